@@ -8,18 +8,164 @@ mkdir -p src/shaders/compiled
 glslangValidator -V src/shaders/vertex.vert -o src/shaders/compiled/vertex.vert.spv
 cp src/shaders/compiled/vertex.vert.spv build/shaders/
 
+# Compile vertex shader (procedural geometry: triangle corners from gl_VertexIndex, no vertex input)
+glslangValidator -V -DENTITY_PROCEDURAL_GEOMETRY src/shaders/vertex.vert -o src/shaders/compiled/vertex.procedural.vert.spv
+cp src/shaders/compiled/vertex.procedural.vert.spv build/shaders/
+
+# Compile vertex shader (density LOD heat map tiles)
+glslangValidator -V src/shaders/entity_density.vert -o src/shaders/compiled/entity_density.vert.spv
+cp src/shaders/compiled/entity_density.vert.spv build/shaders/
+
 # Compile fragment shader  
 glslangValidator -V src/shaders/fragment.frag -o src/shaders/compiled/fragment.frag.spv
 cp src/shaders/compiled/fragment.frag.spv build/shaders/
 
+# Compile fragment shader (entity pick frames: colour plus spawn ID attachment)
+glslangValidator -V src/shaders/fragment.pick.frag -o src/shaders/compiled/fragment.pick.frag.spv
+cp src/shaders/compiled/fragment.pick.frag.spv build/shaders/
+
+# Compile fragment shader (overdraw diagnostic: colour plus a count per fragment, the count image at set 1 or,
+# after the bindless table and camera UBO sets, set 2)
+glslangValidator -V src/shaders/fragment.overdraw.frag -o src/shaders/compiled/fragment.overdraw.frag.spv
+cp src/shaders/compiled/fragment.overdraw.frag.spv build/shaders/
+glslangValidator -V -DOVERDRAW_SET=2 src/shaders/fragment.overdraw.frag -o src/shaders/compiled/fragment.overdraw.set2.frag.spv
+cp src/shaders/compiled/fragment.overdraw.set2.frag.spv build/shaders/
+
+# Compile performance HUD overlay shaders
+glslangValidator -V src/shaders/hud_overlay.vert -o src/shaders/compiled/hud_overlay.vert.spv
+cp src/shaders/compiled/hud_overlay.vert.spv build/shaders/
+glslangValidator -V src/shaders/hud_overlay.frag -o src/shaders/compiled/hud_overlay.frag.spv
+cp src/shaders/compiled/hud_overlay.frag.spv build/shaders/
+
+# Compile debug overlay shaders (spatial grid occupancy and entity bounds)
+glslangValidator -V src/shaders/debug_grid.vert -o src/shaders/compiled/debug_grid.vert.spv
+cp src/shaders/compiled/debug_grid.vert.spv build/shaders/
+glslangValidator -V src/shaders/debug_bounds.vert -o src/shaders/compiled/debug_bounds.vert.spv
+cp src/shaders/compiled/debug_bounds.vert.spv build/shaders/
+glslangValidator -V src/shaders/debug_overlay.frag -o src/shaders/compiled/debug_overlay.frag.spv
+cp src/shaders/compiled/debug_overlay.frag.spv build/shaders/
+
+# Compile overdraw diagnostic shaders (count histogram and heat map)
+glslangValidator -V src/shaders/overdraw_histogram.comp -o src/shaders/compiled/overdraw_histogram.comp.spv
+cp src/shaders/compiled/overdraw_histogram.comp.spv build/shaders/
+glslangValidator -V src/shaders/overdraw_heat_map.vert -o src/shaders/compiled/overdraw_heat_map.vert.spv
+cp src/shaders/compiled/overdraw_heat_map.vert.spv build/shaders/
+glslangValidator -V src/shaders/overdraw_heat_map.frag -o src/shaders/compiled/overdraw_heat_map.frag.spv
+cp src/shaders/compiled/overdraw_heat_map.frag.spv build/shaders/
+
+# Compile compute shader (recording colour conversion to YUV 4:2:0)
+glslangValidator -V src/shaders/capture_yuv.comp -o src/shaders/compiled/capture_yuv.comp.spv
+cp src/shaders/compiled/capture_yuv.comp.spv build/shaders/
+
 # Compile compute shader (random walk movement)
 glslangValidator -V src/shaders/movement_random.comp -o src/shaders/compiled/movement_random.comp.spv
 cp src/shaders/compiled/movement_random.comp.spv build/shaders/
 
+# Compile compute shaders (movement type dispatch: per-type list binning, orbit and flow field kernels)
+glslangValidator -V src/shaders/movement_bin.comp -o src/shaders/compiled/movement_bin.comp.spv
+cp src/shaders/compiled/movement_bin.comp.spv build/shaders/
+glslangValidator -V src/shaders/movement_orbit.comp -o src/shaders/compiled/movement_orbit.comp.spv
+cp src/shaders/compiled/movement_orbit.comp.spv build/shaders/
+glslangValidator -V src/shaders/movement_flow.comp -o src/shaders/compiled/movement_flow.comp.spv
+cp src/shaders/compiled/movement_flow.comp.spv build/shaders/
+
+# Compile compute shader (movement type dispatch from device-generated commands; buffer addresses only, no variants)
+glslangValidator -V src/shaders/movement_commands.comp -o src/shaders/compiled/movement_commands.comp.spv
+cp src/shaders/compiled/movement_commands.comp.spv build/shaders/
+
 # Compile compute shader (physics)
 glslangValidator -V src/shaders/physics.comp -o src/shaders/compiled/physics.comp.spv
 cp src/shaders/compiled/physics.comp.spv build/shaders/
 
+# Compile compute shader (physics, shared-memory tiled variant)
+glslangValidator -V src/shaders/physics_tiled.comp -o src/shaders/compiled/physics_tiled.comp.spv
+cp src/shaders/compiled/physics_tiled.comp.spv build/shaders/
+
+# Compile compute shader (spatial grid clear)
+glslangValidator -V src/shaders/spatial_clear.comp -o src/shaders/compiled/spatial_clear.comp.spv
+cp src/shaders/compiled/spatial_clear.comp.spv build/shaders/
+
+# Compile compute shader (spatial grid count)
+glslangValidator -V src/shaders/spatial_count.comp -o src/shaders/compiled/spatial_count.comp.spv
+cp src/shaders/compiled/spatial_count.comp.spv build/shaders/
+
+# Compile compute shader (spatial grid prefix sum)
+glslangValidator -V src/shaders/spatial_prefix_sum.comp -o src/shaders/compiled/spatial_prefix_sum.comp.spv
+cp src/shaders/compiled/spatial_prefix_sum.comp.spv build/shaders/
+
+# Compile compute shader (spatial grid scatter)
+glslangValidator -V src/shaders/spatial_scatter.comp -o src/shaders/compiled/spatial_scatter.comp.spv
+cp src/shaders/compiled/spatial_scatter.comp.spv build/shaders/
+
+# Compile compute shader (entity reorder by spatial cell)
+glslangValidator -V src/shaders/entity_reorder.comp -o src/shaders/compiled/entity_reorder.comp.spv
+cp src/shaders/compiled/entity_reorder.comp.spv build/shaders/
+
+# Compile compute shader (entity despawn compaction)
+glslangValidator -V src/shaders/entity_despawn.comp -o src/shaders/compiled/entity_despawn.comp.spv
+cp src/shaders/compiled/entity_despawn.comp.spv build/shaders/
+
+# Compile compute shader (sparse ECS -> GPU entity updates)
+glslangValidator -V src/shaders/entity_update.comp -o src/shaders/compiled/entity_update.comp.spv
+cp src/shaders/compiled/entity_update.comp.spv build/shaders/
+
+# Compile compute shader (GPU entity spawning from emitter records)
+glslangValidator -V src/shaders/entity_spawn.comp -o src/shaders/compiled/entity_spawn.comp.spv
+cp src/shaders/compiled/entity_spawn.comp.spv build/shaders/
+
+# Compile compute shader (physics active set compaction, for sleeping entities)
+glslangValidator -V src/shaders/entity_active.comp -o src/shaders/compiled/entity_active.comp.spv
+cp src/shaders/compiled/entity_active.comp.spv build/shaders/
+
+# Compile compute shader (entity frustum culling and compaction)
+glslangValidator -V src/shaders/entity_cull.comp -o src/shaders/compiled/entity_cull.comp.spv
+cp src/shaders/compiled/entity_cull.comp.spv build/shaders/
+
+# Compile compute shader (visible entity binning by shape)
+glslangValidator -V src/shaders/entity_bin.comp -o src/shaders/compiled/entity_bin.comp.spv
+cp src/shaders/compiled/entity_bin.comp.spv build/shaders/
+
+# Compile compute shader (live entity bounds reduction)
+glslangValidator -V src/shaders/entity_bounds.comp -o src/shaders/compiled/entity_bounds.comp.spv
+cp src/shaders/compiled/entity_bounds.comp.spv build/shaders/
+
+# Compile compute shader (batched radius / nearest spatial queries)
+glslangValidator -V src/shaders/spatial_query.comp -o src/shaders/compiled/spatial_query.comp.spv
+cp src/shaders/compiled/spatial_query.comp.spv build/shaders/
+
+# Bindless variants: entity buffers come from the descriptor table (see src/shaders/entity_bindings.glsl)
+for shader in vertex.vert entity_density.vert movement_random.comp movement_bin.comp movement_orbit.comp movement_flow.comp \
+              physics.comp physics_tiled.comp spatial_clear.comp spatial_count.comp \
+              spatial_prefix_sum.comp spatial_scatter.comp entity_reorder.comp entity_despawn.comp entity_update.comp entity_spawn.comp \
+              entity_active.comp entity_cull.comp entity_bin.comp entity_bounds.comp spatial_query.comp; do
+    output="src/shaders/compiled/${shader%.*}.bindless.${shader##*.}.spv"
+    glslangValidator -V -DENTITY_BINDLESS "src/shaders/$shader" -o "$output"
+    cp "$output" build/shaders/
+    
+    # Buffer address variants: entity buffers come from the stream address table instead
+    output="src/shaders/compiled/${shader%.*}.bda.${shader##*.}.spv"
+    glslangValidator -V -DENTITY_BUFFER_ADDRESS "src/shaders/$shader" -o "$output"
+    cp "$output" build/shaders/
+done
+
+# Procedural geometry vertex shader in both binding modes
+for mode in bindless:ENTITY_BINDLESS bda:ENTITY_BUFFER_ADDRESS; do
+    output="src/shaders/compiled/vertex.procedural.${mode%%:*}.vert.spv"
+    glslangValidator -V -DENTITY_PROCEDURAL_GEOMETRY -D${mode#*:} src/shaders/vertex.vert -o "$output"
+    cp "$output" build/shaders/
+done
+
+# Subgroup ballot variants of the compaction kernels (src/shaders/subgroup_scan.glsl) and of the kernels adding to
+# the simulation counters (src/shaders/simulation_counters.glsl) in every binding mode:
+# x.ballot.comp.spv, x.bindless.ballot.comp.spv and x.bda.ballot.comp.spv
+for shader in entity_active.comp entity_cull.comp entity_despawn.comp physics.comp movement_random.comp; do
+    for mode in "" bindless:ENTITY_BINDLESS bda:ENTITY_BUFFER_ADDRESS; do
+        output="src/shaders/compiled/${shader%.*}${mode:+.${mode%%:*}}.ballot.${shader##*.}.spv"
+        glslangValidator -V -DENTITY_SUBGROUP_BALLOT ${mode:+-D${mode#*:}} "src/shaders/$shader" -o "$output"
+        cp "$output" build/shaders/
+    done
+done
+
 # Export shaders to Windows build folder
 WINDOWS_DEST="/mnt/f/Projects/Fractalia2/build/shaders"
 if mkdir -p "$WINDOWS_DEST" 2>/dev/null; then
@@ -0,0 +1,83 @@
+# Bakes every SPIR-V module in SPIRV_DIR into OUTPUT, a table included by src/vulkan/pipelines/embedded_shaders.cpp.
+# Run as a build step: cmake -DSPIRV_DIR=<dir> -DOUTPUT=<file> -P embed-shaders.cmake
+#
+# Each entry is keyed by the path the pipeline specs load ("shaders/<name>.spv") and carries the reflection
+# ShaderManager::performBasicReflection would derive at load time - stage from the file name, workgroup size
+# from the module's LocalSize execution mode, or its defaults when the size comes from specialization constants.
+
+if(NOT SPIRV_DIR OR NOT OUTPUT)
+    message(FATAL_ERROR "embed-shaders.cmake needs -DSPIRV_DIR and -DOUTPUT")
+endif()
+
+file(GLOB SPIRV_FILES "${SPIRV_DIR}/*.spv")
+list(SORT SPIRV_FILES)
+
+set(ARRAYS "")
+set(ENTRIES "")
+set(INDEX 0)
+foreach(SPIRV_FILE ${SPIRV_FILES})
+    get_filename_component(NAME ${SPIRV_FILE} NAME)
+    file(READ ${SPIRV_FILE} HEX HEX)
+    string(LENGTH "${HEX}" HEX_LENGTH)
+    math(EXPR WORD_COUNT "${HEX_LENGTH} / 8")
+    math(EXPR REMAINDER "${HEX_LENGTH} % 8")
+    if(WORD_COUNT LESS 5 OR NOT REMAINDER EQUAL 0)
+        message(FATAL_ERROR "embed-shaders.cmake: ${SPIRV_FILE} is not a SPIR-V module")
+    endif()
+
+    # Little-endian bytes to words, one token per word so the matches below stay word aligned
+    string(REGEX REPLACE "(..)(..)(..)(..)" "0x\\4\\3\\2\\1," WORDS "${HEX}")
+    if(NOT WORDS MATCHES "^0x07230203,")
+        message(FATAL_ERROR "embed-shaders.cmake: ${SPIRV_FILE} has no SPIR-V magic number")
+    endif()
+
+    if(NAME MATCHES "\\.comp\\.spv$")
+        set(STAGE VK_SHADER_STAGE_COMPUTE_BIT)
+        set(LOCAL_SIZE "32, 1, 1")
+    elseif(NAME MATCHES "\\.frag\\.spv$")
+        set(STAGE VK_SHADER_STAGE_FRAGMENT_BIT)
+        set(LOCAL_SIZE "1, 1, 1")
+    elseif(NAME MATCHES "\\.geom\\.spv$")
+        set(STAGE VK_SHADER_STAGE_GEOMETRY_BIT)
+        set(LOCAL_SIZE "1, 1, 1")
+    else()
+        set(STAGE VK_SHADER_STAGE_VERTEX_BIT)
+        set(LOCAL_SIZE "1, 1, 1")
+    endif()
+
+    # OpExecutionMode <entry> LocalSize x y z: opcode 16 with a word count of 6, execution mode 17
+    if(STAGE STREQUAL "VK_SHADER_STAGE_COMPUTE_BIT"
+       AND WORDS MATCHES "0x00060010,0x[0-9a-f]+,0x00000011,(0x[0-9a-f]+),(0x[0-9a-f]+),(0x[0-9a-f]+),")
+        math(EXPR SIZE_X "${CMAKE_MATCH_1}")
+        math(EXPR SIZE_Y "${CMAKE_MATCH_2}")
+        math(EXPR SIZE_Z "${CMAKE_MATCH_3}")
+        set(LOCAL_SIZE "${SIZE_X}, ${SIZE_Y}, ${SIZE_Z}")
+    endif()
+
+    # Eight words per line keeps the generated file diffable
+    set(WORD "0x[0-9a-f]+,")
+    string(REGEX REPLACE "(${WORD}${WORD}${WORD}${WORD}${WORD}${WORD}${WORD}${WORD})" "\\1\n    " WORDS "${WORDS}")
+    string(REGEX REPLACE "\n    $" "" WORDS "${WORDS}")
+    string(APPEND ARRAYS "// ${NAME}\nconstexpr uint32_t SPIRV_${INDEX}[] = {\n    ${WORDS}\n};\n\n")
+    string(APPEND ENTRIES "    { \"shaders/${NAME}\", ${STAGE}, { ${LOCAL_SIZE} }, SPIRV_${INDEX}, ${WORD_COUNT} },\n")
+    math(EXPR INDEX "${INDEX} + 1")
+endforeach()
+
+if(INDEX EQUAL 0)
+    message(WARNING "embed-shaders.cmake: No SPIR-V modules in ${SPIRV_DIR}, run ./compile-shaders.sh first")
+endif()
+
+# The trailing null entry keeps the array non-empty when nothing was compiled
+set(CONTENT "// Generated by embed-shaders.cmake from ${SPIRV_DIR} - do not edit\n\n${ARRAYS}")
+string(APPEND CONTENT "constexpr size_t EMBEDDED_SHADER_COUNT = ${INDEX};\n\n")
+string(APPEND CONTENT "constexpr EmbeddedShader EMBEDDED_SHADER_TABLE[] = {\n${ENTRIES}")
+string(APPEND CONTENT "    { nullptr, VK_SHADER_STAGE_VERTEX_BIT, { 1, 1, 1 }, nullptr, 0 },\n};\n")
+
+# Only touch the output when it changes, so unchanged shaders don't rebuild the table
+if(EXISTS ${OUTPUT})
+    file(READ ${OUTPUT} PREVIOUS)
+    if(PREVIOUS STREQUAL CONTENT)
+        return()
+    endif()
+endif()
+file(WRITE ${OUTPUT} "${CONTENT}")
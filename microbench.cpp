@@ -0,0 +1,465 @@
+// CPU microbenchmarks for the infrastructure types on the frame path. Built as fractalia2_microbench with
+// -DFRACTALIA_MICROBENCH=ON; `cmake --build . --target microbench` runs it with JSON output in the build directory.
+//
+//   fractalia2_microbench [--filter TEXT] [--min-time MS] [--repetitions N] [--output results.json]
+//
+// Every benchmark runs once per argument. The iteration count is grown until one run takes --min-time (default
+// 200 ms), then --repetitions runs (default 5) at that count give the median, fastest and slowest time per op.
+#include <SDL3/SDL.h>
+#include <SDL3/SDL_vulkan.h>
+#include <flecs.h>
+#include "src/ecs/core/entity_factory.h"
+#include "src/ecs/core/service_locator.h"
+#include "src/ecs/events/event_bus.h"
+#include "src/ecs/gpu/gpu_entity_manager.h"
+#include "src/vulkan/core/vulkan_context.h"
+#include "src/vulkan/pipelines/graphics_pipeline_state_hash.h"
+#include "src/vulkan/pipelines/hash_utils.h"
+#include "src/vulkan/resources/buffers/buffer_factory.h"
+#include "src/vulkan/resources/buffers/staging_buffer_pool.h"
+#include "src/vulkan/resources/core/memory_allocator.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+namespace {
+
+using Clock = std::chrono::steady_clock;
+
+// Keeps a value the benchmark computes from being optimised away
+template<typename T>
+inline void keepValue(const T& value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+// Loop control handed to a benchmark body: `while (state.keepRunning())` runs the timed op iterations times.
+// Setup before the loop and anything between pauseTiming() and resumeTiming() is left out of the time
+class BenchmarkState {
+public:
+    BenchmarkState(int64_t argument, uint64_t iterations) : argument(argument), iterations(iterations) {}
+
+    bool keepRunning() {
+        if (!started) {
+            started = true;
+            resumeTiming();
+        }
+        if (completed == iterations) {
+            pauseTiming();
+            return false;
+        }
+        ++completed;
+        return true;
+    }
+
+    void pauseTiming() { elapsed += Clock::now() - timingStart; }
+    void resumeTiming() { timingStart = Clock::now(); }
+
+    int64_t getArgument() const { return argument; }
+    uint64_t getIterations() const { return iterations; }
+
+    // Items one op processes (entities, events), for the items per second column; 0 leaves it out
+    void setItemsPerOp(double items) { itemsPerOp = items; }
+    double getItemsPerOp() const { return itemsPerOp; }
+
+    // A body that cannot run (no device) skips instead of timing nothing
+    void skip(const std::string& reason) { skipReason = reason; }
+    const std::string& getSkipReason() const { return skipReason; }
+
+    double getElapsedNs() const { return std::chrono::duration<double, std::nano>(elapsed).count(); }
+
+private:
+    int64_t argument;
+    uint64_t iterations;
+    uint64_t completed = 0;
+    bool started = false;
+    Clock::time_point timingStart;
+    Clock::duration elapsed{0};
+    double itemsPerOp = 0.0;
+    std::string skipReason;
+};
+
+struct Benchmark {
+    std::string name;
+    std::string argumentName;
+    std::vector<int64_t> arguments;
+    std::function<void(BenchmarkState&)> body;
+};
+
+struct BenchmarkResult {
+    std::string name;            // name/argumentName:argument
+    int64_t argument = 0;
+    uint64_t iterations = 0;     // Per repetition
+    uint32_t repetitions = 0;
+    double medianNs = 0.0;       // Per op
+    double minNs = 0.0;
+    double maxNs = 0.0;
+    double itemsPerSecond = 0.0; // At the median
+    std::string skipReason;
+};
+
+struct Options {
+    std::string filter;
+    double minTimeMs = 200.0;
+    uint32_t repetitions = 5;
+    std::string outputPath;
+};
+
+// EventBus
+
+struct BenchEvent {
+    uint32_t value = 0;
+    float payload[3] = {};
+};
+
+void subscribeCounters(Events::EventBus& bus, int64_t listeners, std::vector<Events::EventListenerHandle>& handles,
+                       uint64_t& sink) {
+    for (int64_t i = 0; i < listeners; ++i) {
+        handles.push_back(bus.subscribe<BenchEvent>([&sink](const BenchEvent& event) { sink += event.value; }));
+    }
+}
+
+void benchEventPublishImmediate(BenchmarkState& state) {
+    Events::EventBus bus;
+    std::vector<Events::EventListenerHandle> handles;
+    uint64_t sink = 0;
+    subscribeCounters(bus, state.getArgument(), handles, sink);
+
+    uint32_t value = 0;
+    while (state.keepRunning()) {
+        bus.publish<BenchEvent>(Events::ProcessingMode::Immediate, ++value);
+    }
+    keepValue(sink);
+}
+
+void benchEventPublishNow(BenchmarkState& state) {
+    Events::EventBus bus;
+    std::vector<Events::EventListenerHandle> handles;
+    uint64_t sink = 0;
+    subscribeCounters(bus, state.getArgument(), handles, sink);
+
+    uint32_t value = 0;
+    while (state.keepRunning()) {
+        bus.publishNow<BenchEvent>(++value);
+    }
+    keepValue(sink);
+}
+
+// One op publishes a frame's worth of deferred events and processes them
+void benchEventDeferred(BenchmarkState& state) {
+    Events::EventBus bus;
+    std::vector<Events::EventListenerHandle> handles;
+    uint64_t sink = 0;
+    subscribeCounters(bus, 1, handles, sink);
+
+    const auto batch = static_cast<uint32_t>(state.getArgument());
+    state.setItemsPerOp(batch);
+    while (state.keepRunning()) {
+        for (uint32_t i = 0; i < batch; ++i) {
+            bus.publish<BenchEvent>(Events::ProcessingMode::Deferred, i);
+        }
+        bus.processDeferred();
+    }
+    keepValue(sink);
+}
+
+// ServiceLocator
+
+struct BenchService {
+    uint64_t counter = 0;
+};
+
+// Argument 1 freezes the registry first, as main() does after startup
+void benchRequireService(BenchmarkState& state) {
+    ServiceLocator& locator = ServiceLocator::instance();
+    locator.clear();
+    locator.createAndRegister<BenchService>("BenchService");
+    locator.initializeAllServices();
+    if (state.getArgument() != 0) {
+        locator.freeze();
+    }
+
+    while (state.keepRunning()) {
+        BenchService& service = locator.requireService<BenchService>();
+        keepValue(++service.counter);
+    }
+    locator.clear();
+}
+
+// Pipeline state hashing
+
+void benchHashCombiner(BenchmarkState& state) {
+    std::vector<uint32_t> values(static_cast<size_t>(state.getArgument()));
+    for (size_t i = 0; i < values.size(); ++i) {
+        values[i] = static_cast<uint32_t>(i * 2654435761u);
+    }
+
+    state.setItemsPerOp(static_cast<double>(values.size()));
+    while (state.keepRunning()) {
+        keepValue(VulkanHash::HashCombiner().combineContainer(values).get());
+    }
+}
+
+// Equal states with argument vertex attributes, the case a cache hit compares in full
+void benchGraphicsPipelineStateEquals(BenchmarkState& state) {
+    GraphicsPipelineState first;
+    first.shaderStages = {"shaders/vertex.vert.spv", "shaders/fragment.frag.spv"};
+    first.vertexBindings.push_back({0, sizeof(float) * 4, VK_VERTEX_INPUT_RATE_VERTEX});
+    for (int64_t i = 0; i < state.getArgument(); ++i) {
+        first.vertexAttributes.push_back({static_cast<uint32_t>(i), 0, VK_FORMAT_R32G32B32A32_SFLOAT,
+                                          static_cast<uint32_t>(i * 16)});
+    }
+    VkPipelineColorBlendAttachmentState blend{};
+    blend.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | VK_COLOR_COMPONENT_B_BIT |
+                           VK_COLOR_COMPONENT_A_BIT;
+    first.colorBlendAttachments.push_back(blend);
+    first.colorAttachmentFormat = VK_FORMAT_B8G8R8A8_SRGB;
+    const GraphicsPipelineState second = first;
+
+    while (state.keepRunning()) {
+        keepValue(first == second);
+    }
+}
+
+// StagingBufferPool, on a device of its own behind a hidden window
+
+struct StagingDevice {
+    SDL_Window* window = nullptr;
+    VulkanContext context;
+    MemoryAllocator allocator;
+    BufferFactory factory;
+    bool ready = false;
+
+    StagingDevice() {
+        if (!SDL_Init(SDL_INIT_VIDEO)) return;
+        window = SDL_CreateWindow("fractalia2 microbench", 64, 64, SDL_WINDOW_VULKAN | SDL_WINDOW_HIDDEN);
+        ready = window && context.initialize(window) && allocator.initialize(context) &&
+                factory.initialize(context, &allocator);
+    }
+
+    ~StagingDevice() {
+        factory.cleanup();
+        allocator.cleanup();
+        context.cleanup();
+        if (window) SDL_DestroyWindow(window);
+        SDL_Quit();
+    }
+};
+
+StagingDevice& getStagingDevice() {
+    static StagingDevice device;
+    return device;
+}
+
+// Argument is the allocation size; the pool is reset every 256 allocations, as a frame slot retires
+void benchStagingAllocate(BenchmarkState& state) {
+    StagingDevice& device = getStagingDevice();
+    if (!device.ready) {
+        state.skip("no Vulkan device");
+        return;
+    }
+
+    constexpr uint32_t ALLOCATIONS_PER_FRAME = 256;
+    constexpr VkDeviceSize SEGMENT_SIZE = 4 * 1024 * 1024;
+    StagingBufferPool pool;
+    if (!pool.initialize(&device.factory, SEGMENT_SIZE)) {
+        state.skip("staging pool initialization failed");
+        return;
+    }
+
+    const auto size = static_cast<VkDeviceSize>(state.getArgument());
+    uint32_t frameAllocations = 0;
+    while (state.keepRunning()) {
+        keepValue(pool.allocate(size, 16).mappedData);
+        if (++frameAllocations == ALLOCATIONS_PER_FRAME) {
+            state.pauseTiming();
+            pool.reset();
+            frameAllocations = 0;
+            state.resumeTiming();
+        }
+    }
+    pool.cleanup();
+}
+
+// Entity creation and staging
+
+void benchCreateSwarm(BenchmarkState& state) {
+    flecs::world world;
+    EntityFactory factory(world);
+    factory.seed(1);
+
+    const auto count = static_cast<size_t>(state.getArgument());
+    state.setItemsPerOp(static_cast<double>(count));
+    while (state.keepRunning()) {
+        std::vector<flecs::entity> swarm = factory.createSwarm(count, glm::vec3(0.0f), 10.0f);
+
+        state.pauseTiming();
+        for (flecs::entity entity : swarm) {
+            entity.destruct();
+        }
+        state.resumeTiming();
+    }
+}
+
+// The staging path of GPUEntityManager::addEntitiesFromECS: size the streams, then write every entity's slot
+void benchStageEntities(BenchmarkState& state) {
+    const auto count = static_cast<size_t>(state.getArgument());
+    std::vector<Transform> transforms(count);
+    std::vector<Renderable> renderables(count);
+    std::vector<MovementPattern> patterns(count);
+    for (size_t i = 0; i < count; ++i) {
+        transforms[i].position = glm::vec3(static_cast<float>(i % 256), static_cast<float>(i / 256), 0.0f);
+        patterns[i].amplitude = 12.0f + static_cast<float>(i % 8);
+    }
+
+    GPUEntitySoA staging;
+    state.setItemsPerOp(static_cast<double>(count));
+    while (state.keepRunning()) {
+        staging.clear();
+        staging.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            staging.writeFromECS(i, transforms[i], nullptr, renderables[i], patterns[i], static_cast<uint32_t>(i));
+        }
+        keepValue(staging.velocities.data());
+    }
+}
+
+std::vector<Benchmark> createBenchmarks() {
+    return {
+        {"EventBus.publishImmediate", "listeners", {1, 4, 16}, benchEventPublishImmediate},
+        {"EventBus.publishNow", "listeners", {1, 4, 16}, benchEventPublishNow},
+        {"EventBus.publishDeferred+processDeferred", "events", {64, 1024}, benchEventDeferred},
+        {"ServiceLocator.requireService", "frozen", {0, 1}, benchRequireService},
+        {"VulkanHash.HashCombiner", "values", {4, 16, 64}, benchHashCombiner},
+        {"GraphicsPipelineState.operator==", "attributes", {2, 8}, benchGraphicsPipelineStateEquals},
+        {"StagingBufferPool.allocate", "bytes", {256, 4096, 65536}, benchStagingAllocate},
+        {"EntityFactory.createSwarm", "entities", {1000, 10000, 100000}, benchCreateSwarm},
+        {"GPUEntitySoA.writeFromECS", "entities", {1000, 10000, 100000}, benchStageEntities},
+    };
+}
+
+BenchmarkResult runBenchmark(const Benchmark& benchmark, int64_t argument, const Options& options) {
+    BenchmarkResult result;
+    result.name = benchmark.name + "/" + benchmark.argumentName + ":" + std::to_string(argument);
+    result.argument = argument;
+
+    // Grow the iteration count until one run fills the minimum time
+    const double minTimeNs = options.minTimeMs * 1e6;
+    uint64_t iterations = 1;
+    for (;;) {
+        BenchmarkState state(argument, iterations);
+        benchmark.body(state);
+        if (!state.getSkipReason().empty()) {
+            result.skipReason = state.getSkipReason();
+            return result;
+        }
+        const double elapsedNs = state.getElapsedNs();
+        if (elapsedNs >= minTimeNs || iterations >= (1ull << 32)) break;
+
+        const double scale = elapsedNs > 0.0 ? minTimeNs / elapsedNs * 1.2 : 10.0;
+        iterations = std::max(iterations + 1, static_cast<uint64_t>(iterations * std::min(scale, 10.0)));
+    }
+
+    std::vector<double> nsPerOp;
+    double itemsPerOp = 0.0;
+    for (uint32_t repetition = 0; repetition < options.repetitions; ++repetition) {
+        BenchmarkState state(argument, iterations);
+        benchmark.body(state);
+        nsPerOp.push_back(state.getElapsedNs() / static_cast<double>(iterations));
+        itemsPerOp = state.getItemsPerOp();
+    }
+    std::sort(nsPerOp.begin(), nsPerOp.end());
+
+    result.iterations = iterations;
+    result.repetitions = options.repetitions;
+    result.medianNs = nsPerOp[nsPerOp.size() / 2];
+    result.minNs = nsPerOp.front();
+    result.maxNs = nsPerOp.back();
+    result.itemsPerSecond = itemsPerOp > 0.0 && result.medianNs > 0.0 ? itemsPerOp * 1e9 / result.medianNs : 0.0;
+    return result;
+}
+
+// Benchmark names are literals above, so they need no escaping
+void writeJson(std::ostream& out, const std::vector<BenchmarkResult>& results, const Options& options) {
+    out << std::fixed << std::setprecision(3);
+    out << "{\n";
+    out << "  \"minTimeMs\": " << options.minTimeMs << ",\n";
+    out << "  \"repetitions\": " << options.repetitions << ",\n";
+    out << "  \"benchmarks\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const BenchmarkResult& result = results[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"name\": \"" << result.name << "\", \"argument\": " << result.argument;
+        if (!result.skipReason.empty()) {
+            out << ", \"skipped\": \"" << result.skipReason << "\"}";
+            continue;
+        }
+        out << ", \"iterations\": " << result.iterations << ", \"nsPerOp\": {\"median\": " << result.medianNs
+            << ", \"min\": " << result.minNs << ", \"max\": " << result.maxNs << "}, \"itemsPerSecond\": "
+            << result.itemsPerSecond << "}";
+    }
+    out << "\n  ]\n}\n";
+}
+
+Options parseArguments(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument(argv[i]);
+        const bool hasValue = i + 1 < argc;
+
+        if (argument == "--filter" && hasValue) {
+            options.filter = argv[++i];
+        } else if (argument == "--min-time" && hasValue) {
+            options.minTimeMs = std::max(1.0, std::strtod(argv[++i], nullptr));
+        } else if (argument == "--repetitions" && hasValue) {
+            options.repetitions = static_cast<uint32_t>(std::max(1L, std::strtol(argv[++i], nullptr, 10)));
+        } else if (argument == "--output" && hasValue) {
+            options.outputPath = argv[++i];
+        }
+    }
+    return options;
+}
+
+}
+
+int main(int argc, char* argv[]) {
+    const Options options = parseArguments(argc, argv);
+
+    std::vector<BenchmarkResult> results;
+    std::cout << std::left << std::setw(60) << "benchmark" << std::right << std::setw(14) << "ns/op"
+              << std::setw(14) << "min" << std::setw(14) << "max" << std::setw(16) << "items/s" << std::endl;
+    for (const Benchmark& benchmark : createBenchmarks()) {
+        if (!options.filter.empty() && benchmark.name.find(options.filter) == std::string::npos) continue;
+
+        for (int64_t argument : benchmark.arguments) {
+            BenchmarkResult result = runBenchmark(benchmark, argument, options);
+            std::cout << std::left << std::setw(60) << result.name << std::right << std::fixed << std::setprecision(1);
+            if (!result.skipReason.empty()) {
+                std::cout << "  skipped: " << result.skipReason << std::endl;
+            } else {
+                std::cout << std::setw(14) << result.medianNs << std::setw(14) << result.minNs << std::setw(14)
+                          << result.maxNs << std::setw(16) << std::setprecision(0) << result.itemsPerSecond << std::endl;
+            }
+            results.push_back(std::move(result));
+        }
+    }
+
+    if (options.outputPath.empty()) return 0;
+
+    std::ofstream out(options.outputPath);
+    if (out) {
+        writeJson(out, results, options);
+    }
+    if (!out) {
+        std::cerr << "Microbench: Failed to write results to " << options.outputPath << std::endl;
+        return 1;
+    }
+    std::cout << "Microbench: " << results.size() << " results written to " << options.outputPath << std::endl;
+    return 0;
+}
@@ -21,4 +21,20 @@ PolygonMesh PolygonFactory::createSquare() {
     };
     square.indices = {0, 1, 2, 0, 2, 3};
     return square;
+}
+
+PolygonMesh PolygonFactory::createEntityShapes(std::vector<PolygonMeshRange>& ranges) {
+    // Indices stay local to their shape; the range's vertex offset rebases them
+    PolygonMesh merged;
+    ranges.clear();
+    for (const PolygonMesh& shape : {createTriangle(), createSquare()}) {
+        PolygonMeshRange range;
+        range.firstIndex = static_cast<uint32_t>(merged.indices.size());
+        range.indexCount = static_cast<uint32_t>(shape.indices.size());
+        range.vertexOffset = static_cast<int32_t>(merged.vertices.size());
+        ranges.push_back(range);
+        merged.vertices.insert(merged.vertices.end(), shape.vertices.begin(), shape.vertices.end());
+        merged.indices.insert(merged.indices.end(), shape.indices.begin(), shape.indices.end());
+    }
+    return merged;
 }
\ No newline at end of file
@@ -13,8 +13,18 @@ struct PolygonMesh {
     std::vector<uint16_t> indices;
 };
 
+// Where one shape lives in a merged mesh, in the terms of VkDrawIndexedIndirectCommand
+struct PolygonMeshRange {
+    uint32_t firstIndex = 0;
+    uint32_t indexCount = 0;
+    int32_t vertexOffset = 0;
+};
+
 class PolygonFactory {
 public:
     static PolygonMesh createTriangle();
     static PolygonMesh createSquare();
+    
+    // Every entity shape in one mesh, in EntityShape order, with each shape's range
+    static PolygonMesh createEntityShapes(std::vector<PolygonMeshRange>& ranges);
 };
\ No newline at end of file
@@ -0,0 +1,492 @@
+#include "benchmark_runner.h"
+#include "vulkan_renderer.h"
+#include "ecs/core/entity_factory.h"
+#include "ecs/gpu/gpu_entity_manager.h"
+#include "ecs/utilities/constants.h"
+#include "vulkan/rendering/frame_graph.h"
+#include "vulkan/core/vulkan_context.h"
+#include "vulkan/core/vulkan_function_loader.h"
+#include "vulkan/core/vulkan_constants.h"
+#include <algorithm>
+#include <cstdlib>
+#include <fstream>
+#include <functional>
+#include <iomanip>
+#include <iostream>
+#include <numeric>
+
+namespace {
+    // Nearest-rank percentile of an unsorted sample set
+    float percentile(std::vector<float> samples, float fraction) {
+        if (samples.empty()) return 0.0f;
+        const size_t rank = std::min(samples.size() - 1, static_cast<size_t>(fraction * samples.size()));
+        std::nth_element(samples.begin(), samples.begin() + rank, samples.end());
+        return samples[rank];
+    }
+    
+    float average(const std::vector<float>& samples) {
+        if (samples.empty()) return 0.0f;
+        return std::accumulate(samples.begin(), samples.end(), 0.0f) / samples.size();
+    }
+    
+    bool endsWith(const std::string& value, const std::string& suffix) {
+        return value.size() >= suffix.size() && value.compare(value.size() - suffix.size(), suffix.size(), suffix) == 0;
+    }
+    
+    float median(std::vector<float> samples) {
+        return percentile(std::move(samples), 0.5f);
+    }
+    
+    // Device names are the only free text in the output
+    std::string jsonString(const std::string& value) {
+        std::string quoted = "\"";
+        for (char c : value) {
+            if (c == '"' || c == '\\') quoted += '\\';
+            quoted += c;
+        }
+        return quoted + "\"";
+    }
+    
+    uint32_t parseCount(const char* value) {
+        return static_cast<uint32_t>(std::max(0L, std::strtol(value, nullptr, 10)));
+    }
+    
+    // "144,60,120" -> {144, 120, 60}; entries that are not positive numbers are dropped
+    std::vector<float> parseRates(const char* value) {
+        std::vector<float> rates;
+        for (char* cursor = const_cast<char*>(value); *cursor != '\0'; ) {
+            const float rate = std::strtof(cursor, &cursor);
+            if (rate > 0.0f) rates.push_back(rate);
+            while (*cursor != '\0' && *cursor != ',') ++cursor;
+            if (*cursor == ',') ++cursor;
+        }
+        std::sort(rates.begin(), rates.end(), std::greater<float>());
+        rates.erase(std::unique(rates.begin(), rates.end()), rates.end());
+        return rates;
+    }
+    
+    // Probes closer together than this are not told apart by the frame time noise anyway
+    constexpr uint32_t CAPACITY_MIN_STEP = 256;
+    
+    float getFrameBudgetMs(float targetRate) {
+        return 1000.0f / targetRate;
+    }
+}
+
+BenchmarkRunner::Options BenchmarkRunner::parseArguments(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument(argv[i]);
+        const bool hasValue = i + 1 < argc;
+        
+        if (argument == "--bench") {
+            options.enabled = true;
+        } else if (argument == "--bench-frames" && hasValue) {
+            options.measuredFrames = std::max(1u, parseCount(argv[++i]));
+        } else if (argument == "--bench-repetitions" && hasValue) {
+            options.repetitions = std::max(1u, parseCount(argv[++i]));
+        } else if (argument == "--bench-warmup" && hasValue) {
+            options.warmupFrames = parseCount(argv[++i]);
+        } else if (argument == "--bench-start" && hasValue) {
+            options.startEntities = std::max(1u, parseCount(argv[++i]));
+        } else if (argument == "--bench-max" && hasValue) {
+            options.maxEntities = std::max(1u, parseCount(argv[++i]));
+        } else if (argument == "--bench-seed" && hasValue) {
+            options.seed = parseCount(argv[++i]);
+        } else if (argument == "--bench-output" && hasValue) {
+            options.outputPath = argv[++i];
+        } else if (argument == "--bench-capacity") {
+            options.enabled = true;
+            options.capacity = true;
+        } else if (argument == "--bench-targets" && hasValue) {
+            std::vector<float> rates = parseRates(argv[++i]);
+            if (!rates.empty()) options.targetRates = std::move(rates);
+        } else if (argument == "--bench-resolution" && hasValue) {
+            options.capacityResolution = std::clamp(std::strtof(argv[++i], nullptr), 0.001f, 0.5f);
+        }
+    }
+    
+    options.maxEntities = std::min(options.maxEntities, ENTITY_CAPACITY_MAX);
+    options.startEntities = std::min(options.startEntities, options.maxEntities);
+    return options;
+}
+
+BenchmarkRunner::BenchmarkRunner(const Options& options, VulkanRenderer& renderer, EntityFactory& entityFactory)
+    : options(options), renderer(renderer), entityFactory(entityFactory) {
+    
+    // Capacity probes after the first are planned as each one finishes
+    for (uint64_t target = options.startEntities; ; target *= 2) {
+        stageTargets.push_back(static_cast<uint32_t>(std::min<uint64_t>(target, options.maxEntities)));
+        if (options.capacity || target >= options.maxEntities) break;
+    }
+    
+    // Same seed, same spawn positions and movement patterns on every run
+    entityFactory.seed(options.seed);
+    
+    if (options.capacity) {
+        std::cout << "BenchmarkRunner: Capacity search from " << options.startEntities << " up to "
+                  << options.maxEntities << " entities for";
+        for (float rate : options.targetRates) {
+            std::cout << " " << rate << "Hz";
+        }
+        std::cout << ", " << options.warmupFrames << " settling + " << options.repetitions << " x "
+                  << options.measuredFrames << " measured frames per probe" << std::endl;
+        return;
+    }
+    
+    std::cout << "BenchmarkRunner: " << stageTargets.size() << " stages from " << stageTargets.front() << " to "
+              << stageTargets.back() << " entities, " << options.warmupFrames << " warmup + " << options.repetitions
+              << " x " << options.measuredFrames << " measured frames each at " << options.deltaTime * 1000.0f << "ms"
+              << std::endl;
+}
+
+void BenchmarkRunner::beginFrame() {
+    if (isFinished() || stageFrame != 0) return;
+    
+    spawnToTarget(stageTargets[stageIndex]);
+    cpuSamples.clear();
+    cpuSamples.reserve(static_cast<size_t>(options.measuredFrames) * options.repetitions);
+    nodeSamples.clear();
+}
+
+void BenchmarkRunner::endFrame(float cpuFrameMs) {
+    if (isFinished()) return;
+    
+    if (stageFrame >= options.warmupFrames) {
+        cpuSamples.push_back(cpuFrameMs);
+    }
+    
+    // Warmup frames only baseline the per-node sample counts, so timings from the previous stage are skipped
+    sampleNodeTimings();
+    
+    ++stageFrame;
+    if (stageFrame > options.warmupFrames && (stageFrame - options.warmupFrames) % options.measuredFrames == 0) {
+        finishRepetition();
+    }
+    if (stageFrame >= options.warmupFrames + options.measuredFrames * options.repetitions) {
+        finishStage();
+        stageFrame = 0;
+        ++stageIndex;
+        if (options.capacity) {
+            planCapacityStage();
+        }
+    }
+}
+
+void BenchmarkRunner::spawnToTarget(uint32_t target) {
+    GPUEntityManager* gpuEntityManager = renderer.getGPUEntityManager();
+    if (!gpuEntityManager || target == spawnedEntities) return;
+    
+    // Bisection steps down by respawning from nothing, so a probe never measures despawn compaction passes
+    if (target < spawnedEntities) {
+        despawnAll();
+    }
+    
+    const size_t count = target - spawnedEntities;
+    if (SystemConstants::GPU_RESIDENT_SWARMS) {
+        SwarmSpawn spawn;
+        auto entities = entityFactory.createResidentSwarm(count, glm::vec3(10.0f, 10.0f, 0.0f), 8.0f, MovementType::RandomWalk, spawn);
+        gpuEntityManager->addResidentEntities(entities, spawn.transforms, spawn.renderables, spawn.patterns);
+        if (options.capacity) spawnedList.insert(spawnedList.end(), entities.begin(), entities.end());
+    } else {
+        auto entities = entityFactory.createSwarm(count, glm::vec3(10.0f, 10.0f, 0.0f), 8.0f);
+        gpuEntityManager->addEntitiesFromECS(entities);
+        if (options.capacity) spawnedList.insert(spawnedList.end(), entities.begin(), entities.end());
+    }
+    gpuEntityManager->uploadPendingEntities();
+    spawnedEntities = target;
+    
+    if (options.capacity) {
+        std::cout << "BenchmarkRunner: Capacity probe " << stageIndex + 1 << " - "
+                  << gpuEntityManager->getEntityCount() << " entities" << std::endl;
+        return;
+    }
+    std::cout << "BenchmarkRunner: Stage " << stageIndex + 1 << "/" << stageTargets.size() << " - "
+              << gpuEntityManager->getEntityCount() << " entities" << std::endl;
+}
+
+void BenchmarkRunner::despawnAll() {
+    // The despawn observers queue each entity, and clearAllEntities then drops the queue with every slot
+    for (flecs::entity entity : spawnedList) {
+        if (entity.is_alive()) entity.destruct();
+    }
+    spawnedList.clear();
+    renderer.getGPUEntityManager()->clearAllEntities();
+    spawnedEntities = 0;
+}
+
+BenchmarkRunner::CapacityBounds BenchmarkRunner::getCapacityBounds(float targetRate) const {
+    // The CPU frame time covers the GPU too: a GPU-bound frame waits for its in-flight fence inside it
+    const float budgetMs = getFrameBudgetMs(targetRate);
+    CapacityBounds bounds;
+    for (size_t i = 0; i < results.size(); ++i) {
+        if (results[i].cpuP99Ms > budgetMs && (bounds.missedEntities == 0 || stageTargets[i] < bounds.missedEntities)) {
+            bounds.missedEntities = stageTargets[i];
+        }
+    }
+    // A noisy hit above the first miss does not count
+    for (size_t i = 0; i < results.size(); ++i) {
+        const uint32_t target = stageTargets[i];
+        if (results[i].cpuP99Ms <= budgetMs && target > bounds.sustainedEntities &&
+            (bounds.missedEntities == 0 || target < bounds.missedEntities)) {
+            bounds.sustainedEntities = target;
+            bounds.sustainedStage = i;
+        }
+    }
+    return bounds;
+}
+
+void BenchmarkRunner::planCapacityStage() {
+    // Strictest target first, so the search mostly grows; looser targets start from its probes
+    for (float rate : options.targetRates) {
+        const CapacityBounds bounds = getCapacityBounds(rate);
+        uint32_t next = 0;
+        if (bounds.missedEntities == 0) {
+            if (bounds.sustainedEntities >= options.maxEntities) continue;
+            next = static_cast<uint32_t>(std::min<uint64_t>(uint64_t(bounds.sustainedEntities) * 2, options.maxEntities));
+        } else {
+            const uint32_t gap = bounds.missedEntities - bounds.sustainedEntities;
+            const uint32_t resolution = std::max(CAPACITY_MIN_STEP,
+                static_cast<uint32_t>(bounds.sustainedEntities * options.capacityResolution));
+            if (gap <= resolution) continue;
+            next = bounds.sustainedEntities + gap / 2;
+        }
+        stageTargets.push_back(next);
+        return;
+    }
+}
+
+void BenchmarkRunner::sampleNodeTimings() {
+    const FrameGraph* frameGraph = renderer.getFrameGraph();
+    if (!frameGraph) return;
+    
+    const bool measuring = stageFrame >= options.warmupFrames;
+    for (const auto& [nodeId, timing] : frameGraph->getNodeProfiler().getTimings()) {
+        NodeSamples& samples = nodeSamples[timing.name];
+        if (timing.sampleCount > samples.lastSampleCount && measuring) {
+            samples.milliseconds.push_back(timing.lastMs);
+        }
+        samples.lastSampleCount = timing.sampleCount;
+        samples.bytesPerEntity = timing.bytesPerEntity;
+    }
+}
+
+void BenchmarkRunner::finishRepetition() {
+    // A node that did not run in this window contributes no repetition
+    for (auto& [name, samples] : nodeSamples) {
+        if (samples.milliseconds.size() > samples.repetitionStart) {
+            std::vector<float> window(samples.milliseconds.begin() + samples.repetitionStart, samples.milliseconds.end());
+            samples.repetitionAverages.push_back(average(window));
+        }
+        samples.repetitionStart = samples.milliseconds.size();
+    }
+}
+
+void BenchmarkRunner::finishStage() {
+    StageResult result;
+    GPUEntityManager* gpuEntityManager = renderer.getGPUEntityManager();
+    result.entities = gpuEntityManager ? gpuEntityManager->getEntityCount() : 0;
+    result.frames = static_cast<uint32_t>(cpuSamples.size());
+    result.cpuAvgMs = average(cpuSamples);
+    result.cpuP50Ms = percentile(cpuSamples, 0.50f);
+    result.cpuP99Ms = percentile(cpuSamples, 0.99f);
+    result.cpuMaxMs = cpuSamples.empty() ? 0.0f : *std::max_element(cpuSamples.begin(), cpuSamples.end());
+    
+    const double seconds = std::accumulate(cpuSamples.begin(), cpuSamples.end(), 0.0) / 1000.0;
+    result.entitiesPerSecond = seconds > 0.0 ? static_cast<double>(result.entities) * result.frames / seconds : 0.0;
+    
+    for (const auto& [name, samples] : nodeSamples) {
+        if (samples.repetitionAverages.empty()) continue;
+        NodeResult& node = result.gpuNodes[name];
+        node.medianMs = median(samples.repetitionAverages);
+        node.minMs = *std::min_element(samples.repetitionAverages.begin(), samples.repetitionAverages.end());
+        node.maxMs = *std::max_element(samples.repetitionAverages.begin(), samples.repetitionAverages.end());
+        node.p99Ms = percentile(samples.milliseconds, 0.99f);
+        if (node.medianMs > 0.0f) {
+            node.entitiesPerMs = result.entities / static_cast<double>(node.medianMs);
+            node.gigabytesPerSecond = node.entitiesPerMs * samples.bytesPerEntity / 1.0e6;
+        }
+    }
+    
+    std::cout << "BenchmarkRunner: " << result.entities << " entities - CPU avg " << result.cpuAvgMs << "ms, p99 "
+              << result.cpuP99Ms << "ms, " << static_cast<uint64_t>(result.entitiesPerSecond) << " entities/s" << std::endl;
+    results.push_back(std::move(result));
+}
+
+bool BenchmarkRunner::writeResults() const {
+    std::ofstream out(options.outputPath);
+    if (!out) {
+        std::cerr << "BenchmarkRunner: Failed to open " << options.outputPath << " for writing" << std::endl;
+        return false;
+    }
+    
+    out << std::fixed << std::setprecision(4);
+    if (endsWith(options.outputPath, ".json")) {
+        writeJson(out);
+    } else if (options.capacity) {
+        writeCapacityCsv(out);
+    } else {
+        writeCsv(out);
+    }
+    if (!out) {
+        std::cerr << "BenchmarkRunner: Failed to write results to " << options.outputPath << std::endl;
+        return false;
+    }
+    
+    std::cout << "BenchmarkRunner: Results for " << results.size() << " stages written to " << options.outputPath << std::endl;
+    return true;
+}
+
+void BenchmarkRunner::writeCsv(std::ostream& out) const {
+    // One column group per node timed in any stage; stages where a node did not run leave it empty
+    std::vector<std::string> nodeNames;
+    for (const StageResult& result : results) {
+        for (const auto& [name, node] : result.gpuNodes) {
+            if (std::find(nodeNames.begin(), nodeNames.end(), name) == nodeNames.end()) {
+                nodeNames.push_back(name);
+            }
+        }
+    }
+    std::sort(nodeNames.begin(), nodeNames.end());
+    
+    out << "entities,frames,cpu_avg_ms,cpu_p50_ms,cpu_p99_ms,cpu_max_ms,entities_per_sec";
+    for (const std::string& name : nodeNames) {
+        const std::string prefix = ",gpu_" + name;
+        out << prefix << "_median_ms" << prefix << "_min_ms" << prefix << "_max_ms" << prefix << "_p99_ms"
+            << prefix << "_entities_per_ms" << prefix << "_gbps";
+    }
+    out << "\n";
+    
+    for (const StageResult& result : results) {
+        out << result.entities << "," << result.frames << "," << result.cpuAvgMs << "," << result.cpuP50Ms << ","
+            << result.cpuP99Ms << "," << result.cpuMaxMs << "," << result.entitiesPerSecond;
+        for (const std::string& name : nodeNames) {
+            auto it = result.gpuNodes.find(name);
+            if (it == result.gpuNodes.end()) {
+                out << ",,,,,,";
+                continue;
+            }
+            const NodeResult& node = it->second;
+            out << "," << node.medianMs << "," << node.minMs << "," << node.maxMs << "," << node.p99Ms << ","
+                << node.entitiesPerMs << "," << node.gigabytesPerSecond;
+        }
+        out << "\n";
+    }
+}
+
+void BenchmarkRunner::writeCapacityCsv(std::ostream& out) const {
+    // One row per target, with the stage columns of the probe it sustained; the probes themselves are JSON only
+    std::vector<std::string> nodeNames;
+    for (float rate : options.targetRates) {
+        const CapacityBounds bounds = getCapacityBounds(rate);
+        if (bounds.sustainedStage == SIZE_MAX) continue;
+        for (const auto& [name, node] : results[bounds.sustainedStage].gpuNodes) {
+            if (std::find(nodeNames.begin(), nodeNames.end(), name) == nodeNames.end()) {
+                nodeNames.push_back(name);
+            }
+        }
+    }
+    std::sort(nodeNames.begin(), nodeNames.end());
+    
+    out << "target_hz,frame_budget_ms,max_entities,at_max,cpu_avg_ms,cpu_p50_ms,cpu_p99_ms,cpu_max_ms";
+    for (const std::string& name : nodeNames) {
+        out << ",gpu_" << name << "_median_ms";
+    }
+    out << "\n";
+    
+    for (float rate : options.targetRates) {
+        const CapacityBounds bounds = getCapacityBounds(rate);
+        out << rate << "," << getFrameBudgetMs(rate) << "," << bounds.sustainedEntities << ","
+            << (bounds.sustainedEntities >= options.maxEntities ? 1 : 0);
+        if (bounds.sustainedStage == SIZE_MAX) {
+            out << ",,,," << std::string(nodeNames.size(), ',') << "\n";
+            continue;
+        }
+        const StageResult& result = results[bounds.sustainedStage];
+        out << "," << result.cpuAvgMs << "," << result.cpuP50Ms << "," << result.cpuP99Ms << "," << result.cpuMaxMs;
+        for (const std::string& name : nodeNames) {
+            auto it = result.gpuNodes.find(name);
+            out << ",";
+            if (it != result.gpuNodes.end()) out << it->second.medianMs;
+        }
+        out << "\n";
+    }
+}
+
+void BenchmarkRunner::writeCapacityJson(std::ostream& out) const {
+    out << "  \"capacityResolution\": " << options.capacityResolution << ",\n";
+    out << "  \"capacity\": [";
+    for (size_t i = 0; i < options.targetRates.size(); ++i) {
+        const float rate = options.targetRates[i];
+        const CapacityBounds bounds = getCapacityBounds(rate);
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"targetHz\": " << rate << ", \"frameBudgetMs\": " << getFrameBudgetMs(rate)
+            << ", \"maxEntities\": " << bounds.sustainedEntities << ", \"firstMissEntities\": " << bounds.missedEntities
+            << ", \"atMax\": " << (bounds.sustainedEntities >= options.maxEntities ? "true" : "false");
+        if (bounds.sustainedStage != SIZE_MAX) {
+            const StageResult& result = results[bounds.sustainedStage];
+            out << ", \"cpuP99Ms\": " << result.cpuP99Ms << ", \"gpuNodeMs\": {";
+            bool first = true;
+            for (const auto& [name, node] : result.gpuNodes) {
+                out << (first ? "" : ", ") << "\"" << name << "\": " << node.medianMs;
+                first = false;
+            }
+            out << "}";
+        }
+        out << "}";
+    }
+    out << "\n  ],\n";
+}
+
+void BenchmarkRunner::writeJson(std::ostream& out) const {
+    // Node names are class names, so they need no escaping
+    out << "{\n";
+    writeDeviceJson(out);
+    out << "  \"timeToFirstFrameMs\": " << timeToFirstFrameMs << ",\n";
+    out << "  \"deltaTime\": " << options.deltaTime << ",\n";
+    out << "  \"seed\": " << options.seed << ",\n";
+    out << "  \"warmupFrames\": " << options.warmupFrames << ",\n";
+    out << "  \"measuredFrames\": " << options.measuredFrames << ",\n";
+    out << "  \"repetitions\": " << options.repetitions << ",\n";
+    if (options.capacity) {
+        writeCapacityJson(out);
+    }
+    out << "  \"stages\": [";
+    for (size_t i = 0; i < results.size(); ++i) {
+        const StageResult& result = results[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\n";
+        out << "      \"entities\": " << result.entities << ",\n";
+        out << "      \"frames\": " << result.frames << ",\n";
+        out << "      \"cpuMs\": {\"avg\": " << result.cpuAvgMs << ", \"p50\": " << result.cpuP50Ms
+            << ", \"p99\": " << result.cpuP99Ms << ", \"max\": " << result.cpuMaxMs << "},\n";
+        out << "      \"entitiesPerSecond\": " << result.entitiesPerSecond << ",\n";
+        out << "      \"gpuNodeMs\": {";
+        bool first = true;
+        for (const auto& [name, node] : result.gpuNodes) {
+            out << (first ? "\n" : ",\n") << "        \"" << name << "\": {\"median\": " << node.medianMs
+                << ", \"min\": " << node.minMs << ", \"max\": " << node.maxMs << ", \"p99\": " << node.p99Ms
+                << ", \"entitiesPerMs\": " << node.entitiesPerMs << ", \"gbps\": " << node.gigabytesPerSecond << "}";
+            first = false;
+        }
+        if (!first) out << "\n      ";
+        out << "}\n";
+        out << "    }";
+    }
+    out << "\n  ]\n}\n";
+}
+
+void BenchmarkRunner::writeDeviceJson(std::ostream& out) const {
+    const FrameGraph* frameGraph = renderer.getFrameGraph();
+    const VulkanContext* context = frameGraph ? frameGraph->getContext() : nullptr;
+    if (!context) return;
+    
+    VkPhysicalDeviceProperties properties{};
+    context->getLoader().vkGetPhysicalDeviceProperties(context->getPhysicalDevice(), &properties);
+    
+    // driverVersion stays raw: its packing is vendor-specific
+    out << "  \"device\": {\"name\": " << jsonString(properties.deviceName) << ", \"vendorID\": " << properties.vendorID
+        << ", \"deviceID\": " << properties.deviceID << ", \"driverVersion\": " << properties.driverVersion
+        << ", \"apiVersion\": \"" << VK_VERSION_MAJOR(properties.apiVersion) << "." << VK_VERSION_MINOR(properties.apiVersion)
+        << "." << VK_VERSION_PATCH(properties.apiVersion) << "\"},\n";
+}
@@ -0,0 +1,121 @@
+#pragma once
+
+#include <flecs.h>
+#include <cstdint>
+#include <iosfwd>
+#include <map>
+#include <string>
+#include <vector>
+
+class VulkanRenderer;
+class EntityFactory;
+
+// Headless benchmark scenario for --bench: the entity count ramps through a fixed list of stages, each run for
+// a warmup and then a number of measured repetitions at a fixed deltaTime. Per stage it writes CPU frame time
+// and, per frame graph node, GPU timestamp time with its spread across repetitions, entities/ms and estimated
+// GB/s, as CSV or JSON (by output extension) tagged with the device and driver for cross-SKU comparisons.
+// Capacity mode (--bench-capacity) instead searches for the largest entity count whose p99 frame time fits each
+// target frame rate: every probe is a stage, growing by doubling until one misses and then bisecting between the
+// last hit and the first miss, and the result per target is the stage at that count with its node breakdown
+class BenchmarkRunner {
+public:
+    struct Options {
+        bool enabled = false;
+        uint32_t startEntities = 10000;
+        uint32_t maxEntities = 131072;       // Stages double from startEntities, the last one clamped here
+        uint32_t warmupFrames = 120;         // Per stage, after the spawn; covers growth and timestamp latency
+        uint32_t measuredFrames = 600;       // Per repetition
+        uint32_t repetitions = 3;            // Measured windows per stage, back to back
+        float deltaTime = 1.0f / 60.0f;
+        uint32_t seed = 1;
+        std::string outputPath = "fractalia2_bench.csv";
+        
+        bool capacity = false;
+        std::vector<float> targetRates = {120.0f, 60.0f};  // Hz, strictest first
+        float capacityResolution = 0.02f;   // Search stops once the miss is within this fraction of the hit
+    };
+    
+    // --bench enables the mode; --bench-frames, --bench-warmup, --bench-repetitions, --bench-start, --bench-max,
+    // --bench-seed and --bench-output override the defaults. --bench-capacity enables it in capacity mode, with
+    // --bench-targets (comma-separated Hz) and --bench-resolution. Unrelated arguments are ignored
+    static Options parseArguments(int argc, char* argv[]);
+    
+    BenchmarkRunner(const Options& options, VulkanRenderer& renderer, EntityFactory& entityFactory);
+    
+    bool isFinished() const { return stageIndex >= stageTargets.size(); }
+    float getDeltaTime() const { return options.deltaTime; }
+    
+    // Around each frame of the main loop: beginFrame spawns up to the stage's entity count on its first
+    // frame, endFrame records the frame once the stage is past its warmup
+    void beginFrame();
+    void endFrame(float cpuFrameMs);
+    
+    bool writeResults() const;
+    
+    // Process start to the first submitted frame, written with the results
+    void setTimeToFirstFrame(float milliseconds) { timeToFirstFrameMs = milliseconds; }
+
+private:
+    struct NodeSamples {
+        std::vector<float> milliseconds;        // Every measured frame of the stage
+        std::vector<float> repetitionAverages;
+        size_t repetitionStart = 0;             // First sample of the current repetition
+        uint64_t lastSampleCount = 0;
+        float bytesPerEntity = 0.0f;
+    };
+    
+    struct NodeResult {
+        float medianMs = 0.0f;        // Median of the repetition averages
+        float minMs = 0.0f;           // Fastest and slowest repetition average
+        float maxMs = 0.0f;
+        float p99Ms = 0.0f;           // Over all measured frames
+        double entitiesPerMs = 0.0;
+        double gigabytesPerSecond = 0.0;  // 0 when the node reports no bytes per entity
+    };
+    
+    struct StageResult {
+        uint32_t entities = 0;
+        uint32_t frames = 0;
+        float cpuAvgMs = 0.0f;
+        float cpuP50Ms = 0.0f;
+        float cpuP99Ms = 0.0f;
+        float cpuMaxMs = 0.0f;
+        double entitiesPerSecond = 0.0;
+        std::map<std::string, NodeResult> gpuNodes;
+    };
+    
+    struct CapacityBounds {
+        uint32_t sustainedEntities = 0;     // Largest probe below the first miss that fit the budget, 0 for none
+        uint32_t missedEntities = 0;        // Smallest probe that did not, 0 for none
+        size_t sustainedStage = SIZE_MAX;   // Its index into results
+    };
+    
+    void spawnToTarget(uint32_t target);
+    void despawnAll();
+    CapacityBounds getCapacityBounds(float targetRate) const;
+    void planCapacityStage();
+    void sampleNodeTimings();
+    void finishRepetition();
+    void finishStage();
+    
+    void writeCsv(std::ostream& out) const;
+    void writeCapacityCsv(std::ostream& out) const;
+    void writeCapacityJson(std::ostream& out) const;
+    void writeJson(std::ostream& out) const;
+    void writeDeviceJson(std::ostream& out) const;
+    
+    Options options;
+    VulkanRenderer& renderer;
+    EntityFactory& entityFactory;
+    
+    std::vector<uint32_t> stageTargets;
+    size_t stageIndex = 0;
+    uint32_t stageFrame = 0;
+    uint32_t spawnedEntities = 0;
+    std::vector<flecs::entity> spawnedList;     // Destroyed when a capacity probe goes below the spawned count
+    
+    std::vector<float> cpuSamples;
+    std::map<std::string, NodeSamples> nodeSamples;
+    std::vector<StageResult> results;
+    float timeToFirstFrameMs = 0.0f;
+};
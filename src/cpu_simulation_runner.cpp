@@ -0,0 +1,173 @@
+#include "cpu_simulation_runner.h"
+#include "ecs/core/entity_factory.h"
+#include "ecs/gpu/cpu_simulation.h"
+#include "ecs/gpu/entity_snapshot.h"
+#include "ecs/gpu/gpu_entity_manager.h"
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdlib>
+#include <cstring>
+#include <flecs.h>
+#include <iostream>
+
+namespace {
+    constexpr uint32_t LOG_INTERVAL_TICKS = 300;
+    
+    uint32_t parseCount(const char* value) {
+        return static_cast<uint32_t>(std::max(0L, std::strtol(value, nullptr, 10)));
+    }
+    
+    // The default scene's swarm, staged the way GPUEntityManager stages ECS entities
+    void stageSwarm(uint32_t count, uint32_t seed, GPUEntitySoA& staged) {
+        flecs::world world;
+        EntityFactory entityFactory(world);
+        entityFactory.seed(seed);
+        const std::vector<flecs::entity> entities = entityFactory.createSwarm(count, glm::vec3(10.0f, 10.0f, 0.0f), 8.0f);
+        
+        staged.resize(entities.size());
+        size_t written = 0;
+        for (const flecs::entity& entity : entities) {
+            const bool complete = entity.get([&](const Transform& transform, const Renderable& renderable, const MovementPattern& movement) {
+                const uint32_t spawnId = static_cast<uint32_t>(written);
+                staged.writeFromECS(written, transform, entity.get<TransformCold>(), renderable, movement, spawnId);
+                staged.spawnIds[written] = spawnId;
+            });
+            if (complete) {
+                ++written;
+            }
+        }
+        staged.resize(written);
+    }
+    
+    // Positions of the run against the reference's: bit-identical entities and the largest distance apart
+    bool compareWithSnapshot(const CpuSimulation& simulation, const std::string& path) {
+        EntitySnapshotFile reference;
+        if (!reference.open(path)) {
+            return false;
+        }
+        size_t size = 0;
+        uint32_t elementSize = 0;
+        const auto* positions = static_cast<const glm::vec4*>(reference.getColumn(EntitySnapshotColumn::Position, size, elementSize));
+        if (!positions || elementSize != sizeof(glm::vec4)) {
+            std::cerr << "CpuSimulationRunner: " << path << " has no position column" << std::endl;
+            return false;
+        }
+        
+        const std::vector<glm::vec4>& simulated = simulation.getPositions();
+        const size_t count = std::min<size_t>(simulated.size(), std::min<size_t>(reference.getHeader().entityCount, size / sizeof(glm::vec4)));
+        size_t identical = 0;
+        float maxDistance = 0.0f;
+        for (size_t i = 0; i < count; ++i) {
+            if (std::memcmp(&simulated[i], &positions[i], sizeof(glm::vec4)) == 0) {
+                ++identical;
+            } else if (simulated[i].w != 0.0f && positions[i].w != 0.0f) {
+                maxDistance = std::max(maxDistance, glm::length(glm::vec2(simulated[i]) - glm::vec2(positions[i])));
+            }
+        }
+        std::cout << "CpuSimulationRunner: Against " << path << " (frame " << reference.getHeader().frame << "): "
+                  << identical << " of " << count << " positions identical, largest difference " << maxDistance;
+        if (count != simulated.size() || count != reference.getHeader().entityCount) {
+            std::cout << " (" << simulated.size() << " entities here, " << reference.getHeader().entityCount << " there)";
+        }
+        std::cout << std::endl;
+        return true;
+    }
+}
+
+CpuSimulationRunner::Options CpuSimulationRunner::parseArguments(int argc, char* argv[]) {
+    Options options;
+    for (int i = 1; i < argc; ++i) {
+        const std::string argument(argv[i]);
+        const bool hasValue = i + 1 < argc;
+        
+        if (argument == "--cpu-simulation") {
+            options.enabled = true;
+        } else if (argument == "--cpu-ticks" && hasValue) {
+            options.ticks = parseCount(argv[++i]);
+        } else if (argument == "--cpu-entities" && hasValue) {
+            options.entities = std::min(std::max(1u, parseCount(argv[++i])), ENTITY_CAPACITY_MAX);
+        } else if (argument == "--cpu-step-ticks" && hasValue) {
+            options.ticksPerStep = std::clamp(parseCount(argv[++i]), 1u, MAX_SIMULATION_FAST_FORWARD_TICKS_PER_FRAME);
+        } else if (argument == "--cpu-compare" && hasValue) {
+            options.comparePath = argv[++i];
+        } else if (argument == "--sim-rate" && hasValue) {
+            options.tickRate = parseCount(argv[++i]);
+        } else if (argument == "--seed" && hasValue) {
+            options.seed = static_cast<uint32_t>(std::strtoul(argv[++i], nullptr, 10));
+        } else if (argument == "--load-snapshot" && hasValue) {
+            options.loadSnapshotPath = argv[++i];
+        } else if (argument == "--save-snapshot" && hasValue) {
+            options.saveSnapshotPath = argv[++i];
+        } else if (argument == "--cell-order" && hasValue) {
+            options.cellOrder = std::string(argv[++i]) == "morton" ? SpatialCellOrder::Morton : SpatialCellOrder::RowMajor;
+        } else if (argument == "--no-collisions") {
+            options.features.flags &= ~ComputeShaderFeatures::COLLISIONS;
+        } else if (argument == "--no-sleeping") {
+            options.features.flags &= ~ComputeShaderFeatures::SLEEPING;
+        } else if (argument == "--cell-capacity" && hasValue) {
+            options.features.maxEntitiesPerCell = std::max(1u, parseCount(argv[++i]));
+        } else if (argument == "--collision-stride" && hasValue) {
+            options.features.collisionStride = std::min(parseCount(argv[++i]), PHYSICS_MAX_COLLISION_STRIDE);
+        }
+    }
+    return options;
+}
+
+int CpuSimulationRunner::run(const Options& options) {
+    CpuSimulation simulation;
+    simulation.setFeatures(options.features);
+    simulation.setSpatialCellOrder(options.cellOrder);
+    if (!options.loadSnapshotPath.empty()) {
+        if (!simulation.loadSnapshot(options.loadSnapshotPath)) {
+            std::cerr << "CpuSimulationRunner: Failed to restore " << options.loadSnapshotPath << std::endl;
+            return -1;
+        }
+    } else {
+        GPUEntitySoA staged;
+        stageSwarm(options.entities, options.seed, staged);
+        simulation.load(staged);
+    }
+    
+    // Every tick is simulated, however long it takes; --sim-rate 0 ticks at SIMULATION_TICK_RATE
+    const float tickSeconds = options.tickRate > 0 ? 1.0f / options.tickRate : 1.0f / SIMULATION_TICK_RATE;
+    std::cout << "CpuSimulationRunner: " << simulation.getEntityCount() << " entities, " << options.ticks << " ticks of "
+              << tickSeconds * 1000.0f << "ms, " << options.ticksPerStep << " per grid build" << std::endl;
+    
+    const auto runStart = std::chrono::steady_clock::now();
+    auto windowStart = runStart;
+    uint32_t ticksRun = 0;
+    uint32_t windowTicks = 0;
+    while (ticksRun < options.ticks) {
+        SimulationStep step;
+        step.firstTick = ticksRun;
+        step.tickCount = std::min(options.ticksPerStep, options.ticks - ticksRun);
+        step.tickSeconds = tickSeconds;
+        simulation.step(step);
+        ticksRun += step.tickCount;
+        windowTicks += step.tickCount;
+        
+        if (windowTicks >= LOG_INTERVAL_TICKS || ticksRun == options.ticks) {
+            const auto now = std::chrono::steady_clock::now();
+            const float windowMs = std::chrono::duration<float, std::milli>(now - windowStart).count();
+            const CpuSimulation::Telemetry& telemetry = simulation.getTelemetry();
+            std::cout << "CpuSimulationRunner: Tick " << ticksRun << "/" << options.ticks
+                      << " | " << windowMs / windowTicks << "ms per tick"
+                      << " | Collisions " << telemetry.collisions << " (" << telemetry.truncatedEntities << " truncated)"
+                      << " | Direction changes " << telemetry.directionChanges
+                      << " | Expired " << telemetry.expiredEntities << std::endl;
+            windowStart = now;
+            windowTicks = 0;
+        }
+    }
+    std::cout << "CpuSimulationRunner: Finished in "
+              << std::chrono::duration<float>(std::chrono::steady_clock::now() - runStart).count() << "s" << std::endl;
+    
+    if (!options.comparePath.empty()) {
+        compareWithSnapshot(simulation, options.comparePath);
+    }
+    if (!options.saveSnapshotPath.empty() && !simulation.saveSnapshot(options.saveSnapshotPath)) {
+        return -1;
+    }
+    return 0;
+}
@@ -0,0 +1,37 @@
+#pragma once
+
+#include "ecs/gpu/entity_buffer_manager.h"
+#include "vulkan/pipelines/compute_pipeline_types.h"
+#include "vulkan/core/vulkan_constants.h"
+#include <cstdint>
+#include <string>
+
+// Headless scenario run on the CPU simulation backend (CpuSimulation) for hosts without a usable Vulkan device.
+// It spawns a seeded swarm or restores a snapshot, runs a fixed number of ticks as fast as the job workers allow,
+// logs the simulation counters every few hundred ticks and writes the final state as a snapshot, which either
+// backend can restore. A reference snapshot of the same ticks (from a GPU run, or another CPU run) is compared
+// entity by entity, bit for bit and by distance
+class CpuSimulationRunner {
+public:
+    struct Options {
+        bool enabled = false;
+        uint32_t ticks = 3600;
+        uint32_t entities = 10000;
+        uint32_t ticksPerStep = 1;        // Ticks against one grid build, as one GPU frame runs them
+        uint32_t tickRate = SIMULATION_TICK_RATE;
+        uint32_t seed = 1;
+        std::string loadSnapshotPath;
+        std::string saveSnapshotPath;
+        std::string comparePath;
+        ComputeShaderFeatures features;
+        SpatialCellOrder cellOrder = SpatialCellOrder::RowMajor;
+    };
+    
+    // --cpu-simulation enables the mode; --cpu-ticks, --cpu-entities, --cpu-step-ticks and --cpu-compare set its
+    // own options, and --sim-rate, --seed, --load-snapshot, --save-snapshot, --cell-order, --no-collisions,
+    // --no-sleeping, --cell-capacity and --collision-stride apply as they do to the GPU simulation
+    static Options parseArguments(int argc, char* argv[]);
+    
+    // Process exit code: 0 once the run finished and its snapshot, if any, was written
+    static int run(const Options& options);
+};
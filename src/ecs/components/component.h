@@ -7,27 +7,36 @@
 #include <cstring>
 
 // Transform component - consolidates position/rotation for better cache locality
+// Hot half of the transform, read by every system that moves, culls or uploads entities (16 bytes)
 struct Transform {
     glm::vec3 position{0.0f, 0.0f, 0.0f};
+    mutable bool dirty{true};  // Position changed since TransformCold last built the matrix
+    
+    void setPosition(const glm::vec3& pos) { position = pos; dirty = true; }
+};
+
+// Cold half: rotation, scale and the cached model matrix. Optional - an entity without it is unrotated at unit
+// scale, which is what every swarm entity is, so the bulk archetype carries no matrix at all
+struct TransformCold {
     glm::quat rotation{1.0f, 0.0f, 0.0f, 0.0f}; // w, x, y, z (identity quaternion)
     glm::vec3 scale{1.0f, 1.0f, 1.0f};
     
-    // Cached transform matrix - updated when dirty
+    // Cached transform matrix - updated when either half is dirty
     mutable glm::mat4 matrix{1.0f};
     mutable bool dirty{true};
     
-    const glm::mat4& getMatrix() const {
-        if (dirty) {
-            glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), position);
+    const glm::mat4& getMatrix(const Transform& transform) const {
+        if (dirty || transform.dirty) {
+            glm::mat4 translationMatrix = glm::translate(glm::mat4(1.0f), transform.position);
             glm::mat4 rotationMatrix = glm::mat4_cast(rotation);
             glm::mat4 scaleMatrix = glm::scale(glm::mat4(1.0f), scale);
             matrix = translationMatrix * rotationMatrix * scaleMatrix;
             dirty = false;
+            transform.dirty = false;
         }
         return matrix;
     }
     
-    void setPosition(const glm::vec3& pos) { position = pos; dirty = true; }
     void setRotation(const glm::quat& rot) { rotation = rot; dirty = true; }
     void setRotation(const glm::vec3& eulerAngles) { 
         rotation = glm::quat(eulerAngles);
@@ -36,6 +45,16 @@ struct Transform {
     void setScale(const glm::vec3& scl) { scale = scl; dirty = true; }
 };
 
+// Model matrix of an entity, its translation alone when it has no TransformCold
+inline glm::mat4 composeModelMatrix(const Transform& transform, const TransformCold* cold) {
+    return cold ? cold->getMatrix(transform) : glm::translate(glm::mat4(1.0f), transform.position);
+}
+
+// Half extents of the default unit box Bounds, scaled by the entity's TransformCold
+inline glm::vec3 defaultHalfExtents(const TransformCold* cold) {
+    return cold ? cold->scale * 0.5f : glm::vec3(0.5f);
+}
+
 // Velocity component for physics
 struct Velocity {
     glm::vec3 linear{0.0f, 0.0f, 0.0f};
@@ -43,16 +62,21 @@ struct Velocity {
 };
 
 // Render component - optimized for batch rendering
+// Entity meshes, in the order PolygonFactory::createEntityShapes merges them (ENTITY_SHAPE_COUNT)
+enum class EntityShape : uint32_t {
+    Triangle = 0,
+    Square = 1
+};
+
+// Hot render state only (32 bytes); the model matrix is TransformCold's
 struct Renderable {
     glm::vec4 color{1.0f, 1.0f, 1.0f, 1.0f};
     uint32_t layer{0}; // For depth sorting
-    bool visible{true};
-    
-    // Transform matrix for GPU upload
-    glm::mat4 modelMatrix{1.0f};
+    EntityShape shape{EntityShape::Triangle};  // Drawn as shape 0 unless entity shape binning is active
     
     // Change tracking for optimization
     mutable uint32_t version{0};
+    bool visible{true};
     mutable bool dirty{true};
     void markDirty() const { ++version; dirty = true; }
 };
@@ -71,9 +95,11 @@ struct Bounds {
     bool dynamic{true}; // Updates with transform changes
 };
 
-// Movement types matching GPU compute shader
-enum class MovementType {
-    RandomWalk = 0  // GPU-driven random walk from center point (simplified to single type)
+// Movement types, each with its own GPU kernel under movement type dispatch (MOVEMENT_TYPE_COUNT)
+enum class MovementType : uint32_t {
+    RandomWalk = 0,  // New random heading every movement cycle (movement_random.comp)
+    Orbit = 1,       // Circles of radius amplitude at a speed set by frequency (movement_orbit.comp)
+    FlowField = 2    // Steers along a time-varying field sampled at the entity position (movement_flow.comp)
 };
 
 struct MovementPattern {
@@ -243,6 +269,11 @@ struct ApplicationState {
 // GPU synchronization marker components
 struct GPUUploadPending {};        // Entity needs GPU upload
 struct GPUUploadComplete {};       // Entity has been uploaded to GPU
+struct GPUDriven {};               // Moved, culled and drawn by the GPU pipeline; never queued per entity on the CPU
+struct GPUResident {};             // Transform, Renderable and MovementPattern exist only on the GPU (GPUEntityManager::requestRehydration)
+struct GPUSlot {                   // Spawn ID of a GPU-resident entity, the GPU slot it names is kept in SpawnSlotBuffer
+    uint32_t spawnId = UINT32_MAX;
+};
 struct GPUEntitySync {             // Singleton component for GPU sync operations
     bool needsUpload = false;
     uint32_t pendingCount = 0;
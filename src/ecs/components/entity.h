@@ -10,6 +10,7 @@ using EntityHandle = flecs::entity;
 struct GPUEntityData {
     uint32_t id{0};
     Transform transform{};
+    TransformCold transformCold{};
     Renderable renderable{};
     MovementPattern movement{};
     
@@ -21,6 +22,9 @@ struct GPUEntityData {
         if (e.has<Transform>()) {
             transform = *e.get<Transform>();
         }
+        if (e.has<TransformCold>()) {
+            transformCold = *e.get<TransformCold>();
+        }
         if (e.has<Renderable>()) {
             renderable = *e.get<Renderable>();
         }
@@ -6,6 +6,7 @@
 #include <functional>
 #include <vector>
 #include <random>
+#include <algorithm>
 
 // Entity builder pattern for designer-friendly workflow
 class EntityBuilder {
@@ -29,30 +30,25 @@ public:
         return at(glm::vec3(x, y, z));
     }
     
+    // Rotation and scale live in TransformCold, added the first time an entity needs either
     EntityBuilder& rotated(const glm::vec3& rotation) {
-        if (auto* transform = entity.get_mut<Transform>()) {
-            transform->setRotation(rotation);
+        if (auto* cold = entity.get_mut<TransformCold>()) {
+            cold->setRotation(rotation);
         } else {
-            auto t = entity.get_mut<Transform>();
-            if (!t) {
-                entity.set<Transform>({});
-                t = entity.get_mut<Transform>();
-            }
-            t->setRotation(rotation);
+            TransformCold t;
+            t.setRotation(rotation);
+            entity.set<TransformCold>(t);
         }
         return *this;
     }
     
     EntityBuilder& scaled(const glm::vec3& scale) {
-        if (auto* transform = entity.get_mut<Transform>()) {
-            transform->setScale(scale);
+        if (auto* cold = entity.get_mut<TransformCold>()) {
+            cold->setScale(scale);
         } else {
-            auto t = entity.get_mut<Transform>();
-            if (!t) {
-                entity.set<Transform>({});
-                t = entity.get_mut<Transform>();
-            }
-            t->setScale(scale);
+            TransformCold t;
+            t.setScale(scale);
+            entity.set<TransformCold>(t);
         }
         return *this;
     }
@@ -93,6 +89,22 @@ public:
         return *this;
     }
     
+    // Taken at upload; later changes are not sent to the GPU
+    EntityBuilder& withShape(EntityShape shape) {
+        if (auto* renderable = entity.get_mut<Renderable>()) {
+            renderable->shape = shape;
+            renderable->markDirty();
+        } else {
+            auto r = entity.get_mut<Renderable>();
+            if (!r) {
+                entity.set<Renderable>({});
+                r = entity.get_mut<Renderable>();
+            }
+            r->shape = shape;
+        }
+        return *this;
+    }
+    
     // Physics methods
     EntityBuilder& withVelocity(const glm::vec3& linear, const glm::vec3& angular = glm::vec3(0.0f)) {
         entity.set<Velocity>({.linear = linear, .angular = angular});
@@ -134,6 +146,15 @@ public:
     }
 };
 
+// Component values of a swarm, one entry per entity, before they become ECS entities or GPU slots
+struct SwarmSpawn {
+    std::vector<Transform> transforms;
+    std::vector<Renderable> renderables;
+    std::vector<MovementPattern> patterns;
+    
+    size_t size() const { return transforms.size(); }
+};
+
 // Entity factory with pooling support
 class EntityFactory {
 private:
@@ -170,6 +191,9 @@ public:
         entityPool.reserve(1000); // Pre-allocate pool
     }
     
+    // Reseed spawn placement and movement pattern randomisation for reproducible scenarios
+    void seed(uint32_t value) { rng.seed(value); }
+    
     // Create new entity or reuse from pool
     EntityBuilder create() {
         flecs::entity entity;
@@ -241,7 +265,7 @@ public:
             .asDynamic()
             .build();
             
-        entity.set<MovementPattern>(pattern);
+        entity.set<MovementPattern>(pattern).add<GPUDriven>();
         return entity;
     }
     
@@ -259,7 +283,7 @@ public:
             .asPooled()
             .build();
             
-        entity.set<MovementPattern>(pattern);
+        entity.set<MovementPattern>(pattern).add<GPUDriven>();
         return entity;
     }
     
@@ -270,36 +294,133 @@ public:
     
     // Create swarm of entities with specified movement type
     std::vector<flecs::entity> createSwarmWithType(size_t count, const glm::vec3& center, float radius, MovementType movementType) {
+        const SwarmSpawn swarm = generateSwarm(count, center, radius, movementType);
+        return createMovingBulk(swarm.transforms, swarm.renderables, swarm.patterns);
+    }
+    
+    // Same swarm as createSwarmWithType, as GPU-resident entities: the components are generated into spawn and only
+    // handed to GPUEntityManager::addResidentEntities, the entities themselves are created with none of them
+    std::vector<flecs::entity> createResidentSwarm(size_t count, const glm::vec3& center, float radius,
+                                                   MovementType movementType, SwarmSpawn& spawn) {
+        spawn = generateSwarm(count, center, radius, movementType);
+        return createResidentBulk(spawn.size());
+    }
+    
+    // Swarm component values, with the placement and randomisation of createSwarmWithType
+    SwarmSpawn generateSwarm(size_t count, const glm::vec3& center, float radius, MovementType movementType) {
         std::uniform_real_distribution<float> angleDist(0.0f, 2.0f * M_PI);
         std::uniform_real_distribution<float> smallRadiusDist(0.0f, 0.5f); // Start very close to center for initial dispersal
         
-        return createBatch(count, [&](EntityBuilder& builder, size_t i) {
+        SwarmSpawn swarm;
+        swarm.transforms.resize(count);
+        swarm.renderables.resize(count);
+        swarm.patterns.resize(count);
+        auto& transforms = swarm.transforms;
+        auto& renderables = swarm.renderables;
+        auto& patterns = swarm.patterns;
+        
+        for (size_t i = 0; i < count; ++i) {
             // Start entities very close to center for dispersal effect
             float angle = angleDist(rng);
             float r = smallRadiusDist(rng); // Very small initial radius
-            glm::vec3 pos = center + glm::vec3(
+            transforms[i].position = center + glm::vec3(
                 r * std::cos(angle),
                 r * std::sin(angle),
                 0.0f
             );
             
             // Use a neutral starting color - dynamic colors will be applied by movement system
-            glm::vec4 color = glm::vec4(0.8f, 0.8f, 0.8f, 1.0f); // Neutral gray start
+            renderables[i].color = glm::vec4(0.8f, 0.8f, 0.8f, 1.0f); // Neutral gray start
+            renderables[i].shape = i % 4 == 3 ? EntityShape::Square : EntityShape::Triangle;  // A square in four
             
             // Create movement pattern that will disperse from center
-            MovementPattern pattern = createMovementPattern(center, i, count, movementType);
-            
-            flecs::entity entity = builder.at(pos)
-                   .withColor(color)
-                   .asDynamic()
-                   .asPooled()
-                   .build();
-                   
-            // Add the movement pattern
-            entity.set<MovementPattern>(pattern);
-            
-            return entity;
-        });
+            patterns[i] = createMovementPattern(center, i, count, movementType);
+        }
+        
+        return swarm;
+    }
+    
+    // Create entities straight into the final [Transform, Renderable, MovementPattern, Dynamic, Pooled, GPUDriven]
+    // archetype. Pooled entities are reused first; the rest are inserted with a single ecs_bulk_init,
+    // which writes each component column once instead of moving every entity through several tables.
+    // Swarm entities keep the default rotation and scale, so the archetype has no TransformCold.
+    std::vector<flecs::entity> createMovingBulk(const std::vector<Transform>& transforms,
+                                                const std::vector<Renderable>& renderables,
+                                                const std::vector<MovementPattern>& patterns) {
+        const size_t count = std::min({transforms.size(), renderables.size(), patterns.size()});
+        std::vector<flecs::entity> entities;
+        entities.reserve(count);
+        
+        // Recycled entities already exist, so they are rebuilt in place
+        size_t next = 0;
+        while (next < count && !entityPool.empty()) {
+            flecs::entity entity = entityPool.back();
+            entityPool.pop_back();
+            entity.clear();
+            entity.set<Transform>(transforms[next])
+                  .set<Renderable>(renderables[next])
+                  .set<MovementPattern>(patterns[next])
+                  .add<Dynamic>()
+                  .add<Pooled>()
+                  .add<GPUDriven>();
+            entities.push_back(entity);
+            ++next;
+        }
+        
+        const size_t bulkCount = count - next;
+        if (bulkCount == 0) {
+            return entities;
+        }
+        
+        ecs_bulk_desc_t desc{};
+        desc.count = static_cast<int32_t>(bulkCount);
+        desc.ids[0] = world.id<Transform>().raw_id();
+        desc.ids[1] = world.id<Renderable>().raw_id();
+        desc.ids[2] = world.id<MovementPattern>().raw_id();
+        desc.ids[3] = world.id<Dynamic>().raw_id();
+        desc.ids[4] = world.id<Pooled>().raw_id();
+        desc.ids[5] = world.id<GPUDriven>().raw_id();
+        
+        // One column pointer per id; tags carry no data
+        void* columns[] = {
+            const_cast<Transform*>(transforms.data() + next),
+            const_cast<Renderable*>(renderables.data() + next),
+            const_cast<MovementPattern*>(patterns.data() + next),
+            nullptr,
+            nullptr,
+            nullptr
+        };
+        desc.data = columns;
+        
+        // Returned ids live in flecs-owned storage that the next operation may reuse
+        const ecs_entity_t* ids = ecs_bulk_init(world, &desc);
+        for (size_t i = 0; i < bulkCount; ++i) {
+            entities.emplace_back(world, ids[i]);
+        }
+        
+        return entities;
+    }
+    
+    // Create count entities straight into the [GPUSlot, GPUResident] archetype with one ecs_bulk_init: 4 bytes of
+    // component data each, filled in by GPUEntityManager once it hands out the spawn IDs. They bypass the pool,
+    // which only recycles entities carrying Pooled
+    std::vector<flecs::entity> createResidentBulk(size_t count) {
+        std::vector<flecs::entity> entities;
+        if (count == 0) {
+            return entities;
+        }
+        entities.reserve(count);
+        
+        ecs_bulk_desc_t desc{};
+        desc.count = static_cast<int32_t>(count);
+        desc.ids[0] = world.id<GPUSlot>().raw_id();
+        desc.ids[1] = world.id<GPUResident>().raw_id();
+        
+        const ecs_entity_t* ids = ecs_bulk_init(world, &desc);
+        for (size_t i = 0; i < count; ++i) {
+            entities.emplace_back(world, ids[i]);
+        }
+        return entities;
     }
     
     // Cleanup pool
@@ -6,6 +6,8 @@
 #include <string>
 #include <functional>
 #include <mutex>
+#include <atomic>
+#include <algorithm>
 #include <vector>
 #include <stdexcept>
 #include <iostream>
@@ -48,6 +50,11 @@ public:
         auto typeIndex = std::type_index(typeid(T));
         std::string serviceName = name.empty() ? typeid(T).name() : name;
         
+        if (frozen_.load(std::memory_order_relaxed)) {
+            std::cerr << "ServiceLocator: Cannot register '" << serviceName << "' while the registry is frozen" << std::endl;
+            return;
+        }
+        
         auto metadata = std::make_unique<ServiceMetadata>(typeIndex, service, serviceName);
         metadata->priority = priority;
         
@@ -55,6 +62,10 @@ public:
         serviceMetadata_[typeIndex] = std::move(metadata);
         serviceOrder_.push_back(typeIndex);
         
+        // The registry keeps the shared_ptr alive, so the slot can hold a plain pointer
+        ServiceSlot<T>::instance = service.get();
+        slotResets_[typeIndex] = [] { ServiceSlot<T>::instance = nullptr; };
+        
         // Sort by priority for proper initialization order
         std::sort(serviceOrder_.begin(), serviceOrder_.end(), 
                  [this](const std::type_index& a, const std::type_index& b) {
@@ -92,22 +103,54 @@ public:
 
     template<typename T>
     T& requireService() {
-        auto service = getService<T>();
-        if (!service) {
-            throw std::runtime_error("Required service not found: " + std::string(typeid(T).name()));
+        if (T* service = findService<T>()) {
+            return *service;
         }
-        return *service;
+        throw std::runtime_error("Required service not found: " + std::string(typeid(T).name()));
     }
 
     template<typename T>
     bool hasService() const {
+        if (frozen_.load(std::memory_order_acquire)) {
+            return ServiceSlot<T>::instance != nullptr;
+        }
         std::lock_guard<std::mutex> lock(mutex_);
         return services_.find(std::type_index(typeid(T))) != services_.end();
     }
+    
+    // Non-owning lookup for hot paths: once frozen it is a single pointer load, with no lock and no
+    // reference count traffic; before that it takes the locked getService() path
+    template<typename T>
+    T* findService() {
+        if (frozen_.load(std::memory_order_acquire)) {
+            return ServiceSlot<T>::instance;
+        }
+        return getService<T>().get();
+    }
+    
+    // Read-only mode for after startup: registration and unregistration are rejected, and lookups
+    // read the per-type slots. clear() thaws the registry for teardown
+    void freeze() {
+        std::lock_guard<std::mutex> lock(mutex_);
+        for (const auto& [typeIndex, metadata] : serviceMetadata_) {
+            if (metadata->lifecycle != ServiceLifecycle::INITIALIZED) {
+                std::cerr << "Warning: Freezing service registry with '" << metadata->name
+                         << "' not fully initialized" << std::endl;
+            }
+        }
+        frozen_.store(true, std::memory_order_release);
+    }
+    
+    bool isFrozen() const { return frozen_.load(std::memory_order_acquire); }
 
     void unregisterService(const std::type_index& type) {
         std::lock_guard<std::mutex> lock(mutex_);
         
+        if (frozen_.load(std::memory_order_relaxed)) {
+            std::cerr << "ServiceLocator: Cannot unregister " << type.name() << " while the registry is frozen" << std::endl;
+            return;
+        }
+        
         // Mark as shutting down
         auto metaIt = serviceMetadata_.find(type);
         if (metaIt != serviceMetadata_.end()) {
@@ -121,6 +164,7 @@ public:
         
         services_.erase(type);
         serviceMetadata_.erase(type);
+        resetSlot(type);
     }
 
     template<typename T>
@@ -130,6 +174,7 @@ public:
 
     void clear() {
         std::lock_guard<std::mutex> lock(mutex_);
+        frozen_.store(false, std::memory_order_release);
         
         // Shutdown services in reverse order of initialization
         for (auto it = serviceOrder_.rbegin(); it != serviceOrder_.rend(); ++it) {
@@ -142,6 +187,10 @@ public:
         services_.clear();
         serviceMetadata_.clear();
         serviceOrder_.clear();
+        for (const auto& [type, reset] : slotResets_) {
+            reset();
+        }
+        slotResets_.clear();
     }
 
     // Dependency management
@@ -238,7 +287,23 @@ public:
 private:
     ServiceLocator() = default;
     
+    // One slot per service type, written under mutex_ and read lock-free only while frozen_
+    template<typename T>
+    struct ServiceSlot {
+        static inline T* instance = nullptr;
+    };
+    
+    void resetSlot(const std::type_index& type) {
+        auto it = slotResets_.find(type);
+        if (it != slotResets_.end()) {
+            it->second();
+            slotResets_.erase(it);
+        }
+    }
+    
     mutable std::mutex mutex_;
+    std::atomic<bool> frozen_{false};
+    std::unordered_map<std::type_index, void (*)()> slotResets_;
     std::unordered_map<std::type_index, std::shared_ptr<void>> services_;
     std::unordered_map<std::type_index, std::unique_ptr<ServiceMetadata>> serviceMetadata_;
     std::vector<std::type_index> serviceOrder_; // Initialization/cleanup order
@@ -1,6 +1,9 @@
 #include "world_manager.h"
 #include "../systems/movement_system.h"
 #include "../gpu/gpu_entity_manager.h"
+#include "../utilities/constants.h"
+#include "../utilities/job_system.h"
+#include "../utilities/logger.h"
 #include <algorithm>
 #include <chrono>
 #include <stdexcept>
@@ -8,33 +11,66 @@
 
 // Service implementation - removed macro
 
+namespace {
+    // Flecs task threads as jobs: a stage's task is queued when Flecs starts it, and joining it runs queued
+    // frame jobs until it is done, so a stage no worker has picked up runs on the joining thread
+    struct FlecsTask {
+        JobCounter done;
+        void* result = nullptr;
+    };
+    
+    ecs_os_thread_t startFlecsTask(ecs_os_thread_callback_t callback, void* param) {
+        auto* task = new FlecsTask();
+        JobSystem::getInstance().submit([task, callback, param]() { task->result = callback(param); },
+                                        JobPriority::High, &task->done);
+        return static_cast<ecs_os_thread_t>(reinterpret_cast<uintptr_t>(task));
+    }
+    
+    void* joinFlecsTask(ecs_os_thread_t thread) {
+        auto* task = reinterpret_cast<FlecsTask*>(static_cast<uintptr_t>(thread));
+        JobSystem::getInstance().wait(task->done);
+        void* result = task->result;
+        delete task;
+        return result;
+    }
+}
+
 WorldManager::WorldManager() 
     : world_()
     , performanceMonitoringEnabled_(false)
     , frameTimeAccumulator_(0.0f)
     , frameCount_(0) {
-    
-    // Configure Flecs for optimal performance
-    world_.set<flecs::Rest>({});  // Enable REST API for debugging
-    // Performance monitoring setup - using available Flecs features
-    
-    // Setup basic phases - simplified for compatibility
 }
 
 WorldManager::~WorldManager() {
     shutdown();
 }
 
-bool WorldManager::initialize() {
+bool WorldManager::initialize(WorldProfile profile) {
     try {
         // Initialize core Flecs systems
-        world_.set_threads(std::thread::hardware_concurrency());
+        setThreadCount(SystemConstants::ECS_WORKER_THREADS);
+        systemQuery_ = world_.query_builder<>().with(flecs::System).build();
         
         // Enable performance monitoring by default
         enablePerformanceMonitoring(true);
         
-        // Register built-in systems
-        registerSystems();
+        // Modules declared for the profile load now, in name order with dependencies first; modules declared later join them
+        declareBuiltinModules();
+        profile_ = profile;
+        profileLoaded_ = true;
+        std::vector<std::string> names;
+        for (const auto& [name, declaration] : moduleDeclarations_) {
+            if (declaration.profiles & worldProfileBit(profile)) {
+                names.push_back(name);
+            }
+        }
+        std::sort(names.begin(), names.end());
+        for (const std::string& name : names) {
+            if (!requireModule(name)) {
+                return false;
+            }
+        }
         
         return true;
     } catch (const std::exception& e) {
@@ -60,13 +96,13 @@ bool WorldManager::unloadModule(const std::string& name) {
         return false;
     }
     
-    // Check for dependencies - simple implementation
-    // In a more sophisticated system, this would check dependency graph
-    for (const auto& [moduleName, module] : modules_) {
-        if (moduleName != name) {
-            // Check if this module depends on the one we're trying to unload
-            // For now, we'll just prevent unloading if other modules exist
-            // A real implementation would have proper dependency tracking
+    // A loaded dependent keeps its dependencies loaded
+    for (const std::string& loaded : moduleOrder_) {
+        auto declaration = moduleDeclarations_.find(loaded);
+        if (declaration == moduleDeclarations_.end()) continue;
+        const auto& dependencies = declaration->second.dependencies;
+        if (std::find(dependencies.begin(), dependencies.end(), name) != dependencies.end()) {
+            return false;
         }
     }
     
@@ -76,6 +112,7 @@ bool WorldManager::unloadModule(const std::string& name) {
         
         // Remove from modules map
         modules_.erase(it);
+        moduleOrder_.erase(std::remove(moduleOrder_.begin(), moduleOrder_.end(), name), moduleOrder_.end());
         
         return true;
     } catch (const std::exception& e) {
@@ -85,28 +122,96 @@ bool WorldManager::unloadModule(const std::string& name) {
 }
 
 void WorldManager::unloadAllModules() {
-    // Unload modules in reverse order of loading to respect dependencies
-    std::vector<std::string> moduleNames;
-    moduleNames.reserve(modules_.size());
+    // Unload modules in reverse order of loading, so dependents go before their dependencies
+    const std::vector<std::string> moduleNames(moduleOrder_.rbegin(), moduleOrder_.rend());
+    for (const auto& name : moduleNames) {
+        unloadModule(name);
+    }
+}
+
+void WorldManager::declareModule(const std::string& name, std::vector<std::string> dependencies, uint32_t profiles,
+                                 ModuleFactory factory) {
+    ModuleDeclaration& declaration = moduleDeclarations_[name];
+    declaration.dependencies = std::move(dependencies);
+    declaration.profiles = profiles;
+    declaration.factory = std::move(factory);
     
-    for (const auto& [name, module] : modules_) {
-        moduleNames.push_back(name);
+    if (profileLoaded_ && (profiles & worldProfileBit(profile_))) {
+        requireModule(name);
+    }
+}
+
+std::shared_ptr<ECSModule> WorldManager::requireModule(const std::string& name) {
+    std::vector<std::string> loading;
+    if (!loadModuleTree(name, loading)) {
+        return nullptr;
+    }
+    return modules_[name];
+}
+
+bool WorldManager::loadModuleTree(const std::string& name, std::vector<std::string>& loading) {
+    if (modules_.find(name) != modules_.end()) {
+        return true;
     }
     
-    // Reverse the order for proper dependency unloading
-    std::reverse(moduleNames.begin(), moduleNames.end());
+    auto declaration = moduleDeclarations_.find(name);
+    if (declaration == moduleDeclarations_.end()) {
+        LOG_ERROR("WorldManager: Module '" << name << "' was never declared");
+        return false;
+    }
+    if (std::find(loading.begin(), loading.end(), name) != loading.end()) {
+        LOG_ERROR("WorldManager: Module '" << name << "' depends on itself");
+        return false;
+    }
     
-    for (const auto& name : moduleNames) {
-        unloadModule(name);
+    loading.push_back(name);
+    for (const std::string& dependency : declaration->second.dependencies) {
+        if (!loadModuleTree(dependency, loading)) {
+            return false;
+        }
     }
+    loading.pop_back();
+    
+    std::shared_ptr<ECSModule> module = declaration->second.factory();
+    if (!module || !module->initialize(world_)) {
+        LOG_ERROR("WorldManager: Module '" << name << "' failed to initialize");
+        return false;
+    }
+    modules_[name] = std::move(module);
+    moduleOrder_.push_back(name);
+    return true;
+}
+
+void WorldManager::declareBuiltinModules() {
+    // Flecs explorer endpoint, for interactive debugging only
+    declareModule("rest", {}, worldProfileBit(WorldProfile::Interactive), []() {
+        return std::make_shared<SystemModule>(
+            "rest", [](flecs::world& world) { world.set<flecs::Rest>({}); },
+            [](flecs::world& world) { world.remove<flecs::Rest>(); });
+    });
+    
+    // Movement, physics and sync phases, for systems that order themselves against the GPU movement pipeline
+    declareModule("movement_phases", {}, worldProfileBit(WorldProfile::Interactive), []() {
+        return std::make_shared<SystemModule>("movement_phases", MovementSystem::setupMovementPhases);
+    });
+    
+    // Movement and physics entity counts; four observers on every MovementPattern and Velocity add and remove,
+    // which no benchmark ramp should pay for
+    declareModule("movement_stats", {"movement_phases"}, worldProfileBit(WorldProfile::Interactive), []() {
+        return std::make_shared<SystemModule>("movement_stats", [](flecs::world& world) {
+            MovementSystem::resetStats();
+            MovementSystem::setupStatsObservers(world);
+        });
+    });
 }
 
 void WorldManager::executeFrame(float deltaTime) {
     auto frameStartTime = std::chrono::high_resolution_clock::now();
     
     try {
-        // Update all modules first
-        for (const auto& [name, module] : modules_) {
+        // Update all modules first, in load order
+        for (const std::string& name : moduleOrder_) {
+            const auto& module = modules_[name];
             if (module->isInitialized()) {
                 module->update(deltaTime);
             }
@@ -122,6 +227,7 @@ void WorldManager::executeFrame(float deltaTime) {
             
             frameTimeAccumulator_ += frameDuration;
             frameCount_++;
+            sampleSystemTimings(frameCount_ >= FRAME_SAMPLE_SIZE);
             
             // Calculate average over sample size
             if (frameCount_ >= FRAME_SAMPLE_SIZE) {
@@ -147,24 +253,81 @@ void WorldManager::executeFrame(float deltaTime) {
     }
 }
 
-void WorldManager::registerSystems() {
-    // Register movement systems
-    // Note: GPUEntityManager will be provided by services that need GPU sync
-    MovementSystem::registerSystems(world_, nullptr);
-}
-
 void WorldManager::registerPerformanceCallback(std::function<void(float)> callback) {
     performanceCallback_ = std::move(callback);
 }
 
 void WorldManager::enablePerformanceMonitoring(bool enable) {
     performanceMonitoringEnabled_ = enable;
+    world_.measure_system_time(enable);
     
     if (!enable) {
         // Reset counters when disabling
         frameTimeAccumulator_ = 0.0f;
         frameCount_ = 0;
+        systemSamples_.clear();
+    }
+}
+
+void WorldManager::setThreadCount(uint32_t threadCount, bool useTaskThreads) {
+    const uint32_t defaultCount = useTaskThreads ? JobSystem::getInstance().getConcurrency()
+                                                 : std::max(1u, std::thread::hardware_concurrency());
+    const uint32_t resolved = threadCount > 0 ? threadCount : defaultCount;
+    
+    // Either call stops the threads of the previous configuration first
+    if (useTaskThreads) {
+        ecs_os_api.task_new_ = startFlecsTask;
+        ecs_os_api.task_join_ = joinFlecsTask;
+        world_.set_task_threads(static_cast<int32_t>(resolved));
+    } else {
+        world_.set_threads(static_cast<int32_t>(resolved));
+    }
+    threadCount_ = resolved;
+    useTaskThreads_ = useTaskThreads;
+}
+
+void WorldManager::sampleSystemTimings(bool windowComplete) {
+    if (!systemQuery_) {
+        return;
     }
+    
+    systemQuery_.each([this, windowComplete](flecs::entity system) {
+        const ecs_system_t* data = ecs_system_get(world_.c_ptr(), system);
+        if (!data) {
+            return;
+        }
+        
+        auto [it, inserted] = systemSamples_.try_emplace(system.id());
+        SystemSamples& samples = it->second;
+        const double timeSpent = static_cast<double>(data->time_spent);
+        if (inserted) {
+            // First sight of the system: its time so far predates the current window
+            samples.name = system.name().c_str();
+            samples.lastTimeSpent = timeSpent;
+            return;
+        }
+        
+        samples.timing.lastMs = static_cast<float>((timeSpent - samples.lastTimeSpent) * 1000.0);
+        samples.lastTimeSpent = timeSpent;
+        samples.windowMs += samples.timing.lastMs;
+        if (windowComplete) {
+            samples.timing.averageMs = samples.windowMs / static_cast<float>(FRAME_SAMPLE_SIZE);
+            samples.windowMs = 0.0f;
+        }
+    });
+}
+
+std::vector<WorldManager::SystemTiming> WorldManager::getSystemTimings() const {
+    std::vector<SystemTiming> timings;
+    timings.reserve(systemSamples_.size());
+    for (const auto& [id, samples] : systemSamples_) {
+        timings.push_back(samples.timing);
+        timings.back().name = samples.name;
+    }
+    std::sort(timings.begin(), timings.end(), [](const SystemTiming& a, const SystemTiming& b) {
+        return a.averageMs > b.averageMs;
+    });
+    return timings;
 }
 
 size_t WorldManager::getEntityCount() const {
@@ -4,11 +4,23 @@
 #include <memory>
 #include <unordered_map>
 #include <string>
+#include <vector>
 #include <functional>
 #include "service_locator.h"
 
 class ECSModule;
 
+// What a run needs from the world: modules are declared for the profiles that use them and the active profile
+// loads only those, so a benchmark never registers the systems and observers an interactive session does
+enum class WorldProfile : uint8_t {
+    Interactive = 0,  // Windowed session with input, camera and picking
+    Bench = 1,        // --bench entity ramp in a hidden window
+    Headless = 2      // No window or renderer; modules load on first use only
+};
+
+inline constexpr uint32_t worldProfileBit(WorldProfile profile) { return 1u << static_cast<uint32_t>(profile); }
+inline constexpr uint32_t ALL_WORLD_PROFILES = 0x7u;
+
 class WorldManager {
 public:
     DECLARE_SERVICE(WorldManager);
@@ -16,8 +28,11 @@ public:
     explicit WorldManager();
     ~WorldManager();
 
-    bool initialize();
+    // Declares the built-in modules and loads those of profile
+    bool initialize(WorldProfile profile = WorldProfile::Interactive);
     void shutdown();
+    
+    WorldProfile getProfile() const { return profile_; }
 
     flecs::world& getWorld() { return world_; }
     const flecs::world& getWorld() const { return world_; }
@@ -33,6 +48,7 @@ public:
         auto module = std::make_shared<ModuleType>(std::forward<Args>(args)...);
         if (module->initialize(world_)) {
             modules_[name] = module;
+            moduleOrder_.push_back(name);
             return module;
         }
         
@@ -48,23 +64,64 @@ public:
         return nullptr;
     }
 
+    using ModuleFactory = std::function<std::shared_ptr<ECSModule>()>;
+    
+    // A module the world can load later: by the active profile when profiles (worldProfileBit mask) include it,
+    // at once if that profile is already loaded, otherwise on the first requireModule. Dependencies load first
+    void declareModule(const std::string& name, std::vector<std::string> dependencies, uint32_t profiles,
+                       ModuleFactory factory);
+    
+    // Loads a declared module and its dependencies unless loaded; nullptr when one is undeclared or fails
+    std::shared_ptr<ECSModule> requireModule(const std::string& name);
+    bool isModuleLoaded(const std::string& name) const { return modules_.find(name) != modules_.end(); }
+    
+    // Loaded module names, dependencies before their dependents
+    const std::vector<std::string>& getLoadedModules() const { return moduleOrder_; }
+
+    // Refuses while a loaded module depends on name
     bool unloadModule(const std::string& name);
     void unloadAllModules();
 
     void executeFrame(float deltaTime);
-    
-    void registerSystems();
 
     void registerPerformanceCallback(std::function<void(float)> callback);
     void enablePerformanceMonitoring(bool enable);
 
+    // Flecs threads for multi_threaded systems. Task threads are High-priority JobSystem jobs started for each
+    // progress(), sharing the pool's workers (0 = the pool's concurrency); otherwise Flecs keeps its own threads
+    // waiting between frames (0 = one per hardware thread). Call between frames only
+    void setThreadCount(uint32_t threadCount, bool useTaskThreads = true);
+    uint32_t getThreadCount() const { return threadCount_; }
+    bool usesTaskThreads() const { return useTaskThreads_; }
+
+    // CPU time per Flecs system, from system time measurement while performance monitoring is enabled
+    struct SystemTiming {
+        std::string name;
+        float lastMs = 0.0f;
+        float averageMs = 0.0f;  // Over the last complete FRAME_SAMPLE_SIZE window
+    };
+    std::vector<SystemTiming> getSystemTimings() const;
+
     size_t getEntityCount() const;
     float getAverageFrameTime() const;
     float getFPS() const;
 
 private:
+    struct ModuleDeclaration {
+        std::vector<std::string> dependencies;
+        uint32_t profiles = 0;
+        ModuleFactory factory;
+    };
+    
     flecs::world world_;
     std::unordered_map<std::string, std::shared_ptr<ECSModule>> modules_;
+    std::vector<std::string> moduleOrder_;  // Load order, unloaded in reverse
+    std::unordered_map<std::string, ModuleDeclaration> moduleDeclarations_;
+    WorldProfile profile_ = WorldProfile::Interactive;
+    bool profileLoaded_ = false;
+    
+    void declareBuiltinModules();
+    bool loadModuleTree(const std::string& name, std::vector<std::string>& loading);
     
     bool performanceMonitoringEnabled_ = false;
     std::function<void(float)> performanceCallback_;
@@ -72,6 +129,21 @@ private:
     float frameTimeAccumulator_ = 0.0f;
     size_t frameCount_ = 0;
     static constexpr size_t FRAME_SAMPLE_SIZE = 60;
+
+    uint32_t threadCount_ = 1;
+    bool useTaskThreads_ = true;
+
+    // Keyed by system entity; time spent is cumulative in Flecs, so each sample is the difference
+    struct SystemSamples {
+        std::string name;
+        double lastTimeSpent = 0.0;
+        float windowMs = 0.0f;
+        SystemTiming timing;
+    };
+    flecs::query<> systemQuery_;
+    std::unordered_map<uint64_t, SystemSamples> systemSamples_;
+
+    void sampleSystemTimings(bool windowComplete);
 };
 
 class ECSModule {
@@ -87,4 +159,39 @@ public:
 
 protected:
     bool initialized_ = false;
+};
+
+// Module for a group of systems, observers and phases. Everything registration creates is scoped under the
+// module's own entity, so unloading deletes it again; unregistration undoes what lives outside that scope
+class SystemModule : public ECSModule {
+public:
+    SystemModule(std::string name, std::function<void(flecs::world&)> registration,
+                 std::function<void(flecs::world&)> unregistration = nullptr)
+        : name_(std::move(name)), registration_(std::move(registration)), unregistration_(std::move(unregistration)) {}
+    
+    bool initialize(flecs::world& world) override {
+        world_ = &world;
+        scope_ = world.entity(name_.c_str());
+        const flecs::entity previousScope = world.set_scope(scope_);
+        registration_(world);
+        world.set_scope(previousScope);
+        initialized_ = true;
+        return true;
+    }
+    
+    void shutdown() override {
+        if (!initialized_) return;
+        if (unregistration_) unregistration_(*world_);
+        scope_.destruct();
+        initialized_ = false;
+    }
+    
+    const std::string& getName() const override { return name_; }
+
+private:
+    std::string name_;
+    std::function<void(flecs::world&)> registration_;
+    std::function<void(flecs::world&)> unregistration_;
+    flecs::world* world_ = nullptr;
+    flecs::entity scope_;
 };
\ No newline at end of file
@@ -0,0 +1,210 @@
+#include "event_bus.h"
+#include <deque>
+
+namespace Events {
+
+namespace {
+    // Listener snapshots per dispatch depth: handlers may subscribe, unsubscribe and publish re-entrantly without
+    // the listener lock held, and a steady dispatch reuses the snapshot's capacity. A deque keeps the outer
+    // snapshots in place while a nested dispatch adds one
+    thread_local std::deque<std::vector<std::shared_ptr<EventListener>>> dispatchSnapshots;
+    thread_local size_t dispatchDepth = 0;
+}
+
+void EventListenerHandle::unsubscribe() {
+    if (valid_.exchange(false) && bus_) {
+        bus_->unsubscribe(id_, type_);
+    }
+    bus_ = nullptr;
+}
+
+EventBus::EventBus() = default;
+
+EventBus::~EventBus() {
+    clear();
+}
+
+bool EventBus::unsubscribe(uint64_t listenerId, std::type_index eventType) {
+    std::unique_lock lock(listenersMutex_);
+    auto it = listeners_.find(eventType);
+    if (it == listeners_.end()) return false;
+
+    auto& typeListeners = it->second;
+    auto listener = std::find_if(typeListeners.begin(), typeListeners.end(),
+                                 [listenerId](const auto& entry) { return entry->id == listenerId; });
+    if (listener == typeListeners.end()) return false;
+
+    typeListeners.erase(listener);
+    stats_.activeListeners.fetch_sub(1, std::memory_order_relaxed);
+    return true;
+}
+
+bool EventBus::setListenerEnabled(uint64_t listenerId, std::type_index eventType, bool enabled) {
+    std::shared_lock lock(listenersMutex_);
+    auto it = listeners_.find(eventType);
+    if (it == listeners_.end()) return false;
+
+    for (const auto& listener : it->second) {
+        if (listener->id == listenerId) {
+            listener->enabled = enabled;
+            return true;
+        }
+    }
+    return false;
+}
+
+void EventBus::processDeferred(size_t maxEvents) {
+    if (std::chrono::steady_clock::now() - lastCleanup_ > CLEANUP_INTERVAL) {
+        cleanupExpiredListeners();
+    }
+
+    // Taken in one lock, so events published while these dispatch wait for the next call
+    {
+        std::unique_lock lock(queueMutex_);
+        const size_t count = maxEvents == 0 ? deferredQueue_.size() : std::min(maxEvents, deferredQueue_.size());
+        deferredBatch_.reserve(count);
+        for (size_t i = 0; i < count; ++i) {
+            // pop() moves the top to the back before it compares, so the moved-from entry is never ordered
+            deferredBatch_.push_back(std::move(const_cast<QueuedEvent&>(deferredQueue_.top())));
+            deferredQueue_.pop();
+        }
+        stats_.queueSize.store(deferredQueue_.size(), std::memory_order_relaxed);
+    }
+
+    for (const QueuedEvent& queued : deferredBatch_) {
+        dispatchToListeners(*queued.event, queued.type);
+    }
+    deferredBatch_.clear();
+}
+
+void EventBus::processUntilEmpty() {
+    while (getQueueSize() > 0) {
+        processDeferred();
+    }
+}
+
+size_t EventBus::getQueueSize() const {
+    std::shared_lock lock(queueMutex_);
+    return deferredQueue_.size();
+}
+
+size_t EventBus::getListenerCount() const {
+    std::shared_lock lock(listenersMutex_);
+    size_t count = 0;
+    for (const auto& [type, typeListeners] : listeners_) {
+        count += typeListeners.size();
+    }
+    return count;
+}
+
+size_t EventBus::getListenerCount(std::type_index eventType) const {
+    std::shared_lock lock(listenersMutex_);
+    auto it = listeners_.find(eventType);
+    return it != listeners_.end() ? it->second.size() : 0;
+}
+
+void EventBus::clear() {
+    clearEvents();
+    clearListeners();
+}
+
+void EventBus::clearEvents() {
+    std::unique_lock lock(queueMutex_);
+    deferredQueue_ = decltype(deferredQueue_)(
+        std::less<QueuedEvent>(), std::pmr::vector<QueuedEvent>(&MemoryTags::getResource(MemoryTag::EventBus)));
+    stats_.queueSize.store(0, std::memory_order_relaxed);
+}
+
+void EventBus::clearListeners() {
+    std::unique_lock lock(listenersMutex_);
+    listeners_.clear();
+    stats_.activeListeners.store(0, std::memory_order_relaxed);
+}
+
+void EventBus::dispatchImmediate(const BaseEvent& event, std::type_index eventType) {
+    stats_.eventsPublished.fetch_add(1, std::memory_order_relaxed);
+    stats_.immediateEvents.fetch_add(1, std::memory_order_relaxed);
+    dispatchToListeners(event, eventType);
+}
+
+void EventBus::dispatchToListeners(const BaseEvent& event, std::type_index eventType) {
+    if (!passesGlobalFilter(event, eventType)) {
+        stats_.eventsFiltered.fetch_add(1, std::memory_order_relaxed);
+        return;
+    }
+
+    if (dispatchSnapshots.size() <= dispatchDepth) {
+        dispatchSnapshots.emplace_back();
+    }
+    auto& snapshot = dispatchSnapshots[dispatchDepth];
+    {
+        std::shared_lock lock(listenersMutex_);
+        auto it = listeners_.find(eventType);
+        if (it == listeners_.end() || it->second.empty()) return;
+        snapshot.assign(it->second.begin(), it->second.end());
+    }
+
+    ++dispatchDepth;
+    for (const auto& listener : snapshot) {
+        if (event.consumed) break;
+        if (!listener->shouldHandle(event)) continue;
+
+        listener->handler(event);
+        stats_.eventsProcessed.fetch_add(1, std::memory_order_relaxed);
+        if (listener->oneShot) {
+            unsubscribe(listener->id, eventType);
+        }
+    }
+    --dispatchDepth;
+    snapshot.clear();
+}
+
+void EventBus::queueDeferred(std::unique_ptr<BaseEvent> event, std::type_index eventType) {
+    stats_.eventsPublished.fetch_add(1, std::memory_order_relaxed);
+    stats_.deferredEvents.fetch_add(1, std::memory_order_relaxed);
+
+    std::unique_lock lock(queueMutex_);
+    deferredQueue_.emplace(std::move(event), eventType);
+    stats_.queueSize.store(deferredQueue_.size(), std::memory_order_relaxed);
+}
+
+bool EventBus::passesGlobalFilter(const BaseEvent& event, std::type_index eventType) const {
+    std::shared_lock lock(globalFiltersMutex_);
+    auto it = globalFilters_.find(eventType);
+    return it == globalFilters_.end() || it->second(event);
+}
+
+void EventBus::cleanupExpiredListeners() {
+    const auto now = std::chrono::steady_clock::now();
+    lastCleanup_ = now;
+
+    std::unique_lock lock(listenersMutex_);
+    for (auto& [type, typeListeners] : listeners_) {
+        const size_t removed = std::erase_if(typeListeners, [now](const auto& listener) {
+            return now > listener->expiryTime;
+        });
+        stats_.activeListeners.fetch_sub(removed, std::memory_order_relaxed);
+    }
+}
+
+namespace Global {
+    namespace {
+        std::mutex eventBusMutex;
+        std::unique_ptr<EventBus> eventBus;
+    }
+
+    EventBus& getEventBus() {
+        std::lock_guard lock(eventBusMutex);
+        if (!eventBus) {
+            eventBus = std::make_unique<EventBus>();
+        }
+        return *eventBus;
+    }
+
+    void setEventBus(std::unique_ptr<EventBus> replacement) {
+        std::lock_guard lock(eventBusMutex);
+        eventBus = std::move(replacement);
+    }
+}
+
+} // namespace Events
@@ -13,6 +13,12 @@
 #include <thread>
 #include <algorithm>
 #include <chrono>
+#include <bit>
+#include <cstddef>
+#include <new>
+#include <string>
+#include <memory_resource>
+#include "../utilities/memory_tags.h"
 
 namespace Events {
 
@@ -45,14 +51,43 @@ public:
     virtual std::type_index getType() const = 0;
     virtual std::unique_ptr<BaseEvent> clone() const = 0;
     
+    // Deferred events are created and destroyed every frame, so they come from the EventBus tag's pool, which
+    // keeps blocks for reuse. Channel slots and stack events construct in place and never reach these
+    static void* operator new(std::size_t size) {
+        return MemoryTags::getPool(MemoryTag::EventBus)->allocate(size);
+    }
+    static void* operator new(std::size_t size, std::align_val_t alignment) {
+        return MemoryTags::getPool(MemoryTag::EventBus)->allocate(size, static_cast<std::size_t>(alignment));
+    }
+    static void* operator new(std::size_t, void* place) noexcept { return place; }
+    static void operator delete(void* pointer, std::size_t size) {
+        MemoryTags::getPool(MemoryTag::EventBus)->deallocate(pointer, size);
+    }
+    static void operator delete(void* pointer, std::size_t size, std::align_val_t alignment) {
+        MemoryTags::getPool(MemoryTag::EventBus)->deallocate(pointer, size, static_cast<std::size_t>(alignment));
+    }
+    
     EventPriority priority = EventPriority::Normal;
     std::chrono::steady_clock::time_point timestamp = std::chrono::steady_clock::now();
     uint64_t sequenceId = 0;
     bool consumed = false;
     
-    // Event metadata for filtering and debugging
+    // Event metadata for filtering and debugging, allocated only once a key is set
     std::string source;
-    std::unordered_map<std::string, std::string> metadata;
+    std::unique_ptr<std::unordered_map<std::string, std::string>> metadata;
+    
+    void setMetadata(const std::string& key, const std::string& value) {
+        if (!metadata) {
+            metadata = std::make_unique<std::unordered_map<std::string, std::string>>();
+        }
+        (*metadata)[key] = value;
+    }
+    
+    const std::string* findMetadata(const std::string& key) const {
+        if (!metadata) return nullptr;
+        auto it = metadata->find(key);
+        return it != metadata->end() ? &it->second : nullptr;
+    }
 };
 
 // Typed event wrapper
@@ -143,7 +178,8 @@ struct EventListener {
     
     bool shouldHandle(const BaseEvent& event) const {
         if (!enabled.load()) return false;
-        if (event.priority < minPriority || event.priority > maxPriority) return false;
+        // Lower values are more urgent: minPriority is the least urgent level handled, maxPriority the most
+        if (event.priority > minPriority || event.priority < maxPriority) return false;
         if (std::chrono::steady_clock::now() > expiryTime) return false;
         return !filter || filter(event);
     }
@@ -166,6 +202,106 @@ struct QueuedEvent {
     }
 };
 
+// Type-erased view of an EventChannel so the bus can drain every channel in one pass
+class EventChannelBase {
+public:
+    virtual ~EventChannelBase() = default;
+    virtual size_t dispatchTo(EventBus& bus, size_t maxEvents) = 0;
+};
+
+// Bounded multi-producer, single-consumer ring for one event type. Events are constructed in place in
+// preallocated slots and dispatched straight from them, so neither publishing nor draining touches the
+// heap; a full channel rejects the event rather than growing. Each slot's sequence number tells producers
+// when it is free and the consumer when it is written
+template<typename EventType>
+class EventChannel : public EventChannelBase {
+public:
+    // capacity must be a power of two
+    explicit EventChannel(size_t capacity)
+        : mask_(capacity - 1), slots_(std::make_unique<Slot[]>(capacity)) {
+        for (size_t i = 0; i < capacity; ++i) {
+            slots_[i].sequence.store(i, std::memory_order_relaxed);
+        }
+    }
+    
+    ~EventChannel() override {
+        drain([](const Event<EventType>&) {});
+    }
+    
+    EventChannel(const EventChannel&) = delete;
+    EventChannel& operator=(const EventChannel&) = delete;
+    
+    // Safe from any thread; false when the channel is full
+    template<typename... Args>
+    bool tryPublish(EventPriority priority, Args&&... args) {
+        size_t position = enqueuePosition_.load(std::memory_order_relaxed);
+        Slot* slot = nullptr;
+        for (;;) {
+            slot = &slots_[position & mask_];
+            const size_t sequence = slot->sequence.load(std::memory_order_acquire);
+            const auto lag = static_cast<std::ptrdiff_t>(sequence - position);
+            if (lag == 0) {
+                if (enqueuePosition_.compare_exchange_weak(position, position + 1, std::memory_order_relaxed)) {
+                    break;
+                }
+            } else if (lag < 0) {
+                droppedEvents_.fetch_add(1, std::memory_order_relaxed);
+                return false;
+            } else {
+                position = enqueuePosition_.load(std::memory_order_relaxed);
+            }
+        }
+        
+        auto* event = new (slot->storage) Event<EventType>(std::forward<Args>(args)...);
+        event->priority = priority;
+        event->sequenceId = position;
+        slot->sequence.store(position + 1, std::memory_order_release);
+        return true;
+    }
+    
+    template<typename... Args>
+    bool tryPublish(Args&&... args) {
+        return tryPublish(EventPriority::Normal, std::forward<Args>(args)...);
+    }
+    
+    // Consumer thread only: visits and destroys queued events in publish order (0 = all)
+    template<typename Visitor>
+    size_t drain(Visitor&& visitor, size_t maxEvents = 0) {
+        size_t drained = 0;
+        while (maxEvents == 0 || drained < maxEvents) {
+            Slot& slot = slots_[dequeuePosition_ & mask_];
+            if (slot.sequence.load(std::memory_order_acquire) != dequeuePosition_ + 1) {
+                break;
+            }
+            
+            auto* event = std::launder(reinterpret_cast<Event<EventType>*>(slot.storage));
+            visitor(*event);
+            event->~Event<EventType>();
+            slot.sequence.store(dequeuePosition_ + mask_ + 1, std::memory_order_release);
+            ++dequeuePosition_;
+            ++drained;
+        }
+        return drained;
+    }
+    
+    size_t dispatchTo(EventBus& bus, size_t maxEvents) override;
+    
+    size_t getCapacity() const { return mask_ + 1; }
+    uint64_t getDroppedCount() const { return droppedEvents_.load(std::memory_order_relaxed); }
+
+private:
+    struct Slot {
+        std::atomic<size_t> sequence{0};
+        alignas(Event<EventType>) unsigned char storage[sizeof(Event<EventType>)];
+    };
+    
+    const size_t mask_;
+    std::unique_ptr<Slot[]> slots_;
+    alignas(64) std::atomic<size_t> enqueuePosition_{0};
+    alignas(64) size_t dequeuePosition_ = 0;
+    std::atomic<uint64_t> droppedEvents_{0};
+};
+
 // Thread-safe, high-performance event bus
 class EventBus {
 public:
@@ -201,6 +337,37 @@ public:
         }
     }
     
+    // Synchronous dispatch of an event built on the stack, skipping the allocation publish() makes
+    template<typename EventType, typename... Args>
+    void publishNow(Args&&... args) {
+        Event<EventType> event(std::forward<Args>(args)...);
+        event.sequenceId = nextSequenceId_.fetch_add(1, std::memory_order_relaxed);
+        dispatchImmediate(event, std::type_index(typeid(EventType)));
+    }
+    
+    // Channel for a high-frequency event type, created on first use with capacity rounded up to a power of
+    // two. The lookup locks, so producers should keep the returned reference; publishing through it never
+    // allocates. processChannels() delivers the queued events to this type's listeners
+    template<typename EventType>
+    EventChannel<EventType>& channel(size_t capacity = DEFAULT_CHANNEL_CAPACITY) {
+        std::unique_lock lock(channelsMutex_);
+        auto& entry = channels_[std::type_index(typeid(EventType))];
+        if (!entry) {
+            entry = std::make_unique<EventChannel<EventType>>(std::bit_ceil(std::max<size_t>(capacity, 2)));
+        }
+        return static_cast<EventChannel<EventType>&>(*entry);
+    }
+    
+    // Drains every channel on the calling thread (maxEventsPerChannel 0 = all); returns events dispatched
+    size_t processChannels(size_t maxEventsPerChannel = 0) {
+        std::shared_lock lock(channelsMutex_);
+        size_t dispatched = 0;
+        for (auto& [type, eventChannel] : channels_) {
+            dispatched += eventChannel->dispatchTo(*this, maxEventsPerChannel);
+        }
+        return dispatched;
+    }
+    
     template<typename EventType>
     void publish(const EventType& eventData, ProcessingMode mode = ProcessingMode::Conditional) {
         publish<EventType>(mode, eventData);
@@ -217,7 +384,9 @@ public:
         return subscribeWithFilter<EventType>(std::forward<HandlerType>(handler), nullptr, name);
     }
     
-    template<typename EventType, EventHandler<EventType> HandlerType, EventFilter<EventType> FilterType>
+    // filter may be nullptr, which subscribe() passes for no filter
+    template<typename EventType, EventHandler<EventType> HandlerType, typename FilterType>
+        requires EventFilter<FilterType, EventType> || std::is_null_pointer_v<std::decay_t<FilterType>>
     EventListenerHandle subscribeWithFilter(HandlerType&& handler, FilterType&& filter, 
                                            const std::string& name = "") {
         
@@ -252,6 +421,7 @@ public:
             std::unique_lock lock(listenersMutex_);
             listeners_[eventType].push_back(listener);
         }
+        stats_.activeListeners.fetch_add(1, std::memory_order_relaxed);
         
         return EventListenerHandle(listener->id, eventType, this);
     }
@@ -330,7 +500,7 @@ public:
     bool setListenerEnabled(uint64_t listenerId, std::type_index eventType, bool enabled);
     
     // Event processing
-    void processDeferred(size_t maxEvents = 0); // Process queued events (0 = all)
+    void processDeferred(size_t maxEvents = 0); // Process queued events (0 = all), one thread at a time
     void processUntilEmpty(); // Process all queued events
     size_t getQueueSize() const;
     
@@ -393,8 +563,14 @@ public:
     bool isThreadSafetyEnabled() const { return threadSafetyEnabled_; }
 
 private:
-    // Internal dispatch methods
+    template<typename EventType>
+    friend class EventChannel;
+    
+    static constexpr size_t DEFAULT_CHANNEL_CAPACITY = 1024;
+    
+    // Internal dispatch methods; dispatchImmediate counts the event as published, dispatchToListeners only delivers
     void dispatchImmediate(const BaseEvent& event, std::type_index eventType);
+    void dispatchToListeners(const BaseEvent& event, std::type_index eventType);
     void queueDeferred(std::unique_ptr<BaseEvent> event, std::type_index eventType);
     bool passesGlobalFilter(const BaseEvent& event, std::type_index eventType) const;
     void cleanupExpiredListeners();
@@ -408,12 +584,20 @@ private:
     // Event listeners grouped by type
     std::unordered_map<std::type_index, std::vector<std::shared_ptr<EventListener>>> listeners_;
     
-    // Deferred event queue (priority queue)
-    std::priority_queue<QueuedEvent> deferredQueue_;
+    // Deferred event queue (priority queue), its storage charged to the EventBus tag
+    std::priority_queue<QueuedEvent, std::pmr::vector<QueuedEvent>> deferredQueue_{
+        std::less<QueuedEvent>(), std::pmr::vector<QueuedEvent>(&MemoryTags::getResource(MemoryTag::EventBus))};
+    
+    // Events processDeferred() took off the queue, dispatched outside the queue lock; kept for its capacity
+    std::pmr::vector<QueuedEvent> deferredBatch_{&MemoryTags::getResource(MemoryTag::EventBus)};
     
     // Global event filters
     std::unordered_map<std::type_index, std::function<bool(const BaseEvent&)>> globalFilters_;
     
+    // Per-type lock-free channels (map guarded by channelsMutex_, the channels themselves are not)
+    mutable std::shared_mutex channelsMutex_;
+    std::unordered_map<std::type_index, std::unique_ptr<EventChannelBase>> channels_;
+    
     // ID generation
     std::atomic<uint64_t> nextListenerId_{1};
     std::atomic<uint64_t> nextSequenceId_{1};
@@ -426,6 +610,14 @@ private:
     static constexpr std::chrono::seconds CLEANUP_INTERVAL{30}; // Cleanup expired listeners every 30s
 };
 
+template<typename EventType>
+size_t EventChannel<EventType>::dispatchTo(EventBus& bus, size_t maxEvents) {
+    const auto eventType = std::type_index(typeid(EventType));
+    return drain([&bus, eventType](const Event<EventType>& event) {
+        bus.dispatchImmediate(event, eventType);
+    }, maxEvents);
+}
+
 // Global event bus instance (optional convenience)
 namespace Global {
     EventBus& getEventBus();
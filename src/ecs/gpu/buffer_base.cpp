@@ -1,10 +1,13 @@
 #include "buffer_base.h"
 #include "../../vulkan/core/vulkan_context.h"
 #include "../../vulkan/resources/core/resource_coordinator.h"
+#include "../../vulkan/resources/core/command_executor.h"
 #include "../../vulkan/core/vulkan_function_loader.h"
 #include "../../vulkan/core/vulkan_utils.h"
 #include "../../vulkan/resources/core/resource_handle.h"
 #include "../../vulkan/core/vulkan_raii.h"
+#include "../../vulkan/core/deletion_queue.h"
+#include <algorithm>
 #include <iostream>
 
 BufferBase::BufferBase() {
@@ -14,29 +17,93 @@ BufferBase::~BufferBase() {
     cleanup();
 }
 
+MemoryAllocator* BufferBase::getMemoryAllocator() const {
+    return resourceCoordinator ? resourceCoordinator->getMemoryAllocator() : nullptr;
+}
+
+bool SparseBindBatch::submit(const VulkanContext& context) {
+    if (binds.empty()) {
+        return true;
+    }
+    
+    std::vector<VkSparseBufferMemoryBindInfo> bufferBinds;
+    bufferBinds.reserve(binds.size());
+    for (const auto& entry : binds) {
+        bufferBinds.push_back({entry.buffer, 1, &entry.bind});
+    }
+    
+    VkBindSparseInfo bindInfo{};
+    bindInfo.sType = VK_STRUCTURE_TYPE_BIND_SPARSE_INFO;
+    bindInfo.bufferBindCount = static_cast<uint32_t>(bufferBinds.size());
+    bindInfo.pBufferBinds = bufferBinds.data();
+    
+    const auto& vk = context.getLoader();
+    const VkDevice device = context.getDevice();
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    VkFence fence = VK_NULL_HANDLE;
+    if (vk.vkCreateFence(device, &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+        std::cerr << "SparseBindBatch: Failed to create fence" << std::endl;
+        return false;
+    }
+    
+    // Later submits only touch the new ranges after this returns, so a host wait is all the ordering they need
+    const VkResult result = vk.vkQueueBindSparse(context.getTransferQueue(), 1, &bindInfo, fence);
+    const bool bound = result == VK_SUCCESS && vk.vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX) == VK_SUCCESS;
+    vk.vkDestroyFence(device, fence, nullptr);
+    if (!bound) {
+        std::cerr << "SparseBindBatch: Failed to bind " << binds.size() << " sparse ranges (VkResult: " << result << ")" << std::endl;
+        return false;
+    }
+    binds.clear();
+    return true;
+}
+
 bool BufferBase::initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, 
-                           uint32_t maxElements, VkDeviceSize elementSize, VkBufferUsageFlags usage) {
+                           uint32_t maxElements, VkDeviceSize elementSize, VkBufferUsageFlags usage,
+                           uint32_t reservedElements) {
     this->context = &context;
     this->resourceCoordinator = resourceCoordinator;
     this->maxElements = maxElements;
     this->elementSize = elementSize;
     this->bufferSize = maxElements * elementSize;
     
-    // Standard buffer usage for entity data
+    // Standard buffer usage for entity data (transfer source so contents survive a resize)
     const VkBufferUsageFlags standardUsage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | 
                                             VK_BUFFER_USAGE_VERTEX_BUFFER_BIT | 
+                                            VK_BUFFER_USAGE_TRANSFER_SRC_BIT |
                                             VK_BUFFER_USAGE_TRANSFER_DST_BIT;
     
     // Allow subclasses to add specific usage flags
-    const VkBufferUsageFlags finalUsage = standardUsage | usage | getAdditionalUsageFlags();
+    usageFlags = standardUsage | usage | getAdditionalUsageFlags();
+    if (context.supportsBufferDeviceAddress()) {
+        usageFlags |= VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR;
+    }
+    
+    // Descriptors bind the whole reservation, so it has to fit one storage buffer range
+    this->reservedElements = 0;
+    if (reservedElements > maxElements && context.supportsSparseEntityBuffers() && !externalExport && !renderDeviceMirror) {
+        VkPhysicalDeviceProperties properties{};
+        context.getLoader().vkGetPhysicalDeviceProperties(context.getPhysicalDevice(), &properties);
+        if (reservedElements * elementSize <= properties.limits.maxStorageBufferRange) {
+            this->reservedElements = reservedElements;
+        }
+    }
     
-    if (!createBuffer(bufferSize, finalUsage)) {
+    const bool created = isSparse() ? createSparseBuffer(this->reservedElements * elementSize, usageFlags)
+                                    : createBuffer(bufferSize, usageFlags);
+    if (!created) {
         std::cerr << "BufferBase: Failed to create " << getBufferTypeName() << " buffer" << std::endl;
+        this->reservedElements = 0;
         return false;
     }
     
     std::cout << "BufferBase: Initialized " << getBufferTypeName() << " buffer for " 
-              << maxElements << " elements (" << bufferSize << " bytes)" << std::endl;
+              << maxElements << " elements (" << bufferSize << " bytes";
+    if (isSparse()) {
+        std::cout << ", sparse reservation for " << this->reservedElements;
+    }
+    std::cout << ")" << std::endl;
     return true;
 }
 
@@ -46,7 +113,84 @@ void BufferBase::cleanup() {
     resourceCoordinator = nullptr;
     maxElements = 0;
     elementSize = 0;
+    usageFlags = 0;
     bufferSize = 0;
+    allocationSize = 0;
+    reservedElements = 0;
+}
+
+bool BufferBase::resize(uint32_t newMaxElements, bool preserveContents, SparseBindBatch* sparseBinds) {
+    if (!isInitialized() || !resourceCoordinator) {
+        std::cerr << "BufferBase: Cannot resize - " << getBufferTypeName() << " buffer not initialized" << std::endl;
+        return false;
+    }
+    
+    if (newMaxElements <= maxElements) {
+        return true;
+    }
+    
+    if (isSparse()) {
+        if (!canGrowInPlace(newMaxElements)) {
+            std::cerr << "BufferBase: " << getBufferTypeName() << " buffer cannot grow past its sparse reservation of "
+                      << reservedElements << " elements" << std::endl;
+            return false;
+        }
+        
+        const VkDeviceSize newSize = newMaxElements * elementSize;
+        SparseBindBatch ownBinds;
+        if (!bindSparsePages(newSize, sparseBinds ? *sparseBinds : ownBinds) || !ownBinds.submit(*context)) {
+            std::cerr << "BufferBase: Failed to bind pages growing " << getBufferTypeName() << " buffer to " << newSize << " bytes" << std::endl;
+            return false;
+        }
+        
+        std::cout << "BufferBase: Grew sparse " << getBufferTypeName() << " buffer from " << maxElements
+                  << " to " << newMaxElements << " elements (" << newSize << " bytes) in place" << std::endl;
+        maxElements = newMaxElements;
+        bufferSize = newSize;
+        return true;
+    }
+    
+    VkBuffer oldBuffer = buffer;
+    VkBuffer oldAlias = renderInstanceBuffer;
+    VkDeviceMemory oldMemory = bufferMemory;
+    const VkDeviceAddress oldAddress = deviceAddress;
+    const VkDeviceSize oldSize = bufferSize;
+    const VkDeviceSize oldAllocationSize = allocationSize;
+    const uint32_t oldMemoryType = bufferMemoryType;
+    const VkDeviceSize newSize = newMaxElements * elementSize;
+    
+    buffer = VK_NULL_HANDLE;
+    renderInstanceBuffer = VK_NULL_HANDLE;
+    bufferMemory = VK_NULL_HANDLE;
+    if (!createBuffer(newSize, usageFlags)) {
+        std::cerr << "BufferBase: Failed to grow " << getBufferTypeName() << " buffer to " << newSize << " bytes" << std::endl;
+        buffer = oldBuffer;
+        renderInstanceBuffer = oldAlias;
+        bufferMemory = oldMemory;
+        deviceAddress = oldAddress;
+        allocationSize = oldAllocationSize;
+        bufferMemoryType = oldMemoryType;
+        return false;
+    }
+    
+    if (preserveContents) {
+        resourceCoordinator->getCommandExecutor()->copyBufferToBuffer(oldBuffer, buffer, oldSize);
+    }
+    
+    // Buffers go before the memory they are bound to
+    DeletionQueue* deletionQueue = resourceCoordinator->getDeletionQueue();
+    deletionQueue->retire(vulkan_raii::make_buffer(oldBuffer, context));
+    deletionQueue->retire(vulkan_raii::make_buffer(oldAlias, context));
+    deletionQueue->retire(vulkan_raii::make_device_memory(oldMemory, context));
+    if (MemoryAllocator* allocator = getMemoryAllocator()) {
+        allocator->recordExternalFree(oldMemoryType, oldAllocationSize);
+    }
+    
+    std::cout << "BufferBase: Grew " << getBufferTypeName() << " buffer from " << maxElements 
+              << " to " << newMaxElements << " elements (" << newSize << " bytes)" << std::endl;
+    maxElements = newMaxElements;
+    bufferSize = newSize;
+    return true;
 }
 
 bool BufferBase::copyData(const void* data, VkDeviceSize size, VkDeviceSize offset) {
@@ -98,6 +242,13 @@ bool BufferBase::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage) {
     bufferInfo.usage = usage;
     bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
     
+    VkExternalMemoryBufferCreateInfoKHR externalInfo{};
+    externalInfo.sType = VK_STRUCTURE_TYPE_EXTERNAL_MEMORY_BUFFER_CREATE_INFO_KHR;
+    externalInfo.handleTypes = EXTERNAL_MEMORY_HANDLE_TYPE;
+    if (externalExport) {
+        bufferInfo.pNext = &externalInfo;
+    }
+    
     const auto& vk = context->getLoader();
     const VkDevice device = context->getDevice();
     
@@ -115,6 +266,34 @@ bool BufferBase::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage) {
         context->getPhysicalDevice(), vk, memRequirements.memoryTypeBits, 
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
     
+    // Device-addressable buffers must be bound to memory allocated with the address flag
+    VkMemoryAllocateFlagsInfoKHR allocFlags{};
+    allocFlags.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO_KHR;
+    allocFlags.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT_KHR;
+    const bool addressable = (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR) != 0;
+    if (addressable) {
+        allocInfo.pNext = &allocFlags;
+    }
+    
+    // Exported memory backs this buffer alone, which is how the consumer imports it
+    VkMemoryDedicatedAllocateInfoKHR dedicatedInfo{};
+    dedicatedInfo.sType = VK_STRUCTURE_TYPE_MEMORY_DEDICATED_ALLOCATE_INFO_KHR;
+    dedicatedInfo.buffer = buffer;
+    VkExportMemoryAllocateInfoKHR exportInfo{};
+    exportInfo.sType = VK_STRUCTURE_TYPE_EXPORT_MEMORY_ALLOCATE_INFO_KHR;
+    exportInfo.handleTypes = EXTERNAL_MEMORY_HANDLE_TYPE;
+    if (externalExport) {
+        dedicatedInfo.pNext = allocInfo.pNext;
+        exportInfo.pNext = &dedicatedInfo;
+        allocInfo.pNext = &exportInfo;
+    }
+    
+    MemoryAllocator* allocator = getMemoryAllocator();
+    VkMemoryPriorityAllocateInfoEXT priorityInfo{};
+    if (allocator) {
+        allocator->applyPriority(allocInfo, priorityInfo, getMemoryPriority());
+    }
+    
     if (vk.vkAllocateMemory(device, &allocInfo, nullptr, &bufferMemory) != VK_SUCCESS) {
         vk.vkDestroyBuffer(device, buffer, nullptr);
         buffer = VK_NULL_HANDLE;
@@ -122,6 +301,143 @@ bool BufferBase::createBuffer(VkDeviceSize size, VkBufferUsageFlags usage) {
     }
     
     vk.vkBindBufferMemory(device, buffer, bufferMemory, 0);
+    allocationSize = memRequirements.size;
+    
+    if (renderDeviceMirror && context->isMultiDeviceSimulation() && !createRenderInstanceAlias(bufferInfo)) {
+        vk.vkDestroyBuffer(device, buffer, nullptr);
+        vk.vkFreeMemory(device, bufferMemory, nullptr);
+        buffer = VK_NULL_HANDLE;
+        bufferMemory = VK_NULL_HANDLE;
+        return false;
+    }
+    
+    bufferMemoryType = allocInfo.memoryTypeIndex;
+    if (allocator) {
+        allocator->recordExternalAllocation(bufferMemoryType, allocationSize);
+    }
+    
+    deviceAddress = 0;
+    if (addressable) {
+        VkBufferDeviceAddressInfoKHR addressInfo{};
+        addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO_KHR;
+        addressInfo.buffer = buffer;
+        deviceAddress = vk.vkGetBufferDeviceAddressKHR(device, &addressInfo);
+    }
+    return true;
+}
+
+bool BufferBase::createRenderInstanceAlias(const VkBufferCreateInfo& bufferInfo) {
+    const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
+    
+    if (vk.vkCreateBuffer(device, &bufferInfo, nullptr, &renderInstanceBuffer) != VK_SUCCESS) {
+        renderInstanceBuffer = VK_NULL_HANDLE;
+        return false;
+    }
+    
+    // Indexed by the binding GPU: each one, the simulation GPU included, reaches device index 0's instance
+    const uint32_t deviceIndices[2] = {0, 0};
+    VkBindBufferMemoryDeviceGroupInfoKHR deviceGroupBind{};
+    deviceGroupBind.sType = VK_STRUCTURE_TYPE_BIND_BUFFER_MEMORY_DEVICE_GROUP_INFO_KHR;
+    deviceGroupBind.deviceIndexCount = 2;
+    deviceGroupBind.pDeviceIndices = deviceIndices;
+    VkBindBufferMemoryInfoKHR bindInfo{};
+    bindInfo.sType = VK_STRUCTURE_TYPE_BIND_BUFFER_MEMORY_INFO_KHR;
+    bindInfo.pNext = &deviceGroupBind;
+    bindInfo.buffer = renderInstanceBuffer;
+    bindInfo.memory = bufferMemory;
+    bindInfo.memoryOffset = 0;
+    if (vk.vkBindBufferMemory2KHR(device, 1, &bindInfo) != VK_SUCCESS) {
+        std::cerr << "BufferBase: Failed to alias the rendering GPU's " << getBufferTypeName() << " buffer" << std::endl;
+        vk.vkDestroyBuffer(device, renderInstanceBuffer, nullptr);
+        renderInstanceBuffer = VK_NULL_HANDLE;
+        return false;
+    }
+    return true;
+}
+
+bool BufferBase::createSparseBuffer(VkDeviceSize size, VkBufferUsageFlags usage) {
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.flags = VK_BUFFER_CREATE_SPARSE_BINDING_BIT | VK_BUFFER_CREATE_SPARSE_RESIDENCY_BIT;
+    bufferInfo.size = size;
+    bufferInfo.usage = usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    
+    const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
+    
+    if (vk.vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
+        return false;
+    }
+    
+    // The alignment is the sparse page size; every bind covers whole pages
+    VkMemoryRequirements memRequirements;
+    vk.vkGetBufferMemoryRequirements(device, buffer, &memRequirements);
+    sparsePageSize = memRequirements.alignment;
+    sparseReservedSize = memRequirements.size;
+    sparseMemoryType = VulkanUtils::findMemoryType(
+        context->getPhysicalDevice(), vk, memRequirements.memoryTypeBits,
+        VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    sparseBoundSize = 0;
+    
+    SparseBindBatch initialBinds;
+    if (!bindSparsePages(bufferSize, initialBinds) || !initialBinds.submit(*context)) {
+        destroyBuffer();
+        return false;
+    }
+    
+    deviceAddress = 0;
+    if (usage & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR) {
+        VkBufferDeviceAddressInfoKHR addressInfo{};
+        addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO_KHR;
+        addressInfo.buffer = buffer;
+        deviceAddress = vk.vkGetBufferDeviceAddressKHR(device, &addressInfo);
+    }
+    return true;
+}
+
+bool BufferBase::bindSparsePages(VkDeviceSize size, SparseBindBatch& sparseBinds) {
+    const VkDeviceSize boundTarget = std::min((size + sparsePageSize - 1) / sparsePageSize * sparsePageSize, sparseReservedSize);
+    if (boundTarget <= sparseBoundSize) {
+        return true;
+    }
+    
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = boundTarget - sparseBoundSize;
+    allocInfo.memoryTypeIndex = sparseMemoryType;
+    
+    VkMemoryAllocateFlagsInfoKHR allocFlags{};
+    allocFlags.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO_KHR;
+    allocFlags.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT_KHR;
+    if (usageFlags & VK_BUFFER_USAGE_SHADER_DEVICE_ADDRESS_BIT_KHR) {
+        allocInfo.pNext = &allocFlags;
+    }
+    
+    MemoryAllocator* allocator = getMemoryAllocator();
+    VkMemoryPriorityAllocateInfoEXT priorityInfo{};
+    if (allocator) {
+        allocator->applyPriority(allocInfo, priorityInfo, getMemoryPriority());
+    }
+    
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    if (context->getLoader().vkAllocateMemory(context->getDevice(), &allocInfo, nullptr, &memory) != VK_SUCCESS) {
+        return false;
+    }
+    if (allocator) {
+        allocator->recordExternalAllocation(sparseMemoryType, allocInfo.allocationSize);
+    }
+    
+    VkSparseMemoryBind bind{};
+    bind.resourceOffset = sparseBoundSize;
+    bind.size = allocInfo.allocationSize;
+    bind.memory = memory;
+    bind.memoryOffset = 0;
+    sparseBinds.add(buffer, bind);
+    
+    sparseMemory.push_back(memory);
+    sparseBoundSize = boundTarget;
     return true;
 }
 
@@ -134,10 +450,29 @@ void BufferBase::destroyBuffer() {
     if (buffer != VK_NULL_HANDLE) {
         vk.vkDestroyBuffer(device, buffer, nullptr);
         buffer = VK_NULL_HANDLE;
+        deviceAddress = 0;
+    }
+    
+    if (renderInstanceBuffer != VK_NULL_HANDLE) {
+        vk.vkDestroyBuffer(device, renderInstanceBuffer, nullptr);
+        renderInstanceBuffer = VK_NULL_HANDLE;
     }
     
+    MemoryAllocator* allocator = getMemoryAllocator();
     if (bufferMemory != VK_NULL_HANDLE) {
         vk.vkFreeMemory(device, bufferMemory, nullptr);
         bufferMemory = VK_NULL_HANDLE;
+        if (allocator) {
+            allocator->recordExternalFree(bufferMemoryType, allocationSize);
+        }
+    }
+    
+    for (VkDeviceMemory memory : sparseMemory) {
+        vk.vkFreeMemory(device, memory, nullptr);
+    }
+    if (allocator && !sparseMemory.empty()) {
+        allocator->recordExternalFree(sparseMemoryType, sparseBoundSize);
     }
+    sparseMemory.clear();
+    sparseBoundSize = 0;
 }
\ No newline at end of file
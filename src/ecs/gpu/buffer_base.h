@@ -1,12 +1,35 @@
 #pragma once
 
 #include "buffer_operations_interface.h"
+#include "../../vulkan/resources/core/memory_allocator.h"
 #include <vulkan/vulkan.h>
+#include <vector>
 
 // Forward declarations
 class VulkanContext;
 class ResourceCoordinator;
 
+/**
+ * Page binds gathered from several sparse buffers' resize calls, submitted together as one vkQueueBindSparse
+ * on the transfer queue. The buffers already report their new size; nothing may use the new range before
+ * submit() returns.
+ */
+class SparseBindBatch {
+public:
+    void add(VkBuffer buffer, const VkSparseMemoryBind& bind) { binds.push_back({buffer, bind}); }
+    bool empty() const { return binds.empty(); }
+    
+    // Waits for the binds to land; false leaves the new ranges unbacked
+    bool submit(const VulkanContext& context);
+
+private:
+    struct BufferBind {
+        VkBuffer buffer;
+        VkSparseMemoryBind bind;
+    };
+    std::vector<BufferBind> binds;
+};
+
 /**
  * Base class providing common buffer operations to avoid code duplication
  * while allowing specialized buffer classes to maintain SRP
@@ -20,16 +43,46 @@ public:
     VkBuffer getBuffer() const override { return buffer; }
     VkDeviceSize getSize() const override { return bufferSize; }
     uint32_t getMaxElements() const override { return maxElements; }
+    VkDeviceSize getElementSize() const { return elementSize; }
     bool isInitialized() const override { return buffer != VK_NULL_HANDLE; }
     
+    // GPU address of the current allocation, 0 without buffer device address support; changes on resize
+    VkDeviceAddress getDeviceAddress() const { return deviceAddress; }
+    
     // Common buffer operations
     bool copyData(const void* data, VkDeviceSize size, VkDeviceSize offset = 0) override;
     bool readData(void* data, VkDeviceSize size, VkDeviceSize offset = 0) const override;
     
-    // Lifecycle
+    // Lifecycle. reservedElements above maxElements reserves address space for that many elements as a sparse
+    // residency buffer when the device supports it (VulkanContext::supportsSparseEntityBuffers); only the first
+    // maxElements are backed by memory
     virtual bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, 
-                           uint32_t maxElements, VkDeviceSize elementSize, VkBufferUsageFlags usage);
+                           uint32_t maxElements, VkDeviceSize elementSize, VkBufferUsageFlags usage,
+                           uint32_t reservedElements = 0);
     virtual void cleanup();
+    
+    // Reallocate for more elements, optionally GPU-copying the old contents; when it does, the caller
+    // guarantees no submitted work still writes the old buffer. The old buffer and memory are retired into
+    // the coordinator's DeletionQueue, so frames in flight may go on reading them.
+    // Within a sparse reservation the buffer instead keeps its handle, address and contents and only binds
+    // pages for the new range (queued into sparseBinds when given, submitted here otherwise); work in flight
+    // may keep using the old range
+    bool resize(uint32_t newMaxElements, bool preserveContents, SparseBindBatch* sparseBinds = nullptr);
+    bool canGrowInPlace(uint32_t newMaxElements) const { return newMaxElements <= reservedElements; }
+    bool isSparse() const { return reservedElements > 0; }
+    
+    // Set before initialize(): every allocation is then a dedicated, exportable one of EXTERNAL_MEMORY_HANDLE_TYPE
+    // (VulkanContext::supportsExternalPositionExport) and never sparse, so each resize gets new memory to export
+    void setExternalExport(bool exportable) { externalExport = exportable; }
+    bool isExternallyExported() const { return externalExport; }
+    VkDeviceMemory getMemory() const { return bufferMemory; }
+    VkDeviceSize getAllocationSize() const { return allocationSize; }  // What an import of getMemory() must ask for
+    
+    // Set before initialize(): under multi-device simulation every allocation, never sparse, also gets an alias
+    // bound to the rendering GPU's instance of the memory on every GPU of the group, so the simulation GPU can
+    // copy into what the rendering GPU reads. getBuffer() itself without multi-device simulation
+    void setRenderDeviceMirror(bool mirrored) { renderDeviceMirror = mirrored; }
+    VkBuffer getRenderInstanceBuffer() const { return renderInstanceBuffer != VK_NULL_HANDLE ? renderInstanceBuffer : buffer; }
 
 protected:
     // Shared buffer resources
@@ -37,7 +90,22 @@ protected:
     VkDeviceMemory bufferMemory = VK_NULL_HANDLE;
     VkDeviceSize bufferSize = 0;
     VkDeviceSize elementSize = 0;
+    VkBufferUsageFlags usageFlags = 0;
     uint32_t maxElements = 0;
+    VkDeviceAddress deviceAddress = 0;
+    VkDeviceSize allocationSize = 0;
+    uint32_t bufferMemoryType = 0;
+    bool externalExport = false;
+    bool renderDeviceMirror = false;
+    VkBuffer renderInstanceBuffer = VK_NULL_HANDLE;
+    
+    // Sparse residency (reservedElements 0 for a dedicated allocation): one memory block per growth
+    uint32_t reservedElements = 0;
+    VkDeviceSize sparsePageSize = 0;
+    VkDeviceSize sparseBoundSize = 0;     // Backed prefix, whole pages
+    VkDeviceSize sparseReservedSize = 0;
+    uint32_t sparseMemoryType = 0;
+    std::vector<VkDeviceMemory> sparseMemory;
     
     // Dependencies
     const VulkanContext* context = nullptr;
@@ -47,8 +115,17 @@ protected:
     virtual VkBufferUsageFlags getAdditionalUsageFlags() const { return 0; }
     virtual const char* getBufferTypeName() const = 0;
     
+    // Residency priority of every allocation, sparse pages included; High for the streams every frame reads
+    virtual MemoryAllocator::Priority getMemoryPriority() const { return MemoryAllocator::Priority::Normal; }
+    
 private:
+    // The allocation itself bypasses the allocator, which still counts it into its heap usage
+    MemoryAllocator* getMemoryAllocator() const;
+
     // Common implementation shared by all buffer types
     bool createBuffer(VkDeviceSize size, VkBufferUsageFlags usage);
+    bool createRenderInstanceAlias(const VkBufferCreateInfo& bufferInfo);
+    bool createSparseBuffer(VkDeviceSize size, VkBufferUsageFlags usage);
+    bool bindSparsePages(VkDeviceSize size, SparseBindBatch& sparseBinds);
     void destroyBuffer();
 };
\ No newline at end of file
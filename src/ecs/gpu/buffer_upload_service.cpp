@@ -1,5 +1,6 @@
 #include "buffer_upload_service.h"
 #include "../../vulkan/resources/core/resource_coordinator.h"
+#include "../../vulkan/resources/buffers/buffer_manager.h"
 #include <iostream>
 
 BufferUploadService::BufferUploadService() {
@@ -25,34 +26,45 @@ void BufferUploadService::cleanup() {
     resourceCoordinator = nullptr;
 }
 
-bool BufferUploadService::uploadBatch(const std::vector<UploadOperation>& operations) {
-    if (!resourceCoordinator) {
+CommandExecutor::AsyncTransfer BufferUploadService::uploadBatch(const std::vector<UploadOperation>& operations) {
+    if (!resourceCoordinator || !resourceCoordinator->getBufferManager()) {
         std::cerr << "BufferUploadService: Not initialized" << std::endl;
-        return false;
+        return {};
     }
     
-    bool allSucceeded = true;
+    // Non-owning handles for the batch; reserved up front so the batch's pointers stay put
+    std::vector<ResourceHandle> handles;
+    handles.reserve(operations.size());
+    BufferManager::TransferBatch batch;
     
     for (const auto& op : operations) {
-        if (!op.buffer || !op.buffer->isInitialized()) {
+        if (op.dst == VK_NULL_HANDLE || !op.data) {
             std::cerr << "BufferUploadService: Invalid buffer in batch operation" << std::endl;
-            allSucceeded = false;
             continue;
         }
         
-        if (!validateUpload(*op.buffer, op.size, op.offset)) {
+        if (op.size == 0 || (op.capacity != VK_WHOLE_SIZE && op.offset + op.size > op.capacity)) {
             std::cerr << "BufferUploadService: Validation failed for batch operation" << std::endl;
-            allSucceeded = false;
             continue;
         }
         
-        if (!op.buffer->copyData(op.data, op.size, op.offset)) {
-            std::cerr << "BufferUploadService: Failed to upload data in batch operation" << std::endl;
-            allSucceeded = false;
-        }
+        ResourceHandle& handle = handles.emplace_back();
+        handle.buffer = vulkan_raii::make_buffer(op.dst, resourceCoordinator->getContext());
+        handle.size = op.capacity;
+        batch.addTransfer(op.data, &handle, op.size, op.offset);
+    }
+    
+    CommandExecutor::AsyncTransfer transfer = resourceCoordinator->getBufferManager()->executeBatchAsync(batch);
+    
+    // Detach to prevent cleanup of the existing buffers
+    for (auto& handle : handles) {
+        handle.buffer.detach();
     }
     
-    return allSucceeded;
+    if (!batch.empty() && !transfer.isValid()) {
+        std::cerr << "BufferUploadService: Failed to submit batch of " << batch.size() << " uploads" << std::endl;
+    }
+    return transfer;
 }
 
 bool BufferUploadService::validateUpload(const IBufferOperations& buffer, VkDeviceSize size, VkDeviceSize offset) const {
@@ -75,9 +87,12 @@ bool BufferUploadService::validateUpload(const IBufferOperations& buffer, VkDevi
     return true;
 }
 
-bool BufferUploadService::readback(VkBuffer buffer, void* data, VkDeviceSize size, VkDeviceSize offset) {
-    // For debug readback, we need to implement a simple staging buffer approach
-    // This is expensive and should only be used for debugging
-    std::cerr << "BufferUploadService::readback: GPU readback not implemented yet - spatial map data not available" << std::endl;
-    return false;
+bool BufferUploadService::readbackAsync(VkBuffer buffer, VkDeviceSize size, VkDeviceSize offset, ReadbackRing::Callback callback) {
+    ReadbackRing* ring = resourceCoordinator ? resourceCoordinator->getReadbackRing() : nullptr;
+    if (!ring) {
+        std::cerr << "BufferUploadService: Readback ring not available" << std::endl;
+        return false;
+    }
+    
+    return ring->request(buffer, offset, size, std::move(callback));
 }
\ No newline at end of file
@@ -1,6 +1,8 @@
 #pragma once
 
 #include "buffer_operations_interface.h"
+#include "../../vulkan/resources/core/command_executor.h"
+#include "../../vulkan/resources/core/readback_ring.h"
 #include <vulkan/vulkan.h>
 #include <vector>
 
@@ -34,16 +36,24 @@ public:
     
     // Batch upload operations for multiple buffers
     struct UploadOperation {
-        IBufferOperations* buffer;
+        VkBuffer dst = VK_NULL_HANDLE;
+        VkDeviceSize capacity = 0;  // VK_WHOLE_SIZE when the caller has bounds-checked the range itself
         const void* data;
         VkDeviceSize size;
         VkDeviceSize offset;
         
         UploadOperation(IBufferOperations* buf, const void* d, VkDeviceSize s, VkDeviceSize o = 0)
-            : buffer(buf), data(d), size(s), offset(o) {}
+            : dst(buf && buf->isInitialized() ? buf->getBuffer() : VK_NULL_HANDLE),
+              capacity(buf ? buf->getSize() : 0), data(d), size(s), offset(o) {}
+        
+        UploadOperation(VkBuffer buffer, const void* d, VkDeviceSize s, VkDeviceSize o = 0)
+            : dst(buffer), capacity(VK_WHOLE_SIZE), data(d), size(s), offset(o) {}
     };
     
-    bool uploadBatch(const std::vector<UploadOperation>& operations);
+    // Every operation shares one staging allocation and one transfer submit (see
+    // TransferOrchestrator::executeBatchAsync); invalid operations are logged and skipped.
+    // The returned transfer is owned by the caller, who waits on or polls it and then frees it
+    CommandExecutor::AsyncTransfer uploadBatch(const std::vector<UploadOperation>& operations);
     
     // Upload with validation
     template<typename BufferType>
@@ -67,8 +77,22 @@ public:
         return buffer.readData(data, size, offset);
     }
     
+    // Non-blocking readback through the coordinator's ReadbackRing: the copy is recorded into an upcoming
+    // frame and callback runs once that frame's fences have signalled, typically framesInFlight frames later
+    template<typename BufferType>
+    bool readbackAsync(BufferType& buffer, VkDeviceSize size, VkDeviceSize offset, ReadbackRing::Callback callback) {
+        static_assert(std::is_base_of_v<IBufferOperations, BufferType>, 
+                     "BufferType must implement IBufferOperations");
+        
+        if (!buffer.isInitialized() || offset + size > buffer.getSize()) {
+            return false;
+        }
+        
+        return readbackAsync(buffer.getBuffer(), size, offset, std::move(callback));
+    }
+    
     // Direct VkBuffer readback for when we have the handle directly
-    bool readback(VkBuffer buffer, void* data, VkDeviceSize size, VkDeviceSize offset = 0);
+    bool readbackAsync(VkBuffer buffer, VkDeviceSize size, VkDeviceSize offset, ReadbackRing::Callback callback);
     
     // Access to resource coordinator for advanced operations
     ResourceCoordinator* getResourceCoordinator() const { return resourceCoordinator; }
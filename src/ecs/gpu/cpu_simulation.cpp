@@ -0,0 +1,450 @@
+#include "cpu_simulation.h"
+#include "gpu_entity_manager.h"
+#include "entity_snapshot.h"
+#include "../utilities/job_system.h"
+#include "../utilities/logger.h"
+#include "../../vulkan/core/vulkan_constants.h"
+#include <algorithm>
+#include <array>
+#include <bit>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <type_traits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define CPU_SIMULATION_AVX2 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define CPU_SIMULATION_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+    // movement_random.comp and physics.comp constants, in the same single precision
+    constexpr float TWO_PI = 6.28318530718f;
+    constexpr float INV_4294967295 = 2.3283064e-10f;
+    constexpr float COLLISION_RADIUS = 1.5f * 2.0f;  // TRIANGLE_RADIUS * 2
+    constexpr float COLLISION_RADIUS_SQ = COLLISION_RADIUS * COLLISION_RADIUS;
+    constexpr float MIN_CONTACT_DISTANCE_SQ = 0.000001f;
+    constexpr float SPEED_SCALE = 15.0f;
+    constexpr float VELOCITY_DAMPING = 0.998f;
+    constexpr float TOMBSTONE_POSITION = std::numeric_limits<float>::quiet_NaN();
+    
+    // physics.comp walks the entity's cell first, then the sides, then the diagonals
+    const std::array<glm::ivec2, 9> NEIGHBOUR_OFFSETS = {{
+        {0, 0}, {-1, 0}, {1, 0}, {0, -1}, {0, 1}, {-1, -1}, {1, -1}, {-1, 1}, {1, 1}
+    }};
+    
+    uint32_t fastHash(uint32_t seed) {
+        seed ^= seed >> 16u;
+        seed *= 0x7feb352du;
+        seed ^= seed >> 15u;
+        seed *= 0x846ca68bu;
+        seed ^= seed >> 16u;
+        return seed;
+    }
+    
+    float hashToFloat(uint32_t hash) {
+        return static_cast<float>(hash) * INV_4294967295;
+    }
+    
+    // Candidate the narrow phase stops at: the first in cell order that is not the entity itself and lies inside
+    // the collision radius without sitting on it; count when there is none. Tombstones are NaN and never match
+    uint32_t firstContactScalar(const float* x, const float* y, const uint32_t* indices, uint32_t count, glm::vec2 position, uint32_t self) {
+        for (uint32_t i = 0; i < count; ++i) {
+            if (indices[i] == self) continue;
+            const float dx = position.x - x[i];
+            const float dy = position.y - y[i];
+            const float distSq = dx * dx + dy * dy;
+            if (distSq < COLLISION_RADIUS_SQ && distSq > MIN_CONTACT_DISTANCE_SQ) {
+                return i;
+            }
+        }
+        return count;
+    }
+
+#if defined(CPU_SIMULATION_AVX2)
+    // The kernel is compiled for AVX2 on its own, so the rest of the build keeps its baseline target
+    bool cpuHasAvx2() {
+        static const bool supported = [] {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+        }();
+        return supported;
+    }
+    
+    __attribute__((target("avx2")))
+    uint32_t firstContactWide(const float* x, const float* y, const uint32_t* indices, uint32_t count, glm::vec2 position, uint32_t self) {
+        const __m256 px = _mm256_set1_ps(position.x), py = _mm256_set1_ps(position.y);
+        const __m256 limit = _mm256_set1_ps(COLLISION_RADIUS_SQ), floor = _mm256_set1_ps(MIN_CONTACT_DISTANCE_SQ);
+        const __m256i selfIndex = _mm256_set1_epi32(static_cast<int>(self));
+        uint32_t i = 0;
+        for (; i + 8 <= count; i += 8) {
+            const __m256 dx = _mm256_sub_ps(px, _mm256_loadu_ps(x + i));
+            const __m256 dy = _mm256_sub_ps(py, _mm256_loadu_ps(y + i));
+            const __m256 distSq = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            const __m256 contact = _mm256_and_ps(_mm256_cmp_ps(distSq, limit, _CMP_LT_OQ), _mm256_cmp_ps(distSq, floor, _CMP_GT_OQ));
+            const __m256i isSelf = _mm256_cmpeq_epi32(_mm256_loadu_si256(reinterpret_cast<const __m256i*>(indices + i)), selfIndex);
+            const uint32_t mask = static_cast<uint32_t>(_mm256_movemask_ps(_mm256_andnot_ps(_mm256_castsi256_ps(isSelf), contact)));
+            if (mask) {
+                return i + std::countr_zero(mask);
+            }
+        }
+        return i + firstContactScalar(x + i, y + i, indices + i, count - i, position, self);
+    }
+#elif defined(CPU_SIMULATION_NEON)
+    uint32_t firstContactWide(const float* x, const float* y, const uint32_t* indices, uint32_t count, glm::vec2 position, uint32_t self) {
+        static const uint32_t bitValues[4] = {1u, 2u, 4u, 8u};
+        const float32x4_t px = vdupq_n_f32(position.x), py = vdupq_n_f32(position.y);
+        const float32x4_t limit = vdupq_n_f32(COLLISION_RADIUS_SQ), floor = vdupq_n_f32(MIN_CONTACT_DISTANCE_SQ);
+        const uint32x4_t selfIndex = vdupq_n_u32(self);
+        uint32_t i = 0;
+        for (; i + 4 <= count; i += 4) {
+            const float32x4_t dx = vsubq_f32(px, vld1q_f32(x + i));
+            const float32x4_t dy = vsubq_f32(py, vld1q_f32(y + i));
+            const float32x4_t distSq = vaddq_f32(vmulq_f32(dx, dx), vmulq_f32(dy, dy));
+            const uint32x4_t contact = vbicq_u32(vandq_u32(vcltq_f32(distSq, limit), vcgtq_f32(distSq, floor)),
+                                                 vceqq_u32(vld1q_u32(indices + i), selfIndex));
+            const uint32_t mask = vaddvq_u32(vandq_u32(contact, vld1q_u32(bitValues)));
+            if (mask) {
+                return i + std::countr_zero(mask);
+            }
+        }
+        return i + firstContactScalar(x + i, y + i, indices + i, count - i, position, self);
+    }
+#endif
+
+    uint32_t firstContact(const float* x, const float* y, const uint32_t* indices, uint32_t count, glm::vec2 position, uint32_t self) {
+#if defined(CPU_SIMULATION_AVX2)
+        if (cpuHasAvx2()) {
+            return firstContactWide(x, y, indices, count, position, self);
+        }
+#elif defined(CPU_SIMULATION_NEON)
+        return firstContactWide(x, y, indices, count, position, self);
+#endif
+        return firstContactScalar(x, y, indices, count, position, self);
+    }
+    
+    bool isRandomWalker(uint32_t entityType) {
+        return ((entityType >> EntityTypeBuffer::MOVEMENT_SHIFT) & EntityTypeBuffer::MOVEMENT_MASK) ==
+               static_cast<uint32_t>(MovementType::RandomWalk);
+    }
+}
+
+void CpuSimulation::setFeatures(const ComputeShaderFeatures& newFeatures) {
+    features = newFeatures;
+    features.maxEntitiesPerCell = std::max(1u, features.maxEntitiesPerCell);
+    features.collisionStride = std::max(1u, features.collisionStride);
+}
+
+void CpuSimulation::resetState(size_t count) {
+    positions.resize(count);
+    previousPositions.resize(count);
+    velocities.resize(count);
+    movementParams.resize(count);
+    runtimeStates.resize(count);
+    colorParams.resize(count);
+    spawnIds.resize(count);
+    entityTypes.resize(count);
+    modelMatrices.clear();
+    telemetry = {};
+    totalTime = 0.0f;
+}
+
+void CpuSimulation::load(const GPUEntitySoA& entities) {
+    const size_t count = entities.size();
+    resetState(count);
+    velocities.assign(entities.velocities.begin(), entities.velocities.end());
+    movementParams.assign(entities.movementParams.begin(), entities.movementParams.end());
+    runtimeStates.assign(entities.runtimeStates.begin(), entities.runtimeStates.end());
+    colorParams.assign(entities.colorParams.begin(), entities.colorParams.end());
+    spawnIds.assign(entities.spawnIds.begin(), entities.spawnIds.end());
+    entityTypes.assign(entities.entityTypes.begin(), entities.entityTypes.end());
+    if (entities.storeModelMatrices) {
+        modelMatrices.assign(entities.modelMatrices.begin(), entities.modelMatrices.end());
+    }
+    
+    // Uploads write the spawn position to every position buffer
+    positions.assign(entities.spawnPositions.begin(), entities.spawnPositions.end());
+    previousPositions = positions;
+    spawnBoundsMin = spawnBoundsMax = count > 0 ? glm::vec2(positions[0]) : glm::vec2(0.0f);
+    for (const glm::vec4& position : positions) {
+        spawnBoundsMin = glm::min(spawnBoundsMin, glm::vec2(position));
+        spawnBoundsMax = glm::max(spawnBoundsMax, glm::vec2(position));
+    }
+    LOG_INFO("CpuSimulation: Loaded " << count << " entities");
+}
+
+bool CpuSimulation::loadSnapshot(const std::string& path) {
+    EntitySnapshotFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    
+    const EntitySnapshotHeader& header = file.getHeader();
+    if ((header.flags & EntitySnapshotHeader::FLAG_COMPACT_LAYOUT) != 0) {
+        LOG_ERROR("CpuSimulation: " << path << " was saved with the compact stream layout, which has no CPU backend");
+        return false;
+    }
+    const uint32_t count = header.entityCount;
+    
+    bool columnsValid = true;
+    auto column = [&](EntitySnapshotColumn id, auto& stream, bool required) {
+        using Element = typename std::remove_reference_t<decltype(stream)>::value_type;
+        size_t size = 0;
+        uint32_t elementSize = 0;
+        const void* data = file.getColumn(id, size, elementSize);
+        if (!data || elementSize != sizeof(Element) || size < sizeof(Element) * count) {
+            if (required) {
+                LOG_ERROR("CpuSimulation: Snapshot column " << static_cast<uint32_t>(id) << " is missing or has another stride");
+                columnsValid = false;
+            }
+            stream.clear();
+            return;
+        }
+        stream.resize(count);
+        std::memcpy(stream.data(), data, sizeof(Element) * count);
+    };
+    
+    resetState(count);
+    column(EntitySnapshotColumn::Velocity, velocities, true);
+    column(EntitySnapshotColumn::MovementParams, movementParams, true);
+    column(EntitySnapshotColumn::RuntimeState, runtimeStates, true);
+    column(EntitySnapshotColumn::ColorParams, colorParams, true);
+    column(EntitySnapshotColumn::Position, positions, true);
+    column(EntitySnapshotColumn::PreviousPosition, previousPositions, true);
+    column(EntitySnapshotColumn::SpawnId, spawnIds, true);
+    column(EntitySnapshotColumn::EntityType, entityTypes, true);
+    column(EntitySnapshotColumn::ModelMatrix, modelMatrices, false);
+    if (!columnsValid) {
+        resetState(0);
+        return false;
+    }
+    
+    spawnBoundsMin = glm::vec2(header.spawnBoundsMin[0], header.spawnBoundsMin[1]);
+    spawnBoundsMax = glm::vec2(header.spawnBoundsMax[0], header.spawnBoundsMax[1]);
+    totalTime = header.totalTime;
+    LOG_INFO("CpuSimulation: Restored " << count << " entities from " << path);
+    return true;
+}
+
+bool CpuSimulation::saveSnapshot(const std::string& path) const {
+    const uint32_t count = getEntityCount();
+    uint32_t spawnIdLimit = 0;
+    for (uint32_t spawnId : spawnIds) {
+        spawnIdLimit = std::max(spawnIdLimit, spawnId + 1);
+    }
+    
+    EntitySnapshotHeader header;
+    header.entityCount = count;
+    header.spawnIdLimit = spawnIdLimit;
+    header.frame = telemetry.ticks;
+    header.totalTime = totalTime;
+    header.spawnBoundsMin[0] = spawnBoundsMin.x;
+    header.spawnBoundsMin[1] = spawnBoundsMin.y;
+    header.spawnBoundsMax[0] = spawnBoundsMax.x;
+    header.spawnBoundsMax[1] = spawnBoundsMax.y;
+    
+    // No flecs world backs these entities, so every spawn ID restores without an ECS entity
+    const std::vector<uint64_t> ecsEntities(spawnIdLimit, 0);
+    std::vector<EntitySnapshotColumnData> columns = {
+        {EntitySnapshotColumn::Velocity, sizeof(glm::vec4), velocities.data(), count * sizeof(glm::vec4)},
+        {EntitySnapshotColumn::MovementParams, sizeof(glm::vec4), movementParams.data(), count * sizeof(glm::vec4)},
+        {EntitySnapshotColumn::RuntimeState, sizeof(glm::vec4), runtimeStates.data(), count * sizeof(glm::vec4)},
+        {EntitySnapshotColumn::ColorParams, sizeof(glm::uvec4), colorParams.data(), count * sizeof(glm::uvec4)},
+        {EntitySnapshotColumn::Position, sizeof(glm::vec4), positions.data(), count * sizeof(glm::vec4)},
+        {EntitySnapshotColumn::PreviousPosition, sizeof(glm::vec4), previousPositions.data(), count * sizeof(glm::vec4)},
+        {EntitySnapshotColumn::SpawnId, sizeof(uint32_t), spawnIds.data(), count * sizeof(uint32_t)},
+        {EntitySnapshotColumn::EntityType, sizeof(uint32_t), entityTypes.data(), count * sizeof(uint32_t)},
+        {EntitySnapshotColumn::ECSEntity, sizeof(uint64_t), ecsEntities.data(), ecsEntities.size() * sizeof(uint64_t)},
+    };
+    if (modelMatrices.size() == count) {
+        columns.push_back({EntitySnapshotColumn::ModelMatrix, sizeof(glm::mat4), modelMatrices.data(), count * sizeof(glm::mat4)});
+    }
+    if (!writeEntitySnapshot(path, header, columns)) {
+        return false;
+    }
+    LOG_INFO("CpuSimulation: Saved " << count << " entities after " << telemetry.ticks << " ticks to " << path);
+    return true;
+}
+
+void CpuSimulation::buildGrid() {
+    const uint32_t count = getEntityCount();
+    const glm::vec2 spawnSize = spawnBoundsMax - spawnBoundsMin;
+    grid = SpatialGridConfig::choose(count, std::max(SPATIAL_WORLD_EXTENT, std::max(spawnSize.x, spawnSize.y)));
+    grid.cellOrder = cellOrder;
+    
+    // Counting sort by cell, each cell filled in entity order, so the grid does not depend on the thread count
+    cells.assign(grid.getCellCount(), glm::uvec2(0u));
+    entityCells.resize(count);
+    for (uint32_t entityIndex = 0; entityIndex < count; ++entityIndex) {
+        const glm::ivec2 cell(glm::floor(glm::vec2(positions[entityIndex]) / grid.cellSize));
+        entityCells[entityIndex] = grid.getCellIndex(cell);
+        cells[entityCells[entityIndex]].y++;
+    }
+    uint32_t rangeStart = 0;
+    for (glm::uvec2& cell : cells) {
+        cell.x = rangeStart;
+        rangeStart += cell.y;
+    }
+    
+    cellCursors.resize(cells.size());
+    for (size_t cell = 0; cell < cells.size(); ++cell) {
+        cellCursors[cell] = cells[cell].x;
+    }
+    sortedIndices.resize(count);
+    sortedX.resize(count);
+    sortedY.resize(count);
+    for (uint32_t entityIndex = 0; entityIndex < count; ++entityIndex) {
+        const uint32_t slot = cellCursors[entityCells[entityIndex]]++;
+        const glm::vec4& position = positions[entityIndex];
+        sortedIndices[slot] = entityIndex;
+        sortedX[slot] = position.w == 0.0f ? TOMBSTONE_POSITION : position.x;
+        sortedY[slot] = position.w == 0.0f ? TOMBSTONE_POSITION : position.y;
+    }
+}
+
+void CpuSimulation::collectMovers(const SimulationStep& simulation) {
+    const uint32_t count = getEntityCount();
+    movers.clear();
+    for (uint32_t entityIndex = 0; entityIndex < count; ++entityIndex) {
+        // entity_active.comp: awake, counting down a lifetime, or due a new direction on one of the ticks
+        bool active = !features.hasSleeping() || velocities[entityIndex].w < 0.5f || runtimeStates[entityIndex].y > 0.0f;
+        for (uint32_t tick = 0; !active && tick < simulation.tickCount; ++tick) {
+            active = (simulation.firstTick + tick + entityIndex * MOVEMENT_CYCLE_STAGGER) % MOVEMENT_CYCLE_LENGTH == 0u;
+        }
+        if (active) {
+            movers.push_back(entityIndex);
+        }
+    }
+}
+
+void CpuSimulation::simulateRange(size_t begin, size_t end, uint32_t frame, float deltaTime, ChunkCounters& counters) {
+    const uint32_t cellCapacity = features.maxEntitiesPerCell;
+    const uint32_t collisionStride = features.collisionStride;
+    
+    for (size_t mover = begin; mover < end; ++mover) {
+        const uint32_t entityIndex = movers[mover];
+        const glm::vec4 storedPosition = positions[entityIndex];
+        if (storedPosition.w == 0.0f) {
+            continue;
+        }
+        
+        // expireEntity
+        glm::vec4& runtimeState = runtimeStates[entityIndex];
+        if (runtimeState.y > 0.0f) {
+            const float lifetime = runtimeState.y - deltaTime;
+            runtimeState.y = std::max(lifetime, 0.0f);
+            if (lifetime <= 0.0f) {
+                positions[entityIndex].w = 0.0f;
+                counters.expiredEntities++;
+                continue;
+            }
+        }
+        
+        // applyRandomWalk
+        glm::vec4 velocity = velocities[entityIndex];
+        if (isRandomWalker(entityTypes[entityIndex])) {
+            const bool initialized = runtimeState.w >= 0.5f;
+            if (!initialized) {
+                runtimeState.w = 1.0f;
+            }
+            const uint32_t cycle = (frame + entityIndex * MOVEMENT_CYCLE_STAGGER) % MOVEMENT_CYCLE_LENGTH;
+            if (cycle == 0u || !initialized) {
+                const uint32_t seed = entityIndex * 1664525u + frame * 1013904223u;
+                const float randAngle = hashToFloat(fastHash(seed)) * TWO_PI;
+                const float speed = 1.2f * (1.0f + hashToFloat(fastHash(seed + 12345u)) * 2.0f);
+                const float angularVelocity = (hashToFloat(fastHash(seed + 67890u)) - 0.5f) * 0.15f;
+                velocity.x = speed * std::cos(randAngle + angularVelocity);
+                velocity.y = speed * std::sin(randAngle + angularVelocity);
+                counters.directionChanges++;
+            }
+        }
+        
+        glm::vec2 vel(velocity.x, velocity.y);
+        glm::vec3 currentPosition(storedPosition);
+        if (glm::length(currentPosition) < 0.01f) {
+            currentPosition = glm::vec3(static_cast<float>(entityIndex % 10) * 0.8f - 4.0f,
+                                        static_cast<float>(entityIndex / 10) * 0.8f - 4.0f, 0.0f);
+        }
+        previousPositions[entityIndex] = glm::vec4(currentPosition, 1.0f);
+        
+        const bool moving = glm::length(vel) > PHYSICS_IDLE_SPEED;
+        if (moving) {
+            currentPosition.x += vel.x * deltaTime * SPEED_SCALE;
+            currentPosition.y += vel.y * deltaTime * SPEED_SCALE;
+        }
+        vel *= VELOCITY_DAMPING;
+        
+        // Narrow phase against the step's snapshot, first contact only
+        glm::vec2 resolvedPosition(currentPosition);
+        bool hadCollision = false;
+        bool truncated = false;
+        if (features.hasCollisions() && (entityIndex + frame) % collisionStride == 0u) {
+            const glm::vec2 position(currentPosition);
+            const glm::ivec2 cellCoord(glm::floor(position / grid.cellSize));
+            for (const glm::ivec2& offset : NEIGHBOUR_OFFSETS) {
+                const glm::uvec2 range = cells[grid.getCellIndex(cellCoord + offset)];
+                const uint32_t candidates = std::min(range.y, cellCapacity);
+                truncated = truncated || range.y > cellCapacity;
+                
+                const uint32_t contact = firstContact(sortedX.data() + range.x, sortedY.data() + range.x,
+                                                      sortedIndices.data() + range.x, candidates, position, entityIndex);
+                if (contact < candidates) {
+                    const glm::vec2 other(sortedX[range.x + contact], sortedY[range.x + contact]);
+                    const glm::vec2 diff = position - other;
+                    const float invDist = 1.0f / std::sqrt(diff.x * diff.x + diff.y * diff.y);
+                    resolvedPosition = other + (diff * invDist) * COLLISION_RADIUS;
+                    vel = glm::vec2(0.0f);
+                    hadCollision = true;
+                    break;
+                }
+            }
+        }
+        
+        const bool asleep = features.hasSleeping() && !moving && !hadCollision;
+        velocities[entityIndex] = glm::vec4(vel, velocity.z, asleep ? 1.0f : 0.0f);
+        positions[entityIndex] = glm::vec4(resolvedPosition, currentPosition.z, 1.0f);
+        counters.collisions += hadCollision ? 1 : 0;
+        counters.truncatedEntities += truncated ? 1 : 0;
+    }
+}
+
+void CpuSimulation::step(const SimulationStep& simulation) {
+    if (simulation.tickCount == 0 || positions.empty()) {
+        return;
+    }
+    buildGrid();
+    collectMovers(simulation);
+    
+    // A mover's ticks only read its own streams and the step's snapshot, so each chunk runs every tick on its own
+    JobSystem& jobs = JobSystem::getInstance();
+    const size_t chunkCount = std::max<size_t>(1, std::min<size_t>(jobs.getConcurrency(),
+        (movers.size() + CHUNK_MIN_ENTITIES - 1) / CHUNK_MIN_ENTITIES));
+    const size_t chunkSize = (movers.size() + chunkCount - 1) / chunkCount;
+    std::vector<ChunkCounters> chunkCounters(chunkCount);
+    auto runChunk = [&](size_t chunk) {
+        const size_t begin = chunk * chunkSize;
+        const size_t end = std::min(movers.size(), begin + chunkSize);
+        for (uint32_t tick = 0; tick < simulation.tickCount; ++tick) {
+            simulateRange(begin, end, simulation.firstTick + tick, simulation.tickSeconds, chunkCounters[chunk]);
+        }
+    };
+    
+    JobCounter chunksSimulated;
+    for (size_t chunk = 1; chunk < chunkCount; ++chunk) {
+        jobs.submit([&, chunk]() { runChunk(chunk); }, JobPriority::High, &chunksSimulated);
+    }
+    runChunk(0);
+    jobs.wait(chunksSimulated);
+    
+    for (const ChunkCounters& counters : chunkCounters) {
+        telemetry.collisions += counters.collisions;
+        telemetry.truncatedEntities += counters.truncatedEntities;
+        telemetry.directionChanges += counters.directionChanges;
+        telemetry.expiredEntities += counters.expiredEntities;
+    }
+    telemetry.ticks += simulation.tickCount;
+    totalTime += simulation.tickSeconds * simulation.tickCount;
+}
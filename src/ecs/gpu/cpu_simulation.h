@@ -0,0 +1,108 @@
+#pragma once
+
+#include "entity_buffer_manager.h"
+#include "../../vulkan/pipelines/compute_pipeline_types.h"
+#include "../../vulkan/rendering/frame_graph_types.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+struct GPUEntitySoA;
+
+/**
+ * CPU implementation of the simulation kernels for hosts without a usable Vulkan device (--cpu-simulation, or
+ * when no device is found): the random walk of movement_random.comp fused into the integration and grid collision
+ * of physics.comp, as the fused physics pipeline runs them, over the full GPU stream layout. A step builds the
+ * spatial grid and the neighbour snapshot once and then runs its ticks against them, like one GPU frame does.
+ *
+ * Movers are split into chunks run as JobSystem jobs; the neighbour walk tests a cell's candidates eight (AVX2)
+ * or four (NEON) at a time from cell-sorted copies of the snapshot. Every operation follows the kernels in order
+ * and in single precision, so the hash-driven directions and collision-free integration agree with the GPU bit
+ * for bit. Two things do not: cos and sin round differently from the device's, and the grid count pass orders a
+ * cell's entities by atomic arrival where this orders them by index, which can change a collision's partner.
+ * Runs of this backend are deterministic, whatever the thread count. Entities of movement types other than the
+ * random walk integrate the velocity they have; their kernels are not ported.
+ */
+class CpuSimulation {
+public:
+    CpuSimulation() = default;
+    ~CpuSimulation() = default;
+    
+    // Collisions, sleeping, cell capacity and collision stride as the physics permutation uses them (stride 0,
+    // adaptive on the GPU, tests every entity)
+    void setFeatures(const ComputeShaderFeatures& features);
+    void setSpatialCellOrder(SpatialCellOrder order) { cellOrder = order; }
+    
+    // Takes the staged entities, starting from their spawn positions, and replaces any earlier state
+    void load(const GPUEntitySoA& entities);
+    // Snapshot files of the standard stream layout (GPUEntityManager::saveSnapshot or saveSnapshot below)
+    bool loadSnapshot(const std::string& path);
+    // Written like a GPU snapshot, with the tick count as the frame, so either backend can restore it
+    bool saveSnapshot(const std::string& path) const;
+    
+    // Runs the step's ticks; nothing when it has none
+    void step(const SimulationStep& simulation);
+    
+    uint32_t getEntityCount() const { return static_cast<uint32_t>(positions.size()); }
+    const std::vector<glm::vec4>& getPositions() const { return positions; }
+    const std::vector<glm::vec4>& getVelocities() const { return velocities; }
+    
+    // Totals since load, as the GPU's SimulationCounters count them
+    struct Telemetry {
+        uint64_t ticks = 0;
+        uint64_t collisions = 0;
+        uint64_t truncatedEntities = 0;
+        uint64_t directionChanges = 0;
+        uint64_t expiredEntities = 0;
+    };
+    const Telemetry& getTelemetry() const { return telemetry; }
+
+private:
+    static constexpr size_t CHUNK_MIN_ENTITIES = 4096;  // Smaller runs of movers are simulated inline
+    
+    struct ChunkCounters {
+        uint64_t collisions = 0;
+        uint64_t truncatedEntities = 0;
+        uint64_t directionChanges = 0;
+        uint64_t expiredEntities = 0;
+    };
+    
+    void resetState(size_t count);
+    // Spatial grid and cell-sorted neighbour snapshot of the current positions (spatial_count.comp through
+    // spatial_scatter.comp), and the movers the step runs over (entity_active.comp)
+    void buildGrid();
+    void collectMovers(const SimulationStep& simulation);
+    // physics.comp with FUSED_MOVEMENT for movers [begin, end) in one tick
+    void simulateRange(size_t begin, size_t end, uint32_t frame, float deltaTime, ChunkCounters& counters);
+    
+    ComputeShaderFeatures features;
+    SpatialCellOrder cellOrder = SpatialCellOrder::RowMajor;
+    
+    // Entity streams in the standard GPU layout
+    std::vector<glm::vec4> positions;
+    std::vector<glm::vec4> previousPositions;
+    std::vector<glm::vec4> velocities;
+    std::vector<glm::vec4> movementParams;
+    std::vector<glm::vec4> runtimeStates;
+    std::vector<glm::uvec4> colorParams;
+    std::vector<glm::mat4> modelMatrices;  // Carried into snapshots, empty when the source had none
+    std::vector<uint32_t> spawnIds;
+    std::vector<uint32_t> entityTypes;
+    glm::vec2 spawnBoundsMin{0.0f};
+    glm::vec2 spawnBoundsMax{0.0f};
+    float totalTime = 0.0f;  // Simulated seconds, the snapshot's totalTime
+    
+    // Grid of the current step: (sorted range start, entity count) per cell, and the snapshot in cell order with
+    // tombstones at NaN so no comparison matches them
+    SpatialGridConfig grid;
+    std::vector<glm::uvec2> cells;
+    std::vector<uint32_t> entityCells;
+    std::vector<uint32_t> cellCursors;   // Next free sorted slot of each cell while scattering
+    std::vector<uint32_t> sortedIndices;
+    std::vector<float> sortedX;
+    std::vector<float> sortedY;
+    std::vector<uint32_t> movers;
+    
+    Telemetry telemetry;
+};
@@ -3,10 +3,100 @@
 #include "../../vulkan/resources/core/resource_coordinator.h"
 #include "../../vulkan/resources/core/command_executor.h"
 #include "../../vulkan/core/vulkan_function_loader.h"
+#include "../../vulkan/core/vulkan_constants.h"
+#include <array>
 #include <iostream>
 #include <cstring>
 #include <limits>
 #include <algorithm>
+#include <cmath>
+#include <glm/gtc/packing.hpp>
+
+namespace {
+    uint32_t nextPowerOfTwo(uint32_t value) {
+        if (value <= 1) return 1;
+        value--;
+        value |= value >> 1;
+        value |= value >> 2;
+        value |= value >> 4;
+        value |= value >> 8;
+        value |= value >> 16;
+        return value + 1;
+    }
+    
+    // Same hash as the spatial grid shaders: floor to cells, wrap with the power-of-two mask
+    uint32_t spatialCellOf(const SpatialGridConfig& grid, glm::vec2 position) {
+        return grid.getCellIndex(glm::ivec2(glm::floor(position / grid.cellSize)));
+    }
+    
+    // Spreads the low 16 bits of v over the even bits
+    uint32_t mortonSpread(uint32_t v) {
+        v &= 0x0000FFFFu;
+        v = (v | (v << 8)) & 0x00FF00FFu;
+        v = (v | (v << 4)) & 0x0F0F0F0Fu;
+        v = (v | (v << 2)) & 0x33333333u;
+        v = (v | (v << 1)) & 0x55555555u;
+        return v;
+    }
+}
+
+struct EntityBufferManager::EntityPickSearch {
+    glm::vec2 worldPos{0.0f};
+    SpatialGridConfig grid;
+    uint64_t generation = 0;
+    EntityPickCallback callback;
+    
+    uint32_t outstanding = 0;  // Readbacks of the current stage still to resolve
+    bool failed = false;
+    
+    std::vector<glm::uvec2> cellRanges;  // Start in the sorted spatial index, entity count
+    std::vector<uint32_t> candidates;
+    std::vector<glm::vec4> positions;
+    std::vector<glm::vec4> velocities;
+    std::vector<uint32_t> spawnIds;
+};
+
+struct EntityBufferManager::EntityStateRead {
+    uint32_t spawnId = 0;
+    uint64_t generation = 0;
+    EntityStateCallback callback;
+    
+    uint32_t outstanding = 0;  // Readbacks of the slot stage still to resolve
+    bool failed = false;
+    
+    EntityState state;
+    glm::uvec4 movementBits{0u};       // Stream bits, four floats or two half2 words under the compact layout
+    uint32_t slotSpawnId = UINT32_MAX; // Entity ID stream at the slot, checked against spawnId
+};
+
+SpatialGridConfig SpatialGridConfig::choose(uint32_t entityCount, float worldExtent, float cellSize) {
+    // Cells per axis needed to cover the world before the hash wraps around
+    float cellsAcross = worldExtent / cellSize;
+    uint32_t coverageDimension = cellsAcross >= static_cast<float>(SPATIAL_GRID_MAX_DIMENSION)
+        ? SPATIAL_GRID_MAX_DIMENSION
+        : nextPowerOfTwo(static_cast<uint32_t>(std::ceil(cellsAcross)));
+    
+    // Roughly one cell per entity - finer grids only add clear and prefix sum work
+    uint32_t densityDimension = nextPowerOfTwo(static_cast<uint32_t>(std::ceil(std::sqrt(static_cast<float>(entityCount)))));
+    
+    uint32_t dimension = std::clamp(std::min(coverageDimension, densityDimension),
+                                    SPATIAL_GRID_MIN_DIMENSION, SPATIAL_GRID_MAX_DIMENSION);
+    
+    SpatialGridConfig config;
+    config.width = dimension;
+    config.height = dimension;
+    config.cellSize = cellSize;
+    return config;
+}
+
+uint32_t SpatialGridConfig::getCellIndex(glm::ivec2 cell) const {
+    uint32_t x = static_cast<uint32_t>(cell.x) & (width - 1);
+    uint32_t y = static_cast<uint32_t>(cell.y) & (height - 1);
+    if (cellOrder == SpatialCellOrder::Morton) {
+        return mortonSpread(x) | (mortonSpread(y) << 1);
+    }
+    return x + y * width;
+}
 
 EntityBufferManager::EntityBufferManager() {
 }
@@ -15,8 +105,9 @@ EntityBufferManager::~EntityBufferManager() {
     cleanup();
 }
 
-bool EntityBufferManager::initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities) {
+bool EntityBufferManager::initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities, bool compactLayout) {
     this->maxEntities = maxEntities;
+    this->compactLayout = compactLayout;
     this->context = &context;
     
     // Initialize upload service
@@ -25,18 +116,23 @@ bool EntityBufferManager::initialize(const VulkanContext& context, ResourceCoord
         return false;
     }
     
+    // The streams graphics reads besides the snapshots, aliased for the publish under multi-device simulation
+    movementParamsBuffer.setRenderDeviceMirror(true);
+    colorBuffer.setRenderDeviceMirror(true);
+    entityIdBuffer.setRenderDeviceMirror(true);
+    
     // Initialize specialized buffers
     if (!velocityBuffer.initialize(context, resourceCoordinator, maxEntities)) {
         std::cerr << "EntityBufferManager: Failed to initialize velocity buffer" << std::endl;
         return false;
     }
     
-    if (!movementParamsBuffer.initialize(context, resourceCoordinator, maxEntities)) {
+    if (!movementParamsBuffer.initialize(context, resourceCoordinator, maxEntities, compactLayout)) {
         std::cerr << "EntityBufferManager: Failed to initialize movement params buffer" << std::endl;
         return false;
     }
     
-    if (!runtimeStateBuffer.initialize(context, resourceCoordinator, maxEntities)) {
+    if (!runtimeStateBuffer.initialize(context, resourceCoordinator, maxEntities, compactLayout)) {
         std::cerr << "EntityBufferManager: Failed to initialize runtime state buffer" << std::endl;
         return false;
     }
@@ -46,35 +142,143 @@ bool EntityBufferManager::initialize(const VulkanContext& context, ResourceCoord
         return false;
     }
     
-    if (!modelMatrixBuffer.initialize(context, resourceCoordinator, maxEntities)) {
+    if (hasModelMatrixStream() && !modelMatrixBuffer.initialize(context, resourceCoordinator, maxEntities)) {
         std::cerr << "EntityBufferManager: Failed to initialize model matrix buffer" << std::endl;
         return false;
     }
+    if (!compactLayout && !hasModelMatrixStream()) {
+        std::cout << "EntityBufferManager: no kernel accesses the model matrix stream, leaving it unallocated" << std::endl;
+    }
     
-    if (!spatialMapBuffer.initialize(context, resourceCoordinator, 4096)) { // 64x64 grid
+    // Size the spatial map for the largest grid any entity count up to maxEntities can select
+    spatialGridCapacity = SpatialGridConfig::choose(maxEntities, std::numeric_limits<float>::max()).getCellCount();
+    spatialGrid = SpatialGridConfig::choose(0, SPATIAL_WORLD_EXTENT);
+    
+    if (!spatialMapBuffer.initialize(context, resourceCoordinator, spatialGridCapacity)) {
         std::cerr << "EntityBufferManager: Failed to initialize spatial map buffer" << std::endl;
         return false;
     }
     
-    // Initialize spatial map buffer with NULL values (0xFFFFFFFF)
+    if (!spatialEntryBuffer.initialize(context, resourceCoordinator, maxEntities)) {
+        std::cerr << "EntityBufferManager: Failed to initialize spatial entry buffer" << std::endl;
+        return false;
+    }
+    
+    if (!spatialIndexBuffer.initialize(context, resourceCoordinator, maxEntities)) {
+        std::cerr << "EntityBufferManager: Failed to initialize spatial index buffer" << std::endl;
+        return false;
+    }
+    
+    if (!entityIdBuffer.initialize(context, resourceCoordinator, maxEntities)) {
+        std::cerr << "EntityBufferManager: Failed to initialize entity ID buffer" << std::endl;
+        return false;
+    }
+    
+    if (!entityTypeBuffer.initialize(context, resourceCoordinator, maxEntities)) {
+        std::cerr << "EntityBufferManager: Failed to initialize entity type buffer" << std::endl;
+        return false;
+    }
+    
+    if (!spawnSlotBuffer.initialize(context, resourceCoordinator, maxEntities)) {
+        std::cerr << "EntityBufferManager: Failed to initialize spawn slot buffer" << std::endl;
+        return false;
+    }
+    
+    if (!reorderScratchBuffer.initialize(context, resourceCoordinator, maxEntities, ENTITY_REORDER_STREAM_COUNT)) {
+        std::cerr << "EntityBufferManager: Failed to initialize reorder scratch buffer" << std::endl;
+        return false;
+    }
+    
+    if (!indirectCommandBuffer.initialize(context, resourceCoordinator)) {
+        std::cerr << "EntityBufferManager: Failed to initialize indirect command buffer" << std::endl;
+        return false;
+    }
+    {
+        // The counters start over with the new buffer, so the next readback seeds the totals again
+        std::lock_guard<std::mutex> lock(boundsMutex);
+        latestSimulationCounters = SimulationCounters{};
+    }
+    
+    if (!visibleIndexBuffer.initialize(context, resourceCoordinator, maxEntities)) {
+        std::cerr << "EntityBufferManager: Failed to initialize visible index buffer" << std::endl;
+        return false;
+    }
+    
+    if (!visibleDrawCommandBuffer.initialize(context, resourceCoordinator)) {
+        std::cerr << "EntityBufferManager: Failed to initialize visible draw command buffer" << std::endl;
+        return false;
+    }
+    
+    if constexpr (ENABLE_PIPELINED_ASYNC_COMPUTE) {
+        for (uint32_t slot = 0; slot < PUBLISHED_SNAPSHOT_COUNT; ++slot) {
+            publishedVisibleIndexBuffers[slot].setRenderDeviceMirror(true);
+            publishedDrawCommandBuffers[slot].setRenderDeviceMirror(true);
+            if (!publishedVisibleIndexBuffers[slot].initialize(context, resourceCoordinator, maxEntities) ||
+                !publishedDrawCommandBuffers[slot].initialize(context, resourceCoordinator)) {
+                std::cerr << "EntityBufferManager: Failed to initialize published culling snapshot " << slot << std::endl;
+                return false;
+            }
+        }
+    }
+    
+    // Initialize spatial map buffer with empty cell ranges
     if (!initializeSpatialMapBuffer()) {
         std::cerr << "EntityBufferManager: Failed to clear spatial map buffer" << std::endl;
         return false;
     }
     
-    // Initialize position buffer coordinator
-    if (!positionCoordinator.initialize(context, resourceCoordinator, maxEntities)) {
+    // Initialize position buffer coordinator; exported snapshots need the ring pipelined async compute publishes
+    const bool exportPositions = ENABLE_EXTERNAL_POSITION_EXPORT && ENABLE_PIPELINED_ASYNC_COMPUTE &&
+                                 !positionExportPath.empty() && context.supportsExternalPositionExport();
+    if (!positionCoordinator.initialize(context, resourceCoordinator, maxEntities, compactLayout, exportPositions)) {
         std::cerr << "EntityBufferManager: Failed to initialize position coordinator" << std::endl;
         return false;
     }
+    if (exportPositions && (!positionExport.initialize(context, positionExportPath) ||
+                            !positionExport.publishBuffers(positionCoordinator, generation))) {
+        std::cerr << "EntityBufferManager: Failed to export position snapshots, continuing without" << std::endl;
+        positionExport.cleanup();
+    }
     
-    std::cout << "EntityBufferManager: Initialized successfully for " << maxEntities << " entities using SRP-compliant design" << std::endl;
+    std::cout << "EntityBufferManager: Initialized successfully for " << maxEntities << " entities using SRP-compliant design"
+              << (compactLayout ? " (compact layout)" : "") << std::endl;
     return true;
 }
 
 void EntityBufferManager::cleanup() {
-    // Cleanup specialized components
+    // Finished captures and snapshots are still written and sent; results of the ones in progress never arrive
+    telemetryCapture.close();
+    entityStream.close();
+    
+    // Staging memory must outlive any transfer still reading from it
+    waitForAsyncUpload();
+    if (asyncStagingBuffer.isValid()) {
+        if (auto* resourceCoordinator = uploadService.getResourceCoordinator()) {
+            resourceCoordinator->destroyResource(asyncStagingBuffer);
+        }
+        asyncStagingBuffer = {};
+    }
+    
+    // A queued pick will not be drawn any more, nor queued spatial queries run
+    failEntityIdPick();
+    failSpatialQueries();
+    
+    // Cleanup specialized components; the exported handles go first, naming memory freed below
+    positionExport.cleanup();
     positionCoordinator.cleanup();
+    for (uint32_t slot = 0; slot < PUBLISHED_SNAPSHOT_COUNT; ++slot) {
+        publishedDrawCommandBuffers[slot].cleanup();
+        publishedVisibleIndexBuffers[slot].cleanup();
+    }
+    visibleDrawCommandBuffer.cleanup();
+    visibleIndexBuffer.cleanup();
+    indirectCommandBuffer.cleanup();
+    reorderScratchBuffer.cleanup();
+    spawnSlotBuffer.cleanup();
+    entityTypeBuffer.cleanup();
+    entityIdBuffer.cleanup();
+    spatialIndexBuffer.cleanup();
+    spatialEntryBuffer.cleanup();
     spatialMapBuffer.cleanup();
     modelMatrixBuffer.cleanup();
     colorBuffer.cleanup();
@@ -83,9 +287,118 @@ void EntityBufferManager::cleanup() {
     velocityBuffer.cleanup();
     uploadService.cleanup();
     
+    // A mirror sweep or search over these buffers lost its queued readbacks with them, which a reinitialize
+    // after device loss must not wait for
     maxEntities = 0;
+    ++generation;
+}
+
+bool EntityBufferManager::growCapacity(uint32_t newMaxEntities) {
+    if (newMaxEntities <= maxEntities) {
+        return true;
+    }
+    
+    // An in-flight transfer still writes into the old buffers
+    waitForAsyncUpload();
+    
+    // Persistent per-entity state is copied; grid, culling and scratch data is rebuilt every frame. Sparse
+    // buffers keep everything and gather their page binds for one submit
+    const bool inPlace = canGrowInPlace(newMaxEntities);
+    SparseBindBatch sparseBinds;
+    bool success = velocityBuffer.resize(newMaxEntities, true, &sparseBinds) &&
+                   movementParamsBuffer.resize(newMaxEntities, true, &sparseBinds) &&
+                   runtimeStateBuffer.resize(newMaxEntities, true, &sparseBinds) &&
+                   colorBuffer.resize(newMaxEntities, true, &sparseBinds) &&
+                   (!hasModelMatrixStream() || modelMatrixBuffer.resize(newMaxEntities, true, &sparseBinds)) &&
+                   entityIdBuffer.resize(newMaxEntities, true, &sparseBinds) &&
+                   entityTypeBuffer.resize(newMaxEntities, true, &sparseBinds) &&
+                   spawnSlotBuffer.resize(newMaxEntities, true, &sparseBinds) &&
+                   positionCoordinator.resize(newMaxEntities, &sparseBinds) &&
+                   spatialEntryBuffer.resize(newMaxEntities, false, &sparseBinds) &&
+                   spatialIndexBuffer.resize(newMaxEntities, false, &sparseBinds) &&
+                   reorderScratchBuffer.resize(newMaxEntities * ENTITY_REORDER_STREAM_COUNT, false, &sparseBinds) &&
+                   visibleIndexBuffer.resize(newMaxEntities, false, &sparseBinds);
+    for (auto& published : publishedVisibleIndexBuffers) {
+        success = success && (!published.isInitialized() || published.resize(newMaxEntities, false, &sparseBinds));
+    }
+    success = success && sparseBinds.submit(*context);
+    
+    // Buffers that did grow already carry new handles or sizes, so dependents must rebind either way
+    ++generation;
+    lastGrowthInPlace = inPlace;
+    
+    // Queued readbacks would record copies from the retired buffers; recorded ones already ran in the drain.
+    // In-place growth retires nothing
+    auto* resourceCoordinator = uploadService.getResourceCoordinator();
+    if (resourceCoordinator && !inPlace) {
+        if (ReadbackRing* ring = resourceCoordinator->getReadbackRing()) {
+            ring->cancelPending();
+        }
+        if (ReadbackRing* ring = resourceCoordinator->getStreamingReadbackRing()) {
+            ring->cancelPending();
+        }
+    }
+    if (!success) {
+        std::cerr << "EntityBufferManager: Failed to grow entity buffers to " << newMaxEntities << " entities" << std::endl;
+        return false;
+    }
+    
+    // Denser scenes may select a larger grid than the current spatial map holds
+    uint32_t newGridCapacity = SpatialGridConfig::choose(newMaxEntities, std::numeric_limits<float>::max()).getCellCount();
+    if (newGridCapacity > spatialGridCapacity) {
+        if (!spatialMapBuffer.resize(newGridCapacity, false)) {
+            std::cerr << "EntityBufferManager: Failed to grow spatial map to " << newGridCapacity << " cells" << std::endl;
+            return false;
+        }
+        spatialGridCapacity = newGridCapacity;
+        if (!initializeSpatialMapBuffer()) {
+            std::cerr << "EntityBufferManager: Failed to clear grown spatial map buffer" << std::endl;
+            return false;
+        }
+    }
+    
+    // Exported snapshots are never sparse, so this growth gave them new allocations
+    if (positionExport.isActive() && !positionExport.publishBuffers(positionCoordinator, generation)) {
+        std::cerr << "EntityBufferManager: Failed to re-export grown position snapshots, export stopped" << std::endl;
+        positionExport.cleanup();
+    }
+    
+    std::cout << "EntityBufferManager: Grew entity capacity from " << maxEntities << " to " << newMaxEntities << " entities" << std::endl;
+    maxEntities = newMaxEntities;
+    return true;
+}
+
+bool EntityBufferManager::canGrowInPlace(uint32_t newMaxEntities) const {
+    bool inPlace = velocityBuffer.canGrowInPlace(newMaxEntities) && movementParamsBuffer.canGrowInPlace(newMaxEntities) &&
+                   runtimeStateBuffer.canGrowInPlace(newMaxEntities) && colorBuffer.canGrowInPlace(newMaxEntities) &&
+                   (!hasModelMatrixStream() || modelMatrixBuffer.canGrowInPlace(newMaxEntities)) &&
+                   entityIdBuffer.canGrowInPlace(newMaxEntities) && entityTypeBuffer.canGrowInPlace(newMaxEntities) &&
+                   spawnSlotBuffer.canGrowInPlace(newMaxEntities) && positionCoordinator.canGrowInPlace(newMaxEntities) &&
+                   spatialEntryBuffer.canGrowInPlace(newMaxEntities) && spatialIndexBuffer.canGrowInPlace(newMaxEntities) &&
+                   reorderScratchBuffer.canGrowInPlace(newMaxEntities * ENTITY_REORDER_STREAM_COUNT) &&
+                   visibleIndexBuffer.canGrowInPlace(newMaxEntities);
+    for (const auto& published : publishedVisibleIndexBuffers) {
+        inPlace = inPlace && (!published.isInitialized() || published.canGrowInPlace(newMaxEntities));
+    }
+    
+    // The spatial map is sized by grid, not reserved; a capacity that selects a larger grid reallocates it
+    const uint32_t gridCapacity = SpatialGridConfig::choose(newMaxEntities, std::numeric_limits<float>::max()).getCellCount();
+    return inPlace && gridCapacity <= spatialGridCapacity;
 }
 
+VkDeviceSize EntityBufferManager::getBytesPerEntity() const {
+    if (maxEntities == 0) return 0;
+    
+    // The streams growCapacity resizes; uninitialized ones report zero
+    VkDeviceSize total = velocityBuffer.getSize() + movementParamsBuffer.getSize() + runtimeStateBuffer.getSize() +
+                         colorBuffer.getSize() + modelMatrixBuffer.getSize() + entityIdBuffer.getSize() + entityTypeBuffer.getSize() +
+                         spawnSlotBuffer.getSize() + positionCoordinator.getTotalSize() + spatialEntryBuffer.getSize() +
+                         spatialIndexBuffer.getSize() + reorderScratchBuffer.getSize() + visibleIndexBuffer.getSize();
+    for (const auto& published : publishedVisibleIndexBuffers) {
+        total += published.getSize();
+    }
+    return (total + maxEntities - 1) / maxEntities;
+}
 
 bool EntityBufferManager::uploadVelocityData(const void* data, VkDeviceSize size, VkDeviceSize offset) {
     return uploadService.upload(velocityBuffer, data, size, offset);
@@ -104,6 +417,10 @@ bool EntityBufferManager::uploadColorData(const void* data, VkDeviceSize size, V
 }
 
 bool EntityBufferManager::uploadModelMatrixData(const void* data, VkDeviceSize size, VkDeviceSize offset) {
+    if (!hasModelMatrixStream()) {
+        std::cerr << "EntityBufferManager: Compact layout has no model matrix buffer" << std::endl;
+        return false;
+    }
     return uploadService.upload(modelMatrixBuffer, data, size, offset);
 }
 
@@ -111,10 +428,160 @@ bool EntityBufferManager::uploadSpatialMapData(const void* data, VkDeviceSize si
     return uploadService.upload(spatialMapBuffer, data, size, offset);
 }
 
+bool EntityBufferManager::uploadEntityIdData(const void* data, VkDeviceSize size, VkDeviceSize offset) {
+    return uploadService.upload(entityIdBuffer, data, size, offset);
+}
+
+bool EntityBufferManager::uploadEntityTypeData(const void* data, VkDeviceSize size, VkDeviceSize offset) {
+    return uploadService.upload(entityTypeBuffer, data, size, offset);
+}
+
+bool EntityBufferManager::uploadIndirectCommands(const EntityIndirectCommands& commands) {
+    return uploadService.upload(indirectCommandBuffer, &commands, EntityIndirectCommandBuffer::getCommandSize(), 0);
+}
+
+bool EntityBufferManager::uploadExpiredEntityCount(uint32_t count) {
+    return uploadService.upload(indirectCommandBuffer, &count, sizeof(count), EntityIndirectCommandBuffer::getExpiredCountOffset());
+}
+
+bool EntityBufferManager::uploadVisibleDrawCommands(const VisibleDrawCommands& commands) {
+    return uploadService.upload(visibleDrawCommandBuffer, &commands, sizeof(VisibleDrawCommands), 0);
+}
+
 bool EntityBufferManager::uploadPositionDataToAllBuffers(const void* data, VkDeviceSize size, VkDeviceSize offset) {
     return positionCoordinator.uploadToAllBuffers(data, size, offset);
 }
 
+bool EntityBufferManager::ensureAsyncStagingCapacity(VkDeviceSize size) {
+    if (asyncStagingBuffer.isValid() && asyncStagingBuffer.size >= size) {
+        return true;
+    }
+    
+    auto* resourceCoordinator = uploadService.getResourceCoordinator();
+    if (!resourceCoordinator) {
+        return false;
+    }
+    
+    if (asyncStagingBuffer.isValid()) {
+        resourceCoordinator->destroyResource(asyncStagingBuffer);
+        asyncStagingBuffer = {};
+    }
+    
+    // Never smaller than the shared staging ring, so typical spawn batches allocate once
+    VkDeviceSize capacity = std::max<VkDeviceSize>(size, STAGING_BUFFER_SIZE);
+    asyncStagingBuffer = resourceCoordinator->createMappedBuffer(capacity, VK_BUFFER_USAGE_TRANSFER_SRC_BIT);
+    if (!asyncStagingBuffer.isValid() || !asyncStagingBuffer.mappedData) {
+        std::cerr << "EntityBufferManager: Failed to create async staging buffer (" << capacity << " bytes)" << std::endl;
+        asyncStagingBuffer = {};
+        return false;
+    }
+    asyncStagingBuffer.size = capacity;
+    return true;
+}
+
+bool EntityBufferManager::submitAsyncUpload(const std::vector<UploadRegion>& regions) {
+    if (isAsyncUploadInFlight()) {
+        std::cerr << "EntityBufferManager: Async upload already in flight" << std::endl;
+        return false;
+    }
+    
+    auto* resourceCoordinator = uploadService.getResourceCoordinator();
+    if (!resourceCoordinator || regions.empty()) {
+        return false;
+    }
+    
+    VkDeviceSize totalSize = 0;
+    for (const auto& region : regions) {
+        totalSize += region.size;
+    }
+    if (!ensureAsyncStagingCapacity(totalSize)) {
+        return false;
+    }
+    
+    // Pack every region back to back; the fence guarantees the previous copy no longer reads this memory
+    std::vector<CommandExecutor::BufferRegionCopy> copies;
+    copies.reserve(regions.size());
+    
+    auto* staging = static_cast<uint8_t*>(asyncStagingBuffer.mappedData);
+    VkDeviceSize stagingOffset = 0;
+    for (const auto& region : regions) {
+        if (region.dst == VK_NULL_HANDLE || !region.data || region.size == 0) {
+            continue;
+        }
+        std::memcpy(staging + stagingOffset, region.data, static_cast<size_t>(region.size));
+        
+        CommandExecutor::BufferRegionCopy copy{};
+        copy.dst = region.dst;
+        copy.region.srcOffset = stagingOffset;
+        copy.region.dstOffset = region.offset;
+        copy.region.size = region.size;
+        copies.push_back(copy);
+        
+        stagingOffset += region.size;
+    }
+    
+    asyncUpload = resourceCoordinator->getCommandExecutor()->copyBufferRegionsAsync(asyncStagingBuffer.buffer.get(), copies);
+    if (!asyncUpload.isValid()) {
+        std::cerr << "EntityBufferManager: Failed to submit async upload" << std::endl;
+        return false;
+    }
+    uploadedBytes += stagingOffset;
+    return true;
+}
+
+bool EntityBufferManager::pollAsyncUpload() {
+    if (!isAsyncUploadInFlight()) {
+        return false;
+    }
+    
+    auto* executor = uploadService.getResourceCoordinator()->getCommandExecutor();
+    if (!executor->isTransferComplete(asyncUpload)) {
+        return false;
+    }
+    executor->freeAsyncTransfer(asyncUpload);
+    return true;
+}
+
+void EntityBufferManager::waitForAsyncUpload() {
+    if (!isAsyncUploadInFlight()) {
+        return;
+    }
+    
+    auto* resourceCoordinator = uploadService.getResourceCoordinator();
+    if (!resourceCoordinator) {
+        return;
+    }
+    auto* executor = resourceCoordinator->getCommandExecutor();
+    executor->waitForTransfer(asyncUpload);
+    executor->freeAsyncTransfer(asyncUpload);
+}
+
+bool EntityBufferManager::uploadRegions(const std::vector<UploadRegion>& regions) {
+    auto* resourceCoordinator = uploadService.getResourceCoordinator();
+    if (!resourceCoordinator || regions.empty()) {
+        return false;
+    }
+    
+    std::vector<BufferUploadService::UploadOperation> operations;
+    operations.reserve(regions.size());
+    VkDeviceSize totalSize = 0;
+    for (const auto& region : regions) {
+        operations.emplace_back(region.dst, region.data, region.size, region.offset);
+        totalSize += region.size;
+    }
+    
+    CommandExecutor::AsyncTransfer transfer = uploadService.uploadBatch(operations);
+    if (!transfer.isValid()) {
+        return false;
+    }
+    uploadedBytes += totalSize;
+    
+    auto* executor = resourceCoordinator->getCommandExecutor();
+    executor->waitForTransfer(transfer);
+    executor->freeAsyncTransfer(transfer);
+    return true;
+}
+
 // Helper method to create staging buffer and read GPU data
 bool EntityBufferManager::readGPUBuffer(VkBuffer srcBuffer, void* dstData, VkDeviceSize size, VkDeviceSize offset) const {
     // Access resourceCoordinator through uploadService
@@ -128,11 +595,12 @@ bool EntityBufferManager::readGPUBuffer(VkBuffer srcBuffer, void* dstData, VkDev
         return false;
     }
     
-    // Create staging buffer for readback
+    // Create staging buffer for readback; debug and snapshot reads only, so it is the first to be demoted
     auto stagingHandle = resourceCoordinator->createBuffer(
         size,
         VK_BUFFER_USAGE_TRANSFER_DST_BIT,
-        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+        MemoryAllocator::Priority::Low
     );
     
     if (!stagingHandle.buffer.get()) {
@@ -148,25 +616,21 @@ bool EntityBufferManager::readGPUBuffer(VkBuffer srcBuffer, void* dstData, VkDev
     }
     
     // Use synchronous buffer copy (automatically handles command buffer creation/submission)
-    commandExecutor->copyBufferToBuffer(srcBuffer, stagingHandle.buffer.get(), size, offset, 0);
+    commandExecutor->readBufferToHost(srcBuffer, stagingHandle.buffer.get(), size, offset, 0);
     
     // Copy data from staging buffer to host memory
     if (stagingHandle.mappedData) {
         std::memcpy(dstData, stagingHandle.mappedData, size);
     } else {
-        // Map, copy, unmap
-        const auto& loader = context->getLoader();
-        VkDevice device = context->getDevice();
-        
-        void* mappedData;
-        VkResult result = loader.vkMapMemory(device, stagingHandle.memory.get(), 0, size, 0, &mappedData);
-        if (result != VK_SUCCESS) {
+        // Map, copy, unmap; the allocator resolves sub-allocations to their block's mapping
+        MemoryAllocator* memoryAllocator = resourceCoordinator->getMemoryAllocator();
+        if (!memoryAllocator->mapResourceMemory(stagingHandle)) {
             resourceCoordinator->destroyResource(stagingHandle);
             return false;
         }
         
-        std::memcpy(dstData, mappedData, size);
-        loader.vkUnmapMemory(device, stagingHandle.memory.get());
+        std::memcpy(dstData, stagingHandle.mappedData, size);
+        memoryAllocator->unmapResourceMemory(stagingHandle);
     }
     
     // Cleanup staging buffer
@@ -177,22 +641,22 @@ bool EntityBufferManager::readGPUBuffer(VkBuffer srcBuffer, void* dstData, VkDev
 // Debug readback implementations
 bool EntityBufferManager::readbackEntityAtPosition(glm::vec2 worldPos, EntityDebugInfo& info) const {
     // Calculate clicked spatial cell using same logic as GPU shader
-    const float CELL_SIZE = 2.0f;
-    const uint32_t GRID_WIDTH = 64;
-    const uint32_t GRID_HEIGHT = 64;
+    const float CELL_SIZE = spatialGrid.cellSize;
+    const uint32_t GRID_WIDTH = spatialGrid.width;
+    const uint32_t GRID_HEIGHT = spatialGrid.height;
     
     // Convert world position to grid coordinates (same as GPU)
     glm::ivec2 gridCoord = glm::ivec2(glm::floor(worldPos / CELL_SIZE));
     uint32_t clickedX = static_cast<uint32_t>(gridCoord.x) & (GRID_WIDTH - 1);
     uint32_t clickedY = static_cast<uint32_t>(gridCoord.y) & (GRID_HEIGHT - 1);
-    uint32_t clickedCellIndex = clickedX + clickedY * GRID_WIDTH;
+    uint32_t clickedCellIndex = spatialGrid.getCellIndex(gridCoord);
     
     std::cout << "=== ENTITY SEARCH DEBUG ===" << std::endl;
     std::cout << "Click position: (" << worldPos.x << ", " << worldPos.y << ")" << std::endl;
     std::cout << "CELL_SIZE: " << CELL_SIZE << ", GRID_WIDTH: " << GRID_WIDTH << ", GRID_HEIGHT: " << GRID_HEIGHT << std::endl;
     std::cout << "Raw grid coord: (" << gridCoord.x << ", " << gridCoord.y << ")" << std::endl;
     std::cout << "Wrapped grid coord: (" << clickedX << ", " << clickedY << ")" << std::endl;
-    std::cout << "Clicked cell: " << clickedCellIndex << " (formula: " << clickedX << " + " << clickedY << " * " << GRID_WIDTH << ")" << std::endl;
+    std::cout << "Clicked cell: " << clickedCellIndex << (spatialGrid.cellOrder == SpatialCellOrder::Morton ? " (Morton order)" : " (row-major)") << std::endl;
     
     // Search nearby spatial cells for entities (much more efficient!)
     uint32_t closestEntity = 0;
@@ -213,7 +677,7 @@ bool EntityBufferManager::readbackEntityAtPosition(glm::vec2 worldPos, EntityDeb
             // Wrap around grid boundaries (handle negative coordinates properly)
             uint32_t searchX = ((uint32_t)(neighborX % (int)GRID_WIDTH + GRID_WIDTH)) & (GRID_WIDTH - 1);
             uint32_t searchY = ((uint32_t)(neighborY % (int)GRID_HEIGHT + GRID_HEIGHT)) & (GRID_HEIGHT - 1);
-            uint32_t searchCellIndex = searchX + searchY * GRID_WIDTH;
+            uint32_t searchCellIndex = spatialGrid.getCellIndex(glm::ivec2(searchX, searchY));
             
             cellsChecked++;
             
@@ -234,9 +698,7 @@ bool EntityBufferManager::readbackEntityAtPosition(glm::vec2 worldPos, EntityDeb
                         // Calculate entity's spatial cell using same logic as shader
                         glm::vec2 entityPos2D = glm::vec2(entityPosition);
                         glm::ivec2 entityGridCoord = glm::ivec2(glm::floor(entityPos2D / CELL_SIZE));
-                        uint32_t entityCellX = static_cast<uint32_t>(entityGridCoord.x) & (GRID_WIDTH - 1);
-                        uint32_t entityCellY = static_cast<uint32_t>(entityGridCoord.y) & (GRID_HEIGHT - 1);
-                        uint32_t entityActualCell = entityCellX + entityCellY * GRID_WIDTH;
+                        uint32_t entityActualCell = spatialGrid.getCellIndex(entityGridCoord);
                         
                         float distance = glm::distance(worldPos, glm::vec2(entityPosition));
                         std::cout << "  Entity " << entityId << " at (" << entityPosition.x << ", " << entityPosition.y 
@@ -264,9 +726,7 @@ bool EntityBufferManager::readbackEntityAtPosition(glm::vec2 worldPos, EntityDeb
     // Calculate which cell the closest entity is actually in
     glm::vec2 entityPos2D = glm::vec2(closestPosition);
     glm::ivec2 entityGridCoord = glm::ivec2(glm::floor(entityPos2D / CELL_SIZE));
-    uint32_t entityX = static_cast<uint32_t>(entityGridCoord.x) & (GRID_WIDTH - 1);
-    uint32_t entityY = static_cast<uint32_t>(entityGridCoord.y) & (GRID_WIDTH - 1);
-    uint32_t entityCellIndex = entityX + entityY * GRID_WIDTH;
+    uint32_t entityCellIndex = spatialGrid.getCellIndex(entityGridCoord);
     
     // Fill in the debug info
     info.entityId = closestEntity;
@@ -311,27 +771,22 @@ bool EntityBufferManager::readbackEntityById(uint32_t entityId, EntityDebugInfo&
     }
     
     // Calculate spatial cell from position (same logic as GPU)
-    const float CELL_SIZE = 2.0f;
-    const uint32_t GRID_WIDTH = 64;
+    const float CELL_SIZE = spatialGrid.cellSize;
     
     glm::vec2 pos2D = glm::vec2(info.position);
-    glm::ivec2 gridCoord = glm::ivec2(glm::floor(pos2D / CELL_SIZE));
-    uint32_t x = static_cast<uint32_t>(gridCoord.x) & (GRID_WIDTH - 1);
-    uint32_t y = static_cast<uint32_t>(gridCoord.y) & (GRID_WIDTH - 1);
-    info.spatialCell = x + y * GRID_WIDTH;
+    info.spatialCell = spatialGrid.getCellIndex(glm::ivec2(glm::floor(pos2D / CELL_SIZE)));
     
     return true;
 }
 
 bool EntityBufferManager::readbackSpatialCell(uint32_t cellIndex, std::vector<uint32_t>& entityIds) const {
-    const uint32_t SPATIAL_MAP_SIZE = 4096; // 64x64
-    if (cellIndex >= SPATIAL_MAP_SIZE) {
+    if (cellIndex >= spatialGrid.getCellCount()) {
         return false;
     }
     
     entityIds.clear();
     
-    // Read the spatial cell entry (uvec2: entityId, nextIndex)
+    // Read the spatial cell range (uvec2: start in sorted index buffer, entity count)
     glm::uvec2 cellData;
     if (!readGPUBuffer(spatialMapBuffer.getBuffer(), 
                       &cellData, sizeof(glm::uvec2), 
@@ -339,85 +794,639 @@ bool EntityBufferManager::readbackSpatialCell(uint32_t cellIndex, std::vector<ui
         return false;
     }
     
-    std::cout << "DEBUG: Cell " << cellIndex << " raw data: entityId=" << cellData.x 
-              << ", next=" << cellData.y << std::endl;
+    std::cout << "DEBUG: Cell " << cellIndex << " raw data: start=" << cellData.x 
+              << ", count=" << cellData.y << std::endl;
     
-    // Check if there's an entity in this cell
-    const uint32_t NULL_INDEX = 0xFFFFFFFF;
-    if (cellData.x == NULL_INDEX || cellData.x == 0) {
+    if (cellData.y == 0) {
         std::cout << "DEBUG: Empty cell (no entities)" << std::endl;
         return true; // Empty cell
     }
     
-    // Looking at the GPU shader more carefully:
-    // atomicExchange(spatialMap.spatialCells[cellIndex].x, entityIndex) 
-    // spatialMap.spatialCells[cellIndex].y = oldHead
-    //
-    // This means:
-    // - .x contains the most recent entity ID added to this cell
-    // - .y contains the previous head (which could be another entity or NULL_INDEX)
-    //
-    // But there's a race condition issue: the .y gets overwritten each time
-    // So we can only reliably get the most recent entity in each cell
-    
-    uint32_t headEntity = cellData.x;
-    if (headEntity != NULL_INDEX && headEntity < maxEntities) {
-        std::cout << "DEBUG: Found head entity " << headEntity << " in cell " << cellIndex << std::endl;
-        entityIds.push_back(headEntity);
-        
-        // Try to follow the chain, but this might not work reliably due to race conditions
-        uint32_t nextEntity = cellData.y;
-        if (nextEntity != NULL_INDEX && nextEntity < maxEntities && nextEntity != headEntity) {
-            std::cout << "DEBUG: Found next entity " << nextEntity << " in cell " << cellIndex << std::endl;
-            entityIds.push_back(nextEntity);
-        }
+    if (cellData.x >= maxEntities || cellData.y > maxEntities - cellData.x) {
+        std::cerr << "EntityBufferManager: Spatial cell " << cellIndex << " range out of bounds" << std::endl;
+        return false;
     }
     
+    // Entities of a cell are contiguous in the sorted index buffer after the scatter pass
+    entityIds.resize(cellData.y);
+    if (!readGPUBuffer(spatialIndexBuffer.getBuffer(),
+                      entityIds.data(), cellData.y * sizeof(uint32_t),
+                      cellData.x * sizeof(uint32_t))) {
+        entityIds.clear();
+        return false;
+    }
+    
+    std::cout << "DEBUG: Found " << entityIds.size() << " entities in cell " << cellIndex << std::endl;
     return true;
 }
 
-bool EntityBufferManager::initializeSpatialMapBuffer() {
-    const uint32_t SPATIAL_MAP_SIZE = 4096; // 64x64 grid
-    const uint32_t NULL_INDEX = 0xFFFFFFFF;
-    
-    // Create initialization data with NULL values
-    std::vector<glm::uvec2> initData(SPATIAL_MAP_SIZE);
-    for (auto& cell : initData) {
-        cell.x = NULL_INDEX; // entityId = NULL
-        cell.y = NULL_INDEX; // nextIndex = NULL
+bool EntityBufferManager::readbackEntityId(uint32_t gpuIndex, uint32_t& spawnId) const {
+    if (gpuIndex >= maxEntities) {
+        return false;
     }
     
-    // Upload the NULL initialization data
-    VkDeviceSize uploadSize = SPATIAL_MAP_SIZE * sizeof(glm::uvec2);
+    return readGPUBuffer(entityIdBuffer.getBuffer(), &spawnId, sizeof(uint32_t), gpuIndex * sizeof(uint32_t));
+}
+
+bool EntityBufferManager::initializeSpatialMapBuffer() {
+    // Every cell starts as an empty range (start = 0, count = 0)
+    std::vector<glm::uvec2> initData(spatialGridCapacity, glm::uvec2(0, 0));
+    
+    VkDeviceSize uploadSize = spatialGridCapacity * sizeof(glm::uvec2);
     bool success = uploadService.upload(spatialMapBuffer, initData.data(), uploadSize, 0);
     
     if (success) {
-        std::cout << "EntityBufferManager: Spatial map buffer initialized with NULL values (" 
-                  << SPATIAL_MAP_SIZE << " cells)" << std::endl;
+        std::cout << "EntityBufferManager: Spatial map buffer initialized with empty cells (" 
+                  << spatialGridCapacity << " cells)" << std::endl;
     }
     
     return success;
 }
 
-bool EntityBufferManager::readbackEntityAtPositionSafe(glm::vec2 worldPos, EntityDebugInfo& info) const {
-    if (!context) {
-        std::cerr << "EntityBufferManager::readbackEntityAtPositionSafe - No Vulkan context available" << std::endl;
+bool EntityBufferManager::configureSpatialGrid(uint32_t entityCount, float worldExtent) {
+    SpatialGridConfig config = SpatialGridConfig::choose(std::min(entityCount, maxEntities), worldExtent, spatialGrid.cellSize);
+    config.cellOrder = spatialGrid.cellOrder;
+    config.occupancyHistogram = spatialGrid.occupancyHistogram;
+    if (config.getCellCount() > spatialGridCapacity) {
+        std::cerr << "EntityBufferManager: Spatial grid " << config.width << "x" << config.height
+                  << " exceeds spatial map capacity (" << spatialGridCapacity << " cells)" << std::endl;
+        return false;
+    }
+    
+    if (config.width != spatialGrid.width || config.height != spatialGrid.height) {
+        std::cout << "EntityBufferManager: Spatial grid resized to " << config.width << "x" << config.height
+                  << " (cell size " << config.cellSize << ") for " << entityCount << " entities" << std::endl;
+    }
+    spatialGrid = config;
+    return true;
+}
+
+bool EntityBufferManager::requestEntityAtPosition(glm::vec2 worldPos, EntityPickCallback callback) {
+    if (!callback || !spatialMapBuffer.isInitialized()) {
+        return false;
+    }
+    
+    auto search = std::make_shared<EntityPickSearch>();
+    search->worldPos = worldPos;
+    search->grid = spatialGrid;
+    search->generation = generation;
+    search->callback = std::move(callback);
+    
+    // The 5x5 neighbourhood readbackEntityAtPosition searches, deduplicated for grids narrower than that
+    const int SEARCH_RADIUS = 2;
+    std::vector<uint32_t> cells;
+    for (int dy = -SEARCH_RADIUS; dy <= SEARCH_RADIUS; ++dy) {
+        for (int dx = -SEARCH_RADIUS; dx <= SEARCH_RADIUS; ++dx) {
+            cells.push_back(spatialCellOf(spatialGrid, worldPos + glm::vec2(dx, dy) * spatialGrid.cellSize));
+        }
+    }
+    std::sort(cells.begin(), cells.end());
+    cells.erase(std::unique(cells.begin(), cells.end()), cells.end());
+    
+    for (uint32_t cell : cells) {
+        bool queued = uploadService.readbackAsync(spatialMapBuffer, sizeof(glm::uvec2), cell * sizeof(glm::uvec2),
+            [this, search](const void* data, VkDeviceSize) {
+                if (!data) {
+                    search->failed = true;
+                } else {
+                    glm::uvec2 range;
+                    std::memcpy(&range, data, sizeof(range));
+                    if (range.y > 0 && range.x < maxEntities && range.y <= maxEntities - range.x) {
+                        search->cellRanges.push_back(range);
+                    }
+                }
+                if (--search->outstanding == 0) {
+                    readPickCandidates(search);
+                }
+            });
+        if (!queued) {
+            search->failed = true;
+            break;
+        }
+        search->outstanding++;
+    }
+    
+    // Requests that did queue still resolve and finish the search as failed
+    return search->outstanding > 0;
+}
+
+void EntityBufferManager::readPickCandidates(const std::shared_ptr<EntityPickSearch>& search) {
+    if (search->failed || search->generation != generation || search->cellRanges.empty()) {
+        finishPick(search);
+        return;
+    }
+    
+    for (const glm::uvec2& range : search->cellRanges) {
+        bool queued = uploadService.readbackAsync(spatialIndexBuffer, range.y * sizeof(uint32_t), range.x * sizeof(uint32_t),
+            [this, search](const void* data, VkDeviceSize size) {
+                if (!data) {
+                    search->failed = true;
+                } else {
+                    const size_t first = search->candidates.size();
+                    search->candidates.resize(first + size / sizeof(uint32_t));
+                    std::memcpy(search->candidates.data() + first, data, static_cast<size_t>(size));
+                }
+                if (--search->outstanding == 0) {
+                    readPickCandidateData(search);
+                }
+            });
+        if (!queued) {
+            search->failed = true;
+            break;
+        }
+        search->outstanding++;
+    }
+    
+    if (search->outstanding == 0) {
+        finishPick(search);
+    }
+}
+
+void EntityBufferManager::readPickCandidateData(const std::shared_ptr<EntityPickSearch>& search) {
+    auto& candidates = search->candidates;
+    candidates.erase(std::remove_if(candidates.begin(), candidates.end(),
+        [this](uint32_t index) { return index >= maxEntities; }), candidates.end());
+    
+    if (search->failed || search->generation != generation || candidates.empty()) {
+        finishPick(search);
+        return;
+    }
+    
+    search->positions.resize(candidates.size());
+    search->velocities.resize(candidates.size());
+    search->spawnIds.resize(candidates.size());
+    
+    // Each candidate's three streams resolve into its own slot, in whatever order the copies land
+    auto readInto = [this, search](VkBuffer buffer, VkDeviceSize stride, uint32_t index, void* dst) {
+        bool queued = uploadService.readbackAsync(buffer, stride, index * stride,
+            [this, search, dst](const void* data, VkDeviceSize size) {
+                if (!data) {
+                    search->failed = true;
+                } else {
+                    std::memcpy(dst, data, static_cast<size_t>(size));
+                }
+                if (--search->outstanding == 0) {
+                    finishPick(search);
+                }
+            });
+        if (queued) {
+            search->outstanding++;
+        }
+        return queued;
+    };
+    
+    for (size_t i = 0; i < candidates.size(); ++i) {
+        const uint32_t index = candidates[i];
+        if (!readInto(positionCoordinator.getPrimaryBuffer(), sizeof(glm::vec4), index, &search->positions[i]) ||
+            !readInto(velocityBuffer.getBuffer(), sizeof(glm::vec4), index, &search->velocities[i]) ||
+            !readInto(entityIdBuffer.getBuffer(), sizeof(uint32_t), index, &search->spawnIds[i])) {
+            search->failed = true;
+            break;
+        }
+    }
+    
+    if (search->outstanding == 0) {
+        finishPick(search);
+    }
+}
+
+bool EntityBufferManager::requestEntityState(uint32_t spawnId, EntityStateCallback callback) {
+    if (!callback || !spawnSlotBuffer.isInitialized() || spawnId >= spawnSlotBuffer.getSize() / sizeof(uint32_t)) {
         return false;
     }
     
-    // Wait for GPU to complete all operations to ensure spatial map is consistent
+    auto read = std::make_shared<EntityStateRead>();
+    read->spawnId = spawnId;
+    read->generation = generation;
+    read->callback = std::move(callback);
+    
+    return uploadService.readbackAsync(spawnSlotBuffer, sizeof(uint32_t), spawnId * sizeof(uint32_t),
+        [this, read](const void* data, VkDeviceSize) {
+            uint32_t slot = UINT32_MAX;
+            if (data) {
+                std::memcpy(&slot, data, sizeof(slot));
+            }
+            readEntityStateSlot(read, slot);
+        });
+}
+
+void EntityBufferManager::readEntityStateSlot(const std::shared_ptr<EntityStateRead>& read, uint32_t slot) {
+    if (slot >= maxEntities || read->generation != generation) {
+        read->failed = true;
+        finishEntityStateRead(read);
+        return;
+    }
+    read->state.slot = slot;
+    
+    // Same shape as the pick's candidate stage: every stream resolves into its own field
+    auto readInto = [this, read, slot](VkBuffer buffer, VkDeviceSize stride, void* dst) {
+        bool queued = uploadService.readbackAsync(buffer, stride, slot * stride,
+            [this, read, dst](const void* data, VkDeviceSize size) {
+                if (!data) {
+                    read->failed = true;
+                } else {
+                    std::memcpy(dst, data, static_cast<size_t>(size));
+                }
+                if (--read->outstanding == 0) {
+                    finishEntityStateRead(read);
+                }
+            });
+        if (queued) {
+            read->outstanding++;
+        }
+        return queued;
+    };
+    
+    if (!readInto(positionCoordinator.getPrimaryBuffer(), sizeof(glm::vec4), &read->state.position) ||
+        !readInto(movementParamsBuffer.getBuffer(), movementParamsBuffer.getElementSize(), &read->movementBits) ||
+        !readInto(entityTypeBuffer.getBuffer(), sizeof(uint32_t), &read->state.entityType) ||
+        !readInto(entityIdBuffer.getBuffer(), sizeof(uint32_t), &read->slotSpawnId)) {
+        read->failed = true;
+    }
+    
+    if (read->outstanding == 0) {
+        finishEntityStateRead(read);
+    }
+}
+
+void EntityBufferManager::finishEntityStateRead(const std::shared_ptr<EntityStateRead>& read) {
+    const bool found = !read->failed && read->generation == generation && read->slotSpawnId == read->spawnId;
+    if (found) {
+        const glm::uvec4& bits = read->movementBits;
+        read->state.movementParams = compactLayout
+            ? glm::vec4(glm::unpackHalf2x16(bits.x), glm::unpackHalf2x16(bits.y))
+            : glm::uintBitsToFloat(bits);
+    }
+    
+    EntityStateCallback callback = std::move(read->callback);
+    callback(found, read->state);
+}
+
+bool EntityBufferManager::requestExpiredEntityCount(std::function<void(const uint32_t* count)> callback) {
+    return uploadService.readbackAsync(indirectCommandBuffer, sizeof(uint32_t), EntityIndirectCommandBuffer::getExpiredCountOffset(),
+        [callback = std::move(callback)](const void* data, VkDeviceSize) {
+            uint32_t count = 0;
+            if (data) {
+                std::memcpy(&count, data, sizeof(count));
+            }
+            callback(data ? &count : nullptr);
+        });
+}
+
+void EntityBufferManager::recordStreamMirror(VkCommandBuffer commandBuffer, uint32_t entityCount) const {
     const auto& vk = context->getLoader();
-    const VkDevice device = context->getDevice();
+    const std::array<const BufferBase*, 3> streams = {&movementParamsBuffer, &colorBuffer, &entityIdBuffer};
+    for (const BufferBase* stream : streams) {
+        VkBufferCopy copy{0, 0, static_cast<VkDeviceSize>(entityCount) * stream->getElementSize()};
+        vk.vkCmdCopyBuffer(commandBuffer, stream->getBuffer(), stream->getRenderInstanceBuffer(), 1, &copy);
+    }
+}
+
+bool EntityBufferManager::recordEntityBoundsReadback(VkCommandBuffer commandBuffer, uint32_t tick) {
+    auto* resourceCoordinator = uploadService.getResourceCoordinator();
+    ReadbackRing* ring = resourceCoordinator ? resourceCoordinator->getReadbackRing() : nullptr;
+    if (!ring) {
+        return false;
+    }
+    
+    return ring->recordCopy(commandBuffer, indirectCommandBuffer.getBuffer(), EntityIndirectCommandBuffer::getBoundsOffset(),
+        sizeof(EntityBoundsRecord), [this, tick](const void* data, VkDeviceSize) {
+            if (!data) return;
+            EntityBoundsRecord record;
+            std::memcpy(&record, data, sizeof(record));
+            
+            std::lock_guard<std::mutex> lock(boundsMutex);
+            latestBounds.minimum = glm::vec3(record.minimum[0], record.minimum[1], record.minimum[2]);
+            latestBounds.maximum = glm::vec3(record.maximum[0], record.maximum[1], record.maximum[2]);
+            latestBounds.centroid = glm::vec3(record.centroid[0], record.centroid[1], record.centroid[2]);
+            latestBounds.count = record.count;
+            latestBounds.positionHash = record.positionHash;
+            latestBounds.tick = tick;
+            latestBounds.valid = true;
+        });
+}
+
+bool EntityBufferManager::recordSimulationCountersReadback(VkCommandBuffer commandBuffer) {
+    auto* resourceCoordinator = uploadService.getResourceCoordinator();
+    ReadbackRing* ring = resourceCoordinator ? resourceCoordinator->getReadbackRing() : nullptr;
+    if (!ring) {
+        return false;
+    }
+    
+    return ring->recordCopy(commandBuffer, indirectCommandBuffer.getBuffer(), EntityIndirectCommandBuffer::getSimulationCountersOffset(),
+        sizeof(EntitySimulationCounters), [this](const void* data, VkDeviceSize) {
+            if (!data) return;
+            EntitySimulationCounters record;
+            std::memcpy(&record, data, sizeof(record));
+            
+            std::lock_guard<std::mutex> lock(boundsMutex);
+            SimulationCounters& counters = latestSimulationCounters;
+            if (counters.valid) {
+                // Unsigned differences stay right across the GPU totals wrapping
+                counters.frameCollisions = record.collisions - lastSimulationTotals.collisions;
+                counters.frameTruncatedEntities = record.truncatedEntities - lastSimulationTotals.truncatedEntities;
+                counters.frameDirectionChanges = record.directionChanges - lastSimulationTotals.directionChanges;
+                counters.collisions += counters.frameCollisions;
+                counters.truncatedEntities += counters.frameTruncatedEntities;
+                counters.directionChanges += counters.frameDirectionChanges;
+            }
+            lastSimulationTotals = record;
+            
+            counters.occupiedCells = record.occupiedCells;
+            counters.overflowCells = record.overflowCells;
+            counters.maxCellOccupancy = record.maxCellOccupancy;
+            counters.histogramValid = record.histogramValid != 0;
+            if (counters.histogramValid) {
+                std::copy(std::begin(record.occupancyHistogram), std::end(record.occupancyHistogram), counters.occupancyHistogram.begin());
+            }
+            counters.valid = true;
+        });
+}
+
+void EntityBufferManager::requestEntityIdPick(glm::vec2 viewportPos, EntityIdPickCallback callback) {
+    failEntityIdPick();
+    pendingIdPick.viewportPos = viewportPos;
+    pendingIdPick.callback = std::move(callback);
+    pendingIdPick.deferredFrames = 0;
+}
+
+bool EntityBufferManager::recordEntityIdPickReadback(VkCommandBuffer commandBuffer, VkImage pickImage, VkOffset2D pixel) {
+    auto* resourceCoordinator = uploadService.getResourceCoordinator();
+    ReadbackRing* ring = resourceCoordinator ? resourceCoordinator->getReadbackRing() : nullptr;
+    if (!ring || !pendingIdPick.callback) {
+        return false;
+    }
+    
+    EntityIdPickCallback callback = std::move(pendingIdPick.callback);
+    pendingIdPick.callback = nullptr;
+    auto shared = std::make_shared<EntityIdPickCallback>(std::move(callback));
+    const bool recorded = ring->recordImageCopy(commandBuffer, pickImage, VkRect2D{pixel, {1, 1}}, sizeof(uint32_t),
+        [shared](const void* data, VkDeviceSize) {
+            uint32_t pickId = 0;
+            if (data) {
+                std::memcpy(&pickId, data, sizeof(pickId));
+            }
+            // The attachment holds spawn ID + 1, so 0 is background
+            (*shared)(!data ? EntityIdPickResult::Unavailable : pickId == 0 ? EntityIdPickResult::Miss : EntityIdPickResult::Hit,
+                      pickId - 1);
+        });
+    if (!recorded) {
+        (*shared)(EntityIdPickResult::Unavailable, UINT32_MAX);
+    }
+    return recorded;
+}
+
+void EntityBufferManager::deferEntityIdPick() {
+    if (pendingIdPick.callback && ++pendingIdPick.deferredFrames > ENTITY_PICK_MAX_PENDING_FRAMES) {
+        failEntityIdPick();
+    }
+}
+
+void EntityBufferManager::failEntityIdPick() {
+    if (!pendingIdPick.callback) {
+        return;
+    }
+    EntityIdPickCallback callback = std::move(pendingIdPick.callback);
+    pendingIdPick.callback = nullptr;
+    callback(EntityIdPickResult::Unavailable, UINT32_MAX);
+}
+
+EntityBounds EntityBufferManager::getEntityBounds() const {
+    std::lock_guard<std::mutex> lock(boundsMutex);
+    return latestBounds;
+}
+
+SimulationCounters EntityBufferManager::getSimulationCounters() const {
+    std::lock_guard<std::mutex> lock(boundsMutex);
+    return latestSimulationCounters;
+}
+
+void EntityBufferManager::submitSpatialQuery(const SpatialQuery& query, SpatialQueryCallback callback) {
+    if (!callback) {
+        return;
+    }
+    
+    PendingSpatialQuery pending;
+    pending.record.center[0] = query.center.x;
+    pending.record.center[1] = query.center.y;
+    pending.record.radius = std::isfinite(query.radius) ? std::max(query.radius, 0.0f) : std::numeric_limits<float>::max();
+    pending.record.params = std::min(query.maxResults, SPATIAL_QUERY_MAX_RESULTS) |
+                            (query.kind == SpatialQuery::Kind::Nearest ? SpatialQueryRecord::NEAREST_BIT : 0u);
+    pending.callback = std::move(callback);
+    pendingSpatialQueries.push_back(std::move(pending));
+}
+
+SpatialQueryBatch EntityBufferManager::takeSpatialQueryBatch() {
+    SpatialQueryBatch batch;
+    const size_t count = std::min<size_t>(pendingSpatialQueries.size(), SPATIAL_QUERY_MAX_BATCH);
+    batch.records.reserve(count);
+    batch.callbacks.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        batch.records.push_back(pendingSpatialQueries[i].record);
+        batch.callbacks.push_back(std::move(pendingSpatialQueries[i].callback));
+    }
+    pendingSpatialQueries.erase(pendingSpatialQueries.begin(), pendingSpatialQueries.begin() + count);
+    return batch;
+}
+
+bool EntityBufferManager::recordSpatialQueryReadback(VkCommandBuffer commandBuffer, SpatialQueryBatch batch) {
+    auto* resourceCoordinator = uploadService.getResourceCoordinator();
+    ReadbackRing* ring = resourceCoordinator ? resourceCoordinator->getReadbackRing() : nullptr;
+    if (!ring || batch.empty()) {
+        answerSpatialQueries(batch, false);
+        return false;
+    }
+    
+    const uint32_t queryCount = static_cast<uint32_t>(batch.records.size());
+    auto shared = std::make_shared<SpatialQueryBatch>(std::move(batch));
+    const bool recorded = ring->recordCopy(commandBuffer, reorderScratchBuffer.getBuffer(), SpatialQueryBatch::RESULT_OFFSET,
+        queryCount * SpatialQueryBatch::RESULT_STRIDE, [shared, queryCount](const void* data, VkDeviceSize) {
+            if (!data) {
+                answerSpatialQueries(*shared, false);
+                return;
+            }
+            
+            SpatialQueryResult result;
+            result.available = true;
+            for (uint32_t query = 0; query < queryCount; ++query) {
+                const auto* words = static_cast<const uint32_t*>(data) + query * (SpatialQueryBatch::RESULT_STRIDE / sizeof(uint32_t));
+                const uint32_t found = std::min(words[0], SPATIAL_QUERY_MAX_RESULTS);
+                result.total = words[1];
+                result.hits.resize(found);
+                for (uint32_t i = 0; i < found; ++i) {
+                    result.hits[i].spawnId = words[2 + 2 * i];
+                    std::memcpy(&result.hits[i].distance, &words[3 + 2 * i], sizeof(float));
+                }
+                shared->callbacks[query](result);
+            }
+        });
+    if (!recorded) {
+        answerSpatialQueries(*shared, false);
+    }
+    return recorded;
+}
+
+void EntityBufferManager::answerSpatialQueries(const SpatialQueryBatch& batch, bool available) {
+    SpatialQueryResult result;
+    result.available = available;
+    for (const auto& callback : batch.callbacks) {
+        callback(result);
+    }
+}
+
+void EntityBufferManager::failSpatialQueries() {
+    std::vector<PendingSpatialQuery> pending = std::move(pendingSpatialQueries);
+    pendingSpatialQueries.clear();
+    SpatialQueryResult result;
+    for (const auto& query : pending) {
+        query.callback(result);
+    }
+}
+
+void EntityBufferManager::refreshPositionMirror(uint32_t frame, uint32_t liveCount) {
+    if (positionMirror.isSweeping() && positionMirror.getSweepGeneration() != generation) {
+        positionMirror.abortSweep();  // Growth cancelled its queued chunks; the slots are re-read from scratch
+    }
+    if (positionMirror.isSweepDue(frame)) {
+        positionMirror.beginSweep(frame, std::min(liveCount, maxEntities), generation);
+    }
     
-    VkResult result = vk.vkDeviceWaitIdle(device);
-    if (result != VK_SUCCESS) {
-        std::cerr << "EntityBufferManager::readbackEntityAtPositionSafe - Failed to wait for GPU idle: " << result << std::endl;
+    uint32_t first = 0;
+    uint32_t count = 0;
+    for (uint32_t chunk = 0; chunk < POSITION_MIRROR_CHUNKS_PER_FRAME && positionMirror.takeChunk(first, count); ++chunk) {
+        const uint32_t sweep = positionMirror.getSweepId();
+        bool queued = uploadService.readbackAsync(positionCoordinator.getPrimaryBuffer(), count * sizeof(glm::vec4),
+            first * sizeof(glm::vec4), [this, sweep, first, count](const void* data, VkDeviceSize) {
+                positionMirror.storePositions(sweep, first, data, count);
+            });
+        if (queued) {
+            positionMirror.addOutstanding();
+            queued = uploadService.readbackAsync(entityIdBuffer, count * sizeof(uint32_t), first * sizeof(uint32_t),
+                [this, sweep, first, count](const void* data, VkDeviceSize) {
+                    positionMirror.storeSpawnIds(sweep, first, data, count);
+                });
+        }
+        if (!queued) {
+            positionMirror.abortSweep();
+            break;
+        }
+        positionMirror.addOutstanding();
+    }
+}
+
+bool EntityBufferManager::startTelemetryCapture(const std::string& path, uint32_t streams, uint32_t interval) {
+    auto* resourceCoordinator = uploadService.getResourceCoordinator();
+    if (!resourceCoordinator || !resourceCoordinator->enableStreamingReadbackRing(TELEMETRY_CAPTURE_RING_BYTES_PER_FRAME)) {
+        std::cerr << "EntityBufferManager: Telemetry capture needs the streaming readback ring" << std::endl;
         return false;
     }
     
-    std::cout << "GPU synchronized - spatial map data should be consistent" << std::endl;
+    const std::array<uint32_t, EntityTelemetryCapture::STREAM_COUNT> elementSizes = {
+        sizeof(glm::vec4), sizeof(glm::vec4), static_cast<uint32_t>(getRuntimeStateStride()), sizeof(uint32_t)};
+    return telemetryCapture.open(path, streams, interval, elementSizes);
+}
+
+void EntityBufferManager::refreshTelemetryCapture(uint32_t frame, uint32_t liveCount) {
+    if (telemetryCapture.isCapturing() && telemetryCapture.getCaptureGeneration() != generation) {
+        telemetryCapture.abortCapture();  // Growth cancelled its queued chunks
+    }
+    
+    const uint32_t count = std::min(liveCount, maxEntities);
+    auto* resourceCoordinator = uploadService.getResourceCoordinator();
+    ReadbackRing* ring = resourceCoordinator ? resourceCoordinator->getStreamingReadbackRing() : nullptr;
+    if (!ring || count == 0 || !telemetryCapture.isCaptureDue(frame) || !telemetryCapture.beginCapture(frame, count, generation)) {
+        return;
+    }
+    
+    // Indexed by stream bit. Every chunk is queued now; the ring records what fits this frame and defers the rest,
+    // so a capture only spans frames when it outgrows TELEMETRY_CAPTURE_RING_BYTES_PER_FRAME
+    const std::array<VkBuffer, EntityTelemetryCapture::STREAM_COUNT> sources = {
+        positionCoordinator.getPrimaryBuffer(), velocityBuffer.getBuffer(), runtimeStateBuffer.getBuffer(), entityIdBuffer.getBuffer()};
+    const uint32_t capture = telemetryCapture.getCaptureId();
+    for (uint32_t stream = 0; stream < EntityTelemetryCapture::STREAM_COUNT; ++stream) {
+        if (!(telemetryCapture.getStreams() & (1u << stream))) continue;
+        
+        const VkDeviceSize streamSize = VkDeviceSize(count) * telemetryCapture.getElementSize(stream);
+        for (VkDeviceSize offset = 0; offset < streamSize; offset += TELEMETRY_CAPTURE_CHUNK_BYTES) {
+            const VkDeviceSize size = std::min<VkDeviceSize>(TELEMETRY_CAPTURE_CHUNK_BYTES, streamSize - offset);
+            bool queued = ring->request(sources[stream], offset, size, [this, capture, stream, offset](const void* data, VkDeviceSize size) {
+                telemetryCapture.storeChunk(capture, stream, offset, data, size);
+            });
+            if (!queued) {
+                telemetryCapture.abortCapture();
+                return;
+            }
+            telemetryCapture.addOutstanding();
+        }
+    }
+}
+
+bool EntityBufferManager::startEntityStream(uint16_t port, uint32_t interval, uint32_t budgetBytes) {
+    auto* resourceCoordinator = uploadService.getResourceCoordinator();
+    if (!resourceCoordinator || !resourceCoordinator->enableStreamingReadbackRing(TELEMETRY_CAPTURE_RING_BYTES_PER_FRAME)) {
+        std::cerr << "EntityBufferManager: Entity streaming needs the streaming readback ring" << std::endl;
+        return false;
+    }
+    return entityStream.open(port, interval, budgetBytes);
+}
+
+void EntityBufferManager::refreshEntityStream(uint32_t frame, uint32_t liveCount) {
+    if (entityStream.isTakingSnapshot() && entityStream.getSnapshotGeneration() != generation) {
+        entityStream.abortSnapshot();  // Growth cancelled its queued chunks
+    }
+    
+    const uint32_t count = std::min(liveCount, maxEntities);
+    auto* resourceCoordinator = uploadService.getResourceCoordinator();
+    ReadbackRing* ring = resourceCoordinator ? resourceCoordinator->getStreamingReadbackRing() : nullptr;
+    if (!ring || count == 0 || !entityStream.isSnapshotDue(frame) ||
+        !entityStream.beginSnapshot(frame, count, generation, spatialGrid.cellSize)) {
+        return;
+    }
+    
+    // Stream 0 is positions, 1 spawn IDs; queued whole like a telemetry capture
+    const std::array<VkBuffer, 2> sources = {positionCoordinator.getPrimaryBuffer(), entityIdBuffer.getBuffer()};
+    const std::array<VkDeviceSize, 2> elementSizes = {sizeof(glm::vec4), sizeof(uint32_t)};
+    const uint32_t snapshot = entityStream.getSnapshotId();
+    for (uint32_t stream = 0; stream < sources.size(); ++stream) {
+        const VkDeviceSize streamSize = VkDeviceSize(count) * elementSizes[stream];
+        for (VkDeviceSize offset = 0; offset < streamSize; offset += TELEMETRY_CAPTURE_CHUNK_BYTES) {
+            const VkDeviceSize size = std::min<VkDeviceSize>(TELEMETRY_CAPTURE_CHUNK_BYTES, streamSize - offset);
+            bool queued = ring->request(sources[stream], offset, size, [this, snapshot, stream, offset](const void* data, VkDeviceSize size) {
+                entityStream.storeChunk(snapshot, stream, offset, data, size);
+            });
+            if (!queued) {
+                entityStream.abortSnapshot();
+                return;
+            }
+            entityStream.addOutstanding();
+        }
+    }
+}
+
+void EntityBufferManager::finishPick(const std::shared_ptr<EntityPickSearch>& search) {
+    EntityDebugInfo info{};
+    bool found = false;
+    
+    if (!search->failed && search->generation == generation) {
+        float closestDistance = std::numeric_limits<float>::max();
+        for (size_t i = 0; i < search->positions.size(); ++i) {
+            float distance = glm::distance(search->worldPos, glm::vec2(search->positions[i]));
+            if (distance < closestDistance) {
+                closestDistance = distance;
+                info.entityId = search->candidates[i];
+                info.position = search->positions[i];
+                info.velocity = search->velocities[i];
+                info.spawnId = search->spawnIds[i];
+                found = true;
+            }
+        }
+        if (found) {
+            info.spatialCell = spatialCellOf(search->grid, glm::vec2(info.position));
+        }
+    }
     
-    // Now perform the readback with guaranteed consistent data
-    return readbackEntityAtPosition(worldPos, info);
+    // Moved out first: a callback issuing a new pick must not find this search still referenced
+    EntityPickCallback callback = std::move(search->callback);
+    callback(found, info);
 }
 
@@ -3,13 +3,131 @@
 #include "specialized_buffers.h"
 #include "position_buffer_coordinator.h"
 #include "buffer_upload_service.h"
+#include "entity_position_export.h"
+#include "entity_position_mirror.h"
+#include "entity_stream_server.h"
+#include "entity_telemetry_capture.h"
+#include "../../vulkan/core/vulkan_constants.h"
+#include "../../vulkan/resources/core/resource_handle.h"
+#include "../../vulkan/resources/core/command_executor.h"
 #include <vulkan/vulkan.h>
+#include <array>
+#include <functional>
 #include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
 
 // Forward declarations
 class VulkanContext;
 class ResourceCoordinator;
 
+// Order of the cells in the spatial map, and so of entities in the sorted index (and after a reorder, in the
+// entity buffers). Morton interleaves the wrapped cell coordinates, so a dense cluster spanning a few rows of
+// cells still occupies one contiguous run instead of one run per row. Must match spatial_cells.glsl
+enum class SpatialCellOrder : uint32_t {
+    RowMajor = 0,
+    Morton = 1
+};
+
+// Active spatial grid layout - width and height are powers of 2 so the GPU hash can wrap with a mask
+struct SpatialGridConfig {
+    uint32_t width = SPATIAL_GRID_MIN_DIMENSION;
+    uint32_t height = SPATIAL_GRID_MIN_DIMENSION;
+    float cellSize = SPATIAL_CELL_SIZE;
+    SpatialCellOrder cellOrder = SpatialCellOrder::RowMajor;  // Morton needs width == height, which choose() keeps
+    bool occupancyHistogram = false;  // Prefix sum pass also bins cell occupancy (SimulationCounters)
+    
+    uint32_t getCellCount() const { return width * height; }
+    
+    // Map index of an unwrapped cell coordinate, as spatialCellIndex in spatial_cells.glsl
+    uint32_t getCellIndex(glm::ivec2 cell) const;
+    
+    // Enough cells to cover worldExtent without aliasing, but no more cells than entities need
+    static SpatialGridConfig choose(uint32_t entityCount, float worldExtent, float cellSize = SPATIAL_CELL_SIZE);
+};
+
+// Live entity extent from the GPU bounds reduction (EntityBoundsNode), a couple of frames old when read
+struct EntityBounds {
+    glm::vec3 minimum{0.0f};
+    glm::vec3 maximum{0.0f};
+    glm::vec3 centroid{0.0f};
+    uint32_t count = 0;   // Unexpired live entities
+    uint32_t positionHash = 0;  // Order-independent hash of the positions' exact bits (entity_bounds.comp)
+    uint32_t tick = 0;    // Last simulation tick the reduction ran after
+    bool valid = false;   // False until the first reduction has been read back
+};
+
+// Physics, random walk and grid build counters (EntityIndirectCommands::simulation), read back after each frame's
+// physics pass; a couple of frames old when read
+struct SimulationCounters {
+    // Since the entity buffers were created, and in the latest frame read back
+    uint64_t collisions = 0;
+    uint64_t truncatedEntities = 0;  // Narrow phases that skipped neighbours past the physics cell capacity
+    uint64_t directionChanges = 0;   // New random walk directions
+    uint32_t frameCollisions = 0;
+    uint32_t frameTruncatedEntities = 0;
+    uint32_t frameDirectionChanges = 0;
+    
+    // Last grid build
+    uint32_t occupiedCells = 0;
+    uint32_t overflowCells = 0;      // Cells holding more entities than the physics cell capacity
+    uint32_t maxCellOccupancy = 0;
+    bool histogramValid = false;     // Only built while SpatialGridConfig::occupancyHistogram is set
+    std::array<uint32_t, SPATIAL_OCCUPANCY_HISTOGRAM_BINS> occupancyHistogram{};
+    
+    bool valid = false;              // False until the first readback after initialize()
+};
+
+// GPU spatial query (EntityBufferManager::submitSpatialQuery): the entities within radius of center, nearest first.
+// A radius query counts everything in range and keeps the nearest maxResults; a nearest query only looks as far as
+// it needs to fill maxResults. The radius stops at SPATIAL_QUERY_MAX_CELL_RADIUS grid cells (and short of half the
+// grid), so a nearest query without one searches that far
+struct SpatialQuery {
+    enum class Kind : uint32_t { Radius, Nearest };
+    
+    glm::vec2 center{0.0f};
+    float radius = 0.0f;
+    uint32_t maxResults = SPATIAL_QUERY_MAX_RESULTS;  // At most SPATIAL_QUERY_MAX_RESULTS
+    Kind kind = Kind::Radius;
+};
+
+struct SpatialQueryHit {
+    uint32_t spawnId = 0;
+    float distance = 0.0f;
+};
+
+struct SpatialQueryResult {
+    bool available = false;             // False when the query never ran (full readback ring, buffer teardown)
+    uint32_t total = 0;                 // Radius: every entity in range, even past maxResults; Nearest: hits.size()
+    std::vector<SpatialQueryHit> hits;  // Nearest first
+};
+
+// One query in the word layout spatial_query.comp reads
+struct SpatialQueryRecord {
+    float center[2] = {0.0f, 0.0f};
+    float radius = 0.0f;
+    uint32_t params = 0;  // maxResults | NEAREST_BIT
+    
+    static constexpr uint32_t NEAREST_BIT = 0x10000u;
+};
+static_assert(sizeof(SpatialQueryRecord) == 16, "SpatialQueryRecord must match the query stride in spatial_query.comp");
+
+using SpatialQueryCallback = std::function<void(const SpatialQueryResult& result)>;
+
+// Queries of one SpatialQueryNode pass, in submission order. In the reorder scratch buffer the records start at
+// byte 0 and results at RESULT_OFFSET, RESULT_STRIDE per query: found and total, then found (spawn ID, distance)
+struct SpatialQueryBatch {
+    std::vector<SpatialQueryRecord> records;
+    std::vector<SpatialQueryCallback> callbacks;
+    
+    static constexpr VkDeviceSize RESULT_OFFSET = SPATIAL_QUERY_MAX_BATCH * sizeof(SpatialQueryRecord);
+    static constexpr VkDeviceSize RESULT_STRIDE = (2 + 2 * SPATIAL_QUERY_MAX_RESULTS) * sizeof(uint32_t);
+    static constexpr VkDeviceSize SCRATCH_BYTES = RESULT_OFFSET + SPATIAL_QUERY_MAX_BATCH * RESULT_STRIDE;
+    
+    bool empty() const { return records.empty(); }
+};
+
 /**
  * REFACTORED: Entity buffer manager using SRP-compliant specialized buffer classes
  * Single responsibility: coordinate specialized buffer components for entity rendering
@@ -19,7 +137,8 @@ public:
     EntityBufferManager();
     ~EntityBufferManager();
 
-    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities);
+    // compactLayout selects the ENTITY_COMPACT_LAYOUT encoding of the movement params and runtime state streams
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities, bool compactLayout = false);
     void cleanup();
     
     // SoA buffer access - delegated to specialized buffers
@@ -29,6 +148,15 @@ public:
     VkBuffer getColorBuffer() const { return colorBuffer.getBuffer(); }
     VkBuffer getModelMatrixBuffer() const { return modelMatrixBuffer.getBuffer(); }
     VkBuffer getSpatialMapBuffer() const { return spatialMapBuffer.getBuffer(); }
+    VkBuffer getSpatialEntryBuffer() const { return spatialEntryBuffer.getBuffer(); }
+    VkBuffer getSpatialIndexBuffer() const { return spatialIndexBuffer.getBuffer(); }
+    VkBuffer getEntityIdBuffer() const { return entityIdBuffer.getBuffer(); }
+    VkBuffer getEntityTypeBuffer() const { return entityTypeBuffer.getBuffer(); }
+    VkBuffer getSpawnSlotBuffer() const { return spawnSlotBuffer.getBuffer(); }
+    VkBuffer getReorderScratchBuffer() const { return reorderScratchBuffer.getBuffer(); }
+    VkBuffer getIndirectCommandBuffer() const { return indirectCommandBuffer.getBuffer(); }
+    VkBuffer getVisibleIndexBuffer() const { return visibleIndexBuffer.getBuffer(); }
+    VkBuffer getVisibleDrawCommandBuffer() const { return visibleDrawCommandBuffer.getBuffer(); }
     
     // Position buffers - delegated to coordinator
     VkBuffer getPositionBuffer() const { return positionCoordinator.getPrimaryBuffer(); }
@@ -38,8 +166,23 @@ public:
     
     
     // Ping-pong buffer access - delegated to coordinator
-    VkBuffer getComputeWriteBuffer(uint32_t frameIndex) const { return positionCoordinator.getComputeWriteBuffer(frameIndex); }
-    VkBuffer getGraphicsReadBuffer(uint32_t frameIndex) const { return positionCoordinator.getGraphicsReadBuffer(frameIndex); }
+    VkBuffer getComputeWriteBuffer(uint32_t frame) const { return positionCoordinator.getComputeWriteBuffer(frame); }
+    VkBuffer getGraphicsReadBuffer(uint32_t frame) const { return positionCoordinator.getGraphicsReadBuffer(frame); }
+    
+    // Culling output snapshots published alongside the positions (slot = frame % PUBLISHED_SNAPSHOT_COUNT)
+    VkBuffer getPublishedPositionBuffer(uint32_t slot) const { return positionCoordinator.getComputeWriteBuffer(slot); }
+    VkBuffer getPublishedVisibleIndexBuffer(uint32_t slot) const { return publishedVisibleIndexBuffers[slot % PUBLISHED_SNAPSHOT_COUNT].getBuffer(); }
+    VkBuffer getPublishedDrawCommandBuffer(uint32_t slot) const { return publishedDrawCommandBuffers[slot % PUBLISHED_SNAPSHOT_COUNT].getBuffer(); }
+    bool hasPublishedSnapshots() const { return publishedDrawCommandBuffers[0].isInitialized(); }
+    
+    // Multi-device simulation: the rendering GPU's instance of the snapshots and the graphics-read streams, which
+    // EntityPublishNode copies into from the simulation GPU (the buffers themselves otherwise)
+    VkBuffer getPublishedPositionRenderInstance(uint32_t slot) const { return positionCoordinator.getPublishedBuffer(slot).getRenderInstanceBuffer(); }
+    VkBuffer getPublishedVisibleIndexRenderInstance(uint32_t slot) const { return publishedVisibleIndexBuffers[slot % PUBLISHED_SNAPSHOT_COUNT].getRenderInstanceBuffer(); }
+    VkBuffer getPublishedDrawCommandRenderInstance(uint32_t slot) const { return publishedDrawCommandBuffers[slot % PUBLISHED_SNAPSHOT_COUNT].getRenderInstanceBuffer(); }
+    // Records copies of the live range of the movement params, colour and entity ID streams into their rendering
+    // GPU instances, for frames whose compute rewrote them
+    void recordStreamMirror(VkCommandBuffer commandBuffer, uint32_t entityCount) const;
     
     // Buffer properties - delegated to specialized buffers
     VkDeviceSize getVelocityBufferSize() const { return velocityBuffer.getSize(); }
@@ -48,9 +191,59 @@ public:
     VkDeviceSize getColorBufferSize() const { return colorBuffer.getSize(); }
     VkDeviceSize getModelMatrixBufferSize() const { return modelMatrixBuffer.getSize(); }
     VkDeviceSize getSpatialMapBufferSize() const { return spatialMapBuffer.getSize(); }
+    VkDeviceSize getSpatialEntryBufferSize() const { return spatialEntryBuffer.getSize(); }
+    VkDeviceSize getSpatialIndexBufferSize() const { return spatialIndexBuffer.getSize(); }
+    VkDeviceSize getEntityIdBufferSize() const { return entityIdBuffer.getSize(); }
+    VkDeviceSize getEntityTypeBufferSize() const { return entityTypeBuffer.getSize(); }
+    VkDeviceSize getSpawnSlotBufferSize() const { return spawnSlotBuffer.getSize(); }
+    VkDeviceSize getReorderScratchBufferSize() const { return reorderScratchBuffer.getSize(); }
+    VkDeviceSize getIndirectCommandBufferSize() const { return indirectCommandBuffer.getSize(); }
+    VkDeviceAddress getIndirectCommandAddress() const { return indirectCommandBuffer.getDeviceAddress(); }
+    VkDeviceSize getVisibleIndexBufferSize() const { return visibleIndexBuffer.getSize(); }
+    VkDeviceSize getVisibleDrawCommandBufferSize() const { return visibleDrawCommandBuffer.getSize(); }
     VkDeviceSize getPositionBufferSize() const { return positionCoordinator.getBufferSize(); }
+    VkDeviceSize getCurrentPositionBufferSize() const { return positionCoordinator.getCurrentBufferSize(); }
     uint32_t getMaxEntities() const { return maxEntities; }
     
+    // Per-entity byte strides of the layout-dependent streams
+    bool isCompactLayout() const { return compactLayout; }
+    
+    // No shader reads the model matrices, so the compact layout drops them (EntityStreamSchema) and allocates no
+    // buffer, as does any layout once reflection showed no kernel accesses binding 6 (getModelMatrixBuffer is
+    // VK_NULL_HANDLE and binding 6 is left unwritten)
+    bool hasModelMatrixStream() const {
+        return EntityStreamSchema::getStride(ModelMatrixBuffer::BINDING, compactLayout) != 0 &&
+               (accessedComputeBindings & (1u << ModelMatrixBuffer::BINDING)) != 0;
+    }
+    VkDeviceSize getMovementParamsStride() const { return movementParamsBuffer.getElementSize(); }
+    VkDeviceSize getRuntimeStateStride() const { return runtimeStateBuffer.getElementSize(); }
+    VkDeviceSize getCurrentPositionStride() const { return positionCoordinator.getCurrentStride(); }
+    
+    // Geometric capacity growth - per-entity buffers are reallocated and the live contents GPU-copied.
+    // Every VkBuffer handle changes, so the GPU must be idle and dependents rebind on a generation change.
+    // When canGrowInPlace, every buffer growth touches is a sparse reservation (ENABLE_SPARSE_ENTITY_BUFFERS)
+    // instead: their new pages are bound in one vkQueueBindSparse, handles, addresses and contents stay, and
+    // frames in flight need not drain. The generation still changes (sizes did); grewInPlace tells the two apart
+    bool growCapacity(uint32_t newMaxEntities);
+    bool canGrowInPlace(uint32_t newMaxEntities) const;
+    bool grewInPlace() const { return lastGrowthInPlace; }
+    uint64_t getGeneration() const { return generation; }
+    
+    // Device memory growCapacity adds per entity of capacity (the spatial map, sized by grid, is not included)
+    VkDeviceSize getBytesPerEntity() const;
+    
+    // Spatial grid configuration - the map buffer is sized for the largest grid maxEntities can select
+    const SpatialGridConfig& getSpatialGridConfig() const { return spatialGrid; }
+    uint32_t getSpatialGridCapacity() const { return spatialGridCapacity; }
+    bool configureSpatialGrid(uint32_t entityCount, float worldExtent);
+    
+    // Kept across grid resizes; takes effect with the next frame's grid passes
+    void setSpatialCellOrder(SpatialCellOrder order) { spatialGrid.cellOrder = order; }
+    void setOccupancyHistogram(bool enabled) { spatialGrid.occupancyHistogram = enabled; }
+    
+    // Likewise, but the grid dimensions depend on it: call configureSpatialGrid afterwards
+    void setSpatialCellSize(float cellSize) { spatialGrid.cellSize = cellSize; }
+    
     
     // Data upload - using shared upload service
     
@@ -61,34 +254,189 @@ public:
     bool uploadColorData(const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
     bool uploadModelMatrixData(const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
     bool uploadSpatialMapData(const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
+    bool uploadEntityIdData(const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
+    bool uploadEntityTypeData(const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
+    bool uploadIndirectCommands(const EntityIndirectCommands& commands);  // Leaves the expiry counter alone
+    bool uploadExpiredEntityCount(uint32_t count);
+    bool uploadVisibleDrawCommands(const VisibleDrawCommands& commands);
     bool uploadPositionDataToAllBuffers(const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
     
+    // Asynchronous upload - all regions go through one persistent staging buffer and one
+    // transfer-queue submit; completion is polled through the submit's fence, never waited on
+    struct UploadRegion {
+        VkBuffer dst = VK_NULL_HANDLE;
+        const void* data = nullptr;
+        VkDeviceSize size = 0;
+        VkDeviceSize offset = 0;
+    };
+    
+    bool submitAsyncUpload(const std::vector<UploadRegion>& regions);
+    bool isAsyncUploadInFlight() const { return asyncUpload.isValid(); }
+    bool pollAsyncUpload();     // True once the in-flight upload has landed (transfer is released)
+    void waitForAsyncUpload();  // Blocking fallback for teardown and clearAllEntities
+    
+    // Synchronous counterpart: the same regions as one BufferUploadService batch, waited on before returning
+    bool uploadRegions(const std::vector<UploadRegion>& regions);
+    
+    // Bytes submitted through either upload path so far, for the upload rate telemetry
+    uint64_t getUploadedBytes() const { return uploadedBytes; }
+    
+    // Blocking copy of a buffer range to host memory; stalls on the copy, so snapshots and debugging only
+    bool readGPUBuffer(VkBuffer srcBuffer, void* dstData, VkDeviceSize size, VkDeviceSize offset) const;
+    
     // Debug readback methods (expensive - use sparingly)
     struct EntityDebugInfo {
         glm::vec4 position;
         glm::vec4 velocity;
         uint32_t spatialCell;
         uint32_t entityId;
+        uint32_t spawnId = UINT32_MAX;  // Only filled by requestEntityAtPosition
     };
     
     bool readbackEntityAtPosition(glm::vec2 worldPos, EntityDebugInfo& info) const;
     bool readbackEntityById(uint32_t entityId, EntityDebugInfo& info) const;
     bool readbackSpatialCell(uint32_t cellIndex, std::vector<uint32_t>& entityIds) const;
+    bool readbackEntityId(uint32_t gpuIndex, uint32_t& spawnId) const;
+    
+    // Non-blocking counterpart of readbackEntityAtPosition: cell ranges, cell contents and the candidates'
+    // position, velocity and spawn ID are read back as three chained ReadbackRing stages, each recorded after
+    // that frame's compute, so the whole search takes a few frames and never stalls the GPU. Entities may
+    // move slots between stages; growing the buffers fails the search. False when nothing could be queued,
+    // otherwise callback runs exactly once on the render thread
+    using EntityPickCallback = std::function<void(bool found, const EntityDebugInfo& info)>;
+    bool requestEntityAtPosition(glm::vec2 worldPos, EntityPickCallback callback);
+    
+    // Non-blocking read of one entity's state by spawn ID (GPUEntityManager::requestRehydration): its slot from the
+    // SpawnSlotBuffer, then that slot's position, movement params, type and spawn ID as a second ReadbackRing stage.
+    // The read fails when the slot no longer holds the spawn ID by then (despawn compaction, reorder) or the buffers
+    // grew. False when nothing could be queued, otherwise callback runs exactly once on the render thread
+    struct EntityState {
+        glm::vec4 position{0.0f};
+        glm::vec4 movementParams{0.0f};  // amplitude, frequency, phase, timeOffset, decoded from either layout
+        uint32_t entityType = 0;         // EntityTypeBuffer::pack
+        uint32_t slot = 0;
+    };
+    using EntityStateCallback = std::function<void(bool found, const EntityState& state)>;
+    bool requestEntityState(uint32_t spawnId, EntityStateCallback callback);
+    
+    // Exact pick through the GPU pick attachment (ENABLE_ENTITY_PICK_BUFFER): EntityGraphicsNode takes the queued
+    // pick, draws that frame with the pick attachment and copies the pixel under viewportPos (0..1 across the
+    // render area) into the ReadbackRing. callback gets the spawn ID drawn there a few frames later, Miss over
+    // background, or Unavailable when the frame could not write the attachment (render pass path, density tiles,
+    // no entities, pick pipeline still compiling after ENTITY_PICK_MAX_PENDING_FRAMES). A new request replaces a
+    // queued one, which is reported Unavailable
+    enum class EntityIdPickResult { Hit, Miss, Unavailable };
+    using EntityIdPickCallback = std::function<void(EntityIdPickResult result, uint32_t spawnId)>;
+    void requestEntityIdPick(glm::vec2 viewportPos, EntityIdPickCallback callback);
+    bool hasEntityIdPick() const { return static_cast<bool>(pendingIdPick.callback); }
+    glm::vec2 getEntityIdPickPosition() const { return pendingIdPick.viewportPos; }
+    
+    // EntityGraphicsNode side: copy pixel of pickImage (TRANSFER_SRC_OPTIMAL) for the queued pick; the caller
+    // makes the copy available to the host afterwards when this returns true. deferEntityIdPick keeps the pick
+    // for a later frame until it has waited too long; failEntityIdPick reports it Unavailable
+    bool recordEntityIdPickReadback(VkCommandBuffer commandBuffer, VkImage pickImage, VkOffset2D pixel);
+    void deferEntityIdPick();
+    void failEntityIdPick();
+    
+    // Non-blocking read of the GPU expiry counter (EntityIndirectCommands::expiredEntityCount). callback gets
+    // nullptr when the request was cancelled
+    bool requestExpiredEntityCount(std::function<void(const uint32_t* count)> callback);
+    
+    // Copies EntityIndirectCommands::bounds into the ReadbackRing right after the reduction that wrote it; the
+    // caller makes the reduction visible to transfer reads before and the copy to the host after. The result
+    // replaces getEntityBounds() once the frame's fences have signalled, stamped with tick, the last simulation tick
+    // the reduction ran after
+    bool recordEntityBoundsReadback(VkCommandBuffer commandBuffer, uint32_t tick);
+    
+    // Latest read-back bounds; safe from any thread
+    EntityBounds getEntityBounds() const;
+    
+    // Copies EntityIndirectCommands::simulation into the ReadbackRing after the frame's physics, with the same
+    // barriers around it as the bounds readback. Totals are differenced against the previous readback, the first
+    // one after initialize() only seeds them
+    bool recordSimulationCountersReadback(VkCommandBuffer commandBuffer);
+    SimulationCounters getSimulationCounters() const;
     
-    // GPU-synchronized readback (waits for compute shader completion)
-    bool readbackEntityAtPositionSafe(glm::vec2 worldPos, EntityDebugInfo& info) const;
+    // Batched GPU spatial queries: SpatialQueryNode takes up to SPATIAL_QUERY_MAX_BATCH queued queries on the next
+    // frame that builds the spatial grid, answers them in one dispatch and reads the results back through the
+    // ReadbackRing, so callback runs exactly once on the render thread a few frames later. Render thread, or a
+    // frontendCall
+    void submitSpatialQuery(const SpatialQuery& query, SpatialQueryCallback callback);
+    bool hasPendingSpatialQueries() const { return !pendingSpatialQueries.empty(); }
+    SpatialQueryBatch takeSpatialQueryBatch();
+    
+    // SpatialQueryNode side: copies the batch's results out of the reorder scratch buffer once the dispatch that
+    // wrote them is visible to transfer reads; the caller makes the copy available to the host after. A batch
+    // that cannot be read back is answered unavailable. answerSpatialQueries gives every query of a batch an
+    // empty result (available for an empty world, unavailable when it cannot run); failSpatialQueries does the
+    // latter for everything still queued
+    bool recordSpatialQueryReadback(VkCommandBuffer commandBuffer, SpatialQueryBatch batch);
+    static void answerSpatialQueries(const SpatialQueryBatch& batch, bool available);
+    void failSpatialQueries();
+    
+    // CPU position mirror for spatial queries off the GPU (disabled until given a refresh interval). Called once
+    // per frame before recording: starts a sweep when one is due and queues its next chunks of the live range
+    void refreshPositionMirror(uint32_t frame, uint32_t liveCount);
+    EntityPositionMirror& getPositionMirror() { return positionMirror; }
+    const EntityPositionMirror& getPositionMirror() const { return positionMirror; }
+    
+    // Telemetry capture of the EntityTelemetryCapture stream bits every interval frames, read back through the
+    // streaming ReadbackRing (created on the first start) and written by the capture's own thread. Called once
+    // per frame before recording, like refreshPositionMirror: queues a due capture's chunks of the live range
+    bool startTelemetryCapture(const std::string& path, uint32_t streams, uint32_t interval);
+    void stopTelemetryCapture() { telemetryCapture.close(); }
+    void refreshTelemetryCapture(uint32_t frame, uint32_t liveCount);
+    const EntityTelemetryCapture& getTelemetryCapture() const { return telemetryCapture; }
+    
+    // Streaming server for remote viewers (see EntityStreamServer): positions and spawn IDs of the live range every
+    // interval frames through the same streaming ReadbackRing, quantized to the current grid's cell size
+    bool startEntityStream(uint16_t port, uint32_t interval, uint32_t budgetBytes);
+    void stopEntityStream() { entityStream.close(); }
+    void refreshEntityStream(uint32_t frame, uint32_t liveCount);
+    const EntityStreamServer& getEntityStream() const { return entityStream; }
+    
+    // Zero-copy export of the published position snapshots (see EntityPositionExport): set the manifest path
+    // before initialize(), which allocates the exportable ring and writes the manifest when the device can
+    void setPositionExportPath(const std::string& manifestPath) { positionExportPath = manifestPath; }
+    
+    // Entity compute bindings the kernels access (PipelineSystemManager::reflectEntityComputeBindings), set before
+    // initialize(); optional streams outside the mask allocate no buffer
+    void setAccessedComputeBindings(uint32_t bindingMask) { accessedComputeBindings = bindingMask; }
+    EntityPositionExport& getPositionExport() { return positionExport; }
+    const EntityPositionExport& getPositionExport() const { return positionExport; }
 
 private:
     // Configuration
     uint32_t maxEntities = 0;
+    bool compactLayout = false;
+    uint32_t accessedComputeBindings = ~0u;
     const VulkanContext* context = nullptr;
+    SpatialGridConfig spatialGrid;
+    uint32_t spatialGridCapacity = 0;
     
-    // Helper method for GPU readback
-    bool readGPUBuffer(VkBuffer srcBuffer, void* dstData, VkDeviceSize size, VkDeviceSize offset) const;
+    // Incremented whenever growCapacity grows the buffers, replacing the handles unless lastGrowthInPlace
+    uint64_t generation = 0;
+    bool lastGrowthInPlace = false;
+    
+    uint64_t uploadedBytes = 0;
+    
+    // Stages of requestEntityAtPosition, sharing one search through the readback callbacks
+    struct EntityPickSearch;
+    void readPickCandidates(const std::shared_ptr<EntityPickSearch>& search);
+    void readPickCandidateData(const std::shared_ptr<EntityPickSearch>& search);
+    void finishPick(const std::shared_ptr<EntityPickSearch>& search);
     
-    // Initialize spatial map with NULL values
+    // Second stage of requestEntityState, once the slot is known
+    struct EntityStateRead;
+    void readEntityStateSlot(const std::shared_ptr<EntityStateRead>& read, uint32_t slot);
+    void finishEntityStateRead(const std::shared_ptr<EntityStateRead>& read);
+    
+    // Initialize spatial map with empty cell ranges
     bool initializeSpatialMapBuffer();
     
+    // Grow the persistent async staging buffer to hold at least size bytes
+    bool ensureAsyncStagingCapacity(VkDeviceSize size);
+    
     // Specialized buffer components (SRP-compliant)
     VelocityBuffer velocityBuffer;
     MovementParamsBuffer movementParamsBuffer;
@@ -96,6 +444,19 @@ private:
     ColorBuffer colorBuffer;
     ModelMatrixBuffer modelMatrixBuffer;
     SpatialMapBuffer spatialMapBuffer;
+    SpatialEntryBuffer spatialEntryBuffer;
+    SpatialIndexBuffer spatialIndexBuffer;
+    EntityIdBuffer entityIdBuffer;
+    EntityTypeBuffer entityTypeBuffer;
+    SpawnSlotBuffer spawnSlotBuffer;
+    ReorderScratchBuffer reorderScratchBuffer;
+    EntityIndirectCommandBuffer indirectCommandBuffer;
+    VisibleIndexBuffer visibleIndexBuffer;
+    VisibleDrawCommandBuffer visibleDrawCommandBuffer;
+    
+    // Pipelined async compute snapshots of the culling output (only allocated with ENABLE_PIPELINED_ASYNC_COMPUTE)
+    std::array<VisibleIndexBuffer, PUBLISHED_SNAPSHOT_COUNT> publishedVisibleIndexBuffers;
+    std::array<VisibleDrawCommandBuffer, PUBLISHED_SNAPSHOT_COUNT> publishedDrawCommandBuffers;
     
     // Position buffer coordination
     PositionBufferCoordinator positionCoordinator;
@@ -103,5 +464,33 @@ private:
     // Shared upload service
     BufferUploadService uploadService;
     
+    // Async upload state - the staging buffer is only rewritten once the previous transfer has completed
+    ResourceHandle asyncStagingBuffer;
+    CommandExecutor::AsyncTransfer asyncUpload;
+    
+    EntityPositionMirror positionMirror;
+    EntityTelemetryCapture telemetryCapture;
+    EntityStreamServer entityStream;
+    EntityPositionExport positionExport;
+    std::string positionExportPath;
+    
+    // Queued GPU ID pick, taken by the next entity pass that can draw the pick attachment
+    struct PendingEntityIdPick {
+        glm::vec2 viewportPos{0.0f};
+        EntityIdPickCallback callback;
+        uint32_t deferredFrames = 0;
+    } pendingIdPick;
+    
+    struct PendingSpatialQuery {
+        SpatialQueryRecord record;
+        SpatialQueryCallback callback;
+    };
+    std::vector<PendingSpatialQuery> pendingSpatialQueries;
+    
+    // Written by readback callbacks on the render thread, read by camera and LOD consumers on the main thread
+    mutable std::mutex boundsMutex;
+    EntityBounds latestBounds;
+    SimulationCounters latestSimulationCounters;  // Also under boundsMutex
+    EntitySimulationCounters lastSimulationTotals{};
 };
 
@@ -22,20 +22,51 @@ namespace EntityDescriptorBindings {
             CURRENT_POSITION_BUFFER = 4,
             COLOR_BUFFER = 5,
             MODEL_MATRIX_BUFFER = 6,
-            SPATIAL_MAP_BUFFER = 7
+            SPATIAL_MAP_BUFFER = 7,
+            SPATIAL_ENTRY_BUFFER = 8,
+            SPATIAL_INDEX_BUFFER = 9,
+            ENTITY_ID_BUFFER = 10,
+            REORDER_SCRATCH_BUFFER = 11,
+            INDIRECT_COMMAND_BUFFER = 12,
+            VISIBLE_INDEX_BUFFER = 13,
+            VISIBLE_DRAW_COMMAND_BUFFER = 14,
+            PREVIOUS_POSITION_BUFFER = 15,
+            ENTITY_TYPE_BUFFER = 16,
+            SPAWN_SLOT_BUFFER = 17
         };
         
-        constexpr uint32_t BINDING_COUNT = 8;
+        constexpr uint32_t BINDING_COUNT = 18;
     }
 
     // Graphics descriptor set bindings (rendering pipeline)
     namespace Graphics {
         enum Binding : uint32_t {
-            UNIFORM_BUFFER = 0,      // Camera matrices
+            UNIFORM_BUFFER = 0,      // Camera matrices (dynamic offset into the frame ring allocator)
             POSITION_BUFFER = 1,     // Entity positions
-            MOVEMENT_PARAMS_BUFFER = 2  // Movement params for color
+            MOVEMENT_PARAMS_BUFFER = 2, // Movement params for color
+            VISIBLE_INDEX_BUFFER = 3,   // Culled instance -> entity index
+            COLOR_BUFFER = 4,           // Packed static colour parameters
+            PREVIOUS_POSITION_BUFFER = 5, // Positions at the start of the latest simulation tick
+            ENTITY_ID_BUFFER = 6          // Slot -> spawn ID, read by the entity pick variant only
         };
         
-        constexpr uint32_t BINDING_COUNT = 3;
+        constexpr uint32_t BINDING_COUNT = 7;
+        
+        // Bound range of the frame UBO: view + projection matrices, then time and delta time padded to a vec4
+        constexpr uint32_t UNIFORM_BUFFER_RANGE = 2 * 16 * sizeof(float) + 4 * sizeof(float);
+    }
+    
+    // Bindless table (ENABLE_BINDLESS_ENTITY_DESCRIPTORS): one storage buffer array replaces both sets above.
+    // A view is VIEW_STRIDE consecutive entries ordered like the compute bindings; shaders read entry
+    // entityTable + compute binding, with the base pushed per dispatch or draw. The stream address table
+    // (ENABLE_ENTITY_BUFFER_DEVICE_ADDRESS) lays out one device address per entry the same way
+    namespace Bindless {
+        constexpr uint32_t TABLE_SET = 0;
+        constexpr uint32_t TABLE_BINDING = 0;
+        constexpr uint32_t UNIFORM_SET = 1;     // Graphics camera UBO: dynamic buffers cannot be update-after-bind
+        constexpr uint32_t VIEW_STRIDE = Compute::BINDING_COUNT;
+        constexpr uint32_t WORKING_VIEW = 0;    // Published snapshot slot s is view 1 + s
+        
+        constexpr uint32_t getViewBase(uint32_t view) { return view * VIEW_STRIDE; }
     }
 }
\ No newline at end of file
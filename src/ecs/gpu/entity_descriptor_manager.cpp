@@ -4,10 +4,13 @@
 #include "../../vulkan/core/vulkan_context.h"
 #include "../../vulkan/core/vulkan_function_loader.h"
 #include "../../vulkan/resources/core/resource_coordinator.h"
+#include "../../vulkan/resources/core/frame_ring_allocator.h"
 #include "../../vulkan/resources/descriptors/descriptor_update_helper.h"
 #include "../../vulkan/resources/managers/descriptor_pool_manager.h"
+#include "../../vulkan/pipelines/descriptor_layout_manager.h"
 #include <iostream>
 #include <array>
+#include <algorithm>
 
 EntityDescriptorManager::EntityDescriptorManager() {
 }
@@ -35,14 +38,23 @@ void EntityDescriptorManager::cleanupSpecialized() {
     // Cleanup entity-specific resources
     computeDescriptorPool.reset();
     graphicsDescriptorPool.reset();
+    bindlessTablePool.reset();
+    bindlessUniformPool.reset();
+    streamAddressTable.cleanup();
     
     cleanupDescriptorSetLayouts();
     
     bufferManager = nullptr;
     resourceCoordinator = nullptr;
+    layoutManager = nullptr;
     
+    computeSetLayout = VK_NULL_HANDLE;
+    graphicsSetLayout = VK_NULL_HANDLE;
     computeDescriptorSet = VK_NULL_HANDLE;
     graphicsDescriptorSet = VK_NULL_HANDLE;
+    publishedGraphicsDescriptorSets.fill(VK_NULL_HANDLE);
+    bindlessTableSet = VK_NULL_HANDLE;
+    bindlessUniformSet = VK_NULL_HANDLE;
 }
 
 
@@ -61,6 +73,16 @@ void EntityDescriptorManager::cleanupDescriptorSetLayouts() {
         loader.vkDestroyDescriptorSetLayout(device, graphicsDescriptorSetLayout, nullptr);
         graphicsDescriptorSetLayout = VK_NULL_HANDLE;
     }
+    
+    if (bindlessTableLayout != VK_NULL_HANDLE) {
+        loader.vkDestroyDescriptorSetLayout(device, bindlessTableLayout, nullptr);
+        bindlessTableLayout = VK_NULL_HANDLE;
+    }
+    
+    if (bindlessUniformLayout != VK_NULL_HANDLE) {
+        loader.vkDestroyDescriptorSetLayout(device, bindlessUniformLayout, nullptr);
+        bindlessUniformLayout = VK_NULL_HANDLE;
+    }
 }
 
 bool EntityDescriptorManager::createDescriptorSetLayouts() {
@@ -122,6 +144,66 @@ bool EntityDescriptorManager::createDescriptorSetLayouts() {
     computeBindings[EntityDescriptorBindings::Compute::SPATIAL_MAP_BUFFER].descriptorCount = 1;
     computeBindings[EntityDescriptorBindings::Compute::SPATIAL_MAP_BUFFER].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
 
+    // Binding 8: Spatial entry buffer (per-entity cell and slot, written by grid count pass)
+    computeBindings[EntityDescriptorBindings::Compute::SPATIAL_ENTRY_BUFFER].binding = EntityDescriptorBindings::Compute::SPATIAL_ENTRY_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::SPATIAL_ENTRY_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::SPATIAL_ENTRY_BUFFER].descriptorCount = 1;
+    computeBindings[EntityDescriptorBindings::Compute::SPATIAL_ENTRY_BUFFER].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    // Binding 9: Spatial index buffer (entity indices sorted by cell, written by grid scatter pass)
+    computeBindings[EntityDescriptorBindings::Compute::SPATIAL_INDEX_BUFFER].binding = EntityDescriptorBindings::Compute::SPATIAL_INDEX_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::SPATIAL_INDEX_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::SPATIAL_INDEX_BUFFER].descriptorCount = 1;
+    computeBindings[EntityDescriptorBindings::Compute::SPATIAL_INDEX_BUFFER].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    // Binding 10: Entity ID buffer (stable spawn ID per GPU slot, permuted by reorder pass)
+    computeBindings[EntityDescriptorBindings::Compute::ENTITY_ID_BUFFER].binding = EntityDescriptorBindings::Compute::ENTITY_ID_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::ENTITY_ID_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::ENTITY_ID_BUFFER].descriptorCount = 1;
+    computeBindings[EntityDescriptorBindings::Compute::ENTITY_ID_BUFFER].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    // Binding 11: Reorder scratch buffer (gathered entity streams, reorder pass only)
+    computeBindings[EntityDescriptorBindings::Compute::REORDER_SCRATCH_BUFFER].binding = EntityDescriptorBindings::Compute::REORDER_SCRATCH_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::REORDER_SCRATCH_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::REORDER_SCRATCH_BUFFER].descriptorCount = 1;
+    computeBindings[EntityDescriptorBindings::Compute::REORDER_SCRATCH_BUFFER].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    // Binding 12: Indirect command buffer (GPU-resident live entity count)
+    computeBindings[EntityDescriptorBindings::Compute::INDIRECT_COMMAND_BUFFER].binding = EntityDescriptorBindings::Compute::INDIRECT_COMMAND_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::INDIRECT_COMMAND_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::INDIRECT_COMMAND_BUFFER].descriptorCount = 1;
+    computeBindings[EntityDescriptorBindings::Compute::INDIRECT_COMMAND_BUFFER].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    // Binding 13: Visible index buffer (compacted by the culling pass)
+    computeBindings[EntityDescriptorBindings::Compute::VISIBLE_INDEX_BUFFER].binding = EntityDescriptorBindings::Compute::VISIBLE_INDEX_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::VISIBLE_INDEX_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::VISIBLE_INDEX_BUFFER].descriptorCount = 1;
+    computeBindings[EntityDescriptorBindings::Compute::VISIBLE_INDEX_BUFFER].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    // Binding 14: Visible draw command buffer (instanceCount accumulated by the culling pass)
+    computeBindings[EntityDescriptorBindings::Compute::VISIBLE_DRAW_COMMAND_BUFFER].binding = EntityDescriptorBindings::Compute::VISIBLE_DRAW_COMMAND_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::VISIBLE_DRAW_COMMAND_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::VISIBLE_DRAW_COMMAND_BUFFER].descriptorCount = 1;
+    computeBindings[EntityDescriptorBindings::Compute::VISIBLE_DRAW_COMMAND_BUFFER].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    // Binding 15: Previous position buffer (written by physics at the start of every tick, render interpolation source)
+    computeBindings[EntityDescriptorBindings::Compute::PREVIOUS_POSITION_BUFFER].binding = EntityDescriptorBindings::Compute::PREVIOUS_POSITION_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::PREVIOUS_POSITION_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::PREVIOUS_POSITION_BUFFER].descriptorCount = 1;
+    computeBindings[EntityDescriptorBindings::Compute::PREVIOUS_POSITION_BUFFER].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    // Binding 16: Entity type buffer (shape read by the culling and binning passes)
+    computeBindings[EntityDescriptorBindings::Compute::ENTITY_TYPE_BUFFER].binding = EntityDescriptorBindings::Compute::ENTITY_TYPE_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::ENTITY_TYPE_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::ENTITY_TYPE_BUFFER].descriptorCount = 1;
+    computeBindings[EntityDescriptorBindings::Compute::ENTITY_TYPE_BUFFER].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    // Binding 17: Spawn slot buffer (GPU slot per spawn ID, kept by the passes that move entities)
+    computeBindings[EntityDescriptorBindings::Compute::SPAWN_SLOT_BUFFER].binding = EntityDescriptorBindings::Compute::SPAWN_SLOT_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::SPAWN_SLOT_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    computeBindings[EntityDescriptorBindings::Compute::SPAWN_SLOT_BUFFER].descriptorCount = 1;
+    computeBindings[EntityDescriptorBindings::Compute::SPAWN_SLOT_BUFFER].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+
     VkDescriptorSetLayoutCreateInfo computeLayoutInfo{};
     computeLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     computeLayoutInfo.bindingCount = EntityDescriptorBindings::Compute::BINDING_COUNT;
@@ -137,7 +219,7 @@ bool EntityDescriptorManager::createDescriptorSetLayouts() {
     
     // Binding 0: Uniform buffer (camera matrices) 
     graphicsBindings[EntityDescriptorBindings::Graphics::UNIFORM_BUFFER].binding = EntityDescriptorBindings::Graphics::UNIFORM_BUFFER;
-    graphicsBindings[EntityDescriptorBindings::Graphics::UNIFORM_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+    graphicsBindings[EntityDescriptorBindings::Graphics::UNIFORM_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
     graphicsBindings[EntityDescriptorBindings::Graphics::UNIFORM_BUFFER].descriptorCount = 1;
     graphicsBindings[EntityDescriptorBindings::Graphics::UNIFORM_BUFFER].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
@@ -153,6 +235,30 @@ bool EntityDescriptorManager::createDescriptorSetLayouts() {
     graphicsBindings[EntityDescriptorBindings::Graphics::MOVEMENT_PARAMS_BUFFER].descriptorCount = 1;
     graphicsBindings[EntityDescriptorBindings::Graphics::MOVEMENT_PARAMS_BUFFER].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
 
+    // Binding 3: Visible index buffer (instance index -> entity index after GPU culling)
+    graphicsBindings[EntityDescriptorBindings::Graphics::VISIBLE_INDEX_BUFFER].binding = EntityDescriptorBindings::Graphics::VISIBLE_INDEX_BUFFER;
+    graphicsBindings[EntityDescriptorBindings::Graphics::VISIBLE_INDEX_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    graphicsBindings[EntityDescriptorBindings::Graphics::VISIBLE_INDEX_BUFFER].descriptorCount = 1;
+    graphicsBindings[EntityDescriptorBindings::Graphics::VISIBLE_INDEX_BUFFER].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    // Binding 4: Color buffer (packed static colour parameters)
+    graphicsBindings[EntityDescriptorBindings::Graphics::COLOR_BUFFER].binding = EntityDescriptorBindings::Graphics::COLOR_BUFFER;
+    graphicsBindings[EntityDescriptorBindings::Graphics::COLOR_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    graphicsBindings[EntityDescriptorBindings::Graphics::COLOR_BUFFER].descriptorCount = 1;
+    graphicsBindings[EntityDescriptorBindings::Graphics::COLOR_BUFFER].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    // Binding 5: Previous tick positions (interpolation source)
+    graphicsBindings[EntityDescriptorBindings::Graphics::PREVIOUS_POSITION_BUFFER].binding = EntityDescriptorBindings::Graphics::PREVIOUS_POSITION_BUFFER;
+    graphicsBindings[EntityDescriptorBindings::Graphics::PREVIOUS_POSITION_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    graphicsBindings[EntityDescriptorBindings::Graphics::PREVIOUS_POSITION_BUFFER].descriptorCount = 1;
+    graphicsBindings[EntityDescriptorBindings::Graphics::PREVIOUS_POSITION_BUFFER].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
+    // Binding 6: Entity ID buffer (spawn IDs written to the pick attachment)
+    graphicsBindings[EntityDescriptorBindings::Graphics::ENTITY_ID_BUFFER].binding = EntityDescriptorBindings::Graphics::ENTITY_ID_BUFFER;
+    graphicsBindings[EntityDescriptorBindings::Graphics::ENTITY_ID_BUFFER].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    graphicsBindings[EntityDescriptorBindings::Graphics::ENTITY_ID_BUFFER].descriptorCount = 1;
+    graphicsBindings[EntityDescriptorBindings::Graphics::ENTITY_ID_BUFFER].stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+
     VkDescriptorSetLayoutCreateInfo graphicsLayoutInfo{};
     graphicsLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     graphicsLayoutInfo.bindingCount = EntityDescriptorBindings::Graphics::BINDING_COUNT;
@@ -163,10 +269,171 @@ bool EntityDescriptorManager::createDescriptorSetLayouts() {
         return false;
     }
 
+    // Optional: without buffer device addresses or descriptor indexing (or on failure) the sets above stay in use
+    if (ENABLE_ENTITY_BUFFER_DEVICE_ADDRESS && getContext()->supportsBufferDeviceAddress() && !createStreamAddressTable()) {
+        std::cerr << "EntityDescriptorManager: Stream address table unavailable, binding entity buffers through descriptors" << std::endl;
+    }
+    if (!usesStreamAddresses() && ENABLE_BINDLESS_ENTITY_DESCRIPTORS && getContext()->supportsBindlessDescriptors() &&
+        !createBindlessTable()) {
+        std::cerr << "EntityDescriptorManager: Bindless table unavailable, using per-pipeline descriptor sets" << std::endl;
+    }
+
     std::cout << "EntityDescriptorManager: Descriptor set layouts created successfully" << std::endl;
     return true;
 }
 
+bool EntityDescriptorManager::createBindlessTable() {
+    const auto& loader = getContext()->getLoader();
+    VkDevice device = getContext()->getDevice();
+    
+    // Working view plus one per published snapshot slot
+    const uint32_t requiredEntries = EntityDescriptorBindings::Bindless::getViewBase(1 + PUBLISHED_SNAPSHOT_COUNT);
+    const uint32_t tableSize = std::min(MAX_BINDLESS_BUFFERS, getContext()->getMaxBindlessStorageBuffers());
+    if (tableSize < requiredEntries) {
+        std::cerr << "EntityDescriptorManager: Device allows " << tableSize << " update-after-bind storage buffers, table needs "
+                  << requiredEntries << std::endl;
+        return false;
+    }
+    
+    VkDescriptorSetLayoutBinding tableBinding{};
+    tableBinding.binding = EntityDescriptorBindings::Bindless::TABLE_BINDING;
+    tableBinding.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    tableBinding.descriptorCount = tableSize;
+    tableBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT | VK_SHADER_STAGE_VERTEX_BIT;
+    
+    // Entries no shader reads (unused views, the model matrix stream under the compact layout) stay unwritten,
+    // and entries outside in-flight views may be rewritten while those frames execute
+    VkDescriptorBindingFlagsEXT tableFlags = VK_DESCRIPTOR_BINDING_UPDATE_AFTER_BIND_BIT_EXT |
+                                             VK_DESCRIPTOR_BINDING_PARTIALLY_BOUND_BIT_EXT |
+                                             VK_DESCRIPTOR_BINDING_UPDATE_UNUSED_WHILE_PENDING_BIT_EXT;
+    VkDescriptorSetLayoutBindingFlagsCreateInfoEXT bindingFlags{};
+    bindingFlags.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_BINDING_FLAGS_CREATE_INFO_EXT;
+    bindingFlags.bindingCount = 1;
+    bindingFlags.pBindingFlags = &tableFlags;
+    
+    VkDescriptorSetLayoutCreateInfo tableLayoutInfo{};
+    tableLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    tableLayoutInfo.pNext = &bindingFlags;
+    tableLayoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_UPDATE_AFTER_BIND_POOL_BIT_EXT;
+    tableLayoutInfo.bindingCount = 1;
+    tableLayoutInfo.pBindings = &tableBinding;
+    
+    if (loader.vkCreateDescriptorSetLayout(device, &tableLayoutInfo, nullptr, &bindlessTableLayout) != VK_SUCCESS) {
+        std::cerr << "EntityDescriptorManager: Failed to create bindless table layout" << std::endl;
+        return false;
+    }
+    
+    DescriptorPoolManager::DescriptorPoolConfig tableConfig;
+    tableConfig.maxSets = 1;
+    tableConfig.uniformBuffers = 0;
+    tableConfig.storageBuffers = tableSize;
+    tableConfig.sampledImages = 0;
+    tableConfig.storageImages = 0;
+    tableConfig.samplers = 0;
+    tableConfig.allowFreeDescriptorSets = false;
+    tableConfig.bindlessReady = true;
+    bindlessTablePool = getPoolManager().createDescriptorPool(tableConfig);
+    if (!bindlessTablePool) {
+        std::cerr << "EntityDescriptorManager: Failed to create bindless table pool" << std::endl;
+        return false;
+    }
+    
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = bindlessTablePool.get();
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &bindlessTableLayout;
+    
+    VkDescriptorSet tableSet = VK_NULL_HANDLE;
+    if (loader.vkAllocateDescriptorSets(device, &allocInfo, &tableSet) != VK_SUCCESS) {
+        std::cerr << "EntityDescriptorManager: Failed to allocate bindless table set" << std::endl;
+        return false;
+    }
+    
+    if (!createBindlessUniformSet()) {
+        return false;
+    }
+    
+    // Set last: isBindless() keys off it
+    bindlessTableSet = tableSet;
+    std::cout << "EntityDescriptorManager: Bindless entity table with " << tableSize << " storage buffer entries" << std::endl;
+    return true;
+}
+
+bool EntityDescriptorManager::createBindlessUniformSet() {
+    if (bindlessUniformSet != VK_NULL_HANDLE) {
+        return true;
+    }
+    
+    const auto& loader = getContext()->getLoader();
+    VkDevice device = getContext()->getDevice();
+    
+    // Dynamic uniform buffers cannot live in an update-after-bind layout, so the camera UBO gets its own set
+    VkDescriptorSetLayoutBinding uniformBinding{};
+    uniformBinding.binding = 0;
+    uniformBinding.descriptorType = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
+    uniformBinding.descriptorCount = 1;
+    uniformBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+    
+    VkDescriptorSetLayoutCreateInfo uniformLayoutInfo{};
+    uniformLayoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    uniformLayoutInfo.bindingCount = 1;
+    uniformLayoutInfo.pBindings = &uniformBinding;
+    
+    if (loader.vkCreateDescriptorSetLayout(device, &uniformLayoutInfo, nullptr, &bindlessUniformLayout) != VK_SUCCESS) {
+        std::cerr << "EntityDescriptorManager: Failed to create bindless uniform layout" << std::endl;
+        return false;
+    }
+    
+    DescriptorPoolManager::DescriptorPoolConfig uniformConfig;
+    uniformConfig.maxSets = 1;
+    uniformConfig.uniformBuffers = 0;
+    uniformConfig.dynamicUniformBuffers = 1;
+    uniformConfig.storageBuffers = 0;
+    uniformConfig.sampledImages = 0;
+    uniformConfig.storageImages = 0;
+    uniformConfig.samplers = 0;
+    uniformConfig.allowFreeDescriptorSets = false;
+    bindlessUniformPool = getPoolManager().createDescriptorPool(uniformConfig);
+    if (!bindlessUniformPool) {
+        std::cerr << "EntityDescriptorManager: Failed to create bindless uniform pool" << std::endl;
+        return false;
+    }
+    
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = bindlessUniformPool.get();
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &bindlessUniformLayout;
+    if (loader.vkAllocateDescriptorSets(device, &allocInfo, &bindlessUniformSet) != VK_SUCCESS) {
+        std::cerr << "EntityDescriptorManager: Failed to allocate bindless uniform set" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+bool EntityDescriptorManager::createStreamAddressTable() {
+    if (!resourceCoordinator) {
+        std::cerr << "EntityDescriptorManager: Stream address table needs a ResourceCoordinator for uploads" << std::endl;
+        return false;
+    }
+    
+    if (!createBindlessUniformSet()) {
+        return false;
+    }
+    
+    // Working view plus one per published snapshot slot, at the bindless table's view bases
+    const uint32_t entryCount = EntityDescriptorBindings::Bindless::getViewBase(1 + PUBLISHED_SNAPSHOT_COUNT);
+    if (!streamAddressTable.initialize(*getContext(), resourceCoordinator, entryCount) ||
+        streamAddressTable.getDeviceAddress() == 0) {
+        streamAddressTable.cleanup();
+        return false;
+    }
+    
+    std::cout << "EntityDescriptorManager: Entity streams read through a " << entryCount << " entry address table" << std::endl;
+    return true;
+}
+
 bool EntityDescriptorManager::createComputeDescriptorPool() {
     DescriptorPoolManager::DescriptorPoolConfig config;
     config.maxSets = 1;
@@ -181,11 +448,19 @@ bool EntityDescriptorManager::createComputeDescriptorPool() {
     return static_cast<bool>(computeDescriptorPool);
 }
 
+uint32_t EntityDescriptorManager::getGraphicsSetCount() const {
+    // Working-buffer set plus one per published snapshot
+    return (bufferManager && bufferManager->hasPublishedSnapshots()) ? 1 + PUBLISHED_SNAPSHOT_COUNT : 1;
+}
+
 bool EntityDescriptorManager::createGraphicsDescriptorPool() {
+    const uint32_t setCount = getGraphicsSetCount();
+    
     DescriptorPoolManager::DescriptorPoolConfig config;
-    config.maxSets = 1;
-    config.uniformBuffers = 1;  // Camera matrices
-    config.storageBuffers = EntityDescriptorBindings::Graphics::BINDING_COUNT - 1;  // Storage buffers (excluding uniform buffer)
+    config.maxSets = setCount;
+    config.uniformBuffers = 0;
+    config.dynamicUniformBuffers = setCount;  // Camera matrices (frame ring allocator)
+    config.storageBuffers = (EntityDescriptorBindings::Graphics::BINDING_COUNT - 1) * setCount;  // Storage buffers (excluding uniform buffer)
     config.sampledImages = 0;
     config.storageImages = 0;
     config.samplers = 0;
@@ -196,6 +471,13 @@ bool EntityDescriptorManager::createGraphicsDescriptorPool() {
 }
 
 bool EntityDescriptorManager::createComputeDescriptorSets(VkDescriptorSetLayout layout) {
+    if (usesStreamAddresses()) {
+        return updateStreamAddressTable();
+    }
+    if (isBindless()) {
+        return updateBindlessTable();
+    }
+    
     // Create descriptor pool if not already created
     if (!computeDescriptorPool && !createComputeDescriptorPool()) {
         std::cerr << "EntityDescriptorManager: Failed to create compute descriptor pool" << std::endl;
@@ -213,45 +495,74 @@ bool EntityDescriptorManager::createComputeDescriptorSets(VkDescriptorSetLayout
         std::cerr << "EntityDescriptorManager: Failed to allocate compute descriptor sets" << std::endl;
         return false;
     }
+    computeSetLayout = layout;
 
-    if (!updateComputeDescriptorSet()) {
+    DescriptorWriteBatch batch;
+    if (!updateComputeDescriptorSet(batch)) {
         std::cerr << "EntityDescriptorManager: Failed to update compute descriptor set" << std::endl;
         return false;
     }
+    batch.flush(*getContext());
 
     std::cout << "EntityDescriptorManager: Compute descriptor sets created and updated" << std::endl;
     return true;
 }
 
 bool EntityDescriptorManager::createGraphicsDescriptorSets(VkDescriptorSetLayout layout) {
+    if (usesStreamAddresses()) {
+        return updateStreamAddressTable() && updateBindlessUniformSet();
+    }
+    if (isBindless()) {
+        return updateBindlessTable() && updateBindlessUniformSet();
+    }
+    
     // Create graphics descriptor pool
     if (!graphicsDescriptorPool && !createGraphicsDescriptorPool()) {
         std::cerr << "EntityDescriptorManager: Failed to create graphics descriptor pool" << std::endl;
         return false;
     }
 
-    // Allocate descriptor set
-    VkDescriptorSetAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = graphicsDescriptorPool.get();
-    allocInfo.descriptorSetCount = 1;
-    allocInfo.pSetLayouts = &layout;
-
-    if (getContext()->getLoader().vkAllocateDescriptorSets(getContext()->getDevice(), &allocInfo, &graphicsDescriptorSet) != VK_SUCCESS) {
+    if (!allocateGraphicsDescriptorSets(layout)) {
         std::cerr << "EntityDescriptorManager: Failed to allocate graphics descriptor sets" << std::endl;
         return false;
     }
 
-    if (!updateGraphicsDescriptorSet()) {
+    DescriptorWriteBatch batch;
+    if (!updateGraphicsDescriptorSet(batch)) {
         std::cerr << "EntityDescriptorManager: Failed to update graphics descriptor set" << std::endl;
         return false;
     }
+    batch.flush(*getContext());
 
     std::cout << "EntityDescriptorManager: Graphics descriptor sets created and updated" << std::endl;
     return true;
 }
 
-bool EntityDescriptorManager::updateComputeDescriptorSet() {
+bool EntityDescriptorManager::allocateGraphicsDescriptorSets(VkDescriptorSetLayout layout) {
+    const uint32_t setCount = getGraphicsSetCount();
+    std::array<VkDescriptorSetLayout, 1 + PUBLISHED_SNAPSHOT_COUNT> layouts;
+    layouts.fill(layout);
+    std::array<VkDescriptorSet, 1 + PUBLISHED_SNAPSHOT_COUNT> sets{};
+    
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = graphicsDescriptorPool.get();
+    allocInfo.descriptorSetCount = setCount;
+    allocInfo.pSetLayouts = layouts.data();
+
+    if (getContext()->getLoader().vkAllocateDescriptorSets(getContext()->getDevice(), &allocInfo, sets.data()) != VK_SUCCESS) {
+        return false;
+    }
+    
+    graphicsDescriptorSet = sets[0];
+    graphicsSetLayout = layout;
+    for (uint32_t slot = 0; slot < PUBLISHED_SNAPSHOT_COUNT; ++slot) {
+        publishedGraphicsDescriptorSets[slot] = sets[1 + slot];
+    }
+    return true;
+}
+
+bool EntityDescriptorManager::updateComputeDescriptorSet(DescriptorWriteBatch& batch) {
     if (!bufferManager) {
         std::cerr << "EntityDescriptorManager: Buffer manager not available" << std::endl;
         return false;
@@ -265,14 +576,30 @@ bool EntityDescriptorManager::updateComputeDescriptorSet() {
         {EntityDescriptorBindings::Compute::POSITION_BUFFER, bufferManager->getPositionBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
         {EntityDescriptorBindings::Compute::CURRENT_POSITION_BUFFER, bufferManager->getCurrentPositionBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
         {EntityDescriptorBindings::Compute::COLOR_BUFFER, bufferManager->getColorBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
-        {EntityDescriptorBindings::Compute::MODEL_MATRIX_BUFFER, bufferManager->getModelMatrixBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
-        {EntityDescriptorBindings::Compute::SPATIAL_MAP_BUFFER, bufferManager->getSpatialMapBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER}
+        {EntityDescriptorBindings::Compute::SPATIAL_MAP_BUFFER, bufferManager->getSpatialMapBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
+        {EntityDescriptorBindings::Compute::SPATIAL_ENTRY_BUFFER, bufferManager->getSpatialEntryBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
+        {EntityDescriptorBindings::Compute::SPATIAL_INDEX_BUFFER, bufferManager->getSpatialIndexBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
+        {EntityDescriptorBindings::Compute::ENTITY_ID_BUFFER, bufferManager->getEntityIdBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
+        {EntityDescriptorBindings::Compute::REORDER_SCRATCH_BUFFER, bufferManager->getReorderScratchBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
+        {EntityDescriptorBindings::Compute::INDIRECT_COMMAND_BUFFER, bufferManager->getIndirectCommandBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
+        {EntityDescriptorBindings::Compute::VISIBLE_INDEX_BUFFER, bufferManager->getVisibleIndexBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
+        {EntityDescriptorBindings::Compute::VISIBLE_DRAW_COMMAND_BUFFER, bufferManager->getVisibleDrawCommandBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
+        {EntityDescriptorBindings::Compute::PREVIOUS_POSITION_BUFFER, bufferManager->getTargetPositionBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
+        {EntityDescriptorBindings::Compute::ENTITY_TYPE_BUFFER, bufferManager->getEntityTypeBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
+        {EntityDescriptorBindings::Compute::SPAWN_SLOT_BUFFER, bufferManager->getSpawnSlotBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER}
     };
+    
+    // No shader statically uses binding 6, so it may stay unwritten when the layout drops the stream
+    if (bufferManager->hasModelMatrixStream()) {
+        bindings.push_back({EntityDescriptorBindings::Compute::MODEL_MATRIX_BUFFER, bufferManager->getModelMatrixBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER});
+    }
 
-    return DescriptorUpdateHelper::updateDescriptorSet(*getContext(), computeDescriptorSet, bindings);
+    // The template writes binding 6 too, so without the stream the batch falls back to plain writes
+    const auto* updateTemplate = layoutManager ? layoutManager->getUpdateTemplate(computeSetLayout) : nullptr;
+    return batch.add(computeDescriptorSet, updateTemplate, bindings);
 }
 
-bool EntityDescriptorManager::updateGraphicsDescriptorSet() {
+bool EntityDescriptorManager::updateGraphicsDescriptorSet(DescriptorWriteBatch& batch) {
     if (!bufferManager) {
         std::cerr << "EntityDescriptorManager: Buffer manager not available" << std::endl;
         return false;
@@ -283,42 +610,206 @@ bool EntityDescriptorManager::updateGraphicsDescriptorSet() {
         return false;
     }
 
-    // Get uniform buffer from ResourceCoordinator
-    const auto& uniformBuffers = resourceCoordinator->getUniformBuffers();
-    if (uniformBuffers.empty()) {
-        std::cerr << "EntityDescriptorManager: No uniform buffers available from ResourceCoordinator" << std::endl;
+    // Camera UBO lives in the frame ring; EntityGraphicsNode supplies the per-frame dynamic offset
+    const FrameRingAllocator* frameRing = resourceCoordinator->getFrameRingAllocator();
+    if (!frameRing || frameRing->getBuffer() == VK_NULL_HANDLE) {
+        std::cerr << "EntityDescriptorManager: No frame ring allocator available from ResourceCoordinator" << std::endl;
         return false;
     }
 
-    // Use DescriptorUpdateHelper for DRY principle
-    std::vector<DescriptorUpdateHelper::BufferBinding> bindings = {
-        {EntityDescriptorBindings::Graphics::UNIFORM_BUFFER, uniformBuffers[0], VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER},  // Camera matrices
-        {EntityDescriptorBindings::Graphics::POSITION_BUFFER, bufferManager->getPositionBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},  // Entity positions
-        {EntityDescriptorBindings::Graphics::MOVEMENT_PARAMS_BUFFER, bufferManager->getMovementParamsBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER}  // Movement params for color
+    // Every graphics set shares one layout, hence one template
+    const auto* updateTemplate = layoutManager ? layoutManager->getUpdateTemplate(graphicsSetLayout) : nullptr;
+    auto updateSet = [&](VkDescriptorSet set, VkBuffer positions, VkBuffer previousPositions, VkBuffer visibleIndices) {
+        std::vector<DescriptorUpdateHelper::BufferBinding> bindings = {
+            {EntityDescriptorBindings::Graphics::UNIFORM_BUFFER, frameRing->getBuffer(), 0, EntityDescriptorBindings::Graphics::UNIFORM_BUFFER_RANGE, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC},  // Camera matrices
+            {EntityDescriptorBindings::Graphics::POSITION_BUFFER, positions, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},  // Entity positions
+            {EntityDescriptorBindings::Graphics::MOVEMENT_PARAMS_BUFFER, bufferManager->getMovementParamsBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},  // Movement params for color
+            {EntityDescriptorBindings::Graphics::VISIBLE_INDEX_BUFFER, visibleIndices, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},  // Culled instance -> entity index
+            {EntityDescriptorBindings::Graphics::COLOR_BUFFER, bufferManager->getColorBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},  // Packed colour parameters
+            {EntityDescriptorBindings::Graphics::PREVIOUS_POSITION_BUFFER, previousPositions, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},  // Interpolation source
+            {EntityDescriptorBindings::Graphics::ENTITY_ID_BUFFER, bufferManager->getEntityIdBuffer(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER}  // Spawn IDs for picking
+        };
+        return batch.add(set, updateTemplate, bindings);
     };
 
-    return DescriptorUpdateHelper::updateDescriptorSet(*getContext(), graphicsDescriptorSet, bindings);
+    if (!updateSet(graphicsDescriptorSet, bufferManager->getPositionBuffer(), bufferManager->getTargetPositionBuffer(),
+                   bufferManager->getVisibleIndexBuffer())) {
+        return false;
+    }
+    
+    // Snapshot sets only differ in the compute-published streams; a snapshot holds a single tick, so both
+    // position bindings read it and the blend is a no-op
+    for (uint32_t slot = 0; slot < PUBLISHED_SNAPSHOT_COUNT; ++slot) {
+        const VkBuffer publishedPositions = bufferManager->getPublishedPositionBuffer(slot);
+        if (publishedGraphicsDescriptorSets[slot] != VK_NULL_HANDLE &&
+            !updateSet(publishedGraphicsDescriptorSets[slot], publishedPositions, publishedPositions,
+                       bufferManager->getPublishedVisibleIndexBuffer(slot))) {
+            return false;
+        }
+    }
+    return true;
+}
+
+VkDescriptorSet EntityDescriptorManager::getEntityComputeSet() const {
+    if (usesStreamAddresses()) {
+        return VK_NULL_HANDLE;
+    }
+    return isBindless() ? bindlessTableSet : computeDescriptorSet;
+}
+
+uint32_t EntityDescriptorManager::getViewCount() const {
+    return bufferManager && bufferManager->hasPublishedSnapshots() ? 1 + PUBLISHED_SNAPSHOT_COUNT : 1;
+}
+
+uint64_t EntityDescriptorManager::getViewTable(uint32_t view) const {
+    const uint32_t base = EntityDescriptorBindings::Bindless::getViewBase(view);
+    if (usesStreamAddresses()) {
+        return streamAddressTable.getDeviceAddress() + base * sizeof(VkDeviceAddress);
+    }
+    return base;
+}
+
+EntityDescriptorManager::ViewStreams EntityDescriptorManager::getViewStreams(uint32_t view) const {
+    namespace Compute = EntityDescriptorBindings::Compute;
+    ViewStreams streams{};
+    streams[Compute::VELOCITY_BUFFER] = bufferManager->getVelocityBuffer();
+    streams[Compute::MOVEMENT_PARAMS_BUFFER] = bufferManager->getMovementParamsBuffer();
+    streams[Compute::RUNTIME_STATE_BUFFER] = bufferManager->getRuntimeStateBuffer();
+    streams[Compute::POSITION_BUFFER] = bufferManager->getPositionBuffer();
+    streams[Compute::CURRENT_POSITION_BUFFER] = bufferManager->getCurrentPositionBuffer();
+    streams[Compute::COLOR_BUFFER] = bufferManager->getColorBuffer();
+    streams[Compute::MODEL_MATRIX_BUFFER] = bufferManager->hasModelMatrixStream() ? bufferManager->getModelMatrixBuffer() : VK_NULL_HANDLE;
+    streams[Compute::SPATIAL_MAP_BUFFER] = bufferManager->getSpatialMapBuffer();
+    streams[Compute::SPATIAL_ENTRY_BUFFER] = bufferManager->getSpatialEntryBuffer();
+    streams[Compute::SPATIAL_INDEX_BUFFER] = bufferManager->getSpatialIndexBuffer();
+    streams[Compute::ENTITY_ID_BUFFER] = bufferManager->getEntityIdBuffer();
+    streams[Compute::REORDER_SCRATCH_BUFFER] = bufferManager->getReorderScratchBuffer();
+    streams[Compute::INDIRECT_COMMAND_BUFFER] = bufferManager->getIndirectCommandBuffer();
+    streams[Compute::VISIBLE_INDEX_BUFFER] = bufferManager->getVisibleIndexBuffer();
+    streams[Compute::VISIBLE_DRAW_COMMAND_BUFFER] = bufferManager->getVisibleDrawCommandBuffer();
+    streams[Compute::PREVIOUS_POSITION_BUFFER] = bufferManager->getTargetPositionBuffer();
+    streams[Compute::ENTITY_TYPE_BUFFER] = bufferManager->getEntityTypeBuffer();
+    streams[Compute::SPAWN_SLOT_BUFFER] = bufferManager->getSpawnSlotBuffer();
+    
+    // Snapshot views only differ in the compute-published streams (one tick each, so no interpolation source)
+    if (view != EntityDescriptorBindings::Bindless::WORKING_VIEW) {
+        const uint32_t slot = view - 1;
+        streams[Compute::POSITION_BUFFER] = bufferManager->getPublishedPositionBuffer(slot);
+        streams[Compute::PREVIOUS_POSITION_BUFFER] = streams[Compute::POSITION_BUFFER];
+        streams[Compute::VISIBLE_INDEX_BUFFER] = bufferManager->getPublishedVisibleIndexBuffer(slot);
+    }
+    return streams;
+}
+
+bool EntityDescriptorManager::updateBindlessTable() {
+    if (!bufferManager) {
+        std::cerr << "EntityDescriptorManager: Buffer manager not available" << std::endl;
+        return false;
+    }
+    
+    namespace Compute = EntityDescriptorBindings::Compute;
+    const uint32_t viewCount = getViewCount();
+    std::vector<VkDescriptorBufferInfo> bufferInfos;
+    bufferInfos.reserve(viewCount * Compute::BINDING_COUNT);
+    std::vector<VkWriteDescriptorSet> writes;
+    writes.reserve(bufferInfos.capacity());
+    
+    for (uint32_t view = 0; view < viewCount; ++view) {
+        const ViewStreams streams = getViewStreams(view);
+        const uint32_t base = EntityDescriptorBindings::Bindless::getViewBase(view);
+        for (uint32_t binding = 0; binding < Compute::BINDING_COUNT; ++binding) {
+            // Partially bound: a missing stream leaves its entry unwritten
+            if (streams[binding] == VK_NULL_HANDLE) continue;
+            
+            bufferInfos.push_back({streams[binding], 0, VK_WHOLE_SIZE});
+            
+            VkWriteDescriptorSet write{};
+            write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            write.dstSet = bindlessTableSet;
+            write.dstBinding = EntityDescriptorBindings::Bindless::TABLE_BINDING;
+            write.dstArrayElement = base + binding;
+            write.descriptorCount = 1;
+            write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            write.pBufferInfo = &bufferInfos.back();  // Reserved above, so the pointer stays valid
+            writes.push_back(write);
+        }
+    }
+    
+    getContext()->getLoader().vkUpdateDescriptorSets(
+        getContext()->getDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    return true;
+}
+
+bool EntityDescriptorManager::updateStreamAddressTable() {
+    if (!bufferManager) {
+        std::cerr << "EntityDescriptorManager: Buffer manager not available" << std::endl;
+        return false;
+    }
+    
+    const auto& loader = getContext()->getLoader();
+    VkDevice device = getContext()->getDevice();
+    
+    // Absent streams (and views without snapshots) stay 0; no shader dereferences them
+    std::vector<VkDeviceAddress> addresses(streamAddressTable.getMaxElements(), 0);
+    const uint32_t viewCount = getViewCount();
+    for (uint32_t view = 0; view < viewCount; ++view) {
+        const ViewStreams streams = getViewStreams(view);
+        const uint32_t base = EntityDescriptorBindings::Bindless::getViewBase(view);
+        for (uint32_t binding = 0; binding < EntityDescriptorBindings::Compute::BINDING_COUNT; ++binding) {
+            if (streams[binding] == VK_NULL_HANDLE) continue;
+            
+            VkBufferDeviceAddressInfoKHR addressInfo{};
+            addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO_KHR;
+            addressInfo.buffer = streams[binding];
+            addresses[base + binding] = loader.vkGetBufferDeviceAddressKHR(device, &addressInfo);
+        }
+    }
+    
+    // Only rewritten at setup, growth and swapchain recreation, all with the GPU idle
+    return streamAddressTable.copyData(addresses.data(), addresses.size() * sizeof(VkDeviceAddress));
+}
+
+bool EntityDescriptorManager::updateBindlessUniformSet() {
+    const FrameRingAllocator* frameRing = resourceCoordinator ? resourceCoordinator->getFrameRingAllocator() : nullptr;
+    if (!frameRing || frameRing->getBuffer() == VK_NULL_HANDLE) {
+        std::cerr << "EntityDescriptorManager: No frame ring allocator available from ResourceCoordinator" << std::endl;
+        return false;
+    }
+    
+    std::vector<DescriptorUpdateHelper::BufferBinding> bindings = {
+        {0, frameRing->getBuffer(), 0, EntityDescriptorBindings::Graphics::UNIFORM_BUFFER_RANGE, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC}
+    };
+    return DescriptorUpdateHelper::updateDescriptorSet(*getContext(), bindlessUniformSet, bindings);
 }
 
 bool EntityDescriptorManager::recreateDescriptorSets() {
-    // Recreate both compute and graphics descriptor sets
+    // The table outlives buffer swaps: only its entries change, so pipelines and layouts are untouched
+    if (usesStreamAddresses()) {
+        return updateStreamAddressTable() && updateBindlessUniformSet();
+    }
+    if (isBindless()) {
+        return updateBindlessTable() && updateBindlessUniformSet();
+    }
+    
+    // Buffer growth and swapchain recreation run with the device idle, so the existing sets are rewritten in
+    // place and every write goes out in one flush
+    DescriptorWriteBatch batch;
     bool computeSuccess = true;
     bool graphicsSuccess = true;
     
-    // Recreate compute descriptor sets
     if (computeDescriptorSetLayout != VK_NULL_HANDLE) {
-        computeSuccess = recreateComputeDescriptorSets();
+        computeSuccess = recreateComputeDescriptorSets(batch);
     }
     
-    // Recreate graphics descriptor sets
     if (graphicsDescriptorSetLayout != VK_NULL_HANDLE) {
-        graphicsSuccess = recreateGraphicsDescriptorSets();
+        graphicsSuccess = recreateGraphicsDescriptorSets(batch);
     }
     
+    batch.flush(*getContext());
     return computeSuccess && graphicsSuccess;
 }
 
-bool EntityDescriptorManager::recreateComputeDescriptorSets() {
+bool EntityDescriptorManager::recreateComputeDescriptorSets(DescriptorWriteBatch& batch) {
     // Validate that we have the compute descriptor set layout
     if (computeDescriptorSetLayout == VK_NULL_HANDLE) {
         std::cerr << "EntityDescriptorManager: ERROR - Cannot recreate compute descriptor sets: layout not available" << std::endl;
@@ -333,29 +824,27 @@ bool EntityDescriptorManager::recreateComputeDescriptorSets() {
         return false;
     }
     
-    // Reset the descriptor pool to allow reallocation
-    if (computeDescriptorPool) {
-        if (getContext()->getLoader().vkResetDescriptorPool(getContext()->getDevice(), computeDescriptorPool.get(), 0) != VK_SUCCESS) {
-            std::cerr << "EntityDescriptorManager: ERROR - Failed to reset compute descriptor pool" << std::endl;
+    // Only a set that was never allocated needs the pool; an existing one keeps its layout and template
+    if (computeDescriptorSet == VK_NULL_HANDLE) {
+        if (!computeDescriptorPool && !createComputeDescriptorPool()) {
+            std::cerr << "EntityDescriptorManager: ERROR - Failed to create compute descriptor pool" << std::endl;
             return false;
         }
-        std::cout << "EntityDescriptorManager: Reset compute descriptor pool for reallocation" << std::endl;
-        computeDescriptorSet = VK_NULL_HANDLE; // Pool reset invalidates all descriptor sets
-    }
-    
-    // Allocate new descriptor set (reusing same layout and pool)
-    VkDescriptorSetAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = computeDescriptorPool.get();
-    allocInfo.descriptorSetCount = 1;
-    allocInfo.pSetLayouts = &computeDescriptorSetLayout;
-
-    if (getContext()->getLoader().vkAllocateDescriptorSets(getContext()->getDevice(), &allocInfo, &computeDescriptorSet) != VK_SUCCESS) {
-        std::cerr << "EntityDescriptorManager: ERROR - Failed to reallocate compute descriptor set" << std::endl;
-        return false;
+        
+        VkDescriptorSetAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+        allocInfo.descriptorPool = computeDescriptorPool.get();
+        allocInfo.descriptorSetCount = 1;
+        allocInfo.pSetLayouts = &computeDescriptorSetLayout;
+
+        if (getContext()->getLoader().vkAllocateDescriptorSets(getContext()->getDevice(), &allocInfo, &computeDescriptorSet) != VK_SUCCESS) {
+            std::cerr << "EntityDescriptorManager: ERROR - Failed to reallocate compute descriptor set" << std::endl;
+            return false;
+        }
+        computeSetLayout = computeDescriptorSetLayout;
     }
 
-    if (!updateComputeDescriptorSet()) {
+    if (!updateComputeDescriptorSet(batch)) {
         std::cerr << "EntityDescriptorManager: ERROR - Failed to update recreated compute descriptor set" << std::endl;
         return false;
     }
@@ -364,7 +853,7 @@ bool EntityDescriptorManager::recreateComputeDescriptorSets() {
     return true;
 }
 
-bool EntityDescriptorManager::recreateGraphicsDescriptorSets() {
+bool EntityDescriptorManager::recreateGraphicsDescriptorSets(DescriptorWriteBatch& batch) {
     // Similar logic for graphics descriptor sets
     if (graphicsDescriptorSetLayout == VK_NULL_HANDLE) {
         std::cerr << "EntityDescriptorManager: ERROR - Cannot recreate graphics descriptor sets: layout not available" << std::endl;
@@ -376,28 +865,28 @@ bool EntityDescriptorManager::recreateGraphicsDescriptorSets() {
         return false;
     }
     
-    // Reset the descriptor pool
-    if (graphicsDescriptorPool) {
-        if (getContext()->getLoader().vkResetDescriptorPool(getContext()->getDevice(), graphicsDescriptorPool.get(), 0) != VK_SUCCESS) {
-            std::cerr << "EntityDescriptorManager: ERROR - Failed to reset graphics descriptor pool" << std::endl;
+    // Reallocate only when the set count changed (snapshots appeared or went away) or nothing was allocated yet
+    const bool hasSnapshotSets = publishedGraphicsDescriptorSets[0] != VK_NULL_HANDLE;
+    if (graphicsDescriptorSet == VK_NULL_HANDLE || hasSnapshotSets != (getGraphicsSetCount() > 1)) {
+        if (graphicsDescriptorPool) {
+            if (getContext()->getLoader().vkResetDescriptorPool(getContext()->getDevice(), graphicsDescriptorPool.get(), 0) != VK_SUCCESS) {
+                std::cerr << "EntityDescriptorManager: ERROR - Failed to reset graphics descriptor pool" << std::endl;
+                return false;
+            }
+            graphicsDescriptorSet = VK_NULL_HANDLE;
+            publishedGraphicsDescriptorSets.fill(VK_NULL_HANDLE);
+        } else if (!createGraphicsDescriptorPool()) {
+            std::cerr << "EntityDescriptorManager: ERROR - Failed to create graphics descriptor pool" << std::endl;
+            return false;
+        }
+        
+        if (!allocateGraphicsDescriptorSets(graphicsDescriptorSetLayout)) {
+            std::cerr << "EntityDescriptorManager: ERROR - Failed to reallocate graphics descriptor set" << std::endl;
             return false;
         }
-        graphicsDescriptorSet = VK_NULL_HANDLE;
-    }
-    
-    // Allocate new descriptor set
-    VkDescriptorSetAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
-    allocInfo.descriptorPool = graphicsDescriptorPool.get();
-    allocInfo.descriptorSetCount = 1;
-    allocInfo.pSetLayouts = &graphicsDescriptorSetLayout;
-
-    if (getContext()->getLoader().vkAllocateDescriptorSets(getContext()->getDevice(), &allocInfo, &graphicsDescriptorSet) != VK_SUCCESS) {
-        std::cerr << "EntityDescriptorManager: ERROR - Failed to reallocate graphics descriptor set" << std::endl;
-        return false;
     }
 
-    if (!updateGraphicsDescriptorSet()) {
+    if (!updateGraphicsDescriptorSet(batch)) {
         std::cerr << "EntityDescriptorManager: ERROR - Failed to update recreated graphics descriptor set" << std::endl;
         return false;
     }
@@ -3,11 +3,16 @@
 #include "../../vulkan/resources/descriptors/descriptor_set_manager_base.h"
 #include "../../vulkan/core/vulkan_raii.h"
 #include "entity_descriptor_bindings.h"
+#include "specialized_buffers.h"
+#include "../../vulkan/core/vulkan_constants.h"
 #include <vulkan/vulkan.h>
+#include <array>
 
 // Forward declarations
 class EntityBufferManager;
 class ResourceCoordinator;
+class DescriptorLayoutManager;
+class DescriptorWriteBatch;
 
 /**
  * EntityDescriptorManager - Entity-specific descriptor set management (SRP)
@@ -15,7 +20,7 @@ class ResourceCoordinator;
  * Single Responsibility: Manage descriptor sets specifically for entity rendering pipeline
  * - Compute descriptors: Entity SoA buffers (velocity, movement params, runtime state, positions, colors, model matrices)
  * - Graphics descriptors: Entity rendering data (positions, movement params from ResourceCoordinator uniform buffer)
- * - Swapchain recreation support with descriptor set recreation
+ * - Swapchain recreation support: sets are rewritten in place, through the layouts' update templates when available
  * 
  * Uses composition with DescriptorSetManagerBase for shared functionality (DRY)
  * Uses DescriptorUpdateHelper for update operations (DRY)
@@ -27,6 +32,9 @@ public:
 
     // Entity-specific initialization
     bool initializeEntity(EntityBufferManager& bufferManager, ResourceCoordinator* resourceCoordinator = nullptr);
+    
+    // Owner of the layouts passed to create*DescriptorSets, whose update templates then rewrite those sets
+    void setLayoutManager(DescriptorLayoutManager* layoutManager) { this->layoutManager = layoutManager; }
 
     // Descriptor set layout management (entity-specific responsibility)
     bool createDescriptorSetLayouts();
@@ -40,10 +48,37 @@ public:
     // Descriptor set access
     VkDescriptorSet getComputeDescriptorSet() const { return computeDescriptorSet; }
     VkDescriptorSet getGraphicsDescriptorSet() const { return graphicsDescriptorSet; }
+    
+    // Graphics sets reading published snapshot slot (positions and visible indices); VK_NULL_HANDLE
+    // when the buffer manager allocated no snapshots
+    VkDescriptorSet getPublishedGraphicsDescriptorSet(uint32_t slot) const { return publishedGraphicsDescriptorSets[slot % PUBLISHED_SNAPSHOT_COUNT]; }
 
     // State queries (entity-specific)
     bool hasValidComputeDescriptorSet() const { return computeDescriptorSet != VK_NULL_HANDLE; }
     bool hasValidGraphicsDescriptorSet() const { return graphicsDescriptorSet != VK_NULL_HANDLE; }
+    
+    // Bindless mode, active when the device supports descriptor indexing: every entity pipeline binds the table
+    // at set 0 instead of the compute/graphics sets, which are then never allocated. Buffer growth or reorder
+    // rewrites table entries in place, so the set, its layout and the pipeline layouts survive
+    bool isBindless() const { return bindlessTableSet != VK_NULL_HANDLE; }
+    VkDescriptorSetLayout getBindlessTableLayout() const { return bindlessTableLayout; }
+    VkDescriptorSetLayout getBindlessUniformLayout() const { return bindlessUniformLayout; }
+    VkDescriptorSet getBindlessTableSet() const { return bindlessTableSet; }
+    VkDescriptorSet getBindlessUniformSet() const { return bindlessUniformSet; }
+    
+    // Buffer address mode, preferred when the device supports buffer device addresses: entity shaders read
+    // every stream through a device address looked up in a small table buffer, so compute binds no descriptor
+    // set and graphics binds only the camera UBO set (getBindlessUniformSet, at set 0). Growth or reorder
+    // rewrites the table contents; no descriptor is written
+    bool usesStreamAddresses() const { return streamAddressTable.isInitialized(); }
+    
+    // Set 0 of every entity compute dispatch; VK_NULL_HANDLE in buffer address mode, which binds none
+    VkDescriptorSet getEntityComputeSet() const;
+    
+    // entityTable push constants: the working buffers, or what graphics reads for published snapshot slot.
+    // A bindless table view base, or the address of the view's run of stream addresses
+    uint64_t getWorkingTable() const { return getViewTable(EntityDescriptorBindings::Bindless::WORKING_VIEW); }
+    uint64_t getPublishedTable(uint32_t slot) const { return getViewTable(1 + slot % PUBLISHED_SNAPSHOT_COUNT); }
 
     // Override from base class
     bool recreateDescriptorSets() override;
@@ -57,6 +92,7 @@ private:
     // Entity-specific dependencies
     EntityBufferManager* bufferManager = nullptr;
     ResourceCoordinator* resourceCoordinator = nullptr;
+    DescriptorLayoutManager* layoutManager = nullptr;
     
     // Entity-specific descriptor set layouts
     VkDescriptorSetLayout computeDescriptorSetLayout = VK_NULL_HANDLE;
@@ -69,14 +105,44 @@ private:
     // Entity-specific descriptor sets
     VkDescriptorSet computeDescriptorSet = VK_NULL_HANDLE;
     VkDescriptorSet graphicsDescriptorSet = VK_NULL_HANDLE;
+    std::array<VkDescriptorSet, PUBLISHED_SNAPSHOT_COUNT> publishedGraphicsDescriptorSets{};
+    
+    // Layouts the sets above were allocated with, which pick their update templates
+    VkDescriptorSetLayout computeSetLayout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout graphicsSetLayout = VK_NULL_HANDLE;
+    
+    // Bindless table (update-after-bind pool) and the graphics UBO set beside it
+    VkDescriptorSetLayout bindlessTableLayout = VK_NULL_HANDLE;
+    VkDescriptorSetLayout bindlessUniformLayout = VK_NULL_HANDLE;
+    vulkan_raii::DescriptorPool bindlessTablePool;
+    vulkan_raii::DescriptorPool bindlessUniformPool;
+    VkDescriptorSet bindlessTableSet = VK_NULL_HANDLE;
+    VkDescriptorSet bindlessUniformSet = VK_NULL_HANDLE;
+    
+    // Device addresses of every view's streams, laid out like the bindless table entries
+    StreamAddressTableBuffer streamAddressTable;
     
     // Entity-specific helpers (SRP)
     bool createComputeDescriptorPool();
     bool createGraphicsDescriptorPool();
-    bool updateComputeDescriptorSet();
-    bool updateGraphicsDescriptorSet();
-    bool recreateComputeDescriptorSets();
-    bool recreateGraphicsDescriptorSets();
+    bool updateComputeDescriptorSet(DescriptorWriteBatch& batch);
+    bool updateGraphicsDescriptorSet(DescriptorWriteBatch& batch);
+    bool allocateGraphicsDescriptorSets(VkDescriptorSetLayout layout);
+    uint32_t getGraphicsSetCount() const;
+    bool recreateComputeDescriptorSets(DescriptorWriteBatch& batch);
+    bool recreateGraphicsDescriptorSets(DescriptorWriteBatch& batch);
+    bool createBindlessTable();
+    bool createBindlessUniformSet();
+    bool createStreamAddressTable();
+    bool updateBindlessTable();
+    bool updateBindlessUniformSet();
+    bool updateStreamAddressTable();
+    
+    // Streams of view 0 (working buffers) or 1 + published snapshot slot; VK_NULL_HANDLE for absent streams
+    using ViewStreams = std::array<VkBuffer, EntityDescriptorBindings::Compute::BINDING_COUNT>;
+    ViewStreams getViewStreams(uint32_t view) const;
+    uint32_t getViewCount() const;
+    uint64_t getViewTable(uint32_t view) const;
     
     // Entity-specific cleanup
     void cleanupDescriptorSetLayouts();
@@ -0,0 +1,240 @@
+#include "entity_position_export.h"
+#include "position_buffer_coordinator.h"
+#include "../../vulkan/core/vulkan_context.h"
+#include "../../vulkan/core/vulkan_function_loader.h"
+#include <cstdint>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+#if !defined(VK_USE_PLATFORM_WIN32_KHR)
+#include <unistd.h>
+#endif
+
+namespace {
+    // Handles are written as plain integers: a descriptor, or the value of the NT handle
+    uint64_t handleValue(EntityPositionExport::Handle handle) {
+#if defined(VK_USE_PLATFORM_WIN32_KHR)
+        return static_cast<uint64_t>(reinterpret_cast<uintptr_t>(handle));
+#else
+        return static_cast<uint64_t>(handle);
+#endif
+    }
+    
+    uint64_t processId() {
+#if defined(VK_USE_PLATFORM_WIN32_KHR)
+        return GetCurrentProcessId();
+#else
+        return static_cast<uint64_t>(getpid());
+#endif
+    }
+}
+
+EntityPositionExport::EntityPositionExport() {
+    memoryHandles.fill(INVALID_HANDLE);
+}
+
+EntityPositionExport::~EntityPositionExport() {
+    cleanup();
+}
+
+bool EntityPositionExport::initialize(const VulkanContext& context, const std::string& manifestPath) {
+    cleanup();
+    if (!context.supportsExternalPositionExport()) {
+        return false;
+    }
+    this->context = &context;
+    this->manifestPath = manifestPath;
+    
+    const auto& vk = context.getLoader();
+    const VkDevice device = context.getDevice();
+    
+    VkExportSemaphoreCreateInfoKHR exportInfo{};
+    exportInfo.sType = VK_STRUCTURE_TYPE_EXPORT_SEMAPHORE_CREATE_INFO_KHR;
+    exportInfo.handleTypes = EXTERNAL_SEMAPHORE_HANDLE_TYPE;
+    VkSemaphoreTypeCreateInfoKHR typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+    typeInfo.pNext = &exportInfo;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+    typeInfo.initialValue = 0;
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+    if (vk.vkCreateSemaphore(device, &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+        std::cerr << "EntityPositionExport: Failed to create exportable timeline semaphore" << std::endl;
+        semaphore = VK_NULL_HANDLE;
+        return false;
+    }
+    
+    VkResult result = VK_ERROR_EXTENSION_NOT_PRESENT;
+#if defined(VK_USE_PLATFORM_WIN32_KHR)
+    VkSemaphoreGetWin32HandleInfoKHR handleInfo{};
+    handleInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_WIN32_HANDLE_INFO_KHR;
+    handleInfo.semaphore = semaphore;
+    handleInfo.handleType = EXTERNAL_SEMAPHORE_HANDLE_TYPE;
+    if (vk.vkGetSemaphoreWin32HandleKHR) {
+        result = vk.vkGetSemaphoreWin32HandleKHR(device, &handleInfo, &semaphoreHandle);
+    }
+#else
+    VkSemaphoreGetFdInfoKHR handleInfo{};
+    handleInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_GET_FD_INFO_KHR;
+    handleInfo.semaphore = semaphore;
+    handleInfo.handleType = EXTERNAL_SEMAPHORE_HANDLE_TYPE;
+    if (vk.vkGetSemaphoreFdKHR) {
+        result = vk.vkGetSemaphoreFdKHR(device, &handleInfo, &semaphoreHandle);
+    }
+#endif
+    if (result != VK_SUCCESS) {
+        std::cerr << "EntityPositionExport: Failed to export timeline semaphore (VkResult: " << result << ")" << std::endl;
+        semaphoreHandle = INVALID_HANDLE;
+        cleanup();
+        return false;
+    }
+    return true;
+}
+
+void EntityPositionExport::cleanup() {
+    for (Handle& handle : memoryHandles) {
+        closeHandle(handle);
+    }
+    closeHandle(semaphoreHandle);
+    if (context && semaphore != VK_NULL_HANDLE) {
+        context->getLoader().vkDestroySemaphore(context->getDevice(), semaphore, nullptr);
+    }
+    semaphore = VK_NULL_HANDLE;
+    
+    // A consumer must not find handles that no longer name anything
+    if (!manifestPath.empty()) {
+        std::error_code error;
+        std::filesystem::remove(manifestPath, error);
+    }
+    manifestPath.clear();
+    context = nullptr;
+    generation = 0;
+    lastValue = 0;
+    pendingValue = 0;
+}
+
+void EntityPositionExport::closeHandle(Handle& handle) const {
+    if (handle == INVALID_HANDLE) {
+        return;
+    }
+#if defined(VK_USE_PLATFORM_WIN32_KHR)
+    CloseHandle(handle);
+#else
+    close(handle);
+#endif
+    handle = INVALID_HANDLE;
+}
+
+bool EntityPositionExport::publishBuffers(const PositionBufferCoordinator& positions, uint64_t bufferGeneration) {
+    if (!isActive()) {
+        return false;
+    }
+    
+    const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
+    for (uint32_t slot = 0; slot < PUBLISHED_SNAPSHOT_COUNT; ++slot) {
+        // The consumer has duplicated what it imports; handles of the freed allocations are dropped here
+        closeHandle(memoryHandles[slot]);
+        const PositionBuffer& published = positions.getPublishedBuffer(slot);
+        if (!published.isExternallyExported() || published.getMemory() == VK_NULL_HANDLE) {
+            std::cerr << "EntityPositionExport: Snapshot " << slot << " is not exportable memory" << std::endl;
+            return false;
+        }
+        
+        VkResult result = VK_ERROR_EXTENSION_NOT_PRESENT;
+#if defined(VK_USE_PLATFORM_WIN32_KHR)
+        VkMemoryGetWin32HandleInfoKHR handleInfo{};
+        handleInfo.sType = VK_STRUCTURE_TYPE_MEMORY_GET_WIN32_HANDLE_INFO_KHR;
+        handleInfo.memory = published.getMemory();
+        handleInfo.handleType = EXTERNAL_MEMORY_HANDLE_TYPE;
+        if (vk.vkGetMemoryWin32HandleKHR) {
+            result = vk.vkGetMemoryWin32HandleKHR(device, &handleInfo, &memoryHandles[slot]);
+        }
+#else
+        VkMemoryGetFdInfoKHR handleInfo{};
+        handleInfo.sType = VK_STRUCTURE_TYPE_MEMORY_GET_FD_INFO_KHR;
+        handleInfo.memory = published.getMemory();
+        handleInfo.handleType = EXTERNAL_MEMORY_HANDLE_TYPE;
+        if (vk.vkGetMemoryFdKHR) {
+            result = vk.vkGetMemoryFdKHR(device, &handleInfo, &memoryHandles[slot]);
+        }
+#endif
+        if (result != VK_SUCCESS) {
+            std::cerr << "EntityPositionExport: Failed to export snapshot " << slot << " (VkResult: " << result << ")" << std::endl;
+            memoryHandles[slot] = INVALID_HANDLE;
+            return false;
+        }
+    }
+    
+    generation = bufferGeneration;
+    if (!writeManifest(positions)) {
+        return false;
+    }
+    std::cout << "EntityPositionExport: Exported " << PUBLISHED_SNAPSHOT_COUNT << " position snapshots of "
+              << positions.getMaxEntities() << " entities (generation " << generation << ") to " << manifestPath << std::endl;
+    return true;
+}
+
+bool EntityPositionExport::writeManifest(const PositionBufferCoordinator& positions) const {
+    // Written beside the manifest and renamed over it, so a consumer never reads half of one
+    const std::string tempPath = manifestPath + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        if (!file) {
+            std::cerr << "EntityPositionExport: Failed to open " << tempPath << std::endl;
+            return false;
+        }
+        file << "fractalia-position-export 1\n"
+             << "pid " << processId() << "\n"
+             << "device_uuid " << context->getDeviceUuid() << "\n"
+#if defined(VK_USE_PLATFORM_WIN32_KHR)
+             << "handle_type opaque_win32\n"
+#else
+             << "handle_type opaque_fd\n"
+#endif
+             << "generation " << generation << "\n"
+             << "semaphore " << handleValue(semaphoreHandle) << "\n"
+             << "slots " << PUBLISHED_SNAPSHOT_COUNT << "\n"
+             << "capacity " << positions.getMaxEntities() << "\n"
+             << "stride " << sizeof(glm::vec4) << "\n";
+        for (uint32_t slot = 0; slot < PUBLISHED_SNAPSHOT_COUNT; ++slot) {
+            const PositionBuffer& published = positions.getPublishedBuffer(slot);
+            file << "slot " << slot << " " << handleValue(memoryHandles[slot]) << " " << published.getSize()
+                 << " " << published.getAllocationSize() << "\n";
+        }
+        if (!file.flush()) {
+            std::cerr << "EntityPositionExport: Failed to write " << tempPath << std::endl;
+            return false;
+        }
+    }
+    
+    std::error_code error;
+    std::filesystem::rename(tempPath, manifestPath, error);
+    if (error) {
+        std::cerr << "EntityPositionExport: Failed to replace " << manifestPath << ": " << error.message() << std::endl;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+void EntityPositionExport::beginPublish(uint32_t slot) {
+    if (!isActive()) {
+        return;
+    }
+    
+    // Smallest value past the last that names the slot; a frame that never submits leaves a gap, which a
+    // timeline allows
+    uint64_t value = lastValue + 1;
+    value += (slot % PUBLISHED_SNAPSHOT_COUNT + PUBLISHED_SNAPSHOT_COUNT - value % PUBLISHED_SNAPSHOT_COUNT) % PUBLISHED_SNAPSHOT_COUNT;
+    lastValue = value;
+    pendingValue = value;
+}
+
+uint64_t EntityPositionExport::takePendingSignal() {
+    const uint64_t value = pendingValue;
+    pendingValue = 0;
+    return value;
+}
@@ -0,0 +1,73 @@
+#pragma once
+
+#include "../../vulkan/core/vulkan_constants.h"
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+#include <string>
+
+// Forward declarations
+class VulkanContext;
+class PositionBufferCoordinator;
+
+/**
+ * Zero-copy export of the published position snapshots (--export-positions, ENABLE_EXTERNAL_POSITION_EXPORT).
+ * PositionBufferCoordinator allocates its snapshot ring as dedicated exportable memory; this owns the exported
+ * handles of those allocations and an exported timeline semaphore that the compute submit of every publishing
+ * frame signals. Both go into a manifest file for a consumer process on the same device, which takes the
+ * handles over (pidfd_getfd on Linux, DuplicateHandle on Windows), imports memory and semaphore, and reads the
+ * snapshots on its own queues without any copy on either side.
+ *
+ * A signaled value V means slot V % PUBLISHED_SNAPSHOT_COUNT holds a completed frame: one vec4 position per
+ * entity slot, w = 0 for tombstones, stale past the live count. The producer never waits on the consumer. The
+ * frame signaling V + PUBLISHED_SNAPSHOT_COUNT rewrites the slot, and its copy starts no earlier than the frame
+ * before it completes, so a read that still sees the counter below V + PUBLISHED_SNAPSHOT_COUNT - 1 once it has
+ * finished read intact data. Growth reallocates the ring: the manifest is rewritten with a new generation and new
+ * handles, and the counter keeps climbing. Ownership is never released to VK_QUEUE_FAMILY_EXTERNAL, which the
+ * graphics acquire of every frame would conflict with; the consumer reads its import without an acquire.
+ */
+class EntityPositionExport {
+public:
+#if defined(VK_USE_PLATFORM_WIN32_KHR)
+    using Handle = void*;  // NT handle
+    static constexpr Handle INVALID_HANDLE = nullptr;
+#else
+    using Handle = int;    // File descriptor
+    static constexpr Handle INVALID_HANDLE = -1;
+#endif
+
+    EntityPositionExport();
+    ~EntityPositionExport();
+    EntityPositionExport(const EntityPositionExport&) = delete;
+    EntityPositionExport& operator=(const EntityPositionExport&) = delete;
+    
+    // Creates and exports the timeline semaphore (VulkanContext::supportsExternalPositionExport); the manifest
+    // is first written by publishBuffers
+    bool initialize(const VulkanContext& context, const std::string& manifestPath);
+    void cleanup();  // Device idle: destroys the semaphore, closes the handles and removes the manifest
+    bool isActive() const { return semaphore != VK_NULL_HANDLE; }
+    
+    // Exports the ring's current allocations and rewrites the manifest; after initialization and after every
+    // growth that reallocated the ring
+    bool publishBuffers(const PositionBufferCoordinator& positions, uint64_t bufferGeneration);
+    
+    // This frame publishes into slot: picks the next value naming it, which the frame's compute submit signals
+    void beginPublish(uint32_t slot);
+    // Value for the coming compute submit, 0 when the frame published nothing (or export is off)
+    uint64_t takePendingSignal();
+    VkSemaphore getSemaphore() const { return semaphore; }
+    uint64_t getLastValue() const { return lastValue; }
+
+private:
+    bool writeManifest(const PositionBufferCoordinator& positions) const;
+    void closeHandle(Handle& handle) const;
+    
+    const VulkanContext* context = nullptr;
+    std::string manifestPath;
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+    Handle semaphoreHandle = INVALID_HANDLE;
+    std::array<Handle, PUBLISHED_SNAPSHOT_COUNT> memoryHandles{};  // INVALID_HANDLE until publishBuffers
+    uint64_t generation = 0;
+    uint64_t lastValue = 0;      // Highest value handed out, each above the last
+    uint64_t pendingValue = 0;
+};
@@ -0,0 +1,308 @@
+#include "entity_position_mirror.h"
+#include "../../vulkan/core/vulkan_constants.h"
+#include <algorithm>
+#include <bit>
+#include <cstring>
+#include <limits>
+
+#if (defined(__x86_64__) || defined(__i386__)) && (defined(__GNUC__) || defined(__clang__))
+#define POSITION_MIRROR_AVX2 1
+#include <immintrin.h>
+#elif defined(__aarch64__)
+#define POSITION_MIRROR_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+    // Every comparison with NaN is false, so padded lanes never match and never win a nearest search
+    constexpr float PADDING_POSITION = std::numeric_limits<float>::quiet_NaN();
+    
+    void appendLanes(uint32_t mask, size_t base, std::vector<uint32_t>& indices) {
+        while (mask) {
+            indices.push_back(static_cast<uint32_t>(base + std::countr_zero(mask)));
+            mask &= mask - 1;
+        }
+    }
+    
+    struct NearestResult {
+        float distanceSquared;
+        uint32_t index;
+    };
+
+#if defined(POSITION_MIRROR_AVX2)
+    // The kernels are compiled for AVX2 on their own, so the rest of the build keeps its baseline target
+    bool cpuHasAvx2() {
+        static const bool supported = [] {
+            __builtin_cpu_init();
+            return __builtin_cpu_supports("avx2") != 0;
+        }();
+        return supported;
+    }
+    
+    __attribute__((target("avx2")))
+    size_t queryRectWide(const float* x, const float* y, size_t size, glm::vec2 min, glm::vec2 max, std::vector<uint32_t>& indices) {
+        const __m256 minX = _mm256_set1_ps(min.x), maxX = _mm256_set1_ps(max.x);
+        const __m256 minY = _mm256_set1_ps(min.y), maxY = _mm256_set1_ps(max.y);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            const __m256 px = _mm256_loadu_ps(x + i);
+            const __m256 py = _mm256_loadu_ps(y + i);
+            const __m256 insideX = _mm256_and_ps(_mm256_cmp_ps(px, minX, _CMP_GE_OQ), _mm256_cmp_ps(px, maxX, _CMP_LE_OQ));
+            const __m256 insideY = _mm256_and_ps(_mm256_cmp_ps(py, minY, _CMP_GE_OQ), _mm256_cmp_ps(py, maxY, _CMP_LE_OQ));
+            appendLanes(static_cast<uint32_t>(_mm256_movemask_ps(_mm256_and_ps(insideX, insideY))), i, indices);
+        }
+        return i;
+    }
+    
+    __attribute__((target("avx2")))
+    size_t queryRadiusWide(const float* x, const float* y, size_t size, glm::vec2 center, float radiusSquared, std::vector<uint32_t>& indices) {
+        const __m256 cx = _mm256_set1_ps(center.x), cy = _mm256_set1_ps(center.y);
+        const __m256 limit = _mm256_set1_ps(radiusSquared);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), cx);
+            const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), cy);
+            const __m256 distanceSquared = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            appendLanes(static_cast<uint32_t>(_mm256_movemask_ps(_mm256_cmp_ps(distanceSquared, limit, _CMP_LE_OQ))), i, indices);
+        }
+        return i;
+    }
+    
+    __attribute__((target("avx2")))
+    size_t findNearestWide(const float* x, const float* y, size_t size, glm::vec2 point, NearestResult& nearest) {
+        const __m256 px = _mm256_set1_ps(point.x), py = _mm256_set1_ps(point.y);
+        __m256 best = _mm256_set1_ps(nearest.distanceSquared);
+        __m256i bestIndex = _mm256_set1_epi32(static_cast<int>(nearest.index));
+        __m256i lane = _mm256_setr_epi32(0, 1, 2, 3, 4, 5, 6, 7);
+        const __m256i step = _mm256_set1_epi32(8);
+        size_t i = 0;
+        for (; i + 8 <= size; i += 8) {
+            const __m256 dx = _mm256_sub_ps(_mm256_loadu_ps(x + i), px);
+            const __m256 dy = _mm256_sub_ps(_mm256_loadu_ps(y + i), py);
+            const __m256 distanceSquared = _mm256_add_ps(_mm256_mul_ps(dx, dx), _mm256_mul_ps(dy, dy));
+            const __m256 closer = _mm256_cmp_ps(distanceSquared, best, _CMP_LT_OQ);
+            best = _mm256_blendv_ps(best, distanceSquared, closer);
+            bestIndex = _mm256_castps_si256(_mm256_blendv_ps(_mm256_castsi256_ps(bestIndex), _mm256_castsi256_ps(lane), closer));
+            lane = _mm256_add_epi32(lane, step);
+        }
+        
+        alignas(32) float distances[8];
+        alignas(32) uint32_t laneIndices[8];
+        _mm256_store_ps(distances, best);
+        _mm256_store_si256(reinterpret_cast<__m256i*>(laneIndices), bestIndex);
+        for (int l = 0; l < 8; ++l) {
+            if (distances[l] < nearest.distanceSquared ||
+                (distances[l] == nearest.distanceSquared && laneIndices[l] < nearest.index)) {
+                nearest = {distances[l], laneIndices[l]};
+            }
+        }
+        return i;
+    }
+#elif defined(POSITION_MIRROR_NEON)
+    uint32_t laneMask(uint32x4_t matches) {
+        const uint32_t bitValues[4] = {1u, 2u, 4u, 8u};
+        return vaddvq_u32(vandq_u32(matches, vld1q_u32(bitValues)));
+    }
+    
+    size_t queryRectWide(const float* x, const float* y, size_t size, glm::vec2 min, glm::vec2 max, std::vector<uint32_t>& indices) {
+        const float32x4_t minX = vdupq_n_f32(min.x), maxX = vdupq_n_f32(max.x);
+        const float32x4_t minY = vdupq_n_f32(min.y), maxY = vdupq_n_f32(max.y);
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4) {
+            const float32x4_t px = vld1q_f32(x + i);
+            const float32x4_t py = vld1q_f32(y + i);
+            const uint32x4_t insideX = vandq_u32(vcgeq_f32(px, minX), vcleq_f32(px, maxX));
+            const uint32x4_t insideY = vandq_u32(vcgeq_f32(py, minY), vcleq_f32(py, maxY));
+            appendLanes(laneMask(vandq_u32(insideX, insideY)), i, indices);
+        }
+        return i;
+    }
+    
+    size_t queryRadiusWide(const float* x, const float* y, size_t size, glm::vec2 center, float radiusSquared, std::vector<uint32_t>& indices) {
+        const float32x4_t cx = vdupq_n_f32(center.x), cy = vdupq_n_f32(center.y);
+        const float32x4_t limit = vdupq_n_f32(radiusSquared);
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4) {
+            const float32x4_t dx = vsubq_f32(vld1q_f32(x + i), cx);
+            const float32x4_t dy = vsubq_f32(vld1q_f32(y + i), cy);
+            const float32x4_t distanceSquared = vmlaq_f32(vmulq_f32(dx, dx), dy, dy);
+            appendLanes(laneMask(vcleq_f32(distanceSquared, limit)), i, indices);
+        }
+        return i;
+    }
+    
+    size_t findNearestWide(const float* x, const float* y, size_t size, glm::vec2 point, NearestResult& nearest) {
+        const float32x4_t px = vdupq_n_f32(point.x), py = vdupq_n_f32(point.y);
+        float32x4_t best = vdupq_n_f32(nearest.distanceSquared);
+        uint32x4_t bestIndex = vdupq_n_u32(nearest.index);
+        const uint32_t firstLanes[4] = {0u, 1u, 2u, 3u};
+        uint32x4_t lane = vld1q_u32(firstLanes);
+        const uint32x4_t step = vdupq_n_u32(4u);
+        size_t i = 0;
+        for (; i + 4 <= size; i += 4) {
+            const float32x4_t dx = vsubq_f32(vld1q_f32(x + i), px);
+            const float32x4_t dy = vsubq_f32(vld1q_f32(y + i), py);
+            const float32x4_t distanceSquared = vmlaq_f32(vmulq_f32(dx, dx), dy, dy);
+            const uint32x4_t closer = vcltq_f32(distanceSquared, best);
+            best = vbslq_f32(closer, distanceSquared, best);
+            bestIndex = vbslq_u32(closer, lane, bestIndex);
+            lane = vaddq_u32(lane, step);
+        }
+        
+        float distances[4];
+        uint32_t laneIndices[4];
+        vst1q_f32(distances, best);
+        vst1q_u32(laneIndices, bestIndex);
+        for (int l = 0; l < 4; ++l) {
+            if (distances[l] < nearest.distanceSquared ||
+                (distances[l] == nearest.distanceSquared && laneIndices[l] < nearest.index)) {
+                nearest = {distances[l], laneIndices[l]};
+            }
+        }
+        return i;
+    }
+#endif
+}
+
+void EntityPositionMirror::Snapshot::queryRect(glm::vec2 min, glm::vec2 max, std::vector<uint32_t>& indices) const {
+    size_t i = 0;
+#if defined(POSITION_MIRROR_AVX2)
+    if (cpuHasAvx2()) i = queryRectWide(x.data(), y.data(), x.size(), min, max, indices);
+#elif defined(POSITION_MIRROR_NEON)
+    i = queryRectWide(x.data(), y.data(), x.size(), min, max, indices);
+#endif
+    for (; i < count; ++i) {
+        if (x[i] >= min.x && x[i] <= max.x && y[i] >= min.y && y[i] <= max.y) {
+            indices.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+void EntityPositionMirror::Snapshot::queryRadius(glm::vec2 center, float radius, std::vector<uint32_t>& indices) const {
+    const float radiusSquared = radius * radius;
+    size_t i = 0;
+#if defined(POSITION_MIRROR_AVX2)
+    if (cpuHasAvx2()) i = queryRadiusWide(x.data(), y.data(), x.size(), center, radiusSquared, indices);
+#elif defined(POSITION_MIRROR_NEON)
+    i = queryRadiusWide(x.data(), y.data(), x.size(), center, radiusSquared, indices);
+#endif
+    for (; i < count; ++i) {
+        const float dx = x[i] - center.x;
+        const float dy = y[i] - center.y;
+        if (dx * dx + dy * dy <= radiusSquared) {
+            indices.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
+uint32_t EntityPositionMirror::Snapshot::findNearest(glm::vec2 point, float maxRadius) const {
+    NearestResult nearest{maxRadius * maxRadius, NO_ENTITY};
+    size_t i = 0;
+#if defined(POSITION_MIRROR_AVX2)
+    if (cpuHasAvx2()) i = findNearestWide(x.data(), y.data(), x.size(), point, nearest);
+#elif defined(POSITION_MIRROR_NEON)
+    i = findNearestWide(x.data(), y.data(), x.size(), point, nearest);
+#endif
+    for (; i < count; ++i) {
+        const float dx = x[i] - point.x;
+        const float dy = y[i] - point.y;
+        const float distanceSquared = dx * dx + dy * dy;
+        if (distanceSquared < nearest.distanceSquared) {
+            nearest = {distanceSquared, static_cast<uint32_t>(i)};
+        }
+    }
+    return nearest.index;
+}
+
+std::shared_ptr<const EntityPositionMirror::Snapshot> EntityPositionMirror::getSnapshot() const {
+    std::lock_guard<std::mutex> lock(publishMutex);
+    return published;
+}
+
+bool EntityPositionMirror::isSweepDue(uint32_t frame) const {
+    return isEnabled() && !isSweeping() && (!hasSwept || frame - lastSweepFrame >= refreshInterval);
+}
+
+void EntityPositionMirror::beginSweep(uint32_t frame, uint32_t count, uint64_t bufferGeneration) {
+    auto snapshot = std::make_shared<Snapshot>();
+    const size_t paddedCount = (static_cast<size_t>(count) + LANE_PADDING - 1) / LANE_PADDING * LANE_PADDING;
+    snapshot->x.assign(paddedCount, PADDING_POSITION);
+    snapshot->y.assign(paddedCount, PADDING_POSITION);
+    snapshot->spawnIds.assign(count, UINT32_MAX);
+    snapshot->count = count;
+    snapshot->frame = frame;
+    
+    ++sweepId;
+    lastSweepFrame = frame;
+    hasSwept = true;
+    sweepGeneration = bufferGeneration;
+    nextChunkSlot = 0;
+    outstanding = 0;
+    sweepFailed = false;
+    
+    if (count == 0) {
+        std::lock_guard<std::mutex> lock(publishMutex);
+        published = std::move(snapshot);
+    } else {
+        building = std::move(snapshot);
+    }
+}
+
+bool EntityPositionMirror::takeChunk(uint32_t& first, uint32_t& count) {
+    if (!building || sweepFailed || nextChunkSlot >= building->count) {
+        return false;
+    }
+    
+    first = nextChunkSlot;
+    count = std::min(POSITION_MIRROR_CHUNK_ENTITIES, building->count - nextChunkSlot);
+    nextChunkSlot += count;
+    return true;
+}
+
+void EntityPositionMirror::storePositions(uint32_t sweep, uint32_t first, const void* data, uint32_t count) {
+    if (!acceptsResult(sweep, data)) return;
+    
+    // Readback data carries no alignment guarantee for glm::vec4, so the x and y lanes are copied out
+    const auto* bytes = static_cast<const unsigned char*>(data);
+    for (uint32_t i = 0; i < count; ++i) {
+        std::memcpy(&building->x[first + i], bytes + i * sizeof(glm::vec4), sizeof(float));
+        std::memcpy(&building->y[first + i], bytes + i * sizeof(glm::vec4) + sizeof(float), sizeof(float));
+    }
+    completeRequest();
+}
+
+void EntityPositionMirror::storeSpawnIds(uint32_t sweep, uint32_t first, const void* data, uint32_t count) {
+    if (!acceptsResult(sweep, data)) return;
+    
+    std::memcpy(&building->spawnIds[first], data, count * sizeof(uint32_t));
+    completeRequest();
+}
+
+void EntityPositionMirror::abortSweep() {
+    building.reset();
+    outstanding = 0;
+}
+
+bool EntityPositionMirror::acceptsResult(uint32_t sweep, const void* data) {
+    if (sweep != sweepId || !building) {
+        return false;  // Result of an aborted sweep
+    }
+    if (!data) {
+        sweepFailed = true;
+        completeRequest();
+        return false;
+    }
+    return true;
+}
+
+void EntityPositionMirror::completeRequest() {
+    if (--outstanding > 0 || (!sweepFailed && nextChunkSlot < building->count)) {
+        return;
+    }
+    
+    if (!sweepFailed) {
+        std::lock_guard<std::mutex> lock(publishMutex);
+        published = std::move(building);
+    }
+    building.reset();
+}
@@ -0,0 +1,85 @@
+#pragma once
+
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+/**
+ * Optional CPU copy of entity positions for spatial queries that should not wait on the GPU.
+ * EntityBufferManager sweeps the position and entity ID streams into it through the ReadbackRing, a few
+ * chunks per frame, and publishes the finished sweep as an immutable Snapshot. Queries run on any thread
+ * against the snapshot they hold, as structure-of-arrays batch kernels (AVX2 when the CPU has it, NEON on
+ * ARM, scalar otherwise).
+ *
+ * A snapshot is as old as its sweep (a few frames per hundred thousand entities) and chunks are read in
+ * different frames, so an entity moved between slots mid-sweep can be missed or seen twice.
+ */
+class EntityPositionMirror {
+public:
+    static constexpr uint32_t NO_ENTITY = UINT32_MAX;
+    static constexpr uint32_t LANE_PADDING = 8;  // Widest kernel; padded lanes hold NaN and match nothing
+    
+    struct Snapshot {
+        std::vector<float> x;            // World position per GPU slot, padded to LANE_PADDING
+        std::vector<float> y;
+        std::vector<uint32_t> spawnIds;  // Slot -> spawn ID, for GPUEntityManager::getECSEntityFromSpawnId
+        uint32_t count = 0;
+        uint32_t frame = 0;              // Frame the sweep started
+        
+        // Slots whose position lies in [min, max], appended to indices in slot order
+        void queryRect(glm::vec2 min, glm::vec2 max, std::vector<uint32_t>& indices) const;
+        
+        // Slots within radius of center, appended to indices in slot order
+        void queryRadius(glm::vec2 center, float radius, std::vector<uint32_t>& indices) const;
+        
+        // Closest slot within maxRadius of point, lowest slot on ties; NO_ENTITY when none
+        uint32_t findNearest(glm::vec2 point, float maxRadius) const;
+    };
+    
+    // Frames between sweep starts, 0 disables the mirror (the default). A sweep longer than the interval
+    // starts the next one as soon as it is published
+    void setRefreshInterval(uint32_t frames) { refreshInterval = frames; }
+    uint32_t getRefreshInterval() const { return refreshInterval; }
+    bool isEnabled() const { return refreshInterval > 0; }
+    
+    // Latest published sweep, nullptr before the first one; safe from any thread
+    std::shared_ptr<const Snapshot> getSnapshot() const;
+    
+    // Sweep bookkeeping for EntityBufferManager, on the render thread
+    bool isSweeping() const { return building != nullptr; }
+    bool isSweepDue(uint32_t frame) const;
+    void beginSweep(uint32_t frame, uint32_t count, uint64_t bufferGeneration);
+    uint64_t getSweepGeneration() const { return sweepGeneration; }
+    uint32_t getSweepId() const { return sweepId; }  // Carried by readback results, so an aborted sweep's are ignored
+    
+    // Next chunk of slots to read back; false once every chunk of the sweep has been handed out
+    bool takeChunk(uint32_t& first, uint32_t& count);
+    void addOutstanding() { ++outstanding; }
+    
+    // Readback results; data is nullptr for a cancelled request, which fails the sweep. The last outstanding
+    // result of a sweep publishes it, or drops it when it failed
+    void storePositions(uint32_t sweep, uint32_t first, const void* data, uint32_t count);
+    void storeSpawnIds(uint32_t sweep, uint32_t first, const void* data, uint32_t count);
+    void abortSweep();
+
+private:
+    bool acceptsResult(uint32_t sweep, const void* data);
+    void completeRequest();
+    
+    uint32_t refreshInterval = 0;
+    
+    mutable std::mutex publishMutex;
+    std::shared_ptr<const Snapshot> published;
+    
+    // Sweep in progress, render thread only
+    std::shared_ptr<Snapshot> building;
+    uint64_t sweepGeneration = 0;
+    uint32_t sweepId = 0;
+    uint32_t nextChunkSlot = 0;
+    uint32_t outstanding = 0;
+    uint32_t lastSweepFrame = 0;
+    bool hasSwept = false;
+    bool sweepFailed = false;
+};
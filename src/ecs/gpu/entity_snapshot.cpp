@@ -0,0 +1,181 @@
+#include "entity_snapshot.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#else
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
+#include <unistd.h>
+#endif
+
+namespace {
+    uint64_t alignColumnOffset(uint64_t offset) {
+        return (offset + SNAPSHOT_COLUMN_ALIGNMENT - 1) & ~(SNAPSHOT_COLUMN_ALIGNMENT - 1);
+    }
+}
+
+bool writeEntitySnapshot(const std::string& path, EntitySnapshotHeader header, const std::vector<EntitySnapshotColumnData>& columns) {
+    header.magic = EntitySnapshotHeader::MAGIC;
+    header.version = EntitySnapshotHeader::VERSION;
+    header.columnCount = static_cast<uint32_t>(columns.size());
+    
+    std::vector<EntitySnapshotColumnEntry> table(columns.size());
+    uint64_t offset = alignColumnOffset(sizeof(EntitySnapshotHeader) + table.size() * sizeof(EntitySnapshotColumnEntry));
+    for (size_t i = 0; i < columns.size(); ++i) {
+        table[i].id = static_cast<uint32_t>(columns[i].id);
+        table[i].elementSize = columns[i].elementSize;
+        table[i].offset = offset;
+        table[i].size = columns[i].size;
+        offset = alignColumnOffset(offset + columns[i].size);
+    }
+    
+    const std::string tempPath = path + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open()) {
+            std::cerr << "EntitySnapshot: Failed to open " << tempPath << std::endl;
+            return false;
+        }
+        
+        static const char padding[SNAPSHOT_COLUMN_ALIGNMENT] = {};
+        uint64_t written = 0;
+        auto writeBytes = [&](const void* data, uint64_t size) {
+            file.write(static_cast<const char*>(data), static_cast<std::streamsize>(size));
+            written += size;
+        };
+        auto padTo = [&](uint64_t target) {
+            writeBytes(padding, target - written);
+        };
+        
+        writeBytes(&header, sizeof(header));
+        writeBytes(table.data(), table.size() * sizeof(EntitySnapshotColumnEntry));
+        for (size_t i = 0; i < columns.size(); ++i) {
+            padTo(table[i].offset);
+            writeBytes(columns[i].data, columns[i].size);
+        }
+        
+        if (!file.flush()) {
+            std::cerr << "EntitySnapshot: Failed to write " << tempPath << std::endl;
+            return false;
+        }
+    }
+    
+    std::error_code error;
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::cerr << "EntitySnapshot: Failed to replace " << path << ": " << error.message() << std::endl;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    return true;
+}
+
+EntitySnapshotFile::~EntitySnapshotFile() {
+    close();
+}
+
+bool EntitySnapshotFile::open(const std::string& path) {
+    close();
+
+#if defined(_WIN32)
+    HANDLE file = CreateFileA(path.c_str(), GENERIC_READ, FILE_SHARE_READ, nullptr, OPEN_EXISTING, FILE_FLAG_SEQUENTIAL_SCAN, nullptr);
+    if (file == INVALID_HANDLE_VALUE) {
+        std::cerr << "EntitySnapshot: Failed to open " << path << std::endl;
+        return false;
+    }
+    LARGE_INTEGER fileSize{};
+    HANDLE mapping = GetFileSizeEx(file, &fileSize) && fileSize.QuadPart > 0
+        ? CreateFileMappingA(file, nullptr, PAGE_READONLY, 0, 0, nullptr) : nullptr;
+    const void* view = mapping ? MapViewOfFile(mapping, FILE_MAP_READ, 0, 0, 0) : nullptr;
+    if (!view) {
+        std::cerr << "EntitySnapshot: Failed to map " << path << std::endl;
+        if (mapping) CloseHandle(mapping);
+        CloseHandle(file);
+        return false;
+    }
+    fileHandle = file;
+    mappingHandle = mapping;
+    mappedData = static_cast<const uint8_t*>(view);
+    mappedSize = static_cast<size_t>(fileSize.QuadPart);
+#else
+    int fd = ::open(path.c_str(), O_RDONLY);
+    if (fd < 0) {
+        std::cerr << "EntitySnapshot: Failed to open " << path << std::endl;
+        return false;
+    }
+    struct stat fileStat{};
+    void* view = fstat(fd, &fileStat) == 0 && fileStat.st_size > 0
+        ? mmap(nullptr, static_cast<size_t>(fileStat.st_size), PROT_READ, MAP_PRIVATE, fd, 0) : MAP_FAILED;
+    ::close(fd);  // The mapping keeps the file referenced
+    if (view == MAP_FAILED) {
+        std::cerr << "EntitySnapshot: Failed to map " << path << std::endl;
+        return false;
+    }
+    // Columns are read once, front to back, by the staging copy - start paging them in now
+    madvise(view, static_cast<size_t>(fileStat.st_size), MADV_WILLNEED);
+    mappedData = static_cast<const uint8_t*>(view);
+    mappedSize = static_cast<size_t>(fileStat.st_size);
+#endif
+
+    if (mappedSize < sizeof(EntitySnapshotHeader)) {
+        std::cerr << "EntitySnapshot: " << path << " is truncated" << std::endl;
+        close();
+        return false;
+    }
+    std::memcpy(&header, mappedData, sizeof(header));
+    if (header.magic != EntitySnapshotHeader::MAGIC || header.version != EntitySnapshotHeader::VERSION) {
+        std::cerr << "EntitySnapshot: " << path << " is not a version " << EntitySnapshotHeader::VERSION << " snapshot" << std::endl;
+        close();
+        return false;
+    }
+    
+    const uint64_t tableEnd = sizeof(EntitySnapshotHeader) + uint64_t(header.columnCount) * sizeof(EntitySnapshotColumnEntry);
+    if (tableEnd > mappedSize) {
+        std::cerr << "EntitySnapshot: " << path << " has a truncated column table" << std::endl;
+        close();
+        return false;
+    }
+    columns.resize(header.columnCount);
+    std::memcpy(columns.data(), mappedData + sizeof(EntitySnapshotHeader), columns.size() * sizeof(EntitySnapshotColumnEntry));
+    for (const EntitySnapshotColumnEntry& column : columns) {
+        if (column.offset < tableEnd || column.offset > mappedSize || column.size > mappedSize - column.offset) {
+            std::cerr << "EntitySnapshot: Column " << column.id << " of " << path << " lies outside the file" << std::endl;
+            close();
+            return false;
+        }
+    }
+    return true;
+}
+
+void EntitySnapshotFile::close() {
+#if defined(_WIN32)
+    if (mappedData) UnmapViewOfFile(mappedData);
+    if (mappingHandle) CloseHandle(mappingHandle);
+    if (fileHandle) CloseHandle(fileHandle);
+    fileHandle = mappingHandle = nullptr;
+#else
+    if (mappedData) munmap(const_cast<uint8_t*>(mappedData), mappedSize);
+#endif
+    mappedData = nullptr;
+    mappedSize = 0;
+    header = EntitySnapshotHeader{};
+    columns.clear();
+}
+
+const void* EntitySnapshotFile::getColumn(EntitySnapshotColumn id, size_t& size, uint32_t& elementSize) const {
+    for (const EntitySnapshotColumnEntry& column : columns) {
+        if (column.id == static_cast<uint32_t>(id)) {
+            size = static_cast<size_t>(column.size);
+            elementSize = column.elementSize;
+            return mappedData + column.offset;
+        }
+    }
+    return nullptr;
+}
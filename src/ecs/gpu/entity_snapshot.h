@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Versioned, column-oriented binary file holding the GPU entity state (GPUEntityManager::saveSnapshot).
+ * A fixed header is followed by a column table and the columns, each the raw bytes of one GPU stream in
+ * slot order, so a restore hands the mapped pages straight to the staging copy without parsing them.
+ *
+ * Column offsets are aligned to SNAPSHOT_COLUMN_ALIGNMENT; every field is little-endian, as written by
+ * the machines this runs on. A file from another version or stream layout is rejected, not converted.
+ */
+enum class EntitySnapshotColumn : uint32_t {
+    Velocity = 0,
+    MovementParams,     // Layout-dependent stride (ENTITY_COMPACT_LAYOUT)
+    RuntimeState,       // Layout-dependent stride
+    ColorParams,
+    ModelMatrix,        // Absent under the compact layout
+    Position,           // Primary positions, restored to the primary, alternate and current buffers
+    PreviousPosition,   // Target buffer: start-of-tick positions the vertex shader interpolates from
+    SpawnId,            // Slot -> spawn ID (the entity ID buffer)
+    ECSEntity,          // Spawn ID -> flecs entity id (0 for free IDs), one per spawn ID below spawnIdLimit
+    EntityType,         // Slot -> entity type bits (shape), added in version 2
+};
+
+struct EntitySnapshotHeader {
+    static constexpr uint32_t MAGIC = 0x50414E53;  // "SNAP"
+    static constexpr uint32_t VERSION = 2;
+    static constexpr uint32_t FLAG_COMPACT_LAYOUT = 1u << 0;
+    
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t flags = 0;
+    uint32_t columnCount = 0;
+    uint32_t entityCount = 0;
+    uint32_t spawnIdLimit = 0;     // Exclusive upper bound of the spawn IDs in use
+    uint64_t frame = 0;            // Renderer frame counter
+    float totalTime = 0.0f;        // Accumulated simulation time fed to the entity shaders
+    float spawnBoundsMin[2] = {};  // Spawn area, which sizes the spatial grid
+    float spawnBoundsMax[2] = {};
+    uint32_t reserved = 0;
+};
+static_assert(sizeof(EntitySnapshotHeader) == 56, "EntitySnapshotHeader is part of the file format");
+
+struct EntitySnapshotColumnEntry {
+    uint32_t id = 0;           // EntitySnapshotColumn
+    uint32_t elementSize = 0;  // Bytes per slot (or per spawn ID for ECSEntity)
+    uint64_t offset = 0;       // From the start of the file
+    uint64_t size = 0;
+};
+static_assert(sizeof(EntitySnapshotColumnEntry) == 24, "EntitySnapshotColumnEntry is part of the file format");
+
+constexpr uint64_t SNAPSHOT_COLUMN_ALIGNMENT = 256;
+
+// One column to write, pointing at memory the caller keeps alive until writeEntitySnapshot returns
+struct EntitySnapshotColumnData {
+    EntitySnapshotColumn id;
+    uint32_t elementSize = 0;
+    const void* data = nullptr;
+    size_t size = 0;
+};
+
+// Writes header and columns beside path and renames the result over it, so a failed save keeps the old file
+bool writeEntitySnapshot(const std::string& path, EntitySnapshotHeader header, const std::vector<EntitySnapshotColumnData>& columns);
+
+// Read-only memory mapping of a snapshot file, validated on open
+class EntitySnapshotFile {
+public:
+    EntitySnapshotFile() = default;
+    ~EntitySnapshotFile();
+    
+    EntitySnapshotFile(const EntitySnapshotFile&) = delete;
+    EntitySnapshotFile& operator=(const EntitySnapshotFile&) = delete;
+    
+    // False (logged) when the file is missing, truncated, another version, or a column lies outside it
+    bool open(const std::string& path);
+    void close();
+    
+    const EntitySnapshotHeader& getHeader() const { return header; }
+    
+    // Mapped column bytes, nullptr when the file has no such column; size and elementSize are set when found
+    const void* getColumn(EntitySnapshotColumn id, size_t& size, uint32_t& elementSize) const;
+
+private:
+    const uint8_t* mappedData = nullptr;
+    size_t mappedSize = 0;
+#if defined(_WIN32)
+    void* fileHandle = nullptr;
+    void* mappingHandle = nullptr;
+#endif
+
+    EntitySnapshotHeader header{};
+    std::vector<EntitySnapshotColumnEntry> columns;
+};
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <flecs.h>
+#include <algorithm>
+#include <cstdint>
+#include <vector>
+
+/**
+ * Two-way map between spawn IDs and ECS entities as a sparse set. Spawn IDs index a dense array of Flecs ids,
+ * entity indices (the low 32 bits of an id) a sparse array of spawn IDs, so both lookups are one array read
+ * with no hashing. The sparse entry is only trusted when the dense entry it names holds the full id back,
+ * which also rejects an entity index Flecs recycled with a new generation.
+ *
+ * The GPU slot of a spawn ID is kept on the GPU side (SpawnSlotBuffer), since the reorder and despawn passes
+ * move entities between slots without the CPU seeing it.
+ */
+class EntitySpawnMap {
+public:
+    static constexpr uint32_t NO_SPAWN_ID = UINT32_MAX;
+    
+    // Spawn IDs below limit can be bound; grows geometrically so per-spawn calls stay amortised O(1)
+    void reserveSpawnIds(uint32_t limit) {
+        if (limit <= entityBySpawnId.size()) return;
+        if (limit > entityBySpawnId.capacity()) {
+            entityBySpawnId.reserve(std::max<size_t>(limit, entityBySpawnId.capacity() * 2));
+        }
+        entityBySpawnId.resize(limit, 0);
+    }
+    uint32_t getSpawnIdLimit() const { return static_cast<uint32_t>(entityBySpawnId.size()); }
+    
+    // Dense side only: concurrent calls for distinct spawn IDs below the reserved limit are safe. The binding
+    // is not found by entity until index() has run for it
+    void assign(uint32_t spawnId, flecs::entity_t entity) { entityBySpawnId[spawnId] = entity; }
+    
+    // Sparse side of an assigned spawn ID; one thread
+    void index(uint32_t spawnId) {
+        const uint32_t entityIndex = indexOf(entityBySpawnId[spawnId]);
+        if (entityIndex >= spawnIdByIndex.size()) {
+            spawnIdByIndex.resize(std::max<size_t>(entityIndex + 1, spawnIdByIndex.size() * 2), NO_SPAWN_ID);
+        }
+        spawnIdByIndex[entityIndex] = spawnId;
+    }
+    
+    void bind(uint32_t spawnId, flecs::entity_t entity) {
+        reserveSpawnIds(spawnId + 1);
+        assign(spawnId, entity);
+        index(spawnId);
+    }
+    
+    // Forgets the entity's binding and returns its spawn ID, NO_SPAWN_ID when it had none
+    uint32_t unbind(flecs::entity_t entity) {
+        const uint32_t spawnId = find(entity);
+        if (spawnId != NO_SPAWN_ID) {
+            entityBySpawnId[spawnId] = 0;
+        }
+        return spawnId;
+    }
+    
+    // Stale sparse entries are left behind; the dense check ignores them
+    void unbindSpawnId(uint32_t spawnId) {
+        if (spawnId < entityBySpawnId.size()) {
+            entityBySpawnId[spawnId] = 0;
+        }
+    }
+    
+    uint32_t find(flecs::entity_t entity) const {
+        const uint32_t entityIndex = indexOf(entity);
+        if (entity == 0 || entityIndex >= spawnIdByIndex.size()) {
+            return NO_SPAWN_ID;
+        }
+        const uint32_t spawnId = spawnIdByIndex[entityIndex];
+        return spawnId < entityBySpawnId.size() && entityBySpawnId[spawnId] == entity ? spawnId : NO_SPAWN_ID;
+    }
+    
+    // 0 when the spawn ID is unbound
+    flecs::entity_t getEntity(uint32_t spawnId) const {
+        return spawnId < entityBySpawnId.size() ? entityBySpawnId[spawnId] : 0;
+    }
+    
+    void clear() {
+        entityBySpawnId.clear();
+        spawnIdByIndex.clear();
+    }
+
+private:
+    static uint32_t indexOf(flecs::entity_t entity) { return static_cast<uint32_t>(entity); }
+    
+    std::vector<flecs::entity_t> entityBySpawnId;
+    std::vector<uint32_t> spawnIdByIndex;
+};
@@ -0,0 +1,67 @@
+#include "entity_stream_schema.h"
+#include "../../shaders/entity_streams.glsl"
+#include <iomanip>
+#include <ostream>
+#include <string>
+
+namespace EntityStreamSchema {
+    bool isGlslCurrent() {
+        return ENTITY_STREAM_SCHEMA_HASH == getHash();
+    }
+    
+    static const char* temperatureName(EntityStreamTemperature temperature) {
+        switch (temperature) {
+            case EntityStreamTemperature::Hot: return "hot";
+            case EntityStreamTemperature::Cold: return "cold";
+            case EntityStreamTemperature::Transient: return "transient";
+        }
+        return "";
+    }
+    
+    static const char* precisionName(EntityStreamPrecision precision) {
+        switch (precision) {
+            case EntityStreamPrecision::Full: return "full";
+            case EntityStreamPrecision::Half: return "half";
+            case EntityStreamPrecision::Packed: return "packed";
+            case EntityStreamPrecision::Narrowed: return "narrowed";
+            case EntityStreamPrecision::Dropped: return "dropped";
+        }
+        return "";
+    }
+    
+    void writeGlsl(std::ostream& out) {
+        out << "// Generated by EntityStreamSchema::writeGlsl (src/ecs/gpu/entity_stream_schema.h); regenerate with\n"
+               "// `cmake --build . --target entity-schema` rather than editing. entity_stream_schema.cpp includes it\n"
+               "// too, and startup warns while ENTITY_STREAM_SCHEMA_HASH no longer matches the schema\n"
+               "#ifndef ENTITY_STREAMS_GLSL\n"
+               "#define ENTITY_STREAMS_GLSL\n\n";
+        out << "#define ENTITY_STREAM_SCHEMA_HASH 0x" << std::hex << std::setw(8) << std::setfill('0') << getHash()
+            << std::dec << std::setfill(' ') << "u\n";
+        out << "#define ENTITY_STREAM_COUNT " << STREAM_COUNT << "\n\n";
+        
+        out << "// Compute bindings, also the bindless table and stream address table entries\n"
+               "// (block, bytes per element in the standard / compact layout, compact encoding, access)\n";
+        for (const auto& stream : STREAMS) {
+            std::string name = std::string("ENTITY_STREAM_") + stream.id;
+            out << "#define " << std::left << std::setw(40) << name << std::right << std::setw(2) << stream.computeBinding
+                << "  // " << stream.blockName << ", ";
+            if (stream.stride == 0) {
+                out << "one fixed struct";
+            } else {
+                out << stream.stride << " / " << stream.compactStride << (stream.perEntity ? " per entity" : " per cell")
+                    << ", " << precisionName(stream.compactPrecision);
+            }
+            out << ", " << temperatureName(stream.temperature) << "\n";
+        }
+        
+        out << "\n// Graphics bindings (binding 0 is the camera UBO)\n";
+        for (uint32_t binding = 1; binding < Graphics::BINDING_COUNT; ++binding) {
+            for (const auto& stream : STREAMS) {
+                if (stream.graphicsBinding != binding) continue;
+                std::string name = std::string("ENTITY_GRAPHICS_STREAM_") + stream.id;
+                out << "#define " << std::left << std::setw(40) << name << std::right << std::setw(2) << binding << "\n";
+            }
+        }
+        out << "\n#endif\n";
+    }
+}
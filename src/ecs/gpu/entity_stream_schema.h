@@ -0,0 +1,153 @@
+#pragma once
+
+#include "entity_descriptor_bindings.h"
+#include <cstddef>
+#include <cstdint>
+#include <iosfwd>
+
+/**
+ * EntityStreamSchema - the one description of the entity buffer streams
+ *
+ * Every stream of the entity descriptor set is listed once, in compute binding order: its block name, graphics
+ * binding, element stride in each layout and how often it is touched. The specialized buffers take their strides
+ * from it, DescriptorLayoutPresets builds the entity compute and graphics layouts from it, and writeGlsl()
+ * generates src/shaders/entity_streams.glsl (the binding macros the shaders include through entity_bindings.glsl),
+ * which startup checks against the schema (isGlslCurrent). A layout experiment is a change to a stride or precision
+ * here, picked up everywhere the stream is sized or bound.
+ */
+
+// How the compact layout (ENTITY_COMPACT_LAYOUT) stores a stream relative to the standard one
+enum class EntityStreamPrecision : uint8_t {
+    Full,       // Same encoding in both layouts
+    Half,       // fp16 components (packHalf2x16)
+    Packed,     // Fields bit-packed into fewer words
+    Narrowed,   // Fewer fp32 components
+    Dropped,    // Not allocated at all
+};
+
+// Access frequency, which decides what the compact layout shrinks first
+enum class EntityStreamTemperature : uint8_t {
+    Hot,        // Read or written by the simulation every frame
+    Cold,       // Written at spawn or on edits, read when drawing or binning
+    Transient,  // Rebuilt by the GPU every frame or pass
+};
+
+struct EntityStreamInfo {
+    const char* id;                 // Macro suffix in entity_streams.glsl
+    const char* blockName;          // GLSL buffer block name, also the layout's debug name
+    uint32_t computeBinding;        // Also the bindless table and stream address table entry
+    uint32_t graphicsBinding;       // ENTITY_STREAM_NO_GRAPHICS_BINDING when graphics does not bind it
+    uint32_t stride;                // Bytes per element, standard layout; 0 for a single fixed struct
+    uint32_t compactStride;         // Bytes per element, compact layout; 0 when Dropped
+    EntityStreamPrecision compactPrecision;
+    EntityStreamTemperature temperature;
+    bool perEntity;                 // One element per entity slot, reserved to ENTITY_CAPACITY_MAX for sparse growth
+};
+
+constexpr uint32_t ENTITY_STREAM_NO_GRAPHICS_BINDING = UINT32_MAX;
+
+namespace EntityStreamSchema {
+    using namespace EntityDescriptorBindings;
+    constexpr uint32_t NONE = ENTITY_STREAM_NO_GRAPHICS_BINDING;
+    
+    inline constexpr EntityStreamInfo STREAMS[] = {
+        // id                  blockName                     compute binding                     graphics binding
+        //                     stride  compact  compact precision            temperature                          perEntity
+        {"VELOCITY",           "VelocityBuffer",             Compute::VELOCITY_BUFFER,            NONE,
+                               16,     16,      EntityStreamPrecision::Full,     EntityStreamTemperature::Hot,       true},
+        {"MOVEMENT_PARAMS",    "MovementParamsBuffer",       Compute::MOVEMENT_PARAMS_BUFFER,     Graphics::MOVEMENT_PARAMS_BUFFER,
+                               16,     8,       EntityStreamPrecision::Half,     EntityStreamTemperature::Cold,      true},
+        {"RUNTIME_STATE",      "RuntimeStateBuffer",         Compute::RUNTIME_STATE_BUFFER,       NONE,
+                               16,     4,       EntityStreamPrecision::Packed,   EntityStreamTemperature::Hot,       true},
+        {"POSITION",           "PositionBuffer",             Compute::POSITION_BUFFER,            Graphics::POSITION_BUFFER,
+                               16,     16,      EntityStreamPrecision::Full,     EntityStreamTemperature::Hot,       true},
+        {"CURRENT_POSITION",   "CurrentPositionBuffer",      Compute::CURRENT_POSITION_BUFFER,    NONE,
+                               16,     8,       EntityStreamPrecision::Narrowed, EntityStreamTemperature::Hot,       true},
+        {"COLOR",              "ColorBuffer",                Compute::COLOR_BUFFER,               Graphics::COLOR_BUFFER,
+                               16,     16,      EntityStreamPrecision::Full,     EntityStreamTemperature::Cold,      true},
+        {"MODEL_MATRIX",       "ModelMatrixBuffer",          Compute::MODEL_MATRIX_BUFFER,        NONE,
+                               64,     0,       EntityStreamPrecision::Dropped,  EntityStreamTemperature::Cold,      true},
+        {"SPATIAL_MAP",        "SpatialMapBuffer",           Compute::SPATIAL_MAP_BUFFER,         NONE,
+                               8,      8,       EntityStreamPrecision::Full,     EntityStreamTemperature::Transient, false},
+        {"SPATIAL_ENTRY",      "SpatialEntryBuffer",         Compute::SPATIAL_ENTRY_BUFFER,       NONE,
+                               8,      8,       EntityStreamPrecision::Full,     EntityStreamTemperature::Transient, true},
+        {"SPATIAL_INDEX",      "SpatialIndexBuffer",         Compute::SPATIAL_INDEX_BUFFER,       NONE,
+                               4,      4,       EntityStreamPrecision::Full,     EntityStreamTemperature::Transient, true},
+        {"ENTITY_ID",          "EntityIdBuffer",             Compute::ENTITY_ID_BUFFER,           Graphics::ENTITY_ID_BUFFER,
+                               4,      4,       EntityStreamPrecision::Full,     EntityStreamTemperature::Cold,      true},
+        {"REORDER_SCRATCH",    "ReorderScratchBuffer",       Compute::REORDER_SCRATCH_BUFFER,     NONE,
+                               16,     16,      EntityStreamPrecision::Full,     EntityStreamTemperature::Transient, true},
+        {"INDIRECT_COMMAND",   "IndirectCommandBuffer",      Compute::INDIRECT_COMMAND_BUFFER,    NONE,
+                               0,      0,       EntityStreamPrecision::Full,     EntityStreamTemperature::Transient, false},
+        {"VISIBLE_INDEX",      "VisibleIndexBuffer",         Compute::VISIBLE_INDEX_BUFFER,       Graphics::VISIBLE_INDEX_BUFFER,
+                               4,      4,       EntityStreamPrecision::Full,     EntityStreamTemperature::Transient, true},
+        {"VISIBLE_DRAW_COMMAND", "VisibleDrawCommandBuffer", Compute::VISIBLE_DRAW_COMMAND_BUFFER, NONE,
+                               0,      0,       EntityStreamPrecision::Full,     EntityStreamTemperature::Transient, false},
+        {"PREVIOUS_POSITION",  "PreviousPositionBuffer",     Compute::PREVIOUS_POSITION_BUFFER,   Graphics::PREVIOUS_POSITION_BUFFER,
+                               16,     16,      EntityStreamPrecision::Full,     EntityStreamTemperature::Hot,       true},
+        {"ENTITY_TYPE",        "EntityTypeBuffer",           Compute::ENTITY_TYPE_BUFFER,         NONE,
+                               4,      4,       EntityStreamPrecision::Full,     EntityStreamTemperature::Cold,      true},
+        {"SPAWN_SLOT",         "SpawnSlotBuffer",            Compute::SPAWN_SLOT_BUFFER,          NONE,
+                               4,      4,       EntityStreamPrecision::Full,     EntityStreamTemperature::Cold,      true},
+    };
+    
+    constexpr uint32_t STREAM_COUNT = sizeof(STREAMS) / sizeof(STREAMS[0]);
+    
+    constexpr const EntityStreamInfo& get(uint32_t computeBinding) { return STREAMS[computeBinding]; }
+    
+    // Element stride of the stream in the given layout, 0 when the layout drops it
+    constexpr uint32_t getStride(uint32_t computeBinding, bool compactLayout = false) {
+        return compactLayout ? STREAMS[computeBinding].compactStride : STREAMS[computeBinding].stride;
+    }
+    
+    // FNV-1a over every field, written into entity_streams.glsl so a stale generated header can be told apart
+    constexpr uint32_t getHash() {
+        uint32_t hash = 2166136261u;
+        auto mix = [&hash](uint32_t value) {
+            for (uint32_t byte = 0; byte < 4; ++byte) {
+                hash = (hash ^ ((value >> (byte * 8)) & 0xFFu)) * 16777619u;
+            }
+        };
+        auto mixString = [&hash](const char* text) {
+            for (; *text; ++text) hash = (hash ^ static_cast<uint8_t>(*text)) * 16777619u;
+            hash *= 16777619u;  // Terminator, so adjacent strings cannot trade characters
+        };
+        for (const auto& stream : STREAMS) {
+            mixString(stream.id);
+            mixString(stream.blockName);
+            mix(stream.computeBinding);
+            mix(stream.graphicsBinding);
+            mix(stream.stride);
+            mix(stream.compactStride);
+            mix(static_cast<uint32_t>(stream.compactPrecision));
+            mix(static_cast<uint32_t>(stream.temperature));
+            mix(stream.perEntity ? 1u : 0u);
+        }
+        return hash;
+    }
+    
+    constexpr bool isOrderedByBinding() {
+        for (uint32_t i = 0; i < STREAM_COUNT; ++i) {
+            if (STREAMS[i].computeBinding != i) return false;
+        }
+        return true;
+    }
+    
+    constexpr uint32_t getGraphicsStreamCount() {
+        uint32_t count = 0;
+        for (const auto& stream : STREAMS) {
+            if (stream.graphicsBinding != NONE) ++count;
+        }
+        return count;
+    }
+    
+    static_assert(STREAM_COUNT == Compute::BINDING_COUNT && isOrderedByBinding(),
+                  "EntityStreamSchema must list every compute binding, in binding order");
+    static_assert(getGraphicsStreamCount() + 1 == Graphics::BINDING_COUNT,
+                  "EntityStreamSchema must place every graphics binding but the camera UBO");
+    
+    // Writes the entity_streams.glsl shaders include (--write-entity-schema, the entity-schema target)
+    void writeGlsl(std::ostream& out);
+    // False when the entity_streams.glsl this tree was built with came from another schema
+    bool isGlslCurrent();
+}
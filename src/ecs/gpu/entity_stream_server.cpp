@@ -0,0 +1,526 @@
+#include "entity_stream_server.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstddef>
+#include <cstring>
+#include <iostream>
+#include <string>
+
+namespace {
+#ifdef _WIN32
+    using NativeSocket = SOCKET;
+#else
+    using NativeSocket = int;
+#endif
+
+    constexpr intptr_t INVALID_SOCKET_HANDLE = -1;
+    NativeSocket toNative(intptr_t handle) { return static_cast<NativeSocket>(handle); }
+    
+    // Steps are kept well inside int32, so a delta between two of them always fits a five byte varint
+    constexpr double MAX_STEPS = double(1 << 30);
+    
+    // A spawn or removal ranks like an entity that jumped this far
+    constexpr float SPAWN_CHANGE_STEPS = float(ENTITY_STREAM_STEPS_PER_CELL) * 4.0f;
+    
+    size_t writeVarint(uint8_t* out, uint64_t value) {
+        size_t size = 0;
+        while (value >= 0x80) {
+            out[size++] = static_cast<uint8_t>(value | 0x80);
+            value >>= 7;
+        }
+        out[size++] = static_cast<uint8_t>(value);
+        return size;
+    }
+    
+    uint64_t zigzag(int64_t value) {
+        return (static_cast<uint64_t>(value) << 1) ^ static_cast<uint64_t>(value >> 63);
+    }
+    
+    uint32_t varintSize(uint64_t value) {
+        uint32_t size = 1;
+        while (value >= 0x80) {
+            value >>= 7;
+            ++size;
+        }
+        return size;
+    }
+    
+    std::string formatAddress(uint32_t address, uint16_t port) {
+        in_addr ip{};
+        ip.s_addr = address;
+        char text[INET_ADDRSTRLEN] = {};
+        inet_ntop(AF_INET, &ip, text, sizeof(text));
+        return std::string(text) + ":" + std::to_string(ntohs(port));
+    }
+}
+
+EntityStreamServer::~EntityStreamServer() {
+    close();
+}
+
+bool EntityStreamServer::open(uint16_t port, uint32_t interval, uint32_t budgetBytes) {
+    close();
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "EntityStreamServer: WSAStartup failed" << std::endl;
+        return false;
+    }
+#endif
+    socketHandle = static_cast<intptr_t>(socket(AF_INET, SOCK_DGRAM, IPPROTO_UDP));
+    if (socketHandle != INVALID_SOCKET_HANDLE) {
+        int reuse = 1;
+        setsockopt(toNative(socketHandle), SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+        // Room for a few clients' full budgets, so a snapshot leaves in one burst
+        int sendBuffer = static_cast<int>(std::min<uint64_t>(uint64_t(budgetBytes) * ENTITY_STREAM_MAX_CLIENTS * 2, 16 * MEGABYTE));
+        setsockopt(toNative(socketHandle), SOL_SOCKET, SO_SNDBUF, reinterpret_cast<const char*>(&sendBuffer), sizeof(sendBuffer));
+        
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+        bool ready = bind(toNative(socketHandle), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) == 0;
+        // The sender drains client messages between snapshots and must never block on an empty socket
+#ifdef _WIN32
+        u_long nonBlocking = 1;
+        ready = ready && ioctlsocket(toNative(socketHandle), FIONBIO, &nonBlocking) == 0;
+#else
+        ready = ready && fcntl(toNative(socketHandle), F_SETFL, fcntl(toNative(socketHandle), F_GETFL, 0) | O_NONBLOCK) == 0;
+#endif
+        if (!ready) {
+            closeSocket();
+        }
+    }
+    if (socketHandle == INVALID_SOCKET_HANDLE) {
+        std::cerr << "EntityStreamServer: Failed to bind UDP port " << port << std::endl;
+#ifdef _WIN32
+        WSACleanup();
+#endif
+        return false;
+    }
+    
+    // The cap keeps a snapshot's datagrams countable in the 16-bit fragment count
+    this->interval = std::max(1u, interval);
+    this->budgetBytes = std::clamp<uint32_t>(budgetBytes, ENTITY_STREAM_DATAGRAM_BYTES, ENTITY_STREAM_MAX_BUDGET_BYTES);
+    startTime = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < ENTITY_STREAM_QUEUE_DEPTH; ++i) {
+        freeSnapshots.push_back(std::make_unique<Snapshot>());
+    }
+    sequence = 0;
+    hasSnapshot = false;
+    sending = false;
+    enabled = true;
+    
+    std::cout << "EntityStreamServer: Streaming every " << this->interval << " frames on UDP port " << port
+              << ", " << this->budgetBytes / 1024 << " KB per client snapshot" << std::endl;
+    return true;
+}
+
+void EntityStreamServer::close() {
+    if (!enabled) return;
+    
+    abortSnapshot();
+    JobSystem::getInstance().wait(sendJobs, JobPriority::Low);
+    closeSocket();
+#ifdef _WIN32
+    WSACleanup();
+#endif
+
+    queued.clear();
+    freeSnapshots.clear();
+    clients.clear();
+    clientCount = 0;
+    current.clear();
+    current.shrink_to_fit();
+    candidates.clear();
+    candidates.shrink_to_fit();
+    datagrams.clear();
+    enabled = false;
+    
+    const Telemetry totals = getTelemetry();
+    std::cout << "EntityStreamServer: Sent " << totals.snapshotsSent << " snapshots (" << totals.snapshotsDropped
+              << " dropped) as " << totals.datagramsSent << " datagrams (" << totals.sendFailures << " failed), "
+              << totals.bytesSent / MEGABYTE << " MB, " << totals.entriesDeferred << " changes deferred" << std::endl;
+}
+
+void EntityStreamServer::closeSocket() {
+    if (socketHandle != INVALID_SOCKET_HANDLE) {
+#ifdef _WIN32
+        closesocket(toNative(socketHandle));
+#else
+        ::close(toNative(socketHandle));
+#endif
+        socketHandle = INVALID_SOCKET_HANDLE;
+    }
+}
+
+bool EntityStreamServer::isSnapshotDue(uint32_t frame) const {
+    return enabled && !building && (!hasSnapshot || frame - lastSnapshotFrame >= interval);
+}
+
+bool EntityStreamServer::beginSnapshot(uint32_t frame, uint32_t count, uint64_t bufferGeneration, float cellSize) {
+    // The interval restarts either way, so a slow sender sheds whole snapshots instead of retrying every frame
+    lastSnapshotFrame = frame;
+    hasSnapshot = true;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (freeSnapshots.empty()) {
+            ++snapshotsDropped;
+            return false;
+        }
+        building = std::move(freeSnapshots.back());
+        freeSnapshots.pop_back();
+    }
+    
+    building->frame = frame;
+    building->timeMs = static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::steady_clock::now() - startTime).count());
+    building->count = count;
+    building->cellSize = cellSize;
+    building->positions.resize(count);
+    building->spawnIds.resize(count);
+    snapshotGeneration = bufferGeneration;
+    ++snapshotId;
+    outstanding = 0;
+    snapshotFailed = false;
+    return true;
+}
+
+void EntityStreamServer::storeChunk(uint32_t snapshot, uint32_t stream, uint64_t offset, const void* data, uint64_t size) {
+    if (snapshot != snapshotId || !building) return;
+    
+    uint8_t* destination = stream == 0 ? reinterpret_cast<uint8_t*>(building->positions.data())
+                                       : reinterpret_cast<uint8_t*>(building->spawnIds.data());
+    const uint64_t streamSize = stream == 0 ? building->positions.size() * sizeof(glm::vec4)
+                                            : building->spawnIds.size() * sizeof(uint32_t);
+    if (!data || offset + size > streamSize) {
+        snapshotFailed = true;
+    } else {
+        std::memcpy(destination + offset, data, size);
+    }
+    completeRequest();
+}
+
+void EntityStreamServer::completeRequest() {
+    if (outstanding > 0 && --outstanding > 0) return;
+    
+    std::unique_ptr<Snapshot> snapshot = std::move(building);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (snapshotFailed) {
+            ++snapshotsDropped;
+            freeSnapshots.push_back(std::move(snapshot));
+            return;
+        }
+        queued.push_back(std::move(snapshot));
+        if (sending) return;  // The running job picks it up
+        sending = true;
+    }
+    JobSystem::getInstance().submit([this]() { sendQueued(); }, JobPriority::Low, &sendJobs);
+}
+
+void EntityStreamServer::abortSnapshot() {
+    if (!building) return;
+    
+    ++snapshotId;  // Results still in the ring belong to the aborted snapshot
+    outstanding = 0;
+    std::lock_guard<std::mutex> lock(queueMutex);
+    ++snapshotsDropped;
+    freeSnapshots.push_back(std::move(building));
+}
+
+EntityStreamServer::Telemetry EntityStreamServer::getTelemetry() const {
+    Telemetry telemetry;
+    telemetry.snapshotsSent = snapshotsSent.load();
+    telemetry.snapshotsDropped = snapshotsDropped.load();
+    telemetry.datagramsSent = datagramsSent.load();
+    telemetry.sendFailures = sendFailures.load();
+    telemetry.bytesSent = bytesSent.load();
+    telemetry.entriesSent = entriesSent.load();
+    telemetry.entriesDeferred = entriesDeferred.load();
+    telemetry.clients = clientCount.load();
+    return telemetry;
+}
+
+void EntityStreamServer::sendQueued() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (!queued.empty()) {
+        std::unique_ptr<Snapshot> snapshot = std::move(queued.front());
+        queued.pop_front();
+        lock.unlock();
+        sendSnapshot(*snapshot);
+        lock.lock();
+        freeSnapshots.push_back(std::move(snapshot));
+    }
+    sending = false;
+}
+
+void EntityStreamServer::sendSnapshot(const Snapshot& snapshot) {
+    receiveMessages();
+    ++sequence;
+    ++snapshotsSent;
+    if (clients.empty()) return;
+    
+    // Tombstones (w = 0), slots without a spawn ID and anything not finite are empty
+    const float quantum = snapshot.cellSize / float(ENTITY_STREAM_STEPS_PER_CELL);
+    current.resize(snapshot.count);
+    for (uint32_t slot = 0; slot < snapshot.count; ++slot) {
+        const glm::vec4& position = snapshot.positions[slot];
+        SlotState& state = current[slot];
+        if (position.w == 0.0f || snapshot.spawnIds[slot] == ABSENT || !std::isfinite(position.x) || !std::isfinite(position.y)) {
+            state = SlotState{};
+            continue;
+        }
+        state.spawnId = snapshot.spawnIds[slot];
+        state.steps = glm::ivec2(static_cast<int>(std::clamp(std::round(double(position.x) / quantum), -MAX_STEPS, MAX_STEPS)),
+                                 static_cast<int>(std::clamp(std::round(double(position.y) / quantum), -MAX_STEPS, MAX_STEPS)));
+    }
+    
+    for (auto& client : clients) {
+        sendToClient(*client, snapshot, quantum);
+    }
+}
+
+void EntityStreamServer::resetClient(Client& client, float quantum) const {
+    client.quantum = quantum;
+    client.confirmedSequence = 0;
+    std::fill(client.view.begin(), client.view.end(), SlotState{});
+    // A late ACK of a sequence sent before the reset must not be applied to the empty view
+    for (SentRecord& record : client.sent) {
+        record.sequence = 0;
+        record.entries.clear();
+    }
+}
+
+void EntityStreamServer::sendToClient(Client& client, const Snapshot& snapshot, float quantum) {
+    if (client.quantum != quantum) {
+        resetClient(client, quantum);  // The grid changed its cell size; steps of the old one mean nothing
+    }
+    const uint32_t slots = std::max<uint32_t>(snapshot.count, static_cast<uint32_t>(client.view.size()));
+    client.view.resize(slots);
+    
+    // Every slot that differs from what the client holds, ranked by how far it moved and how near the focus it is
+    const glm::vec2 focusSteps = client.focus / quantum;
+    const float falloffSteps = ENTITY_STREAM_FOCUS_FALLOFF_CELLS * float(ENTITY_STREAM_STEPS_PER_CELL);
+    uint64_t totalBytes = 0;
+    candidates.clear();
+    for (uint32_t slot = 0; slot < slots; ++slot) {
+        const SlotState now = slot < snapshot.count ? current[slot] : SlotState{};
+        const SlotState& held = client.view[slot];
+        Candidate candidate;
+        candidate.slot = slot;
+        float change = SPAWN_CHANGE_STEPS;
+        if (now.spawnId == ABSENT) {
+            if (held.spawnId == ABSENT) continue;
+            candidate.kind = ENTRY_REMOVE;
+            candidate.bytes = 2;
+        } else if (now.spawnId != held.spawnId) {
+            candidate.kind = ENTRY_SPAWN;
+            candidate.bytes = 2 + varintSize(now.spawnId) + varintSize(zigzag(now.steps.x)) + varintSize(zigzag(now.steps.y));
+        } else {
+            const glm::ivec2 delta = now.steps - held.steps;
+            if (delta == glm::ivec2(0)) continue;
+            candidate.kind = ENTRY_MOVE;
+            candidate.bytes = 2 + varintSize(zigzag(delta.x)) + varintSize(zigzag(delta.y));
+            change = float(std::max(std::abs(delta.x), std::abs(delta.y)));
+        }
+        if (client.hasFocus) {
+            const glm::ivec2 at = candidate.kind == ENTRY_REMOVE ? held.steps : now.steps;
+            change /= 1.0f + glm::length(glm::vec2(at) - focusSteps) / falloffSteps;
+        }
+        candidate.score = change;
+        totalBytes += candidate.bytes;
+        candidates.push_back(candidate);
+    }
+    
+    if (totalBytes > budgetBytes) {
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) {
+            return a.score != b.score ? a.score > b.score : a.slot < b.slot;
+        });
+        uint64_t usedBytes = 0;
+        size_t taken = 0;
+        while (taken < candidates.size() && usedBytes + candidates[taken].bytes <= budgetBytes) {
+            usedBytes += candidates[taken++].bytes;
+        }
+        entriesDeferred += candidates.size() - taken;
+        candidates.resize(taken);
+        std::sort(candidates.begin(), candidates.end(), [](const Candidate& a, const Candidate& b) { return a.slot < b.slot; });
+    }
+    
+    SentRecord& record = client.sent[sequence % ENTITY_STREAM_ACK_WINDOW];
+    record.sequence = sequence;
+    record.baseSequence = client.confirmedSequence;
+    record.entries.clear();
+    
+    SnapshotHeader header;
+    header.sequence = sequence;
+    header.baseSequence = client.confirmedSequence;
+    header.frame = snapshot.frame;
+    header.timeMs = snapshot.timeMs;
+    header.entityCount = snapshot.count;
+    header.quantum = quantum;
+    
+    // Datagrams are filled in slot order; each restarts the slot gaps, so every one decodes without the others
+    size_t datagramCount = 0;
+    uint32_t previousSlot = 0;
+    auto finishDatagram = [&]() {
+        header.fragment = static_cast<uint16_t>(datagramCount - 1);
+        std::memcpy(datagrams[datagramCount - 1].data(), &header, sizeof(header));
+        header.entryCount = 0;
+    };
+    auto startDatagram = [&]() {
+        if (datagramCount > 0) {
+            finishDatagram();
+        }
+        if (datagrams.size() <= datagramCount) {
+            datagrams.emplace_back();
+            datagrams.back().reserve(ENTITY_STREAM_DATAGRAM_BYTES);
+        }
+        datagrams[datagramCount++].assign(sizeof(SnapshotHeader), 0);
+        previousSlot = 0;
+    };
+    startDatagram();
+    for (const Candidate& candidate : candidates) {
+        const SlotState now = candidate.slot < snapshot.count ? current[candidate.slot] : SlotState{};
+        std::array<uint8_t, 32> entry;
+        size_t size = 0;
+        auto encode = [&]() {
+            size = writeVarint(entry.data(), (uint64_t(candidate.slot - previousSlot) << 2) | candidate.kind);
+            if (candidate.kind == ENTRY_SPAWN) {
+                size += writeVarint(entry.data() + size, now.spawnId);
+                size += writeVarint(entry.data() + size, zigzag(now.steps.x));
+                size += writeVarint(entry.data() + size, zigzag(now.steps.y));
+            } else if (candidate.kind == ENTRY_MOVE) {
+                const glm::ivec2 delta = now.steps - client.view[candidate.slot].steps;
+                size += writeVarint(entry.data() + size, zigzag(delta.x));
+                size += writeVarint(entry.data() + size, zigzag(delta.y));
+            }
+        };
+        encode();
+        if (datagrams[datagramCount - 1].size() + size > ENTITY_STREAM_DATAGRAM_BYTES) {
+            startDatagram();
+            encode();
+        }
+        std::vector<uint8_t>& datagram = datagrams[datagramCount - 1];
+        datagram.insert(datagram.end(), entry.begin(), entry.begin() + size);
+        ++header.entryCount;
+        previousSlot = candidate.slot;
+        record.entries.push_back({candidate.slot, now});
+    }
+    finishDatagram();
+    entriesSent += candidates.size();
+    
+    // The fragment count is only known now
+    const uint16_t fragmentCount = static_cast<uint16_t>(datagramCount);
+    sockaddr_in destination{};
+    destination.sin_family = AF_INET;
+    destination.sin_addr.s_addr = client.address;
+    destination.sin_port = client.port;
+    for (size_t i = 0; i < datagramCount; ++i) {
+        std::vector<uint8_t>& datagram = datagrams[i];
+        std::memcpy(datagram.data() + offsetof(SnapshotHeader, fragmentCount), &fragmentCount, sizeof(fragmentCount));
+        const auto sent = sendto(toNative(socketHandle), reinterpret_cast<const char*>(datagram.data()), static_cast<int>(datagram.size()), 0,
+                                 reinterpret_cast<const sockaddr*>(&destination), sizeof(destination));
+        if (sent < 0) {
+            ++sendFailures;  // A full send buffer; the changes go again with the next snapshot
+            continue;
+        }
+        ++datagramsSent;
+        bytesSent += static_cast<uint64_t>(sent);
+    }
+}
+
+void EntityStreamServer::receiveMessages() {
+    for (;;) {
+        ClientMessage message;
+        sockaddr_in source{};
+#ifdef _WIN32
+        int sourceSize = sizeof(source);
+#else
+        socklen_t sourceSize = sizeof(source);
+#endif
+        const auto received = recvfrom(toNative(socketHandle), reinterpret_cast<char*>(&message), sizeof(message), 0,
+                                       reinterpret_cast<sockaddr*>(&source), &sourceSize);
+        if (received < 0) {
+            break;  // Drained, or an ICMP error from a departed client
+        }
+        if (static_cast<size_t>(received) == sizeof(message) && message.magic == ClientMessage::MAGIC) {
+            handleMessage(message, source.sin_addr.s_addr, source.sin_port);
+        }
+    }
+    
+    const auto now = std::chrono::steady_clock::now();
+    const auto timeout = std::chrono::milliseconds(ENTITY_STREAM_CLIENT_TIMEOUT_MS);
+    auto silent = std::remove_if(clients.begin(), clients.end(), [&](const std::unique_ptr<Client>& client) {
+        if (now - client->lastHeard < timeout) return false;
+        std::cout << "EntityStreamServer: Client " << formatAddress(client->address, client->port) << " timed out" << std::endl;
+        return true;
+    });
+    clients.erase(silent, clients.end());
+    clientCount = static_cast<uint32_t>(clients.size());
+}
+
+void EntityStreamServer::handleMessage(const ClientMessage& message, uint32_t address, uint16_t port) {
+    auto found = std::find_if(clients.begin(), clients.end(), [&](const std::unique_ptr<Client>& client) {
+        return client->address == address && client->port == port;
+    });
+    if (message.type == ClientMessage::BYE) {
+        if (found != clients.end()) {
+            std::cout << "EntityStreamServer: Client " << formatAddress(address, port) << " left" << std::endl;
+            clients.erase(found);
+        }
+        return;
+    }
+    
+    Client* client = found != clients.end() ? found->get() : nullptr;
+    if (!client) {
+        // An ACK from an unknown address joins too: the server restarted under a running client
+        if (clients.size() >= ENTITY_STREAM_MAX_CLIENTS) return;
+        clients.push_back(std::make_unique<Client>());
+        client = clients.back().get();
+        client->address = address;
+        client->port = port;
+        std::cout << "EntityStreamServer: Client " << formatAddress(address, port) << " joined" << std::endl;
+    } else if (message.type == ClientMessage::HELLO) {
+        resetClient(*client, client->quantum);
+    }
+    
+    client->lastHeard = std::chrono::steady_clock::now();
+    client->hasFocus = std::isfinite(message.focusX) && std::isfinite(message.focusY);
+    if (client->hasFocus) {
+        client->focus = glm::vec2(message.focusX, message.focusY);
+    }
+    
+    // Only a sequence built on the view the server holds moves it on; later ones based on the same view are
+    // then stale, and the client acknowledges one of the newer snapshots instead
+    if (message.type == ClientMessage::ACK && message.sequence != 0) {
+        SentRecord& record = client->sent[message.sequence % ENTITY_STREAM_ACK_WINDOW];
+        if (record.sequence == message.sequence && record.baseSequence == client->confirmedSequence) {
+            for (const SentEntry& entry : record.entries) {
+                if (entry.slot < client->view.size()) {
+                    client->view[entry.slot] = entry.state;
+                }
+            }
+            client->confirmedSequence = message.sequence;
+        }
+    }
+}
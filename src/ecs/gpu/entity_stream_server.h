@@ -0,0 +1,209 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <vector>
+#include <glm/glm.hpp>
+#include "../utilities/job_system.h"
+#include "../../vulkan/core/vulkan_constants.h"
+
+/**
+ * Streams entity positions to remote viewers over UDP (--stream-port), so a display client renders the swarm
+ * without running a simulation of its own. Snapshots are taken every N frames the way EntityTelemetryCapture
+ * takes captures: EntityBufferManager queues the live range of positions and spawn IDs through the streaming
+ * ReadbackRing, and a Low-priority JobSystem job, one at a time, quantizes and sends each finished snapshot.
+ * A snapshot finding no free buffer is dropped rather than stalling the render thread.
+ *
+ * Positions are quantized to ENTITY_STREAM_STEPS_PER_CELL steps per spatial grid cell. Each client's snapshot is
+ * delta-encoded against the last one it acknowledged, so a moving entity costs a couple of bytes, a resting one
+ * nothing, and a lost datagram only delays a change to the next snapshot. Every snapshot is capped at the
+ * client's byte budget: changes are ranked by how far the entity moved, weighted towards the focus point the
+ * client reports, and the rest wait. They grow in priority as they stay unsent, and the server tracks exactly
+ * what each client has been sent, so a deferred change is never lost.
+ *
+ * Protocol, little-endian. A client sends ClientMessage datagrams to the port: HELLO to join (again to start
+ * over), ACK with a sequence once every fragment of it arrived, BYE to leave; a client heard from neither in
+ * ENTITY_STREAM_CLIENT_TIMEOUT_MS is dropped. The server answers each snapshot sequence with fragmentCount
+ * datagrams of at most ENTITY_STREAM_DATAGRAM_BYTES, each a SnapshotHeader and entryCount entries that decode on
+ * their own. A snapshot applies to the client's state at baseSequence (0: the empty state) and yields its state
+ * at sequence; clients keep their last ENTITY_STREAM_ACK_WINDOW states, since snapshots based on older ones
+ * arrive until the server sees an ACK. Entry: varint((slot - previous slot in the datagram) << 2 | kind), the
+ * first slot counted from 0, then
+ *   MOVE   zigzag varint dx, dy in steps from the base position
+ *   SPAWN  varint spawn ID, zigzag varint x, y in steps: a new entity in the slot, replacing any before it
+ *   REMOVE nothing: the slot is now empty
+ * Slots missing from a snapshot keep their base state. World position = steps * quantum; timeMs stamps the
+ * snapshot so clients can interpolate between the two latest states.
+ */
+class EntityStreamServer {
+public:
+    enum EntryKind : uint32_t {
+        ENTRY_MOVE = 0,
+        ENTRY_SPAWN = 1,
+        ENTRY_REMOVE = 2,
+    };
+    
+    struct SnapshotHeader {
+        static constexpr uint32_t MAGIC = 0x52545345;  // "ESTR"
+        static constexpr uint16_t VERSION = 1;
+        uint32_t magic = MAGIC;
+        uint16_t version = VERSION;
+        uint16_t fragment = 0;          // Index of this datagram in the snapshot
+        uint16_t fragmentCount = 0;
+        uint16_t entryCount = 0;        // Entries in this datagram
+        uint32_t sequence = 0;          // Counts from 1
+        uint32_t baseSequence = 0;
+        uint32_t frame = 0;             // Renderer frame the snapshot was taken in
+        uint32_t timeMs = 0;            // Milliseconds since the server started
+        uint32_t entityCount = 0;       // Slots the snapshot covers; slots past it are empty
+        float quantum = 0.0f;           // World units per step; a change comes with baseSequence 0
+    };
+    static_assert(sizeof(SnapshotHeader) == 36);
+    
+    struct ClientMessage {
+        static constexpr uint32_t MAGIC = 0x43545345;  // "ESTC"
+        enum Type : uint32_t { HELLO = 1, ACK = 2, BYE = 3 };
+        uint32_t magic = MAGIC;
+        uint32_t type = HELLO;
+        uint32_t sequence = 0;          // ACK: the completed sequence
+        float focusX = 0.0f;            // World point the viewer looks at; NaN for none
+        float focusY = 0.0f;
+    };
+    
+    EntityStreamServer() = default;
+    ~EntityStreamServer();
+    EntityStreamServer(const EntityStreamServer&) = delete;
+    EntityStreamServer& operator=(const EntityStreamServer&) = delete;
+    
+    // Binds port on all interfaces; budgetBytes caps each client's snapshot
+    bool open(uint16_t port, uint32_t interval, uint32_t budgetBytes);
+    // Sends every finished snapshot and reports the totals; an unfinished one is dropped
+    void close();
+    
+    bool isEnabled() const { return enabled; }
+    
+    // Snapshot bookkeeping for EntityBufferManager, on the render thread, as EntityTelemetryCapture's
+    bool isSnapshotDue(uint32_t frame) const;
+    bool beginSnapshot(uint32_t frame, uint32_t count, uint64_t bufferGeneration, float cellSize);  // False when no buffer is free
+    bool isTakingSnapshot() const { return building != nullptr; }
+    uint64_t getSnapshotGeneration() const { return snapshotGeneration; }
+    uint32_t getSnapshotId() const { return snapshotId; }
+    void addOutstanding() { ++outstanding; }
+    
+    // Readback result of [offset, offset + size) of the positions (stream 0) or spawn IDs (stream 1); data is
+    // nullptr for a cancelled request, which drops the snapshot
+    void storeChunk(uint32_t snapshot, uint32_t stream, uint64_t offset, const void* data, uint64_t size);
+    void abortSnapshot();
+    
+    struct Telemetry {
+        uint64_t snapshotsSent = 0;     // Snapshots encoded, whether or not a client was connected
+        uint64_t snapshotsDropped = 0;  // Sender behind, or the readback was cancelled
+        uint64_t datagramsSent = 0;
+        uint64_t sendFailures = 0;
+        uint64_t bytesSent = 0;
+        uint64_t entriesSent = 0;
+        uint64_t entriesDeferred = 0;   // Changes left to a later snapshot by the budget
+        uint32_t clients = 0;
+    };
+    Telemetry getTelemetry() const;
+
+private:
+    static constexpr uint32_t ABSENT = UINT32_MAX;  // Spawn ID of an empty slot
+    
+    struct Snapshot {
+        uint32_t frame = 0;
+        uint32_t timeMs = 0;
+        uint32_t count = 0;
+        float cellSize = 0.0f;
+        std::vector<glm::vec4> positions;
+        std::vector<uint32_t> spawnIds;
+    };
+    
+    struct SlotState {
+        uint32_t spawnId = ABSENT;
+        glm::ivec2 steps{0};
+    };
+    
+    struct SentEntry {
+        uint32_t slot = 0;
+        SlotState state;
+    };
+    
+    // Entries of one sent sequence, applied to the client's view when it is acknowledged
+    struct SentRecord {
+        uint32_t sequence = 0;          // 0: unused
+        uint32_t baseSequence = 0;
+        std::vector<SentEntry> entries;
+    };
+    
+    struct Client {
+        uint32_t address = 0;           // IPv4, network order
+        uint16_t port = 0;              // Network order
+        std::chrono::steady_clock::time_point lastHeard;
+        glm::vec2 focus{0.0f};
+        bool hasFocus = false;
+        float quantum = 0.0f;           // Of the view; a change resets the client
+        uint32_t confirmedSequence = 0; // Sequence the view holds, 0 for the empty state
+        std::vector<SlotState> view;    // What the client holds at confirmedSequence
+        std::array<SentRecord, ENTITY_STREAM_ACK_WINDOW> sent;
+    };
+    
+    struct Candidate {
+        uint32_t slot = 0;
+        uint32_t kind = ENTRY_MOVE;
+        uint32_t bytes = 0;             // Encoded size, counting a two byte slot gap
+        float score = 0.0f;
+    };
+    
+    void completeRequest();
+    void sendQueued();
+    void sendSnapshot(const Snapshot& snapshot);
+    void receiveMessages();
+    void handleMessage(const ClientMessage& message, uint32_t address, uint16_t port);
+    void resetClient(Client& client, float quantum) const;
+    void sendToClient(Client& client, const Snapshot& snapshot, float quantum);
+    void closeSocket();
+    
+    bool enabled = false;
+    uint32_t interval = 1;
+    uint32_t budgetBytes = 0;
+    std::chrono::steady_clock::time_point startTime;
+    
+    // Snapshot in progress, render thread only
+    std::unique_ptr<Snapshot> building;
+    uint64_t snapshotGeneration = 0;
+    uint32_t snapshotId = 0;
+    uint32_t outstanding = 0;
+    uint32_t lastSnapshotFrame = 0;
+    bool hasSnapshot = false;
+    bool snapshotFailed = false;
+    
+    // Handoff to the sender, cycling like EntityTelemetryCapture's captures
+    std::mutex queueMutex;
+    std::deque<std::unique_ptr<Snapshot>> queued;
+    std::vector<std::unique_ptr<Snapshot>> freeSnapshots;
+    bool sending = false;  // A sendQueued() job is queued or running
+    JobCounter sendJobs;
+    
+    // Sender job only, apart from open and close
+    intptr_t socketHandle = -1;  // INVALID_SOCKET and -1 both map to -1
+    std::vector<std::unique_ptr<Client>> clients;
+    uint32_t sequence = 0;
+    std::vector<SlotState> current;          // The snapshot in steps
+    std::vector<Candidate> candidates;
+    std::vector<std::vector<uint8_t>> datagrams;
+    
+    std::atomic<uint64_t> snapshotsSent{0};
+    std::atomic<uint64_t> snapshotsDropped{0};
+    std::atomic<uint64_t> datagramsSent{0};
+    std::atomic<uint64_t> sendFailures{0};
+    std::atomic<uint64_t> bytesSent{0};
+    std::atomic<uint64_t> entriesSent{0};
+    std::atomic<uint64_t> entriesDeferred{0};
+    std::atomic<uint32_t> clientCount{0};
+};
@@ -0,0 +1,242 @@
+#include "entity_telemetry_capture.h"
+#include "../../vulkan/core/vulkan_constants.h"
+#include <iostream>
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // Byte planes of the words XORed with the delta base, so slowly changing floats leave their sign, exponent
+    // and high mantissa planes mostly zero
+    void splitDeltaPlanes(const std::vector<uint8_t>& raw, const std::vector<uint8_t>* base, std::vector<uint8_t>& planes) {
+        const size_t words = raw.size() / 4;
+        const size_t baseWords = base ? std::min(base->size(), raw.size()) / 4 : 0;
+        planes.resize(words * 4);
+        for (size_t word = 0; word < words; ++word) {
+            for (size_t byte = 0; byte < 4; ++byte) {
+                uint8_t value = raw[word * 4 + byte];
+                if (word < baseWords) {
+                    value ^= (*base)[word * 4 + byte];
+                }
+                planes[byte * words + word] = value;
+            }
+        }
+    }
+    
+    void appendZeroRunLength(const std::vector<uint8_t>& data, std::vector<uint8_t>& out) {
+        constexpr size_t MAX_RUN = 128;
+        const size_t size = data.size();
+        size_t i = 0;
+        while (i < size) {
+            size_t zeros = 0;
+            while (i + zeros < size && zeros < MAX_RUN && data[i + zeros] == 0) {
+                ++zeros;
+            }
+            if (zeros >= 2) {
+                out.push_back(static_cast<uint8_t>(0x80 | (zeros - 1)));
+                i += zeros;
+                continue;
+            }
+            
+            // Literals up to the next pair of zeros, which is worth a zero run
+            const size_t start = i;
+            while (i < size && i - start < MAX_RUN && !(data[i] == 0 && i + 1 < size && data[i + 1] == 0)) {
+                ++i;
+            }
+            out.push_back(static_cast<uint8_t>(i - start - 1));
+            out.insert(out.end(), data.begin() + start, data.begin() + i);
+        }
+    }
+}
+
+EntityTelemetryCapture::~EntityTelemetryCapture() {
+    close();
+}
+
+bool EntityTelemetryCapture::open(const std::string& path, uint32_t streams, uint32_t interval,
+                                  const std::array<uint32_t, STREAM_COUNT>& elementSizes) {
+    close();
+    if ((streams & ((1u << STREAM_COUNT) - 1)) == 0) {
+        std::cerr << "EntityTelemetryCapture: No streams selected" << std::endl;
+        return false;
+    }
+    
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "EntityTelemetryCapture: Failed to open " << path << std::endl;
+        return false;
+    }
+    
+    this->streams = streams & ((1u << STREAM_COUNT) - 1);
+    this->interval = std::max(1u, interval);
+    this->elementSizes = elementSizes;
+    
+    FileHeader header;
+    header.streams = this->streams;
+    header.interval = this->interval;
+    header.keyframeInterval = TELEMETRY_CAPTURE_KEYFRAME_INTERVAL;
+    file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+    
+    for (uint32_t i = 0; i < TELEMETRY_CAPTURE_QUEUE_DEPTH; ++i) {
+        freeCaptures.push_back(std::make_unique<Capture>());
+    }
+    recordsSinceKeyframe = 0;
+    hasCaptured = false;
+    writing = false;
+    enabled = true;
+    
+    std::cout << "EntityTelemetryCapture: Capturing every " << this->interval << " frames to " << path << std::endl;
+    return true;
+}
+
+void EntityTelemetryCapture::close() {
+    if (!enabled) return;
+    
+    abortCapture();
+    JobSystem::getInstance().wait(writeJobs, JobPriority::Low);
+    file.close();
+    
+    queued.clear();
+    freeCaptures.clear();
+    for (auto& stream : previous) {
+        stream.clear();
+        stream.shrink_to_fit();
+    }
+    enabled = false;
+    
+    const Telemetry totals = getTelemetry();
+    std::cout << "EntityTelemetryCapture: Wrote " << totals.capturesWritten << " captures (" << totals.capturesDropped
+              << " dropped), " << totals.rawBytes / MEGABYTE << " MB encoded to " << totals.encodedBytes / MEGABYTE << " MB" << std::endl;
+}
+
+bool EntityTelemetryCapture::isCaptureDue(uint32_t frame) const {
+    return enabled && !building && (!hasCaptured || frame - lastCaptureFrame >= interval);
+}
+
+bool EntityTelemetryCapture::beginCapture(uint32_t frame, uint32_t count, uint64_t bufferGeneration) {
+    // The interval restarts either way, so a slow writer sheds whole captures instead of retrying every frame
+    lastCaptureFrame = frame;
+    hasCaptured = true;
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (freeCaptures.empty()) {
+            ++capturesDropped;
+            return false;
+        }
+        building = std::move(freeCaptures.back());
+        freeCaptures.pop_back();
+    }
+    
+    building->frame = frame;
+    building->count = count;
+    for (uint32_t stream = 0; stream < STREAM_COUNT; ++stream) {
+        building->streams[stream].resize((streams & (1u << stream)) ? size_t(count) * elementSizes[stream] : 0);
+    }
+    captureGeneration = bufferGeneration;
+    ++captureId;
+    outstanding = 0;
+    captureFailed = false;
+    return true;
+}
+
+void EntityTelemetryCapture::storeChunk(uint32_t capture, uint32_t streamIndex, uint64_t offset, const void* data, uint64_t size) {
+    if (capture != captureId || !building) return;
+    
+    std::vector<uint8_t>& stream = building->streams[streamIndex];
+    if (!data || offset + size > stream.size()) {
+        captureFailed = true;
+    } else {
+        std::memcpy(stream.data() + offset, data, size);
+    }
+    completeRequest();
+}
+
+void EntityTelemetryCapture::completeRequest() {
+    if (outstanding > 0 && --outstanding > 0) return;
+    
+    std::unique_ptr<Capture> capture = std::move(building);
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        if (captureFailed) {
+            ++capturesDropped;
+            freeCaptures.push_back(std::move(capture));
+            return;
+        }
+        queued.push_back(std::move(capture));
+        if (writing) return;  // The running job picks it up
+        writing = true;
+    }
+    JobSystem::getInstance().submit([this]() { writeQueued(); }, JobPriority::Low, &writeJobs);
+}
+
+void EntityTelemetryCapture::abortCapture() {
+    if (!building) return;
+    
+    ++captureId;  // Results still in the ring belong to the aborted capture
+    outstanding = 0;
+    std::lock_guard<std::mutex> lock(queueMutex);
+    ++capturesDropped;
+    freeCaptures.push_back(std::move(building));
+}
+
+EntityTelemetryCapture::Telemetry EntityTelemetryCapture::getTelemetry() const {
+    Telemetry telemetry;
+    telemetry.capturesWritten = capturesWritten.load();
+    telemetry.capturesDropped = capturesDropped.load();
+    telemetry.rawBytes = rawBytes.load();
+    telemetry.encodedBytes = encodedBytes.load();
+    return telemetry;
+}
+
+void EntityTelemetryCapture::writeQueued() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (!queued.empty()) {
+        std::unique_ptr<Capture> capture = std::move(queued.front());
+        queued.pop_front();
+        lock.unlock();
+        writeRecord(*capture);
+        lock.lock();
+        freeCaptures.push_back(std::move(capture));
+    }
+    writing = false;
+}
+
+void EntityTelemetryCapture::writeRecord(const Capture& capture) {
+    const bool keyframe = recordsSinceKeyframe == 0;
+    recordsSinceKeyframe = (recordsSinceKeyframe + 1) % TELEMETRY_CAPTURE_KEYFRAME_INTERVAL;
+    
+    RecordHeader record;
+    record.frame = capture.frame;
+    record.entityCount = capture.count;
+    record.flags = keyframe ? RecordHeader::FLAG_KEYFRAME : 0;
+    for (uint32_t stream = 0; stream < STREAM_COUNT; ++stream) {
+        record.streamCount += (streams & (1u << stream)) ? 1 : 0;
+    }
+    file.write(reinterpret_cast<const char*>(&record), sizeof(record));
+    
+    for (uint32_t stream = 0; stream < STREAM_COUNT; ++stream) {
+        if (!(streams & (1u << stream))) continue;
+        
+        const std::vector<uint8_t>& raw = capture.streams[stream];
+        splitDeltaPlanes(raw, keyframe ? nullptr : &previous[stream], planes);
+        encoded.clear();
+        appendZeroRunLength(planes, encoded);
+        
+        StreamHeader header;
+        header.stream = 1u << stream;
+        header.elementSize = elementSizes[stream];
+        header.rawSize = raw.size();
+        header.encodedSize = encoded.size();
+        file.write(reinterpret_cast<const char*>(&header), sizeof(header));
+        file.write(reinterpret_cast<const char*>(encoded.data()), static_cast<std::streamsize>(encoded.size()));
+        
+        previous[stream].assign(raw.begin(), raw.end());
+        rawBytes += raw.size();
+        encodedBytes += encoded.size();
+    }
+    
+    if (!file) {
+        std::cerr << "EntityTelemetryCapture: Write failed at frame " << capture.frame << std::endl;
+        file.clear();
+    }
+    ++capturesWritten;
+}
@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "../utilities/job_system.h"
+
+/**
+ * Streams selected entity SoA streams to disk every N frames for offline analysis. EntityBufferManager queues
+ * each capture's chunks through the streaming ReadbackRing, so the copies ride in the frame's compute work and
+ * nothing waits on the GPU; a Low-priority JobSystem job then encodes and writes finished captures, one job at a
+ * time so records stay in frame order. When the writer falls
+ * TELEMETRY_CAPTURE_QUEUE_DEPTH captures behind, new ones are dropped rather than stalling the render thread.
+ *
+ * File: FileHeader, then one record per capture - RecordHeader, then per captured stream a StreamHeader and
+ * its encoded bytes. Encoding: the stream's 32-bit words XORed with the previous record's (none in keyframes,
+ * every TELEMETRY_CAPTURE_KEYFRAME_INTERVAL records), split into four byte planes, then zero-run-length coded:
+ * a control byte c < 0x80 is followed by c + 1 literal bytes, c >= 0x80 stands for (c & 0x7F) + 1 zero bytes.
+ * Slots are GPU slots, so the SPAWN_ID stream is needed to follow an entity across reorders.
+ */
+class EntityTelemetryCapture {
+public:
+    enum Stream : uint32_t {
+        POSITION = 1u << 0,
+        VELOCITY = 1u << 1,
+        RUNTIME_STATE = 1u << 2,
+        SPAWN_ID = 1u << 3,
+    };
+    static constexpr uint32_t STREAM_COUNT = 4;
+    
+    struct FileHeader {
+        static constexpr uint32_t MAGIC = 0x4D4C5445;  // "ETLM"
+        static constexpr uint32_t VERSION = 1;
+        uint32_t magic = MAGIC;
+        uint32_t version = VERSION;
+        uint32_t streams = 0;           // Stream bits
+        uint32_t interval = 0;          // Frames between captures
+        uint32_t keyframeInterval = 0;
+        uint32_t reserved = 0;
+    };
+    
+    struct RecordHeader {
+        static constexpr uint32_t FLAG_KEYFRAME = 1u << 0;
+        uint32_t frame = 0;             // Renderer frame the capture was queued in
+        uint32_t entityCount = 0;
+        uint32_t flags = 0;
+        uint32_t streamCount = 0;
+    };
+    
+    struct StreamHeader {
+        uint32_t stream = 0;            // One Stream bit
+        uint32_t elementSize = 0;       // Bytes per slot
+        uint64_t rawSize = 0;
+        uint64_t encodedSize = 0;
+    };
+    
+    EntityTelemetryCapture() = default;
+    ~EntityTelemetryCapture();
+    
+    // Opens path for writing; elementSizes are the per-slot bytes of each stream, by bit index
+    bool open(const std::string& path, uint32_t streams, uint32_t interval, const std::array<uint32_t, STREAM_COUNT>& elementSizes);
+    
+    // Writes every finished capture and reports the totals; an unfinished capture is dropped
+    void close();
+    
+    bool isEnabled() const { return enabled; }
+    uint32_t getStreams() const { return streams; }
+    
+    // Capture bookkeeping for EntityBufferManager, on the render thread
+    bool isCaptureDue(uint32_t frame) const;
+    bool beginCapture(uint32_t frame, uint32_t count, uint64_t bufferGeneration);  // False when no buffer is free
+    bool isCapturing() const { return building != nullptr; }
+    uint64_t getCaptureGeneration() const { return captureGeneration; }
+    uint32_t getCaptureId() const { return captureId; }  // Carried by readback results, so an aborted capture's are ignored
+    uint32_t getElementSize(uint32_t streamIndex) const { return elementSizes[streamIndex]; }
+    void addOutstanding() { ++outstanding; }
+    
+    // Readback result of [offset, offset + size) of a stream; data is nullptr for a cancelled request, which fails
+    // the capture. The last outstanding result hands the capture to the writer, or drops it when it failed
+    void storeChunk(uint32_t capture, uint32_t streamIndex, uint64_t offset, const void* data, uint64_t size);
+    void abortCapture();
+    
+    struct Telemetry {
+        uint64_t capturesWritten = 0;
+        uint64_t capturesDropped = 0;   // Writer behind, or the readback was cancelled
+        uint64_t rawBytes = 0;
+        uint64_t encodedBytes = 0;
+    };
+    Telemetry getTelemetry() const;
+
+private:
+    struct Capture {
+        uint32_t frame = 0;
+        uint32_t count = 0;
+        std::array<std::vector<uint8_t>, STREAM_COUNT> streams;
+    };
+    
+    void completeRequest();
+    void writeQueued();
+    void writeRecord(const Capture& capture);
+    
+    bool enabled = false;
+    uint32_t streams = 0;
+    uint32_t interval = 1;
+    std::array<uint32_t, STREAM_COUNT> elementSizes{};
+    
+    // Capture in progress, render thread only
+    std::unique_ptr<Capture> building;
+    uint64_t captureGeneration = 0;
+    uint32_t captureId = 0;
+    uint32_t outstanding = 0;
+    uint32_t lastCaptureFrame = 0;
+    bool hasCaptured = false;
+    bool captureFailed = false;
+    
+    // Handoff to the writer; captures cycle between the free list and the queue, so none is allocated per frame
+    std::mutex queueMutex;
+    std::deque<std::unique_ptr<Capture>> queued;
+    std::vector<std::unique_ptr<Capture>> freeCaptures;
+    bool writing = false;  // A writeQueued() job is queued or running
+    JobCounter writeJobs;
+    
+    // Writer job only
+    std::ofstream file;
+    std::array<std::vector<uint8_t>, STREAM_COUNT> previous;  // Last record's raw streams, the delta base
+    uint32_t recordsSinceKeyframe = 0;
+    std::vector<uint8_t> planes;
+    std::vector<uint8_t> encoded;
+    
+    std::atomic<uint64_t> capturesWritten{0};
+    std::atomic<uint64_t> capturesDropped{0};
+    std::atomic<uint64_t> rawBytes{0};
+    std::atomic<uint64_t> encodedBytes{0};
+};
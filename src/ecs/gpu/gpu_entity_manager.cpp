@@ -1,48 +1,221 @@
 #include "gpu_entity_manager.h"
+#include "entity_snapshot.h"
 #include "../../vulkan/core/vulkan_context.h"
 #include "../../vulkan/core/vulkan_sync.h"
 #include "../../vulkan/resources/core/resource_coordinator.h"
+#include "../../vulkan/resources/core/memory_allocator.h"
 #include "../../vulkan/core/vulkan_function_loader.h"
 #include "../../vulkan/core/vulkan_utils.h"
-#include <iostream>
+#include "../utilities/job_system.h"
+#include "../utilities/logger.h"
+#include "../utilities/profiler.h"
 #include <cstring>
-#include <random>
 #include <array>
+#include <algorithm>
+#include <iterator>
+#include <cmath>
+#include <thread>
+#include <glm/gtc/packing.hpp>
 
-// Static RNG for performance - initialized once per thread
-thread_local std::mt19937 rng{std::random_device{}()};
-thread_local std::uniform_real_distribution<float> stateTimerDist{0.0f, 600.0f};
+namespace {
+    float fract(float x) { return x - std::floor(x); }
+    
+    // Static colour terms that vertex.vert used to re-derive per vertex from the instance index.
+    // Layout must match the unpacking in vertex.vert:
+    //   x = half2(frequency multiplier, individual time base)
+    //   y = half2(phase offset, phase length)
+    //   z = half2(brightness frequency, saturation frequency)
+    //   w = unorm4x8(base hue, hue shift amount, brightness base, saturation base)
+    glm::uvec4 packColorParams(uint32_t gpuIndex, const MovementPattern& pattern) {
+        const float i = static_cast<float>(gpuIndex);
+        
+        float freqMultiplier = 0.3f + fract(i * 0.7321f) * 2.7f;         // 0.3 to 3.0
+        float phaseOffset = fract(i * 2.3941f / 6.28318530718f) * 6.28318530718f;
+        float timeOffset = fract(i * 1.4142f / 15.0f) * 15.0f;
+        float phaseLength = 0.8f + fract(i * 0.8660f) * 1.7f;             // 0.8 to 2.5 seconds
+        float brightnessFreq = 0.4f + fract(i * 0.9511f) * 1.2f;          // 0.4 to 1.6
+        float saturationFreq = 0.3f + fract(i * 0.4472f) * 1.0f;          // 0.3 to 1.3
+        
+        // (time + pattern.timeOffset) * freq + timeOffset + pattern.phase, with the constant part folded here
+        float timeBase = pattern.timeOffset * freqMultiplier + timeOffset + pattern.phase;
+        
+        glm::vec4 bases(
+            fract(i * 0.618034f),                  // base hue (golden ratio spread)
+            0.2f + fract(i * 0.5257f) * 0.6f,      // hue shift amount per phase
+            fract(i * 0.381966f),                  // brightness base
+            fract(i * 0.236068f)                   // saturation base
+        );
+        
+        return glm::uvec4(
+            glm::packHalf2x16(glm::vec2(freqMultiplier, timeBase)),
+            glm::packHalf2x16(glm::vec2(phaseOffset, phaseLength)),
+            glm::packHalf2x16(glm::vec2(brightnessFreq, saturationFreq)),
+            glm::packUnorm4x8(bases)
+        );
+    }
+    
+    // Movement params and runtime state in the byte layout of the GPU streams. The standard layout
+    // points straight at the staging vectors; ENTITY_COMPACT_LAYOUT repacks into the owned vectors.
+    // Encodings must match the unpacking in the entity shaders:
+    //   movementParams = half2(amplitude, frequency), half2(phase, timeOffset)
+    //   runtimeState   = initialized flag (bit 0) | half(stateTimer) << 16  (totalTime is GPU-only)
+    struct ColdStreamUpload {
+        std::vector<glm::uvec2> packedMovementParams;
+        std::vector<uint32_t> packedRuntimeStates;
+        const void* movementParams = nullptr;
+        const void* runtimeStates = nullptr;
+    };
+    
+    void prepareColdStreams(const GPUEntitySoA& soa, bool compactLayout, ColdStreamUpload& out) {
+        if (!compactLayout) {
+            out.movementParams = soa.movementParams.data();
+            out.runtimeStates = soa.runtimeStates.data();
+            return;
+        }
+        
+        const size_t count = soa.size();
+        out.packedMovementParams.resize(count);
+        out.packedRuntimeStates.resize(count);
+        for (size_t i = 0; i < count; ++i) {
+            const glm::vec4& params = soa.movementParams[i];
+            const glm::vec4& state = soa.runtimeStates[i];
+            out.packedMovementParams[i] = glm::uvec2(
+                glm::packHalf2x16(glm::vec2(params.x, params.y)),
+                glm::packHalf2x16(glm::vec2(params.z, params.w))
+            );
+            uint32_t flags = state.w != 0.0f ? RUNTIME_STATE_INITIALIZED_BIT : 0u;
+            out.packedRuntimeStates[i] = flags | (glm::packHalf2x16(glm::vec2(state.z, 0.0f)) << 16);
+        }
+        out.movementParams = out.packedMovementParams.data();
+        out.runtimeStates = out.packedRuntimeStates.data();
+    }
+    
+    // Every stream of the staged entities at slots [baseIndex, baseIndex + count), positions into every position buffer that takes vec4s.
+    // spawnSlots holds the spawn slot map values the regions point at until the upload has copied them
+    std::vector<EntityBufferManager::UploadRegion> buildUploadRegions(EntityBufferManager& bufferManager, const GPUEntitySoA& soa,
+                                                                      const ColdStreamUpload& coldStreams, uint32_t baseIndex,
+                                                                      std::vector<uint32_t>& spawnSlots) {
+        const size_t entityCount = soa.size();
+        const VkDeviceSize movementParamsStride = bufferManager.getMovementParamsStride();
+        const VkDeviceSize runtimeStateStride = bufferManager.getRuntimeStateStride();
+        const VkDeviceSize vec4Offset = baseIndex * sizeof(glm::vec4);
+        const VkDeviceSize positionSize = entityCount * sizeof(glm::vec4);
+        const glm::vec4* positions = soa.spawnPositions.data();
+        
+        std::vector<EntityBufferManager::UploadRegion> regions = {
+            {bufferManager.getVelocityBuffer(), soa.velocities.data(), entityCount * sizeof(glm::vec4), vec4Offset},
+            {bufferManager.getMovementParamsBuffer(), coldStreams.movementParams, entityCount * movementParamsStride, baseIndex * movementParamsStride},
+            {bufferManager.getRuntimeStateBuffer(), coldStreams.runtimeStates, entityCount * runtimeStateStride, baseIndex * runtimeStateStride},
+            {bufferManager.getColorBuffer(), soa.colorParams.data(), entityCount * sizeof(glm::uvec4), baseIndex * sizeof(glm::uvec4)},
+            {bufferManager.getPositionBuffer(), positions, positionSize, vec4Offset},
+            {bufferManager.getPositionBufferAlternate(), positions, positionSize, vec4Offset},
+            {bufferManager.getTargetPositionBuffer(), positions, positionSize, vec4Offset},
+            {bufferManager.getEntityIdBuffer(), soa.spawnIds.data(), entityCount * sizeof(uint32_t), baseIndex * sizeof(uint32_t)},
+            {bufferManager.getEntityTypeBuffer(), soa.entityTypes.data(), entityCount * sizeof(uint32_t), baseIndex * sizeof(uint32_t)},
+        };
+        // The compact vec2 snapshot is rebuilt by the grid count pass before physics reads it
+        if (bufferManager.getCurrentPositionStride() == sizeof(glm::vec4)) {
+            regions.push_back({bufferManager.getCurrentPositionBuffer(), positions, positionSize, vec4Offset});
+        }
+        if (bufferManager.hasModelMatrixStream()) {
+            regions.push_back({bufferManager.getModelMatrixBuffer(), soa.modelMatrices.data(), entityCount * sizeof(glm::mat4), baseIndex * sizeof(glm::mat4)});
+        }
+        
+        // One spawn slot region per run of consecutive spawn IDs: fresh IDs make a single run, recycled ones split it
+        spawnSlots.resize(entityCount);
+        size_t runStart = 0;
+        for (size_t i = 0; i < entityCount; ++i) {
+            spawnSlots[i] = baseIndex + static_cast<uint32_t>(i);
+            if (i + 1 == entityCount || soa.spawnIds[i + 1] != soa.spawnIds[i] + 1) {
+                regions.push_back({bufferManager.getSpawnSlotBuffer(), spawnSlots.data() + runStart,
+                                   (i + 1 - runStart) * sizeof(uint32_t), soa.spawnIds[runStart] * sizeof(uint32_t)});
+                runStart = i + 1;
+            }
+        }
+        return regions;
+    }
+    
+    // CPU replica of the entity placement in entity_spawn.comp - the hash is exact, the disc placement matches
+    // up to the rounding of the GPU's sqrt/cos/sin
+    uint32_t emitterHash(uint32_t value) {
+        uint32_t state = value * 747796405u + 2891336453u;
+        uint32_t word = ((state >> ((state >> 28u) + 4u)) ^ state) * 277803737u;
+        return (word >> 22u) ^ word;
+    }
+    
+    float hashUnit(uint32_t hash) {
+        return static_cast<float>(hash >> 8) * (1.0f / 16777216.0f);
+    }
+    
+    void emitEntity(const EntityEmitter& emitter, uint32_t index, glm::vec3& position, MovementPattern& pattern) {
+        uint32_t hash = emitterHash(emitter.seed ^ emitterHash(index));
+        const float angle = hashUnit(hash) * 6.28318530718f;
+        hash = emitterHash(hash);
+        const float distance = emitter.radius * std::sqrt(hashUnit(hash));
+        hash = emitterHash(hash);
+        pattern.phase = hashUnit(hash) * 6.28318530718f;
+        hash = emitterHash(hash);
+        pattern.timeOffset = hashUnit(hash) * 10.0f;
+        
+        const float t = static_cast<float>(index) / static_cast<float>(emitter.count);
+        pattern.amplitude = 12.0f + 8.0f * t;
+        pattern.frequency = 0.8f + 1.2f * t;
+        pattern.center = emitter.center;
+        pattern.type = emitter.movementType;
+        position = emitter.center + glm::vec3(distance * std::cos(angle), distance * std::sin(angle), 0.0f);
+    }
+}
 
-void GPUEntitySoA::addFromECS(const Transform& transform, const Renderable& renderable, const MovementPattern& pattern) {
+void GPUEntitySoA::writeFromECS(size_t slot, const Transform& transform, const TransformCold* cold, const Renderable& renderable,
+                                const MovementPattern& pattern, uint32_t gpuIndex) {
     // Velocity (initialized to zero, set by compute shader)
-    velocities.emplace_back(
+    velocities[slot] = glm::vec4(
         0.0f,                      // velocity.x
         0.0f,                      // velocity.y  
         0.001f,                    // damping factor
-        0.0f                       // reserved
+        0.0f                       // awake
     );
     
     // Movement parameters
-    movementParams.emplace_back(
+    movementParams[slot] = glm::vec4(
         pattern.amplitude,
         pattern.frequency, 
         pattern.phase,
         pattern.timeOffset
     );
     
-    // Runtime state
-    runtimeStates.emplace_back(
+    // Runtime state (stagger hashed from the index, so concurrent writers need no RNG and spawns replay exactly)
+    runtimeStates[slot] = glm::vec4(
         0.0f,                          // totalTime (updated by compute shader)
         0.0f,                          // reserved 
-        stateTimerDist(rng),           // stateTimer (random staggering)
+        ((gpuIndex * 2654435761u) >> 8) * (600.0f / 16777216.0f),  // stateTimer (0 to 600, staggered)
         0.0f                           // initialized flag (starts as 0.0)
     );
     
-    // Color
-    colors.emplace_back(renderable.color);
+    // Colour parameters (the vertex shader derives the animated colour from these)
+    colorParams[slot] = packColorParams(gpuIndex, pattern);
+    entityTypes[slot] = EntityTypeBuffer::pack(static_cast<uint32_t>(renderable.shape), static_cast<uint32_t>(pattern.type));
+    
+    // Spawn position straight from the transform (the model matrix translation)
+    spawnPositions[slot] = glm::vec4(transform.position, 1.0f);
     
     // Model matrix  
-    modelMatrices.emplace_back(transform.getMatrix());
+    if (storeModelMatrices) {
+        modelMatrices[slot] = composeModelMatrix(transform, cold);
+    }
+}
+
+void GPUEntitySoA::moveEntry(size_t dst, size_t src) {
+    velocities[dst] = velocities[src];
+    movementParams[dst] = movementParams[src];
+    runtimeStates[dst] = runtimeStates[src];
+    colorParams[dst] = colorParams[src];
+    if (storeModelMatrices) {
+        modelMatrices[dst] = modelMatrices[src];
+    }
+    spawnPositions[dst] = spawnPositions[src];
+    entityTypes[dst] = entityTypes[src];
+    std::swap(spawnIds[dst], spawnIds[src]);
 }
 
 
@@ -58,25 +231,32 @@ bool GPUEntityManager::initialize(const VulkanContext& context, VulkanSync* sync
     this->sync = sync;
     this->resourceCoordinator = resourceCoordinator;
     
-    // Initialize buffer manager
-    if (!bufferManager.initialize(context, resourceCoordinator, MAX_ENTITIES)) {
-        std::cerr << "GPUEntityManager: Failed to initialize buffer manager" << std::endl;
+    // Initialize buffer manager small - growCapacity doubles it once spawns need more
+    if (!bufferManager.initialize(context, resourceCoordinator, ENTITY_CAPACITY_INITIAL, ENTITY_COMPACT_LAYOUT)) {
+        LOG_ERROR("GPUEntityManager: Failed to initialize buffer manager");
+        return false;
+    }
+    stagingEntities.storeModelMatrices = bufferManager.hasModelMatrixStream();
+    
+    // Indirect command rewrites never cover the expiry counter, so it starts from a known zero here
+    if (!bufferManager.uploadExpiredEntityCount(0)) {
+        LOG_ERROR("GPUEntityManager: Failed to reset the expiry counter");
         return false;
     }
     
     // Initialize base descriptor manager functionality
     if (!descriptorManager.initialize(context)) {
-        std::cerr << "GPUEntityManager: Failed to initialize base descriptor manager" << std::endl;
+        LOG_ERROR("GPUEntityManager: Failed to initialize base descriptor manager");
         return false;
     }
     
     // Initialize entity-specific descriptor manager functionality
     if (!descriptorManager.initializeEntity(bufferManager, resourceCoordinator)) {
-        std::cerr << "GPUEntityManager: Failed to initialize entity descriptor manager" << std::endl;
+        LOG_ERROR("GPUEntityManager: Failed to initialize entity descriptor manager");
         return false;
     }
     
-    std::cout << "GPUEntityManager: Initialized successfully with descriptor manager" << std::endl;
+    LOG_INFO("GPUEntityManager: Initialized successfully with descriptor manager");
     return true;
 }
 
@@ -90,28 +270,191 @@ void GPUEntityManager::cleanup() {
     bufferManager.cleanup();
 }
 
+void GPUEntityManager::releaseDeviceResources() {
+    // Fence waits on the lost device return at once, so an in-flight upload is dropped rather than folded in
+    cleanup();
+    context = nullptr;
+    sync = nullptr;
+    resourceCoordinator = nullptr;
+    resetEntityState();
+    
+    // The readback ring dropped the pending expiry readback unanswered, and no snapshot was published yet
+    expiryReadbackInFlight = false;
+    publishedFrameCount = 0;
+    pendingSnapshotAcquires = 0;
+    snapshotProducerFrames.fill(0);
+    snapshotReadValues.fill(0);
+    graphicsLagsCompute = false;
+}
+
 
 void GPUEntityManager::addEntitiesFromECS(const std::vector<flecs::entity>& entities) {
-    for (const auto& entity : entities) {
-        if (activeEntityCount + stagingEntities.size() >= MAX_ENTITIES) {
-            std::cerr << "GPUEntityManager: Reached max capacity, stopping entity addition" << std::endl;
-            break;
+    if (entities.empty()) return;
+    
+    if (isDeferredFrontendCall()) {
+        // Entities destroyed before the handoff are dropped there; the world is not progressing by then
+        deferredFrontendCalls.push_back([this, entities] {
+            std::vector<flecs::entity> alive;
+            alive.reserve(entities.size());
+            std::copy_if(entities.begin(), entities.end(), std::back_inserter(alive),
+                         [](const flecs::entity& entity) { return entity.is_alive(); });
+            addEntitiesFromECS(alive);
+        });
+        return;
+    }
+    
+    stageEntities(entities, nullptr);
+}
+
+void GPUEntityManager::addResidentEntities(const std::vector<flecs::entity>& entities, const std::vector<Transform>& transforms,
+                                           const std::vector<Renderable>& renderables, const std::vector<MovementPattern>& patterns) {
+    if (entities.empty()) return;
+    if (transforms.size() != entities.size() || renderables.size() != entities.size() || patterns.size() != entities.size()) {
+        LOG_ERROR("GPUEntityManager: Resident entity columns do not match the " << entities.size() << " entities");
+        return;
+    }
+    
+    if (isDeferredFrontendCall()) {
+        // Entities destroyed before the handoff are dropped together with their column entries
+        deferredFrontendCalls.push_back([this, entities, transforms, renderables, patterns] {
+            std::vector<flecs::entity> alive;
+            std::vector<Transform> aliveTransforms;
+            std::vector<Renderable> aliveRenderables;
+            std::vector<MovementPattern> alivePatterns;
+            for (size_t i = 0; i < entities.size(); ++i) {
+                if (!entities[i].is_alive()) continue;
+                alive.push_back(entities[i]);
+                aliveTransforms.push_back(transforms[i]);
+                aliveRenderables.push_back(renderables[i]);
+                alivePatterns.push_back(patterns[i]);
+            }
+            addResidentEntities(alive, aliveTransforms, aliveRenderables, alivePatterns);
+        });
+        return;
+    }
+    
+    const ResidentColumns columns{transforms.data(), renderables.data(), patterns.data()};
+    stageEntities(entities, &columns);
+}
+
+void GPUEntityManager::stageEntities(const std::vector<flecs::entity>& entities, const ResidentColumns* columns) {
+    // Staging may run past the current buffer capacity - the buffers grow before this batch uploads
+    const size_t stagedBefore = stagingEntities.size();
+    const size_t used = std::min<size_t>(ENTITY_CAPACITY_MAX, getRequiredCapacity());
+    const size_t count = std::min(entities.size(), ENTITY_CAPACITY_MAX - used);
+    if (count < entities.size()) {
+        LOG_ERROR("GPUEntityManager: Reached max capacity (" << ENTITY_CAPACITY_MAX << "), stopping entity addition");
+    }
+    if (count == 0) return;
+    
+    // Pre-size every SoA stream and hand out spawn IDs up front so each worker owns a disjoint range
+    stagingEntities.resize(stagedBefore + count);
+    for (size_t i = 0; i < count; ++i) {
+        stagingEntities.spawnIds[stagedBefore + i] = allocateSpawnId();
+    }
+    if (spawnIdResident.size() < nextSpawnId) {
+        spawnMap.reserveSpawnIds(nextSpawnId);
+        spawnIdResident.resize(nextSpawnId, 0);
+    }
+    // Handles taken inside a system may carry a stage; lookups later need the world itself
+    ecsWorld = const_cast<flecs::world_t*>(ecs_get_world(entities.front().world().c_ptr()));
+    
+    // Stages [begin, end) densely from begin and returns how many entities had every component
+    auto stageRange = [&](size_t begin, size_t end) -> size_t {
+        size_t written = begin;
+        for (size_t i = begin; i < end; ++i) {
+            const flecs::entity& entity = entities[i];
+            if (columns) {
+                // Resident entities have no TransformCold either, and are always complete
+                uint32_t spawnId = stagingEntities.spawnIds[stagedBefore + written];
+                stagingEntities.writeFromECS(stagedBefore + written, columns->transforms[i], nullptr,
+                                             columns->renderables[i], columns->patterns[i], spawnId);
+                spawnMap.assign(spawnId, entity.id());
+                ++written;
+                continue;
+            }
+            
+            // Single record lookup reading all three hot component columns; the cold transform only when a
+            // matrix is staged
+            bool complete = entity.get([&](const Transform& transform, const Renderable& renderable, const MovementPattern& movement) {
+                uint32_t spawnId = stagingEntities.spawnIds[stagedBefore + written];
+                const TransformCold* cold = stagingEntities.storeModelMatrices ? entity.get<TransformCold>() : nullptr;
+                stagingEntities.writeFromECS(stagedBefore + written, transform, cold, renderable, movement, spawnId);
+                
+                // Dense half of the spawn map (debug lookups and despawn); distinct spawn IDs per worker
+                spawnMap.assign(spawnId, entity.id());
+            });
+            if (complete) {
+                ++written;
+            }
+        }
+        return written - begin;
+    };
+    
+    JobSystem& jobs = JobSystem::getInstance();
+    const size_t chunkCount = std::min<size_t>(jobs.getConcurrency(), (count + PARALLEL_STAGING_MIN_CHUNK - 1) / PARALLEL_STAGING_MIN_CHUNK);
+    const size_t chunkSize = (count + chunkCount - 1) / chunkCount;
+    std::vector<size_t> chunkWritten(chunkCount, 0);
+    
+    if (chunkCount == 1) {
+        chunkWritten[0] = stageRange(0, count);
+    } else {
+        // Component reads only - readonly mode keeps flecs from touching table locks across threads
+        flecs::world world = entities.front().world();
+        const bool enteredReadonly = !world.is_readonly();
+        if (enteredReadonly) {
+            world.readonly_begin(true);
         }
         
-        // Get components from entity using .get<>()
-        const Transform* transform = entity.get<Transform>();
-        const Renderable* renderable = entity.get<Renderable>();
-        const MovementPattern* movement = entity.get<MovementPattern>();
+        // The first chunk is staged here while the jobs take the rest
+        JobCounter chunksStaged;
+        for (size_t chunk = 1; chunk < chunkCount; ++chunk) {
+            size_t begin = chunk * chunkSize;
+            size_t end = std::min(count, begin + chunkSize);
+            jobs.submit([&, chunk, begin, end]() {
+                chunkWritten[chunk] = stageRange(begin, end);
+            }, JobPriority::High, &chunksStaged);
+        }
+        chunkWritten[0] = stageRange(0, std::min(count, chunkSize));
+        jobs.wait(chunksStaged);
         
-        if (transform && renderable && movement) {
-            stagingEntities.addFromECS(*transform, *renderable, *movement);
-            
-            // Store mapping from GPU buffer index to ECS entity ID for debugging
-            uint32_t gpuIndex = activeEntityCount + stagingEntities.size() - 1;
-            if (gpuIndex >= gpuIndexToECSEntity.size()) {
-                gpuIndexToECSEntity.resize(gpuIndex + 1);
+        if (enteredReadonly) {
+            world.readonly_end();
+        }
+    }
+    
+    // Close gaps left by entities missing a component (normally none, so nothing moves)
+    size_t staged = chunkWritten[0];
+    for (size_t chunk = 1; chunk < chunkCount; ++chunk) {
+        size_t begin = chunk * chunkSize;
+        for (size_t i = 0; i < chunkWritten[chunk]; ++i) {
+            if (staged + i == begin + i) continue;
+            stagingEntities.moveEntry(stagedBefore + staged + i, stagedBefore + begin + i);
+        }
+        staged += chunkWritten[chunk];
+    }
+    
+    if (staged < count) {
+        // Spawn IDs left in the trailing slots were never bound to an entity
+        for (size_t slot = stagedBefore + staged; slot < stagedBefore + count; ++slot) {
+            uint32_t spawnId = stagingEntities.spawnIds[slot];
+            spawnMap.unbindSpawnId(spawnId);
+            freeSpawnIds.push_back(spawnId);
+        }
+        stagingEntities.resize(stagedBefore + staged);
+    }
+    
+    // The sparse half may grow, so it is filled after the chunk jobs have finished
+    for (size_t slot = stagedBefore; slot < stagedBefore + staged; ++slot) {
+        spawnMap.index(stagingEntities.spawnIds[slot]);
+    }
+    
+    // Resident entity i was staged at stagedBefore + i, as none is skipped. Written in place, nothing observes GPUSlot sets
+    if (columns) {
+        for (size_t i = 0; i < staged; ++i) {
+            if (GPUSlot* slot = entities[i].get_mut<GPUSlot>()) {
+                slot->spawnId = stagingEntities.spawnIds[stagedBefore + i];
             }
-            gpuIndexToECSEntity[gpuIndex] = entity;
         }
     }
 }
@@ -119,69 +462,1034 @@ void GPUEntityManager::addEntitiesFromECS(const std::vector<flecs::entity>& enti
 void GPUEntityManager::uploadPendingEntities() {
     if (stagingEntities.empty()) return;
     
-    std::cout << "GPUEntityManager: WARNING - Uploading entities during runtime! This will overwrite computed positions!" << std::endl;
+    LOG_WARNING("GPUEntityManager: WARNING - Uploading entities during runtime! This will overwrite computed positions!");
+    
+    // Staged slots were numbered after any in-flight async batch, so that batch must land first
+    finishAsyncUpload();
+    
+    // This path already stalls, so it grows in place instead of waiting for a frame boundary
+    if (needsCapacityGrowth() && !growCapacity()) {
+        LOG_ERROR("GPUEntityManager: Entity buffers could not grow, keeping " << stagingEntities.size() << " entities staged");
+        return;
+    }
     
     size_t entityCount = stagingEntities.size();
     
-    // Upload each SoA buffer separately
-    VkDeviceSize velocityOffset = activeEntityCount * sizeof(glm::vec4);
-    VkDeviceSize movementParamsOffset = activeEntityCount * sizeof(glm::vec4);
-    VkDeviceSize runtimeStateOffset = activeEntityCount * sizeof(glm::vec4);
-    VkDeviceSize colorOffset = activeEntityCount * sizeof(glm::vec4);
-    VkDeviceSize modelMatrixOffset = activeEntityCount * sizeof(glm::mat4);
-    
-    VkDeviceSize velocitySize = entityCount * sizeof(glm::vec4);
-    VkDeviceSize movementParamsSize = entityCount * sizeof(glm::vec4);
-    VkDeviceSize runtimeStateSize = entityCount * sizeof(glm::vec4);
-    VkDeviceSize colorSize = entityCount * sizeof(glm::vec4);
-    VkDeviceSize modelMatrixSize = entityCount * sizeof(glm::mat4);
-    
-    // Copy SoA data to GPU buffers using new typed upload methods
-    bufferManager.uploadVelocityData(stagingEntities.velocities.data(), velocitySize, velocityOffset);
-    bufferManager.uploadMovementParamsData(stagingEntities.movementParams.data(), movementParamsSize, movementParamsOffset);
-    bufferManager.uploadRuntimeStateData(stagingEntities.runtimeStates.data(), runtimeStateSize, runtimeStateOffset);
-    bufferManager.uploadColorData(stagingEntities.colors.data(), colorSize, colorOffset);
-    bufferManager.uploadModelMatrixData(stagingEntities.modelMatrices.data(), modelMatrixSize, modelMatrixOffset);
+    ColdStreamUpload coldStreams;
+    prepareColdStreams(stagingEntities, bufferManager.isCompactLayout(), coldStreams);
+    std::vector<uint32_t> spawnSlots;
     
     // Initialize position buffers with spawn positions
-    std::vector<glm::vec4> initialPositions;
-    initialPositions.reserve(entityCount);
+    const auto& initialPositions = stagingEntities.spawnPositions;
+    updateSpawnBounds(activeEntityCount);
+    
+    // Debug first few positions to verify data; compiled out of release builds with the rest of LOG_DEBUG
+    for (size_t i = 0; i < std::min<size_t>(5, initialPositions.size()); ++i) {
+        LOG_DEBUG("Entity " << i << " spawn position: (" 
+                  << initialPositions[i].x << ", " << initialPositions[i].y << ", " << initialPositions[i].z << ")");
+    }
+    
+    // Every SoA stream, ALL position buffers and the spawn IDs go in one staging allocation and one submit
+    if (!bufferManager.uploadRegions(buildUploadRegions(bufferManager, stagingEntities, coldStreams, activeEntityCount, spawnSlots))) {
+        LOG_ERROR("GPUEntityManager: Synchronous upload failed, keeping " << entityCount << " entities staged");
+        return;
+    }
+    
+    activeEntityCount += entityCount;
+    ++spawnGeneration;
+    markResident(stagingEntities.spawnIds);
+    stagingEntities.clear();
+    updateIndirectCommands();
+    reconfigureSpatialGrid();
+    
+    LOG_INFO("GPUEntityManager: Uploaded " << entityCount << " entities to GPU-local memory (SoA), total: " << activeEntityCount);
+}
+
+void GPUEntityManager::uploadPendingEntitiesAsync() {
+    if (isDeferredFrontendCall() || stagingEntities.empty()) return;
+    
+    // One staging buffer in flight at a time - later spawns keep accumulating until this batch lands
+    if (bufferManager.isAsyncUploadInFlight()) return;
+    
+    // Batch does not fit yet - it stays staged until the renderer grows the buffers between frames
+    if (needsCapacityGrowth()) return;
+    
+    const size_t entityCount = stagingEntities.size();
+    const uint32_t baseIndex = activeEntityCount;
+    
+    const auto& initialPositions = stagingEntities.spawnPositions;
+    updateSpawnBounds(baseIndex);
+    
+    // Packed copies only need to live until submitAsyncUpload has filled the staging buffer
+    ColdStreamUpload coldStreams;
+    prepareColdStreams(stagingEntities, bufferManager.isCompactLayout(), coldStreams);
+    std::vector<uint32_t> spawnSlots;
+    
+    // New slots lie past the live count, so nothing in flight on the compute or graphics queue reads them. Their
+    // spawn IDs are not resident yet either, so no update or despawn pass reads the spawn slot entries written here
+    if (!bufferManager.submitAsyncUpload(buildUploadRegions(bufferManager, stagingEntities, coldStreams, baseIndex, spawnSlots))) {
+        // Staging is kept, so the synchronous path still gets these entities onto the GPU
+        LOG_ERROR("GPUEntityManager: Async upload failed, falling back to synchronous upload");
+        uploadPendingEntities();
+        return;
+    }
+    
+    pendingUploadCount = static_cast<uint32_t>(entityCount);
+    inFlightSpawnIds.assign(stagingEntities.spawnIds.begin(), stagingEntities.spawnIds.end());
+    stagingEntities.clear();
+}
+
+bool GPUEntityManager::commitCompletedUploads(VkCommandBuffer commandBuffer) {
+    if (pendingUploadCount == 0 || !bufferManager.pollAsyncUpload()) {
+        return false;
+    }
+    
+    activeEntityCount += pendingUploadCount;
+    ++spawnGeneration;
+    const uint32_t committed = pendingUploadCount;
+    pendingUploadCount = 0;
+    markResident(inFlightSpawnIds);
+    inFlightSpawnIds.clear();
+    
+    recordIndirectCommandUpdate(commandBuffer);
+    reconfigureSpatialGrid();
+    
+    LOG_INFO("GPUEntityManager: Committed " << committed << " asynchronously uploaded entities, total: " << activeEntityCount);
+    return true;
+}
+
+void GPUEntityManager::recordIndirectCommandUpdate(VkCommandBuffer commandBuffer) {
+    const auto& vk = context->getLoader();
+    const EntityIndirectCommands commands = buildIndirectCommands();
+    
+    // Previously submitted frames may still be reading the old dispatch/draw arguments
+    vk.vkCmdPipelineBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, 0, nullptr);
+    
+    vk.vkCmdUpdateBuffer(
+        commandBuffer, bufferManager.getIndirectCommandBuffer(), 0, EntityIndirectCommandBuffer::getCommandSize(), &commands);
+    
+    // Covers the new live count and, when the transfer queue aliases this one, the uploaded entity data
+    VkMemoryBarrier commitBarrier{};
+    commitBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    commitBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    commitBarrier.dstAccessMask = VK_ACCESS_INDIRECT_COMMAND_READ_BIT | VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    
+    vk.vkCmdPipelineBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_DRAW_INDIRECT_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        0, 1, &commitBarrier, 0, nullptr, 0, nullptr);
+}
+
+void GPUEntityManager::removeEntity(flecs::entity entity) {
+    if (isDeferredFrontendCall()) {
+        // Only the ID is used, so the entity may be gone by the time this runs
+        deferredFrontendCalls.push_back([this, entity] { removeEntity(entity); });
+        return;
+    }
+    
+    // The GPU slot stays live until a compaction pass picks this spawn ID up
+    const uint32_t spawnId = spawnMap.unbind(entity.id());
+    if (spawnId == EntitySpawnMap::NO_SPAWN_ID) return;
+    pendingDespawns.push_back(spawnId);
+    
+    // The spawn ID may be recycled before the update would land
+    dropPendingUpdate(spawnId);
+}
+
+void GPUEntityManager::removeEntities(const std::vector<flecs::entity>& entities) {
+    if (isDeferredFrontendCall()) {
+        deferredFrontendCalls.push_back([this, entities] { removeEntities(entities); });
+        return;
+    }
+    
+    pendingDespawns.reserve(pendingDespawns.size() + entities.size());
+    for (flecs::entity entity : entities) {
+        removeEntity(entity);
+    }
+}
+
+void GPUEntityManager::updateEntity(flecs::entity entity) {
+    // The reverse map only changes on this thread or at the handoff, so unknown entities (fresh spawns setting
+    // their components) are filtered before anything is queued
+    const uint32_t spawnId = spawnMap.find(entity.id());
+    if (spawnId == EntitySpawnMap::NO_SPAWN_ID) return;
+    
+    if (isDeferredFrontendCall()) {
+        // Components are read when the call runs, so the latest edit wins
+        deferredFrontendCalls.push_back([this, entity] { updateEntity(entity); });
+        return;
+    }
+    
+    const MovementPattern* pattern = entity.is_alive() ? entity.get<MovementPattern>() : nullptr;
+    if (!pattern) return;
+    
+    EntityUpdateRecord record;
+    record.spawnId = spawnId;
+    record.movementType = static_cast<uint32_t>(pattern->type);
+    if (isCompactLayout()) {
+        record.movementParams = glm::uvec4(
+            glm::packHalf2x16(glm::vec2(pattern->amplitude, pattern->frequency)),
+            glm::packHalf2x16(glm::vec2(pattern->phase, pattern->timeOffset)),
+            0u, 0u);
+    } else {
+        record.movementParams = glm::floatBitsToUint(
+            glm::vec4(pattern->amplitude, pattern->frequency, pattern->phase, pattern->timeOffset));
+    }
+    record.colorParams = packColorParams(record.spawnId, *pattern);
+    
+    auto [entry, inserted] = pendingUpdateIndex.try_emplace(record.spawnId, pendingUpdates.size());
+    if (inserted) {
+        pendingUpdates.push_back(record);
+    } else {
+        pendingUpdates[entry->second] = record;
+    }
+}
+
+void GPUEntityManager::dropPendingUpdate(uint32_t spawnId) {
+    auto it = pendingUpdateIndex.find(spawnId);
+    if (it == pendingUpdateIndex.end()) return;
+    
+    const size_t position = it->second;
+    pendingUpdateIndex.erase(it);
+    if (position + 1 != pendingUpdates.size()) {
+        pendingUpdates[position] = pendingUpdates.back();
+        pendingUpdateIndex[pendingUpdates[position].spawnId] = position;
+    }
+    pendingUpdates.pop_back();
+}
+
+std::vector<EntityUpdateRecord> GPUEntityManager::takeUpdateBatch() {
+    std::vector<EntityUpdateRecord> batch;
+    if (pendingUpdates.empty()) {
+        return batch;
+    }
+    
+    // Staged or uploading entities keep their record until the slot they will occupy is live
+    size_t kept = 0;
+    for (const EntityUpdateRecord& record : pendingUpdates) {
+        if (spawnIdResident[record.spawnId] && batch.size() < ENTITY_UPDATE_MAX_BATCH) {
+            batch.push_back(record);
+        } else {
+            pendingUpdates[kept++] = record;
+        }
+    }
+    pendingUpdates.resize(kept);
+    
+    pendingUpdateIndex.clear();
+    for (size_t position = 0; position < pendingUpdates.size(); ++position) {
+        pendingUpdateIndex[pendingUpdates[position].spawnId] = position;
+    }
+    return batch;
+}
+
+void GPUEntityManager::frontendCall(std::function<void()> call) {
+    if (isDeferredFrontendCall()) {
+        deferredFrontendCalls.push_back(std::move(call));
+        return;
+    }
+    call();
+}
+
+void GPUEntityManager::applyDeferredFrontendCalls() {
+    // Runs on the frontend thread, so the thread check has to be off while the queued calls execute
+    const std::thread::id frontendThread = deferredFrontendThread;
+    deferredFrontendThread = std::thread::id{};
+    
+    std::vector<std::function<void()>> calls;
+    calls.swap(deferredFrontendCalls);
+    for (auto& call : calls) {
+        call();
+    }
+    
+    deferredFrontendThread = frontendThread;
+}
+
+std::vector<uint32_t> GPUEntityManager::takeDespawnBatch() {
+    std::vector<uint32_t> batch;
+    if (pendingDespawns.empty() || pendingUploadCount > 0) {
+        return batch;
+    }
+    
+    // Entities still staged or uploading stay queued until their data is resident
+    size_t kept = 0;
+    for (uint32_t spawnId : pendingDespawns) {
+        if (spawnIdResident[spawnId] && batch.size() < ENTITY_DESPAWN_MAX_BATCH) {
+            batch.push_back(spawnId);
+        } else {
+            pendingDespawns[kept++] = spawnId;
+        }
+    }
+    pendingDespawns.resize(kept);
+    return batch;
+}
+
+void GPUEntityManager::commitDespawnBatch(VkCommandBuffer commandBuffer, const std::vector<uint32_t>& spawnIds) {
+    if (spawnIds.empty()) return;
+    
+    activeEntityCount -= static_cast<uint32_t>(spawnIds.size());
+    for (uint32_t spawnId : spawnIds) {
+        spawnIdResident[spawnId] = 0;
+        freeSpawnIds.push_back(spawnId);
+        if (spawnId < emitterOrigins.size()) {
+            emitterOrigins[spawnId] = EmitterOrigin{};
+        }
+    }
+    
+    // Slots were refilled from the tail, so slot order no longer follows spawn IDs
+    entitiesReordered = true;
+    slotsMovedThisFrame = true;
+    
+    recordIndirectCommandUpdate(commandBuffer);
+    reconfigureSpatialGrid();
+}
+
+void GPUEntityManager::spawnEmitter(const EntityEmitter& emitter) {
+    if (isDeferredFrontendCall()) {
+        deferredFrontendCalls.push_back([this, emitter] { spawnEmitter(emitter); });
+        return;
+    }
+    
+    const size_t used = std::min<size_t>(ENTITY_CAPACITY_MAX, getRequiredCapacity());
+    const uint32_t count = static_cast<uint32_t>(std::min<size_t>(emitter.count, ENTITY_CAPACITY_MAX - used));
+    if (count < emitter.count) {
+        LOG_ERROR("GPUEntityManager: Reached max capacity (" << ENTITY_CAPACITY_MAX << "), emitting " << count << " of " << emitter.count << " entities");
+    }
+    if (count == 0) return;
+    
+    // The clamped count is what the burst spreads its movement params over
+    emitters.push_back(emitter);
+    emitters.back().count = count;
+    if (emitter.lifetime > 0.0f && bufferManager.isCompactLayout()) {
+        // The packed runtime state has no lane left to count a lifetime down in
+        LOG_ERROR("GPUEntityManager: Emitter lifetimes need the full entity layout, emitting entities without one");
+        emitters.back().lifetime = 0.0f;
+    }
+    hasLifetimeEntities = hasLifetimeEntities || emitters.back().lifetime > 0.0f;
+    pendingEmitters.push_back({static_cast<uint32_t>(emitters.size() - 1), 0});
+    pendingEmitterEntities += count;
+}
+
+EntityEmitterBatch GPUEntityManager::takeEmitterBatch() {
+    EntityEmitterBatch batch;
+    if (pendingEmitters.empty() || pendingUploadCount > 0) {
+        return batch;
+    }
+    
+    // Whatever does not fit waits for the renderer to grow the buffers, which the queued entities already ask for.
+    // Tombstone refills take no new slot, so only appended entities count against the free capacity
+    const uint32_t maxEntities = bufferManager.getMaxEntities();
+    uint32_t budget = maxEntities > activeEntityCount ? maxEntities - activeEntityCount : 0u;
+    const uint32_t tombstones = getTombstoneCount();
+    batch.baseSlot = activeEntityCount;
+    
+    // A refilled slot keeps the spawn ID of the entity that expired there, which is only right for another
+    // lifetime entity, and the spawn pass refills the first entities of the batch - so reuse stops at the first
+    // entity that has to be appended
+    bool reusing = true;
+    size_t finished = 0;
+    for (PendingEmitter& pending : pendingEmitters) {
+        const uint32_t room = ENTITY_EMITTER_MAX_SPAWNS - batch.getSpawnCount();
+        if (room == 0 || batch.records.size() == ENTITY_EMITTER_MAX_BATCH) break;
+        
+        const EntityEmitter& emitter = emitters[pending.emitter];
+        const uint32_t wanted = std::min(room, emitter.count - pending.emitted);
+        reusing = reusing && emitter.lifetime > 0.0f;
+        const uint32_t reused = reusing ? std::min(wanted, tombstones - batch.reuseCount) : 0u;
+        const uint32_t appended = std::min(wanted - reused, budget);
+        const uint32_t run = reused + appended;
+        if (run == 0) break;
+        reusing = reusing && appended == 0;
+        
+        EntityEmitterRecord record;
+        record.centerRadius = glm::vec4(emitter.center, emitter.radius);
+        record.firstSpawn = batch.getSpawnCount();
+        record.firstIndex = pending.emitted;
+        record.count = emitter.count;
+        record.seed = emitter.seed;
+        record.lifetime = emitter.lifetime;
+        record.entityType = EntityTypeBuffer::pack(static_cast<uint32_t>(emitter.shape), static_cast<uint32_t>(emitter.movementType));
+        batch.records.push_back(record);
+        batch.reuseCount += reused;
+        
+        const size_t firstAppended = batch.spawnIds.size();
+        for (uint32_t i = 0; i < appended; ++i) {
+            batch.spawnIds.push_back(allocateSpawnId());
+        }
+        if (spawnIdResident.size() < nextSpawnId) {
+            spawnMap.reserveSpawnIds(nextSpawnId);
+            spawnIdResident.resize(nextSpawnId, 0);
+        }
+        if (emitterOrigins.size() < nextSpawnId) {
+            emitterOrigins.resize(nextSpawnId);
+        }
+        
+        // Lifetime entities have no shadow entity: the ECS would outlive them
+        for (uint32_t i = 0; i < appended; ++i) {
+            emitterOrigins[batch.spawnIds[firstAppended + i]] = emitter.lifetime > 0.0f
+                ? EmitterOrigin{} : EmitterOrigin{pending.emitter, pending.emitted + reused + i};
+        }
+        
+        pending.emitted += run;
+        budget -= appended;
+        if (pending.emitted < emitter.count) break;
+        ++finished;
+    }
+    
+    pendingEmitters.erase(pendingEmitters.begin(), pendingEmitters.begin() + finished);
+    pendingEmitterEntities -= batch.getSpawnCount();
+    return batch;
+}
+
+void GPUEntityManager::commitEmitterBatch(VkCommandBuffer commandBuffer, const EntityEmitterBatch& batch) {
+    if (batch.empty()) return;
     
-    for (size_t i = 0; i < stagingEntities.modelMatrices.size(); ++i) {
-        const auto& modelMatrix = stagingEntities.modelMatrices[i];
-        // Extract position from modelMatrix (4th column contains translation)
-        glm::vec3 spawnPosition = glm::vec3(modelMatrix[3]);
-        initialPositions.emplace_back(spawnPosition, 1.0f);
+    // Every emitter disc counts as spawned area, so the grid covers the burst before its first physics step
+    for (const EntityEmitterRecord& record : batch.records) {
+        const glm::vec2 center(record.centerRadius);
+        const glm::vec2 extent(record.centerRadius.w);
+        if (activeEntityCount == 0 && &record == &batch.records.front()) {
+            spawnBoundsMin = center - extent;
+            spawnBoundsMax = center + extent;
+        } else {
+            spawnBoundsMin = glm::min(spawnBoundsMin, center - extent);
+            spawnBoundsMax = glm::max(spawnBoundsMax, center + extent);
+        }
+    }
+    
+    activeEntityCount += static_cast<uint32_t>(batch.spawnIds.size());
+    reusedTombstones += batch.reuseCount;
+    ++spawnGeneration;
+    markResident(batch.spawnIds);
+    
+    // The spawn kernel writes colours and movement params on the simulation GPU; the publish only mirrors
+    // them to the rendering GPU on a frame that draws its own snapshot
+    if (context->isMultiDeviceSimulation()) {
+        slotsMovedThisFrame = true;
+    }
+    
+    recordIndirectCommandUpdate(commandBuffer);
+    reconfigureSpatialGrid();
+}
+
+void GPUEntityManager::refreshExpiredEntityCount() {
+    if (!hasLifetimeEntities || expiryReadbackInFlight) return;
+    
+    const uint32_t epoch = expiryEpoch;
+    expiryReadbackInFlight = bufferManager.requestExpiredEntityCount([this, epoch](const uint32_t* count) {
+        expiryReadbackInFlight = false;
+        if (count && epoch == expiryEpoch) {
+            expiredEntityCount = std::max(expiredEntityCount, *count);
+        }
+    });
+}
+
+bool GPUEntityManager::isPipelinedComputeActive() const {
+    return ENABLE_PIPELINED_ASYNC_COMPUTE && sync && sync->usesTimelineSemaphores() && bufferManager.hasPublishedSnapshots();
+}
+
+bool GPUEntityManager::snapshotsNeedOwnershipTransfer() const {
+    // Multi-device compute writes the rendering GPU's aliases, so graphics' own handles never change family
+    return !context->isMultiDeviceSimulation() && context->getComputeQueueFamily() != context->getGraphicsQueueFamily();
+}
+
+uint32_t GPUEntityManager::beginSnapshotPublish() {
+    publishSlot = static_cast<uint32_t>(publishedFrameCount % PUBLISHED_SNAPSHOT_COUNT);
+    
+    // Graphics draws the newest snapshot another frame completed, unless colours or movement params moved since:
+    // every earlier snapshot indexes the old slot layout then
+    uint32_t newestSlot = publishSlot;
+    uint64_t newestFrame = 0;
+    for (uint32_t slot = 0; slot < PUBLISHED_SNAPSHOT_COUNT; ++slot) {
+        if (slot != publishSlot && snapshotProducerFrames[slot] > newestFrame) {
+            newestFrame = snapshotProducerFrames[slot];
+            newestSlot = slot;
+        }
+    }
+    graphicsLagsCompute = newestFrame > 0 && !slotsMovedThisFrame;
+    graphicsSnapshotSlot = graphicsLagsCompute ? newestSlot : publishSlot;
+    
+    // The copies below overwrite this slot, so compute waits on the last graphics submit that drew it
+    snapshotWriteAfterReadValue = snapshotReadValues[publishSlot];
+    
+    ++publishedFrameCount;
+    snapshotProducerFrames[publishSlot] = publishedFrameCount;
+    slotsMovedThisFrame = false;
+    publishedDensityTiles[publishSlot] = densityTilesCulled;
+    if (snapshotsNeedOwnershipTransfer()) {
+        pendingSnapshotAcquires |= 1u << publishSlot;
+    }
+    bufferManager.getPositionExport().beginPublish(publishSlot);
+    return publishSlot;
+}
+
+void GPUEntityManager::markSnapshotDrawn(uint64_t graphicsTimelineValue) {
+    if (graphicsTimelineValue > 0) {
+        snapshotReadValues[graphicsSnapshotSlot] = graphicsTimelineValue;
+    }
+}
+
+uint32_t GPUEntityManager::takeSnapshotAcquires() {
+    uint32_t acquires = pendingSnapshotAcquires;
+    if (graphicsLagsCompute) {
+        acquires &= ~(1u << publishSlot);
+    }
+    pendingSnapshotAcquires &= ~acquires;
+    return acquires;
+}
+
+uint32_t GPUEntityManager::getRequiredCapacity() const {
+    // The spawn slot map is indexed by spawn ID, so the buffers also cover every ID handed out
+    return std::max(activeEntityCount + pendingUploadCount + static_cast<uint32_t>(stagingEntities.size()) + pendingEmitterEntities,
+                    nextSpawnId);
+}
+
+bool GPUEntityManager::needsCapacityGrowth() const {
+    return getRequiredCapacity() > bufferManager.getMaxEntities();
+}
+
+bool GPUEntityManager::growCapacity() {
+    const uint32_t required = getRequiredCapacity();
+    uint32_t capacity = bufferManager.getMaxEntities();
+    if (required <= capacity) return true;
+    
+    // Geometric growth keeps the number of reallocations logarithmic in the final entity count
+    const uint32_t currentCapacity = capacity;
+    while (capacity < required) {
+        capacity = std::min(capacity * 2, ENTITY_CAPACITY_MAX);
+    }
+    
+    // The doubling must fit the device-local budget the driver reports, which other processes and the
+    // compositor shrink; when it does not, grow only to what is required now, and refuse if even that would
+    // push the heap over budget - entities then stay staged instead of the allocation failing or paging
+    if (MemoryAllocator* allocator = resourceCoordinator ? resourceCoordinator->getMemoryAllocator() : nullptr) {
+        const VkDeviceSize available = allocator->getDeviceLocalBudget().availableBytes;
+        const VkDeviceSize headroom = available > ENTITY_GROWTH_BUDGET_HEADROOM ? available - ENTITY_GROWTH_BUDGET_HEADROOM : 0;
+        const VkDeviceSize bytesPerEntity = bufferManager.getBytesPerEntity();
+        auto growthBytes = [&](uint32_t target) { return VkDeviceSize(target - currentCapacity) * bytesPerEntity; };
         
-        // Debug first few positions to verify data
-        if (i < 5) {
-            std::cout << "Entity " << i << " spawn position: (" 
-                      << spawnPosition.x << ", " << spawnPosition.y << ", " << spawnPosition.z << ")" << std::endl;
+        if (growthBytes(capacity) > headroom) {
+            if (growthBytes(required) > headroom) {
+                LOG_ERROR("GPUEntityManager: Growing to " << required << " entities needs " << growthBytes(required) / MEGABYTE
+                          << " MB, only " << headroom / MEGABYTE << " MB of device memory budget left");
+                return false;
+            }
+            capacity = required;
         }
     }
     
-    // Initialize ALL position buffers so graphics and physics can read from any of them
-    VkDeviceSize positionUploadSize = initialPositions.size() * sizeof(glm::vec4);
-    VkDeviceSize positionOffset = activeEntityCount * sizeof(glm::vec4);
+    // The old buffers themselves go to the deletion queue, but the copies carrying their contents over would
+    // race the frames in flight still simulating into them, and those frames bind them through descriptor sets
+    // about to be rewritten in place (or, bindless, table entries about to be rewritten while in use), so every
+    // frame in flight drains first. Sparse buffers growing in place keep every handle, so frames keep running
+    // and an async upload still lands where EntityUploadNode will commit it
+    const bool inPlace = bufferManager.canGrowInPlace(capacity);
+    if (!inPlace) {
+        PROFILE_HITCH_EVENT(HitchCause::DeviceWaitIdle);
+        const auto& vk = context->getLoader();
+        vk.vkDeviceWaitIdle(context->getDevice());
+        finishAsyncUpload();
+    }
     
-    bufferManager.uploadPositionDataToAllBuffers(initialPositions.data(), positionUploadSize, positionOffset);
+    const bool grown = bufferManager.growCapacity(capacity);
     
-    activeEntityCount += entityCount;
-    stagingEntities.clear();
+    // Buffers that did grow already have new handles, so the sets are rebuilt either way
+    if (!inPlace && !descriptorManager.recreateDescriptorSets()) {
+        LOG_ERROR("GPUEntityManager: Failed to recreate descriptor sets after buffer growth");
+        return false;
+    }
+    if (!grown) {
+        LOG_ERROR("GPUEntityManager: Failed to grow entity buffers to " << capacity << " entities");
+        return false;
+    }
+    
+    // New snapshot buffers hold nothing yet, were never released by compute and nothing in flight reads them;
+    // grown in place they keep their contents, ownership and readers
+    if (!inPlace) {
+        publishedFrameCount = 0;
+        pendingSnapshotAcquires = 0;
+        snapshotProducerFrames.fill(0);
+        snapshotReadValues.fill(0);
+    }
+    
+    reconfigureSpatialGrid();
+    LOG_INFO("GPUEntityManager: Entity capacity grown to " << capacity << " (" << required << " required)");
+    return true;
+}
+
+uint32_t GPUEntityManager::allocateSpawnId() {
+    if (!freeSpawnIds.empty()) {
+        uint32_t spawnId = freeSpawnIds.back();
+        freeSpawnIds.pop_back();
+        return spawnId;
+    }
+    return nextSpawnId++;
+}
+
+void GPUEntityManager::markResident(std::span<const uint32_t> spawnIds) {
+    for (uint32_t spawnId : spawnIds) {
+        spawnIdResident[spawnId] = 1;
+    }
+}
+
+void GPUEntityManager::finishAsyncUpload() {
+    if (pendingUploadCount == 0) return;
+    
+    bufferManager.waitForAsyncUpload();
+    activeEntityCount += pendingUploadCount;
+    ++spawnGeneration;
+    pendingUploadCount = 0;
+    markResident(inFlightSpawnIds);
+    inFlightSpawnIds.clear();
+    updateIndirectCommands();
+    reconfigureSpatialGrid();
+}
+
+void GPUEntityManager::updateSpawnBounds(uint32_t baseIndex) {
+    const size_t entityCount = stagingEntities.size();
     
-    std::cout << "GPUEntityManager: Uploaded " << entityCount << " entities to GPU-local memory (SoA), total: " << activeEntityCount << std::endl;
+    for (size_t i = 0; i < entityCount; ++i) {
+        glm::vec3 spawnPosition = glm::vec3(stagingEntities.spawnPositions[i]);
+        
+        if (baseIndex == 0 && i == 0) {
+            spawnBoundsMin = spawnBoundsMax = glm::vec2(spawnPosition);
+        } else {
+            spawnBoundsMin = glm::min(spawnBoundsMin, glm::vec2(spawnPosition));
+            spawnBoundsMax = glm::max(spawnBoundsMax, glm::vec2(spawnPosition));
+        }
+    }
+}
+
+void GPUEntityManager::reconfigureSpatialGrid() {
+    glm::vec2 spawnSize = spawnBoundsMax - spawnBoundsMin;
+    float worldExtent = std::max(SPATIAL_WORLD_EXTENT, std::max(spawnSize.x, spawnSize.y));
+    bufferManager.configureSpatialGrid(activeEntityCount, worldExtent);
+}
+
+void GPUEntityManager::setSpatialCellSize(float cellSize) {
+    bufferManager.setSpatialCellSize(cellSize);
+    reconfigureSpatialGrid();
 }
 
 void GPUEntityManager::clearAllEntities() {
+    // An in-flight transfer still writes into the buffers being reset
+    bufferManager.waitForAsyncUpload();
+    resetEntityState();
+    bufferManager.configureSpatialGrid(0, SPATIAL_WORLD_EXTENT);
+    updateIndirectCommands();
+    bufferManager.uploadExpiredEntityCount(0);
+}
+
+void GPUEntityManager::resetEntityState() {
+    pendingUploadCount = 0;
     stagingEntities.clear();
     activeEntityCount = 0;
+    ++spawnGeneration;
+    
+    // Every spawn ID is released together with its slot
+    spawnMap.clear();
+    spawnIdResident.clear();
+    inFlightSpawnIds.clear();
+    pendingDespawns.clear();
+    pendingUpdates.clear();
+    pendingUpdateIndex.clear();
+    emitters.clear();
+    pendingEmitters.clear();
+    pendingEmitterEntities = 0;
+    emitterOrigins.clear();
+    freeSpawnIds.clear();
+    nextSpawnId = 0;
+    entitiesReordered = false;
+    slotsMovedThisFrame = true;
+    spawnBoundsMin = spawnBoundsMax = glm::vec2(0.0f);
+    
+    // The tombstones went with the slots
+    expiredEntityCount = 0;
+    reusedTombstones = 0;
+    ++expiryEpoch;
+    hasLifetimeEntities = false;
+}
+
+bool GPUEntityManager::saveSnapshot(const std::string& path, uint64_t frame, float totalTime) {
+    // An in-flight batch lands in slots past the live count, so it is folded in first
+    finishAsyncUpload();
+    if (!stagingEntities.empty()) {
+        LOG_INFO("GPUEntityManager: Snapshot leaves out " << stagingEntities.size() << " staged entities");
+    }
+    
+    const uint32_t entityCount = activeEntityCount;
+    EntitySnapshotHeader header;
+    header.flags = bufferManager.isCompactLayout() ? EntitySnapshotHeader::FLAG_COMPACT_LAYOUT : 0;
+    header.entityCount = entityCount;
+    header.spawnIdLimit = nextSpawnId;
+    header.frame = frame;
+    header.totalTime = totalTime;
+    header.spawnBoundsMin[0] = spawnBoundsMin.x;
+    header.spawnBoundsMin[1] = spawnBoundsMin.y;
+    header.spawnBoundsMax[0] = spawnBoundsMax.x;
+    header.spawnBoundsMax[1] = spawnBoundsMax.y;
+    
+    struct Stream {
+        EntitySnapshotColumn id;
+        VkBuffer buffer;
+        VkDeviceSize stride;
+    };
+    std::vector<Stream> streams = {
+        {EntitySnapshotColumn::Velocity, bufferManager.getVelocityBuffer(), sizeof(glm::vec4)},
+        {EntitySnapshotColumn::MovementParams, bufferManager.getMovementParamsBuffer(), bufferManager.getMovementParamsStride()},
+        {EntitySnapshotColumn::RuntimeState, bufferManager.getRuntimeStateBuffer(), bufferManager.getRuntimeStateStride()},
+        {EntitySnapshotColumn::ColorParams, bufferManager.getColorBuffer(), sizeof(glm::uvec4)},
+        {EntitySnapshotColumn::Position, bufferManager.getPositionBuffer(), sizeof(glm::vec4)},
+        {EntitySnapshotColumn::PreviousPosition, bufferManager.getTargetPositionBuffer(), sizeof(glm::vec4)},
+        {EntitySnapshotColumn::SpawnId, bufferManager.getEntityIdBuffer(), sizeof(uint32_t)},
+        {EntitySnapshotColumn::EntityType, bufferManager.getEntityTypeBuffer(), sizeof(uint32_t)},
+    };
+    if (bufferManager.hasModelMatrixStream()) {
+        streams.push_back({EntitySnapshotColumn::ModelMatrix, bufferManager.getModelMatrixBuffer(), sizeof(glm::mat4)});
+    }
+    
+    std::vector<std::vector<uint8_t>> contents(streams.size());
+    std::vector<EntitySnapshotColumnData> columns;
+    columns.reserve(streams.size() + 1);
+    for (size_t i = 0; i < streams.size(); ++i) {
+        contents[i].resize(entityCount * streams[i].stride);
+        if (entityCount > 0 && !bufferManager.readGPUBuffer(streams[i].buffer, contents[i].data(), contents[i].size(), 0)) {
+            LOG_ERROR("GPUEntityManager: Failed to read back stream " << static_cast<uint32_t>(streams[i].id) << " for the snapshot");
+            return false;
+        }
+        columns.push_back({streams[i].id, static_cast<uint32_t>(streams[i].stride), contents[i].data(), contents[i].size()});
+    }
+    
+    // Flecs ids by spawn ID, so a restore in this process can rebind the entities that still exist
+    std::vector<uint64_t> ecsEntities(nextSpawnId, 0);
+    for (uint32_t spawnId = 0; spawnId < nextSpawnId; ++spawnId) {
+        if (spawnIdResident[spawnId]) {
+            ecsEntities[spawnId] = spawnMap.getEntity(spawnId);
+        }
+    }
+    columns.push_back({EntitySnapshotColumn::ECSEntity, sizeof(uint64_t), ecsEntities.data(), ecsEntities.size() * sizeof(uint64_t)});
+    
+    if (!writeEntitySnapshot(path, header, columns)) {
+        return false;
+    }
+    LOG_INFO("GPUEntityManager: Saved " << entityCount << " entities at frame " << frame << " to " << path);
+    return true;
+}
+
+bool GPUEntityManager::loadSnapshot(const std::string& path, uint64_t& frame, float& totalTime, flecs::world* world) {
+    EntitySnapshotFile file;
+    if (!file.open(path)) {
+        return false;
+    }
+    
+    const EntitySnapshotHeader& header = file.getHeader();
+    const bool compactLayout = (header.flags & EntitySnapshotHeader::FLAG_COMPACT_LAYOUT) != 0;
+    if (compactLayout != bufferManager.isCompactLayout()) {
+        LOG_ERROR("GPUEntityManager: " << path << " was saved with the " << (compactLayout ? "compact" : "standard")
+                  << " stream layout");
+        return false;
+    }
+    const uint32_t entityCount = header.entityCount;
+    if (header.spawnIdLimit > ENTITY_CAPACITY_MAX || entityCount > header.spawnIdLimit) {
+        LOG_ERROR("GPUEntityManager: " << path << " holds " << entityCount << " entities below spawn ID "
+                  << header.spawnIdLimit << ", beyond ENTITY_CAPACITY_MAX");
+        return false;
+    }
+    
+    // Every column must cover the live range at this layout's strides before anything is cleared
+    bool columnsValid = true;
+    auto column = [&](EntitySnapshotColumn id, VkDeviceSize stride, uint32_t count) -> const void* {
+        size_t size = 0;
+        uint32_t elementSize = 0;
+        const void* data = file.getColumn(id, size, elementSize);
+        if (!data || elementSize != stride || size < stride * count) {
+            LOG_ERROR("GPUEntityManager: Snapshot column " << static_cast<uint32_t>(id) << " is missing or has another stride");
+            columnsValid = false;
+            return nullptr;
+        }
+        return data;
+    };
+    const void* velocities = column(EntitySnapshotColumn::Velocity, sizeof(glm::vec4), entityCount);
+    const void* movementParams = column(EntitySnapshotColumn::MovementParams, bufferManager.getMovementParamsStride(), entityCount);
+    const void* runtimeStates = column(EntitySnapshotColumn::RuntimeState, bufferManager.getRuntimeStateStride(), entityCount);
+    const void* colorParams = column(EntitySnapshotColumn::ColorParams, sizeof(glm::uvec4), entityCount);
+    const void* positions = column(EntitySnapshotColumn::Position, sizeof(glm::vec4), entityCount);
+    const void* previousPositions = column(EntitySnapshotColumn::PreviousPosition, sizeof(glm::vec4), entityCount);
+    const auto* slotSpawnIds = static_cast<const uint32_t*>(column(EntitySnapshotColumn::SpawnId, sizeof(uint32_t), entityCount));
+    const void* entityTypes = column(EntitySnapshotColumn::EntityType, sizeof(uint32_t), entityCount);
+    const auto* ecsEntities = static_cast<const uint64_t*>(column(EntitySnapshotColumn::ECSEntity, sizeof(uint64_t), header.spawnIdLimit));
+    const void* modelMatrices = bufferManager.hasModelMatrixStream()
+        ? column(EntitySnapshotColumn::ModelMatrix, sizeof(glm::mat4), entityCount) : nullptr;
+    if (!columnsValid) {
+        return false;
+    }
+    
+    // Slots must hold distinct spawn IDs below the limit, or residency and recycling would be corrupted
+    std::vector<uint8_t> resident(header.spawnIdLimit, 0);
+    bool spawnOrder = true;
+    for (uint32_t slot = 0; slot < entityCount; ++slot) {
+        const uint32_t spawnId = slotSpawnIds[slot];
+        if (spawnId >= header.spawnIdLimit || resident[spawnId]) {
+            LOG_ERROR("GPUEntityManager: Snapshot slot " << slot << " holds an invalid spawn ID " << spawnId);
+            return false;
+        }
+        resident[spawnId] = 1;
+        spawnOrder = spawnOrder && spawnId == slot;
+    }
+    
+    clearAllEntities();
+    activeEntityCount = entityCount;
+    ++spawnGeneration;
+    nextSpawnId = header.spawnIdLimit;
+    if (needsCapacityGrowth() && !growCapacity()) {
+        LOG_ERROR("GPUEntityManager: Entity buffers could not grow to the snapshot's " << entityCount << " entities");
+        clearAllEntities();
+        return false;
+    }
+    
+    // The mapped columns are the staging copy's source, so the file is never read into a buffer of its own
+    const VkDeviceSize vec4Size = entityCount * sizeof(glm::vec4);
+    std::vector<EntityBufferManager::UploadRegion> regions = {
+        {bufferManager.getVelocityBuffer(), velocities, vec4Size, 0},
+        {bufferManager.getMovementParamsBuffer(), movementParams, entityCount * bufferManager.getMovementParamsStride(), 0},
+        {bufferManager.getRuntimeStateBuffer(), runtimeStates, entityCount * bufferManager.getRuntimeStateStride(), 0},
+        {bufferManager.getColorBuffer(), colorParams, entityCount * sizeof(glm::uvec4), 0},
+        {bufferManager.getPositionBuffer(), positions, vec4Size, 0},
+        {bufferManager.getPositionBufferAlternate(), positions, vec4Size, 0},
+        {bufferManager.getTargetPositionBuffer(), previousPositions, vec4Size, 0},
+        {bufferManager.getEntityIdBuffer(), slotSpawnIds, entityCount * sizeof(uint32_t), 0},
+        {bufferManager.getEntityTypeBuffer(), entityTypes, entityCount * sizeof(uint32_t), 0},
+    };
+    if (bufferManager.getCurrentPositionStride() == sizeof(glm::vec4)) {
+        regions.push_back({bufferManager.getCurrentPositionBuffer(), positions, vec4Size, 0});
+    }
+    if (modelMatrices) {
+        regions.push_back({bufferManager.getModelMatrixBuffer(), modelMatrices, entityCount * sizeof(glm::mat4), 0});
+    }
+    
+    // The spawn slot map is not saved: it is the inverse of the spawn ID column
+    std::vector<uint32_t> spawnSlots(header.spawnIdLimit, 0);
+    for (uint32_t slot = 0; slot < entityCount; ++slot) {
+        spawnSlots[slotSpawnIds[slot]] = slot;
+    }
+    if (!spawnSlots.empty()) {
+        regions.push_back({bufferManager.getSpawnSlotBuffer(), spawnSlots.data(), spawnSlots.size() * sizeof(uint32_t), 0});
+    }
+    if (entityCount > 0 && !bufferManager.uploadRegions(regions)) {
+        LOG_ERROR("GPUEntityManager: Snapshot upload failed");
+        clearAllEntities();
+        return false;
+    }
+    
+    // Tombstones and running lifetimes come back with the streams, so the expiry counter restarts at the
+    // tombstones the file holds
+    if (!bufferManager.isCompactLayout()) {
+        const auto* slotPositions = static_cast<const glm::vec4*>(positions);
+        const auto* slotStates = static_cast<const glm::vec4*>(runtimeStates);
+        for (uint32_t slot = 0; slot < entityCount; ++slot) {
+            expiredEntityCount += slotPositions[slot].w == 0.0f ? 1u : 0u;
+            hasLifetimeEntities = hasLifetimeEntities || slotStates[slot].y > 0.0f;
+        }
+        hasLifetimeEntities = hasLifetimeEntities || expiredEntityCount > 0;
+        bufferManager.uploadExpiredEntityCount(expiredEntityCount);
+    }
+    
+    // Spawn IDs missing from the slots were free when the snapshot was taken
+    spawnIdResident = std::move(resident);
+    spawnMap.reserveSpawnIds(nextSpawnId);
+    for (uint32_t spawnId = nextSpawnId; spawnId-- > 0;) {
+        if (!spawnIdResident[spawnId]) {
+            freeSpawnIds.push_back(spawnId);
+        }
+    }
+    
+    uint32_t reboundEntities = 0;
+    for (uint32_t spawnId = 0; world && spawnId < nextSpawnId; ++spawnId) {
+        if (spawnIdResident[spawnId] && ecsEntities[spawnId] != 0 && world->is_alive(ecsEntities[spawnId])) {
+            spawnMap.bind(spawnId, ecsEntities[spawnId]);
+            ecsWorld = world->c_ptr();
+            if (GPUSlot* slot = flecs::entity(*world, ecsEntities[spawnId]).get_mut<GPUSlot>()) {
+                slot->spawnId = spawnId;
+            }
+            ++reboundEntities;
+        }
+    }
+    
+    entitiesReordered = !spawnOrder;
+    spawnBoundsMin = glm::vec2(header.spawnBoundsMin[0], header.spawnBoundsMin[1]);
+    spawnBoundsMax = glm::vec2(header.spawnBoundsMax[0], header.spawnBoundsMax[1]);
+    updateIndirectCommands();
+    reconfigureSpatialGrid();
+    
+    frame = header.frame;
+    totalTime = header.totalTime;
+    LOG_INFO("GPUEntityManager: Restored " << entityCount << " entities from frame " << frame << " of " << path
+             << " (" << reboundEntities << " bound to ECS entities)");
+    return true;
+}
+
+void GPUEntityManager::setDrawIndexCount(uint32_t indexCount, bool expandedDraw) {
+    drawIndexCount = indexCount;
+    this->expandedDraw = expandedDraw;
+    shapeBinned = false;
+    updateIndirectCommands();
+    
+    // Culled draw keeps the index count; instanceCount is reset and rebuilt by the culling pass every frame.
+    // Expanded, it is the other way round: one instance, vertex count rebuilt every frame
+    VisibleDrawCommands visibleDraw{};
+    visibleDraw.draws[0].indexCount = expandedDraw ? 0 : drawIndexCount;
+    visibleDraw.draws[0].instanceCount = expandedDraw ? 1 : 0;
+    visibleDraw.drawCount = 1;
+    if (!bufferManager.uploadVisibleDrawCommands(visibleDraw)) {
+        LOG_ERROR("GPUEntityManager: Failed to upload visible draw command");
+    }
+}
+
+void GPUEntityManager::setShapeDraws(const std::vector<PolygonMeshRange>& ranges) {
+    if (ranges.size() != ENTITY_SHAPE_COUNT) {
+        LOG_ERROR("GPUEntityManager: Expected " << ENTITY_SHAPE_COUNT << " entity shape ranges, got " << ranges.size());
+        return;
+    }
+    
+    // The uncounted entity draw (culling off) still draws everything as shape 0
+    drawIndexCount = ranges[0].indexCount;
+    expandedDraw = false;
+    shapeBinned = true;
+    updateIndirectCommands();
+    
+    // Index ranges are fixed; instance counts, first instances and the draw count are rebuilt every frame
+    VisibleDrawCommands visibleDraw{};
+    for (uint32_t shape = 0; shape < ENTITY_SHAPE_COUNT; ++shape) {
+        visibleDraw.draws[shape].indexCount = ranges[shape].indexCount;
+        visibleDraw.draws[shape].firstIndex = ranges[shape].firstIndex;
+        visibleDraw.draws[shape].vertexOffset = ranges[shape].vertexOffset;
+    }
+    if (!bufferManager.uploadVisibleDrawCommands(visibleDraw)) {
+        LOG_ERROR("GPUEntityManager: Failed to upload visible draw commands");
+    }
+}
+
+EntityIndirectCommands GPUEntityManager::buildIndirectCommands() const {
+    EntityIndirectCommands commands{};
+    commands.entityDispatch.x = (activeEntityCount + THREADS_PER_WORKGROUP - 1) / THREADS_PER_WORKGROUP;
+    commands.entityDispatch.y = 1;
+    commands.entityDispatch.z = 1;
+    commands.liveEntityCount = activeEntityCount;
+    commands.entityDraw.indexCount = expandedDraw ? drawIndexCount * activeEntityCount : drawIndexCount;
+    commands.entityDraw.instanceCount = expandedDraw ? 1 : activeEntityCount;
+    return commands;
+}
+
+bool GPUEntityManager::updateIndirectCommands() {
+    if (!bufferManager.uploadIndirectCommands(buildIndirectCommands())) {
+        LOG_ERROR("GPUEntityManager: Failed to upload indirect commands");
+        return false;
+    }
+    return true;
 }
 
 // Core entity logic now clearly visible - descriptor management delegated to EntityDescriptorManager
 
 flecs::entity GPUEntityManager::getECSEntityFromGPUIndex(uint32_t gpuIndex) const {
-    if (gpuIndex < gpuIndexToECSEntity.size()) {
-        return gpuIndexToECSEntity[gpuIndex];
+    uint32_t spawnId = gpuIndex;
+    if (entitiesReordered && !bufferManager.readbackEntityId(gpuIndex, spawnId)) {
+        return flecs::entity{};
+    }
+    
+    return getECSEntityFromSpawnId(spawnId);
+}
+
+flecs::entity GPUEntityManager::getECSEntityFromSpawnId(uint32_t spawnId) const {
+    const flecs::entity_t entity = spawnMap.getEntity(spawnId);
+    if (entity != 0 && ecsWorld) {
+        return flecs::entity(ecsWorld, entity);
     }
     return flecs::entity{}; // Invalid entity
+}
+
+flecs::entity GPUEntityManager::resolveShadowEntity(uint32_t spawnId, flecs::world& world) {
+    flecs::entity entity = getECSEntityFromSpawnId(spawnId);
+    if (entity.is_valid() || spawnId >= emitterOrigins.size() || emitterOrigins[spawnId].emitter == EmitterOrigin::NONE) {
+        return entity;
+    }
+    
+    const EmitterOrigin origin = emitterOrigins[spawnId];
+    Transform transform;
+    MovementPattern pattern;
+    glm::vec3 position;
+    emitEntity(emitters[origin.emitter], origin.index, position, pattern);
+    transform.setPosition(position);
+    Renderable renderable;
+    renderable.color = glm::vec4(0.8f, 0.8f, 0.8f, 1.0f);
+    renderable.shape = emitters[origin.emitter].shape;
+    
+    entity = world.entity()
+        .set<Transform>(transform)
+        .set<Renderable>(renderable)
+        .set<MovementPattern>(pattern)
+        .add<Dynamic>()
+        .add<GPUDriven>();
+    
+    // Bound after the components are set, so the update observer does not resend what the GPU already holds
+    spawnMap.bind(spawnId, entity.id());
+    ecsWorld = world.c_ptr();
+    emitterOrigins[spawnId] = EmitterOrigin{};
+    return entity;
+}
+
+bool GPUEntityManager::requestRehydration(uint32_t spawnId, RehydrationCallback callback) {
+    // Whether the entity is resident is only checked when the state is applied, since the world may be progressing now
+    return bufferManager.requestEntityState(spawnId,
+        [this, spawnId, callback = std::move(callback)](bool found, const EntityBufferManager::EntityState& state) {
+            if (!found) return;
+            std::lock_guard<std::mutex> lock(rehydrationMutex);
+            arrivedRehydrations.push_back({spawnId, state, callback});
+        });
+}
+
+void GPUEntityManager::applyRehydrations() {
+    std::vector<Rehydration> arrived;
+    {
+        std::lock_guard<std::mutex> lock(rehydrationMutex);
+        arrived.swap(arrivedRehydrations);
+    }
+    
+    for (Rehydration& rehydration : arrived) {
+        // Despawned since the read, or the spawn ID recycled for a GPU-only entity
+        flecs::entity entity = getECSEntityFromSpawnId(rehydration.spawnId);
+        if (!entity.is_alive()) continue;
+        
+        if (entity.has<GPUResident>()) {
+            const EntityBufferManager::EntityState& state = rehydration.state;
+            Transform transform;
+            transform.setPosition(glm::vec3(state.position));
+            Renderable renderable;
+            renderable.color = glm::vec4(0.8f, 0.8f, 0.8f, 1.0f);
+            renderable.shape = static_cast<EntityShape>(state.entityType & EntityTypeBuffer::SHAPE_MASK);
+            MovementPattern pattern;
+            pattern.type = static_cast<MovementType>((state.entityType >> EntityTypeBuffer::MOVEMENT_SHIFT) & EntityTypeBuffer::MOVEMENT_MASK);
+            pattern.movementType = pattern.type;
+            pattern.amplitude = state.movementParams.x;
+            pattern.frequency = state.movementParams.y;
+            pattern.phase = state.movementParams.z;
+            pattern.timeOffset = state.movementParams.w;
+            pattern.center = transform.position;  // The GPU keeps no centre, it moves from the entity's position
+            
+            // Unbound while the components are set, so the update observer does not resend what was just read back.
+            // GPUSlot stays: removing it is what despawns a resident entity
+            spawnMap.unbind(entity.id());
+            entity.set<Transform>(transform)
+                .set<Renderable>(renderable)
+                .set<MovementPattern>(pattern)
+                .add<Dynamic>()
+                .add<GPUDriven>()
+                .remove<GPUResident>();
+            spawnMap.bind(rehydration.spawnId, entity.id());
+        }
+        
+        if (rehydration.callback) {
+            rehydration.callback(entity);
+        }
+    }
 }
\ No newline at end of file
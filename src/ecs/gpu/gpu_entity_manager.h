@@ -4,48 +4,139 @@
 #include "../components/entity.h"
 #include "entity_buffer_manager.h"
 #include "entity_descriptor_manager.h"
+#include "entity_spawn_map.h"
+#include "../../PolygonFactory.h"
+#include "../utilities/memory_tags.h"
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
 #include <vector>
 #include <memory>
+#include <memory_resource>
+#include <span>
+#include <unordered_map>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
 
 // Forward declarations
 class VulkanContext;
 class VulkanSync;
 class ResourceContext;
 
-// Structure of Arrays (SoA) for GPU entities - better cache locality and vectorization
+// Structure of Arrays (SoA) for GPU entities - better cache locality and vectorization. The streams are charged
+// to MemoryTag::EntityStaging; clear() keeps their capacity, so a steady spawn rate stops allocating
 struct GPUEntitySoA {
-    std::vector<glm::vec4> velocities;        // velocity.xy, damping, reserved
-    std::vector<glm::vec4> movementParams;    // amplitude, frequency, phase, timeOffset
-    std::vector<glm::vec4> runtimeStates;     // totalTime, initialized, stateTimer, entityState
-    std::vector<glm::vec4> colors;            // RGBA color
-    std::vector<glm::mat4> modelMatrices;     // transform matrices (cold data)
+    static std::pmr::memory_resource* getStagingResource() { return &MemoryTags::getResource(MemoryTag::EntityStaging); }
+    
+    std::pmr::vector<glm::vec4> velocities{getStagingResource()};      // velocity.xy, damping, asleep (set by physics)
+    std::pmr::vector<glm::vec4> movementParams{getStagingResource()};  // amplitude, frequency, phase, timeOffset
+    std::pmr::vector<glm::vec4> runtimeStates{getStagingResource()};   // totalTime, initialized, stateTimer, entityState
+    std::pmr::vector<glm::uvec4> colorParams{getStagingResource()};    // packed static colour terms (see packColorParams)
+    std::pmr::vector<glm::mat4> modelMatrices{getStagingResource()};   // transform matrices (cold data, only when storeModelMatrices)
+    std::pmr::vector<glm::vec4> spawnPositions{getStagingResource()};  // spawn position xyz, w = 1 (uploaded to every position buffer)
+    std::pmr::vector<uint32_t> spawnIds{getStagingResource()};         // stable spawn ID, assigned before the slot is staged
+    std::pmr::vector<uint32_t> entityTypes{getStagingResource()};      // EntityShape and MovementType (EntityTypeBuffer::pack)
+    
+    // Layouts without a model matrix stream skip composing and staging the matrices
+    bool storeModelMatrices = true;
     
     void reserve(size_t capacity) {
         velocities.reserve(capacity);
         movementParams.reserve(capacity);
         runtimeStates.reserve(capacity);
-        colors.reserve(capacity);
-        modelMatrices.reserve(capacity);
+        colorParams.reserve(capacity);
+        if (storeModelMatrices) modelMatrices.reserve(capacity);
+        spawnPositions.reserve(capacity);
+        spawnIds.reserve(capacity);
+        entityTypes.reserve(capacity);
     }
     
     void clear() {
         velocities.clear();
         movementParams.clear();
         runtimeStates.clear();
-        colors.clear();
+        colorParams.clear();
         modelMatrices.clear();
+        spawnPositions.clear();
+        spawnIds.clear();
+        entityTypes.clear();
+    }
+    
+    void resize(size_t count) {
+        velocities.resize(count);
+        movementParams.resize(count);
+        runtimeStates.resize(count);
+        colorParams.resize(count);
+        if (storeModelMatrices) modelMatrices.resize(count);
+        spawnPositions.resize(count);
+        spawnIds.resize(count);
+        entityTypes.resize(count);
     }
     
     size_t size() const { return velocities.size(); }
     bool empty() const { return velocities.empty(); }
     
-    // Add entity from ECS components
-    void addFromECS(const Transform& transform, const Renderable& renderable, const MovementPattern& pattern);
+    // Write entity from ECS components into a pre-sized slot (gpuIndex seeds the per-entity colour variation).
+    // Distinct slots touch disjoint memory, so chunks can be staged concurrently. cold is null for entities
+    // without a TransformCold, and is only read when the layout keeps model matrices.
+    void writeFromECS(size_t slot, const Transform& transform, const TransformCold* cold, const Renderable& renderable,
+                      const MovementPattern& pattern, uint32_t gpuIndex);
+    
+    // Move one staged entity to a lower slot (compaction after skipped entities).
+    // Spawn IDs are swapped rather than copied, so unused IDs collect in the trailing slots.
+    void moveEntry(size_t dst, size_t src);
 };
 
 
+// One sparse update in the word layout entity_update.comp reads: the movement params and colour streams of the
+// slot holding spawnId, as stream bits (movementParams is four floats, or two half2 words under ENTITY_COMPACT_LAYOUT)
+struct EntityUpdateRecord {
+    uint32_t spawnId = 0;
+    uint32_t movementType = 0;     // Replaces the MovementType bits of the slot's type stream
+    uint32_t reserved[2] = {};
+    glm::uvec4 movementParams{0u};
+    glm::uvec4 colorParams{0u};
+};
+static_assert(sizeof(EntityUpdateRecord) == 48, "EntityUpdateRecord must match the record stride in entity_update.comp");
+
+// Burst of entities initialised on the GPU (GPUEntityManager::spawnEmitter): count entities scattered over the
+// disc of radius around center, with movement params spread over the burst the way EntityFactory::createSwarm does
+struct EntityEmitter {
+    glm::vec3 center{0.0f};
+    float radius = 0.0f;
+    uint32_t count = 0;
+    uint32_t seed = 0;
+    float lifetime = 0.0f;  // Seconds each entity lives, counted down on the GPU; 0 = until despawned
+    EntityShape shape = EntityShape::Triangle;
+    MovementType movementType = MovementType::RandomWalk;
+};
+
+// One emitter in the word layout entity_spawn.comp reads; a burst spread over several passes resumes at firstIndex
+struct EntityEmitterRecord {
+    glm::vec4 centerRadius{0.0f};  // xyz = center, w = radius
+    uint32_t firstSpawn = 0;       // Batch entity the run of this emitter starts at
+    uint32_t firstIndex = 0;       // Index of that entity within the burst
+    uint32_t count = 0;            // Whole burst
+    uint32_t seed = 0;
+    float lifetime = 0.0f;
+    uint32_t entityType = 0;       // Written to every entity's type stream (EntityTypeBuffer)
+    uint32_t reserved[2] = {};
+};
+static_assert(sizeof(EntityEmitterRecord) == 48, "EntityEmitterRecord must match the record stride in entity_spawn.comp");
+
+// Entities of one spawn pass, records ordered by firstSpawn. The first reuseCount refill tombstone slots and keep
+// their spawn IDs; entity reuseCount + i is appended at slot baseSlot + i with spawnIds[i]
+struct EntityEmitterBatch {
+    std::vector<EntityEmitterRecord> records;
+    std::vector<uint32_t> spawnIds;
+    uint32_t baseSlot = 0;
+    uint32_t reuseCount = 0;
+    
+    uint32_t getSpawnCount() const { return reuseCount + static_cast<uint32_t>(spawnIds.size()); }
+    bool empty() const { return getSpawnCount() == 0; }
+};
+
 // Modular GPU Entity Manager for AAA Frame Graph Architecture
 class GPUEntityManager {
 public:
@@ -55,11 +146,119 @@ public:
     bool initialize(const VulkanContext& context, VulkanSync* sync, ResourceCoordinator* resourceCoordinator);
     void cleanup();
     
+    // Device loss (VulkanRenderer::recoverFromDeviceLoss): frees the buffers and descriptors of the lost device
+    // without waiting on it and forgets every entity, so initialize() can run again against the rebuilt context.
+    // Settings, the position mirror interval and queued frontend calls are kept; a telemetry capture ends
+    void releaseDeviceResources();
+    
     // Entity management - SoA approach
     void addEntitiesFromECS(const std::vector<flecs::entity>& entities);
+    
+    // GPU-resident entities (EntityFactory::createResidentSwarm): staged from the component columns, one entry per
+    // entity, instead of from the entities, whose GPUSlot only receives the spawn ID. Despawned when GPUSlot is
+    // removed, the way other entities are through their Renderable
+    void addResidentEntities(const std::vector<flecs::entity>& entities, const std::vector<Transform>& transforms,
+                             const std::vector<Renderable>& renderables, const std::vector<MovementPattern>& patterns);
+    
+    // Rehydration of a GPU-resident entity when a tool selects it: its slot, position, movement params and type are
+    // read back a few frames later (EntityBufferManager::requestEntityState), then applyRehydrations() gives it
+    // Transform, Renderable and MovementPattern from them and drops GPUResident, so it is edited like any other
+    // GPU-driven entity. callback then runs with the entity - also one that was never resident - on the frontend
+    // thread. False when nothing could be queued. Render thread, or a frontendCall
+    using RehydrationCallback = std::function<void(flecs::entity entity)>;
+    bool requestRehydration(uint32_t spawnId, RehydrationCallback callback = {});
+    
+    // Frontend thread, once per frame while neither the world nor a frame recording is running
+    void applyRehydrations();
     void uploadPendingEntities(); // Upload staged entities to GPU
     void clearAllEntities();
     
+    // Non-stalling upload for runtime spawns: copies run on the transfer queue into slots past the
+    // live count, and the count only grows once EntityUploadNode sees the transfer fence signalled
+    void uploadPendingEntitiesAsync();
+    bool hasUploadInFlight() const { return pendingUploadCount > 0; }
+    
+    // Called at the start of the compute frame - publishes a completed async upload by recording
+    // the new live count into the indirect command buffer. Returns true if the count changed.
+    bool commitCompletedUploads(VkCommandBuffer commandBuffer);
+    
+    // Per-entity despawn: queued by ECS entity, applied on the GPU by EntityDespawnNode with a
+    // swap-with-last compaction so the live range stays dense
+    void removeEntity(flecs::entity entity);
+    
+    // Batched removeEntity for a frame's worth of expiries (LifetimeSystem): one deferred call in render thread mode
+    void removeEntities(const std::vector<flecs::entity>& entities);
+    bool hasPendingDespawns() const { return !pendingDespawns.empty(); }
+    
+    // Resident spawn IDs for the next compaction pass (at most ENTITY_DESPAWN_MAX_BATCH). Empty
+    // while an async upload is in flight, because its slots are addressed from the live count.
+    std::vector<uint32_t> takeDespawnBatch();
+    
+    // Called by EntityDespawnNode after recording the compaction - shrinks the live count,
+    // recycles the spawn IDs and records the new count into the indirect command buffer
+    void commitDespawnBatch(VkCommandBuffer commandBuffer, const std::vector<uint32_t>& spawnIds);
+    
+    // Incremental sync of entities already handed to addEntitiesFromECS: re-reads the MovementPattern and queues
+    // a record that EntityUpdateNode scatters into the movement params and colour streams, so an edit costs one
+    // record instead of a re-upload. Repeated edits before the pass keep only the latest values
+    void updateEntity(flecs::entity entity);
+    bool hasPendingUpdates() const { return !pendingUpdates.empty(); }
+    
+    // Records of resident entities for the next scatter pass (at most ENTITY_UPDATE_MAX_BATCH); the rest stay queued
+    std::vector<EntityUpdateRecord> takeUpdateBatch();
+    
+    // Called by EntityUpdateNode after recording the scatter - the streams graphics reads changed in place
+    void commitUpdateBatch() { slotsMovedThisFrame = true; }
+    
+    // GPU-side spawning for particle-like bursts: the emitter is queued as is and EntitySpawnNode writes its
+    // entities straight into the buffers, with no ECS entities or per-entity staging on the CPU. They stay
+    // GPU-only - simulated and drawn, but invisible to the ECS - until resolveShadowEntity binds one
+    void spawnEmitter(const EntityEmitter& emitter);
+    bool hasPendingEmitters() const { return !pendingEmitters.empty(); }
+    
+    // Next spawn pass (at most ENTITY_EMITTER_MAX_BATCH emitters and ENTITY_EMITTER_MAX_SPAWNS entities that fit
+    // the buffers), placed from the live count. A leading run of lifetime emitter entities refills known
+    // tombstones first. Empty while an async upload is in flight, which owns those slots
+    EntityEmitterBatch takeEmitterBatch();
+    
+    // Called by EntitySpawnNode after recording the pass - grows the live count by the appended entities and
+    // records it into the indirect command buffer
+    void commitEmitterBatch(VkCommandBuffer commandBuffer, const EntityEmitterBatch& batch);
+    
+    // GPU lifetimes (EntityEmitter::lifetime): the physics pass counts expiries and leaves tombstones that spawn
+    // passes refill, so lifetime entities never reach the ECS. Called once per frame before recording, like
+    // refreshPositionMirror: keeps one readback of the expiry counter in flight while lifetime entities exist.
+    // Both counts are aggregates since the last clear and lag the GPU by the readback latency
+    void refreshExpiredEntityCount();
+    uint32_t getExpiredEntityCount() const { return expiredEntityCount; }
+    uint32_t getTombstoneCount() const { return expiredEntityCount - reusedTombstones; }
+    
+    // ECS entity of a spawn ID, created on first use for GPU-spawned entities from the same hash the spawn pass
+    // used (its Transform is the spawn position, like every GPU-driven entity's). From then on it despawns and
+    // updates the GPU entity like any other. Invalid for unknown spawn IDs. Frontend thread, or a frontendCall
+    flecs::entity resolveShadowEntity(uint32_t spawnId, flecs::world& world);
+    
+    // Exclusive upper bound of spawn IDs handed out so far (sizes the despawn mask clear)
+    uint32_t getSpawnIdLimit() const { return nextSpawnId; }
+    
+    // Capacity growth: staged spawns beyond the current buffer capacity wait until growCapacity runs
+    // at a frame boundary. Growth drains the GPU, copies the buffers and recreates the descriptor sets;
+    // frame graph imports and other holders of the raw handles rebind when the generation changes.
+    // Sparse entity buffers grow in place instead (grewInPlace): no drain, and every handle stays valid.
+    bool needsCapacityGrowth() const;
+    bool growCapacity();
+    uint64_t getBufferGeneration() const { return bufferManager.getGeneration(); }
+    bool grewInPlace() const { return bufferManager.grewInPlace(); }
+    
+    // ENTITY_COMPACT_LAYOUT storage - pipelines reading the movement params/runtime state streams specialise on it
+    bool isCompactLayout() const { return bufferManager.isCompactLayout(); }
+    
+    // Layout and binding mode bits of the entity compute pipelines, for nodes keying ComputePipelineHandles
+    uint64_t getComputeVariantKey() const {
+        return (isCompactLayout() ? 1u : 0u) | (descriptorManager.isBindless() ? 2u : 0u) |
+               (descriptorManager.usesStreamAddresses() ? 4u : 0u);
+    }
+    
     
     // Direct buffer access for frame graph - SoA buffers
     VkBuffer getVelocityBuffer() const { return bufferManager.getVelocityBuffer(); }
@@ -68,6 +267,49 @@ public:
     VkBuffer getColorBuffer() const { return bufferManager.getColorBuffer(); }
     VkBuffer getModelMatrixBuffer() const { return bufferManager.getModelMatrixBuffer(); }
     
+    // Spatial grid buffers (built each frame by the spatial grid compute passes)
+    VkBuffer getSpatialMapBuffer() const { return bufferManager.getSpatialMapBuffer(); }
+    VkBuffer getSpatialEntryBuffer() const { return bufferManager.getSpatialEntryBuffer(); }
+    VkBuffer getSpatialIndexBuffer() const { return bufferManager.getSpatialIndexBuffer(); }
+    VkBuffer getEntityIdBuffer() const { return bufferManager.getEntityIdBuffer(); }
+    VkBuffer getEntityTypeBuffer() const { return bufferManager.getEntityTypeBuffer(); }
+    
+    // Spawn ID -> GPU slot, kept by every pass that places or moves entities (entries of free IDs are stale)
+    VkBuffer getSpawnSlotBuffer() const { return bufferManager.getSpawnSlotBuffer(); }
+    
+    // Indirect dispatch/draw arguments sized from the GPU-resident live entity count
+    VkBuffer getIndirectCommandBuffer() const { return bufferManager.getIndirectCommandBuffer(); }
+    VkDeviceAddress getIndirectCommandAddress() const { return bufferManager.getIndirectCommandAddress(); } // 0 without buffer device address
+    VkDeviceSize getIndirectDispatchOffset() const { return EntityIndirectCommandBuffer::getDispatchOffset(); }
+    VkDeviceSize getIndirectDrawOffset() const { return EntityIndirectCommandBuffer::getDrawOffset(); }
+    VkDeviceSize getActiveDispatchOffset() const { return EntityIndirectCommandBuffer::getActiveDispatchOffset(); }
+    VkDeviceSize getMovementDispatchOffset(uint32_t type) const { return EntityIndirectCommandBuffer::getMovementDispatchOffset(type); }
+    // expandedDraw: the culled draw is one instance whose vertex count the culling pass grows by indexCount per
+    // visible entity, rather than indexCount vertices per visible instance
+    void setDrawIndexCount(uint32_t indexCount, bool expandedDraw = false);
+    bool isExpandedDraw() const { return expandedDraw; }
+    // Shape binning: one culled draw per entity shape, drawn from the merged entity mesh at these ranges (in
+    // EntityShape order); the culling and binning passes fill each draw's instance count and first instance
+    void setShapeDraws(const std::vector<PolygonMeshRange>& ranges);
+    bool isShapeBinned() const { return shapeBinned; }
+    
+    // GPU frustum culling output (compacted visible indices + indirect draw built each frame)
+    VkBuffer getVisibleIndexBuffer() const { return bufferManager.getVisibleIndexBuffer(); }
+    VkBuffer getVisibleDrawCommandBuffer() const { return bufferManager.getVisibleDrawCommandBuffer(); }
+    VkDeviceSize getVisibleIndexBufferSize() const { return bufferManager.getVisibleIndexBufferSize(); }
+    VkDeviceSize getVisibleDrawCommandBufferSize() const { return bufferManager.getVisibleDrawCommandBufferSize(); }
+    // Word of the culled draw the culling pass resets and counts visible entities into
+    VkDeviceSize getVisibleDrawCounterOffset() const {
+        return expandedDraw ? VisibleDrawCommandBuffer::getIndexCountOffset() : VisibleDrawCommandBuffer::getInstanceCountOffset();
+    }
+    
+    // Density LOD: set by EntityCullingNode when this frame's visible index buffer holds tile counts rather than
+    // indices; each published snapshot keeps the flag its copy was taken with
+    void setDensityTilesCulled(bool tiles) { densityTilesCulled = tiles; }
+    bool hasDensityTiles(bool publishedSnapshot, uint32_t slot) const {
+        return publishedSnapshot ? publishedDensityTiles[slot % PUBLISHED_SNAPSHOT_COUNT] : densityTilesCulled;
+    }
+    
     // Position buffers remain the same
     VkBuffer getPositionBuffer() const { return bufferManager.getPositionBuffer(); }
     VkBuffer getPositionBufferAlternate() const { return bufferManager.getPositionBufferAlternate(); }
@@ -75,9 +317,34 @@ public:
     VkBuffer getTargetPositionBuffer() const { return bufferManager.getTargetPositionBuffer(); }
     
     
-    // Async compute support - ping-pong between position buffers
-    VkBuffer getComputeWriteBuffer(uint32_t frameIndex) const { return bufferManager.getComputeWriteBuffer(frameIndex); }
-    VkBuffer getGraphicsReadBuffer(uint32_t frameIndex) const { return bufferManager.getGraphicsReadBuffer(frameIndex); }
+    // Async compute support - ring of published position snapshots
+    VkBuffer getComputeWriteBuffer(uint32_t frame) const { return bufferManager.getComputeWriteBuffer(frame); }
+    VkBuffer getGraphicsReadBuffer(uint32_t frame) const { return bufferManager.getGraphicsReadBuffer(frame); }
+    
+    // Pipelined async compute (ENABLE_PIPELINED_ASYNC_COMPUTE on timeline pacing). EntityPublishNode copies the
+    // positions and culled draw into ring slot N % PUBLISHED_SNAPSHOT_COUNT and graphics frame N draws the slot
+    // with the newest producer tag, so compute and raster of one frame overlap. Frames that move entity slots
+    // (despawn, reorder, clear) or have no previous snapshot draw their own snapshot and the graphics submit
+    // waits on this frame's compute. Each slot also carries a consumer tag, the graphics timeline value of the
+    // last submit that drew it: compute only waits on that one before overwriting the slot, which lets it run
+    // up to PUBLISHED_SNAPSHOT_COUNT - 1 frames ahead of graphics.
+    bool isPipelinedComputeActive() const;
+    bool snapshotsNeedOwnershipTransfer() const;  // Compute and graphics queues are in different families
+    
+    // Called by EntityPublishNode before recording the copies - returns the slot this frame publishes into
+    uint32_t beginSnapshotPublish();
+    uint32_t getGraphicsSnapshotSlot() const { return graphicsSnapshotSlot; }
+    bool isGraphicsLaggingCompute() const { return graphicsLagsCompute; }
+    
+    // Graphics timeline value this frame's compute submit has to wait for (the consumer tag of the slot it
+    // overwrites); only meaningful while graphics lags, frames that move slots wait on the previous graphics frame
+    uint64_t getSnapshotWriteAfterReadValue() const { return snapshotWriteAfterReadValue; }
+    // After the graphics submit: tags the slot this frame drew with the value it signals
+    void markSnapshotDrawn(uint64_t graphicsTimelineValue);
+    
+    // Snapshot slots released by compute that this frame's graphics pass must acquire (bit per slot).
+    // A lagging graphics pass leaves this frame's release for the next one, whose submit waits on it.
+    uint32_t takeSnapshotAcquires();
     
     // Buffer properties - SoA approach
     VkDeviceSize getVelocityBufferSize() const { return bufferManager.getVelocityBufferSize(); }
@@ -86,25 +353,86 @@ public:
     VkDeviceSize getColorBufferSize() const { return bufferManager.getColorBufferSize(); }
     VkDeviceSize getModelMatrixBufferSize() const { return bufferManager.getModelMatrixBufferSize(); }
     VkDeviceSize getPositionBufferSize() const { return bufferManager.getPositionBufferSize(); }
+    VkDeviceSize getCurrentPositionBufferSize() const { return bufferManager.getCurrentPositionBufferSize(); }
+    VkDeviceSize getSpatialMapBufferSize() const { return bufferManager.getSpatialMapBufferSize(); }
+    VkDeviceSize getSpatialEntryBufferSize() const { return bufferManager.getSpatialEntryBufferSize(); }
+    VkDeviceSize getSpatialIndexBufferSize() const { return bufferManager.getSpatialIndexBufferSize(); }
+    VkDeviceSize getEntityIdBufferSize() const { return bufferManager.getEntityIdBufferSize(); }
     
     
     // Entity state
     uint32_t getEntityCount() const { return activeEntityCount; }
+    
+    // Bumped whenever slots receive entities that have had no movement update yet: uploads, emitter spawns
+    // (tombstone refills included), clears and snapshot restores. The live count alone misses refills and
+    // same-size respawns
+    uint64_t getSpawnGeneration() const { return spawnGeneration; }
     uint32_t getMaxEntities() const { return bufferManager.getMaxEntities(); }
-    bool hasPendingUploads() const { return !stagingEntities.empty(); }
+    const SpatialGridConfig& getSpatialGridConfig() const { return bufferManager.getSpatialGridConfig(); }
+    bool hasPendingUploads() const { return !isDeferredFrontendCall() && !stagingEntities.empty(); }
+    
+    // Spatial grid cell size (SpatialCellTuner), grid re-selected for it; render thread, from the next frame's grid build
+    void setSpatialCellSize(float cellSize);
+    
+    // Render thread mode: while another thread records and submits frames, spawns, despawns and frontendCall()
+    // requests made on the frontend thread are queued, and applyDeferredFrontendCalls() runs them in order at
+    // the frame handoff, while the render thread is idle. Upload calls from the frontend thread are no-ops;
+    // the renderer uploads at the start of every frame. Set or clear only while no frame is being recorded
+    void setDeferredFrontendThread(std::thread::id thread) { deferredFrontendThread = thread; }
+    void applyDeferredFrontendCalls();
+    
+    // Runs call now, or queues it for the handoff when made on the deferred frontend thread
+    void frontendCall(std::function<void()> call);
     
     // Descriptor management delegation
     EntityDescriptorManager& getDescriptorManager() { return descriptorManager; }
     const EntityDescriptorManager& getDescriptorManager() const { return descriptorManager; }
     
+    // CPU position mirror over the live range, for spatial queries that should not wait on the GPU
+    void refreshPositionMirror(uint32_t frame) { bufferManager.refreshPositionMirror(frame, activeEntityCount); }
+    EntityPositionMirror& getPositionMirror() { return bufferManager.getPositionMirror(); }
+    const EntityPositionMirror& getPositionMirror() const { return bufferManager.getPositionMirror(); }
+    
+    // Streaming telemetry capture over the live range (EntityBufferManager::startTelemetryCapture)
+    void refreshTelemetryCapture(uint32_t frame) { bufferManager.refreshTelemetryCapture(frame, activeEntityCount); }
+    // Entity streaming to remote viewers, the same way (EntityBufferManager::startEntityStream)
+    void refreshEntityStream(uint32_t frame) { bufferManager.refreshEntityStream(frame, activeEntityCount); }
+    
+    // Live entity AABB, centroid and count from the GPU reduction, any thread (EntityBoundsNode); GPU-spawned
+    // entities and simulated positions included, unlike the ECS Transforms
+    EntityBounds getEntityBounds() const { return bufferManager.getEntityBounds(); }
+    
+    // Collision, cell overflow and direction change counts from the physics pass, any thread (PhysicsComputeNode)
+    SimulationCounters getSimulationCounters() const { return bufferManager.getSimulationCounters(); }
+    
     // Debug access to buffer manager for spatial map readback
     const EntityBufferManager& getBufferManager() const { return bufferManager; }
+    EntityBufferManager& getBufferManager() { return bufferManager; }
     
     // Debug: Get ECS entity ID from GPU buffer index
     flecs::entity getECSEntityFromGPUIndex(uint32_t gpuIndex) const;
+    
+    // Debug: Get ECS entity from a spawn ID already read back from the entity ID buffer
+    flecs::entity getECSEntityFromSpawnId(uint32_t spawnId) const;
+    
+    // Spawn ID bound to an ECS entity, EntitySpawnMap::NO_SPAWN_ID for entities never uploaded or already
+    // removed; O(1), main thread
+    uint32_t getSpawnId(flecs::entity entity) const { return spawnMap.find(entity.id()); }
+    
+    // Called by the reorder pass once GPU slots no longer match spawn order
+    void markEntitiesReordered() { entitiesReordered = true; slotsMovedThisFrame = true; }
+    
+    // Entity state snapshots (entity_snapshot.h); the GPU must be idle. Save reads back every stream of the live
+    // range, the positions and the spawn ID map; staged entities have no GPU state yet and are left out.
+    // Load replaces all entities with the file's, uploaded straight from the mapped columns in one submit, and
+    // fails without touching the current entities when the file does not match this stream layout. Spawn IDs
+    // are rebound to the ECS entities still alive in world - only those of the same process ever are - and
+    // the others stay GPU-only: simulated and drawn, but never despawned or updated through the ECS
+    bool saveSnapshot(const std::string& path, uint64_t frame, float totalTime);
+    bool loadSnapshot(const std::string& path, uint64_t& frame, float& totalTime, flecs::world* world = nullptr);
 
 private:
-    static constexpr uint32_t MAX_ENTITIES = 131072; // 128k entities max
+    static constexpr size_t PARALLEL_STAGING_MIN_CHUNK = 4096; // Smaller batches are staged inline
     
     // Dependencies
     const VulkanContext* context = nullptr;
@@ -118,7 +446,122 @@ private:
     // Staging data - SoA approach
     GPUEntitySoA stagingEntities;
     uint32_t activeEntityCount = 0;
+    uint64_t spawnGeneration = 0;
+    
+    // Index count of the entity mesh, baked into the indirect draw command
+    uint32_t drawIndexCount = 0;
+    bool expandedDraw = false;
+    bool shapeBinned = false;
     
-    // Debug: Mapping from GPU buffer index to ECS entity ID
-    std::vector<flecs::entity> gpuIndexToECSEntity;
+    // Entities copied by the in-flight async upload, not yet part of activeEntityCount
+    uint32_t pendingUploadCount = 0;
+    
+    // Published snapshot bookkeeping (pipelined async compute)
+    uint64_t publishedFrameCount = 0;      // Snapshots published since the buffers were (re)created
+    uint32_t publishSlot = 0;
+    uint32_t graphicsSnapshotSlot = 0;
+    uint32_t pendingSnapshotAcquires = 0;  // Released by compute, not yet acquired by graphics
+    uint64_t snapshotWriteAfterReadValue = 0;
+    std::array<uint64_t, PUBLISHED_SNAPSHOT_COUNT> snapshotProducerFrames{};  // publishedFrameCount after the slot's copy, 0 = empty
+    std::array<uint64_t, PUBLISHED_SNAPSHOT_COUNT> snapshotReadValues{};      // Graphics timeline value of its last reader
+    bool graphicsLagsCompute = false;
+    bool slotsMovedThisFrame = false;      // Colour/movement streams changed slots (or, multi-device, were spawned into) since the last publish
+    bool densityTilesCulled = false;
+    std::array<bool, PUBLISHED_SNAPSHOT_COUNT> publishedDensityTiles{};
+    
+    // Rewrite indirect commands after the live entity count changes (spawn/despawn path)
+    EntityIndirectCommands buildIndirectCommands() const;
+    bool updateIndirectCommands();
+    
+    // Record the indirect command rewrite into a frame command buffer (async upload and despawn commits)
+    void recordIndirectCommandUpdate(VkCommandBuffer commandBuffer);
+    
+    // Block on an in-flight async upload and fold it into the live count (sync paths only)
+    void finishAsyncUpload();
+    
+    // Extend the spawn bounds with the staged entities placed at baseIndex
+    void updateSpawnBounds(uint32_t baseIndex);
+    
+    // CPU side of clearAllEntities - every slot, spawn ID and emitter is forgotten, the buffers are not touched
+    void resetEntityState();
+    
+    // Re-select grid resolution for the live entity count and spawn area
+    void reconfigureSpatialGrid();
+    
+    // Spawn area of uploaded entities, used to size the spatial grid
+    glm::vec2 spawnBoundsMin{0.0f};
+    glm::vec2 spawnBoundsMax{0.0f};
+    
+    // Spawn ID <-> ECS entity, and the world the entities live in
+    EntitySpawnMap spawnMap;
+    flecs::world_t* ecsWorld = nullptr;
+    bool entitiesReordered = false;  // GPU slots permuted - resolve spawn ID through EntityIdBuffer
+    
+    // Entities resident, uploading, staged or queued in emitters - what the buffers must hold once staging lands
+    uint32_t getRequiredCapacity() const;
+    
+    // Spawn ID allocation - despawned IDs are recycled, so IDs stay below ENTITY_CAPACITY_MAX
+    uint32_t allocateSpawnId();
+    void markResident(std::span<const uint32_t> spawnIds);
+    std::vector<uint32_t> freeSpawnIds;
+    uint32_t nextSpawnId = 0;
+    
+    // Despawn bookkeeping - only spawn IDs whose upload has landed can be compacted away
+    std::vector<uint8_t> spawnIdResident;
+    std::vector<uint32_t> inFlightSpawnIds;   // Spawn IDs of the in-flight async upload
+    std::vector<uint32_t> pendingDespawns;    // Queued spawn IDs, resident or not yet
+    
+    // GPU spawn bookkeeping - every emitter since the last clear is kept, so a shadow entity can be rebuilt for
+    // any spawn ID it placed until that ID is bound or recycled
+    struct PendingEmitter {
+        uint32_t emitter = 0;   // emitters index
+        uint32_t emitted = 0;   // Entities already handed to a spawn pass
+    };
+    struct EmitterOrigin {
+        static constexpr uint32_t NONE = ~0u;
+        uint32_t emitter = NONE;
+        uint32_t index = 0;     // Within the burst
+    };
+    std::vector<EntityEmitter> emitters;
+    std::vector<PendingEmitter> pendingEmitters;
+    uint32_t pendingEmitterEntities = 0;
+    std::vector<EmitterOrigin> emitterOrigins;  // Per spawn ID, NONE for lifetime emitter entities
+    
+    // GPU lifetime bookkeeping - only counts; tombstone slots are found by the spawn pass itself
+    uint32_t expiredEntityCount = 0;   // GPU expiry counter as last read back
+    uint32_t reusedTombstones = 0;     // Handed to spawn passes
+    uint32_t expiryEpoch = 0;          // Bumped whenever the counter is reset, so older readbacks are dropped
+    bool expiryReadbackInFlight = false;
+    bool hasLifetimeEntities = false;
+    
+    // ECS component columns of GPU-resident entities, which carry none themselves (addResidentEntities)
+    struct ResidentColumns {
+        const Transform* transforms = nullptr;
+        const Renderable* renderables = nullptr;
+        const MovementPattern* patterns = nullptr;
+    };
+    
+    // Shared by both add paths: stages entities from columns when given, otherwise from their components
+    void stageEntities(const std::vector<flecs::entity>& entities, const ResidentColumns* columns);
+    
+    // Rehydration bookkeeping - states arrive from readback callbacks on the render thread
+    struct Rehydration {
+        uint32_t spawnId = 0;
+        EntityBufferManager::EntityState state;
+        RehydrationCallback callback;
+    };
+    std::mutex rehydrationMutex;
+    std::vector<Rehydration> arrivedRehydrations;
+    
+    // Sparse update bookkeeping - one record per spawn ID, dropped when the entity despawns
+    std::vector<EntityUpdateRecord> pendingUpdates;
+    std::unordered_map<uint32_t, size_t> pendingUpdateIndex;  // spawn ID -> pendingUpdates position
+    void dropPendingUpdate(uint32_t spawnId);
+    
+    // Render thread mode
+    bool isDeferredFrontendCall() const {
+        return deferredFrontendThread != std::thread::id{} && deferredFrontendThread == std::this_thread::get_id();
+    }
+    std::thread::id deferredFrontendThread{};
+    std::vector<std::function<void()>> deferredFrontendCalls;
 };
\ No newline at end of file
@@ -10,7 +10,8 @@ PositionBufferCoordinator::~PositionBufferCoordinator() {
     cleanup();
 }
 
-bool PositionBufferCoordinator::initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities) {
+bool PositionBufferCoordinator::initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities,
+                                           bool compactLayout, bool exportSnapshots) {
     this->maxEntities = maxEntities;
     
     // Initialize all position buffers
@@ -24,7 +25,8 @@ bool PositionBufferCoordinator::initialize(const VulkanContext& context, Resourc
         return false;
     }
     
-    if (!currentBuffer.initialize(context, resourceCoordinator, maxEntities)) {
+    const VkDeviceSize currentStride = EntityStreamSchema::getStride(EntityDescriptorBindings::Compute::CURRENT_POSITION_BUFFER, compactLayout);
+    if (!currentBuffer.initialize(context, resourceCoordinator, maxEntities, currentStride)) {
         std::cerr << "PositionBufferCoordinator: Failed to initialize current buffer" << std::endl;
         return false;
     }
@@ -34,11 +36,25 @@ bool PositionBufferCoordinator::initialize(const VulkanContext& context, Resourc
         return false;
     }
     
+    if constexpr (ENABLE_PIPELINED_ASYNC_COMPUTE) {
+        for (auto& published : publishedBuffers) {
+            published.setExternalExport(exportSnapshots);
+            published.setRenderDeviceMirror(true);
+            if (!published.initialize(context, resourceCoordinator, maxEntities)) {
+                std::cerr << "PositionBufferCoordinator: Failed to initialize published snapshot buffer" << std::endl;
+                return false;
+            }
+        }
+    }
+    
     std::cout << "PositionBufferCoordinator: Initialized successfully for " << maxEntities << " entities" << std::endl;
     return true;
 }
 
 void PositionBufferCoordinator::cleanup() {
+    for (auto& published : publishedBuffers) {
+        published.cleanup();
+    }
     targetBuffer.cleanup();
     currentBuffer.cleanup();
     alternateBuffer.cleanup();
@@ -46,19 +62,47 @@ void PositionBufferCoordinator::cleanup() {
     maxEntities = 0;
 }
 
-VkBuffer PositionBufferCoordinator::getComputeWriteBuffer(uint32_t frameIndex) const {
-    // Compute writes to different buffer each frame (ping-pong)
-    return (frameIndex % 2 == 0) ? primaryBuffer.getBuffer() : alternateBuffer.getBuffer();
+bool PositionBufferCoordinator::resize(uint32_t newMaxEntities, SparseBindBatch* sparseBinds) {
+    if (!primaryBuffer.resize(newMaxEntities, true, sparseBinds) ||
+        !alternateBuffer.resize(newMaxEntities, true, sparseBinds) ||
+        !currentBuffer.resize(newMaxEntities, true, sparseBinds) ||
+        !targetBuffer.resize(newMaxEntities, true, sparseBinds)) {
+        std::cerr << "PositionBufferCoordinator: Failed to grow position buffers to " << newMaxEntities << " entities" << std::endl;
+        return false;
+    }
+    
+    for (auto& published : publishedBuffers) {
+        if (published.isInitialized() && !published.resize(newMaxEntities, false, sparseBinds)) {
+            std::cerr << "PositionBufferCoordinator: Failed to grow published snapshot buffers to " << newMaxEntities << " entities" << std::endl;
+            return false;
+        }
+    }
+    
+    maxEntities = newMaxEntities;
+    return true;
+}
+
+bool PositionBufferCoordinator::canGrowInPlace(uint32_t newMaxEntities) const {
+    bool inPlace = primaryBuffer.canGrowInPlace(newMaxEntities) && alternateBuffer.canGrowInPlace(newMaxEntities) &&
+                   currentBuffer.canGrowInPlace(newMaxEntities) && targetBuffer.canGrowInPlace(newMaxEntities);
+    for (const auto& published : publishedBuffers) {
+        inPlace = inPlace && (!published.isInitialized() || published.canGrowInPlace(newMaxEntities));
+    }
+    return inPlace;
 }
 
-VkBuffer PositionBufferCoordinator::getGraphicsReadBuffer(uint32_t frameIndex) const {
-    // SIMPLE FIX: On frame 0, read from same buffer compute writes to (no "previous" frame)
-    // This prevents reading garbage data on the very first frame
-    if (frameIndex == 0) {
-        return getComputeWriteBuffer(0); // primaryBuffer for frame 0
-    }
-    // Normal ping-pong: graphics reads from previous frame's compute output  
-    return (frameIndex % 2 == 0) ? alternateBuffer.getBuffer() : primaryBuffer.getBuffer();
+VkBuffer PositionBufferCoordinator::getComputeWriteBuffer(uint32_t frame) const {
+    // Compute publishes into the next ring slot each frame
+    return publishedBuffers[frame % PUBLISHED_SNAPSHOT_COUNT].getBuffer();
+}
+
+VkBuffer PositionBufferCoordinator::getGraphicsReadBuffer(uint32_t frame) const {
+    // On frame 0 there is no previous snapshot, so graphics reads the one being published
+    if (frame == 0) {
+        return getComputeWriteBuffer(0);
+    }
+    // Graphics reads the previous frame's published snapshot
+    return publishedBuffers[(frame - 1) % PUBLISHED_SNAPSHOT_COUNT].getBuffer();
 }
 
 bool PositionBufferCoordinator::uploadToAllBuffers(const void* data, VkDeviceSize size, VkDeviceSize offset) {
@@ -79,7 +123,7 @@ bool PositionBufferCoordinator::uploadToAllBuffers(const void* data, VkDeviceSiz
         allSucceeded = false;
     }
     
-    if (!currentBuffer.copyData(data, size, offset)) {
+    if (currentBuffer.getElementSize() == sizeof(glm::vec4) && !currentBuffer.copyData(data, size, offset)) {
         std::cerr << "PositionBufferCoordinator: Failed to upload to current buffer" << std::endl;
         allSucceeded = false;
     }
@@ -108,6 +152,14 @@ bool PositionBufferCoordinator::uploadToTarget(const void* data, VkDeviceSize si
     return targetBuffer.copyData(data, size, offset);
 }
 
+VkDeviceSize PositionBufferCoordinator::getTotalSize() const {
+    VkDeviceSize total = primaryBuffer.getSize() + alternateBuffer.getSize() + currentBuffer.getSize() + targetBuffer.getSize();
+    for (const auto& published : publishedBuffers) {
+        total += published.getSize();
+    }
+    return total;
+}
+
 bool PositionBufferCoordinator::isInitialized() const {
     return primaryBuffer.isInitialized() && 
            alternateBuffer.isInitialized() && 
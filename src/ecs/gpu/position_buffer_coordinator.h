@@ -1,7 +1,9 @@
 #pragma once
 
 #include "specialized_buffers.h"
+#include "../../vulkan/core/vulkan_constants.h"
 #include <vulkan/vulkan.h>
+#include <array>
 
 // Forward declarations
 class VulkanContext;
@@ -16,12 +18,27 @@ public:
     PositionBufferCoordinator();
     ~PositionBufferCoordinator();
     
-    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities);
+    // compactLayout (ENTITY_COMPACT_LAYOUT) stores the current buffer, the start-of-tick neighbour snapshot the
+    // grid count pass writes, as vec2: physics reads it once per neighbour tested, so it carries most of the
+    // position traffic, and only xy is ever read from it. The compact layout has no lifetimes, hence no
+    // tombstones (w = 0) that the snapshot would need to keep
+    // exportSnapshots allocates the published snapshots as exportable memory (ENABLE_EXTERNAL_POSITION_EXPORT)
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities,
+                    bool compactLayout = false, bool exportSnapshots = false);
     void cleanup();
     
-    // Ping-pong buffer access for async compute
-    VkBuffer getComputeWriteBuffer(uint32_t frameIndex) const;
-    VkBuffer getGraphicsReadBuffer(uint32_t frameIndex) const;
+    // Grow all position buffers, keeping their positions (GPU must be idle unless canGrowInPlace); sparse
+    // buffers queue their page binds into sparseBinds
+    bool resize(uint32_t newMaxEntities, SparseBindBatch* sparseBinds = nullptr);
+    bool canGrowInPlace(uint32_t newMaxEntities) const;
+    
+    // Published snapshots for pipelined async compute, indexed by global frame: compute frame N copies the
+    // primary positions into snapshot N % PUBLISHED_SNAPSHOT_COUNT and graphics frame N reads the one published
+    // by frame N - 1 (GPUEntityManager picks the slot actually drawn from its producer tags).
+    // VK_NULL_HANDLE when ENABLE_PIPELINED_ASYNC_COMPUTE is off.
+    VkBuffer getComputeWriteBuffer(uint32_t frame) const;
+    VkBuffer getGraphicsReadBuffer(uint32_t frame) const;
+    const PositionBuffer& getPublishedBuffer(uint32_t slot) const { return publishedBuffers[slot % PUBLISHED_SNAPSHOT_COUNT]; }
     
     // Direct buffer access
     VkBuffer getPrimaryBuffer() const { return primaryBuffer.getBuffer(); }
@@ -31,9 +48,13 @@ public:
     
     // Buffer properties
     VkDeviceSize getBufferSize() const { return primaryBuffer.getSize(); }
+    VkDeviceSize getCurrentBufferSize() const { return currentBuffer.getSize(); }
+    VkDeviceSize getCurrentStride() const { return currentBuffer.getElementSize(); }
+    VkDeviceSize getTotalSize() const;  // Every position and snapshot buffer
     uint32_t getMaxEntities() const { return primaryBuffer.getMaxElements(); }
     
-    // Data upload to all position buffers
+    // Data upload (vec4 positions) to all position buffers; a compact current buffer is skipped, since the
+    // count pass rebuilds it before anything reads it
     bool uploadToAllBuffers(const void* data, VkDeviceSize size, VkDeviceSize offset = 0);
     
     // Individual buffer upload
@@ -49,7 +70,10 @@ private:
     PositionBuffer primaryBuffer;        // Main position buffer (ping)
     PositionBuffer alternateBuffer;      // Alternate position buffer (pong)
     PositionBuffer currentBuffer;        // Current frame positions
-    PositionBuffer targetBuffer;         // Target positions for interpolation
+    PositionBuffer targetBuffer;         // Positions at the start of the latest simulation tick, interpolated from
+    
+    // Compute-to-graphics snapshots (contents are rewritten every frame, so resize does not copy them)
+    std::array<PositionBuffer, PUBLISHED_SNAPSHOT_COUNT> publishedBuffers;
     
     uint32_t maxEntities = 0;
 };
\ No newline at end of file
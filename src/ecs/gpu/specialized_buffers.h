@@ -1,33 +1,42 @@
 #pragma once
 
 #include "buffer_base.h"
+#include "entity_stream_schema.h"
+#include "../../vulkan/core/vulkan_constants.h"
 #include <glm/glm.hpp>
+#include <cstddef>
 
 /**
  * Specialized buffer classes following Single Responsibility Principle
- * Each class manages exactly one type of entity data
+ * Each class manages exactly one type of entity data, with the element stride EntityStreamSchema gives its binding
  */
 
 // SINGLE responsibility: velocity data management
 class VelocityBuffer : public BufferBase {
 public:
     using BufferBase::initialize; // Bring base class initialize into scope
+    static constexpr uint32_t BINDING = EntityDescriptorBindings::Compute::VELOCITY_BUFFER;
     
     bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities) {
-        return BufferBase::initialize(context, resourceCoordinator, maxEntities, sizeof(glm::vec4), 0);
+        return BufferBase::initialize(context, resourceCoordinator, maxEntities, EntityStreamSchema::getStride(BINDING), 0,
+                                      ENTITY_CAPACITY_MAX);
     }
     
 protected:
     const char* getBufferTypeName() const override { return "Velocity"; }
+    MemoryAllocator::Priority getMemoryPriority() const override { return MemoryAllocator::Priority::High; }
 };
 
 // SINGLE responsibility: movement parameters management
 class MovementParamsBuffer : public BufferBase {
 public:
     using BufferBase::initialize; // Bring base class initialize into scope
+    static constexpr uint32_t BINDING = EntityDescriptorBindings::Compute::MOVEMENT_PARAMS_BUFFER;
     
-    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities) {
-        return BufferBase::initialize(context, resourceCoordinator, maxEntities, sizeof(glm::vec4), 0);
+    // Compact layout stores amplitude, frequency, phase, timeOffset as fp16 (uvec2)
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities, bool compactLayout) {
+        VkDeviceSize stride = EntityStreamSchema::getStride(BINDING, compactLayout);
+        return BufferBase::initialize(context, resourceCoordinator, maxEntities, stride, 0, ENTITY_CAPACITY_MAX);
     }
     
 protected:
@@ -38,22 +47,27 @@ protected:
 class RuntimeStateBuffer : public BufferBase {
 public:
     using BufferBase::initialize; // Bring base class initialize into scope
+    static constexpr uint32_t BINDING = EntityDescriptorBindings::Compute::RUNTIME_STATE_BUFFER;
     
-    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities) {
-        return BufferBase::initialize(context, resourceCoordinator, maxEntities, sizeof(glm::vec4), 0);
+    // Compact layout packs flags (low 16 bits) and fp16 stateTimer (high 16 bits) into one uint
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities, bool compactLayout) {
+        VkDeviceSize stride = EntityStreamSchema::getStride(BINDING, compactLayout);
+        return BufferBase::initialize(context, resourceCoordinator, maxEntities, stride, 0, ENTITY_CAPACITY_MAX);
     }
     
 protected:
     const char* getBufferTypeName() const override { return "RuntimeState"; }
 };
 
-// SINGLE responsibility: color data management
+// SINGLE responsibility: packed static colour parameters (read by the vertex shader)
 class ColorBuffer : public BufferBase {
 public:
     using BufferBase::initialize; // Bring base class initialize into scope
+    static constexpr uint32_t BINDING = EntityDescriptorBindings::Compute::COLOR_BUFFER;
     
     bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities) {
-        return BufferBase::initialize(context, resourceCoordinator, maxEntities, sizeof(glm::vec4), 0);
+        return BufferBase::initialize(context, resourceCoordinator, maxEntities, EntityStreamSchema::getStride(BINDING), 0,
+                                      ENTITY_CAPACITY_MAX);
     }
     
 protected:
@@ -64,9 +78,11 @@ protected:
 class ModelMatrixBuffer : public BufferBase {
 public:
     using BufferBase::initialize; // Bring base class initialize into scope
+    static constexpr uint32_t BINDING = EntityDescriptorBindings::Compute::MODEL_MATRIX_BUFFER;
     
     bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities) {
-        return BufferBase::initialize(context, resourceCoordinator, maxEntities, sizeof(glm::mat4), 0);
+        return BufferBase::initialize(context, resourceCoordinator, maxEntities, EntityStreamSchema::getStride(BINDING), 0,
+                                      ENTITY_CAPACITY_MAX);
     }
     
 protected:
@@ -78,24 +94,274 @@ class PositionBuffer : public BufferBase {
 public:
     using BufferBase::initialize; // Bring base class initialize into scope
     
-    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities) {
-        return BufferBase::initialize(context, resourceCoordinator, maxEntities, sizeof(glm::vec4), 0);
+    // The compact layout's neighbour snapshot keeps only xy (see PositionBufferCoordinator)
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities,
+                    VkDeviceSize stride = sizeof(glm::vec4)) {
+        return BufferBase::initialize(context, resourceCoordinator, maxEntities, stride, 0, ENTITY_CAPACITY_MAX);
     }
     
 protected:
     const char* getBufferTypeName() const override { return "Position"; }
+    MemoryAllocator::Priority getMemoryPriority() const override { return MemoryAllocator::Priority::High; }
 };
 
 // SINGLE responsibility: spatial map data management
 class SpatialMapBuffer : public BufferBase {
 public:
     using BufferBase::initialize; // Bring base class initialize into scope
+    static constexpr uint32_t BINDING = EntityDescriptorBindings::Compute::SPATIAL_MAP_BUFFER;
     
-    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t gridSize = 4096) {
-        // Spatial map uses uvec2 (8 bytes per cell) for linked list storage
-        return BufferBase::initialize(context, resourceCoordinator, gridSize, sizeof(glm::uvec2), 0);
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t cellCapacity) {
+        // Spatial map uses uvec2 (8 bytes per cell): sorted range start, entity count
+        return BufferBase::initialize(context, resourceCoordinator, cellCapacity, EntityStreamSchema::getStride(BINDING), 0);
     }
     
 protected:
     const char* getBufferTypeName() const override { return "SpatialMap"; }
+    MemoryAllocator::Priority getMemoryPriority() const override { return MemoryAllocator::Priority::High; }
+};
+
+// SINGLE responsibility: per-entity spatial cell assignment (cell index, slot within cell)
+class SpatialEntryBuffer : public BufferBase {
+public:
+    using BufferBase::initialize; // Bring base class initialize into scope
+    static constexpr uint32_t BINDING = EntityDescriptorBindings::Compute::SPATIAL_ENTRY_BUFFER;
+    
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities) {
+        return BufferBase::initialize(context, resourceCoordinator, maxEntities, EntityStreamSchema::getStride(BINDING), 0,
+                                      ENTITY_CAPACITY_MAX);
+    }
+    
+protected:
+    const char* getBufferTypeName() const override { return "SpatialEntry"; }
+    MemoryAllocator::Priority getMemoryPriority() const override { return MemoryAllocator::Priority::High; }
+};
+
+// SINGLE responsibility: entity indices sorted by spatial cell
+class SpatialIndexBuffer : public BufferBase {
+public:
+    using BufferBase::initialize; // Bring base class initialize into scope
+    static constexpr uint32_t BINDING = EntityDescriptorBindings::Compute::SPATIAL_INDEX_BUFFER;
+    
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities) {
+        return BufferBase::initialize(context, resourceCoordinator, maxEntities, EntityStreamSchema::getStride(BINDING), 0,
+                                      ENTITY_CAPACITY_MAX);
+    }
+    
+protected:
+    const char* getBufferTypeName() const override { return "SpatialIndex"; }
+    MemoryAllocator::Priority getMemoryPriority() const override { return MemoryAllocator::Priority::High; }
+};
+
+// SINGLE responsibility: stable spawn ID per GPU slot (survives entity reordering)
+class EntityIdBuffer : public BufferBase {
+public:
+    using BufferBase::initialize; // Bring base class initialize into scope
+    static constexpr uint32_t BINDING = EntityDescriptorBindings::Compute::ENTITY_ID_BUFFER;
+    
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities) {
+        return BufferBase::initialize(context, resourceCoordinator, maxEntities, EntityStreamSchema::getStride(BINDING), 0,
+                                      ENTITY_CAPACITY_MAX);
+    }
+    
+protected:
+    const char* getBufferTypeName() const override { return "EntityId"; }
+};
+
+// SINGLE responsibility: GPU slot per spawn ID, the inverse of EntityIdBuffer. Spawn IDs are recycled below the
+// number of entities held, so the slot count bounds them too; entries of despawned IDs are stale until reused
+class SpawnSlotBuffer : public BufferBase {
+public:
+    using BufferBase::initialize; // Bring base class initialize into scope
+    static constexpr uint32_t BINDING = EntityDescriptorBindings::Compute::SPAWN_SLOT_BUFFER;
+    
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities) {
+        return BufferBase::initialize(context, resourceCoordinator, maxEntities, EntityStreamSchema::getStride(BINDING), 0,
+                                      ENTITY_CAPACITY_MAX);
+    }
+    
+protected:
+    const char* getBufferTypeName() const override { return "SpawnSlot"; }
+};
+
+// SINGLE responsibility: packed entity type per GPU slot (EntityShape in the low byte, MovementType in the next)
+class EntityTypeBuffer : public BufferBase {
+public:
+    using BufferBase::initialize; // Bring base class initialize into scope
+    static constexpr uint32_t BINDING = EntityDescriptorBindings::Compute::ENTITY_TYPE_BUFFER;
+    
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities) {
+        return BufferBase::initialize(context, resourceCoordinator, maxEntities, EntityStreamSchema::getStride(BINDING), 0,
+                                      ENTITY_CAPACITY_MAX);
+    }
+    
+    static constexpr uint32_t SHAPE_MASK = 0xFFu;  // Must match entity_cull.comp and entity_bin.comp
+    static constexpr uint32_t MOVEMENT_SHIFT = 8;  // Must match movement_bin.comp
+    static constexpr uint32_t MOVEMENT_MASK = 0xFFu;
+    
+    static constexpr uint32_t pack(uint32_t shape, uint32_t movementType) {
+        return (shape & SHAPE_MASK) | ((movementType & MOVEMENT_MASK) << MOVEMENT_SHIFT);
+    }
+    
+protected:
+    const char* getBufferTypeName() const override { return "EntityType"; }
+};
+
+// Live entity bounds as entity_bounds.comp writes them (std430 struct of 16-byte alignment)
+struct EntityBoundsRecord {
+    float minimum[4];   // xyz
+    float maximum[4];   // xyz
+    float centroid[4];  // xyz; a partial holds its position sum here
+    uint32_t count;     // Unexpired live entities
+    uint32_t positionHash;  // Order-independent hash of the exact positions
+    uint32_t padding[2];
+};
+
+// Simulation counters added to by the physics, random walk and grid build kernels (simulation_counters.glsl).
+// The totals are never reset and wrap; EntityBufferManager differences consecutive readbacks. The cell fields
+// describe the last grid build
+struct EntitySimulationCounters {
+    uint32_t collisions;           // Collisions resolved
+    uint32_t truncatedEntities;    // Narrow phases that skipped entities past MAX_ENTITIES_PER_CELL in a neighbour cell
+    uint32_t directionChanges;     // New random walk directions
+    uint32_t occupiedCells;
+    uint32_t overflowCells;        // Cells holding more entities than the physics cell capacity
+    uint32_t maxCellOccupancy;
+    uint32_t histogramValid;       // occupancyHistogram was built by the last grid build
+    uint32_t padding;
+    uint32_t occupancyHistogram[SPATIAL_OCCUPANCY_HISTOGRAM_BINS];
+};
+
+// GPU-resident live entity count plus the indirect commands sized from it.
+// Layout is shared with the compute shaders (binding 12) - keep offsets 4-byte aligned.
+struct EntityIndirectCommands {
+    VkDispatchIndirectCommand entityDispatch;  // One thread per live entity (THREADS_PER_WORKGROUP wide)
+    uint32_t liveEntityCount;                  // Source of truth for shaders and indirect consumers
+    VkDrawIndexedIndirectCommand entityDraw;   // One instance per live entity
+    uint32_t expiredEntityCount;               // Lifetime expiries counted by the physics pass, GPU-owned
+    
+    // Awake entities compacted by entity_active.comp, reset by PhysicsComputeNode each frame, GPU-owned
+    VkDispatchIndirectCommand activeDispatch;  // Sized for the physics pipeline's workgroup size
+    uint32_t activeEntityCount;
+    
+    // Movement type lists built by movement_bin.comp, reset by EntityComputeNode each frame, GPU-owned
+    VkDispatchIndirectCommand movementDispatch[MOVEMENT_TYPE_COUNT];  // Sized for the movement workgroup size
+    uint32_t movementCounts[MOVEMENT_TYPE_COUNT];
+    
+    EntitySimulationCounters simulation;       // GPU-owned, read back by PhysicsComputeNode each frame
+    
+    // Everything below is GPU-owned by entity_bounds.comp; only shaders declaring the full block see it
+    uint32_t boundsWorkgroupsDone;             // Reset by EntityBoundsNode before each reduction
+    uint32_t boundsPadding;
+    EntityBoundsRecord bounds;                 // Result, read back by EntityBufferManager
+    EntityBoundsRecord boundsPartials[ENTITY_BOUNDS_WORKGROUPS];
+};
+static_assert(offsetof(EntityIndirectCommands, bounds) % 16 == 0 && sizeof(EntityBoundsRecord) == 64,
+              "EntityIndirectCommands bounds must follow the std430 layout of entity_bounds.comp");
+static_assert(offsetof(EntityIndirectCommands, simulation) == 104 && sizeof(EntitySimulationCounters) == 96,
+              "EntityIndirectCommands simulation counters must follow the std430 layout of simulation_counters.glsl");
+
+// SINGLE responsibility: indirect dispatch/draw arguments for entity workloads
+class EntityIndirectCommandBuffer : public BufferBase {
+public:
+    using BufferBase::initialize; // Bring base class initialize into scope
+    
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator) {
+        return BufferBase::initialize(context, resourceCoordinator, 1, sizeof(EntityIndirectCommands), 0);
+    }
+    
+    static constexpr VkDeviceSize getDispatchOffset() { return offsetof(EntityIndirectCommands, entityDispatch); }
+    static constexpr VkDeviceSize getDrawOffset() { return offsetof(EntityIndirectCommands, entityDraw); }
+    
+    // CPU rewrites stop short of the expiry counter, so expiries counted since the last readback survive them
+    static constexpr VkDeviceSize getCommandSize() { return offsetof(EntityIndirectCommands, expiredEntityCount); }
+    static constexpr VkDeviceSize getExpiredCountOffset() { return offsetof(EntityIndirectCommands, expiredEntityCount); }
+    static constexpr VkDeviceSize getActiveDispatchOffset() { return offsetof(EntityIndirectCommands, activeDispatch); }
+    static constexpr VkDeviceSize getMovementDispatchOffset(uint32_t type) {
+        return offsetof(EntityIndirectCommands, movementDispatch) + type * sizeof(VkDispatchIndirectCommand);
+    }
+    static constexpr VkDeviceSize getSimulationCountersOffset() { return offsetof(EntityIndirectCommands, simulation); }
+    static constexpr VkDeviceSize getBoundsCounterOffset() { return offsetof(EntityIndirectCommands, boundsWorkgroupsDone); }
+    static constexpr VkDeviceSize getBoundsOffset() { return offsetof(EntityIndirectCommands, bounds); }
+    
+protected:
+    VkBufferUsageFlags getAdditionalUsageFlags() const override { return VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT; }
+    const char* getBufferTypeName() const override { return "EntityIndirectCommand"; }
+};
+
+// SINGLE responsibility: compacted indices of entities that survived GPU frustum culling
+class VisibleIndexBuffer : public BufferBase {
+public:
+    using BufferBase::initialize; // Bring base class initialize into scope
+    static constexpr uint32_t BINDING = EntityDescriptorBindings::Compute::VISIBLE_INDEX_BUFFER;
+    
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities) {
+        return BufferBase::initialize(context, resourceCoordinator, maxEntities, EntityStreamSchema::getStride(BINDING), 0,
+                                      ENTITY_CAPACITY_MAX);
+    }
+    
+protected:
+    const char* getBufferTypeName() const override { return "VisibleIndex"; }
+};
+
+// Culled draw arguments in the layout entity_cull.comp and entity_bin.comp share (binding 14). Unbinned paths
+// only use draws[0]; binned, draws[s] covers shape s's run of the visible list and drawCount is one past the last
+// shape with visible entities, while binnedCount and shapeCursors are the binning pass's own counters
+struct VisibleDrawCommands {
+    VkDrawIndexedIndirectCommand draws[ENTITY_SHAPE_COUNT];
+    uint32_t drawCount;
+    uint32_t binnedCount;                   // Entries the culling pass left unbinned in the reorder scratch buffer
+    uint32_t shapeCursors[ENTITY_SHAPE_COUNT];
+};
+static_assert(sizeof(VkDrawIndexedIndirectCommand) == 20 && offsetof(VisibleDrawCommands, drawCount) % 4 == 0,
+              "VisibleDrawCommands must follow the std430 layout of entity_cull.comp");
+
+// SINGLE responsibility: indirect draw arguments for culled entities (instanceCount built on GPU)
+class VisibleDrawCommandBuffer : public BufferBase {
+public:
+    using BufferBase::initialize; // Bring base class initialize into scope
+    
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator) {
+        return BufferBase::initialize(context, resourceCoordinator, 1, sizeof(VisibleDrawCommands), 0);
+    }
+    
+    static constexpr VkDeviceSize getIndexCountOffset() { return offsetof(VkDrawIndexedIndirectCommand, indexCount); }
+    static constexpr VkDeviceSize getInstanceCountOffset() { return offsetof(VkDrawIndexedIndirectCommand, instanceCount); }
+    static constexpr VkDeviceSize getShapeInstanceCountOffset(uint32_t shape) {
+        return shape * sizeof(VkDrawIndexedIndirectCommand) + getInstanceCountOffset();
+    }
+    static constexpr VkDeviceSize getDrawCountOffset() { return offsetof(VisibleDrawCommands, drawCount); }
+    
+protected:
+    VkBufferUsageFlags getAdditionalUsageFlags() const override { return VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT; }
+    const char* getBufferTypeName() const override { return "VisibleDrawCommand"; }
+};
+
+// SINGLE responsibility: staging space for gathering permuted entity streams during reorder
+class ReorderScratchBuffer : public BufferBase {
+public:
+    using BufferBase::initialize; // Bring base class initialize into scope
+    static constexpr uint32_t BINDING = EntityDescriptorBindings::Compute::REORDER_SCRATCH_BUFFER;
+    
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t maxEntities, uint32_t streamCount) {
+        // One uvec4 per entity per stream, streams stored back to back
+        return BufferBase::initialize(context, resourceCoordinator, maxEntities * streamCount, EntityStreamSchema::getStride(BINDING), 0,
+                                      ENTITY_CAPACITY_MAX * streamCount);
+    }
+    
+protected:
+    const char* getBufferTypeName() const override { return "ReorderScratch"; }
+};
+
+// SINGLE responsibility: device addresses of the entity streams, one compute binding's worth per view
+class StreamAddressTableBuffer : public BufferBase {
+public:
+    using BufferBase::initialize; // Bring base class initialize into scope
+    
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, uint32_t entryCount) {
+        return BufferBase::initialize(context, resourceCoordinator, entryCount, sizeof(VkDeviceAddress), 0);
+    }
+    
+protected:
+    const char* getBufferTypeName() const override { return "StreamAddressTable"; }
 };
\ No newline at end of file
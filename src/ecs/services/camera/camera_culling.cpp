@@ -2,6 +2,77 @@
 #include <cmath>
 #include <algorithm>
 
+#if defined(__SSE2__) || defined(_M_X64)
+#define CAMERA_CULLING_SSE2 1
+#include <emmintrin.h>
+#elif defined(__aarch64__)
+#define CAMERA_CULLING_NEON 1
+#include <arm_neon.h>
+#endif
+
+namespace {
+    // Plane registers of one batch: each lane is one edge, and |n| turns a box's half extent into its
+    // reach along that edge's normal
+    struct PlaneLanes {
+#if defined(CAMERA_CULLING_SSE2)
+        __m128 normalX, normalY, distance, reachX, reachY;
+#elif defined(CAMERA_CULLING_NEON)
+        float32x4_t normalX, normalY, distance, reachX, reachY;
+#else
+        std::array<float, 4> normalX, normalY, distance, reachX, reachY;
+#endif
+        
+        explicit PlaneLanes(const CameraCulling::FrustumPlanes& planes) {
+            std::array<float, 4> absX, absY;
+            for (int i = 0; i < 4; ++i) {
+                absX[i] = std::abs(planes.normalX[i]);
+                absY[i] = std::abs(planes.normalY[i]);
+            }
+#if defined(CAMERA_CULLING_SSE2)
+            normalX = _mm_loadu_ps(planes.normalX.data());
+            normalY = _mm_loadu_ps(planes.normalY.data());
+            distance = _mm_loadu_ps(planes.distance.data());
+            reachX = _mm_loadu_ps(absX.data());
+            reachY = _mm_loadu_ps(absY.data());
+#elif defined(CAMERA_CULLING_NEON)
+            normalX = vld1q_f32(planes.normalX.data());
+            normalY = vld1q_f32(planes.normalY.data());
+            distance = vld1q_f32(planes.distance.data());
+            reachX = vld1q_f32(absX.data());
+            reachY = vld1q_f32(absY.data());
+#else
+            normalX = planes.normalX;
+            normalY = planes.normalY;
+            distance = planes.distance;
+            reachX = absX;
+            reachY = absY;
+#endif
+        }
+        
+        // The box touches the view unless it lies entirely behind one of the edges
+        bool touches(const glm::vec3& position, const glm::vec3& extent) const {
+#if defined(CAMERA_CULLING_SSE2)
+            __m128 signedDistance = _mm_add_ps(_mm_add_ps(_mm_mul_ps(normalX, _mm_set1_ps(position.x)),
+                                                          _mm_mul_ps(normalY, _mm_set1_ps(position.y))), distance);
+            signedDistance = _mm_add_ps(signedDistance, _mm_add_ps(_mm_mul_ps(reachX, _mm_set1_ps(extent.x)),
+                                                                   _mm_mul_ps(reachY, _mm_set1_ps(extent.y))));
+            return _mm_movemask_ps(_mm_cmplt_ps(signedDistance, _mm_setzero_ps())) == 0;
+#elif defined(CAMERA_CULLING_NEON)
+            float32x4_t signedDistance = vmlaq_n_f32(vmlaq_n_f32(distance, normalX, position.x), normalY, position.y);
+            signedDistance = vmlaq_n_f32(vmlaq_n_f32(signedDistance, reachX, extent.x), reachY, extent.y);
+            return vminvq_f32(signedDistance) >= 0.0f;
+#else
+            bool inside = true;
+            for (int i = 0; i < 4; ++i) {
+                inside &= normalX[i] * position.x + normalY[i] * position.y + distance[i] +
+                          reachX[i] * extent.x + reachY[i] * extent.y >= 0.0f;
+            }
+            return inside;
+#endif
+        }
+    };
+}
+
 
 bool CameraCulling::isEntityVisible(const Transform& transform, const Bounds& bounds, const Camera* camera) const {
     if (!camera) {
@@ -13,17 +84,7 @@ bool CameraCulling::isEntityVisible(const Transform& transform, const Bounds& bo
 }
 
 bool CameraCulling::isPositionVisible(const glm::vec3& position, const Camera* camera) const {
-    if (!camera) {
-        return false;
-    }
-    
-    CameraBounds bounds = getCameraBounds(camera);
-    if (!bounds.valid) {
-        return true;
-    }
-    
-    return position.x >= bounds.min.x && position.x <= bounds.max.x &&
-           position.y >= bounds.min.y && position.y <= bounds.max.y;
+    return isInFrustum(position, glm::vec3(0.0f), camera);
 }
 
 
@@ -52,23 +113,77 @@ CameraCulling::CameraBounds CameraCulling::getCameraBounds(const Camera* camera)
     return bounds;
 }
 
+const CameraCulling::FrustumPlanes& CameraCulling::getFrustumPlanes(const Camera* camera) const {
+    if (!camera) {
+        frustumCached = false;
+        frustumPlanes = FrustumPlanes{};
+        return frustumPlanes;
+    }
+    
+    const FrustumKey key{camera->position, camera->zoom, camera->rotation, camera->viewSize};
+    if (frustumCached && key == frustumKey) {
+        return frustumPlanes;
+    }
+    frustumKey = key;
+    frustumCached = true;
+    frustumPlanes = FrustumPlanes{};
+    
+    CameraBounds bounds = getCameraBounds(camera);
+    if (!bounds.valid) {
+        return frustumPlanes;
+    }
+    
+    // View axes in world space; the rectangle is the camera bounds turned about the camera position
+    const glm::vec2 center(camera->position);
+    const glm::vec2 right(std::cos(camera->rotation), std::sin(camera->rotation));
+    const glm::vec2 up(-right.y, right.x);
+    const glm::vec2 halfSize = (bounds.max - bounds.min) * 0.5f;
+    
+    const glm::vec2 normals[4] = {right, -right, up, -up};
+    const float halfExtents[4] = {halfSize.x, halfSize.x, halfSize.y, halfSize.y};
+    for (int i = 0; i < 4; ++i) {
+        frustumPlanes.normalX[i] = normals[i].x;
+        frustumPlanes.normalY[i] = normals[i].y;
+        frustumPlanes.distance[i] = halfExtents[i] - glm::dot(normals[i], center);
+    }
+    frustumPlanes.valid = true;
+    return frustumPlanes;
+}
+
+void CameraCulling::cullBatch(std::span<const glm::vec3> positions, std::span<const glm::vec3> extents,
+                              const Camera* camera, std::vector<uint32_t>& visibleIndices) const {
+    if (!camera || (extents.size() != 1 && extents.size() != positions.size())) {
+        return;
+    }
+    
+    const FrustumPlanes& planes = getFrustumPlanes(camera);
+    if (!planes.valid) {
+        for (size_t i = 0; i < positions.size(); ++i) {
+            visibleIndices.push_back(static_cast<uint32_t>(i));
+        }
+        return;
+    }
+    
+    const PlaneLanes lanes(planes);
+    const bool sharedExtent = extents.size() == 1;
+    for (size_t i = 0; i < positions.size(); ++i) {
+        if (lanes.touches(positions[i], extents[sharedExtent ? 0 : i])) {
+            visibleIndices.push_back(static_cast<uint32_t>(i));
+        }
+    }
+}
+
 bool CameraCulling::isInFrustum(const glm::vec3& position, const glm::vec3& bounds, const Camera* camera) const {
     if (!camera) {
         return false;
     }
     
-    CameraBounds cameraBounds = getCameraBounds(camera);
-    if (!cameraBounds.valid) {
+    const FrustumPlanes& planes = getFrustumPlanes(camera);
+    if (!planes.valid) {
         return true;
     }
     
-    glm::vec2 entityMin = glm::vec2(position.x - bounds.x, position.y - bounds.y);
-    glm::vec2 entityMax = glm::vec2(position.x + bounds.x, position.y + bounds.y);
-    
-    bool intersects = !(entityMax.x < cameraBounds.min.x || entityMin.x > cameraBounds.max.x ||
-                       entityMax.y < cameraBounds.min.y || entityMin.y > cameraBounds.max.y);
-    
-    return intersects;
+    return PlaneLanes(planes).touches(position, bounds);
 }
 
 float CameraCulling::calculateDistanceToCamera(const glm::vec3& position, const Camera* camera) const {
@@ -3,6 +3,9 @@
 #include "../../components/component.h"
 #include "../../components/camera_component.h"
 #include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <span>
 #include <vector>
 
 struct CullingInfo {
@@ -27,8 +30,40 @@ public:
     };
     
     CameraBounds getCameraBounds(const Camera* camera) const;
+    
+    // Edges of the camera's view rectangle, rotated with the camera, as inward 2D planes n.p + d >= 0 in the
+    // order left, right, bottom, top; one lane per plane so a test covers all four at once
+    struct FrustumPlanes {
+        std::array<float, 4> normalX{};
+        std::array<float, 4> normalY{};
+        std::array<float, 4> distance{};
+        bool valid = false;
+    };
+    
+    // Extracted once per camera state and reused until position, zoom, rotation or view size change
+    const FrustumPlanes& getFrustumPlanes(const Camera* camera) const;
+    
+    // Appends the indices of the entities whose box (position +/- extent) touches the view, in input order.
+    // extents holds one half-size per position, or a single one shared by all. Without a camera nothing is
+    // visible; with a degenerate one (zero zoom or view size) everything is
+    void cullBatch(std::span<const glm::vec3> positions, std::span<const glm::vec3> extents, const Camera* camera,
+                   std::vector<uint32_t>& visibleIndices) const;
 
 private:
     bool isInFrustum(const glm::vec3& position, const glm::vec3& bounds, const Camera* camera) const;
+    
+    // Camera state the cached planes were extracted from
+    struct FrustumKey {
+        glm::vec3 position{0.0f};
+        float zoom = 0.0f;
+        float rotation = 0.0f;
+        glm::vec2 viewSize{0.0f};
+        
+        bool operator==(const FrustumKey&) const = default;
+    };
+    
+    mutable FrustumKey frustumKey;
+    mutable FrustumPlanes frustumPlanes;
+    mutable bool frustumCached = false;
     float calculateDistanceToCamera(const glm::vec3& position, const Camera* camera) const;
 };
\ No newline at end of file
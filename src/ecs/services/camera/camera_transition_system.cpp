@@ -57,12 +57,12 @@ void CameraTransitionSystem::cancelTransition() {
     currentTransition.currentTime = 0.0f;
 }
 
-Camera CameraTransitionSystem::getCurrentTransitionState() const {
+Camera CameraTransitionSystem::getTransitionStateAfter(float aheadSeconds) const {
     if (!currentTransition.active) {
         return currentTransition.endState;
     }
     
-    float normalizedTime = std::clamp(currentTransition.currentTime / currentTransition.duration, 0.0f, 1.0f);
+    float normalizedTime = std::clamp((currentTransition.currentTime + aheadSeconds) / currentTransition.duration, 0.0f, 1.0f);
     float easedTime = evaluateEasing(normalizedTime, currentTransition.type);
     
     return interpolateCameras(currentTransition.startState, currentTransition.endState, easedTime);
@@ -50,7 +50,9 @@ public:
     bool isTransitionActive() const { return currentTransition.active; }
     void cancelTransition();
     
-    Camera getCurrentTransitionState() const;
+    Camera getCurrentTransitionState() const { return getTransitionStateAfter(0.0f); }
+    // The transition's state aheadSeconds from now, its end state once that is past (camera prediction)
+    Camera getTransitionStateAfter(float aheadSeconds) const;
     bool hasValidTransition() const;
 
     void setDefaultTransitionType(CameraTransitionType type) { defaultTransitionType = type; }
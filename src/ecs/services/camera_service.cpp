@@ -1,4 +1,6 @@
 #include "camera_service.h"
+#include <glm/gtc/constants.hpp>
+#include <cmath>
 
 CameraService::CameraService() = default;
 
@@ -46,6 +48,8 @@ void CameraService::update(float deltaTime) {
     
     transitionSystem->update(deltaTime);
     updateActiveCamera();
+    updateCameraMotion(deltaTime);
+    refreshCameraVersion();
 }
 
 void CameraService::handleWindowResize(int width, int height) {
@@ -58,6 +62,7 @@ void CameraService::handleWindowResize(int width, int height) {
     cameraManager->handleWindowResize(width, height);
     transforms->setScreenSize(screenSize);
     viewportManager->setScreenSize(screenSize);
+    ++cameraVersion;
 }
 
 CameraID CameraService::createCamera(const std::string& name) {
@@ -69,6 +74,7 @@ CameraID CameraService::createCamera(const Camera& cameraData, const std::string
 }
 
 bool CameraService::removeCamera(CameraID cameraID) {
+    cameraMotion.erase(cameraID);
     return initialized ? cameraManager->removeCamera(cameraID) : false;
 }
 
@@ -159,24 +165,28 @@ void CameraService::cancelTransition() {
 void CameraService::createViewport(const std::string& name, CameraID cameraID, const glm::vec2& offset, const glm::vec2& size) {
     if (initialized) {
         viewportManager->createViewport(name, cameraID, offset, size);
+        ++cameraVersion;
     }
 }
 
 void CameraService::createViewport(const Viewport& viewport) {
     if (initialized) {
         viewportManager->createViewport(viewport);
+        ++cameraVersion;
     }
 }
 
 void CameraService::removeViewport(const std::string& name) {
     if (initialized) {
         viewportManager->removeViewport(name);
+        ++cameraVersion;
     }
 }
 
 void CameraService::setViewportActive(const std::string& name, bool active) {
     if (initialized) {
         viewportManager->setViewportActive(name, active);
+        ++cameraVersion;
     }
 }
 
@@ -217,6 +227,13 @@ bool CameraService::isEntityVisible(const Transform& transform, const Bounds& bo
     return culling->isEntityVisible(transform, bounds, camera);
 }
 
+void CameraService::cullBatch(std::span<const glm::vec3> positions, std::span<const glm::vec3> extents,
+                              std::vector<uint32_t>& visibleIndices, CameraID cameraID) const {
+    if (!initialized) return;
+    
+    culling->cullBatch(positions, extents, getCameraForOperations(cameraID), visibleIndices);
+}
+
 
 glm::vec2 CameraService::worldToScreen(const glm::vec3& worldPos, const glm::vec2& screenSize, CameraID cameraID) const {
     if (!initialized) return glm::vec2(0.0f);
@@ -282,6 +299,29 @@ glm::mat4 CameraService::getViewProjectionMatrix(CameraID cameraID) const {
     return transforms->getViewProjectionMatrix(camera);
 }
 
+Camera CameraService::predictCamera(CameraID cameraID, float aheadSeconds) const {
+    const Camera* camera = initialized ? getCameraForOperations(cameraID) : nullptr;
+    if (!camera) {
+        return Camera{};
+    }
+    
+    const CameraID activeCameraID = cameraManager->getActiveCameraID();
+    const CameraID resolvedID = cameraID == 0 ? activeCameraID : cameraID;
+    if (transitionSystem->isTransitionActive() && resolvedID == activeCameraID) {
+        return transitionSystem->getTransitionStateAfter(aheadSeconds);
+    }
+    
+    Camera predicted = *camera;
+    auto it = cameraMotion.find(resolvedID);
+    if (it != cameraMotion.end()) {
+        const CameraMotion& motion = it->second;
+        predicted.setPosition(camera->position + motion.velocity * aheadSeconds);
+        predicted.setZoom(camera->zoom * std::exp(motion.zoomRate * aheadSeconds));
+        predicted.setRotation(camera->rotation + motion.rotationRate * aheadSeconds);
+    }
+    return predicted;
+}
+
 CameraService::CameraBounds CameraService::getCameraBounds(CameraID cameraID) const {
     if (!initialized) return CameraBounds{};
     
@@ -401,6 +441,48 @@ void CameraService::updateActiveCamera() {
     }
 }
 
+void CameraService::updateCameraMotion(float deltaTime) {
+    for (CameraID cameraID : cameraManager->getAllCameraIDs()) {
+        const Camera* camera = cameraManager->getCamera(cameraID);
+        if (!camera) {
+            continue;
+        }
+        
+        auto [it, inserted] = cameraMotion.try_emplace(cameraID);
+        CameraMotion& motion = it->second;
+        if (!inserted && deltaTime > 0.0f) {
+            float rotationDelta = camera->rotation - motion.rotation;
+            rotationDelta = std::remainder(rotationDelta, 2.0f * glm::pi<float>());
+            motion.velocity = (camera->position - motion.position) / deltaTime;
+            motion.zoomRate = std::log(camera->zoom / motion.zoom) / deltaTime;
+            motion.rotationRate = rotationDelta / deltaTime;
+        }
+        motion.position = camera->position;
+        motion.zoom = camera->zoom;
+        motion.rotation = camera->rotation;
+    }
+}
+
+void CameraService::refreshCameraVersion() {
+    cameraStateScratch.clear();
+    cameraStateScratch.push_back(static_cast<float>(cameraManager->getActiveCameraID()));
+    cameraStateScratch.push_back(transitionSystem->isTransitionActive() ? 1.0f : 0.0f);
+    for (CameraID cameraID : cameraManager->getAllCameraIDs()) {
+        const Camera* camera = cameraManager->getCamera(cameraID);
+        if (!camera) {
+            continue;
+        }
+        cameraStateScratch.insert(cameraStateScratch.end(), {
+            static_cast<float>(cameraID), camera->position.x, camera->position.y, camera->position.z,
+            camera->zoom, camera->rotation, camera->viewSize.x, camera->viewSize.y, camera->aspectRatio});
+    }
+    
+    if (cameraStateScratch != cameraState) {
+        cameraState.swap(cameraStateScratch);
+        ++cameraVersion;
+    }
+}
+
 const Camera* CameraService::getCameraForOperations(CameraID cameraID) const {
     const Camera* camera = getCamera(cameraID);
     if (!camera && transitionSystem->isTransitionActive()) {
@@ -9,6 +9,8 @@
 #include "../components/component.h"
 #include <flecs.h>
 #include <memory>
+#include <unordered_map>
+#include <vector>
 
 class CameraService {
 public:
@@ -26,9 +28,15 @@ public:
     bool initialize(flecs::world& world);
     void cleanup();
     
+    // Advances transitions and refreshes the camera version; call once per frame after the camera was moved
     void update(float deltaTime);
     void handleWindowResize(int width, int height);
     
+    // Changes when update() sees a camera's position, zoom, rotation, view size or aspect ratio, the active camera
+    // or the transition state differ from the previous update, and on viewport or window size changes. Matrix
+    // consumers compare it instead of the matrices; edits through getViewport() pointers are not tracked
+    uint64_t getCameraVersion() const { return cameraVersion; }
+    
     CameraID createCamera(const std::string& name = "");
     CameraID createCamera(const Camera& cameraData, const std::string& name = "");
     bool removeCamera(CameraID cameraID);
@@ -64,6 +72,10 @@ public:
     
     bool isEntityVisible(const Transform& transform, const Bounds& bounds, CameraID cameraID = 0) const;
     
+    // CameraCulling::cullBatch against the camera
+    void cullBatch(std::span<const glm::vec3> positions, std::span<const glm::vec3> extents,
+                   std::vector<uint32_t>& visibleIndices, CameraID cameraID = 0) const;
+    
     glm::vec2 worldToScreen(const glm::vec3& worldPos, const glm::vec2& screenSize, CameraID cameraID = 0) const;
     glm::vec2 screenToWorld(const glm::vec2& screenPos, const glm::vec2& screenSize, CameraID cameraID = 0) const;
     glm::vec2 viewportToWorld(const glm::vec2& viewportPos, const std::string& viewportName) const;
@@ -75,6 +87,10 @@ public:
     glm::mat4 getProjectionMatrix(CameraID cameraID = 0) const;
     glm::mat4 getViewProjectionMatrix(CameraID cameraID = 0) const;
     
+    // The camera aheadSeconds after the last update(): an active transition evaluated that far ahead for the
+    // active camera, otherwise the position, zoom and rotation rates of the last update extrapolated
+    Camera predictCamera(CameraID cameraID, float aheadSeconds) const;
+    
     using CameraBounds = CameraCulling::CameraBounds;
     CameraBounds getCameraBounds(CameraID cameraID = 0) const;
     bool isPositionVisible(const glm::vec3& position, CameraID cameraID = 0) const;
@@ -104,6 +120,21 @@ public:
 private:
     bool initialized = false;
     
+    uint64_t cameraVersion = 1;
+    std::vector<float> cameraState;         // What cameraVersion was published for
+    std::vector<float> cameraStateScratch;  // Reused by refreshCameraVersion
+    
+    // Per camera: its state at the last update() and the rates of change measured then, for predictCamera
+    struct CameraMotion {
+        glm::vec3 position{0.0f};
+        float zoom = 1.0f;
+        float rotation = 0.0f;
+        glm::vec3 velocity{0.0f};
+        float zoomRate = 0.0f;      // Log zoom per second, as zoom scales
+        float rotationRate = 0.0f;
+    };
+    std::unordered_map<CameraID, CameraMotion> cameraMotion;
+    
     std::unique_ptr<CameraManager> cameraManager;
     std::unique_ptr<CameraTransitionSystem> transitionSystem;
     std::unique_ptr<ViewportManager> viewportManager;
@@ -111,6 +142,8 @@ private:
     std::unique_ptr<CameraTransforms> transforms;
     
     void updateActiveCamera();
+    void refreshCameraVersion();
+    void updateCameraMotion(float deltaTime);
     const Camera* getCameraForOperations(CameraID cameraID) const;
     Camera* getCameraForOperations(CameraID cameraID);
 };
@@ -3,12 +3,15 @@
 #include "camera_service.h"
 #include "rendering_service.h"
 #include "../../vulkan_renderer.h"
+#include "../../vulkan/core/vulkan_swapchain.h"
 #include "../core/entity_factory.h"
 #include "../gpu/gpu_entity_manager.h"
+#include "../utilities/constants.h"
 #include "../utilities/debug.h"
 #include "../utilities/profiler.h"
 #include <iostream>
 #include <algorithm>
+#include <iterator>
 
 // Service concept compliance verified by DECLARE_SERVICE macro
 
@@ -32,6 +35,10 @@ bool GameControlService::initialize(flecs::world& world, VulkanRenderer* rendere
     this->world = &world;
     this->renderer = renderer;
     this->entityFactory = entityFactory;
+    controlState.msaaSamples = renderer->getMSAASamples();
+    controlState.renderScale = renderer->getRenderScale();
+    controlState.presentPolicy = renderer->getPresentPolicy();
+    controlState.collisions = renderer->getComputeShaderFeatures().hasCollisions();
     
     // Get service dependencies from ServiceLocator
     auto& locator = ServiceLocator::instance();
@@ -55,6 +62,10 @@ bool GameControlService::initialize(flecs::world& world, VulkanRenderer* rendere
         return false;
     }
     
+    transformQuery_ = world.query_builder<const Transform>("ControlTransformQuery")
+        .cached()
+        .build();
+    
     // Initialize default actions and integrations
     initializeDefaultActions();
     integrateWithInputService();
@@ -77,6 +88,9 @@ void GameControlService::cleanup() {
     actions.clear();
     controlState = ControlState{};
     
+    if (transformQuery_) {
+        transformQuery_.destruct();
+    }
     world = nullptr;
     renderer = nullptr;
     entityFactory = nullptr;
@@ -152,6 +166,11 @@ void GameControlService::handleInput() {
         std::cout << "GameControlService: create_swarm is active but not just pressed" << std::endl;
     }
     
+    if (inputService->isActionJustPressed("emit_swarm")) {
+        controlState.entityCreationPos = inputService->getMouseWorldPosition();
+        executeAction("emit_swarm");
+    }
+    
     // Performance stats
     if (inputService->isActionJustPressed("show_stats")) {
         executeAction("show_stats");
@@ -167,6 +186,35 @@ void GameControlService::handleInput() {
         executeAction("toggle_debug");
     }
     
+    // Render quality
+    if (inputService->isActionJustPressed("cycle_msaa")) {
+        executeAction("cycle_msaa");
+    }
+    
+    if (inputService->isActionJustPressed("cycle_render_scale")) {
+        executeAction("cycle_render_scale");
+    }
+    
+    if (inputService->isActionJustPressed("cycle_present_policy")) {
+        executeAction("cycle_present_policy");
+    }
+    
+    if (inputService->isActionJustPressed("toggle_collisions")) {
+        executeAction("toggle_collisions");
+    }
+    
+    if (inputService->isActionJustPressed("toggle_hud")) {
+        executeAction("toggle_hud");
+    }
+    
+    if (inputService->isActionJustPressed("toggle_overdraw")) {
+        executeAction("toggle_overdraw");
+    }
+    
+    if (inputService->isActionJustPressed("toggle_movement")) {
+        executeAction("toggle_movement");
+    }
+    
     // Camera controls
     if (inputService->isActionJustPressed("camera_reset")) {
         executeAction("camera_reset");
@@ -217,6 +265,14 @@ void GameControlService::setActionEnabled(const std::string& actionName, bool en
 
 void GameControlService::initializeDefaultActions() {
     // Register default control actions
+    registerAction({
+        ControlActionType::TOGGLE_MOVEMENT,
+        "toggle_movement",
+        "Cycle the movement type of new entities",
+        [this]() { actionToggleMovement(); },
+        true, 0.5f, 0.0f
+    });
+    
     registerAction({
         ControlActionType::CREATE_ENTITY,
         "create_entity",
@@ -233,6 +289,14 @@ void GameControlService::initializeDefaultActions() {
         true, swarmCreationCooldown, 0.0f
     });
     
+    registerAction({
+        ControlActionType::CREATE_SWARM,
+        "emit_swarm",
+        "Emit GPU-spawned swarm at cursor position",
+        [this]() { actionEmitSwarm(); },
+        true, swarmCreationCooldown, 0.0f
+    });
+    
     registerAction({
         ControlActionType::DEBUG_ENTITY,
         "debug_entity",
@@ -265,6 +329,54 @@ void GameControlService::initializeDefaultActions() {
         true, 0.5f, 0.0f
     });
     
+    registerAction({
+        ControlActionType::RENDER_QUALITY,
+        "cycle_msaa",
+        "Cycle MSAA sample count",
+        [this]() { actionCycleMSAA(); },
+        true, 0.5f, 0.0f
+    });
+    
+    registerAction({
+        ControlActionType::RENDER_QUALITY,
+        "cycle_render_scale",
+        "Cycle internal render scale",
+        [this]() { actionCycleRenderScale(); },
+        true, 0.5f, 0.0f
+    });
+    
+    registerAction({
+        ControlActionType::RENDER_QUALITY,
+        "cycle_present_policy",
+        "Cycle present policy",
+        [this]() { actionCyclePresentPolicy(); },
+        true, 0.5f, 0.0f
+    });
+    
+    registerAction({
+        ControlActionType::RENDER_QUALITY,
+        "toggle_collisions",
+        "Toggle physics collisions",
+        [this]() { actionToggleCollisions(); },
+        true, 0.5f, 0.0f
+    });
+    
+    registerAction({
+        ControlActionType::PERFORMANCE_STATS,
+        "toggle_hud",
+        "Toggle performance HUD",
+        [this]() { actionTogglePerformanceHud(); },
+        true, 0.5f, 0.0f
+    });
+    
+    registerAction({
+        ControlActionType::PERFORMANCE_STATS,
+        "toggle_overdraw",
+        "Toggle overdraw heat map",
+        [this]() { actionToggleOverdraw(); },
+        true, 0.5f, 0.0f
+    });
+    
     registerAction({
         ControlActionType::CAMERA_CONTROL,
         "camera_reset",
@@ -306,6 +418,10 @@ void GameControlService::executePendingRequests() {
         createSwarm(1000, glm::vec3(10.0f, 10.0f, 0.0f), 8.0f);
     }
     
+    if (controlState.requestSwarmEmission) {
+        emitSwarm(10000, glm::vec3(controlState.entityCreationPos, 0.0f), 8.0f, 20.0f);
+    }
+    
     if (controlState.requestPerformanceStats) {
         showPerformanceStats();
     }
@@ -336,6 +452,13 @@ void GameControlService::integrateWithInputService() {
         {InputBinding(InputBinding::InputType::KEYBOARD_KEY, SDL_SCANCODE_EQUALS)}
     });
     
+    inputService->registerAction({
+        "emit_swarm",
+        InputActionType::DIGITAL,
+        "Emit GPU-spawned swarm at mouse position",
+        {InputBinding(InputBinding::InputType::KEYBOARD_KEY, SDL_SCANCODE_E)}
+    });
+    
     inputService->registerAction({
         "debug_entity",
         InputActionType::DIGITAL,
@@ -364,6 +487,55 @@ void GameControlService::integrateWithInputService() {
         {InputBinding(InputBinding::InputType::KEYBOARD_KEY, SDL_SCANCODE_F3)}
     });
     
+    inputService->registerAction({
+        "cycle_msaa",
+        InputActionType::DIGITAL,
+        "Cycle MSAA sample count",
+        {InputBinding(InputBinding::InputType::KEYBOARD_KEY, SDL_SCANCODE_F4)}
+    });
+    
+    inputService->registerAction({
+        "cycle_render_scale",
+        InputActionType::DIGITAL,
+        "Cycle internal render scale",
+        {InputBinding(InputBinding::InputType::KEYBOARD_KEY, SDL_SCANCODE_F5)}
+    });
+    
+    inputService->registerAction({
+        "cycle_present_policy",
+        InputActionType::DIGITAL,
+        "Cycle present policy",
+        {InputBinding(InputBinding::InputType::KEYBOARD_KEY, SDL_SCANCODE_F6)}
+    });
+    
+    inputService->registerAction({
+        "toggle_collisions",
+        InputActionType::DIGITAL,
+        "Toggle physics collisions",
+        {InputBinding(InputBinding::InputType::KEYBOARD_KEY, SDL_SCANCODE_F7)}
+    });
+    
+    inputService->registerAction({
+        "toggle_hud",
+        InputActionType::DIGITAL,
+        "Toggle performance HUD",
+        {InputBinding(InputBinding::InputType::KEYBOARD_KEY, SDL_SCANCODE_F8)}
+    });
+    
+    inputService->registerAction({
+        "toggle_overdraw",
+        InputActionType::DIGITAL,
+        "Toggle overdraw heat map",
+        {InputBinding(InputBinding::InputType::KEYBOARD_KEY, SDL_SCANCODE_F9)}
+    });
+    
+    inputService->registerAction({
+        "toggle_movement",
+        InputActionType::DIGITAL,
+        "Cycle movement type of new entities",
+        {InputBinding(InputBinding::InputType::KEYBOARD_KEY, SDL_SCANCODE_M)}
+    });
+    
     inputService->registerAction({
         "camera_reset",
         InputActionType::DIGITAL,
@@ -443,9 +615,13 @@ void GameControlService::actionCreateSwarm() {
     controlState.requestSwarmCreation = true;
 }
 
+void GameControlService::actionEmitSwarm() {
+    controlState.requestSwarmEmission = true;
+}
+
 void GameControlService::actionDebugEntity() {
     glm::vec2 mouseWorldPos = inputService->getMouseWorldPosition();
-    debugEntityAtPosition(mouseWorldPos);
+    debugEntityAtPosition(mouseWorldPos, inputService->getMouseViewportPosition());
 }
 
 void GameControlService::actionShowStats() {
@@ -468,10 +644,36 @@ void GameControlService::actionCameraFocus() {
     focusCameraOnEntities();
 }
 
+void GameControlService::actionCycleMSAA() {
+    cycleMSAASamples();
+}
+
+void GameControlService::actionCycleRenderScale() {
+    cycleRenderScale();
+}
+
+void GameControlService::actionCyclePresentPolicy() {
+    cyclePresentPolicy();
+}
+
+void GameControlService::actionToggleCollisions() {
+    toggleCollisions();
+}
+
+void GameControlService::actionTogglePerformanceHud() {
+    togglePerformanceHud();
+}
+
+void GameControlService::actionToggleOverdraw() {
+    toggleOverdraw();
+}
+
 // Game logic implementations
 void GameControlService::toggleMovementType() {
-    controlState.currentMovementType = (controlState.currentMovementType + 1) % 1; // Only RandomWalk for now
-    DEBUG_LOG("Movement type: " << controlState.currentMovementType);
+    // Entities created or emitted from now on take the new type; the GPU only runs more than the random walk
+    // under movement type dispatch
+    controlState.currentMovementType = (controlState.currentMovementType + 1) % MOVEMENT_TYPE_COUNT;
+    std::cout << "Movement type of new entities: " << controlState.currentMovementType << std::endl;
 }
 
 void GameControlService::createEntity(const glm::vec2& position) {
@@ -487,15 +689,15 @@ void GameControlService::createEntity(const glm::vec2& position) {
     }
     
     glm::vec3 pos3d(position.x, position.y, 0.0f);
-    flecs::entity entity = entityFactory->createExactEntity(pos3d);
+    flecs::entity entity = entityFactory->createExactEntity(pos3d, getCurrentMovementType());
     std::cout << "Created single entity at exact position from EntityFactory" << std::endl;
     
     auto* gpuEntityManager = renderer->getGPUEntityManager();
     if (gpuEntityManager) {
         std::vector<flecs::entity> entities = {entity};
         gpuEntityManager->addEntitiesFromECS(entities);
-        gpuEntityManager->uploadPendingEntities();
-        std::cout << "Added entity to GPU manager and uploaded" << std::endl;
+        gpuEntityManager->uploadPendingEntitiesAsync();
+        std::cout << "Added entity to GPU manager and queued upload" << std::endl;
     } else {
         std::cout << "ERROR: gpuEntityManager is null!" << std::endl;
     }
@@ -506,15 +708,39 @@ void GameControlService::createEntity(const glm::vec2& position) {
 void GameControlService::createSwarm(size_t count, const glm::vec3& center, float radius) {
     if (!entityFactory || !renderer) return;
     
-    auto entities = entityFactory->createSwarm(count, center, radius);
+    auto* gpuEntityManager = renderer->getGPUEntityManager();
+    if (SystemConstants::GPU_RESIDENT_SWARMS && gpuEntityManager) {
+        SwarmSpawn spawn;
+        auto entities = entityFactory->createResidentSwarm(count, center, radius, getCurrentMovementType(), spawn);
+        gpuEntityManager->addResidentEntities(entities, spawn.transforms, spawn.renderables, spawn.patterns);
+        gpuEntityManager->uploadPendingEntitiesAsync();
+    } else {
+        auto entities = entityFactory->createSwarmWithType(count, center, radius, getCurrentMovementType());
+        if (gpuEntityManager) {
+            gpuEntityManager->addEntitiesFromECS(entities);
+            gpuEntityManager->uploadPendingEntitiesAsync();
+        }
+    }
+    
+    DEBUG_LOG("Created swarm of " << count << " entities");
+}
+
+void GameControlService::emitSwarm(uint32_t count, const glm::vec3& center, float radius, float lifetime) {
+    if (!renderer) return;
     
     auto* gpuEntityManager = renderer->getGPUEntityManager();
     if (gpuEntityManager) {
-        gpuEntityManager->addEntitiesFromECS(entities);
-        gpuEntityManager->uploadPendingEntities();
+        EntityEmitter emitter;
+        emitter.center = center;
+        emitter.radius = radius;
+        emitter.count = count;
+        emitter.seed = controlState.emitterSeed++;
+        emitter.lifetime = lifetime;
+        emitter.movementType = getCurrentMovementType();
+        gpuEntityManager->spawnEmitter(emitter);
     }
     
-    DEBUG_LOG("Created swarm of " << count << " entities");
+    DEBUG_LOG("Emitted GPU swarm of " << count << " entities at (" << center.x << ", " << center.y << ")");
 }
 
 void GameControlService::showPerformanceStats() {
@@ -537,7 +763,39 @@ void GameControlService::showPerformanceStats() {
         std::cout << "Visible Entities: " << cullingStats.visibleEntities << std::endl;
         std::cout << "Culling Ratio: " << (cullingStats.getCullingRatio() * 100.0f) << "%" << std::endl;
     }
-    std::cout << "=========================" << std::endl;
+    
+    // Frame graph nodes report measured GPU time under "GPU/<node>", sorted slowest first
+    bool gpuHeaderPrinted = false;
+    for (const auto& entry : Profiler::getInstance().generateReport()) {
+        if (entry.name.rfind("GPU/", 0) != 0) continue;
+        if (!gpuHeaderPrinted) {
+            std::cout << "GPU Time per Node (min / avg / p99 ms):" << std::endl;
+            gpuHeaderPrinted = true;
+        }
+        std::cout << "  " << entry.name.substr(4) << ": " << entry.minTime << " / "
+                  << entry.recentAverageTime << " / " << entry.p99Time << std::endl;
+    }
+    Profiler::getInstance().printHitchReport();
+    
+    // Latest pipeline statistics, present only for nodes that opted in under ENABLE_GPU_PIPELINE_STATISTICS.
+    // The node profiler belongs to whichever thread records frames, so the read waits for the frame handoff
+    const FrameGraph* frameGraph = renderer ? renderer->getFrameGraph() : nullptr;
+    auto* gpuEntityManager = renderer ? renderer->getGPUEntityManager() : nullptr;
+    if (frameGraph && gpuEntityManager) {
+        gpuEntityManager->frontendCall([frameGraph, gpuEntityManager] {
+            std::cout << "GPU Lifetime Expiries: " << gpuEntityManager->getExpiredEntityCount() << " ("
+                      << gpuEntityManager->getTombstoneCount() << " slots awaiting reuse)" << std::endl;
+            for (const auto& [nodeId, timing] : frameGraph->getNodeProfiler().getTimings()) {
+                if (!timing.hasPipelineStatistics) continue;
+                std::cout << "  " << timing.name << " invocations: compute " << timing.computeShaderInvocations
+                          << ", vertex " << timing.vertexShaderInvocations
+                          << ", clipping primitives " << timing.clippingPrimitives << std::endl;
+            }
+            std::cout << "=========================" << std::endl;
+        });
+    } else {
+        std::cout << "=========================" << std::endl;
+    }
 }
 
 void GameControlService::runGraphicsTests() {
@@ -550,7 +808,7 @@ void GameControlService::runGraphicsTests() {
         auto* gpuEntityManager = renderer->getGPUEntityManager();
         if (gpuEntityManager) {
             gpuEntityManager->addEntitiesFromECS(testEntities);
-            gpuEntityManager->uploadPendingEntities();
+            gpuEntityManager->uploadPendingEntitiesAsync();
         }
         
         DEBUG_LOG("Created 5000 test entities for graphics testing");
@@ -560,13 +818,116 @@ void GameControlService::runGraphicsTests() {
 void GameControlService::toggleDebugMode() {
     controlState.debugMode = !controlState.debugMode;
     
-    if (renderingService) {
-        renderingService->setDebugVisualization(controlState.debugMode);
+    // Drawn by the renderer from the GPU buffers; nothing is read back for it
+    auto* gpuEntityManager = renderer ? renderer->getGPUEntityManager() : nullptr;
+    if (gpuEntityManager) {
+        VulkanRenderer* target = renderer;
+        const bool visible = controlState.debugMode;
+        gpuEntityManager->frontendCall([target, visible] {
+            target->setDebugOverlayVisible(visible);
+        });
     }
     
     DEBUG_LOG("Debug mode: " << (controlState.debugMode ? "ON" : "OFF"));
 }
 
+void GameControlService::cycleMSAASamples() {
+    // Steps from the last request, so a count the device clamps down still wraps on the next press
+    controlState.msaaSamples = controlState.msaaSamples >= 8 ? 1 : controlState.msaaSamples * 2;
+    requestRenderQuality();
+}
+
+void GameControlService::cycleRenderScale() {
+    static constexpr float renderScales[] = {1.0f, 0.75f, 0.5f};
+    size_t next = 0;
+    for (size_t i = 0; i < std::size(renderScales); ++i) {
+        if (controlState.renderScale == renderScales[i]) {
+            next = (i + 1) % std::size(renderScales);
+            break;
+        }
+    }
+    controlState.renderScale = renderScales[next];
+    requestRenderQuality();
+}
+
+void GameControlService::requestRenderQuality() {
+    auto* gpuEntityManager = renderer ? renderer->getGPUEntityManager() : nullptr;
+    if (!gpuEntityManager) return;
+    
+    std::cout << "GameControlService: Render quality " << controlState.msaaSamples << "x MSAA, render scale "
+              << controlState.renderScale << std::endl;
+    
+    // The renderer's quality belongs to whichever thread records frames
+    VulkanRenderer* target = renderer;
+    const uint32_t msaaSamples = controlState.msaaSamples;
+    const float renderScale = controlState.renderScale;
+    gpuEntityManager->frontendCall([target, msaaSamples, renderScale] {
+        target->setRenderQuality(msaaSamples, renderScale);
+    });
+}
+
+void GameControlService::cyclePresentPolicy() {
+    switch (controlState.presentPolicy) {
+        case PresentPolicy::LowLatency:     controlState.presentPolicy = PresentPolicy::PowerSaver; break;
+        case PresentPolicy::PowerSaver:     controlState.presentPolicy = PresentPolicy::TearFreeMaxFps; break;
+        case PresentPolicy::TearFreeMaxFps: controlState.presentPolicy = PresentPolicy::LowLatency; break;
+    }
+    
+    auto* gpuEntityManager = renderer ? renderer->getGPUEntityManager() : nullptr;
+    if (!gpuEntityManager) return;
+    
+    std::cout << "GameControlService: Present policy "
+              << VulkanSwapchain::getPresentPolicyName(controlState.presentPolicy) << std::endl;
+    
+    VulkanRenderer* target = renderer;
+    const PresentPolicy policy = controlState.presentPolicy;
+    gpuEntityManager->frontendCall([target, policy] {
+        target->setPresentPolicy(policy);
+    });
+}
+
+void GameControlService::toggleCollisions() {
+    auto* gpuEntityManager = renderer ? renderer->getGPUEntityManager() : nullptr;
+    if (!gpuEntityManager) return;
+    
+    controlState.collisions = !controlState.collisions;
+    ComputeShaderFeatures features = renderer->getComputeShaderFeatures();
+    features.flags = controlState.collisions ? (features.flags | ComputeShaderFeatures::COLLISIONS)
+                                             : (features.flags & ~ComputeShaderFeatures::COLLISIONS);
+    std::cout << "GameControlService: Collisions " << (features.hasCollisions() ? "on" : "off") << std::endl;
+    
+    VulkanRenderer* target = renderer;
+    gpuEntityManager->frontendCall([target, features] {
+        target->setComputeShaderFeatures(features);
+    });
+}
+
+void GameControlService::togglePerformanceHud() {
+    auto* gpuEntityManager = renderer ? renderer->getGPUEntityManager() : nullptr;
+    if (!gpuEntityManager) return;
+    
+    controlState.performanceHud = !controlState.performanceHud;
+    const bool visible = controlState.performanceHud;
+    
+    VulkanRenderer* target = renderer;
+    gpuEntityManager->frontendCall([target, visible] {
+        target->setPerformanceHudVisible(visible);
+    });
+}
+
+void GameControlService::toggleOverdraw() {
+    auto* gpuEntityManager = renderer ? renderer->getGPUEntityManager() : nullptr;
+    if (!gpuEntityManager) return;
+    
+    controlState.overdraw = !controlState.overdraw;
+    const bool visible = controlState.overdraw;
+    
+    VulkanRenderer* target = renderer;
+    gpuEntityManager->frontendCall([target, visible] {
+        target->setOverdrawDiagnosticVisible(visible);
+    });
+}
+
 void GameControlService::toggleWireframeMode() {
     controlState.wireframeMode = !controlState.wireframeMode;
     
@@ -645,13 +1006,33 @@ void GameControlService::resetCamera() {
 void GameControlService::focusCameraOnEntities() {
     if (!cameraService || !world) return;
     
-    // Calculate center of all entities
+    // The GPU reduction sees simulated positions and GPU-spawned entities, so frame its bounds when there are any
+    const auto* gpuEntityManager = renderer ? renderer->getGPUEntityManager() : nullptr;
+    const EntityBounds bounds = gpuEntityManager ? gpuEntityManager->getEntityBounds() : EntityBounds{};
+    if (bounds.valid && bounds.count > 0) {
+        float zoom = 1.0f;
+        if (const Camera* camera = cameraService->getCamera(cameraService->getActiveCameraID())) {
+            const glm::vec2 extent = glm::max(glm::vec2(bounds.maximum - bounds.minimum), glm::vec2(1.0f));
+            zoom = 0.9f * std::min(camera->viewSize.x / extent.x, camera->viewSize.y / extent.y);
+        }
+        cameraService->focusCameraOn(cameraService->getActiveCameraID(), bounds.centroid, zoom);
+        DEBUG_LOG("Camera focused on " << bounds.count << " entities around (" << bounds.centroid.x << ", "
+                  << bounds.centroid.y << ", " << bounds.centroid.z << ") at zoom " << zoom);
+        return;
+    }
+    
+    // Before the first GPU readback, fall back to the ECS spawn positions
     glm::vec3 center(0.0f);
     size_t entityCount = 0;
     
-    world->each<Transform>([&](flecs::entity e, Transform& transform) {
-        center += transform.position;
-        entityCount++;
+    transformQuery_.run([&center, &entityCount](flecs::iter& it) {
+        while (it.next()) {
+            flecs::field<const Transform> transforms = it.field<const Transform>(0);
+            for (auto i : it) {
+                center += transforms[i].position;
+            }
+            entityCount += it.count();
+        }
     });
     
     if (entityCount > 0) {
@@ -681,10 +1062,17 @@ void GameControlService::printControlInstructions() const {
     std::cout << "ESC: Exit" << std::endl;
     std::cout << "P: Print detailed performance report" << std::endl;
     std::cout << "+/=: Add 1000 more GPU entities" << std::endl;
+    std::cout << "E: Emit 10000 GPU-spawned entities at mouse position (no ECS entities)" << std::endl;
     std::cout << "Left Click: Create GPU entity with movement at mouse position" << std::endl;
     std::cout << "All entities use random walk movement pattern" << std::endl;
     std::cout << "T: Run graphics buffer overflow tests" << std::endl;
-    std::cout << "F3: Toggle debug mode" << std::endl;
+    std::cout << "F3: Toggle debug overlay (spatial grid occupancy, entity bounds)" << std::endl;
+    std::cout << "F4: Cycle MSAA (1x/2x/4x/8x)" << std::endl;
+    std::cout << "F5: Cycle render scale (100%/75%/50%)" << std::endl;
+    std::cout << "F6: Cycle present policy (low-latency/power-saver/max-fps)" << std::endl;
+    std::cout << "F7: Toggle physics collisions" << std::endl;
+    std::cout << "F8: Toggle performance HUD" << std::endl;
+    std::cout << "F9: Toggle overdraw heat map (average, max and histogram on the HUD and metrics)" << std::endl;
     std::cout << "R: Reset camera" << std::endl;
     std::cout << "F: Focus camera on entities" << std::endl;
     std::cout << "WASD: Move camera" << std::endl;
@@ -693,7 +1081,7 @@ void GameControlService::printControlInstructions() const {
     std::cout << "===============================================\n" << std::endl;
 }
 
-void GameControlService::debugEntityAtPosition(const glm::vec2& worldPos) {
+void GameControlService::debugEntityAtPosition(const glm::vec2& worldPos, const glm::vec2& viewportPos) {
     if (!renderer) {
         std::cerr << "GameControlService::debugEntityAtPosition - No renderer available" << std::endl;
         return;
@@ -705,39 +1093,116 @@ void GameControlService::debugEntityAtPosition(const glm::vec2& worldPos) {
         return;
     }
     
-    // Get the entity buffer manager for readback
+    // The readback ring is fed by the frame recording, so the request waits for the frame handoff under a render thread
+    gpuEntityManager->frontendCall([gpuEntityManager, worldPos, viewportPos, world = this->world] {
+        auto& bufferManager = gpuEntityManager->getBufferManager();
+        
+        // Exact first: the spawn ID the entity pass drew under the cursor. Frames that cannot draw the pick
+        // attachment hand the pick over to the spatial search below
+        if (ENABLE_ENTITY_PICK_BUFFER) {
+            bufferManager.requestEntityIdPick(viewportPos,
+                [gpuEntityManager, worldPos](EntityBufferManager::EntityIdPickResult result, uint32_t spawnId) {
+                    // Readback callbacks run on the render thread while the world may be progressing, so nothing
+                    // here creates shadow entities
+                    using Result = EntityBufferManager::EntityIdPickResult;
+                    if (result == Result::Unavailable) {
+                        debugEntityBySpatialSearch(gpuEntityManager, worldPos, nullptr);
+                    } else if (result == Result::Miss) {
+                        std::cout << "No entity drawn at world position (" << worldPos.x << ", " << worldPos.y << ")" << std::endl;
+                    } else {
+                        auto ecsEntity = gpuEntityManager->getECSEntityFromSpawnId(spawnId);
+                        std::cout << "\n=== ENTITY DEBUG INFO (pick buffer) ===" << std::endl;
+                        std::cout << "World Position: (" << worldPos.x << ", " << worldPos.y << ")" << std::endl;
+                        std::cout << "Spawn ID: " << spawnId << std::endl;
+                        std::cout << "ECS Entity ID: " << std::hex << ecsEntity.id() << std::dec
+                                  << (ecsEntity.is_valid() ? " (valid)" : " (invalid/unmapped)") << std::endl;
+                        std::cout << "========================\n" << std::endl;
+                        debugEntityComponents(gpuEntityManager, spawnId);
+                    }
+                });
+            return;
+        }
+        debugEntityBySpatialSearch(gpuEntityManager, worldPos, world);
+    });
+}
+
+void GameControlService::debugEntityBySpatialSearch(GPUEntityManager* gpuEntityManager, glm::vec2 worldPos, flecs::world* world) {
     auto& bufferManager = gpuEntityManager->getBufferManager();
     
-    // Perform GPU readback at the clicked position with synchronization
-    EntityBufferManager::EntityDebugInfo debugInfo;
-    if (bufferManager.readbackEntityAtPositionSafe(worldPos, debugInfo)) {
-        // Get ECS entity ID from GPU index
-        auto ecsEntity = gpuEntityManager->getECSEntityFromGPUIndex(debugInfo.entityId);
-        
-        std::cout << "\n=== ENTITY DEBUG INFO ===" << std::endl;
-        std::cout << "World Position: (" << worldPos.x << ", " << worldPos.y << ")" << std::endl;
-        std::cout << "GPU Buffer Index: " << debugInfo.entityId << std::endl;
-        std::cout << "ECS Entity ID: " << std::hex << ecsEntity.id() << std::dec;
-        if (ecsEntity.is_valid()) {
-            std::cout << " (valid)";
-        } else {
-            std::cout << " (invalid/unmapped)";
+    // With a position mirror the pick is answered on the spot from its snapshot, over the 5x5 cell
+    // neighbourhood the GPU search covers; a miss (the snapshot may be stale) falls back to the readback
+    const float pickRadius = 2.5f * bufferManager.getSpatialGridConfig().cellSize;
+    if (auto snapshot = gpuEntityManager->getPositionMirror().getSnapshot()) {
+        const uint32_t slot = snapshot->findNearest(worldPos, pickRadius);
+        if (slot != EntityPositionMirror::NO_ENTITY) {
+            // Given a world, the caller holds it still, so a GPU-spawned entity can get its shadow entity now
+            const uint32_t spawnId = snapshot->spawnIds[slot];
+            auto ecsEntity = world ? gpuEntityManager->resolveShadowEntity(spawnId, *world)
+                                   : gpuEntityManager->getECSEntityFromSpawnId(spawnId);
+            std::cout << "\n=== ENTITY DEBUG INFO (position mirror, frame " << snapshot->frame << ") ===" << std::endl;
+            std::cout << "World Position: (" << worldPos.x << ", " << worldPos.y << ")" << std::endl;
+            std::cout << "GPU Buffer Index: " << slot << std::endl;
+            std::cout << "ECS Entity ID: " << std::hex << ecsEntity.id() << std::dec
+                      << (ecsEntity.is_valid() ? " (valid)" : " (invalid/unmapped)") << std::endl;
+            std::cout << "Position: (" << snapshot->x[slot] << ", " << snapshot->y[slot] << ")" << std::endl;
+            std::cout << "========================\n" << std::endl;
+            debugEntityComponents(gpuEntityManager, spawnId);
+            return;
         }
-        std::cout << std::endl;
-        std::cout << "Position: (" << debugInfo.position.x << ", " << debugInfo.position.y 
-                  << ", " << debugInfo.position.z << ")" << std::endl;
-        std::cout << "Velocity: (" << debugInfo.velocity.x << ", " << debugInfo.velocity.y 
-                  << ") | Damping: " << debugInfo.velocity.z << std::endl;
-        std::cout << "Spatial Cell: " << debugInfo.spatialCell << std::endl;
-        
-        // Calculate spatial cell coordinates for readability
-        const uint32_t GRID_WIDTH = 64;
-        uint32_t cellX = debugInfo.spatialCell % GRID_WIDTH;
-        uint32_t cellY = debugInfo.spatialCell / GRID_WIDTH;
-        std::cout << "Spatial Grid: (" << cellX << ", " << cellY << ")" << std::endl;
-        std::cout << "========================\n" << std::endl;
-    } else {
-        std::cout << "No entity found at world position (" << worldPos.x << ", " << worldPos.y << ")" << std::endl;
     }
+    
+    // Results arrive a few frames later through the readback ring, without stalling the GPU
+    const SpatialGridConfig grid = bufferManager.getSpatialGridConfig();
+    bool queued = bufferManager.requestEntityAtPosition(worldPos,
+        [gpuEntityManager, worldPos, grid](bool found, const EntityBufferManager::EntityDebugInfo& debugInfo) {
+            if (found) {
+                // The spawn ID was read back with the entity, so it still matches even if slots were reordered since
+                auto ecsEntity = gpuEntityManager->getECSEntityFromSpawnId(debugInfo.spawnId);
+                
+                std::cout << "\n=== ENTITY DEBUG INFO ===" << std::endl;
+                std::cout << "World Position: (" << worldPos.x << ", " << worldPos.y << ")" << std::endl;
+                std::cout << "GPU Buffer Index: " << debugInfo.entityId << std::endl;
+                std::cout << "ECS Entity ID: " << std::hex << ecsEntity.id() << std::dec;
+                if (ecsEntity.is_valid()) {
+                    std::cout << " (valid)";
+                } else {
+                    std::cout << " (invalid/unmapped)";
+                }
+                std::cout << std::endl;
+                std::cout << "Position: (" << debugInfo.position.x << ", " << debugInfo.position.y 
+                          << ", " << debugInfo.position.z << ")" << std::endl;
+                std::cout << "Velocity: (" << debugInfo.velocity.x << ", " << debugInfo.velocity.y 
+                          << ") | Damping: " << debugInfo.velocity.z << std::endl;
+                std::cout << "Spatial Cell: " << debugInfo.spatialCell << std::endl;
+                
+                // Wrapped cell coordinates for readability (the cell index may be in Morton order)
+                glm::ivec2 cell = glm::ivec2(glm::floor(glm::vec2(debugInfo.position) / grid.cellSize));
+                uint32_t cellX = static_cast<uint32_t>(cell.x) & (grid.width - 1);
+                uint32_t cellY = static_cast<uint32_t>(cell.y) & (grid.height - 1);
+                std::cout << "Spatial Grid: (" << cellX << ", " << cellY << ")" << std::endl;
+                std::cout << "========================\n" << std::endl;
+                debugEntityComponents(gpuEntityManager, debugInfo.spawnId);
+            } else {
+                std::cout << "No entity found at world position (" << worldPos.x << ", " << worldPos.y << ")" << std::endl;
+            }
+        });
+    
+    if (!queued) {
+        std::cerr << "GameControlService::debugEntityAtPosition - Failed to queue entity readback" << std::endl;
+    }
+}
+
+void GameControlService::debugEntityComponents(GPUEntityManager* gpuEntityManager, uint32_t spawnId) {
+    // Entities with their components already are printed too, a few frames later than the GPU state above
+    gpuEntityManager->requestRehydration(spawnId, [spawnId](flecs::entity entity) {
+        const Transform* transform = entity.get<Transform>();
+        const MovementPattern* pattern = entity.get<MovementPattern>();
+        if (!transform || !pattern) return;
+        std::cout << "\n=== ENTITY COMPONENTS (spawn ID " << spawnId << ") ===" << std::endl;
+        std::cout << "Position: (" << transform->position.x << ", " << transform->position.y << ")" << std::endl;
+        std::cout << "Movement: type " << static_cast<uint32_t>(pattern->type) << " | Amplitude: " << pattern->amplitude
+                  << " | Frequency: " << pattern->frequency << " | Phase: " << pattern->phase << std::endl;
+        std::cout << "========================\n" << std::endl;
+    });
 }
 
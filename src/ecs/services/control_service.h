@@ -14,6 +14,8 @@ class EntityFactory;
 class InputService;
 class CameraService;
 class RenderingService;
+class GPUEntityManager;
+enum class PresentPolicy : uint32_t;
 
 // Control action types
 enum class ControlActionType {
@@ -24,7 +26,8 @@ enum class ControlActionType {
     PERFORMANCE_STATS,
     GRAPHICS_TESTS,
     CAMERA_CONTROL,
-    RENDERING_DEBUG
+    RENDERING_DEBUG,
+    RENDER_QUALITY
 };
 
 // Control action definition
@@ -46,15 +49,26 @@ struct ControlState {
     bool wireframeMode = false;
     bool performanceMonitoring = true;
     
+    // Last requested render quality; the renderer may clamp it to what the device supports
+    uint32_t msaaSamples = 1;
+    float renderScale = 1.0f;
+    PresentPolicy presentPolicy{};
+    bool collisions = true;  // Physics shader variant
+    bool performanceHud = false;
+    bool overdraw = false;
+    uint32_t emitterSeed = 0;  // Advanced per GPU-emitted swarm, so bursts at one spot differ
+    
     // Request flags
     bool requestEntityCreation = false;
     bool requestSwarmCreation = false;
+    bool requestSwarmEmission = false;
     bool requestPerformanceStats = false;
     bool requestGraphicsTests = false;
     
     void resetRequestFlags() {
         requestEntityCreation = false;
         requestSwarmCreation = false;
+        requestSwarmEmission = false;
         requestPerformanceStats = false;
         requestGraphicsTests = false;
     }
@@ -91,14 +105,38 @@ public:
     
     // Game logic actions
     void toggleMovementType();
+    MovementType getCurrentMovementType() const { return static_cast<MovementType>(controlState.currentMovementType); }
     void createEntity(const glm::vec2& position);
     void createSwarm(size_t count, const glm::vec3& center, float radius);
-    void debugEntityAtPosition(const glm::vec2& worldPos);
+    
+    // Same burst as createSwarm, initialised on the GPU from one emitter record - no ECS entities are created.
+    // A lifetime (seconds) lets the GPU expire the entities itself
+    void emitSwarm(uint32_t count, const glm::vec3& center, float radius, float lifetime = 0.0f);
+    // Exact through the GPU pick attachment at viewportPos (0..1 of the window) when the renderer has one,
+    // otherwise the spatial search around worldPos
+    void debugEntityAtPosition(const glm::vec2& worldPos, const glm::vec2& viewportPos);
+
     void showPerformanceStats();
     void runGraphicsTests();
     void toggleDebugMode();
     void toggleWireframeMode();
     
+    // Render quality: MSAA 1x -> 2x -> 4x -> 8x, render scale 1 -> 0.75 -> 0.5, both wrapping
+    void cycleMSAASamples();
+    void cycleRenderScale();
+    
+    // Present policy: low-latency -> power-saver -> max-fps, wrapping
+    void cyclePresentPolicy();
+    
+    // Switches physics to the shader variant with collisions compiled in or out
+    void toggleCollisions();
+    
+    // Shows or hides the on-screen performance HUD
+    void togglePerformanceHud();
+    
+    // Shows or hides the overdraw heat map and its HUD and metrics figures
+    void toggleOverdraw();
+    
     // Camera control integration
     void handleCameraControls();
     void resetCamera();
@@ -127,6 +165,9 @@ private:
     CameraService* cameraService = nullptr;
     RenderingService* renderingService = nullptr;
     
+    // Spawn positions for focusCameraOnEntities before the first GPU bounds readback
+    flecs::query<const Transform> transformQuery_;
+    
     // Control system state
     ControlState controlState;
     std::unordered_map<std::string, ControlAction> actions;
@@ -151,11 +192,27 @@ private:
     void actionToggleMovement();
     void actionCreateEntity();
     void actionCreateSwarm();
+    void actionEmitSwarm();
     void actionDebugEntity();
     void actionShowStats();
     void actionGraphicsTests();
     void actionToggleDebug();
     void actionCameraReset();
     void actionCameraFocus();
+    void actionCycleMSAA();
+    void actionCycleRenderScale();
+    void actionCyclePresentPolicy();
+    void actionToggleCollisions();
+    void actionTogglePerformanceHud();
+    void actionToggleOverdraw();
+    
+    void requestRenderQuality();
+    
+    // debugEntityAtPosition without the pick buffer: position mirror, then spatial hash readback. Shadow
+    // entities are only resolved when given a world the caller holds still
+    static void debugEntityBySpatialSearch(GPUEntityManager* gpuEntityManager, glm::vec2 worldPos, flecs::world* world);
+    
+    // Rehydrates a picked GPU-resident entity and prints its components once they are back (GPUEntityManager::requestRehydration)
+    static void debugEntityComponents(GPUEntityManager* gpuEntityManager, uint32_t spawnId);
 };
 
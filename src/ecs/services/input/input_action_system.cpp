@@ -3,6 +3,8 @@
 #include "input_event_processor.h" // For KeyboardState, MouseState
 #include <iostream>
 #include <algorithm>
+#include <bit>
+#include <cmath>
 
 InputActionSystem::InputActionSystem() {
 }
@@ -34,6 +36,14 @@ void InputActionSystem::cleanup() {
     actions.clear();
     actionStates.clear();
     actionCallbacks.clear();
+    resolvedActions.clear();
+    keyActions.clear();
+    buttonActions.clear();
+    modifierActions.clear();
+    analogActions.clear();
+    activeActions.clear();
+    edgeActions.clear();
+    bindingsResolved = false;
     initialized = false;
 }
 
@@ -49,6 +59,7 @@ void InputActionSystem::registerAction(const InputActionDefinition& actionDef) {
     state.justPressed = false;
     state.justReleased = false;
     state.duration = 0.0f;
+    bindingsResolved = false;
     
     // Auto-bind default bindings to default context
     if (contextManager) {
@@ -71,47 +82,142 @@ void InputActionSystem::updateActionStates(const KeyboardState& keyboardState,
         return;
     }
     
-    // Clear frame-based states
-    for (auto& [actionName, state] : actionStates) {
-        state.justPressed = false;
-        state.justReleased = false;
+    // Clear last update's edges
+    for (uint32_t index : edgeActions) {
+        resolvedActions[index].state->justPressed = false;
+        resolvedActions[index].state->justReleased = false;
     }
+    edgeActions.clear();
     
-    // Update each registered action
-    for (auto& [actionName, state] : actionStates) {
-        bool wasActive = state.digitalValue || 
-                        std::abs(state.analogValue1D) > 0.01f ||
-                        glm::length(state.analogValue2D) > 0.01f;
-        
-        // Reset values
-        state.digitalValue = false;
-        state.analogValue1D = 0.0f;
-        state.analogValue2D = glm::vec2(0.0f);
-        
-        // Get bindings from context manager for this action
-        auto bindings = contextManager.getActionBindings(actionName);
-        for (const auto& binding : bindings) {
-            evaluateBinding(binding, actionName, state, keyboardState, mouseState);
+    // New bindings or contexts re-evaluate every action
+    ++updateCount;
+    pendingActions.clear();
+    auto queue = [this](uint32_t index) {
+        if (resolvedActions[index].markedUpdate != updateCount) {
+            resolvedActions[index].markedUpdate = updateCount;
+            pendingActions.push_back(index);
         }
+    };
+    if (!bindingsResolved || resolvedBindingVersion != contextManager.getBindingVersion()) {
+        resolveBindings(contextManager);
+        for (uint32_t index = 0; index < resolvedActions.size(); ++index) {
+            queue(index);
+        }
+    } else {
+        for (uint16_t scancode : keyboardState.changedKeys) {
+            auto it = keyActions.find(scancode);
+            if (it != keyActions.end()) {
+                for (uint32_t index : it->second) queue(index);
+            }
+        }
+        for (uint32_t mask = mouseState.changedButtonMask; mask != 0; mask &= mask - 1) {
+            auto it = buttonActions.find(std::countr_zero(mask) + 1);
+            if (it != buttonActions.end()) {
+                for (uint32_t index : it->second) queue(index);
+            }
+        }
+        if (keyboardState.modifiersChanged) {
+            for (uint32_t index : modifierActions) queue(index);
+        }
+        for (uint32_t index : analogActions) queue(index);
+    }
+    
+    // Active actions whose inputs did not change stay active
+    stillActive.clear();
+    for (uint32_t index : activeActions) {
+        if (resolvedActions[index].markedUpdate != updateCount) {
+            resolvedActions[index].state->duration += deltaTime;
+            stillActive.push_back(index);
+        }
+    }
+    activeActions.swap(stillActive);
+    
+    for (uint32_t index : pendingActions) {
+        ResolvedAction& action = resolvedActions[index];
+        evaluateAction(action, keyboardState, mouseState, deltaTime);
+        if (action.state->justPressed || action.state->justReleased) {
+            edgeActions.push_back(index);
+        }
+        if (action.state->digitalValue || std::abs(action.state->analogValue1D) > 0.01f ||
+            glm::length(action.state->analogValue2D) > 0.01f) {
+            activeActions.push_back(index);
+        }
+    }
+}
+
+void InputActionSystem::resolveBindings(const InputContextManager& contextManager) {
+    resolvedActions.clear();
+    keyActions.clear();
+    buttonActions.clear();
+    modifierActions.clear();
+    analogActions.clear();
+    activeActions.clear();
+    
+    resolvedActions.reserve(actionStates.size());
+    for (auto& [actionName, state] : actionStates) {
+        const uint32_t index = static_cast<uint32_t>(resolvedActions.size());
+        ResolvedAction& action = resolvedActions.emplace_back();
+        action.name = &actionName;
+        action.state = &state;
+        action.bindings = contextManager.getActionBindings(actionName);
         
-        // Update duration and transition states
-        bool isActive = state.digitalValue || 
-                       std::abs(state.analogValue1D) > 0.01f ||
-                       glm::length(state.analogValue2D) > 0.01f;
-        
-        if (isActive) {
-            if (!wasActive) {
-                state.justPressed = true;
-                state.duration = 0.0f;
+        bool analog = false;
+        bool modifiers = false;
+        for (const auto& binding : action.bindings) {
+            if (binding.inputType == InputBinding::InputType::KEYBOARD_KEY) {
+                auto& indices = keyActions[binding.keycode];
+                if (indices.empty() || indices.back() != index) indices.push_back(index);
+            } else if (binding.inputType == InputBinding::InputType::MOUSE_BUTTON) {
+                auto& indices = buttonActions[binding.mouseButton];
+                if (indices.empty() || indices.back() != index) indices.push_back(index);
             } else {
-                state.duration += deltaTime;
-            }
-        } else {
-            if (wasActive) {
-                state.justReleased = true;
+                analog = true;
             }
+            modifiers = modifiers || binding.requiresShift || binding.requiresCtrl || binding.requiresAlt;
+        }
+        if (analog) analogActions.push_back(index);
+        if (modifiers) modifierActions.push_back(index);
+    }
+    
+    resolvedBindingVersion = contextManager.getBindingVersion();
+    bindingsResolved = true;
+}
+
+void InputActionSystem::evaluateAction(ResolvedAction& action,
+                                       const KeyboardState& keyboardState,
+                                       const MouseState& mouseState,
+                                       float deltaTime) {
+    InputActionState& state = *action.state;
+    bool wasActive = state.digitalValue || 
+                    std::abs(state.analogValue1D) > 0.01f ||
+                    glm::length(state.analogValue2D) > 0.01f;
+    
+    // Reset values
+    state.digitalValue = false;
+    state.analogValue1D = 0.0f;
+    state.analogValue2D = glm::vec2(0.0f);
+    
+    for (const auto& binding : action.bindings) {
+        evaluateBinding(binding, state, keyboardState, mouseState);
+    }
+    
+    // Update duration and transition states
+    bool isActive = state.digitalValue || 
+                   std::abs(state.analogValue1D) > 0.01f ||
+                   glm::length(state.analogValue2D) > 0.01f;
+    
+    if (isActive) {
+        if (!wasActive) {
+            state.justPressed = true;
             state.duration = 0.0f;
+        } else {
+            state.duration += deltaTime;
+        }
+    } else {
+        if (wasActive) {
+            state.justReleased = true;
         }
+        state.duration = 0.0f;
     }
 }
 
@@ -159,14 +265,30 @@ void InputActionSystem::unregisterActionCallback(const std::string& actionName)
 }
 
 void InputActionSystem::executeCallbacks() const {
-    for (const auto& [actionName, state] : actionStates) {
-        auto callbackIt = actionCallbacks.find(actionName);
+    if (actionCallbacks.empty()) {
+        return;
+    }
+    
+    // Only actions with an edge or currently active can qualify; an action in both lists is called once
+    auto call = [this](uint32_t index) {
+        const ResolvedAction& action = resolvedActions[index];
+        const InputActionState& state = *action.state;
+        auto callbackIt = actionCallbacks.find(*action.name);
         if (callbackIt != actionCallbacks.end() && 
             (state.justPressed || state.justReleased || 
              (state.digitalValue && state.type == InputActionType::DIGITAL) ||
              (std::abs(state.analogValue1D) > 0.01f && state.type == InputActionType::ANALOG_1D) ||
              (glm::length(state.analogValue2D) > 0.01f && state.type == InputActionType::ANALOG_2D))) {
-            callbackIt->second(actionName, state);
+            callbackIt->second(*action.name, state);
+        }
+    };
+    for (uint32_t index : edgeActions) {
+        call(index);
+    }
+    for (uint32_t index : activeActions) {
+        const InputActionState& state = *resolvedActions[index].state;
+        if (!state.justPressed && !state.justReleased) {
+            call(index);
         }
     }
 }
@@ -205,7 +327,6 @@ void InputActionSystem::printActionStates() const {
 }
 
 void InputActionSystem::evaluateBinding(const InputBinding& binding, 
-                                       const std::string& actionName, 
                                        InputActionState& state,
                                        const KeyboardState& keyboardState,
                                        const MouseState& mouseState) {
@@ -213,16 +334,9 @@ void InputActionSystem::evaluateBinding(const InputBinding& binding,
         return;
     }
     
-    auto actionIt = actions.find(actionName);
-    if (actionIt == actions.end()) {
-        return;
-    }
-    
-    const auto& actionDef = actionIt->second;
-    
     switch (binding.inputType) {
         case InputBinding::InputType::KEYBOARD_KEY:
-            if (actionDef.type == InputActionType::DIGITAL) {
+            if (state.type == InputActionType::DIGITAL) {
                 if (binding.keycode >= 0 && binding.keycode < static_cast<int>(KeyboardState::MAX_KEYS)) {
                     state.digitalValue = state.digitalValue || keyboardState.keys[binding.keycode];
                 }
@@ -230,7 +344,7 @@ void InputActionSystem::evaluateBinding(const InputBinding& binding,
             break;
             
         case InputBinding::InputType::MOUSE_BUTTON:
-            if (actionDef.type == InputActionType::DIGITAL) {
+            if (state.type == InputActionType::DIGITAL) {
                 if (binding.mouseButton > 0 && (binding.mouseButton - 1) < static_cast<int>(MouseState::MAX_BUTTONS)) {
                     state.digitalValue = state.digitalValue || mouseState.buttons[binding.mouseButton - 1];
                 }
@@ -238,13 +352,13 @@ void InputActionSystem::evaluateBinding(const InputBinding& binding,
             break;
             
         case InputBinding::InputType::MOUSE_AXIS_X:
-            if (actionDef.type == InputActionType::ANALOG_1D) {
+            if (state.type == InputActionType::ANALOG_1D) {
                 float value = mouseState.delta.x * binding.sensitivity;
                 if (binding.invertAxis) value = -value;
                 if (std::abs(value) > binding.deadzone) {
                     state.analogValue1D += value;
                 }
-            } else if (actionDef.type == InputActionType::ANALOG_2D) {
+            } else if (state.type == InputActionType::ANALOG_2D) {
                 float value = mouseState.delta.x * binding.sensitivity;
                 if (binding.invertAxis) value = -value;
                 if (std::abs(value) > binding.deadzone) {
@@ -254,13 +368,13 @@ void InputActionSystem::evaluateBinding(const InputBinding& binding,
             break;
             
         case InputBinding::InputType::MOUSE_AXIS_Y:
-            if (actionDef.type == InputActionType::ANALOG_1D) {
+            if (state.type == InputActionType::ANALOG_1D) {
                 float value = mouseState.delta.y * binding.sensitivity;
                 if (binding.invertAxis) value = -value;
                 if (std::abs(value) > binding.deadzone) {
                     state.analogValue1D += value;
                 }
-            } else if (actionDef.type == InputActionType::ANALOG_2D) {
+            } else if (state.type == InputActionType::ANALOG_2D) {
                 float value = mouseState.delta.y * binding.sensitivity;
                 if (binding.invertAxis) value = -value;
                 if (std::abs(value) > binding.deadzone) {
@@ -270,7 +384,7 @@ void InputActionSystem::evaluateBinding(const InputBinding& binding,
             break;
             
         case InputBinding::InputType::MOUSE_WHEEL_X:
-            if (actionDef.type == InputActionType::ANALOG_1D) {
+            if (state.type == InputActionType::ANALOG_1D) {
                 float value = mouseState.wheelDelta.x * binding.sensitivity;
                 if (binding.invertAxis) value = -value;
                 state.analogValue1D += value;
@@ -278,7 +392,7 @@ void InputActionSystem::evaluateBinding(const InputBinding& binding,
             break;
             
         case InputBinding::InputType::MOUSE_WHEEL_Y:
-            if (actionDef.type == InputActionType::ANALOG_1D) {
+            if (state.type == InputActionType::ANALOG_1D) {
                 float value = mouseState.wheelDelta.y * binding.sensitivity;
                 if (binding.invertAxis) value = -value;
                 state.analogValue1D += value;
@@ -1,6 +1,7 @@
 #pragma once
 
 #include "input_types.h"
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -27,7 +28,8 @@ public:
     void registerAction(const InputActionDefinition& actionDef);
     void clearActionBindings(const std::string& actionName);
     
-    // Action state updates
+    // Action state updates. Only actions bound to a key, button or modifier that changed this frame, and the
+    // mouse axis and wheel actions, are re-evaluated; active ones otherwise just accumulate duration
     void updateActionStates(const KeyboardState& keyboardState, 
                            const MouseState& mouseState,
                            const InputContextManager& contextManager,
@@ -61,14 +63,39 @@ private:
     std::unordered_map<std::string, InputActionState> actionStates;
     std::unordered_map<std::string, InputCallback> actionCallbacks;
     
+    // Each action's bindings resolved from the active contexts, rebuilt when actions are registered or the
+    // context manager's binding version changes, and indexed by the input they read
+    struct ResolvedAction {
+        const std::string* name = nullptr;
+        InputActionState* state = nullptr;
+        std::vector<InputBinding> bindings;
+        uint64_t markedUpdate = 0;  // Last update that queued it for evaluation
+    };
+    std::vector<ResolvedAction> resolvedActions;
+    std::unordered_map<int, std::vector<uint32_t>> keyActions;     // Scancode -> resolvedActions indices
+    std::unordered_map<int, std::vector<uint32_t>> buttonActions;  // SDL button (1-based) -> indices
+    std::vector<uint32_t> modifierActions;  // A binding requires shift, ctrl or alt
+    std::vector<uint32_t> analogActions;    // Mouse axis or wheel bindings, evaluated every update
+    std::vector<uint32_t> activeActions;    // Active after the last update
+    std::vector<uint32_t> edgeActions;      // justPressed or justReleased after the last update
+    std::vector<uint32_t> pendingActions;   // Scratch lists of one update
+    std::vector<uint32_t> stillActive;
+    uint64_t resolvedBindingVersion = 0;
+    bool bindingsResolved = false;
+    uint64_t updateCount = 0;
+    
     // Module references
     InputContextManager* contextManager = nullptr;
     
     bool initialized = false;
     
     // Internal methods
+    void resolveBindings(const InputContextManager& contextManager);
+    void evaluateAction(ResolvedAction& action,
+                        const KeyboardState& keyboardState,
+                        const MouseState& mouseState,
+                        float deltaTime);
     void evaluateBinding(const InputBinding& binding, 
-                        const std::string& actionName, 
                         InputActionState& state,
                         const KeyboardState& keyboardState,
                         const MouseState& mouseState);
@@ -30,6 +30,7 @@ void InputContextManager::cleanup() {
     contexts.clear();
     contextStack.clear();
     activeContextName = "default";
+    ++bindingVersion;
     initialized = false;
 }
 
@@ -39,12 +40,14 @@ void InputContextManager::registerContext(const std::string& name, int priority)
     context.priority = priority;
     context.active = false;
     contexts[name] = context;
+    ++bindingVersion;
 }
 
 void InputContextManager::setContextActive(const std::string& contextName, bool active) {
     auto it = contexts.find(contextName);
     if (it != contexts.end()) {
         it->second.active = active;
+        ++bindingVersion;
         if (active) {
             activeContextName = contextName;
         }
@@ -74,6 +77,7 @@ void InputContextManager::bindAction(const std::string& contextName, const std::
     auto contextIt = contexts.find(contextName);
     if (contextIt != contexts.end()) {
         contextIt->second.actionBindings[actionName].push_back(binding);
+        ++bindingVersion;
     }
 }
 
@@ -81,6 +85,7 @@ void InputContextManager::unbindAction(const std::string& contextName, const std
     auto contextIt = contexts.find(contextName);
     if (contextIt != contexts.end()) {
         contextIt->second.actionBindings.erase(actionName);
+        ++bindingVersion;
     }
 }
 
@@ -88,6 +93,7 @@ void InputContextManager::clearActionBindings(const std::string& actionName) {
     for (auto& [contextName, context] : contexts) {
         context.actionBindings.erase(actionName);
     }
+    ++bindingVersion;
 }
 
 std::vector<InputBinding> InputContextManager::getActionBindings(const std::string& actionName) const {
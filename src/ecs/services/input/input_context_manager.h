@@ -1,6 +1,7 @@
 #pragma once
 
 #include "input_types.h"
+#include <cstdint>
 #include <string>
 #include <unordered_map>
 #include <vector>
@@ -37,6 +38,11 @@ public:
     
     // Binding resolution
     std::vector<InputBinding> getActionBindings(const std::string& actionName) const;
+    
+    // Changes whenever a context or binding is added, removed or (de)activated, so resolved bindings can be
+    // cached until then; edits through getContextDefinitions() must call markBindingsChanged()
+    uint64_t getBindingVersion() const { return bindingVersion; }
+    void markBindingsChanged() { ++bindingVersion; }
     std::vector<InputBinding> getActionBindings(const std::string& contextName, const std::string& actionName) const;
     
     // Debug and introspection
@@ -55,6 +61,7 @@ private:
     std::unordered_map<std::string, InputContextDefinition> contexts;
     std::vector<std::string> contextStack;
     std::string activeContextName = "default";
+    uint64_t bindingVersion = 0;
     
     bool initialized = false;
     
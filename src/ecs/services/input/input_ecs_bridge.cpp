@@ -64,13 +64,16 @@ void InputECSBridge::synchronizeToECSComponents(const KeyboardState& keyboardSta
     // Update KeyboardInput component
     auto* keyboardInput = inputEntity.get_mut<KeyboardInput>();
     if (keyboardInput) {
-        // Copy internal keyboard state to ECS component
-        std::copy(keyboardState.keys, keyboardState.keys + KeyboardState::MAX_KEYS, 
-                 keyboardInput->keys);
-        std::copy(keyboardState.keysPressed, keyboardState.keysPressed + KeyboardState::MAX_KEYS,
-                 keyboardInput->keysPressed);
-        std::copy(keyboardState.keysReleased, keyboardState.keysReleased + KeyboardState::MAX_KEYS,
-                 keyboardInput->keysReleased);
+        // Mirror only the keys processSDLEvents() touched: last frame's edges it reset, then this frame's changes
+        for (uint16_t scancode : keyboardState.clearedKeys) {
+            keyboardInput->keysPressed[scancode] = false;
+            keyboardInput->keysReleased[scancode] = false;
+        }
+        for (uint16_t scancode : keyboardState.changedKeys) {
+            keyboardInput->keys[scancode] = keyboardState.keys[scancode];
+            keyboardInput->keysPressed[scancode] = keyboardState.keysPressed[scancode];
+            keyboardInput->keysReleased[scancode] = keyboardState.keysReleased[scancode];
+        }
         keyboardInput->shift = keyboardState.shift;
         keyboardInput->ctrl = keyboardState.ctrl;
         keyboardInput->alt = keyboardState.alt;
@@ -23,7 +23,7 @@ public:
     bool initialize(flecs::world& world);
     void cleanup();
     
-    // ECS synchronization
+    // ECS synchronization; call once per processSDLEvents(), since keys are mirrored from its change lists
     void synchronizeToECSComponents(const KeyboardState& keyboardState, 
                                    const MouseState& mouseState,
                                    float deltaTime);
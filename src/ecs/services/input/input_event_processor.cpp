@@ -1,6 +1,8 @@
 #include "input_event_processor.h"
+#include "input_lockstep.h"
 #include <iostream>
 #include <algorithm>
+#include <bit>
 
 InputEventProcessor::InputEventProcessor() {
 }
@@ -23,6 +25,11 @@ bool InputEventProcessor::initialize(SDL_Window* window) {
     keyboardState.shift = false;
     keyboardState.ctrl = false;
     keyboardState.alt = false;
+    keyboardState.changedKeys.clear();
+    keyboardState.clearedKeys.clear();
+    keyboardState.changedKeys.reserve(KeyboardState::MAX_KEYS);
+    keyboardState.clearedKeys.reserve(KeyboardState::MAX_KEYS);
+    keyboardState.modifiersChanged = false;
     
     std::fill(mouseState.buttons, mouseState.buttons + MouseState::MAX_BUTTONS, false);
     std::fill(mouseState.buttonsPressed, mouseState.buttonsPressed + MouseState::MAX_BUTTONS, false);
@@ -30,12 +37,15 @@ bool InputEventProcessor::initialize(SDL_Window* window) {
     mouseState.position = glm::vec2(0.0f);
     mouseState.delta = glm::vec2(0.0f);
     mouseState.wheelDelta = glm::vec2(0.0f);
+    mouseState.changedButtonMask = 0;
+    mouseState.clearedButtonMask = 0;
     
     hasWindowResize = false;
     windowResizeWidth = 0;
     windowResizeHeight = 0;
     quitRequested = false;
     inputConsumed = false;
+    refreshWindowVisibility();
     
     initialized = true;
     return true;
@@ -46,6 +56,7 @@ void InputEventProcessor::cleanup() {
         return;
     }
     
+    recorder.close();
     window = nullptr;
     initialized = false;
 }
@@ -55,49 +66,286 @@ void InputEventProcessor::processSDLEvents() {
         return;
     }
     
-    // Clear frame-based input states from previous frame
-    std::fill(keyboardState.keysPressed, keyboardState.keysPressed + KeyboardState::MAX_KEYS, false);
-    std::fill(keyboardState.keysReleased, keyboardState.keysReleased + KeyboardState::MAX_KEYS, false);
-    std::fill(mouseState.buttonsPressed, mouseState.buttonsPressed + MouseState::MAX_BUTTONS, false);
-    std::fill(mouseState.buttonsReleased, mouseState.buttonsReleased + MouseState::MAX_BUTTONS, false);
+    // Clear the previous frame's edges through the keys and buttons that had them
+    keyboardState.clearedKeys.swap(keyboardState.changedKeys);
+    keyboardState.changedKeys.clear();
+    for (uint16_t scancode : keyboardState.clearedKeys) {
+        keyboardState.keysPressed[scancode] = false;
+        keyboardState.keysReleased[scancode] = false;
+    }
+    keyboardState.modifiersChanged = false;
+    
+    mouseState.clearedButtonMask = mouseState.changedButtonMask;
+    mouseState.changedButtonMask = 0;
+    for (uint32_t mask = mouseState.clearedButtonMask; mask != 0; mask &= mask - 1) {
+        const int button = std::countr_zero(mask);
+        mouseState.buttonsPressed[button] = false;
+        mouseState.buttonsReleased[button] = false;
+    }
     
     // Clear frame-based deltas
     mouseState.delta = glm::vec2(0.0f);
     mouseState.wheelDelta = glm::vec2(0.0f);
     
+    mouseSamples.clear();
+    firstInputEventNs = 0;
+    
     // Clear window events
     hasWindowResize = false;
     
-    SDL_Event event;
-    while (SDL_PollEvent(&event)) {
-        switch (event.type) {
-            case SDL_EVENT_QUIT:
-                quitRequested = true;
-                break;
-                
-            case SDL_EVENT_KEY_DOWN:
-            case SDL_EVENT_KEY_UP:
-                handleKeyboardEvent(event);
-                break;
-                
-            case SDL_EVENT_MOUSE_BUTTON_DOWN:
-            case SDL_EVENT_MOUSE_BUTTON_UP:
-                handleMouseButtonEvent(event);
-                break;
-                
-            case SDL_EVENT_MOUSE_MOTION:
-                handleMouseMotionEvent(event);
-                break;
-                
-            case SDL_EVENT_MOUSE_WHEEL:
-                handleMouseWheelEvent(event);
-                break;
-                
-            case SDL_EVENT_WINDOW_RESIZED:
-                handleWindowEvent(event);
-                break;
+    // One pump, then the queue in batches rather than an SDL_PollEvent round trip per event
+    constexpr int EVENT_BATCH_SIZE = 64;
+    SDL_Event events[EVENT_BATCH_SIZE];
+    SDL_PumpEvents();
+    int eventCount;
+    while ((eventCount = SDL_PeepEvents(events, EVENT_BATCH_SIZE, SDL_GETEVENT, SDL_EVENT_FIRST, SDL_EVENT_LAST)) > 0) {
+        for (int i = 0; i < eventCount; ++i) {
+            processEvent(events[i]);
         }
     }
+    
+    if (replaying) {
+        if (replayResizePending) {
+            applyRecordedEvent({SDL_EVENT_WINDOW_RESIZED, 0, 0, float(replayHeader.windowWidth), float(replayHeader.windowHeight)});
+            replayResizePending = false;
+        }
+        for (uint32_t i = 0; i < replayEventCount; ++i) {
+            applyRecordedEvent(replayEvents[i]);
+        }
+        replayEventCount = 0;
+    } else if (recorder.isOpen() || lockstep) {
+        if (recorder.isOpen()) {
+            recorder.writeFrame(recordedDeltaTime, recordedEvents);
+        }
+        if (lockstep) {
+            lockstep->sendFrame(recordedDeltaTime, recordedEvents);
+        }
+        recordedEvents.clear();
+    }
+    
+    // Event timestamps are SDL ticks; one clock pair maps the frame's earliest onto the steady clock
+    if (firstInputEventNs != 0) {
+        const uint64_t ticksNow = SDL_GetTicksNS();
+        const auto steadyNow = std::chrono::steady_clock::now();
+        firstInputEventTime = steadyNow - std::chrono::nanoseconds(ticksNow > firstInputEventNs ? ticksNow - firstInputEventNs : 0);
+    }
+}
+
+bool InputEventProcessor::getFrameInputEventTime(std::chrono::steady_clock::time_point& eventTime) const {
+    if (firstInputEventNs == 0) {
+        return false;
+    }
+    eventTime = firstInputEventTime;
+    return true;
+}
+
+bool InputEventProcessor::startRecording(const std::string& path, uint32_t seed) {
+    if (!initialized || replaying) {
+        return false;
+    }
+    InputRecordingHeader header;
+    header.seed = seed;
+    if (window) {
+        SDL_GetWindowSize(window, &header.windowWidth, &header.windowHeight);
+    }
+    if (!recorder.open(path, header)) {
+        return false;
+    }
+    std::cout << "InputEventProcessor: Recording input to " << path << " (seed " << seed << ")" << std::endl;
+    return true;
+}
+
+bool InputEventProcessor::startReplay(const std::string& path) {
+    if (!initialized || recorder.isOpen() || lockstep || !replay.open(path)) {
+        return false;
+    }
+    replaying = true;
+    replayExhausted = false;
+    replayHeader = replay.getHeader();
+    replayResizePending = replayHeader.windowWidth > 0 && replayHeader.windowHeight > 0;
+    if (replayResizePending && window) {
+        SDL_SetWindowSize(window, replayHeader.windowWidth, replayHeader.windowHeight);
+    }
+    return true;
+}
+
+bool InputEventProcessor::startLockstep(LockstepSession* session) {
+    if (!initialized || !session || !session->isActive() || replaying || lockstep) {
+        return false;
+    }
+    lockstep = session;
+    if (session->isLeader()) {
+        return true;
+    }
+    
+    // A follower is a replay fed from the network, window size included, so mouse world positions match the leader's
+    if (recorder.isOpen()) {
+        lockstep = nullptr;
+        return false;
+    }
+    replaying = true;
+    replayExhausted = false;
+    replayHeader = session->getHeader();
+    replayResizePending = replayHeader.windowWidth > 0 && replayHeader.windowHeight > 0;
+    if (replayResizePending && window) {
+        SDL_SetWindowSize(window, replayHeader.windowWidth, replayHeader.windowHeight);
+    }
+    return true;
+}
+
+float InputEventProcessor::resolveFrameDeltaTime(float measuredDeltaTime) {
+    if (!replaying) {
+        recordedDeltaTime = measuredDeltaTime;
+        return measuredDeltaTime;
+    }
+    float deltaTime = measuredDeltaTime;
+    const bool frameAvailable = lockstep ? lockstep->receiveFrame(deltaTime, replayEvents, replayEventCount)
+                                         : replay.nextFrame(deltaTime, replayEvents, replayEventCount);
+    if (!frameAvailable) {
+        replayExhausted = true;
+        replayEventCount = 0;
+    }
+    return deltaTime;
+}
+
+void InputEventProcessor::recordEvent(const SDL_Event& event) {
+    RecordedInputEvent recorded;
+    recorded.type = event.type;
+    switch (event.type) {
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP:
+            recorded.code = static_cast<uint16_t>(event.key.scancode);
+            recorded.modifiers = static_cast<uint16_t>(event.key.mod);
+            break;
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            recorded.code = event.button.button;
+            recorded.x = event.button.x;
+            recorded.y = event.button.y;
+            break;
+        case SDL_EVENT_MOUSE_MOTION:
+            recorded.x = event.motion.x;
+            recorded.y = event.motion.y;
+            recorded.dx = event.motion.xrel;
+            recorded.dy = event.motion.yrel;
+            break;
+        case SDL_EVENT_MOUSE_WHEEL:
+            recorded.x = event.wheel.x;
+            recorded.y = event.wheel.y;
+            break;
+        case SDL_EVENT_WINDOW_RESIZED:
+            recorded.x = static_cast<float>(event.window.data1);
+            recorded.y = static_cast<float>(event.window.data2);
+            break;
+    }
+    recordedEvents.push_back(recorded);
+}
+
+void InputEventProcessor::applyRecordedEvent(const RecordedInputEvent& recorded) {
+    // Rebuilt as the SDL event the handlers would have seen, stamped now so latency is measured from the replay
+    SDL_Event event{};
+    event.type = recorded.type;
+    event.common.timestamp = SDL_GetTicksNS();
+    switch (recorded.type) {
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP:
+            event.key.scancode = static_cast<SDL_Scancode>(recorded.code);
+            event.key.mod = recorded.modifiers;
+            event.key.down = recorded.type == SDL_EVENT_KEY_DOWN;
+            handleKeyboardEvent(event);
+            break;
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            event.button.button = static_cast<Uint8>(recorded.code);
+            event.button.down = recorded.type == SDL_EVENT_MOUSE_BUTTON_DOWN;
+            event.button.x = recorded.x;
+            event.button.y = recorded.y;
+            handleMouseButtonEvent(event);
+            break;
+        case SDL_EVENT_MOUSE_MOTION:
+            event.motion.x = recorded.x;
+            event.motion.y = recorded.y;
+            event.motion.xrel = recorded.dx;
+            event.motion.yrel = recorded.dy;
+            handleMouseMotionEvent(event);
+            break;
+        case SDL_EVENT_MOUSE_WHEEL:
+            event.wheel.x = recorded.x;
+            event.wheel.y = recorded.y;
+            handleMouseWheelEvent(event);
+            break;
+        case SDL_EVENT_WINDOW_RESIZED:
+            // Mouse world positions are taken against the window size, so the window follows the recording
+            event.window.data1 = static_cast<int32_t>(recorded.x);
+            event.window.data2 = static_cast<int32_t>(recorded.y);
+            if (window) {
+                SDL_SetWindowSize(window, event.window.data1, event.window.data2);
+            }
+            handleWindowEvent(event);
+            break;
+    }
+}
+
+void InputEventProcessor::setRawMouseSamplesEnabled(bool enabled) {
+    rawMouseSamples = enabled;
+    if (!enabled) {
+        mouseSamples.clear();
+        mouseSamples.shrink_to_fit();
+    }
+}
+
+void InputEventProcessor::processEvent(const SDL_Event& event) {
+    switch (event.type) {
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP:
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+        case SDL_EVENT_MOUSE_MOTION:
+        case SDL_EVENT_MOUSE_WHEEL:
+        case SDL_EVENT_WINDOW_RESIZED:
+            if (replaying) {
+                return;  // Replaced by the recording's events
+            }
+            if (recorder.isOpen() || lockstep) {
+                recordEvent(event);
+            }
+            break;
+    }
+    
+    switch (event.type) {
+        case SDL_EVENT_QUIT:
+            quitRequested = true;
+            break;
+            
+        case SDL_EVENT_KEY_DOWN:
+        case SDL_EVENT_KEY_UP:
+            handleKeyboardEvent(event);
+            break;
+            
+        case SDL_EVENT_MOUSE_BUTTON_DOWN:
+        case SDL_EVENT_MOUSE_BUTTON_UP:
+            handleMouseButtonEvent(event);
+            break;
+            
+        case SDL_EVENT_MOUSE_MOTION:
+            handleMouseMotionEvent(event);
+            break;
+            
+        case SDL_EVENT_MOUSE_WHEEL:
+            handleMouseWheelEvent(event);
+            break;
+            
+        case SDL_EVENT_WINDOW_RESIZED:
+        case SDL_EVENT_WINDOW_MINIMIZED:
+        case SDL_EVENT_WINDOW_MAXIMIZED:
+        case SDL_EVENT_WINDOW_RESTORED:
+        case SDL_EVENT_WINDOW_HIDDEN:
+        case SDL_EVENT_WINDOW_SHOWN:
+        case SDL_EVENT_WINDOW_OCCLUDED:
+        case SDL_EVENT_WINDOW_EXPOSED:
+            handleWindowEvent(event);
+            break;
+    }
 }
 
 bool InputEventProcessor::isKeyDown(int scancode) const {
@@ -167,35 +415,53 @@ bool InputEventProcessor::shouldQuit() const {
     return quitRequested;
 }
 
+bool InputEventProcessor::waitForEvents(int32_t timeoutMs) const {
+    return initialized && SDL_WaitEventTimeout(nullptr, timeoutMs);
+}
+
 void InputEventProcessor::handleKeyboardEvent(const SDL_Event& event) {
+    stampInputEvent(event.common.timestamp);
     int scancode = event.key.scancode;
     bool pressed = (event.type == SDL_EVENT_KEY_DOWN);
     
-    if (scancode >= 0 && scancode < static_cast<int>(KeyboardState::MAX_KEYS)) {
-        if (pressed && !keyboardState.keys[scancode]) {
+    if (scancode >= 0 && scancode < static_cast<int>(KeyboardState::MAX_KEYS) && pressed != keyboardState.keys[scancode]) {
+        // Repeats leave the state alone; a key that goes down and up within one frame is listed once
+        if (!keyboardState.keysPressed[scancode] && !keyboardState.keysReleased[scancode]) {
+            keyboardState.changedKeys.push_back(static_cast<uint16_t>(scancode));
+        }
+        if (pressed) {
             keyboardState.keysPressed[scancode] = true;
             std::cout << "Key scancode " << scancode << " pressed! (SDL_SCANCODE_EQUALS=" << SDL_SCANCODE_EQUALS << ")" << std::endl;
-        } else if (!pressed && keyboardState.keys[scancode]) {
+        } else {
             keyboardState.keysReleased[scancode] = true;
         }
         keyboardState.keys[scancode] = pressed;
     }
     
-    // Update modifier states
-    keyboardState.shift = (SDL_GetModState() & (SDL_KMOD_LSHIFT | SDL_KMOD_RSHIFT)) != 0;
-    keyboardState.ctrl = (SDL_GetModState() & (SDL_KMOD_LCTRL | SDL_KMOD_RCTRL)) != 0;
-    keyboardState.alt = (SDL_GetModState() & (SDL_KMOD_LALT | SDL_KMOD_RALT)) != 0;
+    // Update modifier states from the event's own, which a replayed event carries from the recording
+    const SDL_Keymod modState = event.key.mod;
+    const bool shift = (modState & (SDL_KMOD_LSHIFT | SDL_KMOD_RSHIFT)) != 0;
+    const bool ctrl = (modState & (SDL_KMOD_LCTRL | SDL_KMOD_RCTRL)) != 0;
+    const bool alt = (modState & (SDL_KMOD_LALT | SDL_KMOD_RALT)) != 0;
+    if (shift != keyboardState.shift || ctrl != keyboardState.ctrl || alt != keyboardState.alt) {
+        keyboardState.shift = shift;
+        keyboardState.ctrl = ctrl;
+        keyboardState.alt = alt;
+        keyboardState.modifiersChanged = true;
+    }
 }
 
 void InputEventProcessor::handleMouseButtonEvent(const SDL_Event& event) {
+    stampInputEvent(event.common.timestamp);
     int button = event.button.button - 1; // SDL uses 1-based indexing, convert to 0-based for array
     bool pressed = (event.type == SDL_EVENT_MOUSE_BUTTON_DOWN);
     
-    if (button >= 0 && button < static_cast<int>(MouseState::MAX_BUTTONS)) {
-        if (pressed && !mouseState.buttons[button]) {
+    if (button >= 0 && button < static_cast<int>(MouseState::MAX_BUTTONS) && pressed != mouseState.buttons[button]) {
+        mouseState.changedButtonMask |= 1u << button;
+        if (pressed) {
             mouseState.buttonsPressed[button] = true;
             std::cout << "Mouse button " << (button + 1) << " (SDL_BUTTON_" << (button + 1) << ") pressed!" << std::endl;
-        } else if (!pressed && mouseState.buttons[button]) {
+        } else {
             mouseState.buttonsReleased[button] = true;
         }
         mouseState.buttons[button] = pressed;
@@ -203,15 +469,27 @@ void InputEventProcessor::handleMouseButtonEvent(const SDL_Event& event) {
 }
 
 void InputEventProcessor::handleMouseMotionEvent(const SDL_Event& event) {
+    stampInputEvent(event.common.timestamp);
+    const glm::vec2 delta(static_cast<float>(event.motion.xrel), static_cast<float>(event.motion.yrel));
     mouseState.position.x = static_cast<float>(event.motion.x);
     mouseState.position.y = static_cast<float>(event.motion.y);
-    mouseState.delta.x = static_cast<float>(event.motion.xrel);
-    mouseState.delta.y = static_cast<float>(event.motion.yrel);
+    mouseState.delta.x += delta.x;
+    mouseState.delta.y += delta.y;
+    
+    if (rawMouseSamples) {
+        mouseSamples.push_back({event.motion.timestamp, mouseState.position, delta, glm::vec2(0.0f)});
+    }
 }
 
 void InputEventProcessor::handleMouseWheelEvent(const SDL_Event& event) {
-    mouseState.wheelDelta.x = static_cast<float>(event.wheel.x);
-    mouseState.wheelDelta.y = static_cast<float>(event.wheel.y);
+    stampInputEvent(event.common.timestamp);
+    const glm::vec2 wheel(static_cast<float>(event.wheel.x), static_cast<float>(event.wheel.y));
+    mouseState.wheelDelta.x += wheel.x;
+    mouseState.wheelDelta.y += wheel.y;
+    
+    if (rawMouseSamples) {
+        mouseSamples.push_back({event.wheel.timestamp, mouseState.position, glm::vec2(0.0f), wheel});
+    }
 }
 
 void InputEventProcessor::handleWindowEvent(const SDL_Event& event) {
@@ -219,5 +497,13 @@ void InputEventProcessor::handleWindowEvent(const SDL_Event& event) {
         hasWindowResize = true;
         windowResizeWidth = event.window.data1;
         windowResizeHeight = event.window.data2;
+    } else {
+        refreshWindowVisibility();
     }
+}
+
+void InputEventProcessor::refreshWindowVisibility() {
+    // Read from the flags rather than inferred from the event, as minimized, hidden and occluded overlap
+    const SDL_WindowFlags hiddenFlags = SDL_WINDOW_MINIMIZED | SDL_WINDOW_HIDDEN | SDL_WINDOW_OCCLUDED;
+    windowVisible = !window || (SDL_GetWindowFlags(window) & hiddenFlags) == 0;
 }
\ No newline at end of file
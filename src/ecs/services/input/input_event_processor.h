@@ -1,9 +1,18 @@
 #pragma once
 
+#include "input_recording.h"
 #include <SDL3/SDL.h>
 #include <glm/glm.hpp>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
 
-// Input state structures
+class LockstepSession;
+
+// Input state structures. The arrays hold the full state; the change lists name the entries an event touched
+// this frame (changed*) and the previous frame's, whose pressed/released edges processSDLEvents() reset (cleared*),
+// so consumers update only those instead of scanning every key
 struct KeyboardState {
     static constexpr size_t MAX_KEYS = 512;
     bool keys[MAX_KEYS] = {false};
@@ -12,6 +21,10 @@ struct KeyboardState {
     bool shift = false;
     bool ctrl = false;
     bool alt = false;
+    
+    std::vector<uint16_t> changedKeys;  // Scancodes pressed or released this frame, once each
+    std::vector<uint16_t> clearedKeys;
+    bool modifiersChanged = false;
 };
 
 struct MouseState {
@@ -19,9 +32,19 @@ struct MouseState {
     bool buttons[MAX_BUTTONS] = {false};
     bool buttonsPressed[MAX_BUTTONS] = {false};
     bool buttonsReleased[MAX_BUTTONS] = {false};
+    uint32_t changedButtonMask = 0;     // Bit i: buttons[i] pressed or released this frame
+    uint32_t clearedButtonMask = 0;
+    glm::vec2 position{0.0f};
+    glm::vec2 delta{0.0f};       // Sum of this frame's motion events
+    glm::vec2 wheelDelta{0.0f};  // Sum of this frame's wheel events
+};
+
+// One motion or wheel event as SDL delivered it, kept only while raw sampling is enabled
+struct MouseSample {
+    uint64_t timestampNs = 0;
     glm::vec2 position{0.0f};
     glm::vec2 delta{0.0f};
-    glm::vec2 wheelDelta{0.0f};
+    glm::vec2 wheel{0.0f};
 };
 
 // Input event processor - handles SDL events and maintains raw input state
@@ -34,9 +57,38 @@ public:
     bool initialize(SDL_Window* window);
     void cleanup();
     
-    // Event processing
+    // Event processing. Events are drained in batches; motion and wheel events only accumulate into the frame's
+    // MouseState, so a high polling rate mouse costs a few additions per event
     void processSDLEvents();
     
+    // Opt-in per-event mouse history (off by default): this frame's motion and wheel events in arrival order
+    void setRawMouseSamplesEnabled(bool enabled);
+    bool areRawMouseSamplesEnabled() const { return rawMouseSamples; }
+    const std::vector<MouseSample>& getRawMouseSamples() const { return mouseSamples; }
+    
+    // When the earliest key or mouse event of the last processSDLEvents() happened, on the steady clock; false
+    // when it had none. Input-to-present latency is measured from here
+    bool getFrameInputEventTime(std::chrono::steady_clock::time_point& eventTime) const;
+    
+    // Input recording and replay, after initialize(). A recording stores every frame's deltaTime and the key,
+    // mouse and resize events processSDLEvents() handled; a replay takes both from the file instead and reads
+    // the live queue only for quit and visibility, resizing the window to the recorded size as it goes
+    bool startRecording(const std::string& path, uint32_t seed);
+    bool startReplay(const std::string& path);
+    bool isRecording() const { return recorder.isOpen(); }
+    bool isReplaying() const { return replaying; }
+    bool isReplayFinished() const { return replaying && replayExhausted; }
+    const InputRecordingHeader* getReplayHeader() const { return replaying ? &replayHeader : nullptr; }
+    
+    // Lockstep (input_lockstep), after initialize() with a session already led or followed. A leader's frames go
+    // to its followers as a recording's go to the file; a follower replays the leader's frames as they arrive,
+    // with isReplayFinished() set once the leader has gone. The session outlives the processor's use of it
+    bool startLockstep(LockstepSession* session);
+    
+    // Once a frame before processSDLEvents(): the measured deltaTime (kept for the recording), or under a replay
+    // the next recorded frame's. Past the last recorded frame isReplayFinished() turns true
+    float resolveFrameDeltaTime(float measuredDeltaTime);
+    
     // Raw input queries
     bool isKeyDown(int scancode) const;
     bool isKeyPressed(int scancode) const;
@@ -52,6 +104,13 @@ public:
     bool hasWindowResizeEvent(int& width, int& height) const;
     bool shouldQuit() const;
     
+    // False while the window is minimized, hidden or occluded; re-read from the window flags on every
+    // visibility event
+    bool isWindowVisible() const { return windowVisible; }
+    
+    // Blocks until an event is queued or timeoutMs passes, leaving the event for the next processSDLEvents()
+    bool waitForEvents(int32_t timeoutMs) const;
+    
     // State access
     const KeyboardState& getKeyboardState() const { return keyboardState; }
     const MouseState& getMouseState() const { return mouseState; }
@@ -70,15 +129,42 @@ private:
     int windowResizeWidth = 0;
     int windowResizeHeight = 0;
     bool quitRequested = false;
+    bool windowVisible = true;
     
     // Input state
     KeyboardState keyboardState;
     MouseState mouseState;
+    bool rawMouseSamples = false;
+    std::vector<MouseSample> mouseSamples;
+    uint64_t firstInputEventNs = 0;  // SDL_GetTicksNS() clock, 0 = no key or mouse event this frame
+    std::chrono::steady_clock::time_point firstInputEventTime{};
+    
+    // Recording and replay
+    InputRecorder recorder;
+    std::vector<RecordedInputEvent> recordedEvents;  // This frame's, written at the end of processSDLEvents()
+    float recordedDeltaTime = 0.0f;
+    InputReplay replay;
+    InputRecordingHeader replayHeader{};  // The replay's, or the lockstep leader's
+    LockstepSession* lockstep = nullptr;
+    bool replaying = false;
+    bool replayExhausted = false;
+    bool replayResizePending = false;  // The recorded window size is applied with the first replayed frame
+    const RecordedInputEvent* replayEvents = nullptr;
+    uint32_t replayEventCount = 0;
     
     // SDL event handling
+    void processEvent(const SDL_Event& event);
     void handleKeyboardEvent(const SDL_Event& event);
     void handleMouseButtonEvent(const SDL_Event& event);
     void handleMouseMotionEvent(const SDL_Event& event);
     void handleMouseWheelEvent(const SDL_Event& event);
     void handleWindowEvent(const SDL_Event& event);
+    void recordEvent(const SDL_Event& event);
+    void applyRecordedEvent(const RecordedInputEvent& recorded);
+    void stampInputEvent(uint64_t timestampNs) {
+        if (firstInputEventNs == 0 || timestampNs < firstInputEventNs) {
+            firstInputEventNs = timestampNs;
+        }
+    }
+    void refreshWindowVisibility();
 };
\ No newline at end of file
@@ -0,0 +1,409 @@
+#include "input_lockstep.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+#include <cstring>
+#include <iostream>
+#include <thread>
+
+namespace {
+#ifdef _WIN32
+    using NativeSocket = SOCKET;
+#else
+    using NativeSocket = int;
+#endif
+
+    // INVALID_SOCKET and -1 both map to -1
+    intptr_t toHandle(NativeSocket socket) { return static_cast<intptr_t>(socket); }
+    NativeSocket toNative(intptr_t handle) { return static_cast<NativeSocket>(handle); }
+    
+    // A leader gone away must not kill the follower writing its ack (SIGPIPE)
+#ifdef MSG_NOSIGNAL
+    constexpr int SEND_FLAGS = MSG_NOSIGNAL;
+#else
+    constexpr int SEND_FLAGS = 0;
+#endif
+
+    // How long a follower keeps retrying a leader that is not listening yet
+    constexpr auto CONNECT_TIMEOUT = std::chrono::seconds(30);
+    constexpr auto CONNECT_RETRY_INTERVAL = std::chrono::milliseconds(250);
+    
+    // How long the leader holds for a follower past LOCKSTEP_MAX_LEAD_FRAMES before dropping it
+    constexpr auto STALL_TIMEOUT = std::chrono::seconds(5);
+    constexpr long ACK_POLL_MS = 10;
+    
+    // More events than any frame has; a larger count means the stream is corrupt
+    constexpr uint32_t MAX_FRAME_EVENTS = 65536;
+    
+    void closeSocket(intptr_t handle) {
+#ifdef _WIN32
+        closesocket(toNative(handle));
+#else
+        close(toNative(handle));
+#endif
+    }
+    
+    // Frames are small and latency bound, so they go out as written instead of waiting for a fuller segment
+    void setNoDelay(intptr_t handle) {
+        int noDelay = 1;
+        setsockopt(toNative(handle), IPPROTO_TCP, TCP_NODELAY, reinterpret_cast<const char*>(&noDelay), sizeof(noDelay));
+    }
+    
+    bool sendAll(intptr_t handle, const void* data, size_t size) {
+        const char* bytes = static_cast<const char*>(data);
+        while (size > 0) {
+            const auto written = send(toNative(handle), bytes, static_cast<int>(size), SEND_FLAGS);
+            if (written <= 0) {
+                return false;
+            }
+            bytes += written;
+            size -= static_cast<size_t>(written);
+        }
+        return true;
+    }
+    
+    bool receiveAll(intptr_t handle, void* data, size_t size) {
+        char* bytes = static_cast<char*>(data);
+        while (size > 0) {
+            const auto received = recv(toNative(handle), bytes, static_cast<int>(size), 0);
+            if (received <= 0) {
+                return false;
+            }
+            bytes += received;
+            size -= static_cast<size_t>(received);
+        }
+        return true;
+    }
+    
+    bool startSockets(bool& socketsInitialized) {
+#ifdef _WIN32
+        if (!socketsInitialized) {
+            WSADATA wsaData;
+            if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+                std::cerr << "LockstepSession: WSAStartup failed" << std::endl;
+                return false;
+            }
+            socketsInitialized = true;
+        }
+#else
+        (void)socketsInitialized;
+#endif
+        return true;
+    }
+}
+
+bool LockstepSession::lead(uint16_t port, uint32_t followerCount, const InputRecordingHeader& sessionHeader) {
+    close();
+    if (followerCount == 0 || !startSockets(socketsInitialized)) {
+        return false;
+    }
+    
+    SocketHandle listenSocket = toHandle(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+    if (listenSocket != INVALID_SOCKET_HANDLE) {
+        // A restarted leader rebinds while the last session's connections linger in TIME_WAIT
+        int reuse = 1;
+        setsockopt(toNative(listenSocket), SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+        
+        sockaddr_in address{};
+        address.sin_family = AF_INET;
+        address.sin_addr.s_addr = htonl(INADDR_ANY);
+        address.sin_port = htons(port);
+        if (bind(toNative(listenSocket), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+            listen(toNative(listenSocket), static_cast<int>(followerCount)) != 0) {
+            closeSocket(listenSocket);
+            listenSocket = INVALID_SOCKET_HANDLE;
+        }
+    }
+    if (listenSocket == INVALID_SOCKET_HANDLE) {
+        std::cerr << "LockstepSession: Failed to listen on port " << port << std::endl;
+        close();
+        return false;
+    }
+    
+    header = sessionHeader;
+    header.magic = InputRecordingHeader::MAGIC;
+    header.version = InputRecordingHeader::VERSION;
+    std::cout << "LockstepSession: Leading on port " << port << ", waiting for " << followerCount << " followers" << std::endl;
+    while (followers.size() < followerCount) {
+        const SocketHandle client = toHandle(accept(toNative(listenSocket), nullptr, nullptr));
+        if (client == INVALID_SOCKET_HANDLE) {
+            continue;
+        }
+        setNoDelay(client);
+        if (!sendAll(client, &header, sizeof(header))) {
+            closeSocket(client);
+            continue;
+        }
+        Follower follower;
+        follower.socket = client;
+        follower.index = static_cast<uint32_t>(followers.size()) + 1;
+        followers.push_back(follower);
+        std::cout << "LockstepSession: Follower " << follower.index << " of " << followerCount << " connected" << std::endl;
+    }
+    closeSocket(listenSocket);
+    
+    leading = true;
+    framesSent = 0;
+    history.fill(TickHash{});
+    std::cout << "LockstepSession: Session started (seed " << header.seed << ")" << std::endl;
+    return true;
+}
+
+bool LockstepSession::follow(const std::string& host, uint16_t port) {
+    close();
+    if (!startSockets(socketsInitialized)) {
+        return false;
+    }
+    
+    addrinfo hints{};
+    hints.ai_family = AF_INET;
+    hints.ai_socktype = SOCK_STREAM;
+    addrinfo* resolved = nullptr;
+    const std::string service = std::to_string(port);
+    if (getaddrinfo(host.c_str(), service.c_str(), &hints, &resolved) != 0 || !resolved) {
+        std::cerr << "LockstepSession: Failed to resolve leader " << host << std::endl;
+        close();
+        return false;
+    }
+    
+    std::cout << "LockstepSession: Connecting to leader " << host << ":" << port << std::endl;
+    const auto deadline = std::chrono::steady_clock::now() + CONNECT_TIMEOUT;
+    while (followerSocket == INVALID_SOCKET_HANDLE && std::chrono::steady_clock::now() < deadline) {
+        SocketHandle candidate = toHandle(socket(resolved->ai_family, resolved->ai_socktype, resolved->ai_protocol));
+        if (candidate != INVALID_SOCKET_HANDLE &&
+            connect(toNative(candidate), resolved->ai_addr, static_cast<int>(resolved->ai_addrlen)) == 0) {
+            followerSocket = candidate;
+            break;
+        }
+        if (candidate != INVALID_SOCKET_HANDLE) {
+            closeSocket(candidate);
+        }
+        std::this_thread::sleep_for(CONNECT_RETRY_INTERVAL);
+    }
+    freeaddrinfo(resolved);
+    if (followerSocket == INVALID_SOCKET_HANDLE) {
+        std::cerr << "LockstepSession: No leader at " << host << ":" << port << std::endl;
+        close();
+        return false;
+    }
+    setNoDelay(followerSocket);
+    
+    if (!receiveAll(followerSocket, &header, sizeof(header)) ||
+        header.magic != InputRecordingHeader::MAGIC || header.version != InputRecordingHeader::VERSION) {
+        std::cerr << "LockstepSession: " << host << ":" << port << " is not a version "
+                  << InputRecordingHeader::VERSION << " lockstep leader" << std::endl;
+        close();
+        return false;
+    }
+    framesReceived = 0;
+    std::cout << "LockstepSession: Following " << host << ":" << port << " (seed " << header.seed << ")" << std::endl;
+    return true;
+}
+
+void LockstepSession::close() {
+    for (Follower& follower : followers) {
+        std::cout << "LockstepSession: Follower " << follower.index << " matched " << follower.hashesMatched
+                  << " position hashes, " << follower.hashMismatches << " differed" << std::endl;
+        if (follower.socket != INVALID_SOCKET_HANDLE) {
+            closeSocket(follower.socket);
+        }
+    }
+    if (leading) {
+        std::cout << "LockstepSession: " << framesSent << " frames sent" << std::endl;
+    }
+    followers.clear();
+    leading = false;
+    
+    if (followerSocket != INVALID_SOCKET_HANDLE) {
+        closeSocket(followerSocket);
+        followerSocket = INVALID_SOCKET_HANDLE;
+        std::cout << "LockstepSession: " << framesReceived << " frames received" << std::endl;
+    }
+#ifdef _WIN32
+    if (socketsInitialized) {
+        WSACleanup();
+    }
+#endif
+    socketsInitialized = false;
+}
+
+void LockstepSession::sendFrame(float deltaTime, const std::vector<RecordedInputEvent>& events) {
+    if (!leading) {
+        return;
+    }
+    
+    // The acks that arrived meanwhile, then the wait for any follower that fell too far behind
+    pollAcks(0);
+    const auto stallStart = std::chrono::steady_clock::now();
+    auto isBehind = [this](const Follower& follower) {
+        return follower.socket != INVALID_SOCKET_HANDLE && framesSent - follower.ackedFrame > LOCKSTEP_MAX_LEAD_FRAMES;
+    };
+    while (std::any_of(followers.begin(), followers.end(), isBehind)) {
+        if (std::chrono::steady_clock::now() - stallStart > STALL_TIMEOUT) {
+            for (Follower& follower : followers) {
+                if (isBehind(follower)) {
+                    dropFollower(follower, "stopped answering");
+                }
+            }
+            break;
+        }
+        pollAcks(ACK_POLL_MS);
+    }
+    
+    // One write per follower, laid out as an input recording frame
+    const RecordedInputFrame frame{deltaTime, static_cast<uint32_t>(events.size())};
+    frameMessage.resize(sizeof(frame) + events.size() * sizeof(RecordedInputEvent));
+    std::memcpy(frameMessage.data(), &frame, sizeof(frame));
+    if (!events.empty()) {
+        std::memcpy(frameMessage.data() + sizeof(frame), events.data(), events.size() * sizeof(RecordedInputEvent));
+    }
+    for (Follower& follower : followers) {
+        if (follower.socket != INVALID_SOCKET_HANDLE && !sendAll(follower.socket, frameMessage.data(), frameMessage.size())) {
+            dropFollower(follower, "disconnected");
+        }
+    }
+    framesSent++;
+}
+
+bool LockstepSession::receiveFrame(float& deltaTime, const RecordedInputEvent*& events, uint32_t& eventCount) {
+    if (followerSocket == INVALID_SOCKET_HANDLE) {
+        return false;
+    }
+    
+    RecordedInputFrame frame;
+    bool received = receiveAll(followerSocket, &frame, sizeof(frame)) && frame.eventCount <= MAX_FRAME_EVENTS;
+    if (received) {
+        receivedEvents.resize(frame.eventCount);
+        received = frame.eventCount == 0 ||
+            receiveAll(followerSocket, receivedEvents.data(), receivedEvents.size() * sizeof(RecordedInputEvent));
+    }
+    if (!received) {
+        std::cout << "LockstepSession: Leader ended the session after " << framesReceived << " frames" << std::endl;
+        closeSocket(followerSocket);
+        followerSocket = INVALID_SOCKET_HANDLE;
+        return false;
+    }
+    
+    framesReceived++;
+    deltaTime = frame.deltaTime;
+    events = receivedEvents.data();
+    eventCount = frame.eventCount;
+    return true;
+}
+
+void LockstepSession::reportState(uint32_t tick, uint32_t positionHash, bool valid) {
+    if (leading) {
+        if (valid) {
+            history[tick % LOCKSTEP_HASH_HISTORY] = TickHash{tick, positionHash, true};
+        }
+        return;
+    }
+    if (followerSocket == INVALID_SOCKET_HANDLE) {
+        return;
+    }
+    
+    // Sent even without a hash: the ack is also what lets the leader run ahead
+    const LockstepAck ack{framesReceived, tick, positionHash, valid ? 1u : 0u};
+    if (!sendAll(followerSocket, &ack, sizeof(ack))) {
+        closeSocket(followerSocket);
+        followerSocket = INVALID_SOCKET_HANDLE;
+    }
+}
+
+void LockstepSession::pollAcks(long timeoutMs) {
+    fd_set readable;
+    FD_ZERO(&readable);
+    SocketHandle highest = INVALID_SOCKET_HANDLE;
+    for (const Follower& follower : followers) {
+        if (follower.socket != INVALID_SOCKET_HANDLE) {
+            FD_SET(toNative(follower.socket), &readable);
+            highest = std::max(highest, follower.socket);
+        }
+    }
+    if (highest == INVALID_SOCKET_HANDLE) {
+        return;
+    }
+    
+    timeval timeout{};
+    timeout.tv_sec = timeoutMs / 1000;
+    timeout.tv_usec = (timeoutMs % 1000) * 1000;
+    if (select(static_cast<int>(highest + 1), &readable, nullptr, nullptr, &timeout) <= 0) {
+        return;
+    }
+    
+    for (Follower& follower : followers) {
+        if (follower.socket == INVALID_SOCKET_HANDLE || !FD_ISSET(toNative(follower.socket), &readable)) {
+            continue;
+        }
+        
+        // Whatever is queued, a ready socket never blocks the first recv; acks are cut out of the bytes in order
+        uint8_t data[sizeof(LockstepAck) * 32];
+        const auto received = recv(toNative(follower.socket), reinterpret_cast<char*>(data), static_cast<int>(sizeof(data)), 0);
+        if (received <= 0) {
+            dropFollower(follower, "disconnected");
+            continue;
+        }
+        for (size_t offset = 0; offset < static_cast<size_t>(received);) {
+            const size_t take = std::min(sizeof(LockstepAck) - follower.pendingBytes, static_cast<size_t>(received) - offset);
+            std::memcpy(follower.pending.data() + follower.pendingBytes, data + offset, take);
+            follower.pendingBytes += static_cast<uint32_t>(take);
+            offset += take;
+            if (follower.pendingBytes == sizeof(LockstepAck)) {
+                LockstepAck ack;
+                std::memcpy(&ack, follower.pending.data(), sizeof(ack));
+                follower.pendingBytes = 0;
+                handleAck(follower, ack);
+            }
+        }
+    }
+}
+
+void LockstepSession::handleAck(Follower& follower, const LockstepAck& ack) {
+    follower.ackedFrame = std::max(follower.ackedFrame, ack.frame);
+    if (!ack.hashValid) {
+        return;
+    }
+    
+    // Only ticks the leader has reduced itself and not yet overwritten can be compared
+    const TickHash& own = history[ack.tick % LOCKSTEP_HASH_HISTORY];
+    if (!own.valid || own.tick != ack.tick) {
+        return;
+    }
+    if (own.positionHash == ack.positionHash) {
+        follower.hashesMatched++;
+        return;
+    }
+    follower.hashMismatches++;
+    if (!follower.diverged) {
+        follower.diverged = true;
+        std::cerr << "LockstepSession: Follower " << follower.index << " diverged at tick " << ack.tick
+                  << " (position hash " << std::hex << ack.positionHash << ", leader " << own.positionHash << std::dec
+                  << ")" << std::endl;
+    }
+}
+
+void LockstepSession::dropFollower(Follower& follower, const char* reason) {
+    std::cerr << "LockstepSession: Follower " << follower.index << " " << reason << " at frame " << framesSent
+              << ", continuing without it" << std::endl;
+    closeSocket(follower.socket);
+    follower.socket = INVALID_SOCKET_HANDLE;
+}
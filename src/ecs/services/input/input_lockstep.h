@@ -0,0 +1,101 @@
+#pragma once
+
+#include "input_recording.h"
+#include <array>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+/**
+ * Lockstep session for a display wall across machines (--lockstep-lead / --lockstep-follow). Every instance runs
+ * the same simulation from the same seed, so only input crosses the network: the leader streams each frame's
+ * input recording record (deltaTime and events, as input_recording writes them) to its followers over TCP, and
+ * the followers replay them as they arrive instead of their own input. A few hundred bytes a second while nobody
+ * touches the leader.
+ *
+ * The followers answer every frame with their latest position hash (EntityBounds::positionHash) and the tick it
+ * was taken at. The leader keeps its own hashes of the last LOCKSTEP_HASH_HISTORY ticks and reports a follower
+ * whose hash differs at the same tick: the runs are only identical on the same GPU model, driver and build. A
+ * follower more than LOCKSTEP_MAX_LEAD_FRAMES frames behind holds the leader until it catches up or is dropped.
+ */
+constexpr uint32_t LOCKSTEP_MAX_LEAD_FRAMES = 8;
+constexpr uint32_t LOCKSTEP_HASH_HISTORY = 256;
+
+// Follower to leader, once a frame
+struct LockstepAck {
+    uint32_t frame = 0;         // Frames received from the leader so far
+    uint32_t tick = 0;          // Simulation tick of positionHash
+    uint32_t positionHash = 0;
+    uint32_t hashValid = 0;     // 0 until the follower's first bounds reduction has been read back
+};
+static_assert(sizeof(LockstepAck) == 16, "LockstepAck is part of the lockstep protocol");
+
+class LockstepSession {
+public:
+    LockstepSession() = default;
+    ~LockstepSession() { close(); }
+    
+    LockstepSession(const LockstepSession&) = delete;
+    LockstepSession& operator=(const LockstepSession&) = delete;
+    
+    // Blocks until followerCount followers have connected to port, then sends each the header (seed and window size)
+    bool lead(uint16_t port, uint32_t followerCount, const InputRecordingHeader& header);
+    // Connects to the leader at host:port, retrying for a while so the instances can be started in any order,
+    // and receives its header
+    bool follow(const std::string& host, uint16_t port);
+    void close();
+    
+    bool isActive() const { return leading || followerSocket != INVALID_SOCKET_HANDLE; }
+    bool isLeader() const { return leading; }
+    const InputRecordingHeader& getHeader() const { return header; }
+    
+    // Leader, once a frame: sends the frame's input to every follower, first waiting for any that fell too far behind
+    void sendFrame(float deltaTime, const std::vector<RecordedInputEvent>& events);
+    // Follower, once a frame: blocks for the leader's next frame (events valid until the next call); false once the
+    // leader has gone, which ends the run like the end of a replay
+    bool receiveFrame(float& deltaTime, const RecordedInputEvent*& events, uint32_t& eventCount);
+    
+    // Once a frame with the latest bounds reduction: the leader keeps the hash, a follower sends it back
+    void reportState(uint32_t tick, uint32_t positionHash, bool valid);
+
+private:
+    using SocketHandle = intptr_t;
+    static constexpr SocketHandle INVALID_SOCKET_HANDLE = -1;
+    
+    struct Follower {
+        SocketHandle socket = INVALID_SOCKET_HANDLE;
+        uint32_t index = 0;
+        uint32_t ackedFrame = 0;
+        std::array<uint8_t, sizeof(LockstepAck)> pending{};  // An ack split across reads
+        uint32_t pendingBytes = 0;
+        bool diverged = false;  // Reported once
+        uint64_t hashesMatched = 0;
+        uint64_t hashMismatches = 0;
+    };
+    
+    struct TickHash {
+        uint32_t tick = 0;
+        uint32_t positionHash = 0;
+        bool valid = false;
+    };
+    
+    // Leader: reads whatever acks arrived, waiting up to timeoutMs for the first; drops followers that hung up
+    void pollAcks(long timeoutMs);
+    void handleAck(Follower& follower, const LockstepAck& ack);
+    void dropFollower(Follower& follower, const char* reason);
+    
+    InputRecordingHeader header{};
+    bool socketsInitialized = false;  // WSAStartup succeeded (Windows)
+    bool leading = false;
+    
+    // Leader
+    std::vector<Follower> followers;
+    std::array<TickHash, LOCKSTEP_HASH_HISTORY> history{};
+    uint32_t framesSent = 0;
+    std::vector<uint8_t> frameMessage;
+    
+    // Follower
+    SocketHandle followerSocket = INVALID_SOCKET_HANDLE;
+    uint32_t framesReceived = 0;
+    std::vector<RecordedInputEvent> receivedEvents;
+};
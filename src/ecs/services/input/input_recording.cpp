@@ -0,0 +1,98 @@
+#include "input_recording.h"
+#include <iostream>
+#include <cstring>
+
+bool InputRecorder::open(const std::string& path, const InputRecordingHeader& header) {
+    close();
+    file.open(path, std::ios::binary | std::ios::trunc);
+    if (!file.is_open()) {
+        std::cerr << "InputRecorder: Failed to open " << path << std::endl;
+        return false;
+    }
+    
+    InputRecordingHeader written = header;
+    written.magic = InputRecordingHeader::MAGIC;
+    written.version = InputRecordingHeader::VERSION;
+    file.write(reinterpret_cast<const char*>(&written), sizeof(written));
+    filePath = path;
+    frameCount = 0;
+    return true;
+}
+
+void InputRecorder::close() {
+    if (!file.is_open()) {
+        return;
+    }
+    file.close();
+    std::cout << "InputRecorder: " << frameCount << " frames written to " << filePath << std::endl;
+}
+
+void InputRecorder::writeFrame(float deltaTime, const std::vector<RecordedInputEvent>& events) {
+    if (!file.is_open()) {
+        return;
+    }
+    const RecordedInputFrame frame{deltaTime, static_cast<uint32_t>(events.size())};
+    file.write(reinterpret_cast<const char*>(&frame), sizeof(frame));
+    file.write(reinterpret_cast<const char*>(events.data()), static_cast<std::streamsize>(events.size() * sizeof(RecordedInputEvent)));
+    frameCount++;
+    if (!file) {
+        std::cerr << "InputRecorder: Write to " << filePath << " failed, recording stopped after " << frameCount << " frames" << std::endl;
+        file.close();
+    }
+}
+
+bool InputReplay::open(const std::string& path) {
+    std::ifstream file(path, std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        std::cerr << "InputReplay: Failed to open " << path << std::endl;
+        return false;
+    }
+    std::vector<char> data(static_cast<size_t>(file.tellg()));
+    file.seekg(0);
+    file.read(data.data(), static_cast<std::streamsize>(data.size()));
+    
+    if (data.size() < sizeof(InputRecordingHeader)) {
+        std::cerr << "InputReplay: " << path << " is truncated" << std::endl;
+        return false;
+    }
+    std::memcpy(&header, data.data(), sizeof(header));
+    if (header.magic != InputRecordingHeader::MAGIC || header.version != InputRecordingHeader::VERSION) {
+        std::cerr << "InputReplay: " << path << " is not a version " << InputRecordingHeader::VERSION << " input recording" << std::endl;
+        return false;
+    }
+    
+    frames.clear();
+    events.clear();
+    nextFrameIndex = 0;
+    size_t offset = sizeof(InputRecordingHeader);
+    while (offset + sizeof(RecordedInputFrame) <= data.size()) {
+        RecordedInputFrame frame;
+        std::memcpy(&frame, data.data() + offset, sizeof(frame));
+        offset += sizeof(frame);
+        const size_t eventBytes = size_t(frame.eventCount) * sizeof(RecordedInputEvent);
+        if (eventBytes > data.size() - offset) {
+            break;
+        }
+        frames.push_back({frame.deltaTime, static_cast<uint32_t>(events.size()), frame.eventCount});
+        events.resize(events.size() + frame.eventCount);
+        std::memcpy(events.data() + frames.back().firstEvent, data.data() + offset, eventBytes);
+        offset += eventBytes;
+    }
+    if (offset != data.size()) {
+        // A recording cut off by a crash still replays up to its last whole frame
+        std::cerr << "InputReplay: " << path << " ends inside a frame, replaying the first " << frames.size() << std::endl;
+    }
+    std::cout << "InputReplay: " << frames.size() << " frames, " << events.size() << " events from " << path << std::endl;
+    return true;
+}
+
+bool InputReplay::nextFrame(float& deltaTime, const RecordedInputEvent*& frameEvents, uint32_t& eventCount) {
+    if (isFinished()) {
+        return false;
+    }
+    const FrameEntry& frame = frames[nextFrameIndex++];
+    deltaTime = frame.deltaTime;
+    frameEvents = events.data() + frame.firstEvent;
+    eventCount = frame.eventCount;
+    return true;
+}
@@ -0,0 +1,93 @@
+#pragma once
+
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <vector>
+
+/**
+ * Binary input recording (--record-input / --replay-input). A fixed header is followed by one record per
+ * frame: the frame's deltaTime, its event count, then the events in arrival order. Only what reaches the
+ * input state is kept - keys with their modifiers, mouse buttons, motion, wheel and window resizes - so a
+ * replay drives the action system, the control service and the camera exactly as the recorded run did.
+ * Every field is little-endian, as written by the machines this runs on.
+ */
+struct InputRecordingHeader {
+    static constexpr uint32_t MAGIC = 0x52495246;  // "FRIR"
+    static constexpr uint32_t VERSION = 1;
+    
+    uint32_t magic = MAGIC;
+    uint32_t version = VERSION;
+    uint32_t seed = 0;           // EntityFactory seed of the recorded run
+    int32_t windowWidth = 0;     // Window size when the recording started
+    int32_t windowHeight = 0;
+    uint32_t reserved = 0;
+};
+static_assert(sizeof(InputRecordingHeader) == 24, "InputRecordingHeader is part of the file format");
+
+struct RecordedInputFrame {
+    float deltaTime = 0.0f;
+    uint32_t eventCount = 0;
+};
+static_assert(sizeof(RecordedInputFrame) == 8, "RecordedInputFrame is part of the file format");
+
+struct RecordedInputEvent {
+    uint32_t type = 0;        // SDL_EventType
+    uint16_t code = 0;        // Scancode or mouse button
+    uint16_t modifiers = 0;   // SDL_Keymod of a key event
+    float x = 0.0f;           // Mouse position, wheel amount, or resized window size
+    float y = 0.0f;
+    float dx = 0.0f;          // Relative motion
+    float dy = 0.0f;
+};
+static_assert(sizeof(RecordedInputEvent) == 24, "RecordedInputEvent is part of the file format");
+
+// Appends one frame per writeFrame() through a buffered stream; the file is complete up to the last frame
+// whenever the stream is flushed, which close() and the destructor do
+class InputRecorder {
+public:
+    InputRecorder() = default;
+    ~InputRecorder() { close(); }
+    
+    InputRecorder(const InputRecorder&) = delete;
+    InputRecorder& operator=(const InputRecorder&) = delete;
+    
+    bool open(const std::string& path, const InputRecordingHeader& header);
+    void close();
+    bool isOpen() const { return file.is_open(); }
+    
+    void writeFrame(float deltaTime, const std::vector<RecordedInputEvent>& events);
+    uint32_t getFrameCount() const { return frameCount; }
+
+private:
+    std::ofstream file;
+    std::string filePath;
+    uint32_t frameCount = 0;
+};
+
+// A whole recording read into memory on open, then handed out a frame at a time
+class InputReplay {
+public:
+    // False (logged) when the file is missing or another version; a file cut off inside a frame replays up to
+    // its last whole frame
+    bool open(const std::string& path);
+    
+    const InputRecordingHeader& getHeader() const { return header; }
+    uint32_t getFrameCount() const { return static_cast<uint32_t>(frames.size()); }
+    
+    // The next frame's deltaTime and events (valid until the next call); false once every frame was replayed
+    bool nextFrame(float& deltaTime, const RecordedInputEvent*& events, uint32_t& eventCount);
+    bool isFinished() const { return nextFrameIndex >= frames.size(); }
+
+private:
+    struct FrameEntry {
+        float deltaTime = 0.0f;
+        uint32_t firstEvent = 0;
+        uint32_t eventCount = 0;
+    };
+    
+    InputRecordingHeader header{};
+    std::vector<FrameEntry> frames;
+    std::vector<RecordedInputEvent> events;
+    size_t nextFrameIndex = 0;
+};
@@ -239,6 +239,16 @@ glm::vec2 InputService::getMouseWorldPosition() const {
     return ecsBridge->getMouseWorldPosition(eventProcessor->getMouseState(), cameraService, window);
 }
 
+glm::vec2 InputService::getMouseViewportPosition() const {
+    if (!eventProcessor || !window) {
+        return glm::vec2(0.0f);
+    }
+    
+    int windowWidth, windowHeight;
+    SDL_GetWindowSize(window, &windowWidth, &windowHeight);
+    return eventProcessor->getMousePosition() / glm::max(glm::vec2(windowWidth, windowHeight), glm::vec2(1.0f));
+}
+
 glm::vec2 InputService::getMouseDelta() const {
     return eventProcessor ? eventProcessor->getMouseDelta() : glm::vec2(0.0f);
 }
@@ -247,6 +257,21 @@ glm::vec2 InputService::getMouseWheelDelta() const {
     return eventProcessor ? eventProcessor->getMouseWheelDelta() : glm::vec2(0.0f);
 }
 
+void InputService::setRawMouseSamplesEnabled(bool enabled) {
+    if (eventProcessor) {
+        eventProcessor->setRawMouseSamplesEnabled(enabled);
+    }
+}
+
+const std::vector<MouseSample>& InputService::getRawMouseSamples() const {
+    static const std::vector<MouseSample> noSamples;
+    return eventProcessor ? eventProcessor->getRawMouseSamples() : noSamples;
+}
+
+bool InputService::getFrameInputEventTime(std::chrono::steady_clock::time_point& eventTime) const {
+    return eventProcessor ? eventProcessor->getFrameInputEventTime(eventTime) : false;
+}
+
 // Input callbacks - delegate to InputActionSystem
 void InputService::registerActionCallback(const std::string& actionName, InputCallback callback) {
     if (actionSystem) {
@@ -299,6 +324,47 @@ bool InputService::hasWindowResizeEvent(int& width, int& height) const {
     return eventProcessor ? eventProcessor->hasWindowResizeEvent(width, height) : false;
 }
 
+bool InputService::isWindowVisible() const {
+    return eventProcessor ? eventProcessor->isWindowVisible() : true;
+}
+
+bool InputService::waitForEvents(int32_t timeoutMs) const {
+    return eventProcessor ? eventProcessor->waitForEvents(timeoutMs) : false;
+}
+
+// Recording and replay - delegate to InputEventProcessor
+bool InputService::startRecording(const std::string& path, uint32_t seed) {
+    return eventProcessor ? eventProcessor->startRecording(path, seed) : false;
+}
+
+bool InputService::startReplay(const std::string& path) {
+    return eventProcessor ? eventProcessor->startReplay(path) : false;
+}
+
+bool InputService::isRecording() const {
+    return eventProcessor ? eventProcessor->isRecording() : false;
+}
+
+bool InputService::isReplaying() const {
+    return eventProcessor ? eventProcessor->isReplaying() : false;
+}
+
+bool InputService::isReplayFinished() const {
+    return eventProcessor ? eventProcessor->isReplayFinished() : false;
+}
+
+const InputRecordingHeader* InputService::getReplayHeader() const {
+    return eventProcessor ? eventProcessor->getReplayHeader() : nullptr;
+}
+
+bool InputService::startLockstep(LockstepSession* session) {
+    return eventProcessor ? eventProcessor->startLockstep(session) : false;
+}
+
+float InputService::resolveFrameDeltaTime(float measuredDeltaTime) {
+    return eventProcessor ? eventProcessor->resolveFrameDeltaTime(measuredDeltaTime) : measuredDeltaTime;
+}
+
 // Debug and introspection
 std::vector<std::string> InputService::getActiveContexts() const {
     return contextManager ? contextManager->getActiveContexts() : std::vector<std::string>();
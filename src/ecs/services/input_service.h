@@ -67,8 +67,12 @@ public:
     bool isMouseButtonReleased(int button) const;
     glm::vec2 getMousePosition() const;
     glm::vec2 getMouseWorldPosition() const;
+    glm::vec2 getMouseViewportPosition() const;  // Mouse position over the window size, 0..1 on both axes
     glm::vec2 getMouseDelta() const;
     glm::vec2 getMouseWheelDelta() const;
+    void setRawMouseSamplesEnabled(bool enabled);
+    const std::vector<MouseSample>& getRawMouseSamples() const;
+    bool getFrameInputEventTime(std::chrono::steady_clock::time_point& eventTime) const;
     
     // Input callbacks for custom handling (delegated to InputActionSystem)
     void registerActionCallback(const std::string& actionName, InputCallback callback);
@@ -86,6 +90,18 @@ public:
     
     // Window event handling (delegated to InputEventProcessor)
     bool hasWindowResizeEvent(int& width, int& height) const;
+    bool isWindowVisible() const;
+    bool waitForEvents(int32_t timeoutMs) const;
+    
+    // Input recording and replay (delegated to InputEventProcessor)
+    bool startRecording(const std::string& path, uint32_t seed);
+    bool startReplay(const std::string& path);
+    bool isRecording() const;
+    bool isReplaying() const;
+    bool isReplayFinished() const;
+    const InputRecordingHeader* getReplayHeader() const;
+    bool startLockstep(LockstepSession* session);
+    float resolveFrameDeltaTime(float measuredDeltaTime);
     
     // Debug and introspection
     std::vector<std::string> getActiveContexts() const;
@@ -3,11 +3,11 @@
 #include "../core/service_locator.h"
 #include "../gpu/gpu_entity_manager.h"
 #include "../../vulkan_renderer.h"
+#include "../utilities/job_system.h"
 #include <iostream>
 #include <algorithm>
 #include <chrono>
 #include <execution>
-#include <thread>
 #include <stdexcept>
 
 RenderingService::RenderingService() {
@@ -36,8 +36,7 @@ bool RenderingService::initialize(flecs::world& world, VulkanRenderer* renderer)
         return false;
     }
     
-    // Reserve space for render queue
-    renderQueue.reserve(maxRenderableEntities);
+    // Queue only holds CPU-drawn renderables, GPUDriven entities never enter it
     renderBatches.reserve(100); // Reasonable default for batches
     
     // Cache service dependencies
@@ -231,7 +230,7 @@ void RenderingService::buildRenderQueue() {
     clearRenderQueue();
     collectRenderableEntities();
     
-    cullingStats.totalEntities = renderQueue.size();
+    cullingStats.totalEntities = renderQueue.size() + gpuDrivenBatch.instanceCount;
 }
 
 void RenderingService::sortRenderQueue() {
@@ -286,19 +285,25 @@ void RenderingService::submitRenderQueue() {
 void RenderingService::clearRenderQueue() {
     renderQueue.clear();
     renderBatches.clear();
+    batchArena.release();
     entityToQueueIndex.clear();
+    gpuDrivenBatch.clear();
 }
 
 
 
 void RenderingService::createRenderBatches() {
-    if (!initialized || renderQueue.empty()) {
+    if (!initialized) {
         return;
     }
     
     renderBatches.clear();
+    batchArena.release();
+    if (gpuDrivenBatch.instanceCount > 0) {
+        renderBatches.push_back(gpuDrivenBatch);
+    }
     
-    RenderBatch currentBatch;
+    RenderBatch currentBatch(&batchArena);
     currentBatch.priority = RenderPriority::NORMAL;
     
     for (const auto& entry : renderQueue) {
@@ -314,7 +319,7 @@ void RenderingService::createRenderBatches() {
             // Finalize current batch
             currentBatch.instanceCount = currentBatch.entries.size();
             renderBatches.push_back(std::move(currentBatch));
-            currentBatch = RenderBatch();
+            currentBatch = RenderBatch(&batchArena);
             currentBatch.priority = entry.priority;
         }
         
@@ -331,7 +336,7 @@ void RenderingService::createRenderBatches() {
 }
 
 void RenderingService::submitBatch(const RenderBatch& batch) {
-    if (!initialized || batch.entries.empty()) {
+    if (!initialized || batch.instanceCount == 0) {
         return;
     }
     
@@ -370,16 +375,6 @@ void RenderingService::printStats() const {
     std::cout << "GPU Render Time: " << renderStats.gpuRenderTimeMs << "ms" << std::endl;
 }
 
-void RenderingService::drawDebugInfo() {
-    if (!debugVisualization || !initialized) {
-        return;
-    }
-    
-    // This would render debug visualization
-    // For now, just print debug info
-    printStats();
-}
-
 void RenderingService::syncWithGPUEntityManager() {
     if (!initialized || !gpuEntityManager) {
         return;
@@ -387,7 +382,7 @@ void RenderingService::syncWithGPUEntityManager() {
     
     // Sync any pending uploads
     if (gpuEntityManager->hasPendingUploads()) {
-        gpuEntityManager->uploadPendingEntities();
+        gpuEntityManager->uploadPendingEntitiesAsync();
     }
 }
 
@@ -396,35 +391,44 @@ void RenderingService::updateFromECS() {
         return;
     }
     
-    // Collect entities that need GPU upload using SoA approach
-    std::vector<flecs::entity> entitiesToUpload;
+    if (!uploadPendingQuery_) {
+        return;
+    }
     
-    // Query for entities that need GPU upload
-    world->query<Transform, Renderable>().each([&entitiesToUpload](flecs::entity entity, 
-                                                                   Transform& transform, 
-                                                                   Renderable& renderable) {
-        // Check if entity has GPU upload pending tag
-        if (!entity.has<GPUUploadPending>()) {
-            return;
-        }
-        
-        // Ensure entity has MovementPattern component (add default if missing)
-        if (!entity.has<MovementPattern>()) {
-            entity.add<MovementPattern>();
+    // Only entities tagged for upload - resident ones are kept in sync by GPUUpdateObserver. Whether a
+    // MovementPattern is missing is a property of the table, so it is checked once per table
+    entitiesToUpload_.clear();
+    entitiesWithoutMovement_.clear();
+    uploadPendingQuery_.run([this](flecs::iter& it) {
+        while (it.next()) {
+            const bool hasMovement = it.is_set(3);
+            for (auto i : it) {
+                entitiesToUpload_.push_back(it.entity(i));
+                if (!hasMovement) {
+                    entitiesWithoutMovement_.push_back(it.entity(i));
+                }
+            }
         }
-        
-        entitiesToUpload.push_back(entity);
     });
+    if (entitiesToUpload_.empty()) {
+        return;
+    }
+    
+    // Components change after the iteration, so no table the query is walking moves under it
+    for (flecs::entity entity : entitiesWithoutMovement_) {
+        entity.add<MovementPattern>();
+    }
+    for (flecs::entity entity : entitiesToUpload_) {
+        entity.add<GPUDriven>();
+    }
     
     // Batch upload using SoA approach for better performance
-    if (!entitiesToUpload.empty()) {
-        gpuEntityManager->addEntitiesFromECS(entitiesToUpload);
-        
-        // Mark all uploaded entities as complete
-        for (auto& entity : entitiesToUpload) {
-            entity.remove<GPUUploadPending>();
-            entity.add<GPUUploadComplete>();
-        }
+    gpuEntityManager->addEntitiesFromECS(entitiesToUpload_);
+    
+    // Mark all uploaded entities as complete
+    for (flecs::entity entity : entitiesToUpload_) {
+        entity.remove<GPUUploadPending>();
+        entity.add<GPUUploadComplete>();
     }
 }
 
@@ -438,7 +442,7 @@ void RenderingService::prepareGPUData() {
     
     // Upload any pending entity data to GPU
     if (gpuEntityManager->hasPendingUploads()) {
-        gpuEntityManager->uploadPendingEntities();
+        gpuEntityManager->uploadPendingEntitiesAsync();
     }
 }
 
@@ -448,25 +452,14 @@ void RenderingService::processRenderingMT() {
         return;
     }
     
-    // Multi-threaded processing
-    std::vector<std::thread> workers;
-    
-    // Thread 1: ECS updates
-    workers.emplace_back([this]() {
+    // ECS updates as a job, the render queue built here meanwhile
+    JobSystem& jobs = JobSystem::getInstance();
+    JobCounter ecsUpdated;
+    jobs.submit([this]() {
         updateFromECS();
-    });
-    
-    // Thread 2: Build render queue
-    workers.emplace_back([this]() {
-        buildRenderQueue();
-    });
-    
-    // Wait for completion
-    for (auto& worker : workers) {
-        if (worker.joinable()) {
-            worker.join();
-        }
-    }
+    }, JobPriority::High, &ecsUpdated);
+    buildRenderQueue();
+    jobs.wait(ecsUpdated);
     
     // Single-threaded operations that depend on the above
     
@@ -504,39 +497,69 @@ void RenderingService::collectRenderableEntities() {
     }
     
     // GPU-DRIVEN RENDERING OPTIMIZATION:
-    // Since movement is GPU-driven, ECS Transform components are stale (never updated).
-    // Skip expensive per-entity queries. Let GPU handle all positioning and culling.
-    
-    uint32_t entityCount = gpuEntityManager->getEntityCount();
-    if (entityCount > 0) {
-        // Create single batch render entry for all GPU entities
-        RenderQueueEntry batchEntry{};
-        batchEntry.entity = flecs::entity::null(); // Batch render, no specific entity
-        batchEntry.priority = RenderPriority::NORMAL;
-        batchEntry.distanceToCamera = 0.0f; // GPU calculates distances
-        batchEntry.visible = true;
-        
-        renderQueue.push_back(batchEntry);
-        
-        // Note: entityCount stored implicitly via GPU entity manager, not in queue entry
+    // GPUDriven entities are moved, culled and drawn on the GPU and their ECS Transforms are stale, so they
+    // cost one batch sized by the live count instead of a queue entry each
+    if (gpuDrivenRendering) {
+        gpuDrivenBatch.priority = RenderPriority::NORMAL;
+        gpuDrivenBatch.instanceCount = gpuEntityManager->getEntityCount();
+    }
+    
+    auto& query = gpuDrivenRendering ? cpuRenderableQuery_ : allRenderableQuery_;
+    if (!query) {
+        return;
     }
     
-    // NOTE: If you need per-entity ECS rendering for debugging, re-enable this:
-    /*
-    world->query<Transform, Renderable>().each([this, cameraPosition](flecs::entity entity, 
-                                                              const Transform& transform, 
-                                                              const Renderable& renderable) {
-        if (!renderable.visible) {
-            return; // Skip invisible entities
+    const Camera* camera = cameraService ? cameraService->getActiveCameraData() : nullptr;
+    const glm::vec3 cameraPosition = camera ? camera->position : glm::vec3(0.0f);
+    
+    cullPositions.clear();
+    cullExtents.clear();
+    query.run([this, cameraPosition](flecs::iter& it) {
+        while (it.next()) {
+            flecs::field<const Transform> transforms = it.field<const Transform>(0);
+            flecs::field<const Renderable> renderables = it.field<const Renderable>(1);
+            const TransformCold* colds = it.is_set(2) ? &it.field<const TransformCold>(2)[0] : nullptr;
+            for (auto i : it) {
+                const Transform& transform = transforms[i];
+                const Renderable& renderable = renderables[i];
+                if (!renderable.visible || renderQueue.size() >= maxRenderableEntities) {
+                    continue;
+                }
+                
+                const flecs::entity entity = it.entity(i);
+                RenderQueueEntry entry = createQueueEntry(entity, transform, renderable);
+                entry.distanceToCamera = glm::length(transform.position - cameraPosition);
+                entry.visible = isEntityVisible(entry);
+                
+                entityToQueueIndex[entity] = static_cast<uint32_t>(renderQueue.size());
+                renderQueue.push_back(entry);
+                cullPositions.push_back(transform.position);
+                cullExtents.push_back(defaultHalfExtents(colds ? &colds[i] : nullptr));
+            }
         }
-        
-        RenderQueueEntry entry = createQueueEntry(entity, transform, renderable);
-        entry.distanceToCamera = glm::length(transform.position - cameraPosition);
-        
-        renderQueue.push_back(entry);
-        entityToQueueIndex[entity] = renderQueue.size() - 1;
     });
-    */
+    
+    // One frustum pass over the queue against the camera's cached planes
+    if (!camera || renderQueue.empty()) {
+        cullingStats.visibleEntities = static_cast<uint32_t>(std::count_if(renderQueue.begin(), renderQueue.end(),
+            [](const RenderQueueEntry& entry) { return entry.visible; }));
+        return;
+    }
+    
+    auto cullStart = std::chrono::steady_clock::now();
+    cullVisible.clear();
+    cameraService->cullBatch(cullPositions, cullExtents, cullVisible);
+    
+    size_t nextVisible = 0;
+    uint32_t visibleCount = 0;
+    for (size_t i = 0; i < renderQueue.size(); ++i) {
+        const bool inView = nextVisible < cullVisible.size() && cullVisible[nextVisible] == i;
+        nextVisible += inView ? 1 : 0;
+        renderQueue[i].visible = renderQueue[i].visible && inView;
+        visibleCount += renderQueue[i].visible ? 1 : 0;
+    }
+    cullingStats.visibleEntities = visibleCount;
+    cullingStats.cullingTimeMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - cullStart).count();
 }
 
 bool RenderingService::isEntityVisible(const RenderQueueEntry& entry) const {
@@ -590,10 +613,75 @@ void RenderingService::registerRenderingSystems() {
     // GPU-DRIVEN PIPELINE: CPU-side ECS systems removed for performance
     // All entity processing handled by GPU compute shaders
     // This eliminates 320k function calls per frame
+    
+    // Removal is event driven - fires only when an entity is destroyed or its Renderable is cleared
+    despawnObserver_ = world->observer<Renderable>("GPUDespawnObserver")
+        .event(flecs::OnRemove)
+        .each([this](flecs::entity entity, Renderable&) {
+            if (gpuEntityManager) {
+                gpuEntityManager->removeEntity(entity);
+            }
+        });
+    
+    // GPU-resident entities keep GPUSlot through rehydration, so removing it is what despawns them. A rehydrated
+    // entity is removed through both observers; the second call finds no spawn ID and does nothing
+    residentDespawnObserver_ = world->observer<const GPUSlot>("GPUResidentDespawnObserver")
+        .event(flecs::OnRemove)
+        .each([this](flecs::entity entity, const GPUSlot&) {
+            if (gpuEntityManager) {
+                gpuEntityManager->removeEntity(entity);
+            }
+        });
+    
+    // Edits are event driven too - only entities whose MovementPattern was set are re-sent, as sparse records
+    updateObserver_ = world->observer<const MovementPattern>("GPUUpdateObserver")
+        .event(flecs::OnSet)
+        .each([this](flecs::entity entity, const MovementPattern&) {
+            if (gpuEntityManager) {
+                gpuEntityManager->updateEntity(entity);
+            }
+        });
+    
+    // Rotation and scale are an optional cold term, read only for the cull extents
+    cpuRenderableQuery_ = world->query_builder<const Transform, const Renderable>("CPURenderableQuery")
+        .term<const TransformCold>().optional()
+        .without<GPUDriven>()
+        .cached()
+        .build();
+    allRenderableQuery_ = world->query_builder<const Transform, const Renderable>("AllRenderableQuery")
+        .term<const TransformCold>().optional()
+        .cached()
+        .build();
+    uploadPendingQuery_ = world->query_builder<const Transform, const Renderable>("UploadPendingQuery")
+        .with<GPUUploadPending>()
+        .with<MovementPattern>().optional()
+        .cached()
+        .build();
 }
 
 void RenderingService::cleanupSystems() {
-    // GPU-DRIVEN PIPELINE: No CPU-side ECS systems to clean up
+    // Observer must go before the world tears entities down, the GPU manager may already be gone
+    if (despawnObserver_) {
+        despawnObserver_.destruct();
+        despawnObserver_ = flecs::observer{};
+    }
+    if (residentDespawnObserver_) {
+        residentDespawnObserver_.destruct();
+        residentDespawnObserver_ = flecs::observer{};
+    }
+    if (updateObserver_) {
+        updateObserver_.destruct();
+        updateObserver_ = flecs::observer{};
+    }
+    if (cpuRenderableQuery_) {
+        cpuRenderableQuery_.destruct();
+    }
+    if (allRenderableQuery_) {
+        allRenderableQuery_.destruct();
+    }
+    if (uploadPendingQuery_) {
+        uploadPendingQuery_.destruct();
+    }
 }
 
 // beginFrame() and endFrame() already implemented above
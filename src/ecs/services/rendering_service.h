@@ -2,11 +2,13 @@
 
 #include "../core/service_locator.h"
 #include "../components/component.h"
+#include "../utilities/memory_tags.h"
 #include <flecs.h>
 #include <glm/glm.hpp>
 #include <vulkan/vulkan.h>
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <functional>
 #include <unordered_map>
 #include <queue>
@@ -75,9 +77,11 @@ struct CullingStats {
     }
 };
 
-// Render batch for efficient GPU submission
+// Render batch for efficient GPU submission; RenderingService's batches draw their entries from its frame arena
 struct RenderBatch {
-    std::vector<RenderQueueEntry> entries;
+    explicit RenderBatch(std::pmr::memory_resource* resource = std::pmr::get_default_resource()) : entries(resource) {}
+    
+    std::pmr::vector<RenderQueueEntry> entries;
     RenderPriority priority;
     VkPipeline pipeline = VK_NULL_HANDLE;
     VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
@@ -149,6 +153,12 @@ public:
     void setBatchingEnabled(bool enabled) { batchingEnabled = enabled; }
     bool isBatchingEnabled() const { return batchingEnabled; }
     
+    // GPU-driven mode (default): GPUDriven entities are one coarse batch sized by the GPU live count, and only
+    // the remaining renderables get queue entries. Turned off, every renderable is queued per entity (debugging)
+    void setGPUDrivenRendering(bool enabled) { gpuDrivenRendering = enabled; }
+    bool isGPUDrivenRendering() const { return gpuDrivenRendering; }
+    const RenderBatch& getGPUDrivenBatch() const { return gpuDrivenBatch; }
+    
     // Statistics and monitoring
     const CullingStats& getCullingStats() const { return cullingStats; }
     const RenderStats& getRenderStats() const { return renderStats; }
@@ -162,9 +172,6 @@ public:
     float getRenderDistance() const { return maxRenderDistance; }
     
     // Debug and profiling
-    void setDebugVisualization(bool enabled) { debugVisualization = enabled; }
-    bool isDebugVisualizationEnabled() const { return debugVisualization; }
-    void drawDebugInfo();
     void setWireframeMode(bool enabled) { wireframeMode = enabled; }
     bool isWireframeModeEnabled() const { return wireframeMode; }
     
@@ -223,17 +230,50 @@ private:
     std::vector<RenderBatch> renderBatches;
     std::unordered_map<flecs::entity, uint32_t> entityToQueueIndex;
     
+    // Frame arena for the batch entries, released whenever renderBatches is cleared. The initial block covers a
+    // typical CPU-drawn frame; larger frames spill into MemoryTag::RenderQueue until the next release
+    static constexpr size_t BATCH_ARENA_BYTES = 64 * 1024;
+    std::unique_ptr<std::byte[]> batchArenaBlock = std::make_unique<std::byte[]>(BATCH_ARENA_BYTES);
+    std::pmr::monotonic_buffer_resource batchArena{batchArenaBlock.get(), BATCH_ARENA_BYTES,
+                                                   &MemoryTags::getResource(MemoryTag::RenderQueue)};
+    
+    // Per-entry frustum inputs and CameraCulling::cullBatch output, reused across frames
+    std::vector<glm::vec3> cullPositions;
+    std::vector<glm::vec3> cullExtents;
+    std::vector<uint32_t> cullVisible;
+    
     bool batchingEnabled = true;
+    bool gpuDrivenRendering = true;
     float maxRenderDistance = 1000.0f;
     
+    // Metadata of the single instanced draw EntityGraphicsNode records; no per-entity entries
+    RenderBatch gpuDrivenBatch;
+    
+    // Cached, so frames only visit the tables that match: CPU-drawn renderables, and all of them for debugging
+    flecs::query<const Transform, const Renderable> cpuRenderableQuery_;
+    flecs::query<const Transform, const Renderable> allRenderableQuery_;  // Both with TransformCold optional
+    flecs::query<const Transform, const Renderable> uploadPendingQuery_;  // GPUUploadPending, MovementPattern optional
+    
+    // updateFromECS scratch, reused so a spawn burst does not allocate every frame
+    std::vector<flecs::entity> entitiesToUpload_;
+    std::vector<flecs::entity> entitiesWithoutMovement_;
+    
     // Configuration
     uint32_t maxRenderableEntities = 100000;
-    bool debugVisualization = false;
     bool wireframeMode = false;
     bool multithreadingEnabled = false;
     
     // GPU-DRIVEN PIPELINE: ECS system entities removed for performance
     
+    // Forwards destroyed or recycled renderables to the GPU despawn queue
+    flecs::observer despawnObserver_;
+    
+    // Same for GPU-resident entities, which have no Renderable until rehydrated
+    flecs::observer residentDespawnObserver_;
+    
+    // Forwards MovementPattern edits of resident entities to the GPU update queue
+    flecs::observer updateObserver_;
+    
     // Render state
     RenderState renderState_;
     flecs::entity cameraEntity_;
@@ -278,9 +318,6 @@ private:
     void waitForGPUIdle();
     void flushPendingOperations();
     
-    // Debug helpers
-    void renderDebugBounds();
-    
     // GPU-DRIVEN PIPELINE: ECS system callbacks removed for performance
     
 };
@@ -0,0 +1,92 @@
+#include "spatial_query_service.h"
+#include "../../vulkan_renderer.h"
+#include "../gpu/gpu_entity_manager.h"
+#include <iostream>
+
+SpatialQueryService::~SpatialQueryService() {
+    cleanup();
+}
+
+bool SpatialQueryService::initialize(VulkanRenderer* renderer) {
+    this->renderer = renderer;
+    if (!renderer) {
+        std::cerr << "SpatialQueryService: renderer cannot be null" << std::endl;
+        return false;
+    }
+    return true;
+}
+
+void SpatialQueryService::cleanup() {
+    // Queries never handed over are answered here; ones already on the GPU side land in the inbox, which nobody reads
+    SpatialQueryResult unavailable;
+    statistics.submitted += queued.size();
+    statistics.unavailable += queued.size();
+    for (const auto& query : queued) {
+        query.callback(unavailable);
+    }
+    queued.clear();
+    renderer = nullptr;
+}
+
+void SpatialQueryService::queryRadius(glm::vec2 center, float radius, Callback callback, uint32_t maxResults) {
+    if (!callback) return;
+    SpatialQuery query;
+    query.center = center;
+    query.radius = radius;
+    query.maxResults = maxResults;
+    query.kind = SpatialQuery::Kind::Radius;
+    queued.push_back({query, std::move(callback)});
+}
+
+void SpatialQueryService::queryNearest(glm::vec2 center, uint32_t count, Callback callback, float maxRadius) {
+    if (!callback) return;
+    SpatialQuery query;
+    query.center = center;
+    query.radius = maxRadius;
+    query.maxResults = count;
+    query.kind = SpatialQuery::Kind::Nearest;
+    queued.push_back({query, std::move(callback)});
+}
+
+void SpatialQueryService::processFrame() {
+    if (!queued.empty()) {
+        statistics.submitted += queued.size();
+        auto* gpuEntityManager = renderer ? renderer->getGPUEntityManager() : nullptr;
+        if (!gpuEntityManager) {
+            SpatialQueryResult unavailable;
+            statistics.unavailable += queued.size();
+            for (const auto& query : queued) {
+                query.callback(unavailable);
+            }
+        } else {
+            // One handoff per frame, however many queries were made
+            auto batch = std::make_shared<std::vector<QueuedQuery>>(std::move(queued));
+            gpuEntityManager->frontendCall([gpuEntityManager, batch, inbox = inbox]() {
+                for (auto& query : *batch) {
+                    gpuEntityManager->getBufferManager().submitSpatialQuery(query.query,
+                        [inbox, callback = std::move(query.callback)](const SpatialQueryResult& result) {
+                            std::lock_guard<std::mutex> lock(inbox->mutex);
+                            inbox->results.emplace_back(callback, result);
+                        });
+                }
+            });
+        }
+        queued.clear();
+    }
+    
+    {
+        std::lock_guard<std::mutex> lock(inbox->mutex);
+        delivering.swap(inbox->results);
+    }
+    for (auto& [callback, result] : delivering) {
+        ++(result.available ? statistics.answered : statistics.unavailable);
+        callback(result);
+    }
+    delivering.clear();
+}
+
+SpatialQueryService::Statistics SpatialQueryService::getStatistics() const {
+    Statistics current = statistics;
+    current.inFlight = static_cast<size_t>(statistics.submitted - statistics.answered - statistics.unavailable) + queued.size();
+    return current;
+}
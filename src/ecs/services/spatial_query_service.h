@@ -0,0 +1,68 @@
+#pragma once
+
+#include "../gpu/entity_buffer_manager.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+// Forward declarations
+class VulkanRenderer;
+
+/**
+ * Frontend entry point for GPU spatial queries ("entities within R of P", "nearest N to the cursor"). Queries made
+ * during a frame are handed to GPUEntityManager in one frontendCall from processFrame(), SpatialQueryNode answers
+ * them against the spatial grid of the next simulated frame, and the results come back through the async readback
+ * path. Callbacks run on the frontend thread in a later processFrame(), a few frames after the query; entities
+ * are reported by spawn ID (GPUEntityManager::getECSEntityFromSpawnId / resolveShadowEntity)
+ */
+class SpatialQueryService {
+public:
+    using Callback = std::function<void(const SpatialQueryResult& result)>;
+    
+    SpatialQueryService() = default;
+    ~SpatialQueryService();
+    
+    // Initialization and cleanup
+    bool initialize(VulkanRenderer* renderer);
+    void cleanup();
+    
+    // Frontend thread. Radius counts every entity within radius and reports the nearest maxResults; nearest
+    // reports the count nearest entities within maxRadius. Both are capped at SPATIAL_QUERY_MAX_RESULTS hits
+    // and SPATIAL_QUERY_MAX_CELL_RADIUS grid cells of reach
+    void queryRadius(glm::vec2 center, float radius, Callback callback, uint32_t maxResults = SPATIAL_QUERY_MAX_RESULTS);
+    void queryNearest(glm::vec2 center, uint32_t count, Callback callback,
+                      float maxRadius = std::numeric_limits<float>::infinity());
+    
+    // Once per frame on the frontend thread: submits the frame's queries and runs the callbacks of arrived results
+    void processFrame();
+    
+    struct Statistics {
+        uint64_t submitted = 0;
+        uint64_t answered = 0;
+        uint64_t unavailable = 0;  // Answered without running (see SpatialQueryResult::available)
+        size_t inFlight = 0;
+    };
+    Statistics getStatistics() const;
+
+private:
+    struct QueuedQuery {
+        SpatialQuery query;
+        Callback callback;
+    };
+    
+    // Filled by readback callbacks on the render thread; shared with them so late results outlive the service
+    struct Inbox {
+        std::mutex mutex;
+        std::vector<std::pair<Callback, SpatialQueryResult>> results;
+    };
+    
+    VulkanRenderer* renderer = nullptr;
+    std::vector<QueuedQuery> queued;
+    std::shared_ptr<Inbox> inbox = std::make_shared<Inbox>();
+    std::vector<std::pair<Callback, SpatialQueryResult>> delivering;
+    Statistics statistics;
+};
@@ -1,14 +1,63 @@
-#include "../components/component.h"
-#include <flecs.h>
+#include "lifetime_system.h"
+#include "../gpu/gpu_entity_manager.h"
+#include <vector>
 
-void lifetime_system(flecs::entity e, Lifetime& lifetime) {
-    const float deltaTime = e.world().delta_time();
+namespace LifetimeSystem {
+    static LifetimeStats stats_;
+    static GPUEntityManager* gpuManager_ = nullptr;
     
-    if (lifetime.maxAge > 0.0f) {
-        lifetime.currentAge += deltaTime;
+    // Reused every frame so an expiry burst does not allocate
+    static std::vector<flecs::entity> expired_;
+    
+    void update(flecs::iter& it) {
+        expired_.clear();
+        
+        while (it.next()) {
+            const float deltaTime = it.delta_time();
+            flecs::field<Lifetime> lifetimes = it.field<Lifetime>(0);
+            const size_t count = it.count();
+            
+            // Branch-free over the column so the compiler can vectorize it; infinite lifetimes do not age
+            for (size_t i = 0; i < count; ++i) {
+                Lifetime& lifetime = lifetimes[i];
+                lifetime.currentAge += lifetime.maxAge > 0.0f ? deltaTime : 0.0f;
+            }
+            
+            for (size_t i = 0; i < count; ++i) {
+                const Lifetime& lifetime = lifetimes[i];
+                if (lifetime.autoDestroy && lifetime.maxAge > 0.0f && lifetime.currentAge >= lifetime.maxAge) {
+                    expired_.push_back(it.entity(i));
+                }
+            }
+        }
+        
+        stats_.expiredLastFrame = expired_.size();
+        if (expired_.empty()) {
+            return;
+        }
+        stats_.totalExpired += expired_.size();
+        
+        // Queued for the despawn node first, so the Renderable OnRemove observer finds nothing left to do
+        if (gpuManager_) {
+            gpuManager_->removeEntities(expired_);
+        }
         
-        if (lifetime.autoDestroy && lifetime.currentAge >= lifetime.maxAge) {
-            e.destruct();
+        // The system runs deferred: the destructs are applied together when the frame's commands merge
+        for (flecs::entity entity : expired_) {
+            entity.destruct();
         }
     }
+    
+    void registerSystems(flecs::world& world, GPUEntityManager* gpuManager) {
+        gpuManager_ = gpuManager;
+        stats_ = LifetimeStats{};
+        
+        // Single-threaded: one expiry list per frame, and the aging loop is cheaper than a worker handoff
+        world.system<Lifetime>("LifetimeSystem")
+            .run(update);
+    }
+    
+    const LifetimeStats& getStats() {
+        return stats_;
+    }
 }
\ No newline at end of file
@@ -3,4 +3,33 @@
 #include "../components/component.h"
 #include <flecs.h>
 
-void lifetime_system(flecs::entity e, Lifetime& lifetime);
\ No newline at end of file
+class GPUEntityManager;
+
+/**
+ * @brief Lifetime expiry as one batched pass over the Lifetime columns
+ * 
+ * Each table's ages are advanced in a single loop, expired entities are gathered into a per-frame list, and the
+ * list is handed to the GPU despawn queue in one call before the entities are destructed through the system's
+ * deferred command queue. A burst of expiries costs one batch rather than one archetype move per iteration step.
+ */
+namespace LifetimeSystem {
+    /**
+     * @brief Register the LifetimeSystem with the Flecs world
+     * @param world The Flecs world instance
+     * @param gpuManager Receives each frame's expired entities as one despawn batch (nullptr = ECS only)
+     */
+    void registerSystems(flecs::world& world, GPUEntityManager* gpuManager = nullptr);
+    
+    /**
+     * @brief Age every Lifetime in the query and retire the expired entities in bulk
+     * @param it Iterator over the Lifetime tables
+     */
+    void update(flecs::iter& it);
+    
+    struct LifetimeStats {
+        size_t expiredLastFrame = 0;
+        size_t totalExpired = 0;
+    };
+    
+    const LifetimeStats& getStats();
+}
\ No newline at end of file
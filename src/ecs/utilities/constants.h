@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cstddef>
+#include <cstdint>
 
 // System-wide constants for the ECS framework
 namespace SystemConstants {
@@ -10,4 +11,14 @@ namespace SystemConstants {
     
     // Movement type constants - simplified to only random walk
     constexpr int MOVEMENT_TYPE_RANDOM_WALK = 0;
+    
+    // Flecs threads for multi_threaded systems, 0 for the JobSystem's concurrency (--ecs-threads overrides)
+    constexpr uint32_t ECS_WORKER_THREADS = 0;
+    
+    // JobSystem workers, 0 for one per hardware thread less the main thread (--job-workers overrides)
+    constexpr uint32_t JOB_WORKER_THREADS = 0;
+    
+    // Swarms spawn as [GPUSlot, GPUResident] entities whose components only the GPU holds, instead of the full
+    // [Transform, Renderable, MovementPattern, ...] archetype (EntityFactory::createResidentBulk)
+    constexpr bool GPU_RESIDENT_SWARMS = true;
 }
\ No newline at end of file
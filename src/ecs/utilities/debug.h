@@ -1,10 +1,6 @@
 #pragma once
 
-#include <iostream>
+#include "logger.h"
 
-// Unified debug output control for the entire project
-#ifdef NDEBUG
-#define DEBUG_LOG(x) do {} while(0)
-#else
-#define DEBUG_LOG(x) std::cout << x << std::endl
-#endif
\ No newline at end of file
+// Unified debug output control for the entire project; compiled out with LOG_MIN_LEVEL above Debug (NDEBUG)
+#define DEBUG_LOG(x) LOG_DEBUG(x)
\ No newline at end of file
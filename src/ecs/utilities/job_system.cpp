@@ -0,0 +1,158 @@
+#include "job_system.h"
+#include <algorithm>
+#include <iostream>
+
+namespace {
+    thread_local int32_t currentWorker = -1;
+}
+
+void JobSystem::initialize(uint32_t workerCount) {
+    if (!workers.empty()) {
+        return;
+    }
+
+    const uint32_t hardwareThreads = std::max(1u, std::thread::hardware_concurrency());
+    const uint32_t count = workerCount > 0 ? workerCount : std::max(1u, hardwareThreads - 1);
+
+    stopping = false;
+    queues.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        queues.push_back(std::make_unique<WorkerQueue>());
+    }
+
+    // Every queue exists before a worker can steal from it
+    workers.reserve(count);
+    for (uint32_t i = 0; i < count; ++i) {
+        workers.emplace_back([this, i]() { runWorker(i); });
+    }
+    std::cout << "JobSystem: " << count << " workers" << std::endl;
+}
+
+void JobSystem::shutdown() {
+    if (workers.empty()) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    workAvailable.notify_all();
+    for (auto& worker : workers) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers.clear();
+    queues.clear();
+    stopping = false;
+}
+
+bool JobSystem::isWorkerThread() const {
+    return currentWorker >= 0;
+}
+
+void JobSystem::submit(Job job, JobPriority priority, JobCounter* counter) {
+    Task task{std::move(job), counter};
+    if (counter) {
+        counter->pending.fetch_add(1);
+    }
+    if (workers.empty()) {
+        finish(task);
+        return;
+    }
+
+    const size_t queue = currentWorker >= 0 ? static_cast<size_t>(currentWorker)
+                                            : nextQueue.fetch_add(1, std::memory_order_relaxed) % queues.size();
+    {
+        std::lock_guard<std::mutex> lock(queues[queue]->mutex);
+        queues[queue]->tasks[static_cast<size_t>(priority)].push_back(std::move(task));
+    }
+    queuedJobs.fetch_add(1);
+
+    // Taken so a worker between its last look and its wait cannot miss the notify
+    { std::lock_guard<std::mutex> lock(wakeMutex); }
+    workAvailable.notify_one();
+}
+
+void JobSystem::wait(const JobCounter& counter, JobPriority helpUpTo) {
+    waitUntil([&counter]() { return counter.isDone(); }, helpUpTo);
+}
+
+void JobSystem::waitUntil(const std::function<bool()>& done, JobPriority helpUpTo) {
+    while (!done()) {
+        if (runQueuedJob(helpUpTo)) {
+            continue;
+        }
+
+        // Nothing this thread may run; whatever it waits for is running elsewhere
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        sleepingWaiters.fetch_add(1);
+        jobFinished.wait_for(lock, WAIT_POLL_INTERVAL, done);
+        sleepingWaiters.fetch_sub(1);
+    }
+}
+
+void JobSystem::runWorker(uint32_t index) {
+    currentWorker = static_cast<int32_t>(index);
+    for (;;) {
+        if (runQueuedJob(JobPriority::Low)) {
+            continue;
+        }
+
+        std::unique_lock<std::mutex> lock(wakeMutex);
+        workAvailable.wait(lock, [this]() { return stopping || queuedJobs.load() > 0; });
+        if (stopping && queuedJobs.load() == 0) {
+            return;
+        }
+    }
+}
+
+bool JobSystem::runQueuedJob(JobPriority lowest) {
+    const size_t queueCount = queues.size();
+    if (queueCount == 0 || queuedJobs.load() == 0) {
+        return false;
+    }
+
+    const bool worker = currentWorker >= 0;
+    const size_t home = worker ? static_cast<size_t>(currentWorker) : nextQueue.load(std::memory_order_relaxed) % queueCount;
+    for (size_t priority = 0; priority <= static_cast<size_t>(lowest); ++priority) {
+        for (size_t offset = 0; offset < queueCount; ++offset) {
+            Task task;
+            {
+                WorkerQueue& queue = *queues[(home + offset) % queueCount];
+                std::lock_guard<std::mutex> lock(queue.mutex);
+                auto& tasks = queue.tasks[priority];
+                if (tasks.empty()) {
+                    continue;
+                }
+
+                // A worker's own jobs newest first, while their data is still in its cache; stolen ones oldest first
+                if (worker && offset == 0) {
+                    task = std::move(tasks.back());
+                    tasks.pop_back();
+                } else {
+                    task = std::move(tasks.front());
+                    tasks.pop_front();
+                }
+                queuedJobs.fetch_sub(1);
+            }
+            finish(task);
+            return true;
+        }
+    }
+    return false;
+}
+
+void JobSystem::finish(Task& task) {
+    task.job();
+
+    // The counter may belong to a waiter that returns as soon as it reads zero, so it is not touched after
+    if (task.counter) {
+        task.counter->pending.fetch_sub(1);
+    }
+    if (sleepingWaiters.load() > 0) {
+        { std::lock_guard<std::mutex> lock(wakeMutex); }
+        jobFinished.notify_all();
+    }
+}
@@ -0,0 +1,119 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <future>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+// Order queued jobs are taken in. Waiting threads only help with jobs up to the priority they pass
+enum class JobPriority : uint32_t {
+    High = 0,    // On the frame's critical path: Flecs tasks, staging fills, render queue builds
+    Normal = 1,  // Something may block on it soon: shader and pipeline compiles
+    Low = 2,     // Nobody waits on it: telemetry encoding
+};
+
+// Jobs of a batch that have not finished; submit() counts up, finishing counts down
+class JobCounter {
+public:
+    JobCounter() = default;
+    JobCounter(const JobCounter&) = delete;
+    JobCounter& operator=(const JobCounter&) = delete;
+
+    bool isDone() const { return pending.load() == 0; }
+
+private:
+    friend class JobSystem;
+    std::atomic<uint32_t> pending{0};
+};
+
+/**
+ * The process-wide pool for short CPU work. Each worker owns a deque per priority: jobs a worker submits go on the
+ * back of its own and it takes them back newest first, while jobs from other threads are dealt round robin and an
+ * idle worker steals from the front of the others' deques, highest priority first. A wait never just blocks - the
+ * waiting thread runs queued jobs up to the priority it allows until what it waits for is done, so jobs waiting on
+ * jobs cannot starve the pool and the frame thread helps with its own batch. Loops that block on I/O or timers
+ * (render thread, recorder lanes, metrics exporter, profiler aggregator) keep their own threads.
+ * Until initialize() every job runs inline on the submitting thread.
+ */
+class JobSystem {
+public:
+    using Job = std::function<void()>;
+
+    static JobSystem& getInstance() {
+        static JobSystem instance;
+        return instance;
+    }
+
+    // workerCount 0: one per hardware thread, less the calling one
+    void initialize(uint32_t workerCount = 0);
+
+    // Runs what is still queued, then joins the workers; later jobs run inline
+    void shutdown();
+
+    uint32_t getWorkerCount() const { return static_cast<uint32_t>(workers.size()); }
+    // Workers plus the calling thread, which helps while it waits
+    uint32_t getConcurrency() const { return getWorkerCount() + 1; }
+    bool isWorkerThread() const;
+
+    void submit(Job job, JobPriority priority = JobPriority::Normal, JobCounter* counter = nullptr);
+
+    template<typename Function>
+    auto async(JobPriority priority, Function&& function) -> std::future<std::invoke_result_t<std::decay_t<Function>>> {
+        using Result = std::invoke_result_t<std::decay_t<Function>>;
+        auto task = std::make_shared<std::packaged_task<Result()>>(std::forward<Function>(function));
+        std::future<Result> future = task->get_future();
+        submit([task]() { (*task)(); }, priority);
+        return future;
+    }
+
+    void wait(const JobCounter& counter, JobPriority helpUpTo = JobPriority::High);
+
+    // For futures from async() and promises set by jobs; get() straight after does not block
+    template<typename Future>
+    void waitFor(const Future& future, JobPriority helpUpTo = JobPriority::Normal) {
+        waitUntil([&future]() { return future.wait_for(std::chrono::seconds(0)) == std::future_status::ready; }, helpUpTo);
+    }
+
+    void waitUntil(const std::function<bool()>& done, JobPriority helpUpTo);
+
+private:
+    static constexpr size_t PRIORITY_COUNT = 3;
+    static constexpr auto WAIT_POLL_INTERVAL = std::chrono::milliseconds(1);  // Waiters also look for new jobs this often
+
+    struct Task {
+        Job job;
+        JobCounter* counter = nullptr;
+    };
+
+    struct WorkerQueue {
+        std::mutex mutex;
+        std::array<std::deque<Task>, PRIORITY_COUNT> tasks;  // By priority
+    };
+
+    std::vector<std::unique_ptr<WorkerQueue>> queues;  // One per worker
+    std::vector<std::thread> workers;
+    std::atomic<uint32_t> queuedJobs{0};
+    std::atomic<uint32_t> nextQueue{0};                // Round robin for threads outside the pool
+
+    std::mutex wakeMutex;
+    std::condition_variable workAvailable;               // Idle workers
+    std::condition_variable jobFinished;                 // Waiters with nothing they may run
+    std::atomic<uint32_t> sleepingWaiters{0};
+    bool stopping = false;
+
+    JobSystem() = default;
+    ~JobSystem() { shutdown(); }
+
+    void runWorker(uint32_t index);
+    bool runQueuedJob(JobPriority lowest);
+    void finish(Task& task);
+};
@@ -0,0 +1,91 @@
+#include "logger.h"
+#include <algorithm>
+#include <iostream>
+#include <string>
+
+Logger::Logger() {
+    pending.reserve(LogThreadBuffer::CAPACITY);
+    flusher = std::thread([this] { runFlusher(); });
+}
+
+Logger::~Logger() {
+    {
+        std::lock_guard<std::mutex> lock(flusherMutex);
+        stopping = true;
+    }
+    flusherWake.notify_one();
+    if (flusher.joinable()) {
+        flusher.join();
+    }
+    flush();
+}
+
+LogThreadBuffer& Logger::threadBuffer() {
+    thread_local std::shared_ptr<LogThreadBuffer> buffer;
+    if (!buffer) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffer = std::make_shared<LogThreadBuffer>();
+        threadBuffers.push_back(buffer);
+    }
+    return *buffer;
+}
+
+void Logger::flush() {
+    std::lock_guard<std::mutex> lock(writeMutex);
+    writeQueued();
+}
+
+void Logger::runFlusher() {
+    std::unique_lock<std::mutex> lock(flusherMutex);
+    while (!stopping) {
+        flusherWake.wait_for(lock, FLUSH_INTERVAL);
+        lock.unlock();
+        flush();
+        lock.lock();
+    }
+}
+
+void Logger::writeQueued() {
+    std::vector<std::shared_ptr<LogThreadBuffer>> buffers;
+    {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffers = threadBuffers;
+    }
+    
+    uint64_t dropped = 0;
+    pending.clear();
+    for (const auto& buffer : buffers) {
+        buffer->drain([this](const LogRecord& record) { pending.push_back(record); });
+        dropped += buffer->dropped.exchange(0, std::memory_order_relaxed);
+    }
+    if (pending.empty() && dropped == 0) {
+        return;
+    }
+    std::sort(pending.begin(), pending.end(),
+              [](const LogRecord& a, const LogRecord& b) { return a.sequence < b.sequence; });
+    
+    std::string out;
+    std::string err;
+    for (const LogRecord& record : pending) {
+        std::string& text = record.level >= LogLevel::Warning ? err : out;
+        text.append(record.text.data(), record.length);
+        if (record.truncated) {
+            text += "...";
+        }
+        if (record.suppressed > 0) {
+            text += " (" + std::to_string(record.suppressed) + " similar skipped)";
+        }
+        text += '\n';
+    }
+    if (dropped > 0) {
+        err += "Logger: " + std::to_string(dropped) + " messages dropped, a thread's ring was full\n";
+    }
+    
+    if (!out.empty()) {
+        std::cout.write(out.data(), static_cast<std::streamsize>(out.size()));
+        std::cout.flush();
+    }
+    if (!err.empty()) {
+        std::cerr.write(err.data(), static_cast<std::streamsize>(err.size()));
+    }
+}
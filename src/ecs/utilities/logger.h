@@ -0,0 +1,227 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <ostream>
+#include <streambuf>
+#include <thread>
+#include <vector>
+
+enum class LogLevel : uint8_t {
+    Debug = 0,
+    Info = 1,
+    Warning = 2,  // Written to stderr from here up
+    Error = 3,
+};
+
+// Lowest level compiled in; calls below it compile out together with the evaluation of their message
+#ifndef LOG_MIN_LEVEL
+#ifdef NDEBUG
+#define LOG_MIN_LEVEL 1
+#else
+#define LOG_MIN_LEVEL 0
+#endif
+#endif
+
+// One formatted message as the logging thread left it
+struct LogRecord {
+    static constexpr uint32_t TEXT_CAPACITY = 240;
+    
+    uint64_t sequence = 0;      // Process-wide order, so the flusher can merge the thread rings
+    uint32_t suppressed = 0;    // Messages the call site's rate limit swallowed since its previous one
+    uint16_t length = 0;
+    LogLevel level = LogLevel::Info;
+    bool truncated = false;
+    std::array<char, TEXT_CAPACITY> text;
+};
+static_assert(sizeof(LogRecord) == 256, "LogRecord should stay four cache lines");
+
+// Stream buffer over a record's fixed text; writes past the end are cut rather than allocated
+class LogTextBuffer : public std::streambuf {
+public:
+    void reset(char* begin, size_t capacity) {
+        setp(begin, begin + capacity);
+        overflowed = false;
+    }
+    size_t length() const { return static_cast<size_t>(pptr() - pbase()); }
+    bool hasOverflowed() const { return overflowed; }
+
+protected:
+    int_type overflow(int_type) override {
+        overflowed = true;
+        return traits_type::eof();
+    }
+
+private:
+    bool overflowed = false;
+};
+
+// Single-producer ring owned by one thread, drained by the flusher. A full ring drops the message before it
+// is formatted instead of blocking the thread that logs
+class LogThreadBuffer {
+public:
+    static constexpr uint32_t CAPACITY = 512;
+    
+    LogThreadBuffer() : stream(&textBuffer) {}
+    
+    template<typename Formatter>
+    bool push(LogLevel level, uint32_t suppressed, uint64_t sequence, Formatter&& format) {
+        const uint32_t writeIndex = head.load(std::memory_order_relaxed);
+        if (writeIndex - tail.load(std::memory_order_acquire) >= CAPACITY) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        LogRecord& record = records[writeIndex % CAPACITY];
+        record.sequence = sequence;
+        record.suppressed = suppressed;
+        record.level = level;
+        
+        // The stream is reused, so formatting state one message left behind is reset for the next
+        textBuffer.reset(record.text.data(), record.text.size());
+        stream.clear();
+        stream.flags(std::ios_base::dec | std::ios_base::skipws);
+        stream.precision(6);
+        stream.fill(' ');
+        format(stream);
+        record.length = static_cast<uint16_t>(textBuffer.length());
+        record.truncated = textBuffer.hasOverflowed();
+        
+        head.store(writeIndex + 1, std::memory_order_release);
+        return true;
+    }
+    
+    template<typename Visitor>
+    void drain(Visitor&& visitor) {
+        const uint32_t readEnd = head.load(std::memory_order_acquire);
+        uint32_t readIndex = tail.load(std::memory_order_relaxed);
+        for (; readIndex != readEnd; ++readIndex) {
+            visitor(records[readIndex % CAPACITY]);
+        }
+        tail.store(readIndex, std::memory_order_release);
+    }
+    
+    std::atomic<uint64_t> dropped{0};
+
+private:
+    std::array<LogRecord, CAPACITY> records;
+    LogTextBuffer textBuffer;
+    std::ostream stream;
+    alignas(64) std::atomic<uint32_t> head{0};
+    alignas(64) std::atomic<uint32_t> tail{0};
+};
+
+// Per call site limit for LOG_EVERY_MS: one message per interval, the rest counted into the next one
+class LogRateLimit {
+public:
+    explicit LogRateLimit(uint32_t intervalMs) : intervalNs(static_cast<int64_t>(intervalMs) * 1000000) {}
+    
+    bool allow(uint32_t& suppressedSince) {
+        const int64_t now = std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+        int64_t last = lastNs.load(std::memory_order_relaxed);
+        if ((last != NEVER && now - last < intervalNs) ||
+            !lastNs.compare_exchange_strong(last, now, std::memory_order_relaxed)) {
+            suppressed.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        suppressedSince = suppressed.exchange(0, std::memory_order_relaxed);
+        return true;
+    }
+
+private:
+    static constexpr int64_t NEVER = INT64_MIN;
+    
+    const int64_t intervalNs;
+    std::atomic<int64_t> lastNs{NEVER};
+    std::atomic<uint32_t> suppressed{0};
+};
+
+/**
+ * Console logging off the calling thread. A message is formatted into the calling thread's ring (no lock, no
+ * allocation, cut at LogRecord::TEXT_CAPACITY) and a background flusher merges the rings in sequence order every
+ * FLUSH_INTERVAL, writing Debug/Info to stdout and Warning/Error to stderr in one write per batch; warnings and
+ * errors wake it early. Console writes (which block for milliseconds on Windows) therefore never land on the
+ * frame. Messages a full ring drops are counted and reported by the flusher, and whatever is queued is
+ * written by flush() and at shutdown, so a crash can lose the last FLUSH_INTERVAL of output.
+ */
+class Logger {
+public:
+    static constexpr std::chrono::milliseconds FLUSH_INTERVAL{10};
+    
+    Logger(const Logger&) = delete;
+    Logger& operator=(const Logger&) = delete;
+    
+    static Logger& getInstance() {
+        static Logger instance;
+        return instance;
+    }
+    
+    // format(std::ostream&) runs on the calling thread only when the ring has room
+    template<typename Formatter>
+    void write(LogLevel level, uint32_t suppressed, Formatter&& format) {
+        const uint64_t sequence = nextSequence.fetch_add(1, std::memory_order_relaxed);
+        threadBuffer().push(level, suppressed, sequence, format);
+        if (level >= LogLevel::Warning) {
+            flusherWake.notify_one();
+        }
+    }
+    
+    // Blocks until everything logged before the call is on the console
+    void flush();
+
+private:
+    Logger();
+    ~Logger();
+    
+    LogThreadBuffer& threadBuffer();
+    void runFlusher();
+    void writeQueued();
+    
+    std::atomic<uint64_t> nextSequence{0};
+    
+    // Rings are handed out once per thread and kept past the thread's exit, so its last messages still go out
+    std::mutex registryMutex;
+    std::vector<std::shared_ptr<LogThreadBuffer>> threadBuffers;
+    
+    // Batch scratch, flusher (or flush()) only under writeMutex
+    std::mutex writeMutex;
+    std::vector<LogRecord> pending;
+    
+    std::thread flusher;
+    std::mutex flusherMutex;
+    std::condition_variable flusherWake;
+    bool stopping = false;
+};
+
+#define LOG_CONCAT_INNER(a, b) a##b
+#define LOG_CONCAT(a, b) LOG_CONCAT_INNER(a, b)
+
+// message is a stream expression, e.g. LOG_INFO("Uploaded " << count << " entities")
+#define LOG_AT(level, message) \
+    do { \
+        if constexpr (static_cast<int>(level) >= LOG_MIN_LEVEL) { \
+            Logger::getInstance().write(level, 0, [&](std::ostream& _log_stream) { _log_stream << message; }); \
+        } \
+    } while (0)
+
+// At most one message per intervalMs from this call site; the next one that passes says how many were skipped
+#define LOG_EVERY_MS(level, intervalMs, message) \
+    do { \
+        if constexpr (static_cast<int>(level) >= LOG_MIN_LEVEL) { \
+            static LogRateLimit LOG_CONCAT(_log_rate_, __LINE__)(intervalMs); \
+            uint32_t _log_suppressed = 0; \
+            if (LOG_CONCAT(_log_rate_, __LINE__).allow(_log_suppressed)) { \
+                Logger::getInstance().write(level, _log_suppressed, [&](std::ostream& _log_stream) { _log_stream << message; }); \
+            } \
+        } \
+    } while (0)
+
+#define LOG_DEBUG(message) LOG_AT(LogLevel::Debug, message)
+#define LOG_INFO(message) LOG_AT(LogLevel::Info, message)
+#define LOG_WARNING(message) LOG_AT(LogLevel::Warning, message)
+#define LOG_ERROR(message) LOG_AT(LogLevel::Error, message)
@@ -0,0 +1,142 @@
+#include "memory_tags.h"
+#include <flecs.h>
+#include <cstdlib>
+#include <cstring>
+#include <mutex>
+
+namespace {
+    constexpr std::array<const char*, MEMORY_TAG_COUNT> MEMORY_TAG_NAMES = {
+        "ecs", "events", "pipelines", "shaders", "frame_graph", "entity_staging", "render_queue"
+    };
+
+    struct TagResources {
+        std::array<TaggedMemoryResource, MEMORY_TAG_COUNT> resources;
+        std::array<std::pmr::synchronized_pool_resource*, MEMORY_TAG_COUNT> pools{};
+        std::once_flag poolOnce[MEMORY_TAG_COUNT];
+    };
+
+    // Leaked on purpose: static containers release into these after main() returns
+    TagResources& getTagResources() {
+        static TagResources* resources = new TagResources();
+        return *resources;
+    }
+
+    // Flecs frees and reallocates without a size, so every block carries its own. Keeps malloc's alignment
+    constexpr size_t FLECS_HEADER_SIZE = alignof(std::max_align_t);
+
+    void* flecsMalloc(ecs_size_t size) {
+        auto* block = static_cast<unsigned char*>(std::malloc(FLECS_HEADER_SIZE + static_cast<size_t>(size)));
+        if (!block) return nullptr;
+        std::memcpy(block, &size, sizeof(size));
+        MemoryTags::getResource(MemoryTag::ECS).recordAllocation(static_cast<size_t>(size));
+        return block + FLECS_HEADER_SIZE;
+    }
+
+    void* flecsCalloc(ecs_size_t size) {
+        void* pointer = flecsMalloc(size);
+        if (pointer) std::memset(pointer, 0, static_cast<size_t>(size));
+        return pointer;
+    }
+
+    void flecsFree(void* pointer) {
+        if (!pointer) return;
+        auto* block = static_cast<unsigned char*>(pointer) - FLECS_HEADER_SIZE;
+        ecs_size_t size = 0;
+        std::memcpy(&size, block, sizeof(size));
+        MemoryTags::getResource(MemoryTag::ECS).recordDeallocation(static_cast<size_t>(size));
+        std::free(block);
+    }
+
+    void* flecsRealloc(void* pointer, ecs_size_t size) {
+        if (!pointer) return flecsMalloc(size);
+        auto* block = static_cast<unsigned char*>(pointer) - FLECS_HEADER_SIZE;
+        ecs_size_t oldSize = 0;
+        std::memcpy(&oldSize, block, sizeof(oldSize));
+        auto* grown = static_cast<unsigned char*>(std::realloc(block, FLECS_HEADER_SIZE + static_cast<size_t>(size)));
+        if (!grown) return nullptr;  // The old block is still valid and still counted
+        std::memcpy(grown, &size, sizeof(size));
+        TaggedMemoryResource& resource = MemoryTags::getResource(MemoryTag::ECS);
+        resource.recordDeallocation(static_cast<size_t>(oldSize));
+        resource.recordAllocation(static_cast<size_t>(size));
+        return grown + FLECS_HEADER_SIZE;
+    }
+}
+
+const char* getMemoryTagName(MemoryTag tag) {
+    const size_t index = static_cast<size_t>(tag);
+    return index < MEMORY_TAG_COUNT ? MEMORY_TAG_NAMES[index] : "unknown";
+}
+
+void* TaggedMemoryResource::do_allocate(size_t bytes, size_t alignment) {
+    void* pointer = upstream->allocate(bytes, alignment);
+    recordAllocation(bytes);
+    return pointer;
+}
+
+void TaggedMemoryResource::do_deallocate(void* pointer, size_t bytes, size_t alignment) {
+    upstream->deallocate(pointer, bytes, alignment);
+    recordDeallocation(bytes);
+}
+
+void TaggedMemoryResource::recordAllocation(size_t bytes) {
+    allocations.fetch_add(1, std::memory_order_relaxed);
+    liveAllocations.fetch_add(1, std::memory_order_relaxed);
+    const size_t current = currentBytes.fetch_add(bytes, std::memory_order_relaxed) + bytes;
+    size_t peak = peakBytes.load(std::memory_order_relaxed);
+    while (current > peak && !peakBytes.compare_exchange_weak(peak, current, std::memory_order_relaxed)) {
+    }
+}
+
+void TaggedMemoryResource::recordDeallocation(size_t bytes) {
+    liveAllocations.fetch_sub(1, std::memory_order_relaxed);
+    currentBytes.fetch_sub(bytes, std::memory_order_relaxed);
+}
+
+TaggedMemoryResource::Counters TaggedMemoryResource::getCounters() const {
+    Counters counters;
+    counters.currentBytes = currentBytes.load(std::memory_order_relaxed);
+    counters.peakBytes = peakBytes.load(std::memory_order_relaxed);
+    counters.allocations = allocations.load(std::memory_order_relaxed);
+    counters.liveAllocations = liveAllocations.load(std::memory_order_relaxed);
+    return counters;
+}
+
+namespace MemoryTags {
+
+TaggedMemoryResource& getResource(MemoryTag tag) {
+    return getTagResources().resources[static_cast<size_t>(tag)];
+}
+
+std::pmr::memory_resource* getPool(MemoryTag tag) {
+    TagResources& resources = getTagResources();
+    const size_t index = static_cast<size_t>(tag);
+    std::call_once(resources.poolOnce[index], [&resources, index]() {
+        resources.pools[index] = new std::pmr::synchronized_pool_resource(&resources.resources[index]);
+    });
+    return resources.pools[index];
+}
+
+Report getReport() {
+    Report report;
+    for (size_t tag = 0; tag < MEMORY_TAG_COUNT; ++tag) {
+        report.tags[tag] = getResource(static_cast<MemoryTag>(tag)).getCounters();
+        report.currentBytes += report.tags[tag].currentBytes;
+        report.allocations += report.tags[tag].allocations;
+    }
+    return report;
+}
+
+void installFlecsAllocator() {
+    static std::once_flag installed;
+    std::call_once(installed, []() {
+        ecs_os_set_api_defaults();
+        ecs_os_api_t api = ecs_os_api;
+        api.malloc_ = flecsMalloc;
+        api.calloc_ = flecsCalloc;
+        api.realloc_ = flecsRealloc;
+        api.free_ = flecsFree;
+        ecs_os_set_api(&api);
+    });
+}
+
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <memory_resource>
+
+// Subsystem a CPU heap allocation is charged to. Containers opt in by taking MemoryTags::getResource (or a pool
+// over it); whatever does not is untagged heap and shows in no counter
+enum class MemoryTag : uint8_t {
+    ECS = 0,           // Flecs worlds, through its OS API allocator (MemoryTags::installFlecsAllocator)
+    EventBus,          // Deferred events and their queue
+    PipelineCache,     // Compute and graphics pipeline cache entries
+    ShaderManager,     // Shader cache entries and the SPIR-V kept for reflection
+    FrameGraph,        // Captured node dependencies
+    EntityStaging,     // GPUEntitySoA staging mirrors of the entity streams
+    RenderQueue,       // RenderingService batches
+    Count
+};
+inline constexpr size_t MEMORY_TAG_COUNT = static_cast<size_t>(MemoryTag::Count);
+
+const char* getMemoryTagName(MemoryTag tag);
+
+// Counting pass-through to an upstream resource. Counters are relaxed atomics, so any thread may allocate while
+// another reads them; the peak is exact, the snapshot of several counters is not taken at one instant
+class TaggedMemoryResource final : public std::pmr::memory_resource {
+public:
+    explicit TaggedMemoryResource(std::pmr::memory_resource* upstream = std::pmr::new_delete_resource())
+        : upstream(upstream) {}
+
+    struct Counters {
+        size_t currentBytes = 0;
+        size_t peakBytes = 0;
+        uint64_t allocations = 0;      // Since startup; upstream calls, so pools show as few
+        uint64_t liveAllocations = 0;
+    };
+    Counters getCounters() const;
+
+    // For allocators that cannot go through the resource interface (the Flecs hooks): count only
+    void recordAllocation(size_t bytes);
+    void recordDeallocation(size_t bytes);
+
+private:
+    void* do_allocate(size_t bytes, size_t alignment) override;
+    void do_deallocate(void* pointer, size_t bytes, size_t alignment) override;
+    bool do_is_equal(const std::pmr::memory_resource& other) const noexcept override { return this == &other; }
+
+    std::pmr::memory_resource* upstream;
+    std::atomic<size_t> currentBytes{0};
+    std::atomic<size_t> peakBytes{0};
+    std::atomic<uint64_t> allocations{0};
+    std::atomic<uint64_t> liveAllocations{0};
+};
+
+namespace MemoryTags {
+    // Process lifetime and never destroyed, so containers in statics may release into them during exit
+    TaggedMemoryResource& getResource(MemoryTag tag);
+
+    // Thread-safe pool over the tag's resource for small, frequently replaced objects; blocks are kept for reuse,
+    // so the tag's bytes include the pool's free space
+    std::pmr::memory_resource* getPool(MemoryTag tag);
+
+    struct Report {
+        std::array<TaggedMemoryResource::Counters, MEMORY_TAG_COUNT> tags{};
+        size_t currentBytes = 0;  // Sum over the tags
+        uint64_t allocations = 0;
+    };
+    Report getReport();
+
+    // Routes Flecs's malloc/calloc/realloc/free through the ECS tag. Must run before the first world is created;
+    // later calls do nothing
+    void installFlecsAllocator();
+}
@@ -2,16 +2,23 @@
 
 #include <chrono>
 #include <string>
+#include <string_view>
 #include <unordered_map>
 #include <vector>
+#include <deque>
+#include <array>
 #include <memory>
 #include <iostream>
 #include <fstream>
 #include <thread>
 #include <mutex>
+#include <condition_variable>
+#include <atomic>
 #include <iomanip>
 #include <algorithm>
 #include <limits>
+#include <cstdint>
+#include "memory_tags.h"
 
 // High-resolution timer for performance profiling
 class ProfileTimer {
@@ -19,7 +26,7 @@ private:
     std::chrono::high_resolution_clock::time_point startTime;
     std::chrono::high_resolution_clock::time_point endTime;
     bool running{false};
-    
+
 public:
     void start() {
         startTime = std::chrono::high_resolution_clock::now();
@@ -52,19 +59,114 @@ public:
     bool isRunning() const { return running; }
 };
 
+// Index of a named zone, registered once per call site by PROFILE_SCOPE
+using ProfileZoneId = uint32_t;
+
+// Known frame spike sources, instrumented with PROFILE_HITCH_EVENT where they block the calling thread
+enum class HitchCause : uint8_t {
+    PipelineCompile = 0,    // vkCreate*Pipelines
+    SynchronousUpload,      // endSingleTimeCommands
+    DeviceWaitIdle,         // Debug readbacks, snapshots, entity buffer growth
+    SwapchainRecreation,
+    ShaderReload,
+    CacheOptimize,          // optimizeCache LRU eviction
+    Count
+};
+inline constexpr size_t HITCH_CAUSE_COUNT = static_cast<size_t>(HitchCause::Count);
+
+inline const char* getHitchCauseName(HitchCause cause) {
+    static constexpr std::array<const char*, HITCH_CAUSE_COUNT> names = {
+        "pipeline compile", "sync upload", "device wait idle", "swapchain recreation", "shader reload", "cache optimize"
+    };
+    return cause < HitchCause::Count ? names[static_cast<size_t>(cause)] : "unknown";
+}
+
+// One frame that took more than the hitch factor times the median of the frames before it, with the
+// instrumented events that ran during it (from any thread)
+struct HitchRecord {
+    size_t frame = 0;
+    float frameTime = 0.0f;     // ms
+    float medianTime = 0.0f;
+    std::array<uint32_t, HITCH_CAUSE_COUNT> causeCounts{};
+    std::array<float, HITCH_CAUSE_COUNT> causeTimes{};  // ms spent in each cause
+    
+    bool isAttributed() const {
+        return std::any_of(causeCounts.begin(), causeCounts.end(), [](uint32_t count) { return count > 0; });
+    }
+};
+
+// Hitches since the last takeHitchSummary()
+struct HitchSummary {
+    uint64_t hitches = 0;
+    uint64_t unattributed = 0;      // Hitch frames without any instrumented event
+    std::array<uint64_t, HITCH_CAUSE_COUNT> framesWithCause{};
+    float worstFrameTime = 0.0f;
+};
+
+// One closed zone as recorded by the thread that ran it; GPU zones are already on the CPU clock
+struct ProfileZoneEvent {
+    ProfileZoneId zone = 0;
+    uint32_t track = 0;         // Producer thread's track, or a GPU queue's
+    int64_t startNs = 0;
+    int64_t durationNs = 0;
+};
+
+// Single-producer ring owned by one thread; only the aggregator consumes it. A full ring drops events
+// instead of blocking the thread being measured
+class ProfileThreadBuffer {
+public:
+    static constexpr uint32_t CAPACITY = 4096;
+    
+    ProfileThreadBuffer(uint32_t track, std::string name) : track(track), name(std::move(name)) {}
+    
+    bool push(const ProfileZoneEvent& event) {
+        const uint32_t writeIndex = head.load(std::memory_order_relaxed);
+        if (writeIndex - tail.load(std::memory_order_acquire) >= CAPACITY) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return false;
+        }
+        events[writeIndex % CAPACITY] = event;
+        head.store(writeIndex + 1, std::memory_order_release);
+        return true;
+    }
+    
+    template<typename Visitor>
+    void drain(Visitor&& visitor) {
+        const uint32_t readEnd = head.load(std::memory_order_acquire);
+        uint32_t readIndex = tail.load(std::memory_order_relaxed);
+        for (; readIndex != readEnd; ++readIndex) {
+            visitor(events[readIndex % CAPACITY]);
+        }
+        tail.store(readIndex, std::memory_order_release);
+    }
+    
+    const uint32_t track;
+    std::string name;           // Guarded by the profiler's registry mutex
+    std::atomic<uint64_t> dropped{0};
+
+private:
+    std::array<ProfileZoneEvent, CAPACITY> events{};
+    alignas(64) std::atomic<uint32_t> head{0};
+    alignas(64) std::atomic<uint32_t> tail{0};
+};
+
 // RAII profiler scope for automatic timing
 class ProfileScope {
 private:
-    class Profiler* profiler;
-    std::string name;
-    ProfileTimer timer;
-    
+    ProfileZoneId zone;
+    int64_t startNs;
+
 public:
-    ProfileScope(class Profiler* p, const std::string& scopeName);
+    explicit ProfileScope(ProfileZoneId zone);
     ~ProfileScope();
+    
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
 };
 
-// Performance data collector and analyzer
+// Performance data collector and analyzer. Recording a zone is a clock read and a push into the calling
+// thread's ring, with no lock and no string work; a background aggregator drains the rings every
+// AGGREGATE_INTERVAL into per-zone statistics and, while a capture runs, into a Chrome trace
 class Profiler {
 private:
     struct ProfileData {
@@ -73,8 +175,11 @@ private:
         float minTime{std::numeric_limits<float>::max()};
         float maxTime{0.0f};
         size_t callCount{0};
-        std::vector<float> recentTimes;
         static constexpr size_t MAX_RECENT = 100;
+        std::array<float, MAX_RECENT> recentTimes{};   // Ring of the most recent samples
+        size_t recentNext{0};
+        
+        size_t recentCount() const { return std::min(callCount, MAX_RECENT); }
         
         void addSample(float time) {
             totalTime += time;
@@ -82,10 +187,8 @@ private:
             maxTime = std::max(maxTime, time);
             callCount++;
             
-            if (recentTimes.size() >= MAX_RECENT) {
-                recentTimes.erase(recentTimes.begin());
-            }
-            recentTimes.push_back(time);
+            recentTimes[recentNext] = time;
+            recentNext = (recentNext + 1) % MAX_RECENT;
         }
         
         float getAverageTime() const {
@@ -93,21 +196,56 @@ private:
         }
         
         float getRecentAverageTime() const {
-            if (recentTimes.empty()) return 0.0f;
+            if (callCount == 0) return 0.0f;
             float sum = 0.0f;
-            for (float time : recentTimes) {
-                sum += time;
+            for (size_t i = 0; i < recentCount(); ++i) {
+                sum += recentTimes[i];
             }
-            return sum / recentTimes.size();
+            return sum / recentCount();
+        }
+        
+        float getRecentPercentile(float percentile) const {
+            if (callCount == 0) return 0.0f;
+            std::array<float, MAX_RECENT> sorted = recentTimes;
+            std::sort(sorted.begin(), sorted.begin() + recentCount());
+            return sorted[static_cast<size_t>((recentCount() - 1) * percentile)];
         }
     };
     
-    std::unordered_map<std::string, std::unique_ptr<ProfileData>> profiles;
+    struct TraceEvent {
+        ProfileZoneId zone;
+        uint32_t track;
+        int64_t startNs;
+        int64_t durationNs;
+    };
+    
+    static constexpr auto AGGREGATE_INTERVAL = std::chrono::milliseconds(5);
+    static constexpr size_t DEFAULT_TRACE_EVENTS = 1 << 20;
+    
+    // Zone names and thread buffers; taken once per call site or thread, never per sample
+    mutable std::mutex registryMutex;
+    std::deque<std::string> zoneNames;
+    std::unordered_map<std::string, ProfileZoneId> zoneIds;
+    std::vector<std::shared_ptr<ProfileThreadBuffer>> threadBuffers;
+    
+    // Aggregated state, touched only by collect() and the readers below
     mutable std::mutex profileMutex;
-    bool enabled{true};
+    std::vector<ProfileData> profiles;   // Indexed by zone
+    bool capturing{false};
+    size_t traceCapacity{0};
+    uint64_t traceDropped{0};
+    int64_t traceStartNs{0};
+    std::vector<TraceEvent> traceEvents;
+    
+    std::atomic<bool> enabled{true};
+    std::thread aggregator;
+    std::mutex aggregatorMutex;
+    std::condition_variable aggregatorWake;
+    bool stopping{false};
     
     // Frame timing
-    ProfileTimer frameTimer;
+    ProfileZoneId frameZone;
+    int64_t frameStartNs{0};
     float targetFrameTime{16.67f}; // 60 FPS
     size_t frameCount{0};
     
@@ -115,70 +253,338 @@ private:
     size_t peakMemoryUsage{0};
     size_t currentMemoryUsage{0};
     
+    // Display refreshes that repeated the previous image, from PresentTimingMonitor
+    std::atomic<uint64_t> missedVblanks{0};
+    
+    // Hitch detection: instrumented events add to the open frame's tallies from any thread; endFrame() takes
+    // them and compares the frame with the median of the last HITCH_MEDIAN_WINDOW frames
+    static constexpr size_t HITCH_MEDIAN_WINDOW = 120;
+    static constexpr size_t HITCH_MIN_HISTORY = 30;      // Frames before the median is trusted
+    static constexpr size_t MAX_HITCH_RECORDS = 64;
+    std::array<std::atomic<uint32_t>, HITCH_CAUSE_COUNT> frameCauseCounts{};
+    std::array<std::atomic<int64_t>, HITCH_CAUSE_COUNT> frameCauseNs{};
+    std::array<float, HITCH_MEDIAN_WINDOW> frameHistory{};
+    size_t frameHistoryCount{0};
+    float hitchFactor{2.5f};
+    mutable std::mutex hitchMutex;
+    std::deque<HitchRecord> hitchRecords;   // Newest last, at most MAX_HITCH_RECORDS
+    HitchSummary hitchSummary;
+    
+    void detectHitch(float frameTime) {
+        HitchRecord record;
+        for (size_t cause = 0; cause < HITCH_CAUSE_COUNT; ++cause) {
+            record.causeCounts[cause] = frameCauseCounts[cause].exchange(0, std::memory_order_relaxed);
+            record.causeTimes[cause] = static_cast<float>(frameCauseNs[cause].exchange(0, std::memory_order_relaxed)) / 1e6f;
+        }
+        
+        const size_t held = std::min(frameHistoryCount, HITCH_MEDIAN_WINDOW);
+        if (held >= HITCH_MIN_HISTORY) {
+            std::array<float, HITCH_MEDIAN_WINDOW> sorted = frameHistory;
+            std::nth_element(sorted.begin(), sorted.begin() + held / 2, sorted.begin() + held);
+            record.medianTime = sorted[held / 2];
+        }
+        frameHistory[frameHistoryCount++ % HITCH_MEDIAN_WINDOW] = frameTime;
+        if (record.medianTime <= 0.0f || frameTime <= record.medianTime * hitchFactor) {
+            return;
+        }
+        
+        record.frame = frameCount;
+        record.frameTime = frameTime;
+        std::lock_guard<std::mutex> lock(hitchMutex);
+        hitchSummary.hitches++;
+        hitchSummary.worstFrameTime = std::max(hitchSummary.worstFrameTime, frameTime);
+        if (!record.isAttributed()) {
+            hitchSummary.unattributed++;
+        }
+        for (size_t cause = 0; cause < HITCH_CAUSE_COUNT; ++cause) {
+            if (record.causeCounts[cause] > 0) {
+                hitchSummary.framesWithCause[cause]++;
+            }
+        }
+        if (hitchRecords.size() == MAX_HITCH_RECORDS) {
+            hitchRecords.pop_front();
+        }
+        hitchRecords.push_back(record);
+    }
+    
+    Profiler() {
+        frameZone = registerZone("Frame");
+        aggregator = std::thread([this] { runAggregator(); });
+    }
+    
+    ~Profiler() {
+        {
+            std::lock_guard<std::mutex> lock(aggregatorMutex);
+            stopping = true;
+        }
+        aggregatorWake.notify_one();
+        if (aggregator.joinable()) {
+            aggregator.join();
+        }
+    }
+    
+    void runAggregator() {
+        std::unique_lock<std::mutex> lock(aggregatorMutex);
+        while (!stopping) {
+            aggregatorWake.wait_for(lock, AGGREGATE_INTERVAL);
+            collect();
+        }
+    }
+    
+    // The ring is handed out once per thread; the registry keeps it alive past the thread's exit so
+    // the aggregator can still drain what it recorded
+    ProfileThreadBuffer& threadBuffer() {
+        thread_local std::shared_ptr<ProfileThreadBuffer> buffer;
+        if (!buffer) {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            const auto thread = static_cast<uint32_t>(threadBuffers.size() + 1);
+            buffer = std::make_shared<ProfileThreadBuffer>(GPU_TRACK_COUNT + thread - 1, "Thread " + std::to_string(thread));
+            threadBuffers.push_back(buffer);
+        }
+        return *buffer;
+    }
+    
+    void recordOn(ProfileThreadBuffer& buffer, ProfileZoneId zone, uint32_t track, int64_t startNs, int64_t durationNs) {
+        buffer.push(ProfileZoneEvent{zone, track, startNs, durationNs});
+    }
+
 public:
+    // GPU work by the queue it ran on; thread tracks follow
+    static constexpr uint32_t GPU_TRACK = 0;
+    static constexpr uint32_t GPU_COMPUTE_TRACK = 1;
+    static constexpr uint32_t GPU_TRACK_COUNT = 2;
+    
+    Profiler(const Profiler&) = delete;
+    Profiler& operator=(const Profiler&) = delete;
+    
     static Profiler& getInstance() {
         static Profiler instance;
         return instance;
     }
     
-    void setEnabled(bool enable) { enabled = enable; }
-    bool isEnabled() const { return enabled; }
+    static int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
     
-    // Manual profiling
-    void beginProfile(const std::string& name) {
-        if (!enabled) return;
-        
-        std::lock_guard<std::mutex> lock(profileMutex);
-        auto it = profiles.find(name);
-        if (it == profiles.end()) {
-            profiles[name] = std::make_unique<ProfileData>();
-            profiles[name]->name = name;
+    void setEnabled(bool enable) { enabled.store(enable, std::memory_order_relaxed); }
+    bool isEnabled() const { return enabled.load(std::memory_order_relaxed); }
+    
+    // Same name, same zone; PROFILE_SCOPE caches the result in a static per call site
+    ProfileZoneId registerZone(std::string_view name) {
+        std::lock_guard<std::mutex> lock(registryMutex);
+        auto it = zoneIds.find(std::string(name));
+        if (it != zoneIds.end()) {
+            return it->second;
         }
+        const auto zone = static_cast<ProfileZoneId>(zoneNames.size());
+        zoneNames.emplace_back(name);
+        zoneIds.emplace(zoneNames.back(), zone);
+        return zone;
     }
     
-    void endProfile(const std::string& name, float timeMs) {
-        if (!enabled) return;
+    // Labels the calling thread's track in exported traces
+    void setThreadName(const std::string& name) {
+        ProfileThreadBuffer& buffer = threadBuffer();
+        std::lock_guard<std::mutex> lock(registryMutex);
+        buffer.name = name;
+    }
+    
+    void record(ProfileZoneId zone, int64_t startNs, int64_t durationNs) {
+        ProfileThreadBuffer& buffer = threadBuffer();
+        recordOn(buffer, zone, buffer.track, startNs, durationNs);
+    }
+    
+    // GPU work measured elsewhere, with startNs already translated to the steady clock; lands on the GPU
+    // track of its queue (GPU_TRACK for graphics, GPU_COMPUTE_TRACK for compute)
+    void recordGpuZone(ProfileZoneId zone, int64_t startNs, int64_t durationNs, uint32_t track = GPU_TRACK) {
+        if (!isEnabled()) return;
+        recordOn(threadBuffer(), zone, track, startNs, durationNs);
+    }
+    
+    // Drains every thread ring; the aggregator calls this on its own, readers call it for fresh numbers
+    void collect() {
+        std::vector<std::shared_ptr<ProfileThreadBuffer>> buffers;
+        size_t zoneCount = 0;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            buffers = threadBuffers;
+            zoneCount = zoneNames.size();
+        }
         
         std::lock_guard<std::mutex> lock(profileMutex);
-        auto it = profiles.find(name);
-        if (it != profiles.end()) {
-            it->second->addSample(timeMs);
+        if (profiles.size() < zoneCount) {
+            std::lock_guard<std::mutex> registryLock(registryMutex);
+            while (profiles.size() < zoneCount) {
+                const size_t zone = profiles.size();
+                profiles.emplace_back().name = zoneNames[zone];
+            }
         }
+        
+        for (const auto& buffer : buffers) {
+            buffer->drain([this](const ProfileZoneEvent& event) {
+                if (event.zone >= profiles.size()) return;
+                profiles[event.zone].addSample(static_cast<float>(event.durationNs) / 1e6f);
+                
+                if (capturing && event.startNs >= traceStartNs) {
+                    if (traceEvents.size() < traceCapacity) {
+                        traceEvents.push_back(TraceEvent{event.zone, event.track, event.startNs, event.durationNs});
+                    } else {
+                        ++traceDropped;
+                    }
+                }
+            });
+        }
+    }
+    
+    // Trace capture: zones closed from now on are kept (up to maxEvents) until exportChromeTrace()
+    void startTraceCapture(size_t maxEvents = DEFAULT_TRACE_EVENTS) {
+        collect();
+        std::lock_guard<std::mutex> lock(profileMutex);
+        capturing = true;
+        traceCapacity = maxEvents;
+        traceDropped = 0;
+        traceStartNs = now();
+        traceEvents.clear();
+        traceEvents.reserve(std::min<size_t>(maxEvents, 1 << 16));
     }
     
-    // Scope-based profiling
-    ProfileScope createScope(const std::string& name) {
-        return ProfileScope(this, name);
+    bool isCapturingTrace() const {
+        std::lock_guard<std::mutex> lock(profileMutex);
+        return capturing;
+    }
+    
+    // Chrome trace event JSON (chrome://tracing, Perfetto UI). CPU zones go on one track per thread, GPU
+    // node timings on one per queue, all on the steady clock; zone names are literals and class names, so
+    // they are written unescaped
+    bool exportChromeTrace(const std::string& filename) {
+        collect();
+        
+        std::vector<std::pair<uint32_t, std::string>> tracks;
+        {
+            std::lock_guard<std::mutex> lock(registryMutex);
+            for (const auto& buffer : threadBuffers) {
+                tracks.emplace_back(buffer->track, buffer->name);
+            }
+        }
+        tracks.emplace_back(GPU_TRACK, "GPU graphics queue");
+        tracks.emplace_back(GPU_COMPUTE_TRACK, "GPU compute queue");
+        
+        std::ofstream file(filename);
+        if (!file.is_open()) {
+            std::cerr << "Profiler: Failed to open " << filename << " for writing" << std::endl;
+            return false;
+        }
+        
+        std::lock_guard<std::mutex> lock(profileMutex);
+        file << std::fixed << std::setprecision(3);
+        file << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n";
+        bool first = true;
+        for (const auto& [track, name] : tracks) {
+            file << (first ? "" : ",\n") << "{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":" << track
+                 << ",\"args\":{\"name\":\"" << name << "\"}}";
+            first = false;
+        }
+        for (const TraceEvent& event : traceEvents) {
+            file << ",\n{\"name\":\"" << profiles[event.zone].name << "\",\"ph\":\"X\",\"pid\":1,\"tid\":" << event.track
+                 << ",\"ts\":" << static_cast<double>(event.startNs - traceStartNs) / 1e3
+                 << ",\"dur\":" << static_cast<double>(event.durationNs) / 1e3 << "}";
+        }
+        file << "\n]}\n";
+        
+        if (!file) {
+            std::cerr << "Profiler: Failed to write trace to " << filename << std::endl;
+            return false;
+        }
+        std::cout << "Profiler: " << traceEvents.size() << " trace events written to " << filename;
+        if (traceDropped > 0) {
+            std::cout << " (" << traceDropped << " dropped past the capture limit)";
+        }
+        std::cout << std::endl;
+        return true;
     }
     
     // Frame timing
     void beginFrame() {
-        frameTimer.start();
+        frameStartNs = now();
     }
     
     void endFrame() {
-        frameTimer.stop();
-        float frameTime = frameTimer.getMilliseconds();
+        const int64_t frameEndNs = now();
+        float frameTime = static_cast<float>(frameEndNs - frameStartNs) / 1e6f;
         frameCount++;
         
         // Track frame timing
-        endProfile("Frame", frameTime);
+        if (isEnabled()) {
+            record(frameZone, frameStartNs, frameEndNs - frameStartNs);
+        }
+        detectHitch(frameTime);
         
         // Log performance warnings
         if (frameTime > targetFrameTime * 1.5f) {
-            std::cout << "Performance Warning: Frame took " << frameTime 
+            std::cout << "Performance Warning: Frame took " << frameTime
                       << "ms (target: " << targetFrameTime << "ms)" << std::endl;
         }
     }
     
     void setTargetFrameTime(float ms) { targetFrameTime = ms; }
     
-    // Memory tracking
+    // Hitch attribution: an event that may stall the frame, counted into the open frame with the time it took
+    void recordHitchEvent(HitchCause cause, int64_t durationNs) {
+        const size_t index = static_cast<size_t>(cause);
+        if (index >= HITCH_CAUSE_COUNT) return;
+        frameCauseCounts[index].fetch_add(1, std::memory_order_relaxed);
+        frameCauseNs[index].fetch_add(durationNs, std::memory_order_relaxed);
+    }
+    
+    // A frame is a hitch beyond factor times the median frame time
+    void setHitchFactor(float factor) { hitchFactor = std::max(1.0f, factor); }
+    float getHitchFactor() const { return hitchFactor; }
+    
+    HitchSummary takeHitchSummary() {
+        std::lock_guard<std::mutex> lock(hitchMutex);
+        HitchSummary summary = hitchSummary;
+        hitchSummary = HitchSummary{};
+        return summary;
+    }
+    
+    std::vector<HitchRecord> getRecentHitches() const {
+        std::lock_guard<std::mutex> lock(hitchMutex);
+        return std::vector<HitchRecord>(hitchRecords.begin(), hitchRecords.end());
+    }
+    
+    // The rolling record, newest last: each hitch frame with the events it ran and their time
+    void printHitchReport() const {
+        const std::vector<HitchRecord> hitches = getRecentHitches();
+        std::cout << "Hitches (frames over " << hitchFactor << "x median, newest " << hitches.size() << "):" << std::endl;
+        for (const HitchRecord& hitch : hitches) {
+            std::cout << "  Frame " << hitch.frame << ": " << hitch.frameTime << "ms (median " << hitch.medianTime << "ms) -";
+            if (!hitch.isAttributed()) {
+                std::cout << " no instrumented event";
+            }
+            for (size_t cause = 0; cause < HITCH_CAUSE_COUNT; ++cause) {
+                if (hitch.causeCounts[cause] > 0) {
+                    std::cout << " " << getHitchCauseName(static_cast<HitchCause>(cause)) << " x" << hitch.causeCounts[cause]
+                              << " (" << hitch.causeTimes[cause] << "ms)";
+                }
+            }
+            std::cout << std::endl;
+        }
+    }
+    
+    // Memory tracking: the tagged CPU heap (MemoryTags::getReport().currentBytes), whose tags printReport breaks down
     void updateMemoryUsage(size_t bytes) {
         currentMemoryUsage = bytes;
         peakMemoryUsage = std::max(peakMemoryUsage, bytes);
     }
     
+    void recordMissedVblanks(uint64_t count) {
+        if (count > 0) {
+            missedVblanks.fetch_add(count, std::memory_order_relaxed);
+        }
+    }
+    uint64_t getMissedVblanks() const { return missedVblanks.load(std::memory_order_relaxed); }
+    
     // Reporting
     struct ProfileReport {
         std::string name;
@@ -186,30 +592,34 @@ public:
         float recentAverageTime;
         float minTime;
         float maxTime;
+        float p50Time;  // Over the recent samples
+        float p99Time;
         size_t callCount;
         float percentOfFrame;
     };
     
-    std::vector<ProfileReport> generateReport() const {
+    std::vector<ProfileReport> generateReport() {
+        collect();
         std::lock_guard<std::mutex> lock(profileMutex);
         std::vector<ProfileReport> report;
         
         // Get frame time for percentage calculations
         float frameTime = 16.67f; // Default
-        auto frameIt = profiles.find("Frame");
-        if (frameIt != profiles.end()) {
-            frameTime = frameIt->second->getRecentAverageTime();
+        if (frameZone < profiles.size() && profiles[frameZone].callCount > 0) {
+            frameTime = profiles[frameZone].getRecentAverageTime();
         }
         
-        for (const auto& [name, data] : profiles) {
-            if (data->callCount > 0) {
+        for (const ProfileData& data : profiles) {
+            if (data.callCount > 0) {
                 ProfileReport entry;
-                entry.name = name;
-                entry.averageTime = data->getAverageTime();
-                entry.recentAverageTime = data->getRecentAverageTime();
-                entry.minTime = data->minTime;
-                entry.maxTime = data->maxTime;
-                entry.callCount = data->callCount;
+                entry.name = data.name;
+                entry.averageTime = data.getAverageTime();
+                entry.recentAverageTime = data.getRecentAverageTime();
+                entry.minTime = data.minTime;
+                entry.maxTime = data.maxTime;
+                entry.p50Time = data.getRecentPercentile(0.5f);
+                entry.p99Time = data.getRecentPercentile(0.99f);
+                entry.callCount = data.callCount;
                 entry.percentOfFrame = (entry.recentAverageTime / frameTime) * 100.0f;
                 
                 report.push_back(entry);
@@ -217,7 +627,7 @@ public:
         }
         
         // Sort by recent average time (descending)
-        std::sort(report.begin(), report.end(), 
+        std::sort(report.begin(), report.end(),
                  [](const ProfileReport& a, const ProfileReport& b) {
                      return a.recentAverageTime > b.recentAverageTime;
                  });
@@ -225,15 +635,16 @@ public:
         return report;
     }
     
-    void printReport() const {
+    void printReport() {
         auto report = generateReport();
         
         std::cout << "\n=== Performance Report ===" << std::endl;
-        std::cout << "Profile Name" << std::setw(20) << "Avg(ms)" << std::setw(12) 
-                  << "Recent(ms)" << std::setw(12) << "Min(ms)" << std::setw(12) 
-                  << "Max(ms)" << std::setw(12) << "Calls" << std::setw(12) 
+        std::cout << "Profile Name" << std::setw(20) << "Avg(ms)" << std::setw(12)
+                  << "Recent(ms)" << std::setw(12) << "Min(ms)" << std::setw(12)
+                  << "Max(ms)" << std::setw(12) << "P50(ms)" << std::setw(12)
+                  << "P99(ms)" << std::setw(12) << "Calls" << std::setw(12)
                   << "% Frame" << std::endl;
-        std::cout << std::string(80, '-') << std::endl;
+        std::cout << std::string(104, '-') << std::endl;
         
         for (const auto& entry : report) {
             std::cout << std::left << std::setw(20) << entry.name
@@ -242,6 +653,8 @@ public:
                       << std::setw(12) << entry.recentAverageTime
                       << std::setw(12) << entry.minTime
                       << std::setw(12) << entry.maxTime
+                      << std::setw(12) << entry.p50Time
+                      << std::setw(12) << entry.p99Time
                       << std::setw(12) << entry.callCount
                       << std::setw(11) << entry.percentOfFrame << "%"
                       << std::endl;
@@ -250,17 +663,26 @@ public:
         std::cout << "\nMemory Usage:" << std::endl;
         std::cout << "  Current: " << (currentMemoryUsage / 1024 / 1024) << " MB" << std::endl;
         std::cout << "  Peak: " << (peakMemoryUsage / 1024 / 1024) << " MB" << std::endl;
+        const MemoryTags::Report heap = MemoryTags::getReport();
+        for (size_t tag = 0; tag < MEMORY_TAG_COUNT; ++tag) {
+            const TaggedMemoryResource::Counters& counters = heap.tags[tag];
+            std::cout << "    " << std::left << std::setw(16) << getMemoryTagName(static_cast<MemoryTag>(tag)) << std::right
+                      << (counters.currentBytes / 1024) << " KB (peak " << (counters.peakBytes / 1024) << " KB, "
+                      << counters.allocations << " allocations)" << std::endl;
+        }
         std::cout << "  Frames: " << frameCount << std::endl;
+        std::cout << "  Missed vblanks: " << getMissedVblanks() << std::endl;
+        printHitchReport();
         std::cout << "=========================" << std::endl;
     }
     
-    void exportToCSV(const std::string& filename) const {
+    void exportToCSV(const std::string& filename) {
         std::ofstream file(filename);
         if (!file.is_open()) return;
         
         auto report = generateReport();
         
-        file << "Name,AverageTime,RecentAverageTime,MinTime,MaxTime,CallCount,PercentOfFrame" << std::endl;
+        file << "Name,AverageTime,RecentAverageTime,MinTime,MaxTime,P50Time,P99Time,CallCount,PercentOfFrame" << std::endl;
         
         for (const auto& entry : report) {
             file << entry.name << ","
@@ -268,6 +690,8 @@ public:
                  << entry.recentAverageTime << ","
                  << entry.minTime << ","
                  << entry.maxTime << ","
+                 << entry.p50Time << ","
+                 << entry.p99Time << ","
                  << entry.callCount << ","
                  << entry.percentOfFrame << std::endl;
         }
@@ -275,21 +699,31 @@ public:
         file.close();
     }
     
-    // Reset statistics
+    // Reset statistics; zone IDs stay valid
     void reset() {
+        collect();
         std::lock_guard<std::mutex> lock(profileMutex);
-        profiles.clear();
+        for (ProfileData& data : profiles) {
+            std::string name = std::move(data.name);
+            data = ProfileData{};
+            data.name = std::move(name);
+        }
         frameCount = 0;
         peakMemoryUsage = 0;
         currentMemoryUsage = 0;
+        missedVblanks.store(0, std::memory_order_relaxed);
+        frameHistoryCount = 0;
+        std::lock_guard<std::mutex> hitchLock(hitchMutex);
+        hitchRecords.clear();
+        hitchSummary = HitchSummary{};
     }
     
     // Quick stats access
-    float getFrameTime() const {
+    float getFrameTime() {
+        collect();
         std::lock_guard<std::mutex> lock(profileMutex);
-        auto it = profiles.find("Frame");
-        if (it != profiles.end() && it->second->callCount > 0) {
-            float frameTime = it->second->getRecentAverageTime();
+        if (frameZone < profiles.size() && profiles[frameZone].callCount > 0) {
+            float frameTime = profiles[frameZone].getRecentAverageTime();
             return frameTime > 0.0f ? frameTime : targetFrameTime;
         }
         return targetFrameTime; // Return target frame time as fallback
@@ -301,23 +735,38 @@ public:
 };
 
 // RAII ProfileScope implementation
-inline ProfileScope::ProfileScope(Profiler* p, const std::string& scopeName) 
-    : profiler(p), name(scopeName) {
-    if (profiler && profiler->isEnabled()) {
-        profiler->beginProfile(name);
-        timer.start();
-    }
+inline ProfileScope::ProfileScope(ProfileZoneId zone)
+    : zone(zone), startNs(Profiler::getInstance().isEnabled() ? Profiler::now() : -1) {
 }
 
 inline ProfileScope::~ProfileScope() {
-    if (profiler && profiler->isEnabled()) {
-        timer.stop();
-        profiler->endProfile(name, timer.getMilliseconds());
+    if (startNs >= 0) {
+        Profiler::getInstance().record(zone, startNs, Profiler::now() - startNs);
     }
 }
 
-// Convenience macros for profiling
-#define PROFILE_SCOPE(name) auto _prof_scope = Profiler::getInstance().createScope(name)
+// Times an instrumented stall for hitch attribution
+class HitchEventScope {
+public:
+    explicit HitchEventScope(HitchCause cause) : cause(cause), startNs(Profiler::now()) {}
+    ~HitchEventScope() { Profiler::getInstance().recordHitchEvent(cause, Profiler::now() - startNs); }
+    
+    HitchEventScope(const HitchEventScope&) = delete;
+    HitchEventScope& operator=(const HitchEventScope&) = delete;
+
+private:
+    HitchCause cause;
+    int64_t startNs;
+};
+
+// Convenience macros for profiling; name should be a literal, since each call site registers it once
+#define PROFILE_CONCAT_INNER(a, b) a##b
+#define PROFILE_CONCAT(a, b) PROFILE_CONCAT_INNER(a, b)
+#define PROFILE_SCOPE(name) \
+    static const ProfileZoneId PROFILE_CONCAT(_prof_zone_, __LINE__) = Profiler::getInstance().registerZone(name); \
+    ProfileScope PROFILE_CONCAT(_prof_scope_, __LINE__)(PROFILE_CONCAT(_prof_zone_, __LINE__))
 #define PROFILE_FUNCTION() PROFILE_SCOPE(__FUNCTION__)
+#define PROFILE_HITCH_EVENT(cause) \
+    HitchEventScope PROFILE_CONCAT(_prof_hitch_, __LINE__)(cause)
 #define PROFILE_BEGIN_FRAME() Profiler::getInstance().beginFrame()
-#define PROFILE_END_FRAME() Profiler::getInstance().endFrame()
\ No newline at end of file
+#define PROFILE_END_FRAME() Profiler::getInstance().endFrame()
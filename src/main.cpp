@@ -1,30 +1,91 @@
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_vulkan.h>
 #include <iostream>
+#include <fstream>
 #include <chrono>
 #include <thread>
+#include <string>
+#include <cstdlib>
+#include <algorithm>
+#include <memory>
+#include <future>
+#include <optional>
+#include <random>
 
 #include "vulkan_renderer.h"
+#include "benchmark_runner.h"
+#include "cpu_simulation_runner.h"
+#include "render_thread.h"
 #include "ecs/utilities/debug.h"
 #include <flecs.h>
 #include "ecs/core/entity_factory.h"
 #include "ecs/systems/lifetime_system.h"
 #include "ecs/components/component.h"
 #include "ecs/utilities/profiler.h"
+#include "ecs/utilities/job_system.h"
+#include "ecs/utilities/logger.h"
+#include "ecs/utilities/memory_tags.h"
+#include "ecs/utilities/constants.h"
 #include "ecs/gpu/gpu_entity_manager.h"
+#include "ecs/gpu/entity_stream_schema.h"
+#include "vulkan/monitoring/metrics_exporter.h"
+#include "vulkan/services/video_recorder.h"
 
 // New service-based architecture includes
 #include "ecs/core/world_manager.h"
 #include "ecs/core/service_locator.h"
 #include "ecs/services/input_service.h"
+#include "ecs/services/input/input_lockstep.h"
 #include "ecs/services/camera_service.h"
 #include "ecs/services/rendering_service.h"
+#include "ecs/services/spatial_query_service.h"
 // TESTING RENAMED CONTROL SERVICE
 #include "ecs/services/control_service.h"
 
 int main(int argc, char* argv[]) {
     constexpr int TARGET_FPS = 60;
     constexpr float TARGET_FRAME_TIME = 1000.0f / TARGET_FPS; // 16.67ms
+    constexpr int BACKGROUND_TICK_RATE = 10;  // Loop rate while the window cannot be seen
+    constexpr float BACKGROUND_FRAME_TIME = 1000.0f / BACKGROUND_TICK_RATE;
+    const auto processStartTime = std::chrono::steady_clock::now();
+    auto millisecondsSince = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - start).count();
+    };
+    
+    // Flecs allocations are charged to MemoryTag::ECS, so the hooks go in before any world exists
+    MemoryTags::installFlecsAllocator();
+    
+    // --write-entity-schema PATH: writes the entity_streams.glsl EntityStreamSchema generates and exits
+    // (the entity-schema build target), before anything starts up
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--write-entity-schema") {
+            std::ofstream out(argv[i + 1]);
+            EntityStreamSchema::writeGlsl(out);
+            std::cout << "Wrote entity stream schema to " << argv[i + 1] << std::endl;
+            return out ? 0 : 1;
+        }
+    }
+    if (!EntityStreamSchema::isGlslCurrent()) {
+        std::cerr << "src/shaders/entity_streams.glsl does not match EntityStreamSchema: build the entity-schema target, "
+                     "then ./compile-shaders.sh" << std::endl;
+    }
+    
+    // --job-workers N: JobSystem workers behind compiles, staging fills, the Flecs tasks and the CPU simulation
+    // backend, 0 for one per hardware thread less this one. Up before anything that queues jobs
+    uint32_t jobWorkers = SystemConstants::JOB_WORKER_THREADS;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--job-workers") {
+            jobWorkers = static_cast<uint32_t>(std::max(0, std::atoi(argv[i + 1])));
+        }
+    }
+    JobSystem::getInstance().initialize(jobWorkers);
+    
+    // --cpu-simulation: headless run on the CPU simulation backend, without SDL or a Vulkan device. Also the
+    // fallback when no Vulkan device can be used
+    const CpuSimulationRunner::Options cpuSimulationOptions = CpuSimulationRunner::parseArguments(argc, argv);
+    if (cpuSimulationOptions.enabled) {
+        return CpuSimulationRunner::run(cpuSimulationOptions);
+    }
     
     // Set SDL vsync hint to 0 for safety (ignored with pure Vulkan, but good practice)
     SDL_SetHint(SDL_HINT_RENDER_VSYNC, "0");
@@ -41,13 +102,17 @@ int main(int argc, char* argv[]) {
         std::cerr << "Vulkan is not supported or no Vulkan extensions available" << std::endl;
         std::cerr << "Make sure Vulkan drivers are installed" << std::endl;
         SDL_Quit();
-        return -1;
+        std::cerr << "Running the CPU simulation backend instead" << std::endl;
+        return CpuSimulationRunner::run(cpuSimulationOptions);
     }
     
+    // --bench: scripted entity ramp in a hidden window, no frame cap, results written on exit
+    const BenchmarkRunner::Options benchOptions = BenchmarkRunner::parseArguments(argc, argv);
+    
     SDL_Window* window = SDL_CreateWindow(
         "Fractalia2 - SDL3 + Vulkan + Flecs",
         800, 600,
-        SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE
+        SDL_WINDOW_VULKAN | (benchOptions.enabled ? SDL_WINDOW_HIDDEN : SDL_WINDOW_RESIZABLE)
     );
 
     if (!window) {
@@ -57,28 +122,276 @@ int main(int argc, char* argv[]) {
     }
     
     VulkanRenderer renderer;
-    if (!renderer.initialize(window)) {
-        std::cerr << "Failed to initialize Vulkan renderer" << std::endl;
-        SDL_DestroyWindow(window);
-        SDL_Quit();
-        return -1;
+    
+    // --frames-in-flight N: 2 for interactive latency, 3 for throughput on heavy scenes
+    // --fps N: frame rate limit, 0 for uncapped (benchmarks always run uncapped)
+    // --sim-rate N: movement and physics ticks per second, 0 for one variable-length tick per frame
+    // --fast-forward SECONDS [--fast-forward-ticks K]: runs that much simulation unpaced and undrawn at startup,
+    //     K ticks (default 16, at most 64) per compute submission, then continues in real time
+    // --msaa N / --render-scale S: MSAA samples (1, 2, 4, 8) and internal resolution scale, also F4/F5 at runtime
+    // --present-policy low-latency|power-saver|max-fps: present mode, swapchain images and frames in flight, F6 at runtime
+    // --gpu NAME|UUID: device by name substring or UUID instead of the highest ranked one (also FRACTALIA_GPU)
+    // --simulation-gpu NAME|UUID|auto: runs the simulation on a second GPU of the rendering GPU's device group
+    // --export-positions MANIFEST: exports the published position snapshots and a timeline semaphore to a consumer
+    //     process on the same GPU, whose handles and layout MANIFEST describes
+    // --record PATH: records the presented frames, H.264 with Vulkan Video encode (--record-gop N IDR interval,
+    //     --record-qp N), Y4M otherwise or piped into --record-encoder "COMMAND"
+    // --target-frame-ms X / --no-quality-governor: frame time the quality governor holds (default the --fps period),
+    //     or no governor, so the quality settings apply unchanged (always off for benchmarks)
+    // --output-windows N: N more windows (at most MAX_OUTPUT_WINDOWS) forming a display wall, side by side, that
+    //     continues the main camera's view across them; drawn from the same simulation, presented with the main window
+    renderer.setFrameRateLimit(benchOptions.enabled ? 0 : DEFAULT_FRAME_RATE_LIMIT);
+    uint32_t msaaSamples = DEFAULT_MSAA_SAMPLES;
+    float renderScale = DEFAULT_RENDER_SCALE;
+    PresentPolicy presentPolicy = DEFAULT_PRESENT_POLICY;
+    bool qualityGovernor = ENABLE_QUALITY_GOVERNOR && !benchOptions.enabled;
+    bool lockstepRequested = false;
+    float fastForwardSeconds = 0.0f;
+    uint32_t fastForwardTicks = SIMULATION_FAST_FORWARD_TICKS_PER_FRAME;
+    RecordingOptions recordingOptions;
+    uint32_t outputWindowCount = 0;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--no-quality-governor") {
+            qualityGovernor = false;
+        } else if ((std::string(argv[i]) == "--lockstep-lead" || std::string(argv[i]) == "--lockstep-follow") &&
+                   !benchOptions.enabled) {
+            // The governor steps the collision stride and idle speed from this machine's frame times
+            qualityGovernor = false;
+            lockstepRequested = true;
+        } else if (std::string(argv[i]) == "--target-frame-ms" && i + 1 < argc) {
+            renderer.setTargetFrameTime(std::max(1.0f, static_cast<float>(std::atof(argv[i + 1]))));
+        }
     }
-
-    // Initialize service-based architecture with proper priorities
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--frames-in-flight") {
+            renderer.setFramesInFlight(static_cast<uint32_t>(std::max(0, std::atoi(argv[i + 1]))));
+        } else if (std::string(argv[i]) == "--fps" && !benchOptions.enabled) {
+            renderer.setFrameRateLimit(static_cast<uint32_t>(std::max(0, std::atoi(argv[i + 1]))));
+        } else if (std::string(argv[i]) == "--sim-rate") {
+            renderer.setSimulationTickRate(static_cast<uint32_t>(std::max(0, std::atoi(argv[i + 1]))));
+        } else if (std::string(argv[i]) == "--fast-forward") {
+            fastForwardSeconds = static_cast<float>(std::atof(argv[i + 1]));
+        } else if (std::string(argv[i]) == "--fast-forward-ticks") {
+            fastForwardTicks = static_cast<uint32_t>(std::max(1, std::atoi(argv[i + 1])));
+        } else if (std::string(argv[i]) == "--msaa") {
+            msaaSamples = static_cast<uint32_t>(std::max(1, std::atoi(argv[i + 1])));
+        } else if (std::string(argv[i]) == "--render-scale") {
+            renderScale = static_cast<float>(std::atof(argv[i + 1]));
+        } else if (std::string(argv[i]) == "--gpu") {
+            renderer.setPreferredDevice(argv[i + 1]);
+        } else if (std::string(argv[i]) == "--simulation-gpu") {
+            renderer.setSimulationDevice(argv[i + 1]);
+        } else if (std::string(argv[i]) == "--export-positions") {
+            renderer.setPositionExport(argv[i + 1]);
+        } else if (std::string(argv[i]) == "--record") {
+            recordingOptions.path = argv[i + 1];
+        } else if (std::string(argv[i]) == "--record-gop") {
+            recordingOptions.gopFrames = static_cast<uint32_t>(std::max(1, std::atoi(argv[i + 1])));
+        } else if (std::string(argv[i]) == "--record-qp") {
+            recordingOptions.qp = static_cast<uint32_t>(std::clamp(std::atoi(argv[i + 1]), 0, 51));
+        } else if (std::string(argv[i]) == "--record-encoder") {
+            recordingOptions.encoderCommand = argv[i + 1];
+        } else if (std::string(argv[i]) == "--present-policy") {
+            const std::string policy(argv[i + 1]);
+            if (policy == "low-latency") {
+                presentPolicy = PresentPolicy::LowLatency;
+            } else if (policy == "power-saver") {
+                presentPolicy = PresentPolicy::PowerSaver;
+            } else if (policy == "max-fps") {
+                presentPolicy = PresentPolicy::TearFreeMaxFps;
+            } else {
+                std::cerr << "Unknown present policy '" << policy << "', using max-fps" << std::endl;
+            }
+        } else if (std::string(argv[i]) == "--output-windows" && !benchOptions.enabled) {
+            outputWindowCount = std::min(static_cast<uint32_t>(std::max(0, std::atoi(argv[i + 1]))), MAX_OUTPUT_WINDOWS);
+        }
+    }
+    std::vector<SDL_Window*> outputWindows;
+    for (uint32_t output = 0; output < outputWindowCount; ++output) {
+        const std::string title = "Fractalia2 - Output " + std::to_string(output + 1);
+        SDL_Window* outputWindow = SDL_CreateWindow(title.c_str(), 800, 600, SDL_WINDOW_VULKAN | SDL_WINDOW_RESIZABLE);
+        if (!outputWindow) {
+            std::cerr << "Failed to create output window: " << SDL_GetError() << std::endl;
+            break;
+        }
+        outputWindows.push_back(outputWindow);
+        renderer.addOutputWindow(outputWindow);
+    }
+    renderer.setRenderQuality(msaaSamples, renderScale);
+    renderer.setPresentPolicy(presentPolicy);
+    renderer.setQualityGovernorEnabled(qualityGovernor);
+    if (!recordingOptions.path.empty()) {
+        renderer.setRecording(recordingOptions);
+    }
+    
+    // --no-collisions: physics kernels specialized without the collision pass, also F7 at runtime
+    // --cell-capacity N: neighbours tested per spatial grid cell (default 64, the tiled kernel caps it at 128)
+    // --collision-stride N: narrow phase for one in N entities per tick (default 1), 0 to adapt it to GPU time
+    // --no-sleeping: stationary entities stay in every physics dispatch instead of sleeping until moved
+    // --closed-form-movement: physics evaluates every entity's random walk velocity instead of a movement pass storing it
+    ComputeShaderFeatures shaderFeatures;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--closed-form-movement") {
+            renderer.setClosedFormMovement(true);
+        } else if (std::string(argv[i]) == "--no-collisions") {
+            shaderFeatures.flags &= ~ComputeShaderFeatures::COLLISIONS;
+        } else if (std::string(argv[i]) == "--no-sleeping") {
+            shaderFeatures.flags &= ~ComputeShaderFeatures::SLEEPING;
+        } else if (std::string(argv[i]) == "--cell-capacity" && i + 1 < argc) {
+            shaderFeatures.maxEntitiesPerCell = static_cast<uint32_t>(std::max(1, std::atoi(argv[i + 1])));
+        } else if (std::string(argv[i]) == "--collision-stride" && i + 1 < argc) {
+            shaderFeatures.collisionStride = static_cast<uint32_t>(std::clamp(std::atoi(argv[i + 1]), 0, int(PHYSICS_MAX_COLLISION_STRIDE)));
+        }
+    }
+    renderer.setComputeShaderFeatures(shaderFeatures);
+    
+    // Initialize service-based architecture with proper priorities. Benchmarks take no keyboard or mouse control
+    // and pick nothing, so their profile leaves out the control and spatial query services along with the
+    // interactive-only world modules
+    const WorldProfile worldProfile = benchOptions.enabled ? WorldProfile::Bench : WorldProfile::Interactive;
+    const bool interactive = worldProfile == WorldProfile::Interactive;
     auto& serviceLocator = ServiceLocator::instance();
     
     auto worldManager = serviceLocator.createAndRegister<WorldManager>("WorldManager", 100);
     auto inputService = serviceLocator.createAndRegister<InputService>("InputService", 90);
     auto cameraService = serviceLocator.createAndRegister<CameraService>("CameraService", 80);
     auto renderingService = serviceLocator.createAndRegister<RenderingService>("RenderingService", 70);
-    // TESTING RENAMED CONTROL SERVICE
-    auto controlService = serviceLocator.createAndRegister<GameControlService>("GameControlService", 60);
+    std::shared_ptr<SpatialQueryService> spatialQueryService;
+    std::shared_ptr<GameControlService> controlService;
+    if (interactive) {
+        spatialQueryService = serviceLocator.createAndRegister<SpatialQueryService>("SpatialQueryService", 65);
+        controlService = serviceLocator.createAndRegister<GameControlService>("GameControlService", 60);
+    }
+    
+    // --ecs-threads N: Flecs threads for multi_threaded systems, 0 for the JobSystem's workers plus this thread
+    // --ecs-dedicated-threads: Flecs' own threads, kept waiting between frames, instead of JobSystem tasks
+    uint32_t ecsThreads = SystemConstants::ECS_WORKER_THREADS;
+    bool ecsTaskThreads = true;
+    bool ecsThreadsOverridden = false;
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--ecs-threads" && i + 1 < argc) {
+            ecsThreads = static_cast<uint32_t>(std::max(0, std::atoi(argv[++i])));
+            ecsThreadsOverridden = true;
+        } else if (std::string(argv[i]) == "--ecs-dedicated-threads") {
+            ecsTaskThreads = false;
+            ecsThreadsOverridden = true;
+        }
+    }
     
-    // Initialize world manager first to get the world reference
-    if (!worldManager->initialize()) {
+    // The Flecs world shares nothing with the renderer, so its setup runs as a job while this thread creates
+    // the device, swapchain, pipelines and entity buffers. SDL input stays here
+    float worldSetupMs = 0.0f;
+    std::future<bool> worldSetup = JobSystem::getInstance().async(JobPriority::High, [&]() {
+        const auto setupStart = std::chrono::steady_clock::now();
+        const bool initialized = worldManager->initialize(worldProfile);
+        if (initialized && ecsThreadsOverridden) {
+            worldManager->setThreadCount(ecsThreads, ecsTaskThreads);
+        }
+        worldSetupMs = millisecondsSince(setupStart);
+        return initialized;
+    });
+    
+    const auto rendererStartTime = std::chrono::steady_clock::now();
+    if (!renderer.initialize(window)) {
+        std::cerr << "Failed to initialize Vulkan renderer" << std::endl;
+        JobSystem::getInstance().waitFor(worldSetup, JobPriority::High);
+        serviceLocator.clear();
+        for (SDL_Window* outputWindow : outputWindows) {
+            SDL_DestroyWindow(outputWindow);
+        }
+        SDL_DestroyWindow(window);
+        SDL_Quit();
+        if (renderer.isDeviceUnavailable() && !benchOptions.enabled) {
+            std::cerr << "No usable Vulkan device, running the CPU simulation backend instead" << std::endl;
+            return CpuSimulationRunner::run(cpuSimulationOptions);
+        }
+        return -1;
+    }
+    const float rendererSetupMs = millisecondsSince(rendererStartTime);
+    
+    // --position-mirror N: CPU copy of the entity positions swept every N frames, for CPU-side spatial queries
+    // --cell-order morton|rows: spatial grid cell order; morton keeps dense swarms in one run of the sorted index
+    // --telemetry-capture <path>: stream entity SoA data to path every --telemetry-interval N frames (default 10);
+    //     --telemetry-streams picks them from p(osition), v(elocity), s(tate), i(d), default "pv"
+    // --metrics-port N: Prometheus /metrics on port N; --statsd host[:port]: StatsD push every --statsd-interval ms
+    // --stream-port N: stream entity positions to remote viewers over UDP every --stream-interval N frames
+    //     (default 3), at most --stream-budget KB per viewer and snapshot (default 64)
+    std::string telemetryCapturePath;
+    uint32_t telemetryInterval = 10;
+    uint32_t telemetryStreams = EntityTelemetryCapture::POSITION | EntityTelemetryCapture::VELOCITY;
+    MetricsExportOptions metricsOptions;
+    uint16_t streamPort = 0;
+    uint32_t streamInterval = 3;
+    uint32_t streamBudgetKb = 64;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--position-mirror" && renderer.getGPUEntityManager()) {
+            renderer.getGPUEntityManager()->getPositionMirror().setRefreshInterval(
+                static_cast<uint32_t>(std::max(0, std::atoi(argv[i + 1]))));
+        } else if (std::string(argv[i]) == "--cell-order" && renderer.getGPUEntityManager()) {
+            renderer.getGPUEntityManager()->getBufferManager().setSpatialCellOrder(
+                std::string(argv[i + 1]) == "morton" ? SpatialCellOrder::Morton : SpatialCellOrder::RowMajor);
+        } else if (std::string(argv[i]) == "--telemetry-capture") {
+            telemetryCapturePath = argv[i + 1];
+        } else if (std::string(argv[i]) == "--telemetry-interval") {
+            telemetryInterval = static_cast<uint32_t>(std::max(1, std::atoi(argv[i + 1])));
+        } else if (std::string(argv[i]) == "--telemetry-streams") {
+            const std::string selection(argv[i + 1]);
+            telemetryStreams = 0;
+            if (selection.find('p') != std::string::npos) telemetryStreams |= EntityTelemetryCapture::POSITION;
+            if (selection.find('v') != std::string::npos) telemetryStreams |= EntityTelemetryCapture::VELOCITY;
+            if (selection.find('s') != std::string::npos) telemetryStreams |= EntityTelemetryCapture::RUNTIME_STATE;
+            if (selection.find('i') != std::string::npos) telemetryStreams |= EntityTelemetryCapture::SPAWN_ID;
+        } else if (std::string(argv[i]) == "--metrics-port") {
+            metricsOptions.httpPort = static_cast<uint16_t>(std::clamp(std::atoi(argv[i + 1]), 0, 65535));
+        } else if (std::string(argv[i]) == "--statsd") {
+            const std::string target(argv[i + 1]);
+            const size_t colon = target.rfind(':');
+            metricsOptions.statsdHost = target.substr(0, colon);
+            if (colon != std::string::npos) {
+                metricsOptions.statsdPort = static_cast<uint16_t>(std::clamp(std::atoi(target.c_str() + colon + 1), 1, 65535));
+            }
+        } else if (std::string(argv[i]) == "--statsd-interval") {
+            metricsOptions.statsdIntervalMs = static_cast<uint32_t>(std::max(10, std::atoi(argv[i + 1])));
+        } else if (std::string(argv[i]) == "--stream-port") {
+            streamPort = static_cast<uint16_t>(std::clamp(std::atoi(argv[i + 1]), 0, 65535));
+        } else if (std::string(argv[i]) == "--stream-interval") {
+            streamInterval = static_cast<uint32_t>(std::max(1, std::atoi(argv[i + 1])));
+        } else if (std::string(argv[i]) == "--stream-budget") {
+            streamBudgetKb = static_cast<uint32_t>(std::clamp(std::atoi(argv[i + 1]), 1, 16384));
+        }
+    }
+    
+    // --occupancy-histogram: bin the spatial grid's cell occupancy every frame, for metrics and the HUD
+    // --auto-cell-size: tune the spatial grid cell size to the measured cell occupancy (implies the histogram)
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--occupancy-histogram" && renderer.getGPUEntityManager()) {
+            renderer.getGPUEntityManager()->getBufferManager().setOccupancyHistogram(true);
+        } else if (std::string(argv[i]) == "--auto-cell-size" && !lockstepRequested) {
+            renderer.setSpatialCellTuningEnabled(true);
+        }
+    }
+    if (!telemetryCapturePath.empty() && renderer.getGPUEntityManager()) {
+        renderer.getGPUEntityManager()->getBufferManager().startTelemetryCapture(telemetryCapturePath, telemetryStreams, telemetryInterval);
+    }
+    if (streamPort != 0 && renderer.getGPUEntityManager()) {
+        renderer.getGPUEntityManager()->getBufferManager().startEntityStream(streamPort, streamInterval, streamBudgetKb * 1024);
+    }
+    if (metricsOptions.httpPort != 0 || !metricsOptions.statsdHost.empty()) {
+        renderer.startMetricsExport(metricsOptions);
+    }
+
+    // World manager comes first in the service order, so everything below waits for its setup
+    JobSystem::getInstance().waitFor(worldSetup, JobPriority::High);
+    if (!worldSetup.get()) {
         std::cerr << "Failed to initialize WorldManager" << std::endl;
         return -1;
     }
+    std::cout << "WorldManager: " << worldManager->getThreadCount()
+              << (worldManager->usesTaskThreads() ? " task" : " worker") << " threads, modules:";
+    for (const std::string& module : worldManager->getLoadedModules()) {
+        std::cout << " " << module;
+    }
+    std::cout << std::endl;
     
     // Create EntityFactory early as it's needed by ControlService
     flecs::world& world = worldManager->getWorld();
@@ -88,8 +401,9 @@ int main(int argc, char* argv[]) {
     serviceLocator.declareDependencies<InputService, WorldManager>();
     serviceLocator.declareDependencies<CameraService, WorldManager>();
     serviceLocator.declareDependencies<RenderingService, WorldManager>();
-    // RESTORED WITH NEW NAME
-    serviceLocator.declareDependencies<GameControlService, WorldManager, InputService, CameraService, RenderingService>();
+    if (controlService) {
+        serviceLocator.declareDependencies<GameControlService, WorldManager, InputService, CameraService, RenderingService>();
+    }
     
     // Validate service dependencies
     if (!serviceLocator.validateDependencies()) {
@@ -120,12 +434,21 @@ int main(int argc, char* argv[]) {
         }
         serviceLocator.setServiceLifecycle<RenderingService>(ServiceLifecycle::INITIALIZED);
         
-        // RESTORED WITH NEW NAME
-        serviceLocator.setServiceLifecycle<GameControlService>(ServiceLifecycle::INITIALIZING);
-        if (!controlService->initialize(worldManager->getWorld(), &renderer, &entityFactory)) {
-            throw std::runtime_error("Failed to initialize GameControlService");
+        if (spatialQueryService) {
+            serviceLocator.setServiceLifecycle<SpatialQueryService>(ServiceLifecycle::INITIALIZING);
+            if (!spatialQueryService->initialize(&renderer)) {
+                throw std::runtime_error("Failed to initialize SpatialQueryService");
+            }
+            serviceLocator.setServiceLifecycle<SpatialQueryService>(ServiceLifecycle::INITIALIZED);
+        }
+        
+        if (controlService) {
+            serviceLocator.setServiceLifecycle<GameControlService>(ServiceLifecycle::INITIALIZING);
+            if (!controlService->initialize(worldManager->getWorld(), &renderer, &entityFactory)) {
+                throw std::runtime_error("Failed to initialize GameControlService");
+            }
+            serviceLocator.setServiceLifecycle<GameControlService>(ServiceLifecycle::INITIALIZED);
         }
-        serviceLocator.setServiceLifecycle<GameControlService>(ServiceLifecycle::INITIALIZED);
         
         // Final service validation
         if (!serviceLocator.initializeAllServices()) {
@@ -135,43 +458,339 @@ int main(int argc, char* argv[]) {
         DEBUG_LOG("All services initialized successfully");
         serviceLocator.printServiceStatus();
         
+        // Nothing registers after startup, so lookups from here on skip the registry lock
+        serviceLocator.freeze();
+        
     } catch (const std::exception& e) {
         std::cerr << "Service initialization error: " << e.what() << std::endl;
         serviceLocator.clear();
         return -1;
     }
     
-    // Simple system registration - no complex scheduling needed
-    world.system<Lifetime>("LifetimeSystem")
-        .each(lifetime_system);
+    // Expired entities reach the GPU despawn queue as one batch per frame. Every profile needs it, so declaring
+    // it loads it
+    GPUEntityManager* lifetimeGpuManager = renderer.getGPUEntityManager();
+    worldManager->declareModule("lifetime", {}, ALL_WORLD_PROFILES, [lifetimeGpuManager]() {
+        return std::make_shared<SystemModule>("lifetime", [lifetimeGpuManager](flecs::world& moduleWorld) {
+            LifetimeSystem::registerSystems(moduleWorld, lifetimeGpuManager);
+        });
+    });
     
     DEBUG_LOG("Camera entities: " << world.count<Camera>());
     
     renderer.setWorld(&world);
     
     Profiler::getInstance().setTargetFrameTime(TARGET_FRAME_TIME);
-
-    constexpr size_t ENTITY_COUNT = 10;
+    Profiler::getInstance().setThreadName("Main");
+    
+    // --profile-trace <path>: CPU zones and GPU node timings for the whole run, as a Chrome trace at exit
+    std::string profileTracePath;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--profile-trace") {
+            profileTracePath = argv[i + 1];
+            Profiler::getInstance().startTraceCapture();
+            break;
+        }
+    }
     
-    DEBUG_LOG("Creating " << ENTITY_COUNT << " GPU entities for stress testing...");
+    // --frame-graph-export <path>: the compiled schedule with the run's last node timings, at exit (.dot Graphviz,
+    // otherwise JSON)
+    std::string frameGraphExportPath;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--frame-graph-export") {
+            frameGraphExportPath = argv[i + 1];
+            break;
+        }
+    }
+
+    const float startupMs = millisecondsSince(processStartTime);
+    std::cout << "Startup: " << startupMs << "ms to the main loop (renderer " << rendererSetupMs << "ms, world "
+              << worldSetupMs << "ms alongside it)" << std::endl;
     
-    auto swarmEntities = entityFactory.createSwarm(
-        ENTITY_COUNT,
-        glm::vec3(10.0f, 10.0f, 0.0f),
-        8.0f
-    );
+    // --load-snapshot <path>: start from a saved entity state instead of the default swarm
+    // --save-snapshot <path>: write the entity state at exit
+    // --recovery-snapshot <path>: save it every --recovery-interval N frames (default 600) and restore it after a
+    //     device loss
+    std::string loadSnapshotPath;
+    std::string saveSnapshotPath;
+    std::string recoverySnapshotPath;
+    uint32_t recoveryInterval = 600;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--load-snapshot") {
+            loadSnapshotPath = argv[i + 1];
+        } else if (std::string(argv[i]) == "--save-snapshot") {
+            saveSnapshotPath = argv[i + 1];
+        } else if (std::string(argv[i]) == "--recovery-snapshot") {
+            recoverySnapshotPath = argv[i + 1];
+        } else if (std::string(argv[i]) == "--recovery-interval") {
+            recoveryInterval = static_cast<uint32_t>(std::max(1, std::atoi(argv[i + 1])));
+        }
+    }
+    renderer.setRecoverySnapshot(recoverySnapshotPath, recoveryInterval);
     
-    auto* gpuEntityManager = renderer.getGPUEntityManager();
-    gpuEntityManager->addEntitiesFromECS(swarmEntities);
-    gpuEntityManager->uploadPendingEntities();
+    // --record-input <path>: every frame's input events and deltaTime, with the seed, for reproducing a session
+    // --replay-input <path>: feeds a recording back with its deltaTime and seed instead of live input and the
+    //     measured frame time, and ends the run with it (neither applies under --bench)
+    // --seed N: EntityFactory seed for spawn placement and movement patterns, random by default
+    // --lockstep-lead PORT [--lockstep-peers N]: leads a display wall of N more instances (default 1), waiting for
+    //     them at startup; they run this instance's seed and input, and their position hashes are checked against its
+    // --lockstep-follow HOST:PORT: follows that leader, replaying its input and window size instead of live input,
+    //     and ends with it. Both run without the quality governor and --auto-cell-size, and should share --sim-rate
+    std::string recordInputPath;
+    std::string replayInputPath;
+    std::optional<uint32_t> sessionSeed;
+    uint16_t lockstepLeadPort = 0;
+    uint32_t lockstepPeers = 1;
+    std::string lockstepLeader;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--record-input") {
+            recordInputPath = argv[i + 1];
+        } else if (std::string(argv[i]) == "--replay-input") {
+            replayInputPath = argv[i + 1];
+        } else if (std::string(argv[i]) == "--seed") {
+            sessionSeed = static_cast<uint32_t>(std::strtoul(argv[i + 1], nullptr, 10));
+        } else if (std::string(argv[i]) == "--lockstep-lead") {
+            lockstepLeadPort = static_cast<uint16_t>(std::clamp(std::atoi(argv[i + 1]), 0, 65535));
+        } else if (std::string(argv[i]) == "--lockstep-peers") {
+            lockstepPeers = static_cast<uint32_t>(std::max(1, std::atoi(argv[i + 1])));
+        } else if (std::string(argv[i]) == "--lockstep-follow") {
+            lockstepLeader = argv[i + 1];
+        }
+    }
+    LockstepSession lockstep;
+    if (!benchOptions.enabled && !lockstepLeader.empty()) {
+        const size_t colon = lockstepLeader.rfind(':');
+        const int port = colon == std::string::npos ? 0 : std::atoi(lockstepLeader.c_str() + colon + 1);
+        if (port <= 0 || port > 65535 || !lockstep.follow(lockstepLeader.substr(0, colon), static_cast<uint16_t>(port)) ||
+            !inputService->startLockstep(&lockstep)) {
+            std::cerr << "Failed to follow lockstep leader " << lockstepLeader << std::endl;
+            return -1;
+        }
+        sessionSeed = lockstep.getHeader().seed;
+    } else if (!benchOptions.enabled && !replayInputPath.empty()) {
+        if (!inputService->startReplay(replayInputPath)) {
+            std::cerr << "Failed to load input recording " << replayInputPath << std::endl;
+            return -1;
+        }
+        sessionSeed = inputService->getReplayHeader()->seed;
+    } else if (!benchOptions.enabled && !recordInputPath.empty()) {
+        if (!sessionSeed) {
+            sessionSeed = std::random_device{}();
+        }
+        inputService->startRecording(recordInputPath, *sessionSeed);
+    }
+    if (!benchOptions.enabled && lockstepLeadPort != 0 && !lockstep.isActive() && !inputService->isReplaying()) {
+        if (!sessionSeed) {
+            sessionSeed = std::random_device{}();
+        }
+        InputRecordingHeader header;
+        header.seed = *sessionSeed;
+        SDL_GetWindowSize(window, &header.windowWidth, &header.windowHeight);
+        if (!lockstep.lead(lockstepLeadPort, lockstepPeers, header) || !inputService->startLockstep(&lockstep)) {
+            std::cerr << "Failed to lead lockstep session on port " << lockstepLeadPort << std::endl;
+            return -1;
+        }
+    }
+    if (sessionSeed) {
+        entityFactory.seed(*sessionSeed);
+    }
     
-    DEBUG_LOG("Created " << swarmEntities.size() << " GPU entities!");
+    std::unique_ptr<BenchmarkRunner> benchmark;
+    if (benchOptions.enabled) {
+        benchmark = std::make_unique<BenchmarkRunner>(benchOptions, renderer, entityFactory);
+    } else if (!loadSnapshotPath.empty() && renderer.loadEntitySnapshot(loadSnapshotPath)) {
+        DEBUG_LOG("Restored GPU entities from " << loadSnapshotPath);
+    } else {
+        constexpr size_t ENTITY_COUNT = 10;
+        
+        DEBUG_LOG("Creating " << ENTITY_COUNT << " GPU entities for stress testing...");
+        
+        auto* gpuEntityManager = renderer.getGPUEntityManager();
+        std::vector<flecs::entity> swarmEntities;
+        if (SystemConstants::GPU_RESIDENT_SWARMS) {
+            SwarmSpawn spawn;
+            swarmEntities = entityFactory.createResidentSwarm(ENTITY_COUNT, glm::vec3(10.0f, 10.0f, 0.0f), 8.0f,
+                                                              MovementType::RandomWalk, spawn);
+            gpuEntityManager->addResidentEntities(swarmEntities, spawn.transforms, spawn.renderables, spawn.patterns);
+        } else {
+            swarmEntities = entityFactory.createSwarm(ENTITY_COUNT, glm::vec3(10.0f, 10.0f, 0.0f), 8.0f);
+            gpuEntityManager->addEntitiesFromECS(swarmEntities);
+        }
+        gpuEntityManager->uploadPendingEntities();
+        
+        DEBUG_LOG("Created " << swarmEntities.size() << " GPU entities!");
+    }
     DEBUG_LOG("Total services active: " << ServiceLocator::instance().getServiceCount());
     
     bool running = true;
     
     DEBUG_LOG("\n🚀 Service-based architecture ready\n");
     int frameCount = 0;
+    
+    // --render-thread: frames are recorded and submitted on a second thread while the next one is simulated
+    // (benchmarks keep the sequential loop so their CPU frame times stay comparable)
+    std::unique_ptr<RenderThread> renderThread;
+    for (int i = 1; i < argc && !benchOptions.enabled; ++i) {
+        if (std::string(argv[i]) == "--render-thread") {
+            renderThread = std::make_unique<RenderThread>(renderer);
+            if (!renderThread->start()) {
+                renderThread.reset();
+            }
+            break;
+        }
+    }
+    
+    // --background pause|simulate: while the window is minimized, hidden or occluded, either stop the loop until
+    // an event arrives or keep simulating at BACKGROUND_TICK_RATE with compute-only frames (the default).
+    // Benchmarks run in a hidden window and are never throttled
+    // (recordings, replays and lockstep sessions always simulate, so every run sees the same frames)
+    bool pauseInBackground = false;
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--background") {
+            pauseInBackground = std::string(argv[i + 1]) == "pause" && !inputService->isRecording() &&
+                                !inputService->isReplaying() && !lockstep.isActive();
+        }
+    }
+    bool windowHidden = false;
+    
+    // --no-camera-latch: frames draw the camera they were prepared with instead of the newest one at submit
+    // --camera-prediction MS: late-latched cameras extrapolated MS past the submit (at most 50), 0 = off
+    for (int i = 1; i < argc; ++i) {
+        if (std::string(argv[i]) == "--no-camera-latch") {
+            renderer.getCameraLatch().setEnabled(false);
+        } else if (std::string(argv[i]) == "--camera-prediction" && i + 1 < argc) {
+            renderer.getCameraLatch().setPredictionLead(static_cast<float>(std::atof(argv[i + 1])) / 1000.0f);
+        }
+    }
+    
+    // --hitch-factor K: frames over K times the median frame time are reported as hitches (default 2.5)
+    for (int i = 1; i + 1 < argc; ++i) {
+        if (std::string(argv[i]) == "--hitch-factor") {
+            Profiler::getInstance().setHitchFactor(static_cast<float>(std::atof(argv[i + 1])));
+        }
+    }
+    
+    auto logFrameTelemetry = [&]() {
+        float avgFrameTime = Profiler::getInstance().getFrameTime();
+        size_t activeEntities = static_cast<size_t>(world.count<Transform>());
+        const MemoryTags::Report heap = MemoryTags::getReport();
+        
+        Profiler::getInstance().updateMemoryUsage(heap.currentBytes);
+        
+        float fps = avgFrameTime > 0.0f ? (1000.0f / avgFrameTime) : 0.0f;
+        const FramePacer::Telemetry& pacing = renderer.getFramePacer().getTelemetry();
+        const SimulationClock::Telemetry& simulation = renderer.getSimulationClock().getTelemetry();
+        std::cout << "Frame " << frameCount 
+                  << ": Avg " << avgFrameTime << "ms"
+                  << " (" << fps << " FPS)"
+                  << " | Interval " << pacing.getAverageIntervalMs() << "ms +/- " << pacing.getIntervalJitterMs()
+                  << "ms, max " << pacing.maxIntervalMs << "ms, " << pacing.missedDeadlines << " missed"
+                  << " | Sim ticks: " << simulation.ticks << " (" << simulation.droppedTicks << " dropped, "
+                  << simulation.fastForwardTicks << " fast-forwarded)"
+                  << " | Entities: " << activeEntities
+                  << " | CPU Heap: " << (heap.currentBytes / 1024) << "KB (";
+        for (size_t tag = 0; tag < MEMORY_TAG_COUNT; ++tag) {
+            std::cout << (tag > 0 ? ", " : "") << getMemoryTagName(static_cast<MemoryTag>(tag)) << " "
+                      << (heap.tags[tag].currentBytes / 1024) << "KB";
+        }
+        std::cout << ")";
+        const HitchSummary hitches = Profiler::getInstance().takeHitchSummary();
+        if (hitches.hitches > 0) {
+            std::cout << " | Hitches: " << hitches.hitches << ", worst " << hitches.worstFrameTime << "ms (";
+            for (size_t cause = 0; cause < HITCH_CAUSE_COUNT; ++cause) {
+                if (hitches.framesWithCause[cause] > 0) {
+                    std::cout << getHitchCauseName(static_cast<HitchCause>(cause)) << " " << hitches.framesWithCause[cause] << ", ";
+                }
+            }
+            std::cout << hitches.unattributed << " unattributed)";
+        }
+        if (renderThread) {
+            const RenderThread::Telemetry& handoff = renderThread->getTelemetry();
+            std::cout << " | Render wait " << handoff.getAverageWaitMs() << "ms, max " << handoff.maxWaitMs << "ms";
+            renderThread->resetTelemetry();
+        }
+        std::cout << std::endl;
+        renderer.resetPacingTelemetry();
+        renderer.resetSimulationTelemetry();
+        
+        const auto systemTimings = worldManager->getSystemTimings();
+        if (!systemTimings.empty()) {
+            std::cout << "ECS systems:";
+            for (const auto& timing : systemTimings) {
+                std::cout << " " << timing.name << " " << timing.averageMs << "ms";
+            }
+            std::cout << std::endl;
+        }
+    };
+    
+    // A camera's view of rect, predicted aheadSeconds past the last camera update unless that is 0
+    auto makeViewportCamera = [&](const glm::vec4& rect, CameraID cameraID, float aheadSeconds) -> ViewportCamera {
+        if (aheadSeconds <= 0.0f) {
+            return {rect, cameraService->getViewMatrix(cameraID), cameraService->getProjectionMatrix(cameraID),
+                    cameraService->getViewProjectionMatrix(cameraID)};
+        }
+        const Camera predicted = cameraService->predictCamera(cameraID, aheadSeconds);
+        return {rect, predicted.getViewMatrix(), predicted.getProjectionMatrix(),
+                predicted.getProjectionMatrix() * predicted.getViewMatrix()};
+    };
+    
+    // Active CameraService viewports by render order (name breaks ties), each with its own camera's matrices
+    std::vector<ViewportCamera> viewportCameras;
+    auto collectViewportCameras = [&](float aheadSeconds) -> const std::vector<ViewportCamera>& {
+        auto viewports = cameraService->getActiveViewports();
+        std::sort(viewports.begin(), viewports.end(), [](const Viewport* a, const Viewport* b) {
+            return a->renderOrder != b->renderOrder ? a->renderOrder < b->renderOrder : a->name < b->name;
+        });
+        
+        viewportCameras.clear();
+        for (const Viewport* viewport : viewports) {
+            if (viewportCameras.size() == MAX_RENDER_VIEWPORTS) break;
+            viewportCameras.push_back(makeViewportCamera(glm::vec4(viewport->offset, viewport->size), viewport->cameraID, aheadSeconds));
+        }
+        return viewportCameras;
+    };
+    uint64_t sentCameraVersion = 0;  // CameraService version the renderer last got matrices for
+    
+    // The views the renderer draws (one full-screen view without viewports), published to the late latch right
+    // after the camera update, so a frame already being recorded on the render thread still picks them up
+    std::vector<ViewportCamera> latchedViews;
+    std::vector<ViewportCamera> predictedViews;
+    uint64_t latchedCameraVersion = 0;
+    auto publishLatchedCamera = [&](std::chrono::steady_clock::time_point sampleTime) {
+        CameraLatch& latch = renderer.getCameraLatch();
+        if (!latch.isEnabled() || (cameraService->getCameraVersion() == latchedCameraVersion && !latch.isPredicting())) {
+            return;
+        }
+        auto collectLatchViews = [&](std::vector<ViewportCamera>& views, float aheadSeconds) {
+            views = collectViewportCameras(aheadSeconds);
+            if (views.empty()) {
+                views.push_back(makeViewportCamera(glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), 0, aheadSeconds));
+            }
+        };
+        collectLatchViews(latchedViews, 0.0f);
+        predictedViews.clear();
+        if (latch.isPredicting()) {
+            collectLatchViews(predictedViews, CameraLatch::PREDICTION_SPAN_SECONDS);
+        }
+        latch.publish(latchedViews, predictedViews, sampleTime);
+        latchedCameraVersion = cameraService->getCameraVersion();
+    };
+    
+    // Time to first frame: process start until the first frame has been recorded and submitted
+    auto reportFirstFrame = [&]() {
+        const float timeToFirstFrameMs = millisecondsSince(processStartTime);
+        std::cout << "Startup: first frame after " << timeToFirstFrameMs << "ms" << std::endl;
+        if (benchmark) {
+            benchmark->setTimeToFirstFrame(timeToFirstFrameMs);
+        }
+    };
+    
+    // Benchmarks time paced, drawn frames, so they never fast-forward
+    if (fastForwardSeconds > 0.0f && !benchmark) {
+        renderer.fastForwardSimulation(fastForwardSeconds, fastForwardTicks);
+        std::cout << "Fast-forwarding " << fastForwardSeconds << "s of simulation, " << fastForwardTicks << " ticks per frame" << std::endl;
+    }
+    
     auto lastFrameTime = std::chrono::high_resolution_clock::now();
     
     while (running) {
@@ -179,9 +798,45 @@ int main(int argc, char* argv[]) {
         float deltaTime = std::chrono::duration<float>(frameStartTime - lastFrameTime).count();
         lastFrameTime = frameStartTime;
         
-        deltaTime = std::min(deltaTime, 1.0f / 30.0f);
+        // Only guards the simulation against stalls (growth, window drags); slow frames still advance in real time
+        constexpr float MAX_FRAME_DELTA = 0.1f;
+        deltaTime = std::min(deltaTime, MAX_FRAME_DELTA);
+        
+        // Fixed timestep, so every run simulates the same frames
+        if (benchmark) {
+            deltaTime = benchmark->getDeltaTime();
+            benchmark->beginFrame();
+        }
+        
+        // Under a replay the recorded frame's deltaTime, and the run ends with the recording
+        deltaTime = inputService->resolveFrameDeltaTime(deltaTime);
+        if (inputService->isReplayFinished()) {
+            std::cout << "Input replay finished after " << frameCount << " frames" << std::endl;
+            running = false;
+            continue;
+        }
+        
+        // Lockstep: the latest position hash, kept by the leader and sent back to it by the followers
+        if (lockstep.isActive() && renderer.getGPUEntityManager()) {
+            const EntityBounds bounds = renderer.getGPUEntityManager()->getEntityBounds();
+            lockstep.reportState(bounds.tick, bounds.positionHash, bounds.valid);
+        }
         
         inputService->processSDLEvents();
+        const auto inputSampleTime = std::chrono::steady_clock::now();
+        
+        const bool wasHidden = windowHidden;
+        windowHidden = !benchmark && !inputService->isWindowVisible();
+        if (windowHidden != wasHidden) {
+            DEBUG_LOG((windowHidden ? "Window hidden, " : "Window visible, ")
+                      << (windowHidden ? (pauseInBackground ? "pausing" : "simulating without presenting") : "resuming"));
+        }
+        if (windowHidden && pauseInBackground) {
+            // Nothing advances while paused, so the first frame back starts from a fresh delta
+            inputService->waitForEvents(static_cast<int32_t>(BACKGROUND_FRAME_TIME));
+            lastFrameTime = std::chrono::high_resolution_clock::now();
+            continue;
+        }
         // Frame cleanup for input (clear justPressed flags, etc.)
         inputService->processFrame(deltaTime);
         
@@ -190,23 +845,25 @@ int main(int argc, char* argv[]) {
             running = false;
         }
         
-        renderer.setDeltaTime(deltaTime);
-        
-        // RESTORED WITH NEW NAME - DEBUG CHECK
+        // Interactive profile only
         if (controlService) {
             controlService->processFrame(deltaTime);
-        } else {
-            std::cout << "ERROR: controlService is null!" << std::endl;
+        }
+        
+        // Hands this frame's spatial queries to the renderer and answers the ones whose results arrived
+        if (spatialQueryService) {
+            spatialQueryService->processFrame();
         }
         
         // Handle window resize for camera aspect ratio
         int width, height;
-        if (inputService->hasWindowResizeEvent(width, height)) {
+        const bool windowResized = inputService->hasWindowResizeEvent(width, height);
+        if (windowResized) {
             cameraService->handleWindowResize(width, height);
-            renderer.updateAspectRatio(width, height);
-            renderer.setFramebufferResized(true);
             DEBUG_LOG("Window resized to " << width << "x" << height);
         }
+        cameraService->update(deltaTime);
+        publishLatchedCamera(inputSampleTime);
 
         PROFILE_BEGIN_FRAME();
         
@@ -220,7 +877,68 @@ int main(int argc, char* argv[]) {
             // Input cleanup is handled by services - no manual cleanup needed
             // Service-based architecture handles frame state management internally
         }
+        
+        // Renderer state is only touched from here on; under a render thread it is idle until beginFrame()
+        if (renderThread) {
+            PROFILE_SCOPE("Render Thread Wait");
+            renderThread->waitForFrame();
+            renderer.getGPUEntityManager()->applyDeferredFrontendCalls();
+            if (frameCount == 1) {
+                reportFirstFrame();
+            }
+            if (frameCount > 0 && frameCount % 300 == 0) {
+                logFrameTelemetry();
+            }
+        }
+        
+        // Selected GPU-resident entities get their components back while the world and the renderer are both idle
+        renderer.getGPUEntityManager()->applyRehydrations();
+        
+        // A lost device is rebuilt here, with no frame recording and the world between updates
+        if (renderer.isDeviceLost() && !renderer.recoverFromDeviceLoss()) {
+            running = false;
+            continue;
+        }
+        
+        renderer.markInputSampled(inputSampleTime);
+        std::chrono::steady_clock::time_point inputEventTime;
+        if (inputService->getFrameInputEventTime(inputEventTime)) {
+            renderer.markInputEvent(inputEventTime);
+        }
+        renderer.setDeltaTime(deltaTime);
+        renderer.setPresentationEnabled(!windowHidden);
+        if (windowResized) {
+            renderer.updateAspectRatio(width, height);
+            renderer.setFramebufferResized(true);
+        }
+        // A static camera keeps the renderer's matrices, and with them the nodes' per-camera work
+        if (cameraService->getCameraVersion() != sentCameraVersion) {
+            renderer.setCameraMatrices(cameraService->getViewMatrix(), cameraService->getProjectionMatrix(),
+                                       cameraService->getViewProjectionMatrix());
+            renderer.setViewportCameras(collectViewportCameras(0.0f));
+            sentCameraVersion = cameraService->getCameraVersion();
+        }
 
+        // Hidden frames are throttled by waiting for window events instead of the frame pacer, so restoring
+        // the window ends the wait at once
+        auto waitForBackgroundTick = [&]() {
+            const float remainingMs = BACKGROUND_FRAME_TIME - std::chrono::duration<float, std::milli>(
+                std::chrono::high_resolution_clock::now() - frameStartTime).count();
+            if (remainingMs >= 1.0f) {
+                inputService->waitForEvents(static_cast<int32_t>(remainingMs));
+            }
+        };
+        
+        if (renderThread) {
+            renderThread->beginFrame();
+            frameCount++;
+            PROFILE_END_FRAME();
+            if (windowHidden) {
+                waitForBackgroundTick();
+            }
+            continue;
+        }
+        
         {
             PROFILE_SCOPE("Vulkan Rendering");
             renderer.drawFrame();
@@ -228,45 +946,63 @@ int main(int argc, char* argv[]) {
 
         frameCount++;
         PROFILE_END_FRAME();
+        if (frameCount == 1) {
+            reportFirstFrame();
+        }
         
-        if (frameCount % 300 == 0) {
-            float avgFrameTime = Profiler::getInstance().getFrameTime();
-            size_t activeEntities = static_cast<size_t>(world.count<Transform>());
-            size_t estimatedMemory = activeEntities * (sizeof(Transform) + sizeof(Renderable) + sizeof(MovementPattern));
-            
-            Profiler::getInstance().updateMemoryUsage(estimatedMemory);
-            
-            float fps = avgFrameTime > 0.0f ? (1000.0f / avgFrameTime) : 0.0f;
-            std::cout << "Frame " << frameCount 
-                      << ": Avg " << avgFrameTime << "ms"
-                      << " (" << fps << " FPS)"
-                      << " | Entities: " << activeEntities
-                      << " | Est Memory: " << (estimatedMemory / 1024) << "KB"
-                      << std::endl;
-        }
-        
-        auto frameEndTime = std::chrono::high_resolution_clock::now();
-        float frameTimeMs = std::chrono::duration<float, std::milli>(frameEndTime - frameStartTime).count();
-        
-        constexpr float MIN_FRAME_TIME = 11.0f;
-        if (frameTimeMs < MIN_FRAME_TIME) {
-            float remainingMs = MIN_FRAME_TIME - frameTimeMs;
-            if (remainingMs > 0.5f) {
-                SDL_Delay(static_cast<int>(remainingMs));
+        if (benchmark) {
+            benchmark->endFrame(std::chrono::duration<float, std::milli>(
+                std::chrono::high_resolution_clock::now() - frameStartTime).count());
+            if (benchmark->isFinished()) {
+                running = false;
             }
+            continue;
+        }
+        
+        if (frameCount % 300 == 0) {
+            logFrameTelemetry();
+        }
+        
+        if (windowHidden) {
+            waitForBackgroundTick();
+        } else if (!renderer.isFastForwarding()) {
+            renderer.waitForNextFrame();
         }
     }
+    
+    if (renderThread) {
+        renderThread->stop();
+    }
+    if (!saveSnapshotPath.empty()) {
+        renderer.saveEntitySnapshot(saveSnapshotPath);
+    }
 
 
+    const bool benchmarkWritten = !benchmark || benchmark->writeResults();
+    if (!profileTracePath.empty()) {
+        Profiler::getInstance().exportChromeTrace(profileTracePath);
+    }
+    if (!frameGraphExportPath.empty() && renderer.getFrameGraph()) {
+        FrameGraphScheduleExport::write(renderer.getFrameGraph()->captureSchedule(renderer.getEntityCount()),
+                                        frameGraphExportPath);
+    }
+    benchmark.reset();
+    
     renderer.cleanup();
+    renderer.finishRecording();
     
     // Cleanup services in proper order
     DEBUG_LOG("Shutting down services...");
     ServiceLocator::instance().clear();
     DEBUG_LOG("All services shut down successfully");
+    JobSystem::getInstance().shutdown();
+    Logger::getInstance().flush();
     
+    for (SDL_Window* outputWindow : outputWindows) {
+        SDL_DestroyWindow(outputWindow);
+    }
     SDL_DestroyWindow(window);
     SDL_Quit();
 
-    return 0;
+    return benchmarkWritten ? 0 : 1;
 }
\ No newline at end of file
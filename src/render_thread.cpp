@@ -0,0 +1,94 @@
+#include "render_thread.h"
+#include "vulkan_renderer.h"
+#include "ecs/gpu/gpu_entity_manager.h"
+#include "ecs/utilities/profiler.h"
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+
+RenderThread::RenderThread(VulkanRenderer& renderer) : renderer(renderer) {
+}
+
+RenderThread::~RenderThread() {
+    stop();
+}
+
+bool RenderThread::start() {
+    if (isRunning()) return true;
+    
+    GPUEntityManager* gpuEntityManager = renderer.getGPUEntityManager();
+    if (!gpuEntityManager) {
+        std::cerr << "RenderThread: Renderer has no GPUEntityManager" << std::endl;
+        return false;
+    }
+    
+    // From here on, spawns and despawns made while simulating are held for the handoff
+    gpuEntityManager->setDeferredFrontendThread(std::this_thread::get_id());
+    stopping = false;
+    framePending = false;
+    worker = std::thread(&RenderThread::run, this);
+    
+    std::cout << "RenderThread: Recording and submitting frames on a separate thread" << std::endl;
+    return true;
+}
+
+void RenderThread::stop() {
+    if (!isRunning()) return;
+    
+    waitForFrame();
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        stopping = true;
+    }
+    frameReady.notify_one();
+    worker.join();
+    
+    if (GPUEntityManager* gpuEntityManager = renderer.getGPUEntityManager()) {
+        gpuEntityManager->applyDeferredFrontendCalls();
+        gpuEntityManager->setDeferredFrontendThread(std::thread::id{});
+    }
+}
+
+void RenderThread::waitForFrame() {
+    const auto waitStart = std::chrono::steady_clock::now();
+    {
+        std::unique_lock<std::mutex> lock(mutex);
+        frameDone.wait(lock, [this] { return !framePending; });
+    }
+    
+    const double waitMs = std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - waitStart).count();
+    telemetry.frames++;
+    telemetry.waitMs += waitMs;
+    telemetry.maxWaitMs = std::max(telemetry.maxWaitMs, waitMs);
+}
+
+void RenderThread::beginFrame() {
+    {
+        std::lock_guard<std::mutex> lock(mutex);
+        framePending = true;
+    }
+    frameReady.notify_one();
+}
+
+void RenderThread::run() {
+    Profiler::getInstance().setThreadName("Render");
+    std::unique_lock<std::mutex> lock(mutex);
+    while (true) {
+        frameReady.wait(lock, [this] { return framePending || stopping; });
+        if (!framePending) {
+            break;
+        }
+        
+        // The main thread touches no renderer state until framePending clears
+        lock.unlock();
+        {
+            PROFILE_SCOPE("Vulkan Rendering");
+            renderer.drawFrame();
+        }
+        renderer.waitForNextFrame();
+        lock.lock();
+        
+        framePending = false;
+        frameDone.notify_one();
+    }
+}
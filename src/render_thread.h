@@ -0,0 +1,58 @@
+#pragma once
+
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+class VulkanRenderer;
+
+// Second pipeline stage for --render-thread: VulkanRenderer::drawFrame and frame pacing run here while the main
+// thread advances input and ECS for the next frame. Once its frame is simulated the main thread calls
+// waitForFrame(), applies renderer-facing state while this thread is idle (delta time, camera, resize and the
+// GPUEntityManager calls deferred meanwhile), then beginFrame() hands the frame over. At most one frame is
+// between the stages, so the simulation never runs more than a frame ahead of recording
+class RenderThread {
+public:
+    explicit RenderThread(VulkanRenderer& renderer);
+    ~RenderThread();
+    
+    RenderThread(const RenderThread&) = delete;
+    RenderThread& operator=(const RenderThread&) = delete;
+    
+    // Called on the main thread after the renderer is initialised and its startup uploads are done
+    bool start();
+    
+    // Finishes the frame being drawn, joins, and applies whatever GPUEntityManager calls are still queued
+    void stop();
+    bool isRunning() const { return worker.joinable(); }
+    
+    // Blocks until the frame handed over last has been submitted and paced
+    void waitForFrame();
+    void beginFrame();
+    
+    // Main thread time blocked in waitForFrame, totals since the last resetTelemetry()
+    struct Telemetry {
+        uint64_t frames = 0;
+        double waitMs = 0.0;
+        double maxWaitMs = 0.0;
+        
+        double getAverageWaitMs() const { return frames > 0 ? waitMs / frames : 0.0; }
+    };
+    const Telemetry& getTelemetry() const { return telemetry; }
+    void resetTelemetry() { telemetry = {}; }
+
+private:
+    void run();
+    
+    VulkanRenderer& renderer;
+    std::thread worker;
+    
+    std::mutex mutex;
+    std::condition_variable frameReady;   // Main thread -> render thread
+    std::condition_variable frameDone;    // Render thread -> main thread
+    bool framePending = false;
+    bool stopping = false;
+    
+    Telemetry telemetry;
+};
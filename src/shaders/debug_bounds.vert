@@ -0,0 +1,34 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "debug_overlay.glsl"
+
+// Debug overlay entity bounds: one instance per entity slot, a line loop of CIRCLE_SEGMENTS segments at the
+// bounding radius around the position the last physics pass resolved. Green while moving, red when stopped by a
+// collision, grey asleep; expired entities draw nothing
+layout(constant_id = 0) const uint CIRCLE_SEGMENTS = 12u;  // DEBUG_OVERLAY_CIRCLE_SEGMENTS
+
+// Position (w = 0 once expired) and velocity (w: 1 asleep, -1 stopped) of this instance's entity
+layout(location = 0) in vec4 position;
+layout(location = 1) in vec4 velocity;
+
+layout(location = 0) out vec4 color;
+
+void main() {
+    if (position.w == 0.0) {
+        gl_Position = DEBUG_OVERLAY_CULLED;
+        color = vec4(0.0);
+        return;
+    }
+    
+    // Two vertices per segment, the second one step further round
+    uint point = uint(gl_VertexIndex) / 2u + (uint(gl_VertexIndex) & 1u);
+    float angle = float(point % CIRCLE_SEGMENTS) * (6.28318531 / float(CIRCLE_SEGMENTS));
+    vec2 world = position.xy + vec2(cos(angle), sin(angle)) * pc.params.y;
+    gl_Position = pc.viewProjection * vec4(world, position.z, 1.0);
+    
+    // The random walk kernel zeroes the velocity of an entity it stopped; the closed-form one flags it with -1
+    bool asleep = velocity.w > 0.5;
+    bool stopped = velocity.w < -0.5 || (!asleep && dot(velocity.xy, velocity.xy) == 0.0);
+    color = asleep ? vec4(0.55, 0.55, 0.55, 0.6) : (stopped ? vec4(1.0, 0.15, 0.1, 0.9) : vec4(0.2, 1.0, 0.3, 0.7));
+}
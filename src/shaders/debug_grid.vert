@@ -0,0 +1,49 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "spatial_cells.glsl"
+#include "debug_overlay.glsl"
+
+// Debug overlay grid: one instance per spatial map cell, two triangles each, shaded by the entities the last grid
+// build counted into the cell. Empty cells draw nothing; cells past the physics capacity, whose entities skip
+// neighbours, are solid red
+const vec2 CELL_CORNERS[6] = vec2[](
+    vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0),
+    vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0)
+);
+const float CELL_INSET = 0.04;  // Of the cell size, so neighbouring cells stay apart
+
+// Spatial map entry (start, count) of this instance's cell
+layout(location = 0) in uvec2 cell;
+
+layout(location = 0) out vec4 color;
+
+// Blue through green and yellow to orange at full heat
+vec3 occupancyRamp(float t) {
+    vec3 heat = mix(vec3(0.0, 0.2, 1.0), vec3(0.0, 0.9, 0.3), clamp(t * 3.0, 0.0, 1.0));
+    heat = mix(heat, vec3(1.0, 0.9, 0.0), clamp(t * 3.0 - 1.0, 0.0, 1.0));
+    return mix(heat, vec3(1.0, 0.5, 0.0), clamp(t * 3.0 - 2.0, 0.0, 1.0));
+}
+
+void main() {
+    uint count = cell.y;
+    if (count == 0u) {
+        gl_Position = DEBUG_OVERLAY_CULLED;
+        color = vec4(0.0);
+        return;
+    }
+    
+    // The grid covers the world without aliasing, so the upper half of each wrapped axis is the negative cells
+    ivec2 gridSize = ivec2(pc.grid.xy);
+    ivec2 wrapped = ivec2(spatialCellOfIndex(uint(gl_InstanceIndex), pc.grid.x, pc.grid.z));
+    ivec2 coordinate = wrapped - gridSize * ivec2(greaterThanEqual(wrapped, gridSize / 2));
+    
+    vec2 corner = mix(vec2(CELL_INSET), vec2(1.0 - CELL_INSET), CELL_CORNERS[gl_VertexIndex]);
+    vec2 world = (vec2(coordinate) + corner) * pc.params.x;
+    gl_Position = pc.viewProjection * vec4(world, 0.0, 1.0);
+    
+    float capacity = float(pc.grid.w);
+    color = count > pc.grid.w
+        ? vec4(1.0, 0.05, 0.05, 0.6)
+        : vec4(occupancyRamp(float(count) / capacity), 0.25 + 0.25 * float(count) / capacity);
+}
@@ -0,0 +1,10 @@
+#version 450
+
+// Debug overlay: flat colours from debug_grid.vert and debug_bounds.vert, alpha blended over the presented image
+layout(location = 0) in vec4 color;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    outColor = color;
+}
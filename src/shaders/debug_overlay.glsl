@@ -0,0 +1,9 @@
+// Debug overlay push constants, shared by debug_grid.vert and debug_bounds.vert (DebugOverlayNode)
+layout(push_constant) uniform DebugOverlayPushConstants {
+    mat4 viewProjection;  // The view drawn over
+    uvec4 grid;           // Width, height (powers of 2), SpatialCellOrder, entities per cell drawn at full heat
+    vec4 params;          // Cell size, entity bounding radius
+} pc;
+
+// Outside the clip volume, so the primitive rasterizes nothing
+const vec4 DEBUG_OVERLAY_CULLED = vec4(2.0, 2.0, 2.0, 1.0);
@@ -0,0 +1,35 @@
+// Entity storage buffer declarations shared by the classic, bindless and buffer address builds.
+//
+// Classic: every block is its own binding in set 0 (EntityDescriptorBindings::Compute / Graphics).
+// Bindless (-DENTITY_BINDLESS): every block aliases the one storage buffer array at set 0, binding 0, and
+// a use reads entry pc.entityTable.x + its compute binding (EntityDescriptorBindings::Bindless).
+// Buffer address (-DENTITY_BUFFER_ADDRESS): every block is a buffer reference type, and a use reads the
+// stream address at its compute binding in the view's address table, whose address is pc.entityTable.
+//
+// Declare each block as
+//     layout(std430, ENTITY_BINDING(3)) buffer PositionBuffer { ... } ENTITY_BLOCK(positions);
+//     #define positions ENTITY_BUFFER(PositionBuffer, positions, 3u)
+// after a push constant block named pc with a uvec2 entityTable member. entity_streams.glsl, generated from
+// EntityStreamSchema, names the bindings: ENTITY_BINDING(ENTITY_STREAM_POSITION) is the same as ENTITY_BINDING(3).
+
+#include "entity_streams.glsl"
+
+#if defined(ENTITY_BUFFER_ADDRESS)
+#extension GL_EXT_buffer_reference : require
+#extension GL_EXT_buffer_reference_uvec2 : require
+layout(std430, buffer_reference, buffer_reference_align = 8) readonly buffer EntityStreamAddresses {
+    uvec2 streams[];
+};
+#define ENTITY_BINDING(index) buffer_reference
+#define ENTITY_BLOCK(instance)
+#define ENTITY_BUFFER(block, instance, index) block(EntityStreamAddresses(pc.entityTable).streams[index])
+#elif defined(ENTITY_BINDLESS)
+#extension GL_EXT_nonuniform_qualifier : require
+#define ENTITY_BINDING(index) set = 0, binding = 0
+#define ENTITY_BLOCK(instance) instance##Table[]
+#define ENTITY_BUFFER(block, instance, index) instance##Table[pc.entityTable.x + index]
+#else
+#define ENTITY_BINDING(index) binding = index
+#define ENTITY_BLOCK(instance) instance
+#define ENTITY_BUFFER(block, instance, index) instance
+#endif
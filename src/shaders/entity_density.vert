@@ -0,0 +1,55 @@
+#version 450
+#extension GL_GOOGLE_include_directive : require
+
+#include "entity_bindings.glsl"
+
+// Density LOD heat map: one instance per screen tile, two triangles each, coloured by the number of entities
+// entity_cull.comp counted into the tile. Shares the entity pipeline layout and fragment.frag
+const uvec2 DENSITY_TILE_GRID = uvec2(128u, 72u);  // ENTITY_LOD_TILE_COLUMNS x ENTITY_LOD_TILE_ROWS
+const float DENSITY_SATURATION_COUNT = 256.0;      // Entities per tile drawn at full heat
+
+// Bindless table view or stream address table: working buffers or a published snapshot (unused by the classic build)
+layout(push_constant) uniform GraphicsPushConstants {
+    uvec2 entityTable;
+} pc;
+
+const vec2 TILE_CORNERS[6] = vec2[](
+    vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0),
+    vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0)
+);
+
+// Tile -> entity count, in place of the visible indices while density LOD is active
+layout(std430, ENTITY_BINDING(3)) readonly buffer VisibleIndexBuffer {
+    uint visibleIndices[];
+} ENTITY_BLOCK(visibleIndexBuffer);
+#define visibleIndexBuffer ENTITY_BUFFER(VisibleIndexBuffer, visibleIndexBuffer, 13u)
+
+layout(location = 0) out vec3 color;
+
+// Dark blue through blue, red and yellow to white
+vec3 heatRamp(float t) {
+    vec3 heat = mix(vec3(0.0, 0.0, 0.3), vec3(0.0, 0.2, 1.0), clamp(t * 4.0, 0.0, 1.0));
+    heat = mix(heat, vec3(1.0, 0.1, 0.0), clamp(t * 4.0 - 1.0, 0.0, 1.0));
+    heat = mix(heat, vec3(1.0, 0.9, 0.0), clamp(t * 4.0 - 2.0, 0.0, 1.0));
+    return mix(heat, vec3(1.0), clamp(t * 4.0 - 3.0, 0.0, 1.0));
+}
+
+void main() {
+    uint tile = uint(gl_InstanceIndex);
+    uint count = visibleIndexBuffer.visibleIndices[tile];
+    
+    // Empty tiles collapse to a point outside the clip volume and leave the clear colour
+    if (count == 0u) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        color = vec3(0.0);
+        return;
+    }
+    
+    // Same normalized screen position the culling pass measured from the frustum planes, back to clip space
+    vec2 cell = vec2(tile % DENSITY_TILE_GRID.x, tile / DENSITY_TILE_GRID.x) + TILE_CORNERS[gl_VertexIndex];
+    gl_Position = vec4(cell / vec2(DENSITY_TILE_GRID) * 2.0 - 1.0, 0.0, 1.0);
+    
+    // Logarithmic, so sparse edges stay visible next to dense cores
+    float heat = clamp(log2(1.0 + float(count)) / log2(1.0 + DENSITY_SATURATION_COUNT), 0.0, 1.0);
+    color = heatRamp(heat);
+}
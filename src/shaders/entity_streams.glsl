@@ -0,0 +1,39 @@
+// Generated by EntityStreamSchema::writeGlsl (src/ecs/gpu/entity_stream_schema.h); regenerate with
+// `cmake --build . --target entity-schema` rather than editing. entity_stream_schema.cpp includes it
+// too, and startup warns while ENTITY_STREAM_SCHEMA_HASH no longer matches the schema
+#ifndef ENTITY_STREAMS_GLSL
+#define ENTITY_STREAMS_GLSL
+
+#define ENTITY_STREAM_SCHEMA_HASH 0xd6a9d06au
+#define ENTITY_STREAM_COUNT 18
+
+// Compute bindings, also the bindless table and stream address table entries
+// (block, bytes per element in the standard / compact layout, compact encoding, access)
+#define ENTITY_STREAM_VELOCITY                   0  // VelocityBuffer, 16 / 16 per entity, full, hot
+#define ENTITY_STREAM_MOVEMENT_PARAMS            1  // MovementParamsBuffer, 16 / 8 per entity, half, cold
+#define ENTITY_STREAM_RUNTIME_STATE              2  // RuntimeStateBuffer, 16 / 4 per entity, packed, hot
+#define ENTITY_STREAM_POSITION                   3  // PositionBuffer, 16 / 16 per entity, full, hot
+#define ENTITY_STREAM_CURRENT_POSITION           4  // CurrentPositionBuffer, 16 / 8 per entity, narrowed, hot
+#define ENTITY_STREAM_COLOR                      5  // ColorBuffer, 16 / 16 per entity, full, cold
+#define ENTITY_STREAM_MODEL_MATRIX               6  // ModelMatrixBuffer, 64 / 0 per entity, dropped, cold
+#define ENTITY_STREAM_SPATIAL_MAP                7  // SpatialMapBuffer, 8 / 8 per cell, full, transient
+#define ENTITY_STREAM_SPATIAL_ENTRY              8  // SpatialEntryBuffer, 8 / 8 per entity, full, transient
+#define ENTITY_STREAM_SPATIAL_INDEX              9  // SpatialIndexBuffer, 4 / 4 per entity, full, transient
+#define ENTITY_STREAM_ENTITY_ID                 10  // EntityIdBuffer, 4 / 4 per entity, full, cold
+#define ENTITY_STREAM_REORDER_SCRATCH           11  // ReorderScratchBuffer, 16 / 16 per entity, full, transient
+#define ENTITY_STREAM_INDIRECT_COMMAND          12  // IndirectCommandBuffer, one fixed struct, transient
+#define ENTITY_STREAM_VISIBLE_INDEX             13  // VisibleIndexBuffer, 4 / 4 per entity, full, transient
+#define ENTITY_STREAM_VISIBLE_DRAW_COMMAND      14  // VisibleDrawCommandBuffer, one fixed struct, transient
+#define ENTITY_STREAM_PREVIOUS_POSITION         15  // PreviousPositionBuffer, 16 / 16 per entity, full, hot
+#define ENTITY_STREAM_ENTITY_TYPE               16  // EntityTypeBuffer, 4 / 4 per entity, full, cold
+#define ENTITY_STREAM_SPAWN_SLOT                17  // SpawnSlotBuffer, 4 / 4 per entity, full, cold
+
+// Graphics bindings (binding 0 is the camera UBO)
+#define ENTITY_GRAPHICS_STREAM_POSITION          1
+#define ENTITY_GRAPHICS_STREAM_MOVEMENT_PARAMS   2
+#define ENTITY_GRAPHICS_STREAM_VISIBLE_INDEX     3
+#define ENTITY_GRAPHICS_STREAM_COLOR             4
+#define ENTITY_GRAPHICS_STREAM_PREVIOUS_POSITION 5
+#define ENTITY_GRAPHICS_STREAM_ENTITY_ID         6
+
+#endif
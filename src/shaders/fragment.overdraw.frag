@@ -0,0 +1,22 @@
+#version 450
+
+// Overdraw diagnostic (F9): fragment.frag plus one count per shaded fragment into the R32_UINT overdraw count image
+// (OverdrawMonitor's set, appended after the binding mode's sets: set 1, or set 2 with the bindless table and camera
+// UBO). Early tests keep the storage write from moving depth testing after shading, so fragments the entity depth
+// rejects are neither shaded nor counted, as in the normal pass
+#ifndef OVERDRAW_SET
+#define OVERDRAW_SET 1
+#endif
+
+layout(early_fragment_tests) in;
+
+layout(location = 0) in vec3 color;
+
+layout(set = OVERDRAW_SET, binding = 0, r32ui) uniform uimage2D overdrawCounts;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    imageAtomicAdd(overdrawCounts, ivec2(gl_FragCoord.xy), 1u);
+    outColor = vec4(color, 1.0);
+}
@@ -0,0 +1,14 @@
+#version 450
+
+// Entity pick frames: fragment.frag plus the spawn ID + 1 of the entity drawn at each pixel (vertex.vert
+// constant_id 4) into the R32_UINT pick attachment
+layout(location = 0) in vec3 color;
+layout(location = 1) flat in uint pickId;
+
+layout(location = 0) out vec4 outColor;
+layout(location = 1) out uint outPickId;
+
+void main() {
+    outColor = vec4(color, 1.0);
+    outPickId = pickId;
+}
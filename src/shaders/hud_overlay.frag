@@ -0,0 +1,44 @@
+#version 450
+
+// Baked 5x7 glyph atlas for ASCII 32..95 (PerformanceHudNode upper-cases everything else): one byte per row,
+// rows 0-3 in x and 4-6 in y, bit 4 the leftmost column
+const uint HUD_SOLID_QUAD = 0xFFFFFFFFu;
+const uint GLYPH_COUNT = 64u;
+const uvec2 GLYPH_CELLS = uvec2(5u, 7u);
+
+const uvec2 FONT[GLYPH_COUNT] = uvec2[](
+    uvec2(0x00000000u, 0x000000u), uvec2(0x04040404u, 0x040004u), uvec2(0x00000A0Au, 0x000000u), uvec2(0x0A1F0A0Au, 0x0A0A1Fu), //  !"#
+    uvec2(0x0E140F04u, 0x041E05u), uvec2(0x04021918u, 0x031308u), uvec2(0x0814120Cu, 0x0D1215u), uvec2(0x00000404u, 0x000000u), // $%&'
+    uvec2(0x08080402u, 0x020408u), uvec2(0x02020408u, 0x080402u), uvec2(0x0E150400u, 0x000415u), uvec2(0x1F040400u, 0x000404u), // ()*+
+    uvec2(0x00000000u, 0x08040Cu), uvec2(0x1F000000u, 0x000000u), uvec2(0x00000000u, 0x0C0C00u), uvec2(0x04020100u, 0x001008u), // ,-./
+    uvec2(0x1513110Eu, 0x0E1119u), uvec2(0x04040C04u, 0x0E0404u), uvec2(0x0201110Eu, 0x1F0804u), uvec2(0x0204021Fu, 0x0E1101u), // 0123
+    uvec2(0x120A0602u, 0x02021Fu), uvec2(0x011E101Fu, 0x0E1101u), uvec2(0x1E100806u, 0x0E1111u), uvec2(0x0402011Fu, 0x080808u), // 4567
+    uvec2(0x0E11110Eu, 0x0E1111u), uvec2(0x0F11110Eu, 0x0C0201u), uvec2(0x000C0C00u, 0x000C0Cu), uvec2(0x000C0C00u, 0x08040Cu), // 89:;
+    uvec2(0x10080402u, 0x020408u), uvec2(0x001F0000u, 0x00001Fu), uvec2(0x01020408u, 0x080402u), uvec2(0x0201110Eu, 0x040004u), // <=>?
+    uvec2(0x0D01110Eu, 0x0E1515u), uvec2(0x1F11110Eu, 0x111111u), uvec2(0x1E11111Eu, 0x1E1111u), uvec2(0x1010110Eu, 0x0E1110u), // @ABC
+    uvec2(0x1111121Cu, 0x1C1211u), uvec2(0x1E10101Fu, 0x1F1010u), uvec2(0x1E10101Fu, 0x101010u), uvec2(0x1710110Eu, 0x0F1111u), // DEFG
+    uvec2(0x1F111111u, 0x111111u), uvec2(0x0404040Eu, 0x0E0404u), uvec2(0x02020207u, 0x0C1202u), uvec2(0x18141211u, 0x111214u), // HIJK
+    uvec2(0x10101010u, 0x1F1010u), uvec2(0x15151B11u, 0x111111u), uvec2(0x15191111u, 0x111113u), uvec2(0x1111110Eu, 0x0E1111u), // LMNO
+    uvec2(0x1E11111Eu, 0x101010u), uvec2(0x1111110Eu, 0x0D1215u), uvec2(0x1E11111Eu, 0x111214u), uvec2(0x0E10100Fu, 0x1E0101u), // PQRS
+    uvec2(0x0404041Fu, 0x040404u), uvec2(0x11111111u, 0x0E1111u), uvec2(0x11111111u, 0x040A11u), uvec2(0x15111111u, 0x0A1515u), // TUVW
+    uvec2(0x040A1111u, 0x11110Au), uvec2(0x040A1111u, 0x040404u), uvec2(0x0402011Fu, 0x1F1008u), uvec2(0x0808080Eu, 0x0E0808u), // XYZ[
+    uvec2(0x04081000u, 0x000102u), uvec2(0x0202020Eu, 0x0E0202u), uvec2(0x00110A04u, 0x000000u), uvec2(0x00000000u, 0x1F0000u)  // \]^_
+);
+
+layout(location = 0) in vec2 glyphCoord;
+layout(location = 1) flat in uint glyph;
+layout(location = 2) flat in vec4 color;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    if (glyph != HUD_SOLID_QUAD) {
+        uvec2 cell = min(uvec2(glyphCoord), GLYPH_CELLS - 1u);
+        uvec2 rows = FONT[min(glyph, GLYPH_COUNT - 1u)];
+        uint row = (cell.y < 4u ? rows.x >> (cell.y * 8u) : rows.y >> ((cell.y - 4u) * 8u)) & 0xFFu;
+        if ((row & (0x10u >> cell.x)) == 0u) {
+            discard;
+        }
+    }
+    outColor = color;
+}
@@ -0,0 +1,32 @@
+#version 450
+
+// Performance HUD: one instance per quad, two triangles each, in swapchain pixels (PerformanceHudNode)
+const vec2 QUAD_CORNERS[6] = vec2[](
+    vec2(0.0, 0.0), vec2(1.0, 0.0), vec2(0.0, 1.0),
+    vec2(1.0, 0.0), vec2(1.0, 1.0), vec2(0.0, 1.0)
+);
+
+const vec2 GLYPH_CELLS = vec2(5.0, 7.0);  // Must match hud_overlay.frag
+
+layout(push_constant) uniform HudPushConstants {
+    vec2 pixelToClip;  // 2 / output extent
+} pc;
+
+// x | y << 16, width | height << 16, glyph (HUD_SOLID_QUAD = filled rect), packed RGBA8
+layout(location = 0) in uvec4 quad;
+
+layout(location = 0) out vec2 glyphCoord;
+layout(location = 1) flat out uint glyph;
+layout(location = 2) flat out vec4 color;
+
+void main() {
+    vec2 corner = QUAD_CORNERS[gl_VertexIndex];
+    vec2 origin = vec2(quad.x & 0xFFFFu, quad.x >> 16u);
+    vec2 size = vec2(quad.y & 0xFFFFu, quad.y >> 16u);
+    
+    // Unused instances are zero-sized and rasterize nothing
+    gl_Position = vec4((origin + corner * size) * pc.pixelToClip - 1.0, 0.0, 1.0);
+    glyphCoord = corner * GLYPH_CELLS;
+    glyph = quad.z;
+    color = unpackUnorm4x8(quad.w);
+}
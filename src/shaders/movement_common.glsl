@@ -0,0 +1,98 @@
+// Push constants, streams and entity selection shared by the movement kernels (movement_*.comp).
+//
+// Dense or due-strided dispatches select entities by index as movement has always done. Under movement type
+// dispatch (MOVEMENT_TYPE_LIST) each kernel instead runs over its MovementType's index list, which movement_bin.comp
+// wrote at entityOffset in the reorder scratch buffer and sized in movementCounts, so a wavefront only ever holds
+// entities of one behaviour.
+//
+// Dispatches past COMPUTE_MAX_WORKGROUPS_X workgroups arrive as a 2D grid of workgroups, so invocations are
+// numbered by movementInvocationIndex() rather than gl_GlobalInvocationID.x; a 1D dispatch numbers them alike.
+//
+// Include after entity_bindings.glsl, and after subgroup_scan.glsl in kernels with a ballot build.
+
+#include "simulation_counters.glsl"
+
+layout(constant_id = 1) const bool ENTITY_COMPACT_LAYOUT = false;
+layout(constant_id = 2) const bool MOVEMENT_TYPE_LIST = false;
+
+const uint MOVEMENT_TYPE_COUNT = 3u;  // MOVEMENT_TYPE_COUNT
+const uint MOVEMENT_NO_ENTITY = 0xFFFFFFFFu;
+
+// Must match EntityComputeNode::ComputePushConstants
+layout(push_constant) uniform ComputePushConstants {
+    float time;
+    float deltaTime;
+    uint entityCount;
+    uint frame;
+    uint entityOffset;  // Chunk offset, first due entity when entityStride != 0, or start of the type list
+    uint entityStride;  // 0 = one thread per entity, otherwise only entities entityOffset + k * entityStride
+    uvec2 entityTable;  // Bindless table view or stream address table (entity_bindings.glsl)
+} pc;
+
+layout(std430, ENTITY_BINDING(0)) buffer VelocityBuffer {
+    vec4 velocities[];  // xy = velocity, z = damping, w = asleep
+} ENTITY_BLOCK(velocityBuffer);
+#define velocityBuffer ENTITY_BUFFER(VelocityBuffer, velocityBuffer, 0u)
+
+layout(std430, ENTITY_BINDING(1)) readonly buffer MovementParamsBuffer {
+    vec4 movementParams[];  // amplitude, frequency, phase, timeOffset
+} ENTITY_BLOCK(movementParamsBuffer);
+#define movementParamsBuffer ENTITY_BUFFER(MovementParamsBuffer, movementParamsBuffer, 1u)
+
+// ENTITY_COMPACT_LAYOUT alias of binding 1 (packing in GPUEntityManager prepareColdStreams)
+layout(std430, ENTITY_BINDING(1)) readonly buffer PackedMovementParamsBuffer {
+    uvec2 packedMovementParams[];  // half2(amplitude, frequency), half2(phase, timeOffset)
+} ENTITY_BLOCK(packedMovementParamsBuffer);
+#define packedMovementParamsBuffer ENTITY_BUFFER(PackedMovementParamsBuffer, packedMovementParamsBuffer, 1u)
+
+layout(std430, ENTITY_BINDING(11)) readonly buffer ReorderScratchBuffer {
+    uint movementLists[];  // R: one index list per MovementType (movement_bin.comp)
+} ENTITY_BLOCK(scratch);
+#define scratch ENTITY_BUFFER(ReorderScratchBuffer, scratch, 11u)
+
+// GPU-resident live entity count (written by the spawn path), the type list lengths and the simulation counters
+layout(std430, ENTITY_BINDING(12)) buffer IndirectCommandBuffer {
+    uint dispatchX;
+    uint dispatchY;
+    uint dispatchZ;
+    uint liveEntityCount;
+    uint drawCommand[5];
+    uint expiredEntityCount;
+    uint activeDispatch[3];
+    uint activeEntityCount;
+    uint movementDispatch[3u * MOVEMENT_TYPE_COUNT];
+    uint movementCounts[MOVEMENT_TYPE_COUNT];
+    SimulationCounters simulation;  // W: directionChanges (movement_random.comp)
+} ENTITY_BLOCK(indirectCommands);
+#define indirectCommands ENTITY_BUFFER(IndirectCommandBuffer, indirectCommands, 12u)
+
+vec4 loadMovementParams(uint entityIndex) {
+    if (ENTITY_COMPACT_LAYOUT) {
+        uvec2 packed = packedMovementParamsBuffer.packedMovementParams[entityIndex];
+        return vec4(unpackHalf2x16(packed.x), unpackHalf2x16(packed.y));
+    }
+    return movementParamsBuffer.movementParams[entityIndex];
+}
+
+// Invocation number across the whole workgroup grid, rows of gl_NumWorkGroups.x workgroups
+uint movementInvocationIndex() {
+    uint workgroup = (gl_WorkGroupID.z * gl_NumWorkGroups.y + gl_WorkGroupID.y) * gl_NumWorkGroups.x + gl_WorkGroupID.x;
+    return workgroup * gl_WorkGroupSize.x + gl_LocalInvocationID.x;
+}
+
+// Entity this invocation moves, or MOVEMENT_NO_ENTITY past the live range or the end of the list
+uint movementEntityIndex(uint movementType) {
+    uint invocation = movementInvocationIndex();
+    if (MOVEMENT_TYPE_LIST) {
+        uint listIndex = invocation;
+        if (listIndex >= indirectCommands.movementCounts[movementType]) {
+            return MOVEMENT_NO_ENTITY;
+        }
+        return scratch.movementLists[pc.entityOffset + listIndex];
+    }
+    
+    uint entityIndex = pc.entityStride == 0u
+        ? invocation + pc.entityOffset
+        : pc.entityOffset + invocation * pc.entityStride;
+    return entityIndex < indirectCommands.liveEntityCount ? entityIndex : MOVEMENT_NO_ENTITY;
+}
@@ -0,0 +1,27 @@
+#version 450
+
+// Overdraw heat map: the entity pass's fragment count under each presented pixel, ramped from blue (shaded once)
+// through green to red at saturation and white beyond, alpha blended over the image. Uncovered pixels are left as
+// they are
+layout(set = 0, binding = 0, r32ui) uniform readonly uimage2D overdrawCounts;
+
+// Must match OverdrawNode::HeatMapPushConstants
+layout(push_constant) uniform HeatMapPushConstants {
+    vec2 renderScale;       // Count image pixels per presented pixel
+    float saturation;       // Fragments per pixel at the top of the ramp
+} pc;
+
+layout(location = 0) out vec4 outColor;
+
+void main() {
+    uint count = imageLoad(overdrawCounts, ivec2(gl_FragCoord.xy * pc.renderScale)).r;
+    if (count == 0u) {
+        discard;
+    }
+
+    float heat = clamp(float(count - 1u) / max(pc.saturation - 1.0, 1.0), 0.0, 1.0);
+    vec3 ramp = heat < 0.5
+        ? mix(vec3(0.0, 0.2, 1.0), vec3(0.0, 1.0, 0.2), heat * 2.0)
+        : mix(vec3(0.0, 1.0, 0.2), vec3(1.0, 0.1, 0.0), heat * 2.0 - 1.0);
+    outColor = vec4(float(count) > pc.saturation ? vec3(1.0) : ramp, 0.65);
+}
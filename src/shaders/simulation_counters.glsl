@@ -0,0 +1,38 @@
+// Simulation counters the physics, random walk and grid build kernels add to, embedded in the IndirectCommandBuffer
+// block (EntityIndirectCommands::simulation in specialized_buffers.h). The totals only grow and wrap around;
+// EntityBufferManager reads them back each frame and differences consecutive readings. The cell fields and the
+// occupancy histogram describe the last grid build (spatial_prefix_sum.comp).
+//
+// Include before the IndirectCommandBuffer block, after subgroup_scan.glsl in kernels with a ballot build.
+
+const uint OCCUPANCY_HISTOGRAM_BINS = 16u;  // SPATIAL_OCCUPANCY_HISTOGRAM_BINS
+
+struct SimulationCounters {
+    uint collisions;
+    uint truncatedEntities;   // Narrow phases that skipped neighbours past MAX_ENTITIES_PER_CELL
+    uint directionChanges;
+    uint occupiedCells;
+    uint overflowCells;       // Cells over the physics cell capacity
+    uint maxCellOccupancy;
+    uint histogramValid;
+    uint padding;
+    uint occupancyHistogram[OCCUPANCY_HISTOGRAM_BINS];
+};
+
+// What this invocation adds to a counter counting predicate, so a subgroup issues one atomic between all its
+// invocations: if (n != 0u) atomicAdd(counter, n). Ballot build: the subgroup's count in its first invocation and 0
+// in the others. Default build: one atomic per invocation with predicate set. No barriers, so kernels call it after
+// their early returns
+uint subgroupCounterIncrement(bool predicate) {
+#if defined(ENTITY_SUBGROUP_BALLOT)
+    uint count = subgroupBallotCount(predicate);
+    return subgroupElectFirst() ? count : 0u;
+#else
+    return predicate ? 1u : 0u;
+#endif
+}
+
+// Histogram bin of a cell's entity count: 0 when empty, b for [2^(b-1), 2^b), the last bin for everything above
+uint occupancyHistogramBin(uint entityCount) {
+    return entityCount == 0u ? 0u : min(uint(findMSB(entityCount)) + 1u, OCCUPANCY_HISTOGRAM_BINS - 1u);
+}
@@ -0,0 +1,52 @@
+// Spatial map cell indexing shared by the grid count pass and every kernel that walks neighbour cells.
+//
+// Cell coordinates wrap onto the power-of-2 grid with a mask, as in the original row-major hash. The Morton
+// order (SpatialCellOrder::Morton) interleaves the wrapped x and y bits instead, so the counting sort lays
+// cells, and the entities in them, out along a Z curve: a dense cluster a few cells tall stays one contiguous
+// run of the sorted index. It needs a square grid, which SpatialGridConfig::choose always picks.
+// Must match SpatialGridConfig::getCellIndex.
+
+const uint SPATIAL_CELL_ORDER_ROW_MAJOR = 0u;
+const uint SPATIAL_CELL_ORDER_MORTON = 1u;
+
+// Spreads the low 16 bits of v over the even bits
+uint spatialMortonSpread(uint v) {
+    v &= 0x0000FFFFu;
+    v = (v | (v << 8)) & 0x00FF00FFu;
+    v = (v | (v << 4)) & 0x0F0F0F0Fu;
+    v = (v | (v << 2)) & 0x33333333u;
+    v = (v | (v << 1)) & 0x55555555u;
+    return v;
+}
+
+// Map index of an unwrapped cell coordinate; negative coordinates wrap like positive ones
+uint spatialCellIndex(ivec2 cell, uint gridWidth, uint gridHeight, uint cellOrder) {
+    uint x = uint(cell.x) & (gridWidth - 1u);
+    uint y = uint(cell.y) & (gridHeight - 1u);
+    if (cellOrder == SPATIAL_CELL_ORDER_MORTON) {
+        return spatialMortonSpread(x) | (spatialMortonSpread(y) << 1);
+    }
+    return x + y * gridWidth;
+}
+
+uint spatialCellIndexOf(vec2 position, float cellSize, uint gridWidth, uint gridHeight, uint cellOrder) {
+    return spatialCellIndex(ivec2(floor(position / cellSize)), gridWidth, gridHeight, cellOrder);
+}
+
+// Gathers the even bits of v into its low 16 bits (inverse of spatialMortonSpread)
+uint spatialMortonCompact(uint v) {
+    v &= 0x55555555u;
+    v = (v | (v >> 1)) & 0x33333333u;
+    v = (v | (v >> 2)) & 0x0F0F0F0Fu;
+    v = (v | (v >> 4)) & 0x00FF00FFu;
+    v = (v | (v >> 8)) & 0x0000FFFFu;
+    return v;
+}
+
+// Wrapped cell coordinate of a map index (inverse of spatialCellIndex)
+uvec2 spatialCellOfIndex(uint index, uint gridWidth, uint cellOrder) {
+    if (cellOrder == SPATIAL_CELL_ORDER_MORTON) {
+        return uvec2(spatialMortonCompact(index), spatialMortonCompact(index >> 1));
+    }
+    return uvec2(index % gridWidth, index / gridWidth);
+}
@@ -0,0 +1,104 @@
+// Workgroup scan and compaction building blocks shared by the grid build and compaction kernels.
+//
+// Ballot build (-DENTITY_SUBGROUP_BALLOT, the .ballot shader variants): GL_ARB_shader_ballot, i.e.
+// VK_EXT_shader_subgroup_ballot with shaderInt64, the subgroup path a Vulkan 1.0 instance can use. An append
+// costs one shared atomic per subgroup instead of one per invocation.
+// Default build: the same results through shared memory alone.
+//
+// Include right after entity_bindings.glsl. Every invocation of the workgroup must reach these calls, since
+// they contain barriers: bounds-check through the predicate or value instead of returning early. Kernels using
+// workgroupExclusiveSum define SCAN_WORKGROUP_SIZE (their local_size_x) before the include.
+
+#if defined(ENTITY_SUBGROUP_BALLOT)
+#extension GL_ARB_shader_ballot : require
+#extension GL_ARB_gpu_shader_int64 : require
+#endif
+
+shared uint scanAppendTotal;
+shared uint scanBroadcastValue;
+
+#if defined(ENTITY_SUBGROUP_BALLOT)
+uint ballotBitCount(uint64_t ballot) {
+    uvec2 words = unpackUint2x32(ballot);
+    return bitCount(words.x) + bitCount(words.y);
+}
+
+// Active invocations of the subgroup with predicate set
+uint subgroupBallotCount(bool predicate) {
+    return ballotBitCount(ballotARB(predicate));
+}
+
+// Active invocations below this one in the subgroup with predicate set
+uint subgroupBallotExclusiveCount(bool predicate) {
+    return ballotBitCount(ballotARB(predicate) & gl_SubGroupLtMaskARB);
+}
+
+// True in the lowest active invocation, the one readFirstInvocationARB reads
+bool subgroupElectFirst() {
+    return gl_SubGroupInvocationARB == readFirstInvocationARB(gl_SubGroupInvocationARB);
+}
+#endif
+
+// This invocation's slot among those appending, in no particular order, and the workgroup's append count
+uint workgroupAppendRank(bool predicate, out uint total) {
+    barrier();  // Readers of an earlier call's total are done with it
+    if (gl_LocalInvocationIndex == 0u) {
+        scanAppendTotal = 0u;
+    }
+    barrier();
+
+#if defined(ENTITY_SUBGROUP_BALLOT)
+    uint subgroupTotal = subgroupBallotCount(predicate);
+    uint subgroupBase = 0u;
+    if (subgroupElectFirst() && subgroupTotal != 0u) {
+        subgroupBase = atomicAdd(scanAppendTotal, subgroupTotal);
+    }
+    uint rank = readFirstInvocationARB(subgroupBase) + subgroupBallotExclusiveCount(predicate);
+#else
+    uint rank = predicate ? atomicAdd(scanAppendTotal, 1u) : 0u;
+#endif
+
+    barrier();
+    total = scanAppendTotal;
+    return rank;
+}
+
+// The first invocation's value in every invocation. Pair with workgroupAppendRank to reserve a workgroup's
+// run of a global list with one atomic:
+//     uint base = workgroupBroadcastFirst(gl_LocalInvocationIndex == 0u && total != 0u ? atomicAdd(counter, total) : 0u);
+uint workgroupBroadcastFirst(uint value) {
+    barrier();
+    if (gl_LocalInvocationIndex == 0u) {
+        scanBroadcastValue = value;
+    }
+    barrier();
+    return scanBroadcastValue;
+}
+
+#if defined(SCAN_WORKGROUP_SIZE)
+shared uint scanPartials[2][SCAN_WORKGROUP_SIZE];
+
+// Ordered exclusive prefix sum over the workgroup's values, and their total. The ballot extension has no
+// arithmetic, so both builds share this inclusive Hillis-Steele scan; ping-ponging between two arrays leaves
+// one barrier per round
+uint workgroupExclusiveSum(uint value, out uint total) {
+    uint tid = gl_LocalInvocationIndex;
+    barrier();  // An earlier call's readers are done with the partials
+    scanPartials[0][tid] = value;
+    barrier();
+    
+    uint source = 0u;
+    for (uint offset = 1u; offset < SCAN_WORKGROUP_SIZE; offset <<= 1u) {
+        uint sum = scanPartials[source][tid];
+        if (tid >= offset) {
+            sum += scanPartials[source][tid - offset];
+        }
+        scanPartials[1u - source][tid] = sum;
+        source = 1u - source;
+        barrier();
+    }
+    
+    total = scanPartials[source][SCAN_WORKGROUP_SIZE - 1u];
+    return scanPartials[source][tid] - value;
+}
+#endif
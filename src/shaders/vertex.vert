@@ -1,70 +1,143 @@
 #version 450
+#extension GL_GOOGLE_include_directive : require
 
+#include "entity_bindings.glsl"
+
+// Frame ring constants: fresh every frame through a dynamic offset, so recorded draws can be replayed.
+// Bindless builds keep it in set 1, beside the descriptor table; buffer address builds bind nothing else
+#ifdef ENTITY_BINDLESS
+layout(set = 1, binding = 0) uniform UBO {
+#else
 layout(binding = 0) uniform UBO {
+#endif
     mat4 view;
     mat4 proj;
+    vec4 timing;  // time, deltaTime, interpolation alpha, viewport index
 } ubo;
 
-layout(push_constant) uniform PC {
-    float time;
-    float dt;
-    uint  count;
+// Bindless table view or stream address table: working buffers or a published snapshot (unused by the classic build)
+layout(push_constant) uniform GraphicsPushConstants {
+    uvec2 entityTable;
 } pc;
 
+// Early depth (ENABLE_ENTITY_EARLY_DEPTH): depth from the entity slot, lowest slot in front, so overlapping
+// entities fail the depth test before the fragment shader instead of overdrawing
+layout(constant_id = 3) const bool ENTITY_SLOT_DEPTH = false;
+const float ENTITY_SLOT_DEPTH_STEP = 1.0 / 1048576.0;  // 1 / ENTITY_CAPACITY_MAX
+
+// Entity pick frames (ENABLE_ENTITY_PICK_BUFFER): pass spawn ID + 1 to fragment.pick.frag, 0 being background
+layout(constant_id = 4) const bool ENTITY_PICK_IDS = false;
+
+#ifdef ENTITY_PROCEDURAL_GEOMETRY
+// Expanded draw: a single instance whose vertex count the culling pass grew by 3 per visible entity
+layout(constant_id = 2) const bool ENTITY_EXPANDED_DRAW = false;
+
+// Entity triangle as a lookup table (PolygonFactory::createTriangle corners), indexed by gl_VertexIndex of a
+// non-indexed draw; ENTITY_PROCEDURAL_VERTEX_COUNT corners per instance, no vertex input
+const vec2 ENTITY_SHAPE_CORNERS[3] = vec2[](
+    vec2(0.0, -2.0),
+    vec2(2.0, 2.0),
+    vec2(-2.0, 2.0)
+);
+#else
 // Input vertex geometry
 layout(location = 0) in vec3 inPos;
+#endif
 
-// Temporarily simplified for debugging
-layout(std430, binding = 1) readonly buffer ComputedPositions {
+// Graphics bindings here, compute binding indices for the bindless table entries
+layout(std430, ENTITY_BINDING(1)) readonly buffer ComputedPositions {
     vec4 computedPos[];
-};
+} ENTITY_BLOCK(computedPositions);
+#define computedPositions ENTITY_BUFFER(ComputedPositions, computedPositions, 3u)
 
-layout(std430, binding = 2) readonly buffer MovementParamsBuffer {
+layout(std430, ENTITY_BINDING(2)) readonly buffer MovementParamsBuffer {
     vec4 movementParams[];  // amplitude, frequency, phase, timeOffset
-} movementParamsBuffer;
+} ENTITY_BLOCK(movementParamsBuffer);
+#define movementParamsBuffer ENTITY_BUFFER(MovementParamsBuffer, movementParamsBuffer, 1u)
+
+// ENTITY_COMPACT_LAYOUT alias of binding 2 (packing in GPUEntityManager prepareColdStreams)
+layout(constant_id = 1) const bool ENTITY_COMPACT_LAYOUT = false;
+
+layout(std430, ENTITY_BINDING(2)) readonly buffer PackedMovementParamsBuffer {
+    uvec2 packedMovementParams[];  // half2(amplitude, frequency), half2(phase, timeOffset)
+} ENTITY_BLOCK(packedMovementParamsBuffer);
+#define packedMovementParamsBuffer ENTITY_BUFFER(PackedMovementParamsBuffer, packedMovementParamsBuffer, 1u)
 
+// Instance -> entity index, compacted by the frustum culling pass; with several viewports the top bits hold the
+// mask of viewports that see the entity (ENTITY_VIEWPORT_MASK_SHIFT), zero meaning every viewport
+const uint VIEWPORT_MASK_SHIFT = 28u;
+layout(std430, ENTITY_BINDING(3)) readonly buffer VisibleIndexBuffer {
+    uint visibleIndices[];
+} ENTITY_BLOCK(visibleIndexBuffer);
+#define visibleIndexBuffer ENTITY_BUFFER(VisibleIndexBuffer, visibleIndexBuffer, 13u)
+
+// Packed static colour parameters, written once per entity at spawn
+layout(std430, ENTITY_BINDING(4)) readonly buffer ColorParamsBuffer {
+    uvec4 colorParams[];
+} ENTITY_BLOCK(colorParamsBuffer);
+#define colorParamsBuffer ENTITY_BUFFER(ColorParamsBuffer, colorParamsBuffer, 5u)
+
+// Positions at the start of the latest simulation tick (the published snapshot itself when drawing one)
+layout(std430, ENTITY_BINDING(5)) readonly buffer PreviousPositions {
+    vec4 previousPos[];
+} ENTITY_BLOCK(previousPositions);
+#define previousPositions ENTITY_BUFFER(PreviousPositions, previousPositions, 15u)
+
+// Slot -> spawn ID; the working buffer also matches a published snapshot, which is only drawn while slots stay put
+layout(std430, ENTITY_BINDING(6)) readonly buffer EntityIdBuffer {
+    uint spawnIds[];
+} ENTITY_BLOCK(entityIdBuffer);
+#define entityIdBuffer ENTITY_BUFFER(EntityIdBuffer, entityIdBuffer, 10u)
 
 layout(location = 0) out vec3 color;
+layout(location = 1) flat out uint pickId;
 
-/* ---------- HSV → RGB ---------- */
+/* ---------- HSV → RGB (branchless) ---------- */
 vec3 hsv2rgb(float h, float s, float v) {
-    float c  = v * s;
-    float x  = c * (1.0 - abs(mod(h * 6.0, 2.0) - 1.0));
-    float m  = v - c;
-    vec3  rgb;
-
-    if      (h < 1.0/6.0) rgb = vec3(c, x, 0);
-    else if (h < 2.0/6.0) rgb = vec3(x, c, 0);
-    else if (h < 3.0/6.0) rgb = vec3(0, c, x);
-    else if (h < 4.0/6.0) rgb = vec3(0, x, c);
-    else if (h < 5.0/6.0) rgb = vec3(x, 0, c);
-    else                    rgb = vec3(c, 0, x);
-
-    return rgb + m;
+    vec3 rgb = clamp(abs(mod(h * 6.0 + vec3(0.0, 4.0, 2.0), 6.0) - 3.0) - 1.0, 0.0, 1.0);
+    return v * mix(vec3(1.0), rgb, s);
 }
 
 void main() {
-    // Read computed positions from physics shader output
-    vec3 worldPos = computedPos[gl_InstanceIndex].xyz;
+    // Culled draws only cover visible entities, so resolve the real entity slot first
+#ifdef ENTITY_PROCEDURAL_GEOMETRY
+    uint visibleSlot = ENTITY_EXPANDED_DRAW ? uint(gl_VertexIndex) / 3u : uint(gl_InstanceIndex);
+    uint corner = ENTITY_EXPANDED_DRAW ? uint(gl_VertexIndex) % 3u : uint(gl_VertexIndex);
+#else
+    uint visibleSlot = uint(gl_InstanceIndex);
+#endif
+    uint visibleEntry = visibleIndexBuffer.visibleIndices[visibleSlot];
+    uint entityIndex = visibleEntry & ((1u << VIEWPORT_MASK_SHIFT) - 1u);
     
-    // Extract movement parameters for color calculation from SoA buffers
-    vec4 entityMovementParams = movementParamsBuffer.movementParams[gl_InstanceIndex];
-    float phase = entityMovementParams.z;
-    float timeOffset = entityMovementParams.w;
-    float entityTime = pc.time + timeOffset;
+    // Culled for this viewport: collapse outside the clip volume before any colour work
+    uint viewportMask = visibleEntry >> VIEWPORT_MASK_SHIFT;
+    if (viewportMask != 0u && (viewportMask & (1u << uint(ubo.timing.w))) == 0u) {
+        gl_Position = vec4(2.0, 2.0, 2.0, 1.0);
+        color = vec3(0.0);
+        pickId = 0u;
+        return;
+    }
     
-    // Calculate dynamic color based on movement parameters with strong per-entity individualization
-    // Use instance index to create much stronger base color variation per entity
-    float entityBaseHue = mod(float(gl_InstanceIndex) * 0.618034, 1.0); // Golden ratio for good distribution
+    // Blend the last two simulation ticks, so motion stays smooth when frames and ticks do not line up
+    vec3 worldPos = mix(previousPositions.previousPos[entityIndex].xyz,
+                        computedPositions.computedPos[entityIndex].xyz, ubo.timing.z);
     
-    // Per-entity individualized timing and frequencies - INTENSE VERSION
-    float entityFreqMultiplier = 0.3 + mod(float(gl_InstanceIndex) * 0.7321, 1.0) * 2.7; // Range: 0.3 to 3.0 (much wider)
-    float entityPhaseOffset = mod(float(gl_InstanceIndex) * 2.3941, 6.28318530718); // Unique phase offset
-    float entityTimeOffset = mod(float(gl_InstanceIndex) * 1.4142, 15.0); // Unique time offset (longer spread)
+    // Static per-entity colour terms are packed once at spawn (see packColorParams in gpu_entity_manager.cpp)
+    uvec4 packedParams = colorParamsBuffer.colorParams[entityIndex];
+    vec2 timing = unpackHalf2x16(packedParams.x);       // frequency multiplier, individual time base
+    vec2 phaseParams = unpackHalf2x16(packedParams.y);  // phase offset, phase length
+    vec2 cycleFreqs = unpackHalf2x16(packedParams.z);   // brightness frequency, saturation frequency
+    vec4 bases = unpackUnorm4x8(packedParams.w);        // base hue, hue shift amount, brightness base, saturation base
     
-    // INTENSE individualized phase system - shorter, more frequent phases
-    float individualTime = entityTime * entityFreqMultiplier + entityTimeOffset + phase;
-    float phaseLengthVariation = 0.8 + mod(float(gl_InstanceIndex) * 0.8660, 1.0) * 1.7; // Phase length: 0.8-2.5 seconds (much faster)
+    float entityTimeOffset = ENTITY_COMPACT_LAYOUT
+        ? unpackHalf2x16(packedMovementParamsBuffer.packedMovementParams[entityIndex].y).y
+        : movementParamsBuffer.movementParams[entityIndex].w;
+    float entityTime = ubo.timing.x + entityTimeOffset;
+    
+    // Individualized phase system: time base already folds in movement phase and time offsets
+    float individualTime = ubo.timing.x * timing.x + timing.y;
+    float entityPhaseOffset = phaseParams.x;
+    float phaseLengthVariation = phaseParams.y;
     float colorPhaseTime = individualTime * 0.8 + entityPhaseOffset; // 2x faster base rate
     float colorPhase = floor(colorPhaseTime / phaseLengthVariation);
     float phaseProgress = mod(colorPhaseTime, phaseLengthVariation) / phaseLengthVariation;
@@ -72,30 +145,23 @@ void main() {
     // More dramatic transition curves for intensity
     float phaseTransition = smoothstep(0.1, 0.9, phaseProgress); // Steeper transitions
     
-    // INTENSE individualized phase-based hue shifts - much larger jumps
-    float entityHueShiftAmount = 0.2 + mod(float(gl_InstanceIndex) * 0.5257, 1.0) * 0.6; // Shift amount: 20-80% (massive jumps)
+    // Phase-based hue shifts around the per-entity base hue
+    float entityHueShiftAmount = bases.y;
     float phaseHueShift = mod(colorPhase * entityHueShiftAmount, 1.0);
     float nextPhaseHueShift = mod((colorPhase + 1.0) * entityHueShiftAmount, 1.0);
     float currentHueShift = mix(phaseHueShift, nextPhaseHueShift, phaseTransition);
+    float hue = mod(bases.x + currentHueShift, 1.0);
     
-    // Combine base hue with INTENSE individualized phase shifting
-    float hue = mod(entityBaseHue + currentHueShift, 1.0);
-    
-    // EXTREME brightness variation with intense breathing patterns
-    float entityBrightnessBase = mod(float(gl_InstanceIndex) * 0.381966, 1.0);
-    float brightnessFreq = 0.4 + mod(float(gl_InstanceIndex) * 0.9511, 1.0) * 1.2; // Range: 0.4 to 1.6 (much faster)
-    float brightnessPhase = sin(individualTime * brightnessFreq + entityPhaseOffset * 2.0) * 0.7; // Much stronger amplitude
-    float brightness = 0.2 + entityBrightnessBase * 0.7 + brightnessPhase; // Range: -0.5 to 1.6
-    brightness = clamp(brightness, 0.05, 1.0); // Allow very dim to very bright
+    // Brightness breathing pattern
+    float brightnessPhase = sin(individualTime * cycleFreqs.x + entityPhaseOffset * 2.0) * 0.7;
+    float brightness = clamp(0.2 + bases.z * 0.7 + brightnessPhase, 0.05, 1.0);
     
-    // EXTREME saturation variation with intense cycling patterns
-    float entitySaturationBase = mod(float(gl_InstanceIndex) * 0.236068, 1.0);
-    float saturationFreq = 0.3 + mod(float(gl_InstanceIndex) * 0.4472, 1.0) * 1.0; // Range: 0.3 to 1.3 (much faster)
-    float saturationPhase = cos(individualTime * saturationFreq + entityPhaseOffset * 1.7) * 0.8; // Much stronger amplitude
-    float saturation = 0.1 + entitySaturationBase * 0.8 + saturationPhase; // Range: -0.7 to 1.7
-    saturation = clamp(saturation, 0.0, 1.0); // Allow completely desaturated to fully saturated
+    // Saturation cycling pattern
+    float saturationPhase = cos(individualTime * cycleFreqs.y + entityPhaseOffset * 1.7) * 0.8;
+    float saturation = clamp(0.1 + bases.w * 0.8 + saturationPhase, 0.0, 1.0);
     
     color = hsv2rgb(hue, saturation, brightness);
+    pickId = ENTITY_PICK_IDS ? entityIdBuffer.spawnIds[entityIndex] + 1u : 0u;
     
     // Apply rotation based on time and final transformation
     float rot = entityTime * 0.1;
@@ -106,5 +172,13 @@ void main() {
         worldPos,             1
     );
     
-    gl_Position = ubo.proj * ubo.view * rotationMatrix * vec4(inPos, 1.0);
+#ifdef ENTITY_PROCEDURAL_GEOMETRY
+    vec3 localPos = vec3(ENTITY_SHAPE_CORNERS[corner], 0.0);
+#else
+    vec3 localPos = inPos;
+#endif
+    gl_Position = ubo.proj * ubo.view * rotationMatrix * vec4(localPos, 1.0);
+    if (ENTITY_SLOT_DEPTH) {
+        gl_Position.z = float(entityIndex) * ENTITY_SLOT_DEPTH_STEP * gl_Position.w;
+    }
 }
\ No newline at end of file
@@ -0,0 +1,19 @@
+#include "deletion_queue.h"
+#include <algorithm>
+
+void DeletionQueue::setFramesInFlight(uint32_t framesInFlight) {
+    framesInFlight_ = std::clamp(framesInFlight, 1u, MAX_FRAMES_IN_FLIGHT);
+}
+
+void DeletionQueue::beginFrame() {
+    ++serial_;
+    while (!retired_.empty() && serial_ - retired_.front().serial >= framesInFlight_) {
+        retired_.pop_front();
+    }
+}
+
+void DeletionQueue::flush() {
+    while (!retired_.empty()) {
+        retired_.pop_front();
+    }
+}
@@ -0,0 +1,56 @@
+#pragma once
+
+#include "vulkan_constants.h"
+#include <cstdint>
+#include <deque>
+#include <memory>
+#include <type_traits>
+#include <utility>
+
+// Defers destruction of Vulkan objects that submitted frames may still reference: pipelines and render passes
+// that were evicted or replaced, buffers replaced by growth or a defragmentation move. Each object is tagged
+// with the frame serial current when it is retired and released by the beginFrame() framesInFlight frames
+// later - after the renderer has waited on the fences (or timeline values) of the slot that frame reuses, so
+// every submission that could have recorded with it has completed. Objects are released in retirement order,
+// so a buffer retired before its memory goes first.
+// One queue per device, owned by the renderer and handed to PipelineSystemManager and ResourceCoordinator.
+// Main thread only; background compiles never retire anything
+class DeletionQueue {
+public:
+    DeletionQueue() = default;
+    ~DeletionQueue() = default;
+    
+    DeletionQueue(const DeletionQueue&) = delete;
+    DeletionQueue& operator=(const DeletionQueue&) = delete;
+    
+    // Frames the renderer keeps in flight; retired objects outlive that many beginFrame() calls
+    void setFramesInFlight(uint32_t framesInFlight);
+    
+    // Call once the slot's fences (or timeline values) have been waited on, before recording into it
+    void beginFrame();
+    
+    // Takes ownership of a RAII handle or unique_ptr; empty resources are dropped immediately
+    template<typename T>
+    void retire(T&& resource) {
+        if (!resource) {
+            return;
+        }
+        retired_.push_back({serial_, std::make_shared<std::decay_t<T>>(std::move(resource))});
+    }
+    
+    // Destroys everything at once; the device must be idle
+    void flush();
+    
+    size_t getPendingCount() const { return retired_.size(); }
+    uint64_t getFrameSerial() const { return serial_; }
+
+private:
+    struct Retired {
+        uint64_t serial = 0;
+        std::shared_ptr<void> resource;
+    };
+    
+    std::deque<Retired> retired_;      // Ascending serial
+    uint64_t serial_ = 0;
+    uint32_t framesInFlight_ = MAX_FRAMES_IN_FLIGHT;
+};
@@ -0,0 +1,117 @@
+#include "gpu_clock_calibration.h"
+#include "vulkan_context.h"
+#include "vulkan_function_loader.h"
+#include "vulkan_constants.h"
+#include <algorithm>
+#include <bit>
+#include <chrono>
+#include <iostream>
+
+#if defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace {
+    constexpr uint32_t CALIBRATION_ATTEMPTS = 4;
+    
+    // The steady clock reads QueryPerformanceCounter on Windows and CLOCK_MONOTONIC elsewhere, from the same epoch
+    int64_t hostReadingToSteadyNs(uint64_t reading) {
+#if defined(_WIN32)
+        LARGE_INTEGER frequency;
+        QueryPerformanceFrequency(&frequency);
+        const auto ticksPerSecond = static_cast<uint64_t>(frequency.QuadPart);
+        return static_cast<int64_t>((reading / ticksPerSecond) * 1000000000ULL +
+                                    (reading % ticksPerSecond) * 1000000000ULL / ticksPerSecond);
+#else
+        return static_cast<int64_t>(reading);
+#endif
+    }
+    
+    int64_t steadyNow() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+            std::chrono::steady_clock::now().time_since_epoch()).count();
+    }
+}
+
+VkTimeDomainEXT GpuClockCalibration::getHostTimeDomain() {
+#if defined(_WIN32)
+    return VK_TIME_DOMAIN_QUERY_PERFORMANCE_COUNTER_EXT;
+#else
+    return VK_TIME_DOMAIN_CLOCK_MONOTONIC_EXT;
+#endif
+}
+
+void GpuClockCalibration::initialize(const VulkanContext* context, float timestampPeriodNs, uint64_t timestampMask) {
+    this->context = context;
+    this->timestampPeriodNs = timestampPeriodNs;
+    this->timestampMask = timestampMask;
+    timestampBits = static_cast<uint32_t>(std::popcount(timestampMask));
+    offsetBoundNs = INT64_MAX;
+    
+    calibrated = false;
+    if (context->supportsCalibratedTimestamps() && context->getLoader().vkGetCalibratedTimestampsEXT) {
+        calibrated = calibrate();
+        if (!calibrated) {
+            std::cout << "GpuClockCalibration: Calibration failed, GPU zones placed from readback times" << std::endl;
+        }
+    }
+}
+
+bool GpuClockCalibration::calibrate() {
+    VkCalibratedTimestampInfoEXT infos[2]{};
+    infos[0].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+    infos[0].timeDomain = VK_TIME_DOMAIN_DEVICE_EXT;
+    infos[1].sType = VK_STRUCTURE_TYPE_CALIBRATED_TIMESTAMP_INFO_EXT;
+    infos[1].timeDomain = getHostTimeDomain();
+    
+    // A reading interrupted between the two clocks has a wide deviation; the tightest of a few attempts is kept
+    uint64_t bestTimestamps[2] = {};
+    uint64_t bestDeviation = UINT64_MAX;
+    for (uint32_t attempt = 0; attempt < CALIBRATION_ATTEMPTS && bestDeviation > GPU_CLOCK_MAX_DEVIATION_NS; ++attempt) {
+        uint64_t timestamps[2] = {};
+        uint64_t maxDeviation = 0;
+        if (context->getLoader().vkGetCalibratedTimestampsEXT(context->getDevice(), 2, infos, timestamps, &maxDeviation) != VK_SUCCESS) {
+            break;
+        }
+        if (maxDeviation < bestDeviation) {
+            bestDeviation = maxDeviation;
+            std::copy(timestamps, timestamps + 2, bestTimestamps);
+        }
+    }
+    if (bestDeviation == UINT64_MAX) {
+        return false;
+    }
+    
+    referenceTicks = bestTimestamps[0] & timestampMask;
+    referenceNs = hostReadingToSteadyNs(bestTimestamps[1]);
+    lastCalibrationNs = steadyNow();
+    return true;
+}
+
+void GpuClockCalibration::refresh(int64_t readbackNs) {
+    if (calibrated && readbackNs - lastCalibrationNs >= static_cast<int64_t>(GPU_CLOCK_RECALIBRATION_MS) * 1000000) {
+        // A failed recalibration keeps the previous pair, which only drifts
+        calibrate();
+    }
+}
+
+void GpuClockCalibration::boundByReadback(int64_t readbackNs, uint64_t endTicks) {
+    if (calibrated) return;
+    const auto endNs = static_cast<int64_t>(static_cast<double>(endTicks & timestampMask) * timestampPeriodNs);
+    offsetBoundNs = std::min(offsetBoundNs, readbackNs - endNs);
+}
+
+int64_t GpuClockCalibration::toSteadyNs(uint64_t ticks) const {
+    if (!calibrated) {
+        return static_cast<int64_t>(static_cast<double>(ticks & timestampMask) * timestampPeriodNs) + offsetBoundNs;
+    }
+    
+    // Timestamps taken shortly before the reference wrap to just under the mask; sign-extend the masked delta
+    const uint64_t delta = ((ticks & timestampMask) - referenceTicks) & timestampMask;
+    const int64_t signedDelta = timestampBits >= 64
+        ? static_cast<int64_t>(delta)
+        : static_cast<int64_t>(delta << (64 - timestampBits)) >> (64 - timestampBits);
+    return referenceNs + static_cast<int64_t>(static_cast<double>(signedDelta) * timestampPeriodNs);
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include <cstdint>
+
+class VulkanContext;
+
+// Maps GPU timestamp query values onto the steady clock (Profiler::now()), so GPU zones share the trace's
+// timeline with the CPU zones that recorded and submitted them. With VK_EXT_calibrated_timestamps it keeps one
+// pair of simultaneous device and host readings, retaken every GPU_CLOCK_RECALIBRATION_MS as the two clocks
+// drift apart; timestamps convert from their wrapped distance to the pair's device reading. Without the
+// extension every readback bounds the offset from above (the work ended before it was read), and the smallest
+// bound seen so far is used, which places zones late by up to the shortest readback delay.
+class GpuClockCalibration {
+public:
+    // The host domain VK_EXT_calibrated_timestamps must offer for the steady clock
+    static VkTimeDomainEXT getHostTimeDomain();
+    
+    // timestampMask covers the valid bits of every queue whose timestamps are converted
+    void initialize(const VulkanContext* context, float timestampPeriodNs, uint64_t timestampMask);
+    bool isCalibrated() const { return calibrated; }
+    
+    // Once per readback, before its timestamps are converted: recalibrates when due
+    void refresh(int64_t readbackNs);
+    // Per read timestamp pair without calibration: endTicks was written before readbackNs
+    void boundByReadback(int64_t readbackNs, uint64_t endTicks);
+    
+    int64_t toSteadyNs(uint64_t ticks) const;
+
+private:
+    bool calibrate();
+    
+    const VulkanContext* context = nullptr;
+    float timestampPeriodNs = 1.0f;
+    uint64_t timestampMask = ~0ULL;
+    uint32_t timestampBits = 64;
+    bool calibrated = false;
+    
+    // Calibrated: device ticks and steady clock ns read together
+    uint64_t referenceTicks = 0;
+    int64_t referenceNs = 0;
+    int64_t lastCalibrationNs = 0;
+    
+    // Uncalibrated: steady clock minus GPU clock, in ns, the smallest readback bound so far
+    int64_t offsetBoundNs = INT64_MAX;
+};
@@ -33,6 +33,7 @@ bool QueueManager::initialize(const VulkanContext& context) {
     std::cout << "  - Dedicated compute queue: " << (hasDedicatedComputeQueue() ? "YES" : "NO") << std::endl;
     std::cout << "  - Dedicated transfer queue: " << (hasDedicatedTransferQueue() ? "YES" : "NO") << std::endl;
     std::cout << "  - Async compute support: " << (supportsAsyncCompute() ? "YES" : "NO") << std::endl;
+    std::cout << "  - Background compute queue: " << (hasBackgroundComputeQueue() ? "YES" : "NO") << std::endl;
     
     return true;
 }
@@ -43,14 +44,26 @@ void QueueManager::cleanup() {
 }
 
 void QueueManager::cleanupBeforeContextDestruction() {
+    // Recycled fences go first; their command buffers are freed with the pools
+    for (CommandRecycler* recycler : {&transferRecycler, &backgroundComputeRecycler}) {
+        recycler->ready.clear();
+        recycler->pendingReset.clear();
+        recycler->retired.clear();
+    }
+    
     // RAII command pools will clean up automatically
+    framePools.clear();
+    recordingLaneCount = 0;
     graphicsCommandPool.reset();
     computeCommandPool.reset();
     transferCommandPool.reset();
+    backgroundComputeCommandPool.reset();
     
     // Command buffer handles are freed when pools are destroyed
     graphicsCommandBuffers.clear();
     computeCommandBuffers.clear();
+    recordedGraphicsCommandBuffers.clear();
+    recordedImageCount = 0;
 }
 
 VkQueue QueueManager::getGraphicsQueue() const {
@@ -69,6 +82,10 @@ VkQueue QueueManager::getPresentQueue() const {
     return context ? context->getPresentQueue() : VK_NULL_HANDLE;
 }
 
+VkQueue QueueManager::getBackgroundComputeQueue() const {
+    return context ? context->getBackgroundComputeQueue() : VK_NULL_HANDLE;
+}
+
 uint32_t QueueManager::getGraphicsQueueFamily() const {
     return context ? context->getGraphicsQueueFamily() : 0;
 }
@@ -98,6 +115,10 @@ bool QueueManager::supportsAsyncCompute() const {
     return hasDedicatedComputeQueue();
 }
 
+bool QueueManager::hasBackgroundComputeQueue() const {
+    return context ? context->hasBackgroundComputeQueue() : false;
+}
+
 VkCommandPool QueueManager::getCommandPool(CommandPoolType type) const {
     switch (type) {
         case CommandPoolType::Graphics:
@@ -106,6 +127,8 @@ VkCommandPool QueueManager::getCommandPool(CommandPoolType type) const {
             return computeCommandPool.get();
         case CommandPoolType::Transfer:
             return transferCommandPool.get();
+        case CommandPoolType::BackgroundCompute:
+            return backgroundComputeCommandPool.get();
         default:
             return VK_NULL_HANDLE;
     }
@@ -127,27 +150,145 @@ VkCommandBuffer QueueManager::getComputeCommandBuffer(uint32_t frameIndex) const
     return computeCommandBuffers[frameIndex];
 }
 
+bool QueueManager::allocateRecordedGraphicsCommandBuffers(uint32_t imageCount) {
+    if (!context || !graphicsCommandPool || imageCount == 0) {
+        return false;
+    }
+    if (imageCount == recordedImageCount) {
+        return true;
+    }
+    
+    const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
+    
+    if (!recordedGraphicsCommandBuffers.empty()) {
+        vk.vkFreeCommandBuffers(device, graphicsCommandPool.get(),
+                                static_cast<uint32_t>(recordedGraphicsCommandBuffers.size()),
+                                recordedGraphicsCommandBuffers.data());
+        recordedGraphicsCommandBuffers.clear();
+        recordedImageCount = 0;
+    }
+    
+    // Same pool as the per-frame buffers: RESET_COMMAND_BUFFER lets each recording be replaced on its own
+    recordedGraphicsCommandBuffers.resize(static_cast<size_t>(context->getFramesInFlight()) * imageCount);
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = graphicsCommandPool.get();
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+    allocInfo.commandBufferCount = static_cast<uint32_t>(recordedGraphicsCommandBuffers.size());
+    
+    if (vk.vkAllocateCommandBuffers(device, &allocInfo, recordedGraphicsCommandBuffers.data()) != VK_SUCCESS) {
+        std::cerr << "QueueManager: Failed to allocate recorded graphics command buffers" << std::endl;
+        recordedGraphicsCommandBuffers.clear();
+        return false;
+    }
+    
+    recordedImageCount = imageCount;
+    return true;
+}
+
+VkCommandBuffer QueueManager::getRecordedGraphicsCommandBuffer(uint32_t frameIndex, uint32_t imageIndex) const {
+    const size_t index = static_cast<size_t>(frameIndex) * recordedImageCount + imageIndex;
+    if (imageIndex >= recordedImageCount || index >= recordedGraphicsCommandBuffers.size()) {
+        return VK_NULL_HANDLE;
+    }
+    return recordedGraphicsCommandBuffers[index];
+}
+
+bool QueueManager::createRecordingCommandPools(uint32_t laneCount) {
+    if (!context || laneCount == 0) {
+        return false;
+    }
+    if (recordingLaneCount == laneCount) {
+        return true;
+    }
+    
+    // Secondaries are executed from the compute queue's primary, so they come from the same family
+    const uint32_t queueFamily = getQueueFamilyForPool(CommandPoolType::Compute);
+    for (auto& pools : framePools) {
+        pools.recordingLanes.clear();
+        pools.recordingLanes.reserve(laneCount);
+        for (uint32_t lane = 0; lane < laneCount; ++lane) {
+            auto pool = createTransientPool(queueFamily);
+            if (!pool) {
+                std::cerr << "QueueManager: Failed to create recording command pool for lane " << lane << std::endl;
+                for (auto& cleared : framePools) {
+                    cleared.recordingLanes.clear();
+                }
+                recordingLaneCount = 0;
+                return false;
+            }
+            pools.recordingLanes.push_back(std::move(pool));
+        }
+    }
+    
+    recordingLaneCount = laneCount;
+    return true;
+}
+
+VkCommandBuffer QueueManager::allocateRecordingCommandBuffer(uint32_t lane, uint32_t frameIndex) {
+    if (!context || lane >= recordingLaneCount || frameIndex >= framePools.size()) {
+        return VK_NULL_HANDLE;
+    }
+    
+    VkCommandBufferAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+    allocInfo.commandPool = framePools[frameIndex].recordingLanes[lane].get();
+    allocInfo.level = VK_COMMAND_BUFFER_LEVEL_SECONDARY;
+    allocInfo.commandBufferCount = 1;
+    
+    VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+    if (context->getLoader().vkAllocateCommandBuffers(context->getDevice(), &allocInfo, &commandBuffer) != VK_SUCCESS) {
+        std::cerr << "QueueManager: Failed to allocate recording command buffer for lane " << lane << std::endl;
+        return VK_NULL_HANDLE;
+    }
+    return commandBuffer;
+}
+
 QueueManager::TransferCommand QueueManager::allocateTransferCommand() {
-    if (!context || !transferCommandPool) {
-        std::cerr << "QueueManager: Cannot allocate transfer command - not initialized" << std::endl;
+    return allocateOneTimeCommand(transferCommandPool.get(), "transfer");
+}
+
+QueueManager::TransferCommand QueueManager::allocateBackgroundComputeCommand() {
+    return allocateOneTimeCommand(backgroundComputeCommandPool.get(), "background compute");
+}
+
+QueueManager::TransferCommand QueueManager::allocateOneTimeCommand(VkCommandPool pool, const char* poolName) {
+    if (!context || pool == VK_NULL_HANDLE) {
+        std::cerr << "QueueManager: Cannot allocate " << poolName << " command - not initialized" << std::endl;
         return {};
     }
     
+    CommandRecycler* recycler = getRecycler(pool);
+    if (recycler && recycler->ready.empty()) {
+        if (recycler->pendingReset.empty()) {
+            collectRetiredCommands(*recycler);
+        }
+        resetPendingCommands(*recycler);
+    }
+    if (recycler && !recycler->ready.empty()) {
+        TransferCommand command = std::move(recycler->ready.back());
+        recycler->ready.pop_back();
+        telemetry.recordTransferAllocation();
+        ++telemetry.recycledTransferAllocations;
+        return command;
+    }
+    
     TransferCommand command;
-    command.sourcePool = transferCommandPool.get();
+    command.sourcePool = pool;
     
     // Allocate command buffer
     VkCommandBufferAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
     allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    allocInfo.commandPool = transferCommandPool.get();
+    allocInfo.commandPool = pool;
     allocInfo.commandBufferCount = 1;
     
     const auto& vk = context->getLoader();
     const VkDevice device = context->getDevice();
     
     if (vk.vkAllocateCommandBuffers(device, &allocInfo, &command.commandBuffer) != VK_SUCCESS) {
-        std::cerr << "QueueManager: Failed to allocate transfer command buffer" << std::endl;
+        std::cerr << "QueueManager: Failed to allocate " << poolName << " command buffer" << std::endl;
         return {};
     }
     
@@ -157,8 +298,8 @@ QueueManager::TransferCommand QueueManager::allocateTransferCommand() {
     
     command.fence = vulkan_raii::create_fence(context, &fenceInfo);
     if (!command.fence) {
-        std::cerr << "QueueManager: Failed to create transfer fence" << std::endl;
-        vk.vkFreeCommandBuffers(device, transferCommandPool.get(), 1, &command.commandBuffer);
+        std::cerr << "QueueManager: Failed to create " << poolName << " fence" << std::endl;
+        vk.vkFreeCommandBuffers(device, pool, 1, &command.commandBuffer);
         return {};
     }
     
@@ -171,20 +312,112 @@ void QueueManager::freeTransferCommand(TransferCommand& command) {
         return;
     }
     
+    recycleCommand(getRecycler(command.sourcePool), std::move(command));
+    command.commandBuffer = VK_NULL_HANDLE;
+    command.sourcePool = VK_NULL_HANDLE;
+    
+    telemetry.recordTransferDeallocation();
+}
+
+void QueueManager::retireTransferCommand(TransferCommand& command) {
+    if (!context || !command.isValid()) {
+        return;
+    }
+    
+    CommandRecycler* recycler = getRecycler(command.sourcePool);
+    if (recycler) {
+        recycler->retired.push_back(std::move(command));
+    } else {
+        waitForTransfer(command);
+        destroyCommand(command);
+    }
+    command.commandBuffer = VK_NULL_HANDLE;
+    command.sourcePool = VK_NULL_HANDLE;
+    
+    telemetry.recordTransferDeallocation();
+}
+
+uint32_t QueueManager::pollCompletedTransfers() {
+    if (!context) {
+        return 0;
+    }
+    return collectRetiredCommands(transferRecycler) + collectRetiredCommands(backgroundComputeRecycler);
+}
+
+QueueManager::CommandRecycler* QueueManager::getRecycler(VkCommandPool pool) {
+    if (pool == VK_NULL_HANDLE) {
+        return nullptr;
+    }
+    if (pool == transferCommandPool.get()) {
+        return &transferRecycler;
+    }
+    if (pool == backgroundComputeCommandPool.get()) {
+        return &backgroundComputeRecycler;
+    }
+    return nullptr;
+}
+
+void QueueManager::recycleCommand(CommandRecycler* recycler, TransferCommand&& command) {
+    if (recycler && recycler->ready.size() + recycler->pendingReset.size() < MAX_RECYCLED_COMMANDS) {
+        recycler->pendingReset.push_back(std::move(command));
+        return;
+    }
+    TransferCommand released = std::move(command);
+    destroyCommand(released);
+}
+
+uint32_t QueueManager::collectRetiredCommands(CommandRecycler& recycler) {
     const auto& vk = context->getLoader();
     const VkDevice device = context->getDevice();
     
-    // Free command buffer
+    uint32_t completed = 0;
+    for (size_t i = 0; i < recycler.retired.size();) {
+        if (vk.vkGetFenceStatus(device, recycler.retired[i].fence.get()) != VK_SUCCESS) {
+            ++i;
+            continue;
+        }
+        TransferCommand command = std::move(recycler.retired[i]);
+        if (i + 1 < recycler.retired.size()) {
+            recycler.retired[i] = std::move(recycler.retired.back());
+        }
+        recycler.retired.pop_back();
+        recycleCommand(&recycler, std::move(command));
+        ++completed;
+    }
+    return completed;
+}
+
+void QueueManager::resetPendingCommands(CommandRecycler& recycler) {
+    if (recycler.pendingReset.empty()) {
+        return;
+    }
+    
+    fenceResetScratch.clear();
+    for (const auto& command : recycler.pendingReset) {
+        fenceResetScratch.push_back(command.fence.get());
+    }
+    
+    VkResult result = context->getLoader().vkResetFences(context->getDevice(),
+        static_cast<uint32_t>(fenceResetScratch.size()), fenceResetScratch.data());
+    for (auto& command : recycler.pendingReset) {
+        if (result == VK_SUCCESS) {
+            recycler.ready.push_back(std::move(command));
+        } else {
+            destroyCommand(command);
+        }
+    }
+    recycler.pendingReset.clear();
+}
+
+void QueueManager::destroyCommand(TransferCommand& command) {
     if (command.commandBuffer != VK_NULL_HANDLE && command.sourcePool != VK_NULL_HANDLE) {
-        vk.vkFreeCommandBuffers(device, command.sourcePool, 1, &command.commandBuffer);
-        command.commandBuffer = VK_NULL_HANDLE;
+        context->getLoader().vkFreeCommandBuffers(context->getDevice(), command.sourcePool, 1, &command.commandBuffer);
     }
+    command.commandBuffer = VK_NULL_HANDLE;
+    command.sourcePool = VK_NULL_HANDLE;
     
     // RAII fence will clean up automatically
     command.fence.reset();
-    command.sourcePool = VK_NULL_HANDLE;
-    
-    telemetry.recordTransferDeallocation();
 }
 
 bool QueueManager::isTransferComplete(const TransferCommand& command) const {
@@ -206,23 +439,22 @@ void QueueManager::waitForTransfer(const TransferCommand& command) const {
 }
 
 void QueueManager::resetCommandBuffersForFrame(uint32_t frameIndex) {
-    if (!context) return;
+    if (!context || frameIndex >= framePools.size()) return;
     
     const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
     
-    // Reset graphics command buffer for this frame
-    if (frameIndex < graphicsCommandBuffers.size()) {
-        vk.vkResetCommandBuffer(graphicsCommandBuffers[frameIndex], 0);
-    }
-    
-    // Reset compute command buffer for this frame
-    if (frameIndex < computeCommandBuffers.size()) {
-        vk.vkResetCommandBuffer(computeCommandBuffers[frameIndex], 0);
+    // Every buffer of the slot returns to the initial state at once; the pools keep their memory for this frame
+    FrameCommandPools& pools = framePools[frameIndex];
+    vk.vkResetCommandPool(device, pools.graphics.get(), 0);
+    vk.vkResetCommandPool(device, pools.compute.get(), 0);
+    for (const auto& lanePool : pools.recordingLanes) {
+        vk.vkResetCommandPool(device, lanePool.get(), 0);
     }
 }
 
 void QueueManager::resetAllCommandBuffers() {
-    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+    for (uint32_t i = 0; i < static_cast<uint32_t>(framePools.size()); ++i) {
         resetCommandBuffersForFrame(i);
     }
 }
@@ -232,10 +464,13 @@ void QueueManager::logTelemetry() const {
     std::cout << "  Graphics submissions: " << telemetry.graphicsSubmissions << std::endl;
     std::cout << "  Compute submissions: " << telemetry.computeSubmissions << std::endl;
     std::cout << "  Transfer submissions: " << telemetry.transferSubmissions << std::endl;
+    std::cout << "  Background compute submissions: " << telemetry.backgroundComputeSubmissions << std::endl;
     std::cout << "  Present submissions: " << telemetry.presentSubmissions << std::endl;
+    std::cout << "  Merged frame submissions: " << telemetry.mergedFrameSubmissions << std::endl;
     std::cout << "  Active transfer commands: " << telemetry.activeTransferCommands << std::endl;
     std::cout << "  Peak transfer commands: " << telemetry.peakTransferCommands << std::endl;
     std::cout << "  Total transfer allocations: " << telemetry.totalTransferAllocations << std::endl;
+    std::cout << "  Recycled transfer allocations: " << telemetry.recycledTransferAllocations << std::endl;
 }
 
 bool QueueManager::createCommandPools() {
@@ -277,58 +512,91 @@ bool QueueManager::createCommandPools() {
         return false;
     }
     
+    // Background compute command pool, apart from the frame's so either side can reset without the other
+    VkCommandPoolCreateInfo backgroundPoolInfo{};
+    backgroundPoolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    backgroundPoolInfo.flags = getCommandPoolFlags(CommandPoolType::BackgroundCompute);
+    backgroundPoolInfo.queueFamilyIndex = getQueueFamilyForPool(CommandPoolType::BackgroundCompute);
+    
+    backgroundComputeCommandPool = vulkan_raii::create_command_pool(context, &backgroundPoolInfo);
+    if (!backgroundComputeCommandPool) {
+        std::cerr << "QueueManager: Failed to create background compute command pool" << std::endl;
+        return false;
+    }
+    
     return true;
 }
 
 bool QueueManager::createFrameCommandBuffers() {
-    if (!context || !graphicsCommandPool || !computeCommandPool) {
+    if (!context) {
         return false;
     }
     
-    // Allocate graphics command buffers
-    graphicsCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-    VkCommandBufferAllocateInfo graphicsAllocInfo{};
-    graphicsAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    graphicsAllocInfo.commandPool = graphicsCommandPool.get();
-    graphicsAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    graphicsAllocInfo.commandBufferCount = static_cast<uint32_t>(graphicsCommandBuffers.size());
-    
+    const uint32_t framesInFlight = context->getFramesInFlight();
+    const uint32_t graphicsFamily = getQueueFamilyForPool(CommandPoolType::Graphics);
+    const uint32_t computeFamily = getQueueFamilyForPool(CommandPoolType::Compute);
     const auto& vk = context->getLoader();
     const VkDevice device = context->getDevice();
     
-    if (vk.vkAllocateCommandBuffers(device, &graphicsAllocInfo, graphicsCommandBuffers.data()) != VK_SUCCESS) {
-        std::cerr << "QueueManager: Failed to allocate graphics command buffers" << std::endl;
-        return false;
-    }
-    
-    // Allocate compute command buffers
-    computeCommandBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-    VkCommandBufferAllocateInfo computeAllocInfo{};
-    computeAllocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
-    computeAllocInfo.commandPool = computeCommandPool.get();
-    computeAllocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
-    computeAllocInfo.commandBufferCount = static_cast<uint32_t>(computeCommandBuffers.size());
-    
-    if (vk.vkAllocateCommandBuffers(device, &computeAllocInfo, computeCommandBuffers.data()) != VK_SUCCESS) {
-        std::cerr << "QueueManager: Failed to allocate compute command buffers" << std::endl;
-        return false;
+    framePools.clear();
+    framePools.resize(framesInFlight);
+    recordingLaneCount = 0;
+    graphicsCommandBuffers.assign(framesInFlight, VK_NULL_HANDLE);
+    computeCommandBuffers.assign(framesInFlight, VK_NULL_HANDLE);
+    
+    for (uint32_t frame = 0; frame < framesInFlight; ++frame) {
+        FrameCommandPools& pools = framePools[frame];
+        pools.graphics = createTransientPool(graphicsFamily);
+        pools.compute = createTransientPool(computeFamily);
+        if (!pools.graphics || !pools.compute) {
+            std::cerr << "QueueManager: Failed to create command pools for frame " << frame << std::endl;
+            return false;
+        }
+        
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandBufferCount = 1;
+        
+        allocInfo.commandPool = pools.graphics.get();
+        if (vk.vkAllocateCommandBuffers(device, &allocInfo, &graphicsCommandBuffers[frame]) != VK_SUCCESS) {
+            std::cerr << "QueueManager: Failed to allocate graphics command buffers" << std::endl;
+            return false;
+        }
+        
+        allocInfo.commandPool = pools.compute.get();
+        if (vk.vkAllocateCommandBuffers(device, &allocInfo, &computeCommandBuffers[frame]) != VK_SUCCESS) {
+            std::cerr << "QueueManager: Failed to allocate compute command buffers" << std::endl;
+            return false;
+        }
     }
     
     return true;
 }
 
+vulkan_raii::CommandPool QueueManager::createTransientPool(uint32_t queueFamily) const {
+    // No RESET_COMMAND_BUFFER: buffers are only ever reset with their whole pool, which lets drivers skip
+    // per-buffer reset bookkeeping
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_TRANSIENT_BIT;
+    poolInfo.queueFamilyIndex = queueFamily;
+    return vulkan_raii::create_command_pool(context, &poolInfo);
+}
+
 VkCommandPoolCreateFlags QueueManager::getCommandPoolFlags(CommandPoolType type) const {
     switch (type) {
         case CommandPoolType::Graphics:
-            // Graphics: Persistent command buffers that can be reset individually
+            // Graphics: Persistent command buffers that can be reset individually (recorded replays, immediate commands)
             return VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
             
         case CommandPoolType::Compute:
-            // Compute: Short-lived dispatches, optimize for frequent allocation/deallocation
+            // Compute: Short-lived dispatches outside the frame; per-frame buffers use the slot pools instead
             return VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
             
         case CommandPoolType::Transfer:
-            // Transfer: One-time use command buffers
+        case CommandPoolType::BackgroundCompute:
+            // Transfer and background compute: One-time use command buffers
             return VK_COMMAND_POOL_CREATE_TRANSIENT_BIT | VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
             
         default:
@@ -343,6 +611,7 @@ uint32_t QueueManager::getQueueFamilyForPool(CommandPoolType type) const {
         case CommandPoolType::Graphics:
             return context->getGraphicsQueueFamily();
         case CommandPoolType::Compute:
+        case CommandPoolType::BackgroundCompute:
             return context->getComputeQueueFamily();
         case CommandPoolType::Transfer:
             return context->getTransferQueueFamily();
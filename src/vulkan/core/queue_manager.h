@@ -17,7 +17,8 @@ class VulkanContext;
 enum class CommandPoolType {
     Graphics,   // Persistent command buffers with reset capability
     Compute,    // Transient command buffers for short-lived dispatches  
-    Transfer    // One-time command buffers for async transfers
+    Transfer,   // One-time command buffers for async transfers
+    BackgroundCompute  // One-time command buffers for the low-priority compute queue
 };
 
 /**
@@ -40,6 +41,7 @@ public:
     VkQueue getComputeQueue() const;
     VkQueue getTransferQueue() const;
     VkQueue getPresentQueue() const;
+    VkQueue getBackgroundComputeQueue() const;  // Frame compute queue when the family has no second queue
     
     // Queue family indices
     uint32_t getGraphicsQueueFamily() const;
@@ -51,15 +53,31 @@ public:
     bool hasDedicatedComputeQueue() const;
     bool hasDedicatedTransferQueue() const;
     bool supportsAsyncCompute() const;
+    bool hasBackgroundComputeQueue() const;
     
     // Specialized command pool access
     VkCommandPool getCommandPool(CommandPoolType type) const;
     
-    // Frame-based command buffer management (graphics/compute)
+    // Frame-based command buffer management (graphics/compute): one primary of each per frame slot, allocated
+    // from that slot's transient pools, so they are only valid to record after resetCommandBuffersForFrame
     VkCommandBuffer getGraphicsCommandBuffer(uint32_t frameIndex) const;
     VkCommandBuffer getComputeCommandBuffer(uint32_t frameIndex) const;
     
-    // One-time command buffer allocation (transfer)
+    // Graphics command buffers per frame slot and swapchain image, kept recorded across frames for replay.
+    // Reallocating for a new image count frees the previous set, so callers must have drained the GPU
+    bool allocateRecordedGraphicsCommandBuffers(uint32_t imageCount);
+    VkCommandBuffer getRecordedGraphicsCommandBuffer(uint32_t frameIndex, uint32_t imageIndex) const;
+    uint32_t getRecordedImageCount() const { return recordedImageCount; }
+    
+    // One compute-family pool per frame graph recording lane and frame slot; a lane's secondaries are only ever
+    // recorded by that lane, so the pools need no locking, and they are reset with the slot's other pools.
+    // Allocation happens at compile time, never while lanes record
+    bool createRecordingCommandPools(uint32_t laneCount);
+    VkCommandBuffer allocateRecordingCommandBuffer(uint32_t lane, uint32_t frameIndex);
+    uint32_t getRecordingLaneCount() const { return recordingLaneCount; }
+    
+    // One-time command buffer allocation (transfer). Freed commands keep their buffer and fence for the next
+    // allocation from the same pool; their fences are reset in one batch when the ready list runs dry
     struct TransferCommand {
         VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
         vulkan_raii::Fence fence;
@@ -69,31 +87,44 @@ public:
     };
     
     TransferCommand allocateTransferCommand();
-    void freeTransferCommand(TransferCommand& command);
+    void freeTransferCommand(TransferCommand& command);  // Completed or never submitted
+    // Hands back a command that may still be in flight; it is recycled once its fence signals
+    void retireTransferCommand(TransferCommand& command);
+    // Recycles retired commands whose fences have signalled, without waiting; returns how many
+    uint32_t pollCompletedTransfers();
     bool isTransferComplete(const TransferCommand& command) const;
     void waitForTransfer(const TransferCommand& command) const;
     
-    // Command buffer lifecycle management
+    // One-time compute family command for getBackgroundComputeQueue(), render thread only; completes and is
+    // freed like a transfer command. Background submissions never wait on or signal the frame timelines
+    TransferCommand allocateBackgroundComputeCommand();
+    
+    // Command buffer lifecycle management: one vkResetCommandPool per transient pool of the slot, keeping the
+    // pools' memory for the next recording. Call once the slot's last submissions have completed, before it records
     void resetCommandBuffersForFrame(uint32_t frameIndex);
-    void resetAllCommandBuffers();
+    void resetAllCommandBuffers();  // Every slot; the GPU must be idle
     
     // Queue utilization telemetry
     struct QueueTelemetry {
         uint64_t graphicsSubmissions = 0;
         uint64_t computeSubmissions = 0;
         uint64_t transferSubmissions = 0;
+        uint64_t backgroundComputeSubmissions = 0;
         uint64_t presentSubmissions = 0;
+        uint64_t mergedFrameSubmissions = 0;  // Frames whose compute and graphics shared one queue submit
         
         // Command buffer allocation tracking
         uint32_t activeTransferCommands = 0;
         uint32_t peakTransferCommands = 0;
         uint32_t totalTransferAllocations = 0;
+        uint32_t recycledTransferAllocations = 0;  // Served from a recycled buffer and fence
         
         void recordSubmission(CommandPoolType type) {
             switch (type) {
                 case CommandPoolType::Graphics: ++graphicsSubmissions; break;
                 case CommandPoolType::Compute: ++computeSubmissions; break;
                 case CommandPoolType::Transfer: ++transferSubmissions; break;
+                case CommandPoolType::BackgroundCompute: ++backgroundComputeSubmissions; break;
             }
         }
         
@@ -121,17 +152,50 @@ private:
     vulkan_raii::CommandPool graphicsCommandPool;
     vulkan_raii::CommandPool computeCommandPool;
     vulkan_raii::CommandPool transferCommandPool;
+    vulkan_raii::CommandPool backgroundComputeCommandPool;
+    
+    // Transient pools of one frame slot, reset as a whole rather than per command buffer
+    struct FrameCommandPools {
+        vulkan_raii::CommandPool graphics;
+        vulkan_raii::CommandPool compute;
+        std::vector<vulkan_raii::CommandPool> recordingLanes;  // Secondaries, freed with their pool
+    };
+    std::vector<FrameCommandPools> framePools;
+    uint32_t recordingLaneCount = 0;
     
-    // Frame-based command buffers
+    // Frame-based command buffers, from framePools
     std::vector<VkCommandBuffer> graphicsCommandBuffers;
     std::vector<VkCommandBuffer> computeCommandBuffers;
     
+    // Recorded graphics command buffers, indexed frameIndex * recordedImageCount + imageIndex. Replayed across
+    // frames, so they come from the persistent graphics pool and are re-recorded one at a time
+    std::vector<VkCommandBuffer> recordedGraphicsCommandBuffers;
+    uint32_t recordedImageCount = 0;
+    
+    // Recycled one-time commands of one pool, at most MAX_RECYCLED_COMMANDS kept between ready and pendingReset
+    static constexpr size_t MAX_RECYCLED_COMMANDS = 32;
+    struct CommandRecycler {
+        std::vector<TransferCommand> ready;         // Fence unsignalled; the buffer resets on begin
+        std::vector<TransferCommand> pendingReset;  // Completed or unsubmitted, fence awaiting the batched reset
+        std::vector<TransferCommand> retired;       // Handed back while possibly in flight
+    };
+    CommandRecycler transferRecycler;
+    CommandRecycler backgroundComputeRecycler;
+    std::vector<VkFence> fenceResetScratch;
+    
     // Telemetry tracking
     mutable QueueTelemetry telemetry;
     
     // Internal command pool creation
     bool createCommandPools();
     bool createFrameCommandBuffers();
+    vulkan_raii::CommandPool createTransientPool(uint32_t queueFamily) const;
+    TransferCommand allocateOneTimeCommand(VkCommandPool pool, const char* poolName);
+    CommandRecycler* getRecycler(VkCommandPool pool);
+    void recycleCommand(CommandRecycler* recycler, TransferCommand&& command);
+    uint32_t collectRetiredCommands(CommandRecycler& recycler);
+    void resetPendingCommands(CommandRecycler& recycler);
+    void destroyCommand(TransferCommand& command);
     
     // Helper methods
     VkCommandPoolCreateFlags getCommandPoolFlags(CommandPoolType type) const;
@@ -3,12 +3,202 @@
 #include <vulkan/vulkan.h>
 #include <cstddef>
 
-inline constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 2;
+// Frames-in-flight depth is a runtime setting (VulkanContext::getFramesInFlight) within these bounds
+inline constexpr uint32_t MIN_FRAMES_IN_FLIGHT = 2;
+inline constexpr uint32_t MAX_FRAMES_IN_FLIGHT = 4;      // Upper bound for fixed-size per-frame storage
+inline constexpr uint32_t DEFAULT_FRAMES_IN_FLIGHT = 2;  // 2 favors input latency, 3 favors throughput on heavy scenes
+
+// Physical device override when VulkanContext::setPreferredDevice was not given one: a case-insensitive name
+// substring or a device UUID (32 hex digits, dashes ignored). Otherwise the highest ranked suitable device is used
+inline constexpr const char* GPU_OVERRIDE_ENV = "FRACTALIA_GPU";
+
+// Second queue in the compute family, when the family exposes one, for work that must never delay a frame:
+// uploads without a dedicated transfer family, diagnostics and other standalone submissions. The frame's compute
+// and graphics submissions stay on queue 0 at full priority
+constexpr bool ENABLE_BACKGROUND_COMPUTE_QUEUE = true;
+inline constexpr float FRAME_QUEUE_PRIORITY = 1.0f;
+inline constexpr float BACKGROUND_QUEUE_PRIORITY = 0.2f;
 
 constexpr uint64_t FENCE_TIMEOUT_IMMEDIATE = 0;
 constexpr uint64_t FENCE_TIMEOUT_FRAME = 16000000;
 constexpr uint64_t FENCE_TIMEOUT_2_SECONDS = 2000000000ULL;
 
+// Frame pacing on one timeline semaphore per queue (VK_KHR_timeline_semaphore), per-slot fences when unsupported
+constexpr bool ENABLE_TIMELINE_FRAME_PACING = true;
+
+// Hang detection: DeviceHealthMonitor's watchdog thread polls the timeline values (or how long the frame loop has
+// been inside a fence wait) every DEVICE_HEALTH_POLL_MS and reports submitted work that made no progress for
+// DEVICE_HANG_TIMEOUT_MS. Breadcrumbs (VK_AMD_buffer_marker, else VK_NV_device_diagnostic_checkpoints) name the
+// frame graph node each queue was last in
+constexpr bool ENABLE_DEVICE_HEALTH_MONITOR = true;
+constexpr bool ENABLE_GPU_BREADCRUMBS = true;
+inline constexpr uint32_t DEVICE_HEALTH_POLL_MS = 100;
+inline constexpr uint32_t DEVICE_HANG_TIMEOUT_MS = 2000;
+
+// CPU frame rate limit (--fps, 0 = uncapped): FramePacer sleeps to a per-frame deadline and spins the last
+// FRAME_PACING_SPIN_MICROSECONDS; with VK_KHR_present_wait it first waits until at most one present is queued
+inline constexpr uint32_t DEFAULT_FRAME_RATE_LIMIT = 90;
+inline constexpr uint32_t FRAME_PACING_SPIN_MICROSECONDS = 1000;
+constexpr bool ENABLE_PRESENT_WAIT_PACING = true;
+constexpr uint64_t PRESENT_WAIT_TIMEOUT_NS = 100000000ULL;  // Never stall a frame on a lost present for longer
+
+// Input-to-present latency (PresentTimingMonitor, logged every 300 frames): presents complete at the display time
+// VK_GOOGLE_display_timing reports, else when a present wait sees them on screen
+constexpr bool ENABLE_DISPLAY_TIMING = true;
+
+// Camera late latch (--no-camera-latch, --camera-prediction MS): the frame UBO's camera matrices are rewritten with
+// the newest published camera right before the graphics submit (CameraLatch)
+constexpr bool ENABLE_CAMERA_LATE_LATCH = true;
+
+// Render quality (--msaa N, --render-scale S, F4/F5 at runtime): the MSAA sample count is clamped to what the
+// device supports for colour framebuffers, and a render scale other than 1 draws into an offscreen image of the
+// scaled extent that is blitted to the swapchain image
+inline constexpr VkSampleCountFlagBits DEFAULT_MSAA_SAMPLES = VK_SAMPLE_COUNT_2_BIT;
+inline constexpr float DEFAULT_RENDER_SCALE = 1.0f;
+inline constexpr float MIN_RENDER_SCALE = 0.25f;
+inline constexpr float MAX_RENDER_SCALE = 2.0f;
+
+// Adaptive quality (--no-quality-governor, --target-frame-ms X): QualityGovernor holds the frame time target, the
+// frame rate limit's period or QUALITY_GOVERNOR_UNCAPPED_TARGET_MS uncapped. Each window it compares the longer of
+// the average CPU frame time and the summed node GPU times with the target; above target * DEGRADE_MARGIN it steps
+// the first knob that has room (collision stride, render scale, MSAA, density LOD threshold, physics idle speed)
+// one notch down, and below target * RESTORE_MARGIN for RESTORE_WINDOWS windows in a row it undoes the last step
+constexpr bool ENABLE_QUALITY_GOVERNOR = true;
+constexpr float QUALITY_GOVERNOR_UNCAPPED_TARGET_MS = 1000.0f / 60.0f;
+constexpr uint32_t QUALITY_GOVERNOR_WINDOW_FRAMES = 60;
+constexpr float QUALITY_GOVERNOR_DEGRADE_MARGIN = 1.05f;
+constexpr float QUALITY_GOVERNOR_RESTORE_MARGIN = 0.75f;
+constexpr uint32_t QUALITY_GOVERNOR_RESTORE_WINDOWS = 3;
+constexpr uint32_t QUALITY_GOVERNOR_MAX_RESTORE_BACKOFF = 8;  // Restores undone within RESTORE_WINDOWS double the wait, up to this
+
+// Presentation policy (--present-policy low-latency|power-saver|max-fps, F6 at runtime): present mode preference and
+// swapchain image count, applied through swapchain recreation. The policy's frames-in-flight depth is only the
+// startup default when --frames-in-flight is not given, since per-frame storage is sized once
+enum class PresentPolicy : uint32_t {
+    LowLatency,      // IMMEDIATE, then MAILBOX; one image above the surface minimum, 2 frames in flight
+    PowerSaver,      // FIFO_RELAXED (adaptive vsync), then FIFO; never renders faster than the display refreshes
+    TearFreeMaxFps   // MAILBOX, then FIFO; an image per frame in flight above the minimum, 3 frames in flight
+};
+inline constexpr PresentPolicy DEFAULT_PRESENT_POLICY = PresentPolicy::TearFreeMaxFps;
+
+// Frame graph barriers through vkCmdPipelineBarrier2 (VK_KHR_synchronization2), legacy barriers when unsupported;
+// split barriers set an event after the producer and wait before the consumer when unrelated passes sit between
+constexpr bool ENABLE_SYNCHRONIZATION2 = true;
+constexpr bool ENABLE_SPLIT_BARRIERS = true;
+
+// Entity drawing through vkCmdBeginRenderingKHR (VK_KHR_dynamic_rendering) directly on the swapchain's image views,
+// with the MSAA resolve declared inline; render pass and framebuffer objects when unsupported
+constexpr bool ENABLE_DYNAMIC_RENDERING = true;
+
+// Compaction kernels (culling, despawn classify) append through subgroup ballots (VK_EXT_shader_subgroup_ballot,
+// which needs shaderInt64) in their .ballot variants; shared-memory appends of the same results otherwise
+constexpr bool ENABLE_SUBGROUP_BALLOT = true;
+
+// Pipelined async compute (needs timeline pacing): compute N publishes positions and the culled draw into
+// snapshot N % PUBLISHED_SNAPSHOT_COUNT while graphics N draws the newest earlier one; frames that move entity
+// slots draw their own. Each extra snapshot in the ring lets compute start one more frame ahead of the graphics
+// frames still drawing older ones (two with three), at 20 bytes per entity of capacity each
+constexpr bool ENABLE_PIPELINED_ASYNC_COMPUTE = true;
+constexpr uint32_t PUBLISHED_SNAPSHOT_COUNT = 3;
+static_assert(PUBLISHED_SNAPSHOT_COUNT >= 2 && PUBLISHED_SNAPSHOT_COUNT <= 32,
+              "The snapshot ring needs a slot to draw besides the one being published, and acquires are a 32-bit mask");
+
+// --export-positions: the published snapshots are allocated as dedicated exportable memory (opaque fd, or opaque
+// Win32 handles on Windows) next to an exported timeline semaphore, so a consumer process on the same device can
+// import them and read the newest completed frame without any copy. Needs the external memory and semaphore
+// extensions, and pipelined async compute to publish the ring
+constexpr bool ENABLE_EXTERNAL_POSITION_EXPORT = true;
+#if defined(VK_USE_PLATFORM_WIN32_KHR)
+constexpr VkExternalMemoryHandleTypeFlagBits EXTERNAL_MEMORY_HANDLE_TYPE = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_WIN32_BIT_KHR;
+constexpr VkExternalSemaphoreHandleTypeFlagBits EXTERNAL_SEMAPHORE_HANDLE_TYPE = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_WIN32_BIT_KHR;
+#else
+constexpr VkExternalMemoryHandleTypeFlagBits EXTERNAL_MEMORY_HANDLE_TYPE = VK_EXTERNAL_MEMORY_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
+constexpr VkExternalSemaphoreHandleTypeFlagBits EXTERNAL_SEMAPHORE_HANDLE_TYPE = VK_EXTERNAL_SEMAPHORE_HANDLE_TYPE_OPAQUE_FD_BIT_KHR;
+#endif
+
+// --simulation-gpu: the device is created over a device group of the rendering GPU (device index 0, which
+// acquires, draws and presents) and a second GPU that runs the frame graph's compute batch. Device-local memory
+// is replicated per GPU, so the publish writes each snapshot, and the graphics-read streams after slots moved or
+// were uploaded, into the rendering GPU's instance through peer memory. Needs timeline pacing, pipelined async
+// compute and peer copy writes; sparse entity buffers, position export and buffer device addresses stay off
+constexpr bool ENABLE_MULTI_DEVICE_SIMULATION = true;
+
+// Replay the graphics queue's recorded command buffer (one per frame slot and swapchain image) while every
+// graphics node reports an unchanged recording key; compute is re-recorded each frame
+constexpr bool ENABLE_RECORDED_COMMAND_REUSE = true;
+
+// Recording lanes for frame graph levels with several independent compute nodes (lane 0 is the calling
+// thread, each further lane a persistent worker with its own command pool); 1 records everything inline
+constexpr uint32_t FRAME_GRAPH_RECORDING_LANES = 3;
+
+// GPU timestamps around every frame graph node, in one query pool per frame slot read back without waiting
+// when the slot is recorded again; nodes past the cap go untimed. Rolling min/avg/p99 cover the window
+constexpr bool ENABLE_GPU_NODE_TIMESTAMPS = true;
+constexpr uint32_t GPU_NODE_TIMESTAMP_MAX_NODES = 64;
+constexpr uint32_t GPU_NODE_TIMING_WINDOW = 120;  // Samples per node
+
+// GPU timestamps are placed on the steady clock (the Profiler's, and so the trace's) through a
+// VK_EXT_calibrated_timestamps pair of device and host readings, retaken every GPU_CLOCK_RECALIBRATION_MS to
+// follow the drift between the two clocks. Without the extension the offset is bounded from readback times,
+// which places GPU zones late by up to the readback delay
+constexpr bool ENABLE_CALIBRATED_TIMESTAMPS = true;
+constexpr uint32_t GPU_CLOCK_RECALIBRATION_MS = 1000;
+constexpr uint64_t GPU_CLOCK_MAX_DEVIATION_NS = 50000;  // Calibrations less exact than this are retried
+
+// Opt-in pipeline statistics (shader invocations, clipping primitives) for nodes that request them, reported
+// next to their timestamps; needs the pipelineStatisticsQuery device feature and adds a query per timed node
+constexpr bool ENABLE_GPU_PIPELINE_STATISTICS = false;
+
+// Pipelines are created with CAPTURE_STATISTICS under VK_KHR_pipeline_executable_properties, and the driver's
+// per-executable register, spill, scratch and shared memory figures are kept next to each cached pipeline for the
+// performance HUD. Compile-time cost only; pipelines that spill are reported when created
+constexpr bool ENABLE_PIPELINE_EXECUTABLE_STATISTICS = true;
+
+// Graphics pipelines linked from per-part libraries (VK_EXT_graphics_pipeline_library) that permutations share,
+// instead of compiling every MSAA/pick/shader variant whole; only on devices that link them fast
+constexpr bool ENABLE_GRAPHICS_PIPELINE_LIBRARY = true;
+
+// Performance HUD (F8): PerformanceHudNode draws frame times, per-node GPU time and memory figures over the
+// swapchain image as instanced quads (needs dynamic rendering). The figures are rebuilt every
+// PERFORMANCE_HUD_REFRESH_FRAMES frames so they stay readable; the frame time graph moves every frame
+constexpr uint32_t PERFORMANCE_HUD_FRAME_HISTORY = 120;   // Graph columns, one frame each
+constexpr uint32_t PERFORMANCE_HUD_MAX_QUADS = 1536;      // Instances drawn every frame, unused ones zero-sized
+constexpr uint32_t PERFORMANCE_HUD_REFRESH_FRAMES = 15;
+
+// Debug overlay (F3): DebugOverlayNode draws the spatial grid cells shaded by occupancy and every entity's bounding
+// circle, coloured by its collision state, over the presented image as two instanced draws straight from the
+// entity buffers (needs dynamic rendering). Nothing is read back, so it costs the same at any entity count
+constexpr uint32_t DEBUG_OVERLAY_CIRCLE_SEGMENTS = 12;  // Line segments per bounding circle
+
+// Overdraw diagnostic (F9): the entity pass switches to a fragment shader variant that also adds one per shaded
+// fragment into an R32_UINT count image at the render extent (needs fragmentStoresAndAtomics), and OverdrawNode
+// reduces the image with overdraw_histogram.comp into the average fragments per covered pixel, the maximum and a
+// histogram, read back frames-in-flight late for the HUD and metrics. With dynamic rendering the counts are also
+// drawn over the presented image as a heat map. Bins are log2 like the spatial occupancy histogram: bin 0 counts
+// uncovered pixels, bin b pixels shaded at least 2^(b-1) times, the last bin open-ended
+constexpr bool ENABLE_OVERDRAW_DIAGNOSTIC = true;
+constexpr uint32_t OVERDRAW_HISTOGRAM_BINS = 8;          // 0, 1, 2-3, 4-7, ..., 64+ fragments per pixel
+constexpr uint32_t OVERDRAW_HEAT_MAP_SATURATION = 32;    // Fragments per pixel at the top of the heat ramp
+
+// Session recording (--record): SwapchainCaptureNode copies every presented image into a capture image of the
+// fixed recording extent and converts it to YUV 4:2:0 on the GPU. With ENABLE_VIDEO_ENCODE and a device exposing
+// VK_KHR_video_encode_h264 the frames are encoded on the video encode queue into an H.264 elementary stream;
+// otherwise they are read back and written as Y4M, or piped into --record-encoder. In both cases a JobSystem
+// worker writes the file. A frame finding its slot still encoding or being written is dropped, not waited for
+constexpr bool ENABLE_VIDEO_ENCODE = true;
+constexpr uint32_t RECORDING_DEFAULT_GOP = 120;        // Frames from one IDR picture to the next
+constexpr uint32_t RECORDING_DEFAULT_QP = 24;          // Constant QP where the encoder can run without rate control
+constexpr uint32_t RECORDING_FRAME_RATE = 60;          // Rate the Y4M header declares; frames are recorded as presented
+constexpr uint32_t RECORDING_EXTENT_ALIGNMENT = 16;    // Recording extent is the first frame's rounded down to macroblocks
+
+// Metrics export (--metrics-port, --statsd): VulkanRenderer publishes its telemetry into a fixed-size registry
+// every METRICS_PUBLISH_FRAMES frames; MetricsExporter serves it as Prometheus text on /metrics and/or pushes it
+// to StatsD over UDP from its own thread
+constexpr uint32_t METRICS_REGISTRY_CAPACITY = 256;       // Metric slots, labelled series included
+constexpr uint32_t METRICS_PUBLISH_FRAMES = 30;
+constexpr uint32_t METRICS_STATSD_INTERVAL_MS = 1000;
+constexpr uint16_t METRICS_STATSD_DEFAULT_PORT = 8125;
+
 constexpr uint32_t GPU_ENTITY_SIZE = 128;
 
 // Cache and Pool Sizes
@@ -19,17 +209,272 @@ constexpr uint32_t DEFAULT_SHADER_CACHE_SIZE = 512;
 constexpr uint32_t DEFAULT_LAYOUT_CACHE_SIZE = 256;
 constexpr uint64_t CACHE_CLEANUP_INTERVAL = 1000;  // frames
 
+// Per-frame transient descriptor arenas chain pools of TRANSIENT_DESCRIPTOR_POOL_SETS sets, each pool holding
+// TRANSIENT_DESCRIPTORS_PER_SET descriptors of every buffer and image type per set
+constexpr uint32_t TRANSIENT_DESCRIPTOR_POOL_SETS = 64;
+constexpr uint32_t TRANSIENT_DESCRIPTORS_PER_SET = 8;
+
+// Driver pipeline caches are loaded at startup and written back at shutdown, one file per pipeline manager
+constexpr bool ENABLE_PERSISTENT_PIPELINE_CACHE = true;
+inline constexpr const char* PIPELINE_CACHE_DIRECTORY = "pipeline_cache";
+
+// GLSL compiled at runtime is kept as SPIR-V here, named by a content hash of the source, its includes, the
+// defines and the stage; compiles run as JobSystem jobs
+inline constexpr const char* SHADER_SPIRV_CACHE_DIRECTORY = "shader_cache";
+
 // Compute Configuration
 constexpr uint32_t THREADS_PER_WORKGROUP = 64;
+constexpr uint32_t COMPUTE_MAX_WORKGROUPS_X = 65535;  // maxComputeWorkGroupCount[0] of every device; movement goes 2D past it
 constexpr uint32_t MAX_WORKGROUPS_PER_CHUNK = 512;
+constexpr uint32_t MIN_WORKGROUPS_PER_CHUNK = 64;
+constexpr float COMPUTE_NODE_GPU_BUDGET_MS = 4.0f;  // Measured p99 above which movement dispatches are chunked smaller
+
+// Movement and physics kernels take local_size_x from this specialization constant; with tuning on, each
+// device's size is chosen from timed candidates and kept beside the pipeline cache
+constexpr uint32_t COMPUTE_WORKGROUP_SIZE_CONSTANT_ID = 4;
+constexpr bool ENABLE_WORKGROUP_SIZE_TUNING = true;
+
+// Physics shader permutation (ComputeShaderFeatures), passed as specialization constants after the workgroup size
+constexpr uint32_t COMPUTE_FEATURE_COLLISIONS_CONSTANT_ID = 5;
+constexpr uint32_t COMPUTE_FEATURE_CELL_CAPACITY_CONSTANT_ID = 6;
+constexpr uint32_t COMPUTE_FEATURE_SLEEPING_CONSTANT_ID = 7;
+constexpr uint32_t PHYSICS_MAX_ENTITIES_PER_CELL = 64;          // Neighbours tested per grid cell by default
+constexpr uint32_t PHYSICS_TILED_MAX_ENTITIES_PER_CELL = 128;   // Keeps the tiled kernel's 3x3 tile under 16 KB of shared memory
+
+// Collision budget (--collision-stride N): each tick only every Nth entity (cell, for the tiled kernel) runs the
+// neighbour test, interleaved by the tick counter, while the rest only integrate. 0 lets PhysicsComputeNode pick
+// the stride from its measured GPU p99, up to PHYSICS_MAX_COLLISION_STRIDE
+constexpr uint32_t PHYSICS_COLLISION_STRIDE = 1;
+constexpr uint32_t PHYSICS_MAX_COLLISION_STRIDE = 8;
+constexpr float PHYSICS_COLLISION_GPU_BUDGET_MS = 4.0f;
+
+// Speed below which physics neither integrates an entity nor keeps it awake (push constant, raised by QualityGovernor)
+constexpr float PHYSICS_IDLE_SPEED = 0.01f;
+
+// Spatial Grid Configuration (dimensions chosen at runtime, passed to spatial_*.comp and physics.comp via push constants)
+constexpr uint32_t SPATIAL_GRID_MIN_DIMENSION = 64;     // Power of 2
+constexpr uint32_t SPATIAL_GRID_MAX_DIMENSION = 1024;   // Power of 2, 1M cells (8MB)
+constexpr float SPATIAL_CELL_SIZE = 1.5f;
+constexpr float SPATIAL_WORLD_EXTENT = 768.0f;          // Minimum world width/height covered without hash aliasing
+constexpr uint32_t SPATIAL_PREFIX_SUM_THREADS = 256;
+
+// Automatic cell size (--auto-cell-size, SpatialCellTuner): each interval the cell size moves by a factor of sqrt(2)
+// to bring the entity-weighted cell occupancy back into [LOW, HIGH], from SPATIAL_CELL_SIZE down at most
+// MAX_SHRINK_STEPS or up MAX_GROW_STEPS steps (0.75 to 6 world units). The band must span more than a factor of 2
+constexpr float SPATIAL_CELL_TUNER_INTERVAL_MS = 2000.0f;
+constexpr float SPATIAL_CELL_TUNER_LOW_OCCUPANCY = 2.0f;
+constexpr float SPATIAL_CELL_TUNER_HIGH_OCCUPANCY = 8.0f;
+constexpr int32_t SPATIAL_CELL_TUNER_MAX_SHRINK_STEPS = 2;
+constexpr int32_t SPATIAL_CELL_TUNER_MAX_GROW_STEPS = 4;
+
+// Cell occupancy histogram of each grid build, written by spatial_prefix_sum.comp while enabled
+// (--occupancy-histogram): bin 0 counts empty cells, bin b cells of [2^(b-1), 2^b) entities and the last bin the rest
+constexpr uint32_t SPATIAL_OCCUPANCY_HISTOGRAM_BINS = 16;  // Must match simulation_counters.glsl
+
+// Movement random walk schedule (must match movement_random.comp and physics.comp)
+constexpr uint32_t MOVEMENT_CYCLE_LENGTH = 120;  // Simulation ticks between direction changes per entity
+constexpr uint32_t MOVEMENT_CYCLE_STAGGER = 37;  // Per-entity phase offset, coprime with MOVEMENT_CYCLE_LENGTH
+
+// Movement/physics fusion (movement_random.comp folded into physics.comp, EntityComputeNode not scheduled).
+// The fused kernel only knows the random walk, so RenderFrameDirector leaves it off under movement type dispatch
+constexpr bool FUSE_MOVEMENT_INTO_PHYSICS = true;
+
+// Movement type dispatch: movement_bin.comp sorts the frame's movers into one index list per MovementType (bits 8-15
+// of the entity type stream) and EntityComputeNode runs each type's kernel indirectly over its own list, so mixed
+// behaviours never share a wavefront and a new behaviour adds a kernel rather than a branch
+constexpr bool ENABLE_MOVEMENT_TYPE_DISPATCH = true;
+constexpr uint32_t MOVEMENT_TYPE_COUNT = 3;  // MovementType values, must match movement_bin.comp and EntityIndirectCommands
+
+// Under movement type dispatch, movement_commands.comp writes the frame's kernel binds and dispatches as device-generated
+// command sequences, skipping types with no movers, and EntityComputeNode records one vkCmdExecuteGeneratedCommandsEXT
+// rather than a bind, push and dispatch per type and tick; needs VK_EXT_device_generated_commands (and with it
+// VK_KHR_maintenance5 on a 1.1 device and buffer device addresses), the per-type loop otherwise
+constexpr bool ENABLE_DEVICE_GENERATED_COMMANDS = true;
+
+// Fixed-step simulation (--sim-rate N, 0 = one variable step per frame): movement and physics advance in ticks of
+// 1 / SIMULATION_TICK_RATE seconds, several per frame when behind and none when ahead, and the vertex shader blends
+// each entity from its previous tick position to its latest. Time beyond MAX_SIMULATION_TICKS_PER_FRAME is dropped
+constexpr bool ENABLE_FIXED_TIMESTEP_SIMULATION = true;
+inline constexpr uint32_t SIMULATION_TICK_RATE = 60;
+inline constexpr uint32_t MAX_SIMULATION_TICKS_PER_FRAME = 4;  // Must stay below MOVEMENT_CYCLE_LENGTH
+
+// Fast-forward (--fast-forward SECONDS): that much simulation time runs as fast as the GPU allows, this many ticks per
+// compute submission on frames that present nothing, and only the frame that finishes it is drawn. The grid and the
+// neighbour snapshot are built once per frame, so more ticks per frame collide against older positions
+inline constexpr uint32_t SIMULATION_FAST_FORWARD_TICKS_PER_FRAME = 16;
+inline constexpr uint32_t MAX_SIMULATION_FAST_FORWARD_TICKS_PER_FRAME = 64;  // Must stay below MOVEMENT_CYCLE_LENGTH
+
+// Procedural entity geometry: vertex.vert takes the triangle corners from gl_VertexIndex and the entity draw is
+// non-indexed, so there is no vertex input, vertex buffer or index buffer; false draws the PolygonFactory mesh
+constexpr bool ENABLE_PROCEDURAL_ENTITY_GEOMETRY = true;
+constexpr uint32_t ENTITY_PROCEDURAL_VERTEX_COUNT = 3;     // Must match ENTITY_SHAPE_CORNERS in vertex.vert
+
+// Expanded entity draw (needs procedural geometry): the culling pass counts visible entities into the vertex count
+// of one instance, and vertex.vert finds entity and corner from gl_VertexIndex, so vertex waves span several
+// entities instead of one 3-vertex instance each (constant_id 2 of entity_cull.comp and vertex.vert)
+constexpr bool ENABLE_EXPANDED_ENTITY_DRAW = true;
+
+// Entity shape binning (needs VK_KHR_draw_indirect_count): every entity carries an EntityShape in its type stream,
+// the culling pass counts visible entities per shape and entity_bin.comp regroups the list into one run per shape,
+// so a single count draw covers every PolygonFactory shape in the merged mesh. Takes precedence over procedural
+// geometry, which only knows the triangle; without the extension the paths above draw every entity as shape 0
+constexpr bool ENABLE_ENTITY_SHAPE_BINNING = true;
+constexpr uint32_t ENTITY_SHAPE_COUNT = 2;                 // EntityShape values, must match entity_cull.comp and entity_bin.comp
+
+// Early depth for overlapping entities: the entity pass gets a depth attachment the swapchain sizes with the MSAA
+// image, and vertex.vert writes a depth from the entity slot (constant_id 3), so the lowest slot is on top and
+// every fragment behind one already drawn fails the early depth test before shading. On frames that ran the spatial
+// grid, the culling pass also lists entities in grid cell order (constant_id 3 of entity_cull.comp), so nearby
+// triangles rasterize together. Depth is the first of D32_SFLOAT, X8_D24 and D16 the device can attach, since
+// D16 alone would give adjacent slots equal depths near ENTITY_CAPACITY_MAX
+constexpr bool ENABLE_ENTITY_EARLY_DEPTH = true;
+
+// Entity ID picking (needs VK_KHR_dynamic_rendering): the swapchain keeps an R32_UINT attachment beside the colour
+// target, and on frames with a queued pick the entity pass also writes spawn ID + 1 per fragment (constant_id 4 of
+// vertex.vert) and copies the picked pixel into the readback ring. Frames without a pick render as before. A pick
+// whose pipeline is still compiling waits up to ENTITY_PICK_MAX_PENDING_FRAMES frames before it is reported
+// unavailable and the caller falls back to the spatial search
+constexpr bool ENABLE_ENTITY_PICK_BUFFER = true;
+inline constexpr VkFormat ENTITY_PICK_FORMAT = VK_FORMAT_R32_UINT;
+inline constexpr uint32_t ENTITY_PICK_MAX_PENDING_FRAMES = 30;
+
+// GPU Culling Configuration
+constexpr float GPU_CULLING_ENTITY_RADIUS = 1.5f;  // Conservative bounding radius of an entity triangle (world units)
+
+// Density LOD: once an entity covers fewer than ENTITY_LOD_PIXEL_THRESHOLD pixels across (orthographic camera only),
+// the culling pass counts visible entities into a grid of screen tiles instead of compacting them, and the entity
+// pass draws the tiles as a heat map. Geometry returns above threshold * ENTITY_LOD_HYSTERESIS, so zooming near the
+// threshold does not flicker between the two. Fewer live entities than tiles always draw geometry
+constexpr bool ENABLE_DENSITY_LOD = true;
+constexpr float ENTITY_LOD_PIXEL_THRESHOLD = 1.5f;
+constexpr float ENTITY_LOD_HYSTERESIS = 1.25f;
+constexpr uint32_t ENTITY_LOD_TILE_COLUMNS = 128;          // Must match entity_cull.comp and entity_density.vert
+constexpr uint32_t ENTITY_LOD_TILE_ROWS = 72;
+constexpr uint32_t ENTITY_LOD_TILE_COUNT = ENTITY_LOD_TILE_COLUMNS * ENTITY_LOD_TILE_ROWS;
+
+// Multi-viewport entity pass: each active CameraService viewport (up to MAX_RENDER_VIEWPORTS, by render order) gets
+// a culling pass that accumulates a per-entity viewport mask, and one draw in the shared render pass. Entities seen
+// by several viewports are listed once, their mask in the top bits of the visible index (must match entity_cull.comp
+// and vertex.vert); density LOD only runs with a single viewport
+constexpr uint32_t MAX_RENDER_VIEWPORTS = 4;
+constexpr uint32_t ENTITY_VIEWPORT_MASK_SHIFT = 28;
+// Display wall windows (--output-windows): each takes one culling view after the main window's, which keeps at least one
+constexpr uint32_t MAX_OUTPUT_WINDOWS = MAX_RENDER_VIEWPORTS - 1;
+
+// Entity Reorder Configuration (cell-order permutation of SoA buffers)
+constexpr uint32_t ENTITY_REORDER_INTERVAL_FRAMES = 600;   // 0 disables periodic reordering
+constexpr uint32_t ENTITY_REORDER_STREAM_COUNT = 8;        // Permuted per-entity streams, must match entity_reorder.comp
+
+// Entity SoA layout (compact: fp16 movement params, packed runtime state flags, no model matrix stream, vec2
+// neighbour position snapshot).
+// Chosen once at EntityBufferManager::initialize; entity shaders specialise on it via constant_id 1.
+constexpr bool ENTITY_COMPACT_LAYOUT = false;
+constexpr uint32_t RUNTIME_STATE_INITIALIZED_BIT = 1u;     // Compact runtime state: low 16 bits flags, high 16 bits fp16 stateTimer
+
+// Entity Capacity Configuration (SoA buffers start small and double on demand up to the ceiling)
+constexpr uint32_t ENTITY_CAPACITY_INITIAL = 16384;        // Must leave room for the despawn work lists in the reorder scratch
+constexpr uint32_t ENTITY_CAPACITY_MAX = 1048576;          // Hard ceiling, 1M entities
+
+// Per-entity buffers reserve ENTITY_CAPACITY_MAX of address space as sparse residency buffers where the device
+// and its transfer queue support it; growth then binds pages (one vkQueueBindSparse) instead of reallocating and
+// copying, and handles, addresses and descriptors stay put
+constexpr bool ENABLE_SPARSE_ENTITY_BUFFERS = true;
+static_assert(ENTITY_CAPACITY_MAX <= (1u << ENTITY_VIEWPORT_MASK_SHIFT) &&
+              MAX_RENDER_VIEWPORTS <= 32 - ENTITY_VIEWPORT_MASK_SHIFT, "Visible index must hold entity index and viewport mask");
+
+// Entity Despawn Configuration (swap-with-last compaction, work lists staged in the reorder scratch buffer)
+constexpr uint32_t ENTITY_DESPAWN_MAX_BATCH = 16384;       // Spawn IDs per pass (64KB vkCmdUpdateBuffer limit), must match entity_despawn.comp
+
+// Entity Update Configuration (sparse ECS -> GPU sync of entities already resident, records staged in the reorder scratch buffer)
+constexpr uint32_t ENTITY_UPDATE_MAX_BATCH = 1024;         // 48-byte records per pass (64KB vkCmdUpdateBuffer limit)
+
+// Entity Spawn Configuration (GPU-initialised spawns from emitter records, records and spawn IDs staged in the reorder scratch buffer)
+constexpr uint32_t ENTITY_EMITTER_MAX_BATCH = 64;           // 48-byte emitter records per pass, must match entity_spawn.comp
+constexpr uint32_t ENTITY_EMITTER_MAX_SPAWNS = 16384;       // Entities per pass, one spawn ID each (64KB vkCmdUpdateBuffer limit), must match entity_spawn.comp
+
+// Entity Bounds Configuration (live AABB, centroid and count reduced after physics, partials in the indirect command buffer)
+constexpr uint32_t ENTITY_BOUNDS_WORKGROUPS = 64;           // Partials folded by one workgroup, so must equal THREADS_PER_WORKGROUP and entity_bounds.comp
+static_assert(ENTITY_BOUNDS_WORKGROUPS == THREADS_PER_WORKGROUP, "The last bounds workgroup folds one partial per invocation");
+
+// Spatial Query Configuration (batched radius / nearest queries over the frame's grid, staged in the reorder scratch buffer)
+constexpr uint32_t SPATIAL_QUERY_MAX_BATCH = 256;           // 16-byte queries per pass, must match spatial_query.comp
+constexpr uint32_t SPATIAL_QUERY_MAX_RESULTS = 16;          // Hits kept per query, nearest first, must match spatial_query.comp
+constexpr uint32_t SPATIAL_QUERY_MAX_CELL_RADIUS = 8;       // Rings of cells searched around a query's cell, must match spatial_query.comp
 
 // Memory Sizes (in bytes)
 constexpr size_t MEGABYTE = 1024 * 1024;
 constexpr size_t STAGING_BUFFER_SIZE = 16 * MEGABYTE;
+constexpr uint64_t STAGING_SEGMENT_IDLE_FRAMES = 120;      // Frames a grown staging segment may sit unused before it is freed
 constexpr size_t MAX_CHUNK_SIZE = 8 * MEGABYTE;
+constexpr size_t FRAME_RING_BYTES_PER_FRAME = 256 * 1024;  // Transient per-frame constants per frame in flight
+constexpr size_t READBACK_RING_BYTES_PER_FRAME = 128 * 1024; // GPU readback results per frame in flight
+constexpr uint32_t POSITION_MIRROR_CHUNK_ENTITIES = 1024;   // Slots per EntityPositionMirror readback (20KB of positions and IDs)
+constexpr uint32_t POSITION_MIRROR_CHUNKS_PER_FRAME = 2;    // Leaves two thirds of the readback ring to other readbacks (a full spatial query batch takes 34KB)
+constexpr size_t TELEMETRY_CAPTURE_RING_BYTES_PER_FRAME = 4 * MEGABYTE;  // Streaming readback ring: positions and velocities of 128k entities
+constexpr size_t TELEMETRY_CAPTURE_CHUNK_BYTES = 256 * 1024;  // Bytes per capture readback request
+constexpr uint32_t TELEMETRY_CAPTURE_QUEUE_DEPTH = 3;       // Captures buffered for the writer thread; a capture finding none free is dropped
+constexpr uint32_t TELEMETRY_CAPTURE_KEYFRAME_INTERVAL = 60; // Captures between records not delta-encoded against the previous one
+constexpr uint32_t ENTITY_STREAM_QUEUE_DEPTH = 2;           // Snapshots buffered for the stream sender; a snapshot finding none free is dropped
+constexpr uint32_t ENTITY_STREAM_STEPS_PER_CELL = 256;      // Position quantization per spatial grid cell
+constexpr uint32_t ENTITY_STREAM_ACK_WINDOW = 32;           // Unacknowledged sequences a client can still acknowledge, and states it keeps
+constexpr uint32_t ENTITY_STREAM_DATAGRAM_BYTES = 1200;     // Below a typical path MTU, so no datagram fragments
+constexpr uint32_t ENTITY_STREAM_MAX_CLIENTS = 8;
+constexpr uint32_t ENTITY_STREAM_MAX_BUDGET_BYTES = 16 * 1024 * 1024;  // Per client snapshot
+constexpr uint32_t ENTITY_STREAM_CLIENT_TIMEOUT_MS = 5000;  // Silence after which a client is dropped
+constexpr float ENTITY_STREAM_FOCUS_FALLOFF_CELLS = 16.0f;  // Cells from a client's focus at which a change ranks half as high
 constexpr size_t MIN_AVAILABLE_MEMORY = 500 * MEGABYTE;
-constexpr size_t LARGE_BUFFER_THRESHOLD = 50 * MEGABYTE;
+constexpr float BANDWIDTH_BOUND_PERCENT = 60.0f;  // Node bandwidth (% of the device peak estimate) GPUMemoryMonitor calls bandwidth-bound
+constexpr size_t ENTITY_GROWTH_BUDGET_HEADROOM = 128 * MEGABYTE;  // Device-local budget entity growth leaves free
+constexpr size_t LARGE_BUFFER_THRESHOLD = 50 * MEGABYTE;   // MemoryAllocator gives requests this size their own VkDeviceMemory
+constexpr size_t MEMORY_BLOCK_SIZE = 64 * MEGABYTE;         // MemoryAllocator sub-allocation block (1/8 of heaps under 512MB)
+
+// MemoryDefragmenter copies registered device-local buffers out of blocks at most this full into fuller blocks of
+// their pool on the transfer queue, so sparse blocks empty out and go back to the driver
+constexpr bool ENABLE_MEMORY_DEFRAGMENTATION = true;
+constexpr float DEFRAG_SOURCE_BLOCK_OCCUPANCY = 0.5f;
+constexpr size_t DEFRAG_BYTES_PER_FRAME = 8 * MEGABYTE;     // Copies scheduled per frame; larger buffers stay put
+constexpr uint64_t DEFRAG_RETRY_FRAMES = 120;               // Frames before a buffer with nowhere to go is tried again
+
+// Small buffers the CPU rewrites every frame go to DEVICE_LOCAL | HOST_VISIBLE memory (resizable BAR, or the
+// 256MB BAR window without it) when the device has such a type; the budget caps what they may take of that heap
+constexpr bool ENABLE_DEVICE_LOCAL_HOST_WRITES = true;
+constexpr size_t HOST_WRITE_MAX_BUFFER_SIZE = 4 * MEGABYTE;
+constexpr size_t HOST_WRITE_DEVICE_LOCAL_BUDGET = 64 * MEGABYTE;  // Never more than a quarter of the heap
 
 // Bindless Limits
 constexpr uint32_t MAX_BINDLESS_TEXTURES = 16384;
-constexpr uint32_t MAX_BINDLESS_BUFFERS = 8192;
\ No newline at end of file
+constexpr uint32_t MAX_BINDLESS_BUFFERS = 8192;
+
+// Entity pipelines index one update-after-bind storage buffer table through a push constant base instead of
+// binding per-pipeline sets (shaders built with -DENTITY_BINDLESS); needs VK_EXT_descriptor_indexing
+constexpr bool ENABLE_BINDLESS_ENTITY_DESCRIPTORS = true;
+
+// Entity pipelines read each SoA stream through a GPU address from a per-view stream address table, whose own
+// address is the push constant (shaders built with -DENTITY_BUFFER_ADDRESS). Takes precedence over the bindless
+// table and binds no entity storage descriptors at all; needs VK_KHR_buffer_device_address
+constexpr bool ENABLE_ENTITY_BUFFER_DEVICE_ADDRESS = true;
+
+// Buffer-only descriptor set layouts get an update template from DescriptorLayoutManager, so rewriting a set is
+// one vkUpdateDescriptorSetWithTemplateKHR call over packed buffer infos; needs VK_KHR_descriptor_update_template
+constexpr bool ENABLE_DESCRIPTOR_UPDATE_TEMPLATES = true;
+
+// Binding numbers an update template can cover: its data is one VkDescriptorBufferInfo per binding number
+constexpr uint32_t MAX_DESCRIPTOR_TEMPLATE_BINDINGS = 18;
+
+// Layouts flagged pushDescriptor in DescriptorLayoutSpec are pushed into the command buffer right before their
+// dispatch or draw (vkCmdPushDescriptorSetKHR), so small per-pass bindings need no pool or set allocation at all;
+// needs VK_KHR_push_descriptor, pool-allocated sets otherwise
+constexpr bool ENABLE_PUSH_DESCRIPTORS = true;
+
+// Per-heap budget and process usage polled from the driver once per frame (VK_EXT_memory_budget), so memory
+// pressure includes what other processes and the compositor hold; own allocation counters otherwise
+constexpr bool ENABLE_MEMORY_BUDGET_TRACKING = true;
+
+// Device memory is allocated with a residency priority (VK_EXT_memory_priority), so under VRAM pressure the OS
+// demotes cold buffers to system memory before the entity streams; VK_EXT_pageable_device_local_memory is enabled
+// with it where present, letting the driver page by those priorities instead of failing allocations
+constexpr bool ENABLE_MEMORY_PRIORITY = true;
+constexpr float MEMORY_PRIORITY_LOW = 0.1f;
+constexpr float MEMORY_PRIORITY_NORMAL = 0.5f;               // The Vulkan default for memory without a priority
+constexpr float MEMORY_PRIORITY_HIGH = 1.0f;
+constexpr size_t DEMOTION_REPORT_THRESHOLD = 16 * MEGABYTE;  // Demoted bytes below this are polling noise
\ No newline at end of file
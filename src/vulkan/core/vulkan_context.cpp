@@ -1,8 +1,13 @@
 #include "vulkan_context.h"
 #include "vulkan_function_loader.h"
+#include "vulkan_constants.h"
+#include "gpu_clock_calibration.h"
 #include <iostream>
 #include <set>
 #include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <string>
 
 const std::vector<const char*> validationLayers = {
     "VK_LAYER_KHRONOS_validation"
@@ -27,6 +32,14 @@ VulkanContext::~VulkanContext() {
     cleanup();
 }
 
+void VulkanContext::setFramesInFlight(uint32_t count) {
+    const uint32_t clamped = std::clamp(count, MIN_FRAMES_IN_FLIGHT, MAX_FRAMES_IN_FLIGHT);
+    if (clamped != count) {
+        std::cerr << "VulkanContext: Frames in flight " << count << " out of range, using " << clamped << std::endl;
+    }
+    framesInFlight = clamped;
+}
+
 bool VulkanContext::initialize(SDL_Window* window) {
     this->window = window;
     
@@ -73,6 +86,7 @@ bool VulkanContext::initialize(SDL_Window* window) {
     
     // Now that device functions are loaded, we can get the queues
     getDeviceQueues();
+    checkPeerMemory();
     
     return true;
 }
@@ -102,6 +116,15 @@ bool VulkanContext::createInstance() {
     appInfo.pEngineName = "No Engine"; 
     appInfo.engineVersion = VK_MAKE_VERSION(1, 0, 0);
     appInfo.apiVersion = VK_API_VERSION_1_0;
+    
+    // Everything else gets by on 1.0 and extensions, but the video extensions and VK_KHR_maintenance5, which
+    // device-generated commands need, are defined on top of 1.1
+    uint32_t loaderVersion = VK_API_VERSION_1_0;
+    if (((ENABLE_VIDEO_ENCODE && videoEncodeRequested) || ENABLE_DEVICE_GENERATED_COMMANDS) && loader->vkEnumerateInstanceVersion &&
+        loader->vkEnumerateInstanceVersion(&loaderVersion) == VK_SUCCESS && loaderVersion >= VK_API_VERSION_1_1) {
+        appInfo.apiVersion = VK_API_VERSION_1_1;
+        instanceVersion11 = true;
+    }
 
     VkInstanceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_INSTANCE_CREATE_INFO;
@@ -148,6 +171,23 @@ bool VulkanContext::createSurface() {
     return true;
 }
 
+vulkan_raii::SurfaceKHR VulkanContext::createWindowSurface(SDL_Window* otherWindow) const {
+    VkSurfaceKHR rawSurface = VK_NULL_HANDLE;
+    if (!SDL_Vulkan_CreateSurface(otherWindow, instance.get(), nullptr, &rawSurface)) {
+        std::cerr << "Failed to create Vulkan surface: " << SDL_GetError() << std::endl;
+        return {};
+    }
+    return vulkan_raii::make_surface_khr(rawSurface, this);
+}
+
+bool VulkanContext::supportsPresentTo(VkSurfaceKHR otherSurface) const {
+    VkBool32 presentSupport = VK_FALSE;
+    return otherSurface != VK_NULL_HANDLE && queueFamilyIndices.presentFamily.has_value() &&
+           loader->vkGetPhysicalDeviceSurfaceSupportKHR(physicalDevice, queueFamilyIndices.presentFamily.value(),
+                                                        otherSurface, &presentSupport) == VK_SUCCESS &&
+           presentSupport == VK_TRUE;
+}
+
 bool VulkanContext::pickPhysicalDevice() {
     uint32_t deviceCount = 0;
     loader->vkEnumeratePhysicalDevices(instance, &deviceCount, nullptr);
@@ -160,21 +200,218 @@ bool VulkanContext::pickPhysicalDevice() {
     std::vector<VkPhysicalDevice> devices(deviceCount);
     loader->vkEnumeratePhysicalDevices(instance, &deviceCount, devices.data());
 
+    std::vector<DeviceCandidate> candidates;
     for (const auto& device : devices) {
-        if (isDeviceSuitable(device)) {
-            physicalDevice = device;
-            break;
+        candidates.push_back(rankPhysicalDevice(device));
+        std::cout << "VulkanContext: GPU " << (candidates.size() - 1) << " '" << candidates.back().name << "' "
+                  << candidates.back().summary << std::endl;
+    }
+    
+    std::string selection = preferredDevice;
+    if (selection.empty()) {
+        const char* environment = std::getenv(GPU_OVERRIDE_ENV);
+        selection = environment ? environment : "";
+    }
+    
+    // An override picks the first suitable match; UUIDs compare without dashes, names as lowercase substrings
+    const DeviceCandidate* chosen = nullptr;
+    if (!selection.empty()) {
+        auto lowercase = [](std::string text) {
+            std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+            return text;
+        };
+        const std::string nameKey = lowercase(selection);
+        std::string uuidKey = nameKey;
+        uuidKey.erase(std::remove(uuidKey.begin(), uuidKey.end(), '-'), uuidKey.end());
+        for (const auto& candidate : candidates) {
+            if (candidate.suitable && ((!candidate.uuid.empty() && candidate.uuid == uuidKey) ||
+                                       lowercase(candidate.name).find(nameKey) != std::string::npos)) {
+                chosen = &candidate;
+                break;
+            }
+        }
+        if (!chosen) {
+            std::cerr << "VulkanContext: No suitable GPU matches '" << selection << "', ranking devices instead" << std::endl;
+        }
+    }
+    
+    // Highest score, enumeration order on ties
+    const bool overridden = chosen != nullptr;
+    for (const auto& candidate : candidates) {
+        if (!overridden && candidate.suitable && (!chosen || candidate.score > chosen->score)) {
+            chosen = &candidate;
         }
     }
 
-    if (physicalDevice == VK_NULL_HANDLE) {
+    if (!chosen) {
         std::cerr << "Failed to find a suitable GPU" << std::endl;
         return false;
     }
+    
+    physicalDevice = chosen->device;
+    deviceName = chosen->name;
+    deviceUuid = chosen->uuid;
+    std::cout << "VulkanContext: Using GPU '" << deviceName << "' ("
+              << (overridden ? "override '" + selection + "'" : "score " + std::to_string(chosen->score)) << ")" << std::endl;
+    logDeviceExtensions(physicalDevice);
+    
+    if (ENABLE_MULTI_DEVICE_SIMULATION && !simulationDeviceRequested.empty()) {
+        pickSimulationDevice(candidates);
+    }
 
     return true;
 }
 
+void VulkanContext::pickSimulationDevice(const std::vector<DeviceCandidate>& candidates) {
+    if (!deviceGroupCreationEnabled || !loader->vkEnumeratePhysicalDeviceGroupsKHR) {
+        std::cerr << "VulkanContext: No device group support, simulation stays on the rendering GPU" << std::endl;
+        return;
+    }
+    
+    uint32_t groupCount = 0;
+    loader->vkEnumeratePhysicalDeviceGroupsKHR(instance, &groupCount, nullptr);
+    std::vector<VkPhysicalDeviceGroupPropertiesKHR> groups(groupCount);
+    for (auto& group : groups) {
+        group.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GROUP_PROPERTIES_KHR;
+    }
+    loader->vkEnumeratePhysicalDeviceGroupsKHR(instance, &groupCount, groups.data());
+    
+    // Only GPUs sharing the rendering GPU's group can join its device; names and UUIDs match as for the override
+    auto lowercase = [](std::string text) {
+        std::transform(text.begin(), text.end(), text.begin(), [](unsigned char c) { return std::tolower(c); });
+        return text;
+    };
+    const std::string nameKey = lowercase(simulationDeviceRequested);
+    std::string uuidKey = nameKey;
+    uuidKey.erase(std::remove(uuidKey.begin(), uuidKey.end(), '-'), uuidKey.end());
+    for (uint32_t g = 0; g < groupCount && !simulationPhysicalDevice; ++g) {
+        const VkPhysicalDeviceGroupPropertiesKHR& group = groups[g];
+        const auto begin = group.physicalDevices;
+        const auto end = group.physicalDevices + group.physicalDeviceCount;
+        if (std::find(begin, end, physicalDevice) == end) {
+            continue;
+        }
+        for (const auto* member = begin; member != end; ++member) {
+            if (*member == physicalDevice) {
+                continue;
+            }
+            const auto candidate = std::find_if(candidates.begin(), candidates.end(),
+                                                [member](const DeviceCandidate& c) { return c.device == *member; });
+            if (candidate == candidates.end()) {
+                continue;
+            }
+            if (nameKey == "auto" || (!candidate->uuid.empty() && candidate->uuid == uuidKey) ||
+                lowercase(candidate->name).find(nameKey) != std::string::npos) {
+                simulationPhysicalDevice = *member;
+                simulationDeviceName = candidate->name;
+                break;
+            }
+        }
+    }
+    
+    if (!simulationPhysicalDevice) {
+        std::cerr << "VulkanContext: No GPU matching '" << simulationDeviceRequested << "' shares a device group with '"
+                  << deviceName << "', simulation stays on the rendering GPU" << std::endl;
+    }
+}
+
+VulkanContext::DeviceCandidate VulkanContext::rankPhysicalDevice(VkPhysicalDevice device) {
+    DeviceCandidate candidate;
+    candidate.device = device;
+    candidate.suitable = isDeviceSuitable(device);
+    
+    VkPhysicalDeviceProperties properties;
+    loader->vkGetPhysicalDeviceProperties(device, &properties);
+    candidate.name = properties.deviceName;
+    
+    // Device type dominates; VRAM then decides within a type, queues and capabilities break near-ties
+    const char* typeName = "other";
+    switch (properties.deviceType) {
+        case VK_PHYSICAL_DEVICE_TYPE_DISCRETE_GPU:   candidate.score = 1000000; typeName = "discrete"; break;
+        case VK_PHYSICAL_DEVICE_TYPE_INTEGRATED_GPU: candidate.score = 300000; typeName = "integrated"; break;
+        case VK_PHYSICAL_DEVICE_TYPE_VIRTUAL_GPU:    candidate.score = 200000; typeName = "virtual"; break;
+        case VK_PHYSICAL_DEVICE_TYPE_CPU:            candidate.score = 0; typeName = "cpu"; break;
+        default:                                     candidate.score = 100000; break;
+    }
+    
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    loader->vkGetPhysicalDeviceMemoryProperties(device, &memoryProperties);
+    VkDeviceSize deviceLocalBytes = 0;
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; ++i) {
+        if (memoryProperties.memoryHeaps[i].flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) {
+            deviceLocalBytes += memoryProperties.memoryHeaps[i].size;
+        }
+    }
+    const uint64_t deviceLocalMiB = deviceLocalBytes / MEGABYTE;
+    candidate.score += deviceLocalMiB / 16;
+    
+    uint32_t queueFamilyCount = 0;
+    loader->vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    loader->vkGetPhysicalDeviceQueueFamilyProperties(device, &queueFamilyCount, queueFamilies.data());
+    bool asyncCompute = false;
+    bool dedicatedTransfer = false;
+    for (const auto& family : queueFamilies) {
+        const bool graphics = family.queueFlags & VK_QUEUE_GRAPHICS_BIT;
+        const bool compute = family.queueFlags & VK_QUEUE_COMPUTE_BIT;
+        asyncCompute = asyncCompute || (compute && !graphics);
+        dedicatedTransfer = dedicatedTransfer || ((family.queueFlags & VK_QUEUE_TRANSFER_BIT) && !graphics && !compute);
+    }
+    candidate.score += (asyncCompute ? 200 : 0) + (dedicatedTransfer ? 100 : 0);
+    
+    // Subgroup size and UUID are 1.1 properties, only queried where the device and the instance can report them
+    uint32_t subgroupSize = 0;
+    if (properties.apiVersion >= VK_MAKE_VERSION(1, 1, 0)) {
+        if (physicalDeviceProperties2Enabled && loader->vkGetPhysicalDeviceProperties2KHR) {
+            VkPhysicalDeviceIDProperties idProperties{};
+            idProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_ID_PROPERTIES;
+            VkPhysicalDeviceSubgroupProperties subgroupProperties{};
+            subgroupProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SUBGROUP_PROPERTIES;
+            subgroupProperties.pNext = &idProperties;
+            VkPhysicalDeviceProperties2KHR properties2{};
+            properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+            properties2.pNext = &subgroupProperties;
+            loader->vkGetPhysicalDeviceProperties2KHR(device, &properties2);
+            
+            subgroupSize = subgroupProperties.subgroupSize;
+            static const char* hexDigits = "0123456789abcdef";
+            for (uint32_t i = 0; i < VK_UUID_SIZE; ++i) {
+                candidate.uuid += hexDigits[idProperties.deviceUUID[i] >> 4];
+                candidate.uuid += hexDigits[idProperties.deviceUUID[i] & 0xF];
+            }
+        }
+    }
+    candidate.score += std::min(subgroupSize, 64u);
+    
+    uint32_t extensionCount = 0;
+    loader->vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> extensions(extensionCount);
+    loader->vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, extensions.data());
+    std::string optionalExtensions;
+    for (const auto& extension : extensions) {
+        const std::string extensionName(extension.extensionName);
+        uint64_t bonus = 0;
+        if (extensionName == VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) {
+            bonus = 50;
+        } else if (extensionName == VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) {
+            bonus = 50;
+        } else if (extensionName == VK_EXT_MESH_SHADER_EXTENSION_NAME) {
+            bonus = 25;
+        }
+        if (bonus > 0) {
+            candidate.score += bonus;
+            optionalExtensions += " " + extensionName;
+        }
+    }
+    
+    candidate.summary = std::string(typeName) + ", " + std::to_string(deviceLocalMiB) + " MiB device-local" +
+                        (asyncCompute ? ", async compute" : "") + (dedicatedTransfer ? ", dedicated transfer" : "") +
+                        (subgroupSize ? ", subgroup " + std::to_string(subgroupSize) : "") + optionalExtensions +
+                        (candidate.uuid.empty() ? "" : ", UUID " + candidate.uuid) +
+                        (candidate.suitable ? ", score " + std::to_string(candidate.score) : ", unsuitable");
+    return candidate;
+}
+
 bool VulkanContext::createLogicalDevice() {
     QueueFamilyIndices indices = findQueueFamilies(physicalDevice);
     
@@ -191,17 +428,48 @@ bool VulkanContext::createLogicalDevice() {
         uniqueQueueFamilies.insert(indices.transferFamily.value());
     }
 
-    float queuePriority = 1.0f;
+    // Queue 0 of every family serves the frame at full priority; the compute family adds a low-priority
+    // background queue when it has a second one. Priorities only order queues of one device, so no other
+    // family needs more than one
+    uint32_t queueFamilyCount = 0;
+    loader->vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> queueFamilies(queueFamilyCount);
+    loader->vkGetPhysicalDeviceQueueFamilyProperties(physicalDevice, &queueFamilyCount, queueFamilies.data());
+    
+    const uint32_t computeFamily = indices.computeFamily.value();
+    computeQueueCount = ENABLE_BACKGROUND_COMPUTE_QUEUE && computeFamily < queueFamilyCount &&
+                        queueFamilies[computeFamily].queueCount > 1 ? 2u : 1u;
+    
+    const float queuePriorities[2] = {FRAME_QUEUE_PRIORITY, BACKGROUND_QUEUE_PRIORITY};
     for (uint32_t queueFamily : uniqueQueueFamilies) {
         VkDeviceQueueCreateInfo queueCreateInfo{};
         queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
         queueCreateInfo.queueFamilyIndex = queueFamily;
-        queueCreateInfo.queueCount = 1;
-        queueCreateInfo.pQueuePriorities = &queuePriority;
+        queueCreateInfo.queueCount = queueFamily == computeFamily ? computeQueueCount : 1u;
+        queueCreateInfo.pQueuePriorities = queuePriorities;
         queueCreateInfos.push_back(queueCreateInfo);
     }
 
     VkPhysicalDeviceFeatures deviceFeatures{};
+    
+    // Core feature, only requested when the statistics mode is compiled in
+    VkPhysicalDeviceFeatures supportedFeatures{};
+    loader->vkGetPhysicalDeviceFeatures(physicalDevice, &supportedFeatures);
+    pipelineStatisticsSupported = ENABLE_GPU_PIPELINE_STATISTICS && supportedFeatures.pipelineStatisticsQuery;
+    deviceFeatures.pipelineStatisticsQuery = pipelineStatisticsSupported ? VK_TRUE : VK_FALSE;
+    
+    // The overdraw diagnostic's fragment shader variant counts into a storage image
+    overdrawCountingSupported = ENABLE_OVERDRAW_DIAGNOSTIC && supportedFeatures.fragmentStoresAndAtomics;
+    deviceFeatures.fragmentStoresAndAtomics = overdrawCountingSupported ? VK_TRUE : VK_FALSE;
+    const bool shaderInt64Available = supportedFeatures.shaderInt64 == VK_TRUE;
+    
+    // Sparse entity buffers bind their pages on the transfer queue (the graphics family without a dedicated one)
+    const uint32_t sparseBindFamily = indices.transferFamily.has_value() ? indices.transferFamily.value() : indices.graphicsFamily.value();
+    sparseEntityBuffersSupported = ENABLE_SPARSE_ENTITY_BUFFERS && supportedFeatures.sparseBinding && supportedFeatures.sparseResidencyBuffer &&
+                                   sparseBindFamily < queueFamilyCount &&
+                                   (queueFamilies[sparseBindFamily].queueFlags & VK_QUEUE_SPARSE_BINDING_BIT);
+    deviceFeatures.sparseBinding = sparseEntityBuffersSupported ? VK_TRUE : VK_FALSE;
+    deviceFeatures.sparseResidencyBuffer = sparseEntityBuffersSupported ? VK_TRUE : VK_FALSE;
 
     // Build list of actually supported extensions
     uint32_t extensionCount;
@@ -213,15 +481,606 @@ bool VulkanContext::createLogicalDevice() {
     enabledExtensions.push_back(VK_KHR_SWAPCHAIN_EXTENSION_NAME); // Always required
     
     // Add optional extensions if supported
+    bool timelineSemaphoreAvailable = false;
+    bool synchronization2Available = false;
+    bool descriptorIndexingAvailable = false;
+    bool maintenance3Available = false;
+    bool bufferDeviceAddressAvailable = false;
+    bool deviceGroupAvailable = false;
+    bool bindMemory2Available = false;
+    bool descriptorUpdateTemplateAvailable = false;
+    bool pushDescriptorAvailable = false;
+    bool memoryBudgetAvailable = false;
+    bool memoryPriorityAvailable = false;
+    bool pageableDeviceLocalMemoryAvailable = false;
+    bool presentIdAvailable = false;
+    bool presentWaitAvailable = false;
+    bool displayTimingAvailable = false;
+    bool dynamicRenderingAvailable = false;
+    bool deviceGeneratedCommandsAvailable = false;
+    bool maintenance5Available = false;
+    bool depthStencilResolveAvailable = false;
+    bool createRenderPass2Available = false;
+    bool multiviewAvailable = false;
+    bool maintenance2Available = false;
+    bool subgroupBallotAvailable = false;
+    bool pipelineExecutablePropertiesAvailable = false;
+    bool pipelineLibraryAvailable = false;
+    bool graphicsPipelineLibraryAvailable = false;
+    bool drawIndirectCountAvailable = false;
+    bool bufferMarkerAvailable = false;
+    bool diagnosticCheckpointsAvailable = false;
+    bool calibratedTimestampsAvailable = false;
+    bool externalMemoryAvailable = false;
+    bool externalMemoryHandleAvailable = false;
+    bool externalSemaphoreAvailable = false;
+    bool externalSemaphoreHandleAvailable = false;
+    bool dedicatedAllocationAvailable = false;
+    bool memoryRequirements2Available = false;
+    bool videoQueueAvailable = false;
+    bool videoEncodeQueueAvailable = false;
+    bool videoEncodeH264Available = false;
+#if defined(VK_USE_PLATFORM_WIN32_KHR)
+    const std::string externalMemoryHandleExtension = VK_KHR_EXTERNAL_MEMORY_WIN32_EXTENSION_NAME;
+    const std::string externalSemaphoreHandleExtension = VK_KHR_EXTERNAL_SEMAPHORE_WIN32_EXTENSION_NAME;
+#else
+    const std::string externalMemoryHandleExtension = VK_KHR_EXTERNAL_MEMORY_FD_EXTENSION_NAME;
+    const std::string externalSemaphoreHandleExtension = VK_KHR_EXTERNAL_SEMAPHORE_FD_EXTENSION_NAME;
+#endif
     for (const auto& extension : availableExtensions) {
-        if (std::string(extension.extensionName) == VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME) {
+        const std::string extensionName(extension.extensionName);
+        if (extensionName == VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME) {
             enabledExtensions.push_back(VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME);
-            break;
+        } else if (extensionName == VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME) {
+            timelineSemaphoreAvailable = true;
+        } else if (extensionName == VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME) {
+            synchronization2Available = true;
+        } else if (extensionName == VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME) {
+            descriptorIndexingAvailable = true;
+        } else if (extensionName == VK_KHR_MAINTENANCE_3_EXTENSION_NAME) {
+            maintenance3Available = true;
+        } else if (extensionName == VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME) {
+            bufferDeviceAddressAvailable = true;
+        } else if (extensionName == VK_KHR_DEVICE_GROUP_EXTENSION_NAME) {
+            deviceGroupAvailable = true;
+        } else if (extensionName == VK_KHR_BIND_MEMORY_2_EXTENSION_NAME) {
+            bindMemory2Available = true;
+        } else if (extensionName == VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME) {
+            descriptorUpdateTemplateAvailable = true;
+        } else if (extensionName == VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME) {
+            pushDescriptorAvailable = true;
+        } else if (extensionName == VK_EXT_MEMORY_BUDGET_EXTENSION_NAME) {
+            memoryBudgetAvailable = true;
+        } else if (extensionName == VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME) {
+            memoryPriorityAvailable = true;
+        } else if (extensionName == VK_EXT_PAGEABLE_DEVICE_LOCAL_MEMORY_EXTENSION_NAME) {
+            pageableDeviceLocalMemoryAvailable = true;
+        } else if (extensionName == VK_KHR_PRESENT_ID_EXTENSION_NAME) {
+            presentIdAvailable = true;
+        } else if (extensionName == VK_KHR_PRESENT_WAIT_EXTENSION_NAME) {
+            presentWaitAvailable = true;
+        } else if (extensionName == VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME) {
+            displayTimingAvailable = true;
+        } else if (extensionName == VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME) {
+            dynamicRenderingAvailable = true;
+        } else if (extensionName == VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME) {
+            depthStencilResolveAvailable = true;
+        } else if (extensionName == VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME) {
+            createRenderPass2Available = true;
+        } else if (extensionName == VK_KHR_MULTIVIEW_EXTENSION_NAME) {
+            multiviewAvailable = true;
+        } else if (extensionName == VK_KHR_MAINTENANCE_2_EXTENSION_NAME) {
+            maintenance2Available = true;
+        } else if (extensionName == VK_EXT_DEVICE_GENERATED_COMMANDS_EXTENSION_NAME) {
+            deviceGeneratedCommandsAvailable = true;
+        } else if (extensionName == VK_KHR_MAINTENANCE_5_EXTENSION_NAME) {
+            maintenance5Available = true;
+        } else if (extensionName == VK_EXT_SHADER_SUBGROUP_BALLOT_EXTENSION_NAME) {
+            subgroupBallotAvailable = true;
+        } else if (extensionName == VK_KHR_PIPELINE_EXECUTABLE_PROPERTIES_EXTENSION_NAME) {
+            pipelineExecutablePropertiesAvailable = true;
+        } else if (extensionName == VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME) {
+            pipelineLibraryAvailable = true;
+        } else if (extensionName == VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME) {
+            graphicsPipelineLibraryAvailable = true;
+        } else if (extensionName == VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME) {
+            drawIndirectCountAvailable = true;
+        } else if (extensionName == VK_AMD_BUFFER_MARKER_EXTENSION_NAME) {
+            bufferMarkerAvailable = true;
+        } else if (extensionName == VK_NV_DEVICE_DIAGNOSTIC_CHECKPOINTS_EXTENSION_NAME) {
+            diagnosticCheckpointsAvailable = true;
+        } else if (extensionName == VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME) {
+            calibratedTimestampsAvailable = true;
+        } else if (extensionName == VK_KHR_EXTERNAL_MEMORY_EXTENSION_NAME) {
+            externalMemoryAvailable = true;
+        } else if (extensionName == externalMemoryHandleExtension) {
+            externalMemoryHandleAvailable = true;
+        } else if (extensionName == VK_KHR_EXTERNAL_SEMAPHORE_EXTENSION_NAME) {
+            externalSemaphoreAvailable = true;
+        } else if (extensionName == externalSemaphoreHandleExtension) {
+            externalSemaphoreHandleAvailable = true;
+        } else if (extensionName == VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME) {
+            dedicatedAllocationAvailable = true;
+        } else if (extensionName == VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME) {
+            memoryRequirements2Available = true;
+        } else if (extensionName == VK_KHR_VIDEO_QUEUE_EXTENSION_NAME) {
+            videoQueueAvailable = true;
+        } else if (extensionName == VK_KHR_VIDEO_ENCODE_QUEUE_EXTENSION_NAME) {
+            videoEncodeQueueAvailable = true;
+        } else if (extensionName == VK_KHR_VIDEO_ENCODE_H264_EXTENSION_NAME) {
+            videoEncodeH264Available = true;
+        }
+    }
+    
+    // The timelineSemaphore feature is mandatory wherever the extension is exposed
+    VkPhysicalDeviceTimelineSemaphoreFeaturesKHR timelineFeatures{};
+    timelineFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_TIMELINE_SEMAPHORE_FEATURES_KHR;
+    timelineFeatures.timelineSemaphore = VK_TRUE;
+    
+    timelineSemaphoreSupported = ENABLE_TIMELINE_FRAME_PACING && timelineSemaphoreAvailable && physicalDeviceProperties2Enabled;
+    if (timelineSemaphoreSupported) {
+        enabledExtensions.push_back(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME);
+    }
+    
+    // No feature structs: a device group over the simulation GPU needs VK_KHR_device_group for submit device
+    // masks and peer memory features and VK_KHR_bind_memory2 to alias the rendering GPU's copy of a buffer,
+    // and timeline pacing for the pipelined publish graphics draws from. Sparse pages would bind per device
+    const bool createDeviceGroup = ENABLE_MULTI_DEVICE_SIMULATION && ENABLE_PIPELINED_ASYNC_COMPUTE &&
+                                   simulationPhysicalDevice != VK_NULL_HANDLE && deviceGroupAvailable &&
+                                   bindMemory2Available && timelineSemaphoreSupported;
+    if (createDeviceGroup) {
+        enabledExtensions.push_back(VK_KHR_DEVICE_GROUP_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_BIND_MEMORY_2_EXTENSION_NAME);
+        sparseEntityBuffersSupported = false;
+        deviceFeatures.sparseBinding = VK_FALSE;
+        deviceFeatures.sparseResidencyBuffer = VK_FALSE;
+    } else if (simulationPhysicalDevice != VK_NULL_HANDLE) {
+        std::cerr << "VulkanContext: Device group extensions or timeline pacing unavailable, simulation stays on the rendering GPU" << std::endl;
+        simulationPhysicalDevice = VK_NULL_HANDLE;
+    }
+    
+    // No feature bits: the extension alone provides the template entry points
+    descriptorUpdateTemplateSupported = ENABLE_DESCRIPTOR_UPDATE_TEMPLATES && descriptorUpdateTemplateAvailable;
+    if (descriptorUpdateTemplateSupported) {
+        enabledExtensions.push_back(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME);
+    }
+    
+    // No feature struct either; it needs VK_KHR_get_physical_device_properties2 at the instance level
+    pushDescriptorSupported = ENABLE_PUSH_DESCRIPTORS && pushDescriptorAvailable && physicalDeviceProperties2Enabled;
+    if (pushDescriptorSupported) {
+        enabledExtensions.push_back(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME);
+    }
+    
+    // Budgets are read through vkGetPhysicalDeviceMemoryProperties2KHR, hence the properties2 dependency
+    memoryBudgetSupported = ENABLE_MEMORY_BUDGET_TRACKING && memoryBudgetAvailable && physicalDeviceProperties2Enabled &&
+                            loader->vkGetPhysicalDeviceMemoryProperties2KHR;
+    if (memoryBudgetSupported) {
+        enabledExtensions.push_back(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME);
+    }
+    
+    // No feature struct; only read back by PresentTimingMonitor, so it is enabled whenever the device has it
+    displayTimingSupported = ENABLE_DISPLAY_TIMING && displayTimingAvailable;
+    if (displayTimingSupported) {
+        enabledExtensions.push_back(VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME);
+    }
+    
+    // No feature struct here either; each shape's draw starts at its run of the binned visible list, which takes the core
+    // first-instance feature for indirect draws
+    drawIndirectCountSupported = ENABLE_ENTITY_SHAPE_BINNING && drawIndirectCountAvailable &&
+                                 supportedFeatures.drawIndirectFirstInstance;
+    if (drawIndirectCountSupported) {
+        enabledExtensions.push_back(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME);
+        deviceFeatures.drawIndirectFirstInstance = VK_TRUE;
+    }
+    
+    // No feature struct either; the ballot masks are 64-bit, so the kernels also need the core shaderInt64 feature
+    subgroupBallotSupported = ENABLE_SUBGROUP_BALLOT && subgroupBallotAvailable && shaderInt64Available;
+    if (subgroupBallotSupported) {
+        enabledExtensions.push_back(VK_EXT_SHADER_SUBGROUP_BALLOT_EXTENSION_NAME);
+        deviceFeatures.shaderInt64 = VK_TRUE;
+    }
+    
+    // Breadcrumbs need one of the two; the buffer markers win as the host can read them before the device is lost
+    bufferMarkerSupported = ENABLE_GPU_BREADCRUMBS && bufferMarkerAvailable;
+    diagnosticCheckpointsSupported = ENABLE_GPU_BREADCRUMBS && !bufferMarkerSupported && diagnosticCheckpointsAvailable;
+    if (bufferMarkerSupported) {
+        enabledExtensions.push_back(VK_AMD_BUFFER_MARKER_EXTENSION_NAME);
+    } else if (diagnosticCheckpointsSupported) {
+        enabledExtensions.push_back(VK_NV_DEVICE_DIAGNOSTIC_CHECKPOINTS_EXTENSION_NAME);
+    }
+    
+    // No feature struct; calibration needs both the device clock and the host clock the steady clock reads
+    calibratedTimestampsSupported = false;
+    if (ENABLE_CALIBRATED_TIMESTAMPS && calibratedTimestampsAvailable && loader->vkGetPhysicalDeviceCalibrateableTimeDomainsEXT) {
+        uint32_t domainCount = 0;
+        loader->vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(physicalDevice, &domainCount, nullptr);
+        std::vector<VkTimeDomainEXT> domains(domainCount);
+        loader->vkGetPhysicalDeviceCalibrateableTimeDomainsEXT(physicalDevice, &domainCount, domains.data());
+        const auto hasDomain = [&domains](VkTimeDomainEXT domain) {
+            return std::find(domains.begin(), domains.end(), domain) != domains.end();
+        };
+        calibratedTimestampsSupported = hasDomain(VK_TIME_DOMAIN_DEVICE_EXT) && hasDomain(GpuClockCalibration::getHostTimeDomain());
+        if (calibratedTimestampsSupported) {
+            enabledExtensions.push_back(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME);
+        }
+    }
+    
+    // No feature structs: the exported snapshots are dedicated allocations of the opaque handle type and the
+    // timeline semaphore the consumer waits on must be exportable as well, which the device reports per type
+    externalExportSupported = false;
+    if (ENABLE_EXTERNAL_POSITION_EXPORT && externalExportRequested && externalCapabilitiesEnabled && !createDeviceGroup &&
+        timelineSemaphoreSupported && externalMemoryAvailable && externalMemoryHandleAvailable &&
+        externalSemaphoreAvailable && externalSemaphoreHandleAvailable && dedicatedAllocationAvailable &&
+        memoryRequirements2Available && loader->vkGetPhysicalDeviceExternalBufferPropertiesKHR &&
+        loader->vkGetPhysicalDeviceExternalSemaphorePropertiesKHR) {
+        VkPhysicalDeviceExternalBufferInfoKHR bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_BUFFER_INFO_KHR;
+        bufferInfo.usage = VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT |
+                           VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+        bufferInfo.handleType = EXTERNAL_MEMORY_HANDLE_TYPE;
+        VkExternalBufferPropertiesKHR bufferProperties{};
+        bufferProperties.sType = VK_STRUCTURE_TYPE_EXTERNAL_BUFFER_PROPERTIES_KHR;
+        loader->vkGetPhysicalDeviceExternalBufferPropertiesKHR(physicalDevice, &bufferInfo, &bufferProperties);
+        
+        VkSemaphoreTypeCreateInfoKHR timelineType{};
+        timelineType.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+        timelineType.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+        VkPhysicalDeviceExternalSemaphoreInfoKHR semaphoreInfo{};
+        semaphoreInfo.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_EXTERNAL_SEMAPHORE_INFO_KHR;
+        semaphoreInfo.pNext = &timelineType;
+        semaphoreInfo.handleType = EXTERNAL_SEMAPHORE_HANDLE_TYPE;
+        VkExternalSemaphorePropertiesKHR semaphoreProperties{};
+        semaphoreProperties.sType = VK_STRUCTURE_TYPE_EXTERNAL_SEMAPHORE_PROPERTIES_KHR;
+        loader->vkGetPhysicalDeviceExternalSemaphorePropertiesKHR(physicalDevice, &semaphoreInfo, &semaphoreProperties);
+        
+        externalExportSupported =
+            (bufferProperties.externalMemoryProperties.externalMemoryFeatures & VK_EXTERNAL_MEMORY_FEATURE_EXPORTABLE_BIT_KHR) &&
+            (semaphoreProperties.externalSemaphoreFeatures & VK_EXTERNAL_SEMAPHORE_FEATURE_EXPORTABLE_BIT_KHR);
+    }
+    if (externalExportSupported) {
+        enabledExtensions.push_back(VK_KHR_GET_MEMORY_REQUIREMENTS_2_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_DEDICATED_ALLOCATION_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_EXTERNAL_MEMORY_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_EXTERNAL_SEMAPHORE_EXTENSION_NAME);
+        enabledExtensions.push_back(externalMemoryHandleExtension.c_str());
+        enabledExtensions.push_back(externalSemaphoreHandleExtension.c_str());
+    } else if (externalExportRequested) {
+        std::cerr << "VulkanContext: External memory or timeline semaphore export unavailable, positions stay private" << std::endl;
+    }
+    
+    // Likewise mandatory with the extension
+    VkPhysicalDeviceSynchronization2FeaturesKHR synchronization2Features{};
+    synchronization2Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_SYNCHRONIZATION_2_FEATURES_KHR;
+    synchronization2Features.synchronization2 = VK_TRUE;
+    
+    synchronization2Supported = ENABLE_SYNCHRONIZATION2 && synchronization2Available && physicalDeviceProperties2Enabled;
+    
+    // No feature structs: recording needs a 1.1 device behind the 1.1 instance, a queue family whose codec
+    // operations include H.264 encode, synchronization2 for the encode stage and timeline semaphores for the
+    // encode submit to wait on the graphics frame. The profile itself is checked by the recorder
+    videoEncodeSupported = false;
+    VkPhysicalDeviceProperties deviceProperties{};
+    loader->vkGetPhysicalDeviceProperties(physicalDevice, &deviceProperties);
+    if (ENABLE_VIDEO_ENCODE && videoEncodeRequested && instanceVersion11 && deviceProperties.apiVersion >= VK_API_VERSION_1_1 &&
+        videoQueueAvailable && videoEncodeQueueAvailable && videoEncodeH264Available && synchronization2Supported &&
+        timelineSemaphoreSupported && loader->vkGetPhysicalDeviceQueueFamilyProperties2KHR) {
+        std::vector<VkQueueFamilyVideoPropertiesKHR> videoProperties(queueFamilyCount);
+        std::vector<VkQueueFamilyProperties2KHR> familyProperties(queueFamilyCount);
+        for (uint32_t i = 0; i < queueFamilyCount; ++i) {
+            videoProperties[i].sType = VK_STRUCTURE_TYPE_QUEUE_FAMILY_VIDEO_PROPERTIES_KHR;
+            familyProperties[i].sType = VK_STRUCTURE_TYPE_QUEUE_FAMILY_PROPERTIES_2_KHR;
+            familyProperties[i].pNext = &videoProperties[i];
+        }
+        loader->vkGetPhysicalDeviceQueueFamilyProperties2KHR(physicalDevice, &queueFamilyCount, familyProperties.data());
+        for (uint32_t i = 0; i < queueFamilyCount && !indices.videoEncodeFamily.has_value(); ++i) {
+            if ((familyProperties[i].queueFamilyProperties.queueFlags & VK_QUEUE_VIDEO_ENCODE_BIT_KHR) &&
+                (videoProperties[i].videoCodecOperations & VK_VIDEO_CODEC_OPERATION_ENCODE_H264_BIT_KHR)) {
+                indices.videoEncodeFamily = i;
+            }
+        }
+        videoEncodeSupported = indices.videoEncodeFamily.has_value();
+    }
+    if (videoEncodeSupported) {
+        enabledExtensions.push_back(VK_KHR_VIDEO_QUEUE_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_VIDEO_ENCODE_QUEUE_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_VIDEO_ENCODE_H264_EXTENSION_NAME);
+        if (!uniqueQueueFamilies.count(indices.videoEncodeFamily.value())) {
+            VkDeviceQueueCreateInfo queueCreateInfo{};
+            queueCreateInfo.sType = VK_STRUCTURE_TYPE_DEVICE_QUEUE_CREATE_INFO;
+            queueCreateInfo.queueFamilyIndex = indices.videoEncodeFamily.value();
+            queueCreateInfo.queueCount = 1;
+            queueCreateInfo.pQueuePriorities = queuePriorities;
+            queueCreateInfos.push_back(queueCreateInfo);
+        }
+    } else if (ENABLE_VIDEO_ENCODE && videoEncodeRequested) {
+        std::cout << "VulkanContext: No H.264 video encode queue, recordings fall back to CPU readback" << std::endl;
+    }
+    
+    // Unlike the two above, the indexing features are individually optional: the bindless entity table needs
+    // runtime arrays, partially bound and update-after-bind storage buffers, and updates while pending
+    VkPhysicalDeviceDescriptorIndexingFeaturesEXT indexingFeatures{};
+    indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    
+    bindlessDescriptorsSupported = false;
+    if (ENABLE_BINDLESS_ENTITY_DESCRIPTORS && descriptorIndexingAvailable && maintenance3Available &&
+        physicalDeviceProperties2Enabled && loader->vkGetPhysicalDeviceFeatures2KHR && loader->vkGetPhysicalDeviceProperties2KHR) {
+        VkPhysicalDeviceFeatures2KHR features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+        features2.pNext = &indexingFeatures;
+        loader->vkGetPhysicalDeviceFeatures2KHR(physicalDevice, &features2);
+        
+        VkPhysicalDeviceDescriptorIndexingPropertiesEXT indexingProperties{};
+        indexingProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_PROPERTIES_EXT;
+        VkPhysicalDeviceProperties2KHR properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+        properties2.pNext = &indexingProperties;
+        loader->vkGetPhysicalDeviceProperties2KHR(physicalDevice, &properties2);
+        maxBindlessStorageBuffers = std::min(indexingProperties.maxPerStageDescriptorUpdateAfterBindStorageBuffers,
+                                             indexingProperties.maxDescriptorSetUpdateAfterBindStorageBuffers);
+        
+        bindlessDescriptorsSupported = indexingFeatures.runtimeDescriptorArray &&
+                                       indexingFeatures.descriptorBindingPartiallyBound &&
+                                       indexingFeatures.descriptorBindingStorageBufferUpdateAfterBind &&
+                                       indexingFeatures.descriptorBindingUpdateUnusedWhilePending &&
+                                       maxBindlessStorageBuffers > 0;
+    }
+    
+    // Only what the table uses is enabled
+    const VkPhysicalDeviceDescriptorIndexingFeaturesEXT supportedIndexing = indexingFeatures;
+    indexingFeatures = {};
+    indexingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DESCRIPTOR_INDEXING_FEATURES_EXT;
+    indexingFeatures.runtimeDescriptorArray = supportedIndexing.runtimeDescriptorArray;
+    indexingFeatures.descriptorBindingPartiallyBound = supportedIndexing.descriptorBindingPartiallyBound;
+    indexingFeatures.descriptorBindingStorageBufferUpdateAfterBind = supportedIndexing.descriptorBindingStorageBufferUpdateAfterBind;
+    indexingFeatures.descriptorBindingUpdateUnusedWhilePending = supportedIndexing.descriptorBindingUpdateUnusedWhilePending;
+    
+    // Only bufferDeviceAddress itself: capture/replay and multi-device addresses go unused, so a device group
+    // over the simulation GPU binds the entity streams through descriptors instead
+    VkPhysicalDeviceBufferDeviceAddressFeaturesKHR bufferDeviceAddressFeatures{};
+    bufferDeviceAddressFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES_KHR;
+    
+    bufferDeviceAddressSupported = false;
+    if (ENABLE_ENTITY_BUFFER_DEVICE_ADDRESS && bufferDeviceAddressAvailable && deviceGroupAvailable && !createDeviceGroup &&
+        deviceGroupCreationEnabled && physicalDeviceProperties2Enabled && loader->vkGetPhysicalDeviceFeatures2KHR) {
+        VkPhysicalDeviceFeatures2KHR features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+        features2.pNext = &bufferDeviceAddressFeatures;
+        loader->vkGetPhysicalDeviceFeatures2KHR(physicalDevice, &features2);
+        bufferDeviceAddressSupported = bufferDeviceAddressFeatures.bufferDeviceAddress;
+    }
+    bufferDeviceAddressFeatures = {};
+    bufferDeviceAddressFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_BUFFER_DEVICE_ADDRESS_FEATURES_KHR;
+    bufferDeviceAddressFeatures.bufferDeviceAddress = VK_TRUE;
+    
+    // Present wait is only usable together with present IDs, and both are features on top of the extensions
+    VkPhysicalDevicePresentIdFeaturesKHR presentIdFeatures{};
+    presentIdFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_ID_FEATURES_KHR;
+    VkPhysicalDevicePresentWaitFeaturesKHR presentWaitFeatures{};
+    presentWaitFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PRESENT_WAIT_FEATURES_KHR;
+    
+    presentWaitSupported = false;
+    if (ENABLE_PRESENT_WAIT_PACING && presentIdAvailable && presentWaitAvailable &&
+        physicalDeviceProperties2Enabled && loader->vkGetPhysicalDeviceFeatures2KHR) {
+        presentIdFeatures.pNext = &presentWaitFeatures;
+        VkPhysicalDeviceFeatures2KHR features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+        features2.pNext = &presentIdFeatures;
+        loader->vkGetPhysicalDeviceFeatures2KHR(physicalDevice, &features2);
+        presentWaitSupported = presentIdFeatures.presentId && presentWaitFeatures.presentWait;
+    }
+    presentIdFeatures.pNext = nullptr;
+    presentWaitFeatures.pNext = nullptr;
+    
+    VkPhysicalDevicePipelineExecutablePropertiesFeaturesKHR executableFeatures{};
+    executableFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_EXECUTABLE_PROPERTIES_FEATURES_KHR;
+    
+    pipelineExecutableInfoSupported = false;
+    if (ENABLE_PIPELINE_EXECUTABLE_STATISTICS && pipelineExecutablePropertiesAvailable &&
+        physicalDeviceProperties2Enabled && loader->vkGetPhysicalDeviceFeatures2KHR) {
+        VkPhysicalDeviceFeatures2KHR features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+        features2.pNext = &executableFeatures;
+        loader->vkGetPhysicalDeviceFeatures2KHR(physicalDevice, &features2);
+        pipelineExecutableInfoSupported = executableFeatures.pipelineExecutableInfo;
+    }
+    executableFeatures = {};
+    executableFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PIPELINE_EXECUTABLE_PROPERTIES_FEATURES_KHR;
+    executableFeatures.pipelineExecutableInfo = VK_TRUE;
+    
+    // Without fast linking a link may compile as long as a whole pipeline, and the libraries would buy nothing
+    VkPhysicalDeviceGraphicsPipelineLibraryFeaturesEXT pipelineLibraryFeatures{};
+    pipelineLibraryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+    
+    graphicsPipelineLibrarySupported = false;
+    if (ENABLE_GRAPHICS_PIPELINE_LIBRARY && pipelineLibraryAvailable && graphicsPipelineLibraryAvailable &&
+        physicalDeviceProperties2Enabled && loader->vkGetPhysicalDeviceFeatures2KHR && loader->vkGetPhysicalDeviceProperties2KHR) {
+        VkPhysicalDeviceFeatures2KHR features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+        features2.pNext = &pipelineLibraryFeatures;
+        loader->vkGetPhysicalDeviceFeatures2KHR(physicalDevice, &features2);
+        
+        VkPhysicalDeviceGraphicsPipelineLibraryPropertiesEXT pipelineLibraryProperties{};
+        pipelineLibraryProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_PROPERTIES_EXT;
+        VkPhysicalDeviceProperties2KHR properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+        properties2.pNext = &pipelineLibraryProperties;
+        loader->vkGetPhysicalDeviceProperties2KHR(physicalDevice, &properties2);
+        graphicsPipelineLibrarySupported = pipelineLibraryFeatures.graphicsPipelineLibrary &&
+                                           pipelineLibraryProperties.graphicsPipelineLibraryFastLinking;
+    }
+    pipelineLibraryFeatures = {};
+    pipelineLibraryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_GRAPHICS_PIPELINE_LIBRARY_FEATURES_EXT;
+    pipelineLibraryFeatures.graphicsPipelineLibrary = VK_TRUE;
+    
+    // On a 1.0 instance dynamic rendering drags in depth/stencil resolve and its render pass 2, multiview and
+    // maintenance2 dependencies; only the dynamicRendering feature itself is enabled
+    VkPhysicalDeviceDynamicRenderingFeaturesKHR dynamicRenderingFeatures{};
+    dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+    
+    dynamicRenderingSupported = false;
+    if (ENABLE_DYNAMIC_RENDERING && dynamicRenderingAvailable && depthStencilResolveAvailable &&
+        createRenderPass2Available && multiviewAvailable && maintenance2Available &&
+        physicalDeviceProperties2Enabled && loader->vkGetPhysicalDeviceFeatures2KHR) {
+        VkPhysicalDeviceFeatures2KHR features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+        features2.pNext = &dynamicRenderingFeatures;
+        loader->vkGetPhysicalDeviceFeatures2KHR(physicalDevice, &features2);
+        dynamicRenderingSupported = dynamicRenderingFeatures.dynamicRendering;
+    }
+    dynamicRenderingFeatures = {};
+    dynamicRenderingFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DYNAMIC_RENDERING_FEATURES_KHR;
+    dynamicRenderingFeatures.dynamicRendering = VK_TRUE;
+    
+    // Pageable device-local memory depends on memory priority; its priorities come from the same allocate info
+    VkPhysicalDeviceMemoryPriorityFeaturesEXT memoryPriorityFeatures{};
+    memoryPriorityFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT;
+    VkPhysicalDevicePageableDeviceLocalMemoryFeaturesEXT pageableMemoryFeatures{};
+    pageableMemoryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PAGEABLE_DEVICE_LOCAL_MEMORY_FEATURES_EXT;
+    
+    memoryPrioritySupported = false;
+    pageableDeviceLocalMemorySupported = false;
+    if (ENABLE_MEMORY_PRIORITY && memoryPriorityAvailable && physicalDeviceProperties2Enabled &&
+        loader->vkGetPhysicalDeviceFeatures2KHR) {
+        if (pageableDeviceLocalMemoryAvailable) {
+            memoryPriorityFeatures.pNext = &pageableMemoryFeatures;
         }
+        VkPhysicalDeviceFeatures2KHR features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+        features2.pNext = &memoryPriorityFeatures;
+        loader->vkGetPhysicalDeviceFeatures2KHR(physicalDevice, &features2);
+        memoryPrioritySupported = memoryPriorityFeatures.memoryPriority;
+        pageableDeviceLocalMemorySupported = memoryPrioritySupported && pageableDeviceLocalMemoryAvailable &&
+                                             pageableMemoryFeatures.pageableDeviceLocalMemory;
+    }
+    memoryPriorityFeatures = {};
+    memoryPriorityFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PRIORITY_FEATURES_EXT;
+    memoryPriorityFeatures.memoryPriority = VK_TRUE;
+    pageableMemoryFeatures = {};
+    pageableMemoryFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PAGEABLE_DEVICE_LOCAL_MEMORY_FEATURES_EXT;
+    pageableMemoryFeatures.pageableDeviceLocalMemory = VK_TRUE;
+    
+    // Generated sequences bind compute pipelines from an execution set, so the device must take pipeline binds
+    // for the compute stage and hold one pipeline per movement type; VK_KHR_maintenance5 is required for the
+    // indirect bindable pipeline and preprocess buffer flags, and its feature bit is enabled alone as well
+    VkPhysicalDeviceDeviceGeneratedCommandsFeaturesEXT generatedCommandsFeatures{};
+    generatedCommandsFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DEVICE_GENERATED_COMMANDS_FEATURES_EXT;
+    VkPhysicalDeviceMaintenance5FeaturesKHR maintenance5Features{};
+    maintenance5Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_5_FEATURES_KHR;
+    
+    deviceGeneratedCommandsSupported = false;
+    if (ENABLE_DEVICE_GENERATED_COMMANDS && ENABLE_MOVEMENT_TYPE_DISPATCH && deviceGeneratedCommandsAvailable &&
+        maintenance5Available && dynamicRenderingSupported && bufferDeviceAddressSupported && instanceVersion11 &&
+        deviceProperties.apiVersion >= VK_API_VERSION_1_1 && loader->vkGetPhysicalDeviceFeatures2KHR &&
+        loader->vkGetPhysicalDeviceProperties2KHR) {
+        generatedCommandsFeatures.pNext = &maintenance5Features;
+        VkPhysicalDeviceFeatures2KHR features2{};
+        features2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_FEATURES_2_KHR;
+        features2.pNext = &generatedCommandsFeatures;
+        loader->vkGetPhysicalDeviceFeatures2KHR(physicalDevice, &features2);
+        
+        VkPhysicalDeviceDeviceGeneratedCommandsPropertiesEXT generatedCommandsProperties{};
+        generatedCommandsProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DEVICE_GENERATED_COMMANDS_PROPERTIES_EXT;
+        VkPhysicalDeviceProperties2KHR properties2{};
+        properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_PROPERTIES_2_KHR;
+        properties2.pNext = &generatedCommandsProperties;
+        loader->vkGetPhysicalDeviceProperties2KHR(physicalDevice, &properties2);
+        maxIndirectPipelineCount = generatedCommandsProperties.maxIndirectPipelineCount;
+        maxIndirectSequenceCount = generatedCommandsProperties.maxIndirectSequenceCount;
+        
+        deviceGeneratedCommandsSupported = generatedCommandsFeatures.deviceGeneratedCommands && maintenance5Features.maintenance5 &&
+            (generatedCommandsProperties.supportedIndirectCommandsShaderStages & VK_SHADER_STAGE_COMPUTE_BIT) &&
+            (generatedCommandsProperties.supportedIndirectCommandsShaderStagesPipelineBinding & VK_SHADER_STAGE_COMPUTE_BIT) &&
+            maxIndirectPipelineCount >= MOVEMENT_TYPE_COUNT &&
+            maxIndirectSequenceCount >= MOVEMENT_TYPE_COUNT * MAX_SIMULATION_FAST_FORWARD_TICKS_PER_FRAME;
+    }
+    generatedCommandsFeatures = {};
+    generatedCommandsFeatures.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_DEVICE_GENERATED_COMMANDS_FEATURES_EXT;
+    generatedCommandsFeatures.deviceGeneratedCommands = VK_TRUE;
+    maintenance5Features = {};
+    maintenance5Features.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MAINTENANCE_5_FEATURES_KHR;
+    maintenance5Features.maintenance5 = VK_TRUE;
+    
+    void* featureChain = nullptr;
+    if (memoryPrioritySupported) {
+        enabledExtensions.push_back(VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME);
+        memoryPriorityFeatures.pNext = featureChain;
+        featureChain = &memoryPriorityFeatures;
+    }
+    if (pageableDeviceLocalMemorySupported) {
+        enabledExtensions.push_back(VK_EXT_PAGEABLE_DEVICE_LOCAL_MEMORY_EXTENSION_NAME);
+        pageableMemoryFeatures.pNext = featureChain;
+        featureChain = &pageableMemoryFeatures;
+    }
+    if (deviceGeneratedCommandsSupported) {
+        enabledExtensions.push_back(VK_KHR_MAINTENANCE_5_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_EXT_DEVICE_GENERATED_COMMANDS_EXTENSION_NAME);
+        maintenance5Features.pNext = featureChain;
+        generatedCommandsFeatures.pNext = &maintenance5Features;
+        featureChain = &generatedCommandsFeatures;
+    }
+    if (graphicsPipelineLibrarySupported) {
+        enabledExtensions.push_back(VK_KHR_PIPELINE_LIBRARY_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME);
+        pipelineLibraryFeatures.pNext = featureChain;
+        featureChain = &pipelineLibraryFeatures;
+    }
+    if (pipelineExecutableInfoSupported) {
+        enabledExtensions.push_back(VK_KHR_PIPELINE_EXECUTABLE_PROPERTIES_EXTENSION_NAME);
+        executableFeatures.pNext = featureChain;
+        featureChain = &executableFeatures;
+    }
+    if (dynamicRenderingSupported) {
+        enabledExtensions.push_back(VK_KHR_MULTIVIEW_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_MAINTENANCE_2_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_CREATE_RENDERPASS_2_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_DEPTH_STENCIL_RESOLVE_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME);
+        dynamicRenderingFeatures.pNext = featureChain;
+        featureChain = &dynamicRenderingFeatures;
+    }
+    if (presentWaitSupported) {
+        enabledExtensions.push_back(VK_KHR_PRESENT_ID_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_PRESENT_WAIT_EXTENSION_NAME);
+        presentWaitFeatures.pNext = featureChain;
+        presentIdFeatures.pNext = &presentWaitFeatures;
+        featureChain = &presentIdFeatures;
+    }
+    if (bufferDeviceAddressSupported) {
+        enabledExtensions.push_back(VK_KHR_DEVICE_GROUP_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME);
+        bufferDeviceAddressFeatures.pNext = featureChain;
+        featureChain = &bufferDeviceAddressFeatures;
+    }
+    if (bindlessDescriptorsSupported) {
+        enabledExtensions.push_back(VK_KHR_MAINTENANCE_3_EXTENSION_NAME);
+        enabledExtensions.push_back(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME);
+        indexingFeatures.pNext = featureChain;
+        featureChain = &indexingFeatures;
+    }
+    if (synchronization2Supported) {
+        enabledExtensions.push_back(VK_KHR_SYNCHRONIZATION_2_EXTENSION_NAME);
+        synchronization2Features.pNext = featureChain;
+        featureChain = &synchronization2Features;
+    }
+    if (timelineSemaphoreSupported) {
+        timelineFeatures.pNext = featureChain;
+        featureChain = &timelineFeatures;
+    }
+    
+    // Rendering GPU first: device index 0 is where acquires, presents and default submits run
+    const VkPhysicalDevice groupDevices[2] = {physicalDevice, simulationPhysicalDevice};
+    VkDeviceGroupDeviceCreateInfoKHR deviceGroupInfo{};
+    deviceGroupInfo.sType = VK_STRUCTURE_TYPE_DEVICE_GROUP_DEVICE_CREATE_INFO_KHR;
+    if (createDeviceGroup) {
+        deviceGroupInfo.physicalDeviceCount = 2;
+        deviceGroupInfo.pPhysicalDevices = groupDevices;
+        deviceGroupInfo.pNext = featureChain;
+        featureChain = &deviceGroupInfo;
     }
 
     VkDeviceCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_DEVICE_CREATE_INFO;
+    createInfo.pNext = featureChain;
     createInfo.queueCreateInfoCount = static_cast<uint32_t>(queueCreateInfos.size());
     createInfo.pQueueCreateInfos = queueCreateInfos.data();
     createInfo.pEnabledFeatures = &deviceFeatures;
@@ -238,6 +1097,7 @@ bool VulkanContext::createLogicalDevice() {
     }
     
     device = vulkan_raii::make_device(rawDevice, this);
+    deviceGroupCreated = createDeviceGroup;
     
 
     // Store queue family indices for later use after device functions are loaded
@@ -246,6 +1106,35 @@ bool VulkanContext::createLogicalDevice() {
     return true;
 }
 
+void VulkanContext::checkPeerMemory() {
+    multiDeviceSimulation = false;
+    if (!deviceGroupCreated || !loader->vkGetDeviceGroupPeerMemoryFeaturesKHR || !loader->vkBindBufferMemory2KHR) {
+        return;
+    }
+    
+    // The simulation GPU copies into the rendering GPU's instance of every device-local heap a mirror may land in
+    VkPhysicalDeviceMemoryProperties memoryProperties;
+    loader->vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memoryProperties);
+    bool peerCopies = true;
+    for (uint32_t heap = 0; heap < memoryProperties.memoryHeapCount; ++heap) {
+        if (!(memoryProperties.memoryHeaps[heap].flags & VK_MEMORY_HEAP_MULTI_INSTANCE_BIT)) {
+            continue;
+        }
+        VkPeerMemoryFeatureFlagsKHR features = 0;
+        loader->vkGetDeviceGroupPeerMemoryFeaturesKHR(device.get(), heap, 1, 0, &features);
+        peerCopies = peerCopies && (features & VK_PEER_MEMORY_FEATURE_COPY_DST_BIT_KHR);
+    }
+    
+    multiDeviceSimulation = peerCopies;
+    if (multiDeviceSimulation) {
+        std::cout << "VulkanContext: Simulating on '" << simulationDeviceName << "' (device index 1), rendering on '"
+                  << deviceName << "'" << std::endl;
+    } else {
+        std::cerr << "VulkanContext: '" << simulationDeviceName << "' cannot copy into the rendering GPU's memory, "
+                  << "simulation stays on the rendering GPU" << std::endl;
+    }
+}
+
 void VulkanContext::getDeviceQueues() {
     if (!device) {
         std::cerr << "Cannot get device queues: device not created" << std::endl;
@@ -260,6 +1149,10 @@ void VulkanContext::getDeviceQueues() {
     loader->vkGetDeviceQueue(device.get(), queueFamilyIndices.graphicsFamily.value(), 0, &graphicsQueue);
     loader->vkGetDeviceQueue(device.get(), queueFamilyIndices.presentFamily.value(), 0, &presentQueue);
     loader->vkGetDeviceQueue(device.get(), queueFamilyIndices.computeFamily.value(), 0, &computeQueue);
+    backgroundComputeQueue = VK_NULL_HANDLE;
+    if (computeQueueCount > 1) {
+        loader->vkGetDeviceQueue(device.get(), queueFamilyIndices.computeFamily.value(), 1, &backgroundComputeQueue);
+    }
     
     // Get transfer queue if available (otherwise will use graphics queue fallback)
     if (queueFamilyIndices.transferFamily.has_value()) {
@@ -274,7 +1167,25 @@ void VulkanContext::getDeviceQueues() {
     } else {
         std::cout << ", Transfer: " << queueFamilyIndices.graphicsFamily.value() << " (graphics fallback)";
     }
-    std::cout << std::endl;
+    
+    videoEncodeQueue = VK_NULL_HANDLE;
+    if (videoEncodeSupported) {
+        loader->vkGetDeviceQueue(device.get(), queueFamilyIndices.videoEncodeFamily.value(), 0, &videoEncodeQueue);
+        std::cout << ", Video encode: " << queueFamilyIndices.videoEncodeFamily.value();
+    }
+    std::cout << (backgroundComputeQueue ? ", background compute queue" : "") << std::endl;
+}
+
+VkQueue VulkanContext::getTransferQueue() const {
+    if (transferQueue) {
+        return transferQueue;
+    }
+    // Without a dedicated family, uploads use the graphics family; its low-priority queue keeps them out of
+    // the frame's submission order without any queue family ownership transfer
+    if (backgroundComputeQueue && queueFamilyIndices.computeFamily == queueFamilyIndices.graphicsFamily) {
+        return backgroundComputeQueue;
+    }
+    return graphicsQueue;
 }
 
 QueueFamilyIndices VulkanContext::findQueueFamilies(VkPhysicalDevice device) const {
@@ -356,9 +1267,6 @@ QueueFamilyIndices VulkanContext::findQueueFamilies(VkPhysicalDevice device) con
 }
 
 bool VulkanContext::isDeviceSuitable(VkPhysicalDevice device) {
-    VkPhysicalDeviceProperties deviceProperties;
-    loader->vkGetPhysicalDeviceProperties(device, &deviceProperties);
-    
     // Check extension support
     uint32_t extensionCount;
     loader->vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
@@ -372,13 +1280,28 @@ bool VulkanContext::isDeviceSuitable(VkPhysicalDevice device) {
     std::set<std::string> optionalExtensions = { VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME };
     
     // Check which extensions are available
-    std::set<std::string> supportedExtensions;
     for (const auto& extension : availableExtensions) {
-        supportedExtensions.insert(extension.extensionName);
         requiredExtensions.erase(extension.extensionName);
         optionalExtensions.erase(extension.extensionName);
     }
     
+    bool extensionsSupported = requiredExtensions.empty();
+    QueueFamilyIndices indices = findQueueFamilies(device);
+    
+    return indices.isComplete() && extensionsSupported;
+}
+
+void VulkanContext::logDeviceExtensions(VkPhysicalDevice device) const {
+    uint32_t extensionCount;
+    loader->vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, nullptr);
+    std::vector<VkExtensionProperties> availableExtensions(extensionCount);
+    loader->vkEnumerateDeviceExtensionProperties(device, nullptr, &extensionCount, availableExtensions.data());
+    
+    std::set<std::string> supportedExtensions;
+    for (const auto& extension : availableExtensions) {
+        supportedExtensions.insert(extension.extensionName);
+    }
+    
     // Log extension support for diagnostics
     if (supportedExtensions.count(VK_EXT_SWAPCHAIN_MAINTENANCE_1_EXTENSION_NAME)) {
         std::cout << "VK_EXT_swapchain_maintenance1 supported - enabling low-latency optimizations" << std::endl;
@@ -386,10 +1309,109 @@ bool VulkanContext::isDeviceSuitable(VkPhysicalDevice device) {
         std::cout << "VK_EXT_swapchain_maintenance1 not supported - using standard presentation" << std::endl;
     }
     
-    bool extensionsSupported = requiredExtensions.empty();
-    QueueFamilyIndices indices = findQueueFamilies(device);
+    if (supportedExtensions.count(VK_KHR_TIMELINE_SEMAPHORE_EXTENSION_NAME)) {
+        std::cout << "VK_KHR_timeline_semaphore supported - enabling timeline frame pacing" << std::endl;
+    } else {
+        std::cout << "VK_KHR_timeline_semaphore not supported - using per-frame fences" << std::endl;
+    }
     
-    return indices.isComplete() && extensionsSupported;
+    if (supportedExtensions.count(VK_EXT_DESCRIPTOR_INDEXING_EXTENSION_NAME)) {
+        std::cout << "VK_EXT_descriptor_indexing supported - bindless entity descriptors available" << std::endl;
+    } else {
+        std::cout << "VK_EXT_descriptor_indexing not supported - using per-pipeline entity descriptor sets" << std::endl;
+    }
+    
+    if (supportedExtensions.count(VK_KHR_BUFFER_DEVICE_ADDRESS_EXTENSION_NAME)) {
+        std::cout << "VK_KHR_buffer_device_address supported - entity streams addressable from shaders" << std::endl;
+    } else {
+        std::cout << "VK_KHR_buffer_device_address not supported - entity streams bound through descriptors" << std::endl;
+    }
+    
+    if (supportedExtensions.count(VK_KHR_DESCRIPTOR_UPDATE_TEMPLATE_EXTENSION_NAME)) {
+        std::cout << "VK_KHR_descriptor_update_template supported - descriptor sets rewritten through templates" << std::endl;
+    } else {
+        std::cout << "VK_KHR_descriptor_update_template not supported - descriptor sets rewritten through write arrays" << std::endl;
+    }
+    
+    if (supportedExtensions.count(VK_KHR_PUSH_DESCRIPTOR_EXTENSION_NAME)) {
+        std::cout << "VK_KHR_push_descriptor supported - transient pass bindings pushed without descriptor pools" << std::endl;
+    } else {
+        std::cout << "VK_KHR_push_descriptor not supported - transient passes bind pool-allocated descriptor sets" << std::endl;
+    }
+    
+    if (supportedExtensions.count(VK_KHR_PRESENT_ID_EXTENSION_NAME) && supportedExtensions.count(VK_KHR_PRESENT_WAIT_EXTENSION_NAME)) {
+        std::cout << "VK_KHR_present_wait supported - frame pacing can wait on presented frames" << std::endl;
+    } else {
+        std::cout << "VK_KHR_present_wait not supported - frame pacing uses CPU timing only" << std::endl;
+    }
+    
+    if (supportedExtensions.count(VK_GOOGLE_DISPLAY_TIMING_EXTENSION_NAME)) {
+        std::cout << "VK_GOOGLE_display_timing supported - present latency read from actual display times" << std::endl;
+    } else {
+        std::cout << "VK_GOOGLE_display_timing not supported - present latency observed through present wait" << std::endl;
+    }
+    
+    if (supportedExtensions.count(VK_EXT_MEMORY_BUDGET_EXTENSION_NAME)) {
+        std::cout << "VK_EXT_memory_budget supported - memory pressure follows driver heap budgets" << std::endl;
+    } else {
+        std::cout << "VK_EXT_memory_budget not supported - memory pressure estimated from own allocations" << std::endl;
+    }
+    
+    if (supportedExtensions.count(VK_EXT_MEMORY_PRIORITY_EXTENSION_NAME)) {
+        std::cout << "VK_EXT_memory_priority supported - entity streams kept resident ahead of cold buffers" << std::endl;
+    } else {
+        std::cout << "VK_EXT_memory_priority not supported - the OS demotes device memory without priorities" << std::endl;
+    }
+    
+    if (supportedExtensions.count(VK_EXT_PAGEABLE_DEVICE_LOCAL_MEMORY_EXTENSION_NAME)) {
+        std::cout << "VK_EXT_pageable_device_local_memory supported - oversubscribed memory paged by priority" << std::endl;
+    } else {
+        std::cout << "VK_EXT_pageable_device_local_memory not supported - oversubscription left to the driver" << std::endl;
+    }
+    
+    if (supportedExtensions.count(VK_KHR_DYNAMIC_RENDERING_EXTENSION_NAME)) {
+        std::cout << "VK_KHR_dynamic_rendering supported - entities drawn without render pass objects" << std::endl;
+    } else {
+        std::cout << "VK_KHR_dynamic_rendering not supported - entities drawn through render passes and framebuffers" << std::endl;
+    }
+    
+    if (supportedExtensions.count(VK_EXT_DEVICE_GENERATED_COMMANDS_EXTENSION_NAME)) {
+        std::cout << "VK_EXT_device_generated_commands supported - movement kernels bound and dispatched by GPU-written sequences" << std::endl;
+    } else {
+        std::cout << "VK_EXT_device_generated_commands not supported - movement kernels recorded per type by the CPU" << std::endl;
+    }
+    
+    if (supportedExtensions.count(VK_KHR_PIPELINE_EXECUTABLE_PROPERTIES_EXTENSION_NAME)) {
+        std::cout << "VK_KHR_pipeline_executable_properties supported - shader register and spill figures reported" << std::endl;
+    } else {
+        std::cout << "VK_KHR_pipeline_executable_properties not supported - no shader register statistics" << std::endl;
+    }
+    
+    if (supportedExtensions.count(VK_EXT_GRAPHICS_PIPELINE_LIBRARY_EXTENSION_NAME)) {
+        std::cout << "VK_EXT_graphics_pipeline_library supported - graphics permutations linked from shared parts" << std::endl;
+    } else {
+        std::cout << "VK_EXT_graphics_pipeline_library not supported - graphics permutations compiled whole" << std::endl;
+    }
+    
+    if (supportedExtensions.count(VK_KHR_DRAW_INDIRECT_COUNT_EXTENSION_NAME)) {
+        std::cout << "VK_KHR_draw_indirect_count supported - entity shapes drawn from GPU-binned lists" << std::endl;
+    } else {
+        std::cout << "VK_KHR_draw_indirect_count not supported - entities drawn as a single shape" << std::endl;
+    }
+    
+    if (supportedExtensions.count(VK_AMD_BUFFER_MARKER_EXTENSION_NAME)) {
+        std::cout << "VK_AMD_buffer_marker supported - frame graph nodes leave breadcrumbs for hang reports" << std::endl;
+    } else if (supportedExtensions.count(VK_NV_DEVICE_DIAGNOSTIC_CHECKPOINTS_EXTENSION_NAME)) {
+        std::cout << "VK_NV_device_diagnostic_checkpoints supported - device loss reports the last checkpoints" << std::endl;
+    } else {
+        std::cout << "No GPU breadcrumb extension - hang reports name no node" << std::endl;
+    }
+    
+    if (supportedExtensions.count(VK_EXT_CALIBRATED_TIMESTAMPS_EXTENSION_NAME)) {
+        std::cout << "VK_EXT_calibrated_timestamps supported - GPU zones placed on the CPU timeline by calibration" << std::endl;
+    } else {
+        std::cout << "VK_EXT_calibrated_timestamps not supported - GPU zones placed on the CPU timeline from readback times" << std::endl;
+    }
 }
 
 std::vector<const char*> VulkanContext::getRequiredExtensions() {
@@ -406,6 +1428,45 @@ std::vector<const char*> VulkanContext::getRequiredExtensions() {
     // Add debug utils extension for validation layer callbacks
     requiredExtensions.push_back(VK_EXT_DEBUG_UTILS_EXTENSION_NAME);
     
+    // VK_KHR_timeline_semaphore and VK_EXT_descriptor_indexing depend on physical device properties2 under a
+    // Vulkan 1.0 instance; VK_KHR_buffer_device_address also needs device groups for its allocation flags (and
+    // --simulation-gpu for the group itself), and
+    // the export extensions the external memory and semaphore capability queries
+    const bool externalExport = ENABLE_EXTERNAL_POSITION_EXPORT && externalExportRequested;
+    const bool deviceGroup = ENABLE_ENTITY_BUFFER_DEVICE_ADDRESS ||
+                             (ENABLE_MULTI_DEVICE_SIMULATION && !simulationDeviceRequested.empty());
+    bool externalMemoryCapabilities = false;
+    bool externalSemaphoreCapabilities = false;
+    if ((ENABLE_TIMELINE_FRAME_PACING || ENABLE_BINDLESS_ENTITY_DESCRIPTORS || deviceGroup ||
+         externalExport) && loader->vkEnumerateInstanceExtensionProperties) {
+        uint32_t instanceExtensionCount = 0;
+        loader->vkEnumerateInstanceExtensionProperties(nullptr, &instanceExtensionCount, nullptr);
+        std::vector<VkExtensionProperties> instanceExtensions(instanceExtensionCount);
+        loader->vkEnumerateInstanceExtensionProperties(nullptr, &instanceExtensionCount, instanceExtensions.data());
+        
+        for (const auto& extension : instanceExtensions) {
+            const std::string extensionName(extension.extensionName);
+            if (extensionName == VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME) {
+                requiredExtensions.push_back(VK_KHR_GET_PHYSICAL_DEVICE_PROPERTIES_2_EXTENSION_NAME);
+                physicalDeviceProperties2Enabled = true;
+            } else if (deviceGroup && extensionName == VK_KHR_DEVICE_GROUP_CREATION_EXTENSION_NAME) {
+                requiredExtensions.push_back(VK_KHR_DEVICE_GROUP_CREATION_EXTENSION_NAME);
+                deviceGroupCreationEnabled = true;
+            } else if (externalExport && extensionName == VK_KHR_EXTERNAL_MEMORY_CAPABILITIES_EXTENSION_NAME) {
+                externalMemoryCapabilities = true;
+            } else if (externalExport && extensionName == VK_KHR_EXTERNAL_SEMAPHORE_CAPABILITIES_EXTENSION_NAME) {
+                externalSemaphoreCapabilities = true;
+            }
+        }
+    }
+    
+    // Both or neither, and they build on properties2 themselves
+    externalCapabilitiesEnabled = externalMemoryCapabilities && externalSemaphoreCapabilities && physicalDeviceProperties2Enabled;
+    if (externalCapabilitiesEnabled) {
+        requiredExtensions.push_back(VK_KHR_EXTERNAL_MEMORY_CAPABILITIES_EXTENSION_NAME);
+        requiredExtensions.push_back(VK_KHR_EXTERNAL_SEMAPHORE_CAPABILITIES_EXTENSION_NAME);
+    }
+    
     return requiredExtensions;
 }
 
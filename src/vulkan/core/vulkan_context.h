@@ -5,15 +5,18 @@
 #include <SDL3/SDL.h>
 #include <SDL3/SDL_vulkan.h>
 #include <optional>
+#include <string>
 #include <vector>
 #include <memory>
 #include "vulkan_raii.h"
+#include "vulkan_constants.h"
 
 struct QueueFamilyIndices {
     std::optional<uint32_t> graphicsFamily;
     std::optional<uint32_t> presentFamily;
     std::optional<uint32_t> computeFamily;
     std::optional<uint32_t> transferFamily;
+    std::optional<uint32_t> videoEncodeFamily;  // H.264 encode, only looked for when recording is requested
 
     bool isComplete() const {
         return graphicsFamily.has_value() && presentFamily.has_value() && computeFamily.has_value();
@@ -42,15 +45,24 @@ public:
 
     VkInstance getInstance() const { return instance.get(); }
     VkSurfaceKHR getSurface() const { return surface.get(); }
+    // Surface of another window on this instance (output windows); null when SDL cannot create one
+    vulkan_raii::SurfaceKHR createWindowSurface(SDL_Window* otherWindow) const;
+    // Whether the present queue can present to a surface other than the one the device was picked for
+    bool supportsPresentTo(VkSurfaceKHR otherSurface) const;
     VkPhysicalDevice getPhysicalDevice() const { return physicalDevice; }
     VkDevice getDevice() const { return device.get(); }
     VkQueue getGraphicsQueue() const { return graphicsQueue; }
     VkQueue getPresentQueue() const { return presentQueue; }
     VkQueue getComputeQueue() const { return computeQueue; }
-    VkQueue getTransferQueue() const { return transferQueue ? transferQueue : graphicsQueue; } // Fallback to graphics
+    VkQueue getTransferQueue() const; // Dedicated transfer, else the background queue when it shares the graphics family
+    // Low-priority compute family queue (ENABLE_BACKGROUND_COMPUTE_QUEUE), the frame compute queue when the family has one
+    VkQueue getBackgroundComputeQueue() const { return backgroundComputeQueue ? backgroundComputeQueue : computeQueue; }
     uint32_t getGraphicsQueueFamily() const { return queueFamilyIndices.graphicsFamily.value(); }
     uint32_t getComputeQueueFamily() const { return queueFamilyIndices.computeFamily.value(); }
     uint32_t getPresentQueueFamily() const { return queueFamilyIndices.presentFamily.value(); }
+    // Video encode queue (VulkanContext::supportsVideoEncode), VK_NULL_HANDLE without one
+    VkQueue getVideoEncodeQueue() const { return videoEncodeQueue; }
+    uint32_t getVideoEncodeQueueFamily() const { return queueFamilyIndices.videoEncodeFamily.value_or(VK_QUEUE_FAMILY_IGNORED); }
     uint32_t getTransferQueueFamily() const { 
         return queueFamilyIndices.transferFamily.has_value() ? 
                queueFamilyIndices.transferFamily.value() : 
@@ -60,6 +72,67 @@ public:
     // Queue capability queries
     bool hasDedicatedTransferQueue() const { return queueFamilyIndices.hasDirectTransfer(); }
     bool hasDedicatedComputeQueue() const { return queueFamilyIndices.hasDedicatedCompute(); }
+    bool hasBackgroundComputeQueue() const { return backgroundComputeQueue != VK_NULL_HANDLE; }
+    bool supportsTimelineSemaphores() const { return timelineSemaphoreSupported; }
+    bool supportsSynchronization2() const { return synchronization2Supported; }
+    bool supportsPipelineStatistics() const { return pipelineStatisticsSupported; }
+    bool supportsOverdrawCounting() const { return overdrawCountingSupported; }  // ENABLE_OVERDRAW_DIAGNOSTIC
+    bool supportsPipelineExecutableInfo() const { return pipelineExecutableInfoSupported; }
+    bool supportsGraphicsPipelineLibrary() const { return graphicsPipelineLibrarySupported; }
+    bool supportsDrawIndirectCount() const { return drawIndirectCountSupported; }  // ENABLE_ENTITY_SHAPE_BINNING
+    bool supportsBufferMarkers() const { return bufferMarkerSupported; }                  // ENABLE_GPU_BREADCRUMBS
+    bool supportsDiagnosticCheckpoints() const { return diagnosticCheckpointsSupported; }  // Only without buffer markers
+    bool supportsCalibratedTimestamps() const { return calibratedTimestampsSupported; }    // ENABLE_CALIBRATED_TIMESTAMPS
+    bool supportsBindlessDescriptors() const { return bindlessDescriptorsSupported; }
+    uint32_t getMaxBindlessStorageBuffers() const { return maxBindlessStorageBuffers; }
+    bool supportsBufferDeviceAddress() const { return bufferDeviceAddressSupported; }
+    bool supportsDescriptorUpdateTemplates() const { return descriptorUpdateTemplateSupported; }
+    bool supportsPushDescriptors() const { return pushDescriptorSupported; }  // ENABLE_PUSH_DESCRIPTORS
+    bool supportsMemoryBudget() const { return memoryBudgetSupported; }
+    bool supportsMemoryPriority() const { return memoryPrioritySupported; }  // ENABLE_MEMORY_PRIORITY
+    bool supportsPageableDeviceLocalMemory() const { return pageableDeviceLocalMemorySupported; }
+    bool supportsPresentWait() const { return presentWaitSupported; }
+    bool supportsDisplayTiming() const { return displayTimingSupported; }  // ENABLE_DISPLAY_TIMING
+    bool supportsDynamicRendering() const { return dynamicRenderingSupported; }
+    // ENABLE_DEVICE_GENERATED_COMMANDS, compute pipeline execution sets only
+    bool supportsDeviceGeneratedCommands() const { return deviceGeneratedCommandsSupported; }
+    uint32_t getMaxIndirectPipelineCount() const { return maxIndirectPipelineCount; }
+    uint32_t getMaxIndirectSequenceCount() const { return maxIndirectSequenceCount; }
+    bool supportsSubgroupBallot() const { return subgroupBallotSupported; }
+    bool supportsSparseEntityBuffers() const { return sparseEntityBuffersSupported; }  // ENABLE_SPARSE_ENTITY_BUFFERS
+    bool supportsExternalPositionExport() const { return externalExportSupported; }    // Only when requested
+    bool supportsVideoEncode() const { return videoEncodeSupported; }                   // Only when requested
+    
+    // External memory and semaphore export (ENABLE_EXTERNAL_POSITION_EXPORT) - set before initialize(), as the
+    // extensions are only enabled when asked for
+    void setExternalExportRequested(bool requested) { externalExportRequested = requested; }
+    
+    // Vulkan Video H.264 encode for --record (ENABLE_VIDEO_ENCODE) - set before initialize(): the instance is
+    // then created for Vulkan 1.1, which the video extensions need, and the encode queue family is created
+    void setVideoEncodeRequested(bool requested) { videoEncodeRequested = requested; }
+    
+    // Physical device by name substring or UUID, set before initialize(); empty falls back to GPU_OVERRIDE_ENV,
+    // then to the ranking (device type, VRAM, async compute and transfer queues, subgroup size, extensions)
+    void setPreferredDevice(const std::string& nameOrUuid) { preferredDevice = nameOrUuid; }
+    const std::string& getDeviceName() const { return deviceName; }
+    const std::string& getDeviceUuid() const { return deviceUuid; }  // Lowercase hex, empty where not reported
+    
+    // Multi-device simulation (ENABLE_MULTI_DEVICE_SIMULATION) - set before initialize(): a second GPU of the
+    // rendering GPU's device group by name substring or UUID, or "auto" for the first other one. The rendering
+    // GPU is device index 0; compute batches run on the simulation GPU's index
+    void setSimulationDeviceRequested(const std::string& nameOrUuid) { simulationDeviceRequested = nameOrUuid; }
+    bool isMultiDeviceSimulation() const { return multiDeviceSimulation; }
+    const std::string& getSimulationDeviceName() const { return simulationDeviceName; }
+    uint32_t getSimulationDeviceIndex() const { return multiDeviceSimulation ? 1u : 0u; }
+    // Submit device masks, 0 without a device group (submits then take their defaults); with a group whose
+    // peer copies fell short everything runs on the rendering GPU
+    uint32_t getRenderDeviceMask() const { return deviceGroupCreated ? 1u : 0u; }
+    uint32_t getSimulationDeviceMask() const { return multiDeviceSimulation ? 2u : getRenderDeviceMask(); }
+    uint32_t getAllDevicesMask() const { return multiDeviceSimulation ? 3u : getRenderDeviceMask(); }
+    
+    // Frames-in-flight depth - set before initialize(), sizes every per-frame array
+    void setFramesInFlight(uint32_t count);
+    uint32_t getFramesInFlight() const { return framesInFlight; }
     const QueueFamilyIndices& getQueueFamilyIndices() const { return queueFamilyIndices; }
     
     class VulkanFunctionLoader& getLoader() const { return *loader; }
@@ -78,7 +151,66 @@ private:
     VkQueue presentQueue = VK_NULL_HANDLE;
     VkQueue computeQueue = VK_NULL_HANDLE;
     VkQueue transferQueue = VK_NULL_HANDLE;
+    VkQueue backgroundComputeQueue = VK_NULL_HANDLE;  // Queue 1 of the compute family
+    VkQueue videoEncodeQueue = VK_NULL_HANDLE;
+    uint32_t computeQueueCount = 1;                   // Queues created in the compute family
     QueueFamilyIndices queueFamilyIndices;
+    
+    // Optional features enabled at instance/device creation
+    bool physicalDeviceProperties2Enabled = false;
+    bool deviceGroupCreationEnabled = false;
+    bool timelineSemaphoreSupported = false;
+    bool synchronization2Supported = false;
+    bool pipelineStatisticsSupported = false;
+    bool overdrawCountingSupported = false;
+    bool pipelineExecutableInfoSupported = false;
+    bool graphicsPipelineLibrarySupported = false;
+    bool drawIndirectCountSupported = false;
+    bool bufferMarkerSupported = false;
+    bool diagnosticCheckpointsSupported = false;
+    bool calibratedTimestampsSupported = false;
+    bool bindlessDescriptorsSupported = false;
+    uint32_t maxBindlessStorageBuffers = 0;  // Per-stage update-after-bind storage buffer limit
+    bool bufferDeviceAddressSupported = false;
+    bool descriptorUpdateTemplateSupported = false;
+    bool pushDescriptorSupported = false;
+    bool memoryBudgetSupported = false;
+    bool memoryPrioritySupported = false;
+    bool pageableDeviceLocalMemorySupported = false;
+    bool presentWaitSupported = false;
+    bool displayTimingSupported = false;
+    bool dynamicRenderingSupported = false;
+    bool deviceGeneratedCommandsSupported = false;
+    uint32_t maxIndirectPipelineCount = 0;  // Pipelines one indirect execution set can hold
+    uint32_t maxIndirectSequenceCount = 0;
+    bool subgroupBallotSupported = false;
+    bool sparseEntityBuffersSupported = false;
+    bool externalExportRequested = false;
+    bool externalCapabilitiesEnabled = false;  // Instance side of the export extensions
+    bool externalExportSupported = false;
+    bool videoEncodeRequested = false;
+    bool instanceVersion11 = false;            // Instance created for Vulkan 1.1 (video encode or generated commands)
+    bool videoEncodeSupported = false;
+    std::string simulationDeviceRequested;
+    VkPhysicalDevice simulationPhysicalDevice = VK_NULL_HANDLE;  // Other member of the device group, once picked
+    bool deviceGroupCreated = false;
+    bool multiDeviceSimulation = false;
+    std::string simulationDeviceName;
+    
+    uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT;
+    std::string preferredDevice;
+    std::string deviceName;
+    std::string deviceUuid;
+    
+    // One enumerated device as pickPhysicalDevice() ranks it
+    struct DeviceCandidate {
+        VkPhysicalDevice device = VK_NULL_HANDLE;
+        std::string name;
+        std::string uuid;  // Lowercase hex, empty when the device cannot report it
+        bool suitable = false;
+        uint64_t score = 0;
+        std::string summary;
+    };
 
     std::unique_ptr<class VulkanFunctionLoader> loader;
     vulkan_raii::DebugUtilsMessengerEXT debugMessenger;
@@ -88,6 +220,10 @@ private:
     bool pickPhysicalDevice();
     bool createLogicalDevice();
     bool isDeviceSuitable(VkPhysicalDevice device);
+    DeviceCandidate rankPhysicalDevice(VkPhysicalDevice device);
+    void pickSimulationDevice(const std::vector<DeviceCandidate>& candidates);
+    void checkPeerMemory();
+    void logDeviceExtensions(VkPhysicalDevice device) const;
     bool setupDebugMessenger();
     void cleanupDebugMessenger();
     
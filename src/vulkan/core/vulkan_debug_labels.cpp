@@ -0,0 +1,63 @@
+#include "vulkan_debug_labels.h"
+
+#if VULKAN_DEBUG_LABELS_ENABLED
+
+#include "vulkan_context.h"
+#include "vulkan_function_loader.h"
+#include <functional>
+
+namespace VulkanDebugLabels {
+
+void beginLabel(const VulkanContext& context, VkCommandBuffer commandBuffer, const std::string& name) {
+    const auto& vk = context.getLoader();
+    if (!vk.vkCmdBeginDebugUtilsLabelEXT) {
+        return;
+    }
+    
+    // Hue from the name at fixed saturation and value, bright enough to read labels over
+    const float hue = static_cast<float>(std::hash<std::string>{}(name) % 360) / 60.0f;
+    const int sector = static_cast<int>(hue);
+    const float rising = hue - static_cast<float>(sector);
+    const float high = 0.9f;
+    const float low = 0.35f;
+    const float up = low + (high - low) * rising;
+    const float down = high - (high - low) * rising;
+    const float rgb[6][3] = {
+        {high, up, low}, {down, high, low}, {low, high, up},
+        {low, down, high}, {up, low, high}, {high, low, down}
+    };
+    
+    VkDebugUtilsLabelEXT label{};
+    label.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_LABEL_EXT;
+    label.pLabelName = name.c_str();
+    label.color[0] = rgb[sector % 6][0];
+    label.color[1] = rgb[sector % 6][1];
+    label.color[2] = rgb[sector % 6][2];
+    label.color[3] = 1.0f;
+    vk.vkCmdBeginDebugUtilsLabelEXT(commandBuffer, &label);
+}
+
+void endLabel(const VulkanContext& context, VkCommandBuffer commandBuffer) {
+    const auto& vk = context.getLoader();
+    if (vk.vkCmdEndDebugUtilsLabelEXT) {
+        vk.vkCmdEndDebugUtilsLabelEXT(commandBuffer);
+    }
+}
+
+void setObjectName(const VulkanContext& context, VkObjectType type, uint64_t handle, const std::string& name) {
+    const auto& vk = context.getLoader();
+    if (!vk.vkSetDebugUtilsObjectNameEXT) {
+        return;
+    }
+    
+    VkDebugUtilsObjectNameInfoEXT nameInfo{};
+    nameInfo.sType = VK_STRUCTURE_TYPE_DEBUG_UTILS_OBJECT_NAME_INFO_EXT;
+    nameInfo.objectType = type;
+    nameInfo.objectHandle = handle;
+    nameInfo.pObjectName = name.c_str();
+    vk.vkSetDebugUtilsObjectNameEXT(context.getDevice(), &nameInfo);
+}
+
+} // namespace VulkanDebugLabels
+
+#endif
@@ -0,0 +1,43 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <string>
+
+class VulkanContext;
+
+// Command buffer labels and object names through VK_EXT_debug_utils, so RenderDoc and Nsight captures show
+// frame graph nodes and resources by name. Compiled in for debug builds (and with VULKAN_DEBUG_LABELS defined);
+// release builds get empty inlines. The extension is enabled on every instance, but a loader without it leaves
+// the entry points null and every call is skipped
+#if !defined(NDEBUG) || defined(VULKAN_DEBUG_LABELS)
+    #define VULKAN_DEBUG_LABELS_ENABLED 1
+#else
+    #define VULKAN_DEBUG_LABELS_ENABLED 0
+#endif
+
+namespace VulkanDebugLabels {
+
+#if VULKAN_DEBUG_LABELS_ENABLED
+    // Colour derived from the name, so a node keeps its colour across captures
+    void beginLabel(const VulkanContext& context, VkCommandBuffer commandBuffer, const std::string& name);
+    void endLabel(const VulkanContext& context, VkCommandBuffer commandBuffer);
+    void setObjectName(const VulkanContext& context, VkObjectType type, uint64_t handle, const std::string& name);
+#else
+    inline void beginLabel(const VulkanContext&, VkCommandBuffer, const std::string&) {}
+    inline void endLabel(const VulkanContext&, VkCommandBuffer) {}
+    inline void setObjectName(const VulkanContext&, VkObjectType, uint64_t, const std::string&) {}
+#endif
+
+// Non-dispatchable handles are pointers on 64-bit targets and uint64_t elsewhere
+template<typename Handle>
+inline void nameObject(const VulkanContext& context, VkObjectType type, Handle handle, const std::string& name) {
+    if constexpr (VULKAN_DEBUG_LABELS_ENABLED) {
+        if (handle != VK_NULL_HANDLE && !name.empty()) {
+            setObjectName(context, type, (uint64_t)handle, name);
+        }
+    }
+}
+
+} // namespace VulkanDebugLabels
@@ -96,18 +96,31 @@ bool VulkanFunctionLoader::loadDeviceFunctions() {
 void VulkanFunctionLoader::loadCoreInstanceFunctions() {
     LOAD_PRE_INSTANCE_FUNCTION(vkCreateInstance);
     LOAD_PRE_INSTANCE_FUNCTION(vkEnumerateInstanceExtensionProperties);
+    LOAD_PRE_INSTANCE_FUNCTION(vkEnumerateInstanceVersion);
 }
 
 void VulkanFunctionLoader::loadPhysicalDeviceFunctions() {
     LOAD_INSTANCE_FUNCTION(vkEnumeratePhysicalDevices);
     LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceProperties);
+    LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceFeatures);
     LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceQueueFamilyProperties);
     LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceMemoryProperties);
+    LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceFormatProperties);
     LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceSurfaceSupportKHR);
     LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceSurfaceCapabilitiesKHR);
     LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceSurfaceFormatsKHR);
     LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceSurfacePresentModesKHR);
     LOAD_INSTANCE_FUNCTION(vkEnumerateDeviceExtensionProperties);
+    LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceFeatures2KHR);
+    LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceProperties2KHR);
+    LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceMemoryProperties2KHR);
+    LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceQueueFamilyProperties2KHR);
+    LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceExternalBufferPropertiesKHR);
+    LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceExternalSemaphorePropertiesKHR);
+    LOAD_INSTANCE_FUNCTION(vkEnumeratePhysicalDeviceGroupsKHR);
+    LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceVideoCapabilitiesKHR);
+    LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceVideoFormatPropertiesKHR);
+    LOAD_INSTANCE_FUNCTION(vkGetPhysicalDeviceCalibrateableTimeDomainsEXT);
     // Load vkCreateDevice here since it's needed before device creation
     LOAD_INSTANCE_FUNCTION(vkCreateDevice);
 }
@@ -119,6 +132,9 @@ void VulkanFunctionLoader::loadSurfaceFunctions() {
     // Debug utils functions
     LOAD_INSTANCE_FUNCTION(vkCreateDebugUtilsMessengerEXT);
     LOAD_INSTANCE_FUNCTION(vkDestroyDebugUtilsMessengerEXT);
+    LOAD_INSTANCE_FUNCTION(vkCmdBeginDebugUtilsLabelEXT);
+    LOAD_INSTANCE_FUNCTION(vkCmdEndDebugUtilsLabelEXT);
+    LOAD_INSTANCE_FUNCTION(vkSetDebugUtilsObjectNameEXT);
 }
 
 void VulkanFunctionLoader::loadDeviceManagementFunctions() {
@@ -160,6 +176,13 @@ void VulkanFunctionLoader::loadSwapchainFunctions() {
     
     // Load VK_EXT_swapchain_maintenance1 extension functions (optional)
     LOAD_DEVICE_FUNCTION(vkReleaseSwapchainImagesEXT);
+    
+    // VK_KHR_present_wait (optional)
+    LOAD_DEVICE_FUNCTION(vkWaitForPresentKHR);
+    
+    // VK_GOOGLE_display_timing (optional)
+    LOAD_DEVICE_FUNCTION(vkGetRefreshCycleDurationGOOGLE);
+    LOAD_DEVICE_FUNCTION(vkGetPastPresentationTimingGOOGLE);
 }
 
 void VulkanFunctionLoader::loadPipelineFunctions() {
@@ -173,6 +196,7 @@ void VulkanFunctionLoader::loadPipelineFunctions() {
     LOAD_DEVICE_FUNCTION(vkDestroyPipelineLayout);
     LOAD_DEVICE_FUNCTION(vkCreatePipelineCache);
     LOAD_DEVICE_FUNCTION(vkDestroyPipelineCache);
+    LOAD_DEVICE_FUNCTION(vkGetPipelineCacheData);
     LOAD_DEVICE_FUNCTION(vkCreateGraphicsPipelines);
     LOAD_DEVICE_FUNCTION(vkCreateComputePipelines);
     LOAD_DEVICE_FUNCTION(vkDestroyPipeline);
@@ -186,6 +210,14 @@ void VulkanFunctionLoader::loadDescriptorFunctions() {
     LOAD_DEVICE_FUNCTION(vkResetDescriptorPool);
     LOAD_DEVICE_FUNCTION(vkAllocateDescriptorSets);
     LOAD_DEVICE_FUNCTION(vkUpdateDescriptorSets);
+    
+    // Load VK_KHR_descriptor_update_template extension functions (optional)
+    LOAD_DEVICE_FUNCTION(vkCreateDescriptorUpdateTemplateKHR);
+    LOAD_DEVICE_FUNCTION(vkDestroyDescriptorUpdateTemplateKHR);
+    LOAD_DEVICE_FUNCTION(vkUpdateDescriptorSetWithTemplateKHR);
+    
+    // Load VK_KHR_push_descriptor extension functions (optional)
+    LOAD_DEVICE_FUNCTION(vkCmdPushDescriptorSetKHR);
 }
 
 void VulkanFunctionLoader::loadSynchronizationFunctions() {
@@ -196,8 +228,47 @@ void VulkanFunctionLoader::loadSynchronizationFunctions() {
     LOAD_DEVICE_FUNCTION(vkWaitForFences);
     LOAD_DEVICE_FUNCTION(vkResetFences);
     LOAD_DEVICE_FUNCTION(vkGetFenceStatus);
+    
+    // Load VK_KHR_timeline_semaphore extension functions (optional)
+    LOAD_DEVICE_FUNCTION(vkWaitSemaphoresKHR);
+    LOAD_DEVICE_FUNCTION(vkGetSemaphoreCounterValueKHR);
+    
+    // Load VK_KHR_buffer_device_address extension functions (optional)
+    LOAD_DEVICE_FUNCTION(vkGetBufferDeviceAddressKHR);
+    
+    // Load VK_KHR_device_group / VK_KHR_bind_memory2 extension functions (optional)
+    LOAD_DEVICE_FUNCTION(vkGetDeviceGroupPeerMemoryFeaturesKHR);
+    LOAD_DEVICE_FUNCTION(vkBindBufferMemory2KHR);
+    
+    // Load VK_KHR_external_memory_* / VK_KHR_external_semaphore_* handle export functions (optional)
+#if defined(VK_USE_PLATFORM_WIN32_KHR)
+    LOAD_DEVICE_FUNCTION(vkGetMemoryWin32HandleKHR);
+    LOAD_DEVICE_FUNCTION(vkGetSemaphoreWin32HandleKHR);
+#else
+    LOAD_DEVICE_FUNCTION(vkGetMemoryFdKHR);
+    LOAD_DEVICE_FUNCTION(vkGetSemaphoreFdKHR);
+#endif
+    
+    // Load VK_KHR_pipeline_executable_properties extension functions (optional)
+    LOAD_DEVICE_FUNCTION(vkGetPipelineExecutablePropertiesKHR);
+    LOAD_DEVICE_FUNCTION(vkGetPipelineExecutableStatisticsKHR);
+    
+    // Load VK_EXT_calibrated_timestamps extension function (optional)
+    LOAD_DEVICE_FUNCTION(vkGetCalibratedTimestampsEXT);
+    
+    // Load VK_EXT_device_generated_commands extension functions (optional)
+    LOAD_DEVICE_FUNCTION(vkCreateIndirectCommandsLayoutEXT);
+    LOAD_DEVICE_FUNCTION(vkDestroyIndirectCommandsLayoutEXT);
+    LOAD_DEVICE_FUNCTION(vkCreateIndirectExecutionSetEXT);
+    LOAD_DEVICE_FUNCTION(vkDestroyIndirectExecutionSetEXT);
+    LOAD_DEVICE_FUNCTION(vkUpdateIndirectExecutionSetPipelineEXT);
+    LOAD_DEVICE_FUNCTION(vkGetGeneratedCommandsMemoryRequirementsEXT);
+    LOAD_DEVICE_FUNCTION(vkCmdExecuteGeneratedCommandsEXT);
+    LOAD_DEVICE_FUNCTION(vkCreateEvent);
+    LOAD_DEVICE_FUNCTION(vkDestroyEvent);
     LOAD_DEVICE_FUNCTION(vkCreateQueryPool);
     LOAD_DEVICE_FUNCTION(vkDestroyQueryPool);
+    LOAD_DEVICE_FUNCTION(vkGetQueryPoolResults);
 }
 
 void VulkanFunctionLoader::loadCommandFunctions() {
@@ -219,20 +290,62 @@ void VulkanFunctionLoader::loadRenderingFunctions() {
     LOAD_DEVICE_FUNCTION(vkCmdSetScissor);
     LOAD_DEVICE_FUNCTION(vkCmdDraw);
     LOAD_DEVICE_FUNCTION(vkCmdDrawIndexed);
+    LOAD_DEVICE_FUNCTION(vkCmdDrawIndexedIndirect);
+    LOAD_DEVICE_FUNCTION(vkCmdDrawIndexedIndirectCountKHR);
     LOAD_DEVICE_FUNCTION(vkCmdBindDescriptorSets);
     LOAD_DEVICE_FUNCTION(vkCmdBindVertexBuffers);
     LOAD_DEVICE_FUNCTION(vkCmdBindIndexBuffer);
     LOAD_DEVICE_FUNCTION(vkCmdDispatch);
     LOAD_DEVICE_FUNCTION(vkCmdDispatchIndirect);
+    LOAD_DEVICE_FUNCTION(vkCmdFillBuffer);
+    LOAD_DEVICE_FUNCTION(vkCmdUpdateBuffer);
     LOAD_DEVICE_FUNCTION(vkCmdPipelineBarrier);
     LOAD_DEVICE_FUNCTION(vkCmdPushConstants);
     LOAD_DEVICE_FUNCTION(vkCmdCopyBuffer);
     LOAD_DEVICE_FUNCTION(vkCmdCopyBufferToImage);
+    LOAD_DEVICE_FUNCTION(vkCmdCopyImageToBuffer);
+    LOAD_DEVICE_FUNCTION(vkCmdBlitImage);
+    LOAD_DEVICE_FUNCTION(vkCmdExecuteCommands);
+    LOAD_DEVICE_FUNCTION(vkCmdResetQueryPool);
+    LOAD_DEVICE_FUNCTION(vkCmdWriteTimestamp);
+    LOAD_DEVICE_FUNCTION(vkCmdBeginQuery);
+    LOAD_DEVICE_FUNCTION(vkCmdEndQuery);
+    
+    // Load GPU breadcrumb extension functions (optional)
+    LOAD_DEVICE_FUNCTION(vkCmdWriteBufferMarkerAMD);
+    LOAD_DEVICE_FUNCTION(vkCmdSetCheckpointNV);
+    LOAD_DEVICE_FUNCTION(vkGetQueueCheckpointDataNV);
+    
+    // Load VK_KHR_synchronization2 extension functions (optional)
+    LOAD_DEVICE_FUNCTION(vkCmdPipelineBarrier2KHR);
+    LOAD_DEVICE_FUNCTION(vkCmdSetEvent2KHR);
+    LOAD_DEVICE_FUNCTION(vkCmdWaitEvents2KHR);
+    LOAD_DEVICE_FUNCTION(vkCmdResetEvent2KHR);
+    LOAD_DEVICE_FUNCTION(vkCmdWriteTimestamp2KHR);
+    LOAD_DEVICE_FUNCTION(vkQueueSubmit2KHR);
+    
+    // Load VK_KHR_dynamic_rendering extension functions (optional)
+    LOAD_DEVICE_FUNCTION(vkCmdBeginRenderingKHR);
+    LOAD_DEVICE_FUNCTION(vkCmdEndRenderingKHR);
+    
+    // Load VK_KHR_video_queue and VK_KHR_video_encode_queue extension functions (optional)
+    LOAD_DEVICE_FUNCTION(vkCreateVideoSessionKHR);
+    LOAD_DEVICE_FUNCTION(vkDestroyVideoSessionKHR);
+    LOAD_DEVICE_FUNCTION(vkGetVideoSessionMemoryRequirementsKHR);
+    LOAD_DEVICE_FUNCTION(vkBindVideoSessionMemoryKHR);
+    LOAD_DEVICE_FUNCTION(vkCreateVideoSessionParametersKHR);
+    LOAD_DEVICE_FUNCTION(vkDestroyVideoSessionParametersKHR);
+    LOAD_DEVICE_FUNCTION(vkGetEncodedVideoSessionParametersKHR);
+    LOAD_DEVICE_FUNCTION(vkCmdBeginVideoCodingKHR);
+    LOAD_DEVICE_FUNCTION(vkCmdEndVideoCodingKHR);
+    LOAD_DEVICE_FUNCTION(vkCmdControlVideoCodingKHR);
+    LOAD_DEVICE_FUNCTION(vkCmdEncodeVideoKHR);
 }
 
 void VulkanFunctionLoader::loadQueueFunctions() {
     LOAD_DEVICE_FUNCTION(vkQueueSubmit);
     LOAD_DEVICE_FUNCTION(vkQueueWaitIdle);
+    LOAD_DEVICE_FUNCTION(vkQueueBindSparse);
 }
 
 // Clean up macros to avoid namespace pollution
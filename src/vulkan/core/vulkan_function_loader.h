@@ -39,23 +39,49 @@ public:
     PFN_vkDestroyInstance vkDestroyInstance = nullptr;
     PFN_vkEnumeratePhysicalDevices vkEnumeratePhysicalDevices = nullptr;
     PFN_vkEnumerateInstanceExtensionProperties vkEnumerateInstanceExtensionProperties = nullptr;
+    PFN_vkEnumerateInstanceVersion vkEnumerateInstanceVersion = nullptr;  // Null on a Vulkan 1.0 loader
     
     // Physical device functions
     PFN_vkGetPhysicalDeviceProperties vkGetPhysicalDeviceProperties = nullptr;
+    PFN_vkGetPhysicalDeviceFeatures vkGetPhysicalDeviceFeatures = nullptr;
     PFN_vkGetPhysicalDeviceQueueFamilyProperties vkGetPhysicalDeviceQueueFamilyProperties = nullptr;
     PFN_vkGetPhysicalDeviceMemoryProperties vkGetPhysicalDeviceMemoryProperties = nullptr;
+    PFN_vkGetPhysicalDeviceFormatProperties vkGetPhysicalDeviceFormatProperties = nullptr;
     PFN_vkGetPhysicalDeviceSurfaceSupportKHR vkGetPhysicalDeviceSurfaceSupportKHR = nullptr;
     PFN_vkGetPhysicalDeviceSurfaceCapabilitiesKHR vkGetPhysicalDeviceSurfaceCapabilitiesKHR = nullptr;
     PFN_vkGetPhysicalDeviceSurfaceFormatsKHR vkGetPhysicalDeviceSurfaceFormatsKHR = nullptr;
     PFN_vkGetPhysicalDeviceSurfacePresentModesKHR vkGetPhysicalDeviceSurfacePresentModesKHR = nullptr;
     PFN_vkEnumerateDeviceExtensionProperties vkEnumerateDeviceExtensionProperties = nullptr;
     
+    // VK_KHR_get_physical_device_properties2 instance functions (optional)
+    PFN_vkGetPhysicalDeviceFeatures2KHR vkGetPhysicalDeviceFeatures2KHR = nullptr;
+    PFN_vkGetPhysicalDeviceProperties2KHR vkGetPhysicalDeviceProperties2KHR = nullptr;
+    PFN_vkGetPhysicalDeviceMemoryProperties2KHR vkGetPhysicalDeviceMemoryProperties2KHR = nullptr;
+    PFN_vkGetPhysicalDeviceQueueFamilyProperties2KHR vkGetPhysicalDeviceQueueFamilyProperties2KHR = nullptr;
+    
+    // VK_KHR_external_memory_capabilities / VK_KHR_external_semaphore_capabilities instance functions (optional)
+    PFN_vkGetPhysicalDeviceExternalBufferPropertiesKHR vkGetPhysicalDeviceExternalBufferPropertiesKHR = nullptr;
+    PFN_vkGetPhysicalDeviceExternalSemaphorePropertiesKHR vkGetPhysicalDeviceExternalSemaphorePropertiesKHR = nullptr;
+    
+    // VK_KHR_device_group_creation instance function (optional)
+    PFN_vkEnumeratePhysicalDeviceGroupsKHR vkEnumeratePhysicalDeviceGroupsKHR = nullptr;
+    
+    // VK_KHR_video_queue / VK_KHR_video_encode_queue physical device functions (optional)
+    PFN_vkGetPhysicalDeviceVideoCapabilitiesKHR vkGetPhysicalDeviceVideoCapabilitiesKHR = nullptr;
+    PFN_vkGetPhysicalDeviceVideoFormatPropertiesKHR vkGetPhysicalDeviceVideoFormatPropertiesKHR = nullptr;
+    
+    // VK_EXT_calibrated_timestamps physical device function (optional)
+    PFN_vkGetPhysicalDeviceCalibrateableTimeDomainsEXT vkGetPhysicalDeviceCalibrateableTimeDomainsEXT = nullptr;
+    
     // Surface functions
     PFN_vkDestroySurfaceKHR vkDestroySurfaceKHR = nullptr;
     
     // Debug utils functions
     PFN_vkCreateDebugUtilsMessengerEXT vkCreateDebugUtilsMessengerEXT = nullptr;
     PFN_vkDestroyDebugUtilsMessengerEXT vkDestroyDebugUtilsMessengerEXT = nullptr;
+    PFN_vkCmdBeginDebugUtilsLabelEXT vkCmdBeginDebugUtilsLabelEXT = nullptr;
+    PFN_vkCmdEndDebugUtilsLabelEXT vkCmdEndDebugUtilsLabelEXT = nullptr;
+    PFN_vkSetDebugUtilsObjectNameEXT vkSetDebugUtilsObjectNameEXT = nullptr;
     
     // === DEVICE FUNCTIONS ===
     // Device management
@@ -94,6 +120,13 @@ public:
     // VK_EXT_swapchain_maintenance1 extension functions (optional)
     PFN_vkReleaseSwapchainImagesEXT vkReleaseSwapchainImagesEXT = nullptr;
     
+    // VK_KHR_present_wait extension functions (optional)
+    PFN_vkWaitForPresentKHR vkWaitForPresentKHR = nullptr;
+    
+    // VK_GOOGLE_display_timing extension functions (optional)
+    PFN_vkGetRefreshCycleDurationGOOGLE vkGetRefreshCycleDurationGOOGLE = nullptr;
+    PFN_vkGetPastPresentationTimingGOOGLE vkGetPastPresentationTimingGOOGLE = nullptr;
+    
     // Render pass and pipeline functions
     PFN_vkCreateRenderPass vkCreateRenderPass = nullptr;
     PFN_vkDestroyRenderPass vkDestroyRenderPass = nullptr;
@@ -105,6 +138,7 @@ public:
     PFN_vkDestroyPipelineLayout vkDestroyPipelineLayout = nullptr;
     PFN_vkCreatePipelineCache vkCreatePipelineCache = nullptr;
     PFN_vkDestroyPipelineCache vkDestroyPipelineCache = nullptr;
+    PFN_vkGetPipelineCacheData vkGetPipelineCacheData = nullptr;
     PFN_vkCreateGraphicsPipelines vkCreateGraphicsPipelines = nullptr;
     PFN_vkCreateComputePipelines vkCreateComputePipelines = nullptr;
     PFN_vkDestroyPipeline vkDestroyPipeline = nullptr;
@@ -118,6 +152,14 @@ public:
     PFN_vkAllocateDescriptorSets vkAllocateDescriptorSets = nullptr;
     PFN_vkUpdateDescriptorSets vkUpdateDescriptorSets = nullptr;
     
+    // VK_KHR_descriptor_update_template extension functions (optional)
+    PFN_vkCreateDescriptorUpdateTemplateKHR vkCreateDescriptorUpdateTemplateKHR = nullptr;
+    PFN_vkDestroyDescriptorUpdateTemplateKHR vkDestroyDescriptorUpdateTemplateKHR = nullptr;
+    PFN_vkUpdateDescriptorSetWithTemplateKHR vkUpdateDescriptorSetWithTemplateKHR = nullptr;
+    
+    // VK_KHR_push_descriptor extension functions (optional)
+    PFN_vkCmdPushDescriptorSetKHR vkCmdPushDescriptorSetKHR = nullptr;
+    
     // Synchronization functions
     PFN_vkCreateSemaphore vkCreateSemaphore = nullptr;
     PFN_vkDestroySemaphore vkDestroySemaphore = nullptr;
@@ -127,9 +169,50 @@ public:
     PFN_vkResetFences vkResetFences = nullptr;
     PFN_vkGetFenceStatus vkGetFenceStatus = nullptr;
     
+    // VK_KHR_timeline_semaphore extension functions (optional)
+    PFN_vkWaitSemaphoresKHR vkWaitSemaphoresKHR = nullptr;
+    PFN_vkGetSemaphoreCounterValueKHR vkGetSemaphoreCounterValueKHR = nullptr;
+    
+    // VK_KHR_buffer_device_address extension functions (optional)
+    PFN_vkGetBufferDeviceAddressKHR vkGetBufferDeviceAddressKHR = nullptr;
+    
+    // VK_KHR_device_group / VK_KHR_bind_memory2 extension functions (optional, multi-device simulation)
+    PFN_vkGetDeviceGroupPeerMemoryFeaturesKHR vkGetDeviceGroupPeerMemoryFeaturesKHR = nullptr;
+    PFN_vkBindBufferMemory2KHR vkBindBufferMemory2KHR = nullptr;
+    
+    // VK_KHR_external_memory_fd / _win32 and VK_KHR_external_semaphore_fd / _win32 functions (optional)
+#if defined(VK_USE_PLATFORM_WIN32_KHR)
+    PFN_vkGetMemoryWin32HandleKHR vkGetMemoryWin32HandleKHR = nullptr;
+    PFN_vkGetSemaphoreWin32HandleKHR vkGetSemaphoreWin32HandleKHR = nullptr;
+#else
+    PFN_vkGetMemoryFdKHR vkGetMemoryFdKHR = nullptr;
+    PFN_vkGetSemaphoreFdKHR vkGetSemaphoreFdKHR = nullptr;
+#endif
+    
+    // VK_KHR_pipeline_executable_properties extension functions (optional)
+    PFN_vkGetPipelineExecutablePropertiesKHR vkGetPipelineExecutablePropertiesKHR = nullptr;
+    PFN_vkGetPipelineExecutableStatisticsKHR vkGetPipelineExecutableStatisticsKHR = nullptr;
+    
+    // VK_EXT_calibrated_timestamps extension function (optional)
+    PFN_vkGetCalibratedTimestampsEXT vkGetCalibratedTimestampsEXT = nullptr;
+    
+    // VK_EXT_device_generated_commands extension functions (optional)
+    PFN_vkCreateIndirectCommandsLayoutEXT vkCreateIndirectCommandsLayoutEXT = nullptr;
+    PFN_vkDestroyIndirectCommandsLayoutEXT vkDestroyIndirectCommandsLayoutEXT = nullptr;
+    PFN_vkCreateIndirectExecutionSetEXT vkCreateIndirectExecutionSetEXT = nullptr;
+    PFN_vkDestroyIndirectExecutionSetEXT vkDestroyIndirectExecutionSetEXT = nullptr;
+    PFN_vkUpdateIndirectExecutionSetPipelineEXT vkUpdateIndirectExecutionSetPipelineEXT = nullptr;
+    PFN_vkGetGeneratedCommandsMemoryRequirementsEXT vkGetGeneratedCommandsMemoryRequirementsEXT = nullptr;
+    PFN_vkCmdExecuteGeneratedCommandsEXT vkCmdExecuteGeneratedCommandsEXT = nullptr;
+    
+    // Events for split barriers
+    PFN_vkCreateEvent vkCreateEvent = nullptr;
+    PFN_vkDestroyEvent vkDestroyEvent = nullptr;
+    
     // Query pool functions
     PFN_vkCreateQueryPool vkCreateQueryPool = nullptr;
     PFN_vkDestroyQueryPool vkDestroyQueryPool = nullptr;
+    PFN_vkGetQueryPoolResults vkGetQueryPoolResults = nullptr;
     
     // Command buffer functions
     PFN_vkCreateCommandPool vkCreateCommandPool = nullptr;
@@ -149,19 +232,61 @@ public:
     PFN_vkCmdSetScissor vkCmdSetScissor = nullptr;
     PFN_vkCmdDraw vkCmdDraw = nullptr;
     PFN_vkCmdDrawIndexed vkCmdDrawIndexed = nullptr;
+    PFN_vkCmdDrawIndexedIndirect vkCmdDrawIndexedIndirect = nullptr;
+    PFN_vkCmdDrawIndexedIndirectCountKHR vkCmdDrawIndexedIndirectCountKHR = nullptr;  // VK_KHR_draw_indirect_count (optional)
     PFN_vkCmdBindDescriptorSets vkCmdBindDescriptorSets = nullptr;
     PFN_vkCmdBindVertexBuffers vkCmdBindVertexBuffers = nullptr;
     PFN_vkCmdBindIndexBuffer vkCmdBindIndexBuffer = nullptr;
     PFN_vkCmdDispatch vkCmdDispatch = nullptr;
     PFN_vkCmdDispatchIndirect vkCmdDispatchIndirect = nullptr;
+    PFN_vkCmdFillBuffer vkCmdFillBuffer = nullptr;
+    PFN_vkCmdUpdateBuffer vkCmdUpdateBuffer = nullptr;
     PFN_vkCmdPipelineBarrier vkCmdPipelineBarrier = nullptr;
     PFN_vkCmdPushConstants vkCmdPushConstants = nullptr;
     PFN_vkCmdCopyBuffer vkCmdCopyBuffer = nullptr;
     PFN_vkCmdCopyBufferToImage vkCmdCopyBufferToImage = nullptr;
+    PFN_vkCmdCopyImageToBuffer vkCmdCopyImageToBuffer = nullptr;
+    PFN_vkCmdBlitImage vkCmdBlitImage = nullptr;
+    PFN_vkCmdExecuteCommands vkCmdExecuteCommands = nullptr;
+    PFN_vkCmdResetQueryPool vkCmdResetQueryPool = nullptr;
+    PFN_vkCmdWriteTimestamp vkCmdWriteTimestamp = nullptr;
+    PFN_vkCmdBeginQuery vkCmdBeginQuery = nullptr;
+    PFN_vkCmdEndQuery vkCmdEndQuery = nullptr;
+    
+    // GPU breadcrumb extension functions (optional, VK_AMD_buffer_marker or VK_NV_device_diagnostic_checkpoints)
+    PFN_vkCmdWriteBufferMarkerAMD vkCmdWriteBufferMarkerAMD = nullptr;
+    PFN_vkCmdSetCheckpointNV vkCmdSetCheckpointNV = nullptr;
+    PFN_vkGetQueueCheckpointDataNV vkGetQueueCheckpointDataNV = nullptr;
+    
+    // VK_KHR_synchronization2 extension functions (optional)
+    PFN_vkCmdPipelineBarrier2KHR vkCmdPipelineBarrier2KHR = nullptr;
+    PFN_vkCmdSetEvent2KHR vkCmdSetEvent2KHR = nullptr;
+    PFN_vkCmdWaitEvents2KHR vkCmdWaitEvents2KHR = nullptr;
+    PFN_vkCmdResetEvent2KHR vkCmdResetEvent2KHR = nullptr;
+    PFN_vkCmdWriteTimestamp2KHR vkCmdWriteTimestamp2KHR = nullptr;
+    PFN_vkQueueSubmit2KHR vkQueueSubmit2KHR = nullptr;
+    
+    // VK_KHR_dynamic_rendering extension functions (optional)
+    PFN_vkCmdBeginRenderingKHR vkCmdBeginRenderingKHR = nullptr;
+    PFN_vkCmdEndRenderingKHR vkCmdEndRenderingKHR = nullptr;
+    
+    // VK_KHR_video_queue and VK_KHR_video_encode_queue extension functions (optional)
+    PFN_vkCreateVideoSessionKHR vkCreateVideoSessionKHR = nullptr;
+    PFN_vkDestroyVideoSessionKHR vkDestroyVideoSessionKHR = nullptr;
+    PFN_vkGetVideoSessionMemoryRequirementsKHR vkGetVideoSessionMemoryRequirementsKHR = nullptr;
+    PFN_vkBindVideoSessionMemoryKHR vkBindVideoSessionMemoryKHR = nullptr;
+    PFN_vkCreateVideoSessionParametersKHR vkCreateVideoSessionParametersKHR = nullptr;
+    PFN_vkDestroyVideoSessionParametersKHR vkDestroyVideoSessionParametersKHR = nullptr;
+    PFN_vkGetEncodedVideoSessionParametersKHR vkGetEncodedVideoSessionParametersKHR = nullptr;
+    PFN_vkCmdBeginVideoCodingKHR vkCmdBeginVideoCodingKHR = nullptr;
+    PFN_vkCmdEndVideoCodingKHR vkCmdEndVideoCodingKHR = nullptr;
+    PFN_vkCmdControlVideoCodingKHR vkCmdControlVideoCodingKHR = nullptr;
+    PFN_vkCmdEncodeVideoKHR vkCmdEncodeVideoKHR = nullptr;
     
     // Queue functions
     PFN_vkQueueSubmit vkQueueSubmit = nullptr;
     PFN_vkQueueWaitIdle vkQueueWaitIdle = nullptr;
+    PFN_vkQueueBindSparse vkQueueBindSparse = nullptr;
     
 private:
     VkInstance instance = VK_NULL_HANDLE;
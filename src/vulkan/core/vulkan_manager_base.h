@@ -2,6 +2,7 @@
 
 #include "vulkan_context.h"
 #include "vulkan_function_loader.h"
+#include "../../ecs/utilities/profiler.h"
 #include <vulkan/vulkan.h>
 
 // Base class for Vulkan managers to reduce repetitive function loading patterns
@@ -27,11 +28,13 @@ protected:
     // Pipeline management wrappers
     VkResult createGraphicsPipelines(VkPipelineCache pipelineCache, uint32_t createInfoCount,
                                    const VkGraphicsPipelineCreateInfo* pCreateInfos, VkPipeline* pPipelines) {
+        PROFILE_HITCH_EVENT(HitchCause::PipelineCompile);
         return loader->vkCreateGraphicsPipelines(device, pipelineCache, createInfoCount, pCreateInfos, nullptr, pPipelines);
     }
     
     VkResult createComputePipelines(VkPipelineCache pipelineCache, uint32_t createInfoCount,
                                   const VkComputePipelineCreateInfo* pCreateInfos, VkPipeline* pPipelines) {
+        PROFILE_HITCH_EVENT(HitchCause::PipelineCompile);
         return loader->vkCreateComputePipelines(device, pipelineCache, createInfoCount, pCreateInfos, nullptr, pPipelines);
     }
     
@@ -85,6 +88,11 @@ protected:
         loader->vkCmdPushConstants(commandBuffer, layout, stageFlags, offset, size, pValues);
     }
     
+    void cmdPushDescriptorSet(VkCommandBuffer commandBuffer, VkPipelineBindPoint pipelineBindPoint, VkPipelineLayout layout,
+                              uint32_t set, uint32_t descriptorWriteCount, const VkWriteDescriptorSet* pDescriptorWrites) {
+        loader->vkCmdPushDescriptorSetKHR(commandBuffer, pipelineBindPoint, layout, set, descriptorWriteCount, pDescriptorWrites);
+    }
+    
     void cmdDispatch(VkCommandBuffer commandBuffer, uint32_t groupCountX, uint32_t groupCountY, uint32_t groupCountZ) {
         loader->vkCmdDispatch(commandBuffer, groupCountX, groupCountY, groupCountZ);
     }
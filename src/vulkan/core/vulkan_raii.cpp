@@ -1,6 +1,7 @@
 #include "vulkan_raii.h"
 #include "vulkan_context.h"
 #include "vulkan_function_loader.h"
+#include "../../ecs/utilities/profiler.h"
 
 namespace vulkan_raii {
 
@@ -116,6 +117,22 @@ static void destroyQueryPool(const VulkanFunctionLoader& loader, VkDevice device
     loader.vkDestroyQueryPool(device, handle, allocator);
 }
 
+static void destroyEvent(const VulkanFunctionLoader& loader, VkDevice device, VkEvent handle, const VkAllocationCallbacks* allocator) {
+    loader.vkDestroyEvent(device, handle, allocator);
+}
+
+static void destroyDescriptorUpdateTemplate(const VulkanFunctionLoader& loader, VkDevice device, VkDescriptorUpdateTemplateKHR handle, const VkAllocationCallbacks* allocator) {
+    loader.vkDestroyDescriptorUpdateTemplateKHR(device, handle, allocator);
+}
+
+static void destroyIndirectCommandsLayout(const VulkanFunctionLoader& loader, VkDevice device, VkIndirectCommandsLayoutEXT handle, const VkAllocationCallbacks* allocator) {
+    loader.vkDestroyIndirectCommandsLayoutEXT(device, handle, allocator);
+}
+
+static void destroyIndirectExecutionSet(const VulkanFunctionLoader& loader, VkDevice device, VkIndirectExecutionSetEXT handle, const VkAllocationCallbacks* allocator) {
+    loader.vkDestroyIndirectExecutionSetEXT(device, handle, allocator);
+}
+
 static void destroyDevice(const VulkanFunctionLoader& loader, VkDevice device, VkDevice handle, const VkAllocationCallbacks* allocator) {
     loader.vkDestroyDevice(handle, allocator);
 }
@@ -214,6 +231,26 @@ void QueryPoolDeleter::operator()(VkQueryPool handle) {
     deleter(handle);
 }
 
+void EventDeleter::operator()(VkEvent handle) {
+    GenericDeleter<VkEvent> deleter(context, destroyEvent);
+    deleter(handle);
+}
+
+void DescriptorUpdateTemplateDeleter::operator()(VkDescriptorUpdateTemplateKHR handle) {
+    GenericDeleter<VkDescriptorUpdateTemplateKHR> deleter(context, destroyDescriptorUpdateTemplate);
+    deleter(handle);
+}
+
+void IndirectCommandsLayoutDeleter::operator()(VkIndirectCommandsLayoutEXT handle) {
+    GenericDeleter<VkIndirectCommandsLayoutEXT> deleter(context, destroyIndirectCommandsLayout);
+    deleter(handle);
+}
+
+void IndirectExecutionSetDeleter::operator()(VkIndirectExecutionSetEXT handle) {
+    GenericDeleter<VkIndirectExecutionSetEXT> deleter(context, destroyIndirectExecutionSet);
+    deleter(handle);
+}
+
 // Core context object deleters
 void InstanceDeleter::operator()(VkInstance handle) {
     GenericDeleter<VkInstance> deleter(context, destroyInstance);
@@ -260,6 +297,7 @@ Pipeline create_graphics_pipeline(const VulkanContext* context, VkPipelineCache
     }
     
     VkPipeline handle = VK_NULL_HANDLE;
+    PROFILE_HITCH_EVENT(HitchCause::PipelineCompile);
     VkResult result = context->getLoader().vkCreateGraphicsPipelines(
         context->getDevice(), pipelineCache, 1, createInfo, nullptr, &handle);
     
@@ -276,6 +314,7 @@ Pipeline create_compute_pipeline(const VulkanContext* context, VkPipelineCache p
     }
     
     VkPipeline handle = VK_NULL_HANDLE;
+    PROFILE_HITCH_EVENT(HitchCause::PipelineCompile);
     VkResult result = context->getLoader().vkCreateComputePipelines(
         context->getDevice(), pipelineCache, 1, createInfo, nullptr, &handle);
     
@@ -215,6 +215,30 @@ struct QueryPoolDeleter : VulkanDeleter {
     void operator()(VkQueryPool handle);
 };
 
+struct EventDeleter : VulkanDeleter {
+    explicit EventDeleter(const VulkanContext* ctx) : VulkanDeleter(ctx) {}
+    
+    void operator()(VkEvent handle);
+};
+
+struct DescriptorUpdateTemplateDeleter : VulkanDeleter {
+    explicit DescriptorUpdateTemplateDeleter(const VulkanContext* ctx) : VulkanDeleter(ctx) {}
+    
+    void operator()(VkDescriptorUpdateTemplateKHR handle);
+};
+
+struct IndirectCommandsLayoutDeleter : VulkanDeleter {
+    explicit IndirectCommandsLayoutDeleter(const VulkanContext* ctx) : VulkanDeleter(ctx) {}
+    
+    void operator()(VkIndirectCommandsLayoutEXT handle);
+};
+
+struct IndirectExecutionSetDeleter : VulkanDeleter {
+    explicit IndirectExecutionSetDeleter(const VulkanContext* ctx) : VulkanDeleter(ctx) {}
+    
+    void operator()(VkIndirectExecutionSetEXT handle);
+};
+
 // Core context object deleters
 struct InstanceDeleter : VulkanDeleter {
     explicit InstanceDeleter(const VulkanContext* ctx) : VulkanDeleter(ctx) {}
@@ -258,6 +282,10 @@ using DeviceMemory = VulkanHandle<VkDeviceMemory, DeviceMemoryDeleter>;
 using Framebuffer = VulkanHandle<VkFramebuffer, FramebufferDeleter>;
 using PipelineCache = VulkanHandle<VkPipelineCache, PipelineCacheDeleter>;
 using QueryPool = VulkanHandle<VkQueryPool, QueryPoolDeleter>;
+using Event = VulkanHandle<VkEvent, EventDeleter>;
+using DescriptorUpdateTemplate = VulkanHandle<VkDescriptorUpdateTemplateKHR, DescriptorUpdateTemplateDeleter>;
+using IndirectCommandsLayout = VulkanHandle<VkIndirectCommandsLayoutEXT, IndirectCommandsLayoutDeleter>;
+using IndirectExecutionSet = VulkanHandle<VkIndirectExecutionSetEXT, IndirectExecutionSetDeleter>;
 
 // Core context object types
 using Instance = VulkanHandle<VkInstance, InstanceDeleter>;
@@ -312,6 +340,22 @@ inline QueryPool make_query_pool(VkQueryPool handle, const VulkanContext* contex
     return make_handle<VkQueryPool, QueryPoolDeleter>(handle, context);
 }
 
+inline Event make_event(VkEvent handle, const VulkanContext* context) {
+    return make_handle<VkEvent, EventDeleter>(handle, context);
+}
+
+inline DescriptorUpdateTemplate make_descriptor_update_template(VkDescriptorUpdateTemplateKHR handle, const VulkanContext* context) {
+    return make_handle<VkDescriptorUpdateTemplateKHR, DescriptorUpdateTemplateDeleter>(handle, context);
+}
+
+inline IndirectCommandsLayout make_indirect_commands_layout(VkIndirectCommandsLayoutEXT handle, const VulkanContext* context) {
+    return make_handle<VkIndirectCommandsLayoutEXT, IndirectCommandsLayoutDeleter>(handle, context);
+}
+
+inline IndirectExecutionSet make_indirect_execution_set(VkIndirectExecutionSetEXT handle, const VulkanContext* context) {
+    return make_handle<VkIndirectExecutionSetEXT, IndirectExecutionSetDeleter>(handle, context);
+}
+
 
 inline CommandPool make_command_pool(VkCommandPool handle, const VulkanContext* context) {
     return make_handle<VkCommandPool, CommandPoolDeleter>(handle, context);
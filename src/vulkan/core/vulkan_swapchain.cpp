@@ -5,6 +5,7 @@
 #include <iostream>
 #include <algorithm>
 #include <array>
+#include <cmath>
 
 VulkanSwapchain::VulkanSwapchain() {
 }
@@ -13,9 +14,12 @@ VulkanSwapchain::~VulkanSwapchain() {
     cleanup();
 }
 
-bool VulkanSwapchain::initialize(const VulkanContext& context, SDL_Window* window) {
+bool VulkanSwapchain::initialize(const VulkanContext& context, SDL_Window* window, VkSurfaceKHR windowSurface) {
     this->context = &context;
     this->window = window;
+    surface = windowSurface != VK_NULL_HANDLE ? windowSurface : context.getSurface();
+    depthFormat = chooseDepthFormat();
+    applyRenderQuality();
     
     if (!createSwapChain(VK_NULL_HANDLE)) {
         std::cerr << "Failed to create swap chain" << std::endl;
@@ -33,6 +37,26 @@ bool VulkanSwapchain::initialize(const VulkanContext& context, SDL_Window* windo
         return false;
     }
     
+    if (!createDepthResources()) {
+        std::cerr << "Failed to create depth resources" << std::endl;
+        return false;
+    }
+    
+    if (!createPickResources()) {
+        std::cerr << "Failed to create entity pick resources" << std::endl;
+        return false;
+    }
+    
+    if (!createOverdrawResources()) {
+        std::cerr << "Failed to create overdraw count image" << std::endl;
+        return false;
+    }
+    
+    if (!createScaledResources()) {
+        std::cerr << "Failed to create scaled render targets" << std::endl;
+        return false;
+    }
+    
     return true;
 }
 
@@ -44,9 +68,7 @@ void VulkanSwapchain::cleanupBeforeContextDestruction() {
     // Clear RAII wrappers before context destruction
     swapChainFramebuffers.clear();
     swapChainImageViews.clear();
-    msaaColorImageView.reset();
-    msaaColorImage.reset();
-    msaaColorImageMemory.reset();
+    releaseRenderTargets();
     
     // Manual cleanup for non-RAII managed resources
     if (context && swapChain != VK_NULL_HANDLE) {
@@ -66,6 +88,95 @@ std::vector<VkImageView> VulkanSwapchain::getImageViews() const {
     return views;
 }
 
+VkImage VulkanSwapchain::getScaledImage(uint32_t imageIndex) const {
+    return imageIndex < scaledImages.size() ? scaledImages[imageIndex].get() : VK_NULL_HANDLE;
+}
+
+VkImage VulkanSwapchain::getRenderTargetImage(uint32_t imageIndex) const {
+    if (isRenderScaled()) {
+        return getScaledImage(imageIndex);
+    }
+    return imageIndex < swapChainImages.size() ? swapChainImages[imageIndex] : VK_NULL_HANDLE;
+}
+
+VkImageView VulkanSwapchain::getRenderTargetView(uint32_t imageIndex) const {
+    const auto& views = isRenderScaled() ? scaledImageViews : swapChainImageViews;
+    return imageIndex < views.size() ? views[imageIndex].get() : VK_NULL_HANDLE;
+}
+
+bool VulkanSwapchain::setPresentPolicy(PresentPolicy policy) {
+    const bool changed = policy != presentPolicy;
+    presentPolicy = policy;
+    return changed;
+}
+
+uint32_t VulkanSwapchain::getPolicyFramesInFlight(PresentPolicy policy) {
+    return policy == PresentPolicy::TearFreeMaxFps ? 3 : 2;
+}
+
+const char* VulkanSwapchain::getPresentPolicyName(PresentPolicy policy) {
+    switch (policy) {
+        case PresentPolicy::LowLatency: return "low-latency";
+        case PresentPolicy::PowerSaver: return "power-saver";
+        case PresentPolicy::TearFreeMaxFps: return "max-fps";
+    }
+    return "unknown";
+}
+
+bool VulkanSwapchain::setRenderQuality(VkSampleCountFlagBits samples, float scale) {
+    requestedSampleCount = samples;
+    requestedRenderScale = scale;
+    if (!context) {
+        return false;
+    }
+    
+    const VkSampleCountFlagBits previousSampleCount = sampleCount;
+    const float previousRenderScale = renderScale;
+    applyRenderQuality();
+    return sampleCount != previousSampleCount || renderScale != previousRenderScale;
+}
+
+void VulkanSwapchain::applyRenderQuality() {
+    const auto& vk = context->getLoader();
+    VkPhysicalDeviceProperties properties{};
+    vk.vkGetPhysicalDeviceProperties(context->getPhysicalDevice(), &properties);
+    maxRenderDimension = properties.limits.maxImageDimension2D;
+    
+    // Highest supported count not above the request; every device supports 1. The depth attachment shares
+    // the colour attachment's sample count
+    VkSampleCountFlags supportedSamples = properties.limits.framebufferColorSampleCounts;
+    if (depthFormat != VK_FORMAT_UNDEFINED) {
+        supportedSamples &= properties.limits.framebufferDepthSampleCounts;
+    }
+    sampleCount = VK_SAMPLE_COUNT_1_BIT;
+    for (uint32_t candidate = requestedSampleCount; candidate > VK_SAMPLE_COUNT_1_BIT; candidate >>= 1) {
+        if (supportedSamples & candidate) {
+            sampleCount = static_cast<VkSampleCountFlagBits>(candidate);
+            break;
+        }
+    }
+    
+    renderScale = std::clamp(requestedRenderScale, MIN_RENDER_SCALE, MAX_RENDER_SCALE);
+    if (renderScale != 1.0f) {
+        SwapChainSupportDetails swapChainSupport = querySwapChainSupport(context->getPhysicalDevice());
+        const VkFormat format = chooseSwapSurfaceFormat(swapChainSupport.formats).format;
+        VkFormatProperties formatProperties{};
+        vk.vkGetPhysicalDeviceFormatProperties(context->getPhysicalDevice(), format, &formatProperties);
+        
+        const VkFormatFeatureFlags blitFeatures = VK_FORMAT_FEATURE_BLIT_SRC_BIT | VK_FORMAT_FEATURE_BLIT_DST_BIT;
+        if (!(swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_DST_BIT) ||
+            (formatProperties.optimalTilingFeatures & blitFeatures) != blitFeatures) {
+            std::cerr << "VulkanSwapchain: Render scale " << renderScale
+                      << " unavailable, swapchain images cannot be blitted to" << std::endl;
+            renderScale = 1.0f;
+        }
+        upscaleFilter = (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_SAMPLED_IMAGE_FILTER_LINEAR_BIT)
+            ? VK_FILTER_LINEAR : VK_FILTER_NEAREST;
+    }
+    
+    std::cout << "VulkanSwapchain: Render quality " << sampleCount << "x MSAA at render scale " << renderScale << std::endl;
+}
+
 std::vector<VkFramebuffer> VulkanSwapchain::getFramebuffers() const {
     std::vector<VkFramebuffer> framebuffers;
     framebuffers.reserve(swapChainFramebuffers.size());
@@ -123,6 +234,26 @@ bool VulkanSwapchain::recreate(VkRenderPass renderPass) {
         return false;
     }
     
+    if (!createDepthResources()) {
+        std::cerr << "Failed to recreate depth resources!" << std::endl;
+        return false;
+    }
+    
+    if (!createPickResources()) {
+        std::cerr << "Failed to recreate entity pick resources!" << std::endl;
+        return false;
+    }
+    
+    if (!createOverdrawResources()) {
+        std::cerr << "Failed to recreate overdraw count image!" << std::endl;
+        return false;
+    }
+    
+    if (!createScaledResources()) {
+        std::cerr << "Failed to recreate scaled render targets!" << std::endl;
+        return false;
+    }
+    
     if (!createFramebuffers(renderPass)) {
         std::cerr << "Failed to recreate framebuffers!" << std::endl;
         return false;
@@ -138,15 +269,16 @@ bool VulkanSwapchain::createSwapChain(VkSwapchainKHR oldSwapchainKHR) {
     VkPresentModeKHR presentMode = chooseSwapPresentMode(swapChainSupport.presentModes);
     VkExtent2D extent = chooseSwapExtent(swapChainSupport.capabilities);
 
-    // Optimize image count for VulkanRenderer::MAX_FRAMES_IN_FLIGHT
-    // Request minImageCount + frames_in_flight to ensure both engine and compositor have spare buffers
-    uint32_t imageCount = swapChainSupport.capabilities.minImageCount + MAX_FRAMES_IN_FLIGHT;
+    // Maximum throughput asks for minImageCount + frames in flight so both engine and compositor have spare
+    // buffers; the latency and power policies keep a single spare, so fewer finished frames queue up
+    const uint32_t spareImages = presentPolicy == PresentPolicy::TearFreeMaxFps ? context->getFramesInFlight() : 1;
+    uint32_t imageCount = swapChainSupport.capabilities.minImageCount + spareImages;
     
     // Clamp to supported range
     if (swapChainSupport.capabilities.maxImageCount > 0 && imageCount > swapChainSupport.capabilities.maxImageCount) {
         imageCount = swapChainSupport.capabilities.maxImageCount;
         std::cout << "WARNING: Swapchain image count clamped to " << imageCount 
-                  << " (requested " << (swapChainSupport.capabilities.minImageCount + MAX_FRAMES_IN_FLIGHT) 
+                  << " (requested " << (swapChainSupport.capabilities.minImageCount + spareImages) 
                   << ")" << std::endl;
     }
     
@@ -156,13 +288,15 @@ bool VulkanSwapchain::createSwapChain(VkSwapchainKHR oldSwapchainKHR) {
 
     VkSwapchainCreateInfoKHR createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SWAPCHAIN_CREATE_INFO_KHR;
-    createInfo.surface = context->getSurface();
+    createInfo.surface = surface;
     createInfo.minImageCount = imageCount;
     createInfo.imageFormat = surfaceFormat.format;
     createInfo.imageColorSpace = surfaceFormat.colorSpace;
     createInfo.imageExtent = extent;
     createInfo.imageArrayLayers = 1;
-    createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT;
+    captureSupported = captureRequested && (swapChainSupport.capabilities.supportedUsageFlags & VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+    createInfo.imageUsage = VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | (isRenderScaled() ? VK_IMAGE_USAGE_TRANSFER_DST_BIT : 0) |
+                            (captureSupported ? VK_IMAGE_USAGE_TRANSFER_SRC_BIT : 0);
 
     // Use cached queue family indices instead of re-querying during swapchain recreation
     const QueueFamilyIndices& indices = context->getQueueFamilyIndices();
@@ -197,10 +331,64 @@ bool VulkanSwapchain::createSwapChain(VkSwapchainKHR oldSwapchainKHR) {
 
     swapChainImageFormat = surfaceFormat.format;
     swapChainExtent = extent;
+    renderExtent = {
+        std::clamp(static_cast<uint32_t>(std::lround(extent.width * renderScale)), 1u, maxRenderDimension),
+        std::clamp(static_cast<uint32_t>(std::lround(extent.height * renderScale)), 1u, maxRenderDimension)
+    };
+    swapChainPresentMode = presentMode;
+    firstSwapchainPresentId = lastPresentId + 1;
+    queryRefreshDuration();
 
     return true;
 }
 
+void VulkanSwapchain::queryRefreshDuration() {
+    refreshDurationNs = 0;
+    if (supportsDisplayTiming()) {
+        VkRefreshCycleDurationGOOGLE refreshCycle{};
+        if (context->getLoader().vkGetRefreshCycleDurationGOOGLE(context->getDevice(), swapChain, &refreshCycle) == VK_SUCCESS) {
+            refreshDurationNs = refreshCycle.refreshDuration;
+        }
+    }
+    
+    // The window may have moved to another display since the last swapchain, so this is re-read each time
+    if (refreshDurationNs == 0 && window) {
+        const SDL_DisplayMode* mode = SDL_GetCurrentDisplayMode(SDL_GetDisplayForWindow(window));
+        if (mode && mode->refresh_rate > 0.0f) {
+            refreshDurationNs = static_cast<uint64_t>(std::llround(1e9 / mode->refresh_rate));
+        }
+    }
+}
+
+void VulkanSwapchain::getPastPresentationTimings(std::vector<VkPastPresentationTimingGOOGLE>& timings) const {
+    if (!supportsDisplayTiming() || swapChain == VK_NULL_HANDLE) {
+        return;
+    }
+    
+    const auto& vk = context->getLoader();
+    uint32_t count = 0;
+    if (vk.vkGetPastPresentationTimingGOOGLE(context->getDevice(), swapChain, &count, nullptr) != VK_SUCCESS || count == 0) {
+        return;
+    }
+    const size_t first = timings.size();
+    timings.resize(first + count);
+    const VkResult result = vk.vkGetPastPresentationTimingGOOGLE(context->getDevice(), swapChain, &count, timings.data() + first);
+    timings.resize(result == VK_SUCCESS || result == VK_INCOMPLETE ? first + count : first);
+}
+
+bool VulkanSwapchain::waitForPresent(uint64_t presentId, uint64_t timeoutNs) const {
+    if (!supportsPresentWait() || swapChain == VK_NULL_HANDLE || presentId < firstSwapchainPresentId) {
+        return true;
+    }
+    
+    VkResult result = context->getLoader().vkWaitForPresentKHR(context->getDevice(), swapChain, presentId, timeoutNs);
+    if (result != VK_SUCCESS && result != VK_TIMEOUT) {
+        // Out of date or surface lost: the recreation path reports it, pacing just stops waiting
+        return false;
+    }
+    return result == VK_SUCCESS;
+}
+
 bool VulkanSwapchain::createImageViews() {
     swapChainImageViews.clear();
     swapChainImageViews.reserve(swapChainImages.size());
@@ -237,12 +425,17 @@ bool VulkanSwapchain::createImageViews() {
 bool VulkanSwapchain::createMSAAColorResources() {
     VkFormat colorFormat = swapChainImageFormat;
     
+    // Single-sample rendering draws straight into the swapchain or scaled image
+    if (sampleCount == VK_SAMPLE_COUNT_1_BIT) {
+        return true;
+    }
+    
     VkImage image;
     VkDeviceMemory memory;
     if (!VulkanUtils::createImage(context->getDevice(), context->getPhysicalDevice(), context->getLoader(),
-                            swapChainExtent.width, swapChainExtent.height, colorFormat, VK_IMAGE_TILING_OPTIMAL,
+                            renderExtent.width, renderExtent.height, colorFormat, VK_IMAGE_TILING_OPTIMAL,
                             VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT,
-                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, memory, VK_SAMPLE_COUNT_2_BIT)) {
+                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, memory, sampleCount)) {
         return false;
     }
     
@@ -259,6 +452,176 @@ bool VulkanSwapchain::createMSAAColorResources() {
     return true;
 }
 
+VkFormat VulkanSwapchain::chooseDepthFormat() const {
+    if (!ENABLE_ENTITY_EARLY_DEPTH) {
+        return VK_FORMAT_UNDEFINED;
+    }
+    
+    // Slot depths step by 1 / ENTITY_CAPACITY_MAX, which 24 bits and up keep distinct; D16 is always attachable
+    const VkFormat candidates[] = {VK_FORMAT_D32_SFLOAT, VK_FORMAT_X8_D24_UNORM_PACK32};
+    for (VkFormat candidate : candidates) {
+        VkFormatProperties formatProperties{};
+        context->getLoader().vkGetPhysicalDeviceFormatProperties(context->getPhysicalDevice(), candidate, &formatProperties);
+        if (formatProperties.optimalTilingFeatures & VK_FORMAT_FEATURE_DEPTH_STENCIL_ATTACHMENT_BIT) {
+            return candidate;
+        }
+    }
+    return VK_FORMAT_D16_UNORM;
+}
+
+bool VulkanSwapchain::createDepthResources() {
+    if (depthFormat == VK_FORMAT_UNDEFINED) {
+        return true;
+    }
+    
+    // Cleared at the start of the pass and never stored, so it can stay in tile memory where the device allows
+    VkImage image;
+    VkDeviceMemory memory;
+    if (!VulkanUtils::createImage(context->getDevice(), context->getPhysicalDevice(), context->getLoader(),
+                            renderExtent.width, renderExtent.height, depthFormat, VK_IMAGE_TILING_OPTIMAL,
+                            VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT | VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT,
+                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, memory, sampleCount)) {
+        return false;
+    }
+    
+    depthImage = vulkan_raii::make_image(image, context);
+    depthImageMemory = vulkan_raii::make_device_memory(memory, context);
+    
+    VkImageView imageView = VulkanUtils::createImageView(context->getDevice(), context->getLoader(), depthImage.get(), depthFormat, VK_IMAGE_ASPECT_DEPTH_BIT);
+    if (imageView == VK_NULL_HANDLE) {
+        return false;
+    }
+    
+    depthImageView = vulkan_raii::make_image_view(imageView, context);
+    return true;
+}
+
+bool VulkanSwapchain::createPickResources() {
+    if (!ENABLE_ENTITY_PICK_BUFFER || !context->supportsDynamicRendering()) {
+        return true;
+    }
+    
+    // Written only on pick frames; the single-sample image is the copy source, so only a multisampled
+    // attachment can stay transient
+    const bool multisampled = sampleCount != VK_SAMPLE_COUNT_1_BIT;
+    VkImage image;
+    VkDeviceMemory memory;
+    if (!VulkanUtils::createImage(context->getDevice(), context->getPhysicalDevice(), context->getLoader(),
+                            renderExtent.width, renderExtent.height, ENTITY_PICK_FORMAT, VK_IMAGE_TILING_OPTIMAL,
+                            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | (multisampled ? VK_IMAGE_USAGE_TRANSIENT_ATTACHMENT_BIT : VK_IMAGE_USAGE_TRANSFER_SRC_BIT),
+                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, memory, sampleCount)) {
+        return false;
+    }
+    pickImage = vulkan_raii::make_image(image, context);
+    pickImageMemory = vulkan_raii::make_device_memory(memory, context);
+    
+    VkImageView imageView = VulkanUtils::createImageView(context->getDevice(), context->getLoader(), image, ENTITY_PICK_FORMAT, VK_IMAGE_ASPECT_COLOR_BIT);
+    if (imageView == VK_NULL_HANDLE) {
+        return false;
+    }
+    pickImageView = vulkan_raii::make_image_view(imageView, context);
+    
+    if (!multisampled) {
+        return true;
+    }
+    if (!VulkanUtils::createImage(context->getDevice(), context->getPhysicalDevice(), context->getLoader(),
+                            renderExtent.width, renderExtent.height, ENTITY_PICK_FORMAT, VK_IMAGE_TILING_OPTIMAL,
+                            VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, memory)) {
+        return false;
+    }
+    pickResolveImage = vulkan_raii::make_image(image, context);
+    pickResolveImageMemory = vulkan_raii::make_device_memory(memory, context);
+    
+    imageView = VulkanUtils::createImageView(context->getDevice(), context->getLoader(), image, ENTITY_PICK_FORMAT, VK_IMAGE_ASPECT_COLOR_BIT);
+    if (imageView == VK_NULL_HANDLE) {
+        return false;
+    }
+    pickResolveImageView = vulkan_raii::make_image_view(imageView, context);
+    return true;
+}
+
+bool VulkanSwapchain::createOverdrawResources() {
+    if (!ENABLE_OVERDRAW_DIAGNOSTIC || !context->supportsOverdrawCounting()) {
+        return true;
+    }
+    
+    // One count per pixel whatever the sample count: the fragment shader runs once per pixel a primitive covers
+    VkImage image;
+    VkDeviceMemory memory;
+    if (!VulkanUtils::createImage(context->getDevice(), context->getPhysicalDevice(), context->getLoader(),
+                            renderExtent.width, renderExtent.height, VK_FORMAT_R32_UINT, VK_IMAGE_TILING_OPTIMAL,
+                            VK_IMAGE_USAGE_STORAGE_BIT | VK_IMAGE_USAGE_TRANSFER_DST_BIT,
+                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, memory)) {
+        return false;
+    }
+    overdrawImage = vulkan_raii::make_image(image, context);
+    overdrawImageMemory = vulkan_raii::make_device_memory(memory, context);
+    
+    VkImageView imageView = VulkanUtils::createImageView(context->getDevice(), context->getLoader(), image, VK_FORMAT_R32_UINT, VK_IMAGE_ASPECT_COLOR_BIT);
+    if (imageView == VK_NULL_HANDLE) {
+        return false;
+    }
+    overdrawImageView = vulkan_raii::make_image_view(imageView, context);
+    return true;
+}
+
+bool VulkanSwapchain::createScaledResources() {
+    if (!isRenderScaled()) {
+        return true;
+    }
+    
+    // One per swapchain image, so a frame's blit never races the next frame's render pass
+    scaledImages.reserve(swapChainImages.size());
+    scaledImageMemory.reserve(swapChainImages.size());
+    scaledImageViews.reserve(swapChainImages.size());
+    for (size_t i = 0; i < swapChainImages.size(); i++) {
+        VkImage image;
+        VkDeviceMemory memory;
+        if (!VulkanUtils::createImage(context->getDevice(), context->getPhysicalDevice(), context->getLoader(),
+                                renderExtent.width, renderExtent.height, swapChainImageFormat, VK_IMAGE_TILING_OPTIMAL,
+                                VK_IMAGE_USAGE_COLOR_ATTACHMENT_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT,
+                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, image, memory)) {
+            return false;
+        }
+        scaledImages.emplace_back(vulkan_raii::make_image(image, context));
+        scaledImageMemory.emplace_back(vulkan_raii::make_device_memory(memory, context));
+        
+        VkImageView imageView = VulkanUtils::createImageView(context->getDevice(), context->getLoader(), image, swapChainImageFormat, VK_IMAGE_ASPECT_COLOR_BIT);
+        if (imageView == VK_NULL_HANDLE) {
+            return false;
+        }
+        scaledImageViews.emplace_back(vulkan_raii::make_image_view(imageView, context));
+    }
+    
+    return true;
+}
+
+void VulkanSwapchain::releaseRenderTargets() {
+    msaaColorImageView.reset();
+    msaaColorImage.reset();
+    msaaColorImageMemory.reset();
+    
+    depthImageView.reset();
+    depthImage.reset();
+    depthImageMemory.reset();
+    
+    pickImageView.reset();
+    pickImage.reset();
+    pickImageMemory.reset();
+    pickResolveImageView.reset();
+    pickResolveImage.reset();
+    pickResolveImageMemory.reset();
+    
+    overdrawImageView.reset();
+    overdrawImage.reset();
+    overdrawImageMemory.reset();
+    
+    scaledImageViews.clear();
+    scaledImages.clear();
+    scaledImageMemory.clear();
+}
+
 void VulkanSwapchain::cleanupSwapChain() {
     // Cache loader and device references for performance
     const auto& vk = context->getLoader();
@@ -267,9 +630,7 @@ void VulkanSwapchain::cleanupSwapChain() {
     // RAII wrappers handle automatic cleanup
     swapChainFramebuffers.clear();
     
-    msaaColorImageView.reset();
-    msaaColorImage.reset();
-    msaaColorImageMemory.reset();
+    releaseRenderTargets();
     
     swapChainImageViews.clear();
     
@@ -301,6 +662,31 @@ void VulkanSwapchain::cleanupSwapChainExceptSwapchain() {
         std::cout << "VulkanSwapchain: MSAA memory successfully freed" << std::endl;
     }
     
+    if (depthImage) {
+        std::cout << "VulkanSwapchain: Destroying depth image" << std::endl;
+    }
+    depthImageView.reset();
+    depthImage.reset();
+    depthImageMemory.reset();
+    
+    pickImageView.reset();
+    pickImage.reset();
+    pickImageMemory.reset();
+    pickResolveImageView.reset();
+    pickResolveImage.reset();
+    pickResolveImageMemory.reset();
+    
+    overdrawImageView.reset();
+    overdrawImage.reset();
+    overdrawImageMemory.reset();
+    
+    if (!scaledImages.empty()) {
+        std::cout << "VulkanSwapchain: Destroying " << scaledImages.size() << " scaled render targets" << std::endl;
+    }
+    scaledImageViews.clear();
+    scaledImages.clear();
+    scaledImageMemory.clear();
+    
     // Cleanup swapchain image views - RAII handles destruction
     std::cout << "VulkanSwapchain: Destroying " << swapChainImageViews.size() << " image views" << std::endl;
     swapChainImageViews.clear();
@@ -312,22 +698,22 @@ void VulkanSwapchain::cleanupSwapChainExceptSwapchain() {
 SwapChainSupportDetails VulkanSwapchain::querySwapChainSupport(VkPhysicalDevice device) {
     SwapChainSupportDetails details;
 
-    context->getLoader().vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, context->getSurface(), &details.capabilities);
+    context->getLoader().vkGetPhysicalDeviceSurfaceCapabilitiesKHR(device, surface, &details.capabilities);
 
     uint32_t formatCount;
-    context->getLoader().vkGetPhysicalDeviceSurfaceFormatsKHR(device, context->getSurface(), &formatCount, nullptr);
+    context->getLoader().vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &formatCount, nullptr);
 
     if (formatCount != 0) {
         details.formats.resize(formatCount);
-        context->getLoader().vkGetPhysicalDeviceSurfaceFormatsKHR(device, context->getSurface(), &formatCount, details.formats.data());
+        context->getLoader().vkGetPhysicalDeviceSurfaceFormatsKHR(device, surface, &formatCount, details.formats.data());
     }
 
     uint32_t presentModeCount;
-    context->getLoader().vkGetPhysicalDeviceSurfacePresentModesKHR(device, context->getSurface(), &presentModeCount, nullptr);
+    context->getLoader().vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &presentModeCount, nullptr);
 
     if (presentModeCount != 0) {
         details.presentModes.resize(presentModeCount);
-        context->getLoader().vkGetPhysicalDeviceSurfacePresentModesKHR(device, context->getSurface(), &presentModeCount, details.presentModes.data());
+        context->getLoader().vkGetPhysicalDeviceSurfacePresentModesKHR(device, surface, &presentModeCount, details.presentModes.data());
     }
 
     return details;
@@ -343,29 +729,33 @@ VkSurfaceFormatKHR VulkanSwapchain::chooseSwapSurfaceFormat(const std::vector<Vk
 }
 
 VkPresentModeKHR VulkanSwapchain::chooseSwapPresentMode(const std::vector<VkPresentModeKHR>& availablePresentModes) {
-    // Priority order for low-latency, tearing-free presentation:
-    // 1. MAILBOX - Low latency with triple buffering, no tearing
-    // 2. IMMEDIATE - Lowest latency but allows tearing
-    // 3. FIFO - Guaranteed no tearing, standard vsync
-    
-    // First choice: MAILBOX for optimal balance of low latency + no tearing
-    for (const auto& availablePresentMode : availablePresentModes) {
-        if (availablePresentMode == VK_PRESENT_MODE_MAILBOX_KHR) {
-            std::cout << "Using VK_PRESENT_MODE_MAILBOX_KHR for low-latency presentation" << std::endl;
-            return availablePresentMode;
-        }
+    // Preference order per policy:
+    // - Low latency: IMMEDIATE (lowest latency, may tear), then MAILBOX (low latency, no tearing)
+    // - Power saver: FIFO_RELAXED (vsync that tears rather than stalls on a late frame), then FIFO
+    // - Tear-free max FPS: MAILBOX (newest frame replaces the queued one, no tearing)
+    std::vector<VkPresentModeKHR> preferredModes;
+    switch (presentPolicy) {
+        case PresentPolicy::LowLatency:
+            preferredModes = {VK_PRESENT_MODE_IMMEDIATE_KHR, VK_PRESENT_MODE_MAILBOX_KHR};
+            break;
+        case PresentPolicy::PowerSaver:
+            preferredModes = {VK_PRESENT_MODE_FIFO_RELAXED_KHR};
+            break;
+        case PresentPolicy::TearFreeMaxFps:
+            preferredModes = {VK_PRESENT_MODE_MAILBOX_KHR};
+            break;
     }
     
-    // Second choice: IMMEDIATE for absolute minimum latency (allows tearing)
-    for (const auto& availablePresentMode : availablePresentModes) {
-        if (availablePresentMode == VK_PRESENT_MODE_IMMEDIATE_KHR) {
-            std::cout << "Using VK_PRESENT_MODE_IMMEDIATE_KHR for minimum latency (may tear)" << std::endl;
-            return availablePresentMode;
+    for (VkPresentModeKHR preferredMode : preferredModes) {
+        if (std::find(availablePresentModes.begin(), availablePresentModes.end(), preferredMode) != availablePresentModes.end()) {
+            std::cout << "Using present mode " << preferredMode << " for the " << getPresentPolicyName(presentPolicy)
+                      << " present policy" << std::endl;
+            return preferredMode;
         }
     }
     
     // Fallback: FIFO is guaranteed to be available
-    std::cout << "Using VK_PRESENT_MODE_FIFO_KHR fallback" << std::endl;
+    std::cout << "Using VK_PRESENT_MODE_FIFO_KHR for the " << getPresentPolicyName(presentPolicy) << " present policy" << std::endl;
     return VK_PRESENT_MODE_FIFO_KHR;
 }
 
@@ -391,21 +781,31 @@ VkExtent2D VulkanSwapchain::chooseSwapExtent(const VkSurfaceCapabilitiesKHR& cap
 
 bool VulkanSwapchain::createFramebuffers(VkRenderPass renderPass) {
     swapChainFramebuffers.clear();
+    if (renderPass == VK_NULL_HANDLE) {
+        return true;
+    }
     swapChainFramebuffers.reserve(swapChainImageViews.size());
     
     for (size_t i = 0; i < swapChainImageViews.size(); i++) {
-        std::array<VkImageView, 2> attachments = {
-            msaaColorImageView.get(),      
-            swapChainImageViews[i].get()
-        };
+        // MSAA colour (when multisampled), then the single-sample output the render pass resolves or draws into,
+        // then depth: GraphicsRenderPassManager's attachment order
+        std::array<VkImageView, 3> attachments{};
+        uint32_t attachmentCount = 0;
+        if (msaaColorImageView) {
+            attachments[attachmentCount++] = msaaColorImageView.get();
+        }
+        attachments[attachmentCount++] = isRenderScaled() ? scaledImageViews[i].get() : swapChainImageViews[i].get();
+        if (depthImageView) {
+            attachments[attachmentCount++] = depthImageView.get();
+        }
         
         VkFramebufferCreateInfo framebufferInfo{};
         framebufferInfo.sType = VK_STRUCTURE_TYPE_FRAMEBUFFER_CREATE_INFO;
         framebufferInfo.renderPass = renderPass;
-        framebufferInfo.attachmentCount = static_cast<uint32_t>(attachments.size());
+        framebufferInfo.attachmentCount = attachmentCount;
         framebufferInfo.pAttachments = attachments.data();
-        framebufferInfo.width = swapChainExtent.width;
-        framebufferInfo.height = swapChainExtent.height;
+        framebufferInfo.width = renderExtent.width;
+        framebufferInfo.height = renderExtent.height;
         framebufferInfo.layers = 1;
 
         VkFramebuffer framebuffer;
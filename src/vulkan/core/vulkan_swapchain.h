@@ -6,6 +6,7 @@
 #include <vector>
 #include "vulkan_context.h"
 #include "vulkan_raii.h"
+#include "vulkan_constants.h"
 
 
 struct SwapChainSupportDetails {
@@ -19,7 +20,8 @@ public:
     VulkanSwapchain();
     ~VulkanSwapchain();
 
-    bool initialize(const VulkanContext& context, SDL_Window* window);
+    // Presents to the context's surface unless given another window's (output windows)
+    bool initialize(const VulkanContext& context, SDL_Window* window, VkSurfaceKHR windowSurface = VK_NULL_HANDLE);
     void cleanup();
     bool recreate(VkRenderPass renderPass);
     
@@ -34,18 +36,95 @@ public:
     
     VkImage getMSAAColorImage() const { return msaaColorImage.get(); }
     VkImageView getMSAAColorImageView() const { return msaaColorImageView.get(); }
+    
+    // Entity depth attachment (ENABLE_ENTITY_EARLY_DEPTH) at the render extent and sample count, shared by every
+    // frame like the MSAA image; VK_FORMAT_UNDEFINED and no image when disabled
+    VkFormat getDepthFormat() const { return depthFormat; }
+    VkImage getDepthImage() const { return depthImage.get(); }
+    VkImageView getDepthImageView() const { return depthImageView.get(); }
+    
+    // Entity pick attachment (ENABLE_ENTITY_PICK_BUFFER, dynamic rendering only) at the render extent and sample
+    // count; multisampled, it is resolved (sample zero) into the single-sample pick image the picked pixel is
+    // copied from. No images when disabled
+    VkImage getPickAttachmentImage() const { return pickImage.get(); }
+    VkImageView getPickAttachmentView() const { return pickImageView.get(); }
+    VkImage getPickImage() const { return pickResolveImage ? pickResolveImage.get() : pickImage.get(); }
+    VkImageView getPickImageView() const { return pickResolveImage ? pickResolveImageView.get() : pickImageView.get(); }
+    
+    // Overdraw count image (ENABLE_OVERDRAW_DIAGNOSTIC, fragmentStoresAndAtomics only): single-sample R32_UINT
+    // storage image at the render extent, cleared and counted into by the entity pass while the diagnostic is on
+    // and left in GENERAL. No image when disabled
+    VkImage getOverdrawImage() const { return overdrawImage.get(); }
+    VkImageView getOverdrawImageView() const { return overdrawImageView.get(); }
     std::vector<VkFramebuffer> getFramebuffers() const;
     
+    // A null render pass (dynamic rendering) leaves the swapchain without framebuffers
     bool createFramebuffers(VkRenderPass renderPass);
+    
+    // Render quality: the sample count is clamped to the device's colour framebuffer sample counts (1 creates no
+    // MSAA image) and the scale to [MIN_RENDER_SCALE, MAX_RENDER_SCALE], or to 1 when the swapchain cannot be
+    // blitted to. Takes effect for the resources made by the next recreate(); before initialize() it is only
+    // recorded. Returns whether either value changed
+    bool setRenderQuality(VkSampleCountFlagBits samples, float scale);
+    VkSampleCountFlagBits getSampleCount() const { return sampleCount; }
+    float getRenderScale() const { return renderScale; }
+    
+    // Scaled rendering draws into one offscreen image per swapchain image at getRenderExtent(), left in
+    // getOutputLayout() by the render pass for the blit to the swapchain image
+    bool isRenderScaled() const { return renderScale != 1.0f; }
+    VkExtent2D getRenderExtent() const { return renderExtent; }
+    VkImage getScaledImage(uint32_t imageIndex) const;
+    
+    // The single-sample image a frame is drawn or resolved into at the render extent: the scaled image when
+    // scaled, else the swapchain image. Dynamic rendering targets these views directly
+    VkImage getRenderTargetImage(uint32_t imageIndex) const;
+    VkImageView getRenderTargetView(uint32_t imageIndex) const;
+    VkImageLayout getOutputLayout() const { return isRenderScaled() ? VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR; }
+    VkFilter getUpscaleFilter() const { return upscaleFilter; }
+    
+    // Present mode preference and image count; takes effect at the next recreate(). Returns whether it changed
+    bool setPresentPolicy(PresentPolicy policy);
+    PresentPolicy getPresentPolicy() const { return presentPolicy; }
+    
+    // Swapchain images that are also transfer sources, for SwapchainCaptureNode (--record); takes effect at the
+    // next recreate(). isCaptureSupported() tells whether the current images were created that way
+    void setCaptureRequested(bool requested) { captureRequested = requested; }
+    bool isCaptureSupported() const { return captureSupported; }
+    static uint32_t getPolicyFramesInFlight(PresentPolicy policy);
+    static const char* getPresentPolicyName(PresentPolicy policy);
+    
+    // Present IDs (VK_KHR_present_id/present_wait): each present chains the ID from nextPresentId(), and
+    // waitForPresent blocks until that present reached the screen. IDs issued before the last recreation
+    // count as presented, since the retired swapchain will never report them
+    bool supportsPresentWait() const { return context && context->supportsPresentWait(); }
+    uint64_t nextPresentId() { return ++lastPresentId; }
+    uint64_t getLastPresentId() const { return lastPresentId; }
+    bool waitForPresent(uint64_t presentId, uint64_t timeoutNs) const;
+    uint64_t getFirstSwapchainPresentId() const { return firstSwapchainPresentId; }
+    
+    // Display timing (VK_GOOGLE_display_timing): presents chain their ID's low 32 bits, and the timings of those
+    // that reached the display since the last call are appended to timings. getRefreshDurationNs() is the
+    // reported refresh cycle, or the display mode's refresh rate without the extension (0 = unknown)
+    bool supportsDisplayTiming() const { return context && context->supportsDisplayTiming(); }
+    void getPastPresentationTimings(std::vector<VkPastPresentationTimingGOOGLE>& timings) const;
+    uint64_t getRefreshDurationNs() const { return refreshDurationNs; }
+    VkPresentModeKHR getPresentMode() const { return swapChainPresentMode; }
 
 private:
     const VulkanContext* context = nullptr;
     SDL_Window* window = nullptr;
+    VkSurfaceKHR surface = VK_NULL_HANDLE;
     
     VkSwapchainKHR swapChain = VK_NULL_HANDLE;
     std::vector<VkImage> swapChainImages;
     VkFormat swapChainImageFormat;
     VkExtent2D swapChainExtent;
+    VkPresentModeKHR swapChainPresentMode = VK_PRESENT_MODE_FIFO_KHR;
+    
+    uint64_t lastPresentId = 0;
+    uint64_t firstSwapchainPresentId = 1;  // First ID presented through the current swapchain
+    uint64_t refreshDurationNs = 0;
+    void queryRefreshDuration();
     std::vector<vulkan_raii::ImageView> swapChainImageViews;
     
     
@@ -53,12 +132,51 @@ private:
     vulkan_raii::DeviceMemory msaaColorImageMemory;
     vulkan_raii::ImageView msaaColorImageView;
     
+    VkFormat depthFormat = VK_FORMAT_UNDEFINED;
+    vulkan_raii::Image depthImage;
+    vulkan_raii::DeviceMemory depthImageMemory;
+    vulkan_raii::ImageView depthImageView;
+    
+    vulkan_raii::Image pickImage;
+    vulkan_raii::DeviceMemory pickImageMemory;
+    vulkan_raii::ImageView pickImageView;
+    vulkan_raii::Image pickResolveImage;         // Multisampled pick attachment only
+    vulkan_raii::DeviceMemory pickResolveImageMemory;
+    vulkan_raii::ImageView pickResolveImageView;
+    
+    vulkan_raii::Image overdrawImage;
+    vulkan_raii::DeviceMemory overdrawImageMemory;
+    vulkan_raii::ImageView overdrawImageView;
+    
+    VkSampleCountFlagBits requestedSampleCount = DEFAULT_MSAA_SAMPLES;
+    float requestedRenderScale = DEFAULT_RENDER_SCALE;
+    VkSampleCountFlagBits sampleCount = DEFAULT_MSAA_SAMPLES;
+    float renderScale = DEFAULT_RENDER_SCALE;
+    VkExtent2D renderExtent{};
+    uint32_t maxRenderDimension = UINT32_MAX;
+    VkFilter upscaleFilter = VK_FILTER_LINEAR;
+    
+    PresentPolicy presentPolicy = DEFAULT_PRESENT_POLICY;
+    bool captureRequested = false;
+    bool captureSupported = false;
+    
+    std::vector<vulkan_raii::Image> scaledImages;
+    std::vector<vulkan_raii::DeviceMemory> scaledImageMemory;
+    std::vector<vulkan_raii::ImageView> scaledImageViews;
+    
     std::vector<vulkan_raii::Framebuffer> swapChainFramebuffers;
 
 
     bool createSwapChain(VkSwapchainKHR oldSwapchainKHR = VK_NULL_HANDLE);
     bool createImageViews();
     bool createMSAAColorResources();
+    bool createDepthResources();
+    VkFormat chooseDepthFormat() const;
+    bool createPickResources();
+    bool createOverdrawResources();
+    bool createScaledResources();
+    void releaseRenderTargets();
+    void applyRenderQuality();
     void cleanupSwapChain();
     void cleanupSwapChainExceptSwapchain();
     
@@ -22,7 +22,16 @@ bool VulkanSync::initialize(const VulkanContext& context) {
         return false;
     }
     
-    std::cout << "VulkanSync: Initialized synchronization objects for " << MAX_FRAMES_IN_FLIGHT << " frames" << std::endl;
+    if (ENABLE_TIMELINE_FRAME_PACING && context.supportsTimelineSemaphores()) {
+        if (!createTimelineSemaphores()) {
+            std::cerr << "VulkanSync: Failed to create timeline semaphores, falling back to per-frame fences" << std::endl;
+            computeTimeline.reset();
+            graphicsTimeline.reset();
+        }
+    }
+    
+    std::cout << "VulkanSync: Initialized synchronization objects for " << context.getFramesInFlight() << " frames"
+              << (usesTimelineSemaphores() ? " (timeline frame pacing)" : " (fence frame pacing)") << std::endl;
     return true;
 }
 
@@ -38,6 +47,8 @@ void VulkanSync::cleanupBeforeContextDestruction() {
     computeFinishedSemaphores.clear();
     inFlightFences.clear();
     computeFences.clear();
+    computeTimeline.reset();
+    graphicsTimeline.reset();
 }
 
 VkSemaphore VulkanSync::getImageAvailableSemaphore(size_t index) const {
@@ -131,11 +142,12 @@ bool VulkanSync::createSyncObjects() {
     }
     
     // Resize all synchronization object vectors
-    imageAvailableSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    renderFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    computeFinishedSemaphores.resize(MAX_FRAMES_IN_FLIGHT);
-    inFlightFences.resize(MAX_FRAMES_IN_FLIGHT);
-    computeFences.resize(MAX_FRAMES_IN_FLIGHT);
+    const uint32_t framesInFlight = context->getFramesInFlight();
+    imageAvailableSemaphores.resize(framesInFlight);
+    renderFinishedSemaphores.resize(framesInFlight);
+    computeFinishedSemaphores.resize(framesInFlight);
+    inFlightFences.resize(framesInFlight);
+    computeFences.resize(framesInFlight);
     
     VkSemaphoreCreateInfo semaphoreInfo{};
     semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
@@ -144,7 +156,7 @@ bool VulkanSync::createSyncObjects() {
     fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
     fenceInfo.flags = VK_FENCE_CREATE_SIGNALED_BIT; // Start in signaled state
     
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < framesInFlight; i++) {
         const auto& vk = context->getLoader();
         const VkDevice device = context->getDevice();
         
@@ -184,5 +196,43 @@ bool VulkanSync::createSyncObjects() {
         }
     }
     
+    return true;
+}
+
+bool VulkanSync::createTimelineSemaphores() {
+    if (!context) {
+        return false;
+    }
+    
+    const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
+    if (!vk.vkWaitSemaphoresKHR || !vk.vkGetSemaphoreCounterValueKHR) {
+        std::cerr << "VulkanSync: Timeline semaphore functions not loaded" << std::endl;
+        return false;
+    }
+    
+    VkSemaphoreTypeCreateInfoKHR typeInfo{};
+    typeInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_TYPE_CREATE_INFO_KHR;
+    typeInfo.semaphoreType = VK_SEMAPHORE_TYPE_TIMELINE_KHR;
+    typeInfo.initialValue = 0;
+    
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    semaphoreInfo.pNext = &typeInfo;
+    
+    VkSemaphore computeSem;
+    if (vk.vkCreateSemaphore(device, &semaphoreInfo, nullptr, &computeSem) != VK_SUCCESS) {
+        std::cerr << "VulkanSync: Failed to create compute timeline semaphore" << std::endl;
+        return false;
+    }
+    computeTimeline = vulkan_raii::make_semaphore(computeSem, context);
+    
+    VkSemaphore graphicsSem;
+    if (vk.vkCreateSemaphore(device, &semaphoreInfo, nullptr, &graphicsSem) != VK_SUCCESS) {
+        std::cerr << "VulkanSync: Failed to create graphics timeline semaphore" << std::endl;
+        return false;
+    }
+    graphicsTimeline = vulkan_raii::make_semaphore(graphicsSem, context);
+    
     return true;
 }
\ No newline at end of file
@@ -39,6 +39,11 @@ public:
     std::vector<VkFence> getInFlightFences() const;
     std::vector<VkFence> getComputeFences() const;
     
+    // Timeline frame pacing - one monotonically increasing semaphore per queue replaces per-slot fences
+    bool usesTimelineSemaphores() const { return computeTimeline && graphicsTimeline; }
+    VkSemaphore getComputeTimelineSemaphore() const { return computeTimeline.get(); }
+    VkSemaphore getGraphicsTimelineSemaphore() const { return graphicsTimeline.get(); }
+    
 private:
     const VulkanContext* context = nullptr;
     
@@ -48,7 +53,10 @@ private:
     std::vector<vulkan_raii::Semaphore> computeFinishedSemaphores; // Compute-to-graphics synchronization
     std::vector<vulkan_raii::Fence> inFlightFences;                // Graphics fences
     std::vector<vulkan_raii::Fence> computeFences;                 // Compute fences
+    vulkan_raii::Semaphore computeTimeline;                        // Signaled once per compute submission
+    vulkan_raii::Semaphore graphicsTimeline;                       // Signaled once per graphics submission
 
     // Internal methods
     bool createSyncObjects();
+    bool createTimelineSemaphores();
 };
\ No newline at end of file
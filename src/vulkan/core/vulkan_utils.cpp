@@ -1,5 +1,6 @@
 #include "vulkan_utils.h"
 #include "vulkan_function_loader.h"
+#include "../../ecs/utilities/profiler.h"
 #include <fstream>
 #include <iostream>
 #include <stdexcept>
@@ -14,6 +15,18 @@ uint32_t VulkanUtils::findMemoryType(VkPhysicalDevice physicalDevice,
     VkPhysicalDeviceMemoryProperties memProperties;
     vk.vkGetPhysicalDeviceMemoryProperties(physicalDevice, &memProperties);
     
+    // Multi-instance memory (one copy per GPU of a device group) cannot be mapped, so mapped allocations
+    // prefer a heap with a single instance
+    if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+            const VkMemoryHeapFlags heapFlags = memProperties.memoryHeaps[memProperties.memoryTypes[i].heapIndex].flags;
+            if ((typeFilter & (1 << i)) && !(heapFlags & VK_MEMORY_HEAP_MULTI_INSTANCE_BIT) &&
+                (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+                return i;
+            }
+        }
+    }
+    
     for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
         if ((typeFilter & (1 << i)) && 
             (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
@@ -211,6 +224,8 @@ void VulkanUtils::endSingleTimeCommands(VkDevice device,
                                        VkQueue queue,
                                        VkCommandPool commandPool,
                                        VkCommandBuffer commandBuffer) {
+    PROFILE_HITCH_EVENT(HitchCause::SynchronousUpload);
+    
     // Cache loader reference for performance
     const auto& vk = loader;
     
@@ -221,10 +236,26 @@ void VulkanUtils::endSingleTimeCommands(VkDevice device,
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &commandBuffer;
     
-    vk.vkQueueSubmit(queue, 1, &submitInfo, VK_NULL_HANDLE);
-    vk.vkQueueWaitIdle(queue);
+    // Wait on this submission alone rather than idling the queue, then return the buffer to its pool
+    VkFenceCreateInfo fenceInfo{};
+    fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+    VkFence fence = VK_NULL_HANDLE;
+    if (vk.vkCreateFence(device, &fenceInfo, nullptr, &fence) != VK_SUCCESS) {
+        fence = VK_NULL_HANDLE;
+    }
+    
+    if (vk.vkQueueSubmit(queue, 1, &submitInfo, fence) == VK_SUCCESS) {
+        if (fence != VK_NULL_HANDLE) {
+            vk.vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
+        } else {
+            vk.vkQueueWaitIdle(queue);
+        }
+    }
     
-    // Note: Command buffer will be freed automatically when command pool is destroyed
+    if (fence != VK_NULL_HANDLE) {
+        vk.vkDestroyFence(device, fence, nullptr);
+    }
+    vk.vkFreeCommandBuffers(device, commandPool, 1, &commandBuffer);
 }
 
 void VulkanUtils::transitionImageLayout(VkDevice device,
@@ -157,10 +157,6 @@ bool ComputeStressTester::executeComputeDispatch(uint32_t workgroupCount, float&
     // Execute and time
     auto startTime = std::chrono::high_resolution_clock::now();
     
-    if (timeoutDetector) {
-        timeoutDetector->beginComputeDispatch("StressTest", workgroupCount);
-    }
-    
     VkSubmitInfo submitInfo{};
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submitInfo.commandBufferCount = 1;
@@ -182,8 +178,9 @@ bool ComputeStressTester::executeComputeDispatch(uint32_t workgroupCount, float&
     auto durationUs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - startTime);
     executionTimeMs = durationUs.count() / 1000.0f;
     
+    // Submit to fence covers the whole submission, which is only this dispatch
     if (timeoutDetector) {
-        timeoutDetector->endComputeDispatch();
+        timeoutDetector->recordDispatchTime(executionTimeMs, workgroupCount);
     }
     
     // Check device status
@@ -0,0 +1,220 @@
+#include "device_health_monitor.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../core/vulkan_constants.h"
+#include "../core/vulkan_sync.h"
+#include <iostream>
+#include <string>
+
+namespace {
+
+uint32_t elapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return static_cast<uint32_t>(std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count());
+}
+
+}
+
+DeviceHealthMonitor::~DeviceHealthMonitor() {
+    stop();
+}
+
+bool DeviceHealthMonitor::start(const VulkanContext* vulkanContext, const VulkanSync* sync,
+                                const FrameGraphExecution::GpuBreadcrumbs* frameBreadcrumbs) {
+    if (running) {
+        return true;
+    }
+    if constexpr (!ENABLE_DEVICE_HEALTH_MONITOR) {
+        return false;
+    }
+    if (!vulkanContext || !sync) {
+        return false;
+    }
+    context = vulkanContext;
+    breadcrumbs = frameBreadcrumbs;
+    
+    const auto now = Clock::now();
+    timelinePacing = sync->usesTimelineSemaphores() && context->getLoader().vkGetSemaphoreCounterValueKHR;
+    timelines[static_cast<uint32_t>(Queue::Compute)].semaphore = sync->getComputeTimelineSemaphore();
+    timelines[static_cast<uint32_t>(Queue::Graphics)].semaphore = sync->getGraphicsTimelineSemaphore();
+    for (TimelineTrack& track : timelines) {
+        track.submitted.store(0, std::memory_order_relaxed);
+        track.completed = 0;
+        track.lastProgress = now;
+        track.reported = false;
+    }
+    fenceWaitStart.store(0, std::memory_order_relaxed);
+    reportedFenceWait = 0;
+    hangDetected.store(false, std::memory_order_relaxed);
+    
+    stopping = false;
+    watchdog = std::thread(&DeviceHealthMonitor::watchLoop, this);
+    running = true;
+    
+    std::cout << "DeviceHealthMonitor: Watching " << (timelinePacing ? "timeline semaphore progress" : "frame fence waits")
+              << ", hangs reported after " << DEVICE_HANG_TIMEOUT_MS << "ms";
+    if (breadcrumbs && breadcrumbs->isActive()) {
+        std::cout << (breadcrumbs->readableBeforeLoss() ? " with node breadcrumbs" : " (node checkpoints on device loss)");
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+void DeviceHealthMonitor::stop() {
+    if (!running) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (watchdog.joinable()) {
+        watchdog.join();
+    }
+    running = false;
+    
+    const Telemetry telemetry = getTelemetry();
+    std::cout << "DeviceHealthMonitor: Stopped, " << telemetry.hangsDetected << " hangs detected, longest stall "
+              << telemetry.longestStallMs << "ms" << std::endl;
+}
+
+void DeviceHealthMonitor::recordSubmission(uint64_t computeValue, uint64_t graphicsValue) {
+    if (computeValue > 0) {
+        timelines[static_cast<uint32_t>(Queue::Compute)].submitted.store(computeValue, std::memory_order_relaxed);
+    }
+    if (graphicsValue > 0) {
+        timelines[static_cast<uint32_t>(Queue::Graphics)].submitted.store(graphicsValue, std::memory_order_relaxed);
+    }
+}
+
+void DeviceHealthMonitor::beginFenceWait() {
+    fenceWaitStart.store(Clock::now().time_since_epoch().count(), std::memory_order_relaxed);
+}
+
+void DeviceHealthMonitor::endFenceWait() {
+    fenceWaitStart.store(0, std::memory_order_relaxed);
+}
+
+DeviceHealthMonitor::Telemetry DeviceHealthMonitor::getTelemetry() const {
+    Telemetry telemetry;
+    telemetry.hangsDetected = hangsDetected.load(std::memory_order_relaxed);
+    telemetry.longestStallMs = longestStallMs.load(std::memory_order_relaxed);
+    return telemetry;
+}
+
+void DeviceHealthMonitor::watchLoop() {
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (!stopping) {
+        wake.wait_for(lock, std::chrono::milliseconds(DEVICE_HEALTH_POLL_MS), [this] { return stopping; });
+        if (stopping) {
+            break;
+        }
+        lock.unlock();
+        
+        const auto now = Clock::now();
+        bool stalled = false;
+        if (timelinePacing) {
+            for (uint32_t queue = 0; queue < timelines.size(); ++queue) {
+                stalled |= checkTimeline(static_cast<Queue>(queue), timelines[queue], now);
+            }
+        } else {
+            stalled = checkFenceWait(now);
+        }
+        hangDetected.store(stalled, std::memory_order_relaxed);
+        
+        lock.lock();
+    }
+}
+
+bool DeviceHealthMonitor::checkTimeline(Queue queue, TimelineTrack& track, Clock::time_point now) {
+    // Device loss fails the query; the frame loop sees it too and reports it
+    uint64_t value = 0;
+    if (context->getLoader().vkGetSemaphoreCounterValueKHR(context->getDevice(), track.semaphore, &value) != VK_SUCCESS) {
+        return false;
+    }
+    
+    const uint64_t submitted = track.submitted.load(std::memory_order_relaxed);
+    if (value != track.completed || submitted <= value) {
+        if (track.reported && value != track.completed) {
+            std::cout << "DeviceHealthMonitor: " << FrameGraphExecution::GpuBreadcrumbs::getQueueName(queue)
+                      << " queue progressing again after " << elapsedMs(track.lastProgress, now) << "ms" << std::endl;
+        }
+        track.completed = value;
+        track.lastProgress = now;
+        track.reported = false;
+        return false;
+    }
+    
+    const uint32_t stalledMs = elapsedMs(track.lastProgress, now);
+    noteStall(stalledMs);
+    if (stalledMs < DEVICE_HANG_TIMEOUT_MS) {
+        return false;
+    }
+    if (!track.reported) {
+        reportHang((std::string(FrameGraphExecution::GpuBreadcrumbs::getQueueName(queue)) + " timeline at " +
+                    std::to_string(value) + " of " + std::to_string(submitted) + " submitted").c_str(), stalledMs);
+        track.reported = true;
+    }
+    return true;
+}
+
+bool DeviceHealthMonitor::checkFenceWait(Clock::time_point now) {
+    const int64_t start = fenceWaitStart.load(std::memory_order_relaxed);
+    if (start == 0) {
+        return false;
+    }
+    if (reportedFenceWait == start) {
+        noteStall(elapsedMs(Clock::time_point(Clock::duration(start)), now));
+        return true;
+    }
+    if (reportedFenceWait != 0) {
+        std::cout << "DeviceHealthMonitor: Frame fence waits returning again" << std::endl;
+        reportedFenceWait = 0;
+    }
+    
+    const uint32_t stalledMs = elapsedMs(Clock::time_point(Clock::duration(start)), now);
+    noteStall(stalledMs);
+    if (stalledMs < DEVICE_HANG_TIMEOUT_MS) {
+        return false;
+    }
+    reportHang("the frame's fence wait", stalledMs);
+    reportedFenceWait = start;
+    return true;
+}
+
+void DeviceHealthMonitor::noteStall(uint32_t stalledMs) {
+    // Only the watchdog writes it
+    if (stalledMs > longestStallMs.load(std::memory_order_relaxed)) {
+        longestStallMs.store(stalledMs, std::memory_order_relaxed);
+    }
+}
+
+void DeviceHealthMonitor::reportHang(const char* what, uint32_t stalledMs) {
+    hangsDetected.fetch_add(1, std::memory_order_relaxed);
+    std::cerr << "DeviceHealthMonitor: GPU hang suspected - " << what << " made no progress for " << stalledMs << "ms" << std::endl;
+    if (breadcrumbs && breadcrumbs->readableBeforeLoss()) {
+        logTrails();
+    }
+}
+
+void DeviceHealthMonitor::reportDeviceLost() const {
+    if (!breadcrumbs || !breadcrumbs->isActive()) {
+        std::cerr << "DeviceHealthMonitor: No breadcrumbs on this device, the lost work cannot be attributed to a node" << std::endl;
+        return;
+    }
+    std::cerr << "DeviceHealthMonitor: Device lost, last breadcrumbs:" << std::endl;
+    logTrails();
+}
+
+void DeviceHealthMonitor::logTrails() const {
+    for (uint32_t queue = 0; queue < FrameGraphExecution::GpuBreadcrumbs::QUEUE_COUNT; ++queue) {
+        FrameGraphExecution::BreadcrumbTrail trail;
+        const char* queueName = FrameGraphExecution::GpuBreadcrumbs::getQueueName(static_cast<Queue>(queue));
+        if (!breadcrumbs->readTrail(static_cast<Queue>(queue), trail)) {
+            std::cerr << "  " << queueName << " queue: no breadcrumbs reported" << std::endl;
+            continue;
+        }
+        std::cerr << "  " << queueName << " queue: last started " << breadcrumbs->describeNode(trail.begun)
+                  << ", last finished " << breadcrumbs->describeNode(trail.completed) << std::endl;
+    }
+}
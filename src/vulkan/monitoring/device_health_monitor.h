@@ -0,0 +1,98 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/execution/gpu_breadcrumbs.h"
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+
+class VulkanContext;
+class VulkanSync;
+
+/**
+ * Hang watchdog that never blocks the device. One thread wakes every DEVICE_HEALTH_POLL_MS and checks that
+ * submitted GPU work keeps moving: under timeline pacing it reads each queue's semaphore counter with
+ * vkGetSemaphoreCounterValueKHR against the latest value the frame loop submitted; under fence pacing, where
+ * vkResetFences on the frame loop rules out querying the fences from another thread, it times how long the frame
+ * loop has been inside its blocking fence wait. Work that made no progress for DEVICE_HANG_TIMEOUT_MS is logged
+ * once, with the node each queue was last in when breadcrumbs are available, and isHangDetected() holds until the
+ * GPU moves again. It only reports: recovery stays with the VK_ERROR_DEVICE_LOST path.
+ */
+class DeviceHealthMonitor {
+public:
+    DeviceHealthMonitor() = default;
+    ~DeviceHealthMonitor();
+    
+    DeviceHealthMonitor(const DeviceHealthMonitor&) = delete;
+    DeviceHealthMonitor& operator=(const DeviceHealthMonitor&) = delete;
+    
+    // Starts the watchdog; the context, sync objects and breadcrumbs must outlive stop()
+    bool start(const VulkanContext* context, const VulkanSync* sync, const FrameGraphExecution::GpuBreadcrumbs* breadcrumbs);
+    void stop();
+    bool isRunning() const { return running; }
+    
+    // Frame loop, timeline pacing: values the frame's compute and graphics submissions signal (0 = none)
+    void recordSubmission(uint64_t computeValue, uint64_t graphicsValue);
+    
+    // Frame loop, fence pacing: around the blocking wait for a slot's fences
+    void beginFenceWait();
+    void endFenceWait();
+    
+    // Any thread: a hang was reported and the GPU has not progressed since
+    bool isHangDetected() const { return hangDetected.load(std::memory_order_relaxed); }
+    
+    // Frame loop, on VK_ERROR_DEVICE_LOST: logs where each queue was; checkpoints can only be read now
+    void reportDeviceLost() const;
+    
+    struct Telemetry {
+        uint64_t hangsDetected = 0;
+        uint32_t longestStallMs = 0;  // Longest stretch pending work went without progress
+    };
+    Telemetry getTelemetry() const;
+
+private:
+    using Clock = std::chrono::steady_clock;
+    using Queue = FrameGraphExecution::GpuBreadcrumbs::Queue;
+    
+    struct TimelineTrack {
+        VkSemaphore semaphore = VK_NULL_HANDLE;
+        std::atomic<uint64_t> submitted{0};
+        // Watchdog thread only
+        uint64_t completed = 0;
+        Clock::time_point lastProgress{};
+        bool reported = false;
+    };
+    
+    void watchLoop();
+    bool checkTimeline(Queue queue, TimelineTrack& track, Clock::time_point now);
+    bool checkFenceWait(Clock::time_point now);
+    void noteStall(uint32_t stalledMs);
+    void reportHang(const char* what, uint32_t stalledMs);
+    void logTrails() const;
+    
+    const VulkanContext* context = nullptr;
+    const FrameGraphExecution::GpuBreadcrumbs* breadcrumbs = nullptr;
+    bool running = false;
+    
+    std::array<TimelineTrack, FrameGraphExecution::GpuBreadcrumbs::QUEUE_COUNT> timelines;
+    bool timelinePacing = false;
+    
+    // Steady clock ticks the current fence wait started at, 0 outside one; the start of the wait last reported
+    // is the watchdog's, so back-to-back waits are told apart even when it never sees the 0 between them
+    std::atomic<int64_t> fenceWaitStart{0};
+    int64_t reportedFenceWait = 0;
+    
+    std::thread watchdog;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    
+    std::atomic<bool> hangDetected{false};
+    std::atomic<uint64_t> hangsDetected{0};
+    std::atomic<uint32_t> longestStallMs{0};
+};
@@ -2,6 +2,7 @@
 #include "../core/vulkan_context.h"
 #include "../core/vulkan_function_loader.h"
 #include "../core/vulkan_constants.h"
+#include "../resources/core/memory_allocator.h"
 #include <iostream>
 #include <algorithm>
 #include <numeric>
@@ -100,6 +101,34 @@ void GPUMemoryMonitor::recordBufferAccess(VkBuffer buffer, uint64_t accessSize,
     }
 }
 
+void GPUMemoryMonitor::recordNodeBandwidth(const std::string& nodeName, uint64_t sampleCount, uint64_t bytes, float gpuMs) {
+    NodeBandwidth& node = nodeBandwidth[nodeName];
+    if (sampleCount == node.sampleCount || gpuMs <= 0.0f) return;
+    node.sampleCount = sampleCount;
+    
+    frameBufferAccessBytes += bytes;
+    frameAccessCount++;
+    
+    const bool wasBound = node.bandwidthBound;
+    node.gigabytesPerSecond = static_cast<float>(bytes / (static_cast<double>(gpuMs) * 1.0e6));
+    node.peakPercent = currentStats.theoreticalBandwidthGBps > 0.0f
+        ? node.gigabytesPerSecond / currentStats.theoreticalBandwidthGBps * 100.0f : 0.0f;
+    node.bandwidthBound = node.peakPercent >= BANDWIDTH_BOUND_PERCENT;
+    if (node.bandwidthBound != wasBound) {
+        std::cout << "GPUMemoryMonitor: " << nodeName << " is " << (node.bandwidthBound ? "now" : "no longer")
+                  << " bandwidth-bound (" << node.gigabytesPerSecond << " GB/s, " << node.peakPercent << "% of "
+                  << currentStats.theoreticalBandwidthGBps << " GB/s peak)" << std::endl;
+    }
+}
+
+void GPUMemoryMonitor::logNodeBandwidth() const {
+    for (const auto& [name, node] : nodeBandwidth) {
+        if (node.sampleCount == 0) continue;
+        std::cout << "GPUMemoryMonitor: " << name << " " << node.gigabytesPerSecond << " GB/s ("
+                  << node.peakPercent << "% of peak" << (node.bandwidthBound ? ", bandwidth-bound" : "") << ")" << std::endl;
+    }
+}
+
 void GPUMemoryMonitor::trackBufferAllocation(VkBuffer buffer, uint64_t size, const char* name) {
     BufferInfo info{};
     info.size = size;
@@ -141,8 +170,18 @@ void GPUMemoryMonitor::trackBufferDeallocation(VkBuffer buffer) {
 
 void GPUMemoryMonitor::updateMemoryStats() {
     // Update memory utilization
-    currentStats.usedDeviceMemory = currentStats.totalBufferMemory; // Simplified tracking
-    currentStats.availableDeviceMemory = currentStats.totalDeviceMemory - currentStats.usedDeviceMemory;
+    if (memoryAllocator) {
+        const MemoryAllocator::DeviceMemoryBudget budget = memoryAllocator->getDeviceLocalBudget();
+        currentStats.totalDeviceMemory = budget.budgetBytes;
+        currentStats.usedDeviceMemory = budget.usedBytes;
+        currentStats.availableDeviceMemory = budget.availableBytes;
+        const MemoryAllocator::ResidencyReport residency = memoryAllocator->getResidencyReport();
+        currentStats.demotedDeviceMemory = residency.demoted ? residency.demotedBytes : 0;
+    } else {
+        currentStats.usedDeviceMemory = currentStats.totalBufferMemory; // Simplified tracking
+        currentStats.availableDeviceMemory = currentStats.totalDeviceMemory > currentStats.usedDeviceMemory
+            ? currentStats.totalDeviceMemory - currentStats.usedDeviceMemory : 0;
+    }
     
     if (currentStats.totalDeviceMemory > 0) {
         currentStats.memoryUtilizationPercent = 
@@ -173,6 +212,7 @@ bool GPUMemoryMonitor::isMemoryHealthy() const {
     // 1. Utilization is below 80%
     // 2. Bandwidth utilization is below 70%
     // 3. We have at least 500MB available
+    // 4. None of our device-local memory has been demoted
     
     const float maxUtilization = 80.0f;
     const float maxBandwidthUtilization = 70.0f;
@@ -180,7 +220,8 @@ bool GPUMemoryMonitor::isMemoryHealthy() const {
     
     return currentStats.memoryUtilizationPercent < maxUtilization &&
            currentStats.bandwidthUtilizationPercent < maxBandwidthUtilization &&
-           currentStats.availableDeviceMemory > minAvailable;
+           currentStats.availableDeviceMemory > minAvailable &&
+           currentStats.demotedDeviceMemory == 0;
 }
 
 float GPUMemoryMonitor::getMemoryPressure() const {
@@ -212,6 +253,12 @@ GPUMemoryMonitor::MemoryRecommendation GPUMemoryMonitor::getRecommendations() co
         rec.recommendations.push_back("Optimize buffer layout for better cache utilization");
     }
     
+    // Kernels reading demoted memory cross the bus and slow down several times without any error
+    if (currentStats.demotedDeviceMemory > 0) {
+        rec.shouldReduceBufferSizes = true;
+        rec.recommendations.push_back("Device memory demoted to system memory - close other GPU applications or reduce entity count");
+    }
+    
     if (currentStats.entityBufferSize > LARGE_BUFFER_THRESHOLD) {
         rec.recommendations.push_back("Entity buffer is large - consider LOD or culling");
     }
@@ -10,6 +10,7 @@
 
 // Forward declarations
 class VulkanContext;
+class MemoryAllocator;
 
 /**
  * GPU Memory Bandwidth Monitor - Tracks memory usage patterns and bandwidth utilization
@@ -19,13 +20,17 @@ class GPUMemoryMonitor {
 public:
     GPUMemoryMonitor(const VulkanContext* context);
     ~GPUMemoryMonitor() = default;
+    
+    // Device memory totals then come from the allocator's device-local budget instead of tracked buffer sizes
+    void setMemoryAllocator(const MemoryAllocator* allocator) { memoryAllocator = allocator; }
 
     // Memory statistics
     struct MemoryStats {
-        uint64_t totalDeviceMemory = 0;           // Total GPU memory
+        uint64_t totalDeviceMemory = 0;           // Total GPU memory (budget, when the allocator knows it)
         uint64_t usedDeviceMemory = 0;            // Currently allocated
         uint64_t availableDeviceMemory = 0;       // Available for allocation
         float memoryUtilizationPercent = 0.0f;   // Used / Total * 100
+        uint64_t demotedDeviceMemory = 0;         // Device-local memory moved to system memory (MemoryAllocator::ResidencyReport)
         
         // Buffer-specific tracking
         uint64_t entityBufferSize = 0;
@@ -44,6 +49,19 @@ public:
     void endFrame();
     void recordBufferAccess(VkBuffer buffer, uint64_t accessSize, bool isWrite);
     
+    // Achieved bandwidth of one frame graph node: the bytes its streams move (getBytesPerEntity() x entities)
+    // over its GPU timestamp time, against the device peak estimate. Both echo a sample from the same timing
+    // window, so a sampleCount already seen is ignored. The bytes also count towards the frame's bandwidth
+    struct NodeBandwidth {
+        float gigabytesPerSecond = 0.0f;
+        float peakPercent = 0.0f;
+        bool bandwidthBound = false;  // peakPercent >= BANDWIDTH_BOUND_PERCENT; otherwise latency or ALU bound
+        uint64_t sampleCount = 0;
+    };
+    void recordNodeBandwidth(const std::string& nodeName, uint64_t sampleCount, uint64_t bytes, float gpuMs);
+    const std::unordered_map<std::string, NodeBandwidth>& getNodeBandwidth() const { return nodeBandwidth; }
+    void logNodeBandwidth() const;
+    
     // Memory allocation tracking
     void trackBufferAllocation(VkBuffer buffer, uint64_t size, const char* name);
     void trackBufferDeallocation(VkBuffer buffer);
@@ -68,6 +86,7 @@ public:
 
 private:
     const VulkanContext* context;
+    const MemoryAllocator* memoryAllocator = nullptr;
     MemoryStats currentStats{};
     
     // Frame-based tracking
@@ -85,6 +104,7 @@ private:
     };
     
     std::unordered_map<VkBuffer, BufferInfo> trackedBuffers;
+    std::unordered_map<std::string, NodeBandwidth> nodeBandwidth;
     
     // Performance history
     std::vector<float> recentBandwidthSamples;
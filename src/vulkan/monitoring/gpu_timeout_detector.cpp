@@ -6,122 +6,233 @@
 #include <iostream>
 #include <algorithm>
 #include <numeric>
+#include <cmath>
 
 GPUTimeoutDetector::GPUTimeoutDetector(const VulkanContext* context, VulkanSync* sync)
     : context(context), sync(sync) {
     
-    // Try to create timestamp query pool, fall back to CPU timing if not supported
-    if (!createTimestampQueryPool()) {
-        std::cout << "GPUTimeoutDetector: Using CPU-based timing (GPU timestamp queries not available)" << std::endl;
+    // Without timestamps only caller-measured times (recordDispatchTime) reach the statistics
+    if (!createTimestampQueryPools()) {
+        std::cout << "GPUTimeoutDetector: GPU timestamp queries not available, dispatch timing disabled" << std::endl;
     } else {
         std::cout << "GPUTimeoutDetector: Using GPU timestamp queries for precise timing" << std::endl;
     }
-    
-    recentDispatchTimes.reserve(ROLLING_WINDOW_SIZE);
+    resetStats();
 }
 
 GPUTimeoutDetector::~GPUTimeoutDetector() {
     // RAII handles cleanup automatically
 }
 
-bool GPUTimeoutDetector::createTimestampQueryPool() {
+bool GPUTimeoutDetector::createTimestampQueryPools() {
     if (!context) return false;
     
-    // Check if timestamp queries are supported
-    VkPhysicalDeviceProperties props;
-    context->getLoader().vkGetPhysicalDeviceProperties(context->getPhysicalDevice(), &props);
+    // Cache loader and device references for performance
+    const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
     
-    if (props.limits.timestampComputeAndGraphics == VK_FALSE) {
-        // Timestamp queries not supported
+    VkPhysicalDeviceProperties props;
+    vk.vkGetPhysicalDeviceProperties(context->getPhysicalDevice(), &props);
+    if (props.limits.timestampPeriod <= 0.0f) {
         return false;
     }
     
-    // Cache loader and device references for performance
-    const auto& vk = context->getLoader();
-    const VkDevice device = context->getDevice();
+    // Frame dispatches run on the compute queue, stress test submissions on the graphics queue
+    uint32_t familyCount = 0;
+    vk.vkGetPhysicalDeviceQueueFamilyProperties(context->getPhysicalDevice(), &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vk.vkGetPhysicalDeviceQueueFamilyProperties(context->getPhysicalDevice(), &familyCount, families.data());
+    
+    const uint32_t computeFamily = context->getComputeQueueFamily();
+    const uint32_t graphicsFamily = context->getGraphicsQueueFamily();
+    if (computeFamily >= familyCount || graphicsFamily >= familyCount) {
+        return false;
+    }
+    const uint32_t validBits = std::min(families[computeFamily].timestampValidBits, families[graphicsFamily].timestampValidBits);
+    if (validBits == 0) {
+        return false;
+    }
+    timestampMask = validBits >= 64 ? ~0ULL : ((1ULL << validBits) - 1);
+    timestampPeriodNs = props.limits.timestampPeriod;
+    clock.initialize(context, timestampPeriodNs, timestampMask);
+    synchronization2 = context->supportsSynchronization2();
     
-    // Create timestamp query pool
     VkQueryPoolCreateInfo queryPoolInfo{};
     queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
     queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
-    queryPoolInfo.queryCount = MAX_TIMESTAMP_QUERIES;
+    queryPoolInfo.queryCount = MAX_TIMED_DISPATCHES * 2;
     
-    VkQueryPool queryPoolHandle = VK_NULL_HANDLE;
-    VkResult result = vk.vkCreateQueryPool(device, &queryPoolInfo, nullptr, &queryPoolHandle);
-    
-    if (result != VK_SUCCESS) {
-        std::cerr << "GPUTimeoutDetector: Failed to create timestamp query pool: " << result << std::endl;
-        return false;
+    frameSlots.clear();
+    frameSlots.resize(context->getFramesInFlight());
+    for (FrameSlot& slot : frameSlots) {
+        VkQueryPool queryPoolHandle = VK_NULL_HANDLE;
+        VkResult result = vk.vkCreateQueryPool(device, &queryPoolInfo, nullptr, &queryPoolHandle);
+        if (result != VK_SUCCESS) {
+            std::cerr << "GPUTimeoutDetector: Failed to create timestamp query pool: " << result << std::endl;
+            frameSlots.clear();
+            return false;
+        }
+        slot.queryPool = vulkan_raii::make_query_pool(queryPoolHandle, context);
     }
-    
-    timestampQueryPool = vulkan_raii::make_query_pool(queryPoolHandle, context);
     return true;
 }
 
-void GPUTimeoutDetector::beginComputeDispatch(const char* dispatchName, uint32_t workgroupCount) {
+void GPUTimeoutDetector::beginFrame(uint32_t frameIndex) {
+    if (frameIndex >= frameSlots.size()) {
+        currentSlot = NO_SLOT;
+        return;
+    }
+    
+    collectSlot(frameSlots[frameIndex]);
+    currentSlot = frameIndex;
+    dispatchInProgress = false;
+}
+
+void GPUTimeoutDetector::beginComputeDispatch(VkCommandBuffer commandBuffer, ProfileZoneId zone, uint32_t workgroupCount, bool capped) {
+    if (currentSlot == NO_SLOT) return;
+    
     if (dispatchInProgress) {
         std::cerr << "GPUTimeoutDetector: Warning - overlapping dispatch monitoring" << std::endl;
         return;
     }
     
+    FrameSlot& slot = frameSlots[currentSlot];
+    if (slot.dispatchCount >= MAX_TIMED_DISPATCHES) return;
+    
+    const auto& vk = context->getLoader();
+    VkQueryPool queryPool = slot.queryPool.get();
+    const uint32_t firstQuery = slot.dispatchCount * 2;
+    
+    // Reset in the same command buffer, ahead of the pair's first write
+    vk.vkCmdResetQueryPool(commandBuffer, queryPool, firstQuery, 2);
+    if (synchronization2) {
+        vk.vkCmdWriteTimestamp2KHR(commandBuffer, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT_KHR, queryPool, firstQuery);
+    } else {
+        vk.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, firstQuery);
+    }
+    
+    slot.dispatches[slot.dispatchCount] = TimedDispatch{zone, workgroupCount, capped};
     dispatchInProgress = true;
-    dispatchStartTime = std::chrono::high_resolution_clock::now();
+}
+
+void GPUTimeoutDetector::endComputeDispatch(VkCommandBuffer commandBuffer) {
+    if (!dispatchInProgress) return;
+    dispatchInProgress = false;
     
-    // Check device status before dispatch
-    checkDeviceStatus();
+    FrameSlot& slot = frameSlots[currentSlot];
+    const auto& vk = context->getLoader();
+    const uint32_t lastQuery = slot.dispatchCount * 2 + 1;
     
-    if (lastDeviceStatus != VK_SUCCESS) {
-        std::cerr << "GPUTimeoutDetector: Device status error before dispatch '" 
-                  << dispatchName << "': " << lastDeviceStatus << std::endl;
+    if (synchronization2) {
+        vk.vkCmdWriteTimestamp2KHR(commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, slot.queryPool.get(), lastQuery);
+    } else {
+        vk.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, slot.queryPool.get(), lastQuery);
     }
+    slot.dispatchCount++;
 }
 
-void GPUTimeoutDetector::endComputeDispatch() {
-    if (!dispatchInProgress) {
-        std::cerr << "GPUTimeoutDetector: Warning - endComputeDispatch without begin" << std::endl;
-        return;
+void GPUTimeoutDetector::collectSlot(FrameSlot& slot) {
+    const auto& vk = context->getLoader();
+    const int64_t collectNs = Profiler::now();
+    clock.refresh(collectNs);
+    float cappedDispatchMs = -1.0f;  // Slowest capped dispatch of the frame, scaled to the current cap
+    bool critical = false;
+    
+    for (uint32_t index = 0; index < slot.dispatchCount; ++index) {
+        // Value and availability per query; never waits, an unfinished pair is simply dropped
+        uint64_t results[4] = {};
+        VkResult result = vk.vkGetQueryPoolResults(
+            context->getDevice(), slot.queryPool.get(), index * 2, 2, sizeof(results), results, sizeof(uint64_t) * 2,
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        
+        // Device loss surfaces here instead of through a device-wide wait
+        if (result != VK_SUCCESS && result != VK_NOT_READY) {
+            if (result == VK_ERROR_DEVICE_LOST && lastDeviceStatus != result) {
+                std::cerr << "GPUTimeoutDetector: FATAL - VK_ERROR_DEVICE_LOST detected!" << std::endl;
+            } else if (lastDeviceStatus != result) {
+                std::cerr << "GPUTimeoutDetector: Device status error: " << result << std::endl;
+            }
+            lastDeviceStatus = result;
+            break;
+        }
+        lastDeviceStatus = VK_SUCCESS;
+        if (results[1] == 0 || results[3] == 0) {
+            continue;
+        }
+        
+        const uint64_t ticks = ((results[2] & timestampMask) - (results[0] & timestampMask)) & timestampMask;
+        const double durationNs = static_cast<double>(ticks) * timestampPeriodNs;
+        clock.boundByReadback(collectNs, results[2]);
+        
+        const TimedDispatch& dispatch = slot.dispatches[index];
+        const float dispatchTimeMs = static_cast<float>(durationNs / 1e6);
+        Profiler::getInstance().recordGpuZone(dispatch.zone, clock.toSteadyNs(results[0]), static_cast<int64_t>(durationNs),
+                                              Profiler::GPU_COMPUTE_TRACK);
+        recordDispatchTime(dispatchTimeMs, dispatch.workgroupCount);
+        
+        critical = critical || dispatchTimeMs > config.criticalThresholdMs;
+        if (dispatch.capped && dispatch.workgroupCount > 0) {
+            cappedDispatchMs = std::max(cappedDispatchMs, dispatchTimeMs * recommendedMaxWorkgroups / dispatch.workgroupCount);
+        }
+    }
+    
+    if (slot.dispatchCount > 0) {
+        recentCritical = critical;
     }
+    if (cappedDispatchMs > 0.0f) {
+        updateChunkController(cappedDispatchMs);
+    }
+    slot.dispatchCount = 0;
+}
+
+void GPUTimeoutDetector::updateChunkController(float cappedDispatchMs) {
+    if (!config.enableAutoRecovery) return;
     
-    auto endTime = std::chrono::high_resolution_clock::now();
-    auto durationUs = std::chrono::duration_cast<std::chrono::microseconds>(endTime - dispatchStartTime);
-    float dispatchTimeMs = durationUs.count() / 1000.0f;
+    // Dispatch time scales with workgroup count, so in log2 space the error is the step to the budget
+    const float error = std::log2(config.targetDispatchMs / cappedDispatchMs);
+    const float previousCap = log2WorkgroupCap;
+    log2WorkgroupCap += config.integralGain * error +
+                        config.proportionalGain * (error - previousError) +
+                        config.derivativeGain * (error - 2.0f * previousError + olderError);
     
-    dispatchInProgress = false;
+    // Past the critical threshold the cap drops to the predicted fit at once instead of converging
+    if (cappedDispatchMs > config.criticalThresholdMs) {
+        log2WorkgroupCap = std::min(log2WorkgroupCap, previousCap + error);
+    }
     
-    // Check device status after dispatch
-    checkDeviceStatus();
+    // Clamping the output keeps the saturated side from winding up
+    log2WorkgroupCap = std::clamp(log2WorkgroupCap,
+                                  std::log2(static_cast<float>(MIN_WORKGROUPS_PER_CHUNK)),
+                                  std::log2(static_cast<float>(MAX_WORKGROUP_CAP)));
+    olderError = previousError;
+    previousError = error;
+    controllerSampled = true;
     
-    // Update statistics
-    updateStats(dispatchTimeMs, 0); // workgroupCount passed separately if needed
+    recommendedMaxWorkgroups = static_cast<uint32_t>(std::exp2(log2WorkgroupCap));
+    
+    // Only a halving or doubling since the last report is logged, so a settling controller stays quiet
+    if (recommendedMaxWorkgroups * 2 <= reportedMaxWorkgroups || recommendedMaxWorkgroups >= reportedMaxWorkgroups * 2) {
+        std::cout << "GPUTimeoutDetector: Capped dispatch " << cappedDispatchMs << "ms against a "
+                  << config.targetDispatchMs << "ms budget, max workgroups " << reportedMaxWorkgroups
+                  << " -> " << recommendedMaxWorkgroups << std::endl;
+        reportedMaxWorkgroups = recommendedMaxWorkgroups;
+    }
+}
+
+void GPUTimeoutDetector::recordDispatchTime(float dispatchTimeMs, uint32_t workgroupCount) {
+    updateStats(dispatchTimeMs, workgroupCount);
     
-    // Check thresholds and provide warnings
+    // Check thresholds; warnings are only counted, the controller's cap changes report them
     if (dispatchTimeMs > config.deviceLostThresholdMs) {
-        std::cerr << "GPUTimeoutDetector: CRITICAL - Dispatch time " << dispatchTimeMs 
+        std::cerr << "GPUTimeoutDetector: CRITICAL - Dispatch time " << dispatchTimeMs
                   << "ms exceeds device lost threshold (" << config.deviceLostThresholdMs << "ms)" << std::endl;
-        consecutiveWarnings = config.maxConsecutiveWarnings; // Force recovery
+        stats.criticalCount++;
     } else if (dispatchTimeMs > config.criticalThresholdMs) {
-        std::cerr << "GPUTimeoutDetector: CRITICAL - Dispatch time " << dispatchTimeMs 
+        std::cerr << "GPUTimeoutDetector: CRITICAL - Dispatch time " << dispatchTimeMs
                   << "ms exceeds critical threshold (" << config.criticalThresholdMs << "ms)" << std::endl;
         stats.criticalCount++;
-        consecutiveWarnings++;
     } else if (dispatchTimeMs > config.warningThresholdMs) {
-        std::cout << "GPUTimeoutDetector: WARNING - Dispatch time " << dispatchTimeMs 
-                  << "ms exceeds warning threshold (" << config.warningThresholdMs << "ms)" << std::endl;
         stats.warningCount++;
-        consecutiveWarnings++;
-    } else {
-        consecutiveWarnings = 0; // Reset on successful dispatch
-    }
-    
-    // Auto-recovery if enabled
-    if (config.enableAutoRecovery && consecutiveWarnings >= config.maxConsecutiveWarnings) {
-        // Reduce recommended max workgroups by 25%
-        recommendedMaxWorkgroups = static_cast<uint32_t>(recommendedMaxWorkgroups * 0.75f);
-        recommendedMaxWorkgroups = std::max(recommendedMaxWorkgroups, 256u); // Minimum viable size
-        
-        std::cout << "GPUTimeoutDetector: Auto-recovery activated - reducing max workgroups to " 
-                  << recommendedMaxWorkgroups << std::endl;
-        consecutiveWarnings = 0; // Reset after applying recovery
     }
 }
 
@@ -130,10 +241,9 @@ void GPUTimeoutDetector::updateStats(float dispatchTimeMs, uint32_t workgroupCou
     stats.peakDispatchTimeMs = std::max(stats.peakDispatchTimeMs, dispatchTimeMs);
     
     // Update rolling average
-    recentDispatchTimes.push_back(dispatchTimeMs);
-    if (recentDispatchTimes.size() > ROLLING_WINDOW_SIZE) {
-        recentDispatchTimes.erase(recentDispatchTimes.begin());
-    }
+    recentDispatchTimes[nextRecentDispatch] = dispatchTimeMs;
+    nextRecentDispatch = (nextRecentDispatch + 1) % ROLLING_WINDOW_SIZE;
+    recentDispatchCount = std::min(recentDispatchCount + 1, ROLLING_WINDOW_SIZE);
     
     stats.averageDispatchTimeMs = calculateMovingAverage();
     
@@ -145,65 +255,50 @@ void GPUTimeoutDetector::updateStats(float dispatchTimeMs, uint32_t workgroupCou
 }
 
 float GPUTimeoutDetector::calculateMovingAverage() const {
-    if (recentDispatchTimes.empty()) return 0.0f;
+    if (recentDispatchCount == 0) return 0.0f;
     
-    float sum = std::accumulate(recentDispatchTimes.begin(), recentDispatchTimes.end(), 0.0f);
-    return sum / recentDispatchTimes.size();
-}
-
-void GPUTimeoutDetector::checkDeviceStatus() {
-    if (!context) return;
-    
-    // Check if device is still responsive
-    VkResult result = context->getLoader().vkDeviceWaitIdle(context->getDevice());
-    lastDeviceStatus = result;
-    
-    if (result == VK_ERROR_DEVICE_LOST) {
-        std::cerr << "GPUTimeoutDetector: FATAL - VK_ERROR_DEVICE_LOST detected!" << std::endl;
-    } else if (result != VK_SUCCESS) {
-        std::cerr << "GPUTimeoutDetector: Device status error: " << result << std::endl;
-    }
+    float sum = std::accumulate(recentDispatchTimes.begin(), recentDispatchTimes.begin() + recentDispatchCount, 0.0f);
+    return sum / recentDispatchCount;
 }
 
 GPUTimeoutDetector::RecoveryRecommendation GPUTimeoutDetector::getRecoveryRecommendation() const {
     RecoveryRecommendation rec{};
     
-    // Check if we should reduce workload
-    if (consecutiveWarnings >= config.maxConsecutiveWarnings / 2 || 
-        stats.averageDispatchTimeMs > config.warningThresholdMs) {
+    // The cap only binds dispatches larger than it, so callers compare it with their own workgroup count
+    if (config.enableAutoRecovery && controllerSampled && recommendedMaxWorkgroups < MAX_WORKGROUP_CAP) {
         rec.shouldReduceWorkload = true;
         rec.recommendedMaxWorkgroups = recommendedMaxWorkgroups;
     }
     
-    // Check if we should split dispatches
-    if (stats.peakDispatchTimeMs > config.criticalThresholdMs) {
-        rec.shouldSplitDispatches = true;
-    }
-    
-    // Estimate safe dispatch time based on recent performance
-    if (stats.throughputEntitiesPerMs > 0.0f) {
-        // Target 75% of warning threshold for safety margin
-        float targetTimeMs = config.warningThresholdMs * 0.75f;
-        rec.estimatedSafeDispatchTimeMs = targetTimeMs;
-    }
+    // A recent dispatch came close to a device loss
+    rec.shouldSplitDispatches = recentCritical;
+    rec.estimatedSafeDispatchTimeMs = config.targetDispatchMs;
     
     return rec;
 }
 
 bool GPUTimeoutDetector::isGPUHealthy() const {
-    return lastDeviceStatus == VK_SUCCESS && 
-           consecutiveWarnings < config.maxConsecutiveWarnings &&
+    return lastDeviceStatus == VK_SUCCESS &&
            stats.averageDispatchTimeMs < config.criticalThresholdMs;
 }
 
 void GPUTimeoutDetector::resetStats() {
     stats = DispatchStats{};
-    recentDispatchTimes.clear();
-    consecutiveWarnings = 0;
-    recommendedMaxWorkgroups = UINT32_MAX;
+    recentDispatchCount = 0;
+    nextRecentDispatch = 0;
+    recentCritical = false;
+    
+    recommendedMaxWorkgroups = MAX_WORKGROUP_CAP;
+    reportedMaxWorkgroups = MAX_WORKGROUP_CAP;
+    log2WorkgroupCap = std::log2(static_cast<float>(MAX_WORKGROUP_CAP));
+    previousError = 0.0f;
+    olderError = 0.0f;
+    controllerSampled = false;
 }
 
 void GPUTimeoutDetector::cleanupBeforeContextDestruction() {
     // Reset RAII wrappers to prevent use-after-free
-    timestampQueryPool.reset();
-}
\ No newline at end of file
+    frameSlots.clear();
+    currentSlot = NO_SLOT;
+    dispatchInProgress = false;
+}
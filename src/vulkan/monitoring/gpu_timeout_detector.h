@@ -3,8 +3,12 @@
 #define VK_NO_PROTOTYPES
 #include <vulkan/vulkan.h>
 #include "../core/vulkan_raii.h"
-#include <chrono>
+#include "../core/gpu_clock_calibration.h"
+#include "../../ecs/utilities/profiler.h"
+#include <array>
+#include <cstdint>
 #include <memory>
+#include <vector>
 
 // Forward declarations
 class VulkanContext;
@@ -13,26 +17,49 @@ class VulkanSync;
 /**
  * GPU Timeout Detector - Monitors compute dispatch execution time
  * and provides early warning/recovery for potential VK_ERROR_DEVICE_LOST
+ *
+ * Dispatches are bracketed with GPU timestamps in a per-frame-slot query pool and named by Profiler zones
+ * interned once per call site, so recording allocates nothing. Results are read back without waiting when
+ * the frame graph opens the slot again, which is also where a lost device shows up.
+ *
+ * The recommended workgroup cap follows measured GPU time: each read-back frame, the slowest capped dispatch
+ * is scaled to the current cap and a PID controller moves log2(cap) toward targetDispatchMs. A fast GPU
+ * settles on a cap above its dispatches (nothing is split), a slow one on chunks that fit the budget.
  */
 class GPUTimeoutDetector {
 public:
     GPUTimeoutDetector(const VulkanContext* context, VulkanSync* sync);
     ~GPUTimeoutDetector();
-
+    
     // Configuration
     struct TimeoutConfig {
         float warningThresholdMs = 16.0f;    // Warn if dispatch takes >16ms
         float criticalThresholdMs = 50.0f;   // Critical if dispatch takes >50ms
         float deviceLostThresholdMs = 100.0f; // Likely device lost if >100ms
-        uint32_t maxConsecutiveWarnings = 3; // Auto-reduce workload after N warnings
-        bool enableAutoRecovery = true;      // Automatically reduce dispatch size
+        bool enableAutoRecovery = true;      // Steer the workgroup cap from measured GPU time
+        
+        // Chunk controller, on the error log2(targetDispatchMs / capped dispatch time scaled to the cap)
+        float targetDispatchMs = 8.0f;       // Per-dispatch GPU budget
+        float proportionalGain = 0.3f;
+        float integralGain = 0.5f;           // Per update; 1 would jump straight to the predicted cap
+        float derivativeGain = 0.05f;
     };
     
     void configure(const TimeoutConfig& config) { this->config = config; }
     
-    // Monitoring interface
-    void beginComputeDispatch(const char* dispatchName, uint32_t workgroupCount);
-    void endComputeDispatch();
+    // Reads the slot's previous dispatch timings and opens it for recording; call once the slot's fence has
+    // signalled and before anything records into it
+    void beginFrame(uint32_t frameIndex);
+    
+    // Monitoring interface: timestamps around the dispatches recorded between the calls. No-ops outside an
+    // open slot, without timestamp support, or once the slot's MAX_TIMED_DISPATCHES pairs are used.
+    // capped: the dispatch was sized by recommendedMaxWorkgroups, so its time steers the controller
+    void beginComputeDispatch(VkCommandBuffer commandBuffer, ProfileZoneId zone, uint32_t workgroupCount, bool capped = false);
+    void endComputeDispatch(VkCommandBuffer commandBuffer);
+    
+    // Dispatch time measured by the caller, e.g. submit to fence for a standalone test submission; feeds the
+    // statistics and thresholds, not the controller
+    void recordDispatchTime(float dispatchTimeMs, uint32_t workgroupCount);
     
     // Recovery recommendations
     struct RecoveryRecommendation {
@@ -65,32 +92,57 @@ public:
     void cleanupBeforeContextDestruction();
 
 private:
+    static constexpr uint32_t MAX_TIMED_DISPATCHES = 32;  // Timestamp pairs per frame slot
+    static constexpr uint32_t NO_SLOT = UINT32_MAX;
+    static constexpr uint32_t MAX_WORKGROUP_CAP = 65535;  // maxComputeWorkGroupCount[0] guaranteed by the spec
+    
+    struct TimedDispatch {
+        ProfileZoneId zone = 0;
+        uint32_t workgroupCount = 0;
+        bool capped = false;
+    };
+    
+    // One frame slot's query pool and the dispatches written into it by its last recording
+    struct FrameSlot {
+        vulkan_raii::QueryPool queryPool;
+        std::array<TimedDispatch, MAX_TIMED_DISPATCHES> dispatches{};
+        uint32_t dispatchCount = 0;
+    };
+    
     const VulkanContext* context;
     VulkanSync* sync;
     TimeoutConfig config{};
     
-    // Timing infrastructure
-    std::chrono::high_resolution_clock::time_point dispatchStartTime;
+    // GPU timestamp queries
+    std::vector<FrameSlot> frameSlots;
+    uint32_t currentSlot = NO_SLOT;
     bool dispatchInProgress = false;
-    
-    // GPU timestamp queries for precise measurement
-    vulkan_raii::QueryPool timestampQueryPool;
-    static constexpr uint32_t MAX_TIMESTAMP_QUERIES = 64;
-    uint32_t currentQueryIndex = 0;
+    bool synchronization2 = false;
+    float timestampPeriodNs = 1.0f;
+    uint64_t timestampMask = ~0ULL;
+    GpuClockCalibration clock;  // Dispatch zones onto the steady clock, on the GPU compute track
     
     // Statistics tracking
     DispatchStats stats{};
-    std::vector<float> recentDispatchTimes; // Rolling window of recent times
     static constexpr size_t ROLLING_WINDOW_SIZE = 30;
+    std::array<float, ROLLING_WINDOW_SIZE> recentDispatchTimes{}; // Ring of recent times
+    size_t recentDispatchCount = 0;
+    size_t nextRecentDispatch = 0;
     
     // Recovery state
-    uint32_t consecutiveWarnings = 0;
-    uint32_t recommendedMaxWorkgroups = UINT32_MAX;
+    uint32_t recommendedMaxWorkgroups = MAX_WORKGROUP_CAP;
+    uint32_t reportedMaxWorkgroups = MAX_WORKGROUP_CAP;
+    float log2WorkgroupCap = 0.0f;
+    float previousError = 0.0f;
+    float olderError = 0.0f;
+    bool controllerSampled = false;   // A capped dispatch has been measured since the last reset
+    bool recentCritical = false;      // The last read-back frame had a dispatch over criticalThresholdMs
     VkResult lastDeviceStatus = VK_SUCCESS;
     
     // Internal methods
-    bool createTimestampQueryPool();
+    bool createTimestampQueryPools();
+    void collectSlot(FrameSlot& slot);
+    void updateChunkController(float cappedDispatchMs);
     void updateStats(float dispatchTimeMs, uint32_t workgroupCount);
     float calculateMovingAverage() const;
-    void checkDeviceStatus();
-};
\ No newline at end of file
+};
@@ -0,0 +1,425 @@
+#include "metrics_exporter.h"
+
+#ifdef _WIN32
+#ifndef WIN32_LEAN_AND_MEAN
+#define WIN32_LEAN_AND_MEAN
+#endif
+#ifndef NOMINMAX
+#define NOMINMAX
+#endif
+#include <winsock2.h>
+#include <ws2tcpip.h>
+#else
+#include <arpa/inet.h>
+#include <netdb.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+#endif
+
+#include <algorithm>
+#include <cmath>
+#include <cstdio>
+#include <cstring>
+#include <iostream>
+
+namespace {
+#ifdef _WIN32
+    using NativeSocket = SOCKET;
+#else
+    using NativeSocket = int;
+#endif
+
+    // INVALID_SOCKET and -1 both map to -1
+    intptr_t toHandle(NativeSocket socket) { return static_cast<intptr_t>(socket); }
+    NativeSocket toNative(intptr_t handle) { return static_cast<NativeSocket>(handle); }
+    
+    // Largest StatsD datagram, below a typical path MTU so no push fragments
+    constexpr size_t STATSD_DATAGRAM_BYTES = 1400;
+    
+    // How long the listener waits for a scrape before checking for stop()
+    constexpr long ACCEPT_POLL_MS = 100;
+    
+    void closeSocket(intptr_t handle) {
+#ifdef _WIN32
+        closesocket(toNative(handle));
+#else
+        close(toNative(handle));
+#endif
+    }
+    
+    void copyName(std::array<char, MetricsRegistry::MAX_NAME_LENGTH>& destination, const char* source) {
+        std::snprintf(destination.data(), destination.size(), "%s", source ? source : "");
+    }
+    
+    // StatsD uses ':', '|' and '@' as separators and '.' as the hierarchy; a label value may contain any of them
+    void appendStatsDName(std::string& out, const char* text) {
+        for (const char* c = text; *c; ++c) {
+            out += (*c == ':' || *c == '|' || *c == '@' || *c == '.' || *c == ' ') ? '_' : *c;
+        }
+    }
+    
+    // Shortest round-tripping form is not needed; six significant digits cover every figure published
+    void appendValue(std::string& out, double value) {
+        char text[32];
+        if (std::isnan(value)) {
+            std::snprintf(text, sizeof(text), "NaN");
+        } else {
+            std::snprintf(text, sizeof(text), "%.6g", value);
+        }
+        out += text;
+    }
+}
+
+MetricsRegistry::MetricId MetricsRegistry::registerMetric(const char* name, Type type, const char* labelName, const char* labelValue) {
+    const char* label = labelName ? labelName : "";
+    const char* value = labelValue ? labelValue : "";
+    const uint32_t count = published.load(std::memory_order_relaxed);
+    for (uint32_t id = 0; id < count; ++id) {
+        const Slot& slot = slots[id];
+        if (std::strncmp(slot.name.data(), name, MAX_NAME_LENGTH - 1) == 0 &&
+            std::strncmp(slot.labelName.data(), label, MAX_NAME_LENGTH - 1) == 0 &&
+            std::strncmp(slot.labelValue.data(), value, MAX_NAME_LENGTH - 1) == 0) {
+            return id;
+        }
+    }
+    if (count >= slots.size()) {
+        ++droppedRegistrations;
+        return INVALID_METRIC;
+    }
+    
+    Slot& slot = slots[count];
+    copyName(slot.name, name);
+    copyName(slot.labelName, label);
+    copyName(slot.labelValue, value);
+    slot.type = type;
+    slot.value.store(0, std::memory_order_relaxed);
+    published.store(count + 1, std::memory_order_release);
+    return count;
+}
+
+MetricsExporter::~MetricsExporter() {
+    stop();
+}
+
+bool MetricsExporter::start(const MetricsExportOptions& exportOptions) {
+    if (running) {
+        return true;
+    }
+    options = exportOptions;
+    if (options.httpPort == 0 && options.statsdHost.empty()) {
+        return false;
+    }
+
+#ifdef _WIN32
+    WSADATA wsaData;
+    if (WSAStartup(MAKEWORD(2, 2), &wsaData) != 0) {
+        std::cerr << "MetricsExporter: WSAStartup failed" << std::endl;
+        return false;
+    }
+    socketsInitialized = true;
+#endif
+
+    if (options.httpPort != 0) {
+        listenSocket = toHandle(socket(AF_INET, SOCK_STREAM, IPPROTO_TCP));
+        if (listenSocket != INVALID_SOCKET_HANDLE) {
+            // A restarted process rebinds while the last one's connections linger in TIME_WAIT
+            int reuse = 1;
+            setsockopt(toNative(listenSocket), SOL_SOCKET, SO_REUSEADDR, reinterpret_cast<const char*>(&reuse), sizeof(reuse));
+            
+            sockaddr_in address{};
+            address.sin_family = AF_INET;
+            address.sin_addr.s_addr = htonl(INADDR_ANY);
+            address.sin_port = htons(options.httpPort);
+            if (bind(toNative(listenSocket), reinterpret_cast<const sockaddr*>(&address), sizeof(address)) != 0 ||
+                listen(toNative(listenSocket), 4) != 0) {
+                closeSocket(listenSocket);
+                listenSocket = INVALID_SOCKET_HANDLE;
+            }
+        }
+        if (listenSocket == INVALID_SOCKET_HANDLE) {
+            std::cerr << "MetricsExporter: Failed to listen on port " << options.httpPort << std::endl;
+            closeSockets();
+            return false;
+        }
+    }
+    
+    if (!options.statsdHost.empty()) {
+        addrinfo hints{};
+        hints.ai_family = AF_INET;
+        hints.ai_socktype = SOCK_DGRAM;
+        addrinfo* resolved = nullptr;
+        const std::string port = std::to_string(options.statsdPort);
+        if (getaddrinfo(options.statsdHost.c_str(), port.c_str(), &hints, &resolved) == 0 && resolved) {
+            statsdSocket = toHandle(socket(resolved->ai_family, resolved->ai_socktype, resolved->ai_protocol));
+            // Connected, so every push is a plain send() to the resolved address
+            if (statsdSocket != INVALID_SOCKET_HANDLE &&
+                connect(toNative(statsdSocket), resolved->ai_addr, static_cast<int>(resolved->ai_addrlen)) != 0) {
+                closeSocket(statsdSocket);
+                statsdSocket = INVALID_SOCKET_HANDLE;
+            }
+            freeaddrinfo(resolved);
+        }
+        if (statsdSocket == INVALID_SOCKET_HANDLE) {
+            std::cerr << "MetricsExporter: Failed to reach StatsD at " << options.statsdHost << ":" << options.statsdPort << std::endl;
+            closeSockets();
+            return false;
+        }
+    }
+    
+    lastCounterValues.assign(METRICS_REGISTRY_CAPACITY, 0.0);
+    datagram.reserve(STATSD_DATAGRAM_BYTES);
+    stopping = false;
+    running = true;
+    exporter = std::thread([this] { exportLoop(); });
+    
+    std::cout << "MetricsExporter: ";
+    if (listenSocket != INVALID_SOCKET_HANDLE) {
+        std::cout << "serving http://0.0.0.0:" << options.httpPort << "/metrics";
+    }
+    if (statsdSocket != INVALID_SOCKET_HANDLE) {
+        std::cout << (listenSocket != INVALID_SOCKET_HANDLE ? ", " : "") << "pushing StatsD to "
+                  << options.statsdHost << ":" << options.statsdPort << " every " << options.statsdIntervalMs << "ms";
+    }
+    std::cout << std::endl;
+    return true;
+}
+
+void MetricsExporter::stop() {
+    if (!running) {
+        return;
+    }
+    {
+        std::lock_guard<std::mutex> lock(wakeMutex);
+        stopping = true;
+    }
+    wake.notify_one();
+    if (exporter.joinable()) {
+        exporter.join();
+    }
+    running = false;
+    closeSockets();
+    
+    const Telemetry telemetry = getTelemetry();
+    std::cout << "MetricsExporter: Stopped after " << telemetry.scrapesServed << " scrapes, "
+              << telemetry.datagramsSent << " StatsD datagrams (" << telemetry.sendFailures << " failed), "
+              << registry.size() << " metrics";
+    if (registry.getDroppedRegistrations() > 0) {
+        std::cout << ", " << registry.getDroppedRegistrations() << " registrations past METRICS_REGISTRY_CAPACITY dropped";
+    }
+    std::cout << std::endl;
+}
+
+void MetricsExporter::closeSockets() {
+    if (listenSocket != INVALID_SOCKET_HANDLE) {
+        closeSocket(listenSocket);
+        listenSocket = INVALID_SOCKET_HANDLE;
+    }
+    if (statsdSocket != INVALID_SOCKET_HANDLE) {
+        closeSocket(statsdSocket);
+        statsdSocket = INVALID_SOCKET_HANDLE;
+    }
+#ifdef _WIN32
+    if (socketsInitialized) {
+        WSACleanup();
+    }
+#endif
+    socketsInitialized = false;
+}
+
+MetricsExporter::Telemetry MetricsExporter::getTelemetry() const {
+    Telemetry telemetry;
+    telemetry.scrapesServed = scrapesServed.load(std::memory_order_relaxed);
+    telemetry.datagramsSent = datagramsSent.load(std::memory_order_relaxed);
+    telemetry.sendFailures = sendFailures.load(std::memory_order_relaxed);
+    return telemetry;
+}
+
+void MetricsExporter::exportLoop() {
+    const auto pushInterval = std::chrono::milliseconds(std::max(1u, options.statsdIntervalMs));
+    auto nextPush = std::chrono::steady_clock::now() + pushInterval;
+    
+    std::unique_lock<std::mutex> lock(wakeMutex);
+    while (!stopping) {
+        if (statsdSocket != INVALID_SOCKET_HANDLE && std::chrono::steady_clock::now() >= nextPush) {
+            lock.unlock();
+            pushStatsD();
+            lock.lock();
+            // Skip pushes missed while suspended rather than bursting them
+            nextPush = std::max(nextPush + pushInterval, std::chrono::steady_clock::now());
+        }
+        
+        if (listenSocket == INVALID_SOCKET_HANDLE) {
+            wake.wait_until(lock, nextPush, [this] { return stopping; });
+            continue;
+        }
+        
+        // The listener polls, so stop() is seen within ACCEPT_POLL_MS even with no scraper around
+        lock.unlock();
+        fd_set readable;
+        FD_ZERO(&readable);
+        FD_SET(toNative(listenSocket), &readable);
+        timeval timeout{};
+        timeout.tv_usec = ACCEPT_POLL_MS * 1000;
+        if (select(static_cast<int>(listenSocket + 1), &readable, nullptr, nullptr, &timeout) > 0) {
+            serveScrape();
+        }
+        lock.lock();
+    }
+}
+
+void MetricsExporter::serveScrape() {
+    const SocketHandle clientSocket = toHandle(accept(toNative(listenSocket), nullptr, nullptr));
+    if (clientSocket == INVALID_SOCKET_HANDLE) {
+        return;
+    }
+    const NativeSocket client = toNative(clientSocket);
+    
+    // Scrapers send the whole request line at once; a client that sends nothing in time is dropped
+#ifdef _WIN32
+    DWORD receiveTimeout = 500;
+#else
+    timeval receiveTimeout{};
+    receiveTimeout.tv_usec = 500 * 1000;
+#endif
+    setsockopt(client, SOL_SOCKET, SO_RCVTIMEO, reinterpret_cast<const char*>(&receiveTimeout), sizeof(receiveTimeout));
+    
+    char request[1024];
+    const auto received = recv(client, request, sizeof(request) - 1, 0);
+    if (received <= 0) {
+        closeSocket(clientSocket);
+        return;
+    }
+    request[received] = '\0';
+    
+    std::string body;
+    const char* status = "200 OK";
+    if (std::strncmp(request, "GET /metrics", 12) == 0 && (request[12] == ' ' || request[12] == '?')) {
+        body = formatPrometheus();
+        scrapesServed.fetch_add(1, std::memory_order_relaxed);
+    } else {
+        status = "404 Not Found";
+        body = "Metrics are served on /metrics\n";
+    }
+    
+    std::string response = "HTTP/1.1 ";
+    response += status;
+    response += "\r\nContent-Type: text/plain; version=0.0.4\r\nConnection: close\r\nContent-Length: ";
+    response += std::to_string(body.size());
+    response += "\r\n\r\n";
+    response += body;
+    
+    size_t sent = 0;
+    while (sent < response.size()) {
+        const auto written = send(client, response.data() + sent, static_cast<int>(response.size() - sent), 0);
+        if (written <= 0) {
+            break;
+        }
+        sent += static_cast<size_t>(written);
+    }
+    closeSocket(clientSocket);
+}
+
+std::string MetricsExporter::formatPrometheus() const {
+    // Samples of one metric name go together under a single TYPE line, while the registry keeps registration
+    // order, so group them by name first
+    struct Entry {
+        uint32_t id;
+        MetricsRegistry::Sample sample;
+    };
+    std::vector<Entry> entries;
+    entries.reserve(registry.size());
+    registry.forEach([&](uint32_t id, const MetricsRegistry::Sample& sample) {
+        entries.push_back({id, sample});
+    });
+    std::stable_sort(entries.begin(), entries.end(), [](const Entry& a, const Entry& b) {
+        return std::strcmp(a.sample.name, b.sample.name) < 0;
+    });
+    
+    std::string out;
+    out.reserve(entries.size() * 64);
+    const char* previousName = "";
+    for (const Entry& entry : entries) {
+        const MetricsRegistry::Sample& sample = entry.sample;
+        if (std::strcmp(sample.name, previousName) != 0) {
+            out += "# TYPE ";
+            out += options.prefix;
+            out += '_';
+            out += sample.name;
+            out += sample.type == MetricsRegistry::Type::Counter ? " counter\n" : " gauge\n";
+            previousName = sample.name;
+        }
+        out += options.prefix;
+        out += '_';
+        out += sample.name;
+        if (sample.labelName[0] != '\0') {
+            out += '{';
+            out += sample.labelName;
+            out += "=\"";
+            for (const char* c = sample.labelValue; *c; ++c) {
+                if (*c == '"' || *c == '\\') {
+                    out += '\\';
+                }
+                out += *c;
+            }
+            out += "\"}";
+        }
+        out += ' ';
+        appendValue(out, sample.value);
+        out += '\n';
+    }
+    return out;
+}
+
+void MetricsExporter::pushStatsD() {
+    // Lines are packed into datagrams up to STATSD_DATAGRAM_BYTES, newline separated as StatsD accepts them
+    datagram.clear();
+    std::string line;
+    const auto flush = [this]() {
+        if (datagram.empty()) {
+            return;
+        }
+        const auto written = send(toNative(statsdSocket), datagram.data(), static_cast<int>(datagram.size()), 0);
+        if (written < 0) {
+            sendFailures.fetch_add(1, std::memory_order_relaxed);
+        } else {
+            datagramsSent.fetch_add(1, std::memory_order_relaxed);
+        }
+        datagram.clear();
+    };
+    
+    registry.forEach([&](uint32_t id, const MetricsRegistry::Sample& sample) {
+        double value = sample.value;
+        if (sample.type == MetricsRegistry::Type::Counter) {
+            // A counter that went backwards was reset (device rebuild); its new total is the increase
+            const double previous = lastCounterValues[id];
+            lastCounterValues[id] = value;
+            value = value >= previous ? value - previous : value;
+            if (value == 0.0) {
+                return;
+            }
+        }
+        
+        line.clear();
+        line += options.prefix;
+        line += '.';
+        line += sample.name;
+        if (sample.labelValue[0] != '\0') {
+            line += '.';
+            appendStatsDName(line, sample.labelValue);
+        }
+        line += ':';
+        appendValue(line, value);
+        line += sample.type == MetricsRegistry::Type::Counter ? "|c" : "|g";
+        
+        if (!datagram.empty() && datagram.size() + 1 + line.size() > STATSD_DATAGRAM_BYTES) {
+            flush();
+        }
+        if (!datagram.empty()) {
+            datagram += '\n';
+        }
+        datagram += line;
+    });
+    flush();
+}
@@ -0,0 +1,150 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "../core/vulkan_constants.h"
+
+/**
+ * Fixed-size metric registry shared between the thread that publishes telemetry and the exporter thread. Slots
+ * are registered and written by the publisher only; a slot is filled before the count that makes it visible is
+ * released, so readers never lock and never see a half-written name. Values are doubles stored as atomic bits
+ */
+class MetricsRegistry {
+public:
+    enum class Type : uint8_t {
+        Gauge,
+        Counter,  // Monotonic total; StatsD gets the increase since the previous push
+    };
+    
+    using MetricId = uint32_t;
+    static constexpr MetricId INVALID_METRIC = UINT32_MAX;
+    static constexpr size_t MAX_NAME_LENGTH = 64;
+    
+    // Publisher thread. The same name and label return the same slot; INVALID_METRIC once the registry is full.
+    // A label is one name="value" pair, e.g. the frame graph node a timing belongs to
+    MetricId registerMetric(const char* name, Type type, const char* labelName = nullptr, const char* labelValue = nullptr);
+    
+    // Publisher thread; ignores INVALID_METRIC
+    void set(MetricId id, double value) {
+        if (id < published.load(std::memory_order_relaxed)) {
+            slots[id].value.store(std::bit_cast<uint64_t>(value), std::memory_order_relaxed);
+        }
+    }
+    
+    struct Sample {
+        const char* name;
+        const char* labelName;   // Empty without a label
+        const char* labelValue;
+        Type type;
+        double value;
+    };
+    
+    // Any thread: every metric registered before the call, in registration order
+    template<typename Visitor>
+    void forEach(Visitor&& visit) const {
+        const uint32_t count = published.load(std::memory_order_acquire);
+        for (uint32_t id = 0; id < count; ++id) {
+            const Slot& slot = slots[id];
+            visit(id, Sample{slot.name.data(), slot.labelName.data(), slot.labelValue.data(), slot.type,
+                             std::bit_cast<double>(slot.value.load(std::memory_order_relaxed))});
+        }
+    }
+    
+    uint32_t size() const { return published.load(std::memory_order_acquire); }
+    uint64_t getDroppedRegistrations() const { return droppedRegistrations; }
+
+private:
+    struct Slot {
+        std::array<char, MAX_NAME_LENGTH> name{};
+        std::array<char, MAX_NAME_LENGTH> labelName{};
+        std::array<char, MAX_NAME_LENGTH> labelValue{};
+        Type type = Type::Gauge;
+        std::atomic<uint64_t> value{0};
+    };
+    
+    std::array<Slot, METRICS_REGISTRY_CAPACITY> slots;
+    std::atomic<uint32_t> published{0};
+    uint64_t droppedRegistrations = 0;  // Publisher thread only
+};
+
+// Where MetricsExporter sends the registry; either or both
+struct MetricsExportOptions {
+    uint16_t httpPort = 0;            // Prometheus text exposition on GET /metrics, all interfaces (0 = off)
+    std::string statsdHost;           // UDP StatsD push target (empty = off)
+    uint16_t statsdPort = METRICS_STATSD_DEFAULT_PORT;
+    uint32_t statsdIntervalMs = METRICS_STATSD_INTERVAL_MS;
+    std::string prefix = "fractalia"; // Prometheus "prefix_name", StatsD "prefix.name"
+};
+
+/**
+ * Serves a MetricsRegistry to external monitoring from one background thread: answers Prometheus scrapes on a
+ * tiny blocking HTTP listener and/or pushes StatsD datagrams every statsdIntervalMs. Never touches the
+ * publisher beyond reading the registry, so a slow scraper cannot stall a frame
+ */
+class MetricsExporter {
+public:
+    MetricsExporter() = default;
+    ~MetricsExporter();
+    
+    MetricsExporter(const MetricsExporter&) = delete;
+    MetricsExporter& operator=(const MetricsExporter&) = delete;
+    
+    // Opens the sockets and starts the thread; false (and nothing running) when a socket cannot be set up
+    bool start(const MetricsExportOptions& options);
+    
+    // Joins the thread, closes the sockets and reports the totals
+    void stop();
+    
+    bool isRunning() const { return running; }
+    MetricsRegistry& getRegistry() { return registry; }
+    const MetricsRegistry& getRegistry() const { return registry; }
+    
+    // Prometheus text exposition format (0.0.4) of the registry's current values
+    std::string formatPrometheus() const;
+    
+    struct Telemetry {
+        uint64_t scrapesServed = 0;
+        uint64_t datagramsSent = 0;
+        uint64_t sendFailures = 0;
+    };
+    Telemetry getTelemetry() const;
+
+private:
+    // Platform socket handle (SOCKET on Windows, a file descriptor elsewhere)
+    using SocketHandle = intptr_t;
+    static constexpr SocketHandle INVALID_SOCKET_HANDLE = -1;
+    
+    void exportLoop();
+    void serveScrape();
+    void pushStatsD();
+    void closeSockets();
+    
+    MetricsRegistry registry;
+    MetricsExportOptions options;
+    bool running = false;
+    bool socketsInitialized = false;  // WSAStartup succeeded (Windows)
+    
+    SocketHandle listenSocket = INVALID_SOCKET_HANDLE;
+    SocketHandle statsdSocket = INVALID_SOCKET_HANDLE;
+    
+    std::thread exporter;
+    std::mutex wakeMutex;
+    std::condition_variable wake;
+    bool stopping = false;
+    
+    // Exporter thread only
+    std::vector<double> lastCounterValues;  // By metric ID, for StatsD counter deltas
+    std::string datagram;
+    
+    std::atomic<uint64_t> scrapesServed{0};
+    std::atomic<uint64_t> datagramsSent{0};
+    std::atomic<uint64_t> sendFailures{0};
+};
@@ -0,0 +1,139 @@
+#include "overdraw_monitor.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../resources/core/resource_coordinator.h"
+#include "../../ecs/utilities/logger.h"
+#include <algorithm>
+#include <cstring>
+
+bool OverdrawMonitor::initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator) {
+    this->context = &context;
+    slotCount = std::min(context.getFramesInFlight(), MAX_FRAMES_IN_FLIGHT);
+    
+    // Binding 0: the count image, added to by the entity pass and read by the reduction and the heat map;
+    // binding 1: the slot's results
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    bindings[0].binding = 0;
+    bindings[0].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+    bindings[0].descriptorCount = 1;
+    bindings[0].stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT | VK_SHADER_STAGE_COMPUTE_BIT;
+    bindings[1].binding = 1;
+    bindings[1].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+    bindings[1].descriptorCount = 1;
+    bindings[1].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    
+    const auto& vk = context.getLoader();
+    const VkDevice device = context.getDevice();
+    VkDescriptorSetLayout layoutHandle = VK_NULL_HANDLE;
+    if (vk.vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &layoutHandle) != VK_SUCCESS) {
+        LOG_ERROR("OverdrawMonitor: Failed to create overdraw descriptor set layout");
+        return false;
+    }
+    descriptorSetLayout = vulkan_raii::make_descriptor_set_layout(layoutHandle, &context);
+    
+    const std::array<VkDescriptorPoolSize, 2> poolSizes = {{
+        {VK_DESCRIPTOR_TYPE_STORAGE_IMAGE, MAX_FRAMES_IN_FLIGHT},
+        {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, MAX_FRAMES_IN_FLIGHT},
+    }};
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
+    poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
+    poolInfo.pPoolSizes = poolSizes.data();
+    VkDescriptorPool poolHandle = VK_NULL_HANDLE;
+    if (vk.vkCreateDescriptorPool(device, &poolInfo, nullptr, &poolHandle) != VK_SUCCESS) {
+        LOG_ERROR("OverdrawMonitor: Failed to create overdraw descriptor pool");
+        return false;
+    }
+    descriptorPool = vulkan_raii::make_descriptor_pool(poolHandle, &context);
+    
+    std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> layouts;
+    layouts.fill(layoutHandle);
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> sets{};
+    VkDescriptorSetAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = poolHandle;
+    allocateInfo.descriptorSetCount = slotCount;
+    allocateInfo.pSetLayouts = layouts.data();
+    if (vk.vkAllocateDescriptorSets(device, &allocateInfo, sets.data()) != VK_SUCCESS) {
+        LOG_ERROR("OverdrawMonitor: Failed to allocate overdraw descriptor sets");
+        return false;
+    }
+    
+    // The results stay bound for good; the count image is bound on the slot's first count
+    for (uint32_t index = 0; index < slotCount; ++index) {
+        Slot& slot = slots[index];
+        slot.descriptorSet = sets[index];
+        slot.results = resourceCoordinator->createMappedBuffer(sizeof(Results), VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+        if (!slot.results.isValid() || !slot.results.mappedData) {
+            LOG_ERROR("OverdrawMonitor: Failed to create results buffer " << index);
+            return false;
+        }
+        std::memset(slot.results.mappedData, 0, sizeof(Results));
+        
+        const VkDescriptorBufferInfo bufferInfo{slot.results.buffer.get(), 0, sizeof(Results)};
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = slot.descriptorSet;
+        write.dstBinding = 1;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        write.pBufferInfo = &bufferInfo;
+        vk.vkUpdateDescriptorSets(device, 1, &write, 0, nullptr);
+    }
+    return true;
+}
+
+void OverdrawMonitor::beginFrame(uint32_t frameIndex) {
+    if (frameIndex >= slotCount) {
+        return;
+    }
+    Slot& slot = slots[frameIndex];
+    slot.counted = false;
+    
+    // Zeroed after every read, so pixels is only set when the slot's last frame was reduced and submitted
+    auto* results = static_cast<Results*>(slot.results.mappedData);
+    if (results->pixels > 0) {
+        stats.valid = true;
+        stats.pixels = results->pixels;
+        stats.coveredPixels = results->coveredPixels;
+        stats.fragments = (static_cast<uint64_t>(results->fragmentsHigh) << 32) | results->fragmentsLow;
+        stats.maxFragments = results->maxFragments;
+        std::copy(std::begin(results->histogram), std::end(results->histogram), stats.histogram.begin());
+    }
+    std::memset(results, 0, sizeof(Results));
+}
+
+VkDescriptorSet OverdrawMonitor::prepareCount(uint32_t frameIndex, VkImageView countImage) {
+    if (frameIndex >= slotCount || countImage == VK_NULL_HANDLE) {
+        return VK_NULL_HANDLE;
+    }
+    Slot& slot = slots[frameIndex];
+    
+    // The slot's last frame has finished, so its set is free to rewrite
+    if (slot.boundImage != countImage) {
+        const VkDescriptorImageInfo imageInfo{VK_NULL_HANDLE, countImage, VK_IMAGE_LAYOUT_GENERAL};
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = slot.descriptorSet;
+        write.dstBinding = 0;
+        write.descriptorCount = 1;
+        write.descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_IMAGE;
+        write.pImageInfo = &imageInfo;
+        context->getLoader().vkUpdateDescriptorSets(context->getDevice(), 1, &write, 0, nullptr);
+        slot.boundImage = countImage;
+    }
+    slot.counted = true;
+    return slot.descriptorSet;
+}
+
+void OverdrawMonitor::invalidateCountImage() {
+    for (Slot& slot : slots) {
+        slot.boundImage = VK_NULL_HANDLE;
+    }
+    ++bindingGeneration;
+}
@@ -0,0 +1,92 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../core/vulkan_raii.h"
+#include "../core/vulkan_constants.h"
+#include "../resources/core/resource_handle.h"
+#include <array>
+#include <cstdint>
+
+// Forward declarations
+class VulkanContext;
+class ResourceCoordinator;
+
+/**
+ * Overdraw diagnostic (F9) figures. While it is on, EntityGraphicsNode counts every shaded fragment into the
+ * swapchain's overdraw count image (fragment.overdraw.frag) and OverdrawNode reduces the image with
+ * overdraw_histogram.comp into the frame slot's host-visible results. beginFrame() reads them once the slot's
+ * frame wait has returned, so the figures trail the frame by the frames in flight and nothing waits.
+ *
+ * Owns the descriptor set layout both passes bind (binding 0: the count image, binding 1: the results) and one
+ * set and results buffer per frame slot. VulkanRenderer owns it beside the memory monitor.
+ */
+class OverdrawMonitor {
+public:
+    OverdrawMonitor() = default;
+    ~OverdrawMonitor() = default;
+    OverdrawMonitor(const OverdrawMonitor&) = delete;
+    OverdrawMonitor& operator=(const OverdrawMonitor&) = delete;
+    
+    bool initialize(const VulkanContext& context, ResourceCoordinator* resourceCoordinator);
+    
+    // After the frame slot's wait, before the frame is recorded: takes the slot's reduced figures and zeroes them
+    void beginFrame(uint32_t frameIndex);
+    
+    // Entity pass: binds the count image into the slot's set and marks the slot counted this frame
+    VkDescriptorSet prepareCount(uint32_t frameIndex, VkImageView countImage);
+    // OverdrawNode: whether the entity pass counted into the slot this frame, and the set to reduce it with
+    bool isCounted(uint32_t frameIndex) const { return frameIndex < slotCount && slots[frameIndex].counted; }
+    VkDescriptorSet getDescriptorSet(uint32_t frameIndex) const {
+        return frameIndex < slotCount ? slots[frameIndex].descriptorSet : VK_NULL_HANDLE;
+    }
+    VkDescriptorSetLayout getDescriptorSetLayout() const { return descriptorSetLayout.get(); }
+    
+    // Swapchain recreation destroyed the count image: every set is rebound on its next count. The generation
+    // keys the recordings that bind the sets
+    void invalidateCountImage();
+    uint64_t getBindingGeneration() const { return bindingGeneration; }
+    
+    struct Stats {
+        bool valid = false;                 // A counted frame has been read back since the last reset
+        uint32_t pixels = 0;                // Render extent
+        uint32_t coveredPixels = 0;         // Shaded at least once
+        uint64_t fragments = 0;
+        uint32_t maxFragments = 0;          // Most fragments shaded at one pixel
+        std::array<uint32_t, OVERDRAW_HISTOGRAM_BINS> histogram{};  // Pixels per log2 bin, bin 0 uncovered
+        
+        // Fragments per covered pixel: 1 is no overdraw
+        float averageOverdraw() const {
+            return coveredPixels > 0 ? static_cast<float>(static_cast<double>(fragments) / coveredPixels) : 0.0f;
+        }
+    };
+    const Stats& getStats() const { return stats; }
+    void resetStats() { stats = Stats{}; }
+
+private:
+    // Must match OverdrawResults in overdraw_histogram.comp
+    struct Results {
+        uint32_t pixels;
+        uint32_t coveredPixels;
+        uint32_t fragmentsLow;
+        uint32_t fragmentsHigh;
+        uint32_t maxFragments;
+        uint32_t padding[3];
+        uint32_t histogram[OVERDRAW_HISTOGRAM_BINS];
+    };
+    
+    struct Slot {
+        ResourceHandle results;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;
+        VkImageView boundImage = VK_NULL_HANDLE;
+        bool counted = false;
+    };
+    
+    const VulkanContext* context = nullptr;
+    vulkan_raii::DescriptorSetLayout descriptorSetLayout;
+    vulkan_raii::DescriptorPool descriptorPool;
+    std::array<Slot, MAX_FRAMES_IN_FLIGHT> slots;
+    uint32_t slotCount = 0;
+    uint64_t bindingGeneration = 0;
+    Stats stats;
+};
@@ -0,0 +1,297 @@
+#include "debug_overlay_node.h"
+#include "../pipelines/graphics_pipeline_manager.h"
+#include "../pipelines/descriptor_layout_manager.h"
+#include "../core/vulkan_swapchain.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../resources/core/resource_coordinator.h"
+#include "../../ecs/gpu/gpu_entity_manager.h"
+#include "../../ecs/utilities/logger.h"
+#include <cstring>
+#include <stdexcept>
+
+DebugOverlayNode::DebugOverlayNode(
+    FrameGraphTypes::ResourceId velocityBuffer,
+    FrameGraphTypes::ResourceId positionBuffer,
+    FrameGraphTypes::ResourceId spatialMapBuffer,
+    FrameGraphTypes::ResourceId colorTarget,
+    GraphicsPipelineManager* graphicsManager,
+    VulkanSwapchain* swapchain,
+    ResourceCoordinator* resourceCoordinator,
+    GPUEntityManager* gpuEntityManager
+) : velocityBufferId(velocityBuffer)
+  , positionBufferId(positionBuffer)
+  , spatialMapBufferId(spatialMapBuffer)
+  , colorTargetId(colorTarget)
+  , graphicsManager(graphicsManager)
+  , swapchain(swapchain)
+  , resourceCoordinator(resourceCoordinator)
+  , gpuEntityManager(gpuEntityManager) {
+  
+    // Validate dependencies during construction for fail-fast behavior
+    if (!graphicsManager) {
+        throw std::invalid_argument("DebugOverlayNode: graphicsManager cannot be null");
+    }
+    if (!swapchain) {
+        throw std::invalid_argument("DebugOverlayNode: swapchain cannot be null");
+    }
+    if (!resourceCoordinator) {
+        throw std::invalid_argument("DebugOverlayNode: resourceCoordinator cannot be null");
+    }
+    if (!gpuEntityManager) {
+        throw std::invalid_argument("DebugOverlayNode: gpuEntityManager cannot be null");
+    }
+}
+
+std::vector<ResourceDependency> DebugOverlayNode::getInputs() const {
+    return {
+        {velocityBufferId, ResourceAccess::Read, PipelineStage::VertexShader},
+        {positionBufferId, ResourceAccess::Read, PipelineStage::VertexShader},
+        {spatialMapBufferId, ResourceAccess::Read, PipelineStage::VertexShader},
+    };
+}
+
+std::vector<ResourceDependency> DebugOverlayNode::getOutputs() const {
+    return {
+        {currentSwapchainImageId, ResourceAccess::Write, PipelineStage::ColorAttachment},
+    };
+}
+
+void DebugOverlayNode::setViewportCameras(const std::vector<ViewportCamera>& cameras, uint64_t version) {
+    if (version == viewportCameraVersion) {
+        return;
+    }
+    viewportCameraVersion = version;
+    viewportCameras = cameras;
+}
+
+void DebugOverlayNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    // prepareFrame() already reported why this frame cannot draw
+    if (!frameResolved) {
+        return;
+    }
+    
+    const VulkanContext* context = frameGraph.getContext();
+    if (!context) {
+        LOG_ERROR("DebugOverlayNode: Missing Vulkan context");
+        return;
+    }
+    const auto& vk = context->getLoader();
+    
+    recordLayoutTransition(commandBuffer, vk, true);
+    
+    // The entity pass's image is drawn over, not cleared
+    VkRenderingAttachmentInfoKHR colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    colorAttachment.imageView = resolvedView;
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    
+    VkRenderingInfoKHR renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.renderArea.offset = {0, 0};
+    renderingInfo.renderArea.extent = resolvedExtent;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+    vk.vkCmdBeginRenderingKHR(commandBuffer, &renderingInfo);
+    
+    const VkDeviceSize offset = 0;
+    const VkBuffer entityStreams[] = {resolvedPositionBuffer, resolvedVelocityBuffer};
+    const VkDeviceSize entityOffsets[] = {0, 0};
+    
+    for (const ViewportCamera& camera : viewportCameras) {
+        // A view without a camera has nothing to line the overlay up with
+        if (camera.viewProjection == glm::mat4(0.0f)) {
+            continue;
+        }
+        
+        VkRect2D rect{};
+        rect.offset.x = static_cast<int32_t>(camera.rect.x * resolvedExtent.width);
+        rect.offset.y = static_cast<int32_t>(camera.rect.y * resolvedExtent.height);
+        rect.extent.width = static_cast<uint32_t>(camera.rect.z * resolvedExtent.width);
+        rect.extent.height = static_cast<uint32_t>(camera.rect.w * resolvedExtent.height);
+        if (rect.extent.width == 0 || rect.extent.height == 0) {
+            continue;
+        }
+        
+        VkViewport viewport{};
+        viewport.x = static_cast<float>(rect.offset.x);
+        viewport.y = static_cast<float>(rect.offset.y);
+        viewport.width = static_cast<float>(rect.extent.width);
+        viewport.height = static_cast<float>(rect.extent.height);
+        viewport.maxDepth = 1.0f;
+        vk.vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        vk.vkCmdSetScissor(commandBuffer, 0, 1, &rect);
+        
+        PushConstants pushConstants = resolvedPushConstants;
+        pushConstants.viewProjection = camera.viewProjection;
+        
+        // Cells first, so the circles stay readable over crowded ones
+        vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, resolvedGridPipeline);
+        vk.vkCmdPushConstants(commandBuffer, cachedPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pushConstants), &pushConstants);
+        vk.vkCmdBindVertexBuffers(commandBuffer, 0, 1, &resolvedSpatialMapBuffer, &offset);
+        vk.vkCmdDraw(commandBuffer, 6, resolvedCellCount, 0, 0);
+        
+        if (resolvedEntityCount > 0) {
+            vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, resolvedBoundsPipeline);
+            vk.vkCmdBindVertexBuffers(commandBuffer, 0, 2, entityStreams, entityOffsets);
+            vk.vkCmdDraw(commandBuffer, DEBUG_OVERLAY_CIRCLE_SEGMENTS * 2, resolvedEntityCount, 0, 0);
+        }
+    }
+    
+    vk.vkCmdEndRenderingKHR(commandBuffer);
+    recordLayoutTransition(commandBuffer, vk, false);
+}
+
+void DebugOverlayNode::recordLayoutTransition(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk, bool toAttachment) const {
+    // The entity pass leaves the image presentable, written as an attachment or by the upscale blit
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = resolvedImage;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    
+    if (toAttachment) {
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        vk.vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier);
+    } else {
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        vk.vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+}
+
+bool DebugOverlayNode::resolveFrame() {
+    // Detect manager cache invalidation; the cached states hold nothing from the layout cache but the shared
+    // pipeline layout handle does
+    const auto* layoutMgr = graphicsManager->getLayoutManager();
+    const uint64_t currentLayoutGen = layoutMgr ? layoutMgr->getGeneration() : 0;
+    const uint64_t currentGraphicsGen = graphicsManager->getGeneration();
+    if (currentLayoutGen != observedLayoutGeneration || currentGraphicsGen != observedGraphicsPipelineGeneration) {
+        invalidateCachedState();
+        observedLayoutGeneration = currentLayoutGen;
+        observedGraphicsPipelineGeneration = currentGraphicsGen;
+    }
+    
+    const VkFormat colorFormat = swapchain->getImageFormat();
+    if (cachedColorFormat != colorFormat) {
+        cachedGridState = GraphicsPipelinePresets::createDebugGridState(VK_NULL_HANDLE);
+        GraphicsPipelinePresets::applyDynamicRendering(cachedGridState, colorFormat);
+        cachedBoundsState = GraphicsPipelinePresets::createDebugBoundsState(VK_NULL_HANDLE);
+        GraphicsPipelinePresets::applyDynamicRendering(cachedBoundsState, colorFormat);
+        cachedColorFormat = colorFormat;
+        cachedPipelineLayout = VK_NULL_HANDLE;
+    }
+    
+    // Non-blocking, looked up every frame so the cache never ages out the recorded pipelines; the overlay
+    // appears once both have compiled
+    resolvedGridPipeline = graphicsManager->getPipelineIfReady(cachedGridState);
+    resolvedBoundsPipeline = graphicsManager->getPipelineIfReady(cachedBoundsState);
+    if (resolvedGridPipeline == VK_NULL_HANDLE || resolvedBoundsPipeline == VK_NULL_HANDLE) {
+        return false;
+    }
+    if (cachedPipelineLayout == VK_NULL_HANDLE) {
+        cachedPipelineLayout = graphicsManager->getPipelineLayout(cachedGridState);
+    }
+    if (cachedPipelineLayout == VK_NULL_HANDLE) {
+        LOG_ERROR("DebugOverlayNode: Failed to get debug overlay pipeline");
+        return false;
+    }
+    
+    const std::vector<VkImage>& images = swapchain->getImages();
+    const std::vector<VkImageView> views = swapchain->getImageViews();
+    if (imageIndex >= images.size() || imageIndex >= views.size()) {
+        LOG_ERROR("DebugOverlayNode: Invalid imageIndex " << imageIndex);
+        return false;
+    }
+    resolvedImage = images[imageIndex];
+    resolvedView = views[imageIndex];
+    resolvedExtent = swapchain->getExtent();
+    if (resolvedExtent.width == 0 || resolvedExtent.height == 0) {
+        return false;
+    }
+    
+    // The grid as this frame's build lays it out; the map buffer holds at least its cells
+    const SpatialGridConfig& grid = gpuEntityManager->getSpatialGridConfig();
+    resolvedSpatialMapBuffer = gpuEntityManager->getBufferManager().getSpatialMapBuffer();
+    resolvedPositionBuffer = gpuEntityManager->getPositionBuffer();
+    resolvedVelocityBuffer = gpuEntityManager->getVelocityBuffer();
+    if (resolvedSpatialMapBuffer == VK_NULL_HANDLE || resolvedPositionBuffer == VK_NULL_HANDLE ||
+        resolvedVelocityBuffer == VK_NULL_HANDLE) {
+        return false;
+    }
+    resolvedCellCount = grid.getCellCount();
+    resolvedEntityCount = gpuEntityManager->getEntityCount();
+    resolvedBufferGeneration = gpuEntityManager->getBufferGeneration();
+    
+    resolvedPushConstants.grid = glm::uvec4(grid.width, grid.height, static_cast<uint32_t>(grid.cellOrder),
+                                            PHYSICS_MAX_ENTITIES_PER_CELL);
+    resolvedPushConstants.params = glm::vec4(grid.cellSize, GPU_CULLING_ENTITY_RADIUS, 0.0f, 0.0f);
+    return true;
+}
+
+// Node lifecycle implementation
+bool DebugOverlayNode::initializeNode(const FrameGraph& frameGraph) {
+    // One-time initialization - validate dependencies
+    if (!graphicsManager || !swapchain || !resourceCoordinator || !gpuEntityManager) {
+        LOG_ERROR("DebugOverlayNode: Missing dependencies");
+        return false;
+    }
+    
+    // Drawing over the entity pass's output needs a pass that loads it; render passes here all clear
+    dynamicRenderingSupported = resourceCoordinator->getContext()->supportsDynamicRendering();
+    if (!dynamicRenderingSupported) {
+        LOG_INFO("DebugOverlayNode: Dynamic rendering unavailable, debug overlay disabled");
+    }
+    return true;
+}
+
+void DebugOverlayNode::prepareFrame(uint32_t frameIndex, float time, float deltaTime) {
+    frameResolved = enabled && resolveFrame();
+}
+
+uint64_t DebugOverlayNode::getRecordingKey() const {
+    // An unresolved frame records nothing but may be resolvable next frame
+    if (!frameResolved) {
+        return UNCACHEABLE_RECORDING;
+    }
+    
+    // The streams are read at draw time, so only the handles, counts and push constants are baked in; the
+    // views' matrices change only with the camera version
+    uint64_t key = combineRecordingKey(0, imageIndex);
+    key = combineRecordingKey(key, recordingHandleKey(resolvedGridPipeline));
+    key = combineRecordingKey(key, recordingHandleKey(resolvedBoundsPipeline));
+    key = combineRecordingKey(key, recordingHandleKey(cachedPipelineLayout));
+    key = combineRecordingKey(key, recordingHandleKey(resolvedImage));
+    key = combineRecordingKey(key, recordingHandleKey(resolvedView));
+    key = combineRecordingKey(key, (static_cast<uint64_t>(resolvedExtent.width) << 32) | resolvedExtent.height);
+    key = combineRecordingKey(key, recordingHandleKey(resolvedSpatialMapBuffer));
+    key = combineRecordingKey(key, recordingHandleKey(resolvedPositionBuffer));
+    key = combineRecordingKey(key, recordingHandleKey(resolvedVelocityBuffer));
+    key = combineRecordingKey(key, resolvedBufferGeneration);
+    key = combineRecordingKey(key, (static_cast<uint64_t>(resolvedCellCount) << 32) | resolvedEntityCount);
+    key = combineRecordingKey(key, (static_cast<uint64_t>(resolvedPushConstants.grid.x) << 32) | resolvedPushConstants.grid.y);
+    key = combineRecordingKey(key, resolvedPushConstants.grid.z);
+    uint32_t cellSizeBits = 0;
+    std::memcpy(&cellSizeBits, &resolvedPushConstants.params.x, sizeof(cellSizeBits));
+    key = combineRecordingKey(key, cellSizeBits);
+    key = combineRecordingKey(key, viewportCameraVersion);
+    return key;
+}
+
+void DebugOverlayNode::releaseFrame(uint32_t frameIndex) {
+    // Per-frame cleanup - nothing per frame is owned
+}
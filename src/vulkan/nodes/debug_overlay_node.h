@@ -0,0 +1,135 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/frame_graph.h"
+#include "../rendering/viewport_camera.h"
+#include "../pipelines/graphics_pipeline_state_hash.h"
+#include "../core/vulkan_constants.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <limits>
+#include <vector>
+
+// Forward declarations
+class VulkanFunctionLoader;
+class GraphicsPipelineManager;
+class VulkanSwapchain;
+class ResourceCoordinator;
+class GPUEntityManager;
+
+// Debug overlay (F3), drawn over the finished swapchain image after the entity pass and before the HUD. Two
+// instanced draws read the entity buffers in place as vertex streams: one quad per spatial map cell, shaded by
+// the occupancy the last grid build counted (red past the physics cell capacity), and one line circle per
+// entity slot at its bounding radius, coloured by the collision and sleep state physics left in velocity.w. No
+// readback and no CPU work per entity, so it stays cheap at any entity count.
+//
+// The buffers are the working ones: with compute pipelined ahead of graphics the grid may already be the next
+// frame's, partly rebuilt, and the circles sit at the resolved rather than the interpolated positions. Disabled
+// while not turned on or without VK_KHR_dynamic_rendering
+class DebugOverlayNode : public FrameGraphNode {
+    DECLARE_FRAME_GRAPH_NODE(DebugOverlayNode)
+
+public:
+    DebugOverlayNode(
+        FrameGraphTypes::ResourceId velocityBuffer,
+        FrameGraphTypes::ResourceId positionBuffer,
+        FrameGraphTypes::ResourceId spatialMapBuffer,
+        FrameGraphTypes::ResourceId colorTarget,
+        GraphicsPipelineManager* graphicsManager,
+        VulkanSwapchain* swapchain,
+        ResourceCoordinator* resourceCoordinator,
+        GPUEntityManager* gpuEntityManager
+    );
+    
+    // FrameGraphNode interface
+    std::vector<ResourceDependency> getInputs() const override;
+    std::vector<ResourceDependency> getOutputs() const override;
+    void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
+    
+    uint64_t getRecordingKey() const override;
+    bool isEnabled(const FrameContext& frameContext) const override { return enabled && dynamicRenderingSupported; }
+    
+    // Queue requirements
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::Graphics; }
+    
+    // Node lifecycle - standardized pattern
+    bool initializeNode(const FrameGraph& frameGraph) override;
+    void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
+    void releaseFrame(uint32_t frameIndex) override;
+    
+    // Update swapchain image index for current frame
+    void setImageIndex(uint32_t imageIndex) { this->imageIndex = imageIndex; }
+    
+    // Set current frame's swapchain image resource ID (called each frame)
+    void setCurrentSwapchainImageId(FrameGraphTypes::ResourceId currentImageId) { this->currentSwapchainImageId = currentImageId; }
+    
+    void setEnabled(bool enabled) { this->enabled = enabled; }
+    
+    // The main window's views, drawn over in their viewport rects; version as for EntityGraphicsNode
+    void setViewportCameras(const std::vector<ViewportCamera>& cameras, uint64_t version);
+    
+    // Invalidate cached state after swapchain recreation or layout cache clear
+    void invalidateCachedState() {
+        cachedColorFormat = VK_FORMAT_UNDEFINED;
+        cachedPipelineLayout = VK_NULL_HANDLE;
+    }
+
+private:
+    // Must match DebugOverlayPushConstants in debug_overlay.glsl
+    struct PushConstants {
+        glm::mat4 viewProjection;
+        glm::uvec4 grid;    // Width, height, cell order, full heat occupancy
+        glm::vec4 params;   // Cell size, entity bounding radius
+    };
+    static_assert(sizeof(PushConstants) == 96, "DebugOverlayNode::PushConstants must match debug_overlay.glsl");
+    
+    // Resolve the pipelines, buffers and target execute() records (called from prepareFrame)
+    bool resolveFrame();
+    
+    void recordLayoutTransition(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk, bool toAttachment) const;
+    
+    // Resources
+    FrameGraphTypes::ResourceId velocityBufferId;
+    FrameGraphTypes::ResourceId positionBufferId;
+    FrameGraphTypes::ResourceId spatialMapBufferId;
+    FrameGraphTypes::ResourceId colorTargetId; // Static placeholder - not used
+    FrameGraphTypes::ResourceId currentSwapchainImageId = 0; // Dynamic per-frame ID
+    
+    // External dependencies (not owned) - validated during execution
+    GraphicsPipelineManager* graphicsManager;
+    VulkanSwapchain* swapchain;
+    ResourceCoordinator* resourceCoordinator;
+    GPUEntityManager* gpuEntityManager;
+    bool enabled = false;
+    bool dynamicRenderingSupported = false;
+    
+    // Current frame state
+    uint32_t imageIndex = 0;
+    std::vector<ViewportCamera> viewportCameras;
+    uint64_t viewportCameraVersion = 0;
+    
+    // Resolved by prepareFrame() for execute() and getRecordingKey()
+    bool frameResolved = false;
+    VkPipeline resolvedGridPipeline = VK_NULL_HANDLE;
+    VkPipeline resolvedBoundsPipeline = VK_NULL_HANDLE;
+    VkImage resolvedImage = VK_NULL_HANDLE;
+    VkImageView resolvedView = VK_NULL_HANDLE;
+    VkExtent2D resolvedExtent{};
+    VkBuffer resolvedSpatialMapBuffer = VK_NULL_HANDLE;
+    VkBuffer resolvedPositionBuffer = VK_NULL_HANDLE;
+    VkBuffer resolvedVelocityBuffer = VK_NULL_HANDLE;
+    uint32_t resolvedCellCount = 0;
+    uint32_t resolvedEntityCount = 0;
+    uint64_t resolvedBufferGeneration = 0;
+    PushConstants resolvedPushConstants{};
+    
+    // Pipeline states for the cached colour format, rebuilt when the format or a manager generation changes;
+    // both share one pipeline layout
+    GraphicsPipelineState cachedGridState;
+    GraphicsPipelineState cachedBoundsState;
+    VkFormat cachedColorFormat = VK_FORMAT_UNDEFINED;
+    VkPipelineLayout cachedPipelineLayout = VK_NULL_HANDLE;
+    uint64_t observedLayoutGeneration = std::numeric_limits<uint64_t>::max();
+    uint64_t observedGraphicsPipelineGeneration = std::numeric_limits<uint64_t>::max();
+};
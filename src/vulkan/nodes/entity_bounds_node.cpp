@@ -0,0 +1,153 @@
+#include "entity_bounds_node.h"
+#include "../pipelines/compute_pipeline_manager.h"
+#include "../../ecs/gpu/gpu_entity_manager.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../core/vulkan_constants.h"
+#include "../pipelines/descriptor_layout_manager.h"
+#include "../monitoring/gpu_timeout_detector.h"
+#include "../../ecs/utilities/logger.h"
+#include <stdexcept>
+#include <memory>
+
+EntityBoundsNode::EntityBoundsNode(
+    FrameGraphTypes::ResourceId positionBuffer,
+    ComputePipelineManager* computeManager,
+    GPUEntityManager* gpuEntityManager,
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector
+) : positionBufferId(positionBuffer)
+  , computeManager(computeManager)
+  , gpuEntityManager(gpuEntityManager)
+  , timeoutDetector(timeoutDetector) {
+  
+    // Validate dependencies during construction for fail-fast behavior
+    if (!computeManager) {
+        throw std::invalid_argument("EntityBoundsNode: computeManager cannot be null");
+    }
+    if (!gpuEntityManager) {
+        throw std::invalid_argument("EntityBoundsNode: gpuEntityManager cannot be null");
+    }
+}
+
+std::vector<ResourceDependency> EntityBoundsNode::getInputs() const {
+    return {
+        {positionBufferId, ResourceAccess::Read, PipelineStage::ComputeShader},
+    };
+}
+
+std::vector<ResourceDependency> EntityBoundsNode::getOutputs() const {
+    return {};
+}
+
+bool EntityBoundsNode::isEnabled(const FrameContext& frameContext) const {
+    return frameContext.simulation.tickCount > 0 && gpuEntityManager && gpuEntityManager->getEntityCount() > 0;
+}
+
+void EntityBoundsNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    // Validate dependencies are still valid
+    if (!computeManager || !gpuEntityManager) {
+        LOG_ERROR("EntityBoundsNode: Critical error - dependencies became null during execution");
+        return;
+    }
+    
+    const VulkanContext* context = frameGraph.getContext();
+    if (!context) {
+        LOG_ERROR("EntityBoundsNode: Cannot get Vulkan context");
+        return;
+    }
+    
+    const auto& descriptorManager = gpuEntityManager->getDescriptorManager();
+    const bool resolved = boundsPipeline.resolveBlocking(*computeManager, gpuEntityManager->getComputeVariantKey(), [&]() {
+        auto layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
+        VkDescriptorSetLayout descriptorLayout = computeManager->getLayoutManager()->getLayout(layoutSpec);
+        ComputePipelineState state = ComputePipelinePresets::createEntityBoundsState(descriptorLayout);
+        if (descriptorManager.usesStreamAddresses()) {
+            ComputePipelinePresets::applyEntityStreamAddresses(state);
+        } else if (descriptorManager.isBindless()) {
+            ComputePipelinePresets::applyBindlessEntityTable(state, descriptorManager.getBindlessTableLayout());
+        }
+        return state;
+    });
+    if (!resolved) {
+        LOG_ERROR("EntityBoundsNode: Failed to get bounds pipeline or layout");
+        return;
+    }
+    VkPipeline pipeline = boundsPipeline.getPipeline();
+    VkPipelineLayout pipelineLayout = boundsPipeline.getLayout();
+    
+    VkDescriptorSet computeDescriptorSet = descriptorManager.getEntityComputeSet();
+    if (computeDescriptorSet == VK_NULL_HANDLE && !descriptorManager.usesStreamAddresses()) {
+        LOG_ERROR("EntityBoundsNode: ERROR - Missing compute descriptor set!");
+        return;
+    }
+    
+    pushConstants.entityTable = descriptorManager.getWorkingTable();
+    
+    FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 1800, "EntityBoundsNode: reducing " << gpuEntityManager->getEntityCount() << " entities");
+    
+    // Cache loader reference for performance
+    const auto& vk = context->getLoader();
+    const auto& barriers = frameGraph.getBarrierManager();
+    VkBuffer indirectBuffer = gpuEntityManager->getIndirectCommandBuffer();
+    
+    // Live count rewrites (transfer) and GPU spawns (compute) land before the reduction reads the count; the
+    // previous reduction's readback copy must be done before the counter is reset
+    barriers.insertMemoryBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR,
+        VK_ACCESS_2_SHADER_WRITE_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+    vk.vkCmdFillBuffer(commandBuffer, indirectBuffer, EntityIndirectCommandBuffer::getBoundsCounterOffset(), sizeof(uint32_t), 0);
+    barriers.insertMemoryBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR,
+        VK_ACCESS_2_SHADER_WRITE_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    if (computeDescriptorSet != VK_NULL_HANDLE) {
+        vk.vkCmdBindDescriptorSets(
+            commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout,
+            0, 1, &computeDescriptorSet, 0, nullptr);
+    }
+    vk.vkCmdPushConstants(
+        commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(BoundsPushConstants), &pushConstants);
+    
+    if (timeoutDetector) {
+        static const ProfileZoneId zone = Profiler::getInstance().registerZone("EntityBounds");
+        timeoutDetector->beginComputeDispatch(commandBuffer, zone, ENTITY_BOUNDS_WORKGROUPS);
+    }
+    
+    // Fixed grid: each workgroup strides over the live range, whatever its length
+    vk.vkCmdDispatch(commandBuffer, ENTITY_BOUNDS_WORKGROUPS, 1, 1);
+    
+    if (timeoutDetector) {
+        timeoutDetector->endComputeDispatch(commandBuffer);
+    }
+    
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+    const SimulationStep& step = frameGraph.getSimulationStep();
+    const uint32_t lastTick = step.firstTick + step.tickCount - 1;
+    if (gpuEntityManager->getBufferManager().recordEntityBoundsReadback(commandBuffer, lastTick)) {
+        barriers.insertMemoryBarrier(
+            commandBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            VK_PIPELINE_STAGE_2_HOST_BIT_KHR, VK_ACCESS_2_HOST_READ_BIT_KHR);
+    }
+}
+
+// Node lifecycle implementation
+bool EntityBoundsNode::initializeNode(const FrameGraph& frameGraph) {
+    // One-time initialization - validate dependencies
+    if (!computeManager) {
+        LOG_ERROR("EntityBoundsNode: ComputePipelineManager is null");
+        return false;
+    }
+    if (!gpuEntityManager) {
+        LOG_ERROR("EntityBoundsNode: GPUEntityManager is null");
+        return false;
+    }
+    return true;
+}
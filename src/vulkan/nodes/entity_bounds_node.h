@@ -0,0 +1,64 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/frame_graph.h"
+#include "../rendering/frame_graph_debug.h"
+#include "../core/vulkan_constants.h"
+#include "../pipelines/compute_pipeline_handle.h"
+#include <memory>
+#include <vector>
+
+// Forward declarations
+class ComputePipelineManager;
+class GPUEntityManager;
+class GPUTimeoutDetector;
+
+// Reduces the simulated entity positions to their AABB, centroid and count (EntityIndirectCommands::bounds) and
+// copies the result into the ReadbackRing in the same pass, so GPUEntityManager::getEntityBounds() follows the GPU
+// a couple of frames behind without a stall. Runs after PhysicsComputeNode on frames that ran a simulation tick.
+class EntityBoundsNode : public FrameGraphNode {
+    DECLARE_FRAME_GRAPH_NODE(EntityBoundsNode)
+
+public:
+    EntityBoundsNode(
+        FrameGraphTypes::ResourceId positionBuffer,
+        ComputePipelineManager* computeManager,
+        GPUEntityManager* gpuEntityManager,
+        std::shared_ptr<GPUTimeoutDetector> timeoutDetector = nullptr
+    );
+    
+    // FrameGraphNode interface - the result lives in the indirect command buffer, which the graph does not track
+    std::vector<ResourceDependency> getInputs() const override;
+    std::vector<ResourceDependency> getOutputs() const override;
+    void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
+    
+    // Positions only move on simulation ticks
+    bool isEnabled(const FrameContext& frameContext) const override;
+    
+    // Queue requirements
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::AsyncCompute; }
+    
+    // One position read per entity
+    float getBytesPerEntity() const override { return 16.0f; }
+    
+    // Node lifecycle - standardized pattern
+    bool initializeNode(const FrameGraph& frameGraph) override;
+
+private:
+    FrameGraphTypes::ResourceId positionBufferId;
+    
+    // External dependencies (not owned) - validated during execution
+    ComputePipelineManager* computeManager;
+    GPUEntityManager* gpuEntityManager;
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector;
+    ComputePipelineHandle boundsPipeline;
+    
+    // Debug counter - zero overhead in release builds
+    mutable FrameGraphDebug::DebugCounter debugCounter{};
+    
+    // Must match entity_bounds.comp
+    struct BoundsPushConstants {
+        uint64_t entityTable;   // Bindless table view or stream address table of the working buffers
+    } pushConstants{};
+};
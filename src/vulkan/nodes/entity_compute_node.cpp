@@ -6,7 +6,8 @@
 #include "../core/vulkan_constants.h"
 #include "../pipelines/descriptor_layout_manager.h"
 #include "../monitoring/gpu_timeout_detector.h"
-#include <iostream>
+#include "../../ecs/utilities/logger.h"
+#include <algorithm>
 #include <array>
 #include <glm/glm.hpp>
 #include <stdexcept>
@@ -21,14 +22,45 @@ namespace {
         bool useChunking;
     };
     
-    DispatchParams calculateDispatchParams(uint32_t entityCount, uint32_t maxWorkgroups, bool forceChunking) {
-        const uint32_t totalWorkgroups = (entityCount + THREADS_PER_WORKGROUP - 1) / THREADS_PER_WORKGROUP;
+    // Chunks only when asked to: by the timeout detector or measured GPU time for ones over maxWorkgroups, or forced
+    DispatchParams calculateDispatchParams(uint32_t entityCount, uint32_t workgroupSize, uint32_t maxWorkgroups,
+                                           bool chunkingRequested, bool forceChunking) {
+        const uint32_t totalWorkgroups = (entityCount + workgroupSize - 1) / workgroupSize;
         return {
             totalWorkgroups,
             maxWorkgroups,
-            totalWorkgroups > maxWorkgroups || forceChunking
+            forceChunking || (chunkingRequested && totalWorkgroups > maxWorkgroups)
         };
     }
+    
+    // Rows of at most COMPUTE_MAX_WORKGROUPS_X workgroups, as even as possible so the last row wastes little. The
+    // movement kernels number invocations across rows (movementInvocationIndex), so one dispatch covers any count
+    glm::uvec2 workgroupGrid(uint32_t workgroupCount) {
+        const uint32_t rows = std::max(1u, (workgroupCount + COMPUTE_MAX_WORKGROUPS_X - 1) / COMPUTE_MAX_WORKGROUPS_X);
+        return glm::uvec2((workgroupCount + rows - 1) / rows, rows);
+    }
+    
+    // Inverse of the stagger modulo the cycle length: entity i is due when
+    // (frame + i * STAGGER) % LENGTH == 0, i.e. i == -frame * inverse (mod LENGTH)
+    constexpr uint32_t findStaggerInverse() {
+        for (uint32_t candidate = 1; candidate < MOVEMENT_CYCLE_LENGTH; ++candidate) {
+            if ((candidate * MOVEMENT_CYCLE_STAGGER) % MOVEMENT_CYCLE_LENGTH == 1) {
+                return candidate;
+            }
+        }
+        return 0;
+    }
+    
+    constexpr uint32_t STAGGER_INVERSE = findStaggerInverse();
+    static_assert(STAGGER_INVERSE != 0, "MOVEMENT_CYCLE_STAGGER must be coprime with MOVEMENT_CYCLE_LENGTH");
+    
+    // The type lists take one word per entity each out of the reorder scratch buffer's uvec4 per entity and stream
+    static_assert(MOVEMENT_TYPE_COUNT <= ENTITY_REORDER_STREAM_COUNT * 4, "Movement type lists must fit the reorder scratch buffer");
+    
+    uint32_t firstDueEntity(uint32_t frame) {
+        const uint32_t negFrame = (MOVEMENT_CYCLE_LENGTH - frame % MOVEMENT_CYCLE_LENGTH) % MOVEMENT_CYCLE_LENGTH;
+        return (negFrame * STAGGER_INVERSE) % MOVEMENT_CYCLE_LENGTH;
+    }
 }
 
 EntityComputeNode::EntityComputeNode(
@@ -68,10 +100,36 @@ std::vector<ResourceDependency> EntityComputeNode::getOutputs() const {
     };
 }
 
+float EntityComputeNode::getBytesPerEntity() const {
+    // A due entity reads its initialized flag and writes velocity xy and w; one in MOVEMENT_CYCLE_LENGTH is
+    // due per tick. Type dispatch also reads every entity's type word, and the figure assumes random walkers,
+    // since the type mix is only known on the GPU
+    const float dueBytes = 4.0f + 12.0f;
+    const float binBytes = ENABLE_MOVEMENT_TYPE_DISPATCH ? 4.0f : 0.0f;
+    return binBytes + dueBytes / MOVEMENT_CYCLE_LENGTH;
+}
+
+bool EntityComputeNode::isEnabled(const FrameContext& frameContext) const {
+    if (!gpuEntityManager) return true;
+    
+    // Frames between simulation ticks move nothing
+    const SimulationStep& simulation = frameContext.simulation;
+    if (simulation.tickCount == 0) return false;
+    
+    // Steady state dispatches only entities starting a cycle, and small worlds have ticks with none due
+    const uint32_t entityCount = gpuEntityManager->getEntityCount();
+    if (entityCount == 0) return false;
+    if (ENABLE_MOVEMENT_TYPE_DISPATCH || gpuEntityManager->getSpawnGeneration() != lastDenseSpawnGeneration) return true;
+    for (uint32_t step = 0; step < simulation.tickCount; ++step) {
+        if (firstDueEntity(simulation.firstTick + step) < entityCount) return true;
+    }
+    return false;
+}
+
 void EntityComputeNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
     // Validate dependencies are still valid
     if (!computeManager || !gpuEntityManager) {
-        std::cerr << "EntityComputeNode: Critical error - dependencies became null during execution" << std::endl;
+        LOG_ERROR("EntityComputeNode: Critical error - dependencies became null during execution");
         return;
     }
     
@@ -81,75 +139,83 @@ void EntityComputeNode::execute(VkCommandBuffer commandBuffer, const FrameGraph&
         return;
     }
     
-    // Create compute pipeline state for entity movement
-    auto layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
-    VkDescriptorSetLayout descriptorLayout = computeManager->getLayoutManager()->getLayout(layoutSpec);
-    ComputePipelineState pipelineState = ComputePipelinePresets::createEntityMovementState(descriptorLayout);
+    // The dense dispatch runs as the frame's first simulation tick; due dispatches cover the rest
+    const SimulationStep& simulation = frameGraph.getSimulationStep();
+    pushConstants.frame = simulation.firstTick;
+    pushConstants.deltaTime = simulation.tickSeconds;
     
-    // Set frame counter from FrameGraph for compute shader consistency
-    pushConstants.frame = frameGraph.getGlobalFrameCounter();
-    
-    // Create compute dispatch
+    // Create compute dispatch from the pipeline resolved in prepareFrame()
     ComputeDispatch dispatch{};
-    dispatch.pipeline = computeManager->getPipeline(pipelineState);
-    
-    dispatch.layout = computeManager->getPipelineLayout(pipelineState);
+    dispatch.pipeline = pipeline;
+    dispatch.layout = pipelineLayout;
     
-    if (dispatch.pipeline == VK_NULL_HANDLE || dispatch.layout == VK_NULL_HANDLE) {
-        std::cerr << "EntityComputeNode: Failed to get compute pipeline or layout" << std::endl;
+    if (!ENABLE_MOVEMENT_TYPE_DISPATCH && (dispatch.pipeline == VK_NULL_HANDLE || dispatch.layout == VK_NULL_HANDLE)) {
+        FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 1800, "EntityComputeNode: Movement pipeline not ready, skipping dispatch");
         return;
     }
     
     // Set up descriptor sets
-    VkDescriptorSet computeDescriptorSet = gpuEntityManager->getDescriptorManager().getComputeDescriptorSet();
+    VkDescriptorSet computeDescriptorSet = gpuEntityManager->getDescriptorManager().getEntityComputeSet();
     
     if (computeDescriptorSet != VK_NULL_HANDLE) {
         dispatch.descriptorSets.push_back(computeDescriptorSet);
-    } else {
-        std::cerr << "EntityComputeNode: ERROR - Missing compute descriptor set!" << std::endl;
+    } else if (!gpuEntityManager->getDescriptorManager().usesStreamAddresses()) {
+        LOG_ERROR("EntityComputeNode: ERROR - Missing compute descriptor set!");
         return;
     }
     
     // Configure push constants and dispatch
     pushConstants.entityCount = entityCount;
+    pushConstants.entityStride = 0;
+    pushConstants.entityTable = gpuEntityManager->getDescriptorManager().getWorkingTable();
     dispatch.pushConstantData = &pushConstants;
     dispatch.pushConstantSize = sizeof(ComputePushConstants);
     dispatch.pushConstantStages = VK_SHADER_STAGE_COMPUTE_BIT;
-    dispatch.calculateOptimalDispatch(entityCount, glm::uvec3(THREADS_PER_WORKGROUP, 1, 1));
+    dispatch.calculateOptimalDispatch(entityCount, glm::uvec3(activeWorkgroupSize, 1, 1));
+    
+    if (ENABLE_MOVEMENT_TYPE_DISPATCH) {
+        const VulkanContext* context = frameGraph.getContext();
+        if (!context) {
+            LOG_ERROR("EntityComputeNode: Cannot get Vulkan context");
+            return;
+        }
+        tuneWorkgroupSize(frameGraph.getNodeGpuTiming(getId()), entityCount);
+        executeTypeDispatch(commandBuffer, frameGraph, context, dispatch, entityCount);
+        return;
+    }
     
     // Apply adaptive workload management
+    adaptChunkingToGpuTime(frameGraph.getNodeGpuTiming(getId()));
+    tuneWorkgroupSize(frameGraph.getNodeGpuTiming(getId()), entityCount);
     uint32_t maxWorkgroupsPerDispatch = adaptiveMaxWorkgroups;
     bool shouldForceChunking = forceChunkedDispatch;
+    bool timeoutRequestsChunking = false;
     
     if (timeoutDetector) {
+        // The cap comes from measured GPU time, so it only splits dispatches too large for this GPU
         auto recommendation = timeoutDetector->getRecoveryRecommendation();
-        if (recommendation.shouldReduceWorkload) {
+        const uint32_t totalWorkgroups = (entityCount + activeWorkgroupSize - 1) / activeWorkgroupSize;
+        if (recommendation.shouldReduceWorkload && recommendation.recommendedMaxWorkgroups < totalWorkgroups) {
             maxWorkgroupsPerDispatch = std::min(maxWorkgroupsPerDispatch, recommendation.recommendedMaxWorkgroups);
+            timeoutRequestsChunking = true;
         }
-        if (recommendation.shouldSplitDispatches) {
+        if (recommendation.shouldSplitDispatches || !timeoutDetector->isGPUHealthy()) {
             shouldForceChunking = true;
-        }
-        if (!timeoutDetector->isGPUHealthy()) {
-            std::cerr << "EntityComputeNode: GPU not healthy, reducing workload" << std::endl;
-            maxWorkgroupsPerDispatch = std::min(maxWorkgroupsPerDispatch, 512u);
+            timeoutRequestsChunking = true;
         }
     }
     
-    // Calculate dispatch parameters
-    auto dispatchParams = calculateDispatchParams(entityCount, maxWorkgroupsPerDispatch, shouldForceChunking);
-    
-    // Validate dispatch limits
-    if (dispatchParams.totalWorkgroups > 65535) {
-        std::cerr << "ERROR: Workgroup count " << dispatchParams.totalWorkgroups << " exceeds Vulkan limit!" << std::endl;
-        return;
-    }
+    // Calculate dispatch parameters. Past COMPUTE_MAX_WORKGROUPS_X a single dispatch goes 2D rather than chunked
+    const bool gpuTimeRequestsChunking = adaptiveMaxWorkgroups < MAX_WORKGROUPS_PER_CHUNK;
+    auto dispatchParams = calculateDispatchParams(entityCount, activeWorkgroupSize, maxWorkgroupsPerDispatch,
+                                                  timeoutRequestsChunking || gpuTimeRequestsChunking, shouldForceChunking);
     
     // Debug logging (thread-safe) - once every 30 seconds
     FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 1800, "EntityComputeNode (Movement): " << entityCount << " entities → " << dispatchParams.totalWorkgroups << " workgroups");
     
     const VulkanContext* context = frameGraph.getContext();
     if (!context) {
-        std::cerr << "EntityComputeNode: Cannot get Vulkan context" << std::endl;
+        LOG_ERROR("EntityComputeNode: Cannot get Vulkan context");
         return;
     }
     
@@ -163,39 +229,82 @@ void EntityComputeNode::execute(VkCommandBuffer commandBuffer, const FrameGraph&
         commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, dispatch.layout,
         0, 1, &dispatch.descriptorSets[0], 0, nullptr);
     
-    if (!dispatchParams.useChunking) {
-        // Single dispatch execution
-        std::cout << "EntityComputeNode: Starting single dispatch execution..." << std::endl;
-        if (timeoutDetector) {
-            timeoutDetector->beginComputeDispatch("EntityMovement", dispatchParams.totalWorkgroups);
-        }
-        
-        vk.vkCmdPushConstants(
-            commandBuffer, dispatch.layout, VK_SHADER_STAGE_COMPUTE_BIT,
-            0, sizeof(ComputePushConstants), &pushConstants);
-        
-        vk.vkCmdDispatch(commandBuffer, dispatchParams.totalWorkgroups, 1, 1);
+    // Steady state: every entity is initialized, so only those starting a new cycle need a thread
+    uint32_t firstDueStep = 0;
+    const uint64_t spawnGeneration = gpuEntityManager->getSpawnGeneration();
+    if (spawnGeneration != lastDenseSpawnGeneration) {
+        lastDenseSpawnGeneration = spawnGeneration;
+        firstDueStep = 1;
         
-        if (timeoutDetector) {
-            timeoutDetector->endComputeDispatch();
+        // GPU-sized single dispatch; CPU-sized chunks when the timeout detector or measured GPU time asks for them.
+        // The indirect workgroup count is written 1D for THREADS_PER_WORKGROUP, so other sizes and grids past
+        // COMPUTE_MAX_WORKGROUPS_X dispatch directly
+        if (useIndirectDispatch && activeWorkgroupSize == THREADS_PER_WORKGROUP && !dispatchParams.useChunking &&
+            dispatchParams.totalWorkgroups <= COMPUTE_MAX_WORKGROUPS_X) {
+            executeIndirectDispatch(commandBuffer, context, dispatch);
+        } else if (!dispatchParams.useChunking) {
+            // Single dispatch execution
+            if (timeoutDetector) {
+                static const ProfileZoneId zone = Profiler::getInstance().registerZone("EntityMovement");
+                timeoutDetector->beginComputeDispatch(commandBuffer, zone, dispatchParams.totalWorkgroups, true);
+            }
+            
+            vk.vkCmdPushConstants(
+                commandBuffer, dispatch.layout, VK_SHADER_STAGE_COMPUTE_BIT,
+                0, sizeof(ComputePushConstants), &pushConstants);
+            
+            const glm::uvec2 grid = workgroupGrid(dispatchParams.totalWorkgroups);
+            vk.vkCmdDispatch(commandBuffer, grid.x, grid.y, 1);
+            
+            if (timeoutDetector) {
+                timeoutDetector->endComputeDispatch(commandBuffer);
+            }
+        } else {
+            executeChunkedDispatch(commandBuffer, context, dispatch, 
+                                  dispatchParams.totalWorkgroups, dispatchParams.maxWorkgroupsPerChunk, entityCount);
         }
         
-        // Memory barrier for compute→graphics synchronization (SoA uses storage buffers)
-        VkMemoryBarrier memoryBarrier{};
-        memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-        memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-        memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;  // SoA reads from storage buffers, not vertex attributes
-        
-        vk.vkCmdPipelineBarrier(
-            commandBuffer,
-            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-            VK_PIPELINE_STAGE_VERTEX_SHADER_BIT,  // Graphics reads in vertex shader stage
-            0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
-    } else {
-        executeChunkedDispatch(commandBuffer, context, dispatch, 
-                              dispatchParams.totalWorkgroups, dispatchParams.maxWorkgroupsPerChunk, entityCount);
+        if (simulation.tickCount > 1) {
+            frameGraph.getBarrierManager().insertMemoryBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+        }
     }
     
+    // MAX_SIMULATION_TICKS_PER_FRAME stays below MOVEMENT_CYCLE_LENGTH, so no entity is due on two ticks of the
+    // same frame and the due dispatches need no barriers between them
+    for (uint32_t step = firstDueStep; step < simulation.tickCount; ++step) {
+        executeDueEntityDispatch(commandBuffer, context, dispatch, entityCount, simulation.firstTick + step);
+    }
+}
+
+void EntityComputeNode::adaptChunkingToGpuTime(const FrameGraphExecution::NodeGpuTiming* timing) {
+    // One decision per full timing window, so each sees only samples taken at the current chunk size
+    if (!timing || timing->sampleCount < lastChunkAdaptSample + GPU_NODE_TIMING_WINDOW) {
+        return;
+    }
+    lastChunkAdaptSample = timing->sampleCount;
+    
+    const uint32_t previous = adaptiveMaxWorkgroups;
+    if (timing->p99Ms > COMPUTE_NODE_GPU_BUDGET_MS) {
+        adaptiveMaxWorkgroups = std::max(MIN_WORKGROUPS_PER_CHUNK, adaptiveMaxWorkgroups / 2);
+    } else if (timing->p99Ms < COMPUTE_NODE_GPU_BUDGET_MS * 0.25f) {
+        adaptiveMaxWorkgroups = std::min(MAX_WORKGROUPS_PER_CHUNK, adaptiveMaxWorkgroups * 2);
+    }
+    
+    if (adaptiveMaxWorkgroups != previous) {
+        LOG_INFO("EntityComputeNode: GPU p99 " << timing->p99Ms << "ms, max workgroups per chunk "
+                 << previous << " -> " << adaptiveMaxWorkgroups);
+    }
+}
+
+void EntityComputeNode::tuneWorkgroupSize(const FrameGraphExecution::NodeGpuTiming* timing, uint32_t entityCount) {
+    if (!timing || timing->sampleCount < lastTuneSample + GPU_NODE_TIMING_WINDOW) {
+        return;
+    }
+    lastTuneSample = timing->sampleCount;
+    computeManager->getWorkgroupTuner()->reportWindow("movement", activeWorkgroupSize, timing->avgMs, entityCount);
 }
 
 void EntityComputeNode::executeChunkedDispatch(
@@ -214,14 +323,14 @@ void EntityComputeNode::executeChunkedDispatch(
     
     while (processedWorkgroups < totalWorkgroups) {
         uint32_t currentChunkSize = std::min(maxWorkgroupsPerChunk, totalWorkgroups - processedWorkgroups);
-        uint32_t baseEntityOffset = processedWorkgroups * THREADS_PER_WORKGROUP;
+        uint32_t baseEntityOffset = processedWorkgroups * activeWorkgroupSize;
         
         if (entityCount <= baseEntityOffset) break; // No more entities to process
         
         // Monitor chunk execution
         if (timeoutDetector) {
-            std::string chunkName = "EntityMovement_Chunk" + std::to_string(chunkCount);
-            timeoutDetector->beginComputeDispatch(chunkName.c_str(), currentChunkSize);
+            static const ProfileZoneId chunkZone = Profiler::getInstance().registerZone("EntityMovement_Chunk");  // Shared by every chunk
+            timeoutDetector->beginComputeDispatch(commandBuffer, chunkZone, currentChunkSize, true);
         }
         
         // Update push constants for this chunk
@@ -235,64 +344,320 @@ void EntityComputeNode::executeChunkedDispatch(
         vk.vkCmdDispatch(commandBuffer, currentChunkSize, 1, 1);
         
         if (timeoutDetector) {
-            timeoutDetector->endComputeDispatch();
-        }
-        
-        // Inter-chunk memory barrier
-        if (processedWorkgroups + currentChunkSize < totalWorkgroups) {
-            VkMemoryBarrier memoryBarrier{};
-            memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-            memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-            memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
-            
-            vk.vkCmdPipelineBarrier(
-                commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+            timeoutDetector->endComputeDispatch(commandBuffer);
         }
         
+        // No barrier between chunks: each thread reads and writes only its own entity's slots
         processedWorkgroups += currentChunkSize;
         chunkCount++;
     }
     
-    // Final memory barrier for compute→graphics synchronization (SoA uses storage buffers)
-    VkMemoryBarrier finalMemoryBarrier{};
-    finalMemoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-    finalMemoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    finalMemoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;  // SoA reads from storage buffers
-    
-    vk.vkCmdPipelineBarrier(
-        commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        VK_PIPELINE_STAGE_VERTEX_SHADER_BIT, 0, 1, &finalMemoryBarrier, 0, nullptr, 0, nullptr);
-    
     // Debug statistics logging (thread-safe)
     if constexpr (FRAME_GRAPH_DEBUG_ENABLED) {
         uint32_t chunkLogCounter = FrameGraphDebug::incrementCounter(debugCounter);
         if (chunkLogCounter % 300 == 0) {
-            std::cout << "[FrameGraph Debug] EntityComputeNode: Split dispatch into " << chunkCount 
-                      << " chunks (" << maxWorkgroupsPerChunk << " max) for " << entityCount << " entities (occurrence #" << chunkLogCounter << ")" << std::endl;
+            LOG_INFO("[FrameGraph Debug] EntityComputeNode: Split dispatch into " << chunkCount 
+                     << " chunks (" << maxWorkgroupsPerChunk << " max) for " << entityCount << " entities (occurrence #" << chunkLogCounter << ")");
             
             if (timeoutDetector) {
                 auto stats = timeoutDetector->getStats();
-                std::cout << "  GPU Stats: avg=" << stats.averageDispatchTimeMs 
-                          << "ms, peak=" << stats.peakDispatchTimeMs << "ms"
-                          << ", warnings=" << stats.warningCount 
-                          << ", critical=" << stats.criticalCount << std::endl;
+                LOG_INFO("  GPU Stats: avg=" << stats.averageDispatchTimeMs 
+                         << "ms, peak=" << stats.peakDispatchTimeMs << "ms"
+                         << ", warnings=" << stats.warningCount 
+                         << ", critical=" << stats.criticalCount);
+            }
+        }
+    }
+}
+
+void EntityComputeNode::executeDueEntityDispatch(
+    VkCommandBuffer commandBuffer,
+    const VulkanContext* context,
+    const ComputeDispatch& dispatch,
+    uint32_t entityCount,
+    uint32_t tick) {
+    
+    const uint32_t firstDue = firstDueEntity(tick);
+    if (firstDue >= entityCount) {
+        return; // Nothing due this tick - no writes, no barrier needed
+    }
+    
+    const uint32_t dueCount = (entityCount - 1 - firstDue) / MOVEMENT_CYCLE_LENGTH + 1;
+    const uint32_t workgroupCount = (dueCount + activeWorkgroupSize - 1) / activeWorkgroupSize;
+    
+    // Cache loader reference for performance
+    const auto& vk = context->getLoader();
+    
+    ComputePushConstants duePushConstants = pushConstants;
+    duePushConstants.frame = tick;
+    duePushConstants.entityOffset = firstDue;
+    duePushConstants.entityStride = MOVEMENT_CYCLE_LENGTH;
+    
+    if (timeoutDetector) {
+        static const ProfileZoneId zone = Profiler::getInstance().registerZone("EntityMovement_Due");
+        timeoutDetector->beginComputeDispatch(commandBuffer, zone, workgroupCount);
+    }
+    
+    vk.vkCmdPushConstants(
+        commandBuffer, dispatch.layout, VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(ComputePushConstants), &duePushConstants);
+    
+    const glm::uvec2 grid = workgroupGrid(workgroupCount);
+    vk.vkCmdDispatch(commandBuffer, grid.x, grid.y, 1);
+    
+    if (timeoutDetector) {
+        timeoutDetector->endComputeDispatch(commandBuffer);
+    }
+    
+    FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 1800, "EntityComputeNode (Movement): " << dueCount << " due entities → " << workgroupCount << " workgroups");
+}
+
+void EntityComputeNode::executeIndirectDispatch(
+    VkCommandBuffer commandBuffer,
+    const VulkanContext* context,
+    const ComputeDispatch& dispatch) {
+    
+    // Cache loader reference for performance
+    const auto& vk = context->getLoader();
+    
+    ComputePushConstants indirectPushConstants = pushConstants;
+    indirectPushConstants.entityOffset = 0;
+    
+    vk.vkCmdPushConstants(
+        commandBuffer, dispatch.layout, VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(ComputePushConstants), &indirectPushConstants);
+    
+    if (timeoutDetector) {
+        static const ProfileZoneId zone = Profiler::getInstance().registerZone("EntityMovement_Indirect");
+        timeoutDetector->beginComputeDispatch(commandBuffer, zone, dispatch.groupCountX, true);
+    }
+    
+    // Workgroup count and the shader's bounds check both come from the live entity count on the GPU
+    vk.vkCmdDispatchIndirect(
+        commandBuffer, gpuEntityManager->getIndirectCommandBuffer(), gpuEntityManager->getIndirectDispatchOffset());
+    
+    if (timeoutDetector) {
+        timeoutDetector->endComputeDispatch(commandBuffer);
+    }
+}
+
+void EntityComputeNode::executeTypeDispatch(
+    VkCommandBuffer commandBuffer,
+    const FrameGraph& frameGraph,
+    const VulkanContext* context,
+    const ComputeDispatch& dispatch,
+    uint32_t entityCount) {
+    
+    if (!binReady) {
+        FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 1800, "EntityComputeNode: Movement binning pipeline not ready, skipping dispatch");
+        return;
+    }
+    
+    static const std::array<ProfileZoneId, MOVEMENT_TYPE_COUNT> kernelZones = []() {
+        std::array<ProfileZoneId, MOVEMENT_TYPE_COUNT> zones{};
+        for (uint32_t type = 0; type < MOVEMENT_TYPE_COUNT; ++type) {
+            zones[type] = Profiler::getInstance().registerZone(MOVEMENT_KERNELS[type].name);
+        }
+        return zones;
+    }();
+    
+    const auto& vk = context->getLoader();
+    const auto& barriers = frameGraph.getBarrierManager();
+    const SimulationStep& simulation = frameGraph.getSimulationStep();
+    VkBuffer indirectBuffer = gpuEntityManager->getIndirectCommandBuffer();
+    auto bindDescriptors = [&](VkPipelineLayout layout) {
+        if (!dispatch.descriptorSets.empty()) {
+            vk.vkCmdBindDescriptorSets(
+                commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, layout,
+                0, 1, &dispatch.descriptorSets[0], 0, nullptr);
+        }
+    };
+    
+    // Last frame's type dispatches and this frame's earlier scratch users are done with the lists and arguments, and
+    // last frame's generated commands with the sequences and preprocess buffer the generating pass reuses
+    VkPipelineStageFlags2KHR lastUseStages = VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR;
+    VkAccessFlags2KHR lastUseAccess = VK_ACCESS_2_SHADER_WRITE_BIT_KHR;
+    if (commandsReady) {
+        lastUseStages |= GeneratedComputeCommands::CONSUMER_STAGES;
+        lastUseAccess |= VK_ACCESS_2_COMMAND_PREPROCESS_WRITE_BIT_EXT;
+    }
+    barriers.insertMemoryBarrier(
+        commandBuffer, lastUseStages, lastUseAccess,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+    std::array<uint32_t, 4 * MOVEMENT_TYPE_COUNT> reset{};  // Type dispatches (0, 1, 1), then the type counts
+    for (uint32_t type = 0; type < MOVEMENT_TYPE_COUNT; ++type) {
+        reset[type * 3 + 1] = 1u;
+        reset[type * 3 + 2] = 1u;
+    }
+    vk.vkCmdUpdateBuffer(commandBuffer, indirectBuffer, gpuEntityManager->getMovementDispatchOffset(0),
+                         sizeof(reset), reset.data());
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    
+    // New entities have had no update yet, so every random walker is listed, as the dense dispatch would run them
+    const uint32_t listStride = gpuEntityManager->getMaxEntities();
+    binPushConstants.firstTick = simulation.firstTick;
+    binPushConstants.tickCount = simulation.tickCount;
+    binPushConstants.listStride = listStride;
+    binPushConstants.workgroupSize = activeWorkgroupSize;
+    const uint64_t spawnGeneration = gpuEntityManager->getSpawnGeneration();
+    binPushConstants.dueOnly = spawnGeneration == lastDenseSpawnGeneration ? 1u : 0u;
+    binPushConstants.entityTable = pushConstants.entityTable;
+    lastDenseSpawnGeneration = spawnGeneration;
+    
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, binPipeline.getPipeline());
+    bindDescriptors(binPipeline.getLayout());
+    vk.vkCmdPushConstants(
+        commandBuffer, binPipeline.getLayout(), VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(MovementBinPushConstants), &binPushConstants);
+    
+    if (timeoutDetector) {
+        static const ProfileZoneId zone = Profiler::getInstance().registerZone("EntityMovement_Bin");
+        timeoutDetector->beginComputeDispatch(commandBuffer, zone, dispatch.groupCountX, true);
+    }
+    
+    // One thread per live entity, sized by the GPU-resident live count. The entity arguments are 1D, so past
+    // COMPUTE_MAX_WORKGROUPS_X the grid comes from the CPU count, which the live count never exceeds
+    const uint32_t binWorkgroups = (entityCount + THREADS_PER_WORKGROUP - 1) / THREADS_PER_WORKGROUP;
+    if (binWorkgroups <= COMPUTE_MAX_WORKGROUPS_X) {
+        vk.vkCmdDispatchIndirect(commandBuffer, indirectBuffer, gpuEntityManager->getIndirectDispatchOffset());
+    } else {
+        const glm::uvec2 grid = workgroupGrid(binWorkgroups);
+        vk.vkCmdDispatch(commandBuffer, grid.x, grid.y, 1);
+    }
+    
+    if (timeoutDetector) {
+        timeoutDetector->endComputeDispatch(commandBuffer);
+    }
+    
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR | VK_ACCESS_2_SHADER_READ_BIT_KHR);
+    
+    if (commandsReady) {
+        executeGeneratedCommands(commandBuffer, frameGraph, context, dispatch, listStride);
+        FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 1800, "EntityComputeNode (Movement): " << entityCount << " entities binned by type, "
+                                        << simulation.tickCount << " ticks from generated commands");
+        return;
+    }
+    
+    // The lists are disjoint, and MAX_SIMULATION_TICKS_PER_FRAME stays below MOVEMENT_CYCLE_LENGTH so no random
+    // walker is due on two ticks of a frame: none of these dispatches needs a barrier against another
+    for (uint32_t type = 0; type < MOVEMENT_TYPE_COUNT; ++type) {
+        if (!typeReady[type]) {
+            continue;
+        }
+        const MovementKernel& kernel = MOVEMENT_KERNELS[type];
+        const ComputePipelineHandle& typePipeline = typePipelines[type];
+        vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, typePipeline.getPipeline());
+        bindDescriptors(typePipeline.getLayout());
+        
+        ComputePushConstants typePushConstants = pushConstants;
+        typePushConstants.entityOffset = type * listStride;
+        typePushConstants.entityStride = 0;
+        const uint32_t dispatchCount = kernel.perTick ? simulation.tickCount : 1u;
+        if (!kernel.perTick) {
+            typePushConstants.deltaTime = simulation.tickSeconds * simulation.tickCount;
+        }
+        
+        for (uint32_t step = 0; step < dispatchCount; ++step) {
+            typePushConstants.frame = simulation.firstTick + step;
+            vk.vkCmdPushConstants(
+                commandBuffer, typePipeline.getLayout(), VK_SHADER_STAGE_COMPUTE_BIT,
+                0, sizeof(ComputePushConstants), &typePushConstants);
+            
+            if (timeoutDetector) {
+                timeoutDetector->beginComputeDispatch(commandBuffer, kernelZones[type], dispatch.groupCountX, true);
+            }
+            
+            vk.vkCmdDispatchIndirect(commandBuffer, indirectBuffer, gpuEntityManager->getMovementDispatchOffset(type));
+            
+            if (timeoutDetector) {
+                timeoutDetector->endComputeDispatch(commandBuffer);
             }
         }
     }
+    
+    FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 1800, "EntityComputeNode (Movement): " << entityCount << " entities binned by type, "
+                                    << simulation.tickCount << " ticks");
+}
+
+void EntityComputeNode::executeGeneratedCommands(
+    VkCommandBuffer commandBuffer,
+    const FrameGraph& frameGraph,
+    const VulkanContext* context,
+    const ComputeDispatch& dispatch,
+    uint32_t listStride) {
+    
+    const auto& vk = context->getLoader();
+    const auto& barriers = frameGraph.getBarrierManager();
+    const SimulationStep& simulation = frameGraph.getSimulationStep();
+    
+    // The same sequences the per-type loop records: the ticks of per-tick kernels, one frame step for the others
+    commandsPushConstants.indirectCommands = gpuEntityManager->getIndirectCommandAddress();
+    commandsPushConstants.sequences = generatedCommands.getSequenceAddress();
+    commandsPushConstants.entityTable = pushConstants.entityTable;
+    commandsPushConstants.time = pushConstants.time;
+    commandsPushConstants.tickSeconds = simulation.tickSeconds;
+    commandsPushConstants.entityCount = pushConstants.entityCount;
+    commandsPushConstants.firstTick = simulation.firstTick;
+    commandsPushConstants.tickCount = simulation.tickCount;
+    commandsPushConstants.listStride = listStride;
+    commandsPushConstants.maxSequences = generatedCommands.getMaxSequences();
+    commandsPushConstants.perTickMask = 0;
+    for (uint32_t type = 0; type < MOVEMENT_TYPE_COUNT; ++type) {
+        commandsPushConstants.perTickMask |= MOVEMENT_KERNELS[type].perTick ? (1u << type) : 0u;
+    }
+    
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, commandsPipeline.getPipeline());
+    vk.vkCmdPushConstants(
+        commandBuffer, commandsPipeline.getLayout(), VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(MovementCommandsPushConstants), &commandsPushConstants);
+    vk.vkCmdDispatch(commandBuffer, 1, 1, 1);
+    
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        GeneratedComputeCommands::CONSUMER_STAGES, GeneratedComputeCommands::CONSUMER_ACCESS);
+    
+    // Every kernel shares the layout, so the set bound here serves whichever pipeline a sequence selects
+    VkPipelineLayout layout = typePipelines[0].getLayout();
+    if (!dispatch.descriptorSets.empty()) {
+        vk.vkCmdBindDescriptorSets(
+            commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, layout,
+            0, 1, &dispatch.descriptorSets[0], 0, nullptr);
+    }
+    
+    // One zone for the whole execution: the CPU no longer knows which kernels run
+    if (timeoutDetector) {
+        static const ProfileZoneId zone = Profiler::getInstance().registerZone("EntityMovement_Generated");
+        timeoutDetector->beginComputeDispatch(commandBuffer, zone, dispatch.groupCountX, true);
+    }
+    
+    generatedCommands.execute(commandBuffer);
+    
+    if (timeoutDetector) {
+        timeoutDetector->endComputeDispatch(commandBuffer);
+    }
 }
 
 // Node lifecycle implementation
 bool EntityComputeNode::initializeNode(const FrameGraph& frameGraph) {
     // One-time initialization - validate dependencies
     if (!computeManager) {
-        std::cerr << "EntityComputeNode: ComputePipelineManager is null" << std::endl;
+        LOG_ERROR("EntityComputeNode: ComputePipelineManager is null");
         return false;
     }
     if (!gpuEntityManager) {
-        std::cerr << "EntityComputeNode: GPUEntityManager is null" << std::endl;
+        LOG_ERROR("EntityComputeNode: GPUEntityManager is null");
         return false;
     }
+    
+    // Replaced execution sets and buffers may still be read by frames in flight, as replaced pipelines may
+    const VulkanContext* context = frameGraph.getContext();
+    generatedCommandsSupported = ENABLE_MOVEMENT_TYPE_DISPATCH && context && context->supportsDeviceGeneratedCommands();
+    generatedCommands.initialize(context, computeManager->getCache()->getDeletionQueue());
     return true;
 }
 
@@ -301,9 +666,123 @@ void EntityComputeNode::prepareFrame(uint32_t frameIndex, float time, float delt
     currentTime = time;
     currentDeltaTime = deltaTime;
     
-    // Update push constants with timing data - frame counter will be set in execute()
+    // Update push constants with timing data - tick counter and step length are set in execute()
     pushConstants.time = time;
-    pushConstants.deltaTime = deltaTime;
+    
+    // Cache lookups mutate LRU state, so they stay here rather than in execute() (see supportsParallelRecording).
+    // The state is only rebuilt when the variant or a cache generation changes
+    const uint32_t requestedWorkgroupSize = computeManager->getWorkgroupTuner()->getWorkgroupSize("movement");
+    const uint64_t variant = gpuEntityManager->getComputeVariantKey();
+    if (ENABLE_MOVEMENT_TYPE_DISPATCH) {
+        prepareTypePipelines(variant, requestedWorkgroupSize);
+        return;
+    }
+    auto buildState = [this](uint32_t workgroupSize) {
+        return [this, workgroupSize]() {
+            auto layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
+            VkDescriptorSetLayout descriptorLayout = computeManager->getLayoutManager()->getLayout(layoutSpec);
+            ComputePipelineState state = ComputePipelinePresets::createEntityMovementState(descriptorLayout, gpuEntityManager->isCompactLayout());
+            const auto& descriptorManager = gpuEntityManager->getDescriptorManager();
+            if (descriptorManager.usesStreamAddresses()) {
+                ComputePipelinePresets::applyEntityStreamAddresses(state);
+            } else if (descriptorManager.isBindless()) {
+                ComputePipelinePresets::applyBindlessEntityTable(state, descriptorManager.getBindlessTableLayout());
+            }
+            if (computeManager->getDeviceInfo()->supportsSubgroupOperations()) {
+                ComputePipelinePresets::applySubgroupBallot(state);
+            }
+            ComputePipelinePresets::applyWorkgroupSize(state, workgroupSize);
+            return state;
+        };
+    };
+    
+    // Never compiles here: until the background compile lands, execute() skips the dispatch and entities hold still.
+    // A tuned size still compiling runs on the previously resolved size, or the default one before any; the
+    // layout and binding mode bits must match what is bound
+    auto matchesVariant = [this, variant]() {
+        return movementPipeline.isReady() && (movementPipeline.getKey() & 0xFF) == variant;
+    };
+    if (!movementPipeline.resolve(*computeManager, variant | (uint64_t(requestedWorkgroupSize) << 8), buildState(requestedWorkgroupSize)) &&
+        !matchesVariant() && requestedWorkgroupSize != THREADS_PER_WORKGROUP) {
+        movementPipeline.resolve(*computeManager, variant | (uint64_t(THREADS_PER_WORKGROUP) << 8), buildState(THREADS_PER_WORKGROUP));
+    }
+    const bool ready = matchesVariant();
+    pipeline = ready ? movementPipeline.getPipeline() : VK_NULL_HANDLE;
+    pipelineLayout = ready ? movementPipeline.getLayout() : VK_NULL_HANDLE;
+    activeWorkgroupSize = ready ? movementPipeline.getState().workgroupSizeX : THREADS_PER_WORKGROUP;
+}
+
+void EntityComputeNode::prepareTypePipelines(uint64_t variant, uint32_t requestedWorkgroupSize) {
+    const auto& descriptorManager = gpuEntityManager->getDescriptorManager();
+    auto applyBindingMode = [&descriptorManager](ComputePipelineState& state) {
+        if (descriptorManager.usesStreamAddresses()) {
+            ComputePipelinePresets::applyEntityStreamAddresses(state);
+        } else if (descriptorManager.isBindless()) {
+            ComputePipelinePresets::applyBindlessEntityTable(state, descriptorManager.getBindlessTableLayout());
+        }
+    };
+    auto getDescriptorLayout = [this]() {
+        auto layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
+        return computeManager->getLayoutManager()->getLayout(layoutSpec);
+    };
+    
+    binReady = binPipeline.resolve(*computeManager, variant, [&]() {
+        ComputePipelineState state = ComputePipelinePresets::createMovementBinState(getDescriptorLayout());
+        applyBindingMode(state);
+        return state;
+    });
+    
+    // Every kernel runs at the size the binning pass sizes the dispatches for. Until all of them have a tuned size
+    // compiled, the default size runs; like the single movement kernel, this never compiles here
+    auto resolveKernels = [&](uint32_t workgroupSize) {
+        bool allReady = true;
+        for (uint32_t type = 0; type < MOVEMENT_TYPE_COUNT; ++type) {
+            typeReady[type] = typePipelines[type].resolve(*computeManager, variant | (uint64_t(workgroupSize) << 8), [&, type]() {
+                ComputePipelineState state = ComputePipelinePresets::createMovementTypeState(
+                    getDescriptorLayout(), MOVEMENT_KERNELS[type].shaderPath, gpuEntityManager->isCompactLayout());
+                applyBindingMode(state);
+                if (computeManager->getDeviceInfo()->supportsSubgroupOperations()) {
+                    ComputePipelinePresets::applySubgroupBallot(state);  // Random walk counter updates
+                }
+                ComputePipelinePresets::applyWorkgroupSize(state, workgroupSize);
+                if (generatedCommandsSupported) {
+                    ComputePipelinePresets::applyIndirectBindable(state);
+                }
+                return state;
+            });
+            allReady = allReady && typeReady[type];
+        }
+        return allReady;
+    };
+    activeWorkgroupSize = requestedWorkgroupSize;
+    if (!resolveKernels(requestedWorkgroupSize) && requestedWorkgroupSize != THREADS_PER_WORKGROUP) {
+        activeWorkgroupSize = THREADS_PER_WORKGROUP;
+        resolveKernels(THREADS_PER_WORKGROUP);
+    }
+    prepareGeneratedCommands();
+}
+
+void EntityComputeNode::prepareGeneratedCommands() {
+    commandsReady = false;
+    if (!generatedCommandsSupported || gpuEntityManager->getIndirectCommandAddress() == 0) {
+        return;
+    }
+    const bool generatorReady = commandsPipeline.resolve(*computeManager, 0, []() {
+        return ComputePipelinePresets::createMovementCommandsState();
+    });
+    
+    // A kernel still compiling leaves the frame on the per-type loop, which skips it; the execution set is only
+    // rebuilt when the resolved pipelines change
+    std::vector<VkPipeline> pipelines;
+    for (uint32_t type = 0; type < MOVEMENT_TYPE_COUNT; ++type) {
+        if (!typeReady[type] || typePipelines[type].getLayout() != typePipelines[0].getLayout()) {
+            return;
+        }
+        pipelines.push_back(typePipelines[type].getPipeline());
+    }
+    commandsReady = generatorReady && generatedCommands.prepare(
+        pipelines, typePipelines[0].getLayout(), sizeof(ComputePushConstants),
+        MOVEMENT_TYPE_COUNT * MAX_SIMULATION_FAST_FORWARD_TICKS_PER_FRAME);
 }
 
 void EntityComputeNode::releaseFrame(uint32_t frameIndex) {
@@ -5,6 +5,9 @@
 #include "../rendering/frame_graph.h"
 #include "../rendering/frame_graph_debug.h"
 #include "../core/vulkan_constants.h"
+#include "../pipelines/compute_pipeline_handle.h"
+#include "../pipelines/generated_compute_commands.h"
+#include <array>
 #include <memory>
 
 // Forward declarations
@@ -32,15 +35,42 @@ public:
     void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
     
     // Queue requirements
-    bool needsComputeQueue() const override { return true; }
-    bool needsGraphicsQueue() const override { return false; }
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::AsyncCompute; }
+    
+    // Off on frames where no entity starts a movement cycle and none are new. Under movement type dispatch only
+    // off between ticks: the type lists are rebuilt on the GPU, so the CPU cannot tell when they are empty
+    bool isEnabled(const FrameContext& frameContext) const override;
+    
+    // Pipeline resolution happens in prepareFrame(); the timeout detector is not safe to share across lanes
+    bool supportsParallelRecording() const override { return !timeoutDetector; }
+    
+    // Invocation counts show how much of the dense array the cycle scheduling actually touches
+    bool wantsPipelineStatistics() const override { return true; }
+    float getBytesPerEntity() const override;
     
     // Node lifecycle - standardized pattern
     bool initializeNode(const FrameGraph& frameGraph) override;
     void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
     void releaseFrame(uint32_t frameIndex) override;
+    
+    // Indirect dispatch reads workgroup counts from GPUEntityManager's indirect command buffer
+    void setIndirectDispatch(bool enabled) { useIndirectDispatch = enabled; }
 
 private:
+    // A movement behaviour under movement type dispatch (ENABLE_MOVEMENT_TYPE_DISPATCH); indexed by MovementType,
+    // so a new behaviour is an entry here plus its kernel. Lists hold entities of one type only, and kernels
+    // run over them through that type's indirect arguments, so no wavefront mixes behaviours
+    struct MovementKernel {
+        const char* name;        // Profiler zone
+        const char* shaderPath;
+        bool perTick;            // One dispatch per simulation tick, else one per frame covering all its ticks
+    };
+    static constexpr std::array<MovementKernel, MOVEMENT_TYPE_COUNT> MOVEMENT_KERNELS = {{
+        {"EntityMovement_RandomWalk", "shaders/movement_random.comp.spv", true},
+        {"EntityMovement_Orbit", "shaders/movement_orbit.comp.spv", false},
+        {"EntityMovement_FlowField", "shaders/movement_flow.comp.spv", false},
+    }};
+    
     // Dispatch parameters struct
     struct DispatchParams {
         uint32_t totalWorkgroups;
@@ -57,6 +87,47 @@ private:
         uint32_t maxWorkgroupsPerChunk,
         uint32_t entityCount);
     
+    // Halves or doubles adaptiveMaxWorkgroups from the node's measured GPU time
+    void adaptChunkingToGpuTime(const FrameGraphExecution::NodeGpuTiming* timing);
+    
+    // Hands each full timing window to the ComputeWorkgroupTuner
+    void tuneWorkgroupSize(const FrameGraphExecution::NodeGpuTiming* timing, uint32_t entityCount);
+    
+    // Helper method for a single dispatch sized from the GPU-resident entity count
+    void executeIndirectDispatch(
+        VkCommandBuffer commandBuffer,
+        const VulkanContext* context,
+        const class ComputeDispatch& dispatch);
+    
+    // Helper method for dispatching only entities whose movement cycle restarts on the given simulation tick
+    void executeDueEntityDispatch(
+        VkCommandBuffer commandBuffer,
+        const VulkanContext* context,
+        const class ComputeDispatch& dispatch,
+        uint32_t entityCount,
+        uint32_t tick);
+    
+    // Movement type dispatch: bins the frame's movers by type, then runs each ready kernel over its own list - from
+    // sequences movement_commands.comp generates when device-generated commands are ready, else per type from here
+    void executeTypeDispatch(
+        VkCommandBuffer commandBuffer,
+        const FrameGraph& frameGraph,
+        const VulkanContext* context,
+        const class ComputeDispatch& dispatch,
+        uint32_t entityCount);
+    
+    // Resolves the binning pipeline and every type kernel at one workgroup size, then the generated commands over them
+    void prepareTypePipelines(uint64_t variant, uint32_t requestedWorkgroupSize);
+    void prepareGeneratedCommands();
+    
+    // Writes the frame's sequences and executes them; the binning pass's barrier must already be recorded
+    void executeGeneratedCommands(
+        VkCommandBuffer commandBuffer,
+        const FrameGraph& frameGraph,
+        const VulkanContext* context,
+        const class ComputeDispatch& dispatch,
+        uint32_t listStride);
+    
     FrameGraphTypes::ResourceId entityBufferId;
     FrameGraphTypes::ResourceId positionBufferId;
     FrameGraphTypes::ResourceId currentPositionBufferId;
@@ -67,9 +138,34 @@ private:
     GPUEntityManager* gpuEntityManager;
     std::shared_ptr<GPUTimeoutDetector> timeoutDetector;
     
+    // Resolved in prepareFrame() from the shared pipeline caches
+    ComputePipelineHandle movementPipeline;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    uint32_t activeWorkgroupSize = THREADS_PER_WORKGROUP;  // local_size_x of the resolved pipeline
+    
+    // Movement type dispatch; a kernel not current at activeWorkgroupSize is skipped and its entities hold still
+    ComputePipelineHandle binPipeline;
+    std::array<ComputePipelineHandle, MOVEMENT_TYPE_COUNT> typePipelines;
+    std::array<bool, MOVEMENT_TYPE_COUNT> typeReady{};
+    bool binReady = false;
+    
+    // Device-generated commands (VulkanContext::supportsDeviceGeneratedCommands); only used with every kernel ready
+    GeneratedComputeCommands generatedCommands;
+    ComputePipelineHandle commandsPipeline;
+    bool generatedCommandsSupported = false;
+    bool commandsReady = false;
+    
     // Adaptive dispatch parameters
     uint32_t adaptiveMaxWorkgroups = MAX_WORKGROUPS_PER_CHUNK;
-    bool forceChunkedDispatch = true;     // Always use chunking for stability
+    uint64_t lastChunkAdaptSample = 0;    // Timing sample count at the last chunk size decision
+    uint64_t lastTuneSample = 0;          // Timing sample count at the last window reported to the tuner
+    bool forceChunkedDispatch = false;    // Chunk every dense dispatch, not only when TDR protection asks
+    bool useIndirectDispatch = true;      // Size from GPU live entity count unless the timeout detector intervenes
+    
+    // Dense dispatch is needed whenever new (uninitialized) entities appear: GPUEntityManager::getSpawnGeneration
+    // at the last dense pass. Starts past any generation, so the first frame with entities runs dense
+    uint64_t lastDenseSpawnGeneration = ~0ULL;
     
     // Debug counter - zero overhead in release builds
     mutable FrameGraphDebug::DebugCounter debugCounter{};
@@ -84,7 +180,35 @@ private:
         float deltaTime;
         uint32_t entityCount;
         uint32_t frame;
-        uint32_t entityOffset;  // For chunked dispatches
-        uint32_t padding[3];    // Ensure 16-byte alignment
+        uint32_t entityOffset;  // For chunked dispatches, first due entity in due-only mode, or start of the type list
+        uint32_t entityStride;  // 0 = dense dispatch, MOVEMENT_CYCLE_LENGTH = due-only dispatch
+        uint64_t entityTable;   // Bindless table view or stream address table of the working buffers
     } pushConstants{};
+    
+    // Must match movement_bin.comp
+    struct MovementBinPushConstants {
+        uint32_t firstTick;
+        uint32_t tickCount;
+        uint32_t listStride;     // Entries reserved per type list in the reorder scratch buffer
+        uint32_t workgroupSize;  // activeWorkgroupSize, which the type dispatches are sized for
+        uint32_t dueOnly;        // 0 = list every random walker, as the dense dispatch would
+        uint32_t padding0;
+        uint64_t entityTable;
+    } binPushConstants{};
+    
+    // Must match movement_commands.comp
+    struct MovementCommandsPushConstants {
+        uint64_t indirectCommands;
+        uint64_t sequences;
+        uint64_t entityTable;
+        float time;
+        float tickSeconds;
+        uint32_t entityCount;
+        uint32_t firstTick;
+        uint32_t tickCount;
+        uint32_t listStride;
+        uint32_t perTickMask;    // Bit per MovementType whose kernel is perTick
+        uint32_t maxSequences;
+    } commandsPushConstants{};
+    static_assert(sizeof(MovementCommandsPushConstants) == 56, "EntityComputeNode::MovementCommandsPushConstants must match movement_commands.comp");
 };
\ No newline at end of file
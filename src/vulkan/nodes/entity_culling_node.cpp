@@ -0,0 +1,300 @@
+#include "entity_culling_node.h"
+#include "../pipelines/compute_pipeline_manager.h"
+#include "../../ecs/gpu/gpu_entity_manager.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../core/vulkan_constants.h"
+#include "../pipelines/descriptor_layout_manager.h"
+#include "../monitoring/gpu_timeout_detector.h"
+#include "../../ecs/utilities/logger.h"
+#include <algorithm>
+#include <stdexcept>
+#include <memory>
+
+EntityCullingNode::EntityCullingNode(
+    FrameGraphTypes::ResourceId positionBuffer,
+    FrameGraphTypes::ResourceId spatialIndexBuffer,
+    FrameGraphTypes::ResourceId visibleIndexBuffer,
+    FrameGraphTypes::ResourceId visibleDrawCommandBuffer,
+    ComputePipelineManager* computeManager,
+    GPUEntityManager* gpuEntityManager,
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector
+) : positionBufferId(positionBuffer)
+  , spatialIndexBufferId(spatialIndexBuffer)
+  , visibleIndexBufferId(visibleIndexBuffer)
+  , visibleDrawCommandBufferId(visibleDrawCommandBuffer)
+  , computeManager(computeManager)
+  , gpuEntityManager(gpuEntityManager)
+  , timeoutDetector(timeoutDetector) {
+    
+    // Validate dependencies during construction for fail-fast behavior
+    if (!computeManager) {
+        throw std::invalid_argument("EntityCullingNode: computeManager cannot be null");
+    }
+    if (!gpuEntityManager) {
+        throw std::invalid_argument("EntityCullingNode: gpuEntityManager cannot be null");
+    }
+}
+
+std::vector<ResourceDependency> EntityCullingNode::getInputs() const {
+    return {
+        {positionBufferId, ResourceAccess::Read, PipelineStage::ComputeShader},
+        {spatialIndexBufferId, ResourceAccess::Read, PipelineStage::ComputeShader},
+    };
+}
+
+std::vector<ResourceDependency> EntityCullingNode::getOutputs() const {
+    return {
+        {visibleIndexBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+        {visibleDrawCommandBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+    };
+}
+
+void EntityCullingNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    // Validate dependencies are still valid
+    if (!computeManager || !gpuEntityManager) {
+        LOG_ERROR("EntityCullingNode: Critical error - dependencies became null during execution");
+        return;
+    }
+    
+    const VulkanContext* context = frameGraph.getContext();
+    if (!context) {
+        LOG_ERROR("EntityCullingNode: Cannot get Vulkan context");
+        return;
+    }
+    
+    const bool expandedDraw = gpuEntityManager->isExpandedDraw();
+    const bool gridOrder = ENABLE_ENTITY_EARLY_DEPTH && gridOrderAvailable;
+    const bool shapeBinned = gpuEntityManager->isShapeBinned();
+    const uint64_t variant = gpuEntityManager->getComputeVariantKey() | (expandedDraw ? 8u : 0u) | (gridOrder ? 16u : 0u) |
+                             (shapeBinned ? 32u : 0u);
+    const auto& descriptorManager = gpuEntityManager->getDescriptorManager();
+    auto retarget = [&](ComputePipelineState& state) {
+        if (descriptorManager.usesStreamAddresses()) {
+            ComputePipelinePresets::applyEntityStreamAddresses(state);
+        } else if (descriptorManager.isBindless()) {
+            ComputePipelinePresets::applyBindlessEntityTable(state, descriptorManager.getBindlessTableLayout());
+        }
+        if (computeManager->getDeviceInfo()->supportsSubgroupOperations()) {
+            ComputePipelinePresets::applySubgroupBallot(state);
+        }
+    };
+    const bool resolved = cullingPipeline.resolveBlocking(*computeManager, variant, [&]() {
+        auto layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
+        VkDescriptorSetLayout descriptorLayout = computeManager->getLayoutManager()->getLayout(layoutSpec);
+        ComputePipelineState state = ComputePipelinePresets::createFrustumCullingState(
+            descriptorLayout, expandedDraw, gridOrder, shapeBinned);
+        retarget(state);
+        return state;
+    });
+    const bool binningResolved = !shapeBinned || binningPipeline.resolveBlocking(*computeManager, variant, [&]() {
+        auto layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
+        VkDescriptorSetLayout descriptorLayout = computeManager->getLayoutManager()->getLayout(layoutSpec);
+        ComputePipelineState state = ComputePipelinePresets::createEntityBinningState(descriptorLayout);
+        retarget(state);
+        return state;
+    });
+    if (!resolved || !binningResolved) {
+        LOG_ERROR("EntityCullingNode: Failed to get culling pipeline or layout");
+        return;
+    }
+    VkPipeline pipeline = cullingPipeline.getPipeline();
+    VkPipelineLayout pipelineLayout = cullingPipeline.getLayout();
+    
+    VkDescriptorSet computeDescriptorSet = descriptorManager.getEntityComputeSet();
+    if (computeDescriptorSet == VK_NULL_HANDLE && !descriptorManager.usesStreamAddresses()) {
+        LOG_ERROR("EntityCullingNode: ERROR - Missing compute descriptor set!");
+        return;
+    }
+    
+    const uint32_t entityCount = gpuEntityManager->getEntityCount();
+    pushConstants.entityCount = entityCount;
+    pushConstants.entityTable = descriptorManager.getWorkingTable();
+    
+    // Without camera views yet, a single pass accepts every entity
+    const uint32_t viewportCount = std::clamp(static_cast<uint32_t>(viewportCameras.size()), 1u, MAX_RENDER_VIEWPORTS);
+    auto viewProjectionOf = [&](uint32_t viewport) {
+        return viewport < viewportCameras.size() ? viewportCameras[viewport].viewProjection : glm::mat4(0.0f);
+    };
+    if (planesVersion != viewportCameraVersion || planesCullingEnabled != cullingEnabled) {
+        for (uint32_t viewport = 0; viewport < viewportCount; ++viewport) {
+            extractFrustumPlanes(viewProjectionOf(viewport), viewportPlanes[viewport]);
+        }
+        planesVersion = viewportCameraVersion;
+        planesCullingEnabled = cullingEnabled;
+    }
+    densityTiles = viewportCount == 1 && selectDensityTiles(viewProjectionOf(0), entityCount);
+    pushConstants.densityTiles = densityTiles ? 1u : 0u;
+    gpuEntityManager->setDensityTilesCulled(densityTiles);
+    
+    // Cache loader reference for performance
+    const auto& vk = context->getLoader();
+    const auto& barriers = frameGraph.getBarrierManager();
+    VkBuffer visibleDrawBuffer = gpuEntityManager->getVisibleDrawCommandBuffer();
+    
+    // Previous frame's culled draw must be done reading the counter before it is reset
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR, 0,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, 0);
+    
+    if (shapeBinned) {
+        // Every shape's instance count, then the draw count and the binning counters behind the draws
+        for (uint32_t shape = 0; shape < ENTITY_SHAPE_COUNT; ++shape) {
+            vk.vkCmdFillBuffer(
+                commandBuffer, visibleDrawBuffer, VisibleDrawCommandBuffer::getShapeInstanceCountOffset(shape), sizeof(uint32_t), 0);
+        }
+        vk.vkCmdFillBuffer(
+            commandBuffer, visibleDrawBuffer, VisibleDrawCommandBuffer::getDrawCountOffset(),
+            sizeof(VisibleDrawCommands) - VisibleDrawCommandBuffer::getDrawCountOffset(), 0);
+    } else {
+        vk.vkCmdFillBuffer(
+            commandBuffer, visibleDrawBuffer, gpuEntityManager->getVisibleDrawCounterOffset(), sizeof(uint32_t), 0);
+    }
+    if (densityTiles) {
+        vk.vkCmdFillBuffer(
+            commandBuffer, gpuEntityManager->getVisibleIndexBuffer(), 0, ENTITY_LOD_TILE_COUNT * sizeof(uint32_t), 0);
+    }
+    
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    
+    FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 1800, "EntityCullingNode: culling " << entityCount << " entities (enabled: " << cullingEnabled << ")");
+    
+    // An empty world still needs the reset above so the culled draw emits zero instances
+    if (entityCount > 0) {
+        vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+        if (computeDescriptorSet != VK_NULL_HANDLE) {
+            vk.vkCmdBindDescriptorSets(
+                commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout,
+                0, 1, &computeDescriptorSet, 0, nullptr);
+        }
+        
+        const uint32_t workgroupCount = (entityCount + THREADS_PER_WORKGROUP - 1) / THREADS_PER_WORKGROUP;
+        for (uint32_t viewport = 0; viewport < viewportCount; ++viewport) {
+            // Each pass reads the viewport mask the previous one left per entity
+            if (viewport > 0) {
+                barriers.insertMemoryBarrier(
+                    commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+                    VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+            }
+            
+            std::copy(viewportPlanes[viewport].begin(), viewportPlanes[viewport].end(), pushConstants.planes);
+            pushConstants.viewportPass = viewport | (viewportCount << 8);
+            vk.vkCmdPushConstants(
+                commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+                0, sizeof(CullingPushConstants), &pushConstants);
+            
+            if (timeoutDetector) {
+                static const ProfileZoneId zone = Profiler::getInstance().registerZone("EntityCulling");
+                timeoutDetector->beginComputeDispatch(commandBuffer, zone, workgroupCount);
+            }
+            
+            // Shares the entity dispatch arguments, sized from the GPU-resident live count
+            vk.vkCmdDispatchIndirect(
+                commandBuffer, gpuEntityManager->getIndirectCommandBuffer(), gpuEntityManager->getIndirectDispatchOffset());
+            
+            if (timeoutDetector) {
+                timeoutDetector->endComputeDispatch(commandBuffer);
+            }
+        }
+        
+        // Density tiles leave nothing in the list; the binning pass needs every workgroup's shape counts
+        if (shapeBinned && !densityTiles) {
+            barriers.insertMemoryBarrier(
+                commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+            
+            vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, binningPipeline.getPipeline());
+            if (computeDescriptorSet != VK_NULL_HANDLE) {
+                vk.vkCmdBindDescriptorSets(
+                    commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, binningPipeline.getLayout(),
+                    0, 1, &computeDescriptorSet, 0, nullptr);
+            }
+            vk.vkCmdPushConstants(
+                commandBuffer, binningPipeline.getLayout(), VK_SHADER_STAGE_COMPUTE_BIT,
+                0, sizeof(CullingPushConstants), &pushConstants);
+            vk.vkCmdDispatchIndirect(
+                commandBuffer, gpuEntityManager->getIndirectCommandBuffer(), gpuEntityManager->getIndirectDispatchOffset());
+        }
+    }
+    
+    // Visible indices feed the vertex shader, the counted draw feeds the indirect draw
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR,
+        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR | VK_ACCESS_2_SHADER_READ_BIT_KHR);
+}
+
+void EntityCullingNode::extractFrustumPlanes(const glm::mat4& viewProjection, FrustumPlanes& planes) const {
+    const glm::mat4 viewProj = cullingEnabled ? viewProjection : glm::mat4(0.0f);
+    
+    // No camera (or culling disabled): planes with zero normal and positive distance accept everything
+    if (viewProj == glm::mat4(0.0f)) {
+        for (auto& plane : planes) {
+            plane = glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+        }
+        return;
+    }
+    
+    // GLM is column-major, so row i of the matrix is (m[0][i], m[1][i], m[2][i], m[3][i])
+    const glm::vec4 row0(viewProj[0][0], viewProj[1][0], viewProj[2][0], viewProj[3][0]);
+    const glm::vec4 row1(viewProj[0][1], viewProj[1][1], viewProj[2][1], viewProj[3][1]);
+    const glm::vec4 row2(viewProj[0][2], viewProj[1][2], viewProj[2][2], viewProj[3][2]);
+    const glm::vec4 row3(viewProj[0][3], viewProj[1][3], viewProj[2][3], viewProj[3][3]);
+    
+    // Near uses the -w..w depth range, a superset of Vulkan's 0..w, so culling stays conservative
+    planes[0] = row3 + row0;  // left
+    planes[1] = row3 - row0;  // right
+    planes[2] = row3 + row1;  // bottom
+    planes[3] = row3 - row1;  // top
+    planes[4] = row3 + row2;  // near
+    planes[5] = row3 - row2;  // far
+    
+    // Normalize so the shader can compare signed distances against a world-space radius
+    for (auto& plane : planes) {
+        float length = glm::length(glm::vec3(plane));
+        plane = length > 0.0f ? plane / length : glm::vec4(0.0f, 0.0f, 0.0f, 1.0f);
+    }
+}
+
+bool EntityCullingNode::selectDensityTiles(const glm::mat4& viewProjection, uint32_t entityCount) {
+    // The tile mapping reads screen position off opposite plane pairs, which only an affine projection keeps
+    // proportional; too few entities leave the visible index buffer and its snapshot copy shorter than the tiles
+    const bool orthographic = viewProjection[0][3] == 0.0f && viewProjection[1][3] == 0.0f &&
+                              viewProjection[2][3] == 0.0f && viewProjection[3][3] == 1.0f;
+    if (!ENABLE_DENSITY_LOD || !cullingEnabled || !orthographic || renderHeight == 0 ||
+        entityCount < ENTITY_LOD_TILE_COUNT) {
+        return false;
+    }
+    
+    // Clip-space y spans 2 over the render height, so an entity's diameter in pixels is its world diameter
+    // times the y row's scale times half the height
+    const float clipScale = glm::length(glm::vec3(viewProjection[0][1], viewProjection[1][1], viewProjection[2][1]));
+    const float pixelSize = GPU_CULLING_ENTITY_RADIUS * clipScale * static_cast<float>(renderHeight);
+    const float threshold = densityTiles ? densityLodThreshold * ENTITY_LOD_HYSTERESIS : densityLodThreshold;
+    return pixelSize < threshold;
+}
+
+// Node lifecycle implementation
+bool EntityCullingNode::initializeNode(const FrameGraph& frameGraph) {
+    // One-time initialization - validate dependencies
+    if (!computeManager) {
+        LOG_ERROR("EntityCullingNode: ComputePipelineManager is null");
+        return false;
+    }
+    if (!gpuEntityManager) {
+        LOG_ERROR("EntityCullingNode: GPUEntityManager is null");
+        return false;
+    }
+    pushConstants.radius = GPU_CULLING_ENTITY_RADIUS;
+    return true;
+}
+
+void EntityCullingNode::prepareFrame(uint32_t frameIndex, float time, float deltaTime) {
+    // Frustum planes are refreshed in execute() from the current camera
+}
+
+void EntityCullingNode::releaseFrame(uint32_t frameIndex) {
+    // Per-frame cleanup - nothing to clean up for culling node
+}
@@ -0,0 +1,128 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/frame_graph.h"
+#include "../rendering/frame_graph_debug.h"
+#include "../core/vulkan_constants.h"
+#include "../rendering/viewport_camera.h"
+#include "../pipelines/compute_pipeline_handle.h"
+#include <glm/glm.hpp>
+#include <array>
+#include <memory>
+#include <vector>
+
+// Forward declarations
+class ComputePipelineManager;
+class GPUEntityManager;
+class GPUTimeoutDetector;
+
+// Tests every entity position against the camera frustum and compacts the survivors into
+// the visible index buffer, building the instanceCount of the culled indirect draw on the GPU.
+// Zoomed out past the density LOD threshold it counts entities per screen tile there instead.
+// Several viewports cull in one pass each and list every entity once, tagged with the viewports that see it.
+// Runs after PhysicsComputeNode and before EntityGraphicsNode.
+class EntityCullingNode : public FrameGraphNode {
+    DECLARE_FRAME_GRAPH_NODE(EntityCullingNode)
+    
+public:
+    EntityCullingNode(
+        FrameGraphTypes::ResourceId positionBuffer,
+        FrameGraphTypes::ResourceId spatialIndexBuffer,
+        FrameGraphTypes::ResourceId visibleIndexBuffer,
+        FrameGraphTypes::ResourceId visibleDrawCommandBuffer,
+        ComputePipelineManager* computeManager,
+        GPUEntityManager* gpuEntityManager,
+        std::shared_ptr<GPUTimeoutDetector> timeoutDetector = nullptr
+    );
+    
+    // FrameGraphNode interface
+    std::vector<ResourceDependency> getInputs() const override;
+    std::vector<ResourceDependency> getOutputs() const override;
+    void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
+    
+    // Only frames that draw need the visible list
+    bool isEnabled(const FrameContext& frameContext) const override { return frameContext.presenting; }
+    
+    // Queue requirements
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::AsyncCompute; }
+    
+    // Position read and visible index write, in slot order (cell order adds a 4-byte sorted index read)
+    float getBytesPerEntity() const override { return 20.0f; }
+    
+    // Node lifecycle - standardized pattern
+    bool initializeNode(const FrameGraph& frameGraph) override;
+    void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
+    void releaseFrame(uint32_t frameIndex) override;
+    
+    // Disabling keeps the compaction pass but accepts every entity (useful for debugging)
+    void setCullingEnabled(bool enabled) { cullingEnabled = enabled; }
+    bool isCullingEnabled() const { return cullingEnabled; }
+    
+    // Camera views for this frame, one culling pass each (up to MAX_RENDER_VIEWPORTS); a zero view-projection
+    // (no camera) accepts every entity. Views are only copied, and planes re-extracted, when version changes
+    void setViewportCameras(const std::vector<ViewportCamera>& cameras, uint64_t version) {
+        if (version != viewportCameraVersion) {
+            viewportCameras = cameras;
+            viewportCameraVersion = version;
+        }
+    }
+    
+    // Whether the spatial grid sorted this frame's entities, so the culling pass can walk them in cell order
+    // (ENABLE_ENTITY_EARLY_DEPTH); frames without a simulation tick keep slot order
+    void setGridOrderAvailable(bool available) { gridOrderAvailable = available; }
+    
+    // Height in pixels of the target the entities are drawn to, for the density LOD pixel size estimate
+    void setRenderHeight(uint32_t height) { renderHeight = height; }
+    
+    // Projected entity size in pixels below which the heat map replaces the entities (ENTITY_LOD_PIXEL_THRESHOLD)
+    void setDensityLodThreshold(float pixels) { densityLodThreshold = pixels; }
+    bool isDrawingDensityTiles() const { return densityTiles; }
+
+private:
+    using FrustumPlanes = std::array<glm::vec4, 6>;
+    
+    // Gribb-Hartmann plane extraction from a camera view-projection matrix
+    void extractFrustumPlanes(const glm::mat4& viewProjection, FrustumPlanes& planes) const;
+    
+    // Density LOD switch with hysteresis, from the projected entity size under an orthographic camera
+    bool selectDensityTiles(const glm::mat4& viewProjection, uint32_t entityCount);
+    
+    FrameGraphTypes::ResourceId positionBufferId;
+    FrameGraphTypes::ResourceId spatialIndexBufferId;
+    FrameGraphTypes::ResourceId visibleIndexBufferId;
+    FrameGraphTypes::ResourceId visibleDrawCommandBufferId;
+    
+    // External dependencies (not owned) - validated during execution
+    ComputePipelineManager* computeManager;
+    GPUEntityManager* gpuEntityManager;
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector;
+    ComputePipelineHandle cullingPipeline;
+    ComputePipelineHandle binningPipeline;  // Shape binning only
+    
+    bool cullingEnabled = true;
+    bool gridOrderAvailable = false;
+    std::vector<ViewportCamera> viewportCameras;
+    uint64_t viewportCameraVersion = 0;
+    
+    // Planes per viewport pass, extracted for planesVersion and planesCullingEnabled and reused while neither changes
+    std::array<FrustumPlanes, MAX_RENDER_VIEWPORTS> viewportPlanes{};
+    uint64_t planesVersion = UINT64_MAX;
+    bool planesCullingEnabled = true;
+    uint32_t renderHeight = 0;
+    float densityLodThreshold = ENTITY_LOD_PIXEL_THRESHOLD;
+    bool densityTiles = false;
+    
+    // Debug counter - zero overhead in release builds
+    mutable FrameGraphDebug::DebugCounter debugCounter{};
+    
+    // Frustum data for compute shader
+    struct CullingPushConstants {
+        glm::vec4 planes[6];    // left, right, bottom, top, near, far
+        uint32_t entityCount;
+        float radius;
+        uint64_t entityTable;   // Bindless table view or stream address table of the working buffers
+        uint32_t densityTiles;  // Non-zero: count density LOD tiles instead of compacting
+        uint32_t viewportPass;  // Viewport index | viewport count << 8
+    } pushConstants{};
+};
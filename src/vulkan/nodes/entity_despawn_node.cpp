@@ -0,0 +1,226 @@
+#include "entity_despawn_node.h"
+#include "../pipelines/compute_pipeline_manager.h"
+#include "../../ecs/gpu/gpu_entity_manager.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../core/vulkan_constants.h"
+#include "../pipelines/descriptor_layout_manager.h"
+#include "../monitoring/gpu_timeout_detector.h"
+#include "../../ecs/utilities/logger.h"
+#include <stdexcept>
+#include <memory>
+
+namespace {
+    constexpr uint32_t DESPAWN_PHASE_MARK = 0;
+    constexpr uint32_t DESPAWN_PHASE_CLASSIFY = 1;
+    constexpr uint32_t DESPAWN_PHASE_MOVE = 2;
+    
+    // Reorder scratch word layout, must match entity_despawn.comp
+    constexpr VkDeviceSize DESPAWN_COUNTER_WORDS = 4;
+    constexpr VkDeviceSize DESPAWN_ID_BASE_WORD = DESPAWN_COUNTER_WORDS;
+    constexpr VkDeviceSize DESPAWN_MASK_BASE_WORD = DESPAWN_ID_BASE_WORD + 3 * ENTITY_DESPAWN_MAX_BATCH;
+}
+
+EntityDespawnNode::EntityDespawnNode(
+    FrameGraphTypes::ResourceId entityBuffer,
+    FrameGraphTypes::ResourceId positionBuffer,
+    FrameGraphTypes::ResourceId currentPositionBuffer,
+    ComputePipelineManager* computeManager,
+    GPUEntityManager* gpuEntityManager,
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector
+) : entityBufferId(entityBuffer)
+  , positionBufferId(positionBuffer)
+  , currentPositionBufferId(currentPositionBuffer)
+  , computeManager(computeManager)
+  , gpuEntityManager(gpuEntityManager)
+  , timeoutDetector(timeoutDetector) {
+    
+    // Validate dependencies during construction for fail-fast behavior
+    if (!computeManager) {
+        throw std::invalid_argument("EntityDespawnNode: computeManager cannot be null");
+    }
+    if (!gpuEntityManager) {
+        throw std::invalid_argument("EntityDespawnNode: gpuEntityManager cannot be null");
+    }
+}
+
+std::vector<ResourceDependency> EntityDespawnNode::getInputs() const {
+    // Declared unconditionally so later entity passes always order after this node, even on idle frames
+    return {
+        {entityBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+        {positionBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+        {currentPositionBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+    };
+}
+
+std::vector<ResourceDependency> EntityDespawnNode::getOutputs() const {
+    return {
+        {entityBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+        {positionBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+        {currentPositionBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+    };
+}
+
+bool EntityDespawnNode::isEnabled(const FrameContext& frameContext) const {
+    // Uploads committed this frame never add despawns, so the request queue is already final here. Compaction
+    // moves entities without their previous-tick positions, so requests wait for a frame that runs physics after it
+    if (frameContext.simulation.tickCount == 0) return false;
+    return !gpuEntityManager || gpuEntityManager->hasPendingDespawns();
+}
+
+void EntityDespawnNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    // Validate dependencies are still valid
+    if (!computeManager || !gpuEntityManager) {
+        LOG_ERROR("EntityDespawnNode: Critical error - dependencies became null during execution");
+        return;
+    }
+    
+    if (!gpuEntityManager->hasPendingDespawns()) {
+        return;
+    }
+    
+    const VulkanContext* context = frameGraph.getContext();
+    if (!context) {
+        LOG_ERROR("EntityDespawnNode: Cannot get Vulkan context");
+        return;
+    }
+    
+    const auto& descriptorManager = gpuEntityManager->getDescriptorManager();
+    const uint64_t variant = gpuEntityManager->getComputeVariantKey();
+    bool resolved = true;
+    for (uint32_t phase = DESPAWN_PHASE_MARK; phase <= DESPAWN_PHASE_MOVE; ++phase) {
+        resolved = phasePipelines[phase].resolveBlocking(*computeManager, variant, [&]() {
+            auto layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
+            VkDescriptorSetLayout descriptorLayout = computeManager->getLayoutManager()->getLayout(layoutSpec);
+            ComputePipelineState state = ComputePipelinePresets::createEntityDespawnState(
+                descriptorLayout, phase, gpuEntityManager->isCompactLayout());
+            if (descriptorManager.usesStreamAddresses()) {
+                ComputePipelinePresets::applyEntityStreamAddresses(state);
+            } else if (descriptorManager.isBindless()) {
+                ComputePipelinePresets::applyBindlessEntityTable(state, descriptorManager.getBindlessTableLayout());
+            }
+            if (computeManager->getDeviceInfo()->supportsSubgroupOperations()) {
+                ComputePipelinePresets::applySubgroupBallot(state);
+            }
+            return state;
+        }) && resolved;
+    }
+    
+    VkPipeline markPipeline = phasePipelines[DESPAWN_PHASE_MARK].getPipeline();
+    VkPipeline classifyPipeline = phasePipelines[DESPAWN_PHASE_CLASSIFY].getPipeline();
+    VkPipeline movePipeline = phasePipelines[DESPAWN_PHASE_MOVE].getPipeline();
+    VkPipelineLayout pipelineLayout = phasePipelines[DESPAWN_PHASE_MARK].getLayout();
+    if (!resolved) {
+        LOG_ERROR("EntityDespawnNode: Failed to get despawn pipelines or layout");
+        return;
+    }
+    
+    VkDescriptorSet computeDescriptorSet = descriptorManager.getEntityComputeSet();
+    if (computeDescriptorSet == VK_NULL_HANDLE && !descriptorManager.usesStreamAddresses()) {
+        LOG_ERROR("EntityDespawnNode: ERROR - Missing compute descriptor set!");
+        return;
+    }
+    
+    // Only resident entities are handed out, so every ID in the batch occupies exactly one live slot
+    const std::vector<uint32_t> despawnBatch = gpuEntityManager->takeDespawnBatch();
+    if (despawnBatch.empty()) {
+        return;
+    }
+    
+    const uint32_t entityCount = gpuEntityManager->getEntityCount();
+    const uint32_t despawnCount = static_cast<uint32_t>(despawnBatch.size());
+    pushConstants.entityCount = entityCount;
+    pushConstants.despawnCount = despawnCount;
+    pushConstants.entityTable = descriptorManager.getWorkingTable();
+    
+    const uint32_t batchWorkgroups = (despawnCount + THREADS_PER_WORKGROUP - 1) / THREADS_PER_WORKGROUP;
+    const uint32_t entityWorkgroups = (entityCount + THREADS_PER_WORKGROUP - 1) / THREADS_PER_WORKGROUP;
+    
+    FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 60, "EntityDespawnNode: compacting " << despawnCount << " of " << entityCount << " entities");
+    
+    // Cache loader reference for performance
+    const auto& vk = context->getLoader();
+    const auto& barriers = frameGraph.getBarrierManager();
+    VkBuffer scratchBuffer = gpuEntityManager->getBufferManager().getReorderScratchBuffer();
+    
+    // Earlier reorder passes may still be using the scratch buffer, and earlier frames the entity slots
+    barriers.insertMemoryBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+    
+    // Reset hole/mover counters and the mask for every spawn ID handed out, then upload the batch
+    vk.vkCmdFillBuffer(commandBuffer, scratchBuffer, 0, DESPAWN_COUNTER_WORDS * sizeof(uint32_t), 0);
+    vk.vkCmdFillBuffer(
+        commandBuffer, scratchBuffer, DESPAWN_MASK_BASE_WORD * sizeof(uint32_t),
+        static_cast<VkDeviceSize>(gpuEntityManager->getSpawnIdLimit()) * sizeof(uint32_t), 0);
+    vk.vkCmdUpdateBuffer(
+        commandBuffer, scratchBuffer, DESPAWN_ID_BASE_WORD * sizeof(uint32_t),
+        despawnCount * sizeof(uint32_t), despawnBatch.data());
+    
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    
+    // All three phases share the pipeline layout, so descriptors and push constants stay bound
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, markPipeline);
+    if (computeDescriptorSet != VK_NULL_HANDLE) {
+        vk.vkCmdBindDescriptorSets(
+            commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout,
+            0, 1, &computeDescriptorSet, 0, nullptr);
+    }
+    vk.vkCmdPushConstants(
+        commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(DespawnPushConstants), &pushConstants);
+    
+    auto dispatchPhase = [&](VkPipeline pipeline, ProfileZoneId zone, uint32_t workgroupCount) {
+        vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+        if (timeoutDetector) {
+            timeoutDetector->beginComputeDispatch(commandBuffer, zone, workgroupCount);
+        }
+        vk.vkCmdDispatch(commandBuffer, workgroupCount, 1, 1);
+        if (timeoutDetector) {
+            timeoutDetector->endComputeDispatch(commandBuffer);
+        }
+        barriers.insertMemoryBarrier(
+            commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    };
+    
+    static const ProfileZoneId markZone = Profiler::getInstance().registerZone("EntityDespawn_Mark");
+    static const ProfileZoneId classifyZone = Profiler::getInstance().registerZone("EntityDespawn_Classify");
+    static const ProfileZoneId moveZone = Profiler::getInstance().registerZone("EntityDespawn_Move");
+    dispatchPhase(markPipeline, markZone, batchWorkgroups);
+    dispatchPhase(classifyPipeline, classifyZone, entityWorkgroups);
+    dispatchPhase(movePipeline, moveZone, batchWorkgroups);
+    
+    // Color and movement params are not frame graph resources, so cover the vertex stage readers too
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR);
+    
+    // Shrinks the live count and rewrites the indirect arguments before any later pass reads them
+    gpuEntityManager->commitDespawnBatch(commandBuffer, despawnBatch);
+}
+
+// Node lifecycle implementation
+bool EntityDespawnNode::initializeNode(const FrameGraph& frameGraph) {
+    // One-time initialization - validate dependencies
+    if (!computeManager) {
+        LOG_ERROR("EntityDespawnNode: ComputePipelineManager is null");
+        return false;
+    }
+    if (!gpuEntityManager) {
+        LOG_ERROR("EntityDespawnNode: GPUEntityManager is null");
+        return false;
+    }
+    return true;
+}
+
+void EntityDespawnNode::prepareFrame(uint32_t frameIndex, float time, float deltaTime) {
+    // Despawn batch is taken in execute() so it sees uploads committed earlier this frame
+}
+
+void EntityDespawnNode::releaseFrame(uint32_t frameIndex) {
+    // Per-frame cleanup - nothing to clean up for despawn node
+}
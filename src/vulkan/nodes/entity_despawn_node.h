@@ -0,0 +1,69 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/frame_graph.h"
+#include "../rendering/frame_graph_debug.h"
+#include "../core/vulkan_constants.h"
+#include "../pipelines/compute_pipeline_handle.h"
+#include <array>
+#include <memory>
+
+// Forward declarations
+class ComputePipelineManager;
+class GPUEntityManager;
+class GPUTimeoutDetector;
+
+// Removes despawned entities from the GPU with a swap-with-last compaction: live entities
+// from the tail of the live range are moved into the freed slots and the live count shrinks.
+// Runs after EntityUploadNode and before every pass that reads entity slots.
+class EntityDespawnNode : public FrameGraphNode {
+    DECLARE_FRAME_GRAPH_NODE(EntityDespawnNode)
+    
+public:
+    EntityDespawnNode(
+        FrameGraphTypes::ResourceId entityBuffer,
+        FrameGraphTypes::ResourceId positionBuffer,
+        FrameGraphTypes::ResourceId currentPositionBuffer,
+        ComputePipelineManager* computeManager,
+        GPUEntityManager* gpuEntityManager,
+        std::shared_ptr<GPUTimeoutDetector> timeoutDetector = nullptr
+    );
+    
+    // FrameGraphNode interface
+    std::vector<ResourceDependency> getInputs() const override;
+    std::vector<ResourceDependency> getOutputs() const override;
+    void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
+    
+    // Queue requirements
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::AsyncCompute; }
+    
+    // Off unless despawns are queued
+    bool isEnabled(const FrameContext& frameContext) const override;
+    
+    // Node lifecycle - standardized pattern
+    bool initializeNode(const FrameGraph& frameGraph) override;
+    void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
+    void releaseFrame(uint32_t frameIndex) override;
+
+private:
+    FrameGraphTypes::ResourceId entityBufferId;
+    FrameGraphTypes::ResourceId positionBufferId;
+    FrameGraphTypes::ResourceId currentPositionBufferId;
+    
+    // External dependencies (not owned) - validated during execution
+    ComputePipelineManager* computeManager;
+    GPUEntityManager* gpuEntityManager;
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector;
+    std::array<ComputePipelineHandle, 3> phasePipelines;  // Mark, classify and move phases
+    
+    // Debug counter - zero overhead in release builds
+    mutable FrameGraphDebug::DebugCounter debugCounter{};
+    
+    // Counts for entity_despawn.comp
+    struct DespawnPushConstants {
+        uint32_t entityCount;   // Live count before compaction
+        uint32_t despawnCount;
+        uint64_t entityTable;   // Bindless table view or stream address table of the working buffers
+    } pushConstants{};
+};
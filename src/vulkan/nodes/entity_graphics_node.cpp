@@ -2,16 +2,21 @@
 #include "../pipelines/graphics_pipeline_manager.h"
 #include "../core/vulkan_swapchain.h"
 #include "../resources/core/resource_coordinator.h"
+#include "../resources/core/frame_ring_allocator.h"
 #include "../resources/managers/graphics_resource_manager.h"
+#include "../services/camera_latch.h"
+#include "../monitoring/overdraw_monitor.h"
 #include "../../ecs/gpu/gpu_entity_manager.h"
+#include "../../ecs/gpu/entity_descriptor_bindings.h"
 #include "../core/vulkan_context.h"
 #include "../core/vulkan_function_loader.h"
+#include "../core/vulkan_constants.h"
 #include "../../ecs/components/camera_component.h"
 #include "../pipelines/descriptor_layout_manager.h"
-#include <iostream>
-#include "../../ecs/core/service_locator.h"
-#include "../../ecs/services/camera_service.h"
+#include "../../ecs/utilities/logger.h"
+#include <algorithm>
 #include <array>
+#include <cstddef>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <flecs.h>
@@ -21,6 +26,9 @@
 EntityGraphicsNode::EntityGraphicsNode(
     FrameGraphTypes::ResourceId entityBuffer, 
     FrameGraphTypes::ResourceId positionBuffer,
+    FrameGraphTypes::ResourceId previousPositionBuffer,
+    FrameGraphTypes::ResourceId visibleIndexBuffer,
+    FrameGraphTypes::ResourceId visibleDrawCommandBuffer,
     FrameGraphTypes::ResourceId colorTarget,
     GraphicsPipelineManager* graphicsManager,
     VulkanSwapchain* swapchain,
@@ -28,6 +36,9 @@ EntityGraphicsNode::EntityGraphicsNode(
     GPUEntityManager* gpuEntityManager
 ) : entityBufferId(entityBuffer)
   , positionBufferId(positionBuffer)
+  , previousPositionBufferId(previousPositionBuffer)
+  , visibleIndexBufferId(visibleIndexBuffer)
+  , visibleDrawCommandBufferId(visibleDrawCommandBuffer)
   , colorTargetId(colorTarget)
   , graphicsManager(graphicsManager)
   , swapchain(swapchain)
@@ -53,6 +64,9 @@ std::vector<ResourceDependency> EntityGraphicsNode::getInputs() const {
     return {
         {entityBufferId, ResourceAccess::Read, PipelineStage::VertexShader},
         {positionBufferId, ResourceAccess::Read, PipelineStage::VertexShader},
+        {previousPositionBufferId, ResourceAccess::Read, PipelineStage::VertexShader},
+        {visibleIndexBufferId, ResourceAccess::Read, PipelineStage::VertexShader},
+        {visibleDrawCommandBufferId, ResourceAccess::Read, PipelineStage::VertexShader},
     };
 }
 
@@ -65,29 +79,392 @@ std::vector<ResourceDependency> EntityGraphicsNode::getOutputs() const {
 
 void EntityGraphicsNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
     
-    // Validate dependencies are still valid
-    if (!graphicsManager || !swapchain || !resourceCoordinator || !gpuEntityManager) {
-        std::cerr << "EntityGraphicsNode: Critical error - dependencies became null during execution" << std::endl;
+    // Get Vulkan context from frame graph
+    const VulkanContext* context = frameGraph.getContext();
+    if (!context) {
+        LOG_ERROR("EntityGraphicsNode: Missing Vulkan context");
         return;
     }
     
-    const uint32_t entityCount = gpuEntityManager->getEntityCount();
+    // Every snapshot release must be matched, including on frames that draw nothing
+    if (drawPublishedSnapshot) {
+        acquirePublishedSnapshots(commandBuffer, frameGraph);
+    }
     
     if (entityCount == 0) {
         FRAME_GRAPH_DEBUG_LOG_THROTTLED(noEntitiesCounter, 1800, "EntityGraphicsNode: No entities to render");
         return;
     }
     
-    // Get Vulkan context from frame graph
-    const VulkanContext* context = frameGraph.getContext();
-    if (!context) {
-        std::cerr << "EntityGraphicsNode: Missing Vulkan context" << std::endl;
+    // prepareFrame() already reported why this frame cannot draw
+    if (!frameResolved) {
         return;
     }
-    
-    // Update uniform buffer with camera matrices (now handled by EntityDescriptorManager)
-    updateUniformBuffer();
     
+    // Cache loader reference for performance
+    const auto& vk = context->getLoader();
+    
+    if (resolvedOverdrawSet != VK_NULL_HANDLE) {
+        recordOverdrawClear(commandBuffer, vk);
+    }
+    
+    if (resolvedDynamicRendering) {
+        beginDynamicRendering(commandBuffer, vk);
+    } else {
+        // Begin render pass
+        VkRenderPassBeginInfo renderPassInfo{};
+        renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
+        renderPassInfo.renderPass = cachedRenderPass;
+        renderPassInfo.framebuffer = resolvedFramebuffer;
+        renderPassInfo.renderArea.offset = {0, 0};
+        renderPassInfo.renderArea.extent = resolvedExtent;
+        
+        // Clear values by attachment: colour (MSAA when multisampled), resolve when multisampled, then depth
+        std::array<VkClearValue, 3> clearValues{};
+        uint32_t clearValueCount = 0;
+        clearValues[clearValueCount++].color = CLEAR_COLOR;
+        if (cachedSamples != VK_SAMPLE_COUNT_1_BIT) {
+            clearValues[clearValueCount++].color = CLEAR_COLOR;
+        }
+        if (cachedDepthFormat != VK_FORMAT_UNDEFINED) {
+            clearValues[clearValueCount++].depthStencil = CLEAR_DEPTH;
+        }
+        renderPassInfo.clearValueCount = clearValueCount;
+        renderPassInfo.pClearValues = clearValues.data();
+        
+        vk.vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
+    }
+
+    // Bind graphics pipeline
+    vk.vkCmdBindPipeline(
+        commandBuffer, 
+        VK_PIPELINE_BIND_POINT_GRAPHICS, 
+        resolvedPipeline
+    );
+    
+    if (resolvedPushesEntityTable) {
+        vk.vkCmdPushConstants(
+            commandBuffer, resolvedPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT,
+            0, sizeof(uint64_t), &resolvedEntityTable);
+    }
+    
+    if (!resolvedDensityTiles && !resolvedProceduralGeometry) {
+        // Bind vertex buffer: only geometry vertices (SoA uses storage buffers for entity data)
+        VkBuffer vertexBuffers[] = {
+            resolvedVertexBuffer      // Vertex positions for triangle geometry
+        };
+        VkDeviceSize offsets[] = {0};
+        vk.vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
+        
+        // Bind index buffer for triangle geometry
+        vk.vkCmdBindIndexBuffer(commandBuffer, resolvedIndexBuffer, 0, VK_INDEX_TYPE_UINT16);
+    }
+    
+    // One draw per viewport: the culling pass listed every entity any viewport sees once, and vertex.vert drops
+    // the ones outside the viewport its frame UBO names
+    for (uint32_t viewportIndex = 0; viewportIndex < viewportCount; ++viewportIndex) {
+        const VkRect2D& rect = resolvedViewportRects[viewportIndex];
+        if (rect.extent.width == 0 || rect.extent.height == 0) {
+            continue;
+        }
+        
+        // Set dynamic viewport and scissor
+        VkViewport viewport{};
+        viewport.x = static_cast<float>(rect.offset.x);
+        viewport.y = static_cast<float>(rect.offset.y);
+        viewport.width = static_cast<float>(rect.extent.width);
+        viewport.height = static_cast<float>(rect.extent.height);
+        viewport.minDepth = 0.0f;
+        viewport.maxDepth = 1.0f;
+        vk.vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+        vk.vkCmdSetScissor(commandBuffer, 0, 1, &rect);
+        
+        // Classic: single descriptor set with unified layout (uniform + storage buffers). Bindless: table at set 0,
+        // camera UBO at set 1. Buffer address: camera UBO alone at set 0. Time and delta time travel in the frame
+        // UBO rather than push constants, so a replayed recording still animates; the two bindless modes push the
+        // entity table that picks the working or snapshot view. Overdraw frames add the count image's set after them
+        const uint32_t modeSetCount = resolvedUniformSet != VK_NULL_HANDLE ? 2 : 1;
+        const VkDescriptorSet sets[] = {resolvedDescriptorSet, modeSetCount > 1 ? resolvedUniformSet : resolvedOverdrawSet, resolvedOverdrawSet};
+        vk.vkCmdBindDescriptorSets(
+            commandBuffer,
+            VK_PIPELINE_BIND_POINT_GRAPHICS,
+            resolvedPipelineLayout,
+            0, modeSetCount + (resolvedOverdrawSet != VK_NULL_HANDLE ? 1 : 0), sets,
+            1, &frameUniformOffsets[viewportIndex]
+        );
+        
+        if (resolvedDensityTiles) {
+            // Tile count per instance, read from the visible index buffer; empty tiles collapse in the vertex shader
+            vk.vkCmdDraw(commandBuffer, 6, ENTITY_LOD_TILE_COUNT, 0, 0);
+        } else if (resolvedProceduralGeometry) {
+            // Non-indexed: VkDrawIndirectCommand is a prefix of the indexed command the culling pass writes
+            // (indexCount reads as vertexCount, firstIndex and vertexOffset as firstVertex and firstInstance, all 0);
+            // the expanded path's command is one instance of three vertices per visible entity
+            static_assert(offsetof(VkDrawIndirectCommand, instanceCount) == offsetof(VkDrawIndexedIndirectCommand, instanceCount));
+            vk.vkCmdDrawIndirect(
+                commandBuffer,
+                resolvedDrawCommandBuffer,
+                0,
+                1, sizeof(VkDrawIndexedIndirectCommand)
+            );
+        } else if (resolvedShapeBinned) {
+            // One command per shape up to the last one with visible entities; each one's first instance starts its
+            // run of the binned visible index list, which gl_InstanceIndex already includes
+            vk.vkCmdDrawIndexedIndirectCountKHR(
+                commandBuffer,
+                resolvedDrawCommandBuffer,
+                0,
+                resolvedDrawCommandBuffer,
+                VisibleDrawCommandBuffer::getDrawCountOffset(),
+                ENTITY_SHAPE_COUNT, sizeof(VkDrawIndexedIndirectCommand)
+            );
+        } else {
+            // Draw indexed instances: instance count is the number of entities that survived GPU culling
+            vk.vkCmdDrawIndexedIndirect(
+                commandBuffer,
+                resolvedDrawCommandBuffer,
+                0,
+                1, sizeof(VkDrawIndexedIndirectCommand)
+            );
+        }
+    }
+    
+    // Debug: confirm draw call (thread-safe)
+    FRAME_GRAPH_DEBUG_LOG_THROTTLED(drawCounter, 1800, "EntityGraphicsNode: Drew " << entityCount << " entities" << (resolvedDensityTiles ? " (density tiles)" : resolvedProceduralGeometry ? " (procedural geometry)" : ""));
+
+    if (resolvedDynamicRendering) {
+        endDynamicRendering(commandBuffer, vk);
+    } else {
+        vk.vkCmdEndRenderPass(commandBuffer);
+    }
+    
+    if (resolvedPickFrame) {
+        recordPickReadback(commandBuffer, vk);
+    }
+    
+    if (resolvedScaledImage != VK_NULL_HANDLE) {
+        recordUpscaleBlit(commandBuffer, vk);
+    }
+}
+
+void EntityGraphicsNode::beginDynamicRendering(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk) const {
+    // What the render pass's initial layouts and external dependency did: previous contents are discarded, and
+    // the output waits for the acquire (colour attachment output) and, when scaled, the last blit reading it.
+    // The pick images are shared by every frame and were last read by a pick copy
+    std::array<VkImageMemoryBarrier, 5> toAttachment{};
+    uint32_t barrierCount = 0;
+    const VkImage pickAttachmentImage = resolvedPickFrame ? resolvedPickAttachmentImage : VK_NULL_HANDLE;
+    const VkImage pickResolveImage = resolvedPickFrame && resolvedPickImage != resolvedPickAttachmentImage ? resolvedPickImage : VK_NULL_HANDLE;
+    const VkImage images[] = {resolvedTargetImage, resolvedMSAAColorImage, pickAttachmentImage, pickResolveImage};
+    for (VkImage image : images) {
+        if (image == VK_NULL_HANDLE) {
+            continue;
+        }
+        VkImageMemoryBarrier& barrier = toAttachment[barrierCount++];
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = image == resolvedTargetImage ? 0 : VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = image;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    }
+    
+    // The depth image is shared by every frame, like the MSAA image: the clear waits for the last frame's tests
+    const VkPipelineStageFlags depthStages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+    if (resolvedDepthImage != VK_NULL_HANDLE) {
+        VkImageMemoryBarrier& barrier = toAttachment[barrierCount++];
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        barrier.newLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.image = resolvedDepthImage;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_DEPTH_BIT, 0, 1, 0, 1};
+    }
+    
+    const VkPipelineStageFlags srcStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        (resolvedScaledImage != VK_NULL_HANDLE || resolvedPickFrame ? VK_PIPELINE_STAGE_TRANSFER_BIT : 0) |
+        (resolvedDepthImage != VK_NULL_HANDLE ? depthStages : 0);
+    const VkPipelineStageFlags dstStages = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT |
+        (resolvedDepthImage != VK_NULL_HANDLE ? depthStages : 0);
+    vk.vkCmdPipelineBarrier(commandBuffer,
+        srcStages, dstStages,
+        0, 0, nullptr, 0, nullptr, barrierCount, toAttachment.data());
+    
+    // Multisampled: draw into the shared MSAA image and resolve into the output at the end of rendering
+    VkRenderingAttachmentInfoKHR colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    colorAttachment.clearValue.color = CLEAR_COLOR;
+    if (resolvedMSAAColorView != VK_NULL_HANDLE) {
+        colorAttachment.imageView = resolvedMSAAColorView;
+        colorAttachment.resolveMode = VK_RESOLVE_MODE_AVERAGE_BIT_KHR;
+        colorAttachment.resolveImageView = resolvedTargetView;
+        colorAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    } else {
+        colorAttachment.imageView = resolvedTargetView;
+        colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    }
+    
+    // Depth is only tested within the pass, so it is never stored
+    VkRenderingAttachmentInfoKHR depthAttachment{};
+    depthAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    depthAttachment.imageView = resolvedDepthView;
+    depthAttachment.imageLayout = VK_IMAGE_LAYOUT_DEPTH_STENCIL_ATTACHMENT_OPTIMAL;
+    depthAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    depthAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    depthAttachment.clearValue.depthStencil = CLEAR_DEPTH;
+    
+    // Pick frames: spawn ID + 1 per pixel, 0 where nothing was drawn. Integer attachments resolve sample zero
+    std::array<VkRenderingAttachmentInfoKHR, 2> colorAttachments{colorAttachment, {}};
+    VkRenderingAttachmentInfoKHR& pickAttachment = colorAttachments[1];
+    pickAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    pickAttachment.imageView = resolvedPickAttachmentView;
+    pickAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    pickAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_CLEAR;
+    pickAttachment.clearValue.color.uint32[0] = 0;
+    if (pickResolveImage != VK_NULL_HANDLE) {
+        pickAttachment.resolveMode = VK_RESOLVE_MODE_SAMPLE_ZERO_BIT_KHR;
+        pickAttachment.resolveImageView = resolvedPickView;
+        pickAttachment.resolveImageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        pickAttachment.storeOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
+    } else {
+        pickAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    }
+    
+    VkRenderingInfoKHR renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.renderArea.offset = {0, 0};
+    renderingInfo.renderArea.extent = resolvedExtent;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = resolvedPickFrame ? 2 : 1;
+    renderingInfo.pColorAttachments = colorAttachments.data();
+    renderingInfo.pDepthAttachment = resolvedDepthView != VK_NULL_HANDLE ? &depthAttachment : nullptr;
+    vk.vkCmdBeginRenderingKHR(commandBuffer, &renderingInfo);
+}
+
+void EntityGraphicsNode::endDynamicRendering(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk) const {
+    vk.vkCmdEndRenderingKHR(commandBuffer);
+    
+    // The render pass's final layout: presentable, or TRANSFER_SRC with its writes visible to the upscale blit
+    const bool scaled = resolvedOutputLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    VkImageMemoryBarrier toOutput{};
+    toOutput.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toOutput.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    toOutput.dstAccessMask = scaled ? VK_ACCESS_TRANSFER_READ_BIT : 0;
+    toOutput.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    toOutput.newLayout = resolvedOutputLayout;
+    toOutput.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toOutput.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toOutput.image = resolvedTargetImage;
+    toOutput.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vk.vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        scaled ? VK_PIPELINE_STAGE_TRANSFER_BIT : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &toOutput);
+}
+
+void EntityGraphicsNode::recordOverdrawClear(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk) const {
+    // The image is shared by every frame: the clear waits for the last frame's reduction and heat map
+    VkImageMemoryBarrier toClear{};
+    toClear.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toClear.srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    toClear.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toClear.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    toClear.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    toClear.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toClear.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toClear.image = resolvedOverdrawImage;
+    toClear.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vk.vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &toClear);
+    
+    const VkClearColorValue zero{};
+    const VkImageSubresourceRange range{VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vk.vkCmdClearColorImage(commandBuffer, resolvedOverdrawImage, VK_IMAGE_LAYOUT_GENERAL, &zero, 1, &range);
+    
+    VkImageMemoryBarrier toCount = toClear;
+    toCount.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toCount.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    toCount.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    vk.vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &toCount);
+}
+
+void EntityGraphicsNode::recordPickReadback(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk) {
+    VkImageMemoryBarrier toTransfer{};
+    toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toTransfer.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    toTransfer.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    toTransfer.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    toTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.image = resolvedPickImage;
+    toTransfer.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vk.vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &toTransfer);
+    
+    if (!gpuEntityManager->getBufferManager().recordEntityIdPickReadback(commandBuffer, resolvedPickImage, resolvedPickPixel)) {
+        return;
+    }
+    VkMemoryBarrier toHost{};
+    toHost.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    toHost.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toHost.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vk.vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+        0, 1, &toHost, 0, nullptr, 0, nullptr);
+}
+
+void EntityGraphicsNode::recordUpscaleBlit(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk) const {
+    // Rendering left the scaled image in TRANSFER_SRC and made its writes visible to transfers; the
+    // swapchain image comes from the acquire, which the graphics submit waits for at colour attachment output
+    VkImageMemoryBarrier toTransfer{};
+    toTransfer.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toTransfer.srcAccessMask = 0;
+    toTransfer.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toTransfer.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    toTransfer.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    toTransfer.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toTransfer.image = resolvedSwapchainImage;
+    toTransfer.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vk.vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &toTransfer);
+    
+    VkImageBlit blit{};
+    blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.srcOffsets[1] = {static_cast<int32_t>(resolvedExtent.width), static_cast<int32_t>(resolvedExtent.height), 1};
+    blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.dstOffsets[1] = {static_cast<int32_t>(resolvedOutputExtent.width), static_cast<int32_t>(resolvedOutputExtent.height), 1};
+    vk.vkCmdBlitImage(commandBuffer,
+        resolvedScaledImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+        resolvedSwapchainImage, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+        1, &blit, resolvedUpscaleFilter);
+    
+    VkImageMemoryBarrier toPresent = toTransfer;
+    toPresent.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    toPresent.dstAccessMask = 0;
+    toPresent.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    toPresent.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    vk.vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &toPresent);
+}
+
+bool EntityGraphicsNode::resolveFrame() {
     // Detect manager cache invalidation and reset cached handles if needed
     const auto* layoutMgr = graphicsManager->getLayoutManager();
     const uint64_t currentLayoutGen = layoutMgr ? layoutMgr->getGeneration() : 0;
@@ -95,266 +472,330 @@ void EntityGraphicsNode::execute(VkCommandBuffer commandBuffer, const FrameGraph
     if (currentLayoutGen != observedLayoutGeneration || currentGraphicsGen != observedGraphicsPipelineGeneration) {
         cachedDescriptorLayout = VK_NULL_HANDLE;
         cachedPipelineLayout = VK_NULL_HANDLE;
+        cachedOverdrawPipelineLayout = VK_NULL_HANDLE;
+        cachedRenderPass = VK_NULL_HANDLE;  // Cleared with the pipeline cache; the old one is only kept for frames in flight
         observedLayoutGeneration = currentLayoutGen;
         observedGraphicsPipelineGeneration = currentGraphicsGen;
     }
 
+    const EntityDescriptorManager& descriptorManager = gpuEntityManager->getDescriptorManager();
+    const bool streamAddresses = descriptorManager.usesStreamAddresses();
+    const bool bindless = descriptorManager.isBindless();
+    
     // Create or reuse descriptor layout for this pipeline
-    if (cachedDescriptorLayout == VK_NULL_HANDLE) {
+    if (streamAddresses) {
+        cachedDescriptorLayout = descriptorManager.getBindlessUniformLayout();
+    } else if (bindless) {
+        cachedDescriptorLayout = descriptorManager.getBindlessTableLayout();
+    } else if (cachedDescriptorLayout == VK_NULL_HANDLE) {
         auto layoutSpec = DescriptorLayoutPresets::createEntityGraphicsLayout();
         cachedDescriptorLayout = graphicsManager->getLayoutManager()->getLayout(layoutSpec);
         if (cachedDescriptorLayout == VK_NULL_HANDLE) {
-            std::cerr << "EntityGraphicsNode: Failed to get descriptor layout" << std::endl;
-            return;
+            LOG_ERROR("EntityGraphicsNode: Failed to get descriptor layout");
+            return false;
         }
     }
     
-    // Get or cache the render pass that matches current swapchain format/MSAA
+    // Get or cache the render pass that matches current swapchain format and render quality; dynamic rendering
+    // needs only the format
     const VkFormat colorFormat = swapchain->getImageFormat();
-    const VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_2_BIT;
-    const bool enableMSAA = true;
+    const VkSampleCountFlagBits samples = swapchain->getSampleCount();
+    const bool enableMSAA = samples != VK_SAMPLE_COUNT_1_BIT;
+    const VkImageLayout outputLayout = swapchain->getOutputLayout();
+    const VkFormat depthFormat = swapchain->getDepthFormat();
+    resolvedDynamicRendering = resourceCoordinator->getContext()->supportsDynamicRendering();
 
-    if (cachedRenderPass == VK_NULL_HANDLE ||
+    if (resolvedDynamicRendering) {
+        cachedRenderPass = VK_NULL_HANDLE;
+    } else if (cachedRenderPass == VK_NULL_HANDLE ||
         cachedColorFormat != colorFormat ||
+        cachedDepthFormat != depthFormat ||
         cachedSamples != samples ||
-        cachedEnableMSAA != enableMSAA) {
+        cachedEnableMSAA != enableMSAA ||
+        cachedOutputLayout != outputLayout) {
         cachedRenderPass = graphicsManager->createRenderPass(
             colorFormat,
-            VK_FORMAT_UNDEFINED,
+            depthFormat,
             samples,
-            enableMSAA
+            enableMSAA,
+            outputLayout
         );
         cachedColorFormat = colorFormat;
+        cachedDepthFormat = depthFormat;
         cachedSamples = samples;
         cachedEnableMSAA = enableMSAA;
+        cachedOutputLayout = outputLayout;
     }
     
-    GraphicsPipelineState pipelineState = GraphicsPipelinePresets::createEntityRenderingState(
-        cachedRenderPass, cachedDescriptorLayout);
+    // The culling pass that filled the drawn visible index buffer decided between entities and density tiles
+    const auto geometryPath = GraphicsPipelinePresets::selectEntityGeometryPath(*resourceCoordinator->getContext());
+    resolvedProceduralGeometry = GraphicsPipelinePresets::isProceduralGeometry(geometryPath);
+    resolvedShapeBinned = geometryPath == GraphicsPipelinePresets::EntityGeometryPath::BinnedMesh;
+    resolvedDensityTiles = gpuEntityManager->hasDensityTiles(drawPublishedSnapshot, snapshotSlot);
+    GraphicsPipelineState pipelineState = resolvedDensityTiles
+        ? GraphicsPipelinePresets::createEntityDensityState(cachedRenderPass, cachedDescriptorLayout)
+        : GraphicsPipelinePresets::createEntityRenderingState(
+              cachedRenderPass, cachedDescriptorLayout, gpuEntityManager->isCompactLayout(), geometryPath);
+    pipelineState.rasterizationSamples = samples;
+    if (depthFormat != VK_FORMAT_UNDEFINED && !resolvedDensityTiles) {
+        GraphicsPipelinePresets::applyEntityEarlyDepth(pipelineState);
+    }
+    if (resolvedDynamicRendering) {
+        GraphicsPipelinePresets::applyDynamicRendering(pipelineState, colorFormat, depthFormat);
+    }
+    if (streamAddresses) {
+        GraphicsPipelinePresets::applyEntityStreamAddresses(pipelineState, cachedDescriptorLayout);
+    } else if (bindless) {
+        GraphicsPipelinePresets::applyBindlessEntityTable(
+            pipelineState, cachedDescriptorLayout, descriptorManager.getBindlessUniformLayout());
+    }
     
-    // Get pipeline and layout (cache layout for reuse)
-    VkPipeline pipeline = graphicsManager->getPipeline(pipelineState);
-    if (pipeline == VK_NULL_HANDLE) {
-        std::cerr << "EntityGraphicsNode: Failed to get graphics pipeline" << std::endl;
-        return;
+    // Looked up every frame, replayed or not, so the pipeline cache never ages out a recorded pipeline
+    // Non-blocking: while the pipeline compiles in the background the frame draws nothing, as with no entities
+    resolvedPipeline = graphicsManager->getPipelineIfReady(pipelineState);
+    if (resolvedPipeline == VK_NULL_HANDLE) {
+        return false;
     }
     if (cachedPipelineLayout == VK_NULL_HANDLE) {
         cachedPipelineLayout = graphicsManager->getPipelineLayout(pipelineState);
     }
     if (cachedPipelineLayout == VK_NULL_HANDLE) {
-        std::cerr << "EntityGraphicsNode: Failed to get graphics pipeline" << std::endl;
-        return;
+        LOG_ERROR("EntityGraphicsNode: Failed to get graphics pipeline");
+        return false;
     }
+    resolvedPipelineLayout = cachedPipelineLayout;
     
-    // Validate swapchain state before accessing framebuffers
-    const auto& framebuffers = swapchain->getFramebuffers();
-    if (imageIndex >= framebuffers.size()) {
-        std::cerr << "EntityGraphicsNode: Invalid imageIndex " << imageIndex 
-                  << " >= framebuffer count " << framebuffers.size() << std::endl;
-        return;
+    // A queued pick switches this frame to the pick variant (same layouts) once it has compiled
+    resolvedPickFrame = false;
+    EntityBufferManager& buffers = gpuEntityManager->getBufferManager();
+    if (viewportBase == 0 && buffers.hasEntityIdPick()) {
+        if (!resolvedDynamicRendering || resolvedDensityTiles || swapchain->getPickImage() == VK_NULL_HANDLE) {
+            buffers.failEntityIdPick();
+        } else {
+            GraphicsPipelinePresets::applyEntityPickIds(pipelineState);
+            const VkPipeline pickPipeline = graphicsManager->getPipelineIfReady(pipelineState);
+            if (pickPipeline != VK_NULL_HANDLE) {
+                resolvedPipeline = pickPipeline;
+                resolvedPickFrame = true;
+            } else {
+                buffers.deferEntityIdPick();
+            }
+        }
     }
     
-    // Begin render pass
-    VkRenderPassBeginInfo renderPassInfo{};
-    renderPassInfo.sType = VK_STRUCTURE_TYPE_RENDER_PASS_BEGIN_INFO;
-    renderPassInfo.renderPass = cachedRenderPass;
-    renderPassInfo.framebuffer = framebuffers[imageIndex];
-    renderPassInfo.renderArea.offset = {0, 0};
-    renderPassInfo.renderArea.extent = swapchain->getExtent();
-
-    // Clear values: MSAA color, resolve color (no depth)
-    std::array<VkClearValue, 2> clearValues{};
-    clearValues[0].color = {{0.1f, 0.1f, 0.2f, 1.0f}};  // MSAA color attachment
-    clearValues[1].color = {{0.1f, 0.1f, 0.2f, 1.0f}};  // Resolve attachment
-    renderPassInfo.clearValueCount = static_cast<uint32_t>(clearValues.size());
-    renderPassInfo.pClearValues = clearValues.data();
-
-    // Cache loader reference for performance
-    const auto& vk = context->getLoader();
-
-    vk.vkCmdBeginRenderPass(commandBuffer, &renderPassInfo, VK_SUBPASS_CONTENTS_INLINE);
-
-    // Set dynamic viewport and scissor
-    VkViewport viewport{};
-    viewport.x = 0.0f;
-    viewport.y = 0.0f;
-    viewport.width = static_cast<float>(swapchain->getExtent().width);
-    viewport.height = static_cast<float>(swapchain->getExtent().height);
-    viewport.minDepth = 0.0f;
-    viewport.maxDepth = 1.0f;
-    vk.vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
-
-    VkRect2D scissor{};
-    scissor.offset = {0, 0};
-    scissor.extent = swapchain->getExtent();
-    vk.vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
-
-    // Entity count already retrieved above
+    // Overdraw diagnostic: the counting variant once it has compiled; until then the frame draws uncounted and
+    // OverdrawNode skips its reduction. Pick frames stay uncounted
+    resolvedOverdrawSet = VK_NULL_HANDLE;
+    resolvedOverdrawImage = VK_NULL_HANDLE;
+    resolvedOverdrawView = VK_NULL_HANDLE;
+    if (overdrawMonitor && !resolvedPickFrame && swapchain->getOverdrawImageView() != VK_NULL_HANDLE) {
+        GraphicsPipelineState overdrawState = pipelineState;
+        GraphicsPipelinePresets::applyEntityOverdrawCount(overdrawState, overdrawMonitor->getDescriptorSetLayout());
+        const VkPipeline overdrawPipeline = graphicsManager->getPipelineIfReady(overdrawState);
+        if (overdrawPipeline != VK_NULL_HANDLE && cachedOverdrawPipelineLayout == VK_NULL_HANDLE) {
+            cachedOverdrawPipelineLayout = graphicsManager->getPipelineLayout(overdrawState);
+        }
+        if (overdrawPipeline != VK_NULL_HANDLE && cachedOverdrawPipelineLayout != VK_NULL_HANDLE) {
+            resolvedOverdrawImage = swapchain->getOverdrawImage();
+            resolvedOverdrawView = swapchain->getOverdrawImageView();
+            resolvedOverdrawSet = overdrawMonitor->prepareCount(currentFrameIndex, resolvedOverdrawView);
+        }
+        if (resolvedOverdrawSet != VK_NULL_HANDLE) {
+            resolvedPipeline = overdrawPipeline;
+            resolvedPipelineLayout = cachedOverdrawPipelineLayout;
+        }
+    }
     
-    // Bind graphics pipeline
-    vk.vkCmdBindPipeline(
-        commandBuffer, 
-        VK_PIPELINE_BIND_POINT_GRAPHICS, 
-        pipeline
-    );
+    if (resolvedDynamicRendering) {
+        // Rendering begins on the frame's output view, and on the shared MSAA image when multisampled
+        resolvedFramebuffer = VK_NULL_HANDLE;
+        resolvedTargetImage = swapchain->getRenderTargetImage(imageIndex);
+        resolvedTargetView = swapchain->getRenderTargetView(imageIndex);
+        resolvedMSAAColorImage = enableMSAA ? swapchain->getMSAAColorImage() : VK_NULL_HANDLE;
+        resolvedMSAAColorView = enableMSAA ? swapchain->getMSAAColorImageView() : VK_NULL_HANDLE;
+        resolvedDepthImage = swapchain->getDepthImage();
+        resolvedDepthView = swapchain->getDepthImageView();
+        resolvedOutputLayout = outputLayout;
+        if (resolvedTargetView == VK_NULL_HANDLE || (enableMSAA && resolvedMSAAColorView == VK_NULL_HANDLE) ||
+            (depthFormat != VK_FORMAT_UNDEFINED && resolvedDepthView == VK_NULL_HANDLE)) {
+            LOG_ERROR("EntityGraphicsNode: Invalid imageIndex " << imageIndex << " for dynamic rendering");
+            return false;
+        }
+    } else {
+        // Validate swapchain state before accessing framebuffers
+        const auto& framebuffers = swapchain->getFramebuffers();
+        if (imageIndex >= framebuffers.size()) {
+            LOG_ERROR("EntityGraphicsNode: Invalid imageIndex " << imageIndex 
+                      << " >= framebuffer count " << framebuffers.size());
+            return false;
+        }
+        resolvedFramebuffer = framebuffers[imageIndex];
+    }
+    resolvedExtent = swapchain->getRenderExtent();
     
-    // Bind single descriptor set with unified layout (uniform + storage buffers)
-    VkDescriptorSet entityDescriptorSet = gpuEntityManager->getDescriptorManager().getGraphicsDescriptorSet();
+    if (resolvedPickFrame) {
+        resolvedPickAttachmentImage = swapchain->getPickAttachmentImage();
+        resolvedPickAttachmentView = swapchain->getPickAttachmentView();
+        resolvedPickImage = swapchain->getPickImage();
+        resolvedPickView = swapchain->getPickImageView();
+        const glm::uvec2 pixel = glm::clamp(buffers.getEntityIdPickPosition(), 0.0f, 1.0f) *
+                                 glm::vec2(resolvedExtent.width, resolvedExtent.height);
+        resolvedPickPixel = {static_cast<int32_t>(std::min(pixel.x, resolvedExtent.width - 1)),
+                             static_cast<int32_t>(std::min(pixel.y, resolvedExtent.height - 1))};
+    }
     
-    if (entityDescriptorSet != VK_NULL_HANDLE) {
-        vk.vkCmdBindDescriptorSets(
-            commandBuffer,
-            VK_PIPELINE_BIND_POINT_GRAPHICS,
-            cachedPipelineLayout,
-            0, 1, &entityDescriptorSet,
-            0, nullptr
-        );
-    } else {
-        std::cerr << "EntityGraphicsNode: ERROR - Missing graphics descriptor set!" << std::endl;
-        return;
-    }
-
-    // Push constants for vertex shader
-    struct VertexPushConstants {
-        float time;                 // Current simulation time
-        float dt;                   // Time per frame  
-        uint32_t count;             // Total number of entities
-    } vertexPushConstants = { 
-        frameTime,
-        frameDeltaTime,
-        entityCount
-    };
+    // Viewport rects in render pixels, clamped to the render area; empty ones are not drawn
+    for (uint32_t viewport = 0; viewport < viewportCount; ++viewport) {
+        const glm::vec4 rect = viewport < viewportCameras.size() ? viewportCameras[viewport].rect : glm::vec4(0.0f, 0.0f, 1.0f, 1.0f);
+        const glm::vec2 extent(resolvedExtent.width, resolvedExtent.height);
+        const glm::uvec2 minCorner(glm::clamp(glm::vec2(rect.x, rect.y), 0.0f, 1.0f) * extent);
+        const glm::uvec2 maxCorner = glm::max(
+            glm::uvec2(glm::clamp(glm::vec2(rect.x + rect.z, rect.y + rect.w), 0.0f, 1.0f) * extent), minCorner);
+        VkRect2D& pixels = resolvedViewportRects[viewport];
+        pixels.offset = {static_cast<int32_t>(minCorner.x), static_cast<int32_t>(minCorner.y)};
+        pixels.extent = {maxCorner.x - minCorner.x, maxCorner.y - minCorner.y};
+    }
+    
+    // Scaled rendering ends with a blit of the frame's scaled image to the swapchain image
+    resolvedScaledImage = swapchain->isRenderScaled() ? swapchain->getScaledImage(imageIndex) : VK_NULL_HANDLE;
+    resolvedSwapchainImage = swapchain->getImages()[imageIndex];
+    resolvedOutputExtent = swapchain->getExtent();
+    resolvedUpscaleFilter = swapchain->getUpscaleFilter();
+    
+    // Pipelined frames read the published snapshot chosen by EntityPublishNode instead of the buffers
+    // compute is still writing
+    if (streamAddresses || bindless) {
+        resolvedDescriptorSet = streamAddresses ? descriptorManager.getBindlessUniformSet() : descriptorManager.getBindlessTableSet();
+        resolvedUniformSet = streamAddresses ? VK_NULL_HANDLE : descriptorManager.getBindlessUniformSet();
+        resolvedPushesEntityTable = true;
+        resolvedEntityTable = drawPublishedSnapshot
+            ? descriptorManager.getPublishedTable(snapshotSlot)
+            : descriptorManager.getWorkingTable();
+    } else {
+        resolvedDescriptorSet = drawPublishedSnapshot
+            ? descriptorManager.getPublishedGraphicsDescriptorSet(snapshotSlot)
+            : descriptorManager.getGraphicsDescriptorSet();
+        resolvedUniformSet = VK_NULL_HANDLE;
+        resolvedPushesEntityTable = false;
+        resolvedEntityTable = 0;
+    }
+    if (resolvedDescriptorSet == VK_NULL_HANDLE) {
+        LOG_ERROR("EntityGraphicsNode: ERROR - Missing graphics descriptor set!");
+        return false;
+    }
     
-    vk.vkCmdPushConstants(
-        commandBuffer, 
-        cachedPipelineLayout,
-        VK_SHADER_STAGE_VERTEX_BIT, 
-        0, sizeof(VertexPushConstants), 
-        &vertexPushConstants
-    );
+    resolvedDrawCommandBuffer = drawPublishedSnapshot
+        ? gpuEntityManager->getBufferManager().getPublishedDrawCommandBuffer(snapshotSlot)
+        : gpuEntityManager->getVisibleDrawCommandBuffer();
+    // Null under procedural geometry, which binds neither
+    resolvedVertexBuffer = resourceCoordinator->getGraphicsManager()->getVertexBuffer();
+    resolvedIndexBuffer = resourceCoordinator->getGraphicsManager()->getIndexBuffer();
+    return true;
+}
 
-    // Draw entities
-    if (entityCount > 0) {
-        // Bind vertex buffer: only geometry vertices (SoA uses storage buffers for entity data)
-        VkBuffer vertexBuffers[] = {
-            resourceCoordinator->getGraphicsManager()->getVertexBuffer()      // Vertex positions for triangle geometry
-        };
-        VkDeviceSize offsets[] = {0};
-        vk.vkCmdBindVertexBuffers(commandBuffer, 0, 1, vertexBuffers, offsets);
-        
-        // Bind index buffer for triangle geometry
-        vk.vkCmdBindIndexBuffer(
-            commandBuffer, resourceCoordinator->getGraphicsManager()->getIndexBuffer(), 0, VK_INDEX_TYPE_UINT16);
-        
-        // Draw indexed instances: all entities with triangle geometry
-        vk.vkCmdDrawIndexed(
-            commandBuffer, 
-            resourceCoordinator->getGraphicsManager()->getIndexCount(),  // Number of indices per triangle
-            entityCount,                      // Number of instances (entities)
-            0, 0, 0                          // Index/vertex/instance offsets
-        );
+void EntityGraphicsNode::acquirePublishedSnapshots(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    const uint32_t acquires = pendingSnapshotAcquires;
+    if (acquires == 0) {
+        return;
+    }
+    
+    // Acquire half of the queue family ownership transfer released by EntityPublishNode (ranges must match)
+    const VulkanContext& context = *frameGraph.getContext();
+    const EntityBufferManager& buffers = gpuEntityManager->getBufferManager();
+    std::vector<VkBufferMemoryBarrier2KHR> acquireBarriers;
+    for (uint32_t slot = 0; slot < PUBLISHED_SNAPSHOT_COUNT; ++slot) {
+        if ((acquires & (1u << slot)) == 0) {
+            continue;
+        }
         
-        // Debug: confirm draw call (thread-safe)
-        FRAME_GRAPH_DEBUG_LOG_THROTTLED(drawCounter, 1800, "EntityGraphicsNode: Drew " << entityCount << " entities with " << resourceCoordinator->getGraphicsManager()->getIndexCount() << " indices per triangle");
+        const VkBuffer snapshots[] = {
+            buffers.getPublishedPositionBuffer(slot),
+            buffers.getPublishedVisibleIndexBuffer(slot),
+            buffers.getPublishedDrawCommandBuffer(slot)
+        };
+        for (VkBuffer snapshot : snapshots) {
+            VkBufferMemoryBarrier2KHR barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+            barrier.srcStageMask = 0;
+            barrier.srcAccessMask = 0;
+            barrier.dstStageMask = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR;
+            barrier.dstAccessMask = VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR | VK_ACCESS_2_SHADER_READ_BIT_KHR;
+            barrier.srcQueueFamilyIndex = context.getComputeQueueFamily();
+            barrier.dstQueueFamilyIndex = context.getGraphicsQueueFamily();
+            barrier.buffer = snapshot;
+            barrier.offset = 0;
+            barrier.size = VK_WHOLE_SIZE;
+            acquireBarriers.push_back(barrier);
+        }
     }
+    
+    frameGraph.getBarrierManager().insertBufferBarriers(
+        commandBuffer, acquireBarriers.data(), static_cast<uint32_t>(acquireBarriers.size()));
+}
 
-    // End render pass
-    vk.vkCmdEndRenderPass(commandBuffer);
+namespace {
+// Original fallback camera when none was set
+ViewportCamera fallbackCamera(const glm::vec4& rect) {
+    ViewportCamera camera{rect, glm::mat4(1.0f), glm::ortho(-4.0f, 4.0f, -3.0f, 3.0f, -5.0f, 5.0f), glm::mat4(0.0f)};
+    camera.projection[1][1] *= -1; // Flip Y for Vulkan
+    camera.viewProjection = camera.projection * camera.view;
+    return camera;
+}
 }
 
-void EntityGraphicsNode::updateUniformBuffer() {
-    if (!resourceCoordinator) return;
-    
-    // Check if uniform buffer needs updating for this frame index
-    bool needsUpdate = uniformBufferDirty || (lastUpdatedFrameIndex != currentFrameIndex);
+void EntityGraphicsNode::setViewportCameras(const std::vector<ViewportCamera>& cameras, uint64_t version) {
+    if (version == viewportCameraVersion) {
+        return;
+    }
+    viewportCameraVersion = version;
+    viewportCameras = cameras;
     
-    struct UniformBufferObject {
-        glm::mat4 view;
-        glm::mat4 proj;
-    } newUBO{};
+    // Resolve missing matrices here rather than comparing them every frame
+    for (auto& camera : viewportCameras) {
+        if (camera.view == glm::mat4(0.0f) || camera.projection == glm::mat4(0.0f)) {
+            camera = fallbackCamera(camera.rect);
+            FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 1, "EntityGraphicsNode: Using fallback matrices - no camera set");
+        }
+    }
+}
+
+EntityGraphicsNode::FrameUniforms EntityGraphicsNode::getFrameUniforms(const ViewportCamera& camera, uint32_t viewport) {
+    FrameUniforms uniforms{};
+    uniforms.timing = glm::vec4(frameTime, frameDeltaTime, interpolationAlpha, static_cast<float>(viewportBase + viewport));
 
-    // Get camera matrices from service
-    auto& cameraService = ServiceLocator::instance().requireService<CameraService>();
-    newUBO.view = cameraService.getViewMatrix();
-    newUBO.proj = cameraService.getProjectionMatrix();
+    uniforms.view = camera.view;
+    uniforms.proj = camera.projection;
     
     // Debug camera matrix application (once every 30 seconds) - thread-safe
     if constexpr (FRAME_GRAPH_DEBUG_ENABLED) {
         uint32_t counter = FrameGraphDebug::incrementCounter(debugCounter);
         if (counter % 1800 == 0) {
-            std::cout << "[FrameGraph Debug] EntityGraphicsNode: Using camera matrices from service (occurrence #" << counter << ")" << std::endl;
-            std::cout << "  View matrix[3]: " << newUBO.view[3][0] << ", " << newUBO.view[3][1] << ", " << newUBO.view[3][2] << std::endl;
-            std::cout << "  Proj matrix[0][0]: " << newUBO.proj[0][0] << ", [1][1]: " << newUBO.proj[1][1] << std::endl;
+            LOG_INFO("[FrameGraph Debug] EntityGraphicsNode: Using frame camera matrices (occurrence #" << counter << ")");
+            LOG_INFO("  View matrix[3]: " << uniforms.view[3][0] << ", " << uniforms.view[3][1] << ", " << uniforms.view[3][2]);
+            LOG_INFO("  Proj matrix[0][0]: " << uniforms.proj[0][0] << ", [1][1]: " << uniforms.proj[1][1]);
         }
     }
     
-    // If no valid matrices, use fallback
-    if (newUBO.view == glm::mat4(0.0f) || newUBO.proj == glm::mat4(0.0f)) {
-        // Original fallback matrices when no world is set
-        newUBO.view = glm::mat4(1.0f);
-        newUBO.proj = glm::ortho(-4.0f, 4.0f, -3.0f, 3.0f, -5.0f, 5.0f);
-        newUBO.proj[1][1] *= -1; // Flip Y for Vulkan
-        
-        FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 1800, "EntityGraphicsNode: Using fallback matrices - no world reference");
-    }
-    
-    // Check if matrices actually changed (avoid memcmp by comparing key components)
-    bool matricesChanged = (newUBO.view != cachedUBO.view) || (newUBO.proj != cachedUBO.proj);
-    
-    // Only update if dirty, frame changed, or matrices changed
-    if (needsUpdate || matricesChanged) {
-        auto uniformBuffers = resourceCoordinator->getGraphicsManager()->getUniformBuffersMapped();
-        
-        // Auto-recreate uniform buffers if they were destroyed (e.g., during resize)
-        if (uniformBuffers.empty()) {
-            std::cout << "EntityGraphicsNode: Uniform buffers missing, attempting to recreate..." << std::endl;
-            if (resourceCoordinator->getGraphicsManager()->createAllGraphicsResources()) {
-                std::cout << "EntityGraphicsNode: Successfully recreated graphics resources" << std::endl;
-                uniformBuffers = resourceCoordinator->getGraphicsManager()->getUniformBuffersMapped();
-            } else {
-                std::cerr << "EntityGraphicsNode: CRITICAL ERROR: Failed to recreate graphics resources!" << std::endl;
-                return;
-            }
-        }
-        
-        if (!uniformBuffers.empty() && currentFrameIndex < uniformBuffers.size()) {
-            void* data = uniformBuffers[currentFrameIndex];
-            if (data) {
-                memcpy(data, &newUBO, sizeof(newUBO));
-                
-                // Update cache and tracking
-                cachedUBO.view = newUBO.view;
-                cachedUBO.proj = newUBO.proj;
-                uniformBufferDirty = false;
-                lastUpdatedFrameIndex = currentFrameIndex;
-                
-                // Debug optimized updates (once every 30 seconds) - thread-safe
-                FRAME_GRAPH_DEBUG_LOG_THROTTLED(updateCounter, 1800, "EntityGraphicsNode: Updated uniform buffer (optimized)");
-            }
-        } else {
-            std::cerr << "EntityGraphicsNode: ERROR: invalid currentFrameIndex (" << currentFrameIndex 
-                     << ") or uniformBuffers size (" << uniformBuffers.size() << ")!" << std::endl;
-        }
-    }
+    return uniforms;
 }
 
 // Node lifecycle implementation
 bool EntityGraphicsNode::initializeNode(const FrameGraph& frameGraph) {
     // One-time initialization - validate dependencies
     if (!graphicsManager) {
-        std::cerr << "EntityGraphicsNode: GraphicsPipelineManager is null" << std::endl;
+        LOG_ERROR("EntityGraphicsNode: GraphicsPipelineManager is null");
         return false;
     }
     if (!swapchain) {
-        std::cerr << "EntityGraphicsNode: VulkanSwapchain is null" << std::endl;
+        LOG_ERROR("EntityGraphicsNode: VulkanSwapchain is null");
         return false;
     }
     if (!resourceCoordinator) {
-        std::cerr << "EntityGraphicsNode: ResourceCoordinator is null" << std::endl;
+        LOG_ERROR("EntityGraphicsNode: ResourceCoordinator is null");
         return false;
     }
     if (!gpuEntityManager) {
-        std::cerr << "EntityGraphicsNode: GPUEntityManager is null" << std::endl;
+        LOG_ERROR("EntityGraphicsNode: GPUEntityManager is null");
         return false;
     }
     return true;
@@ -365,11 +806,110 @@ void EntityGraphicsNode::prepareFrame(uint32_t frameIndex, float time, float del
     frameTime = time;
     frameDeltaTime = deltaTime;
     currentFrameIndex = frameIndex;
+    frameResolved = false;
+    resolvedPickFrame = false;
+    resolvedOverdrawSet = VK_NULL_HANDLE;
+    
+    // Validate dependencies are still valid
+    if (!graphicsManager || !swapchain || !resourceCoordinator || !gpuEntityManager) {
+        LOG_ERROR("EntityGraphicsNode: Critical error - dependencies became null during execution");
+        drawPublishedSnapshot = false;
+        pendingSnapshotAcquires = 0;
+        entityCount = 0;
+        return;
+    }
     
-    // Check if uniform buffer needs updating
-    if (uniformBufferDirty || lastUpdatedFrameIndex != frameIndex) {
-        updateUniformBuffer();
+    // Everything execute() records is resolved here, before the frame graph decides whether to replay it.
+    // Runs after EntityPublishNode has executed, so the snapshot slot and acquires are this frame's
+    drawPublishedSnapshot = gpuEntityManager->isPipelinedComputeActive();
+    pendingSnapshotAcquires = drawPublishedSnapshot ? gpuEntityManager->takeSnapshotAcquires() : 0;
+    snapshotSlot = gpuEntityManager->getGraphicsSnapshotSlot();
+    entityCount = gpuEntityManager->getEntityCount();
+    if (entityCount == 0) {
+        if (viewportBase == 0) {
+            gpuEntityManager->getBufferManager().failEntityIdPick();  // Nothing to draw the pick into
+        }
+        return;
+    }
+    
+    // Fresh frame constants every frame, replayed or not - this slot's ring region is no longer read by the GPU
+    static_assert(sizeof(FrameUniforms) == EntityDescriptorBindings::Graphics::UNIFORM_BUFFER_RANGE,
+                  "Frame UBO must match the bound descriptor range");
+    static_assert(offsetof(FrameUniforms, proj) == offsetof(FrameUniforms, view) + sizeof(glm::mat4),
+                  "CameraLatch writes view and projection as one contiguous pair");
+    FrameRingAllocator* frameRing = resourceCoordinator->getFrameRingAllocator();
+    viewportCount = std::clamp(static_cast<uint32_t>(viewportCameras.size()), 1u, MAX_RENDER_VIEWPORTS);
+    for (uint32_t viewport = 0; viewport < viewportCount; ++viewport) {
+        const FrameUniforms frameUniforms = getFrameUniforms(
+            viewport < viewportCameras.size() ? viewportCameras[viewport] : fallbackCamera(glm::vec4(0.0f, 0.0f, 1.0f, 1.0f)), viewport);
+        const FrameRingAllocator::Allocation uniformAllocation = frameRing
+            ? frameRing->push(&frameUniforms, sizeof(frameUniforms))
+            : FrameRingAllocator::Allocation{};
+        if (!uniformAllocation.isValid()) {
+            LOG_ERROR("EntityGraphicsNode: Failed to allocate frame uniforms from the frame ring");
+            return;
+        }
+        frameUniformOffsets[viewport] = uniformAllocation.dynamicOffset;
+        if (cameraLatch) {
+            cameraLatch->addTarget(&static_cast<FrameUniforms*>(uniformAllocation.mapped)->view);
+        }
+    }
+    
+    frameResolved = resolveFrame();
+}
+
+uint64_t EntityGraphicsNode::getRecordingKey() const {
+    // An unresolved frame records nothing but may be resolvable next frame; a pick frame registers its
+    // readback while recording
+    if (entityCount > 0 && (!frameResolved || resolvedPickFrame)) {
+        return UNCACHEABLE_RECORDING;
+    }
+    
+    // Everything execute() bakes into the command buffer; the ring offset repeats per slot as long as this
+    // node is the slot's first ring allocation
+    uint64_t key = combineRecordingKey(0, imageIndex);
+    key = combineRecordingKey(key, entityCount > 0 ? 1 : 0);
+    key = combineRecordingKey(key, drawPublishedSnapshot ? 1 : 0);
+    key = combineRecordingKey(key, pendingSnapshotAcquires);
+    key = combineRecordingKey(key, snapshotSlot);
+    key = combineRecordingKey(key, gpuEntityManager->getBufferGeneration());
+    if (entityCount > 0) {
+        key = combineRecordingKey(key, resolvedDensityTiles ? 1 : 0);
+        key = combineRecordingKey(key, recordingHandleKey(resolvedPipeline));
+        key = combineRecordingKey(key, recordingHandleKey(resolvedPipelineLayout));
+        key = combineRecordingKey(key, recordingHandleKey(resolvedOverdrawSet));
+        if (resolvedOverdrawSet != VK_NULL_HANDLE) {
+            key = combineRecordingKey(key, recordingHandleKey(resolvedOverdrawView));
+            key = combineRecordingKey(key, overdrawMonitor->getBindingGeneration());
+        }
+        key = combineRecordingKey(key, recordingHandleKey(cachedRenderPass));
+        key = combineRecordingKey(key, recordingHandleKey(resolvedFramebuffer));
+        key = combineRecordingKey(key, resolvedDynamicRendering ? 1 : 0);
+        if (resolvedDynamicRendering) {
+            key = combineRecordingKey(key, recordingHandleKey(resolvedTargetView));
+            key = combineRecordingKey(key, recordingHandleKey(resolvedMSAAColorView));
+            key = combineRecordingKey(key, recordingHandleKey(resolvedDepthView));
+            key = combineRecordingKey(key, resolvedOutputLayout);
+        }
+        key = combineRecordingKey(key, (static_cast<uint64_t>(resolvedExtent.width) << 32) | resolvedExtent.height);
+        key = combineRecordingKey(key, recordingHandleKey(resolvedScaledImage));
+        key = combineRecordingKey(key, recordingHandleKey(resolvedSwapchainImage));
+        key = combineRecordingKey(key, (static_cast<uint64_t>(resolvedOutputExtent.width) << 32) | resolvedOutputExtent.height);
+        key = combineRecordingKey(key, recordingHandleKey(resolvedDescriptorSet));
+        key = combineRecordingKey(key, recordingHandleKey(resolvedUniformSet));
+        key = combineRecordingKey(key, resolvedEntityTable);
+        key = combineRecordingKey(key, recordingHandleKey(resolvedDrawCommandBuffer));
+        key = combineRecordingKey(key, recordingHandleKey(resolvedVertexBuffer));
+        key = combineRecordingKey(key, recordingHandleKey(resolvedIndexBuffer));
+        key = combineRecordingKey(key, viewportCount);
+        for (uint32_t viewport = 0; viewport < viewportCount; ++viewport) {
+            const VkRect2D& rect = resolvedViewportRects[viewport];
+            key = combineRecordingKey(key, frameUniformOffsets[viewport]);
+            key = combineRecordingKey(key, (static_cast<uint64_t>(static_cast<uint32_t>(rect.offset.x)) << 32) | static_cast<uint32_t>(rect.offset.y));
+            key = combineRecordingKey(key, (static_cast<uint64_t>(rect.extent.width) << 32) | rect.extent.height);
+        }
     }
+    return key;
 }
 
 void EntityGraphicsNode::releaseFrame(uint32_t frameIndex) {
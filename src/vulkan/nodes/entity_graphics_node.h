@@ -4,17 +4,25 @@
 #include <vulkan/vulkan.h>
 #include "../rendering/frame_graph.h"
 #include "../rendering/frame_graph_debug.h"
+#include "../rendering/viewport_camera.h"
+#include "../core/vulkan_constants.h"
 #include <flecs.h>
 #include <cstdint>
 #include <glm/glm.hpp>
 #include <memory>
 #include <limits>
+#include <array>
+#include <vector>
 
 // Forward declarations
+class VulkanContext;
+class VulkanFunctionLoader;
 class GraphicsPipelineManager;
 class VulkanSwapchain;
 class ResourceCoordinator;
 class GPUEntityManager;
+class CameraLatch;
+class OverdrawMonitor;
 
 class EntityGraphicsNode : public FrameGraphNode {
     DECLARE_FRAME_GRAPH_NODE(EntityGraphicsNode)
@@ -23,6 +31,9 @@ public:
     EntityGraphicsNode(
         FrameGraphTypes::ResourceId entityBuffer, 
         FrameGraphTypes::ResourceId positionBuffer,
+        FrameGraphTypes::ResourceId previousPositionBuffer,
+        FrameGraphTypes::ResourceId visibleIndexBuffer,
+        FrameGraphTypes::ResourceId visibleDrawCommandBuffer,
         FrameGraphTypes::ResourceId colorTarget,
         GraphicsPipelineManager* graphicsManager,
         VulkanSwapchain* swapchain,
@@ -35,9 +46,14 @@ public:
     std::vector<ResourceDependency> getOutputs() const override;
     void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
     
+    // Replayable once prepareFrame() has resolved the pipeline, buffers and snapshot acquires
+    uint64_t getRecordingKey() const override;
+    
     // Queue requirements
-    bool needsComputeQueue() const override { return false; }
-    bool needsGraphicsQueue() const override { return true; }
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::Graphics; }
+    
+    // Vertex invocations and clipped primitives confirm what GPU culling removes from the draw
+    bool wantsPipelineStatistics() const override { return true; }
     
     // Update swapchain image index for current frame
     void setImageIndex(uint32_t imageIndex) { this->imageIndex = imageIndex; }
@@ -45,6 +61,30 @@ public:
     // Set current frame's swapchain image resource ID (called each frame)
     void setCurrentSwapchainImageId(FrameGraphTypes::ResourceId currentImageId) { this->currentSwapchainImageId = currentImageId; }
     
+    // Blend from the previous simulation tick's positions to the latest (SimulationStep), set each frame
+    void setInterpolationAlpha(float alpha) { interpolationAlpha = alpha; }
+    
+    // Camera views captured by the frame's producer, so recording never reads CameraService state mid-update.
+    // One draw per view (up to MAX_RENDER_VIEWPORTS) within the same render pass, each in its rect. Copied,
+    // with the no-camera fallback resolved, only when version changes
+    void setViewportCameras(const std::vector<ViewportCamera>& cameras, uint64_t version);
+    
+    // Late latch (not owned): each viewport's frame UBO camera is registered as a latch target while preparing
+    void setCameraLatch(CameraLatch* latch) { cameraLatch = latch; }
+    
+    // Overdraw diagnostic (not owned, null while off): frames other than pick frames draw with the counting
+    // variant once it has compiled, counting into the swapchain's overdraw image for OverdrawNode. Set each frame
+    void setOverdrawMonitor(OverdrawMonitor* monitor) { overdrawMonitor = monitor; }
+    
+    // Output window nodes: culling view index of this node's first viewport (the frame UBO's viewport index, which
+    // vertex.vert tests against the visible mask). A node with a base leaves entity picks to the main window's
+    void setViewportBase(uint32_t base) { viewportBase = base; }
+    
+    // Output window nodes: whether this frame got an image of the node's swapchain, set before the frame's
+    // predicates are evaluated
+    void setTargetAcquired(bool acquired) { targetAcquired = acquired; }
+    bool isEnabled(const FrameContext& frameContext) const override { return targetAcquired; }
+    
     // Node lifecycle - standardized pattern
     bool initializeNode(const FrameGraph& frameGraph) override;
     void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
@@ -53,9 +93,6 @@ public:
     // Set world reference for camera matrix access
     void setWorld(flecs::world* world) { this->world = world; }
     
-    // Force uniform buffer update on next frame (call when camera changes)
-    void markUniformBufferDirty() { uniformBufferDirty = true; }
-    
     // Invalidate cached state after swapchain recreation or layout cache clear
     void invalidateCachedState() { 
         cachedRenderPass = VK_NULL_HANDLE; 
@@ -63,22 +100,43 @@ public:
     }
 
 private:
-    // Internal uniform buffer update
-    void updateUniformBuffer();
+    static constexpr VkClearColorValue CLEAR_COLOR = {{0.1f, 0.1f, 0.2f, 1.0f}};
+    static constexpr VkClearDepthStencilValue CLEAR_DEPTH = {1.0f, 0};
     
-    // Uniform buffer optimization - cache and dirty tracking
-    struct CachedUBO {
+    // Frame UBO contents, pushed into the frame ring allocator every frame (bound with a dynamic offset)
+    struct FrameUniforms {
         glm::mat4 view;
         glm::mat4 proj;
-    } cachedUBO{};
+        glm::vec4 timing;  // time, deltaTime, interpolation alpha, viewport index
+    };
     
-    // Helper methods for camera matrix management
-    CachedUBO getCameraMatrices();
-    bool updateUniformBufferData(const CachedUBO& ubo);
+    FrameUniforms getFrameUniforms(const ViewportCamera& camera, uint32_t viewport);
+    
+    // Resolve the pipeline, framebuffer and buffers execute() records (called from prepareFrame)
+    bool resolveFrame();
+    
+    // Dynamic rendering: the layout transitions the render pass would make, around vkCmdBegin/EndRenderingKHR
+    void beginDynamicRendering(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk) const;
+    void endDynamicRendering(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk) const;
+    
+    // Overdraw frames: zero the count image before the fragments add to it
+    void recordOverdrawClear(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk) const;
+    
+    // Entity pick frames: copy the picked pixel of the single-sample pick image into the readback ring
+    void recordPickReadback(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk);
+    
+    // Render scale other than 1: blit the scaled image to the swapchain image and hand it to presentation
+    void recordUpscaleBlit(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk) const;
+    
+    // Pipelined async compute: take ownership of the snapshots compute released for this frame
+    void acquirePublishedSnapshots(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph);
     
     // Resources
     FrameGraphTypes::ResourceId entityBufferId;
     FrameGraphTypes::ResourceId positionBufferId;
+    FrameGraphTypes::ResourceId previousPositionBufferId;
+    FrameGraphTypes::ResourceId visibleIndexBufferId;
+    FrameGraphTypes::ResourceId visibleDrawCommandBufferId;
     FrameGraphTypes::ResourceId colorTargetId; // Static placeholder - not used
     FrameGraphTypes::ResourceId currentSwapchainImageId = 0; // Dynamic per-frame ID
     
@@ -87,30 +145,82 @@ private:
     VulkanSwapchain* swapchain;
     ResourceCoordinator* resourceCoordinator;
     GPUEntityManager* gpuEntityManager;
+    CameraLatch* cameraLatch = nullptr;
+    OverdrawMonitor* overdrawMonitor = nullptr;
+    uint32_t viewportBase = 0;
+    bool targetAcquired = true;
     
     // Current frame state
     uint32_t imageIndex = 0;
     float frameTime = 0.0f;
     float frameDeltaTime = 0.0f;
+    float interpolationAlpha = 1.0f;
+    std::vector<ViewportCamera> viewportCameras;  // Empty until a camera is set - getFrameUniforms falls back
+    uint64_t viewportCameraVersion = 0;
     uint32_t currentFrameIndex = 0;
     
+    // Resolved by prepareFrame() for execute() and getRecordingKey()
+    bool frameResolved = false;
+    bool drawPublishedSnapshot = false;
+    uint32_t pendingSnapshotAcquires = 0;
+    uint32_t snapshotSlot = 0;
+    uint32_t entityCount = 0;
+    uint32_t viewportCount = 1;
+    std::array<uint32_t, MAX_RENDER_VIEWPORTS> frameUniformOffsets{};  // One frame UBO per viewport
+    std::array<VkRect2D, MAX_RENDER_VIEWPORTS> resolvedViewportRects{};
+    VkPipeline resolvedPipeline = VK_NULL_HANDLE;
+    VkFramebuffer resolvedFramebuffer = VK_NULL_HANDLE;   // Render pass path only
+    bool resolvedDynamicRendering = false;                // VK_KHR_dynamic_rendering, no render pass
+    VkImage resolvedTargetImage = VK_NULL_HANDLE;         // Dynamic rendering: output (or resolve) image
+    VkImageView resolvedTargetView = VK_NULL_HANDLE;
+    VkImage resolvedMSAAColorImage = VK_NULL_HANDLE;      // Dynamic rendering with MSAA only
+    VkImageView resolvedMSAAColorView = VK_NULL_HANDLE;
+    VkImage resolvedDepthImage = VK_NULL_HANDLE;          // Dynamic rendering with early depth only
+    VkImageView resolvedDepthView = VK_NULL_HANDLE;
+    bool resolvedPickFrame = false;                       // A queued entity pick is drawn and read back this frame
+    VkImage resolvedPickAttachmentImage = VK_NULL_HANDLE; // Pick attachment at the sample count
+    VkImageView resolvedPickAttachmentView = VK_NULL_HANDLE;
+    VkImage resolvedPickImage = VK_NULL_HANDLE;           // Single-sample copy source (the attachment or its resolve)
+    VkImageView resolvedPickView = VK_NULL_HANDLE;
+    VkOffset2D resolvedPickPixel{};
+    VkDescriptorSet resolvedOverdrawSet = VK_NULL_HANDLE; // Overdraw frames only, after the binding mode's sets
+    VkImage resolvedOverdrawImage = VK_NULL_HANDLE;
+    VkImageView resolvedOverdrawView = VK_NULL_HANDLE;
+    VkPipelineLayout resolvedPipelineLayout = VK_NULL_HANDLE;  // Counting variant's on overdraw frames
+    VkImageLayout resolvedOutputLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    VkExtent2D resolvedExtent{};
+    VkDescriptorSet resolvedDescriptorSet = VK_NULL_HANDLE;
+    VkDescriptorSet resolvedUniformSet = VK_NULL_HANDLE;  // Bindless mode only (set 1)
+    bool resolvedPushesEntityTable = false;               // Bindless and buffer address modes
+    uint64_t resolvedEntityTable = 0;
+    VkBuffer resolvedDrawCommandBuffer = VK_NULL_HANDLE;
+    VkBuffer resolvedVertexBuffer = VK_NULL_HANDLE;
+    VkBuffer resolvedIndexBuffer = VK_NULL_HANDLE;
+    bool resolvedProceduralGeometry = false;              // Non-indexed draw without vertex or index buffers
+    bool resolvedShapeBinned = false;                     // One indexed draw per entity shape, counted by the GPU
+    bool resolvedDensityTiles = false;                    // Density LOD heat map in place of the entities
+    VkImage resolvedScaledImage = VK_NULL_HANDLE;         // Render scale other than 1 only, blitted to the swapchain image
+    VkImage resolvedSwapchainImage = VK_NULL_HANDLE;
+    VkExtent2D resolvedOutputExtent{};
+    VkFilter resolvedUpscaleFilter = VK_FILTER_LINEAR;
+    
     // ECS world reference for camera matrices
     flecs::world* world = nullptr;
     
-    bool uniformBufferDirty = true;  // Force update on first frame
-    uint32_t lastUpdatedFrameIndex = UINT32_MAX; // Track which frame index was last updated
-
     // Cached render pass to avoid redundant lookups/creation
     VkRenderPass cachedRenderPass = VK_NULL_HANDLE;
     VkFormat cachedColorFormat = VK_FORMAT_UNDEFINED;
+    VkFormat cachedDepthFormat = VK_FORMAT_UNDEFINED;
     VkSampleCountFlagBits cachedSamples = VK_SAMPLE_COUNT_1_BIT;
     bool cachedEnableMSAA = false;
+    VkImageLayout cachedOutputLayout = VK_IMAGE_LAYOUT_UNDEFINED;
 
     // Cached descriptor layout used by the pipeline state
     VkDescriptorSetLayout cachedDescriptorLayout = VK_NULL_HANDLE;
     
     // Cached pipeline layout for binding and push constants
     VkPipelineLayout cachedPipelineLayout = VK_NULL_HANDLE;
+    VkPipelineLayout cachedOverdrawPipelineLayout = VK_NULL_HANDLE;  // With OverdrawMonitor's set appended
     
     // Observed generations to detect cache invalidation
     uint64_t observedLayoutGeneration = std::numeric_limits<uint64_t>::max();
@@ -120,5 +230,4 @@ private:
     mutable FrameGraphDebug::DebugCounter debugCounter{};
     mutable FrameGraphDebug::DebugCounter noEntitiesCounter{};
     mutable FrameGraphDebug::DebugCounter drawCounter{};
-    mutable FrameGraphDebug::DebugCounter updateCounter{};
 };
@@ -0,0 +1,137 @@
+#include "entity_publish_node.h"
+#include "../../ecs/gpu/gpu_entity_manager.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../../ecs/utilities/logger.h"
+#include <array>
+#include <stdexcept>
+
+EntityPublishNode::EntityPublishNode(
+    FrameGraphTypes::ResourceId positionBuffer,
+    FrameGraphTypes::ResourceId visibleIndexBuffer,
+    FrameGraphTypes::ResourceId visibleDrawCommandBuffer,
+    GPUEntityManager* gpuEntityManager
+) : positionBufferId(positionBuffer)
+  , visibleIndexBufferId(visibleIndexBuffer)
+  , visibleDrawCommandBufferId(visibleDrawCommandBuffer)
+  , gpuEntityManager(gpuEntityManager) {
+    
+    // Validate dependencies during construction for fail-fast behavior
+    if (!gpuEntityManager) {
+        throw std::invalid_argument("EntityPublishNode: gpuEntityManager cannot be null");
+    }
+}
+
+std::vector<ResourceDependency> EntityPublishNode::getInputs() const {
+    return {
+        {positionBufferId, ResourceAccess::Read, PipelineStage::Transfer},
+        {visibleIndexBufferId, ResourceAccess::Read, PipelineStage::Transfer},
+    };
+}
+
+std::vector<ResourceDependency> EntityPublishNode::getOutputs() const {
+    // Declared as a write so EntityGraphicsNode, which reads the same stream, always records after the publish
+    return {
+        {visibleDrawCommandBufferId, ResourceAccess::Write, PipelineStage::Transfer},
+    };
+}
+
+void EntityPublishNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    if (!gpuEntityManager) {
+        LOG_ERROR("EntityPublishNode: Critical error - gpuEntityManager became null during execution");
+        return;
+    }
+    
+    if (!gpuEntityManager->isPipelinedComputeActive()) {
+        return;
+    }
+    
+    const VulkanContext* context = frameGraph.getContext();
+    if (!context) {
+        LOG_ERROR("EntityPublishNode: Cannot get Vulkan context");
+        return;
+    }
+    
+    const auto& vk = context->getLoader();
+    const auto& barriers = frameGraph.getBarrierManager();
+    const EntityBufferManager& buffers = gpuEntityManager->getBufferManager();
+    const uint32_t slot = gpuEntityManager->beginSnapshotPublish();
+    const uint32_t entityCount = gpuEntityManager->getEntityCount();
+    
+    // Physics and culling results become copy sources. Overwriting the snapshot itself needs no barrier:
+    // the submit waits on the graphics frame that last read it.
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+    
+    // Multi-device simulation writes the rendering GPU's instance of the snapshot through peer memory
+    const bool multiDevice = context->isMultiDeviceSimulation();
+    const std::array<VkBuffer, 3> snapshots = multiDevice ? std::array<VkBuffer, 3>{
+        buffers.getPublishedPositionRenderInstance(slot),
+        buffers.getPublishedVisibleIndexRenderInstance(slot),
+        buffers.getPublishedDrawCommandRenderInstance(slot)
+    } : std::array<VkBuffer, 3>{
+        buffers.getPublishedPositionBuffer(slot),
+        buffers.getPublishedVisibleIndexBuffer(slot),
+        buffers.getPublishedDrawCommandBuffer(slot)
+    };
+    
+    // Only the live range carries data; the draw command always goes so an empty world draws nothing
+    if (entityCount > 0) {
+        VkBufferCopy positionCopy{0, 0, static_cast<VkDeviceSize>(entityCount) * sizeof(glm::vec4)};
+        vk.vkCmdCopyBuffer(commandBuffer, buffers.getPositionBuffer(), snapshots[0], 1, &positionCopy);
+        
+        VkBufferCopy visibleIndexCopy{0, 0, static_cast<VkDeviceSize>(entityCount) * sizeof(uint32_t)};
+        vk.vkCmdCopyBuffer(commandBuffer, buffers.getVisibleIndexBuffer(), snapshots[1], 1, &visibleIndexCopy);
+    }
+    
+    // Every shape's draw and the draw count, for the shape-binned count draw
+    VkBufferCopy drawCopy{0, 0, sizeof(VisibleDrawCommands)};
+    vk.vkCmdCopyBuffer(commandBuffer, buffers.getVisibleDrawCommandBuffer(), snapshots[2], 1, &drawCopy);
+    
+    // The colour, movement and ID streams graphics reads as well only follow when this frame does not lag:
+    // frames that rewrite them (moved slots, spawns) draw their own snapshot
+    if (multiDevice && !gpuEntityManager->isGraphicsLaggingCompute() && entityCount > 0) {
+        buffers.recordStreamMirror(commandBuffer, entityCount);
+    }
+    
+    // Same family: the timeline semaphore wait already makes the copies visible to graphics. Multi-device
+    // snapshots never need one, only the aliases are written on the compute family
+    if (gpuEntityManager->snapshotsNeedOwnershipTransfer()) {
+        std::array<VkBufferMemoryBarrier2KHR, 3> releaseBarriers{};
+        for (size_t i = 0; i < snapshots.size(); ++i) {
+            releaseBarriers[i].sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+            releaseBarriers[i].srcStageMask = VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
+            releaseBarriers[i].srcAccessMask = VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR;
+            releaseBarriers[i].dstStageMask = 0;
+            releaseBarriers[i].dstAccessMask = 0;
+            releaseBarriers[i].srcQueueFamilyIndex = context->getComputeQueueFamily();
+            releaseBarriers[i].dstQueueFamilyIndex = context->getGraphicsQueueFamily();
+            releaseBarriers[i].buffer = snapshots[i];
+            releaseBarriers[i].offset = 0;
+            releaseBarriers[i].size = VK_WHOLE_SIZE;
+        }
+        
+        barriers.insertBufferBarriers(commandBuffer, releaseBarriers.data(), static_cast<uint32_t>(releaseBarriers.size()));
+    }
+    
+    FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 1800, "EntityPublishNode: published " << entityCount << " entities into snapshot " << slot
+                                    << (gpuEntityManager->isGraphicsLaggingCompute() ? " (graphics one frame behind)" : " (graphics serialized)"));
+}
+
+// Node lifecycle implementation
+bool EntityPublishNode::initializeNode(const FrameGraph& frameGraph) {
+    if (!gpuEntityManager) {
+        LOG_ERROR("EntityPublishNode: GPUEntityManager is null");
+        return false;
+    }
+    return true;
+}
+
+void EntityPublishNode::prepareFrame(uint32_t frameIndex, float time, float deltaTime) {
+    // Snapshot slots follow the publish count, not the frame-in-flight index
+}
+
+void EntityPublishNode::releaseFrame(uint32_t frameIndex) {
+    // Per-frame cleanup - nothing to clean up for publish node
+}
@@ -0,0 +1,52 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/frame_graph.h"
+#include "../rendering/frame_graph_debug.h"
+
+// Forward declarations
+class GPUEntityManager;
+
+// Pipelined async compute: copies this frame's positions, visible indices and culled draw command
+// into published snapshot N % PUBLISHED_SNAPSHOT_COUNT and releases them to the graphics queue family, so the next frame
+// can draw them while compute already simulates ahead. Runs after EntityCullingNode and is only
+// recorded while GPUEntityManager::isPipelinedComputeActive().
+class EntityPublishNode : public FrameGraphNode {
+    DECLARE_FRAME_GRAPH_NODE(EntityPublishNode)
+    
+public:
+    EntityPublishNode(
+        FrameGraphTypes::ResourceId positionBuffer,
+        FrameGraphTypes::ResourceId visibleIndexBuffer,
+        FrameGraphTypes::ResourceId visibleDrawCommandBuffer,
+        GPUEntityManager* gpuEntityManager
+    );
+    
+    // FrameGraphNode interface
+    std::vector<ResourceDependency> getInputs() const override;
+    std::vector<ResourceDependency> getOutputs() const override;
+    void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
+    
+    // A snapshot is only published for a frame that draws, so every release has its acquire
+    bool isEnabled(const FrameContext& frameContext) const override { return frameContext.presenting; }
+    
+    // Queue requirements
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::Transfer; }
+    
+    // Node lifecycle - standardized pattern
+    bool initializeNode(const FrameGraph& frameGraph) override;
+    void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
+    void releaseFrame(uint32_t frameIndex) override;
+
+private:
+    FrameGraphTypes::ResourceId positionBufferId;
+    FrameGraphTypes::ResourceId visibleIndexBufferId;
+    FrameGraphTypes::ResourceId visibleDrawCommandBufferId;
+    
+    // External dependencies (not owned) - validated during execution
+    GPUEntityManager* gpuEntityManager;
+    
+    // Debug counter - zero overhead in release builds
+    mutable FrameGraphDebug::DebugCounter debugCounter{};
+};
@@ -0,0 +1,80 @@
+#include "entity_readback_node.h"
+#include "../resources/core/resource_coordinator.h"
+#include "../resources/core/readback_ring.h"
+#include "../../ecs/utilities/logger.h"
+#include <stdexcept>
+
+EntityReadbackNode::EntityReadbackNode(
+    FrameGraphTypes::ResourceId entityBuffer,
+    FrameGraphTypes::ResourceId positionBuffer,
+    FrameGraphTypes::ResourceId spatialMapBuffer,
+    FrameGraphTypes::ResourceId spatialIndexBuffer,
+    ResourceCoordinator* resourceCoordinator
+) : entityBufferId(entityBuffer)
+  , positionBufferId(positionBuffer)
+  , spatialMapBufferId(spatialMapBuffer)
+  , spatialIndexBufferId(spatialIndexBuffer)
+  , resourceCoordinator(resourceCoordinator) {
+  
+    // Validate dependencies during construction for fail-fast behavior
+    if (!resourceCoordinator) {
+        throw std::invalid_argument("EntityReadbackNode: resourceCoordinator cannot be null");
+    }
+}
+
+std::vector<ResourceDependency> EntityReadbackNode::getInputs() const {
+    // The entity streams debug readbacks read; they order the node after every pass writing them
+    return {
+        {entityBufferId, ResourceAccess::Read, PipelineStage::Transfer},
+        {positionBufferId, ResourceAccess::Read, PipelineStage::Transfer},
+        {spatialMapBufferId, ResourceAccess::Read, PipelineStage::Transfer},
+        {spatialIndexBufferId, ResourceAccess::Read, PipelineStage::Transfer},
+    };
+}
+
+std::vector<ResourceDependency> EntityReadbackNode::getOutputs() const {
+    return {};
+}
+
+bool EntityReadbackNode::isEnabled(const FrameContext& frameContext) const {
+    if (!resourceCoordinator) return false;
+    const ReadbackRing* ring = resourceCoordinator->getReadbackRing();
+    const ReadbackRing* streamingRing = resourceCoordinator->getStreamingReadbackRing();
+    return (ring && ring->hasPendingRequests()) || (streamingRing && streamingRing->hasPendingRequests());
+}
+
+void EntityReadbackNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    ReadbackRing* ring = resourceCoordinator ? resourceCoordinator->getReadbackRing() : nullptr;
+    if (!ring) {
+        LOG_ERROR("EntityReadbackNode: Critical error - readback ring unavailable during execution");
+        return;
+    }
+    
+    // Requests may name buffers the graph does not track (spawn IDs), so every compute and copy write counts
+    const auto& barriers = frameGraph.getBarrierManager();
+    barriers.insertMemoryBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR,
+        VK_ACCESS_2_SHADER_WRITE_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+    
+    // Both rings share the barriers; the streaming ring only exists while something streams through it
+    bool recorded = ring->recordCopies(commandBuffer);
+    if (ReadbackRing* streamingRing = resourceCoordinator->getStreamingReadbackRing()) {
+        recorded = streamingRing->recordCopies(commandBuffer) || recorded;
+    }
+    if (recorded) {
+        barriers.insertMemoryBarrier(
+            commandBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            VK_PIPELINE_STAGE_2_HOST_BIT_KHR, VK_ACCESS_2_HOST_READ_BIT_KHR);
+    }
+}
+
+// Node lifecycle implementation
+bool EntityReadbackNode::initializeNode(const FrameGraph& frameGraph) {
+    if (!resourceCoordinator || !resourceCoordinator->getReadbackRing()) {
+        LOG_ERROR("EntityReadbackNode: ReadbackRing is not available");
+        return false;
+    }
+    return true;
+}
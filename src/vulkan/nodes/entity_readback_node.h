@@ -0,0 +1,45 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/frame_graph.h"
+
+// Forward declarations
+class ResourceCoordinator;
+
+// Records queued ReadbackRing copies (the default and the streaming ring) at the end of the compute work, after
+// physics and the spatial grid have written this frame's data. Disabled while nothing is queued, so idle frames
+// carry no barriers.
+class EntityReadbackNode : public FrameGraphNode {
+    DECLARE_FRAME_GRAPH_NODE(EntityReadbackNode)
+
+public:
+    EntityReadbackNode(
+        FrameGraphTypes::ResourceId entityBuffer,
+        FrameGraphTypes::ResourceId positionBuffer,
+        FrameGraphTypes::ResourceId spatialMapBuffer,
+        FrameGraphTypes::ResourceId spatialIndexBuffer,
+        ResourceCoordinator* resourceCoordinator
+    );
+    
+    // FrameGraphNode interface
+    std::vector<ResourceDependency> getInputs() const override;
+    std::vector<ResourceDependency> getOutputs() const override;
+    bool isEnabled(const FrameContext& frameContext) const override;
+    void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
+    
+    // Queue requirements
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::Transfer; }
+    
+    // Node lifecycle - standardized pattern
+    bool initializeNode(const FrameGraph& frameGraph) override;
+
+private:
+    FrameGraphTypes::ResourceId entityBufferId;
+    FrameGraphTypes::ResourceId positionBufferId;
+    FrameGraphTypes::ResourceId spatialMapBufferId;
+    FrameGraphTypes::ResourceId spatialIndexBufferId;
+    
+    // External dependencies (not owned) - validated during execution
+    ResourceCoordinator* resourceCoordinator;
+};
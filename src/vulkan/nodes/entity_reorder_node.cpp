@@ -0,0 +1,215 @@
+#include "entity_reorder_node.h"
+#include "../pipelines/compute_pipeline_manager.h"
+#include "../../ecs/gpu/gpu_entity_manager.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../core/vulkan_constants.h"
+#include "../pipelines/descriptor_layout_manager.h"
+#include "../monitoring/gpu_timeout_detector.h"
+#include "../../ecs/utilities/logger.h"
+#include <stdexcept>
+#include <memory>
+
+namespace {
+    constexpr uint32_t REORDER_PHASE_GATHER = 0;
+    constexpr uint32_t REORDER_PHASE_APPLY = 1;
+}
+
+EntityReorderNode::EntityReorderNode(
+    FrameGraphTypes::ResourceId entityBuffer,
+    FrameGraphTypes::ResourceId positionBuffer,
+    FrameGraphTypes::ResourceId currentPositionBuffer,
+    FrameGraphTypes::ResourceId spatialIndexBuffer,
+    ComputePipelineManager* computeManager,
+    GPUEntityManager* gpuEntityManager,
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector
+) : entityBufferId(entityBuffer)
+  , positionBufferId(positionBuffer)
+  , currentPositionBufferId(currentPositionBuffer)
+  , spatialIndexBufferId(spatialIndexBuffer)
+  , computeManager(computeManager)
+  , gpuEntityManager(gpuEntityManager)
+  , timeoutDetector(timeoutDetector) {
+    
+    // Validate dependencies during construction for fail-fast behavior
+    if (!computeManager) {
+        throw std::invalid_argument("EntityReorderNode: computeManager cannot be null");
+    }
+    if (!gpuEntityManager) {
+        throw std::invalid_argument("EntityReorderNode: gpuEntityManager cannot be null");
+    }
+}
+
+std::vector<ResourceDependency> EntityReorderNode::getInputs() const {
+    // Declared unconditionally so physics always orders after this node, even on idle frames
+    return {
+        {entityBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+        {positionBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+        {currentPositionBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+        {spatialIndexBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+    };
+}
+
+std::vector<ResourceDependency> EntityReorderNode::getOutputs() const {
+    return {
+        {entityBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+        {positionBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+        {currentPositionBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+        {spatialIndexBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+    };
+}
+
+bool EntityReorderNode::isEnabled(const FrameContext& frameContext) const {
+    if (reorderInterval == 0 || frameContext.globalFrame % reorderInterval != 0) return false;
+    // Physics rewrites the previous-tick positions after a permutation; without a tick they would stay unsorted
+    if (frameContext.simulation.tickCount == 0) return false;
+    return !gpuEntityManager || gpuEntityManager->getEntityCount() >= 2;
+}
+
+void EntityReorderNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    // Validate dependencies are still valid
+    if (!computeManager || !gpuEntityManager) {
+        LOG_ERROR("EntityReorderNode: Critical error - dependencies became null during execution");
+        return;
+    }
+    
+    const uint32_t frame = frameGraph.getGlobalFrameCounter();
+    if (reorderInterval == 0 || frame % reorderInterval != 0) {
+        return;
+    }
+    
+    const uint32_t entityCount = gpuEntityManager->getEntityCount();
+    if (entityCount < 2) {
+        return;
+    }
+    
+    const uint32_t workgroupCount = (entityCount + THREADS_PER_WORKGROUP - 1) / THREADS_PER_WORKGROUP;
+    if (workgroupCount > 65535) {
+        LOG_ERROR("ERROR: Workgroup count " << workgroupCount << " exceeds Vulkan limit!");
+        return;
+    }
+    
+    const auto& descriptorManager = gpuEntityManager->getDescriptorManager();
+    const uint64_t variant = gpuEntityManager->getComputeVariantKey();
+    bool ready = true;
+    for (uint32_t phase = REORDER_PHASE_GATHER; phase <= REORDER_PHASE_APPLY; ++phase) {
+        ready = phasePipelines[phase].resolve(*computeManager, variant, [&]() {
+            auto layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
+            VkDescriptorSetLayout descriptorLayout = computeManager->getLayoutManager()->getLayout(layoutSpec);
+            ComputePipelineState state = ComputePipelinePresets::createEntityReorderState(
+                descriptorLayout, phase, gpuEntityManager->isCompactLayout());
+            if (descriptorManager.usesStreamAddresses()) {
+                ComputePipelinePresets::applyEntityStreamAddresses(state);
+            } else if (descriptorManager.isBindless()) {
+                ComputePipelinePresets::applyBindlessEntityTable(state, descriptorManager.getBindlessTableLayout());
+            }
+            return state;
+        }) && ready;
+    }
+    
+    // Reordering is only a locality optimization, so a pass whose pipelines are still compiling is dropped
+    if (!ready) {
+        return;
+    }
+    VkPipeline gatherPipeline = phasePipelines[REORDER_PHASE_GATHER].getPipeline();
+    VkPipeline applyPipeline = phasePipelines[REORDER_PHASE_APPLY].getPipeline();
+    VkPipelineLayout pipelineLayout = phasePipelines[REORDER_PHASE_GATHER].getLayout();
+    if (pipelineLayout == VK_NULL_HANDLE) {
+        LOG_ERROR("EntityReorderNode: Failed to get reorder pipelines or layout");
+        return;
+    }
+    
+    VkDescriptorSet computeDescriptorSet = descriptorManager.getEntityComputeSet();
+    if (computeDescriptorSet == VK_NULL_HANDLE && !descriptorManager.usesStreamAddresses()) {
+        LOG_ERROR("EntityReorderNode: ERROR - Missing compute descriptor set!");
+        return;
+    }
+    
+    const VulkanContext* context = frameGraph.getContext();
+    if (!context) {
+        LOG_ERROR("EntityReorderNode: Cannot get Vulkan context");
+        return;
+    }
+    
+    pushConstants.entityCount = entityCount;
+    pushConstants.frame = frame;
+    pushConstants.entityOffset = 0;
+    pushConstants.entityTable = descriptorManager.getWorkingTable();
+    
+    FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 10, "EntityReorderNode: reordering " << entityCount << " entities by spatial cell");
+    
+    // Cache loader reference for performance
+    const auto& vk = context->getLoader();
+    const auto& barriers = frameGraph.getBarrierManager();
+    
+    // Both phases share the pipeline layout, so descriptors and push constants stay bound
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, gatherPipeline);
+    if (computeDescriptorSet != VK_NULL_HANDLE) {
+        vk.vkCmdBindDescriptorSets(
+            commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout,
+            0, 1, &computeDescriptorSet, 0, nullptr);
+    }
+    vk.vkCmdPushConstants(
+        commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(ReorderPushConstants), &pushConstants);
+    
+    if (timeoutDetector) {
+        static const ProfileZoneId zone = Profiler::getInstance().registerZone("EntityReorder_Gather");
+        timeoutDetector->beginComputeDispatch(commandBuffer, zone, workgroupCount);
+    }
+    vk.vkCmdDispatch(commandBuffer, workgroupCount, 1, 1);
+    if (timeoutDetector) {
+        timeoutDetector->endComputeDispatch(commandBuffer);
+    }
+    
+    // Gather must finish reading every stream before apply overwrites them
+    barriers.insertMemoryBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, applyPipeline);
+    
+    if (timeoutDetector) {
+        static const ProfileZoneId zone = Profiler::getInstance().registerZone("EntityReorder_Apply");
+        timeoutDetector->beginComputeDispatch(commandBuffer, zone, workgroupCount);
+    }
+    vk.vkCmdDispatch(commandBuffer, workgroupCount, 1, 1);
+    if (timeoutDetector) {
+        timeoutDetector->endComputeDispatch(commandBuffer);
+    }
+    
+    // Movement params, runtime state and color are not frame graph resources, so cover
+    // every later compute and vertex stage reader with a global barrier
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR,
+        VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR | VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT_KHR);
+    
+    // GPU slots no longer follow spawn order - debug lookups must go through the entity ID buffer
+    gpuEntityManager->markEntitiesReordered();
+}
+
+// Node lifecycle implementation
+bool EntityReorderNode::initializeNode(const FrameGraph& frameGraph) {
+    // One-time initialization - validate dependencies
+    if (!computeManager) {
+        LOG_ERROR("EntityReorderNode: ComputePipelineManager is null");
+        return false;
+    }
+    if (!gpuEntityManager) {
+        LOG_ERROR("EntityReorderNode: GPUEntityManager is null");
+        return false;
+    }
+    return true;
+}
+
+void EntityReorderNode::prepareFrame(uint32_t frameIndex, float time, float deltaTime) {
+    // Frame counter will be set in execute()
+    pushConstants.time = time;
+    pushConstants.deltaTime = deltaTime;
+}
+
+void EntityReorderNode::releaseFrame(uint32_t frameIndex) {
+    // Per-frame cleanup - nothing to clean up for reorder node
+}
@@ -0,0 +1,83 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/frame_graph.h"
+#include "../rendering/frame_graph_debug.h"
+#include "../core/vulkan_constants.h"
+#include "../pipelines/compute_pipeline_handle.h"
+#include <array>
+#include <memory>
+
+// Forward declarations
+class ComputePipelineManager;
+class GPUEntityManager;
+class GPUTimeoutDetector;
+
+// Periodically permutes per-entity SoA buffers into spatial grid cell order so
+// neighbouring entities share cache lines in physics and rendering.
+// Runs after SpatialGridNode::Scatter and before PhysicsComputeNode.
+class EntityReorderNode : public FrameGraphNode {
+    DECLARE_FRAME_GRAPH_NODE(EntityReorderNode)
+    
+public:
+    EntityReorderNode(
+        FrameGraphTypes::ResourceId entityBuffer,
+        FrameGraphTypes::ResourceId positionBuffer,
+        FrameGraphTypes::ResourceId currentPositionBuffer,
+        FrameGraphTypes::ResourceId spatialIndexBuffer,
+        ComputePipelineManager* computeManager,
+        GPUEntityManager* gpuEntityManager,
+        std::shared_ptr<GPUTimeoutDetector> timeoutDetector = nullptr
+    );
+    
+    // FrameGraphNode interface
+    std::vector<ResourceDependency> getInputs() const override;
+    std::vector<ResourceDependency> getOutputs() const override;
+    void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
+    
+    // Queue requirements
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::AsyncCompute; }
+    
+    // Off between reorder frames
+    bool isEnabled(const FrameContext& frameContext) const override;
+    
+    // Node lifecycle - standardized pattern
+    bool initializeNode(const FrameGraph& frameGraph) override;
+    void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
+    void releaseFrame(uint32_t frameIndex) override;
+    
+    // Reorder cadence in frames (0 disables reordering)
+    void setReorderInterval(uint32_t frames) { reorderInterval = frames; }
+    uint32_t getReorderInterval() const { return reorderInterval; }
+
+private:
+    FrameGraphTypes::ResourceId entityBufferId;
+    FrameGraphTypes::ResourceId positionBufferId;
+    FrameGraphTypes::ResourceId currentPositionBufferId;
+    FrameGraphTypes::ResourceId spatialIndexBufferId;
+    
+    // External dependencies (not owned) - validated during execution
+    ComputePipelineManager* computeManager;
+    GPUEntityManager* gpuEntityManager;
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector;
+    std::array<ComputePipelineHandle, 2> phasePipelines;  // Gather and apply phases
+    
+    uint32_t reorderInterval = ENTITY_REORDER_INTERVAL_FRAMES;
+    
+    // Debug counter - zero overhead in release builds
+    mutable FrameGraphDebug::DebugCounter debugCounter{};
+    
+    // Frame data for compute shader (layout shared with PhysicsPushConstants)
+    struct ReorderPushConstants {
+        float time;
+        float deltaTime;
+        uint32_t entityCount;
+        uint32_t frame;
+        uint32_t entityOffset;
+        uint32_t gridWidth;     // Unused by the reorder shader
+        uint32_t gridHeight;
+        float cellSize;
+        uint64_t entityTable;   // Bindless table view or stream address table of the working buffers
+    } pushConstants{};
+};
@@ -0,0 +1,231 @@
+#include "entity_spawn_node.h"
+#include "../pipelines/compute_pipeline_manager.h"
+#include "../../ecs/gpu/gpu_entity_manager.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../core/vulkan_constants.h"
+#include "../pipelines/descriptor_layout_manager.h"
+#include "../monitoring/gpu_timeout_detector.h"
+#include "../../ecs/utilities/logger.h"
+#include <stdexcept>
+#include <memory>
+
+namespace {
+    // Reorder scratch word layout, must match entity_spawn.comp
+    constexpr VkDeviceSize SPAWN_RECORD_BASE_WORD = 4;
+    constexpr VkDeviceSize SPAWN_RECORD_WORDS = sizeof(EntityEmitterRecord) / sizeof(uint32_t);
+    constexpr VkDeviceSize SPAWN_ID_BASE_WORD = SPAWN_RECORD_BASE_WORD + SPAWN_RECORD_WORDS * ENTITY_EMITTER_MAX_BATCH;
+    constexpr VkDeviceSize SPAWN_TOMBSTONE_COUNT_WORD = 0;
+    
+    constexpr uint32_t SPAWN_PHASE_COLLECT = 0;
+    constexpr uint32_t SPAWN_PHASE_SPAWN = 1;
+}
+
+EntitySpawnNode::EntitySpawnNode(
+    FrameGraphTypes::ResourceId entityBuffer,
+    FrameGraphTypes::ResourceId positionBuffer,
+    FrameGraphTypes::ResourceId currentPositionBuffer,
+    FrameGraphTypes::ResourceId targetPositionBuffer,
+    ComputePipelineManager* computeManager,
+    GPUEntityManager* gpuEntityManager,
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector
+) : entityBufferId(entityBuffer)
+  , positionBufferId(positionBuffer)
+  , currentPositionBufferId(currentPositionBuffer)
+  , targetPositionBufferId(targetPositionBuffer)
+  , computeManager(computeManager)
+  , gpuEntityManager(gpuEntityManager)
+  , timeoutDetector(timeoutDetector) {
+  
+    // Validate dependencies during construction for fail-fast behavior
+    if (!computeManager) {
+        throw std::invalid_argument("EntitySpawnNode: computeManager cannot be null");
+    }
+    if (!gpuEntityManager) {
+        throw std::invalid_argument("EntitySpawnNode: gpuEntityManager cannot be null");
+    }
+}
+
+std::vector<ResourceDependency> EntitySpawnNode::getInputs() const {
+    // Declared unconditionally so it keeps its place between the update node and the simulation passes
+    return {
+        {entityBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+        {positionBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+        {currentPositionBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+        {targetPositionBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+    };
+}
+
+std::vector<ResourceDependency> EntitySpawnNode::getOutputs() const {
+    return {
+        {entityBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+        {positionBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+        {currentPositionBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+        {targetPositionBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+    };
+}
+
+bool EntitySpawnNode::isEnabled(const FrameContext& frameContext) const {
+    return !gpuEntityManager || gpuEntityManager->hasPendingEmitters();
+}
+
+void EntitySpawnNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    // Validate dependencies are still valid
+    if (!computeManager || !gpuEntityManager) {
+        LOG_ERROR("EntitySpawnNode: Critical error - dependencies became null during execution");
+        return;
+    }
+    
+    if (!gpuEntityManager->hasPendingEmitters()) {
+        return;
+    }
+    
+    const VulkanContext* context = frameGraph.getContext();
+    if (!context) {
+        LOG_ERROR("EntitySpawnNode: Cannot get Vulkan context");
+        return;
+    }
+    
+    const auto& descriptorManager = gpuEntityManager->getDescriptorManager();
+    const uint64_t variant = gpuEntityManager->getComputeVariantKey();
+    bool resolved = true;
+    for (uint32_t phase = SPAWN_PHASE_COLLECT; phase <= SPAWN_PHASE_SPAWN; ++phase) {
+        resolved = phasePipelines[phase].resolveBlocking(*computeManager, variant, [&]() {
+            auto layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
+            VkDescriptorSetLayout descriptorLayout = computeManager->getLayoutManager()->getLayout(layoutSpec);
+            ComputePipelineState state = ComputePipelinePresets::createEntitySpawnState(
+                descriptorLayout, phase, gpuEntityManager->isCompactLayout());
+            if (descriptorManager.usesStreamAddresses()) {
+                ComputePipelinePresets::applyEntityStreamAddresses(state);
+            } else if (descriptorManager.isBindless()) {
+                ComputePipelinePresets::applyBindlessEntityTable(state, descriptorManager.getBindlessTableLayout());
+            }
+            return state;
+        }) && resolved;
+    }
+    
+    VkPipelineLayout pipelineLayout = phasePipelines[SPAWN_PHASE_SPAWN].getLayout();
+    if (!resolved) {
+        LOG_ERROR("EntitySpawnNode: Failed to get spawn pipelines or layout");
+        return;
+    }
+    
+    VkDescriptorSet computeDescriptorSet = descriptorManager.getEntityComputeSet();
+    if (computeDescriptorSet == VK_NULL_HANDLE && !descriptorManager.usesStreamAddresses()) {
+        LOG_ERROR("EntitySpawnNode: ERROR - Missing compute descriptor set!");
+        return;
+    }
+    
+    // Taken only once the pipeline is ready, so a failed frame leaves the emitters queued
+    const EntityEmitterBatch batch = gpuEntityManager->takeEmitterBatch();
+    if (batch.empty()) {
+        return;
+    }
+    
+    const uint32_t spawnCount = batch.getSpawnCount();
+    const uint32_t appendCount = static_cast<uint32_t>(batch.spawnIds.size());
+    pushConstants.baseSlot = batch.baseSlot;
+    pushConstants.spawnCount = spawnCount;
+    pushConstants.emitterCount = static_cast<uint32_t>(batch.records.size());
+    pushConstants.reuseCount = batch.reuseCount;
+    pushConstants.entityTable = descriptorManager.getWorkingTable();
+    
+    const uint32_t workgroups = (spawnCount + THREADS_PER_WORKGROUP - 1) / THREADS_PER_WORKGROUP;
+    const uint32_t collectWorkgroups = (batch.baseSlot + THREADS_PER_WORKGROUP - 1) / THREADS_PER_WORKGROUP;
+    
+    FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 60, "EntitySpawnNode: spawning " << spawnCount << " entities from "
+                                    << batch.records.size() << " emitters at slot " << batch.baseSlot
+                                    << " (" << batch.reuseCount << " into tombstones)");
+    
+    // Cache loader reference for performance
+    const auto& vk = context->getLoader();
+    const auto& barriers = frameGraph.getBarrierManager();
+    VkBuffer scratchBuffer = gpuEntityManager->getBufferManager().getReorderScratchBuffer();
+    
+    // Despawn and update passes may still be using the scratch buffer, and the despawn move reading the tail slots
+    barriers.insertMemoryBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+    
+    // Records (at most 3KB) and spawn IDs (at most 64KB) - the whole per-frame upload of a burst - plus the
+    // cleared tombstone counter when the batch refills any
+    vk.vkCmdUpdateBuffer(
+        commandBuffer, scratchBuffer, SPAWN_RECORD_BASE_WORD * sizeof(uint32_t),
+        batch.records.size() * sizeof(EntityEmitterRecord), batch.records.data());
+    if (appendCount > 0) {
+        vk.vkCmdUpdateBuffer(
+            commandBuffer, scratchBuffer, SPAWN_ID_BASE_WORD * sizeof(uint32_t),
+            appendCount * sizeof(uint32_t), batch.spawnIds.data());
+    }
+    if (batch.reuseCount > 0) {
+        vk.vkCmdFillBuffer(commandBuffer, scratchBuffer, SPAWN_TOMBSTONE_COUNT_WORD * sizeof(uint32_t), sizeof(uint32_t), 0);
+    }
+    
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    
+    // Both phases share the pipeline layout, so descriptors and push constants stay bound
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, phasePipelines[SPAWN_PHASE_SPAWN].getPipeline());
+    if (computeDescriptorSet != VK_NULL_HANDLE) {
+        vk.vkCmdBindDescriptorSets(
+            commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout,
+            0, 1, &computeDescriptorSet, 0, nullptr);
+    }
+    vk.vkCmdPushConstants(
+        commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(SpawnPushConstants), &pushConstants);
+    
+    auto dispatchPhase = [&](uint32_t phase, ProfileZoneId zone, uint32_t workgroupCount) {
+        vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, phasePipelines[phase].getPipeline());
+        if (timeoutDetector) {
+            timeoutDetector->beginComputeDispatch(commandBuffer, zone, workgroupCount);
+        }
+        vk.vkCmdDispatch(commandBuffer, workgroupCount, 1, 1);
+        if (timeoutDetector) {
+            timeoutDetector->endComputeDispatch(commandBuffer);
+        }
+    };
+    
+    static const ProfileZoneId collectZone = Profiler::getInstance().registerZone("EntitySpawn_Collect");
+    static const ProfileZoneId spawnZone = Profiler::getInstance().registerZone("EntitySpawn");
+    if (batch.reuseCount > 0) {
+        dispatchPhase(SPAWN_PHASE_COLLECT, collectZone, collectWorkgroups);
+        barriers.insertMemoryBarrier(
+            commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+            VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    }
+    dispatchPhase(SPAWN_PHASE_SPAWN, spawnZone, workgroups);
+    
+    // Colour and movement params are not frame graph resources, so cover the vertex stage readers too
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR,
+        VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    
+    // The new live count reaches the indirect commands in this command buffer, after the slots are written
+    gpuEntityManager->commitEmitterBatch(commandBuffer, batch);
+}
+
+// Node lifecycle implementation
+bool EntitySpawnNode::initializeNode(const FrameGraph& frameGraph) {
+    // One-time initialization - validate dependencies
+    if (!computeManager) {
+        LOG_ERROR("EntitySpawnNode: ComputePipelineManager is null");
+        return false;
+    }
+    if (!gpuEntityManager) {
+        LOG_ERROR("EntitySpawnNode: GPUEntityManager is null");
+        return false;
+    }
+    return true;
+}
+
+void EntitySpawnNode::prepareFrame(uint32_t frameIndex, float time, float deltaTime) {
+    // Emitter batch is taken in execute() so it is placed after this frame's despawn compaction
+}
+
+void EntitySpawnNode::releaseFrame(uint32_t frameIndex) {
+    // Per-frame cleanup - nothing to clean up for spawn node
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/frame_graph.h"
+#include "../rendering/frame_graph_debug.h"
+#include "../core/vulkan_constants.h"
+#include "../pipelines/compute_pipeline_handle.h"
+#include <array>
+#include <memory>
+
+// Forward declarations
+class ComputePipelineManager;
+class GPUEntityManager;
+class GPUTimeoutDetector;
+
+// Appends GPU-initialised entities from queued emitter records (GPUEntityManager::spawnEmitter): the records and
+// one spawn ID per entity are uploaded into the reorder scratch buffer and entity_spawn.comp writes every stream
+// of the new slots past the live count. Batches that refill tombstones of expired lifetime entities run a
+// collect pass over the live range first. Runs after EntityUpdateNode, so the simulation passes see the new count.
+class EntitySpawnNode : public FrameGraphNode {
+    DECLARE_FRAME_GRAPH_NODE(EntitySpawnNode)
+
+public:
+    EntitySpawnNode(
+        FrameGraphTypes::ResourceId entityBuffer,
+        FrameGraphTypes::ResourceId positionBuffer,
+        FrameGraphTypes::ResourceId currentPositionBuffer,
+        FrameGraphTypes::ResourceId targetPositionBuffer,
+        ComputePipelineManager* computeManager,
+        GPUEntityManager* gpuEntityManager,
+        std::shared_ptr<GPUTimeoutDetector> timeoutDetector = nullptr
+    );
+    
+    // FrameGraphNode interface
+    std::vector<ResourceDependency> getInputs() const override;
+    std::vector<ResourceDependency> getOutputs() const override;
+    void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
+    
+    // Queue requirements
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::AsyncCompute; }
+    
+    // Off unless emitters are queued
+    bool isEnabled(const FrameContext& frameContext) const override;
+    
+    // Node lifecycle - standardized pattern
+    bool initializeNode(const FrameGraph& frameGraph) override;
+    void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
+    void releaseFrame(uint32_t frameIndex) override;
+
+private:
+    FrameGraphTypes::ResourceId entityBufferId;
+    FrameGraphTypes::ResourceId positionBufferId;
+    FrameGraphTypes::ResourceId currentPositionBufferId;
+    FrameGraphTypes::ResourceId targetPositionBufferId;
+    
+    // External dependencies (not owned) - validated during execution
+    ComputePipelineManager* computeManager;
+    GPUEntityManager* gpuEntityManager;
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector;
+    std::array<ComputePipelineHandle, 2> phasePipelines;  // Collect and spawn phases
+    
+    // Debug counter - zero overhead in release builds
+    mutable FrameGraphDebug::DebugCounter debugCounter{};
+    
+    // Counts for entity_spawn.comp
+    struct SpawnPushConstants {
+        uint32_t baseSlot;      // Live count before the batch
+        uint32_t spawnCount;
+        uint32_t emitterCount;
+        uint32_t reuseCount;    // Leading entities refilling tombstones
+        uint64_t entityTable;   // Bindless table view or stream address table of the working buffers
+    } pushConstants{};
+};
@@ -0,0 +1,186 @@
+#include "entity_update_node.h"
+#include "../pipelines/compute_pipeline_manager.h"
+#include "../../ecs/gpu/gpu_entity_manager.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../core/vulkan_constants.h"
+#include "../pipelines/descriptor_layout_manager.h"
+#include "../monitoring/gpu_timeout_detector.h"
+#include "../../ecs/utilities/logger.h"
+#include <stdexcept>
+#include <memory>
+
+namespace {
+    // Reorder scratch word layout, must match entity_update.comp
+    constexpr VkDeviceSize UPDATE_RECORD_BASE_WORD = 4;
+}
+
+EntityUpdateNode::EntityUpdateNode(
+    FrameGraphTypes::ResourceId entityBuffer,
+    ComputePipelineManager* computeManager,
+    GPUEntityManager* gpuEntityManager,
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector
+) : entityBufferId(entityBuffer)
+  , computeManager(computeManager)
+  , gpuEntityManager(gpuEntityManager)
+  , timeoutDetector(timeoutDetector) {
+    
+    // Validate dependencies during construction for fail-fast behavior
+    if (!computeManager) {
+        throw std::invalid_argument("EntityUpdateNode: computeManager cannot be null");
+    }
+    if (!gpuEntityManager) {
+        throw std::invalid_argument("EntityUpdateNode: gpuEntityManager cannot be null");
+    }
+}
+
+std::vector<ResourceDependency> EntityUpdateNode::getInputs() const {
+    // Declared unconditionally so it keeps its place between despawn and the simulation passes
+    return {
+        {entityBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+    };
+}
+
+std::vector<ResourceDependency> EntityUpdateNode::getOutputs() const {
+    return {
+        {entityBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+    };
+}
+
+bool EntityUpdateNode::isEnabled(const FrameContext& frameContext) const {
+    return !gpuEntityManager || gpuEntityManager->hasPendingUpdates();
+}
+
+void EntityUpdateNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    // Validate dependencies are still valid
+    if (!computeManager || !gpuEntityManager) {
+        LOG_ERROR("EntityUpdateNode: Critical error - dependencies became null during execution");
+        return;
+    }
+    
+    if (!gpuEntityManager->hasPendingUpdates()) {
+        return;
+    }
+    
+    const VulkanContext* context = frameGraph.getContext();
+    if (!context) {
+        LOG_ERROR("EntityUpdateNode: Cannot get Vulkan context");
+        return;
+    }
+    
+    const auto& descriptorManager = gpuEntityManager->getDescriptorManager();
+    const uint64_t variant = gpuEntityManager->getComputeVariantKey();
+    const bool resolved = pipelineHandle.resolveBlocking(*computeManager, variant, [&]() {
+        auto layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
+        VkDescriptorSetLayout descriptorLayout = computeManager->getLayoutManager()->getLayout(layoutSpec);
+        ComputePipelineState state = ComputePipelinePresets::createEntityUpdateState(
+            descriptorLayout, gpuEntityManager->isCompactLayout());
+        if (descriptorManager.usesStreamAddresses()) {
+            ComputePipelinePresets::applyEntityStreamAddresses(state);
+        } else if (descriptorManager.isBindless()) {
+            ComputePipelinePresets::applyBindlessEntityTable(state, descriptorManager.getBindlessTableLayout());
+        }
+        return state;
+    });
+    
+    VkPipeline pipeline = pipelineHandle.getPipeline();
+    VkPipelineLayout pipelineLayout = pipelineHandle.getLayout();
+    if (!resolved) {
+        LOG_ERROR("EntityUpdateNode: Failed to get update pipeline or layout");
+        return;
+    }
+    
+    VkDescriptorSet computeDescriptorSet = descriptorManager.getEntityComputeSet();
+    if (computeDescriptorSet == VK_NULL_HANDLE && !descriptorManager.usesStreamAddresses()) {
+        LOG_ERROR("EntityUpdateNode: ERROR - Missing compute descriptor set!");
+        return;
+    }
+    
+    // Only resident entities are handed out, so every record has exactly one live slot to land in
+    const std::vector<EntityUpdateRecord> updateBatch = gpuEntityManager->takeUpdateBatch();
+    if (updateBatch.empty()) {
+        return;
+    }
+    
+    const uint32_t entityCount = gpuEntityManager->getEntityCount();
+    const uint32_t updateCount = static_cast<uint32_t>(updateBatch.size());
+    pushConstants.entityCount = entityCount;
+    pushConstants.updateCount = updateCount;
+    pushConstants.entityTable = descriptorManager.getWorkingTable();
+    
+    const uint32_t batchWorkgroups = (updateCount + THREADS_PER_WORKGROUP - 1) / THREADS_PER_WORKGROUP;
+    
+    FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 60, "EntityUpdateNode: applying " << updateCount << " updates across " << entityCount << " entities");
+    
+    // Cache loader reference for performance
+    const auto& vk = context->getLoader();
+    const auto& barriers = frameGraph.getBarrierManager();
+    VkBuffer scratchBuffer = gpuEntityManager->getBufferManager().getReorderScratchBuffer();
+    
+    // Despawn and reorder passes may still be using the scratch buffer, and earlier frames the streams
+    barriers.insertMemoryBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+    
+    // Upload the records (at most 48KB)
+    vk.vkCmdUpdateBuffer(
+        commandBuffer, scratchBuffer, UPDATE_RECORD_BASE_WORD * sizeof(uint32_t),
+        updateCount * sizeof(EntityUpdateRecord), updateBatch.data());
+    
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    if (computeDescriptorSet != VK_NULL_HANDLE) {
+        vk.vkCmdBindDescriptorSets(
+            commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout,
+            0, 1, &computeDescriptorSet, 0, nullptr);
+    }
+    vk.vkCmdPushConstants(
+        commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(UpdatePushConstants), &pushConstants);
+    
+    static const ProfileZoneId applyZone = Profiler::getInstance().registerZone("EntityUpdate_Apply");
+    if (timeoutDetector) {
+        timeoutDetector->beginComputeDispatch(commandBuffer, applyZone, batchWorkgroups);
+    }
+    vk.vkCmdDispatch(commandBuffer, batchWorkgroups, 1, 1);
+    if (timeoutDetector) {
+        timeoutDetector->endComputeDispatch(commandBuffer);
+    }
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    
+    // Color and movement params are not frame graph resources, so cover the vertex stage readers too
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR);
+    
+    // Graphics must not draw a lagging snapshot against streams rewritten in place
+    gpuEntityManager->commitUpdateBatch();
+}
+
+// Node lifecycle implementation
+bool EntityUpdateNode::initializeNode(const FrameGraph& frameGraph) {
+    // One-time initialization - validate dependencies
+    if (!computeManager) {
+        LOG_ERROR("EntityUpdateNode: ComputePipelineManager is null");
+        return false;
+    }
+    if (!gpuEntityManager) {
+        LOG_ERROR("EntityUpdateNode: GPUEntityManager is null");
+        return false;
+    }
+    return true;
+}
+
+void EntityUpdateNode::prepareFrame(uint32_t frameIndex, float time, float deltaTime) {
+    // Update batch is taken in execute() so it sees uploads committed earlier this frame
+}
+
+void EntityUpdateNode::releaseFrame(uint32_t frameIndex) {
+    // Per-frame cleanup - nothing to clean up for update node
+}
@@ -0,0 +1,64 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/frame_graph.h"
+#include "../rendering/frame_graph_debug.h"
+#include "../core/vulkan_constants.h"
+#include "../pipelines/compute_pipeline_handle.h"
+#include <memory>
+
+// Forward declarations
+class ComputePipelineManager;
+class GPUEntityManager;
+class GPUTimeoutDetector;
+
+// Applies sparse CPU-side edits of resident entities (GPUEntityManager::updateEntity): records are uploaded
+// into the reorder scratch buffer and scattered into the movement params and colour streams through the spawn
+// slot map, so an edit costs one thread regardless of the live count. Runs after EntityDespawnNode.
+class EntityUpdateNode : public FrameGraphNode {
+    DECLARE_FRAME_GRAPH_NODE(EntityUpdateNode)
+    
+public:
+    EntityUpdateNode(
+        FrameGraphTypes::ResourceId entityBuffer,
+        ComputePipelineManager* computeManager,
+        GPUEntityManager* gpuEntityManager,
+        std::shared_ptr<GPUTimeoutDetector> timeoutDetector = nullptr
+    );
+    
+    // FrameGraphNode interface
+    std::vector<ResourceDependency> getInputs() const override;
+    std::vector<ResourceDependency> getOutputs() const override;
+    void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
+    
+    // Queue requirements
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::AsyncCompute; }
+    
+    // Off unless updates are queued
+    bool isEnabled(const FrameContext& frameContext) const override;
+    
+    // Node lifecycle - standardized pattern
+    bool initializeNode(const FrameGraph& frameGraph) override;
+    void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
+    void releaseFrame(uint32_t frameIndex) override;
+
+private:
+    FrameGraphTypes::ResourceId entityBufferId;
+    
+    // External dependencies (not owned) - validated during execution
+    ComputePipelineManager* computeManager;
+    GPUEntityManager* gpuEntityManager;
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector;
+    ComputePipelineHandle pipelineHandle;
+    
+    // Debug counter - zero overhead in release builds
+    mutable FrameGraphDebug::DebugCounter debugCounter{};
+    
+    // Counts for entity_update.comp
+    struct UpdatePushConstants {
+        uint32_t entityCount;   // Live count
+        uint32_t updateCount;
+        uint64_t entityTable;   // Bindless table view or stream address table of the working buffers
+    } pushConstants{};
+};
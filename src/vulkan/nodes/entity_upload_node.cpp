@@ -0,0 +1,63 @@
+#include "entity_upload_node.h"
+#include "../../ecs/gpu/gpu_entity_manager.h"
+#include "../../ecs/utilities/logger.h"
+#include <stdexcept>
+
+EntityUploadNode::EntityUploadNode(
+    FrameGraphTypes::ResourceId entityBuffer,
+    FrameGraphTypes::ResourceId positionBuffer,
+    FrameGraphTypes::ResourceId currentPositionBuffer,
+    FrameGraphTypes::ResourceId targetPositionBuffer,
+    GPUEntityManager* gpuEntityManager
+) : entityBufferId(entityBuffer)
+  , positionBufferId(positionBuffer)
+  , currentPositionBufferId(currentPositionBuffer)
+  , targetPositionBufferId(targetPositionBuffer)
+  , gpuEntityManager(gpuEntityManager) {
+    
+    // Validate dependencies during construction for fail-fast behavior
+    if (!gpuEntityManager) {
+        throw std::invalid_argument("EntityUploadNode: gpuEntityManager cannot be null");
+    }
+}
+
+std::vector<ResourceDependency> EntityUploadNode::getInputs() const {
+    return {};
+}
+
+std::vector<ResourceDependency> EntityUploadNode::getOutputs() const {
+    // Declared unconditionally so every entity pass orders after this node, even on idle frames
+    return {
+        {entityBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+        {positionBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+        {currentPositionBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+        {targetPositionBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+    };
+}
+
+void EntityUploadNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    if (!gpuEntityManager) {
+        LOG_ERROR("EntityUploadNode: Critical error - gpuEntityManager became null during execution");
+        return;
+    }
+    
+    // Non-blocking: an upload still on the transfer queue is simply picked up a later frame
+    gpuEntityManager->commitCompletedUploads(commandBuffer);
+}
+
+// Node lifecycle implementation
+bool EntityUploadNode::initializeNode(const FrameGraph& frameGraph) {
+    if (!gpuEntityManager) {
+        LOG_ERROR("EntityUploadNode: GPUEntityManager is null");
+        return false;
+    }
+    return true;
+}
+
+void EntityUploadNode::prepareFrame(uint32_t frameIndex, float time, float deltaTime) {
+    // Upload completion is polled in execute() so the commit lands in this frame's command buffer
+}
+
+void EntityUploadNode::releaseFrame(uint32_t frameIndex) {
+    // Per-frame cleanup - nothing to clean up for upload node
+}
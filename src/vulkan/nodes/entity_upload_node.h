@@ -0,0 +1,46 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/frame_graph.h"
+
+// Forward declarations
+class GPUEntityManager;
+
+// Publishes entities uploaded asynchronously on the transfer queue. Once the upload fence has
+// signalled it records the new live count into the indirect command buffer, so every later
+// pass this frame sees the new entities. Added first so it orders before all other entity passes.
+class EntityUploadNode : public FrameGraphNode {
+    DECLARE_FRAME_GRAPH_NODE(EntityUploadNode)
+    
+public:
+    EntityUploadNode(
+        FrameGraphTypes::ResourceId entityBuffer,
+        FrameGraphTypes::ResourceId positionBuffer,
+        FrameGraphTypes::ResourceId currentPositionBuffer,
+        FrameGraphTypes::ResourceId targetPositionBuffer,
+        GPUEntityManager* gpuEntityManager
+    );
+    
+    // FrameGraphNode interface
+    std::vector<ResourceDependency> getInputs() const override;
+    std::vector<ResourceDependency> getOutputs() const override;
+    void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
+    
+    // Queue requirements
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::Transfer; }
+    
+    // Node lifecycle - standardized pattern
+    bool initializeNode(const FrameGraph& frameGraph) override;
+    void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
+    void releaseFrame(uint32_t frameIndex) override;
+
+private:
+    FrameGraphTypes::ResourceId entityBufferId;
+    FrameGraphTypes::ResourceId positionBufferId;
+    FrameGraphTypes::ResourceId currentPositionBufferId;
+    FrameGraphTypes::ResourceId targetPositionBufferId;
+    
+    // External dependencies (not owned) - validated during execution
+    GPUEntityManager* gpuEntityManager;
+};
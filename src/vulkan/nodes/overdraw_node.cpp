@@ -0,0 +1,277 @@
+#include "overdraw_node.h"
+#include "../pipelines/graphics_pipeline_manager.h"
+#include "../pipelines/descriptor_layout_manager.h"
+#include "../core/vulkan_swapchain.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../core/vulkan_constants.h"
+#include "../resources/core/resource_coordinator.h"
+#include "../monitoring/overdraw_monitor.h"
+#include "../../ecs/utilities/logger.h"
+#include <stdexcept>
+
+OverdrawNode::OverdrawNode(
+    FrameGraphTypes::ResourceId colorTarget,
+    ComputePipelineManager* computeManager,
+    GraphicsPipelineManager* graphicsManager,
+    VulkanSwapchain* swapchain,
+    ResourceCoordinator* resourceCoordinator
+) : colorTargetId(colorTarget)
+  , computeManager(computeManager)
+  , graphicsManager(graphicsManager)
+  , swapchain(swapchain)
+  , resourceCoordinator(resourceCoordinator) {
+  
+    // Validate dependencies during construction for fail-fast behavior
+    if (!computeManager) {
+        throw std::invalid_argument("OverdrawNode: computeManager cannot be null");
+    }
+    if (!graphicsManager) {
+        throw std::invalid_argument("OverdrawNode: graphicsManager cannot be null");
+    }
+    if (!swapchain) {
+        throw std::invalid_argument("OverdrawNode: swapchain cannot be null");
+    }
+    if (!resourceCoordinator) {
+        throw std::invalid_argument("OverdrawNode: resourceCoordinator cannot be null");
+    }
+}
+
+std::vector<ResourceDependency> OverdrawNode::getInputs() const {
+    // The count image is not a frame graph resource. What orders this node after the entity pass that fills it
+    // is the write-after-write edge on the swapchain image both declare (the main graphics node added first),
+    // and both having graphics affinity, so they share the graphics stream. The count image's barriers are
+    // recorded here and in EntityGraphicsNode, not derived by the frame graph
+    return {};
+}
+
+std::vector<ResourceDependency> OverdrawNode::getOutputs() const {
+    return {
+        {currentSwapchainImageId, ResourceAccess::Write, PipelineStage::ColorAttachment},
+    };
+}
+
+void OverdrawNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    // prepareFrame() already decided this frame has no counts to reduce
+    if (!frameResolved) {
+        return;
+    }
+    
+    const VulkanContext* context = frameGraph.getContext();
+    if (!context) {
+        LOG_ERROR("OverdrawNode: Missing Vulkan context");
+        return;
+    }
+    const auto& vk = context->getLoader();
+    
+    // The entity pass's atomic adds, visible to the reduction and the heat map
+    VkImageMemoryBarrier toRead{};
+    toRead.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toRead.srcAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+    toRead.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    toRead.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+    toRead.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+    toRead.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toRead.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toRead.image = resolvedCountImage;
+    toRead.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vk.vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT | VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &toRead);
+    
+    // One 16x16 tile per workgroup; the slot's results were zeroed by the host before this submit
+    const HistogramPushConstants histogramConstants{resolvedRenderExtent.width, resolvedRenderExtent.height};
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, resolvedHistogramPipeline);
+    vk.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, cachedHistogramLayout,
+        0, 1, &resolvedDescriptorSet, 0, nullptr);
+    vk.vkCmdPushConstants(commandBuffer, cachedHistogramLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(histogramConstants), &histogramConstants);
+    vk.vkCmdDispatch(commandBuffer, (resolvedRenderExtent.width + 15) / 16, (resolvedRenderExtent.height + 15) / 16, 1);
+    
+    VkMemoryBarrier toHost{};
+    toHost.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    toHost.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    toHost.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+    vk.vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+        0, 1, &toHost, 0, nullptr, 0, nullptr);
+    
+    if (resolvedHeatMapPipeline != VK_NULL_HANDLE) {
+        recordHeatMap(commandBuffer, vk);
+    }
+}
+
+void OverdrawNode::recordHeatMap(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk) const {
+    // The entity pass leaves the image presentable, written as an attachment or by the upscale blit
+    VkImageMemoryBarrier toAttachment{};
+    toAttachment.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    toAttachment.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    toAttachment.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    toAttachment.oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    toAttachment.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    toAttachment.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toAttachment.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    toAttachment.image = resolvedImage;
+    toAttachment.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    vk.vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &toAttachment);
+    
+    // Drawn over the finished image, not cleared
+    VkRenderingAttachmentInfoKHR colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    colorAttachment.imageView = resolvedView;
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    
+    VkRenderingInfoKHR renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.renderArea.offset = {0, 0};
+    renderingInfo.renderArea.extent = resolvedOutputExtent;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+    vk.vkCmdBeginRenderingKHR(commandBuffer, &renderingInfo);
+    
+    VkViewport viewport{};
+    viewport.width = static_cast<float>(resolvedOutputExtent.width);
+    viewport.height = static_cast<float>(resolvedOutputExtent.height);
+    viewport.maxDepth = 1.0f;
+    const VkRect2D scissor{{0, 0}, resolvedOutputExtent};
+    vk.vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    vk.vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+    
+    // Presented pixels map back onto the count image at the render scale
+    HeatMapPushConstants heatMapConstants{};
+    heatMapConstants.renderScale = glm::vec2(resolvedRenderExtent.width, resolvedRenderExtent.height) /
+                                   glm::vec2(resolvedOutputExtent.width, resolvedOutputExtent.height);
+    heatMapConstants.saturation = static_cast<float>(OVERDRAW_HEAT_MAP_SATURATION);
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, resolvedHeatMapPipeline);
+    vk.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, cachedHeatMapLayout,
+        0, 1, &resolvedDescriptorSet, 0, nullptr);
+    vk.vkCmdPushConstants(commandBuffer, cachedHeatMapLayout, VK_SHADER_STAGE_FRAGMENT_BIT,
+        0, sizeof(heatMapConstants), &heatMapConstants);
+    vk.vkCmdDraw(commandBuffer, 3, 1, 0, 0);
+    
+    vk.vkCmdEndRenderingKHR(commandBuffer);
+    
+    VkImageMemoryBarrier toPresent = toAttachment;
+    toPresent.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+    toPresent.dstAccessMask = 0;
+    toPresent.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    toPresent.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    vk.vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0, 0, nullptr, 0, nullptr, 1, &toPresent);
+}
+
+bool OverdrawNode::resolveFrame(uint32_t frameIndex) {
+    // Detect manager cache invalidation; the pipeline layout handles come from the layout caches
+    const auto* computeLayoutMgr = computeManager->getLayoutManager();
+    const uint64_t currentLayoutGen = computeLayoutMgr ? computeLayoutMgr->getGeneration() : 0;
+    const uint64_t currentComputeGen = computeManager->getGeneration();
+    const uint64_t currentGraphicsGen = graphicsManager->getGeneration();
+    if (currentLayoutGen != observedLayoutGeneration || currentComputeGen != observedComputePipelineGeneration ||
+        currentGraphicsGen != observedGraphicsPipelineGeneration) {
+        invalidateCachedState();
+        observedLayoutGeneration = currentLayoutGen;
+        observedComputePipelineGeneration = currentComputeGen;
+        observedGraphicsPipelineGeneration = currentGraphicsGen;
+    }
+    
+    const VkDescriptorSetLayout descriptorLayout = monitor->getDescriptorSetLayout();
+    const VkFormat colorFormat = swapchain->getImageFormat();
+    if (cachedLayout != descriptorLayout || cachedColorFormat != colorFormat) {
+        cachedHistogramState = ComputePipelinePresets::createOverdrawHistogramState(descriptorLayout);
+        cachedHeatMapState = GraphicsPipelinePresets::createOverdrawHeatMapState(VK_NULL_HANDLE, descriptorLayout);
+        GraphicsPipelinePresets::applyDynamicRendering(cachedHeatMapState, colorFormat);
+        cachedLayout = descriptorLayout;
+        cachedColorFormat = colorFormat;
+        cachedHistogramLayout = VK_NULL_HANDLE;
+        cachedHeatMapLayout = VK_NULL_HANDLE;
+    }
+    
+    // Non-blocking: figures start once the reduction has compiled, the heat map once it has too
+    resolvedHistogramPipeline = computeManager->getPipelineIfReady(cachedHistogramState);
+    if (resolvedHistogramPipeline == VK_NULL_HANDLE) {
+        return false;
+    }
+    if (cachedHistogramLayout == VK_NULL_HANDLE) {
+        cachedHistogramLayout = computeManager->getPipelineLayout(cachedHistogramState);
+    }
+    if (cachedHistogramLayout == VK_NULL_HANDLE) {
+        LOG_ERROR("OverdrawNode: Failed to get overdraw histogram pipeline");
+        return false;
+    }
+    
+    resolvedHeatMapPipeline = dynamicRenderingSupported ? graphicsManager->getPipelineIfReady(cachedHeatMapState) : VK_NULL_HANDLE;
+    if (resolvedHeatMapPipeline != VK_NULL_HANDLE && cachedHeatMapLayout == VK_NULL_HANDLE) {
+        cachedHeatMapLayout = graphicsManager->getPipelineLayout(cachedHeatMapState);
+    }
+    if (cachedHeatMapLayout == VK_NULL_HANDLE) {
+        resolvedHeatMapPipeline = VK_NULL_HANDLE;
+    }
+    
+    const std::vector<VkImage>& images = swapchain->getImages();
+    const std::vector<VkImageView> views = swapchain->getImageViews();
+    if (imageIndex >= images.size() || imageIndex >= views.size()) {
+        LOG_ERROR("OverdrawNode: Invalid imageIndex " << imageIndex);
+        return false;
+    }
+    resolvedImage = images[imageIndex];
+    resolvedView = views[imageIndex];
+    resolvedCountImage = swapchain->getOverdrawImage();
+    resolvedDescriptorSet = monitor->getDescriptorSet(frameIndex);
+    resolvedRenderExtent = swapchain->getRenderExtent();
+    resolvedOutputExtent = swapchain->getExtent();
+    return resolvedCountImage != VK_NULL_HANDLE && resolvedDescriptorSet != VK_NULL_HANDLE &&
+           resolvedRenderExtent.width > 0 && resolvedRenderExtent.height > 0;
+}
+
+// Node lifecycle implementation
+bool OverdrawNode::initializeNode(const FrameGraph& frameGraph) {
+    // One-time initialization - validate dependencies
+    if (!computeManager || !graphicsManager || !swapchain || !resourceCoordinator) {
+        LOG_ERROR("OverdrawNode: Missing dependencies");
+        return false;
+    }
+    
+    // Drawing over the entity pass's output needs a pass that loads it; render passes here all clear
+    dynamicRenderingSupported = resourceCoordinator->getContext()->supportsDynamicRendering();
+    if (!dynamicRenderingSupported) {
+        LOG_INFO("OverdrawNode: Dynamic rendering unavailable, overdraw heat map disabled");
+    }
+    return true;
+}
+
+void OverdrawNode::prepareFrame(uint32_t frameIndex, float time, float deltaTime) {
+    // Runs after the entity pass's prepareFrame, which marks the slot counted
+    frameResolved = monitor && monitor->isCounted(frameIndex) && resolveFrame(frameIndex);
+}
+
+uint64_t OverdrawNode::getRecordingKey() const {
+    // An unresolved frame records nothing but may be resolvable next frame
+    if (!frameResolved) {
+        return UNCACHEABLE_RECORDING;
+    }
+    
+    uint64_t key = combineRecordingKey(0, imageIndex);
+    key = combineRecordingKey(key, recordingHandleKey(resolvedHistogramPipeline));
+    key = combineRecordingKey(key, recordingHandleKey(resolvedHeatMapPipeline));
+    key = combineRecordingKey(key, recordingHandleKey(cachedHistogramLayout));
+    key = combineRecordingKey(key, recordingHandleKey(cachedHeatMapLayout));
+    key = combineRecordingKey(key, recordingHandleKey(resolvedDescriptorSet));
+    key = combineRecordingKey(key, recordingHandleKey(resolvedCountImage));
+    key = combineRecordingKey(key, recordingHandleKey(resolvedImage));
+    key = combineRecordingKey(key, recordingHandleKey(resolvedView));
+    key = combineRecordingKey(key, (static_cast<uint64_t>(resolvedRenderExtent.width) << 32) | resolvedRenderExtent.height);
+    key = combineRecordingKey(key, (static_cast<uint64_t>(resolvedOutputExtent.width) << 32) | resolvedOutputExtent.height);
+    key = combineRecordingKey(key, monitor->getBindingGeneration());
+    return key;
+}
+
+void OverdrawNode::releaseFrame(uint32_t frameIndex) {
+    // Per-frame cleanup - the slot's results are read by OverdrawMonitor::beginFrame()
+}
@@ -0,0 +1,127 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/frame_graph.h"
+#include "../pipelines/compute_pipeline_manager.h"
+#include "../pipelines/graphics_pipeline_state_hash.h"
+#include <glm/glm.hpp>
+#include <cstdint>
+#include <limits>
+
+// Forward declarations
+class VulkanFunctionLoader;
+class GraphicsPipelineManager;
+class VulkanSwapchain;
+class ResourceCoordinator;
+class OverdrawMonitor;
+
+// Overdraw diagnostic (F9), after the entity pass and output windows and before the debug overlay. On frames the
+// entity pass counted into the swapchain's overdraw image, overdraw_histogram.comp reduces the image into the
+// frame slot's OverdrawMonitor results (read back frames in flight later for the HUD and metrics), then
+// overdraw_heat_map.frag draws the counts over the swapchain image. The reduction runs without dynamic
+// rendering; the heat map needs it to load the image, as the debug overlay does. Disabled while no monitor is set
+class OverdrawNode : public FrameGraphNode {
+    DECLARE_FRAME_GRAPH_NODE(OverdrawNode)
+
+public:
+    OverdrawNode(
+        FrameGraphTypes::ResourceId colorTarget,
+        ComputePipelineManager* computeManager,
+        GraphicsPipelineManager* graphicsManager,
+        VulkanSwapchain* swapchain,
+        ResourceCoordinator* resourceCoordinator
+    );
+    
+    // FrameGraphNode interface - ordered after the main entity pass by the swapchain image both write, so it
+    // must be added after that node; layout transitions and the count image's barriers made by the node itself
+    std::vector<ResourceDependency> getInputs() const override;
+    std::vector<ResourceDependency> getOutputs() const override;
+    void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
+    
+    uint64_t getRecordingKey() const override;
+    bool isEnabled(const FrameContext& frameContext) const override { return monitor != nullptr; }
+    
+    // Queue requirements
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::Graphics; }
+    
+    // Node lifecycle - standardized pattern
+    bool initializeNode(const FrameGraph& frameGraph) override;
+    void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
+    void releaseFrame(uint32_t frameIndex) override;
+    
+    // Update swapchain image index for current frame
+    void setImageIndex(uint32_t imageIndex) { this->imageIndex = imageIndex; }
+    
+    // Set current frame's swapchain image resource ID (called each frame)
+    void setCurrentSwapchainImageId(FrameGraphTypes::ResourceId currentImageId) { this->currentSwapchainImageId = currentImageId; }
+    
+    // Monitor the entity pass counted for (not owned); nullptr while the diagnostic is off. Set each frame
+    void setOverdrawMonitor(OverdrawMonitor* monitor) { this->monitor = monitor; }
+    
+    // Invalidate cached state after swapchain recreation or layout cache clear
+    void invalidateCachedState() {
+        cachedLayout = VK_NULL_HANDLE;
+        cachedHistogramLayout = VK_NULL_HANDLE;
+        cachedHeatMapLayout = VK_NULL_HANDLE;
+        cachedColorFormat = VK_FORMAT_UNDEFINED;
+    }
+
+private:
+    // Must match the push constants in overdraw_histogram.comp
+    struct HistogramPushConstants {
+        uint32_t width;
+        uint32_t height;
+    };
+    
+    // Must match HeatMapPushConstants in overdraw_heat_map.frag
+    struct HeatMapPushConstants {
+        glm::vec2 renderScale;
+        float saturation;
+        float padding;
+    };
+    static_assert(sizeof(HeatMapPushConstants) == sizeof(glm::vec4), "OverdrawNode::HeatMapPushConstants must match overdraw_heat_map.frag");
+    
+    // Resolve the pipelines, images and set execute() records (called from prepareFrame)
+    bool resolveFrame(uint32_t frameIndex);
+    
+    void recordHeatMap(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk) const;
+    
+    // Resources
+    FrameGraphTypes::ResourceId colorTargetId; // Static placeholder - not used
+    FrameGraphTypes::ResourceId currentSwapchainImageId = 0; // Dynamic per-frame ID
+    
+    // External dependencies (not owned) - validated during execution
+    ComputePipelineManager* computeManager;
+    GraphicsPipelineManager* graphicsManager;
+    VulkanSwapchain* swapchain;
+    ResourceCoordinator* resourceCoordinator;
+    OverdrawMonitor* monitor = nullptr;
+    bool dynamicRenderingSupported = false;
+    
+    // Current frame state
+    uint32_t imageIndex = 0;
+    
+    // Resolved by prepareFrame() for execute() and getRecordingKey()
+    bool frameResolved = false;
+    VkPipeline resolvedHistogramPipeline = VK_NULL_HANDLE;
+    VkPipeline resolvedHeatMapPipeline = VK_NULL_HANDLE;  // Null until compiled or without dynamic rendering
+    VkDescriptorSet resolvedDescriptorSet = VK_NULL_HANDLE;
+    VkImage resolvedCountImage = VK_NULL_HANDLE;
+    VkImage resolvedImage = VK_NULL_HANDLE;
+    VkImageView resolvedView = VK_NULL_HANDLE;
+    VkExtent2D resolvedRenderExtent{};
+    VkExtent2D resolvedOutputExtent{};
+    
+    // Pipeline states for the monitor's layout and the cached colour format, rebuilt when either or a manager
+    // generation changes
+    ComputePipelineState cachedHistogramState;
+    GraphicsPipelineState cachedHeatMapState;
+    VkDescriptorSetLayout cachedLayout = VK_NULL_HANDLE;
+    VkFormat cachedColorFormat = VK_FORMAT_UNDEFINED;
+    VkPipelineLayout cachedHistogramLayout = VK_NULL_HANDLE;
+    VkPipelineLayout cachedHeatMapLayout = VK_NULL_HANDLE;
+    uint64_t observedLayoutGeneration = std::numeric_limits<uint64_t>::max();
+    uint64_t observedComputePipelineGeneration = std::numeric_limits<uint64_t>::max();
+    uint64_t observedGraphicsPipelineGeneration = std::numeric_limits<uint64_t>::max();
+};
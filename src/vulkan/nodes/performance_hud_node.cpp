@@ -0,0 +1,452 @@
+#include "performance_hud_node.h"
+#include "../pipelines/graphics_pipeline_manager.h"
+#include "../pipelines/descriptor_layout_manager.h"
+#include "../core/vulkan_swapchain.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../resources/core/resource_coordinator.h"
+#include "../resources/core/frame_ring_allocator.h"
+#include "../../ecs/utilities/logger.h"
+#include <algorithm>
+#include <cctype>
+#include <cstdio>
+#include <cstring>
+#include <stdexcept>
+
+namespace {
+    // Glyphs are the 5x7 font cells at twice their size, one column and line of spacing between them
+    constexpr uint32_t GLYPH_SCALE = 2;
+    constexpr uint32_t GLYPH_WIDTH = 5 * GLYPH_SCALE;
+    constexpr uint32_t GLYPH_HEIGHT = 7 * GLYPH_SCALE;
+    constexpr uint32_t GLYPH_ADVANCE = GLYPH_WIDTH + GLYPH_SCALE;
+    constexpr uint32_t LINE_HEIGHT = GLYPH_HEIGHT + 2 * GLYPH_SCALE;
+    
+    constexpr uint32_t PANEL_ORIGIN = 12;
+    constexpr uint32_t PANEL_PADDING = 8;
+    
+    // Frame time graph: one column per frame, full height at two 60 Hz frames
+    constexpr uint32_t GRAPH_COLUMN_WIDTH = 3;
+    constexpr uint32_t GRAPH_WIDTH = PERFORMANCE_HUD_FRAME_HISTORY * GRAPH_COLUMN_WIDTH;
+    constexpr uint32_t GRAPH_HEIGHT = 64;
+    constexpr float GRAPH_FULL_SCALE_MS = 33.3f;
+    constexpr float GRAPH_TARGET_MS = 16.7f;
+    
+    // Quads left for the panel and text once the graph columns and target line are reserved
+    constexpr uint32_t TEXT_QUAD_CAPACITY = PERFORMANCE_HUD_MAX_QUADS - PERFORMANCE_HUD_FRAME_HISTORY - 1;
+    constexpr size_t MAX_NODE_LINES = 16;
+    constexpr size_t MAX_SHADER_LINES = 4;
+    
+    constexpr uint32_t rgba(uint32_t r, uint32_t g, uint32_t b, uint32_t a = 0xFF) {
+        return r | (g << 8) | (b << 16) | (a << 24);
+    }
+    
+    constexpr uint32_t PANEL_COLOR = rgba(0x00, 0x00, 0x00, 0xB0);
+    constexpr uint32_t GRAPH_BACKGROUND_COLOR = rgba(0x30, 0x30, 0x30, 0xC0);
+    constexpr uint32_t TEXT_COLOR = rgba(0xF0, 0xF0, 0xF0);
+    constexpr uint32_t LABEL_COLOR = rgba(0x90, 0xC8, 0xFF);
+    constexpr uint32_t NODE_BAR_COLOR = rgba(0x40, 0x70, 0xB0, 0x90);
+    constexpr uint32_t SPILL_COLOR = rgba(0xE0, 0x50, 0x40);
+    constexpr uint32_t TARGET_LINE_COLOR = rgba(0xFF, 0xFF, 0xFF, 0x80);
+    
+    uint32_t frameTimeColor(float milliseconds) {
+        if (milliseconds <= GRAPH_TARGET_MS) {
+            return rgba(0x50, 0xD0, 0x50);
+        }
+        return milliseconds <= GRAPH_FULL_SCALE_MS ? rgba(0xE0, 0xC0, 0x40) : rgba(0xE0, 0x50, 0x40);
+    }
+    
+    glm::uvec4 makeQuad(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t glyph, uint32_t color) {
+        return glm::uvec4(x | (y << 16), width | (height << 16), glyph, color);
+    }
+    
+    // "EntityGraphicsNode" -> "ENTITYGRAPHICS"
+    std::string displayName(const std::string& nodeName) {
+        std::string name = nodeName;
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, "Node") == 0) {
+            name.resize(name.size() - 4);
+        }
+        return name;
+    }
+}
+
+PerformanceHudNode::PerformanceHudNode(
+    FrameGraphTypes::ResourceId colorTarget,
+    GraphicsPipelineManager* graphicsManager,
+    VulkanSwapchain* swapchain,
+    ResourceCoordinator* resourceCoordinator
+) : colorTargetId(colorTarget)
+  , graphicsManager(graphicsManager)
+  , swapchain(swapchain)
+  , resourceCoordinator(resourceCoordinator) {
+  
+    // Validate dependencies during construction for fail-fast behavior
+    if (!graphicsManager) {
+        throw std::invalid_argument("PerformanceHudNode: graphicsManager cannot be null");
+    }
+    if (!swapchain) {
+        throw std::invalid_argument("PerformanceHudNode: swapchain cannot be null");
+    }
+    if (!resourceCoordinator) {
+        throw std::invalid_argument("PerformanceHudNode: resourceCoordinator cannot be null");
+    }
+}
+
+std::vector<ResourceDependency> PerformanceHudNode::getInputs() const {
+    return {};
+}
+
+std::vector<ResourceDependency> PerformanceHudNode::getOutputs() const {
+    return {
+        {currentSwapchainImageId, ResourceAccess::Write, PipelineStage::ColorAttachment},
+    };
+}
+
+void PerformanceHudNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    // prepareFrame() already reported why this frame cannot draw
+    if (!frameResolved) {
+        return;
+    }
+    
+    const VulkanContext* context = frameGraph.getContext();
+    if (!context) {
+        LOG_ERROR("PerformanceHudNode: Missing Vulkan context");
+        return;
+    }
+    const auto& vk = context->getLoader();
+    
+    recordLayoutTransition(commandBuffer, vk, true);
+    
+    // The entity pass's image is drawn over, not cleared
+    VkRenderingAttachmentInfoKHR colorAttachment{};
+    colorAttachment.sType = VK_STRUCTURE_TYPE_RENDERING_ATTACHMENT_INFO_KHR;
+    colorAttachment.imageView = resolvedView;
+    colorAttachment.imageLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+    colorAttachment.loadOp = VK_ATTACHMENT_LOAD_OP_LOAD;
+    colorAttachment.storeOp = VK_ATTACHMENT_STORE_OP_STORE;
+    
+    VkRenderingInfoKHR renderingInfo{};
+    renderingInfo.sType = VK_STRUCTURE_TYPE_RENDERING_INFO_KHR;
+    renderingInfo.renderArea.offset = {0, 0};
+    renderingInfo.renderArea.extent = resolvedExtent;
+    renderingInfo.layerCount = 1;
+    renderingInfo.colorAttachmentCount = 1;
+    renderingInfo.pColorAttachments = &colorAttachment;
+    vk.vkCmdBeginRenderingKHR(commandBuffer, &renderingInfo);
+    
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_GRAPHICS, resolvedPipeline);
+    
+    VkViewport viewport{};
+    viewport.width = static_cast<float>(resolvedExtent.width);
+    viewport.height = static_cast<float>(resolvedExtent.height);
+    viewport.maxDepth = 1.0f;
+    vk.vkCmdSetViewport(commandBuffer, 0, 1, &viewport);
+    
+    VkRect2D scissor{};
+    scissor.extent = resolvedExtent;
+    vk.vkCmdSetScissor(commandBuffer, 0, 1, &scissor);
+    
+    const glm::vec2 pixelToClip(2.0f / static_cast<float>(resolvedExtent.width), 2.0f / static_cast<float>(resolvedExtent.height));
+    vk.vkCmdPushConstants(commandBuffer, cachedPipelineLayout, VK_SHADER_STAGE_VERTEX_BIT, 0, sizeof(pixelToClip), &pixelToClip);
+    
+    const VkDeviceSize quadOffset = resolvedQuadOffset;
+    vk.vkCmdBindVertexBuffers(commandBuffer, 0, 1, &resolvedQuadBuffer, &quadOffset);
+    vk.vkCmdDraw(commandBuffer, 6, PERFORMANCE_HUD_MAX_QUADS, 0, 0);
+    
+    vk.vkCmdEndRenderingKHR(commandBuffer);
+    recordLayoutTransition(commandBuffer, vk, false);
+}
+
+void PerformanceHudNode::recordLayoutTransition(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk, bool toAttachment) const {
+    // The entity pass leaves the image presentable, written as an attachment or by the upscale blit
+    VkImageMemoryBarrier barrier{};
+    barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+    barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    barrier.image = resolvedImage;
+    barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    
+    if (toAttachment) {
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+        barrier.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_READ_BIT | VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        barrier.newLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        vk.vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier);
+    } else {
+        barrier.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        barrier.dstAccessMask = 0;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        vk.vkCmdPipelineBarrier(commandBuffer,
+            VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+            0, 0, nullptr, 0, nullptr, 1, &barrier);
+    }
+}
+
+void PerformanceHudNode::addQuad(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t glyph, uint32_t color) {
+    if (textQuads.size() < TEXT_QUAD_CAPACITY) {
+        textQuads.push_back(makeQuad(x, y, width, height, glyph, color));
+    }
+}
+
+uint32_t PerformanceHudNode::addText(uint32_t x, uint32_t y, const char* text, uint32_t color) {
+    // The font covers ASCII 32..95, so letters are upper-cased and anything else shows as '?'
+    uint32_t cursor = x;
+    for (const char* c = text; *c; ++c) {
+        int character = std::toupper(static_cast<unsigned char>(*c));
+        if (character < 32 || character > 95) {
+            character = '?';
+        }
+        if (character != ' ') {
+            addQuad(cursor, y, GLYPH_WIDTH, GLYPH_HEIGHT, static_cast<uint32_t>(character - 32), color);
+        }
+        cursor += GLYPH_ADVANCE;
+    }
+    return cursor - x;
+}
+
+void PerformanceHudNode::layoutText() {
+    textQuads.clear();
+    laidOutVersion = stats->version;
+    
+    // Panel first so everything else blends over it; its size is known once the lines are laid out
+    addQuad(0, 0, 0, 0, SOLID_QUAD, PANEL_COLOR);
+    
+    const uint32_t left = PANEL_ORIGIN + PANEL_PADDING;
+    uint32_t y = PANEL_ORIGIN + PANEL_PADDING;
+    uint32_t width = GRAPH_WIDTH;
+    char line[96];
+    
+    const float fps = stats->averageFrameMs > 0.0f ? 1000.0f / stats->averageFrameMs : 0.0f;
+    std::snprintf(line, sizeof(line), "FRAME %.2f MS  %.0f FPS", stats->averageFrameMs, fps);
+    width = std::max(width, addText(left, y, line, TEXT_COLOR));
+    y += LINE_HEIGHT;
+    
+    graphX = left;
+    graphY = y;
+    addQuad(graphX, graphY, GRAPH_WIDTH, GRAPH_HEIGHT, SOLID_QUAD, GRAPH_BACKGROUND_COLOR);
+    y += GRAPH_HEIGHT + PANEL_PADDING;
+    
+    std::snprintf(line, sizeof(line), "ENTITIES %u", stats->entityCount);
+    width = std::max(width, addText(left, y, line, TEXT_COLOR));
+    y += LINE_HEIGHT;
+    
+    constexpr double MEGABYTE = 1024.0 * 1024.0;
+    if (stats->vramBudgetBytes > 0) {
+        std::snprintf(line, sizeof(line), "VRAM %.0f / %.0f MB",
+                      stats->vramUsedBytes / MEGABYTE, stats->vramBudgetBytes / MEGABYTE);
+    } else {
+        std::snprintf(line, sizeof(line), "VRAM %.0f MB", stats->vramUsedBytes / MEGABYTE);
+    }
+    width = std::max(width, addText(left, y, line, TEXT_COLOR));
+    y += LINE_HEIGHT;
+    
+    std::snprintf(line, sizeof(line), "COMPUTE PIPELINES %u  HIT %.0f%%",
+                  stats->computePipelines, stats->computeCacheHitRatio * 100.0f);
+    width = std::max(width, addText(left, y, line, TEXT_COLOR));
+    y += LINE_HEIGHT;
+    
+    std::snprintf(line, sizeof(line), "UPLOAD %.2f MB/S", stats->uploadMegabytesPerSecond);
+    width = std::max(width, addText(left, y, line, TEXT_COLOR));
+    y += LINE_HEIGHT;
+    
+    if (stats->simulationCountersValid) {
+        std::snprintf(line, sizeof(line), "COLLISIONS %.0f  TRUNCATED %.0f  TURNS %.0f /FRAME",
+                      stats->collisionsPerFrame, stats->truncatedEntitiesPerFrame, stats->directionChangesPerFrame);
+        width = std::max(width, addText(left, y, line, TEXT_COLOR));
+        y += LINE_HEIGHT;
+        
+        // Overflowing cells lose collisions, so the line turns to the warning colour
+        std::snprintf(line, sizeof(line), "CELLS %u / %u  SIZE %.2f  OVERFLOW %u  MAX %u",
+                      stats->occupiedCells, stats->gridCells, stats->cellSize, stats->overflowCells, stats->maxCellOccupancy);
+        width = std::max(width, addText(left, y, line, stats->overflowCells > 0 ? SPILL_COLOR : TEXT_COLOR));
+        y += LINE_HEIGHT;
+    }
+    
+    if (stats->overdrawValid) {
+        std::snprintf(line, sizeof(line), "OVERDRAW AVG %.2f  MAX %u  COVERED %.0f%%",
+                      stats->averageOverdraw, stats->maxOverdraw, stats->overdrawCoverage * 100.0f);
+        width = std::max(width, addText(left, y, line, TEXT_COLOR));
+        y += LINE_HEIGHT;
+    }
+    
+    if (!stats->nodeTimes.empty()) {
+        y += GLYPH_SCALE * 2;
+        width = std::max(width, addText(left, y, "GPU MS", LABEL_COLOR));
+        y += LINE_HEIGHT;
+    }
+    
+    // Each node's share of the frame as a bar behind its line
+    const size_t nodeLines = std::min(stats->nodeTimes.size(), MAX_NODE_LINES);
+    for (size_t i = 0; i < nodeLines; ++i) {
+        const PerformanceHudStats::NodeTime& node = stats->nodeTimes[i];
+        const float share = stats->averageFrameMs > 0.0f ? std::clamp(node.gpuMs / stats->averageFrameMs, 0.0f, 1.0f) : 0.0f;
+        const uint32_t barWidth = static_cast<uint32_t>(share * GRAPH_WIDTH);
+        if (barWidth > 0) {
+            addQuad(left, y - GLYPH_SCALE, barWidth, LINE_HEIGHT - GLYPH_SCALE, SOLID_QUAD, NODE_BAR_COLOR);
+        }
+        std::snprintf(line, sizeof(line), "%-18.18s %7.3f", displayName(node.name).c_str(), node.gpuMs);
+        width = std::max(width, addText(left, y, line, TEXT_COLOR));
+        y += LINE_HEIGHT;
+    }
+    
+    if (!stats->shaderStats.empty()) {
+        y += GLYPH_SCALE * 2;
+        width = std::max(width, addText(left, y, "SHADER               REG SPILL   LDS", LABEL_COLOR));
+        y += LINE_HEIGHT;
+    }
+    
+    // A shader that spills is the regression worth noticing, so its line stands out
+    const size_t shaderLines = std::min(stats->shaderStats.size(), MAX_SHADER_LINES);
+    for (size_t i = 0; i < shaderLines; ++i) {
+        const PerformanceHudStats::ShaderStat& shader = stats->shaderStats[i];
+        std::snprintf(line, sizeof(line), "%-18.18s %5u %5u %5u", shader.name.c_str(),
+                      shader.registers, shader.spills, shader.sharedMemoryBytes);
+        width = std::max(width, addText(left, y, line, shader.spilling ? SPILL_COLOR : TEXT_COLOR));
+        y += LINE_HEIGHT;
+    }
+    
+    textQuads[0] = makeQuad(PANEL_ORIGIN, PANEL_ORIGIN, width + 2 * PANEL_PADDING,
+                            y - LINE_HEIGHT + GLYPH_HEIGHT + PANEL_PADDING - PANEL_ORIGIN, SOLID_QUAD, PANEL_COLOR);
+}
+
+uint32_t PerformanceHudNode::writeFrameGraph(glm::uvec4* quads, uint32_t capacity) const {
+    uint32_t count = 0;
+    for (uint32_t column = 0; column < PERFORMANCE_HUD_FRAME_HISTORY && count < capacity; ++column) {
+        const float milliseconds = stats->frameTimesMs[(stats->frameTimeCursor + column) % PERFORMANCE_HUD_FRAME_HISTORY];
+        if (milliseconds <= 0.0f) {
+            continue;
+        }
+        const uint32_t height = std::max(1u, static_cast<uint32_t>(
+            std::min(milliseconds / GRAPH_FULL_SCALE_MS, 1.0f) * GRAPH_HEIGHT));
+        quads[count++] = makeQuad(graphX + column * GRAPH_COLUMN_WIDTH, graphY + GRAPH_HEIGHT - height,
+                                  GRAPH_COLUMN_WIDTH - 1, height, SOLID_QUAD, frameTimeColor(milliseconds));
+    }
+    
+    // 60 Hz budget line over the columns
+    if (count < capacity) {
+        const uint32_t targetHeight = static_cast<uint32_t>(GRAPH_TARGET_MS / GRAPH_FULL_SCALE_MS * GRAPH_HEIGHT);
+        quads[count++] = makeQuad(graphX, graphY + GRAPH_HEIGHT - targetHeight, GRAPH_WIDTH, 1, SOLID_QUAD, TARGET_LINE_COLOR);
+    }
+    return count;
+}
+
+bool PerformanceHudNode::resolveFrame() {
+    // Detect manager cache invalidation; the cached state holds nothing from the layout cache but its pipeline
+    // layout handle does
+    const auto* layoutMgr = graphicsManager->getLayoutManager();
+    const uint64_t currentLayoutGen = layoutMgr ? layoutMgr->getGeneration() : 0;
+    const uint64_t currentGraphicsGen = graphicsManager->getGeneration();
+    if (currentLayoutGen != observedLayoutGeneration || currentGraphicsGen != observedGraphicsPipelineGeneration) {
+        invalidateCachedState();
+        observedLayoutGeneration = currentLayoutGen;
+        observedGraphicsPipelineGeneration = currentGraphicsGen;
+    }
+    
+    const VkFormat colorFormat = swapchain->getImageFormat();
+    if (cachedColorFormat != colorFormat) {
+        cachedPipelineState = GraphicsPipelinePresets::createUIRenderingState(VK_NULL_HANDLE);
+        GraphicsPipelinePresets::applyDynamicRendering(cachedPipelineState, colorFormat);
+        cachedColorFormat = colorFormat;
+        cachedPipelineLayout = VK_NULL_HANDLE;
+    }
+    
+    // Non-blocking, looked up every frame so the cache never ages out the recorded pipeline; the HUD simply
+    // appears once it has compiled
+    resolvedPipeline = graphicsManager->getPipelineIfReady(cachedPipelineState);
+    if (resolvedPipeline == VK_NULL_HANDLE) {
+        return false;
+    }
+    if (cachedPipelineLayout == VK_NULL_HANDLE) {
+        cachedPipelineLayout = graphicsManager->getPipelineLayout(cachedPipelineState);
+    }
+    if (cachedPipelineLayout == VK_NULL_HANDLE) {
+        LOG_ERROR("PerformanceHudNode: Failed to get HUD pipeline");
+        return false;
+    }
+    
+    const std::vector<VkImage>& images = swapchain->getImages();
+    const std::vector<VkImageView> views = swapchain->getImageViews();
+    if (imageIndex >= images.size() || imageIndex >= views.size()) {
+        LOG_ERROR("PerformanceHudNode: Invalid imageIndex " << imageIndex);
+        return false;
+    }
+    resolvedImage = images[imageIndex];
+    resolvedView = views[imageIndex];
+    resolvedExtent = swapchain->getExtent();
+    return resolvedExtent.width > 0 && resolvedExtent.height > 0;
+}
+
+// Node lifecycle implementation
+bool PerformanceHudNode::initializeNode(const FrameGraph& frameGraph) {
+    // One-time initialization - validate dependencies
+    if (!graphicsManager || !swapchain || !resourceCoordinator) {
+        LOG_ERROR("PerformanceHudNode: Missing dependencies");
+        return false;
+    }
+    
+    // Drawing over the entity pass's output needs a pass that loads it; render passes here all clear
+    dynamicRenderingSupported = resourceCoordinator->getContext()->supportsDynamicRendering();
+    if (!dynamicRenderingSupported) {
+        LOG_INFO("PerformanceHudNode: Dynamic rendering unavailable, performance HUD disabled");
+    }
+    return true;
+}
+
+void PerformanceHudNode::prepareFrame(uint32_t frameIndex, float time, float deltaTime) {
+    frameResolved = false;
+    if (!stats) {
+        return;
+    }
+    
+    if (stats->version != laidOutVersion) {
+        layoutText();
+    }
+    if (!resolveFrame()) {
+        return;
+    }
+    
+    // The quads go into the ring every frame, replayed or not; only the graph columns change between refreshes
+    FrameRingAllocator* frameRing = resourceCoordinator->getFrameRingAllocator();
+    const FrameRingAllocator::Allocation allocation = frameRing
+        ? frameRing->allocate(PERFORMANCE_HUD_MAX_QUADS * sizeof(glm::uvec4))
+        : FrameRingAllocator::Allocation{};
+    if (!allocation.isValid()) {
+        LOG_ERROR("PerformanceHudNode: Failed to allocate HUD quads from the frame ring");
+        return;
+    }
+    
+    glm::uvec4* quads = static_cast<glm::uvec4*>(allocation.mapped);
+    const uint32_t textCount = static_cast<uint32_t>(textQuads.size());
+    std::memcpy(quads, textQuads.data(), textCount * sizeof(glm::uvec4));
+    const uint32_t count = textCount + writeFrameGraph(quads + textCount, PERFORMANCE_HUD_MAX_QUADS - textCount);
+    std::memset(quads + count, 0, (PERFORMANCE_HUD_MAX_QUADS - count) * sizeof(glm::uvec4));
+    
+    resolvedQuadBuffer = allocation.buffer;
+    resolvedQuadOffset = allocation.dynamicOffset;
+    frameResolved = true;
+}
+
+uint64_t PerformanceHudNode::getRecordingKey() const {
+    // An unresolved frame records nothing but may be resolvable next frame
+    if (!frameResolved) {
+        return UNCACHEABLE_RECORDING;
+    }
+    
+    // The quads are read from the ring at draw time, so only where they live is baked in
+    uint64_t key = combineRecordingKey(0, imageIndex);
+    key = combineRecordingKey(key, recordingHandleKey(resolvedPipeline));
+    key = combineRecordingKey(key, recordingHandleKey(cachedPipelineLayout));
+    key = combineRecordingKey(key, recordingHandleKey(resolvedImage));
+    key = combineRecordingKey(key, recordingHandleKey(resolvedView));
+    key = combineRecordingKey(key, (static_cast<uint64_t>(resolvedExtent.width) << 32) | resolvedExtent.height);
+    key = combineRecordingKey(key, recordingHandleKey(resolvedQuadBuffer));
+    key = combineRecordingKey(key, resolvedQuadOffset);
+    return key;
+}
+
+void PerformanceHudNode::releaseFrame(uint32_t frameIndex) {
+    // Per-frame cleanup - the ring region is recycled with the frame slot
+}
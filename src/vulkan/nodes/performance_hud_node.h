@@ -0,0 +1,170 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/frame_graph.h"
+#include "../pipelines/graphics_pipeline_state_hash.h"
+#include "../core/vulkan_constants.h"
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <limits>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class VulkanFunctionLoader;
+class GraphicsPipelineManager;
+class VulkanSwapchain;
+class ResourceCoordinator;
+
+// Figures the performance HUD shows, gathered by VulkanRenderer. The frame time history moves every frame; the
+// rest is refreshed every PERFORMANCE_HUD_REFRESH_FRAMES frames, each refresh bumping version
+struct PerformanceHudStats {
+    struct NodeTime {
+        std::string name;
+        float gpuMs = 0.0f;  // Rolling average (NodeGpuTiming::avgMs)
+    };
+    
+    // Driver figures of a cached pipeline (PipelineExecutableStats), only with VK_KHR_pipeline_executable_properties
+    struct ShaderStat {
+        std::string name;
+        uint32_t registers = 0;
+        uint32_t spills = 0;
+        uint32_t sharedMemoryBytes = 0;
+        bool spilling = false;  // Spills, or scratch memory where the driver only reports that
+    };
+    
+    std::array<float, PERFORMANCE_HUD_FRAME_HISTORY> frameTimesMs{};  // Ring, oldest at frameTimeCursor
+    uint32_t frameTimeCursor = 0;
+    
+    float averageFrameMs = 0.0f;
+    std::vector<NodeTime> nodeTimes;  // Slowest first
+    uint32_t entityCount = 0;
+    VkDeviceSize vramUsedBytes = 0;
+    VkDeviceSize vramBudgetBytes = 0;
+    uint32_t computePipelines = 0;
+    float computeCacheHitRatio = 0.0f;
+    float uploadMegabytesPerSecond = 0.0f;
+    
+    // SimulationCounters: events per frame over the refresh interval, cells of the last grid build
+    bool simulationCountersValid = false;
+    float collisionsPerFrame = 0.0f;
+    float truncatedEntitiesPerFrame = 0.0f;
+    float directionChangesPerFrame = 0.0f;
+    uint32_t occupiedCells = 0;
+    uint32_t gridCells = 0;
+    float cellSize = 0.0f;
+    uint32_t overflowCells = 0;
+    uint32_t maxCellOccupancy = 0;
+    
+    // OverdrawMonitor figures while the overdraw diagnostic (F9) is shown: fragments per covered pixel
+    bool overdrawValid = false;
+    float averageOverdraw = 0.0f;
+    uint32_t maxOverdraw = 0;
+    float overdrawCoverage = 0.0f;  // Covered share of the render extent
+    
+    std::vector<ShaderStat> shaderStats;  // Most registers first
+    uint64_t version = 0;
+};
+
+// Performance HUD overlay, drawn over the finished swapchain image after the entity pass and before presentation.
+// Everything is one instanced draw of quads - solid rectangles for the panel and graph bars, glyphs of the font
+// baked into hud_overlay.frag for text - written into the frame ring every frame. The draw always covers
+// PERFORMANCE_HUD_MAX_QUADS instances (unused ones zero-sized), so the recording replays while only the ring
+// contents change. Disabled while no stats are set or without VK_KHR_dynamic_rendering
+class PerformanceHudNode : public FrameGraphNode {
+    DECLARE_FRAME_GRAPH_NODE(PerformanceHudNode)
+
+public:
+    PerformanceHudNode(
+        FrameGraphTypes::ResourceId colorTarget,
+        GraphicsPipelineManager* graphicsManager,
+        VulkanSwapchain* swapchain,
+        ResourceCoordinator* resourceCoordinator
+    );
+    
+    // FrameGraphNode interface - the image is only written, so the graph orders the node after the entity pass
+    // without a barrier of its own (the node makes its layout transitions itself)
+    std::vector<ResourceDependency> getInputs() const override;
+    std::vector<ResourceDependency> getOutputs() const override;
+    void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
+    
+    uint64_t getRecordingKey() const override;
+    bool isEnabled(const FrameContext& frameContext) const override { return stats != nullptr && dynamicRenderingSupported; }
+    
+    // Queue requirements
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::Graphics; }
+    
+    // Node lifecycle - standardized pattern
+    bool initializeNode(const FrameGraph& frameGraph) override;
+    void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
+    void releaseFrame(uint32_t frameIndex) override;
+    
+    // Update swapchain image index for current frame
+    void setImageIndex(uint32_t imageIndex) { this->imageIndex = imageIndex; }
+    
+    // Set current frame's swapchain image resource ID (called each frame)
+    void setCurrentSwapchainImageId(FrameGraphTypes::ResourceId currentImageId) { this->currentSwapchainImageId = currentImageId; }
+    
+    // Figures to draw (not owned, read while the frame is prepared); nullptr hides the HUD
+    void setStats(const PerformanceHudStats* stats) { this->stats = stats; }
+    
+    // Invalidate cached state after swapchain recreation or layout cache clear
+    void invalidateCachedState() {
+        cachedColorFormat = VK_FORMAT_UNDEFINED;
+        cachedPipelineLayout = VK_NULL_HANDLE;
+    }
+
+private:
+    static constexpr uint32_t SOLID_QUAD = 0xFFFFFFFFu;  // Must match HUD_SOLID_QUAD in hud_overlay.frag
+    
+    // Rebuild the panel and text quads from the current stats (on a version change)
+    void layoutText();
+    void addQuad(uint32_t x, uint32_t y, uint32_t width, uint32_t height, uint32_t glyph, uint32_t color);
+    uint32_t addText(uint32_t x, uint32_t y, const char* text, uint32_t color);
+    
+    // Frame time graph columns, written behind the text quads into the frame's ring allocation
+    uint32_t writeFrameGraph(glm::uvec4* quads, uint32_t capacity) const;
+    
+    // Resolve the pipeline and target execute() records (called from prepareFrame)
+    bool resolveFrame();
+    
+    void recordLayoutTransition(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk, bool toAttachment) const;
+    
+    // Resources
+    FrameGraphTypes::ResourceId colorTargetId; // Static placeholder - not used
+    FrameGraphTypes::ResourceId currentSwapchainImageId = 0; // Dynamic per-frame ID
+    
+    // External dependencies (not owned) - validated during execution
+    GraphicsPipelineManager* graphicsManager;
+    VulkanSwapchain* swapchain;
+    ResourceCoordinator* resourceCoordinator;
+    const PerformanceHudStats* stats = nullptr;
+    bool dynamicRenderingSupported = false;
+    
+    // Current frame state
+    uint32_t imageIndex = 0;
+    
+    // Panel, labels and figures of the last laid out stats version; the panel background is the first quad
+    std::vector<glm::uvec4> textQuads;
+    uint64_t laidOutVersion = std::numeric_limits<uint64_t>::max();
+    uint32_t graphX = 0;
+    uint32_t graphY = 0;
+    
+    // Resolved by prepareFrame() for execute() and getRecordingKey()
+    bool frameResolved = false;
+    VkPipeline resolvedPipeline = VK_NULL_HANDLE;
+    VkImage resolvedImage = VK_NULL_HANDLE;
+    VkImageView resolvedView = VK_NULL_HANDLE;
+    VkExtent2D resolvedExtent{};
+    VkBuffer resolvedQuadBuffer = VK_NULL_HANDLE;
+    uint32_t resolvedQuadOffset = 0;
+    
+    // Pipeline state for the cached colour format, rebuilt when the format or a manager generation changes
+    GraphicsPipelineState cachedPipelineState;
+    VkFormat cachedColorFormat = VK_FORMAT_UNDEFINED;
+    VkPipelineLayout cachedPipelineLayout = VK_NULL_HANDLE;
+    uint64_t observedLayoutGeneration = std::numeric_limits<uint64_t>::max();
+    uint64_t observedGraphicsPipelineGeneration = std::numeric_limits<uint64_t>::max();
+};
@@ -6,7 +6,7 @@
 #include "../core/vulkan_constants.h"
 #include "../pipelines/descriptor_layout_manager.h"
 #include "../monitoring/gpu_timeout_detector.h"
-#include <iostream>
+#include "../../ecs/utilities/logger.h"
 #include <array>
 #include <glm/glm.hpp>
 #include <stdexcept>
@@ -19,14 +19,9 @@ namespace {
         bool useChunking;
     };
     
-    DispatchParams calculateDispatchParams(uint32_t entityCount, uint32_t maxWorkgroups, bool forceChunking) {
-        // Calculate workgroups needed for both spatial map clearing and entity processing
-        const uint32_t SPATIAL_MAP_SIZE = 4096;
-        const uint32_t spatialClearWorkgroups = (SPATIAL_MAP_SIZE + THREADS_PER_WORKGROUP - 1) / THREADS_PER_WORKGROUP;
-        const uint32_t entityWorkgroups = (entityCount + THREADS_PER_WORKGROUP - 1) / THREADS_PER_WORKGROUP;
-        
-        // Use maximum of both requirements
-        const uint32_t totalWorkgroups = std::max(spatialClearWorkgroups, entityWorkgroups);
+    DispatchParams calculateDispatchParams(uint32_t entityCount, uint32_t workgroupSize, uint32_t maxWorkgroups, bool forceChunking) {
+        // Spatial grid is cleared and built by SpatialGridNode passes, so only entities need workgroups
+        const uint32_t totalWorkgroups = (entityCount + workgroupSize - 1) / workgroupSize;
         
         return {
             totalWorkgroups,
@@ -41,6 +36,8 @@ PhysicsComputeNode::PhysicsComputeNode(
     FrameGraphTypes::ResourceId positionBuffer,
     FrameGraphTypes::ResourceId currentPositionBuffer,
     FrameGraphTypes::ResourceId targetPositionBuffer,
+    FrameGraphTypes::ResourceId spatialMapBuffer,
+    FrameGraphTypes::ResourceId spatialIndexBuffer,
     ComputePipelineManager* computeManager,
     GPUEntityManager* gpuEntityManager,
     std::shared_ptr<GPUTimeoutDetector> timeoutDetector
@@ -48,6 +45,8 @@ PhysicsComputeNode::PhysicsComputeNode(
   , positionBufferId(positionBuffer)
   , currentPositionBufferId(currentPositionBuffer)
   , targetPositionBufferId(targetPositionBuffer)
+  , spatialMapBufferId(spatialMapBuffer)
+  , spatialIndexBufferId(spatialIndexBuffer)
   , computeManager(computeManager)
   , gpuEntityManager(gpuEntityManager)
   , timeoutDetector(timeoutDetector) {
@@ -64,21 +63,41 @@ PhysicsComputeNode::PhysicsComputeNode(
 std::vector<ResourceDependency> PhysicsComputeNode::getInputs() const {
     return {
         {entityBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
-        {currentPositionBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+        {currentPositionBufferId, ResourceAccess::Read, PipelineStage::ComputeShader},
+        {spatialMapBufferId, ResourceAccess::Read, PipelineStage::ComputeShader},
+        {spatialIndexBufferId, ResourceAccess::Read, PipelineStage::ComputeShader},
     };
 }
 
 std::vector<ResourceDependency> PhysicsComputeNode::getOutputs() const {
     return {
         {positionBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
-        {currentPositionBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+        {targetPositionBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
     };
 }
 
+float PhysicsComputeNode::getBytesPerEntity() const {
+    // Own streams only: runtime state, velocity and position read and written, previous position and the entity's
+    // cell range. Neighbour reads depend on density and come on top
+    const bool compact = gpuEntityManager && gpuEntityManager->isCompactLayout();
+    float bytes = (compact ? 4.0f : 16.0f) + 16.0f * 2.0f + 16.0f * 2.0f + 16.0f + 8.0f;
+    if (isClosedFormMovement()) {
+        bytes -= 16.0f * 2.0f - 4.0f;  // Only the velocity state word is read; it is written on a change
+    } else if (fusedMovement) {
+        bytes += compact ? 8.0f : 16.0f;  // Movement params
+    }
+    return bytes;
+}
+
+bool PhysicsComputeNode::isEnabled(const FrameContext& frameContext) const {
+    if (frameContext.simulation.tickCount == 0) return false;
+    return !gpuEntityManager || gpuEntityManager->getEntityCount() > 0;
+}
+
 void PhysicsComputeNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
     // Validate dependencies are still valid
     if (!computeManager || !gpuEntityManager) {
-        std::cerr << "PhysicsComputeNode: Critical error - dependencies became null during execution" << std::endl;
+        LOG_ERROR("PhysicsComputeNode: Critical error - dependencies became null during execution");
         return;
     }
     
@@ -88,65 +107,136 @@ void PhysicsComputeNode::execute(VkCommandBuffer commandBuffer, const FrameGraph
         return;
     }
     
-    // Create compute pipeline state for physics
-    auto layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
-    VkDescriptorSetLayout descriptorLayout = computeManager->getLayoutManager()->getLayout(layoutSpec);
-    ComputePipelineState pipelineState = ComputePipelinePresets::createPhysicsState(descriptorLayout);
-    
-    // Set frame counter from FrameGraph for compute shader consistency
-    pushConstants.frame = frameGraph.getGlobalFrameCounter();
+    // Shader permutation selected on the ComputePipelineManager and the tuned workgroup size (per-entity kernel
+    // only - the tiled kernel's workgroups are grid cells). A newly selected variant compiles in the background
+    // while the previous one keeps running, so toggling a feature never pauses the simulation
+    const bool tiled = collisionKernel == CollisionKernel::TiledShared;
+    const ComputeShaderFeatures& requestedFeatures = computeManager->getShaderFeatures();
+    const auto* timing = frameGraph.getNodeGpuTiming(getId());
+    adaptCollisionStride(timing, requestedFeatures.collisionStride);
+    uint32_t requestedWorkgroupSize = THREADS_PER_WORKGROUP;
+    if (!tiled) {
+        // Windows timed with part of the narrow phase skipped would not compare with full ones
+        if (collisionStride == 1) {
+            tuneWorkgroupSize(timing, entityCount);
+        } else if (timing) {
+            lastTuneSample = timing->sampleCount;
+        }
+        requestedWorkgroupSize = computeManager->getWorkgroupTuner()->getWorkgroupSize(getTuningKernel());
+    } else if (timing) {
+        lastTuneSample = timing->sampleCount;  // Tiled samples never reach the tuner
+    }
     
-    // Create compute dispatch
-    ComputeDispatch dispatch{};
-    dispatch.pipeline = computeManager->getPipeline(pipelineState);
-    dispatch.layout = computeManager->getPipelineLayout(pipelineState);
+    // Kernel, fused movement and binding mode must match what is bound; workgroup size and features may lag
+    const uint64_t structuralKey = gpuEntityManager->getComputeVariantKey() | (tiled ? 8u : 0u) | (fusedMovement ? 16u : 0u) |
+                                   (isClosedFormMovement() ? 32u : 0u);
+    auto variantKey = [structuralKey](const ComputeShaderFeatures& features, uint32_t workgroupSize) {
+        return structuralKey | (uint64_t(workgroupSize & 0xFFFF) << 8) | (uint64_t(features.flags & 0xFF) << 24) |
+               (uint64_t(features.maxEntitiesPerCell) << 32);
+    };
+    auto buildState = [this, tiled](const ComputeShaderFeatures& features, uint32_t workgroupSize) {
+        return [this, tiled, features, workgroupSize]() {
+            auto layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
+            VkDescriptorSetLayout descriptorLayout = computeManager->getLayoutManager()->getLayout(layoutSpec);
+            const bool compactLayout = gpuEntityManager->isCompactLayout();
+            const bool closedForm = isClosedFormMovement();
+            ComputePipelineState state = tiled
+                ? ComputePipelinePresets::createPhysicsTiledState(descriptorLayout, fusedMovement, compactLayout, closedForm)
+                : ComputePipelinePresets::createPhysicsState(descriptorLayout, fusedMovement, compactLayout, closedForm);
+            const auto& descriptorManager = gpuEntityManager->getDescriptorManager();
+            if (descriptorManager.usesStreamAddresses()) {
+                ComputePipelinePresets::applyEntityStreamAddresses(state);
+            } else if (descriptorManager.isBindless()) {
+                ComputePipelinePresets::applyBindlessEntityTable(state, descriptorManager.getBindlessTableLayout());
+            }
+            if (computeManager->getDeviceInfo()->supportsSubgroupOperations()) {
+                ComputePipelinePresets::applySubgroupBallot(state);
+            }
+            ComputePipelinePresets::applyShaderFeatures(state, features);
+            ComputePipelinePresets::applyWorkgroupSize(state, workgroupSize);
+            return state;
+        };
+    };
     
-    if (dispatch.pipeline == VK_NULL_HANDLE || dispatch.layout == VK_NULL_HANDLE) {
-        std::cerr << "PhysicsComputeNode: Failed to get physics compute pipeline or layout" << std::endl;
+    // Skipped rather than compiled inline while the pipeline is still building (e.g. right after a kernel switch);
+    // before anything of this kernel is ready, the default size is tried meanwhile
+    const uint64_t structuralMask = 0xFF;
+    if (!physicsPipeline.resolve(*computeManager, variantKey(requestedFeatures, requestedWorkgroupSize),
+                                 buildState(requestedFeatures, requestedWorkgroupSize)) &&
+        (!physicsPipeline.isReady() || (physicsPipeline.getKey() & structuralMask) != structuralKey) &&
+        requestedWorkgroupSize != THREADS_PER_WORKGROUP) {
+        physicsPipeline.resolve(*computeManager, variantKey(requestedFeatures, THREADS_PER_WORKGROUP),
+                                buildState(requestedFeatures, THREADS_PER_WORKGROUP));
+    }
+    if (!physicsPipeline.isReady() || (physicsPipeline.getKey() & structuralMask) != structuralKey) {
+        FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 1800, "PhysicsComputeNode: Physics pipeline not ready, skipping dispatch");
         return;
     }
+    activeWorkgroupSize = tiled ? THREADS_PER_WORKGROUP : physicsPipeline.getState().workgroupSizeX;
+    
+    // The per-entity kernel built with sleeping runs over the active index list; the tiled one skips sleepers itself
+    const bool activeSet = !tiled && ((physicsPipeline.getKey() >> 24) & ComputeShaderFeatures::SLEEPING) != 0;
+    
+    // Every step integrates one simulation tick; the frame counter is set per step below
+    const SimulationStep& simulation = frameGraph.getSimulationStep();
+    pushConstants.deltaTime = simulation.tickSeconds;
+    
+    // Create compute dispatch
+    ComputeDispatch dispatch{};
+    dispatch.pipeline = physicsPipeline.getPipeline();
+    dispatch.layout = physicsPipeline.getLayout();
     
     // Set up descriptor sets
-    VkDescriptorSet computeDescriptorSet = gpuEntityManager->getDescriptorManager().getComputeDescriptorSet();
+    const auto& descriptorManager = gpuEntityManager->getDescriptorManager();
+    VkDescriptorSet computeDescriptorSet = descriptorManager.getEntityComputeSet();
     
     if (computeDescriptorSet != VK_NULL_HANDLE) {
         dispatch.descriptorSets.push_back(computeDescriptorSet);
-    } else {
-        std::cerr << "PhysicsComputeNode: ERROR - Missing compute descriptor set!" << std::endl;
+    } else if (!descriptorManager.usesStreamAddresses()) {
+        LOG_ERROR("PhysicsComputeNode: ERROR - Missing compute descriptor set!");
         return;
     }
     
     // Configure push constants and dispatch
+    const SpatialGridConfig& grid = gpuEntityManager->getSpatialGridConfig();
     pushConstants.entityCount = entityCount;
+    pushConstants.gridWidth = grid.width;
+    pushConstants.gridHeight = grid.height;
+    pushConstants.cellSize = grid.cellSize;
+    pushConstants.collisionStride = collisionStride;
+    pushConstants.cellOrder = static_cast<uint32_t>(grid.cellOrder);
+    pushConstants.idleSpeed = idleSpeed;
+    pushConstants.entityTable = descriptorManager.getWorkingTable();
     dispatch.pushConstantData = &pushConstants;
     dispatch.pushConstantSize = sizeof(PhysicsPushConstants);
     dispatch.pushConstantStages = VK_SHADER_STAGE_COMPUTE_BIT;
-    dispatch.calculateOptimalDispatch(entityCount, glm::uvec3(THREADS_PER_WORKGROUP, 1, 1));
+    dispatch.calculateOptimalDispatch(entityCount, glm::uvec3(activeWorkgroupSize, 1, 1));
     
     // Apply adaptive workload management
     uint32_t maxWorkgroupsPerDispatch = adaptiveMaxWorkgroups;
     bool shouldForceChunking = forceChunkedDispatch;
+    bool timeoutRequestsChunking = false;
     
     if (timeoutDetector) {
+        // The cap comes from measured GPU time, so it only splits dispatches too large for this GPU
         auto recommendation = timeoutDetector->getRecoveryRecommendation();
-        if (recommendation.shouldReduceWorkload) {
+        const uint32_t totalWorkgroups = (entityCount + activeWorkgroupSize - 1) / activeWorkgroupSize;
+        if (recommendation.shouldReduceWorkload && recommendation.recommendedMaxWorkgroups < totalWorkgroups) {
             maxWorkgroupsPerDispatch = std::min(maxWorkgroupsPerDispatch, recommendation.recommendedMaxWorkgroups);
+            timeoutRequestsChunking = true;
         }
-        if (recommendation.shouldSplitDispatches) {
+        if (recommendation.shouldSplitDispatches || !timeoutDetector->isGPUHealthy()) {
             shouldForceChunking = true;
-        }
-        if (!timeoutDetector->isGPUHealthy()) {
-            std::cerr << "PhysicsComputeNode: GPU not healthy, reducing workload" << std::endl;
-            maxWorkgroupsPerDispatch = std::min(maxWorkgroupsPerDispatch, 512u);
+            timeoutRequestsChunking = true;
         }
     }
     
     // Calculate dispatch parameters
-    auto dispatchParams = calculateDispatchParams(entityCount, maxWorkgroupsPerDispatch, shouldForceChunking);
+    auto dispatchParams = calculateDispatchParams(entityCount, activeWorkgroupSize, maxWorkgroupsPerDispatch, shouldForceChunking);
     
     // Validate dispatch limits
     if (dispatchParams.totalWorkgroups > 65535) {
-        std::cerr << "ERROR: Workgroup count " << dispatchParams.totalWorkgroups << " exceeds Vulkan limit!" << std::endl;
+        LOG_ERROR("ERROR: Workgroup count " << dispatchParams.totalWorkgroups << " exceeds Vulkan limit!");
         return;
     }
     
@@ -155,13 +245,17 @@ void PhysicsComputeNode::execute(VkCommandBuffer commandBuffer, const FrameGraph
     
     const VulkanContext* context = frameGraph.getContext();
     if (!context) {
-        std::cerr << "PhysicsComputeNode: Cannot get Vulkan context" << std::endl;
+        LOG_ERROR("PhysicsComputeNode: Cannot get Vulkan context");
         return;
     }
     
     // Cache loader reference for performance
     const auto& vk = context->getLoader();
     
+    if (activeSet && !recordActiveSetCompaction(commandBuffer, frameGraph, context, dispatch, simulation)) {
+        return;
+    }
+    
     // Bind pipeline and descriptor sets once
     vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, dispatch.pipeline);
     
@@ -169,37 +263,89 @@ void PhysicsComputeNode::execute(VkCommandBuffer commandBuffer, const FrameGraph
         commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, dispatch.layout,
         0, 1, &dispatch.descriptorSets[0], 0, nullptr);
     
-    if (!dispatchParams.useChunking) {
-        // Single dispatch execution
-        std::cout << "PhysicsComputeNode: Starting single dispatch execution..." << std::endl;
-        if (timeoutDetector) {
-            timeoutDetector->beginComputeDispatch("Physics", dispatchParams.totalWorkgroups);
+    // The grid and neighbour snapshot are built once per frame; each step only integrates against them, and
+    // reads the positions and velocities the step before wrote for its own entity
+    for (uint32_t step = 0; step < simulation.tickCount; ++step) {
+        if (step > 0) {
+            frameGraph.getBarrierManager().insertMemoryBarrier(
+                commandBuffer,
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+                VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
         }
+        pushConstants.frame = simulation.firstTick + step;
         
-        vk.vkCmdPushConstants(
-            commandBuffer, dispatch.layout, VK_SHADER_STAGE_COMPUTE_BIT,
-            0, sizeof(PhysicsPushConstants), &pushConstants);
-        
-        vk.vkCmdDispatch(commandBuffer, dispatchParams.totalWorkgroups, 1, 1);
-        
-        if (timeoutDetector) {
-            timeoutDetector->endComputeDispatch();
+        if (collisionKernel == CollisionKernel::TiledShared) {
+            executeTiledDispatch(commandBuffer, context, dispatch, grid.width, grid.height);
+        } else if (useIndirectDispatch && (activeSet || activeWorkgroupSize == THREADS_PER_WORKGROUP) && !timeoutRequestsChunking) {
+            // GPU-sized single dispatch; CPU-sized chunks only when the timeout detector asks for them.
+            // The live entity workgroup count assumes THREADS_PER_WORKGROUP, the active set's the pipeline's size
+            executeIndirectDispatch(commandBuffer, context, dispatch,
+                                    activeSet ? gpuEntityManager->getActiveDispatchOffset() : gpuEntityManager->getIndirectDispatchOffset());
+        } else if (!dispatchParams.useChunking) {
+            // Single dispatch execution
+            if (timeoutDetector) {
+                static const ProfileZoneId zone = Profiler::getInstance().registerZone("Physics");
+                timeoutDetector->beginComputeDispatch(commandBuffer, zone, dispatchParams.totalWorkgroups, true);
+            }
+            
+            vk.vkCmdPushConstants(
+                commandBuffer, dispatch.layout, VK_SHADER_STAGE_COMPUTE_BIT,
+                0, sizeof(PhysicsPushConstants), &pushConstants);
+            
+            vk.vkCmdDispatch(commandBuffer, dispatchParams.totalWorkgroups, 1, 1);
+            
+            if (timeoutDetector) {
+                timeoutDetector->endComputeDispatch(commandBuffer);
+            }
+        } else {
+            executeChunkedDispatch(commandBuffer, context, dispatch, 
+                                  dispatchParams.totalWorkgroups, dispatchParams.maxWorkgroupsPerChunk, entityCount);
         }
-        
-        // Memory barrier for compute→graphics synchronization
-        VkMemoryBarrier memoryBarrier{};
-        memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-        memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-        memoryBarrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
-        
-        vk.vkCmdPipelineBarrier(
-            commandBuffer,
-            VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-            VK_PIPELINE_STAGE_VERTEX_INPUT_BIT,
-            0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
-    } else {
-        executeChunkedDispatch(commandBuffer, context, dispatch, 
-                              dispatchParams.totalWorkgroups, dispatchParams.maxWorkgroupsPerChunk, entityCount);
+    }
+    
+    // Simulation counters of this frame's grid build, movement and physics ticks
+    const auto& barriers = frameGraph.getBarrierManager();
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+    if (gpuEntityManager->getBufferManager().recordSimulationCountersReadback(commandBuffer)) {
+        barriers.insertMemoryBarrier(
+            commandBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            VK_PIPELINE_STAGE_2_HOST_BIT_KHR, VK_ACCESS_2_HOST_READ_BIT_KHR);
+    }
+}
+
+void PhysicsComputeNode::tuneWorkgroupSize(const FrameGraphExecution::NodeGpuTiming* timing, uint32_t entityCount) {
+    // One report per full timing window, as EntityComputeNode does
+    if (!timing || timing->sampleCount < lastTuneSample + GPU_NODE_TIMING_WINDOW) {
+        return;
+    }
+    lastTuneSample = timing->sampleCount;
+    computeManager->getWorkgroupTuner()->reportWindow(getTuningKernel(), activeWorkgroupSize, timing->avgMs, entityCount);
+}
+
+void PhysicsComputeNode::adaptCollisionStride(const FrameGraphExecution::NodeGpuTiming* timing, uint32_t configuredStride) {
+    if (configuredStride != 0) {
+        collisionStride = std::min(configuredStride, PHYSICS_MAX_COLLISION_STRIDE);
+        return;
+    }
+    
+    // One decision per full timing window, like EntityComputeNode's chunk size; the stride stays a power of two
+    if (!timing || timing->sampleCount < lastStrideAdaptSample + GPU_NODE_TIMING_WINDOW) {
+        return;
+    }
+    lastStrideAdaptSample = timing->sampleCount;
+    
+    const uint32_t previous = collisionStride;
+    if (timing->p99Ms > PHYSICS_COLLISION_GPU_BUDGET_MS) {
+        collisionStride = std::min(PHYSICS_MAX_COLLISION_STRIDE, collisionStride * 2);
+    } else if (timing->p99Ms < PHYSICS_COLLISION_GPU_BUDGET_MS * 0.25f) {
+        collisionStride = std::max(1u, collisionStride / 2);
+    }
+    
+    if (collisionStride != previous) {
+        LOG_INFO("PhysicsComputeNode: GPU p99 " << timing->p99Ms << "ms, collision stride "
+                 << previous << " -> " << collisionStride);
     }
 }
 
@@ -219,14 +365,14 @@ void PhysicsComputeNode::executeChunkedDispatch(
     
     while (processedWorkgroups < totalWorkgroups) {
         uint32_t currentChunkSize = std::min(maxWorkgroupsPerChunk, totalWorkgroups - processedWorkgroups);
-        uint32_t baseEntityOffset = processedWorkgroups * THREADS_PER_WORKGROUP;
+        uint32_t baseEntityOffset = processedWorkgroups * activeWorkgroupSize;
         
         if (entityCount <= baseEntityOffset) break; // No more entities to process
         
         // Monitor chunk execution
         if (timeoutDetector) {
-            std::string chunkName = "Physics_Chunk" + std::to_string(chunkCount);
-            timeoutDetector->beginComputeDispatch(chunkName.c_str(), currentChunkSize);
+            static const ProfileZoneId chunkZone = Profiler::getInstance().registerZone("Physics_Chunk");  // Shared by every chunk
+            timeoutDetector->beginComputeDispatch(commandBuffer, chunkZone, currentChunkSize, true);
         }
         
         // Update push constants for this chunk
@@ -240,62 +386,179 @@ void PhysicsComputeNode::executeChunkedDispatch(
         vk.vkCmdDispatch(commandBuffer, currentChunkSize, 1, 1);
         
         if (timeoutDetector) {
-            timeoutDetector->endComputeDispatch();
-        }
-        
-        // Inter-chunk memory barrier
-        if (processedWorkgroups + currentChunkSize < totalWorkgroups) {
-            VkMemoryBarrier memoryBarrier{};
-            memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-            memoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-            memoryBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
-            
-            vk.vkCmdPipelineBarrier(
-                commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-                VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, 0, 1, &memoryBarrier, 0, nullptr, 0, nullptr);
+            timeoutDetector->endComputeDispatch(commandBuffer);
         }
         
+        // No barrier between chunks: neighbors come from the read-only start-of-frame snapshot and
+        // each thread writes only its own entity's slots
         processedWorkgroups += currentChunkSize;
         chunkCount++;
     }
     
-    // Final memory barrier for compute→graphics synchronization
-    VkMemoryBarrier finalMemoryBarrier{};
-    finalMemoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
-    finalMemoryBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
-    finalMemoryBarrier.dstAccessMask = VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT;
-    
-    vk.vkCmdPipelineBarrier(
-        commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
-        VK_PIPELINE_STAGE_VERTEX_INPUT_BIT, 0, 1, &finalMemoryBarrier, 0, nullptr, 0, nullptr);
-    
     // Debug statistics logging (thread-safe)
     if constexpr (FRAME_GRAPH_DEBUG_ENABLED) {
         uint32_t chunkLogCounter = FrameGraphDebug::incrementCounter(debugCounter);
         if (chunkLogCounter % 300 == 0) {
-            std::cout << "[FrameGraph Debug] PhysicsComputeNode: Split dispatch into " << chunkCount 
-                      << " chunks (" << maxWorkgroupsPerChunk << " max) for " << entityCount << " entities (occurrence #" << chunkLogCounter << ")" << std::endl;
+            LOG_INFO("[FrameGraph Debug] PhysicsComputeNode: Split dispatch into " << chunkCount 
+                     << " chunks (" << maxWorkgroupsPerChunk << " max) for " << entityCount << " entities (occurrence #" << chunkLogCounter << ")");
             
             if (timeoutDetector) {
                 auto stats = timeoutDetector->getStats();
-                std::cout << "  GPU Stats: avg=" << stats.averageDispatchTimeMs 
-                          << "ms, peak=" << stats.peakDispatchTimeMs << "ms"
-                          << ", warnings=" << stats.warningCount 
-                          << ", critical=" << stats.criticalCount << std::endl;
+                LOG_INFO("  GPU Stats: avg=" << stats.averageDispatchTimeMs 
+                         << "ms, peak=" << stats.peakDispatchTimeMs << "ms"
+                         << ", warnings=" << stats.warningCount 
+                         << ", critical=" << stats.criticalCount);
             }
         }
     }
 }
 
+void PhysicsComputeNode::executeTiledDispatch(
+    VkCommandBuffer commandBuffer,
+    const VulkanContext* context,
+    const ComputeDispatch& dispatch,
+    uint32_t gridWidth,
+    uint32_t gridHeight) {
+    
+    // Cache loader reference for performance
+    const auto& vk = context->getLoader();
+    
+    // Empty cells exit before touching shared memory, so a single 2D dispatch over the grid is cheap
+    if (timeoutDetector) {
+        static const ProfileZoneId zone = Profiler::getInstance().registerZone("Physics_Tiled");
+        timeoutDetector->beginComputeDispatch(commandBuffer, zone, gridWidth * gridHeight);
+    }
+    
+    PhysicsPushConstants tiledPushConstants = pushConstants;
+    tiledPushConstants.entityOffset = 0;
+    
+    vk.vkCmdPushConstants(
+        commandBuffer, dispatch.layout, VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(PhysicsPushConstants), &tiledPushConstants);
+    
+    vk.vkCmdDispatch(commandBuffer, gridWidth, gridHeight, 1);
+    
+    if (timeoutDetector) {
+        timeoutDetector->endComputeDispatch(commandBuffer);
+    }
+}
+
+void PhysicsComputeNode::executeIndirectDispatch(
+    VkCommandBuffer commandBuffer,
+    const VulkanContext* context,
+    const ComputeDispatch& dispatch,
+    VkDeviceSize argumentOffset) {
+    
+    // Cache loader reference for performance
+    const auto& vk = context->getLoader();
+    
+    PhysicsPushConstants indirectPushConstants = pushConstants;
+    indirectPushConstants.entityOffset = 0;
+    
+    vk.vkCmdPushConstants(
+        commandBuffer, dispatch.layout, VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(PhysicsPushConstants), &indirectPushConstants);
+    
+    if (timeoutDetector) {
+        static const ProfileZoneId zone = Profiler::getInstance().registerZone("Physics_Indirect");
+        timeoutDetector->beginComputeDispatch(commandBuffer, zone, dispatch.groupCountX, true);
+    }
+    
+    // Workgroup count and the shader's bounds check both come from the same GPU-resident count
+    vk.vkCmdDispatchIndirect(commandBuffer, gpuEntityManager->getIndirectCommandBuffer(), argumentOffset);
+    
+    if (timeoutDetector) {
+        timeoutDetector->endComputeDispatch(commandBuffer);
+    }
+}
+
+bool PhysicsComputeNode::recordActiveSetCompaction(
+    VkCommandBuffer commandBuffer,
+    const FrameGraph& frameGraph,
+    const VulkanContext* context,
+    const ComputeDispatch& dispatch,
+    const SimulationStep& simulation) {
+    
+    const auto& descriptorManager = gpuEntityManager->getDescriptorManager();
+    const uint64_t variant = gpuEntityManager->getComputeVariantKey() | (fusedMovement ? 8u : 0u);
+    const bool resolved = activeSetPipeline.resolveBlocking(*computeManager, variant, [&]() {
+        auto layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
+        VkDescriptorSetLayout descriptorLayout = computeManager->getLayoutManager()->getLayout(layoutSpec);
+        ComputePipelineState state = ComputePipelinePresets::createEntityActiveSetState(
+            descriptorLayout, fusedMovement, gpuEntityManager->isCompactLayout());
+        if (descriptorManager.usesStreamAddresses()) {
+            ComputePipelinePresets::applyEntityStreamAddresses(state);
+        } else if (descriptorManager.isBindless()) {
+            ComputePipelinePresets::applyBindlessEntityTable(state, descriptorManager.getBindlessTableLayout());
+        }
+        if (computeManager->getDeviceInfo()->supportsSubgroupOperations()) {
+            ComputePipelinePresets::applySubgroupBallot(state);
+        }
+        return state;
+    });
+    if (!resolved) {
+        LOG_ERROR("PhysicsComputeNode: Failed to get active set pipeline or layout");
+        return false;
+    }
+    
+    const auto& vk = context->getLoader();
+    const auto& barriers = frameGraph.getBarrierManager();
+    VkBuffer indirectBuffer = gpuEntityManager->getIndirectCommandBuffer();
+    
+    // Last frame's physics dispatch and this frame's reorder are done with the active arguments and the scratch buffer
+    barriers.insertMemoryBarrier(
+        commandBuffer,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+    const uint32_t reset[4] = {0u, 1u, 1u, 0u};  // Active dispatch (0, 1, 1), active entity count
+    vk.vkCmdUpdateBuffer(commandBuffer, indirectBuffer, gpuEntityManager->getActiveDispatchOffset(), sizeof(reset), reset);
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    
+    activeSetPushConstants.firstTick = simulation.firstTick;
+    activeSetPushConstants.tickCount = simulation.tickCount;
+    activeSetPushConstants.workgroupSize = activeWorkgroupSize;
+    activeSetPushConstants.entityTable = descriptorManager.getWorkingTable();
+    
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, activeSetPipeline.getPipeline());
+    if (!dispatch.descriptorSets.empty()) {
+        vk.vkCmdBindDescriptorSets(
+            commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, activeSetPipeline.getLayout(),
+            0, 1, &dispatch.descriptorSets[0], 0, nullptr);
+    }
+    vk.vkCmdPushConstants(
+        commandBuffer, activeSetPipeline.getLayout(), VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(ActiveSetPushConstants), &activeSetPushConstants);
+    
+    if (timeoutDetector) {
+        static const ProfileZoneId zone = Profiler::getInstance().registerZone("Physics_ActiveSet");
+        timeoutDetector->beginComputeDispatch(commandBuffer, zone, dispatch.groupCountX);
+    }
+    
+    // One thread per live entity, sized by the GPU-resident live count like the physics dispatch it replaces
+    vk.vkCmdDispatchIndirect(commandBuffer, indirectBuffer, gpuEntityManager->getIndirectDispatchOffset());
+    
+    if (timeoutDetector) {
+        timeoutDetector->endComputeDispatch(commandBuffer);
+    }
+    
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR | VK_ACCESS_2_SHADER_READ_BIT_KHR);
+    return true;
+}
+
 // Node lifecycle implementation
 bool PhysicsComputeNode::initializeNode(const FrameGraph& frameGraph) {
     // One-time initialization - validate dependencies
     if (!computeManager) {
-        std::cerr << "PhysicsComputeNode: ComputePipelineManager is null" << std::endl;
+        LOG_ERROR("PhysicsComputeNode: ComputePipelineManager is null");
         return false;
     }
     if (!gpuEntityManager) {
-        std::cerr << "PhysicsComputeNode: GPUEntityManager is null" << std::endl;
+        LOG_ERROR("PhysicsComputeNode: GPUEntityManager is null");
         return false;
     }
     return true;
@@ -306,9 +569,8 @@ void PhysicsComputeNode::prepareFrame(uint32_t frameIndex, float time, float del
     currentTime = time;
     currentDeltaTime = deltaTime;
     
-    // Update push constants with timing data - frame counter will be set in execute()
+    // Update push constants with timing data - tick counter and step length are set in execute()
     pushConstants.time = time;
-    pushConstants.deltaTime = deltaTime;
 }
 
 void PhysicsComputeNode::releaseFrame(uint32_t frameIndex) {
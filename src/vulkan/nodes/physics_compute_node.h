@@ -5,6 +5,7 @@
 #include "../rendering/frame_graph.h"
 #include "../rendering/frame_graph_debug.h"
 #include "../core/vulkan_constants.h"
+#include "../pipelines/compute_pipeline_handle.h"
 #include <memory>
 
 // Forward declarations
@@ -16,11 +17,19 @@ class PhysicsComputeNode : public FrameGraphNode {
     DECLARE_FRAME_GRAPH_NODE(PhysicsComputeNode)
     
 public:
+    // Collision kernel variant
+    enum class CollisionKernel {
+        PerEntity,    // physics.comp: one thread per entity, neighbours read from global memory
+        TiledShared   // physics_tiled.comp: one workgroup per cell, cell + halo staged in shared memory
+    };
+    
     PhysicsComputeNode(
         FrameGraphTypes::ResourceId entityBuffer, 
         FrameGraphTypes::ResourceId positionBuffer,
         FrameGraphTypes::ResourceId currentPositionBuffer,
         FrameGraphTypes::ResourceId targetPositionBuffer,
+        FrameGraphTypes::ResourceId spatialMapBuffer,
+        FrameGraphTypes::ResourceId spatialIndexBuffer,
         ComputePipelineManager* computeManager,
         GPUEntityManager* gpuEntityManager,
         std::shared_ptr<GPUTimeoutDetector> timeoutDetector = nullptr
@@ -32,15 +41,55 @@ public:
     void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
     
     // Queue requirements
-    bool needsComputeQueue() const override { return true; }
-    bool needsGraphicsQueue() const override { return false; }
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::AsyncCompute; }
+    
+    // Off while the world is empty
+    bool isEnabled(const FrameContext& frameContext) const override;
+    
+    // Counted so skip-idle changes show up as fewer invocations rather than just a lower time
+    bool wantsPipelineStatistics() const override { return true; }
+    float getBytesPerEntity() const override;
     
     // Node lifecycle - standardized pattern
     bool initializeNode(const FrameGraph& frameGraph) override;
     void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
     void releaseFrame(uint32_t frameIndex) override;
+    
+    // Indirect dispatch reads workgroup counts from GPUEntityManager's indirect command buffer
+    void setIndirectDispatch(bool enabled) { useIndirectDispatch = enabled; }
+    
+    // Kernel selection - tiled variant pays off for dense swarms with many entities per cell
+    void setCollisionKernel(CollisionKernel kernel) { collisionKernel = kernel; }
+    CollisionKernel getCollisionKernel() const { return collisionKernel; }
+    
+    // Fused mode runs the movement velocity update inline, replacing EntityComputeNode
+    void setFusedMovement(bool fused) { fusedMovement = fused; }
+    bool isFusedMovement() const { return fusedMovement; }
+    
+    // Closed form (fused only) evaluates the random walk velocity from entity index and tick instead of storing it
+    void setClosedFormMovement(bool closedForm) { closedFormMovement = closedForm; }
+    bool isClosedFormMovement() const { return fusedMovement && closedFormMovement; }
+    
+    // Collision stride last dispatched (ComputeShaderFeatures::collisionStride, or the adaptive choice)
+    uint32_t getCollisionStride() const { return collisionStride; }
+    
+    // Speed below which an entity stops integrating and may sleep; higher drops slow drifters from the dispatch sooner
+    void setIdleSpeed(float speed) { idleSpeed = speed; }
+    float getIdleSpeed() const { return idleSpeed; }
 
 private:
+    // Hands each full timing window of the per-entity kernel to the ComputeWorkgroupTuner
+    void tuneWorkgroupSize(const FrameGraphExecution::NodeGpuTiming* timing, uint32_t entityCount);
+    
+    // Takes a fixed stride as configured; for 0, doubles or halves the stride once per timing window against
+    // PHYSICS_COLLISION_GPU_BUDGET_MS
+    void adaptCollisionStride(const FrameGraphExecution::NodeGpuTiming* timing, uint32_t configuredStride);
+    
+    // The fused kernels do more work per thread, so they are tuned separately
+    const char* getTuningKernel() const {
+        return isClosedFormMovement() ? "physics_closed_form" : (fusedMovement ? "physics_fused" : "physics");
+    }
+    
     // Helper method for chunked dispatch execution
     void executeChunkedDispatch(
         VkCommandBuffer commandBuffer, 
@@ -50,10 +99,36 @@ private:
         uint32_t maxWorkgroupsPerChunk,
         uint32_t entityCount);
     
+    // Helper method for a single dispatch sized on the GPU: the live entity count, or the active set under sleeping
+    void executeIndirectDispatch(
+        VkCommandBuffer commandBuffer,
+        const VulkanContext* context,
+        const class ComputeDispatch& dispatch,
+        VkDeviceSize argumentOffset);
+    
+    // Compacts the entities the per-entity kernel visits this frame into the active index list (reorder scratch
+    // buffer) and its indirect dispatch; once per frame, ahead of every tick
+    bool recordActiveSetCompaction(
+        VkCommandBuffer commandBuffer,
+        const FrameGraph& frameGraph,
+        const VulkanContext* context,
+        const class ComputeDispatch& dispatch,
+        const SimulationStep& simulation);
+    
+    // Helper method for the tiled kernel (one workgroup per grid cell)
+    void executeTiledDispatch(
+        VkCommandBuffer commandBuffer,
+        const VulkanContext* context,
+        const class ComputeDispatch& dispatch,
+        uint32_t gridWidth,
+        uint32_t gridHeight);
+    
     FrameGraphTypes::ResourceId entityBufferId;
     FrameGraphTypes::ResourceId positionBufferId;
     FrameGraphTypes::ResourceId currentPositionBufferId;
     FrameGraphTypes::ResourceId targetPositionBufferId;
+    FrameGraphTypes::ResourceId spatialMapBufferId;
+    FrameGraphTypes::ResourceId spatialIndexBufferId;
     
     // External dependencies (not owned) - validated during execution
     ComputePipelineManager* computeManager;
@@ -63,6 +138,17 @@ private:
     // Adaptive dispatch parameters
     uint32_t adaptiveMaxWorkgroups = MAX_WORKGROUPS_PER_CHUNK;
     bool forceChunkedDispatch = true;     // Always use chunking for stability
+    bool useIndirectDispatch = true;      // Size from GPU live entity count unless the timeout detector intervenes
+    CollisionKernel collisionKernel = CollisionKernel::PerEntity;
+    bool fusedMovement = false;
+    bool closedFormMovement = false;
+    uint32_t activeWorkgroupSize = THREADS_PER_WORKGROUP;  // local_size_x of the pipeline last dispatched
+    ComputePipelineHandle physicsPipeline;  // Last ready variant; its features may lag the requested ones
+    ComputePipelineHandle activeSetPipeline;
+    uint64_t lastTuneSample = 0;          // Timing sample count at the last window reported to the tuner
+    uint32_t collisionStride = PHYSICS_COLLISION_STRIDE;
+    uint64_t lastStrideAdaptSample = 0;   // Timing sample count at the last adaptive stride decision
+    float idleSpeed = PHYSICS_IDLE_SPEED;
     
     // Debug counter - zero overhead in release builds
     mutable FrameGraphDebug::DebugCounter debugCounter{};
@@ -78,6 +164,22 @@ private:
         uint32_t entityCount;
         uint32_t frame;
         uint32_t entityOffset;  // For chunked dispatches
-        uint32_t padding[3];    // Ensure 16-byte alignment
+        uint32_t gridWidth;     // Active spatial grid dimensions (powers of 2)
+        uint32_t gridHeight;
+        float cellSize;
+        uint32_t collisionStride;  // Entities (cells) per narrow-phase slot, interleaved by frame
+        uint32_t cellOrder;     // SpatialCellOrder the grid was built with
+        float idleSpeed;
+        uint32_t padding0;
+        uint64_t entityTable;   // Bindless table view or stream address table of the working buffers
     } pushConstants{};
+    
+    // Must match entity_active.comp
+    struct ActiveSetPushConstants {
+        uint32_t firstTick;
+        uint32_t tickCount;
+        uint32_t workgroupSize;  // The physics pipeline's, which the active dispatch is sized for
+        uint32_t padding0;
+        uint64_t entityTable;
+    } activeSetPushConstants{};
 };
\ No newline at end of file
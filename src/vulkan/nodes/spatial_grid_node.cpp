@@ -0,0 +1,260 @@
+#include "spatial_grid_node.h"
+#include "../pipelines/compute_pipeline_manager.h"
+#include "../../ecs/gpu/gpu_entity_manager.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../core/vulkan_constants.h"
+#include "../pipelines/descriptor_layout_manager.h"
+#include "../monitoring/gpu_timeout_detector.h"
+#include "../../ecs/utilities/logger.h"
+#include <stdexcept>
+#include <memory>
+
+namespace {
+    const char* getPassName(SpatialGridNode::Pass pass) {
+        switch (pass) {
+            case SpatialGridNode::Pass::Clear: return "Clear";
+            case SpatialGridNode::Pass::Count: return "Count";
+            case SpatialGridNode::Pass::PrefixSum: return "PrefixSum";
+            case SpatialGridNode::Pass::Scatter: return "Scatter";
+        }
+        return "Unknown";
+    }
+}
+
+SpatialGridNode::SpatialGridNode(
+    Pass pass,
+    FrameGraphTypes::ResourceId spatialMapBuffer,
+    FrameGraphTypes::ResourceId spatialEntryBuffer,
+    FrameGraphTypes::ResourceId spatialIndexBuffer,
+    FrameGraphTypes::ResourceId positionBuffer,
+    FrameGraphTypes::ResourceId currentPositionBuffer,
+    ComputePipelineManager* computeManager,
+    GPUEntityManager* gpuEntityManager,
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector
+) : pass(pass)
+  , spatialMapBufferId(spatialMapBuffer)
+  , spatialEntryBufferId(spatialEntryBuffer)
+  , spatialIndexBufferId(spatialIndexBuffer)
+  , positionBufferId(positionBuffer)
+  , currentPositionBufferId(currentPositionBuffer)
+  , computeManager(computeManager)
+  , gpuEntityManager(gpuEntityManager)
+  , timeoutDetector(timeoutDetector) {
+    
+    // Validate dependencies during construction for fail-fast behavior
+    if (!computeManager) {
+        throw std::invalid_argument("SpatialGridNode: computeManager cannot be null");
+    }
+    if (!gpuEntityManager) {
+        throw std::invalid_argument("SpatialGridNode: gpuEntityManager cannot be null");
+    }
+    dispatchZone = Profiler::getInstance().registerZone(getName());
+}
+
+std::string SpatialGridNode::getName() const {
+    return std::string("SpatialGridNode_") + getPassName(pass);
+}
+
+std::vector<ResourceDependency> SpatialGridNode::getInputs() const {
+    switch (pass) {
+        case Pass::Clear:
+            return {};
+        case Pass::Count:
+            // Position is read before physics writes it, so this sees last frame's resolved positions
+            return {
+                {spatialMapBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+                {positionBufferId, ResourceAccess::Read, PipelineStage::ComputeShader},
+            };
+        case Pass::PrefixSum:
+            return {
+                {spatialMapBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+            };
+        case Pass::Scatter:
+            return {
+                {spatialMapBufferId, ResourceAccess::Read, PipelineStage::ComputeShader},
+                {spatialEntryBufferId, ResourceAccess::Read, PipelineStage::ComputeShader},
+            };
+    }
+    return {};
+}
+
+std::vector<ResourceDependency> SpatialGridNode::getOutputs() const {
+    switch (pass) {
+        case Pass::Clear:
+            return {
+                {spatialMapBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+            };
+        case Pass::Count:
+            return {
+                {spatialMapBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+                {spatialEntryBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+                {currentPositionBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+            };
+        case Pass::PrefixSum:
+            return {
+                {spatialMapBufferId, ResourceAccess::ReadWrite, PipelineStage::ComputeShader},
+            };
+        case Pass::Scatter:
+            return {
+                {spatialIndexBufferId, ResourceAccess::Write, PipelineStage::ComputeShader},
+            };
+    }
+    return {};
+}
+
+ComputePipelineState SpatialGridNode::createPipelineState(VkDescriptorSetLayout descriptorLayout) const {
+    switch (pass) {
+        case Pass::Clear: return ComputePipelinePresets::createSpatialGridClearState(descriptorLayout);
+        case Pass::Count: return ComputePipelinePresets::createSpatialGridCountState(descriptorLayout, gpuEntityManager->isCompactLayout());
+        case Pass::PrefixSum: return ComputePipelinePresets::createSpatialGridPrefixSumState(descriptorLayout);
+        case Pass::Scatter: return ComputePipelinePresets::createSpatialGridScatterState(descriptorLayout);
+    }
+    return ComputePipelinePresets::createSpatialGridClearState(descriptorLayout);
+}
+
+uint32_t SpatialGridNode::calculateWorkgroupCount(uint32_t entityCount, uint32_t cellCount) const {
+    switch (pass) {
+        case Pass::Clear:
+            return (cellCount + THREADS_PER_WORKGROUP - 1) / THREADS_PER_WORKGROUP;
+        case Pass::PrefixSum:
+            return 1;  // Single workgroup scans the whole grid
+        case Pass::Count:
+        case Pass::Scatter:
+            return (entityCount + THREADS_PER_WORKGROUP - 1) / THREADS_PER_WORKGROUP;
+    }
+    return 0;
+}
+
+float SpatialGridNode::getBytesPerEntity() const {
+    switch (pass) {
+        case Pass::Count:
+            // Position to current position (xy only under the compact layout), cell counter atomic, entry write
+            return 16.0f + (gpuEntityManager->isCompactLayout() ? 8.0f : 16.0f) + 8.0f + 8.0f;
+        case Pass::Scatter:
+            return 8.0f + 8.0f + 4.0f;          // Entry and cell range reads, sorted index write
+        default:
+            return 0.0f;
+    }
+}
+
+bool SpatialGridNode::isEnabled(const FrameContext& frameContext) const {
+    // An empty world has no one to query the grid, and a frame without a simulation tick runs no physics,
+    // so every pass drops out together
+    if (frameContext.simulation.tickCount == 0) return false;
+    return !gpuEntityManager || gpuEntityManager->getEntityCount() > 0;
+}
+
+void SpatialGridNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    // Validate dependencies are still valid
+    if (!computeManager || !gpuEntityManager) {
+        LOG_ERROR("SpatialGridNode: Critical error - dependencies became null during execution");
+        return;
+    }
+    
+    const uint32_t entityCount = gpuEntityManager->getEntityCount();
+    if (entityCount == 0) {
+        return;
+    }
+    
+    if (pipeline == VK_NULL_HANDLE || pipelineLayout == VK_NULL_HANDLE) {
+        LOG_ERROR("SpatialGridNode: Failed to get " << getPassName(pass) << " pipeline or layout");
+        return;
+    }
+    
+    VkDescriptorSet computeDescriptorSet = gpuEntityManager->getDescriptorManager().getEntityComputeSet();
+    if (computeDescriptorSet == VK_NULL_HANDLE && !gpuEntityManager->getDescriptorManager().usesStreamAddresses()) {
+        LOG_ERROR("SpatialGridNode: ERROR - Missing compute descriptor set!");
+        return;
+    }
+    
+    const SpatialGridConfig& grid = gpuEntityManager->getSpatialGridConfig();
+    const uint32_t workgroupCount = calculateWorkgroupCount(entityCount, grid.getCellCount());
+    if (workgroupCount > 65535) {
+        LOG_ERROR("ERROR: Workgroup count " << workgroupCount << " exceeds Vulkan limit!");
+        return;
+    }
+    
+    const VulkanContext* context = frameGraph.getContext();
+    if (!context) {
+        LOG_ERROR("SpatialGridNode: Cannot get Vulkan context");
+        return;
+    }
+    
+    pushConstants.entityCount = entityCount;
+    pushConstants.frame = frameGraph.getGlobalFrameCounter();
+    pushConstants.entityOffset = 0;
+    pushConstants.gridWidth = grid.width;
+    pushConstants.gridHeight = grid.height;
+    pushConstants.cellSize = grid.cellSize;
+    pushConstants.entityTable = gpuEntityManager->getDescriptorManager().getWorkingTable();
+    pushConstants.cellOrder = static_cast<uint32_t>(grid.cellOrder);
+    pushConstants.cellCapacity = computeManager->getShaderFeatures().maxEntitiesPerCell;
+    pushConstants.occupancyHistogram = grid.occupancyHistogram ? 1u : 0u;
+    
+    FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 1800, getName() << ": " << entityCount << " entities → " << workgroupCount << " workgroups");
+    
+    // Cache loader reference for performance
+    const auto& vk = context->getLoader();
+    
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    if (computeDescriptorSet != VK_NULL_HANDLE) {
+        vk.vkCmdBindDescriptorSets(
+            commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout,
+            0, 1, &computeDescriptorSet, 0, nullptr);
+    }
+    vk.vkCmdPushConstants(
+        commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(SpatialGridPushConstants), &pushConstants);
+    
+    if (timeoutDetector) {
+        timeoutDetector->beginComputeDispatch(commandBuffer, dispatchZone, workgroupCount);
+    }
+    
+    vk.vkCmdDispatch(commandBuffer, workgroupCount, 1, 1);
+    
+    if (timeoutDetector) {
+        timeoutDetector->endComputeDispatch(commandBuffer);
+    }
+}
+
+// Node lifecycle implementation
+bool SpatialGridNode::initializeNode(const FrameGraph& frameGraph) {
+    // One-time initialization - validate dependencies
+    if (!computeManager) {
+        LOG_ERROR("SpatialGridNode: ComputePipelineManager is null");
+        return false;
+    }
+    if (!gpuEntityManager) {
+        LOG_ERROR("SpatialGridNode: GPUEntityManager is null");
+        return false;
+    }
+    return true;
+}
+
+void SpatialGridNode::prepareFrame(uint32_t frameIndex, float time, float deltaTime) {
+    // Frame counter will be set in execute()
+    pushConstants.time = time;
+    pushConstants.deltaTime = deltaTime;
+    
+    // Cache lookups mutate LRU state, so they stay here rather than in execute() (see supportsParallelRecording).
+    // The pass is fixed per node, so only the binding mode keys the handle
+    const bool resolved = gridPipeline.resolveBlocking(*computeManager, gpuEntityManager->getComputeVariantKey(), [this]() {
+        auto layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
+        VkDescriptorSetLayout descriptorLayout = computeManager->getLayoutManager()->getLayout(layoutSpec);
+        ComputePipelineState state = createPipelineState(descriptorLayout);
+        const auto& descriptorManager = gpuEntityManager->getDescriptorManager();
+        if (descriptorManager.usesStreamAddresses()) {
+            ComputePipelinePresets::applyEntityStreamAddresses(state);
+        } else if (descriptorManager.isBindless()) {
+            ComputePipelinePresets::applyBindlessEntityTable(state, descriptorManager.getBindlessTableLayout());
+        }
+        return state;
+    });
+    pipeline = resolved ? gridPipeline.getPipeline() : VK_NULL_HANDLE;
+    pipelineLayout = resolved ? gridPipeline.getLayout() : VK_NULL_HANDLE;
+}
+
+void SpatialGridNode::releaseFrame(uint32_t frameIndex) {
+    // Per-frame cleanup - nothing to clean up for spatial grid passes
+}
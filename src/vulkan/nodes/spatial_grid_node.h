@@ -0,0 +1,107 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/frame_graph.h"
+#include "../rendering/frame_graph_debug.h"
+#include "../core/vulkan_constants.h"
+#include "../pipelines/compute_pipeline_handle.h"
+#include <memory>
+
+// Forward declarations
+class ComputePipelineManager;
+class GPUEntityManager;
+class GPUTimeoutDetector;
+struct ComputePipelineState;
+
+// One pass of the spatial grid counting sort. Four instances run between
+// movement and physics: Clear -> Count -> PrefixSum -> Scatter.
+class SpatialGridNode : public FrameGraphNode {
+public:
+    enum class Pass {
+        Clear,      // Reset cell ranges
+        Count,      // Snapshot positions, count entities per cell, record per-entity slot
+        PrefixSum,  // Convert cell counts into sorted range starts
+        Scatter     // Write entity indices into cell-sorted order
+    };
+    
+    SpatialGridNode(
+        Pass pass,
+        FrameGraphTypes::ResourceId spatialMapBuffer,
+        FrameGraphTypes::ResourceId spatialEntryBuffer,
+        FrameGraphTypes::ResourceId spatialIndexBuffer,
+        FrameGraphTypes::ResourceId positionBuffer,
+        FrameGraphTypes::ResourceId currentPositionBuffer,
+        ComputePipelineManager* computeManager,
+        GPUEntityManager* gpuEntityManager,
+        std::shared_ptr<GPUTimeoutDetector> timeoutDetector = nullptr
+    );
+    
+    // Node identification - one name per pass
+    std::string getName() const override;
+    
+    // FrameGraphNode interface
+    std::vector<ResourceDependency> getInputs() const override;
+    std::vector<ResourceDependency> getOutputs() const override;
+    void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
+    
+    // Queue requirements
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::AsyncCompute; }
+    
+    // Off while the world is empty
+    bool isEnabled(const FrameContext& frameContext) const override;
+    
+    // Pipeline resolution happens in prepareFrame(); the timeout detector is not safe to share across lanes
+    bool supportsParallelRecording() const override { return !timeoutDetector; }
+    
+    // Count and Scatter run per entity; Clear and PrefixSum run per cell and are not reported
+    float getBytesPerEntity() const override;
+    
+    // Node lifecycle - standardized pattern
+    bool initializeNode(const FrameGraph& frameGraph) override;
+    void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
+    void releaseFrame(uint32_t frameIndex) override;
+
+private:
+    ComputePipelineState createPipelineState(VkDescriptorSetLayout descriptorLayout) const;
+    uint32_t calculateWorkgroupCount(uint32_t entityCount, uint32_t cellCount) const;
+    
+    Pass pass;
+    
+    FrameGraphTypes::ResourceId spatialMapBufferId;
+    FrameGraphTypes::ResourceId spatialEntryBufferId;
+    FrameGraphTypes::ResourceId spatialIndexBufferId;
+    FrameGraphTypes::ResourceId positionBufferId;
+    FrameGraphTypes::ResourceId currentPositionBufferId;
+    
+    // External dependencies (not owned) - validated during execution
+    ComputePipelineManager* computeManager;
+    GPUEntityManager* gpuEntityManager;
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector;
+    uint32_t dispatchZone = 0;  // Profiler zone named after the pass, for the timeout detector
+    
+    // Resolved in prepareFrame() from the shared pipeline caches
+    ComputePipelineHandle gridPipeline;
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkPipelineLayout pipelineLayout = VK_NULL_HANDLE;
+    
+    // Debug counter - zero overhead in release builds
+    mutable FrameGraphDebug::DebugCounter debugCounter{};
+    
+    // Frame data for compute shader (layout shared with PhysicsPushConstants)
+    struct SpatialGridPushConstants {
+        float time;
+        float deltaTime;
+        uint32_t entityCount;
+        uint32_t frame;
+        uint32_t entityOffset;
+        uint32_t gridWidth;     // Active spatial grid dimensions (powers of 2)
+        uint32_t gridHeight;
+        float cellSize;
+        uint64_t entityTable;   // Bindless table view or stream address table of the working buffers
+        uint32_t cellOrder;     // SpatialCellOrder, read by the count pass only
+        uint32_t cellCapacity;  // Physics neighbours per cell, prefix sum pass only (overflowing cells)
+        uint32_t occupancyHistogram;  // SpatialGridConfig::occupancyHistogram, prefix sum pass only
+        uint32_t padding0;
+    } pushConstants{};
+};
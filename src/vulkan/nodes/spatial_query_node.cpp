@@ -0,0 +1,187 @@
+#include "spatial_query_node.h"
+#include "../pipelines/compute_pipeline_manager.h"
+#include "../../ecs/gpu/gpu_entity_manager.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../core/vulkan_constants.h"
+#include "../pipelines/descriptor_layout_manager.h"
+#include "../monitoring/gpu_timeout_detector.h"
+#include "../../ecs/utilities/logger.h"
+#include <stdexcept>
+#include <memory>
+
+SpatialQueryNode::SpatialQueryNode(
+    FrameGraphTypes::ResourceId entityBuffer,
+    FrameGraphTypes::ResourceId currentPositionBuffer,
+    FrameGraphTypes::ResourceId spatialMapBuffer,
+    FrameGraphTypes::ResourceId spatialIndexBuffer,
+    ComputePipelineManager* computeManager,
+    GPUEntityManager* gpuEntityManager,
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector
+) : entityBufferId(entityBuffer)
+  , currentPositionBufferId(currentPositionBuffer)
+  , spatialMapBufferId(spatialMapBuffer)
+  , spatialIndexBufferId(spatialIndexBuffer)
+  , computeManager(computeManager)
+  , gpuEntityManager(gpuEntityManager)
+  , timeoutDetector(timeoutDetector) {
+  
+    // Validate dependencies during construction for fail-fast behavior
+    if (!computeManager) {
+        throw std::invalid_argument("SpatialQueryNode: computeManager cannot be null");
+    }
+    if (!gpuEntityManager) {
+        throw std::invalid_argument("SpatialQueryNode: gpuEntityManager cannot be null");
+    }
+}
+
+std::vector<ResourceDependency> SpatialQueryNode::getInputs() const {
+    // The entity buffer read orders the pass after physics; spawn IDs are read from it
+    return {
+        {entityBufferId, ResourceAccess::Read, PipelineStage::ComputeShader},
+        {currentPositionBufferId, ResourceAccess::Read, PipelineStage::ComputeShader},
+        {spatialMapBufferId, ResourceAccess::Read, PipelineStage::ComputeShader},
+        {spatialIndexBufferId, ResourceAccess::Read, PipelineStage::ComputeShader},
+    };
+}
+
+std::vector<ResourceDependency> SpatialQueryNode::getOutputs() const {
+    return {};
+}
+
+bool SpatialQueryNode::isEnabled(const FrameContext& frameContext) const {
+    return frameContext.simulation.tickCount > 0 && gpuEntityManager &&
+           gpuEntityManager->getBufferManager().hasPendingSpatialQueries();
+}
+
+void SpatialQueryNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    // Validate dependencies are still valid
+    if (!computeManager || !gpuEntityManager) {
+        LOG_ERROR("SpatialQueryNode: Critical error - dependencies became null during execution");
+        return;
+    }
+    
+    auto& bufferManager = gpuEntityManager->getBufferManager();
+    if (!bufferManager.hasPendingSpatialQueries()) {
+        return;
+    }
+    
+    // No grid was built over an empty world, and there is nothing in it to find
+    if (gpuEntityManager->getEntityCount() == 0) {
+        EntityBufferManager::answerSpatialQueries(bufferManager.takeSpatialQueryBatch(), true);
+        return;
+    }
+    
+    if (bufferManager.getReorderScratchBufferSize() < SpatialQueryBatch::SCRATCH_BYTES) {
+        LOG_ERROR("SpatialQueryNode: Reorder scratch buffer too small for a query batch");
+        bufferManager.failSpatialQueries();
+        return;
+    }
+    
+    const VulkanContext* context = frameGraph.getContext();
+    if (!context) {
+        LOG_ERROR("SpatialQueryNode: Cannot get Vulkan context");
+        return;
+    }
+    
+    const auto& descriptorManager = gpuEntityManager->getDescriptorManager();
+    const bool resolved = queryPipeline.resolveBlocking(*computeManager, gpuEntityManager->getComputeVariantKey(), [&]() {
+        auto layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
+        VkDescriptorSetLayout descriptorLayout = computeManager->getLayoutManager()->getLayout(layoutSpec);
+        ComputePipelineState state = ComputePipelinePresets::createSpatialQueryState(descriptorLayout, gpuEntityManager->isCompactLayout());
+        if (descriptorManager.usesStreamAddresses()) {
+            ComputePipelinePresets::applyEntityStreamAddresses(state);
+        } else if (descriptorManager.isBindless()) {
+            ComputePipelinePresets::applyBindlessEntityTable(state, descriptorManager.getBindlessTableLayout());
+        }
+        return state;
+    });
+    if (!resolved) {
+        LOG_ERROR("SpatialQueryNode: Failed to get query pipeline or layout");
+        return;
+    }
+    VkPipeline pipeline = queryPipeline.getPipeline();
+    VkPipelineLayout pipelineLayout = queryPipeline.getLayout();
+    
+    VkDescriptorSet computeDescriptorSet = descriptorManager.getEntityComputeSet();
+    if (computeDescriptorSet == VK_NULL_HANDLE && !descriptorManager.usesStreamAddresses()) {
+        LOG_ERROR("SpatialQueryNode: ERROR - Missing compute descriptor set!");
+        return;
+    }
+    
+    // Taken only once the pipeline is ready, so a failed frame leaves the queries queued
+    SpatialQueryBatch batch = bufferManager.takeSpatialQueryBatch();
+    const uint32_t queryCount = static_cast<uint32_t>(batch.records.size());
+    const SpatialGridConfig& grid = gpuEntityManager->getSpatialGridConfig();
+    pushConstants.queryCount = queryCount;
+    pushConstants.gridWidth = grid.width;
+    pushConstants.gridHeight = grid.height;
+    pushConstants.cellSize = grid.cellSize;
+    pushConstants.entityTable = descriptorManager.getWorkingTable();
+    pushConstants.cellOrder = static_cast<uint32_t>(grid.cellOrder);
+    
+    const uint32_t workgroups = (queryCount + THREADS_PER_WORKGROUP - 1) / THREADS_PER_WORKGROUP;
+    
+    FRAME_GRAPH_DEBUG_LOG_THROTTLED(debugCounter, 600, "SpatialQueryNode: " << queryCount << " queries over a "
+                                    << grid.width << "x" << grid.height << " grid");
+    
+    // Cache loader reference for performance
+    const auto& vk = context->getLoader();
+    const auto& barriers = frameGraph.getBarrierManager();
+    VkBuffer scratchBuffer = bufferManager.getReorderScratchBuffer();
+    
+    // The reorder and earlier scratch users this frame must be done with it before the records land
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR);
+    vk.vkCmdUpdateBuffer(commandBuffer, scratchBuffer, 0, queryCount * sizeof(SpatialQueryRecord), batch.records.data());
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    if (computeDescriptorSet != VK_NULL_HANDLE) {
+        vk.vkCmdBindDescriptorSets(
+            commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout,
+            0, 1, &computeDescriptorSet, 0, nullptr);
+    }
+    vk.vkCmdPushConstants(
+        commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT,
+        0, sizeof(SpatialQueryPushConstants), &pushConstants);
+    
+    if (timeoutDetector) {
+        static const ProfileZoneId zone = Profiler::getInstance().registerZone("SpatialQuery");
+        timeoutDetector->beginComputeDispatch(commandBuffer, zone, workgroups);
+    }
+    
+    vk.vkCmdDispatch(commandBuffer, workgroups, 1, 1);
+    
+    if (timeoutDetector) {
+        timeoutDetector->endComputeDispatch(commandBuffer);
+    }
+    
+    barriers.insertMemoryBarrier(
+        commandBuffer, VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR, VK_ACCESS_2_SHADER_WRITE_BIT_KHR,
+        VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_READ_BIT_KHR);
+    if (bufferManager.recordSpatialQueryReadback(commandBuffer, std::move(batch))) {
+        // Host reads of the ring, and the next writers of the scratch buffer after the copy
+        barriers.insertMemoryBarrier(
+            commandBuffer, VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR, VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR,
+            VK_PIPELINE_STAGE_2_HOST_BIT_KHR | VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR,
+            VK_ACCESS_2_HOST_READ_BIT_KHR | VK_ACCESS_2_TRANSFER_WRITE_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR);
+    }
+}
+
+// Node lifecycle implementation
+bool SpatialQueryNode::initializeNode(const FrameGraph& frameGraph) {
+    // One-time initialization - validate dependencies
+    if (!computeManager) {
+        LOG_ERROR("SpatialQueryNode: ComputePipelineManager is null");
+        return false;
+    }
+    if (!gpuEntityManager) {
+        LOG_ERROR("SpatialQueryNode: GPUEntityManager is null");
+        return false;
+    }
+    return true;
+}
@@ -0,0 +1,74 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/frame_graph.h"
+#include "../rendering/frame_graph_debug.h"
+#include "../core/vulkan_constants.h"
+#include "../pipelines/compute_pipeline_handle.h"
+#include <memory>
+#include <vector>
+
+// Forward declarations
+class ComputePipelineManager;
+class GPUEntityManager;
+class GPUTimeoutDetector;
+
+// Answers queued spatial queries (EntityBufferManager::submitSpatialQuery) against the grid this frame's spatial
+// passes built: up to SPATIAL_QUERY_MAX_BATCH query records are uploaded into the reorder scratch buffer,
+// spatial_query.comp walks each query's cells and the results are copied into the ReadbackRing in the same pass.
+// Runs after PhysicsComputeNode on frames that ran a simulation tick and have queries queued.
+class SpatialQueryNode : public FrameGraphNode {
+    DECLARE_FRAME_GRAPH_NODE(SpatialQueryNode)
+
+public:
+    SpatialQueryNode(
+        FrameGraphTypes::ResourceId entityBuffer,
+        FrameGraphTypes::ResourceId currentPositionBuffer,
+        FrameGraphTypes::ResourceId spatialMapBuffer,
+        FrameGraphTypes::ResourceId spatialIndexBuffer,
+        ComputePipelineManager* computeManager,
+        GPUEntityManager* gpuEntityManager,
+        std::shared_ptr<GPUTimeoutDetector> timeoutDetector = nullptr
+    );
+    
+    // FrameGraphNode interface - queries and results live in the reorder scratch buffer, which the graph does not track
+    std::vector<ResourceDependency> getInputs() const override;
+    std::vector<ResourceDependency> getOutputs() const override;
+    void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
+    
+    // Only the frames that build the grid can answer, and only when someone asked
+    bool isEnabled(const FrameContext& frameContext) const override;
+    
+    // Queue requirements
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::AsyncCompute; }
+    
+    // Node lifecycle - standardized pattern
+    bool initializeNode(const FrameGraph& frameGraph) override;
+
+private:
+    FrameGraphTypes::ResourceId entityBufferId;
+    FrameGraphTypes::ResourceId currentPositionBufferId;
+    FrameGraphTypes::ResourceId spatialMapBufferId;
+    FrameGraphTypes::ResourceId spatialIndexBufferId;
+    
+    // External dependencies (not owned) - validated during execution
+    ComputePipelineManager* computeManager;
+    GPUEntityManager* gpuEntityManager;
+    std::shared_ptr<GPUTimeoutDetector> timeoutDetector;
+    ComputePipelineHandle queryPipeline;
+    
+    // Debug counter - zero overhead in release builds
+    mutable FrameGraphDebug::DebugCounter debugCounter{};
+    
+    // Must match spatial_query.comp
+    struct SpatialQueryPushConstants {
+        uint32_t queryCount;
+        uint32_t gridWidth;     // Active grid dimensions, as the spatial passes used them this frame
+        uint32_t gridHeight;
+        float cellSize;
+        uint64_t entityTable;   // Bindless table view or stream address table of the working buffers
+        uint32_t cellOrder;     // SpatialCellOrder the grid was built with
+        uint32_t padding0;
+    } pushConstants{};
+};
@@ -0,0 +1,140 @@
+#include "swapchain_capture_node.h"
+#include "../pipelines/descriptor_layout_manager.h"
+#include "../core/vulkan_swapchain.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../services/video_recorder.h"
+#include "../../ecs/utilities/logger.h"
+#include <stdexcept>
+
+SwapchainCaptureNode::SwapchainCaptureNode(
+    FrameGraphTypes::ResourceId colorTarget,
+    ComputePipelineManager* computeManager,
+    VulkanSwapchain* swapchain
+) : colorTargetId(colorTarget)
+  , computeManager(computeManager)
+  , swapchain(swapchain) {
+  
+    // Validate dependencies during construction for fail-fast behavior
+    if (!computeManager) {
+        throw std::invalid_argument("SwapchainCaptureNode: computeManager cannot be null");
+    }
+    if (!swapchain) {
+        throw std::invalid_argument("SwapchainCaptureNode: swapchain cannot be null");
+    }
+}
+
+std::vector<ResourceDependency> SwapchainCaptureNode::getInputs() const {
+    return {};
+}
+
+std::vector<ResourceDependency> SwapchainCaptureNode::getOutputs() const {
+    return {
+        {currentSwapchainImageId, ResourceAccess::Write, PipelineStage::ColorAttachment},
+    };
+}
+
+bool SwapchainCaptureNode::isEnabled(const FrameContext& frameContext) const {
+    return recorder != nullptr && recorder->isAttached() && swapchain->isCaptureSupported();
+}
+
+void SwapchainCaptureNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
+    // prepareFrame() already decided this frame is not captured
+    if (!frameResolved) {
+        return;
+    }
+    
+    const VulkanContext* context = frameGraph.getContext();
+    if (!context) {
+        LOG_ERROR("SwapchainCaptureNode: Missing Vulkan context");
+        return;
+    }
+    
+    recorder->recordCapture(commandBuffer, context->getLoader(), resolvedImage, resolvedPipeline, cachedPipelineLayout);
+}
+
+bool SwapchainCaptureNode::resolveFrame(uint32_t frameIndex) {
+    // Detect manager cache invalidation; the pipeline layout handle comes from the layout cache
+    const auto* layoutMgr = computeManager->getLayoutManager();
+    const uint64_t currentLayoutGen = layoutMgr ? layoutMgr->getGeneration() : 0;
+    const uint64_t currentComputeGen = computeManager->getGeneration();
+    if (currentLayoutGen != observedLayoutGeneration || currentComputeGen != observedComputePipelineGeneration) {
+        invalidateCachedState();
+        observedLayoutGeneration = currentLayoutGen;
+        observedComputePipelineGeneration = currentComputeGen;
+    }
+    
+    // The recorder's layout is its own, recreated with its resources after a device rebuild
+    const VkDescriptorSetLayout descriptorLayout = recorder->getDescriptorSetLayout();
+    if (descriptorLayout == VK_NULL_HANDLE) {
+        return false;
+    }
+    if (cachedLayout != descriptorLayout) {
+        cachedPipelineState = ComputePipelinePresets::createCaptureYuvState(descriptorLayout);
+        cachedLayout = descriptorLayout;
+        cachedPipelineLayout = VK_NULL_HANDLE;
+    }
+    
+    // Non-blocking like the HUD: recording starts once the conversion has compiled
+    resolvedPipeline = computeManager->getPipelineIfReady(cachedPipelineState);
+    if (resolvedPipeline == VK_NULL_HANDLE) {
+        return false;
+    }
+    if (cachedPipelineLayout == VK_NULL_HANDLE) {
+        cachedPipelineLayout = computeManager->getPipelineLayout(cachedPipelineState);
+    }
+    if (cachedPipelineLayout == VK_NULL_HANDLE) {
+        LOG_ERROR("SwapchainCaptureNode: Failed to get capture pipeline");
+        return false;
+    }
+    
+    const std::vector<VkImage>& images = swapchain->getImages();
+    if (imageIndex >= images.size()) {
+        LOG_ERROR("SwapchainCaptureNode: Invalid imageIndex " << imageIndex);
+        return false;
+    }
+    resolvedImage = images[imageIndex];
+    
+    // Last, since a reserved slot must be recorded and submitted
+    return recorder->prepareCapture(frameIndex, swapchain->getExtent(), swapchain->getImageFormat());
+}
+
+// Node lifecycle implementation
+bool SwapchainCaptureNode::initializeNode(const FrameGraph& frameGraph) {
+    // One-time initialization - validate dependencies
+    if (!computeManager || !swapchain) {
+        LOG_ERROR("SwapchainCaptureNode: Missing dependencies");
+        return false;
+    }
+    
+    if (!swapchain->isCaptureSupported()) {
+        LOG_INFO("SwapchainCaptureNode: Swapchain images cannot be copied from, session recording disabled");
+    }
+    return true;
+}
+
+void SwapchainCaptureNode::prepareFrame(uint32_t frameIndex, float time, float deltaTime) {
+    frameResolved = false;
+    if (!recorder || !recorder->isAttached() || !swapchain->isCaptureSupported()) {
+        return;
+    }
+    frameResolved = resolveFrame(frameIndex);
+}
+
+uint64_t SwapchainCaptureNode::getRecordingKey() const {
+    // An unresolved frame records nothing but may be resolvable next frame
+    if (!frameResolved) {
+        return UNCACHEABLE_RECORDING;
+    }
+    
+    uint64_t key = combineRecordingKey(0, imageIndex);
+    key = combineRecordingKey(key, recordingHandleKey(resolvedPipeline));
+    key = combineRecordingKey(key, recordingHandleKey(cachedPipelineLayout));
+    key = combineRecordingKey(key, recordingHandleKey(resolvedImage));
+    key = combineRecordingKey(key, recorder->getCaptureKey());
+    return key;
+}
+
+void SwapchainCaptureNode::releaseFrame(uint32_t frameIndex) {
+    // Per-frame cleanup - the recorder's slot is handed over by VideoRecorder::submitFrame()
+}
@@ -0,0 +1,86 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../rendering/frame_graph.h"
+#include "../pipelines/compute_pipeline_manager.h"
+#include <cstdint>
+#include <limits>
+
+// Forward declarations
+class VulkanSwapchain;
+class VideoRecorder;
+
+// Session recording capture (--record): after the HUD and before presentation, copies the finished swapchain
+// image into VideoRecorder's capture resources and converts it to YUV with capture_yuv.comp, in the graphics
+// command buffer. Disabled while no recorder is set, the swapchain images are not transfer sources, or the
+// recorder has no free slot for the frame (the frame is then dropped from the recording)
+class SwapchainCaptureNode : public FrameGraphNode {
+    DECLARE_FRAME_GRAPH_NODE(SwapchainCaptureNode)
+
+public:
+    SwapchainCaptureNode(
+        FrameGraphTypes::ResourceId colorTarget,
+        ComputePipelineManager* computeManager,
+        VulkanSwapchain* swapchain
+    );
+    
+    // FrameGraphNode interface - like the HUD, ordered after the pass that finished the image, layout
+    // transitions made by the node itself
+    std::vector<ResourceDependency> getInputs() const override;
+    std::vector<ResourceDependency> getOutputs() const override;
+    void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
+    
+    uint64_t getRecordingKey() const override;
+    bool isEnabled(const FrameContext& frameContext) const override;
+    
+    // Queue requirements
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::Graphics; }
+    
+    // Node lifecycle - standardized pattern
+    bool initializeNode(const FrameGraph& frameGraph) override;
+    void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
+    void releaseFrame(uint32_t frameIndex) override;
+    
+    // Update swapchain image index for current frame
+    void setImageIndex(uint32_t imageIndex) { this->imageIndex = imageIndex; }
+    
+    // Set current frame's swapchain image resource ID (called each frame)
+    void setCurrentSwapchainImageId(FrameGraphTypes::ResourceId currentImageId) { this->currentSwapchainImageId = currentImageId; }
+    
+    // Recorder the frames go to (not owned); nullptr stops capturing
+    void setVideoRecorder(VideoRecorder* recorder) { this->recorder = recorder; }
+    
+    // Invalidate cached state after swapchain recreation or layout cache clear
+    void invalidateCachedState() {
+        cachedLayout = VK_NULL_HANDLE;
+        cachedPipelineLayout = VK_NULL_HANDLE;
+    }
+
+private:
+    bool resolveFrame(uint32_t frameIndex);
+    
+    // Resources
+    FrameGraphTypes::ResourceId colorTargetId; // Static placeholder - not used
+    FrameGraphTypes::ResourceId currentSwapchainImageId = 0; // Dynamic per-frame ID
+    
+    // External dependencies (not owned) - validated during execution
+    ComputePipelineManager* computeManager;
+    VulkanSwapchain* swapchain;
+    VideoRecorder* recorder = nullptr;
+    
+    // Current frame state
+    uint32_t imageIndex = 0;
+    
+    // Resolved by prepareFrame() for execute() and getRecordingKey()
+    bool frameResolved = false;
+    VkPipeline resolvedPipeline = VK_NULL_HANDLE;
+    VkImage resolvedImage = VK_NULL_HANDLE;
+    
+    // Pipeline state for the recorder's descriptor set layout, rebuilt when it or a manager generation changes
+    ComputePipelineState cachedPipelineState;
+    VkDescriptorSetLayout cachedLayout = VK_NULL_HANDLE;
+    VkPipelineLayout cachedPipelineLayout = VK_NULL_HANDLE;
+    uint64_t observedLayoutGeneration = std::numeric_limits<uint64_t>::max();
+    uint64_t observedComputePipelineGeneration = std::numeric_limits<uint64_t>::max();
+};
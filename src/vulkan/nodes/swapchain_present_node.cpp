@@ -2,7 +2,7 @@
 #include "../core/vulkan_swapchain.h"
 #include "../core/vulkan_context.h"
 #include "../core/vulkan_function_loader.h"
-#include <iostream>
+#include "../../ecs/utilities/logger.h"
 #include <stdexcept>
 #include <memory>
 
@@ -12,7 +12,7 @@ namespace {
     public:
         static bool validateDependencies(VulkanSwapchain* swapchain, const char* context) {
             if (!swapchain) {
-                std::cerr << context << ": Missing swapchain dependency" << std::endl;
+                LOG_ERROR(context << ": Missing swapchain dependency");
                 return false;
             }
             return true;
@@ -20,7 +20,7 @@ namespace {
         
         static bool validateContext(const VulkanContext* context, const char* nodeContext) {
             if (!context) {
-                std::cerr << nodeContext << ": Missing Vulkan context from frame graph" << std::endl;
+                LOG_ERROR(nodeContext << ": Missing Vulkan context from frame graph");
                 return false;
             }
             return true;
@@ -55,7 +55,7 @@ std::vector<ResourceDependency> SwapchainPresentNode::getOutputs() const {
 void SwapchainPresentNode::execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) {
     // Validate runtime dependencies
     if (!swapchain) {
-        std::cerr << "SwapchainPresentNode::execute: Critical error - swapchain became null during execution" << std::endl;
+        LOG_ERROR("SwapchainPresentNode::execute: Critical error - swapchain became null during execution");
         return;
     }
     
@@ -67,8 +67,8 @@ void SwapchainPresentNode::execute(VkCommandBuffer commandBuffer, const FrameGra
     // Validate image index bounds
     uint32_t imageCount = swapchain->getImages().size();
     if (imageIndex >= imageCount) {
-        std::cerr << "SwapchainPresentNode: Invalid image index " << imageIndex 
-                  << " (max: " << imageCount << ")" << std::endl;
+        LOG_ERROR("SwapchainPresentNode: Invalid image index " << imageIndex 
+                  << " (max: " << imageCount << ")");
         return;
     }
     
@@ -83,7 +83,7 @@ void SwapchainPresentNode::execute(VkCommandBuffer commandBuffer, const FrameGra
 bool SwapchainPresentNode::initializeNode(const FrameGraph& frameGraph) {
     // One-time initialization - validate dependencies
     if (!swapchain) {
-        std::cerr << "SwapchainPresentNode: VulkanSwapchain is null" << std::endl;
+        LOG_ERROR("SwapchainPresentNode: VulkanSwapchain is null");
         return false;
     }
     return true;
@@ -93,8 +93,8 @@ void SwapchainPresentNode::prepareFrame(uint32_t frameIndex, float time, float d
     // Per-frame preparation - validate image index (timing data not needed for present node)
     uint32_t imageCount = swapchain ? swapchain->getImages().size() : 0;
     if (imageIndex >= imageCount) {
-        std::cerr << "SwapchainPresentNode: Invalid image index " << imageIndex 
-                  << " (max: " << imageCount << ")" << std::endl;
+        LOG_ERROR("SwapchainPresentNode: Invalid image index " << imageIndex 
+                  << " (max: " << imageCount << ")");
     }
 }
 
@@ -22,14 +22,16 @@ public:
     std::vector<ResourceDependency> getOutputs() const override;
     void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) override;
     
+    // Records no commands, so it never forces the graphics queue to re-record
+    uint64_t getRecordingKey() const override { return combineRecordingKey(0, imageIndex); }
+    
     // Node lifecycle - standardized pattern
     bool initializeNode(const FrameGraph& frameGraph) override;
     void prepareFrame(uint32_t frameIndex, float time, float deltaTime) override;
     void releaseFrame(uint32_t frameIndex) override;
     
     // Queue requirements - presentation happens on graphics queue
-    bool needsComputeQueue() const override { return false; }
-    bool needsGraphicsQueue() const override { return true; }
+    QueueAffinity getQueueAffinity() const override { return QueueAffinity::Graphics; }
     
     // Update swapchain image index for current frame
     void setImageIndex(uint32_t imageIndex) { this->imageIndex = imageIndex; }
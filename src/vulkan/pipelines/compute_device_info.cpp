@@ -28,7 +28,19 @@ uint32_t ComputeDeviceInfo::getMaxComputeWorkgroupInvocations() const {
 }
 
 bool ComputeDeviceInfo::supportsSubgroupOperations() const {
-    return true;
+    return context_ && context_->supportsSubgroupBallot();
+}
+
+std::vector<uint32_t> ComputeDeviceInfo::getWorkgroupSizeCandidates() const {
+    const uint32_t limit = std::min(deviceProperties_.limits.maxComputeWorkGroupInvocations,
+                                    deviceProperties_.limits.maxComputeWorkGroupSize[0]);
+    std::vector<uint32_t> candidates;
+    for (uint32_t size = 32; size <= 256; size *= 2) {
+        if (size <= limit) {
+            candidates.push_back(size);
+        }
+    }
+    return candidates;
 }
 
 glm::uvec3 ComputeDeviceInfo::calculateOptimalWorkgroupSize(uint32_t dataSize,
@@ -3,6 +3,7 @@
 #define VK_NO_PROTOTYPES
 #include <vulkan/vulkan.h>
 #include <glm/glm.hpp>
+#include <vector>
 #include "../core/vulkan_context.h"
 
 class ComputeDeviceInfo {
@@ -14,8 +15,13 @@ public:
     
     glm::uvec3 getOptimalWorkgroupSize() const;
     uint32_t getMaxComputeWorkgroupInvocations() const;
+    // Subgroup ballots (VK_EXT_shader_subgroup_ballot) for the .ballot compaction kernel variants
     bool supportsSubgroupOperations() const;
     
+    // local_size_x values worth timing for 1D per-entity kernels: 32 through 256 within the device limits.
+    // Vulkan 1.0 cannot query the subgroup width, so wave32 and wave64 sizes are both tried
+    std::vector<uint32_t> getWorkgroupSizeCandidates() const;
+    
     glm::uvec3 calculateOptimalWorkgroupSize(uint32_t dataSize,
                                             const glm::uvec3& maxWorkgroupSize = {1024, 1024, 64}) const;
     uint32_t calculateOptimalWorkgroupCount(uint32_t dataSize, uint32_t workgroupSize) const;
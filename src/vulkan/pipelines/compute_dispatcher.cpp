@@ -21,6 +21,12 @@ void ComputeDispatcher::dispatch(VkCommandBuffer commandBuffer, const ComputeDis
             dispatch.descriptorSets.data(), 0, nullptr);
     }
     
+    if (!dispatch.pushDescriptorWrites.empty()) {
+        cmdPushDescriptorSet(
+            commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, dispatch.layout, dispatch.pushDescriptorSet,
+            static_cast<uint32_t>(dispatch.pushDescriptorWrites.size()), dispatch.pushDescriptorWrites.data());
+    }
+    
     if (dispatch.pushConstantData && dispatch.pushConstantSize > 0) {
         cmdPushConstants(
             commandBuffer, dispatch.layout, dispatch.pushConstantStages,
@@ -119,6 +125,17 @@ bool ComputeDispatcher::validateDispatch(const ComputeDispatch& dispatch) const
                   << dispatch.groupCountX << "x" << dispatch.groupCountY << "x" << dispatch.groupCountZ << std::endl;
         return false;
     }
+    if (!dispatch.pushDescriptorWrites.empty()) {
+        if (!context->supportsPushDescriptors()) {
+            std::cerr << "ComputeDispatcher: Push descriptor writes without VK_KHR_push_descriptor" << std::endl;
+            return false;
+        }
+        if (dispatch.pushDescriptorSet < dispatch.descriptorSets.size()) {
+            std::cerr << "ComputeDispatcher: Push descriptor set " << dispatch.pushDescriptorSet
+                      << " overlaps the " << dispatch.descriptorSets.size() << " bound sets" << std::endl;
+            return false;
+        }
+    }
     return true;
 }
 
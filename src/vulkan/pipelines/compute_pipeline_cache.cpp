@@ -1,11 +1,13 @@
 #include "compute_pipeline_cache.h"
+#include "../core/deletion_queue.h"
 #include <iostream>
 #include <algorithm>
 
-ComputePipelineCache::ComputePipelineCache(uint32_t maxCacheSize) : maxCacheSize_(maxCacheSize) {}
+ComputePipelineCache::ComputePipelineCache(uint32_t maxCacheSize)
+    : cache_(&MemoryTags::getResource(MemoryTag::PipelineCache)), maxCacheSize_(maxCacheSize) {}
 
-VkPipeline ComputePipelineCache::getPipeline(const ComputePipelineState& state) {
-    auto it = cache_.find(state);
+VkPipeline ComputePipelineCache::getPipeline(const VulkanHash::PipelineKey& key, const ComputePipelineState& state) {
+    auto it = cache_.find(key);
     if (it != cache_.end()) {
         updateStats(true);
         it->second->lastUsedFrame = ++frameCounter_;
@@ -30,7 +32,7 @@ VkPipeline ComputePipelineCache::getPipeline(const ComputePipelineState& state)
     
     updateStats(false, cachedPipeline->compilationTime);
     
-    cache_[state] = std::move(cachedPipeline);
+    cache_[key] = std::move(cachedPipeline);
     stats_.totalPipelines++;
     
     if (cache_.size() > maxCacheSize_) {
@@ -40,31 +42,37 @@ VkPipeline ComputePipelineCache::getPipeline(const ComputePipelineState& state)
     return pipeline;
 }
 
-VkPipelineLayout ComputePipelineCache::getPipelineLayout(const ComputePipelineState& state) {
-    auto it = cache_.find(state);
+VkPipelineLayout ComputePipelineCache::getPipelineLayout(const VulkanHash::PipelineKey& key, const ComputePipelineState& state) {
+    auto it = cache_.find(key);
     if (it != cache_.end()) {
         return it->second->layout.get();
     }
     
-    VkPipeline pipeline = getPipeline(state);
+    VkPipeline pipeline = getPipeline(key, state);
     if (pipeline == VK_NULL_HANDLE) {
         return VK_NULL_HANDLE;
     }
     
-    it = cache_.find(state);
+    it = cache_.find(key);
     return it != cache_.end() ? it->second->layout.get() : VK_NULL_HANDLE;
 }
 
-bool ComputePipelineCache::contains(const ComputePipelineState& state) const {
-    return cache_.find(state) != cache_.end();
+bool ComputePipelineCache::contains(const VulkanHash::PipelineKey& key) const {
+    return cache_.find(key) != cache_.end();
 }
 
-void ComputePipelineCache::insert(const ComputePipelineState& state, std::unique_ptr<CachedComputePipeline> pipeline) {
+void ComputePipelineCache::insert(const VulkanHash::PipelineKey& key, std::unique_ptr<CachedComputePipeline> pipeline) {
     pipeline->lastUsedFrame = ++frameCounter_;
     updateStats(false, pipeline->compilationTime);
     
-    cache_[state] = std::move(pipeline);
-    stats_.totalPipelines++;
+    // Swapping in a replacement (hot reload) leaves the old pipeline to frames still recording with it
+    auto& entry = cache_[key];
+    if (entry) {
+        retire(std::move(entry));
+    } else {
+        stats_.totalPipelines++;
+    }
+    entry = std::move(pipeline);
     
     if (cache_.size() > maxCacheSize_) {
         evictLeastRecentlyUsed();
@@ -74,8 +82,10 @@ void ComputePipelineCache::insert(const ComputePipelineState& state, std::unique
 void ComputePipelineCache::optimizeCache(uint64_t currentFrame) {
     for (auto it = cache_.begin(); it != cache_.end();) {
         if (currentFrame - it->second->lastUsedFrame > CACHE_CLEANUP_INTERVAL) {
+            retire(std::move(it->second));
             it = cache_.erase(it);
             stats_.totalPipelines--;
+            ++evictionCount_;
         } else {
             ++it;
         }
@@ -84,6 +94,9 @@ void ComputePipelineCache::optimizeCache(uint64_t currentFrame) {
 
 void ComputePipelineCache::clear() {
     // Clear cache in dependency order - pipelines first, then layouts
+    for (auto& [key, pipeline] : cache_) {
+        retire(std::move(pipeline));
+    }
     cache_.clear();
     
     // Reset statistics to prevent corruption
@@ -94,6 +107,25 @@ void ComputePipelineCache::clear() {
     stats_.hitRatio = 0.0f;
 }
 
+ComputePipelineCache::Stats ComputePipelineCache::getStats() const {
+    stats_.maxRegisters = 0;
+    stats_.spillingPipelines = 0;
+    for (const auto& [key, cached] : cache_) {
+        const PipelineExecutableStats& executable = cached->executableStats;
+        stats_.maxRegisters = std::max(stats_.maxRegisters, static_cast<uint32_t>(executable.registers));
+        stats_.spillingPipelines += executable.spillsRegisters() ? 1 : 0;
+    }
+    return stats_;
+}
+
+void ComputePipelineCache::collectExecutableReports(std::vector<PipelineExecutableReport>& reports) const {
+    for (const auto& [key, cached] : cache_) {
+        if (cached->executableStats.isCaptured()) {
+            reports.push_back({PipelineUtils::describeShaders({cached->state.shaderPath}), cached->executableStats});
+        }
+    }
+}
+
 void ComputePipelineCache::resetFrameStats() {
     stats_.hitRatio = static_cast<float>(stats_.cacheHits) / static_cast<float>(stats_.cacheHits + stats_.cacheMisses);
 }
@@ -112,8 +144,16 @@ void ComputePipelineCache::evictLeastRecentlyUsed() {
         }
     }
     
+    retire(std::move(lruIt->second));
     cache_.erase(lruIt);
     stats_.totalPipelines--;
+    ++evictionCount_;
+}
+
+void ComputePipelineCache::retire(std::unique_ptr<CachedComputePipeline> pipeline) {
+    if (deletionQueue_) {
+        deletionQueue_->retire(std::move(pipeline));
+    }
 }
 
 void ComputePipelineCache::updateStats(bool isHit, std::chrono::nanoseconds compilationTime) {
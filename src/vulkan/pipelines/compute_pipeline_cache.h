@@ -4,10 +4,14 @@
 #include <vulkan/vulkan.h>
 #include <unordered_map>
 #include <memory>
+#include <memory_resource>
 #include <chrono>
 #include <functional>
 #include "compute_pipeline_types.h"
 #include "../core/vulkan_constants.h"
+#include "../../ecs/utilities/memory_tags.h"
+
+class DeletionQueue;
 
 class ComputePipelineCache {
 public:
@@ -20,30 +24,48 @@ public:
         uint32_t cacheMisses = 0;
         std::chrono::nanoseconds totalCompilationTime{0};
         float hitRatio = 0.0f;
+        
+        // Over the cached pipelines whose executable statistics were captured
+        uint32_t maxRegisters = 0;
+        uint32_t spillingPipelines = 0;
     };
 
-    VkPipeline getPipeline(const ComputePipelineState& state);
-    VkPipelineLayout getPipelineLayout(const ComputePipelineState& state);
+    // key is state.getKey(), built once by the caller; state only feeds the create callback on a miss
+    VkPipeline getPipeline(const VulkanHash::PipelineKey& key, const ComputePipelineState& state);
+    VkPipelineLayout getPipelineLayout(const VulkanHash::PipelineKey& key, const ComputePipelineState& state);
     
-    bool contains(const ComputePipelineState& state) const;
-    void insert(const ComputePipelineState& state, std::unique_ptr<CachedComputePipeline> pipeline);
+    bool contains(const VulkanHash::PipelineKey& key) const;
+    void insert(const VulkanHash::PipelineKey& key, std::unique_ptr<CachedComputePipeline> pipeline);
     
     void optimizeCache(uint64_t currentFrame);
     void clear();
     
-    Stats getStats() const { return stats_; }
+    Stats getStats() const;
+    void collectExecutableReports(std::vector<PipelineExecutableReport>& reports) const;
+    
+    // Entries dropped by LRU or age eviction so far, so handles held outside the cache can tell theirs went away
+    uint64_t getEvictionCount() const { return evictionCount_; }
+    
     void resetFrameStats();
     
     void setCreatePipelineCallback(std::function<std::unique_ptr<CachedComputePipeline>(const ComputePipelineState&)> callback);
+    
+    // Evicted, replaced and cleared pipelines go here instead of being destroyed on the spot (nullptr = destroy)
+    void setDeletionQueue(DeletionQueue* deletionQueue) { deletionQueue_ = deletionQueue; }
+    DeletionQueue* getDeletionQueue() const { return deletionQueue_; }
 
 private:
-    std::unordered_map<ComputePipelineState, std::unique_ptr<CachedComputePipeline>, ComputePipelineStateHash> cache_;
+    // Entries charged to MemoryTag::PipelineCache (the map's nodes and buckets; the pipelines they own are not)
+    std::pmr::unordered_map<VulkanHash::PipelineKey, std::unique_ptr<CachedComputePipeline>, VulkanHash::PipelineKeyHash> cache_;
     std::function<std::unique_ptr<CachedComputePipeline>(const ComputePipelineState&)> createPipelineCallback_;
+    DeletionQueue* deletionQueue_ = nullptr;
     
     uint32_t maxCacheSize_;
     uint64_t frameCounter_ = 0;
+    uint64_t evictionCount_ = 0;
     mutable Stats stats_;
     
     void evictLeastRecentlyUsed();
+    void retire(std::unique_ptr<CachedComputePipeline> pipeline);
     void updateStats(bool isHit, std::chrono::nanoseconds compilationTime = {});
 };
\ No newline at end of file
@@ -23,19 +23,29 @@ std::unique_ptr<CachedComputePipeline> ComputePipelineFactory::createPipeline(co
     auto cachedPipeline = std::make_unique<CachedComputePipeline>();
     cachedPipeline->state = state;
     
-    VkPipelineLayout rawLayout = createPipelineLayout(state.descriptorSetLayouts, state.pushConstantRanges);
-    if (rawLayout == VK_NULL_HANDLE) {
-        std::cerr << "Failed to create compute pipeline layout" << std::endl;
-        return nullptr;
-    }
-    cachedPipeline->layout = vulkan_raii::make_pipeline_layout(rawLayout, context);
-    
     VkShaderModule shaderModule = loadShader(state);
     if (shaderModule == VK_NULL_HANDLE) {
         std::cerr << "Failed to load compute shader: " << state.shaderPath << std::endl;
         return nullptr;
     }
     
+    // The shader's own push constant block decides the range, so a state declaring none or too few bytes
+    // still gets a layout the shader is valid against
+    std::vector<VkPushConstantRange> pushConstantRanges = state.pushConstantRanges;
+    SpirvReflection reflection;
+    if (shaderManager_->reflectShader(shaderModule, reflection) &&
+        reconcilePushConstantRanges(pushConstantRanges, reflection, VK_SHADER_STAGE_COMPUTE_BIT)) {
+        std::cerr << "ComputePipelineFactory: " << state.shaderPath << " declares " << reflection.pushConstantSize
+                  << " push constant bytes, more than its state's ranges; range taken from the shader" << std::endl;
+    }
+    
+    VkPipelineLayout rawLayout = createPipelineLayout(state.descriptorSetLayouts, pushConstantRanges);
+    if (rawLayout == VK_NULL_HANDLE) {
+        std::cerr << "Failed to create compute pipeline layout" << std::endl;
+        return nullptr;
+    }
+    cachedPipeline->layout = vulkan_raii::make_pipeline_layout(rawLayout, context);
+    
     VkPipelineShaderStageCreateInfo shaderStageInfo{};
     shaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
     shaderStageInfo.stage = VK_SHADER_STAGE_COMPUTE_BIT;
@@ -54,6 +64,17 @@ std::unique_ptr<CachedComputePipeline> ComputePipelineFactory::createPipeline(co
     pipelineInfo.stage = shaderStageInfo;
     pipelineInfo.layout = cachedPipeline->layout.get();
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+    if (context->supportsPipelineExecutableInfo()) {
+        pipelineInfo.flags |= VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR;
+    }
+    
+    // The indirect bindable bit only exists as a 64-bit flag, which replaces pipelineInfo.flags altogether
+    VkPipelineCreateFlags2CreateInfoKHR createFlags2{};
+    createFlags2.sType = VK_STRUCTURE_TYPE_PIPELINE_CREATE_FLAGS_2_CREATE_INFO_KHR;
+    if (state.indirectBindable && context->supportsDeviceGeneratedCommands()) {
+        createFlags2.flags = VkPipelineCreateFlags2KHR(pipelineInfo.flags) | VK_PIPELINE_CREATE_2_INDIRECT_BINDABLE_BIT_EXT;
+        pipelineInfo.pNext = &createFlags2;
+    }
     
     std::cout << "ComputePipelineFactory: Creating compute pipeline for shader: " << state.shaderPath << std::endl;
     
@@ -72,7 +93,12 @@ std::unique_ptr<CachedComputePipeline> ComputePipelineFactory::createPipeline(co
     auto endTime = std::chrono::high_resolution_clock::now();
     cachedPipeline->compilationTime = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
     
+    if (context->supportsPipelineExecutableInfo()) {
+        cachedPipeline->executableStats = PipelineUtils::queryExecutableStatistics(device, *loader, rawPipeline);
+    }
+    
     logPipelineCreation(state, cachedPipeline->compilationTime);
+    PipelineUtils::logExecutableStatistics(state.shaderPath, cachedPipeline->executableStats);
     
     return cachedPipeline;
 }
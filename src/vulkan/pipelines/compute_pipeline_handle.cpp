@@ -0,0 +1,47 @@
+#include "compute_pipeline_handle.h"
+#include "compute_pipeline_manager.h"
+#include "descriptor_layout_manager.h"
+
+void ComputePipelineHandle::reset() {
+    pipeline = VK_NULL_HANDLE;
+    layout = VK_NULL_HANDLE;
+    readyState = ComputePipelineState{};
+    readyKey = 0;
+    pendingState = ComputePipelineState{};
+    hasPending = false;
+}
+
+void ComputePipelineHandle::invalidateIfStale(const ComputePipelineManager& manager) {
+    // Both generations also move on evictions, so a held handle never outlives its cache entry
+    const DescriptorLayoutManager* layoutManager = manager.getLayoutManager();
+    const uint64_t pipelineGeneration = manager.getGeneration();
+    const uint64_t layoutGeneration = layoutManager ? layoutManager->getGeneration() : 0;
+    if (pipelineGeneration != observedPipelineGeneration || layoutGeneration != observedLayoutGeneration) {
+        // The states hold descriptor set layouts from the old generation, so they are rebuilt too
+        reset();
+        observedPipelineGeneration = pipelineGeneration;
+        observedLayoutGeneration = layoutGeneration;
+    }
+}
+
+bool ComputePipelineHandle::adoptPending(ComputePipelineManager& manager, bool blocking) {
+    VkPipeline candidate = blocking ? manager.getPipeline(pendingState) : manager.getPipelineIfReady(pendingState);
+    if (candidate == VK_NULL_HANDLE) {
+        return false;
+    }
+    VkPipelineLayout candidateLayout = manager.getPipelineLayout(pendingState);
+    if (candidateLayout == VK_NULL_HANDLE) {
+        return false;
+    }
+    
+    // A compile finishing may have evicted another entry, which moves the generation; this handle is current
+    // for whatever generation it resolved under
+    observedPipelineGeneration = manager.getGeneration();
+    pipeline = candidate;
+    layout = candidateLayout;
+    readyState = std::move(pendingState);
+    readyKey = pendingKey;
+    pendingState = ComputePipelineState{};
+    hasPending = false;
+    return true;
+}
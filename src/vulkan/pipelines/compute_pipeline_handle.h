@@ -0,0 +1,71 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include "compute_pipeline_types.h"
+
+class ComputePipelineManager;
+class DescriptorLayoutManager;
+
+// A compute pipeline resolved once and reused by a node across frames. The node describes the variant it wants
+// with a small key (binding mode, compact layout, workgroup size, ...); the ComputePipelineState is only rebuilt
+// and looked up when the key or the pipeline/layout cache generations change, so steady-state recording neither
+// hashes nor allocates. A requested variant still compiling in the background leaves the previous ready one bound
+class ComputePipelineHandle {
+public:
+    // Current for key and the managers' generations; a stale handle is dropped first. The bound pipeline may
+    // still be a previous variant - check getKey() when the variant matters
+    template<typename BuildState>
+    bool resolve(ComputePipelineManager& manager, uint64_t key, BuildState&& buildState) {
+        invalidateIfStale(manager);
+        if (pipeline != VK_NULL_HANDLE && key == readyKey) {
+            return true;
+        }
+        if (!hasPending || key != pendingKey) {
+            pendingState = buildState();
+            pendingKey = key;
+            hasPending = true;
+        }
+        return adoptPending(manager);
+    }
+    
+    // Blocking variant for nodes that only run on demand: compiles on a miss instead of waiting for a
+    // background compile
+    template<typename BuildState>
+    bool resolveBlocking(ComputePipelineManager& manager, uint64_t key, BuildState&& buildState) {
+        invalidateIfStale(manager);
+        if (pipeline != VK_NULL_HANDLE && key == readyKey) {
+            return true;
+        }
+        pendingState = buildState();
+        pendingKey = key;
+        hasPending = true;
+        return adoptPending(manager, true);
+    }
+    
+    bool isReady() const { return pipeline != VK_NULL_HANDLE; }
+    VkPipeline getPipeline() const { return pipeline; }
+    VkPipelineLayout getLayout() const { return layout; }
+    uint64_t getKey() const { return readyKey; }
+    const ComputePipelineState& getState() const { return readyState; }
+    
+    void reset();
+
+private:
+    void invalidateIfStale(const ComputePipelineManager& manager);
+    bool adoptPending(ComputePipelineManager& manager, bool blocking = false);
+    
+    VkPipeline pipeline = VK_NULL_HANDLE;
+    VkPipelineLayout layout = VK_NULL_HANDLE;
+    ComputePipelineState readyState;
+    uint64_t readyKey = 0;
+    
+    // Requested variant not compiled yet; retried with one cache lookup per resolve
+    ComputePipelineState pendingState;
+    uint64_t pendingKey = 0;
+    bool hasPending = false;
+    
+    uint64_t observedPipelineGeneration = 0;
+    uint64_t observedLayoutGeneration = 0;
+};
@@ -1,9 +1,12 @@
 #include "compute_pipeline_manager.h"
 #include "shader_manager.h"
 #include "descriptor_layout_manager.h"
+#include "pipeline_cache_store.h"
+#include "../core/deletion_queue.h"
 #include "../core/vulkan_function_loader.h"
 #include "../core/vulkan_utils.h"
 #include "../core/vulkan_constants.h"
+#include "../../ecs/utilities/job_system.h"
 #include <iostream>
 #include <chrono>
 #include <algorithm>
@@ -23,17 +26,16 @@ ComputePipelineManager::~ComputePipelineManager() {
 }
 
 bool ComputePipelineManager::initialize(ShaderManager* shaderManager,
-                                      DescriptorLayoutManager* layoutManager) {
+                                      DescriptorLayoutManager* layoutManager,
+                                      PipelineCacheStore* cacheStore,
+                                      DeletionQueue* deletionQueue) {
     this->shaderManager_ = shaderManager;
     this->layoutManager_ = layoutManager;
+    this->cacheStore_ = cacheStore;
+    cache_.setDeletionQueue(deletionQueue);
     
     // Create pipeline cache for optimal performance
-    VkPipelineCacheCreateInfo cacheInfo{};
-    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-    cacheInfo.initialDataSize = 0;
-    cacheInfo.pInitialData = nullptr;
-    
-    pipelineCache_ = vulkan_raii::create_pipeline_cache(context, &cacheInfo);
+    pipelineCache_ = createPipelineCache();
     if (!pipelineCache_) {
         std::cerr << "Failed to create compute pipeline cache" << std::endl;
         return false;
@@ -50,7 +52,10 @@ bool ComputePipelineManager::initialize(ShaderManager* shaderManager,
         return createPipelineInternal(state);
     });
     
-    // Device properties are now handled by ComputeDeviceInfo component
+    if (!deviceInfo_.initialize()) {
+        return false;
+    }
+    workgroupTuner_.initialize(deviceInfo_, cacheStore_ ? cacheStore_->getDeviceKey() : std::string{});
     
     std::cout << "ComputePipelineManager initialized successfully" << std::endl;
     return true;
@@ -63,44 +68,99 @@ void ComputePipelineManager::cleanup() {
 void ComputePipelineManager::cleanupBeforeContextDestruction() {
     if (!context) return;
     
-    // Wait for any async compilations to complete
-    for (auto& [state, future] : asyncCompilations) {
-        if (future.valid()) {
-            future.wait();
-        }
-    }
-    asyncCompilations.clear();
-    
-    // Clear pipeline cache (RAII handles cleanup automatically)
+    // Clear pipeline cache, after any async compilations finish (RAII handles cleanup automatically)
     clearCache();
     
-    // Reset pipeline cache (RAII handles cleanup automatically)
+    // Persist what the driver compiled this run, then reset (RAII handles cleanup automatically)
+    if (cacheStore_ && pipelineCache_) {
+        cacheStore_->save("compute", pipelineCache_.get());
+    }
     pipelineCache_.reset();
     
     context = nullptr;
 }
 
 VkPipeline ComputePipelineManager::getPipeline(const ComputePipelineState& state) {
-    // Check async compilation first
-    auto asyncIt = asyncCompilations.find(state);
-    if (asyncIt != asyncCompilations.end() && asyncIt->second.valid()) {
-        if (asyncIt->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready) {
-            auto cachedPipeline = asyncIt->second.get();
-            asyncCompilations.erase(asyncIt);
-            
-            if (cachedPipeline) {
-                VkPipeline pipeline = cachedPipeline->pipeline.get();
-                cache_.insert(state, std::move(cachedPipeline));
-                return pipeline;
-            }
-        }
+    return getPipeline(state.getKey(), state);
+}
+
+VkPipeline ComputePipelineManager::getPipeline(const VulkanHash::PipelineKey& key, const ComputePipelineState& state) {
+    // A state already compiling in the background is waited for rather than compiled twice
+    if (asyncCompilations.count(key)) {
+        adoptAsyncCompilation(key);
     }
     
-    return cache_.getPipeline(state);
+    return cache_.getPipeline(key, state);
+}
+
+VkPipeline ComputePipelineManager::getPipelineIfReady(const ComputePipelineState& state) {
+    const auto key = state.getKey();
+    if (cache_.contains(key)) {
+        return cache_.getPipeline(key, state);
+    }
+    
+    if (!isAsyncCompilationComplete(key)) {
+        compileAsync(key, state);
+        return VK_NULL_HANDLE;
+    }
+    
+    adoptAsyncCompilation(key);
+    return cache_.contains(key) ? cache_.getPipeline(key, state) : VK_NULL_HANDLE;
+}
+
+bool ComputePipelineManager::compileAsync(const ComputePipelineState& state) {
+    return compileAsync(state.getKey(), state);
+}
+
+bool ComputePipelineManager::compileAsync(const VulkanHash::PipelineKey& key, const ComputePipelineState& state) {
+    if (!context || cache_.contains(key) || asyncCompilations.count(key) || failedCompilations.count(key)) {
+        return false;
+    }
+    
+    // The factory only reads shared state: shader loads are serialized by ShaderManager and the driver
+    // pipeline cache is internally synchronized
+    asyncCompilations.emplace(key, JobSystem::getInstance().async(JobPriority::Normal, [this, state]() {
+        return createPipelineInternal(state);
+    }));
+    return true;
+}
+
+bool ComputePipelineManager::isAsyncCompilationComplete(const ComputePipelineState& state) {
+    return isAsyncCompilationComplete(state.getKey());
+}
+
+bool ComputePipelineManager::isAsyncCompilationComplete(const VulkanHash::PipelineKey& key) const {
+    auto asyncIt = asyncCompilations.find(key);
+    return asyncIt != asyncCompilations.end() &&
+           asyncIt->second.wait_for(std::chrono::seconds(0)) == std::future_status::ready;
+}
+
+void ComputePipelineManager::waitForAsyncCompilations() {
+    while (!asyncCompilations.empty()) {
+        const VulkanHash::PipelineKey key = asyncCompilations.begin()->first;
+        adoptAsyncCompilation(key);
+    }
+}
+
+void ComputePipelineManager::adoptAsyncCompilation(const VulkanHash::PipelineKey& key) {
+    auto asyncIt = asyncCompilations.find(key);
+    if (asyncIt == asyncCompilations.end()) {
+        return;
+    }
+    
+    // Still queued, the compile may well run on this thread
+    JobSystem::getInstance().waitFor(asyncIt->second);
+    auto cachedPipeline = asyncIt->second.get();
+    asyncCompilations.erase(asyncIt);
+    if (cachedPipeline) {
+        cache_.insert(key, std::move(cachedPipeline));
+    } else {
+        failedCompilations.insert(key);
+    }
 }
 
 VkPipelineLayout ComputePipelineManager::getPipelineLayout(const ComputePipelineState& state) {
-    return cache_.getPipelineLayout(state);
+    return cache_.getPipelineLayout(state.getKey(), state);
 }
 
 void ComputePipelineManager::dispatch(VkCommandBuffer commandBuffer, const ComputeDispatch& dispatch) {
@@ -113,8 +173,9 @@ void ComputePipelineManager::dispatchBuffer(VkCommandBuffer commandBuffer,
                                           const std::vector<VkDescriptorSet>& descriptorSets,
                                           const void* pushConstants, 
                                           uint32_t pushConstantSize) {
-    VkPipeline pipeline = getPipeline(state);
-    VkPipelineLayout layout = getPipelineLayout(state);
+    const auto key = state.getKey();
+    VkPipeline pipeline = getPipeline(key, state);
+    VkPipelineLayout layout = cache_.getPipelineLayout(key, state);
     
     if (pipeline == VK_NULL_HANDLE || layout == VK_NULL_HANDLE) {
         std::cerr << "Failed to get compute pipeline for buffer dispatch" << std::endl;
@@ -142,8 +203,9 @@ void ComputePipelineManager::dispatchImage(VkCommandBuffer commandBuffer,
                                          const std::vector<VkDescriptorSet>& descriptorSets,
                                          const void* pushConstants,
                                          uint32_t pushConstantSize) {
-    VkPipeline pipeline = getPipeline(state);
-    VkPipelineLayout layout = getPipelineLayout(state);
+    const auto key = state.getKey();
+    VkPipeline pipeline = getPipeline(key, state);
+    VkPipelineLayout layout = cache_.getPipelineLayout(key, state);
     
     if (pipeline == VK_NULL_HANDLE || layout == VK_NULL_HANDLE) {
         std::cerr << "Failed to get compute pipeline for image dispatch" << std::endl;
@@ -180,6 +242,12 @@ std::unique_ptr<CachedComputePipeline> ComputePipelineManager::createPipelineInt
 
 void ComputePipelineManager::clearCache() {
     if (!context) return;
+    // Results of pending compiles belong to the old generation, but the jobs still use this manager
+    for (auto& [key, future] : asyncCompilations) {
+        JobSystem::getInstance().waitFor(future);
+    }
+    asyncCompilations.clear();
+    failedCompilations.clear();
     cache_.clear();
     ++generation_;
 }
@@ -198,15 +266,8 @@ bool ComputePipelineManager::recreatePipelineCache() {
     isRecreating_ = true;
     std::cout << "ComputePipelineManager: Recreating pipeline cache for swapchain resize" << std::endl;
     
-    // Wait for device idle to ensure no pipelines are in use
-    const auto& vk = context->getLoader();
-    const VkDevice device = context->getDevice();
-    vk.vkDeviceWaitIdle(device);
-    
-    // Clear async compilations to prevent race conditions
-    asyncCompilations.clear();
-    
-    // Clear caches in dependency order
+    // No device wait: pipelines frames in flight still use are retired rather than destroyed, and clearing
+    // waits out any background compile still writing into the driver cache destroyed below
     clearCache();
     
     if (layoutManager_) {
@@ -220,13 +281,8 @@ bool ComputePipelineManager::recreatePipelineCache() {
         pipelineCache_.reset();
     }
     
-    // Create new pipeline cache
-    VkPipelineCacheCreateInfo cacheInfo{};
-    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-    cacheInfo.initialDataSize = 0;
-    cacheInfo.pInitialData = nullptr;
-    
-    pipelineCache_ = vulkan_raii::create_pipeline_cache(context, &cacheInfo);
+    // Create new pipeline cache, seeded from the last blob loaded from or saved to disk
+    pipelineCache_ = createPipelineCache();
     if (!pipelineCache_) {
         std::cerr << "ComputePipelineManager: Failed to recreate pipeline cache" << std::endl;
         return false;
@@ -242,6 +298,35 @@ bool ComputePipelineManager::recreatePipelineCache() {
 }
 
 
+bool ComputePipelineManager::reloadPipeline(const ComputePipelineState& state) {
+    const auto key = state.getKey();
+    if (!hotReloadEnabled_ || !cache_.contains(key)) {
+        return false;
+    }
+    
+    // Built before the swap, so lookups never see the state missing
+    auto newPipeline = createPipelineInternal(state);
+    if (!newPipeline) {
+        std::cerr << "ComputePipelineManager: Failed to reload pipeline for " << state.shaderPath << ", keeping the old one" << std::endl;
+        return false;
+    }
+    cache_.insert(key, std::move(newPipeline));
+    ++generation_;
+    return true;
+}
+
+vulkan_raii::PipelineCache ComputePipelineManager::createPipelineCache() {
+    if (cacheStore_) {
+        return cacheStore_->createCache("compute");
+    }
+    
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = 0;
+    cacheInfo.pInitialData = nullptr;
+    return vulkan_raii::create_pipeline_cache(context, &cacheInfo);
+}
+
 glm::uvec3 ComputePipelineManager::calculateOptimalWorkgroupSize(uint32_t dataSize,
                                                                 const glm::uvec3& maxWorkgroupSize) const {
     return deviceInfo_.calculateOptimalWorkgroupSize(dataSize, maxWorkgroupSize);
@@ -292,7 +377,15 @@ ComputePipelineState ComputePipelineManager::createBufferProcessingState(const s
 
 // ComputePipelinePresets namespace implementation
 namespace ComputePipelinePresets {
-    ComputePipelineState createEntityMovementState(VkDescriptorSetLayout descriptorLayout) {
+    // ENTITY_COMPACT_LAYOUT lives at constant_id 1 so constant_id 0 keeps its per-shader meaning.
+    // The standard layout leaves the constants untouched, keeping its cache keys unchanged.
+    static void applyEntityLayout(ComputePipelineState& state, bool compactLayout) {
+        if (!compactLayout) return;
+        state.specializationConstants.resize(2, 0u);
+        state.specializationConstants[1] = 1u;
+    }
+    
+    ComputePipelineState createEntityMovementState(VkDescriptorSetLayout descriptorLayout, bool compactLayout) {
         ComputePipelineState state{};
         state.shaderPath = "shaders/movement_random.comp.spv";
         state.descriptorSetLayouts.push_back(descriptorLayout);
@@ -305,13 +398,58 @@ namespace ComputePipelinePresets {
         VkPushConstantRange pushConstant{};
         pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
         pushConstant.offset = 0;
-        pushConstant.size = sizeof(float) * 2 + sizeof(uint32_t) * 6;  // time, deltaTime, entityCount, frame, entityOffset, padding[3]
+        pushConstant.size = sizeof(float) * 2 + sizeof(uint32_t) * 4 + sizeof(uint64_t);  // time, deltaTime, entityCount, frame, entityOffset, entityStride, entityTable
         state.pushConstantRanges.push_back(pushConstant);
         
+        applyEntityLayout(state, compactLayout);
         return state;
     }
     
-    ComputePipelineState createPhysicsState(VkDescriptorSetLayout descriptorLayout) {
+    ComputePipelineState createMovementTypeState(VkDescriptorSetLayout descriptorLayout, const char* shaderPath, bool compactLayout) {
+        // Same push constants as the random walk; MOVEMENT_TYPE_LIST (constant_id 2) reads the type's list
+        ComputePipelineState state = createEntityMovementState(descriptorLayout, compactLayout);
+        state.shaderPath = shaderPath;
+        state.specializationConstants.resize(3, 0u);
+        state.specializationConstants[2] = 1u;
+        return state;
+    }
+    
+    ComputePipelineState createMovementBinState(VkDescriptorSetLayout descriptorLayout) {
+        ComputePipelineState state{};
+        state.shaderPath = "shaders/movement_bin.comp.spv";
+        state.descriptorSetLayouts.push_back(descriptorLayout);
+        state.workgroupSizeX = THREADS_PER_WORKGROUP;  // MUST match shader local_size_x
+        state.workgroupSizeY = 1;
+        state.workgroupSizeZ = 1;
+        state.isFrequentlyUsed = true;
+        
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(uint32_t) * 6 + sizeof(uint64_t);  // firstTick, tickCount, listStride, workgroupSize, dueOnly, padding, entityTable
+        state.pushConstantRanges.push_back(pushConstant);
+        return state;
+    }
+    
+    ComputePipelineState createMovementCommandsState() {
+        ComputePipelineState state{};
+        state.shaderPath = "shaders/movement_commands.comp.spv";
+        state.workgroupSizeX = 1;  // MUST match shader local_size_x
+        state.workgroupSizeY = 1;
+        state.workgroupSizeZ = 1;
+        state.isFrequentlyUsed = true;
+        
+        // Push constants must match EntityComputeNode::MovementCommandsPushConstants
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(uint64_t) * 3 + sizeof(uint32_t) * 8;  // indirectCommands, sequences, entityTable, time, tickSeconds, entityCount, firstTick, tickCount, listStride, perTickMask, padding
+        state.pushConstantRanges.push_back(pushConstant);
+        return state;
+    }
+    
+    ComputePipelineState createPhysicsState(VkDescriptorSetLayout descriptorLayout, bool fusedMovement, bool compactLayout,
+                                            bool closedFormMovement) {
         ComputePipelineState state{};
         state.shaderPath = "shaders/physics.comp.spv";
         state.descriptorSetLayouts.push_back(descriptorLayout);
@@ -324,9 +462,339 @@ namespace ComputePipelinePresets {
         VkPushConstantRange pushConstant{};
         pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
         pushConstant.offset = 0;
-        pushConstant.size = sizeof(float) * 2 + sizeof(uint32_t) * 6;  // time, deltaTime, entityCount, frame, entityOffset, padding[3]
+        pushConstant.size = sizeof(float) * 3 + sizeof(uint32_t) * 9 + sizeof(uint64_t);  // time, deltaTime, entityCount, frame, entityOffset, gridWidth, gridHeight, cellSize, collisionStride, cellOrder, idleSpeed, padding, entityTable
+        state.pushConstantRanges.push_back(pushConstant);
+        
+        // FUSED_MOVEMENT specialization constant (constant_id 0) folds movement_random.comp into physics
+        if (fusedMovement) {
+            state.specializationConstants = {1u};
+        }
+        
+        applyEntityLayout(state, compactLayout);
+        
+        // CLOSED_FORM_MOVEMENT (constant_id 2) evaluates the fused random walk's velocity rather than storing it
+        if (fusedMovement && closedFormMovement) {
+            state.specializationConstants.resize(3, 0u);
+            state.specializationConstants[2] = 1u;
+        }
+        return state;
+    }
+    
+    ComputePipelineState createPhysicsTiledState(VkDescriptorSetLayout descriptorLayout, bool fusedMovement, bool compactLayout,
+                                                 bool closedFormMovement) {
+        // Same layout and push constants as the per-entity kernel, one workgroup per grid cell
+        ComputePipelineState state = createPhysicsState(descriptorLayout, fusedMovement, compactLayout, closedFormMovement);
+        state.shaderPath = "shaders/physics_tiled.comp.spv";
+        return state;
+    }
+    
+    ComputePipelineState createEntityActiveSetState(VkDescriptorSetLayout descriptorLayout, bool fusedMovement, bool compactLayout) {
+        ComputePipelineState state{};
+        state.shaderPath = "shaders/entity_active.comp.spv";
+        state.descriptorSetLayouts.push_back(descriptorLayout);
+        state.workgroupSizeX = THREADS_PER_WORKGROUP;  // MUST match shader local_size_x
+        state.workgroupSizeY = 1;
+        state.workgroupSizeZ = 1;
+        state.isFrequentlyUsed = true;
+        
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(uint32_t) * 4 + sizeof(uint64_t);  // firstTick, tickCount, workgroupSize, padding, entityTable
+        state.pushConstantRanges.push_back(pushConstant);
+        
+        // FUSED_MOVEMENT (constant_id 0) adds the random walk's cycle ticks to what wakes a sleeper
+        if (fusedMovement) {
+            state.specializationConstants = {1u};
+        }
+        
+        applyEntityLayout(state, compactLayout);
+        return state;
+    }
+    
+    // Shared setup for spatial grid passes (push constants match SpatialGridPushConstants)
+    static ComputePipelineState createSpatialGridState(VkDescriptorSetLayout descriptorLayout,
+                                                       const char* shaderPath, uint32_t workgroupSizeX) {
+        ComputePipelineState state{};
+        state.shaderPath = shaderPath;
+        state.descriptorSetLayouts.push_back(descriptorLayout);
+        state.workgroupSizeX = workgroupSizeX;  // MUST match shader local_size_x
+        state.workgroupSizeY = 1;
+        state.workgroupSizeZ = 1;
+        state.isFrequentlyUsed = true;
+        
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(float) * 2 + sizeof(uint32_t) * 10 + sizeof(uint64_t);  // time, deltaTime, entityCount, frame, entityOffset, gridWidth, gridHeight, cellSize, entityTable, cellOrder, cellCapacity, occupancyHistogram, padding
+        state.pushConstantRanges.push_back(pushConstant);
+        
+        return state;
+    }
+    
+    ComputePipelineState createSpatialGridClearState(VkDescriptorSetLayout descriptorLayout) {
+        return createSpatialGridState(descriptorLayout, "shaders/spatial_clear.comp.spv", THREADS_PER_WORKGROUP);
+    }
+    
+    ComputePipelineState createSpatialGridCountState(VkDescriptorSetLayout descriptorLayout, bool compactLayout) {
+        ComputePipelineState state = createSpatialGridState(descriptorLayout, "shaders/spatial_count.comp.spv", THREADS_PER_WORKGROUP);
+        applyEntityLayout(state, compactLayout);
+        return state;
+    }
+    
+    ComputePipelineState createSpatialGridPrefixSumState(VkDescriptorSetLayout descriptorLayout) {
+        return createSpatialGridState(descriptorLayout, "shaders/spatial_prefix_sum.comp.spv", SPATIAL_PREFIX_SUM_THREADS);
+    }
+    
+    ComputePipelineState createSpatialGridScatterState(VkDescriptorSetLayout descriptorLayout) {
+        return createSpatialGridState(descriptorLayout, "shaders/spatial_scatter.comp.spv", THREADS_PER_WORKGROUP);
+    }
+    
+    ComputePipelineState createEntityReorderState(VkDescriptorSetLayout descriptorLayout, uint32_t phase, bool compactLayout) {
+        // Same push constant layout as the grid passes; phase selects gather (0) or apply (1)
+        ComputePipelineState state = createSpatialGridState(descriptorLayout, "shaders/entity_reorder.comp.spv", THREADS_PER_WORKGROUP);
+        state.specializationConstants = {phase};
+        state.isFrequentlyUsed = false;
+        applyEntityLayout(state, compactLayout);
+        return state;
+    }
+    
+    ComputePipelineState createEntityDespawnState(VkDescriptorSetLayout descriptorLayout, uint32_t phase, bool compactLayout) {
+        ComputePipelineState state{};
+        state.shaderPath = "shaders/entity_despawn.comp.spv";
+        state.descriptorSetLayouts.push_back(descriptorLayout);
+        state.workgroupSizeX = THREADS_PER_WORKGROUP;  // MUST match shader local_size_x
+        state.workgroupSizeY = 1;
+        state.workgroupSizeZ = 1;
+        state.specializationConstants = {phase};
+        state.isFrequentlyUsed = false;
+        
+        // Push constants must match DespawnPushConstants struct
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(uint32_t) * 2 + sizeof(uint64_t);  // entityCount, despawnCount, entityTable
+        state.pushConstantRanges.push_back(pushConstant);
+        
+        applyEntityLayout(state, compactLayout);
+        return state;
+    }
+    
+    ComputePipelineState createEntityUpdateState(VkDescriptorSetLayout descriptorLayout, bool compactLayout) {
+        ComputePipelineState state{};
+        state.shaderPath = "shaders/entity_update.comp.spv";
+        state.descriptorSetLayouts.push_back(descriptorLayout);
+        state.workgroupSizeX = THREADS_PER_WORKGROUP;  // MUST match shader local_size_x
+        state.workgroupSizeY = 1;
+        state.workgroupSizeZ = 1;
+        state.isFrequentlyUsed = false;
+        
+        // Push constants must match UpdatePushConstants struct
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(uint32_t) * 2 + sizeof(uint64_t);  // entityCount, updateCount, entityTable
+        state.pushConstantRanges.push_back(pushConstant);
+        
+        applyEntityLayout(state, compactLayout);
+        return state;
+    }
+    
+    ComputePipelineState createEntitySpawnState(VkDescriptorSetLayout descriptorLayout, uint32_t phase, bool compactLayout) {
+        ComputePipelineState state{};
+        state.shaderPath = "shaders/entity_spawn.comp.spv";
+        state.descriptorSetLayouts.push_back(descriptorLayout);
+        state.workgroupSizeX = THREADS_PER_WORKGROUP;  // MUST match shader local_size_x
+        state.workgroupSizeY = 1;
+        state.workgroupSizeZ = 1;
+        state.specializationConstants = {phase};
+        state.isFrequentlyUsed = false;
+        
+        // Push constants must match SpawnPushConstants struct
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(uint32_t) * 4 + sizeof(uint64_t);  // baseSlot, spawnCount, emitterCount, reuseCount, entityTable
+        state.pushConstantRanges.push_back(pushConstant);
+        
+        applyEntityLayout(state, compactLayout);
+        return state;
+    }
+    
+    void applyBindlessEntityTable(ComputePipelineState& state, VkDescriptorSetLayout tableLayout) {
+        // shaders/x.comp.spv -> shaders/x.bindless.comp.spv, built by compile-shaders.sh with -DENTITY_BINDLESS
+        const size_t extension = state.shaderPath.rfind(".comp.spv");
+        if (extension != std::string::npos) {
+            state.shaderPath.insert(extension, ".bindless");
+        }
+        state.descriptorSetLayouts = {tableLayout};
+    }
+    
+    void applyEntityStreamAddresses(ComputePipelineState& state) {
+        // shaders/x.comp.spv -> shaders/x.bda.comp.spv, built by compile-shaders.sh with -DENTITY_BUFFER_ADDRESS
+        const size_t extension = state.shaderPath.rfind(".comp.spv");
+        if (extension != std::string::npos) {
+            state.shaderPath.insert(extension, ".bda");
+        }
+        state.descriptorSetLayouts.clear();
+    }
+    
+    void applySubgroupBallot(ComputePipelineState& state) {
+        // shaders/x[.bindless|.bda].comp.spv -> shaders/x[.bindless|.bda].ballot.comp.spv, for the kernels
+        // compile-shaders.sh builds with -DENTITY_SUBGROUP_BALLOT: the compaction kernels, and the per-entity
+        // physics and random walk kernels for their simulation counter updates
+        static constexpr const char* ballotKernels[] = {"shaders/entity_cull.", "shaders/entity_despawn.", "shaders/entity_active.",
+                                                        "shaders/physics.", "shaders/movement_random."};
+        const size_t extension = state.shaderPath.rfind(".comp.spv");
+        for (const char* kernel : ballotKernels) {
+            if (extension != std::string::npos && state.shaderPath.rfind(kernel, 0) == 0) {
+                state.shaderPath.insert(extension, ".ballot");
+                return;
+            }
+        }
+    }
+    
+    void applyIndirectBindable(ComputePipelineState& state) {
+        state.indirectBindable = true;
+    }
+    
+    void applyWorkgroupSize(ComputePipelineState& state, uint32_t workgroupSize) {
+        if (workgroupSize == THREADS_PER_WORKGROUP) return;
+        if (state.specializationConstants.size() <= COMPUTE_WORKGROUP_SIZE_CONSTANT_ID) {
+            state.specializationConstants.resize(COMPUTE_WORKGROUP_SIZE_CONSTANT_ID + 1, 0u);
+        }
+        state.specializationConstants[COMPUTE_WORKGROUP_SIZE_CONSTANT_ID] = workgroupSize;
+        state.workgroupSizeX = workgroupSize;
+    }
+    
+    void applyShaderFeatures(ComputePipelineState& state, const ComputeShaderFeatures& features) {
+        if (state.shaderPath.rfind("shaders/physics", 0) != 0) return;
+        
+        uint32_t cellCapacity = std::max(1u, features.maxEntitiesPerCell);
+        if (state.shaderPath.rfind("shaders/physics_tiled.", 0) == 0) {
+            cellCapacity = std::min(cellCapacity, PHYSICS_TILED_MAX_ENTITIES_PER_CELL);
+        }
+        if (features.hasCollisions() && features.hasSleeping() && cellCapacity == PHYSICS_MAX_ENTITIES_PER_CELL) return;
+        
+        // Constants are passed by ID, so the ones in between need values too: the workgroup size is the
+        // state's, the others keep their zero defaults
+        if (state.specializationConstants.size() <= COMPUTE_WORKGROUP_SIZE_CONSTANT_ID) {
+            state.specializationConstants.resize(COMPUTE_WORKGROUP_SIZE_CONSTANT_ID + 1, 0u);
+            state.specializationConstants[COMPUTE_WORKGROUP_SIZE_CONSTANT_ID] = state.workgroupSizeX;
+        }
+        state.specializationConstants.resize(std::max<size_t>(state.specializationConstants.size(), COMPUTE_FEATURE_SLEEPING_CONSTANT_ID + 1), 0u);
+        state.specializationConstants[COMPUTE_FEATURE_COLLISIONS_CONSTANT_ID] = features.hasCollisions() ? 1u : 0u;
+        state.specializationConstants[COMPUTE_FEATURE_CELL_CAPACITY_CONSTANT_ID] = cellCapacity;
+        state.specializationConstants[COMPUTE_FEATURE_SLEEPING_CONSTANT_ID] = features.hasSleeping() ? 1u : 0u;
+    }
+    
+    ComputePipelineState createFrustumCullingState(VkDescriptorSetLayout descriptorLayout, bool expandedDraw, bool gridOrder,
+                                                   bool shapeBinning) {
+        ComputePipelineState state{};
+        state.shaderPath = "shaders/entity_cull.comp.spv";
+        if (expandedDraw || gridOrder || shapeBinning) {
+            state.specializationConstants = {0u, 0u, expandedDraw ? 1u : 0u};
+        }
+        if (gridOrder || shapeBinning) {
+            state.specializationConstants.push_back(gridOrder ? 1u : 0u);
+        }
+        if (shapeBinning) {
+            state.specializationConstants.push_back(1u);
+        }
+        state.descriptorSetLayouts.push_back(descriptorLayout);
+        state.workgroupSizeX = THREADS_PER_WORKGROUP;  // MUST match shader local_size_x
+        state.workgroupSizeY = 1;
+        state.workgroupSizeZ = 1;
+        state.isFrequentlyUsed = true;
+        
+        // Push constants must match CullingPushConstants struct
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(float) * 4 * 6 + sizeof(uint32_t) * 4 + sizeof(uint64_t);  // planes[6], entityCount, radius, entityTable, densityTiles, viewportPass
+        state.pushConstantRanges.push_back(pushConstant);
+        
+        return state;
+    }
+    
+    ComputePipelineState createEntityBinningState(VkDescriptorSetLayout descriptorLayout) {
+        // Same push constant range as culling, so either pipeline takes the pushed CullingPushConstants
+        ComputePipelineState state = createFrustumCullingState(descriptorLayout);
+        state.shaderPath = "shaders/entity_bin.comp.spv";
+        return state;
+    }
+    
+    ComputePipelineState createEntityBoundsState(VkDescriptorSetLayout descriptorLayout) {
+        ComputePipelineState state{};
+        state.shaderPath = "shaders/entity_bounds.comp.spv";
+        state.descriptorSetLayouts.push_back(descriptorLayout);
+        state.workgroupSizeX = THREADS_PER_WORKGROUP;  // MUST match shader local_size_x
+        state.workgroupSizeY = 1;
+        state.workgroupSizeZ = 1;
+        state.isFrequentlyUsed = true;
+        
+        // Push constants must match BoundsPushConstants struct
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(uint64_t);  // entityTable
+        state.pushConstantRanges.push_back(pushConstant);
+        
+        return state;
+    }
+    
+    ComputePipelineState createCaptureYuvState(VkDescriptorSetLayout descriptorLayout) {
+        ComputePipelineState state{};
+        state.shaderPath = "shaders/capture_yuv.comp.spv";
+        state.descriptorSetLayouts.push_back(descriptorLayout);
+        state.workgroupSizeX = 16;  // MUST match shader local_size_x
+        state.workgroupSizeY = 4;
+        state.workgroupSizeZ = 1;
+        
+        // Push constants must match CapturePushConstants struct
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(uint32_t) * 4;  // width, height, planar, swapRedBlue
+        state.pushConstantRanges.push_back(pushConstant);
+        
+        return state;
+    }
+    
+    ComputePipelineState createOverdrawHistogramState(VkDescriptorSetLayout descriptorLayout) {
+        ComputePipelineState state{};
+        state.shaderPath = "shaders/overdraw_histogram.comp.spv";
+        state.descriptorSetLayouts.push_back(descriptorLayout);
+        state.workgroupSizeX = 16;  // MUST match shader local_size_x
+        state.workgroupSizeY = 16;
+        state.workgroupSizeZ = 1;
+        
+        // Push constants must match HistogramPushConstants struct
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(uint32_t) * 2;  // width, height
+        state.pushConstantRanges.push_back(pushConstant);
+        
+        return state;
+    }
+    
+    ComputePipelineState createSpatialQueryState(VkDescriptorSetLayout descriptorLayout, bool compactLayout) {
+        ComputePipelineState state{};
+        state.shaderPath = "shaders/spatial_query.comp.spv";
+        state.descriptorSetLayouts.push_back(descriptorLayout);
+        state.workgroupSizeX = THREADS_PER_WORKGROUP;  // MUST match shader local_size_x
+        state.workgroupSizeY = 1;
+        state.workgroupSizeZ = 1;
+        
+        // Push constants must match SpatialQueryPushConstants struct
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(uint32_t) * 6 + sizeof(uint64_t);  // queryCount, grid dimensions, cellSize, entityTable, cellOrder, padding
         state.pushConstantRanges.push_back(pushConstant);
         
+        applyEntityLayout(state, compactLayout);
         return state;
     }
 }
@@ -353,6 +821,8 @@ ComputePipelineManager::ComputeStats ComputePipelineManager::getStats() const {
     stats.totalDispatches = dispatchStats.totalDispatches;
     stats.totalCompilationTime = cacheStats.totalCompilationTime;
     stats.hitRatio = cacheStats.hitRatio;
+    stats.maxRegisters = cacheStats.maxRegisters;
+    stats.spillingPipelines = cacheStats.spillingPipelines;
     
     return stats;
 }
@@ -5,6 +5,7 @@
 #include <vector>
 #include <string>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <chrono>
 #include <functional>
@@ -19,23 +20,36 @@
 #include "compute_pipeline_factory.h"
 #include "compute_dispatcher.h"
 #include "compute_device_info.h"
+#include "compute_workgroup_tuner.h"
 
 class ShaderManager;
 class DescriptorLayoutManager;
+class PipelineCacheStore;
+class DeletionQueue;
 
 class ComputePipelineManager : public VulkanManagerBase {
 public:
     explicit ComputePipelineManager(VulkanContext* ctx);
     ~ComputePipelineManager();
 
+    // cacheStore (optional) seeds the driver pipeline cache from disk and receives it back at cleanup;
+    // deletionQueue (optional) receives evicted and replaced pipelines instead of destroying them in place
     bool initialize(ShaderManager* shaderManager,
-                   DescriptorLayoutManager* layoutManager);
+                   DescriptorLayoutManager* layoutManager,
+                   PipelineCacheStore* cacheStore = nullptr,
+                   DeletionQueue* deletionQueue = nullptr);
     void cleanup();
     void cleanupBeforeContextDestruction();
 
+    // Blocking: compiles on a miss, or waits for the state's background compile
     VkPipeline getPipeline(const ComputePipelineState& state);
     VkPipelineLayout getPipelineLayout(const ComputePipelineState& state);
     
+    // Non-blocking, for per-frame lookups: adopts a finished background compile or queues one and returns
+    // VK_NULL_HANDLE, in which case the caller skips its work this frame. A failed compile is not retried
+    // until clearCache()
+    VkPipeline getPipelineIfReady(const ComputePipelineState& state);
+    
     std::vector<VkPipeline> createPipelinesBatch(const std::vector<ComputePipelineState>& states);
     
     void dispatch(VkCommandBuffer commandBuffer, const ComputeDispatch& dispatch);
@@ -62,12 +76,20 @@ public:
     void optimizeCache(uint64_t currentFrame);
     void clearCache();
     
-    // Pipeline cache recreation for swapchain resize operations
+    // Pipeline cache recreation for swapchain resize operations; the GPU keeps running, with the old
+    // pipelines retired to the deletion queue
     bool recreatePipelineCache();
     
-    // Async compilation for hot reloading
+    // Rebuilds a cached state (e.g. after its shader changed) and swaps the result in; the old pipeline stays
+    // alive for frames in flight. Bumps the generation so dependents refetch the layout
+    bool reloadPipeline(const ComputePipelineState& state);
+    void enableHotReload(bool enable) { hotReloadEnabled_ = enable; }
+    
+    // Background compilation on a worker thread; false when the state is already cached, compiling or failed
     bool compileAsync(const ComputePipelineState& state);
     bool isAsyncCompilationComplete(const ComputePipelineState& state);
+    size_t getPendingCompilationCount() const { return asyncCompilations.size(); }
+    void waitForAsyncCompilations();
     
     // Performance profiling
     struct ComputeProfileData {
@@ -90,14 +112,18 @@ public:
         uint64_t totalDispatches = 0;
         std::chrono::nanoseconds totalCompilationTime{0};
         float hitRatio = 0.0f;
+        uint32_t maxRegisters = 0;       // Highest register count of any cached pipeline (executable statistics)
+        uint32_t spillingPipelines = 0;
     };
     
     ComputeStats getStats() const;
+    // Cached pipelines with captured executable statistics, appended in no particular order
+    void collectExecutableReports(std::vector<PipelineExecutableReport>& reports) const { cache_.collectExecutableReports(reports); }
     void resetFrameStats();
     void debugPrintCache() const;
 
-    // Cache generation for dependents to detect invalidation
-    uint64_t getGeneration() const { return generation_; }
+    // Cache generation for dependents to detect invalidation; evictions count too
+    uint64_t getGeneration() const { return generation_ + cache_.getEvictionCount(); }
     
     // Workgroup optimization
     glm::uvec3 calculateOptimalWorkgroupSize(uint32_t dataSize, 
@@ -109,6 +135,11 @@ public:
     ComputePipelineFactory* getFactory() { return &factory_; }
     ComputeDispatcher* getDispatcher() { return &dispatcher_; }
     ComputeDeviceInfo* getDeviceInfo() { return &deviceInfo_; }
+    ComputeWorkgroupTuner* getWorkgroupTuner() { return &workgroupTuner_; }
+    
+    // Physics shader permutation the nodes select for the next frames they record
+    void setShaderFeatures(const ComputeShaderFeatures& features) { shaderFeatures_ = features; }
+    const ComputeShaderFeatures& getShaderFeatures() const { return shaderFeatures_; }
     
     // Memory barrier optimization
     void insertOptimalBarriers(VkCommandBuffer commandBuffer, 
@@ -124,12 +155,15 @@ public:
 private:
     // Core Vulkan objects
     vulkan_raii::PipelineCache pipelineCache_;
+    PipelineCacheStore* cacheStore_ = nullptr;
+    vulkan_raii::PipelineCache createPipelineCache();
     
     // Dependencies
     ShaderManager* shaderManager_ = nullptr;
     DescriptorLayoutManager* layoutManager_ = nullptr;
     
     // State management
+    bool hotReloadEnabled_ = false;
     bool isRecreating_ = false;  // Synchronization for cache recreation
     
     // Focused components
@@ -137,15 +171,23 @@ private:
     ComputePipelineFactory factory_;
     ComputeDispatcher dispatcher_;
     ComputeDeviceInfo deviceInfo_;
+    ComputeWorkgroupTuner workgroupTuner_;
+    ComputeShaderFeatures shaderFeatures_;
 
     // Monotonic generation counter incremented on cache clear/recreate
     uint64_t generation_ = 0;
     
-    // Async compilation tracking
-    std::unordered_map<ComputePipelineState, std::future<std::unique_ptr<CachedComputePipeline>>, ComputePipelineStateHash> asyncCompilations;
+    // Async compilation tracking; results are adopted into cache_ on the calling thread only
+    // Keyed by ComputePipelineState::getKey(); public entry points build it once and pass it down
+    std::unordered_map<VulkanHash::PipelineKey, std::future<std::unique_ptr<CachedComputePipeline>>, VulkanHash::PipelineKeyHash> asyncCompilations;
+    std::unordered_set<VulkanHash::PipelineKey, VulkanHash::PipelineKeyHash> failedCompilations;
+    void adoptAsyncCompilation(const VulkanHash::PipelineKey& key);
+    VkPipeline getPipeline(const VulkanHash::PipelineKey& key, const ComputePipelineState& state);
+    bool compileAsync(const VulkanHash::PipelineKey& key, const ComputePipelineState& state);
+    bool isAsyncCompilationComplete(const VulkanHash::PipelineKey& key) const;
     
     // Performance tracking
-    std::unordered_map<ComputePipelineState, ComputeProfileData, ComputePipelineStateHash> profileData;
+    std::unordered_map<VulkanHash::PipelineKey, ComputeProfileData, VulkanHash::PipelineKeyHash> profileData;
     
     // Configuration
     uint32_t maxCacheSize_ = DEFAULT_COMPUTE_CACHE_SIZE;
@@ -159,18 +201,96 @@ private:
 };
 
 // Utility functions for common compute patterns
+// Presets reading entity SoA streams take compactLayout (ENTITY_COMPACT_LAYOUT specialization, constant_id 1)
 namespace ComputePipelinePresets {
     // Entity movement computation (for your use case)
-    ComputePipelineState createEntityMovementState(VkDescriptorSetLayout descriptorLayout);
+    ComputePipelineState createEntityMovementState(VkDescriptorSetLayout descriptorLayout, bool compactLayout = false);
+    
+    // One MovementType's kernel, run over the index list movement_bin.comp builds for it (movement type dispatch)
+    ComputePipelineState createMovementTypeState(VkDescriptorSetLayout descriptorLayout, const char* shaderPath, bool compactLayout = false);
+    
+    // Per-type index lists and indirect dispatches ahead of the movement type kernels
+    ComputePipelineState createMovementBinState(VkDescriptorSetLayout descriptorLayout);
+    
+    // One invocation writing the movement type kernels' generated command sequences; buffer addresses only, no sets
+    ComputePipelineState createMovementCommandsState();
+    
+    // Physics computation (velocity-based position updates), optionally fused with movement, whose velocity the
+    // closed-form variant evaluates instead of storing
+    ComputePipelineState createPhysicsState(VkDescriptorSetLayout descriptorLayout, bool fusedMovement = false, bool compactLayout = false,
+                                            bool closedFormMovement = false);
+    
+    // Physics with shared-memory tiles (one workgroup per grid cell plus halo)
+    ComputePipelineState createPhysicsTiledState(VkDescriptorSetLayout descriptorLayout, bool fusedMovement = false, bool compactLayout = false,
+                                                 bool closedFormMovement = false);
+    
+    // Awake entity compaction ahead of the per-entity physics kernel (sleeping), with its random walk schedule
+    ComputePipelineState createEntityActiveSetState(VkDescriptorSetLayout descriptorLayout, bool fusedMovement = false, bool compactLayout = false);
+    
+    // Spatial grid counting sort passes (clear, count, prefix sum, scatter)
+    ComputePipelineState createSpatialGridClearState(VkDescriptorSetLayout descriptorLayout);
+    ComputePipelineState createSpatialGridCountState(VkDescriptorSetLayout descriptorLayout, bool compactLayout = false);
+    ComputePipelineState createSpatialGridPrefixSumState(VkDescriptorSetLayout descriptorLayout);
+    ComputePipelineState createSpatialGridScatterState(VkDescriptorSetLayout descriptorLayout);
+    
+    // Periodic entity reorder into grid cell order (phase 0 = gather, 1 = apply)
+    ComputePipelineState createEntityReorderState(VkDescriptorSetLayout descriptorLayout, uint32_t phase, bool compactLayout = false);
+    
+    // Swap-with-last despawn compaction (phase 0 = mark, 1 = classify, 2 = move)
+    ComputePipelineState createEntityDespawnState(VkDescriptorSetLayout descriptorLayout, uint32_t phase, bool compactLayout = false);
     
-    // Physics computation (velocity-based position updates)
-    ComputePipelineState createPhysicsState(VkDescriptorSetLayout descriptorLayout);
+    // Sparse entity updates, one thread per record
+    ComputePipelineState createEntityUpdateState(VkDescriptorSetLayout descriptorLayout, bool compactLayout = false);
+    
+    // GPU entity spawning from emitter records (phase 0 = collect tombstones, 1 = spawn)
+    ComputePipelineState createEntitySpawnState(VkDescriptorSetLayout descriptorLayout, uint32_t phase, bool compactLayout = false);
     
     // Particle system update
     ComputePipelineState createParticleUpdateState(VkDescriptorSetLayout descriptorLayout);
     
-    // Frustum culling
-    ComputePipelineState createFrustumCullingState(VkDescriptorSetLayout descriptorLayout);
+    // Frustum culling; expandedDraw counts visible entities into the vertex count of one instance (constant_id 2),
+    // gridOrder walks entities in spatial grid cell order (constant_id 3), shapeBinning counts them per shape and
+    // leaves the list for createEntityBinningState (constant_id 4)
+    ComputePipelineState createFrustumCullingState(VkDescriptorSetLayout descriptorLayout, bool expandedDraw = false,
+                                                   bool gridOrder = false, bool shapeBinning = false);
+    
+    // Groups the shape-binned culling list by shape and sets the per-shape draws, after the culling pass
+    ComputePipelineState createEntityBinningState(VkDescriptorSetLayout descriptorLayout);
+    
+    // Live entity AABB, centroid and count in one dispatch of ENTITY_BOUNDS_WORKGROUPS workgroups
+    ComputePipelineState createEntityBoundsState(VkDescriptorSetLayout descriptorLayout);
+    
+    // Recording colour conversion of the captured frame to YUV 4:2:0, 8x2 pixels per invocation (VideoRecorder's layout)
+    ComputePipelineState createCaptureYuvState(VkDescriptorSetLayout descriptorLayout);
+    
+    // Overdraw histogram of the entity pass's count image, one 16x16 pixel tile per workgroup (OverdrawMonitor's layout)
+    ComputePipelineState createOverdrawHistogramState(VkDescriptorSetLayout descriptorLayout);
+    
+    // Batched radius / nearest queries over the frame's spatial grid, one invocation per query
+    ComputePipelineState createSpatialQueryState(VkDescriptorSetLayout descriptorLayout, bool compactLayout = false);
+    
+    // Retargets an entity preset at the bindless table: .bindless shader variant, table layout at set 0.
+    // Push constants are unchanged - every entity shader declares entityTable in all variants
+    void applyBindlessEntityTable(ComputePipelineState& state, VkDescriptorSetLayout tableLayout);
+    
+    // Retargets an entity preset at the stream address table: .bda shader variant, no descriptor set layouts
+    void applyEntityStreamAddresses(ComputePipelineState& state);
+    
+    // Retargets a compaction preset (frustum culling, despawn, active set) at its .ballot shader variant, after the binding mode
+    // helpers above; states without a ballot variant are left untouched
+    void applySubgroupBallot(ComputePipelineState& state);
+    
+    // Marks a preset bindable from a device-generated commands execution set (VulkanContext::supportsDeviceGeneratedCommands);
+    // its own cache entry, as the pipeline is created with VK_PIPELINE_CREATE_2_INDIRECT_BINDABLE_BIT_EXT
+    void applyIndirectBindable(ComputePipelineState& state);
+    
+    // Runs a movement or physics preset at workgroupSize (local_size_x_id = COMPUTE_WORKGROUP_SIZE_CONSTANT_ID);
+    // THREADS_PER_WORKGROUP leaves the state untouched
+    void applyWorkgroupSize(ComputePipelineState& state, uint32_t workgroupSize);
+    
+    // Specializes a physics preset for features (COMPUTE_FEATURE_*_CONSTANT_ID), before applyWorkgroupSize;
+    // the default features and non-physics states are left untouched
+    void applyShaderFeatures(ComputePipelineState& state, const ComputeShaderFeatures& features);
     
     // GPU sorting algorithms
     ComputePipelineState createRadixSortState(VkDescriptorSetLayout descriptorLayout);
@@ -1,46 +1,23 @@
 #include "compute_pipeline_types.h"
-#include "hash_utils.h"
 #include <cmath>
 
 // ComputePipelineState implementation
-bool ComputePipelineState::operator==(const ComputePipelineState& other) const {
-    // Manual comparison for pushConstantRanges since VkPushConstantRange doesn't have operator==
-    if (pushConstantRanges.size() != other.pushConstantRanges.size()) {
-        return false;
-    }
-    for (size_t i = 0; i < pushConstantRanges.size(); ++i) {
-        const auto& a = pushConstantRanges[i];
-        const auto& b = other.pushConstantRanges[i];
-        if (a.stageFlags != b.stageFlags || a.offset != b.offset || a.size != b.size) {
-            return false;
-        }
-    }
-    
-    return shaderPath == other.shaderPath &&
-           specializationConstants == other.specializationConstants &&
-           descriptorSetLayouts == other.descriptorSetLayouts &&
-           workgroupSizeX == other.workgroupSizeX &&
-           workgroupSizeY == other.workgroupSizeY &&
-           workgroupSizeZ == other.workgroupSizeZ;
-}
-
-size_t ComputePipelineState::getHash() const {
-    VulkanHash::HashCombiner hasher;
-    
-    hasher.combine(shaderPath)
-          .combineContainer(specializationConstants)
-          .combineContainer(descriptorSetLayouts)
-          .combine(workgroupSizeX)
-          .combine(workgroupSizeY)
-          .combine(workgroupSizeZ);
-    
+VulkanHash::PipelineKey ComputePipelineState::getKey() const {
+    VulkanHash::PipelineKeyBuilder builder;
+    builder.add(shaderPath)
+           .addContainer(specializationConstants)
+           .addContainer(descriptorSetLayouts)
+           .add(workgroupSizeX)
+           .add(workgroupSizeY)
+           .add(workgroupSizeZ)
+           .add(static_cast<uint32_t>(indirectBindable))
+           .add(static_cast<uint32_t>(pushConstantRanges.size()));
     for (const auto& range : pushConstantRanges) {
-        hasher.combine(range.stageFlags)
-              .combine(range.offset)
-              .combine(range.size);
+        builder.add(range.stageFlags)
+               .add(range.offset)
+               .add(range.size);
     }
-    
-    return hasher.get();
+    return builder.build();
 }
 
 // ComputeDispatch implementation
@@ -8,6 +8,25 @@
 #include <chrono>
 #include <glm/glm.hpp>
 #include "../core/vulkan_raii.h"
+#include "../core/vulkan_constants.h"
+#include "hash_utils.h"
+#include "pipeline_utils.h"
+
+// Shader permutation of the physics kernels, chosen per frame. ComputePipelinePresets::applyShaderFeatures
+// turns it into specialization constants, so each combination is its own cached pipeline and the driver
+// compiles disabled features out rather than branching around them
+struct ComputeShaderFeatures {
+    static constexpr uint32_t COLLISIONS = 1u << 0;
+    static constexpr uint32_t SLEEPING = 1u << 1;   // Stationary entities leave the physics dispatch until woken
+    
+    uint32_t flags = COLLISIONS | SLEEPING;
+    uint32_t maxEntitiesPerCell = PHYSICS_MAX_ENTITIES_PER_CELL;
+    uint32_t collisionStride = PHYSICS_COLLISION_STRIDE;  // Push constant, not part of the permutation (0 = adaptive)
+    
+    bool hasCollisions() const { return (flags & COLLISIONS) != 0; }
+    bool hasSleeping() const { return (flags & SLEEPING) != 0; }
+    bool operator==(const ComputeShaderFeatures& other) const = default;
+};
 
 // Compute Pipeline State Object for caching
 struct ComputePipelineState {
@@ -26,20 +45,16 @@ struct ComputePipelineState {
     uint32_t workgroupSizeY = 1;
     uint32_t workgroupSizeZ = 1;
     
+    // Bindable from an indirect execution set by device-generated commands (ComputePipelinePresets::applyIndirectBindable)
+    bool indirectBindable = false;
+    
     // Performance hints
     bool isFrequentlyUsed = false;  // Hot path optimization
     bool allowAsyncCompilation = true;  // Background compilation
     
-    // Comparison for caching
-    bool operator==(const ComputePipelineState& other) const;
-    size_t getHash() const;
-};
-
-// Hash specialization for compute PSO caching
-struct ComputePipelineStateHash {
-    std::size_t operator()(const ComputePipelineState& state) const {
-        return state.getHash();
-    }
+    // Interned cache key over everything but the hints; caches build it once per lookup
+    VulkanHash::PipelineKey getKey() const;
+    bool operator==(const ComputePipelineState& other) const { return getKey() == other.getKey(); }
 };
 
 // Cached compute pipeline with metadata
@@ -55,6 +70,7 @@ struct CachedComputePipeline {
     // Performance metrics
     std::chrono::nanoseconds compilationTime{0};
     bool isHotPath = false;
+    PipelineExecutableStats executableStats;  // Uncaptured without VK_KHR_pipeline_executable_properties
     
     // Dispatch optimization data
     struct DispatchInfo {
@@ -74,9 +90,15 @@ struct ComputeDispatch {
     uint32_t groupCountY = 1;
     uint32_t groupCountZ = 1;
     
-    // Descriptor sets
+    // Descriptor sets, bound from set 0
     std::vector<VkDescriptorSet> descriptorSets;
     
+    // Bindings pushed into pushDescriptorSet (a DescriptorLayoutSpec::pushDescriptor layout, numbered after the
+    // bound sets) right before the dispatch, so the pass allocates no set. dstSet is ignored; the infos the writes
+    // point at only need to outlive dispatch()
+    uint32_t pushDescriptorSet = 0;
+    std::vector<VkWriteDescriptorSet> pushDescriptorWrites;
+    
     // Push constants
     const void* pushConstantData = nullptr;
     uint32_t pushConstantSize = 0;
@@ -0,0 +1,128 @@
+#include "compute_workgroup_tuner.h"
+#include "compute_device_info.h"
+#include "../core/vulkan_constants.h"
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <iostream>
+
+void ComputeWorkgroupTuner::initialize(const ComputeDeviceInfo& deviceInfo, const std::string& deviceKey) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    candidates_ = deviceInfo.getWorkgroupSizeCandidates();
+    kernels_.clear();
+    enabled_ = ENABLE_WORKGROUP_SIZE_TUNING && candidates_.size() > 1;
+    path_ = deviceKey.empty() ? std::string{}
+        : (std::filesystem::path(PIPELINE_CACHE_DIRECTORY) / ("workgroup_sizes_" + deviceKey + ".txt")).string();
+    
+    if (enabled_) {
+        load();
+    }
+}
+
+uint32_t ComputeWorkgroupTuner::getWorkgroupSize(const std::string& kernel) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!enabled_) {
+        return THREADS_PER_WORKGROUP;
+    }
+    
+    const KernelTuning& tuning = kernels_[kernel];
+    return tuning.chosenSize != 0 ? tuning.chosenSize : candidates_[tuning.trial];
+}
+
+void ComputeWorkgroupTuner::reportWindow(const std::string& kernel, uint32_t workgroupSize, float averageMs, uint32_t workloadSize) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    if (!enabled_) {
+        return;
+    }
+    
+    KernelTuning& tuning = kernels_[kernel];
+    // Also skips windows run on the fallback pipeline while the candidate's was compiling
+    if (tuning.chosenSize != 0 || workgroupSize != candidates_[tuning.trial]) {
+        return;
+    }
+    
+    // Times are only comparable at one workload; a change of more than 2% restarts the trials
+    const uint32_t difference = workloadSize > tuning.workloadSize ? workloadSize - tuning.workloadSize
+                                                                   : tuning.workloadSize - workloadSize;
+    if (tuning.workloadSize == 0 || difference > tuning.workloadSize / 50) {
+        tuning.workloadSize = workloadSize;
+        tuning.trial = 0;
+        tuning.settled = false;
+        tuning.trialMs.clear();
+        return;
+    }
+    
+    if (!tuning.settled) {
+        tuning.settled = true;
+        return;
+    }
+    tuning.trialMs.push_back(averageMs);
+    tuning.settled = false;
+    if (++tuning.trial < candidates_.size()) {
+        return;
+    }
+    
+    const size_t best = std::min_element(tuning.trialMs.begin(), tuning.trialMs.end()) - tuning.trialMs.begin();
+    tuning.chosenSize = candidates_[best];
+    
+    std::cout << "ComputeWorkgroupTuner: '" << kernel << "' at " << workloadSize << " items:";
+    for (size_t i = 0; i < candidates_.size(); ++i) {
+        std::cout << " " << candidates_[i] << "=" << tuning.trialMs[i] << "ms";
+    }
+    std::cout << " -> local_size_x " << tuning.chosenSize << std::endl;
+    save();
+}
+
+bool ComputeWorkgroupTuner::isTuned(const std::string& kernel) const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    auto it = kernels_.find(kernel);
+    return !enabled_ || (it != kernels_.end() && it->second.chosenSize != 0);
+}
+
+void ComputeWorkgroupTuner::load() {
+    if (path_.empty()) {
+        return;
+    }
+    std::ifstream file(path_);
+    if (!file.is_open()) {
+        return;
+    }
+    
+    // One "kernel size" pair per line; sizes the device no longer offers are tuned again
+    std::string kernel;
+    uint32_t size = 0;
+    while (file >> kernel >> size) {
+        if (std::find(candidates_.begin(), candidates_.end(), size) != candidates_.end()) {
+            kernels_[kernel].chosenSize = size;
+            std::cout << "ComputeWorkgroupTuner: '" << kernel << "' uses local_size_x " << size << " from " << path_ << std::endl;
+        }
+    }
+}
+
+void ComputeWorkgroupTuner::save() const {
+    if (path_.empty()) {
+        return;
+    }
+    
+    // Same write-and-rename as PipelineCacheStore, so an interrupted save keeps the previous choices
+    std::error_code error;
+    std::filesystem::create_directories(PIPELINE_CACHE_DIRECTORY, error);
+    const std::string tempPath = path_ + ".tmp";
+    {
+        std::ofstream file(tempPath, std::ios::trunc);
+        for (const auto& [kernel, tuning] : kernels_) {
+            if (tuning.chosenSize != 0) {
+                file << kernel << " " << tuning.chosenSize << "\n";
+            }
+        }
+        if (!file) {
+            std::cerr << "ComputeWorkgroupTuner: Failed to write " << tempPath << std::endl;
+            return;
+        }
+    }
+    std::filesystem::rename(tempPath, path_, error);
+    if (error) {
+        std::cerr << "ComputeWorkgroupTuner: Failed to replace " << path_ << ": " << error.message() << std::endl;
+        std::filesystem::remove(tempPath, error);
+    }
+}
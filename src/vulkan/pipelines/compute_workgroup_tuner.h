@@ -0,0 +1,47 @@
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <mutex>
+
+class ComputeDeviceInfo;
+
+// Picks local_size_x for the per-entity kernels (local_size_x_id = COMPUTE_WORKGROUP_SIZE_CONSTANT_ID) per
+// device, timing each ComputeDeviceInfo candidate on the live workload through its node's GPU timestamps.
+// A candidate runs for two timing windows, the first letting the rolling window drain the previous size's
+// samples, and only windows whose workload stayed the same size count. The fastest average wins and is
+// written to PIPELINE_CACHE_DIRECTORY/workgroup_sizes_<device>.txt, so later runs start on it
+class ComputeWorkgroupTuner {
+public:
+    // An empty deviceKey tunes without persisting; with ENABLE_WORKGROUP_SIZE_TUNING off every kernel
+    // stays at THREADS_PER_WORKGROUP
+    void initialize(const ComputeDeviceInfo& deviceInfo, const std::string& deviceKey);
+    
+    // Size the kernel runs at now: its chosen size, or the candidate on trial
+    uint32_t getWorkgroupSize(const std::string& kernel);
+    
+    // One full node timing window, measured while the kernel ran at workgroupSize over workloadSize items
+    void reportWindow(const std::string& kernel, uint32_t workgroupSize, float averageMs, uint32_t workloadSize);
+    
+    bool isTuned(const std::string& kernel) const;
+
+private:
+    struct KernelTuning {
+        uint32_t chosenSize = 0;         // 0 while trials run
+        size_t trial = 0;                // Index into candidates_
+        bool settled = false;            // The current candidate's draining window has passed
+        uint32_t workloadSize = 0;       // Workload the trials are compared at
+        std::vector<float> trialMs;
+    };
+    
+    void load();
+    void save() const;
+    
+    std::vector<uint32_t> candidates_;
+    std::unordered_map<std::string, KernelTuning> kernels_;
+    std::string path_;
+    bool enabled_ = false;
+    mutable std::mutex mutex_;  // Compute nodes may record on separate lanes
+};
@@ -1,6 +1,8 @@
 #include "descriptor_layout_manager.h"
 #include "../core/vulkan_function_loader.h"
+#include "../core/vulkan_debug_labels.h"
 #include "hash_utils.h"
+#include "../../ecs/gpu/entity_stream_schema.h"
 #include <iostream>
 #include <algorithm>
 #include <cassert>
@@ -17,18 +19,14 @@ bool DescriptorBinding::operator==(const DescriptorBinding& other) const {
            immutableSamplers == other.immutableSamplers;
 }
 
-size_t DescriptorBinding::getHash() const {
-    VulkanHash::HashCombiner hasher;
-    
-    hasher.combine(binding)
-          .combine(type)
-          .combine(descriptorCount)
-          .combine(stageFlags)
-          .combine(isBindless)
-          .combine(maxBindlessDescriptors)
-          .combineContainer(immutableSamplers);
-    
-    return hasher.get();
+void DescriptorBinding::appendKey(VulkanHash::PipelineKeyBuilder& builder) const {
+    builder.add(binding)
+           .add(type)
+           .add(descriptorCount)
+           .add(stageFlags)
+           .add(isBindless)
+           .add(maxBindlessDescriptors)
+           .addContainer(immutableSamplers);
 }
 
 // DescriptorLayoutSpec implementation
@@ -37,22 +35,25 @@ bool DescriptorLayoutSpec::operator==(const DescriptorLayoutSpec& other) const {
            flags == other.flags &&
            enableBindless == other.enableBindless &&
            enableUpdateAfterBind == other.enableUpdateAfterBind &&
-           enablePartiallyBound == other.enablePartiallyBound;
+           enablePartiallyBound == other.enablePartiallyBound &&
+           pushDescriptor == other.pushDescriptor;
 }
 
-size_t DescriptorLayoutSpec::getHash() const {
-    VulkanHash::HashCombiner hasher;
+VulkanHash::PipelineKey DescriptorLayoutSpec::getKey() const {
+    VulkanHash::PipelineKeyBuilder builder;
     
+    builder.add(static_cast<uint32_t>(bindings.size()));
     for (const auto& binding : bindings) {
-        hasher.combine(binding.getHash());
+        binding.appendKey(builder);
     }
     
-    hasher.combine(flags)
-          .combine(enableBindless)
-          .combine(enableUpdateAfterBind)
-          .combine(enablePartiallyBound);
+    builder.add(flags)
+           .add(enableBindless)
+           .add(enableUpdateAfterBind)
+           .add(enablePartiallyBound)
+           .add(pushDescriptor);
     
-    return hasher.get();
+    return builder.build();
 }
 
 // DescriptorLayoutManager implementation
@@ -110,7 +111,8 @@ void DescriptorLayoutManager::cleanupBeforeContextDestruction() {
 
 VkDescriptorSetLayout DescriptorLayoutManager::getLayout(const DescriptorLayoutSpec& spec) {
     // Check cache first
-    auto it = layoutCache_.find(spec);
+    const auto key = spec.getKey();
+    auto it = layoutCache_.find(key);
     if (it != layoutCache_.end()) {
         // Cache hit
         stats.cacheHits++;
@@ -131,7 +133,7 @@ VkDescriptorSetLayout DescriptorLayoutManager::getLayout(const DescriptorLayoutS
     VkDescriptorSetLayout layout = cachedLayout->layout.get();
     
     // Store in cache
-    layoutCache_[spec] = std::move(cachedLayout);
+    layoutCache_[key] = std::move(cachedLayout);
     stats.totalLayouts++;
     
     if (spec.enableBindless) {
@@ -171,12 +173,95 @@ std::unique_ptr<CachedDescriptorLayout> DescriptorLayoutManager::createLayoutInt
     }
     cachedLayout->layout = vulkan_raii::make_descriptor_set_layout(rawLayout, context_);
     
+    // Layouts are shared by key, which ignores names, so the capture shows the first spec's
+    if constexpr (VULKAN_DEBUG_LABELS_ENABLED) {
+        std::string name = spec.layoutName;
+        for (size_t i = 0; i < spec.bindings.size(); ++i) {
+            name += (i == 0 ? " (" : ", ") + spec.bindings[i].debugName;
+        }
+        if (!spec.bindings.empty()) {
+            name += ")";
+        }
+        VulkanDebugLabels::nameObject(*context_, VK_OBJECT_TYPE_DESCRIPTOR_SET_LAYOUT, rawLayout, name);
+    }
+    
     // Update pool size hints
     updatePoolSizeHints(*cachedLayout);
     
+    createUpdateTemplate(*cachedLayout);
+    
     return cachedLayout;
 }
 
+void DescriptorLayoutManager::createUpdateTemplate(CachedDescriptorLayout& cachedLayout) {
+    // Push layouts would need a push descriptor template tied to one pipeline layout; they are written per draw
+    if (!context_->supportsDescriptorUpdateTemplates() || cachedLayout.spec.bindings.empty() ||
+        cachedLayout.spec.pushDescriptor) {
+        return;
+    }
+    
+    DescriptorUpdateHelper::UpdateTemplate updateTemplate;
+    std::vector<VkDescriptorUpdateTemplateEntryKHR> entries;
+    entries.reserve(cachedLayout.spec.bindings.size());
+    
+    for (const auto& binding : cachedLayout.spec.bindings) {
+        switch (binding.type) {
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+            case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+            case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
+                break;
+            default:
+                return;
+        }
+        if (binding.isBindless || binding.descriptorCount != 1 || binding.binding >= MAX_DESCRIPTOR_TEMPLATE_BINDINGS) {
+            return;
+        }
+        
+        VkDescriptorUpdateTemplateEntryKHR entry{};
+        entry.dstBinding = binding.binding;
+        entry.dstArrayElement = 0;
+        entry.descriptorCount = 1;
+        entry.descriptorType = binding.type;
+        entry.offset = binding.binding * sizeof(VkDescriptorBufferInfo);
+        entry.stride = sizeof(VkDescriptorBufferInfo);
+        entries.push_back(entry);
+        
+        updateTemplate.bindingMask |= 1u << binding.binding;
+        updateTemplate.types[binding.binding] = binding.type;
+    }
+    
+    VkDescriptorUpdateTemplateCreateInfoKHR createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_UPDATE_TEMPLATE_CREATE_INFO_KHR;
+    createInfo.descriptorUpdateEntryCount = static_cast<uint32_t>(entries.size());
+    createInfo.pDescriptorUpdateEntries = entries.data();
+    createInfo.templateType = VK_DESCRIPTOR_UPDATE_TEMPLATE_TYPE_DESCRIPTOR_SET_KHR;
+    createInfo.descriptorSetLayout = cachedLayout.layout.get();
+    
+    VkDescriptorUpdateTemplateKHR handle = VK_NULL_HANDLE;
+    if (context_->getLoader().vkCreateDescriptorUpdateTemplateKHR(context_->getDevice(), &createInfo, nullptr, &handle) != VK_SUCCESS) {
+        // Sets of this layout keep being written through plain descriptor writes
+        std::cerr << "Failed to create descriptor update template: " << cachedLayout.spec.layoutName << std::endl;
+        return;
+    }
+    
+    cachedLayout.ownedTemplate = vulkan_raii::make_descriptor_update_template(handle, context_);
+    updateTemplate.handle = handle;
+    cachedLayout.updateTemplate = updateTemplate;
+}
+
+const DescriptorUpdateHelper::UpdateTemplate* DescriptorLayoutManager::getUpdateTemplate(VkDescriptorSetLayout layout) const {
+    if (layout == VK_NULL_HANDLE) {
+        return nullptr;
+    }
+    for (const auto& [key, cachedLayout] : layoutCache_) {
+        if (cachedLayout->layout.get() == layout) {
+            return cachedLayout->updateTemplate.handle != VK_NULL_HANDLE ? &cachedLayout->updateTemplate : nullptr;
+        }
+    }
+    return nullptr;
+}
+
 VkDescriptorSetLayout DescriptorLayoutManager::createVulkanLayout(const DescriptorLayoutSpec& spec) {
     std::vector<VkDescriptorSetLayoutBinding> vulkanBindings;
     std::vector<VkDescriptorBindingFlags> bindingFlags;
@@ -216,6 +301,9 @@ VkDescriptorSetLayout DescriptorLayoutManager::createVulkanLayout(const Descript
     VkDescriptorSetLayoutCreateInfo layoutInfo{};
     layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
     layoutInfo.flags = spec.flags;
+    if (spec.pushDescriptor) {
+        layoutInfo.flags |= VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+    }
     layoutInfo.bindingCount = static_cast<uint32_t>(vulkanBindings.size());
     layoutInfo.pBindings = vulkanBindings.data();
     
@@ -383,6 +471,7 @@ void DescriptorLayoutManager::evictLeastRecentlyUsed() {
     // Erase the layout (RAII handles cleanup automatically)
     layoutCache_.erase(lruIt);
     stats.totalLayouts--;
+    ++generation_;
 }
 
 void DescriptorLayoutManager::updatePoolSizeHints(CachedDescriptorLayout& cachedLayout) {
@@ -465,6 +554,17 @@ bool DescriptorLayoutManager::validateLayoutSpec(const DescriptorLayoutSpec& spe
         return false;
     }
     
+    if (spec.pushDescriptor) {
+        if (!context_->supportsPushDescriptors()) {
+            std::cerr << "Layout validation failed: push descriptors not supported on this device" << std::endl;
+            return false;
+        }
+        if (spec.enableBindless || spec.enableUpdateAfterBind) {
+            std::cerr << "Layout validation failed: push descriptor layouts cannot be bindless or update-after-bind" << std::endl;
+            return false;
+        }
+    }
+    
     return true;
 }
 
@@ -532,35 +632,38 @@ std::string DescriptorLayoutManager::descriptorTypeToString(VkDescriptorType typ
 
 // DescriptorLayoutPresets namespace implementation
 namespace DescriptorLayoutPresets {
+    // One storage buffer binding per EntityStreamSchema stream the set places, named after its block
+    static DescriptorBinding createEntityStreamBinding(const EntityStreamInfo& stream, uint32_t binding, VkShaderStageFlags stages) {
+        DescriptorBinding streamBinding{};
+        streamBinding.binding = binding;
+        streamBinding.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        streamBinding.descriptorCount = 1;
+        streamBinding.stageFlags = stages;
+        streamBinding.debugName = stream.blockName;
+        return streamBinding;
+    }
+    
     DescriptorLayoutSpec createEntityGraphicsLayout() {
         DescriptorLayoutSpec spec;
         spec.layoutName = "EntityGraphics";
         
-        // UBO for camera/view matrices
+        // UBO for camera/view matrices (dynamic offset into the frame ring allocator)
         DescriptorBinding uboBinding{};
-        uboBinding.binding = 0;
-        uboBinding.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+        uboBinding.binding = EntityDescriptorBindings::Graphics::UNIFORM_BUFFER;
+        uboBinding.type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC;
         uboBinding.descriptorCount = 1;
         uboBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
         uboBinding.debugName = "cameraUBO";
+        spec.bindings.push_back(uboBinding);
         
-        // Storage buffer for entity data
-        DescriptorBinding entityBinding{};
-        entityBinding.binding = 1;
-        entityBinding.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        entityBinding.descriptorCount = 1;
-        entityBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-        entityBinding.debugName = "entityBuffer";
-        
-        // Storage buffer for positions
-        DescriptorBinding positionBinding{};
-        positionBinding.binding = 2;
-        positionBinding.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        positionBinding.descriptorCount = 1;
-        positionBinding.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
-        positionBinding.debugName = "positionBuffer";
-        
-        spec.bindings = {uboBinding, entityBinding, positionBinding};
+        // Then the streams the vertex shader reads, in graphics binding order
+        for (uint32_t binding = 1; binding < EntityDescriptorBindings::Graphics::BINDING_COUNT; ++binding) {
+            for (const auto& stream : EntityStreamSchema::STREAMS) {
+                if (stream.graphicsBinding == binding) {
+                    spec.bindings.push_back(createEntityStreamBinding(stream, binding, VK_SHADER_STAGE_VERTEX_BIT));
+                }
+            }
+        }
         return spec;
     }
     
@@ -568,57 +671,11 @@ namespace DescriptorLayoutPresets {
         DescriptorLayoutSpec spec;
         spec.layoutName = "EntityComputeSoA";
         
-        // SoA Structure of Arrays layout matching compute shaders
-        
-        // Binding 0: VelocityBuffer (velocity.xy, damping, reserved)
-        DescriptorBinding velocityBinding{};
-        velocityBinding.binding = 0;
-        velocityBinding.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        velocityBinding.descriptorCount = 1;
-        velocityBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-        velocityBinding.debugName = "velocityBuffer";
-        
-        // Binding 1: MovementParamsBuffer (amplitude, frequency, phase, timeOffset)
-        DescriptorBinding movementParamsBinding{};
-        movementParamsBinding.binding = 1;
-        movementParamsBinding.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        movementParamsBinding.descriptorCount = 1;
-        movementParamsBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-        movementParamsBinding.debugName = "movementParamsBuffer";
-        
-        // Binding 2: RuntimeStateBuffer (totalTime, initialized, stateTimer, entityState)
-        DescriptorBinding runtimeStateBinding{};
-        runtimeStateBinding.binding = 2;
-        runtimeStateBinding.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        runtimeStateBinding.descriptorCount = 1;
-        runtimeStateBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-        runtimeStateBinding.debugName = "runtimeStateBuffer";
-        
-        // Binding 3: PositionBuffer (output positions for graphics)
-        DescriptorBinding positionOutputBinding{};
-        positionOutputBinding.binding = 3;
-        positionOutputBinding.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        positionOutputBinding.descriptorCount = 1;
-        positionOutputBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-        positionOutputBinding.debugName = "positionOutputBuffer";
-        
-        // Binding 4: CurrentPositionBuffer (physics integration state)
-        DescriptorBinding currentPosBinding{};
-        currentPosBinding.binding = 4;
-        currentPosBinding.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        currentPosBinding.descriptorCount = 1;
-        currentPosBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-        currentPosBinding.debugName = "currentPositionBuffer";
-        
-        // Binding 7: SpatialMapBuffer (spatial hash grid for collision detection)
-        DescriptorBinding spatialMapBinding{};
-        spatialMapBinding.binding = 7;
-        spatialMapBinding.type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
-        spatialMapBinding.descriptorCount = 1;
-        spatialMapBinding.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
-        spatialMapBinding.debugName = "spatialMapBuffer";
-        
-        spec.bindings = {velocityBinding, movementParamsBinding, runtimeStateBinding, positionOutputBinding, currentPosBinding, spatialMapBinding};
+        // Every stream at its compute binding. ModelMatrixBuffer stays declared when the layout drops the stream,
+        // keeping one layout for both; its binding is then left unwritten
+        for (const auto& stream : EntityStreamSchema::STREAMS) {
+            spec.bindings.push_back(createEntityStreamBinding(stream, stream.computeBinding, VK_SHADER_STAGE_COMPUTE_BIT));
+        }
         return spec;
     }
 }
@@ -653,6 +710,11 @@ DescriptorLayoutBuilder& DescriptorLayoutBuilder::setName(const std::string& nam
     return *this;
 }
 
+DescriptorLayoutBuilder& DescriptorLayoutBuilder::enablePushDescriptor(bool enable) {
+    spec_.pushDescriptor = enable;
+    return *this;
+}
+
 DescriptorLayoutSpec DescriptorLayoutBuilder::build() {
     return spec_;
 }
@@ -668,6 +730,7 @@ void DescriptorLayoutManager::optimizeCache(uint64_t currentFrame) {
             // Erase layout (RAII handles cleanup automatically)
             it = layoutCache_.erase(it);
             stats.totalLayouts--;
+            ++generation_;
         } else {
             ++it;
         }
@@ -10,6 +10,8 @@
 #include "../core/vulkan_context.h"
 #include "../core/vulkan_raii.h"
 #include "../core/vulkan_constants.h"
+#include "hash_utils.h"
+#include "../resources/descriptors/descriptor_update_helper.h"
 
 // Descriptor binding specification for flexible layout creation
 struct DescriptorBinding {
@@ -30,7 +32,7 @@ struct DescriptorBinding {
     
     // Comparison for caching
     bool operator==(const DescriptorBinding& other) const;
-    size_t getHash() const;
+    void appendKey(VulkanHash::PipelineKeyBuilder& builder) const;
 };
 
 // Descriptor set layout specification
@@ -43,19 +45,16 @@ struct DescriptorLayoutSpec {
     bool enableUpdateAfterBind = false;
     bool enablePartiallyBound = false;
     
+    // Pushed into the command buffer before each dispatch or draw rather than allocated and bound
+    // (VK_KHR_push_descriptor); at most one such set per pipeline layout, and no bindless bindings
+    bool pushDescriptor = false;
+    
     // Debug information
     std::string layoutName;
     
-    // Comparison for caching
+    // Comparison for caching; the key leaves out the debug names, like operator==
     bool operator==(const DescriptorLayoutSpec& other) const;
-    size_t getHash() const;
-};
-
-// Hash specialization for layout caching
-struct DescriptorLayoutSpecHash {
-    std::size_t operator()(const DescriptorLayoutSpec& spec) const {
-        return spec.getHash();
-    }
+    VulkanHash::PipelineKey getKey() const;
 };
 
 // Cached descriptor set layout with metadata
@@ -81,6 +80,11 @@ struct CachedDescriptorLayout {
     // Bindless information
     bool isBindless = false;
     uint32_t maxBindlessDescriptors = 0;
+    
+    // Built with the layout when every binding is a single buffer descriptor; updateTemplate.handle borrows
+    // ownedTemplate's handle
+    vulkan_raii::DescriptorUpdateTemplate ownedTemplate;
+    DescriptorUpdateHelper::UpdateTemplate updateTemplate;
 };
 
 // Descriptor pool configuration with automatic sizing
@@ -121,6 +125,11 @@ public:
     VkDescriptorSetLayout getLayout(const DescriptorLayoutSpec& spec);
     VkDescriptorSetLayout createLayout(const DescriptorLayoutSpec& spec);
     
+    // Update template of a layout from getLayout(); nullptr when the layout has none (non-buffer, arrayed or
+    // bindless bindings, push descriptor layouts, or no VK_KHR_descriptor_update_template). Lives as long as the
+    // cached layout
+    const DescriptorUpdateHelper::UpdateTemplate* getUpdateTemplate(VkDescriptorSetLayout layout) const;
+    
     // Batch layout creation for reduced driver overhead
     std::vector<VkDescriptorSetLayout> createLayoutsBatch(const std::vector<DescriptorLayoutSpec>& specs);
     
@@ -191,7 +200,7 @@ private:
     const VulkanContext* context_ = nullptr;
     
     // Layout cache
-    std::unordered_map<DescriptorLayoutSpec, std::unique_ptr<CachedDescriptorLayout>, DescriptorLayoutSpecHash> layoutCache_;
+    std::unordered_map<VulkanHash::PipelineKey, std::unique_ptr<CachedDescriptorLayout>, VulkanHash::PipelineKeyHash> layoutCache_;
     
     // Pool management
     std::vector<vulkan_raii::DescriptorPool> managedPools_;
@@ -218,12 +227,13 @@ private:
     uint32_t maxCacheSize_ = DEFAULT_LAYOUT_CACHE_SIZE;
     uint64_t cacheCleanupInterval_ = CACHE_CLEANUP_INTERVAL;
     
-    // Monotonic generation counter incremented on cache clear
+    // Monotonic generation counter incremented on cache clear and eviction
     uint64_t generation_ = 0;
     
     // Internal layout creation
     std::unique_ptr<CachedDescriptorLayout> createLayoutInternal(const DescriptorLayoutSpec& spec);
     VkDescriptorSetLayout createVulkanLayout(const DescriptorLayoutSpec& spec);
+    void createUpdateTemplate(CachedDescriptorLayout& cachedLayout);
     
     // Cache management helpers
     void evictLeastRecentlyUsed();
@@ -289,6 +299,7 @@ public:
     DescriptorLayoutBuilder& setName(const std::string& name);
     DescriptorLayoutBuilder& enableUpdateAfterBind(bool enable = true);
     DescriptorLayoutBuilder& enablePartiallyBound(bool enable = true);
+    DescriptorLayoutBuilder& enablePushDescriptor(bool enable = true);
     
     // Build the layout specification
     DescriptorLayoutSpec build();
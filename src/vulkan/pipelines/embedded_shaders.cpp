@@ -0,0 +1,23 @@
+#include "embedded_shaders.h"
+
+#if defined(FRACTALIA_EMBEDDED_SHADERS)
+#include "embedded_shaders.inc"
+#else
+constexpr size_t EMBEDDED_SHADER_COUNT = 0;
+constexpr EmbeddedShader EMBEDDED_SHADER_TABLE[] = {
+    { nullptr, VK_SHADER_STAGE_VERTEX_BIT, { 1, 1, 1 }, nullptr, 0 },
+};
+#endif
+
+const EmbeddedShader* findEmbeddedShader(std::string_view path) {
+    for (size_t i = 0; i < EMBEDDED_SHADER_COUNT; ++i) {
+        if (path == EMBEDDED_SHADER_TABLE[i].path) {
+            return &EMBEDDED_SHADER_TABLE[i];
+        }
+    }
+    return nullptr;
+}
+
+size_t getEmbeddedShaderCount() {
+    return EMBEDDED_SHADER_COUNT;
+}
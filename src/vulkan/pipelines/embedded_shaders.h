@@ -0,0 +1,20 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <string_view>
+
+// SPIR-V module baked into the executable by embed-shaders.cmake (EMBED_SHADERS builds), with the
+// reflection performBasicReflection would otherwise derive at load time
+struct EmbeddedShader {
+    const char* path;             // As pipeline specs name it, e.g. "shaders/physics.comp.spv"
+    VkShaderStageFlagBits stage;
+    uint32_t localSize[3];        // Workgroup size for compute modules, 1 otherwise
+    const uint32_t* code;
+    size_t wordCount;
+};
+
+// nullptr when path is not embedded, always in builds without EMBED_SHADERS
+const EmbeddedShader* findEmbeddedShader(std::string_view path);
+size_t getEmbeddedShaderCount();
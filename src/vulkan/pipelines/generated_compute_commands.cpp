@@ -0,0 +1,262 @@
+#include "generated_compute_commands.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../core/vulkan_utils.h"
+#include "../core/deletion_queue.h"
+#include <algorithm>
+#include <array>
+#include <iostream>
+#include <stdexcept>
+
+void GeneratedComputeCommands::initialize(const VulkanContext* context, DeletionQueue* deletionQueue) {
+    context_ = context;
+    deletionQueue_ = deletionQueue;
+    ready_ = false;
+}
+
+void GeneratedComputeCommands::cleanupBeforeContextDestruction() {
+    deletionQueue_ = nullptr;
+    retire();
+    pipelines_.clear();
+    layout_ = VK_NULL_HANDLE;
+    maxSequences_ = 0;
+}
+
+bool GeneratedComputeCommands::prepare(const std::vector<VkPipeline>& pipelines, VkPipelineLayout layout,
+                                       uint32_t pushConstantSize, uint32_t maxSequences) {
+    if (pipelines == pipelines_ && layout == layout_ && pushConstantSize == pushConstantSize_ &&
+        maxSequences == maxSequences_) {
+        return ready_;
+    }
+
+    retire();
+    pipelines_ = pipelines;
+    layout_ = layout;
+    pushConstantSize_ = pushConstantSize;
+    maxSequences_ = maxSequences;
+
+    // A failure is remembered for these inputs, so the caller falls back without retrying every frame
+    if (!context_ || !context_->supportsDeviceGeneratedCommands() || pipelines.empty() || layout == VK_NULL_HANDLE ||
+        pipelines.size() > context_->getMaxIndirectPipelineCount() || maxSequences == 0 ||
+        maxSequences > context_->getMaxIndirectSequenceCount()) {
+        return false;
+    }
+    ready_ = createExecutionSet(pipelines) && createCommandsLayout(layout, pushConstantSize) && createBuffers();
+    if (!ready_) {
+        std::cerr << "GeneratedComputeCommands: Failed to create the generated command objects, dispatching from the CPU" << std::endl;
+        retire();
+    }
+    return ready_;
+}
+
+bool GeneratedComputeCommands::createExecutionSet(const std::vector<VkPipeline>& pipelines) {
+    const auto& vk = context_->getLoader();
+
+    VkIndirectExecutionSetPipelineInfoEXT pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_INDIRECT_EXECUTION_SET_PIPELINE_INFO_EXT;
+    pipelineInfo.initialPipeline = pipelines[0];
+    pipelineInfo.maxPipelineCount = static_cast<uint32_t>(pipelines.size());
+
+    VkIndirectExecutionSetCreateInfoEXT createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_INDIRECT_EXECUTION_SET_CREATE_INFO_EXT;
+    createInfo.type = VK_INDIRECT_EXECUTION_SET_INFO_TYPE_PIPELINES_EXT;
+    createInfo.info.pPipelineInfo = &pipelineInfo;
+
+    VkIndirectExecutionSetEXT executionSet = VK_NULL_HANDLE;
+    if (vk.vkCreateIndirectExecutionSetEXT(context_->getDevice(), &createInfo, nullptr, &executionSet) != VK_SUCCESS) {
+        return false;
+    }
+    executionSet_ = vulkan_raii::make_indirect_execution_set(executionSet, context_);
+
+    // The initial pipeline is entry 0; the set is new, so no submitted work uses the other entries yet
+    std::vector<VkWriteIndirectExecutionSetPipelineEXT> writes;
+    for (uint32_t index = 1; index < pipelines.size(); ++index) {
+        VkWriteIndirectExecutionSetPipelineEXT write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_INDIRECT_EXECUTION_SET_PIPELINE_EXT;
+        write.index = index;
+        write.pipeline = pipelines[index];
+        writes.push_back(write);
+    }
+    if (!writes.empty()) {
+        vk.vkUpdateIndirectExecutionSetPipelineEXT(context_->getDevice(), executionSet,
+                                                   static_cast<uint32_t>(writes.size()), writes.data());
+    }
+    return true;
+}
+
+bool GeneratedComputeCommands::createCommandsLayout(VkPipelineLayout layout, uint32_t pushConstantSize) {
+    const auto& vk = context_->getLoader();
+
+    VkIndirectCommandsExecutionSetTokenEXT executionSetToken{};
+    executionSetToken.type = VK_INDIRECT_EXECUTION_SET_INFO_TYPE_PIPELINES_EXT;
+    executionSetToken.shaderStages = VK_SHADER_STAGE_COMPUTE_BIT;
+
+    VkIndirectCommandsPushConstantTokenEXT pushConstantToken{};
+    pushConstantToken.updateRange.stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    pushConstantToken.updateRange.offset = 0;
+    pushConstantToken.updateRange.size = pushConstantSize;
+
+    // The execution set token has to come first; offsets follow getSequenceStride()
+    std::array<VkIndirectCommandsLayoutTokenEXT, 3> tokens{};
+    for (auto& token : tokens) {
+        token.sType = VK_STRUCTURE_TYPE_INDIRECT_COMMANDS_LAYOUT_TOKEN_EXT;
+    }
+    tokens[0].type = VK_INDIRECT_COMMANDS_TOKEN_TYPE_EXECUTION_SET_EXT;
+    tokens[0].data.pExecutionSet = &executionSetToken;
+    tokens[0].offset = 0;
+    tokens[1].type = VK_INDIRECT_COMMANDS_TOKEN_TYPE_PUSH_CONSTANT_EXT;
+    tokens[1].data.pPushConstant = &pushConstantToken;
+    tokens[1].offset = sizeof(uint32_t);
+    tokens[2].type = VK_INDIRECT_COMMANDS_TOKEN_TYPE_DISPATCH_EXT;
+    tokens[2].offset = sizeof(uint32_t) + pushConstantSize;
+
+    VkIndirectCommandsLayoutCreateInfoEXT createInfo{};
+    createInfo.sType = VK_STRUCTURE_TYPE_INDIRECT_COMMANDS_LAYOUT_CREATE_INFO_EXT;
+    createInfo.shaderStages = VK_SHADER_STAGE_COMPUTE_BIT;
+    createInfo.indirectStride = getSequenceStride(pushConstantSize);
+    createInfo.pipelineLayout = layout;
+    createInfo.tokenCount = static_cast<uint32_t>(tokens.size());
+    createInfo.pTokens = tokens.data();
+
+    VkIndirectCommandsLayoutEXT commandsLayout = VK_NULL_HANDLE;
+    if (vk.vkCreateIndirectCommandsLayoutEXT(context_->getDevice(), &createInfo, nullptr, &commandsLayout) != VK_SUCCESS) {
+        return false;
+    }
+    commandsLayout_ = vulkan_raii::make_indirect_commands_layout(commandsLayout, context_);
+    return true;
+}
+
+bool GeneratedComputeCommands::createBuffers() {
+    const auto& vk = context_->getLoader();
+
+    // Sequence count, then maxSequences_ sequences; written by a shader through its address, read as indirect input
+    const VkDeviceSize sequenceSize = SEQUENCE_OFFSET + VkDeviceSize(maxSequences_) * getSequenceStride(pushConstantSize_);
+    if (!createBuffer(sequenceSize, sizeof(uint32_t), ~0u,
+                      VK_BUFFER_USAGE_2_STORAGE_BUFFER_BIT_KHR | VK_BUFFER_USAGE_2_INDIRECT_BUFFER_BIT_KHR,
+                      sequenceBuffer_, sequenceMemory_, sequenceAddress_)) {
+        return false;
+    }
+
+    VkGeneratedCommandsMemoryRequirementsInfoEXT requirementsInfo{};
+    requirementsInfo.sType = VK_STRUCTURE_TYPE_GENERATED_COMMANDS_MEMORY_REQUIREMENTS_INFO_EXT;
+    requirementsInfo.indirectExecutionSet = executionSet_.get();
+    requirementsInfo.indirectCommandsLayout = commandsLayout_.get();
+    requirementsInfo.maxSequenceCount = maxSequences_;
+    requirementsInfo.maxDrawCount = 0;
+    VkMemoryRequirements2 requirements{};
+    requirements.sType = VK_STRUCTURE_TYPE_MEMORY_REQUIREMENTS_2;
+    vk.vkGetGeneratedCommandsMemoryRequirementsEXT(context_->getDevice(), &requirementsInfo, &requirements);
+
+    // Some drivers need no scratch space at all
+    preprocessSize_ = requirements.memoryRequirements.size;
+    if (preprocessSize_ == 0) {
+        preprocessAddress_ = 0;
+        return true;
+    }
+    return createBuffer(preprocessSize_, requirements.memoryRequirements.alignment, requirements.memoryRequirements.memoryTypeBits,
+                        VK_BUFFER_USAGE_2_PREPROCESS_BUFFER_BIT_EXT, preprocessBuffer_, preprocessMemory_, preprocessAddress_);
+}
+
+bool GeneratedComputeCommands::createBuffer(VkDeviceSize size, VkDeviceSize alignment, uint32_t memoryTypeBits,
+                                            VkBufferUsageFlags2KHR usage, vulkan_raii::Buffer& buffer,
+                                            vulkan_raii::DeviceMemory& memory, VkDeviceAddress& address) const {
+    const auto& vk = context_->getLoader();
+    const VkDevice device = context_->getDevice();
+    alignment = std::max<VkDeviceSize>(alignment, 1);
+
+    // Preprocess usage only exists as a 64-bit flag, which then stands in for bufferInfo.usage
+    VkBufferUsageFlags2CreateInfoKHR usageInfo{};
+    usageInfo.sType = VK_STRUCTURE_TYPE_BUFFER_USAGE_FLAGS_2_CREATE_INFO_KHR;
+    usageInfo.usage = usage | VK_BUFFER_USAGE_2_SHADER_DEVICE_ADDRESS_BIT_KHR;
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.pNext = &usageInfo;
+    bufferInfo.size = size + alignment - 1;  // Slack to align the address up
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+
+    VkBuffer rawBuffer = VK_NULL_HANDLE;
+    if (vk.vkCreateBuffer(device, &bufferInfo, nullptr, &rawBuffer) != VK_SUCCESS) {
+        return false;
+    }
+    buffer = vulkan_raii::make_buffer(rawBuffer, context_);
+
+    VkMemoryRequirements memRequirements{};
+    vk.vkGetBufferMemoryRequirements(device, rawBuffer, &memRequirements);
+
+    VkMemoryAllocateFlagsInfoKHR allocFlags{};
+    allocFlags.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_FLAGS_INFO_KHR;
+    allocFlags.flags = VK_MEMORY_ALLOCATE_DEVICE_ADDRESS_BIT_KHR;
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.pNext = &allocFlags;
+    allocInfo.allocationSize = memRequirements.size;
+    try {
+        allocInfo.memoryTypeIndex = VulkanUtils::findMemoryType(context_->getPhysicalDevice(), vk,
+                                                                memRequirements.memoryTypeBits & memoryTypeBits,
+                                                                VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    } catch (const std::runtime_error& e) {
+        std::cerr << "GeneratedComputeCommands: No device-local memory for a generated command buffer: " << e.what() << std::endl;
+        buffer.reset();
+        return false;
+    }
+
+    VkDeviceMemory rawMemory = VK_NULL_HANDLE;
+    if (vk.vkAllocateMemory(device, &allocInfo, nullptr, &rawMemory) != VK_SUCCESS) {
+        buffer.reset();
+        return false;
+    }
+    memory = vulkan_raii::make_device_memory(rawMemory, context_);
+    vk.vkBindBufferMemory(device, rawBuffer, rawMemory, 0);
+
+    VkBufferDeviceAddressInfoKHR addressInfo{};
+    addressInfo.sType = VK_STRUCTURE_TYPE_BUFFER_DEVICE_ADDRESS_INFO_KHR;
+    addressInfo.buffer = rawBuffer;
+    address = (vk.vkGetBufferDeviceAddressKHR(device, &addressInfo) + alignment - 1) / alignment * alignment;
+    return true;
+}
+
+void GeneratedComputeCommands::retire() {
+    // Buffers before their memory; whatever the queue did not take is destroyed right here
+    if (deletionQueue_) {
+        deletionQueue_->retire(std::move(sequenceBuffer_));
+        deletionQueue_->retire(std::move(sequenceMemory_));
+        deletionQueue_->retire(std::move(preprocessBuffer_));
+        deletionQueue_->retire(std::move(preprocessMemory_));
+        deletionQueue_->retire(std::move(commandsLayout_));
+        deletionQueue_->retire(std::move(executionSet_));
+    }
+    sequenceBuffer_.reset();
+    sequenceMemory_.reset();
+    preprocessBuffer_.reset();
+    preprocessMemory_.reset();
+    commandsLayout_.reset();
+    executionSet_.reset();
+    sequenceAddress_ = 0;
+    preprocessAddress_ = 0;
+    preprocessSize_ = 0;
+    ready_ = false;
+}
+
+void GeneratedComputeCommands::execute(VkCommandBuffer commandBuffer) const {
+    if (!ready_) {
+        return;
+    }
+    const auto& vk = context_->getLoader();
+
+    VkGeneratedCommandsInfoEXT generatedInfo{};
+    generatedInfo.sType = VK_STRUCTURE_TYPE_GENERATED_COMMANDS_INFO_EXT;
+    generatedInfo.shaderStages = VK_SHADER_STAGE_COMPUTE_BIT;
+    generatedInfo.indirectExecutionSet = executionSet_.get();
+    generatedInfo.indirectCommandsLayout = commandsLayout_.get();
+    generatedInfo.indirectAddress = sequenceAddress_ + SEQUENCE_OFFSET;
+    generatedInfo.indirectAddressSize = VkDeviceSize(maxSequences_) * getSequenceStride(pushConstantSize_);
+    generatedInfo.preprocessAddress = preprocessAddress_;
+    generatedInfo.preprocessSize = preprocessSize_;
+    generatedInfo.maxSequenceCount = maxSequences_;
+    generatedInfo.sequenceCountAddress = sequenceAddress_;
+    generatedInfo.maxDrawCount = 0;
+
+    // Not preprocessed ahead: the execution preprocesses the sequences itself
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelines_[0]);
+    vk.vkCmdExecuteGeneratedCommandsEXT(commandBuffer, VK_FALSE, &generatedInfo);
+}
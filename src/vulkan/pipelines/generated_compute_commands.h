@@ -0,0 +1,93 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../core/vulkan_raii.h"
+#include <vector>
+#include <cstdint>
+
+// Forward declarations
+class VulkanContext;
+class DeletionQueue;
+
+// Device-generated compute commands (VK_EXT_device_generated_commands). A GPU pass writes up to maxSequences
+// sequences of {execution set index, push constants, VkDispatchIndirectCommand} and their count into the sequence
+// buffer; execute() then records them all as one vkCmdExecuteGeneratedCommandsEXT, so which pipelines run and how
+// often is decided on the GPU. The pipelines form the execution set in index order; they must share one layout and
+// be created indirect bindable (ComputePipelinePresets::applyIndirectBindable). Objects replaced by prepare() are
+// retired into the DeletionQueue, so frames in flight keep executing the previous set. prepare() on the main
+// thread only; execute() from any recording thread
+class GeneratedComputeCommands {
+public:
+    // The sequence count word sits at the start of the sequence buffer, the sequences from here on
+    static constexpr VkDeviceSize SEQUENCE_OFFSET = 16;
+
+    // Bytes per sequence: execution set index, pushConstantSize bytes of push constants, dispatch arguments
+    static constexpr uint32_t getSequenceStride(uint32_t pushConstantSize) {
+        return uint32_t(sizeof(uint32_t)) + pushConstantSize + uint32_t(sizeof(VkDispatchIndirectCommand));
+    }
+
+    // What execute() reads the sequences and writes its preprocess buffer in: the generating pass's writes must
+    // reach these before it, and the next frame's generating pass must wait on them
+    static constexpr VkPipelineStageFlags2KHR CONSUMER_STAGES =
+        VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR | VK_PIPELINE_STAGE_2_COMMAND_PREPROCESS_BIT_EXT;
+    static constexpr VkAccessFlags2KHR CONSUMER_ACCESS =
+        VK_ACCESS_2_INDIRECT_COMMAND_READ_BIT_KHR | VK_ACCESS_2_COMMAND_PREPROCESS_READ_BIT_EXT;
+
+    GeneratedComputeCommands() = default;
+    ~GeneratedComputeCommands() = default;
+
+    GeneratedComputeCommands(const GeneratedComputeCommands&) = delete;
+    GeneratedComputeCommands& operator=(const GeneratedComputeCommands&) = delete;
+
+    // Stays unready (every prepare() false) without VulkanContext::supportsDeviceGeneratedCommands.
+    // deletionQueue nullptr destroys replaced objects on the spot, so the device must then be idle
+    void initialize(const VulkanContext* context, DeletionQueue* deletionQueue);
+    void cleanupBeforeContextDestruction();
+
+    // Rebuilds the execution set, the commands layout and the buffers once the pipelines, their layout or the
+    // limits differ from the last call. False leaves the caller on its own dispatch loop for the frame
+    bool prepare(const std::vector<VkPipeline>& pipelines, VkPipelineLayout layout, uint32_t pushConstantSize,
+                 uint32_t maxSequences);
+    bool isReady() const { return ready_; }
+
+    // Where the generating pass writes: the sequence count at this address, the sequences SEQUENCE_OFFSET on
+    VkDeviceAddress getSequenceAddress() const { return sequenceAddress_; }
+    uint32_t getMaxSequences() const { return maxSequences_; }
+
+    // Binds pipeline 0, which the execution set starts from, and executes the generated sequences. Descriptor sets
+    // bound for the layout beforehand stay bound for every sequence; pipeline and push constant state is undefined
+    // afterwards
+    void execute(VkCommandBuffer commandBuffer) const;
+
+private:
+    // Device-local, device-addressable buffer of at least size bytes from address, which is aligned up to alignment
+    bool createBuffer(VkDeviceSize size, VkDeviceSize alignment, uint32_t memoryTypeBits, VkBufferUsageFlags2KHR usage,
+                      vulkan_raii::Buffer& buffer, vulkan_raii::DeviceMemory& memory, VkDeviceAddress& address) const;
+    bool createExecutionSet(const std::vector<VkPipeline>& pipelines);
+    bool createCommandsLayout(VkPipelineLayout layout, uint32_t pushConstantSize);
+    bool createBuffers();
+
+    // Hands everything prepare() built to the DeletionQueue and leaves the inputs it was built for
+    void retire();
+
+    const VulkanContext* context_ = nullptr;
+    DeletionQueue* deletionQueue_ = nullptr;
+    bool ready_ = false;
+
+    // What the current objects were built for
+    std::vector<VkPipeline> pipelines_;
+    VkPipelineLayout layout_ = VK_NULL_HANDLE;
+    uint32_t pushConstantSize_ = 0;
+    uint32_t maxSequences_ = 0;
+
+    vulkan_raii::IndirectExecutionSet executionSet_;
+    vulkan_raii::IndirectCommandsLayout commandsLayout_;
+    vulkan_raii::Buffer sequenceBuffer_;
+    vulkan_raii::DeviceMemory sequenceMemory_;
+    VkDeviceAddress sequenceAddress_ = 0;
+    vulkan_raii::Buffer preprocessBuffer_;
+    vulkan_raii::DeviceMemory preprocessMemory_;
+    VkDeviceAddress preprocessAddress_ = 0;
+    VkDeviceSize preprocessSize_ = 0;
+};
@@ -1,12 +1,14 @@
 #include "graphics_pipeline_cache.h"
+#include "../core/deletion_queue.h"
 #include <iostream>
 #include <algorithm>
 
-GraphicsPipelineCache::GraphicsPipelineCache(uint32_t maxCacheSize) : maxCacheSize_(maxCacheSize) {
+GraphicsPipelineCache::GraphicsPipelineCache(uint32_t maxCacheSize)
+    : cache_(&MemoryTags::getResource(MemoryTag::PipelineCache)), maxCacheSize_(maxCacheSize) {
 }
 
-VkPipeline GraphicsPipelineCache::getPipeline(const GraphicsPipelineState& state) {
-    auto it = cache_.find(state);
+VkPipeline GraphicsPipelineCache::getPipeline(const VulkanHash::PipelineKey& key) {
+    auto it = cache_.find(key);
     if (it != cache_.end()) {
         stats_.cacheHits++;
         it->second->lastUsedFrame = stats_.cacheHits + stats_.cacheMisses;
@@ -18,23 +20,29 @@ VkPipeline GraphicsPipelineCache::getPipeline(const GraphicsPipelineState& state
     return VK_NULL_HANDLE;
 }
 
-VkPipelineLayout GraphicsPipelineCache::getPipelineLayout(const GraphicsPipelineState& state) {
-    auto it = cache_.find(state);
+VkPipelineLayout GraphicsPipelineCache::getPipelineLayout(const VulkanHash::PipelineKey& key) {
+    auto it = cache_.find(key);
     if (it != cache_.end()) {
         return it->second->layout.get();
     }
     return VK_NULL_HANDLE;
 }
 
-void GraphicsPipelineCache::storePipeline(const GraphicsPipelineState& state, std::unique_ptr<CachedGraphicsPipeline> pipeline) {
-    stats_.totalPipelines++;
+void GraphicsPipelineCache::storePipeline(const VulkanHash::PipelineKey& key, std::unique_ptr<CachedGraphicsPipeline> pipeline) {
     stats_.compilationsThisFrame++;
     
     if (pipeline->compilationTime.count() > 0) {
         stats_.totalCompilationTime += pipeline->compilationTime;
     }
     
-    cache_[state] = std::move(pipeline);
+    // A replacement takes the slot at once; the pipeline it displaces may still be bound by frames in flight
+    auto& entry = cache_[key];
+    if (entry) {
+        retire(std::move(entry));
+    } else {
+        stats_.totalPipelines++;
+    }
+    entry = std::move(pipeline);
     
     if (cache_.size() > maxCacheSize_) {
         evictLeastRecentlyUsed();
@@ -43,6 +51,9 @@ void GraphicsPipelineCache::storePipeline(const GraphicsPipelineState& state, st
 
 void GraphicsPipelineCache::clear() {
     // Clear cache in dependency order - pipelines first, then layouts
+    for (auto& [key, pipeline] : cache_) {
+        retire(std::move(pipeline));
+    }
     cache_.clear();
     
     // Reset statistics to prevent corruption
@@ -57,6 +68,7 @@ void GraphicsPipelineCache::clear() {
 void GraphicsPipelineCache::optimizeCache(uint64_t currentFrame) {
     for (auto it = cache_.begin(); it != cache_.end();) {
         if (shouldEvictPipeline(*it->second, currentFrame)) {
+            retire(std::move(it->second));
             it = cache_.erase(it);
             stats_.totalPipelines--;
         } else {
@@ -75,12 +87,32 @@ void GraphicsPipelineCache::evictLeastRecentlyUsed() {
         }
     }
     
+    retire(std::move(lruIt->second));
     cache_.erase(lruIt);
     stats_.totalPipelines--;
 }
 
-bool GraphicsPipelineCache::contains(const GraphicsPipelineState& state) const {
-    return cache_.find(state) != cache_.end();
+bool GraphicsPipelineCache::contains(const VulkanHash::PipelineKey& key) const {
+    return cache_.find(key) != cache_.end();
+}
+
+const PipelineStats& GraphicsPipelineCache::getStats() const {
+    stats_.maxRegisters = 0;
+    stats_.spillingPipelines = 0;
+    for (const auto& [key, cached] : cache_) {
+        const PipelineExecutableStats& executable = cached->executableStats;
+        stats_.maxRegisters = std::max(stats_.maxRegisters, static_cast<uint32_t>(executable.registers));
+        stats_.spillingPipelines += executable.spillsRegisters() ? 1 : 0;
+    }
+    return stats_;
+}
+
+void GraphicsPipelineCache::collectExecutableReports(std::vector<PipelineExecutableReport>& reports) const {
+    for (const auto& [key, cached] : cache_) {
+        if (cached->executableStats.isCaptured()) {
+            reports.push_back({PipelineUtils::describeShaders(cached->state.shaderStages), cached->executableStats});
+        }
+    }
 }
 
 void GraphicsPipelineCache::resetFrameStats() {
@@ -112,4 +144,10 @@ void GraphicsPipelineCache::debugPrintCache() const {
 
 bool GraphicsPipelineCache::shouldEvictPipeline(const CachedGraphicsPipeline& pipeline, uint64_t currentFrame) const {
     return currentFrame - pipeline.lastUsedFrame > cacheCleanupInterval_;
+}
+
+void GraphicsPipelineCache::retire(std::unique_ptr<CachedGraphicsPipeline> pipeline) {
+    if (deletionQueue_) {
+        deletionQueue_->retire(std::move(pipeline));
+    }
 }
\ No newline at end of file
@@ -4,10 +4,15 @@
 #include <vulkan/vulkan.h>
 #include <unordered_map>
 #include <memory>
+#include <memory_resource>
 #include <chrono>
 #include "../core/vulkan_raii.h"
 #include "../core/vulkan_constants.h"
+#include "../../ecs/utilities/memory_tags.h"
 #include "graphics_pipeline_state_hash.h"
+#include "pipeline_utils.h"
+
+class DeletionQueue;
 
 struct CachedGraphicsPipeline {
     vulkan_raii::Pipeline pipeline;
@@ -18,6 +23,7 @@ struct CachedGraphicsPipeline {
     
     std::chrono::nanoseconds compilationTime{0};
     bool isHotPath = false;
+    PipelineExecutableStats executableStats;  // Uncaptured without VK_KHR_pipeline_executable_properties
 };
 
 struct PipelineStats {
@@ -27,6 +33,10 @@ struct PipelineStats {
     uint32_t compilationsThisFrame = 0;
     std::chrono::nanoseconds totalCompilationTime{0};
     float hitRatio = 0.0f;
+    
+    // Over the cached pipelines whose executable statistics were captured
+    uint32_t maxRegisters = 0;
+    uint32_t spillingPipelines = 0;
 };
 
 class GraphicsPipelineCache {
@@ -34,26 +44,33 @@ public:
     explicit GraphicsPipelineCache(uint32_t maxCacheSize = DEFAULT_GRAPHICS_CACHE_SIZE);
     ~GraphicsPipelineCache() = default;
 
-    VkPipeline getPipeline(const GraphicsPipelineState& state);
-    VkPipelineLayout getPipelineLayout(const GraphicsPipelineState& state);
+    // Keyed by GraphicsPipelineState::getKey(), built once by the caller per lookup
+    VkPipeline getPipeline(const VulkanHash::PipelineKey& key);
+    VkPipelineLayout getPipelineLayout(const VulkanHash::PipelineKey& key);
     
-    void storePipeline(const GraphicsPipelineState& state, std::unique_ptr<CachedGraphicsPipeline> pipeline);
+    void storePipeline(const VulkanHash::PipelineKey& key, std::unique_ptr<CachedGraphicsPipeline> pipeline);
     
     void clear();
     void optimizeCache(uint64_t currentFrame);
     void evictLeastRecentlyUsed();
     
-    bool contains(const GraphicsPipelineState& state) const;
+    bool contains(const VulkanHash::PipelineKey& key) const;
     size_t size() const { return cache_.size(); }
     
-    const PipelineStats& getStats() const { return stats_; }
+    const PipelineStats& getStats() const;
+    void collectExecutableReports(std::vector<PipelineExecutableReport>& reports) const;
     void resetFrameStats();
     void updateStats(bool cacheHit, std::chrono::nanoseconds compilationTime = std::chrono::nanoseconds{0});
     
     void debugPrintCache() const;
+    
+    // Evicted, replaced and cleared pipelines are retired here rather than destroyed (nullptr = destroy)
+    void setDeletionQueue(DeletionQueue* deletionQueue) { deletionQueue_ = deletionQueue; }
 
 private:
-    std::unordered_map<GraphicsPipelineState, std::unique_ptr<CachedGraphicsPipeline>, GraphicsPipelineStateHash> cache_;
+    // Entries charged to MemoryTag::PipelineCache (the map's nodes and buckets; the pipelines they own are not)
+    std::pmr::unordered_map<VulkanHash::PipelineKey, std::unique_ptr<CachedGraphicsPipeline>, VulkanHash::PipelineKeyHash> cache_;
+    DeletionQueue* deletionQueue_ = nullptr;
     
     uint32_t maxCacheSize_;
     uint64_t cacheCleanupInterval_ = CACHE_CLEANUP_INTERVAL;
@@ -61,4 +78,5 @@ private:
     mutable PipelineStats stats_;
     
     bool shouldEvictPipeline(const CachedGraphicsPipeline& pipeline, uint64_t currentFrame) const;
+    void retire(std::unique_ptr<CachedGraphicsPipeline> pipeline);
 };
\ No newline at end of file
@@ -3,6 +3,24 @@
 #include <iostream>
 #include <chrono>
 
+namespace {
+    VkGraphicsPipelineLibraryFlagsEXT libraryFlag(GraphicsPipelineLibraryPart part) {
+        switch (part) {
+            case GraphicsPipelineLibraryPart::VertexInput:
+                return VK_GRAPHICS_PIPELINE_LIBRARY_VERTEX_INPUT_INTERFACE_BIT_EXT;
+            case GraphicsPipelineLibraryPart::PreRasterization:
+                return VK_GRAPHICS_PIPELINE_LIBRARY_PRE_RASTERIZATION_SHADERS_BIT_EXT;
+            case GraphicsPipelineLibraryPart::FragmentShader:
+                return VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_SHADER_BIT_EXT;
+            case GraphicsPipelineLibraryPart::FragmentOutput:
+                return VK_GRAPHICS_PIPELINE_LIBRARY_FRAGMENT_OUTPUT_INTERFACE_BIT_EXT;
+        }
+        return 0;
+    }
+    
+    constexpr VkShaderStageFlags PRE_RASTERIZATION_STAGES = VK_SHADER_STAGE_ALL_GRAPHICS & ~VK_SHADER_STAGE_FRAGMENT_BIT;
+}
+
 GraphicsPipelineFactory::GraphicsPipelineFactory(VulkanContext* ctx) : VulkanManagerBase(ctx), layoutBuilder_(ctx) {
 }
 
@@ -34,152 +52,414 @@ std::unique_ptr<CachedGraphicsPipeline> GraphicsPipelineFactory::createPipeline(
     cachedPipeline->layout = vulkan_raii::make_pipeline_layout(rawLayout, context);
     std::cout << "GraphicsPipelineFactory: Pipeline layout created successfully: " << (void*)rawLayout << std::endl;
     
-    VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
-    vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
-    vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(state.vertexBindings.size());
-    vertexInputInfo.pVertexBindingDescriptions = state.vertexBindings.data();
-    vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(state.vertexAttributes.size());
-    vertexInputInfo.pVertexAttributeDescriptions = state.vertexAttributes.data();
-    
-    VkPipelineInputAssemblyStateCreateInfo inputAssemblyInfo{};
-    inputAssemblyInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
-    inputAssemblyInfo.topology = state.topology;
-    inputAssemblyInfo.primitiveRestartEnable = state.primitiveRestartEnable;
-    
-    VkPipelineViewportStateCreateInfo viewportInfo{};
-    viewportInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
-    viewportInfo.viewportCount = state.viewportCount;
-    viewportInfo.scissorCount = state.scissorCount;
-    
-    VkPipelineRasterizationStateCreateInfo rasterizationInfo{};
-    rasterizationInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
-    rasterizationInfo.depthClampEnable = state.depthClampEnable;
-    rasterizationInfo.rasterizerDiscardEnable = state.rasterizerDiscardEnable;
-    rasterizationInfo.polygonMode = state.polygonMode;
-    rasterizationInfo.lineWidth = state.lineWidth;
-    rasterizationInfo.cullMode = state.cullMode;
-    rasterizationInfo.frontFace = state.frontFace;
-    rasterizationInfo.depthBiasEnable = state.depthBiasEnable;
-    
-    VkPipelineMultisampleStateCreateInfo multisampleInfo{};
-    multisampleInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
-    multisampleInfo.sampleShadingEnable = state.sampleShadingEnable;
-    multisampleInfo.rasterizationSamples = state.rasterizationSamples;
-    multisampleInfo.minSampleShading = state.minSampleShading;
-    
-    VkPipelineColorBlendStateCreateInfo colorBlendInfo{};
-    colorBlendInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
-    colorBlendInfo.logicOpEnable = state.logicOpEnable;
-    colorBlendInfo.logicOp = state.logicOp;
-    colorBlendInfo.attachmentCount = static_cast<uint32_t>(state.colorBlendAttachments.size());
-    colorBlendInfo.pAttachments = state.colorBlendAttachments.data();
-    memcpy(colorBlendInfo.blendConstants, state.blendConstants, sizeof(state.blendConstants));
-    
-    VkPipelineDynamicStateCreateInfo dynamicStateInfo{};
-    dynamicStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
-    dynamicStateInfo.dynamicStateCount = static_cast<uint32_t>(state.dynamicStates.size());
-    dynamicStateInfo.pDynamicStates = state.dynamicStates.data();
-    
-    VkPipelineDepthStencilStateCreateInfo depthStencilInfo{};
-    depthStencilInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
-    depthStencilInfo.depthTestEnable = state.depthTestEnable;
-    depthStencilInfo.depthWriteEnable = state.depthWriteEnable;
-    depthStencilInfo.depthCompareOp = state.depthCompareOp;
-    depthStencilInfo.stencilTestEnable = state.stencilTestEnable;
-    
-    std::cout << "GraphicsPipelineFactory: Loading shaders..." << std::endl;
-    std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
-    std::vector<VkShaderModule> shaderModules;
+    CreateInfos infos;
+    buildCreateInfos(state, infos);
     
-    std::cout << "GraphicsPipelineFactory: Shader stages to load: " << state.shaderStages.size() << std::endl;
-    for (size_t i = 0; i < state.shaderStages.size(); ++i) {
-        std::cout << "  Shader[" << i << "]: " << state.shaderStages[i] << std::endl;
+    // Parts another permutation already compiled are reused and only linked; a part that fails falls back to a
+    // monolithic create
+    VkPipeline rawPipeline = VK_NULL_HANDLE;
+    if (context->supportsGraphicsPipelineLibrary()) {
+        rawPipeline = linkFromLibraries(state, infos, rawLayout);
+        if (rawPipeline == VK_NULL_HANDLE) {
+            std::cerr << "GraphicsPipelineFactory: Library link failed, creating a monolithic pipeline" << std::endl;
+        }
+    }
+    
+    if (rawPipeline == VK_NULL_HANDLE) {
+        std::cout << "GraphicsPipelineFactory: Loading shaders..." << std::endl;
+        std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+        std::vector<VkShaderModule> shaderModules;
+        if (!loadShaderStages(state, infos, VK_SHADER_STAGE_ALL_GRAPHICS, shaderStages, shaderModules)) {
+            return nullptr;
+        }
+        
+        std::cout << "GraphicsPipelineFactory: All shaders loaded successfully, total stages: " << shaderStages.size() << std::endl;
+        
+        VkGraphicsPipelineCreateInfo pipelineInfo{};
+        pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+        pipelineInfo.pNext = state.renderPass == VK_NULL_HANDLE ? &infos.renderingInfo : nullptr;
+        pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+        pipelineInfo.pStages = shaderStages.data();
+        pipelineInfo.pVertexInputState = &infos.vertexInputInfo;
+        pipelineInfo.pInputAssemblyState = &infos.inputAssemblyInfo;
+        pipelineInfo.pViewportState = &infos.viewportInfo;
+        pipelineInfo.pRasterizationState = &infos.rasterizationInfo;
+        pipelineInfo.pMultisampleState = &infos.multisampleInfo;
+        pipelineInfo.pColorBlendState = &infos.colorBlendInfo;
+        pipelineInfo.pDynamicState = &infos.dynamicStateInfo;
+        // Ignored without a depth attachment, required with one even when the test is off
+        pipelineInfo.pDepthStencilState = &infos.depthStencilInfo;
+        pipelineInfo.layout = cachedPipeline->layout.get();
+        pipelineInfo.renderPass = state.renderPass;
+        pipelineInfo.subpass = state.subpass;
+        pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+        if (context->supportsPipelineExecutableInfo()) {
+            pipelineInfo.flags |= VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR;
+        }
+        
+        std::cout << "GraphicsPipelineFactory: Creating graphics pipeline with parameters:" << std::endl;
+        std::cout << "  Pipeline layout: " << (void*)cachedPipeline->layout << std::endl;
+        std::cout << "  Pipeline cache: " << (void*)pipelineCache_ << std::endl;
+        std::cout << "  Render pass: " << (void*)state.renderPass << std::endl;
+        std::cout << "  Subpass: " << state.subpass << std::endl;
+        std::cout << "  Shader stages count: " << pipelineInfo.stageCount << std::endl;
+        std::cout << "  About to call vkCreateGraphicsPipelines..." << std::endl;
+        
+        VkResult result = createGraphicsPipelines(pipelineCache_->get(), 1, &pipelineInfo, &rawPipeline);
+        
+        if (result != VK_SUCCESS) {
+            std::cerr << "GraphicsPipelineFactory: CRITICAL ERROR - Failed to create graphics pipeline!" << std::endl;
+            std::cerr << "  VkResult: " << result << std::endl;
+            std::cerr << "  Pipeline layout valid: " << (cachedPipeline->layout ? "YES" : "NO") << std::endl;
+            std::cerr << "  Pipeline cache valid: " << (pipelineCache_ ? "YES" : "NO") << std::endl;
+            std::cerr << "  Render pass valid: " << (state.renderPass != VK_NULL_HANDLE ? "YES" : "NO") << std::endl;
+            std::cerr << "  Device valid: " << (context->getDevice() != VK_NULL_HANDLE ? "YES" : "NO") << std::endl;
+            
+            return nullptr;
+        } else {
+            std::cout << "GraphicsPipelineFactory: Graphics pipeline created successfully!" << std::endl;
+        }
     }
     
+    cachedPipeline->pipeline = vulkan_raii::make_pipeline(rawPipeline, context);
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    cachedPipeline->compilationTime = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+    
+    if (context->supportsPipelineExecutableInfo()) {
+        cachedPipeline->executableStats = PipelineUtils::queryExecutableStatistics(device, *loader, rawPipeline);
+    }
+    
+    logPipelineCreation(state, cachedPipeline->compilationTime);
+    PipelineUtils::logExecutableStatistics(PipelineUtils::describeShaders(state.shaderStages), cachedPipeline->executableStats);
+    
+    return cachedPipeline;
+}
+
+void GraphicsPipelineFactory::clearLibraries() {
+    std::lock_guard<std::mutex> lock(librariesMutex_);
+    libraries_.clear();
+}
+
+size_t GraphicsPipelineFactory::getLibraryCount() const {
+    std::lock_guard<std::mutex> lock(librariesMutex_);
+    return libraries_.size();
+}
+
+void GraphicsPipelineFactory::buildCreateInfos(const GraphicsPipelineState& state, CreateInfos& infos) const {
+    infos.vertexInputInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VERTEX_INPUT_STATE_CREATE_INFO;
+    infos.vertexInputInfo.vertexBindingDescriptionCount = static_cast<uint32_t>(state.vertexBindings.size());
+    infos.vertexInputInfo.pVertexBindingDescriptions = state.vertexBindings.data();
+    infos.vertexInputInfo.vertexAttributeDescriptionCount = static_cast<uint32_t>(state.vertexAttributes.size());
+    infos.vertexInputInfo.pVertexAttributeDescriptions = state.vertexAttributes.data();
+    
+    infos.inputAssemblyInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INPUT_ASSEMBLY_STATE_CREATE_INFO;
+    infos.inputAssemblyInfo.topology = state.topology;
+    infos.inputAssemblyInfo.primitiveRestartEnable = state.primitiveRestartEnable;
+    
+    infos.viewportInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_VIEWPORT_STATE_CREATE_INFO;
+    infos.viewportInfo.viewportCount = state.viewportCount;
+    infos.viewportInfo.scissorCount = state.scissorCount;
+    
+    infos.rasterizationInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RASTERIZATION_STATE_CREATE_INFO;
+    infos.rasterizationInfo.depthClampEnable = state.depthClampEnable;
+    infos.rasterizationInfo.rasterizerDiscardEnable = state.rasterizerDiscardEnable;
+    infos.rasterizationInfo.polygonMode = state.polygonMode;
+    infos.rasterizationInfo.lineWidth = state.lineWidth;
+    infos.rasterizationInfo.cullMode = state.cullMode;
+    infos.rasterizationInfo.frontFace = state.frontFace;
+    infos.rasterizationInfo.depthBiasEnable = state.depthBiasEnable;
+    
+    infos.multisampleInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_MULTISAMPLE_STATE_CREATE_INFO;
+    infos.multisampleInfo.sampleShadingEnable = state.sampleShadingEnable;
+    infos.multisampleInfo.rasterizationSamples = state.rasterizationSamples;
+    infos.multisampleInfo.minSampleShading = state.minSampleShading;
+    
+    infos.colorBlendInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_COLOR_BLEND_STATE_CREATE_INFO;
+    infos.colorBlendInfo.logicOpEnable = state.logicOpEnable;
+    infos.colorBlendInfo.logicOp = state.logicOp;
+    infos.colorBlendInfo.attachmentCount = static_cast<uint32_t>(state.colorBlendAttachments.size());
+    infos.colorBlendInfo.pAttachments = state.colorBlendAttachments.data();
+    memcpy(infos.colorBlendInfo.blendConstants, state.blendConstants, sizeof(state.blendConstants));
+    
+    infos.dynamicStateInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DYNAMIC_STATE_CREATE_INFO;
+    infos.dynamicStateInfo.dynamicStateCount = static_cast<uint32_t>(state.dynamicStates.size());
+    infos.dynamicStateInfo.pDynamicStates = state.dynamicStates.data();
+    
+    infos.depthStencilInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_DEPTH_STENCIL_STATE_CREATE_INFO;
+    infos.depthStencilInfo.depthTestEnable = state.depthTestEnable;
+    infos.depthStencilInfo.depthWriteEnable = state.depthWriteEnable;
+    infos.depthStencilInfo.depthCompareOp = state.depthCompareOp;
+    infos.depthStencilInfo.stencilTestEnable = state.stencilTestEnable;
+    
+    // Specialization constants are shared by all stages; ids a stage does not declare are ignored
+    for (uint32_t i = 0; i < state.specializationConstants.size(); ++i) {
+        infos.specializationEntries.push_back({i, i * static_cast<uint32_t>(sizeof(uint32_t)), sizeof(uint32_t)});
+    }
+    infos.specializationInfo.mapEntryCount = static_cast<uint32_t>(infos.specializationEntries.size());
+    infos.specializationInfo.pMapEntries = infos.specializationEntries.data();
+    infos.specializationInfo.dataSize = state.specializationConstants.size() * sizeof(uint32_t);
+    infos.specializationInfo.pData = state.specializationConstants.data();
+    
+    // Without a render pass the attachment formats are declared on the pipeline itself
+    infos.colorAttachmentFormats[0] = state.colorAttachmentFormat;
+    infos.colorAttachmentFormats[1] = state.pickAttachmentFormat;
+    infos.renderingInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_RENDERING_CREATE_INFO_KHR;
+    infos.renderingInfo.colorAttachmentCount = state.pickAttachmentFormat != VK_FORMAT_UNDEFINED ? 2 : 1;
+    infos.renderingInfo.pColorAttachmentFormats = infos.colorAttachmentFormats;
+    infos.renderingInfo.depthAttachmentFormat = state.depthAttachmentFormat;
+}
+
+bool GraphicsPipelineFactory::loadShaderStages(const GraphicsPipelineState& state, const CreateInfos& infos,
+                                               VkShaderStageFlags stageMask,
+                                               std::vector<VkPipelineShaderStageCreateInfo>& shaderStages,
+                                               std::vector<VkShaderModule>& shaderModules) {
     for (const auto& shaderPath : state.shaderStages) {
+        VkShaderStageFlagBits stage = shaderManager_->getShaderStageFromFilename(shaderPath);
+        if ((stage & stageMask) == 0) {
+            continue;
+        }
+        
         std::cout << "GraphicsPipelineFactory: Loading shader: " << shaderPath << std::endl;
         VkShaderModule shaderModule = shaderManager_->loadSPIRVFromFile(shaderPath);
-        std::cout << "GraphicsPipelineFactory: Shader module: " << (void*)shaderModule << std::endl;
         
         if (shaderModule == VK_NULL_HANDLE) {
             std::cerr << "GraphicsPipelineFactory: CRITICAL ERROR - Failed to load graphics shader: " << shaderPath << std::endl;
             for (VkShaderModule module : shaderModules) {
                 destroyShaderModule(module);
             }
-            return nullptr;
+            shaderModules.clear();
+            return false;
         }
         
         shaderModules.push_back(shaderModule);
         
-        VkShaderStageFlagBits stage = shaderManager_->getShaderStageFromFilename(shaderPath);
-        std::cout << "GraphicsPipelineFactory: Shader stage determined: " << stage << std::endl;
-        
         VkPipelineShaderStageCreateInfo shaderStageInfo{};
         shaderStageInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_SHADER_STAGE_CREATE_INFO;
         shaderStageInfo.stage = stage;
         shaderStageInfo.module = shaderModule;
         shaderStageInfo.pName = "main";
+        if (!state.specializationConstants.empty()) {
+            shaderStageInfo.pSpecializationInfo = &infos.specializationInfo;
+        }
         
         shaderStages.push_back(shaderStageInfo);
-        std::cout << "GraphicsPipelineFactory: Added shader stage successfully" << std::endl;
     }
+    return true;
+}
+
+VkPipeline GraphicsPipelineFactory::linkFromLibraries(const GraphicsPipelineState& state, const CreateInfos& infos,
+                                                      VkPipelineLayout layout) {
+    constexpr GraphicsPipelineLibraryPart parts[] = {
+        GraphicsPipelineLibraryPart::VertexInput, GraphicsPipelineLibraryPart::PreRasterization,
+        GraphicsPipelineLibraryPart::FragmentShader, GraphicsPipelineLibraryPart::FragmentOutput};
     
-    std::cout << "GraphicsPipelineFactory: All shaders loaded successfully, total stages: " << shaderStages.size() << std::endl;
+    // The shared pointers keep each part alive through the link even if clearLibraries runs meanwhile
+    std::shared_ptr<vulkan_raii::Pipeline> libraries[GRAPHICS_PIPELINE_LIBRARY_PARTS];
+    VkPipeline libraryHandles[GRAPHICS_PIPELINE_LIBRARY_PARTS];
+    for (uint32_t i = 0; i < GRAPHICS_PIPELINE_LIBRARY_PARTS; ++i) {
+        libraries[i] = getLibrary(parts[i], state, infos, layout);
+        if (!libraries[i]) {
+            return VK_NULL_HANDLE;
+        }
+        libraryHandles[i] = libraries[i]->get();
+    }
+    
+    VkPipelineLibraryCreateInfoKHR libraryInfo{};
+    libraryInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_LIBRARY_CREATE_INFO_KHR;
+    libraryInfo.libraryCount = GRAPHICS_PIPELINE_LIBRARY_PARTS;
+    libraryInfo.pLibraries = libraryHandles;
     
+    // Fast link without link-time optimization: the point is a permutation ready within the frame it is needed
     VkGraphicsPipelineCreateInfo pipelineInfo{};
     pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
-    pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
-    pipelineInfo.pStages = shaderStages.data();
-    pipelineInfo.pVertexInputState = &vertexInputInfo;
-    pipelineInfo.pInputAssemblyState = &inputAssemblyInfo;
-    pipelineInfo.pViewportState = &viewportInfo;
-    pipelineInfo.pRasterizationState = &rasterizationInfo;
-    pipelineInfo.pMultisampleState = &multisampleInfo;
-    pipelineInfo.pColorBlendState = &colorBlendInfo;
-    pipelineInfo.pDynamicState = &dynamicStateInfo;
-    pipelineInfo.pDepthStencilState = state.depthTestEnable ? &depthStencilInfo : nullptr;
-    pipelineInfo.layout = cachedPipeline->layout.get();
-    pipelineInfo.renderPass = state.renderPass;
-    pipelineInfo.subpass = state.subpass;
+    pipelineInfo.pNext = &libraryInfo;
+    pipelineInfo.layout = layout;
     pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+    if (context->supportsPipelineExecutableInfo()) {
+        pipelineInfo.flags |= VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR;
+    }
     
-    std::cout << "GraphicsPipelineFactory: Creating graphics pipeline with parameters:" << std::endl;
-    std::cout << "  Pipeline layout: " << (void*)cachedPipeline->layout << std::endl;
-    std::cout << "  Pipeline cache: " << (void*)pipelineCache_ << std::endl;
-    std::cout << "  Render pass: " << (void*)state.renderPass << std::endl;
-    std::cout << "  Subpass: " << state.subpass << std::endl;
-    std::cout << "  Shader stages count: " << pipelineInfo.stageCount << std::endl;
-    std::cout << "  About to call vkCreateGraphicsPipelines..." << std::endl;
+    VkPipeline rawPipeline = VK_NULL_HANDLE;
+    if (createGraphicsPipelines(pipelineCache_->get(), 1, &pipelineInfo, &rawPipeline) != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+    std::cout << "GraphicsPipelineFactory: Linked graphics pipeline from libraries" << std::endl;
+    return rawPipeline;
+}
+
+std::shared_ptr<vulkan_raii::Pipeline> GraphicsPipelineFactory::getLibrary(GraphicsPipelineLibraryPart part,
+                                                                          const GraphicsPipelineState& state,
+                                                                          const CreateInfos& infos,
+                                                                          VkPipelineLayout layout) {
+    const VulkanHash::PipelineKey key = buildLibraryKey(part, state);
+    {
+        std::lock_guard<std::mutex> lock(librariesMutex_);
+        auto it = libraries_.find(key);
+        if (it != libraries_.end()) {
+            return it->second;
+        }
+    }
+    
+    VkGraphicsPipelineLibraryCreateInfoEXT libraryInfo{};
+    libraryInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_LIBRARY_CREATE_INFO_EXT;
+    libraryInfo.flags = libraryFlag(part);
+    
+    VkGraphicsPipelineCreateInfo pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_GRAPHICS_PIPELINE_CREATE_INFO;
+    pipelineInfo.pNext = &libraryInfo;
+    pipelineInfo.flags = VK_PIPELINE_CREATE_LIBRARY_BIT_KHR;
+    if (context->supportsPipelineExecutableInfo()) {
+        pipelineInfo.flags |= VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR;
+    }
+    pipelineInfo.pDynamicState = &infos.dynamicStateInfo;
+    pipelineInfo.basePipelineHandle = VK_NULL_HANDLE;
+    if (part != GraphicsPipelineLibraryPart::VertexInput) {
+        pipelineInfo.renderPass = state.renderPass;
+        pipelineInfo.subpass = state.subpass;
+        if (state.renderPass == VK_NULL_HANDLE) {
+            libraryInfo.pNext = &infos.renderingInfo;
+        }
+    }
     
-    VkPipeline rawPipeline;
-    VkResult result = createGraphicsPipelines(pipelineCache_->get(), 1, &pipelineInfo, &rawPipeline);
+    std::vector<VkPipelineShaderStageCreateInfo> shaderStages;
+    std::vector<VkShaderModule> shaderModules;
+    switch (part) {
+        case GraphicsPipelineLibraryPart::VertexInput:
+            pipelineInfo.pVertexInputState = &infos.vertexInputInfo;
+            pipelineInfo.pInputAssemblyState = &infos.inputAssemblyInfo;
+            break;
+        case GraphicsPipelineLibraryPart::PreRasterization:
+            if (!loadShaderStages(state, infos, PRE_RASTERIZATION_STAGES, shaderStages, shaderModules)) {
+                return nullptr;
+            }
+            pipelineInfo.pViewportState = &infos.viewportInfo;
+            pipelineInfo.pRasterizationState = &infos.rasterizationInfo;
+            pipelineInfo.layout = layout;
+            break;
+        case GraphicsPipelineLibraryPart::FragmentShader:
+            if (!loadShaderStages(state, infos, VK_SHADER_STAGE_FRAGMENT_BIT, shaderStages, shaderModules)) {
+                return nullptr;
+            }
+            pipelineInfo.pMultisampleState = &infos.multisampleInfo;
+            pipelineInfo.pDepthStencilState = &infos.depthStencilInfo;
+            pipelineInfo.layout = layout;
+            break;
+        case GraphicsPipelineLibraryPart::FragmentOutput:
+            pipelineInfo.pMultisampleState = &infos.multisampleInfo;
+            pipelineInfo.pColorBlendState = &infos.colorBlendInfo;
+            break;
+    }
+    pipelineInfo.stageCount = static_cast<uint32_t>(shaderStages.size());
+    pipelineInfo.pStages = shaderStages.data();
     
+    VkPipeline rawLibrary = VK_NULL_HANDLE;
+    VkResult result = createGraphicsPipelines(pipelineCache_->get(), 1, &pipelineInfo, &rawLibrary);
     if (result != VK_SUCCESS) {
-        std::cerr << "GraphicsPipelineFactory: CRITICAL ERROR - Failed to create graphics pipeline!" << std::endl;
-        std::cerr << "  VkResult: " << result << std::endl;
-        std::cerr << "  Pipeline layout valid: " << (cachedPipeline->layout ? "YES" : "NO") << std::endl;
-        std::cerr << "  Pipeline cache valid: " << (pipelineCache_ ? "YES" : "NO") << std::endl;
-        std::cerr << "  Render pass valid: " << (state.renderPass != VK_NULL_HANDLE ? "YES" : "NO") << std::endl;
-        std::cerr << "  Device valid: " << (context->getDevice() != VK_NULL_HANDLE ? "YES" : "NO") << std::endl;
-        
+        std::cerr << "GraphicsPipelineFactory: Failed to create pipeline library part " << static_cast<uint32_t>(part)
+                  << " (VkResult: " << result << ")" << std::endl;
         return nullptr;
-    } else {
-        std::cout << "GraphicsPipelineFactory: Graphics pipeline created successfully!" << std::endl;
     }
     
-    cachedPipeline->pipeline = vulkan_raii::make_pipeline(rawPipeline, context);
+    // Another compile may have built the same part meanwhile; the first one stored is shared and this one dropped
+    auto library = std::make_shared<vulkan_raii::Pipeline>(vulkan_raii::make_pipeline(rawLibrary, context));
+    std::lock_guard<std::mutex> lock(librariesMutex_);
+    return libraries_.emplace(key, std::move(library)).first->second;
+}
+
+VulkanHash::PipelineKey GraphicsPipelineFactory::buildLibraryKey(GraphicsPipelineLibraryPart part,
+                                                                 const GraphicsPipelineState& state) const {
+    VulkanHash::PipelineKeyBuilder builder(128);
+    builder.add(static_cast<uint32_t>(part)).addContainer(state.dynamicStates);
     
-    auto endTime = std::chrono::high_resolution_clock::now();
-    cachedPipeline->compilationTime = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+    auto addShaders = [&](VkShaderStageFlags stageMask) {
+        for (const auto& shaderPath : state.shaderStages) {
+            if ((shaderManager_->getShaderStageFromFilename(shaderPath) & stageMask) != 0) {
+                builder.add(shaderPath);
+            }
+        }
+        builder.addContainer(state.specializationConstants)
+               .addContainer(state.descriptorSetLayouts);
+        for (const auto& range : state.pushConstantRanges) {
+            builder.add(range.stageFlags)
+                   .add(range.offset)
+                   .add(range.size);
+        }
+    };
     
-    logPipelineCreation(state, cachedPipeline->compilationTime);
+    if (part != GraphicsPipelineLibraryPart::VertexInput) {
+        builder.add(state.renderPass)
+               .add(state.subpass);
+    }
     
-    return cachedPipeline;
+    switch (part) {
+        case GraphicsPipelineLibraryPart::VertexInput:
+            for (const auto& binding : state.vertexBindings) {
+                builder.add(binding.binding)
+                       .add(binding.stride)
+                       .add(binding.inputRate);
+            }
+            for (const auto& attr : state.vertexAttributes) {
+                builder.add(attr.location)
+                       .add(attr.binding)
+                       .add(attr.format)
+                       .add(attr.offset);
+            }
+            builder.add(state.topology)
+                   .add(state.primitiveRestartEnable);
+            break;
+        case GraphicsPipelineLibraryPart::PreRasterization:
+            addShaders(PRE_RASTERIZATION_STAGES);
+            builder.add(state.viewportCount)
+                   .add(state.scissorCount)
+                   .add(state.depthClampEnable)
+                   .add(state.rasterizerDiscardEnable)
+                   .add(state.polygonMode)
+                   .add(state.cullMode)
+                   .add(state.frontFace)
+                   .add(state.depthBiasEnable)
+                   .add(state.lineWidth);
+            break;
+        case GraphicsPipelineLibraryPart::FragmentShader:
+            addShaders(VK_SHADER_STAGE_FRAGMENT_BIT);
+            builder.add(state.rasterizationSamples)
+                   .add(state.sampleShadingEnable)
+                   .add(state.minSampleShading)
+                   .add(state.depthTestEnable)
+                   .add(state.depthWriteEnable)
+                   .add(state.depthCompareOp)
+                   .add(state.stencilTestEnable);
+            break;
+        case GraphicsPipelineLibraryPart::FragmentOutput:
+            builder.add(state.rasterizationSamples)
+                   .add(state.sampleShadingEnable)
+                   .add(state.minSampleShading)
+                   .add(state.logicOpEnable)
+                   .add(state.logicOp)
+                   .add(state.colorAttachmentFormat)
+                   .add(state.depthAttachmentFormat)
+                   .add(state.pickAttachmentFormat);
+            for (const auto& attachment : state.colorBlendAttachments) {
+                builder.add(attachment.colorWriteMask)
+                       .add(attachment.blendEnable)
+                       .add(attachment.srcColorBlendFactor)
+                       .add(attachment.dstColorBlendFactor)
+                       .add(attachment.colorBlendOp)
+                       .add(attachment.srcAlphaBlendFactor)
+                       .add(attachment.dstAlphaBlendFactor)
+                       .add(attachment.alphaBlendOp);
+            }
+            for (float constant : state.blendConstants) {
+                builder.add(constant);
+            }
+            break;
+    }
+    return builder.build();
 }
 
 bool GraphicsPipelineFactory::validatePipelineState(const GraphicsPipelineState& state) const {
-    if (state.renderPass == VK_NULL_HANDLE) {
-        std::cerr << "Pipeline state validation failed: null render pass" << std::endl;
+    if (state.renderPass == VK_NULL_HANDLE && state.colorAttachmentFormat == VK_FORMAT_UNDEFINED) {
+        std::cerr << "Pipeline state validation failed: neither a render pass nor a dynamic rendering format" << std::endl;
         return false;
     }
     
@@ -191,8 +471,8 @@ bool GraphicsPipelineFactory::validatePipelineState(const GraphicsPipelineState&
     return true;
 }
 
-void GraphicsPipelineFactory::logPipelineCreation(const GraphicsPipelineState& state, 
+void GraphicsPipelineFactory::logPipelineCreation(const GraphicsPipelineState& state,
                                                  std::chrono::nanoseconds compilationTime) const {
-    std::cout << "Created graphics pipeline (compilation time: " 
+    std::cout << "Created graphics pipeline (compilation time: "
               << compilationTime.count() / 1000000.0f << "ms)" << std::endl;
 }
\ No newline at end of file
@@ -4,6 +4,9 @@
 #include <vulkan/vulkan.h>
 #include <memory>
 #include <chrono>
+#include <mutex>
+#include <unordered_map>
+#include <vector>
 #include "../core/vulkan_context.h"
 #include "../core/vulkan_manager_base.h"
 #include "../core/vulkan_raii.h"
@@ -13,6 +16,18 @@
 
 class ShaderManager;
 
+// The four VK_EXT_graphics_pipeline_library parts a pipeline is linked from
+enum class GraphicsPipelineLibraryPart : uint32_t {
+    VertexInput = 0,       // Vertex bindings, attributes, topology
+    PreRasterization = 1,  // Vertex shader, viewport, rasterization
+    FragmentShader = 2,    // Fragment shader, depth/stencil, sample shading
+    FragmentOutput = 3,    // Blending, sample count, attachment formats
+};
+constexpr uint32_t GRAPHICS_PIPELINE_LIBRARY_PARTS = 4;
+
+// Creates graphics pipelines on any thread. With supportsGraphicsPipelineLibrary each state is fast-linked from
+// four library parts, each cached under the key of only the state it holds, so permutations that differ in MSAA,
+// pick attachment or shader (mode switches) compile just the parts that changed; monolithic otherwise
 class GraphicsPipelineFactory : public VulkanManagerBase {
 public:
     explicit GraphicsPipelineFactory(VulkanContext* ctx);
@@ -21,12 +36,50 @@ public:
     bool initialize(ShaderManager* shaderManager, vulkan_raii::PipelineCache* pipelineCache);
     
     std::unique_ptr<CachedGraphicsPipeline> createPipeline(const GraphicsPipelineState& state);
+    
+    // Library parts are keyed by render pass, layout and shader path handles; drop them whenever those may be
+    // recreated or reloaded. Links already under way keep the parts they hold
+    void clearLibraries();
+    size_t getLibraryCount() const;
 
 private:
+    // Create infos shared by the monolithic and library paths; they point into each other, so built in place
+    struct CreateInfos {
+        VkPipelineVertexInputStateCreateInfo vertexInputInfo{};
+        VkPipelineInputAssemblyStateCreateInfo inputAssemblyInfo{};
+        VkPipelineViewportStateCreateInfo viewportInfo{};
+        VkPipelineRasterizationStateCreateInfo rasterizationInfo{};
+        VkPipelineMultisampleStateCreateInfo multisampleInfo{};
+        VkPipelineColorBlendStateCreateInfo colorBlendInfo{};
+        VkPipelineDynamicStateCreateInfo dynamicStateInfo{};
+        VkPipelineDepthStencilStateCreateInfo depthStencilInfo{};
+        std::vector<VkSpecializationMapEntry> specializationEntries;
+        VkSpecializationInfo specializationInfo{};
+        VkFormat colorAttachmentFormats[2] = {VK_FORMAT_UNDEFINED, VK_FORMAT_UNDEFINED};
+        VkPipelineRenderingCreateInfoKHR renderingInfo{};
+        
+        CreateInfos() = default;
+        CreateInfos(const CreateInfos&) = delete;
+        CreateInfos& operator=(const CreateInfos&) = delete;
+    };
+    
     ShaderManager* shaderManager_ = nullptr;
     vulkan_raii::PipelineCache* pipelineCache_ = nullptr;
     GraphicsPipelineLayoutBuilder layoutBuilder_;
     
+    mutable std::mutex librariesMutex_;
+    std::unordered_map<VulkanHash::PipelineKey, std::shared_ptr<vulkan_raii::Pipeline>, VulkanHash::PipelineKeyHash> libraries_;
+    
+    void buildCreateInfos(const GraphicsPipelineState& state, CreateInfos& infos) const;
+    // Stages of state whose stage bit is in stageMask; modules belong to the ShaderManager
+    bool loadShaderStages(const GraphicsPipelineState& state, const CreateInfos& infos, VkShaderStageFlags stageMask,
+                          std::vector<VkPipelineShaderStageCreateInfo>& shaderStages,
+                          std::vector<VkShaderModule>& shaderModules);
+    VkPipeline linkFromLibraries(const GraphicsPipelineState& state, const CreateInfos& infos, VkPipelineLayout layout);
+    std::shared_ptr<vulkan_raii::Pipeline> getLibrary(GraphicsPipelineLibraryPart part, const GraphicsPipelineState& state,
+                                                      const CreateInfos& infos, VkPipelineLayout layout);
+    VulkanHash::PipelineKey buildLibraryKey(GraphicsPipelineLibraryPart part, const GraphicsPipelineState& state) const;
+    
     bool validatePipelineState(const GraphicsPipelineState& state) const;
     void logPipelineCreation(const GraphicsPipelineState& state, 
                            std::chrono::nanoseconds compilationTime) const;
@@ -1,7 +1,10 @@
 #include "graphics_pipeline_manager.h"
 #include "shader_manager.h"
 #include "descriptor_layout_manager.h"
+#include "pipeline_cache_store.h"
+#include "../core/deletion_queue.h"
 #include "../core/vulkan_constants.h"
+#include "../../ecs/utilities/job_system.h"
 #include <iostream>
 #include <glm/glm.hpp>
 
@@ -19,16 +22,16 @@ GraphicsPipelineManager::~GraphicsPipelineManager() {
 }
 
 bool GraphicsPipelineManager::initialize(ShaderManager* shaderManager,
-                                       DescriptorLayoutManager* layoutManager) {
+                                       DescriptorLayoutManager* layoutManager,
+                                       PipelineCacheStore* cacheStore,
+                                       DeletionQueue* deletionQueue) {
     shaderManager_ = shaderManager;
     layoutManager_ = layoutManager;
+    cacheStore_ = cacheStore;
+    cache_.setDeletionQueue(deletionQueue);
+    renderPassManager_.setDeletionQueue(deletionQueue);
     
-    VkPipelineCacheCreateInfo cacheInfo{};
-    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-    cacheInfo.initialDataSize = 0;
-    cacheInfo.pInitialData = nullptr;
-    
-    pipelineCache_ = vulkan_raii::create_pipeline_cache(context, &cacheInfo);
+    pipelineCache_ = createPipelineCache();
     if (!pipelineCache_) {
         std::cerr << "Failed to create graphics pipeline cache" << std::endl;
         return false;
@@ -52,13 +55,25 @@ void GraphicsPipelineManager::cleanupBeforeContextDestruction() {
     
     clearCache();
     renderPassManager_.clearCache();
+    if (cacheStore_ && pipelineCache_) {
+        cacheStore_->save("graphics", pipelineCache_.get());
+    }
     pipelineCache_.reset();
     
     context = nullptr;
 }
 
 VkPipeline GraphicsPipelineManager::getPipeline(const GraphicsPipelineState& state) {
-    VkPipeline cachedPipeline = cache_.getPipeline(state);
+    return getPipeline(state.getKey(), state);
+}
+
+VkPipeline GraphicsPipelineManager::getPipeline(const VulkanHash::PipelineKey& key, const GraphicsPipelineState& state) {
+    // A state already compiling in the background is waited for rather than compiled twice
+    if (asyncCompilations_.count(key)) {
+        adoptAsyncCompilation(key);
+    }
+    
+    VkPipeline cachedPipeline = cache_.getPipeline(key);
     if (cachedPipeline != VK_NULL_HANDLE) {
         return cachedPipeline;
     }
@@ -70,23 +85,81 @@ VkPipeline GraphicsPipelineManager::getPipeline(const GraphicsPipelineState& sta
     }
     
     VkPipeline pipeline = newPipeline->pipeline.get();
-    cache_.storePipeline(state, std::move(newPipeline));
+    cache_.storePipeline(key, std::move(newPipeline));
     
     return pipeline;
 }
 
 VkPipelineLayout GraphicsPipelineManager::getPipelineLayout(const GraphicsPipelineState& state) {
-    VkPipelineLayout cachedLayout = cache_.getPipelineLayout(state);
+    const auto key = state.getKey();
+    VkPipelineLayout cachedLayout = cache_.getPipelineLayout(key);
     if (cachedLayout != VK_NULL_HANDLE) {
         return cachedLayout;
     }
     
-    VkPipeline pipeline = getPipeline(state);
+    VkPipeline pipeline = getPipeline(key, state);
     if (pipeline == VK_NULL_HANDLE) {
         return VK_NULL_HANDLE;
     }
     
-    return cache_.getPipelineLayout(state);
+    return cache_.getPipelineLayout(key);
+}
+
+VkPipeline GraphicsPipelineManager::getPipelineIfReady(const GraphicsPipelineState& state) {
+    const auto key = state.getKey();
+    if (cache_.contains(key)) {
+        return cache_.getPipeline(key);
+    }
+    
+    auto asyncIt = asyncCompilations_.find(key);
+    if (asyncIt == asyncCompilations_.end() || asyncIt->second.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+        compileAsync(key, state);
+        return VK_NULL_HANDLE;
+    }
+    
+    adoptAsyncCompilation(key);
+    return cache_.contains(key) ? cache_.getPipeline(key) : VK_NULL_HANDLE;
+}
+
+bool GraphicsPipelineManager::compileAsync(const GraphicsPipelineState& state) {
+    return compileAsync(state.getKey(), state);
+}
+
+bool GraphicsPipelineManager::compileAsync(const VulkanHash::PipelineKey& key, const GraphicsPipelineState& state) {
+    if (!context || cache_.contains(key) || asyncCompilations_.count(key) || failedCompilations_.count(key)) {
+        return false;
+    }
+    
+    // The factory and layout builder hold no per-call state; shader loads are serialized by ShaderManager
+    asyncCompilations_.emplace(key, JobSystem::getInstance().async(JobPriority::Normal, [this, state]() {
+        return factory_.createPipeline(state);
+    }));
+    return true;
+}
+
+void GraphicsPipelineManager::waitForAsyncCompilations() {
+    while (!asyncCompilations_.empty()) {
+        const VulkanHash::PipelineKey key = asyncCompilations_.begin()->first;
+        adoptAsyncCompilation(key);
+    }
+}
+
+void GraphicsPipelineManager::adoptAsyncCompilation(const VulkanHash::PipelineKey& key) {
+    auto asyncIt = asyncCompilations_.find(key);
+    if (asyncIt == asyncCompilations_.end()) {
+        return;
+    }
+    
+    // Still queued, the compile may well run on this thread
+    JobSystem::getInstance().waitFor(asyncIt->second);
+    auto cachedPipeline = asyncIt->second.get();
+    asyncCompilations_.erase(asyncIt);
+    if (cachedPipeline) {
+        cache_.storePipeline(key, std::move(cachedPipeline));
+    } else {
+        std::cerr << "Failed to create graphics pipeline in the background" << std::endl;
+        failedCompilations_.insert(key);
+    }
 }
 
 std::vector<VkPipeline> GraphicsPipelineManager::createPipelinesBatch(const std::vector<GraphicsPipelineState>& states) {
@@ -104,8 +177,9 @@ std::vector<VkPipeline> GraphicsPipelineManager::createPipelinesBatch(const std:
 VkRenderPass GraphicsPipelineManager::createRenderPass(VkFormat colorFormat, 
                                                       VkFormat depthFormat,
                                                       VkSampleCountFlagBits samples,
-                                                      bool enableMSAA) {
-    return renderPassManager_.createRenderPass(colorFormat, depthFormat, samples, enableMSAA);
+                                                      bool enableMSAA,
+                                                      VkImageLayout outputLayout) {
+    return renderPassManager_.createRenderPass(colorFormat, depthFormat, samples, enableMSAA, outputLayout);
 }
 
 GraphicsPipelineState GraphicsPipelineManager::createDefaultState() {
@@ -157,7 +231,14 @@ void GraphicsPipelineManager::optimizeCache(uint64_t currentFrame) {
 }
 
 void GraphicsPipelineManager::clearCache() {
+    // Pending compiles reference the render passes cleared below, so they finish first
+    for (auto& [key, future] : asyncCompilations_) {
+        JobSystem::getInstance().waitFor(future);
+    }
+    asyncCompilations_.clear();
+    failedCompilations_.clear();
     cache_.clear();
+    factory_.clearLibraries();
     renderPassManager_.clearCache();
     ++generation_;
 }
@@ -176,12 +257,8 @@ bool GraphicsPipelineManager::recreatePipelineCache() {
     isRecreating_ = true;
     std::cout << "GraphicsPipelineManager: Recreating pipeline cache to prevent corruption" << std::endl;
     
-    // Wait for device idle to ensure no pipelines are in use
-    const auto& vk = context->getLoader();
-    const VkDevice device = context->getDevice();
-    vk.vkDeviceWaitIdle(device);
-    
-    // Clear caches in dependency order
+    // Clear caches in dependency order; what frames in flight still reference goes to the deletion queue,
+    // so the device keeps running
     clearCache();
     
     if (layoutManager_) {
@@ -195,13 +272,8 @@ bool GraphicsPipelineManager::recreatePipelineCache() {
         pipelineCache_.reset();
     }
     
-    // Create new pipeline cache
-    VkPipelineCacheCreateInfo cacheInfo{};
-    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
-    cacheInfo.initialDataSize = 0;
-    cacheInfo.pInitialData = nullptr;
-    
-    pipelineCache_ = vulkan_raii::create_pipeline_cache(context, &cacheInfo);
+    // Create new pipeline cache, seeded from the last blob loaded from or saved to disk
+    pipelineCache_ = createPipelineCache();
     if (!pipelineCache_) {
         std::cerr << "GraphicsPipelineManager: Failed to recreate pipeline cache" << std::endl;
         isRecreating_ = false;
@@ -215,15 +287,31 @@ bool GraphicsPipelineManager::recreatePipelineCache() {
     return true;
 }
 
+vulkan_raii::PipelineCache GraphicsPipelineManager::createPipelineCache() {
+    if (cacheStore_) {
+        return cacheStore_->createCache("graphics");
+    }
+    
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = 0;
+    cacheInfo.pInitialData = nullptr;
+    return vulkan_raii::create_pipeline_cache(context, &cacheInfo);
+}
+
 bool GraphicsPipelineManager::reloadPipeline(const GraphicsPipelineState& state) {
     if (!hotReloadEnabled_) {
         return false;
     }
     
-    if (cache_.contains(state)) {
+    const auto key = state.getKey();
+    if (cache_.contains(key)) {
+        // Library parts are keyed by shader path, so the reloaded shaders would otherwise link from the old ones
+        factory_.clearLibraries();
         auto newPipeline = factory_.createPipeline(state);
         if (newPipeline) {
-            cache_.storePipeline(state, std::move(newPipeline));
+            cache_.storePipeline(key, std::move(newPipeline));
+            ++generation_;
             return true;
         }
     }
@@ -232,17 +320,52 @@ bool GraphicsPipelineManager::reloadPipeline(const GraphicsPipelineState& state)
 }
 
 namespace GraphicsPipelinePresets {
+    EntityGeometryPath selectEntityGeometryPath(const VulkanContext& context) {
+        // Binning needs the count draw; every Vulkan 1.0 device can draw the other three, where the switches only
+        // trade vertex input for vertex pulling
+        if (ENABLE_ENTITY_SHAPE_BINNING && context.supportsDrawIndirectCount()) {
+            return EntityGeometryPath::BinnedMesh;
+        }
+        if (!ENABLE_PROCEDURAL_ENTITY_GEOMETRY) {
+            return EntityGeometryPath::IndexedMesh;
+        }
+        return ENABLE_EXPANDED_ENTITY_DRAW ? EntityGeometryPath::ProceduralExpanded : EntityGeometryPath::ProceduralInstanced;
+    }
+    
     GraphicsPipelineState createEntityRenderingState(VkRenderPass renderPass, 
-                                                    VkDescriptorSetLayout descriptorLayout) {
+                                                    VkDescriptorSetLayout descriptorLayout,
+                                                    bool compactLayout,
+                                                    EntityGeometryPath geometryPath) {
+        const bool proceduralGeometry = isProceduralGeometry(geometryPath);
         GraphicsPipelineState state{};
         state.renderPass = renderPass;
         state.descriptorSetLayouts.push_back(descriptorLayout);
         
         state.shaderStages = {
-            "shaders/vertex.vert.spv",
+            proceduralGeometry ? "shaders/vertex.procedural.vert.spv" : "shaders/vertex.vert.spv",
             "shaders/fragment.frag.spv"
         };
         
+        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | 
+                                             VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        colorBlendAttachment.blendEnable = VK_FALSE;
+        state.colorBlendAttachments.push_back(colorBlendAttachment);
+        
+        // Same constant_id as the compute presets; constant_id 0 is unused by the entity shaders
+        if (compactLayout) {
+            state.specializationConstants = {0u, 1u};
+        }
+        if (geometryPath == EntityGeometryPath::ProceduralExpanded) {
+            state.specializationConstants.resize(2, 0u);
+            state.specializationConstants.push_back(1u);
+        }
+        
+        // Corners come from gl_VertexIndex, so the pipeline has no vertex input at all
+        if (proceduralGeometry) {
+            return state;
+        }
+        
         VkVertexInputBindingDescription vertexBinding{};
         vertexBinding.binding = 0;
         vertexBinding.stride = sizeof(glm::vec3) + sizeof(glm::vec3);
@@ -266,12 +389,243 @@ namespace GraphicsPipelinePresets {
         colorAttr.offset = sizeof(glm::vec3);
         state.vertexAttributes.push_back(colorAttr);
         
+        return state;
+    }
+    
+    GraphicsPipelineState createEntityDensityState(VkRenderPass renderPass, VkDescriptorSetLayout descriptorLayout) {
+        GraphicsPipelineState state{};
+        state.renderPass = renderPass;
+        state.descriptorSetLayouts.push_back(descriptorLayout);
+        state.shaderStages = {
+            "shaders/entity_density.vert.spv",
+            "shaders/fragment.frag.spv"
+        };
+        
         VkPipelineColorBlendAttachmentState colorBlendAttachment{};
         colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | 
                                              VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
         colorBlendAttachment.blendEnable = VK_FALSE;
         state.colorBlendAttachments.push_back(colorBlendAttachment);
         
+        // Tile corners come from gl_VertexIndex, so there is no vertex input
         return state;
     }
+    
+    // Binding-mode variants keep the geometry variant: vertex[.procedural].<mode>.vert.spv
+    static void selectEntityVertexVariant(GraphicsPipelineState& state, const char* mode) {
+        if (state.shaderStages.empty()) {
+            return;
+        }
+        std::string& vertexShader = state.shaderStages[0];
+        const size_t suffix = vertexShader.rfind(".vert.spv");
+        if (suffix != std::string::npos) {
+            vertexShader.insert(suffix, std::string(".") + mode);
+        }
+    }
+    
+    void applyBindlessEntityTable(GraphicsPipelineState& state, VkDescriptorSetLayout tableLayout,
+                                  VkDescriptorSetLayout uniformLayout) {
+        state.descriptorSetLayouts = {tableLayout, uniformLayout};
+        selectEntityVertexVariant(state, "bindless");
+        
+        // entityTable, selecting the working or a published snapshot view per draw
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(uint64_t);
+        state.pushConstantRanges = {pushConstant};
+    }
+    
+    void applyEntityStreamAddresses(GraphicsPipelineState& state, VkDescriptorSetLayout uniformLayout) {
+        state.descriptorSetLayouts = {uniformLayout};
+        selectEntityVertexVariant(state, "bda");
+        
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(uint64_t);
+        state.pushConstantRanges = {pushConstant};
+    }
+    
+    void applyDynamicRendering(GraphicsPipelineState& state, VkFormat colorFormat, VkFormat depthFormat) {
+        state.renderPass = VK_NULL_HANDLE;
+        state.subpass = 0;
+        state.colorAttachmentFormat = colorFormat;
+        state.depthAttachmentFormat = depthFormat;
+    }
+    
+    GraphicsPipelineState createUIRenderingState(VkRenderPass renderPass) {
+        GraphicsPipelineState state{};
+        state.renderPass = renderPass;
+        state.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        state.shaderStages = {
+            "shaders/hud_overlay.vert.spv",
+            "shaders/hud_overlay.frag.spv"
+        };
+        
+        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT | 
+                                             VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        colorBlendAttachment.blendEnable = VK_TRUE;
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        state.colorBlendAttachments.push_back(colorBlendAttachment);
+        
+        // Position, size, glyph and colour per quad; corners come from gl_VertexIndex
+        VkVertexInputBindingDescription instanceBinding{};
+        instanceBinding.binding = 0;
+        instanceBinding.stride = sizeof(glm::uvec4);
+        instanceBinding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+        state.vertexBindings.push_back(instanceBinding);
+        
+        VkVertexInputAttributeDescription quadAttr{};
+        quadAttr.binding = 0;
+        quadAttr.location = 0;
+        quadAttr.format = VK_FORMAT_R32G32B32A32_UINT;
+        quadAttr.offset = 0;
+        state.vertexAttributes.push_back(quadAttr);
+        
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(glm::vec2);
+        state.pushConstantRanges = {pushConstant};
+        return state;
+    }
+    
+    static GraphicsPipelineState createDebugOverlayState(VkRenderPass renderPass, const char* vertexShader) {
+        GraphicsPipelineState state{};
+        state.renderPass = renderPass;
+        state.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        state.shaderStages = {
+            vertexShader,
+            "shaders/debug_overlay.frag.spv"
+        };
+        
+        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                             VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        colorBlendAttachment.blendEnable = VK_TRUE;
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        state.colorBlendAttachments.push_back(colorBlendAttachment);
+        
+        // viewProjection, grid and params of DebugOverlayPushConstants (debug_overlay.glsl)
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_VERTEX_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(glm::mat4) + sizeof(glm::uvec4) + sizeof(glm::vec4);
+        state.pushConstantRanges = {pushConstant};
+        return state;
+    }
+    
+    static void addInstanceStream(GraphicsPipelineState& state, uint32_t binding, uint32_t stride, VkFormat format) {
+        VkVertexInputBindingDescription instanceBinding{};
+        instanceBinding.binding = binding;
+        instanceBinding.stride = stride;
+        instanceBinding.inputRate = VK_VERTEX_INPUT_RATE_INSTANCE;
+        state.vertexBindings.push_back(instanceBinding);
+        
+        VkVertexInputAttributeDescription attribute{};
+        attribute.binding = binding;
+        attribute.location = binding;
+        attribute.format = format;
+        attribute.offset = 0;
+        state.vertexAttributes.push_back(attribute);
+    }
+    
+    GraphicsPipelineState createDebugGridState(VkRenderPass renderPass) {
+        GraphicsPipelineState state = createDebugOverlayState(renderPass, "shaders/debug_grid.vert.spv");
+        
+        // The spatial map entries (start, count) are the instances; corners come from gl_VertexIndex
+        addInstanceStream(state, 0, sizeof(glm::uvec2), VK_FORMAT_R32G32_UINT);
+        return state;
+    }
+    
+    GraphicsPipelineState createDebugBoundsState(VkRenderPass renderPass) {
+        GraphicsPipelineState state = createDebugOverlayState(renderPass, "shaders/debug_bounds.vert.spv");
+        state.topology = VK_PRIMITIVE_TOPOLOGY_LINE_LIST;
+        state.specializationConstants = {DEBUG_OVERLAY_CIRCLE_SEGMENTS};
+        
+        // Position and velocity streams read in place, one entity per instance
+        addInstanceStream(state, 0, sizeof(glm::vec4), VK_FORMAT_R32G32B32A32_SFLOAT);
+        addInstanceStream(state, 1, sizeof(glm::vec4), VK_FORMAT_R32G32B32A32_SFLOAT);
+        return state;
+    }
+    
+    GraphicsPipelineState createOverdrawHeatMapState(VkRenderPass renderPass, VkDescriptorSetLayout countLayout) {
+        GraphicsPipelineState state{};
+        state.renderPass = renderPass;
+        state.rasterizationSamples = VK_SAMPLE_COUNT_1_BIT;
+        state.descriptorSetLayouts.push_back(countLayout);
+        state.shaderStages = {
+            "shaders/overdraw_heat_map.vert.spv",
+            "shaders/overdraw_heat_map.frag.spv"
+        };
+        
+        VkPipelineColorBlendAttachmentState colorBlendAttachment{};
+        colorBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT | VK_COLOR_COMPONENT_G_BIT |
+                                             VK_COLOR_COMPONENT_B_BIT | VK_COLOR_COMPONENT_A_BIT;
+        colorBlendAttachment.blendEnable = VK_TRUE;
+        colorBlendAttachment.srcColorBlendFactor = VK_BLEND_FACTOR_SRC_ALPHA;
+        colorBlendAttachment.dstColorBlendFactor = VK_BLEND_FACTOR_ONE_MINUS_SRC_ALPHA;
+        colorBlendAttachment.colorBlendOp = VK_BLEND_OP_ADD;
+        colorBlendAttachment.srcAlphaBlendFactor = VK_BLEND_FACTOR_ONE;
+        colorBlendAttachment.dstAlphaBlendFactor = VK_BLEND_FACTOR_ZERO;
+        colorBlendAttachment.alphaBlendOp = VK_BLEND_OP_ADD;
+        state.colorBlendAttachments.push_back(colorBlendAttachment);
+        
+        // renderScale and saturation of HeatMapPushConstants (overdraw_heat_map.frag), padded to a vec4
+        VkPushConstantRange pushConstant{};
+        pushConstant.stageFlags = VK_SHADER_STAGE_FRAGMENT_BIT;
+        pushConstant.offset = 0;
+        pushConstant.size = sizeof(glm::vec4);
+        state.pushConstantRanges = {pushConstant};
+        
+        // Corners come from gl_VertexIndex, so there is no vertex input
+        return state;
+    }
+    
+    void applyEntityEarlyDepth(GraphicsPipelineState& state) {
+        // Lower slots in front; slots sharing a depth value (D16 only) keep whichever was drawn first
+        state.depthTestEnable = VK_TRUE;
+        state.depthWriteEnable = VK_TRUE;
+        state.depthCompareOp = VK_COMPARE_OP_LESS;
+        state.specializationConstants.resize(3, 0u);
+        state.specializationConstants.push_back(1u);
+    }
+    
+    void applyEntityPickIds(GraphicsPipelineState& state) {
+        state.pickAttachmentFormat = ENTITY_PICK_FORMAT;
+        if (state.shaderStages.size() > 1) {
+            state.shaderStages[1] = "shaders/fragment.pick.frag.spv";
+        }
+        
+        // Integer attachment: written as is, never blended
+        VkPipelineColorBlendAttachmentState pickBlendAttachment{};
+        pickBlendAttachment.colorWriteMask = VK_COLOR_COMPONENT_R_BIT;
+        pickBlendAttachment.blendEnable = VK_FALSE;
+        state.colorBlendAttachments.resize(1);
+        state.colorBlendAttachments.push_back(pickBlendAttachment);
+        
+        state.specializationConstants.resize(4, 0u);
+        state.specializationConstants.push_back(1u);
+    }
+    
+    void applyEntityOverdrawCount(GraphicsPipelineState& state, VkDescriptorSetLayout countLayout) {
+        // Set 1 after the classic or buffer address set, set 2 after the bindless table and camera UBO
+        const bool afterTwoSets = state.descriptorSetLayouts.size() > 1;
+        state.descriptorSetLayouts.push_back(countLayout);
+        if (state.shaderStages.size() > 1) {
+            state.shaderStages[1] = afterTwoSets ? "shaders/fragment.overdraw.set2.frag.spv" : "shaders/fragment.overdraw.frag.spv";
+        }
+    }
 }
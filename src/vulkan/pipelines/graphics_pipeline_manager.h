@@ -7,6 +7,9 @@
 #include <memory>
 #include <functional>
 #include <chrono>
+#include <future>
+#include <unordered_map>
+#include <unordered_set>
 #include "../core/vulkan_context.h"
 #include "../core/vulkan_constants.h"
 #include "../core/vulkan_manager_base.h"
@@ -19,26 +22,42 @@
 
 class ShaderManager;
 class DescriptorLayoutManager;
+class PipelineCacheStore;
+class DeletionQueue;
 
 class GraphicsPipelineManager : public VulkanManagerBase {
 public:
     explicit GraphicsPipelineManager(VulkanContext* ctx);
     ~GraphicsPipelineManager();
 
+    // cacheStore and deletionQueue are optional, as for ComputePipelineManager; the queue also takes the
+    // render passes dropped by clearCache()
     bool initialize(ShaderManager* shaderManager,
-                   DescriptorLayoutManager* layoutManager);
+                   DescriptorLayoutManager* layoutManager,
+                   PipelineCacheStore* cacheStore = nullptr,
+                   DeletionQueue* deletionQueue = nullptr);
     void cleanup();
     void cleanupBeforeContextDestruction();
 
+    // Blocking: compiles on a miss, or waits for the state's background compile
     VkPipeline getPipeline(const GraphicsPipelineState& state);
     VkPipelineLayout getPipelineLayout(const GraphicsPipelineState& state);
     
+    // Non-blocking counterparts; same contract as ComputePipelineManager
+    VkPipeline getPipelineIfReady(const GraphicsPipelineState& state);
+    bool compileAsync(const GraphicsPipelineState& state);
+    size_t getPendingCompilationCount() const { return asyncCompilations_.size(); }
+    void waitForAsyncCompilations();
+    
     std::vector<VkPipeline> createPipelinesBatch(const std::vector<GraphicsPipelineState>& states);
     
+    // outputLayout is the single-sample output's final layout: PRESENT_SRC for the swapchain image,
+    // TRANSFER_SRC for a scaled image blitted to it afterwards
     VkRenderPass createRenderPass(VkFormat colorFormat, 
                                  VkFormat depthFormat = VK_FORMAT_UNDEFINED,
                                  VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
-                                 bool enableMSAA = false);
+                                 bool enableMSAA = false,
+                                 VkImageLayout outputLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
     
     GraphicsPipelineState createDefaultState();
     GraphicsPipelineState createMSAAState();
@@ -49,15 +68,18 @@ public:
     void optimizeCache(uint64_t currentFrame);
     void clearCache();
     
+    // No device wait; in-flight frames keep the retired pipelines and render passes until their slots come round
     bool recreatePipelineCache();
     
     DescriptorLayoutManager* getLayoutManager() { return layoutManager_; }
     const DescriptorLayoutManager* getLayoutManager() const { return layoutManager_; }
     
     PipelineStats getStats() const { return cache_.getStats(); }
+    void collectExecutableReports(std::vector<PipelineExecutableReport>& reports) const { cache_.collectExecutableReports(reports); }
     void resetFrameStats() { cache_.resetFrameStats(); }
     void debugPrintCache() const { cache_.debugPrintCache(); }
     
+    // Compiles the replacement first, then swaps it in and bumps the generation
     bool reloadPipeline(const GraphicsPipelineState& state);
     void enableHotReload(bool enable) { hotReloadEnabled_ = enable; }
 
@@ -66,6 +88,8 @@ public:
 
 private:
     vulkan_raii::PipelineCache pipelineCache_;
+    PipelineCacheStore* cacheStore_ = nullptr;
+    vulkan_raii::PipelineCache createPipelineCache();
     
     ShaderManager* shaderManager_ = nullptr;
     DescriptorLayoutManager* layoutManager_ = nullptr;
@@ -82,13 +106,90 @@ private:
     
     // Monotonic generation counter incremented on cache clear/recreate
     uint64_t generation_ = 0;
+    
+    // Background compiles, adopted into cache_ on the calling thread
+    std::unordered_map<VulkanHash::PipelineKey, std::future<std::unique_ptr<CachedGraphicsPipeline>>, VulkanHash::PipelineKeyHash> asyncCompilations_;
+    std::unordered_set<VulkanHash::PipelineKey, VulkanHash::PipelineKeyHash> failedCompilations_;
+    void adoptAsyncCompilation(const VulkanHash::PipelineKey& key);
+    
+    // Public entry points build the state's key once and pass it down
+    VkPipeline getPipeline(const VulkanHash::PipelineKey& key, const GraphicsPipelineState& state);
+    bool compileAsync(const VulkanHash::PipelineKey& key, const GraphicsPipelineState& state);
 };
 
 namespace GraphicsPipelinePresets {
+    // How entity triangles reach the rasterizer, cheapest first where the GPU allows it
+    enum class EntityGeometryPath : uint8_t {
+        IndexedMesh,          // PolygonFactory mesh from GraphicsResourceManager, one indexed instance per entity
+        BinnedMesh,           // Merged PolygonFactory mesh, one indexed draw per entity shape from a count draw
+        ProceduralInstanced,  // Corners from gl_VertexIndex, one non-indexed instance per entity
+        ProceduralExpanded    // Corners and entity from gl_VertexIndex, all visible entities in one instance
+    };
+    
+    // Path for entity rendering from ENABLE_ENTITY_SHAPE_BINNING (where the device draws indirect counts),
+    // ENABLE_PROCEDURAL_ENTITY_GEOMETRY and ENABLE_EXPANDED_ENTITY_DRAW. Mesh shading is not offered:
+    // VK_EXT_mesh_shader needs SPIR-V 1.4, beyond the Vulkan 1.0 instance
+    EntityGeometryPath selectEntityGeometryPath(const VulkanContext& context);
+    inline bool isProceduralGeometry(EntityGeometryPath path) {
+        return path != EntityGeometryPath::IndexedMesh && path != EntityGeometryPath::BinnedMesh;
+    }
+    
+    // compactLayout specialises vertex.vert for ENTITY_COMPACT_LAYOUT storage (constant_id 1); procedural paths
+    // select the vertex.procedural variant with no vertex input, drawn non-indexed (expanded: constant_id 2)
     GraphicsPipelineState createEntityRenderingState(VkRenderPass renderPass, 
-                                                    VkDescriptorSetLayout descriptorLayout);
+                                                    VkDescriptorSetLayout descriptorLayout,
+                                                    bool compactLayout = false,
+                                                    EntityGeometryPath geometryPath = EntityGeometryPath::IndexedMesh);
+    
+    // Density LOD heat map: entity_density.vert draws one quad instance per screen tile from the tile counts the
+    // culling pass left in the visible index buffer. Same descriptor and push constant layout as entity rendering,
+    // so the binding-mode variants below apply to it as well
+    GraphicsPipelineState createEntityDensityState(VkRenderPass renderPass, VkDescriptorSetLayout descriptorLayout);
+    
+    // Entity rendering against the bindless table (set 0) and the camera UBO set (set 1), with the
+    // table view base as a vertex push constant
+    void applyBindlessEntityTable(GraphicsPipelineState& state, VkDescriptorSetLayout tableLayout,
+                                  VkDescriptorSetLayout uniformLayout);
+    
+    // Entity rendering through the stream address table: only the camera UBO set (set 0), with the address
+    // of the view's stream addresses as a vertex push constant
+    void applyEntityStreamAddresses(GraphicsPipelineState& state, VkDescriptorSetLayout uniformLayout);
+    
+    // Dynamic rendering: drops the render pass for the colour attachment format, so the pipeline is compatible
+    // with any vkCmdBeginRenderingKHR on an attachment of that format and the state's sample count; depthFormat
+    // names the depth attachment rendering begins with, if any
+    void applyDynamicRendering(GraphicsPipelineState& state, VkFormat colorFormat, VkFormat depthFormat = VK_FORMAT_UNDEFINED);
+    
+    // ENABLE_ENTITY_EARLY_DEPTH: vertex.vert writes the entity slot depth (constant_id 3), tested LESS and written,
+    // so of overlapping entities only the lowest slot is shaded. Needs a render pass or rendering with depth
+    void applyEntityEarlyDepth(GraphicsPipelineState& state);
+    
+    // ENABLE_ENTITY_PICK_BUFFER: adds the R32_UINT pick attachment after the colour attachment, fragment.pick.frag
+    // and vertex.vert's spawn ID output (constant_id 4). Apply to an entity rendering state after
+    // applyDynamicRendering; the descriptor and push constant layouts are unchanged
+    void applyEntityPickIds(GraphicsPipelineState& state);
+    
+    // ENABLE_OVERDRAW_DIAGNOSTIC: fragment.overdraw.frag counts every shaded fragment into OverdrawMonitor's count
+    // image, its set appended after the binding mode's (so apply after applyBindlessEntityTable or
+    // applyEntityStreamAddresses). Applies to entity and density tile states alike; not combined with the pick ids
+    void applyEntityOverdrawCount(GraphicsPipelineState& state, VkDescriptorSetLayout countLayout);
     
     GraphicsPipelineState createWireframeOverlayState(VkRenderPass renderPass);
+    
+    // Performance HUD: hud_overlay.vert/.frag over the single-sampled output, alpha blended, one uvec4
+    // instance per quad (binding 0) and the pixel-to-clip scale as a vertex push constant; no descriptor sets
     GraphicsPipelineState createUIRenderingState(VkRenderPass renderPass);
+    
+    // Debug overlay (DebugOverlayNode), single-sampled and alpha blended like the HUD with debug_overlay.frag and
+    // the 96-byte DebugOverlayPushConstants as a vertex push constant; no descriptor sets. The grid state draws
+    // debug_grid.vert's cell quads from one spatial map entry per instance (binding 0), the bounds state
+    // debug_bounds.vert's line circles from one position (binding 0) and velocity (binding 1) per instance
+    GraphicsPipelineState createDebugGridState(VkRenderPass renderPass);
+    GraphicsPipelineState createDebugBoundsState(VkRenderPass renderPass);
+    
+    // Overdraw heat map (OverdrawNode): overdraw_heat_map.vert's full-screen triangle and overdraw_heat_map.frag
+    // reading the count image (OverdrawMonitor's set 0), single-sampled and alpha blended like the HUD, with the
+    // render scale and saturation as a fragment push constant
+    GraphicsPipelineState createOverdrawHeatMapState(VkRenderPass renderPass, VkDescriptorSetLayout countLayout);
     GraphicsPipelineState createShadowMappingState(VkRenderPass renderPass);
 }
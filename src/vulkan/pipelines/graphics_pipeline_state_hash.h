@@ -4,9 +4,11 @@
 #include <vulkan/vulkan.h>
 #include <vector>
 #include <string>
+#include "hash_utils.h"
 
 struct GraphicsPipelineState {
     std::vector<std::string> shaderStages;
+    std::vector<uint32_t> specializationConstants;  // constant_id = index, applied to every stage
     std::vector<VkVertexInputBindingDescription> vertexBindings;
     std::vector<VkVertexInputAttributeDescription> vertexAttributes;
     
@@ -46,22 +48,16 @@ struct GraphicsPipelineState {
     VkRenderPass renderPass = VK_NULL_HANDLE;
     uint32_t subpass = 0;
     
+    // Dynamic rendering (VK_KHR_dynamic_rendering): no render pass, the single colour attachment's format instead,
+    // and the depth attachment's when rendering has one
+    VkFormat colorAttachmentFormat = VK_FORMAT_UNDEFINED;
+    VkFormat depthAttachmentFormat = VK_FORMAT_UNDEFINED;
+    VkFormat pickAttachmentFormat = VK_FORMAT_UNDEFINED;  // Second colour attachment of entity pick frames
+    
     std::vector<VkDescriptorSetLayout> descriptorSetLayouts;
     std::vector<VkPushConstantRange> pushConstantRanges;
     
-    bool operator==(const GraphicsPipelineState& other) const;
-    size_t getHash() const;
+    // Interned cache key over every field; caches build it once per lookup
+    VulkanHash::PipelineKey getKey() const;
+    bool operator==(const GraphicsPipelineState& other) const { return getKey() == other.getKey(); }
 };
-
-class GraphicsPipelineStateHash {
-public:
-    std::size_t operator()(const GraphicsPipelineState& state) const {
-        return state.getHash();
-    }
-    
-    static bool compareStates(const GraphicsPipelineState& a, const GraphicsPipelineState& b);
-    static size_t hashPushConstantRanges(const std::vector<VkPushConstantRange>& ranges);
-    static size_t hashVertexBindings(const std::vector<VkVertexInputBindingDescription>& bindings);
-    static size_t hashVertexAttributes(const std::vector<VkVertexInputAttributeDescription>& attributes);
-    static size_t hashColorBlendAttachments(const std::vector<VkPipelineColorBlendAttachmentState>& attachments);
-};
\ No newline at end of file
@@ -1,5 +1,7 @@
 #include "graphics_render_pass_manager.h"
 #include "hash_utils.h"
+#include "../core/deletion_queue.h"
+#include <array>
 #include <iostream>
 
 GraphicsRenderPassManager::GraphicsRenderPassManager(VulkanContext* ctx) : VulkanManagerBase(ctx) {
@@ -8,8 +10,9 @@ GraphicsRenderPassManager::GraphicsRenderPassManager(VulkanContext* ctx) : Vulka
 VkRenderPass GraphicsRenderPassManager::createRenderPass(VkFormat colorFormat, 
                                                         VkFormat depthFormat,
                                                         VkSampleCountFlagBits samples,
-                                                        bool enableMSAA) {
-    size_t hash = createRenderPassHash(colorFormat, depthFormat, samples, enableMSAA);
+                                                        bool enableMSAA,
+                                                        VkImageLayout outputLayout) {
+    size_t hash = createRenderPassHash(colorFormat, depthFormat, samples, enableMSAA, outputLayout);
     
     auto it = renderPassCache_.find(hash);
     if (it != renderPassCache_.end()) {
@@ -29,7 +32,7 @@ VkRenderPass GraphicsRenderPassManager::createRenderPass(VkFormat colorFormat,
     colorAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
     colorAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
     colorAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-    colorAttachment.finalLayout = enableMSAA ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    colorAttachment.finalLayout = enableMSAA ? VK_IMAGE_LAYOUT_COLOR_ATTACHMENT_OPTIMAL : outputLayout;
     attachments.push_back(colorAttachment);
     
     VkAttachmentReference colorAttachmentRef{};
@@ -46,7 +49,7 @@ VkRenderPass GraphicsRenderPassManager::createRenderPass(VkFormat colorFormat,
         resolveAttachment.stencilLoadOp = VK_ATTACHMENT_LOAD_OP_DONT_CARE;
         resolveAttachment.stencilStoreOp = VK_ATTACHMENT_STORE_OP_DONT_CARE;
         resolveAttachment.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
-        resolveAttachment.finalLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+        resolveAttachment.finalLayout = outputLayout;
         attachments.push_back(resolveAttachment);
         
         resolveAttachmentRef.attachment = 1;
@@ -85,10 +88,29 @@ VkRenderPass GraphicsRenderPassManager::createRenderPass(VkFormat colorFormat,
     dependency.dstStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
     dependency.dstAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
     
+    // One depth image serves every frame in flight, so the clear waits for the previous pass's depth writes
     if (hasDepth) {
-        dependency.srcStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-        dependency.dstStageMask |= VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT;
-        dependency.dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        const VkPipelineStageFlags depthStages = VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+        dependency.srcStageMask |= depthStages;
+        dependency.srcAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+        dependency.dstStageMask |= depthStages;
+        dependency.dstAccessMask |= VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_READ_BIT | VK_ACCESS_DEPTH_STENCIL_ATTACHMENT_WRITE_BIT;
+    }
+    
+    // An offscreen output is read by a transfer after the pass (the upscale blit), and the blit of its last
+    // use must finish before the pass clears it again
+    std::array<VkSubpassDependency, 2> dependencies = {dependency, {}};
+    uint32_t dependencyCount = 1;
+    if (outputLayout == VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL) {
+        dependencies[0].srcStageMask |= VK_PIPELINE_STAGE_TRANSFER_BIT;
+        
+        VkSubpassDependency& outputDependency = dependencies[dependencyCount++];
+        outputDependency.srcSubpass = 0;
+        outputDependency.dstSubpass = VK_SUBPASS_EXTERNAL;
+        outputDependency.srcStageMask = VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+        outputDependency.srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT;
+        outputDependency.dstStageMask = VK_PIPELINE_STAGE_TRANSFER_BIT;
+        outputDependency.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
     }
     
     VkRenderPassCreateInfo renderPassInfo{};
@@ -97,8 +119,8 @@ VkRenderPass GraphicsRenderPassManager::createRenderPass(VkFormat colorFormat,
     renderPassInfo.pAttachments = attachments.data();
     renderPassInfo.subpassCount = 1;
     renderPassInfo.pSubpasses = &subpass;
-    renderPassInfo.dependencyCount = 1;
-    renderPassInfo.pDependencies = &dependency;
+    renderPassInfo.dependencyCount = dependencyCount;
+    renderPassInfo.pDependencies = dependencies.data();
     
     VkRenderPass renderPass;
     VkResult result = vkCreateRenderPassWrapper(&renderPassInfo, &renderPass);
@@ -117,11 +139,17 @@ VkRenderPass GraphicsRenderPassManager::createRenderPass(VkFormat colorFormat,
 
 void GraphicsRenderPassManager::clearCache() {
     std::cout << "GraphicsRenderPassManager: Clearing render pass cache (" << renderPassCache_.size() << " render passes)" << std::endl;
+    if (deletionQueue_) {
+        for (auto& [hash, renderPass] : renderPassCache_) {
+            deletionQueue_->retire(std::move(renderPass));
+        }
+    }
     renderPassCache_.clear();
     std::cout << "GraphicsRenderPassManager: Render pass cache cleared successfully" << std::endl;
 }
 
 size_t GraphicsRenderPassManager::createRenderPassHash(VkFormat colorFormat, VkFormat depthFormat, 
-                                                      VkSampleCountFlagBits samples, bool enableMSAA) const {
-    return VulkanHash::hash_combine(colorFormat, depthFormat, samples, enableMSAA);
+                                                      VkSampleCountFlagBits samples, bool enableMSAA,
+                                                      VkImageLayout outputLayout) const {
+    return VulkanHash::hash_combine(colorFormat, depthFormat, samples, enableMSAA, outputLayout);
 }
\ No newline at end of file
@@ -7,6 +7,8 @@
 #include "../core/vulkan_manager_base.h"
 #include "../core/vulkan_raii.h"
 
+class DeletionQueue;
+
 class GraphicsRenderPassManager : public VulkanManagerBase {
 public:
     explicit GraphicsRenderPassManager(VulkanContext* ctx);
@@ -15,14 +17,18 @@ public:
     VkRenderPass createRenderPass(VkFormat colorFormat, 
                                  VkFormat depthFormat = VK_FORMAT_UNDEFINED,
                                  VkSampleCountFlagBits samples = VK_SAMPLE_COUNT_1_BIT,
-                                 bool enableMSAA = false);
+                                 bool enableMSAA = false,
+                                 VkImageLayout outputLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR);
     
+    // Cleared render passes are retired to the queue when one is set, since pending frames may still use them
     void clearCache();
     size_t getCacheSize() const { return renderPassCache_.size(); }
+    void setDeletionQueue(DeletionQueue* deletionQueue) { deletionQueue_ = deletionQueue; }
 
 private:
     std::unordered_map<size_t, vulkan_raii::RenderPass> renderPassCache_;
+    DeletionQueue* deletionQueue_ = nullptr;
     
     size_t createRenderPassHash(VkFormat colorFormat, VkFormat depthFormat, 
-                               VkSampleCountFlagBits samples, bool enableMSAA) const;
+                               VkSampleCountFlagBits samples, bool enableMSAA, VkImageLayout outputLayout) const;
 };
\ No newline at end of file
@@ -2,6 +2,11 @@
 
 #include <functional>
 #include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <string>
+#include <type_traits>
+#include <utility>
 #include <vector>
 
 namespace VulkanHash {
@@ -82,4 +87,110 @@ inline size_t hash_shift_combine(size_t h1, size_t h2, size_t h3, size_t h4) {
     return h1 ^ (h2 << 1) ^ (h3 << 2) ^ (h4 << 3);
 }
 
+// 64-bit content hash of a byte range, wyhash-style: one 64x64->128 multiply-fold per 16 bytes. Stable within a
+// process only - keys built from it never leave memory
+inline uint64_t mix64(uint64_t a, uint64_t b) {
+#if defined(__SIZEOF_INT128__)
+    const __uint128_t product = static_cast<__uint128_t>(a) * b;
+    return static_cast<uint64_t>(product) ^ static_cast<uint64_t>(product >> 64);
+#else
+    const uint64_t aLow = a & 0xFFFFFFFFull, aHigh = a >> 32;
+    const uint64_t bLow = b & 0xFFFFFFFFull, bHigh = b >> 32;
+    const uint64_t lowLow = aLow * bLow, lowHigh = aLow * bHigh, highLow = aHigh * bLow, highHigh = aHigh * bHigh;
+    const uint64_t middle = (lowLow >> 32) + (lowHigh & 0xFFFFFFFFull) + (highLow & 0xFFFFFFFFull);
+    const uint64_t low = (middle << 32) | (lowLow & 0xFFFFFFFFull);
+    const uint64_t high = highHigh + (lowHigh >> 32) + (highLow >> 32) + (middle >> 32);
+    return low ^ high;
+#endif
+}
+
+inline uint64_t hashBytes(const void* data, size_t size, uint64_t seed = 0) {
+    constexpr uint64_t P0 = 0xa0761d6478bd642full;
+    constexpr uint64_t P1 = 0xe7037ed1a0b428dbull;
+    constexpr uint64_t P2 = 0x8ebc6af09c88c6e3ull;
+    
+    const uint8_t* bytes = static_cast<const uint8_t*>(data);
+    uint64_t state = seed ^ mix64(seed ^ P0, P1);
+    size_t remaining = size;
+    while (remaining > 16) {
+        uint64_t words[2];
+        std::memcpy(words, bytes, sizeof(words));
+        state = mix64(words[0] ^ P1, words[1] ^ state);
+        bytes += 16;
+        remaining -= 16;
+    }
+    
+    // Last 1-16 bytes, zero padded
+    uint64_t words[2] = {0, 0};
+    if (remaining > 0) {
+        std::memcpy(words, bytes, remaining);
+    }
+    return mix64(P2 ^ size, mix64(words[0] ^ P1, words[1] ^ state));
+}
+
+// Immutable, interned form of a cache key: the key's fields serialized into a byte blob, with the content hash
+// computed once when it is built. Equality tests the hash first, so a colliding bucket entry costs one integer
+// compare and only a match compares the blobs
+class PipelineKey {
+public:
+    PipelineKey() = default;
+    explicit PipelineKey(std::vector<uint8_t> bytes)
+        : bytes_(std::move(bytes)), hash_(hashBytes(bytes_.data(), bytes_.size())) {}
+    
+    uint64_t getHash() const { return hash_; }
+    const std::vector<uint8_t>& getBytes() const { return bytes_; }
+    
+    bool operator==(const PipelineKey& other) const {
+        return hash_ == other.hash_ && bytes_ == other.bytes_;
+    }
+    bool operator!=(const PipelineKey& other) const { return !(*this == other); }
+
+private:
+    std::vector<uint8_t> bytes_;
+    uint64_t hash_ = 0;
+};
+
+struct PipelineKeyHash {
+    size_t operator()(const PipelineKey& key) const { return static_cast<size_t>(key.getHash()); }
+};
+
+// Serializes fields into a PipelineKey. Only scalars (integers, enums, floats, handles) and strings are written,
+// each at its own size, so struct padding never reaches the blob; containers are prefixed with their length
+class PipelineKeyBuilder {
+public:
+    explicit PipelineKeyBuilder(size_t reserveBytes = 128) { bytes_.reserve(reserveBytes); }
+    
+    template<typename T>
+    PipelineKeyBuilder& add(const T& value) {
+        static_assert(std::is_scalar_v<T>, "PipelineKeyBuilder::add takes scalars; write struct fields one by one");
+        append(&value, sizeof(T));
+        return *this;
+    }
+    
+    PipelineKeyBuilder& add(const std::string& value) {
+        add(static_cast<uint32_t>(value.size()));
+        append(value.data(), value.size());
+        return *this;
+    }
+    
+    template<typename T>
+    PipelineKeyBuilder& addContainer(const std::vector<T>& values) {
+        add(static_cast<uint32_t>(values.size()));
+        for (const T& value : values) {
+            add(value);
+        }
+        return *this;
+    }
+    
+    PipelineKey build() { return PipelineKey(std::move(bytes_)); }
+
+private:
+    void append(const void* data, size_t size) {
+        const uint8_t* bytes = static_cast<const uint8_t*>(data);
+        bytes_.insert(bytes_.end(), bytes, bytes + size);
+    }
+    
+    std::vector<uint8_t> bytes_;
+};
+
 }
\ No newline at end of file
@@ -0,0 +1,148 @@
+#include "pipeline_cache_store.h"
+#include "../core/vulkan_function_loader.h"
+#include "../core/vulkan_constants.h"
+#include <iostream>
+#include <fstream>
+#include <filesystem>
+#include <cstring>
+#include <cstdio>
+
+bool PipelineCacheStore::initialize(const VulkanContext& context) {
+    context_ = &context;
+    initialData_.clear();
+    
+    context_->getLoader().vkGetPhysicalDeviceProperties(context_->getPhysicalDevice(), &deviceProperties_);
+    
+    char hex[3];
+    deviceKey_.clear();
+    for (uint32_t i = 0; i < VK_UUID_SIZE; ++i) {
+        std::snprintf(hex, sizeof(hex), "%02x", deviceProperties_.pipelineCacheUUID[i]);
+        deviceKey_ += hex;
+    }
+    deviceKey_ += "_" + std::to_string(deviceProperties_.driverVersion);
+    return true;
+}
+
+void PipelineCacheStore::cleanupBeforeContextDestruction() {
+    initialData_.clear();
+    context_ = nullptr;
+}
+
+vulkan_raii::PipelineCache PipelineCacheStore::createCache(const std::string& name) {
+    if (!context_) {
+        return {};
+    }
+    
+    auto it = initialData_.find(name);
+    if (it == initialData_.end()) {
+        it = initialData_.emplace(name, ENABLE_PERSISTENT_PIPELINE_CACHE ? readCacheFile(name) : std::vector<uint8_t>{}).first;
+        if (!it->second.empty()) {
+            std::cout << "PipelineCacheStore: Loaded " << it->second.size() << " bytes for '" << name << "'" << std::endl;
+        }
+    }
+    
+    VkPipelineCacheCreateInfo cacheInfo{};
+    cacheInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_CACHE_CREATE_INFO;
+    cacheInfo.initialDataSize = it->second.size();
+    cacheInfo.pInitialData = it->second.empty() ? nullptr : it->second.data();
+    
+    vulkan_raii::PipelineCache pipelineCache = vulkan_raii::create_pipeline_cache(context_, &cacheInfo);
+    if (!pipelineCache && !it->second.empty()) {
+        // Drivers may still reject data that passed the header check; start empty rather than fail
+        std::cerr << "PipelineCacheStore: Driver rejected cached data for '" << name << "', starting empty" << std::endl;
+        it->second.clear();
+        cacheInfo.initialDataSize = 0;
+        cacheInfo.pInitialData = nullptr;
+        pipelineCache = vulkan_raii::create_pipeline_cache(context_, &cacheInfo);
+    }
+    return pipelineCache;
+}
+
+bool PipelineCacheStore::save(const std::string& name, VkPipelineCache pipelineCache) {
+    if constexpr (!ENABLE_PERSISTENT_PIPELINE_CACHE) {
+        return false;
+    }
+    if (!context_ || pipelineCache == VK_NULL_HANDLE) {
+        return false;
+    }
+    
+    const auto& vk = context_->getLoader();
+    size_t dataSize = 0;
+    VkResult result = vk.vkGetPipelineCacheData(context_->getDevice(), pipelineCache, &dataSize, nullptr);
+    if (result != VK_SUCCESS || dataSize == 0) {
+        return false;
+    }
+    std::vector<uint8_t> data(dataSize);
+    result = vk.vkGetPipelineCacheData(context_->getDevice(), pipelineCache, &dataSize, data.data());
+    if (result != VK_SUCCESS) {
+        std::cerr << "PipelineCacheStore: Failed to read pipeline cache data for '" << name << "': " << result << std::endl;
+        return false;
+    }
+    data.resize(dataSize);
+    
+    // Written beside the target and renamed over it, so an interrupted write never leaves a truncated cache
+    const std::string path = getCachePath(name);
+    const std::string tempPath = path + ".tmp";
+    std::error_code error;
+    std::filesystem::create_directories(PIPELINE_CACHE_DIRECTORY, error);
+    {
+        std::ofstream file(tempPath, std::ios::binary | std::ios::trunc);
+        if (!file.is_open() || !file.write(reinterpret_cast<const char*>(data.data()), static_cast<std::streamsize>(data.size()))) {
+            std::cerr << "PipelineCacheStore: Failed to write " << tempPath << std::endl;
+            return false;
+        }
+    }
+    std::filesystem::rename(tempPath, path, error);
+    if (error) {
+        std::cerr << "PipelineCacheStore: Failed to replace " << path << ": " << error.message() << std::endl;
+        std::filesystem::remove(tempPath, error);
+        return false;
+    }
+    
+    std::cout << "PipelineCacheStore: Saved " << data.size() << " bytes for '" << name << "'" << std::endl;
+    initialData_[name] = std::move(data);
+    return true;
+}
+
+std::string PipelineCacheStore::getCachePath(const std::string& name) const {
+    return (std::filesystem::path(PIPELINE_CACHE_DIRECTORY) / (name + "_" + deviceKey_ + ".bin")).string();
+}
+
+std::vector<uint8_t> PipelineCacheStore::readCacheFile(const std::string& name) const {
+    std::ifstream file(getCachePath(name), std::ios::binary | std::ios::ate);
+    if (!file.is_open()) {
+        return {};
+    }
+    
+    const std::streamsize fileSize = file.tellg();
+    if (fileSize <= 0) {
+        return {};
+    }
+    std::vector<uint8_t> data(static_cast<size_t>(fileSize));
+    file.seekg(0);
+    if (!file.read(reinterpret_cast<char*>(data.data()), fileSize)) {
+        return {};
+    }
+    
+    if (!isCompatible(data)) {
+        std::cout << "PipelineCacheStore: Ignoring cache for '" << name << "' written by another device or driver" << std::endl;
+        return {};
+    }
+    return data;
+}
+
+bool PipelineCacheStore::isCompatible(const std::vector<uint8_t>& data) const {
+    // VkPipelineCacheHeaderVersionOne: header size, version, vendor ID, device ID, pipeline cache UUID
+    constexpr size_t headerSize = 16 + VK_UUID_SIZE;
+    if (data.size() < headerSize) {
+        return false;
+    }
+    
+    uint32_t fields[4];
+    std::memcpy(fields, data.data(), sizeof(fields));
+    return fields[0] >= headerSize &&
+           fields[1] == VK_PIPELINE_CACHE_HEADER_VERSION_ONE &&
+           fields[2] == deviceProperties_.vendorID &&
+           fields[3] == deviceProperties_.deviceID &&
+           std::memcmp(data.data() + 16, deviceProperties_.pipelineCacheUUID, VK_UUID_SIZE) == 0;
+}
@@ -0,0 +1,43 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_raii.h"
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <cstdint>
+
+// Persists driver pipeline caches between runs so pipeline creation starts from previously compiled ISA.
+// Each named cache lives in PIPELINE_CACHE_DIRECTORY as <name>_<pipelineCacheUUID>_<driverVersion>.bin;
+// a file whose header names another device is ignored and replaced on the next save
+class PipelineCacheStore {
+public:
+    PipelineCacheStore() = default;
+    ~PipelineCacheStore() = default;
+    
+    bool initialize(const VulkanContext& context);
+    void cleanupBeforeContextDestruction();
+    
+    // New VkPipelineCache seeded with the blob read for this name at first use (empty when none is valid)
+    vulkan_raii::PipelineCache createCache(const std::string& name);
+    
+    // Writes the cache's current contents back to disk; failures are logged and leave the old file in place
+    bool save(const std::string& name, VkPipelineCache pipelineCache);
+    
+    // Names other per-device files kept beside the caches (empty before initialize)
+    const std::string& getDeviceKey() const { return deviceKey_; }
+
+private:
+    std::string getCachePath(const std::string& name) const;
+    std::vector<uint8_t> readCacheFile(const std::string& name) const;
+    bool isCompatible(const std::vector<uint8_t>& data) const;
+    
+    const VulkanContext* context_ = nullptr;
+    VkPhysicalDeviceProperties deviceProperties_{};
+    std::string deviceKey_;  // Hex pipelineCacheUUID plus driver version
+    
+    // Last blob loaded or saved per name, so a recreated cache starts from it instead of empty
+    std::unordered_map<std::string, std::vector<uint8_t>> initialData_;
+};
@@ -1,4 +1,6 @@
 #include "pipeline_system_manager.h"
+#include "../../ecs/utilities/profiler.h"
+#include <algorithm>
 #include <iostream>
 
 PipelineSystemManager::PipelineSystemManager() {
@@ -8,8 +10,9 @@ PipelineSystemManager::~PipelineSystemManager() {
     cleanup();
 }
 
-bool PipelineSystemManager::initialize(const VulkanContext& context) {
+bool PipelineSystemManager::initialize(const VulkanContext& context, DeletionQueue* deletionQueue) {
     this->context = &context;
+    this->deletionQueue = deletionQueue;
     
     std::cout << "Initializing AAA Pipeline System Manager..." << std::endl;
     
@@ -40,10 +43,22 @@ void PipelineSystemManager::cleanupBeforeContextDestruction() {
     layoutManager.reset();
     shaderManager.reset();
     
+    if (cacheStore) {
+        cacheStore->cleanupBeforeContextDestruction();
+        cacheStore.reset();
+    }
+    
     context = nullptr;
 }
 
 bool PipelineSystemManager::initializeManagers() {
+    // Driver pipeline cache persistence, shared by both pipeline managers
+    cacheStore = std::make_unique<PipelineCacheStore>();
+    if (!cacheStore->initialize(*context)) {
+        std::cerr << "Failed to initialize PipelineCacheStore" << std::endl;
+        return false;
+    }
+    
     // Initialize shader manager first (required by pipeline managers)
     shaderManager = std::make_unique<ShaderManager>();
     if (!shaderManager->initialize(*context)) {
@@ -60,14 +75,14 @@ bool PipelineSystemManager::initializeManagers() {
     
     // Initialize graphics pipeline manager
     graphicsManager = std::make_unique<GraphicsPipelineManager>(const_cast<VulkanContext*>(context));
-    if (!graphicsManager->initialize(shaderManager.get(), layoutManager.get())) {
+    if (!graphicsManager->initialize(shaderManager.get(), layoutManager.get(), cacheStore.get(), deletionQueue)) {
         std::cerr << "Failed to initialize GraphicsPipelineManager" << std::endl;
         return false;
     }
     
     // Initialize compute pipeline manager
     computeManager = std::make_unique<ComputePipelineManager>(const_cast<VulkanContext*>(context));
-    if (!computeManager->initialize(shaderManager.get(), layoutManager.get())) {
+    if (!computeManager->initialize(shaderManager.get(), layoutManager.get(), cacheStore.get(), deletionQueue)) {
         std::cerr << "Failed to initialize ComputePipelineManager" << std::endl;
         return false;
     }
@@ -137,12 +152,71 @@ VkPipeline PipelineSystemManager::createComputePipeline(const std::string& compu
     return computeManager->getPipeline(pipelineState);
 }
 
-void PipelineSystemManager::warmupCommonPipelines() {
-    if (!graphicsManager || !computeManager || !layoutManager) {
+uint32_t PipelineSystemManager::reflectEntityComputeBindings() const {
+    // Every kernel bound to the entity compute layout; the .bindless and .bda builds read the same streams
+    static constexpr const char* entityKernels[] = {
+        "shaders/entity_active.comp.spv", "shaders/entity_bin.comp.spv", "shaders/entity_bounds.comp.spv",
+        "shaders/entity_cull.comp.spv", "shaders/entity_despawn.comp.spv", "shaders/entity_reorder.comp.spv",
+        "shaders/entity_spawn.comp.spv", "shaders/entity_update.comp.spv", "shaders/movement_bin.comp.spv",
+        "shaders/movement_random.comp.spv", "shaders/movement_orbit.comp.spv", "shaders/movement_flow.comp.spv",
+        "shaders/physics.comp.spv", "shaders/physics_tiled.comp.spv", "shaders/spatial_clear.comp.spv",
+        "shaders/spatial_count.comp.spv", "shaders/spatial_prefix_sum.comp.spv", "shaders/spatial_scatter.comp.spv",
+        "shaders/spatial_query.comp.spv"
+    };
+    if (!shaderManager) {
+        return ~0u;
+    }
+    
+    const DescriptorLayoutSpec layoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
+    uint32_t accessedBindings = 0;
+    for (const char* kernel : entityKernels) {
+        SpirvReflection reflection;
+        if (!shaderManager->reflectShaderFile(kernel, reflection)) {
+            std::cerr << "PipelineSystemManager: cannot reflect " << kernel << ", keeping every entity stream" << std::endl;
+            return ~0u;
+        }
+        
+        for (const auto& resource : reflection.bindings) {
+            if (resource.set != 0 || !resource.accessed) continue;
+            auto declared = std::find_if(layoutSpec.bindings.begin(), layoutSpec.bindings.end(),
+                                         [&](const DescriptorBinding& binding) { return binding.binding == resource.binding; });
+            if (declared == layoutSpec.bindings.end() || declared->type != resource.type) {
+                std::cerr << "PipelineSystemManager: " << kernel << " accesses binding " << resource.binding
+                          << (declared == layoutSpec.bindings.end() ? ", missing from " : " with another type than ")
+                          << layoutSpec.layoutName << std::endl;
+            }
+            if (resource.binding < 32) {
+                accessedBindings |= 1u << resource.binding;
+            }
+        }
+    }
+    return accessedBindings;
+}
+
+void PipelineSystemManager::warmupPipelines(const PipelineWarmupList& warmup) {
+    if (!graphicsManager || !computeManager) {
         return;
     }
     
-    std::cout << "Warming up common pipelines..." << std::endl;
+    size_t queued = 0;
+    for (const auto& state : warmup.compute) {
+        queued += computeManager->compileAsync(state) ? 1 : 0;
+    }
+    for (const auto& state : warmup.graphics) {
+        queued += graphicsManager->compileAsync(state) ? 1 : 0;
+    }
+    std::cout << "Pipeline warmup: " << queued << " pipelines compiling in the background" << std::endl;
+}
+
+void PipelineSystemManager::warmupCommonPipelines(VkRenderPass entityRenderPass, bool compactLayout,
+                                                  VkDescriptorSetLayout bindlessTableLayout,
+                                                  VkDescriptorSetLayout bindlessUniformLayout,
+                                                  bool streamAddresses,
+                                                  VkFormat dynamicRenderingFormat,
+                                                  VkFormat depthFormat) {
+    if (!graphicsManager || !computeManager || !layoutManager) {
+        return;
+    }
     
     // Warmup common descriptor layouts
     std::vector<DescriptorLayoutSpec> commonLayouts = {
@@ -151,24 +225,75 @@ void PipelineSystemManager::warmupCommonPipelines() {
     };
     layoutManager->warmupCache(commonLayouts);
     
-    // Warmup common graphics pipeline states
-    std::vector<GraphicsPipelineState> commonGraphicsStates = {
-        graphicsManager->createDefaultState(),
-        graphicsManager->createMSAAState()
-    };
-    // Note: Would need render pass to actually warmup - this is a placeholder
-    
-    // Warmup common compute pipeline states
+    // Every state the frame graph nodes request with their default configuration; physics covers both
+    // settings of the runtime movement fusion toggle
     auto entityComputeLayout = layoutManager->getLayout(DescriptorLayoutPresets::createEntityComputeLayout());
-    std::vector<ComputePipelineState> commonComputeStates = {
-        ComputePipelinePresets::createEntityMovementState(entityComputeLayout)
+    PipelineWarmupList warmup;
+    warmup.compute = {
+        ComputePipelinePresets::createEntityMovementState(entityComputeLayout, compactLayout),
+        ComputePipelinePresets::createPhysicsState(entityComputeLayout, false, compactLayout),
+        ComputePipelinePresets::createPhysicsState(entityComputeLayout, true, compactLayout),
+        ComputePipelinePresets::createEntityActiveSetState(entityComputeLayout, false, compactLayout),
+        ComputePipelinePresets::createEntityActiveSetState(entityComputeLayout, true, compactLayout),
+        ComputePipelinePresets::createSpatialGridClearState(entityComputeLayout),
+        ComputePipelinePresets::createSpatialGridCountState(entityComputeLayout, compactLayout),
+        ComputePipelinePresets::createSpatialGridPrefixSumState(entityComputeLayout),
+        ComputePipelinePresets::createSpatialGridScatterState(entityComputeLayout),
+        ComputePipelinePresets::createFrustumCullingState(entityComputeLayout)
     };
-    computeManager->warmupCache(commonComputeStates);
+    if (depthFormat != VK_FORMAT_UNDEFINED) {
+        warmup.compute.push_back(ComputePipelinePresets::createFrustumCullingState(entityComputeLayout, false, true));
+    }
+    for (uint32_t phase = 0; phase < 2; ++phase) {  // Gather, apply
+        warmup.compute.push_back(ComputePipelinePresets::createEntityReorderState(entityComputeLayout, phase, compactLayout));
+    }
+    for (uint32_t phase = 0; phase < 3; ++phase) {  // Mark, classify, move
+        warmup.compute.push_back(ComputePipelinePresets::createEntityDespawnState(entityComputeLayout, phase, compactLayout));
+    }
+    for (uint32_t phase = 0; phase < 2; ++phase) {  // Collect, spawn
+        warmup.compute.push_back(ComputePipelinePresets::createEntitySpawnState(entityComputeLayout, phase, compactLayout));
+    }
+    const bool subgroupBallot = computeManager->getDeviceInfo()->supportsSubgroupOperations();
+    for (auto& state : warmup.compute) {
+        if (streamAddresses) {
+            ComputePipelinePresets::applyEntityStreamAddresses(state);
+        } else if (bindlessTableLayout != VK_NULL_HANDLE) {
+            ComputePipelinePresets::applyBindlessEntityTable(state, bindlessTableLayout);
+        }
+        if (subgroupBallot) {
+            ComputePipelinePresets::applySubgroupBallot(state);
+        }
+        ComputePipelinePresets::applyShaderFeatures(state, computeManager->getShaderFeatures());
+    }
+    
+    if (entityRenderPass != VK_NULL_HANDLE || dynamicRenderingFormat != VK_FORMAT_UNDEFINED) {
+        auto entityGraphicsLayout = layoutManager->getLayout(DescriptorLayoutPresets::createEntityGraphicsLayout());
+        warmup.graphics.push_back(GraphicsPipelinePresets::createEntityRenderingState(entityRenderPass, entityGraphicsLayout, compactLayout));
+        if (depthFormat != VK_FORMAT_UNDEFINED) {
+            GraphicsPipelinePresets::applyEntityEarlyDepth(warmup.graphics.back());
+        }
+        if (dynamicRenderingFormat != VK_FORMAT_UNDEFINED) {
+            GraphicsPipelinePresets::applyDynamicRendering(warmup.graphics.back(), dynamicRenderingFormat, depthFormat);
+        }
+        if (streamAddresses) {
+            GraphicsPipelinePresets::applyEntityStreamAddresses(warmup.graphics.back(), bindlessUniformLayout);
+        } else if (bindlessTableLayout != VK_NULL_HANDLE) {
+            GraphicsPipelinePresets::applyBindlessEntityTable(warmup.graphics.back(), bindlessTableLayout, bindlessUniformLayout);
+        }
+    }
     
-    std::cout << "Pipeline warmup complete" << std::endl;
+    warmupPipelines(warmup);
+}
+
+void PipelineSystemManager::beginFrame() {
+    // Non-blocking: adopts finished hot-reload recompiles and queues new ones
+    if (shaderManager) {
+        shaderManager->checkForShaderReloads();
+    }
 }
 
 void PipelineSystemManager::optimizeCaches(uint64_t currentFrame) {
+    PROFILE_HITCH_EVENT(HitchCause::CacheOptimize);
     if (graphicsManager) {
         graphicsManager->optimizeCache(currentFrame);
     }
@@ -5,6 +5,8 @@
 #include "descriptor_layout_manager.h"
 #include "shader_manager.h"
 #include "graphics_pipeline_cache.h"
+#include "pipeline_cache_store.h"
+#include "../core/deletion_queue.h"
 #include "../core/vulkan_context.h"
 #include <memory>
 
@@ -14,8 +16,8 @@ public:
     PipelineSystemManager();
     ~PipelineSystemManager();
 
-    // Initialization
-    bool initialize(const VulkanContext& context);
+    // Initialization; deletionQueue (the renderer's) receives evicted and replaced pipelines and render passes
+    bool initialize(const VulkanContext& context, DeletionQueue* deletionQueue);
     void cleanup();
     
     // Explicit cleanup before context destruction
@@ -46,8 +48,35 @@ public:
     VkPipeline createComputePipeline(const std::string& computeShaderPath);
 
 
+    // Background warmup: every listed state starts compiling on a worker thread and the call returns at once.
+    // Per-frame getPipelineIfReady() lookups adopt results as they finish; blocking lookups wait instead of
+    // compiling the same state again
+    struct PipelineWarmupList {
+        std::vector<ComputePipelineState> compute;
+        std::vector<GraphicsPipelineState> graphics;
+    };
+    void warmupPipelines(const PipelineWarmupList& warmup);
+    
+    // The frame graph's own states, for the entity render pass and the entity buffer layout in use;
+    // a bindless table layout or streamAddresses retargets them at the descriptor or address table as the nodes do,
+    // and a dynamic rendering format replaces the render pass. A depth format (the swapchain's, under
+    // ENABLE_ENTITY_EARLY_DEPTH) selects the early depth entity pipeline and the grid order culling variant
+    void warmupCommonPipelines(VkRenderPass entityRenderPass, bool compactLayout,
+                               VkDescriptorSetLayout bindlessTableLayout = VK_NULL_HANDLE,
+                               VkDescriptorSetLayout bindlessUniformLayout = VK_NULL_HANDLE,
+                               bool streamAddresses = false,
+                               VkFormat dynamicRenderingFormat = VK_FORMAT_UNDEFINED,
+                               VkFormat depthFormat = VK_FORMAT_UNDEFINED);
+    
+    // Entity compute bindings (bit = binding) that some entity kernel's code accesses, reflected from the
+    // kernels' SPIR-V, which also checks that each accessed binding matches the entity compute layout.
+    // All bits when a kernel cannot be reflected, so callers only drop what is known to be unread
+    uint32_t reflectEntityComputeBindings() const;
+    
+    // Adopts finished hot-reload recompiles; call after waiting on the slot's fences
+    void beginFrame();
+    
     // Integrated operations
-    void warmupCommonPipelines();
     void optimizeCaches(uint64_t currentFrame);
     void resetFrameStats();
     
@@ -68,7 +97,10 @@ private:
     // Core Vulkan context
     const VulkanContext* context = nullptr;
 
-    // Specialized managers
+    // Specialized managers; the cache store outlives both pipeline managers, which save into it on cleanup.
+    // They retire into the renderer's deletion queue, which the renderer flushes after this cleanup
+    DeletionQueue* deletionQueue = nullptr;
+    std::unique_ptr<PipelineCacheStore> cacheStore;
     std::unique_ptr<ShaderManager> shaderManager;
     std::unique_ptr<DescriptorLayoutManager> layoutManager;
     std::unique_ptr<GraphicsPipelineManager> graphicsManager;
@@ -1,5 +1,7 @@
 #include "pipeline_utils.h"
 #include "../core/vulkan_function_loader.h"
+#include <algorithm>
+#include <cctype>
 #include <iostream>
 
 // Pipeline layout utilities implementation
@@ -395,6 +397,110 @@ bool PipelineUtils::checkPipelineCreation(VkResult result, const char* pipelineT
     return false;
 }
 
+namespace {
+    uint64_t statisticValue(const VkPipelineExecutableStatisticKHR& statistic) {
+        switch (statistic.format) {
+            case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_BOOL32_KHR:
+                return statistic.value.b32 ? 1 : 0;
+            case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_INT64_KHR:
+                return statistic.value.i64 > 0 ? static_cast<uint64_t>(statistic.value.i64) : 0;
+            case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_UINT64_KHR:
+                return statistic.value.u64;
+            case VK_PIPELINE_EXECUTABLE_STATISTIC_FORMAT_FLOAT64_KHR:
+                return statistic.value.f64 > 0.0 ? static_cast<uint64_t>(statistic.value.f64) : 0;
+            default:
+                return 0;
+        }
+    }
+    
+    bool nameContains(const std::string& name, const char* keyword) {
+        return name.find(keyword) != std::string::npos;
+    }
+}
+
+PipelineExecutableStats PipelineUtils::queryExecutableStatistics(VkDevice device,
+                                                                 const VulkanFunctionLoader& loader,
+                                                                 VkPipeline pipeline) {
+    const auto& vk = loader;
+    PipelineExecutableStats stats;
+    if (pipeline == VK_NULL_HANDLE || !vk.vkGetPipelineExecutablePropertiesKHR || !vk.vkGetPipelineExecutableStatisticsKHR) {
+        return stats;
+    }
+    
+    VkPipelineInfoKHR pipelineInfo{};
+    pipelineInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_INFO_KHR;
+    pipelineInfo.pipeline = pipeline;
+    
+    uint32_t executableCount = 0;
+    if (vk.vkGetPipelineExecutablePropertiesKHR(device, &pipelineInfo, &executableCount, nullptr) != VK_SUCCESS) {
+        return stats;
+    }
+    
+    std::vector<VkPipelineExecutableStatisticKHR> statistics;
+    for (uint32_t executable = 0; executable < executableCount; ++executable) {
+        VkPipelineExecutableInfoKHR executableInfo{};
+        executableInfo.sType = VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_INFO_KHR;
+        executableInfo.pipeline = pipeline;
+        executableInfo.executableIndex = executable;
+        
+        uint32_t statisticCount = 0;
+        if (vk.vkGetPipelineExecutableStatisticsKHR(device, &executableInfo, &statisticCount, nullptr) != VK_SUCCESS) {
+            continue;
+        }
+        statistics.assign(statisticCount, VkPipelineExecutableStatisticKHR{VK_STRUCTURE_TYPE_PIPELINE_EXECUTABLE_STATISTIC_KHR});
+        if (vk.vkGetPipelineExecutableStatisticsKHR(device, &executableInfo, &statisticCount, statistics.data()) < 0) {
+            continue;
+        }
+        stats.executableCount++;
+        
+        // Spill names ("Spilled VGPRs", "Spill count") also mention registers, so they are matched first
+        for (uint32_t i = 0; i < statisticCount; ++i) {
+            std::string name(statistics[i].name);
+            std::transform(name.begin(), name.end(), name.begin(), [](unsigned char c) { return static_cast<char>(std::tolower(c)); });
+            const uint64_t value = statisticValue(statistics[i]);
+            
+            if (nameContains(name, "spill")) {
+                stats.spills += value;
+            } else if (nameContains(name, "scratch") || nameContains(name, "private") || nameContains(name, "local memory")) {
+                stats.scratchBytes += value;
+            } else if (nameContains(name, "shared") || nameContains(name, "lds") || nameContains(name, "workgroup memory")) {
+                stats.sharedMemoryBytes = std::max(stats.sharedMemoryBytes, value);
+            } else if (nameContains(name, "register") || nameContains(name, "gpr")) {
+                stats.registers = std::max(stats.registers, value);
+            }
+        }
+    }
+    return stats;
+}
+
+std::string PipelineUtils::describeShaders(const std::vector<std::string>& shaderPaths) {
+    std::string description;
+    for (const auto& path : shaderPaths) {
+        const size_t slash = path.find_last_of("/\\");
+        std::string name = slash == std::string::npos ? path : path.substr(slash + 1);
+        if (name.size() > 4 && name.compare(name.size() - 4, 4, ".spv") == 0) {
+            name.resize(name.size() - 4);
+        }
+        if (!description.empty()) {
+            description += '+';
+        }
+        description += name;
+    }
+    return description;
+}
+
+void PipelineUtils::logExecutableStatistics(const std::string& pipelineName, const PipelineExecutableStats& stats) {
+    if (!stats.isCaptured()) {
+        return;
+    }
+    std::cout << "  " << pipelineName << ": " << stats.registers << " registers, "
+              << stats.sharedMemoryBytes << " bytes shared memory" << std::endl;
+    if (stats.spillsRegisters()) {
+        std::cerr << "PipelineUtils: WARNING - " << pipelineName << " spills registers (" << stats.spills
+                  << " spills, " << stats.scratchBytes << " bytes scratch)" << std::endl;
+    }
+}
+
 // Debug utilities implementation
 void PipelineUtils::setDebugName(VkDevice device,
                                 const VulkanFunctionLoader& loader,
@@ -7,6 +7,25 @@
 
 class VulkanFunctionLoader;
 
+// Driver figures for one pipeline from VK_KHR_pipeline_executable_properties, folded over its executables
+// (one per stage, or more where the driver splits a stage). Statistic names are vendor-defined, so they are
+// matched by keyword and anything unrecognised is left out
+struct PipelineExecutableStats {
+    uint32_t executableCount = 0;     // 0 = not captured
+    uint64_t registers = 0;           // Highest register count of any executable
+    uint64_t spills = 0;              // Spilled registers or spill instructions, summed
+    uint64_t scratchBytes = 0;        // Private/scratch memory the spills land in, summed
+    uint64_t sharedMemoryBytes = 0;   // Workgroup (LDS) memory, highest of any executable
+    
+    bool isCaptured() const { return executableCount > 0; }
+    bool spillsRegisters() const { return spills > 0 || scratchBytes > 0; }
+};
+
+struct PipelineExecutableReport {
+    std::string name;  // PipelineUtils::describeShaders of the pipeline's stages
+    PipelineExecutableStats stats;
+};
+
 // Pipeline-specific utility functions for common pipeline operations
 // Eliminates code duplication within the pipelines subsystem
 class PipelineUtils {
@@ -117,6 +136,16 @@ public:
     // Error handling utilities specific to pipelines
     static bool checkPipelineCreation(VkResult result, const char* pipelineType);
     
+    // Needs a pipeline created with VK_PIPELINE_CREATE_CAPTURE_STATISTICS_BIT_KHR on a device with
+    // pipelineExecutableInfo enabled; returns uncaptured stats otherwise
+    static PipelineExecutableStats queryExecutableStatistics(VkDevice device,
+                                                             const VulkanFunctionLoader& loader,
+                                                             VkPipeline pipeline);
+    // File names without directories or .spv, joined by '+' ("vertex.vert+fragment.frag")
+    static std::string describeShaders(const std::vector<std::string>& shaderPaths);
+    // One line per captured pipeline, and a warning when it spills
+    static void logExecutableStatistics(const std::string& pipelineName, const PipelineExecutableStats& stats);
+    
     // Debug utilities
     static void setDebugName(VkDevice device,
                            const VulkanFunctionLoader& loader,
@@ -0,0 +1,157 @@
+#include "shader_file_watcher.h"
+#include <iostream>
+#include <algorithm>
+#include <system_error>
+
+#if defined(__linux__)
+#include <sys/inotify.h>
+#include <unistd.h>
+#include <cerrno>
+#elif defined(_WIN32)
+#define WIN32_LEAN_AND_MEAN
+#define NOMINMAX
+#include <windows.h>
+#endif
+
+namespace {
+    std::filesystem::file_time_type lastWriteTime(const std::string& path) {
+        std::error_code error;
+        auto time = std::filesystem::last_write_time(path, error);
+        return error ? std::filesystem::file_time_type{} : time;
+    }
+}
+
+ShaderFileWatcher::~ShaderFileWatcher() {
+    unwatchAll();
+}
+
+std::string ShaderFileWatcher::normalizePath(const std::string& filePath) {
+    std::error_code error;
+    std::filesystem::path absolute = std::filesystem::absolute(filePath, error);
+    return (error ? std::filesystem::path(filePath) : absolute).lexically_normal().string();
+}
+
+bool ShaderFileWatcher::watch(const std::string& filePath) {
+    const std::string file = normalizePath(filePath);
+    if (watchedFiles_.count(file)) {
+        return true;
+    }
+    
+    const std::string directoryPath = std::filesystem::path(file).parent_path().string();
+    auto it = directories_.find(directoryPath);
+    if (it == directories_.end()) {
+        WatchedDirectory directory;
+        directory.path = directoryPath;
+
+#if defined(__linux__)
+        if (inotifyFd_ < 0) {
+            inotifyFd_ = inotify_init1(IN_NONBLOCK | IN_CLOEXEC);
+            if (inotifyFd_ < 0) {
+                std::cerr << "ShaderFileWatcher: inotify_init1 failed (errno " << errno << "), falling back to polling" << std::endl;
+            }
+        }
+        if (inotifyFd_ >= 0) {
+            directory.watchDescriptor = inotify_add_watch(inotifyFd_, directoryPath.c_str(),
+                                                          IN_CLOSE_WRITE | IN_MOVED_TO | IN_CREATE);
+            if (directory.watchDescriptor < 0) {
+                std::cerr << "ShaderFileWatcher: Cannot watch " << directoryPath << " (errno " << errno << ")" << std::endl;
+                return false;
+            }
+        }
+#elif defined(_WIN32)
+        HANDLE handle = FindFirstChangeNotificationA(directoryPath.c_str(), FALSE,
+                                                     FILE_NOTIFY_CHANGE_LAST_WRITE | FILE_NOTIFY_CHANGE_FILE_NAME);
+        if (handle == INVALID_HANDLE_VALUE) {
+            std::cerr << "ShaderFileWatcher: Cannot watch " << directoryPath << " (error " << GetLastError() << ")" << std::endl;
+            return false;
+        }
+        directory.notifyHandle = handle;
+#endif
+
+        it = directories_.emplace(directoryPath, std::move(directory)).first;
+    }
+    
+    it->second.files[file] = lastWriteTime(file);
+    watchedFiles_.insert(file);
+    return true;
+}
+
+void ShaderFileWatcher::unwatchAll() {
+#if defined(__linux__)
+    if (inotifyFd_ >= 0) {
+        // Closing the descriptor drops every watch on it
+        close(inotifyFd_);
+        inotifyFd_ = -1;
+    }
+#elif defined(_WIN32)
+    for (auto& [path, directory] : directories_) {
+        if (directory.notifyHandle) {
+            FindCloseChangeNotification(static_cast<HANDLE>(directory.notifyHandle));
+        }
+    }
+#endif
+    directories_.clear();
+    watchedFiles_.clear();
+}
+
+std::vector<std::string> ShaderFileWatcher::pollChanges() {
+    std::vector<std::string> changes;
+
+#if defined(__linux__)
+    if (inotifyFd_ >= 0) {
+        std::unordered_map<int, const WatchedDirectory*> byDescriptor;
+        for (const auto& [path, directory] : directories_) {
+            byDescriptor[directory.watchDescriptor] = &directory;
+        }
+        
+        alignas(inotify_event) char buffer[4096];
+        for (;;) {
+            const ssize_t length = read(inotifyFd_, buffer, sizeof(buffer));
+            if (length <= 0) {
+                break;  // EAGAIN: queue drained
+            }
+            for (ssize_t offset = 0; offset < length;) {
+                const auto* event = reinterpret_cast<const inotify_event*>(buffer + offset);
+                offset += static_cast<ssize_t>(sizeof(inotify_event) + event->len);
+                
+                auto directoryIt = byDescriptor.find(event->wd);
+                if (directoryIt == byDescriptor.end() || event->len == 0) {
+                    continue;
+                }
+                const std::string file = (std::filesystem::path(directoryIt->second->path) / event->name).string();
+                if (watchedFiles_.count(file) &&
+                    std::find(changes.begin(), changes.end(), file) == changes.end()) {
+                    changes.push_back(file);
+                }
+            }
+        }
+        return changes;
+    }
+#elif defined(_WIN32)
+    // A signal only says the directory changed; its watched files' timestamps say which
+    for (auto& [path, directory] : directories_) {
+        HANDLE handle = static_cast<HANDLE>(directory.notifyHandle);
+        if (handle && WaitForSingleObject(handle, 0) == WAIT_OBJECT_0) {
+            FindNextChangeNotification(handle);
+            collectTimestampChanges(directory, changes);
+        }
+    }
+#endif
+
+#if !defined(_WIN32)
+    for (auto& [path, directory] : directories_) {
+        collectTimestampChanges(directory, changes);
+    }
+#endif
+    return changes;
+}
+
+void ShaderFileWatcher::collectTimestampChanges(WatchedDirectory& directory, std::vector<std::string>& changes) const {
+    for (auto& [file, lastSeen] : directory.files) {
+        const auto modified = lastWriteTime(file);
+        if (modified > lastSeen) {
+            lastSeen = modified;
+            changes.push_back(file);
+        }
+    }
+}
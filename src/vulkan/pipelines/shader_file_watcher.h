@@ -0,0 +1,43 @@
+#pragma once
+
+#include <string>
+#include <vector>
+#include <unordered_map>
+#include <unordered_set>
+#include <filesystem>
+
+// Change notifications for shader sources and SPIR-V binaries, read without blocking from the frame loop.
+// Watches directories rather than files, so editors that save through a temporary file and a rename are
+// still seen: inotify on Linux, FindFirstChangeNotification on Windows (then a timestamp check of the
+// watched files in the signalled directory), timestamp polling elsewhere
+class ShaderFileWatcher {
+public:
+    ShaderFileWatcher() = default;
+    ~ShaderFileWatcher();
+    
+    ShaderFileWatcher(const ShaderFileWatcher&) = delete;
+    ShaderFileWatcher& operator=(const ShaderFileWatcher&) = delete;
+    
+    // False when the file's directory cannot be watched; already watched files are accepted again
+    bool watch(const std::string& filePath);
+    void unwatchAll();
+    
+    // Watched files written, created or renamed into place since the last call, as normalized paths
+    std::vector<std::string> pollChanges();
+    
+    static std::string normalizePath(const std::string& filePath);
+
+private:
+    struct WatchedDirectory {
+        std::string path;
+        std::unordered_map<std::string, std::filesystem::file_time_type> files;  // Normalized path -> last seen write time
+        int watchDescriptor = -1;     // inotify
+        void* notifyHandle = nullptr; // Windows change notification
+    };
+    
+    void collectTimestampChanges(WatchedDirectory& directory, std::vector<std::string>& changes) const;
+    
+    std::unordered_map<std::string, WatchedDirectory> directories_;
+    std::unordered_set<std::string> watchedFiles_;
+    int inotifyFd_ = -1;
+};
@@ -2,13 +2,100 @@
 #include "../core/vulkan_function_loader.h"
 #include "../core/vulkan_raii.h"
 #include "hash_utils.h"
+#include "../../ecs/utilities/profiler.h"
 #include <iostream>
 #include <fstream>
 #include <sstream>
 #include <algorithm>
 #include <cassert>
 #include <cstdlib>
+#include <cstdio>
+#include <atomic>
 #include <filesystem>
+#include <map>
+
+namespace {
+#ifdef _WIN32
+    constexpr const char* NULL_DEVICE = "NUL";
+#else
+    constexpr const char* NULL_DEVICE = "/dev/null";
+#endif
+    
+    // FNV-1a; unlike std::hash it is the same in every build, so disk cache names survive rebuilds
+    class ContentHash {
+    public:
+        ContentHash& add(const std::string& data) {
+            for (unsigned char c : data) {
+                hash_ = (hash_ ^ c) * 0x100000001b3ull;
+            }
+            hash_ = (hash_ ^ 0xffu) * 0x100000001b3ull;  // Separator, so "ab"+"c" differs from "a"+"bc"
+            return *this;
+        }
+        
+        std::string hex() const {
+            char text[17];
+            std::snprintf(text, sizeof(text), "%016llx", static_cast<unsigned long long>(hash_));
+            return text;
+        }
+        
+    private:
+        uint64_t hash_ = 0xcbf29ce484222325ull;
+    };
+    
+    std::string readTextFile(const std::string& path) {
+        std::ifstream file(path);
+        if (!file.is_open()) {
+            return {};
+        }
+        std::stringstream buffer;
+        buffer << file.rdbuf();
+        return buffer.str();
+    }
+    
+    std::string quoteArgument(const std::string& argument) {
+        return "\"" + argument + "\"";
+    }
+    
+    // Hashes every file reached through #include "..." or #include <...>, resolved the way glslc does:
+    // against the including file's directory, then the include paths. Each file is hashed once
+    void hashIncludes(const std::string& source, const std::filesystem::path& directory,
+                      const std::vector<std::string>& includePaths, ContentHash& hash,
+                      std::vector<std::string>& sourceFiles) {
+        std::istringstream lines(source);
+        std::string line;
+        while (std::getline(lines, line)) {
+            const size_t directive = line.find_first_not_of(" \t");
+            if (directive == std::string::npos || line.compare(directive, 8, "#include") != 0) {
+                continue;
+            }
+            const size_t open = line.find_first_of("\"<", directive + 8);
+            const size_t close = open == std::string::npos ? open : line.find_first_of("\">", open + 1);
+            if (close == std::string::npos) {
+                continue;
+            }
+            const std::string name = line.substr(open + 1, close - open - 1);
+            
+            std::vector<std::filesystem::path> candidates{directory / name};
+            for (const std::string& includePath : includePaths) {
+                candidates.push_back(std::filesystem::path(includePath) / name);
+            }
+            for (const auto& candidate : candidates) {
+                std::error_code error;
+                if (!std::filesystem::is_regular_file(candidate, error)) {
+                    continue;
+                }
+                const std::string resolved = ShaderFileWatcher::normalizePath(candidate.string());
+                if (std::find(sourceFiles.begin(), sourceFiles.end(), resolved) == sourceFiles.end()) {
+                    const std::string included = readTextFile(resolved);
+                    sourceFiles.push_back(resolved);
+                    hash.add(name).add(included);
+                    hashIncludes(included, std::filesystem::path(resolved).parent_path(), includePaths, hash, sourceFiles);
+                }
+                break;
+            }
+        }
+    }
+}
 
 // ShaderModuleSpec implementation
 bool ShaderModuleSpec::operator==(const ShaderModuleSpec& other) const {
@@ -60,6 +147,8 @@ bool ShaderManager::initialize(const VulkanContext& context) {
         std::cout << "ShaderManager: spirv-opt optimizer found" << std::endl;
     }
     
+    acceptingCompiles_ = true;
+    
     std::cout << "ShaderManager initialized successfully" << std::endl;
     return true;
 }
@@ -71,6 +160,9 @@ void ShaderManager::cleanup() {
 void ShaderManager::cleanupBeforeContextDestruction() {
     if (!context_) return;
     
+    // Compile jobs hold no Vulkan objects, but they use this manager
+    finishCompileJobs();
+    
     // Clear shader cache before context destruction
     clearCache();
     
@@ -78,32 +170,39 @@ void ShaderManager::cleanupBeforeContextDestruction() {
 }
 
 VkShaderModule ShaderManager::loadShader(const ShaderModuleSpec& spec) {
-    // Check cache first
-    auto it = shaderCache_.find(spec);
-    if (it != shaderCache_.end()) {
-        // Check for hot reload if enabled
-        if (hotReloadEnabled && spec.enableHotReload) {
-            if (isFileNewer(spec.filePath, it->second->sourceModified)) {
-                std::cout << "Hot reloading shader: " << spec.filePath << std::endl;
-                if (reloadShader(spec)) {
-                    stats.hotReloadsThisFrame++;
-                    it = shaderCache_.find(spec);  // Get updated cache entry
-                }
-            }
+    std::shared_future<ShaderCompilationResult> pending;
+    {
+        std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+        
+        // Check cache first; source changes arrive through checkForShaderReloads()
+        auto it = shaderCache_.find(spec);
+        if (it != shaderCache_.end()) {
+            stats.cacheHits++;
+            it->second->lastUsedFrame = stats.cacheHits + stats.cacheMisses;  // Rough frame counter
+            it->second->useCount++;
+            return it->second->module.get();
         }
         
-        // Cache hit
-        stats.cacheHits++;
-        it->second->lastUsedFrame = stats.cacheHits + stats.cacheMisses;  // Rough frame counter
-        it->second->useCount++;
-        return it->second->module.get();
+        // Cache miss - join the queued compile for this spec or queue one
+        stats.cacheMisses++;
+        stats.compilationsThisFrame++;
+        pending = queueCompile(spec);
     }
     
-    // Cache miss - create new shader
-    stats.cacheMisses++;
-    stats.compilationsThisFrame++;
+    // Waited on without the lock, so other threads keep loading while glslc runs
+    JobSystem::getInstance().waitFor(pending);
+    ShaderCompilationResult result = pending.get();
     
-    auto cachedShader = createShaderInternal(spec);
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+    pendingCompiles_.erase(spec);
+    
+    // Another thread waiting on the same job may have stored it already
+    auto it = shaderCache_.find(spec);
+    if (it != shaderCache_.end()) {
+        return it->second->module.get();
+    }
+    
+    auto cachedShader = createShaderInternal(spec, std::move(result));
     if (!cachedShader) {
         std::cerr << "Failed to create shader: " << spec.filePath << std::endl;
         return VK_NULL_HANDLE;
@@ -123,6 +222,34 @@ VkShaderModule ShaderManager::loadShader(const ShaderModuleSpec& spec) {
     return module;
 }
 
+std::vector<VkShaderModule> ShaderManager::loadShadersBatch(const std::vector<ShaderModuleSpec>& specs) {
+    for (const auto& spec : specs) {
+        compileAsync(spec);
+    }
+    
+    std::vector<VkShaderModule> modules;
+    modules.reserve(specs.size());
+    for (const auto& spec : specs) {
+        modules.push_back(loadShader(spec));
+    }
+    return modules;
+}
+
+bool ShaderManager::compileAsync(const ShaderModuleSpec& spec) {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+    if (shaderCache_.count(spec) || pendingCompiles_.count(spec)) {
+        return false;
+    }
+    queueCompile(spec);
+    return true;
+}
+
+void ShaderManager::warmupCache(const std::vector<ShaderModuleSpec>& commonShaders) {
+    for (const auto& spec : commonShaders) {
+        compileAsync(spec);
+    }
+}
+
 VkShaderModule ShaderManager::loadShaderFromFile(const std::string& filePath,
                                                 VkShaderStageFlagBits stage,
                                                 const std::string& entryPoint) {
@@ -148,56 +275,128 @@ VkShaderModule ShaderManager::loadSPIRVFromFile(const std::string& filePath) {
     return loadShaderFromFile(filePath, stage);
 }
 
-std::unique_ptr<CachedShaderModule> ShaderManager::createShaderInternal(const ShaderModuleSpec& spec) {
-    auto startTime = std::chrono::high_resolution_clock::now();
+void ShaderManager::finishCompileJobs() {
+    acceptingCompiles_ = false;
+    JobSystem::getInstance().wait(compileJobs_, JobPriority::Normal);
     
-    if (!fileExists(spec.filePath)) {
-        std::cerr << "Shader file not found: " << spec.filePath << std::endl;
-        return nullptr;
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+    pendingCompiles_.clear();
+    pendingReloads_.clear();
+}
+
+ShaderManager::CompileJob ShaderManager::makeCompileJob(const ShaderModuleSpec& spec) const {
+    CompileJob job;
+    job.spec = spec;
+    job.includePaths = spec.includePaths;
+    job.includePaths.insert(job.includePaths.end(), globalIncludePaths_.begin(), globalIncludePaths_.end());
+    job.defines = globalDefines_;
+    for (const auto& [name, value] : spec.defines) {
+        job.defines[name] = value;
     }
+    return job;
+}
+
+std::shared_future<ShaderCompilationResult> ShaderManager::submitCompile(const ShaderModuleSpec& spec) {
+    auto job = std::make_shared<CompileJob>(makeCompileJob(spec));
+    std::shared_future<ShaderCompilationResult> future = job->result.get_future().share();
     
-    auto cachedShader = std::make_unique<CachedShaderModule>();
-    cachedShader->spec = spec;
-    cachedShader->sourceModified = getFileModifiedTime(spec.filePath);
-    cachedShader->isHotReloadable = spec.enableHotReload;
-    cachedShader->module.setContext(context_);
+    if (acceptingCompiles_) {
+        JobSystem::getInstance().submit([this, job]() { job->result.set_value(produceSpirv(*job)); },
+                                        JobPriority::Normal, &compileJobs_);
+    } else {
+        // Not initialized or shutting down: compile on the caller rather than never
+        job->result.set_value(produceSpirv(*job));
+    }
+    return future;
+}
+
+std::shared_future<ShaderCompilationResult> ShaderManager::queueCompile(const ShaderModuleSpec& spec) {
+    auto it = pendingCompiles_.find(spec);
+    if (it == pendingCompiles_.end()) {
+        it = pendingCompiles_.emplace(spec, submitCompile(spec)).first;
+    }
+    return it->second;
+}
+
+ShaderCompilationResult ShaderManager::produceSpirv(const CompileJob& job) const {
+    const ShaderModuleSpec& spec = job.spec;
+    ShaderCompilationResult result;
+    auto startTime = std::chrono::high_resolution_clock::now();
+    
+    // Embedded modules shadow the files, so a stale .spv beside the executable is never picked up
+    if (spec.sourceType == ShaderSourceType::SPIRV_BINARY) {
+        if (const EmbeddedShader* embedded = findEmbeddedShader(spec.filePath)) {
+            result.spirvCode.assign(embedded->code, embedded->code + embedded->wordCount);
+            result.embedded = embedded;
+            result.success = true;
+            auto endTime = std::chrono::high_resolution_clock::now();
+            result.compilationTime = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+            return result;
+        }
+    }
     
-    // Load or compile shader based on source type
-    std::vector<uint32_t> spirvCode;
+    if (!fileExists(spec.filePath)) {
+        result.errorMessage = "Shader file not found: " + spec.filePath;
+        return result;
+    }
     
     switch (spec.sourceType) {
         case ShaderSourceType::SPIRV_BINARY:
-            spirvCode = loadSPIRVBinaryFromFile(spec.filePath);
+            result.spirvCode = loadSPIRVBinaryFromFile(spec.filePath);
+            result.sourceFiles.push_back(ShaderFileWatcher::normalizePath(spec.filePath));
+            result.success = !result.spirvCode.empty();
+            if (!result.success) {
+                result.errorMessage = "Failed to load shader code: " + spec.filePath;
+            }
             break;
             
         case ShaderSourceType::GLSL_SOURCE: {
-            auto compilationResult = compileGLSLFromFile(spec.filePath, spec.defines);
-            if (!compilationResult.success) {
-                logShaderError(spec.filePath, compilationResult.errorMessage);
-                return nullptr;
+            std::string source = loadShaderSource(spec.filePath);
+            if (source.empty()) {
+                result.errorMessage = "Failed to load shader source";
+                break;
             }
-            spirvCode = std::move(compilationResult.spirvCode);
+            result = compileSPIRVWithGlslc(source, spec.filePath, spec.stageInfo, job.includePaths, job.defines);
             break;
         }
         
         case ShaderSourceType::HLSL_SOURCE:
-            std::cerr << "HLSL compilation not yet implemented" << std::endl;
-            return nullptr;
+            result.errorMessage = "HLSL compilation not yet implemented";
+            break;
+    }
+    
+    auto endTime = std::chrono::high_resolution_clock::now();
+    result.compilationTime = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+    return result;
+}
+
+std::unique_ptr<CachedShaderModule> ShaderManager::createShaderInternal(const ShaderModuleSpec& spec, ShaderCompilationResult result) {
+    if (!context_) {
+        return nullptr;
     }
     
-    if (spirvCode.empty()) {
-        std::cerr << "Failed to load shader code: " << spec.filePath << std::endl;
+    if (!result.success) {
+        logShaderError(spec.filePath, result.errorMessage);
         return nullptr;
     }
     
     // Validate SPIR-V
-    if (!validateSPIRV(spirvCode)) {
+    if (!validateSPIRV(result.spirvCode)) {
         std::cerr << "Invalid SPIR-V code: " << spec.filePath << std::endl;
         return nullptr;
     }
     
+    auto cachedShader = std::make_unique<CachedShaderModule>();
+    cachedShader->spec = spec;
+    if (!result.embedded) {
+        cachedShader->sourceModified = getFileModifiedTime(spec.filePath);
+    }
+    cachedShader->isHotReloadable = spec.enableHotReload;
+    cachedShader->sourceFiles = std::move(result.sourceFiles);
+    cachedShader->module.setContext(context_);
+    
     // Create Vulkan shader module
-    auto shaderModule = createVulkanShaderModule(spirvCode);
+    auto shaderModule = createVulkanShaderModule(result.spirvCode);
     if (!shaderModule) {
         std::cerr << "Failed to create Vulkan shader module: " << spec.filePath << std::endl;
         return nullptr;
@@ -205,20 +404,35 @@ std::unique_ptr<CachedShaderModule> ShaderManager::createShaderInternal(const Sh
     cachedShader->module = std::move(shaderModule);
     
     // Store SPIR-V code for reflection
-    cachedShader->spirvCode = std::move(spirvCode);
+    cachedShader->spirvCode.assign(result.spirvCode.begin(), result.spirvCode.end());
     
     // Perform shader reflection
-    performBasicReflection(*cachedShader);
+    performReflection(*cachedShader, result.embedded);
     
-    auto endTime = std::chrono::high_resolution_clock::now();
-    cachedShader->compilationTime = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+    cachedShader->compilationTime = result.compilationTime;
     stats.totalCompilationTime += cachedShader->compilationTime;
+    if (result.fromDiskCache) {
+        stats.diskCacheHits++;
+    }
+    if (result.embedded) {
+        stats.embeddedLoads++;
+    }
+    
+    if (hotReloadEnabled && cachedShader->isHotReloadable) {
+        watchModuleSources(*cachedShader);
+    }
     
     logShaderCompilation(spec, cachedShader->compilationTime, true);
     
     return cachedShader;
 }
 
+void ShaderManager::watchModuleSources(const CachedShaderModule& cachedModule) {
+    for (const std::string& file : cachedModule.sourceFiles) {
+        fileWatcher_.watch(file);
+    }
+}
+
 vulkan_raii::ShaderModule ShaderManager::createVulkanShaderModule(const std::vector<uint32_t>& spirvCode) {
     VkShaderModuleCreateInfo createInfo{};
     createInfo.sType = VK_STRUCTURE_TYPE_SHADER_MODULE_CREATE_INFO;
@@ -275,55 +489,166 @@ bool ShaderManager::validateSPIRV(const std::vector<uint32_t>& spirvCode) const
 
 ShaderCompilationResult ShaderManager::compileGLSLFromFile(const std::string& filePath,
                                                           const std::unordered_map<std::string, std::string>& defines) {
-    std::string source = loadShaderSource(filePath);
-    if (source.empty()) {
-        ShaderCompilationResult result;
-        result.success = false;
-        result.errorMessage = "Failed to load shader source";
-        return result;
+    ShaderModuleSpec spec;
+    spec.filePath = filePath;
+    spec.sourceType = ShaderSourceType::GLSL_SOURCE;
+    spec.stageInfo.stage = getShaderStageFromFilename(filePath);
+    spec.defines = defines;
+    
+    CompileJob job;
+    {
+        std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+        job = makeCompileJob(spec);
     }
-    
-    VkShaderStageFlagBits stage = getShaderStageFromFilename(filePath);
-    return compileGLSL(source, stage, filePath, defines);
+    return produceSpirv(job);
 }
 
 ShaderCompilationResult ShaderManager::compileGLSL(const std::string& source,
                                                    VkShaderStageFlagBits stage,
                                                    const std::string& fileName,
                                                    const std::unordered_map<std::string, std::string>& defines) {
-    ShaderCompilationResult result;
-    auto startTime = std::chrono::high_resolution_clock::now();
+    ShaderModuleSpec spec;
+    spec.filePath = fileName;
+    spec.stageInfo.stage = stage;
+    spec.defines = defines;
     
-    // Compile using external glslc compiler
-    std::vector<uint32_t> spirvCode = compileSPIRVWithGlslc(source, stage, fileName, defines);
+    CompileJob job;
+    {
+        std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+        job = makeCompileJob(spec);
+    }
     
+    auto startTime = std::chrono::high_resolution_clock::now();
+    ShaderCompilationResult result = compileSPIRVWithGlslc(source, fileName, spec.stageInfo, job.includePaths, job.defines);
     auto endTime = std::chrono::high_resolution_clock::now();
     result.compilationTime = std::chrono::duration_cast<std::chrono::nanoseconds>(endTime - startTime);
+    return result;
+}
+
+ShaderCompilationResult ShaderManager::compileSPIRVWithGlslc(const std::string& source,
+                                                             const std::string& fileName,
+                                                             const ShaderStageInfo& stageInfo,
+                                                             const std::vector<std::string>& includePaths,
+                                                             const std::unordered_map<std::string, std::string>& defines) const {
+    ShaderCompilationResult result;
+    const std::filesystem::path sourceDirectory = std::filesystem::path(ShaderFileWatcher::normalizePath(fileName)).parent_path();
+    result.sourceFiles.push_back(ShaderFileWatcher::normalizePath(fileName));
+    
+    // Cache key: everything that changes the output. Defines are sorted, unordered_map order is not stable
+    ContentHash hash;
+    hash.add(getGlslcStageArgument(stageInfo.stage))
+        .add(stageInfo.entryPoint)
+        .add(stageInfo.enableOptimization ? "O" : "O0")
+        .add(stageInfo.enableDebugInfo ? "g" : "")
+        .add(source);
+    hashIncludes(source, sourceDirectory, includePaths, hash, result.sourceFiles);
+    for (const auto& [name, value] : std::map<std::string, std::string>(defines.begin(), defines.end())) {
+        hash.add(name).add(value);
+    }
+    
+    const std::filesystem::path cacheDirectory(SHADER_SPIRV_CACHE_DIRECTORY);
+    const std::string cachePath = (cacheDirectory / (hash.hex() + ".spv")).string();
+    
+    std::error_code error;
+    if (std::filesystem::exists(cachePath, error)) {
+        result.spirvCode = loadSPIRVBinaryFromFile(cachePath);
+        if (validateSPIRV(result.spirvCode)) {
+            result.success = true;
+            result.fromDiskCache = true;
+            return result;
+        }
+        // Corrupt entry: compile again and overwrite it
+        result.spirvCode.clear();
+    }
     
-    if (spirvCode.empty()) {
-        result.success = false;
-        result.errorMessage = "GLSL compilation failed";
+    if (!ShaderCompiler::isGlslcAvailable()) {
+        result.errorMessage = "glslc not found, cannot compile " + fileName;
         return result;
     }
     
-    result.success = true;
-    result.spirvCode = std::move(spirvCode);
+    // glslc compiles a copy named after the job, so concurrent workers never share a temporary; the
+    // original directory goes first on the include path since the copy lives elsewhere
+    static std::atomic<uint64_t> jobCounter{0};
+    const std::string stem = hash.hex() + "_" + std::to_string(jobCounter.fetch_add(1));
+    const std::string inputPath = (cacheDirectory / (stem + ".glsl")).string();
+    const std::string outputPath = (cacheDirectory / (stem + ".spv.tmp")).string();
+    const std::string logPath = (cacheDirectory / (stem + ".log")).string();
+    
+    std::filesystem::create_directories(cacheDirectory, error);
+    {
+        std::ofstream input(inputPath, std::ios::trunc);
+        if (!input.is_open() || !(input << source)) {
+            result.errorMessage = "Failed to write " + inputPath;
+            return result;
+        }
+    }
+    
+    std::vector<std::string> searchPaths{sourceDirectory.string()};
+    searchPaths.insert(searchPaths.end(), includePaths.begin(), includePaths.end());
+    
+    std::string command = quoteArgument(glslcPath);
+    for (const std::string& argument : buildCompilerArguments(stageInfo, searchPaths, defines)) {
+        command += " " + argument;
+    }
+    command += " -o " + quoteArgument(outputPath) + " " + quoteArgument(inputPath) + " 2> " + quoteArgument(logPath);
+    
+    const int exitCode = std::system(command.c_str());
+    if (exitCode == 0) {
+        result.spirvCode = loadSPIRVBinaryFromFile(outputPath);
+        result.success = validateSPIRV(result.spirvCode);
+    }
+    
+    if (result.success) {
+        // Renamed into place, so a reader never sees a partial file
+        std::filesystem::rename(outputPath, cachePath, error);
+        if (error) {
+            std::cerr << "ShaderManager: Failed to cache " << fileName << " as " << cachePath << ": " << error.message() << std::endl;
+        }
+    } else {
+        result.errorMessage = readTextFile(logPath);
+        if (result.errorMessage.empty()) {
+            result.errorMessage = "glslc exited with code " + std::to_string(exitCode);
+        }
+    }
+    
+    std::filesystem::remove(inputPath, error);
+    std::filesystem::remove(outputPath, error);
+    std::filesystem::remove(logPath, error);
     return result;
 }
 
-std::vector<uint32_t> ShaderManager::compileSPIRVWithGlslc(const std::string& source,
-                                                          VkShaderStageFlagBits stage,
-                                                          const std::string& fileName,
-                                                          const std::unordered_map<std::string, std::string>& defines) const {
-    // For now, return empty vector as external compilation requires process execution
-    // In a full implementation, this would:
-    // 1. Write source to temporary file
-    // 2. Execute glslc with appropriate arguments
-    // 3. Read compiled SPIR-V from output file
-    // 4. Clean up temporary files
+std::string ShaderManager::getGlslcStageArgument(VkShaderStageFlagBits stage) const {
+    switch (stage) {
+        case VK_SHADER_STAGE_VERTEX_BIT: return "vert";
+        case VK_SHADER_STAGE_FRAGMENT_BIT: return "frag";
+        case VK_SHADER_STAGE_COMPUTE_BIT: return "comp";
+        case VK_SHADER_STAGE_GEOMETRY_BIT: return "geom";
+        case VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT: return "tesc";
+        case VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT: return "tese";
+        default: return "vert";
+    }
+}
+
+std::vector<std::string> ShaderManager::buildCompilerArguments(const ShaderStageInfo& stageInfo,
+                                                              const std::vector<std::string>& includePaths,
+                                                              const std::unordered_map<std::string, std::string>& defines) const {
+    std::vector<std::string> arguments;
+    arguments.push_back("-fshader-stage=" + getGlslcStageArgument(stageInfo.stage));
+    if (stageInfo.entryPoint != "main") {
+        arguments.push_back("-fentry-point=" + stageInfo.entryPoint);
+    }
+    arguments.push_back(stageInfo.enableOptimization ? "-O" : "-O0");
+    if (stageInfo.enableDebugInfo) {
+        arguments.push_back("-g");
+    }
     
-    std::cerr << "GLSL compilation not implemented in this demo version" << std::endl;
-    return {};
+    for (const std::string& includePath : includePaths) {
+        arguments.push_back("-I" + quoteArgument(includePath));
+    }
+    for (const auto& [name, value] : defines) {
+        arguments.push_back(quoteArgument("-D" + name + (value.empty() ? "" : "=" + value)));
+    }
+    return arguments;
 }
 
 VkPipelineShaderStageCreateInfo ShaderManager::createShaderStage(VkShaderModule module,
@@ -379,9 +704,11 @@ VkPipelineShaderStageCreateInfo ShaderManager::createComputeShaderStage(VkShader
 
 void ShaderManager::clearCache() {
     if (!context_) return;
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
     
     // RAII wrappers automatically destroy shader modules
     shaderCache_.clear();
+    retiredModules_.clear();
     stats.totalShaders = 0;
 }
 
@@ -402,18 +729,40 @@ void ShaderManager::evictLeastRecentlyUsed() {
 }
 
 bool ShaderManager::reloadShader(const ShaderModuleSpec& spec) {
+    std::shared_future<ShaderCompilationResult> pending;
+    {
+        std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+        if (!shaderCache_.count(spec)) {
+            return false;
+        }
+        pending = submitCompile(spec);
+    }
+    
+    JobSystem::getInstance().waitFor(pending);
+    ShaderCompilationResult result = pending.get();
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+    return adoptReload(spec, std::move(result));
+}
+
+bool ShaderManager::adoptReload(const ShaderModuleSpec& spec, ShaderCompilationResult result) {
+    PROFILE_HITCH_EVENT(HitchCause::ShaderReload);
     auto it = shaderCache_.find(spec);
     if (it == shaderCache_.end()) {
-        return false;
+        return false;  // Evicted while recompiling
     }
     
-    // RAII wrapper automatically destroys old shader module
-    // Remove from cache
-    shaderCache_.erase(it);
-    stats.totalShaders--;
+    auto cachedShader = createShaderInternal(spec, std::move(result));
+    if (!cachedShader) {
+        std::cerr << "ShaderManager: Reload of " << spec.filePath << " failed, keeping the old module" << std::endl;
+        return false;
+    }
     
-    // Reload shader
-    VkShaderModule newModule = loadShader(spec);
+    cachedShader->lastUsedFrame = it->second->lastUsedFrame;
+    cachedShader->useCount = it->second->useCount;
+    retiredModules_.push_back(std::move(it->second->module));
+    it->second = std::move(cachedShader);
+    VkShaderModule newModule = it->second->module.get();
+    stats.hotReloadsThisFrame++;
     
     // Trigger reload callbacks
     auto callbackIt = reloadCallbacks_.find(spec.filePath);
@@ -423,7 +772,100 @@ bool ShaderManager::reloadShader(const ShaderModuleSpec& spec) {
         }
     }
     
-    return newModule != VK_NULL_HANDLE;
+    return true;
+}
+
+void ShaderManager::enableHotReload(bool enable) {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+    if (enable == hotReloadEnabled) {
+        return;
+    }
+    hotReloadEnabled = enable;
+    
+    if (!enable) {
+        fileWatcher_.unwatchAll();
+        return;
+    }
+    for (const auto& [spec, cachedShader] : shaderCache_) {
+        if (cachedShader->isHotReloadable) {
+            watchModuleSources(*cachedShader);
+        }
+    }
+}
+
+void ShaderManager::checkForShaderReloads() {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+    if (!hotReloadEnabled) {
+        return;
+    }
+    
+    const std::vector<std::string> changes = fileWatcher_.pollChanges();
+    for (const auto& entry : shaderCache_) {
+        const ShaderModuleSpec& spec = entry.first;
+        if (!entry.second->isHotReloadable) {
+            continue;
+        }
+        const std::vector<std::string>& sourceFiles = entry.second->sourceFiles;
+        const bool changed = std::any_of(sourceFiles.begin(), sourceFiles.end(),
+            [&changes](const std::string& file) {
+                return std::find(changes.begin(), changes.end(), file) != changes.end();
+            });
+        const bool queued = std::any_of(pendingReloads_.begin(), pendingReloads_.end(),
+            [&spec](const PendingReload& reload) { return reload.spec == spec; });
+        if (changed && !queued) {
+            std::cout << "Hot reloading shader: " << spec.filePath << std::endl;
+            pendingReloads_.push_back({spec, submitCompile(spec)});
+        }
+    }
+    
+    // Only finished recompiles are adopted; the rest are looked at again next frame
+    for (auto it = pendingReloads_.begin(); it != pendingReloads_.end();) {
+        if (it->result.wait_for(std::chrono::seconds(0)) != std::future_status::ready) {
+            ++it;
+            continue;
+        }
+        adoptReload(it->spec, it->result.get());
+        it = pendingReloads_.erase(it);
+    }
+}
+
+void ShaderManager::registerReloadCallback(const std::string& shaderPath,
+                                          std::function<void(VkShaderModule)> callback) {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+    reloadCallbacks_[shaderPath].push_back(std::move(callback));
+}
+
+void ShaderManager::addIncludePath(const std::string& path) {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+    if (std::find(globalIncludePaths_.begin(), globalIncludePaths_.end(), path) == globalIncludePaths_.end()) {
+        globalIncludePaths_.push_back(path);
+    }
+}
+
+void ShaderManager::removeIncludePath(const std::string& path) {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+    globalIncludePaths_.erase(std::remove(globalIncludePaths_.begin(), globalIncludePaths_.end(), path),
+                              globalIncludePaths_.end());
+}
+
+void ShaderManager::clearIncludePaths() {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+    globalIncludePaths_.clear();
+}
+
+void ShaderManager::addGlobalDefine(const std::string& name, const std::string& value) {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+    globalDefines_[name] = value;
+}
+
+void ShaderManager::removeGlobalDefine(const std::string& name) {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+    globalDefines_.erase(name);
+}
+
+void ShaderManager::clearGlobalDefines() {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+    globalDefines_.clear();
 }
 
 std::string ShaderManager::loadShaderSource(const std::string& filePath) const {
@@ -450,11 +892,6 @@ std::filesystem::file_time_type ShaderManager::getFileModifiedTime(const std::st
     }
 }
 
-bool ShaderManager::isFileNewer(const std::string& path, std::filesystem::file_time_type lastModified) const {
-    auto currentModified = getFileModifiedTime(path);
-    return currentModified > lastModified;
-}
-
 VkShaderStageFlagBits ShaderManager::getShaderStageFromFilename(const std::string& filename) const {
     std::string extension = std::filesystem::path(filename).extension().string();
     
@@ -476,21 +913,52 @@ VkShaderStageFlagBits ShaderManager::getShaderStageFromFilename(const std::strin
     return VK_SHADER_STAGE_VERTEX_BIT;
 }
 
-void ShaderManager::performBasicReflection(CachedShaderModule& cachedModule) const {
-    // Basic reflection implementation
-    // In a full implementation, this would use SPIRV-Reflect or similar
-    
-    // For now, just set some defaults based on shader stage
-    VkShaderStageFlagBits stage = cachedModule.spec.stageInfo.stage;
+void ShaderManager::performReflection(CachedShaderModule& cachedModule, const EmbeddedShader* embedded) const {
+    SpirvReflection& reflection = cachedModule.reflection;
+    if (!reflectSpirv(cachedModule.spirvCode.data(), cachedModule.spirvCode.size(), reflection)) {
+        std::cerr << "ShaderManager: Could not reflect " << cachedModule.spec.filePath << std::endl;
+        reflection = SpirvReflection{};
+        reflection.stage = cachedModule.spec.stageInfo.stage;
+    }
     
-    if (stage == VK_SHADER_STAGE_COMPUTE_BIT) {
-        // Default compute workgroup size
-        cachedModule.reflection.localSizeX = 32;
-        cachedModule.reflection.localSizeY = 1;
-        cachedModule.reflection.localSizeZ = 1;
+    // Embedded modules carry the size embed-shaders.cmake read from OpExecutionMode LocalSize, the same
+    // instruction the reflection reads; compute modules without a literal size keep the old 32 wide default
+    if (embedded) {
+        std::copy(std::begin(embedded->localSize), std::end(embedded->localSize), reflection.localSize);
+    } else if (reflection.stage == VK_SHADER_STAGE_COMPUTE_BIT && !reflection.hasLocalSize) {
+        reflection.localSize[0] = 32;
     }
 }
 
+bool ShaderManager::reflectShader(VkShaderModule module, SpirvReflection& reflection) const {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+    for (const auto& [spec, cached] : shaderCache_) {
+        if (cached && cached->module.get() == module) {
+            reflection = cached->reflection;
+            return true;
+        }
+    }
+    return false;
+}
+
+SpirvReflection ShaderManager::reflectSPIRV(const std::vector<uint32_t>& spirvCode) const {
+    SpirvReflection reflection;
+    reflectSpirv(spirvCode.data(), spirvCode.size(), reflection);
+    return reflection;
+}
+
+bool ShaderManager::reflectShaderFile(const std::string& filePath, SpirvReflection& reflection) const {
+    // Embedded modules shadow the files, as produceSpirv() loads them
+    if (const EmbeddedShader* embedded = findEmbeddedShader(filePath)) {
+        return reflectSpirv(embedded->code, embedded->wordCount, reflection);
+    }
+    if (!fileExists(filePath)) {
+        return false;
+    }
+    const std::vector<uint32_t> code = loadSPIRVBinaryFromFile(filePath);
+    return reflectSpirv(code.data(), code.size(), reflection);
+}
+
 void ShaderManager::logShaderCompilation(const ShaderModuleSpec& spec,
                                         std::chrono::nanoseconds compilationTime,
                                         bool success) const {
@@ -561,17 +1029,20 @@ namespace ShaderPresets {
 }
 
 // ShaderCompiler static class implementation
+// Probed once per process; ShaderManager's compile jobs call these concurrently
 bool ShaderCompiler::isGlslcAvailable() {
-    // Simple check - in a real implementation, this would try to execute glslc --version
-    return false;  // Disabled for this demo
+    static const bool available = std::system((std::string("glslc --version > ") + NULL_DEVICE + " 2>&1").c_str()) == 0;
+    return available;
 }
 
 bool ShaderCompiler::isSpirvOptAvailable() {
-    // Simple check - in a real implementation, this would try to execute spirv-opt --version
-    return false;  // Disabled for this demo
+    static const bool available = std::system((std::string("spirv-opt --version > ") + NULL_DEVICE + " 2>&1").c_str()) == 0;
+    return available;
 }
 
 void ShaderManager::optimizeCache(uint64_t currentFrame) {
+    std::lock_guard<std::recursive_mutex> lock(cacheMutex_);
+    
     // Simple LRU eviction for shader cache
     for (auto it = shaderCache_.begin(); it != shaderCache_.end();) {
         if (currentFrame - it->second->lastUsedFrame > CACHE_CLEANUP_INTERVAL) {
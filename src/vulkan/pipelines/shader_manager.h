@@ -6,13 +6,23 @@
 #include <string>
 #include <unordered_map>
 #include <memory>
+#include <memory_resource>
 #include <chrono>
 #include <functional>
 #include <fstream>
 #include <filesystem>
+#include <mutex>
+#include <thread>
+#include <atomic>
+#include <future>
 #include "../core/vulkan_context.h"
 #include "../core/vulkan_raii.h"
 #include "../core/vulkan_constants.h"
+#include "../../ecs/utilities/job_system.h"
+#include "../../ecs/utilities/memory_tags.h"
+#include "shader_file_watcher.h"
+#include "embedded_shaders.h"
+#include "spirv_reflection.h"
 
 // Shader compilation types
 enum class ShaderSourceType {
@@ -68,7 +78,7 @@ struct ShaderModuleSpecHash {
 struct CachedShaderModule {
     vulkan_raii::ShaderModule module;  // RAII wrapper for automatic cleanup
     ShaderModuleSpec spec;
-    std::vector<uint32_t> spirvCode;  // Store SPIR-V for reflection
+    std::pmr::vector<uint32_t> spirvCode{&MemoryTags::getResource(MemoryTag::ShaderManager)};  // Store SPIR-V for reflection
     
     // Usage tracking
     uint64_t lastUsedFrame = 0;
@@ -78,15 +88,10 @@ struct CachedShaderModule {
     std::chrono::nanoseconds compilationTime{0};
     std::filesystem::file_time_type sourceModified{};
     bool isHotReloadable = false;
+    std::vector<std::string> sourceFiles;  // Normalized source and include paths, matched against file changes
     
-    // Reflection data (for descriptor set layout generation)
-    struct ReflectionData {
-        std::vector<VkDescriptorSetLayoutBinding> descriptorBindings;
-        std::vector<VkPushConstantRange> pushConstantRanges;
-        uint32_t localSizeX = 1;  // For compute shaders
-        uint32_t localSizeY = 1;
-        uint32_t localSizeZ = 1;
-    } reflection;
+    // Reflected interface (descriptors, push constants, workgroup size) for layout generation
+    SpirvReflection reflection;
 };
 
 // Shader compilation result
@@ -95,6 +100,9 @@ struct ShaderCompilationResult {
     std::vector<uint32_t> spirvCode;
     std::string errorMessage;
     std::chrono::nanoseconds compilationTime{0};
+    std::vector<std::string> sourceFiles;  // The file itself, then every include it resolved
+    bool fromDiskCache = false;
+    const EmbeddedShader* embedded = nullptr;  // Code and reflection baked into the executable, no file behind it
 };
 
 // AAA Shader Manager with advanced features
@@ -117,10 +125,17 @@ public:
                                      const std::string& entryPoint = "main");
     VkShaderModule loadSPIRVFromFile(const std::string& filePath);
     
-    // Batch shader compilation for reduced overhead
+    // Batch shader compilation for reduced overhead: every spec is queued as a compile job before
+    // the first is waited on, so the glslc invocations run in parallel
     std::vector<VkShaderModule> loadShadersBatch(const std::vector<ShaderModuleSpec>& specs);
     
-    // GLSL compilation (requires external compiler like glslc or shaderc)
+    // Queues a compile job for a spec and returns at once; a later loadShader() waits for the queued
+    // job instead of starting another. False when the spec is already cached or queued
+    bool compileAsync(const ShaderModuleSpec& spec);
+    
+    // GLSL compilation through glslc. SPIR-V is cached on disk in SHADER_SPIRV_CACHE_DIRECTORY under a
+    // content hash of the source, every file it includes, the defines and the stage, so unchanged
+    // shaders skip the compiler on later runs
     ShaderCompilationResult compileGLSL(const std::string& source,
                                        VkShaderStageFlagBits stage,
                                        const std::string& fileName = "shader.glsl",
@@ -145,34 +160,22 @@ public:
     VkPipelineShaderStageCreateInfo createComputeShaderStage(VkShaderModule computeShader,
                                                             const std::string& entryPoint = "main");
     
-    // Hot reloading support
-    void enableHotReload(bool enable) { hotReloadEnabled = enable; }
+    // Hot reloading support. Cached hot-reloadable modules are watched through ShaderFileWatcher;
+    // checkForShaderReloads() runs once per frame, queues a recompile for every module whose source or
+    // includes changed and swaps in the modules whose recompiles have finished, so it never waits on a
+    // compile. Replaced modules are kept until clearCache(), since a background pipeline compile may
+    // still be reading one
+    void enableHotReload(bool enable);
     void checkForShaderReloads();
-    bool reloadShader(const ShaderModuleSpec& spec);
+    bool reloadShader(const ShaderModuleSpec& spec);  // Blocking: recompiles and swaps before returning
     void registerReloadCallback(const std::string& shaderPath, 
                                std::function<void(VkShaderModule)> callback);
     
-    // Shader reflection and analysis
-    struct ShaderReflection {
-        std::vector<VkDescriptorSetLayoutBinding> descriptorBindings;
-        std::vector<VkPushConstantRange> pushConstantRanges;
-        VkShaderStageFlags stageFlags = 0;
-        
-        // Compute shader specific
-        uint32_t localSizeX = 1;
-        uint32_t localSizeY = 1;
-        uint32_t localSizeZ = 1;
-        
-        // Resources used
-        uint32_t uniformBuffers = 0;
-        uint32_t storageBuffers = 0;
-        uint32_t sampledImages = 0;
-        uint32_t storageImages = 0;
-        uint32_t samplers = 0;
-    };
-    
-    ShaderReflection reflectShader(VkShaderModule module) const;
-    ShaderReflection reflectSPIRV(const std::vector<uint32_t>& spirvCode) const;
+    // Shader reflection: the interface of a loaded module (false when module is not one of this cache's), of
+    // SPIR-V code, or of a .spv path (embedded or on disk) without creating a module
+    bool reflectShader(VkShaderModule module, SpirvReflection& reflection) const;
+    SpirvReflection reflectSPIRV(const std::vector<uint32_t>& spirvCode) const;
+    bool reflectShaderFile(const std::string& filePath, SpirvReflection& reflection) const;
     
     // Cache management
     void warmupCache(const std::vector<ShaderModuleSpec>& commonShaders);
@@ -191,6 +194,8 @@ public:
         uint32_t totalShaders = 0;
         uint32_t cacheHits = 0;
         uint32_t cacheMisses = 0;
+        uint32_t diskCacheHits = 0;  // GLSL compiles answered from SHADER_SPIRV_CACHE_DIRECTORY
+        uint32_t embeddedLoads = 0;  // SPIR-V binaries taken from the executable instead of disk
         uint32_t compilationsThisFrame = 0;
         uint32_t hotReloadsThisFrame = 0;
         std::chrono::nanoseconds totalCompilationTime{0};
@@ -219,12 +224,33 @@ private:
     // Core Vulkan objects
     const VulkanContext* context_ = nullptr;
     
-    // Shader cache
-    std::unordered_map<ShaderModuleSpec, std::unique_ptr<CachedShaderModule>, ShaderModuleSpecHash> shaderCache_;
+    // Shader cache; background pipeline compiles load modules from worker threads. Recursive because
+    // loadShader() and reloadShader() call each other. Entries charged to MemoryTag::ShaderManager
+    std::pmr::unordered_map<ShaderModuleSpec, std::unique_ptr<CachedShaderModule>, ShaderModuleSpecHash> shaderCache_{
+        &MemoryTags::getResource(MemoryTag::ShaderManager)};
+    mutable std::recursive_mutex cacheMutex_;
     
-    // Hot reload tracking
+    // Hot reload tracking: recompiles in flight, and the modules finished reloads replaced
+    struct PendingReload {
+        ShaderModuleSpec spec;
+        std::shared_future<ShaderCompilationResult> result;
+    };
     std::unordered_map<std::string, std::vector<std::function<void(VkShaderModule)>>> reloadCallbacks_;
-    std::unordered_map<std::string, std::filesystem::file_time_type> fileWatchList_;
+    std::vector<PendingReload> pendingReloads_;
+    std::vector<vulkan_raii::ShaderModule> retiredModules_;
+    ShaderFileWatcher fileWatcher_;
+    
+    // Compiles run as JobSystem jobs. Jobs carry the include paths and defines resolved when they were
+    // queued, so they never read manager state; pendingCompiles_ (under cacheMutex_) lets loads share a job
+    struct CompileJob {
+        ShaderModuleSpec spec;
+        std::vector<std::string> includePaths;                  // The spec's, then the global ones
+        std::unordered_map<std::string, std::string> defines;  // Global, overridden by the spec's
+        std::promise<ShaderCompilationResult> result;
+    };
+    JobCounter compileJobs_;
+    std::atomic<bool> acceptingCompiles_{false};
+    std::unordered_map<ShaderModuleSpec, std::shared_future<ShaderCompilationResult>, ShaderModuleSpecHash> pendingCompiles_;
     
     // Global include paths and defines
     std::vector<std::string> globalIncludePaths_;
@@ -242,8 +268,17 @@ private:
     std::string glslcPath = "glslc";  // Path to glslc compiler
     std::string spirvOptPath = "spirv-opt";  // Path to SPIR-V optimizer
     
-    // Internal shader creation
-    std::unique_ptr<CachedShaderModule> createShaderInternal(const ShaderModuleSpec& spec);
+    // Compile worker pool
+    void finishCompileJobs();  // Stops queueing and waits out the queued compiles
+    CompileJob makeCompileJob(const ShaderModuleSpec& spec) const;
+    std::shared_future<ShaderCompilationResult> submitCompile(const ShaderModuleSpec& spec);
+    std::shared_future<ShaderCompilationResult> queueCompile(const ShaderModuleSpec& spec);  // Shares a queued job
+    ShaderCompilationResult produceSpirv(const CompileJob& job) const;  // Worker side: reads files, runs glslc
+    
+    // Internal shader creation, from a finished compile
+    std::unique_ptr<CachedShaderModule> createShaderInternal(const ShaderModuleSpec& spec, ShaderCompilationResult result);
+    bool adoptReload(const ShaderModuleSpec& spec, ShaderCompilationResult result);
+    void watchModuleSources(const CachedShaderModule& cachedModule);
     vulkan_raii::ShaderModule createVulkanShaderModule(const std::vector<uint32_t>& spirvCode);
     
     // SPIR-V loading and validation
@@ -251,14 +286,15 @@ private:
     bool validateSPIRV(const std::vector<uint32_t>& spirvCode) const;
     
     // Compilation helpers
-    std::vector<uint32_t> compileSPIRVWithGlslc(const std::string& source,
-                                               VkShaderStageFlagBits stage,
-                                               const std::string& fileName,
-                                               const std::unordered_map<std::string, std::string>& defines) const;
+    ShaderCompilationResult compileSPIRVWithGlslc(const std::string& source,
+                                                  const std::string& fileName,
+                                                  const ShaderStageInfo& stageInfo,
+                                                  const std::vector<std::string>& includePaths,
+                                                  const std::unordered_map<std::string, std::string>& defines) const;
     
     std::string getGlslcStageArgument(VkShaderStageFlagBits stage) const;
-    std::vector<std::string> buildCompilerArguments(VkShaderStageFlagBits stage,
-                                                   const std::string& fileName,
+    std::vector<std::string> buildCompilerArguments(const ShaderStageInfo& stageInfo,
+                                                   const std::vector<std::string>& includePaths,
                                                    const std::unordered_map<std::string, std::string>& defines) const;
     
     // Cache management helpers
@@ -268,10 +304,9 @@ private:
     // File system helpers
     bool fileExists(const std::string& path) const;
     std::filesystem::file_time_type getFileModifiedTime(const std::string& path) const;
-    bool isFileNewer(const std::string& path, std::filesystem::file_time_type lastModified) const;
     
-    // Reflection helpers (basic implementation)
-    void performBasicReflection(CachedShaderModule& cachedModule) const;
+    // Reflects the module's SPIR-V into cachedModule.reflection
+    void performReflection(CachedShaderModule& cachedModule, const EmbeddedShader* embedded) const;
     
     // Error handling and logging
     void logShaderCompilation(const ShaderModuleSpec& spec, 
@@ -0,0 +1,483 @@
+#include "spirv_reflection.h"
+#include <algorithm>
+#include <unordered_map>
+#include <unordered_set>
+
+namespace {
+    // The parts of the SPIR-V specification (unified 1.6) this reads
+    constexpr uint32_t SPIRV_MAGIC = 0x07230203;
+    constexpr size_t SPIRV_HEADER_WORDS = 5;
+    
+    enum Opcode : uint32_t {
+        OpName = 5,
+        OpEntryPoint = 15,
+        OpExecutionMode = 16,
+        OpTypeInt = 21,
+        OpTypeFloat = 22,
+        OpTypeVector = 23,
+        OpTypeMatrix = 24,
+        OpTypeImage = 25,
+        OpTypeSampler = 26,
+        OpTypeSampledImage = 27,
+        OpTypeArray = 28,
+        OpTypeRuntimeArray = 29,
+        OpTypeStruct = 30,
+        OpTypePointer = 32,
+        OpConstant = 43,
+        OpSpecConstant = 50,
+        OpFunction = 54,
+        OpFunctionCall = 57,
+        OpVariable = 59,
+        OpImageTexelPointer = 60,
+        OpLoad = 61,
+        OpStore = 62,
+        OpCopyMemory = 63,
+        OpCopyMemorySized = 64,
+        OpAccessChain = 65,
+        OpInBoundsAccessChain = 66,
+        OpPtrAccessChain = 67,
+        OpArrayLength = 68,
+        OpInBoundsPtrAccessChain = 70,
+        OpDecorate = 71,
+        OpMemberDecorate = 72,
+        OpCopyObject = 83,
+        OpAtomicLoad = 227,
+        OpAtomicStore = 228,
+        OpAtomicXor = 242,     // Last of the pointer-first atomics starting at OpAtomicExchange
+        OpAtomicFMinEXT = 5614,
+        OpAtomicFMaxEXT = 5615,
+        OpAtomicFAddEXT = 6035,
+        OpTypeAccelerationStructureKHR = 5341,
+    };
+    
+    enum Decoration : uint32_t {
+        DecorationBlock = 2,
+        DecorationBufferBlock = 3,
+        DecorationArrayStride = 6,
+        DecorationMatrixStride = 7,
+        DecorationNonWritable = 24,
+        DecorationNonReadable = 25,
+        DecorationBinding = 33,
+        DecorationDescriptorSet = 34,
+        DecorationOffset = 35,
+    };
+    
+    enum StorageClass : uint32_t {
+        StorageClassUniformConstant = 0,
+        StorageClassUniform = 2,
+        StorageClassPushConstant = 9,
+        StorageClassStorageBuffer = 12,
+    };
+    
+    constexpr uint32_t EXECUTION_MODE_LOCAL_SIZE = 17;
+    constexpr uint32_t IMAGE_DIM_BUFFER = 5;
+    constexpr uint32_t IMAGE_DIM_SUBPASS_DATA = 6;
+    
+    struct Decorations {
+        bool block = false;
+        bool bufferBlock = false;
+        bool nonWritable = false;
+        bool nonReadable = false;
+        bool hasBinding = false;
+        bool hasSet = false;
+        uint32_t binding = 0;
+        uint32_t set = 0;
+        uint32_t arrayStride = 0;
+    };
+    
+    struct MemberDecorations {
+        uint32_t offset = 0;
+        uint32_t matrixStride = 0;
+        bool nonWritable = false;
+        bool nonReadable = false;
+    };
+    
+    struct Variable {
+        uint32_t id = 0;
+        uint32_t pointerType = 0;
+        uint32_t storageClass = 0;
+    };
+    
+    // Types by result id: the opcode and the words after the result id
+    struct Type {
+        uint32_t opcode = 0;
+        std::vector<uint32_t> operands;
+    };
+    
+    class ModuleParser {
+    public:
+        ModuleParser(const uint32_t* code, size_t wordCount) : code(code), wordCount(wordCount) {}
+        
+        bool parse(SpirvReflection& reflection) {
+            if (wordCount < SPIRV_HEADER_WORDS || code[0] != SPIRV_MAGIC) {
+                return false;
+            }
+            
+            for (size_t word = SPIRV_HEADER_WORDS; word < wordCount; ) {
+                const uint32_t instructionWords = code[word] >> 16;
+                const uint32_t opcode = code[word] & 0xFFFF;
+                if (instructionWords == 0 || word + instructionWords > wordCount) {
+                    return false;
+                }
+                readInstruction(opcode, code + word, instructionWords, reflection);
+                word += instructionWords;
+            }
+            
+            collectResources(reflection);
+            return true;
+        }
+    
+    private:
+        const uint32_t* code;
+        size_t wordCount;
+        
+        std::unordered_map<uint32_t, std::string> names;
+        std::unordered_map<uint32_t, Decorations> decorations;
+        std::unordered_map<uint32_t, std::vector<MemberDecorations>> memberDecorations;
+        std::unordered_map<uint32_t, Type> types;
+        std::unordered_map<uint32_t, uint32_t> constants;
+        std::vector<Variable> variables;
+        std::unordered_set<uint32_t> referenced;  // Pointer operands of the functions' memory instructions
+        bool inFunctions = false;
+        
+        static std::string readString(const uint32_t* words, uint32_t count) {
+            std::string text;
+            for (uint32_t i = 0; i < count; ++i) {
+                for (uint32_t byte = 0; byte < 4; ++byte) {
+                    const char c = static_cast<char>((words[i] >> (byte * 8)) & 0xFF);
+                    if (c == '\0') return text;
+                    text.push_back(c);
+                }
+            }
+            return text;
+        }
+        
+        MemberDecorations& member(uint32_t structId, uint32_t index) {
+            auto& members = memberDecorations[structId];
+            if (members.size() <= index) {
+                members.resize(index + 1);
+            }
+            return members[index];
+        }
+        
+        void reference(const uint32_t* instruction, uint32_t words, uint32_t operand) {
+            if (operand < words) {
+                referenced.insert(instruction[operand]);
+            }
+        }
+        
+        void readInstruction(uint32_t opcode, const uint32_t* instruction, uint32_t words, SpirvReflection& reflection) {
+            if (inFunctions || opcode == OpFunction) {
+                inFunctions = true;
+                readFunctionInstruction(opcode, instruction, words);
+                return;
+            }
+            
+            switch (opcode) {
+                case OpName:
+                    if (words >= 3) names[instruction[1]] = readString(instruction + 2, words - 2);
+                    break;
+                case OpEntryPoint:
+                    if (words >= 3) reflection.stage = stageFromExecutionModel(instruction[1]);
+                    break;
+                case OpExecutionMode:
+                    if (words == 6 && instruction[2] == EXECUTION_MODE_LOCAL_SIZE) {
+                        reflection.localSize[0] = instruction[3];
+                        reflection.localSize[1] = instruction[4];
+                        reflection.localSize[2] = instruction[5];
+                        reflection.hasLocalSize = true;
+                    }
+                    break;
+                case OpDecorate:
+                    if (words >= 3) readDecoration(instruction[1], instruction[2], words > 3 ? instruction[3] : 0);
+                    break;
+                case OpMemberDecorate:
+                    if (words >= 4) readMemberDecoration(instruction[1], instruction[2], instruction[3], words > 4 ? instruction[4] : 0);
+                    break;
+                case OpConstant:
+                case OpSpecConstant:
+                    // Array lengths; a specialized length is taken at its default
+                    if (words >= 4) constants[instruction[2]] = instruction[3];
+                    break;
+                case OpVariable:
+                    if (words >= 4) variables.push_back({instruction[2], instruction[1], instruction[3]});
+                    break;
+                default:
+                    if ((opcode >= OpTypeInt && opcode <= OpTypePointer) || opcode == OpTypeAccelerationStructureKHR) {
+                        if (words >= 2) {
+                            types[instruction[1]] = {opcode, std::vector<uint32_t>(instruction + 2, instruction + words)};
+                        }
+                    }
+                    break;
+            }
+        }
+        
+        void readFunctionInstruction(uint32_t opcode, const uint32_t* instruction, uint32_t words) {
+            switch (opcode) {
+                case OpLoad:
+                case OpAccessChain:
+                case OpInBoundsAccessChain:
+                case OpPtrAccessChain:
+                case OpInBoundsPtrAccessChain:
+                case OpArrayLength:
+                case OpImageTexelPointer:
+                case OpCopyObject:
+                case OpAtomicLoad:
+                case OpAtomicFMinEXT:
+                case OpAtomicFMaxEXT:
+                case OpAtomicFAddEXT:
+                    reference(instruction, words, 3);
+                    break;
+                case OpStore:
+                case OpAtomicStore:
+                    reference(instruction, words, 1);
+                    break;
+                case OpCopyMemory:
+                case OpCopyMemorySized:
+                    reference(instruction, words, 1);
+                    reference(instruction, words, 2);
+                    break;
+                case OpFunctionCall:
+                    for (uint32_t operand = 4; operand < words; ++operand) {
+                        reference(instruction, words, operand);
+                    }
+                    break;
+                default:
+                    if (opcode > OpAtomicStore && opcode <= OpAtomicXor) {
+                        reference(instruction, words, 3);
+                    }
+                    break;
+            }
+        }
+        
+        void readDecoration(uint32_t target, uint32_t decoration, uint32_t value) {
+            Decorations& entry = decorations[target];
+            switch (decoration) {
+                case DecorationBlock: entry.block = true; break;
+                case DecorationBufferBlock: entry.bufferBlock = true; break;
+                case DecorationArrayStride: entry.arrayStride = value; break;
+                case DecorationNonWritable: entry.nonWritable = true; break;
+                case DecorationNonReadable: entry.nonReadable = true; break;
+                case DecorationBinding: entry.binding = value; entry.hasBinding = true; break;
+                case DecorationDescriptorSet: entry.set = value; entry.hasSet = true; break;
+                default: break;
+            }
+        }
+        
+        void readMemberDecoration(uint32_t structId, uint32_t index, uint32_t decoration, uint32_t value) {
+            switch (decoration) {
+                case DecorationOffset: member(structId, index).offset = value; break;
+                case DecorationMatrixStride: member(structId, index).matrixStride = value; break;
+                case DecorationNonWritable: member(structId, index).nonWritable = true; break;
+                case DecorationNonReadable: member(structId, index).nonReadable = true; break;
+                default: break;
+            }
+        }
+        
+        static VkShaderStageFlagBits stageFromExecutionModel(uint32_t model) {
+            switch (model) {
+                case 0: return VK_SHADER_STAGE_VERTEX_BIT;
+                case 1: return VK_SHADER_STAGE_TESSELLATION_CONTROL_BIT;
+                case 2: return VK_SHADER_STAGE_TESSELLATION_EVALUATION_BIT;
+                case 3: return VK_SHADER_STAGE_GEOMETRY_BIT;
+                case 4: return VK_SHADER_STAGE_FRAGMENT_BIT;
+                default: return VK_SHADER_STAGE_COMPUTE_BIT;
+            }
+        }
+        
+        const Type* findType(uint32_t id) const {
+            auto it = types.find(id);
+            return it != types.end() ? &it->second : nullptr;
+        }
+        
+        uint32_t constantValue(uint32_t id) const {
+            auto it = constants.find(id);
+            return it != constants.end() ? it->second : 1u;
+        }
+        
+        // std430/std140 size as the module lays it out: explicit offsets and strides where it has them
+        uint32_t typeSize(uint32_t id, uint32_t matrixStride = 0, uint32_t depth = 0) const {
+            const Type* type = findType(id);
+            if (!type || depth > 16) return 0;
+            const auto& operands = type->operands;
+            switch (type->opcode) {
+                case OpTypeInt:
+                case OpTypeFloat:
+                    return operands.empty() ? 0 : operands[0] / 8;
+                case OpTypeVector:
+                    return operands.size() < 2 ? 0 : operands[1] * typeSize(operands[0], 0, depth + 1);
+                case OpTypeMatrix:
+                    if (operands.size() < 2) return 0;
+                    return operands[1] * (matrixStride ? matrixStride : typeSize(operands[0], 0, depth + 1));
+                case OpTypeArray: {
+                    if (operands.size() < 2) return 0;
+                    auto decorated = decorations.find(id);
+                    const uint32_t stride = decorated != decorations.end() && decorated->second.arrayStride
+                        ? decorated->second.arrayStride : typeSize(operands[0], 0, depth + 1);
+                    return constantValue(operands[1]) * stride;
+                }
+                case OpTypeStruct: {
+                    uint32_t size = 0;
+                    auto members = memberDecorations.find(id);
+                    for (size_t i = 0; i < operands.size(); ++i) {
+                        MemberDecorations layout{};
+                        if (members != memberDecorations.end() && i < members->second.size()) {
+                            layout = members->second[i];
+                        }
+                        size = std::max(size, layout.offset + typeSize(operands[i], layout.matrixStride, depth + 1));
+                    }
+                    return size;
+                }
+                default:
+                    return 0;  // Runtime arrays and opaque types
+            }
+        }
+        
+        bool allMembers(uint32_t structId, bool MemberDecorations::*flag) const {
+            const Type* type = findType(structId);
+            auto members = memberDecorations.find(structId);
+            if (!type || type->opcode != OpTypeStruct || type->operands.empty() || members == memberDecorations.end() ||
+                members->second.size() < type->operands.size()) {
+                return false;
+            }
+            return std::all_of(members->second.begin(), members->second.begin() + type->operands.size(),
+                               [flag](const MemberDecorations& m) { return m.*flag; });
+        }
+        
+        void collectResources(SpirvReflection& reflection) {
+            for (const Variable& variable : variables) {
+                const Type* pointer = findType(variable.pointerType);
+                if (!pointer || pointer->opcode != OpTypePointer || pointer->operands.size() < 2) continue;
+                uint32_t typeId = pointer->operands[1];
+                
+                if (variable.storageClass == StorageClassPushConstant) {
+                    reflection.pushConstantSize = std::max(reflection.pushConstantSize, typeSize(typeId));
+                    reflection.pushConstantsAccessed = reflection.pushConstantsAccessed || referenced.count(variable.id) != 0;
+                    continue;
+                }
+                if (variable.storageClass != StorageClassUniformConstant && variable.storageClass != StorageClassUniform &&
+                    variable.storageClass != StorageClassStorageBuffer) {
+                    continue;
+                }
+                
+                auto decorated = decorations.find(variable.id);
+                if (decorated == decorations.end() || !decorated->second.hasBinding) continue;
+                
+                SpirvResourceBinding resource;
+                resource.set = decorated->second.set;
+                resource.binding = decorated->second.binding;
+                resource.accessed = referenced.count(variable.id) != 0;
+                
+                // Arrays of descriptors
+                for (const Type* type = findType(typeId); type; type = findType(typeId)) {
+                    if (type->opcode == OpTypeArray && type->operands.size() >= 2) {
+                        resource.descriptorCount *= constantValue(type->operands[1]);
+                    } else if (type->opcode == OpTypeRuntimeArray && !type->operands.empty()) {
+                        resource.descriptorCount = 0;
+                    } else {
+                        break;
+                    }
+                    typeId = type->operands[0];
+                }
+                
+                const Type* type = findType(typeId);
+                if (!type) continue;
+                auto typeDecorations = decorations.find(typeId);
+                const bool bufferBlock = typeDecorations != decorations.end() && typeDecorations->second.bufferBlock;
+                switch (type->opcode) {
+                    case OpTypeStruct:
+                        resource.type = (variable.storageClass == StorageClassStorageBuffer || bufferBlock)
+                            ? VK_DESCRIPTOR_TYPE_STORAGE_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER;
+                        break;
+                    case OpTypeImage: {
+                        const uint32_t dim = type->operands.size() > 1 ? type->operands[1] : 0;
+                        const uint32_t sampled = type->operands.size() > 5 ? type->operands[5] : 1;
+                        if (dim == IMAGE_DIM_SUBPASS_DATA) {
+                            resource.type = VK_DESCRIPTOR_TYPE_INPUT_ATTACHMENT;
+                        } else if (dim == IMAGE_DIM_BUFFER) {
+                            resource.type = sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_TEXEL_BUFFER : VK_DESCRIPTOR_TYPE_UNIFORM_TEXEL_BUFFER;
+                        } else {
+                            resource.type = sampled == 2 ? VK_DESCRIPTOR_TYPE_STORAGE_IMAGE : VK_DESCRIPTOR_TYPE_SAMPLED_IMAGE;
+                        }
+                        break;
+                    }
+                    case OpTypeSampler:
+                        resource.type = VK_DESCRIPTOR_TYPE_SAMPLER;
+                        break;
+                    case OpTypeSampledImage:
+                        resource.type = VK_DESCRIPTOR_TYPE_COMBINED_IMAGE_SAMPLER;
+                        break;
+                    case OpTypeAccelerationStructureKHR:
+                        resource.type = VK_DESCRIPTOR_TYPE_ACCELERATION_STRUCTURE_KHR;
+                        break;
+                    default:
+                        continue;
+                }
+                
+                resource.readOnly = decorated->second.nonWritable || allMembers(typeId, &MemberDecorations::nonWritable);
+                resource.writeOnly = decorated->second.nonReadable || allMembers(typeId, &MemberDecorations::nonReadable);
+                auto name = names.find(variable.id);
+                if (name == names.end() || name->second.empty()) {
+                    name = names.find(typeId);
+                }
+                if (name != names.end()) {
+                    resource.name = name->second;
+                }
+                reflection.bindings.push_back(std::move(resource));
+            }
+            
+            std::sort(reflection.bindings.begin(), reflection.bindings.end(),
+                      [](const SpirvResourceBinding& a, const SpirvResourceBinding& b) {
+                          return a.set != b.set ? a.set < b.set : a.binding < b.binding;
+                      });
+        }
+    };
+}
+
+const SpirvResourceBinding* SpirvReflection::findBinding(uint32_t set, uint32_t binding) const {
+    for (const auto& resource : bindings) {
+        if (resource.set == set && resource.binding == binding) {
+            return &resource;
+        }
+    }
+    return nullptr;
+}
+
+uint32_t SpirvReflection::getAccessedBindingMask(uint32_t set) const {
+    uint32_t mask = 0;
+    for (const auto& resource : bindings) {
+        if (resource.set == set && resource.accessed && resource.binding < 32) {
+            mask |= 1u << resource.binding;
+        }
+    }
+    return mask;
+}
+
+bool reflectSpirv(const uint32_t* code, size_t wordCount, SpirvReflection& reflection) {
+    reflection = SpirvReflection{};
+    if (!code) return false;
+    return ModuleParser(code, wordCount).parse(reflection);
+}
+
+bool reconcilePushConstantRanges(std::vector<VkPushConstantRange>& ranges, const SpirvReflection& reflection,
+                                 VkShaderStageFlags stages) {
+    if (reflection.pushConstantSize == 0) {
+        return false;
+    }
+    
+    for (auto& range : ranges) {
+        if ((range.stageFlags & stages) == 0) continue;
+        if (range.offset + range.size >= reflection.pushConstantSize) {
+            return false;
+        }
+        range.size = reflection.pushConstantSize - range.offset;
+        return true;
+    }
+    
+    VkPushConstantRange generated{};
+    generated.stageFlags = stages;
+    generated.offset = 0;
+    generated.size = reflection.pushConstantSize;
+    ranges.push_back(generated);
+    return true;
+}
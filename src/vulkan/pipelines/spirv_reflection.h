@@ -0,0 +1,43 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include <cstddef>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+// Descriptor a SPIR-V module declares, with whether its entry point's code actually touches it
+struct SpirvResourceBinding {
+    uint32_t set = 0;
+    uint32_t binding = 0;
+    VkDescriptorType type = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;  // Uniform buffers are never reported dynamic
+    uint32_t descriptorCount = 1;   // 0 for a runtime array (bindless)
+    bool accessed = false;          // Loaded, stored, indexed or passed on by a function, not only declared
+    bool readOnly = false;          // NonWritable (readonly in GLSL) on the variable or every block member
+    bool writeOnly = false;         // NonReadable, likewise
+    std::string name;               // Variable or block name when the module kept debug names
+};
+
+// Interface of one SPIR-V module: descriptors, the push constant block and the workgroup size. Reflected from the
+// code itself, so layouts and ranges can be derived from what the shader declares instead of restated by hand
+struct SpirvReflection {
+    VkShaderStageFlagBits stage = VK_SHADER_STAGE_COMPUTE_BIT;
+    std::vector<SpirvResourceBinding> bindings;     // Sorted by set, then binding
+    uint32_t pushConstantSize = 0;                  // Bytes up to the end of the last member, 0 without a block
+    bool pushConstantsAccessed = false;
+    uint32_t localSize[3] = {1, 1, 1};              // Literal LocalSize; a specialized size keeps its default
+    bool hasLocalSize = false;
+    
+    const SpirvResourceBinding* findBinding(uint32_t set, uint32_t binding) const;
+    // Bit b set when binding b (< 32) of set is accessed
+    uint32_t getAccessedBindingMask(uint32_t set) const;
+};
+
+// Parses code (a whole module, header included); false when it is not SPIR-V or is truncated
+bool reflectSpirv(const uint32_t* code, size_t wordCount, SpirvReflection& reflection);
+
+// Makes ranges cover reflection's push constant block for stages, widening the declared range of those stages
+// or generating one when none was declared; true when ranges changed
+bool reconcilePushConstantRanges(std::vector<VkPushConstantRange>& ranges, const SpirvReflection& reflection,
+                                 VkShaderStageFlags stages);
@@ -1,35 +1,73 @@
 #include "dependency_graph.h"
+#include <algorithm>
 
 namespace FrameGraphCompilation {
 
 DependencyGraph::GraphData DependencyGraph::buildGraph(const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes) {
     GraphData graph;
     
-    // Build resource producer mapping for O(1) dependency lookups
+    // Node IDs are assigned in insertion order, which defines the intended pass order
+    // when several nodes touch the same resource (e.g. multi-pass spatial grid build)
+    std::vector<FrameGraphTypes::NodeId> insertionOrder;
+    insertionOrder.reserve(nodes.size());
     for (const auto& [nodeId, node] : nodes) {
-        auto outputs = node->getOutputs();
-        for (const auto& output : outputs) {
-            graph.resourceProducers[output.resourceId] = nodeId;
-        }
+        insertionOrder.push_back(nodeId);
     }
+    std::sort(insertionOrder.begin(), insertionOrder.end());
     
     // Initialize adjacency list and in-degrees
-    for (const auto& [nodeId, node] : nodes) {
+    for (FrameGraphTypes::NodeId nodeId : insertionOrder) {
         graph.inDegree[nodeId] = 0;
         graph.adjacencyList[nodeId] = {};
     }
     
-    // Build graph edges: if nodeA produces resource that nodeB consumes, nodeA -> nodeB
-    for (const auto& [nodeId, node] : nodes) {
-        auto inputs = node->getInputs();
+    auto addEdge = [&graph](FrameGraphTypes::NodeId from, FrameGraphTypes::NodeId to) {
+        if (from == to) return;
+        auto& edges = graph.adjacencyList[from];
+        if (std::find(edges.begin(), edges.end(), to) == edges.end()) {
+            edges.push_back(to);
+            graph.inDegree[to]++;
+        }
+    };
+    
+    // Readers of each resource since its last write, for write-after-read ordering
+    std::unordered_map<FrameGraphTypes::ResourceId, std::vector<FrameGraphTypes::NodeId>> readersSinceWrite;
+    
+    // Build graph edges in insertion order:
+    // - read-after-write and write-after-write: previous writer -> node
+    // - write-after-read: earlier readers -> writer
+    // A read with no earlier writer consumes the previous frame's contents and adds no edge,
+    // so edges always point from older to newer nodes.
+    for (FrameGraphTypes::NodeId nodeId : insertionOrder) {
+        const auto& node = nodes.at(nodeId);
+        const auto inputs = node->getDeclaredInputs();
+        const auto outputs = node->getDeclaredOutputs();
+        
         for (const auto& input : inputs) {
             auto producerIt = graph.resourceProducers.find(input.resourceId);
-            if (producerIt != graph.resourceProducers.end() && producerIt->second != nodeId) {
-                FrameGraphTypes::NodeId producerNodeId = producerIt->second;
-                graph.adjacencyList[producerNodeId].push_back(nodeId);
-                graph.inDegree[nodeId]++;
+            if (producerIt != graph.resourceProducers.end()) {
+                addEdge(producerIt->second, nodeId);
             }
         }
+        
+        for (const auto& output : outputs) {
+            auto producerIt = graph.resourceProducers.find(output.resourceId);
+            if (producerIt != graph.resourceProducers.end()) {
+                addEdge(producerIt->second, nodeId);
+            }
+            for (FrameGraphTypes::NodeId readerId : readersSinceWrite[output.resourceId]) {
+                addEdge(readerId, nodeId);
+            }
+        }
+        
+        for (const auto& input : inputs) {
+            readersSinceWrite[input.resourceId].push_back(nodeId);
+        }
+        
+        for (const auto& output : outputs) {
+            graph.resourceProducers[output.resourceId] = nodeId;
+            readersSinceWrite[output.resourceId].clear();
+        }
     }
     
     return graph;
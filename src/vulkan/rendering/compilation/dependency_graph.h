@@ -11,7 +11,7 @@ namespace FrameGraphCompilation {
 class DependencyGraph {
 public:
     struct GraphData {
-        std::unordered_map<FrameGraphTypes::ResourceId, FrameGraphTypes::NodeId> resourceProducers;
+        std::unordered_map<FrameGraphTypes::ResourceId, FrameGraphTypes::NodeId> resourceProducers;  // Latest writer in insertion order
         std::unordered_map<FrameGraphTypes::NodeId, std::vector<FrameGraphTypes::NodeId>> adjacencyList;
         std::unordered_map<FrameGraphTypes::NodeId, int> inDegree;
     };
@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cassert>
 #include <functional>
+#include <span>
 
 namespace FrameGraphCompilation {
 
@@ -76,6 +77,135 @@ PartialCompilationResult FrameGraphCompiler::attemptPartialCompilation(const std
     return result;
 }
 
+void FrameGraphCompiler::assignExecutionLevels(const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes,
+                                               std::vector<FrameGraphTypes::NodeId>& executionOrder,
+                                               std::vector<uint32_t>& levels) {
+    auto graph = DependencyGraph::buildGraph(nodes);
+    
+    // Nodes outside the order (skipped by partial compilation) never raise a level
+    std::unordered_map<FrameGraphTypes::NodeId, uint32_t> nodeLevels;
+    nodeLevels.reserve(executionOrder.size());
+    for (FrameGraphTypes::NodeId nodeId : executionOrder) {
+        nodeLevels.emplace(nodeId, 0);
+    }
+    
+    // Longest path in one pass: the order is topological, so every producer is final before its dependents
+    for (FrameGraphTypes::NodeId nodeId : executionOrder) {
+        auto adjIt = graph.adjacencyList.find(nodeId);
+        if (adjIt == graph.adjacencyList.end()) continue;
+        
+        const uint32_t dependentLevel = nodeLevels[nodeId] + 1;
+        for (FrameGraphTypes::NodeId dependentNode : adjIt->second) {
+            auto levelIt = nodeLevels.find(dependentNode);
+            if (levelIt != nodeLevels.end()) {
+                levelIt->second = std::max(levelIt->second, dependentLevel);
+            }
+        }
+    }
+    
+    std::stable_sort(executionOrder.begin(), executionOrder.end(),
+                     [&nodeLevels](FrameGraphTypes::NodeId a, FrameGraphTypes::NodeId b) {
+                         return nodeLevels.at(a) < nodeLevels.at(b);
+                     });
+    
+    levels.clear();
+    levels.reserve(executionOrder.size());
+    for (FrameGraphTypes::NodeId nodeId : executionOrder) {
+        levels.push_back(nodeLevels.at(nodeId));
+    }
+}
+
+bool FrameGraphCompiler::partitionQueues(const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes,
+                                         const std::vector<FrameGraphTypes::NodeId>& executionOrder,
+                                         QueuePartition& partition) const {
+    partition.clear();
+    partition.streamAt.reserve(executionOrder.size());
+    std::unordered_map<FrameGraphTypes::NodeId, uint32_t> positions;
+    positions.reserve(executionOrder.size());
+    for (uint32_t position = 0; position < executionOrder.size(); ++position) {
+        auto nodeIt = nodes.find(executionOrder[position]);
+        const QueueStream stream = nodeIt != nodes.end() ? streamForAffinity(nodeIt->second->getQueueAffinity())
+                                                          : QueueStream::Graphics;
+        partition.streamAt.push_back(stream);
+        partition.streams[static_cast<uint32_t>(stream)].push_back(position);
+        positions.emplace(executionOrder[position], position);
+    }
+    
+    // Only edges between streams need a semaphore; the resources behind each come from the two nodes'
+    // declarations, a write on at least one side
+    auto graph = DependencyGraph::buildGraph(nodes);
+    for (uint32_t producerPosition = 0; producerPosition < executionOrder.size(); ++producerPosition) {
+        auto adjIt = graph.adjacencyList.find(executionOrder[producerPosition]);
+        if (adjIt == graph.adjacencyList.end()) continue;
+        const FrameGraphNode& producer = *nodes.at(executionOrder[producerPosition]);
+        
+        for (FrameGraphTypes::NodeId consumerId : adjIt->second) {
+            auto positionIt = positions.find(consumerId);
+            if (positionIt == positions.end()) continue;
+            const uint32_t consumerPosition = positionIt->second;
+            const QueueStream producerStream = partition.streamAt[producerPosition];
+            const QueueStream consumerStream = partition.streamAt[consumerPosition];
+            if (producerStream == consumerStream) continue;
+            
+            const FrameGraphNode& consumer = *nodes.at(consumerId);
+            if (static_cast<uint32_t>(producerStream) > static_cast<uint32_t>(consumerStream)) {
+                std::cerr << "FrameGraphCompiler: " << consumer.getName() << " depends on " << producer.getName()
+                          << ", whose queue is submitted after its own" << std::endl;
+                return false;
+            }
+            
+            QueueSyncPoint* syncPoint = nullptr;
+            for (auto& existing : partition.syncPoints) {
+                if (existing.producer == producerStream && existing.consumer == consumerStream) syncPoint = &existing;
+            }
+            if (!syncPoint) {
+                partition.syncPoints.push_back({producerStream, consumerStream, {}});
+                syncPoint = &partition.syncPoints.back();
+            }
+            
+            auto addEdges = [&](std::span<const ResourceDependency> consumerDependencies, bool consumerWrites) {
+                for (const auto& dependency : consumerDependencies) {
+                    auto touches = [&](std::span<const ResourceDependency> producerDependencies) {
+                        return std::any_of(producerDependencies.begin(), producerDependencies.end(),
+                            [&dependency](const ResourceDependency& other) { return other.resourceId == dependency.resourceId; });
+                    };
+                    if (touches(producer.getDeclaredOutputs()) || (consumerWrites && touches(producer.getDeclaredInputs()))) {
+                        syncPoint->edges.push_back({producerPosition, consumerPosition, dependency.resourceId, dependency.stage});
+                    }
+                }
+            };
+            addEdges(consumer.getDeclaredInputs(), false);
+            addEdges(consumer.getDeclaredOutputs(), true);
+        }
+    }
+    
+    return true;
+}
+
+std::unordered_map<FrameGraphTypes::ResourceId, ResourceLifetime> FrameGraphCompiler::computeResourceLifetimes(
+    const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes,
+    const std::vector<FrameGraphTypes::NodeId>& executionOrder) const {
+    std::unordered_map<FrameGraphTypes::ResourceId, ResourceLifetime> lifetimes;
+    
+    for (uint32_t index = 0; index < executionOrder.size(); ++index) {
+        auto nodeIt = nodes.find(executionOrder[index]);
+        if (nodeIt == nodes.end()) continue;
+        
+        const bool compute = nodeIt->second->needsComputeQueue();
+        auto extend = [&](const ResourceDependency& dependency) {
+            ResourceLifetime& lifetime = lifetimes[dependency.resourceId];
+            lifetime.firstUse = std::min(lifetime.firstUse, index);
+            lifetime.lastUse = std::max(lifetime.lastUse, index);
+            lifetime.usedByCompute = lifetime.usedByCompute || compute;
+            lifetime.usedByGraphics = lifetime.usedByGraphics || !compute;
+        };
+        for (const auto& input : nodeIt->second->getDeclaredInputs()) extend(input);
+        for (const auto& output : nodeIt->second->getDeclaredOutputs()) extend(output);
+    }
+    
+    return lifetimes;
+}
+
 void FrameGraphCompiler::backupState(const std::vector<FrameGraphTypes::NodeId>& executionOrder, bool compiled) {
     backupState_.executionOrder = executionOrder;
     backupState_.compiled = compiled;
@@ -269,12 +399,12 @@ std::vector<DependencyPath> FrameGraphCompiler::findCyclePaths(FrameGraphTypes::
                         FrameGraphTypes::NodeId nextNode = path[i + 1];
                         auto nextNodeIt = nodes.find(nextNode);
                         if (nextNodeIt != nodes.end()) {
-                            auto inputs = nextNodeIt->second->getInputs();
+                            const auto inputs = nextNodeIt->second->getDeclaredInputs();
                             for (const auto& input : inputs) {
                                 // Find which resource from current node is consumed by next node
                                 auto currentNodeIt = nodes.find(path[i]);
                                 if (currentNodeIt != nodes.end()) {
-                                    auto outputs = currentNodeIt->second->getOutputs();
+                                    const auto outputs = currentNodeIt->second->getDeclaredOutputs();
                                     for (const auto& output : outputs) {
                                         if (output.resourceId == input.resourceId) {
                                             cycle.resourceChain.push_back(input.resourceId);
@@ -2,12 +2,14 @@
 
 #include "../frame_graph_types.h"
 #include "dependency_graph.h"
+#include <array>
 #include <vector>
 #include <unordered_map>
 #include <unordered_set>
 #include <string>
 #include <functional>
 #include <memory>
+#include <cstdint>
 
 // Forward declarations
 class FrameGraphNode;
@@ -44,6 +46,53 @@ struct CompilationState {
     }
 };
 
+// Streams the frame graph records, in submission order: each is one command buffer on its queue per frame, so a
+// stream can only wait on the streams submitted before it
+enum class QueueStream : uint32_t {
+    Compute,    // AsyncCompute and Transfer nodes
+    Graphics,
+    Count
+};
+constexpr uint32_t QUEUE_STREAM_COUNT = static_cast<uint32_t>(QueueStream::Count);
+
+inline QueueStream streamForAffinity(QueueAffinity affinity) {
+    return affinity == QueueAffinity::Graphics ? QueueStream::Graphics : QueueStream::Compute;
+}
+
+// A dependency between nodes of two streams; positions index the execution order
+struct CrossQueueEdge {
+    uint32_t producerPosition = 0;
+    uint32_t consumerPosition = 0;
+    FrameGraphTypes::ResourceId resourceId = FrameGraphTypes::INVALID_RESOURCE;
+    PipelineStage consumerStage = PipelineStage::ComputeShader;
+};
+
+// Every edge from producer's stream to consumer's, covered by one semaphore: the consumer stream's submission
+// waits on the producer stream's submission of the same frame, at the stages of the edges whose nodes both run
+struct QueueSyncPoint {
+    QueueStream producer = QueueStream::Compute;
+    QueueStream consumer = QueueStream::Graphics;
+    std::vector<CrossQueueEdge> edges;
+};
+
+struct QueuePartition {
+    std::array<std::vector<uint32_t>, QUEUE_STREAM_COUNT> streams;  // Execution order positions per stream
+    std::vector<QueueStream> streamAt;                               // Parallel to the execution order
+    std::vector<QueueSyncPoint> syncPoints;
+    
+    const QueueSyncPoint* find(QueueStream producer, QueueStream consumer) const {
+        for (const auto& syncPoint : syncPoints) {
+            if (syncPoint.producer == producer && syncPoint.consumer == consumer) return &syncPoint;
+        }
+        return nullptr;
+    }
+    void clear() {
+        for (auto& stream : streams) stream.clear();
+        streamAt.clear();
+        syncPoints.clear();
+    }
+};
+
 class FrameGraphCompiler {
 public:
     FrameGraphCompiler() = default;
@@ -61,6 +110,23 @@ public:
     // Fallback compilation
     PartialCompilationResult attemptPartialCompilation(const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes);
 
+    // Execution levels: a node's level is one past its deepest producer, so nodes sharing a level never depend
+    // on each other. Stable-sorts the (topological) order by level and writes levels[i] for executionOrder[i]
+    void assignExecutionLevels(const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes,
+                               std::vector<FrameGraphTypes::NodeId>& executionOrder,
+                               std::vector<uint32_t>& levels);
+
+    // Splits the (levelled) order into per-queue streams by node affinity and collapses the dependencies between
+    // streams into sync points. Fails when a stream would have to wait on one submitted after it
+    bool partitionQueues(const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes,
+                         const std::vector<FrameGraphTypes::NodeId>& executionOrder,
+                         QueuePartition& partition) const;
+
+    // Lifetime of every resource read or written by a node in the order, for transient memory placement
+    std::unordered_map<FrameGraphTypes::ResourceId, ResourceLifetime> computeResourceLifetimes(
+        const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes,
+        const std::vector<FrameGraphTypes::NodeId>& executionOrder) const;
+
     // State management
     void backupState(const std::vector<FrameGraphTypes::NodeId>& executionOrder, bool compiled);
     void restoreState(std::vector<FrameGraphTypes::NodeId>& executionOrder, bool& compiled);
@@ -2,13 +2,21 @@
 #include "../frame_graph_node_base.h"
 #include "../../core/vulkan_context.h"
 #include "../../core/vulkan_function_loader.h"
+#include "../../core/vulkan_constants.h"
 #include "../resources/resource_manager.h"
 #include <algorithm>
+#include <iostream>
 
 namespace FrameGraphExecution {
 
 void BarrierManager::initialize(const VulkanContext* context) {
     context_ = context;
+    synchronization2_ = context && context->supportsSynchronization2();
+}
+
+void BarrierManager::cleanupBeforeContextDestruction() {
+    splitEvents_.clear();
+    resourceStates_.clear();
 }
 
 void BarrierManager::analyzeBarrierRequirements(const std::vector<FrameGraphTypes::NodeId>& executionOrder,
@@ -24,28 +32,165 @@ void BarrierManager::analyzeBarrierRequirements(const std::vector<FrameGraphType
         auto& node = nodeIt->second;
         
         // Track resource writes for dependency analysis
-        auto outputs = node->getOutputs();
-        for (const auto& output : outputs) {
+        for (const auto& output : node->getDeclaredOutputs()) {
             resourceWriteTracking_[output.resourceId] = {nodeId, output.stage, output.access};
         }
     }
 }
 
 void BarrierManager::createOptimalBarrierBatches(const std::vector<FrameGraphTypes::NodeId>& executionOrder,
-                                                  const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes) {
-    barrierBatches_.clear();
+                                                  const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes,
+                                                  const std::vector<uint32_t>& executionLevels) {
+    executionOrder_ = executionOrder;
+    executionLevels_ = executionLevels;
+    nodes_ = &nodes;
+    conditionalSchedules_.clear();
+    activeSchedule_ = &fullSchedule_;
     
-    // Analyze ALL nodes for dependency barriers (compute-to-compute, compute-to-graphics, graphics-to-compute)
-    for (auto nodeId : executionOrder) {
+    buildSchedule(fullSchedule_, {});
+    std::cout << "BarrierManager: " << fullSchedule_.batches.size() << " barrier batches, " << fullSchedule_.splitBarrierCount
+              << " split (" << (synchronization2_ ? "synchronization2" : "legacy barriers") << ")" << std::endl;
+}
+
+void BarrierManager::selectSchedule(const std::vector<bool>& enabled) {
+    activeSchedule_ = &fullSchedule_;
+    if (nodes_ && enabled.size() == executionOrder_.size() &&
+        std::find(enabled.begin(), enabled.end(), false) != enabled.end()) {
+        auto it = conditionalSchedules_.find(enabled);
+        if (it == conditionalSchedules_.end()) {
+            it = conditionalSchedules_.emplace(enabled, BarrierSchedule{}).first;
+            buildSchedule(it->second, enabled);
+        }
+        activeSchedule_ = &it->second;
+    }
+    scheduleCrossFrameBarriers(*activeSchedule_);
+}
+
+void BarrierManager::scheduleCrossFrameBarriers(const BarrierSchedule& schedule) {
+    crossFrameSchedule_.clear();
+    crossFrameRecordingKey_ = 0;
+    
+    for (const auto& use : schedule.firstAccesses) {
+        auto stateIt = resourceStates_.find(use.dependency.resourceId);
+        if (stateIt == resourceStates_.end()) continue;
+        
+        // Earlier frames' work on the other queue is ordered by the timeline semaphores between submissions.
+        // Same-queue work is not when graphics lags compute, so it gets one exact barrier per stage and write
+        ResourceState& state = stateIt->second;
+        const uint32_t stageBit = 1u << static_cast<uint32_t>(use.dependency.stage);
+        if (state.onComputeQueue != use.onComputeQueue) continue;
+        if ((state.visibleStages & stageBit) && use.dependency.access == ResourceAccess::Read) continue;
+        
+        addResourceBarrier(crossFrameSchedule_, use.dependency, use.nodeId, 0, state.stage, state.access);
+        state.visibleStages |= stageBit;
+        if (!use.onComputeQueue) {
+            const uint64_t value = (static_cast<uint64_t>(use.nodeId) << 32) | use.dependency.resourceId;
+            crossFrameRecordingKey_ ^= value + 0x9e3779b97f4a7c15ull + (crossFrameRecordingKey_ << 6) + (crossFrameRecordingKey_ >> 2);
+        }
+    }
+    for (size_t i = 0; i < crossFrameSchedule_.batches.size(); ++i) {
+        crossFrameSchedule_.batchesByTarget[crossFrameSchedule_.batches[i].targetNodeId].push_back(i);
+    }
+    
+    for (const auto& write : schedule.lastWrites) {
+        resourceStates_[write.resourceId] = {write.stage, write.access, write.onComputeQueue, 0};
+    }
+}
+
+void BarrierManager::rebindResources() {
+    auto rebindBatches = [this](std::vector<NodeBarrierInfo>& batches) {
+        for (auto& batch : batches) {
+            for (size_t i = 0; i < batch.bufferBarriers.size() && getBufferResource_; ++i) {
+                if (const FrameGraphResources::FrameGraphBuffer* buffer = getBufferResource_(batch.bufferResourceIds[i])) {
+                    batch.bufferBarriers[i].buffer = buffer->buffer.get();
+                }
+            }
+            for (size_t i = 0; i < batch.imageBarriers.size() && getImageResource_; ++i) {
+                if (const FrameGraphResources::FrameGraphImage* image = getImageResource_(batch.imageResourceIds[i])) {
+                    batch.imageBarriers[i].image = image->image.get();
+                }
+            }
+        }
+    };
+    auto rebind = [&rebindBatches](BarrierSchedule& schedule) {
+        rebindBatches(schedule.batches);
+        rebindBatches(schedule.releases);
+    };
+    
+    rebind(fullSchedule_);
+    rebind(crossFrameSchedule_);
+    for (auto& [enabled, schedule] : conditionalSchedules_) {
+        rebind(schedule);
+    }
+}
+
+void BarrierManager::buildSchedule(BarrierSchedule& schedule, const std::vector<bool>& enabled) {
+    schedule.clear();
+    const auto& executionOrder = executionOrder_;
+    const auto& executionLevels = executionLevels_;
+    const auto& nodes = *nodes_;
+    auto enabledAt = [&](size_t position) {
+        return enabled.empty() || enabled[position];
+    };
+    
+    // Writes recorded by nodes earlier in execution order - a resource written by several
+    // passes must synchronize against the pass that actually precedes the reader
+    std::unordered_map<FrameGraphTypes::ResourceId, ResourceWriteInfo> precedingWrites;
+    std::unordered_map<FrameGraphTypes::NodeId, size_t> positions;
+    
+    // Compute nodes record into the compute queue's buffer, everything else into the graphics queue's
+    std::vector<bool> onComputeQueue(executionOrder.size(), false);
+    for (size_t position = 0; position < executionOrder.size(); ++position) {
+        auto nodeIt = nodes.find(executionOrder[position]);
+        onComputeQueue[position] = nodeIt != nodes.end() && nodeIt->second->needsComputeQueue();
+    }
+    
+    // Barriers are recorded at the start of the consumer's level, so only passes in earlier levels
+    // actually record between the producer and the wait
+    const bool levelsValid = executionLevels.size() == executionOrder.size();
+    auto levelAt = [&](size_t position) {
+        return levelsValid ? executionLevels[position] : static_cast<uint32_t>(position);
+    };
+    auto hasInterveningWork = [&](size_t producer, size_t consumer) {
+        for (size_t position = producer + 1; position < consumer; ++position) {
+            if (enabledAt(position) && onComputeQueue[position] == onComputeQueue[producer] &&
+                levelAt(position) < levelAt(consumer)) {
+                return true;
+            }
+        }
+        return false;
+    };
+    const bool allowSplit = ENABLE_SPLIT_BARRIERS && synchronization2_;
+    
+    // Transients the graphics queue reads from compute change queue family when the two differ; the release
+    // goes after the compute stream's last access, and only the first graphics reader after a write acquires
+    const bool transferOwnership = context_ && context_->getComputeQueueFamily() != context_->getGraphicsQueueFamily();
+    std::unordered_map<FrameGraphTypes::ResourceId, FrameGraphTypes::NodeId> lastComputeAccess;
+    std::unordered_set<FrameGraphTypes::ResourceId> acquiredByGraphics;
+    for (size_t position = 0; transferOwnership && position < executionOrder.size(); ++position) {
+        auto nodeIt = nodes.find(executionOrder[position]);
+        if (nodeIt == nodes.end() || !enabledAt(position) || !onComputeQueue[position]) continue;
+        for (const auto& input : nodeIt->second->getDeclaredInputs()) lastComputeAccess[input.resourceId] = executionOrder[position];
+        for (const auto& output : nodeIt->second->getDeclaredOutputs()) lastComputeAccess[output.resourceId] = executionOrder[position];
+    }
+    
+    // Analyze ALL enabled nodes for dependency barriers (compute-to-compute, compute-to-graphics, graphics-to-compute);
+    // a disabled writer leaves the previous write as the one its readers synchronize against
+    for (size_t position = 0; position < executionOrder.size(); ++position) {
+        const FrameGraphTypes::NodeId nodeId = executionOrder[position];
         auto nodeIt = nodes.find(nodeId);
-        if (nodeIt == nodes.end()) continue;
+        if (nodeIt == nodes.end() || !enabledAt(position)) continue;
         
         auto& node = nodeIt->second;
-        auto inputs = node->getInputs();
+        const auto inputs = node->getDeclaredInputs();
         
         for (const auto& input : inputs) {
-            auto writeIt = resourceWriteTracking_.find(input.resourceId);
-            if (writeIt != resourceWriteTracking_.end()) {
+            if (precedingWrites.find(input.resourceId) == precedingWrites.end()) {
+                schedule.firstAccesses.push_back({nodeId, input, onComputeQueue[position]});
+            }
+            
+            auto writeIt = precedingWrites.find(input.resourceId);
+            if (writeIt != precedingWrites.end()) {
                 auto& writeInfo = writeIt->second;
                 auto writerNodeIt = nodes.find(writeInfo.writerNode);
                 
@@ -70,25 +215,240 @@ void BarrierManager::createOptimalBarrierBatches(const std::vector<FrameGraphTyp
                         needsBarrier = (writeInfo.access != ResourceAccess::Read);
                     }
                     
+                    const size_t writerPosition = positions.at(writeInfo.writerNode);
+                    if (needsBarrier && transferOwnership && onComputeQueue[writerPosition] && !onComputeQueue[position] &&
+                        isTransientResource(input.resourceId)) {
+                        if (acquiredByGraphics.insert(input.resourceId).second) {
+                            addOwnershipTransfer(schedule, input, lastComputeAccess.at(input.resourceId), nodeId,
+                                                 writeInfo.stage, writeInfo.access);
+                            needsBarrier = false;
+                        }
+                    }
+                    
                     if (needsBarrier) {
-                        addResourceBarrier(input.resourceId, nodeId, writeInfo.stage, input.stage, 
-                                         writeInfo.access, input.access);
+                        // Events only order work on one queue; cross-queue pairs stay plain barriers
+                        FrameGraphTypes::NodeId signalNode = 0;
+                        if (allowSplit && onComputeQueue[writerPosition] == onComputeQueue[position] &&
+                            hasInterveningWork(writerPosition, position)) {
+                            signalNode = writeInfo.writerNode;
+                        }
+                        addResourceBarrier(schedule, input, nodeId, signalNode, writeInfo.stage, writeInfo.access);
                     }
                 }
             }
         }
+        
+        for (const auto& output : node->getDeclaredOutputs()) {
+            // A resource the node also reads already has its first access from the inputs
+            const bool alsoRead = std::any_of(inputs.begin(), inputs.end(),
+                [&output](const ResourceDependency& input) { return input.resourceId == output.resourceId; });
+            if (!alsoRead && precedingWrites.find(output.resourceId) == precedingWrites.end()) {
+                schedule.firstAccesses.push_back({nodeId, output, onComputeQueue[position]});
+            }
+            precedingWrites[output.resourceId] = {nodeId, output.stage, output.access};
+            acquiredByGraphics.erase(output.resourceId);
+        }
+        positions[nodeId] = position;
+    }
+    
+    for (const auto& [resourceId, writeInfo] : precedingWrites) {
+        schedule.lastWrites.push_back({resourceId, writeInfo.stage, writeInfo.access, onComputeQueue[positions.at(writeInfo.writerNode)]});
+    }
+    
+    // Schedules share one event pool: each balances its sets and waits within the frame slot it records into
+    for (auto& batch : schedule.batches) {
+        if (batch.signalNodeId != 0) {
+            batch.eventIndex = schedule.splitBarrierCount++;
+        }
+    }
+    
+    // Without events every split degrades to a plain barrier at its consumer
+    if (schedule.splitBarrierCount > 0 && !ensureSplitEvents(schedule.splitBarrierCount)) {
+        for (auto& batch : schedule.batches) {
+            batch.signalNodeId = 0;
+            batch.eventIndex = 0;
+        }
+        schedule.splitBarrierCount = 0;
+    }
+    
+    for (size_t i = 0; i < schedule.releases.size(); ++i) {
+        schedule.releasesByNode[schedule.releases[i].targetNodeId].push_back(i);
+    }
+    for (size_t i = 0; i < schedule.batches.size(); ++i) {
+        schedule.batchesByTarget[schedule.batches[i].targetNodeId].push_back(i);
+        if (schedule.batches[i].signalNodeId != 0) {
+            schedule.batchesBySignal[schedule.batches[i].signalNodeId].push_back(i);
+        }
+    }
+    
+    // The first enabled user of each aliased transient takes over its aliasing barrier
+    std::unordered_set<FrameGraphTypes::ResourceId> pending(aliasedResources_.begin(), aliasedResources_.end());
+    for (size_t position = 0; position < executionOrder.size() && !pending.empty(); ++position) {
+        auto nodeIt = nodes.find(executionOrder[position]);
+        if (nodeIt == nodes.end() || !enabledAt(position)) continue;
+        
+        auto claim = [&](const ResourceDependency& dependency) {
+            if (pending.erase(dependency.resourceId)) {
+                schedule.aliasingBarrierNodes.insert(executionOrder[position]);
+            }
+        };
+        for (const auto& input : nodeIt->second->getDeclaredInputs()) claim(input);
+        for (const auto& output : nodeIt->second->getDeclaredOutputs()) claim(output);
+    }
+}
+
+void BarrierManager::insertBarriersForNodes(const FrameGraphTypes::NodeId* nodeIds, size_t nodeCount,
+                                            VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+    const BarrierSchedule& schedule = *activeSchedule_;
+    if (!context_ || (schedule.batches.empty() && crossFrameSchedule_.batches.empty())) return;
+    
+    pendingBufferBarriers_.clear();
+    pendingImageBarriers_.clear();
+    pendingEvents_.clear();
+    pendingDependencies_.clear();
+    
+    for (size_t i = 0; i < nodeCount; ++i) {
+        auto crossFrameIt = crossFrameSchedule_.batchesByTarget.find(nodeIds[i]);
+        if (crossFrameIt != crossFrameSchedule_.batchesByTarget.end()) {
+            for (size_t batchIndex : crossFrameIt->second) {
+                const NodeBarrierInfo& batch = crossFrameSchedule_.batches[batchIndex];
+                pendingBufferBarriers_.insert(pendingBufferBarriers_.end(), batch.bufferBarriers.begin(), batch.bufferBarriers.end());
+                pendingImageBarriers_.insert(pendingImageBarriers_.end(), batch.imageBarriers.begin(), batch.imageBarriers.end());
+            }
+        }
+        
+        auto it = schedule.batchesByTarget.find(nodeIds[i]);
+        if (it == schedule.batchesByTarget.end()) continue;
+        
+        for (size_t batchIndex : it->second) {
+            const NodeBarrierInfo& batch = schedule.batches[batchIndex];
+            VkEvent event = getSplitEvent(batch, frameIndex);
+            if (event != VK_NULL_HANDLE) {
+                VkDependencyInfoKHR dependencyInfo;
+                fillDependencyInfo(batch, dependencyInfo);
+                pendingEvents_.push_back(event);
+                pendingDependencies_.push_back(dependencyInfo);
+                continue;
+            }
+            pendingBufferBarriers_.insert(pendingBufferBarriers_.end(), batch.bufferBarriers.begin(), batch.bufferBarriers.end());
+            pendingImageBarriers_.insert(pendingImageBarriers_.end(), batch.imageBarriers.begin(), batch.imageBarriers.end());
+        }
+    }
+    
+    const auto& vk = context_->getLoader();
+    if (!pendingEvents_.empty()) {
+        vk.vkCmdWaitEvents2KHR(commandBuffer, static_cast<uint32_t>(pendingEvents_.size()),
+                               pendingEvents_.data(), pendingDependencies_.data());
+        
+        // Unsignaled again before this frame slot records its next set
+        for (size_t i = 0; i < pendingEvents_.size(); ++i) {
+            VkPipelineStageFlags2KHR waitStages = 0;
+            for (uint32_t b = 0; b < pendingDependencies_[i].bufferMemoryBarrierCount; ++b) {
+                waitStages |= pendingDependencies_[i].pBufferMemoryBarriers[b].dstStageMask;
+            }
+            for (uint32_t b = 0; b < pendingDependencies_[i].imageMemoryBarrierCount; ++b) {
+                waitStages |= pendingDependencies_[i].pImageMemoryBarriers[b].dstStageMask;
+            }
+            vk.vkCmdResetEvent2KHR(commandBuffer, pendingEvents_[i], waitStages);
+        }
     }
+    
+    insertPipelineBarrier(commandBuffer, pendingBufferBarriers_, pendingImageBarriers_);
 }
 
-void BarrierManager::insertBarriersForNode(FrameGraphTypes::NodeId nodeId, VkCommandBuffer commandBuffer, 
-                                           bool& computeExecuted, bool nodeNeedsGraphics) {
-    // Insert barriers for ALL transition types, not just compute-to-graphics
-    // Find barriers targeting this node
-    for (const auto& batch : barrierBatches_) {
-        if (batch.targetNodeId == nodeId) {
-            insertBarrierBatch(batch, commandBuffer);
+void BarrierManager::signalAfterNode(FrameGraphTypes::NodeId nodeId, VkCommandBuffer commandBuffer, uint32_t frameIndex) const {
+    const BarrierSchedule& schedule = *activeSchedule_;
+    if (!context_) return;
+    
+    auto releaseIt = schedule.releasesByNode.find(nodeId);
+    if (releaseIt != schedule.releasesByNode.end()) {
+        for (size_t releaseIndex : releaseIt->second) {
+            const NodeBarrierInfo& release = schedule.releases[releaseIndex];
+            insertPipelineBarrier(commandBuffer, release.bufferBarriers, release.imageBarriers);
         }
     }
+    
+    auto it = schedule.batchesBySignal.find(nodeId);
+    if (it == schedule.batchesBySignal.end()) return;
+    
+    for (size_t batchIndex : it->second) {
+        const NodeBarrierInfo& batch = schedule.batches[batchIndex];
+        VkEvent event = getSplitEvent(batch, frameIndex);
+        if (event == VK_NULL_HANDLE) continue;
+        
+        // The wait must pass identical dependency info, so both sides build it from the same batch
+        VkDependencyInfoKHR dependencyInfo;
+        fillDependencyInfo(batch, dependencyInfo);
+        context_->getLoader().vkCmdSetEvent2KHR(commandBuffer, event, &dependencyInfo);
+    }
+}
+
+void BarrierManager::createAliasingBarriers(const std::vector<FrameGraphTypes::NodeId>& executionOrder,
+                                            const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes,
+                                            const std::vector<FrameGraphTypes::ResourceId>& aliasedResources) {
+    // First users depend on which nodes run, so they are resolved per schedule in buildSchedule()
+    aliasedResources_ = aliasedResources;
+}
+
+void BarrierManager::insertAliasingBarrier(FrameGraphTypes::NodeId nodeId, VkCommandBuffer commandBuffer) const {
+    if (!context_ || activeSchedule_->aliasingBarrierNodes.find(nodeId) == activeSchedule_->aliasingBarrierNodes.end()) {
+        return;
+    }
+    
+    // Full memory dependency: the previous occupant may have been any stage reading or writing the range
+    insertMemoryBarrier(commandBuffer,
+                        VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR, VK_ACCESS_2_MEMORY_WRITE_BIT_KHR,
+                        VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR, VK_ACCESS_2_MEMORY_READ_BIT_KHR | VK_ACCESS_2_MEMORY_WRITE_BIT_KHR);
+}
+
+void BarrierManager::insertMemoryBarrier(VkCommandBuffer commandBuffer,
+                                         VkPipelineStageFlags2KHR srcStage, VkAccessFlags2KHR srcAccess,
+                                         VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR dstAccess) const {
+    if (!context_) return;
+    const auto& vk = context_->getLoader();
+    
+    if (synchronization2_) {
+        VkMemoryBarrier2KHR memoryBarrier{};
+        memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR;
+        memoryBarrier.srcStageMask = srcStage;
+        memoryBarrier.srcAccessMask = srcAccess;
+        memoryBarrier.dstStageMask = dstStage;
+        memoryBarrier.dstAccessMask = dstAccess;
+        
+        VkDependencyInfoKHR dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+        dependencyInfo.memoryBarrierCount = 1;
+        dependencyInfo.pMemoryBarriers = &memoryBarrier;
+        vk.vkCmdPipelineBarrier2KHR(commandBuffer, &dependencyInfo);
+        return;
+    }
+    
+    VkMemoryBarrier memoryBarrier{};
+    memoryBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER;
+    memoryBarrier.srcAccessMask = static_cast<VkAccessFlags>(srcAccess);
+    memoryBarrier.dstAccessMask = static_cast<VkAccessFlags>(dstAccess);
+    
+    // Legacy barriers need non-empty stage masks (an execution-only dependency may pass zero access)
+    vk.vkCmdPipelineBarrier(
+        commandBuffer,
+        srcStage ? static_cast<VkPipelineStageFlags>(srcStage) : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        dstStage ? static_cast<VkPipelineStageFlags>(dstStage) : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0, (srcAccess | dstAccess) ? 1 : 0, &memoryBarrier, 0, nullptr, 0, nullptr);
+}
+
+void BarrierManager::insertBufferBarriers(VkCommandBuffer commandBuffer, const VkBufferMemoryBarrier2KHR* barriers, uint32_t count) const {
+    if (!context_ || count == 0) return;
+    
+    if (synchronization2_) {
+        VkDependencyInfoKHR dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+        dependencyInfo.bufferMemoryBarrierCount = count;
+        dependencyInfo.pBufferMemoryBarriers = barriers;
+        context_->getLoader().vkCmdPipelineBarrier2KHR(commandBuffer, &dependencyInfo);
+        return;
+    }
+    
+    insertPipelineBarrier(commandBuffer, std::vector<VkBufferMemoryBarrier2KHR>(barriers, barriers + count), {});
 }
 
 void BarrierManager::setResourceAccessors(std::function<const FrameGraphResources::FrameGraphBuffer*(FrameGraphTypes::ResourceId)> getBuffer,
@@ -98,48 +458,59 @@ void BarrierManager::setResourceAccessors(std::function<const FrameGraphResource
 }
 
 void BarrierManager::reset() {
-    barrierBatches_.clear();
+    fullSchedule_.clear();
+    conditionalSchedules_.clear();
+    activeSchedule_ = &fullSchedule_;
+    crossFrameSchedule_.clear();
+    crossFrameRecordingKey_ = 0;
     resourceWriteTracking_.clear();
+    aliasedResources_.clear();
 }
 
-void BarrierManager::addResourceBarrier(FrameGraphTypes::ResourceId resourceId, FrameGraphTypes::NodeId targetNode,
-                                       PipelineStage srcStage, PipelineStage dstStage,
-                                       ResourceAccess srcAccess, ResourceAccess dstAccess) {
+void BarrierManager::addResourceBarrier(BarrierSchedule& schedule, const ResourceDependency& dependency, FrameGraphTypes::NodeId targetNode,
+                                       FrameGraphTypes::NodeId signalNode, PipelineStage srcStage, ResourceAccess srcAccess) {
     
-    // Find or create barrier batch for this target node
-    auto batchIt = std::find_if(barrierBatches_.begin(), barrierBatches_.end(),
-        [targetNode](const NodeBarrierInfo& batch) { return batch.targetNodeId == targetNode; });
+    // Find or create barrier batch for this target node (split barriers batch per producer as well)
+    auto batchIt = std::find_if(schedule.batches.begin(), schedule.batches.end(),
+        [targetNode, signalNode](const NodeBarrierInfo& batch) {
+            return batch.targetNodeId == targetNode && batch.signalNodeId == signalNode;
+        });
     
-    if (batchIt == barrierBatches_.end()) {
-        barrierBatches_.emplace_back();
-        batchIt = barrierBatches_.end() - 1;
+    if (batchIt == schedule.batches.end()) {
+        schedule.batches.emplace_back();
+        batchIt = schedule.batches.end() - 1;
         batchIt->targetNodeId = targetNode;
-        batchIt->srcStage = convertPipelineStage(srcStage);
-        batchIt->dstStage = convertPipelineStage(dstStage);
-    } else {
-        // Update stage flags to include all stages in this batch
-        batchIt->srcStage |= convertPipelineStage(srcStage);
-        batchIt->dstStage |= convertPipelineStage(dstStage);
+        batchIt->signalNodeId = signalNode;
     }
     
+    const VkPipelineStageFlags2KHR srcStageMask = convertPipelineStage(srcStage);
+    const VkPipelineStageFlags2KHR dstStageMask = convertPipelineStage(dependency.stage);
+    const VkAccessFlags2KHR srcAccessMask = convertAccess(srcAccess, srcStage);
+    const VkAccessFlags2KHR dstAccessMask = convertAccess(dependency.access, dependency.stage);
+    
     // Add resource barrier to the batch with deduplication within the same batch
     if (getBufferResource_) {
-        const FrameGraphResources::FrameGraphBuffer* buffer = getBufferResource_(resourceId);
+        const FrameGraphResources::FrameGraphBuffer* buffer = getBufferResource_(dependency.resourceId);
         if (buffer) {
-            VkBufferMemoryBarrier barrier{};
-            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
-            barrier.srcAccessMask = convertAccess(srcAccess, srcStage);
-            barrier.dstAccessMask = convertAccess(dstAccess, dstStage);
+            // Scoped to the range the consumer declared (the whole buffer unless it names one)
+            VkBufferMemoryBarrier2KHR barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+            barrier.srcStageMask = srcStageMask;
+            barrier.srcAccessMask = srcAccessMask;
+            barrier.dstStageMask = dstStageMask;
+            barrier.dstAccessMask = dstAccessMask;
             barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
             barrier.buffer = buffer->buffer.get();
-            barrier.offset = 0;
-            barrier.size = VK_WHOLE_SIZE;
+            barrier.offset = dependency.offset;
+            barrier.size = dependency.size;
             
             // Check for duplicate barriers within the same batch
             bool isDuplicate = false;
             for (const auto& existing : batchIt->bufferBarriers) {
                 if (existing.buffer == barrier.buffer &&
+                    existing.srcStageMask == barrier.srcStageMask &&
+                    existing.dstStageMask == barrier.dstStageMask &&
                     existing.srcAccessMask == barrier.srcAccessMask &&
                     existing.dstAccessMask == barrier.dstAccessMask &&
                     existing.offset == barrier.offset &&
@@ -151,18 +522,21 @@ void BarrierManager::addResourceBarrier(FrameGraphTypes::ResourceId resourceId,
             
             if (!isDuplicate) {
                 batchIt->bufferBarriers.push_back(barrier);
+                batchIt->bufferResourceIds.push_back(dependency.resourceId);
             }
             return;
         }
     }
     
     if (getImageResource_) {
-        const FrameGraphResources::FrameGraphImage* image = getImageResource_(resourceId);
+        const FrameGraphResources::FrameGraphImage* image = getImageResource_(dependency.resourceId);
         if (image) {
-            VkImageMemoryBarrier barrier{};
-            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
-            barrier.srcAccessMask = convertAccess(srcAccess, srcStage);
-            barrier.dstAccessMask = convertAccess(dstAccess, dstStage);
+            VkImageMemoryBarrier2KHR barrier{};
+            barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+            barrier.srcStageMask = srcStageMask;
+            barrier.srcAccessMask = srcAccessMask;
+            barrier.dstStageMask = dstStageMask;
+            barrier.dstAccessMask = dstAccessMask;
             barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
             barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
             barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
@@ -178,6 +552,8 @@ void BarrierManager::addResourceBarrier(FrameGraphTypes::ResourceId resourceId,
             bool isDuplicate = false;
             for (const auto& existing : batchIt->imageBarriers) {
                 if (existing.image == barrier.image &&
+                    existing.srcStageMask == barrier.srcStageMask &&
+                    existing.dstStageMask == barrier.dstStageMask &&
                     existing.srcAccessMask == barrier.srcAccessMask &&
                     existing.dstAccessMask == barrier.dstAccessMask &&
                     existing.oldLayout == barrier.oldLayout &&
@@ -192,11 +568,85 @@ void BarrierManager::addResourceBarrier(FrameGraphTypes::ResourceId resourceId,
             
             if (!isDuplicate) {
                 batchIt->imageBarriers.push_back(barrier);
+                batchIt->imageResourceIds.push_back(dependency.resourceId);
             }
         }
     }
 }
 
+void BarrierManager::addOwnershipTransfer(BarrierSchedule& schedule, const ResourceDependency& dependency, FrameGraphTypes::NodeId releaseNode,
+                                          FrameGraphTypes::NodeId acquireNode, PipelineStage srcStage, ResourceAccess srcAccess) {
+    auto batchFor = [](std::vector<NodeBarrierInfo>& batches, FrameGraphTypes::NodeId node) -> NodeBarrierInfo& {
+        auto it = std::find_if(batches.begin(), batches.end(), [node](const NodeBarrierInfo& batch) {
+            return batch.targetNodeId == node && batch.signalNodeId == 0;
+        });
+        if (it != batches.end()) return *it;
+        batches.emplace_back();
+        batches.back().targetNodeId = node;
+        return batches.back();
+    };
+    NodeBarrierInfo& release = batchFor(schedule.releases, releaseNode);
+    NodeBarrierInfo& acquire = batchFor(schedule.batches, acquireNode);
+    
+    // Both halves name the same families, range and layouts; the release carries the source scope, the
+    // acquire the destination, and the frame's compute-to-graphics semaphore orders them
+    const uint32_t computeFamily = context_->getComputeQueueFamily();
+    const uint32_t graphicsFamily = context_->getGraphicsQueueFamily();
+    if (const FrameGraphResources::FrameGraphBuffer* buffer = getBufferResource_ ? getBufferResource_(dependency.resourceId) : nullptr) {
+        VkBufferMemoryBarrier2KHR barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER_2_KHR;
+        barrier.srcQueueFamilyIndex = computeFamily;
+        barrier.dstQueueFamilyIndex = graphicsFamily;
+        barrier.buffer = buffer->buffer.get();
+        barrier.offset = dependency.offset;
+        barrier.size = dependency.size;
+        
+        VkBufferMemoryBarrier2KHR releaseBarrier = barrier;
+        releaseBarrier.srcStageMask = convertPipelineStage(srcStage);
+        releaseBarrier.srcAccessMask = convertAccess(srcAccess, srcStage);
+        release.bufferBarriers.push_back(releaseBarrier);
+        release.bufferResourceIds.push_back(dependency.resourceId);
+        
+        barrier.dstStageMask = convertPipelineStage(dependency.stage);
+        barrier.dstAccessMask = convertAccess(dependency.access, dependency.stage);
+        acquire.bufferBarriers.push_back(barrier);
+        acquire.bufferResourceIds.push_back(dependency.resourceId);
+        return;
+    }
+    
+    if (const FrameGraphResources::FrameGraphImage* image = getImageResource_ ? getImageResource_(dependency.resourceId) : nullptr) {
+        VkImageMemoryBarrier2KHR barrier{};
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+        barrier.oldLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.newLayout = VK_IMAGE_LAYOUT_GENERAL;
+        barrier.srcQueueFamilyIndex = computeFamily;
+        barrier.dstQueueFamilyIndex = graphicsFamily;
+        barrier.image = image->image.get();
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        
+        VkImageMemoryBarrier2KHR releaseBarrier = barrier;
+        releaseBarrier.srcStageMask = convertPipelineStage(srcStage);
+        releaseBarrier.srcAccessMask = convertAccess(srcAccess, srcStage);
+        release.imageBarriers.push_back(releaseBarrier);
+        release.imageResourceIds.push_back(dependency.resourceId);
+        
+        barrier.dstStageMask = convertPipelineStage(dependency.stage);
+        barrier.dstAccessMask = convertAccess(dependency.access, dependency.stage);
+        acquire.imageBarriers.push_back(barrier);
+        acquire.imageResourceIds.push_back(dependency.resourceId);
+    }
+}
+
+bool BarrierManager::isTransientResource(FrameGraphTypes::ResourceId resourceId) const {
+    if (const FrameGraphResources::FrameGraphBuffer* buffer = getBufferResource_ ? getBufferResource_(resourceId) : nullptr) {
+        return buffer->isTransient;
+    }
+    if (const FrameGraphResources::FrameGraphImage* image = getImageResource_ ? getImageResource_(resourceId) : nullptr) {
+        return image->isTransient;
+    }
+    return false;
+}
+
 FrameGraphTypes::NodeId BarrierManager::findNextGraphicsNode(FrameGraphTypes::NodeId fromNode,
                                                               const std::vector<FrameGraphTypes::NodeId>& executionOrder,
                                                               const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes) const {
@@ -212,56 +662,147 @@ FrameGraphTypes::NodeId BarrierManager::findNextGraphicsNode(FrameGraphTypes::No
     return 0;
 }
 
-void BarrierManager::insertBarrierBatch(const NodeBarrierInfo& batch, VkCommandBuffer commandBuffer) {
-    if (batch.bufferBarriers.empty() && batch.imageBarriers.empty()) return;
+bool BarrierManager::ensureSplitEvents(uint32_t eventCount) {
+    if (!context_) return false;
     
     const auto& vk = context_->getLoader();
+    splitEvents_.resize(context_->getFramesInFlight());
+    for (auto& frameEvents : splitEvents_) {
+        while (frameEvents.size() < eventCount) {
+            // Set and waited on only from command buffers, which lets the driver keep it in device memory
+            VkEventCreateInfo eventInfo{};
+            eventInfo.sType = VK_STRUCTURE_TYPE_EVENT_CREATE_INFO;
+            eventInfo.flags = VK_EVENT_CREATE_DEVICE_ONLY_BIT_KHR;
+            
+            VkEvent event = VK_NULL_HANDLE;
+            if (vk.vkCreateEvent(context_->getDevice(), &eventInfo, nullptr, &event) != VK_SUCCESS) {
+                std::cerr << "BarrierManager: Failed to create split barrier event, using plain barriers" << std::endl;
+                return false;
+            }
+            frameEvents.push_back(vulkan_raii::make_event(event, context_));
+        }
+    }
+    return true;
+}
+
+VkEvent BarrierManager::getSplitEvent(const NodeBarrierInfo& batch, uint32_t frameIndex) const {
+    if (batch.signalNodeId == 0 || frameIndex >= splitEvents_.size() ||
+        batch.eventIndex >= splitEvents_[frameIndex].size()) {
+        return VK_NULL_HANDLE;
+    }
+    return splitEvents_[frameIndex][batch.eventIndex].get();
+}
+
+void BarrierManager::fillDependencyInfo(const NodeBarrierInfo& batch, VkDependencyInfoKHR& dependencyInfo) const {
+    dependencyInfo = {};
+    dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+    dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(batch.bufferBarriers.size());
+    dependencyInfo.pBufferMemoryBarriers = batch.bufferBarriers.data();
+    dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(batch.imageBarriers.size());
+    dependencyInfo.pImageMemoryBarriers = batch.imageBarriers.data();
+}
+
+void BarrierManager::insertPipelineBarrier(VkCommandBuffer commandBuffer,
+                                           const std::vector<VkBufferMemoryBarrier2KHR>& bufferBarriers,
+                                           const std::vector<VkImageMemoryBarrier2KHR>& imageBarriers) const {
+    if (bufferBarriers.empty() && imageBarriers.empty()) return;
+    
+    const auto& vk = context_->getLoader();
+    
+    if (synchronization2_) {
+        VkDependencyInfoKHR dependencyInfo{};
+        dependencyInfo.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+        dependencyInfo.bufferMemoryBarrierCount = static_cast<uint32_t>(bufferBarriers.size());
+        dependencyInfo.pBufferMemoryBarriers = bufferBarriers.data();
+        dependencyInfo.imageMemoryBarrierCount = static_cast<uint32_t>(imageBarriers.size());
+        dependencyInfo.pImageMemoryBarriers = imageBarriers.data();
+        vk.vkCmdPipelineBarrier2KHR(commandBuffer, &dependencyInfo);
+        return;
+    }
+    
+    // Legacy barriers share one stage pair, so the batch synchronizes on the union of its stages
+    VkPipelineStageFlags srcStage = 0;
+    VkPipelineStageFlags dstStage = 0;
+    std::vector<VkBufferMemoryBarrier> legacyBufferBarriers;
+    legacyBufferBarriers.reserve(bufferBarriers.size());
+    for (const auto& barrier : bufferBarriers) {
+        VkBufferMemoryBarrier legacy{};
+        legacy.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+        legacy.srcAccessMask = static_cast<VkAccessFlags>(barrier.srcAccessMask);
+        legacy.dstAccessMask = static_cast<VkAccessFlags>(barrier.dstAccessMask);
+        legacy.srcQueueFamilyIndex = barrier.srcQueueFamilyIndex;
+        legacy.dstQueueFamilyIndex = barrier.dstQueueFamilyIndex;
+        legacy.buffer = barrier.buffer;
+        legacy.offset = barrier.offset;
+        legacy.size = barrier.size;
+        legacyBufferBarriers.push_back(legacy);
+        srcStage |= static_cast<VkPipelineStageFlags>(barrier.srcStageMask);
+        dstStage |= static_cast<VkPipelineStageFlags>(barrier.dstStageMask);
+    }
+    
+    std::vector<VkImageMemoryBarrier> legacyImageBarriers;
+    legacyImageBarriers.reserve(imageBarriers.size());
+    for (const auto& barrier : imageBarriers) {
+        VkImageMemoryBarrier legacy{};
+        legacy.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        legacy.srcAccessMask = static_cast<VkAccessFlags>(barrier.srcAccessMask);
+        legacy.dstAccessMask = static_cast<VkAccessFlags>(barrier.dstAccessMask);
+        legacy.oldLayout = barrier.oldLayout;
+        legacy.newLayout = barrier.newLayout;
+        legacy.srcQueueFamilyIndex = barrier.srcQueueFamilyIndex;
+        legacy.dstQueueFamilyIndex = barrier.dstQueueFamilyIndex;
+        legacy.image = barrier.image;
+        legacy.subresourceRange = barrier.subresourceRange;
+        legacyImageBarriers.push_back(legacy);
+        srcStage |= static_cast<VkPipelineStageFlags>(barrier.srcStageMask);
+        dstStage |= static_cast<VkPipelineStageFlags>(barrier.dstStageMask);
+    }
     
     vk.vkCmdPipelineBarrier(
         commandBuffer,
-        batch.srcStage,
-        batch.dstStage,
+        srcStage ? srcStage : VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+        dstStage ? dstStage : VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
         0, // dependencyFlags
         0, nullptr, // memory barriers
-        static_cast<uint32_t>(batch.bufferBarriers.size()), 
-        batch.bufferBarriers.data(),
-        static_cast<uint32_t>(batch.imageBarriers.size()), 
-        batch.imageBarriers.data()
+        static_cast<uint32_t>(legacyBufferBarriers.size()), 
+        legacyBufferBarriers.data(),
+        static_cast<uint32_t>(legacyImageBarriers.size()), 
+        legacyImageBarriers.data()
     );
 }
 
-VkAccessFlags BarrierManager::convertAccess(ResourceAccess access, PipelineStage stage) const {
+VkAccessFlags2KHR BarrierManager::convertAccess(ResourceAccess access, PipelineStage stage) const {
     switch (access) {
         case ResourceAccess::Read: 
             if (stage == PipelineStage::VertexShader) {
-                return VK_ACCESS_VERTEX_ATTRIBUTE_READ_BIT | VK_ACCESS_SHADER_READ_BIT;
+                return VK_ACCESS_2_VERTEX_ATTRIBUTE_READ_BIT_KHR | VK_ACCESS_2_SHADER_READ_BIT_KHR;
             }
-            return VK_ACCESS_SHADER_READ_BIT;
+            return VK_ACCESS_2_SHADER_READ_BIT_KHR;
         case ResourceAccess::Write: 
-            return VK_ACCESS_SHADER_WRITE_BIT;
+            return VK_ACCESS_2_SHADER_WRITE_BIT_KHR;
         case ResourceAccess::ReadWrite: 
-            return VK_ACCESS_SHADER_READ_BIT | VK_ACCESS_SHADER_WRITE_BIT;
+            return VK_ACCESS_2_SHADER_READ_BIT_KHR | VK_ACCESS_2_SHADER_WRITE_BIT_KHR;
         default: 
             return 0;
     }
 }
 
-VkPipelineStageFlags BarrierManager::convertPipelineStage(PipelineStage stage) const {
+VkPipelineStageFlags2KHR BarrierManager::convertPipelineStage(PipelineStage stage) const {
     switch (stage) {
         case PipelineStage::ComputeShader:
-            return VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
+            return VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR;
         case PipelineStage::VertexShader:
-            return VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
+            return VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_INPUT_BIT_KHR;
         case PipelineStage::FragmentShader:
-            return VK_PIPELINE_STAGE_FRAGMENT_SHADER_BIT;
+            return VK_PIPELINE_STAGE_2_FRAGMENT_SHADER_BIT_KHR;
         case PipelineStage::ColorAttachment:
-            return VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT;
+            return VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR;
         case PipelineStage::DepthAttachment:
-            return VK_PIPELINE_STAGE_EARLY_FRAGMENT_TESTS_BIT | VK_PIPELINE_STAGE_LATE_FRAGMENT_TESTS_BIT;
+            return VK_PIPELINE_STAGE_2_EARLY_FRAGMENT_TESTS_BIT_KHR | VK_PIPELINE_STAGE_2_LATE_FRAGMENT_TESTS_BIT_KHR;
         case PipelineStage::Transfer:
-            return VK_PIPELINE_STAGE_TRANSFER_BIT;
+            return VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR;
         default:
-            return VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT;
+            return VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT_KHR;
     }
 }
 
@@ -3,8 +3,10 @@
 #define VK_NO_PROTOTYPES
 #include <vulkan/vulkan.h>
 #include "../frame_graph_types.h"
+#include "../../core/vulkan_raii.h"
 #include <vector>
 #include <unordered_map>
+#include <unordered_set>
 #include <memory>
 #include <functional>
 
@@ -20,18 +22,75 @@ namespace FrameGraphResources {
 
 namespace FrameGraphExecution {
 
-// Per-node barrier tracking for optimal async execution
+// Per-node barrier batch in synchronization2 form (stages live on each barrier); lowered to
+// vkCmdPipelineBarrier when the extension is unavailable
 struct NodeBarrierInfo {
-    std::vector<VkBufferMemoryBarrier> bufferBarriers;
-    std::vector<VkImageMemoryBarrier> imageBarriers;
-    VkPipelineStageFlags srcStage = VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT;
-    VkPipelineStageFlags dstStage = VK_PIPELINE_STAGE_VERTEX_SHADER_BIT | VK_PIPELINE_STAGE_VERTEX_INPUT_BIT;
-    FrameGraphTypes::NodeId targetNodeId = 0;
+    std::vector<VkBufferMemoryBarrier2KHR> bufferBarriers;
+    std::vector<VkImageMemoryBarrier2KHR> imageBarriers;
     
+    // Parallel to the barrier vectors, so rebindResources() can patch handles without re-analysis
+    std::vector<FrameGraphTypes::ResourceId> bufferResourceIds;
+    std::vector<FrameGraphTypes::ResourceId> imageResourceIds;
+    FrameGraphTypes::NodeId targetNodeId = 0;
+
+    // Split barrier: the event is set right after signalNodeId and waited on before targetNodeId,
+    // letting the passes recorded in between overlap the producer (0 = plain barrier at the target)
+    FrameGraphTypes::NodeId signalNodeId = 0;
+    uint32_t eventIndex = 0;
+
     void clear() {
         bufferBarriers.clear();
         imageBarriers.clear();
+        bufferResourceIds.clear();
+        imageResourceIds.clear();
         targetNodeId = 0;
+        signalNodeId = 0;
+        eventIndex = 0;
+    }
+};
+
+// A node accessing a resource before anything writes it in the frame - the access an earlier frame's write
+// may still need to be synchronized with
+struct CrossFrameAccess {
+    FrameGraphTypes::NodeId nodeId = 0;
+    ResourceDependency dependency{};
+    bool onComputeQueue = false;
+};
+
+struct CrossFrameWrite {
+    FrameGraphTypes::ResourceId resourceId = 0;
+    PipelineStage stage = PipelineStage::ComputeShader;
+    ResourceAccess access = ResourceAccess::Write;
+    bool onComputeQueue = false;
+};
+
+// Barrier batches for one set of enabled nodes; built once per set, then selected per frame
+struct BarrierSchedule {
+    std::vector<NodeBarrierInfo> batches;
+    std::unordered_map<FrameGraphTypes::NodeId, std::vector<size_t>> batchesByTarget;
+    std::unordered_map<FrameGraphTypes::NodeId, std::vector<size_t>> batchesBySignal;
+    std::unordered_set<FrameGraphTypes::NodeId> aliasingBarrierNodes;  // First users of aliased transients
+    uint32_t splitBarrierCount = 0;
+    
+    // Queue family releases, recorded right after their target node; each pairs with an acquire batched at the
+    // other queue's first reader
+    std::vector<NodeBarrierInfo> releases;
+    std::unordered_map<FrameGraphTypes::NodeId, std::vector<size_t>> releasesByNode;
+    
+    // What the schedule hands over between frames: its first accesses and every resource's last write
+    std::vector<CrossFrameAccess> firstAccesses;
+    std::vector<CrossFrameWrite> lastWrites;
+    
+    void clear() {
+        batches.clear();
+        batchesByTarget.clear();
+        batchesBySignal.clear();
+        aliasingBarrierNodes.clear();
+        splitBarrierCount = 0;
+        releases.clear();
+        releasesByNode.clear();
+        firstAccesses.clear();
+        lastWrites.clear();
     }
 };
 
@@ -46,20 +105,71 @@ class BarrierManager {
 public:
     BarrierManager() = default;
     ~BarrierManager() = default;
+    
+    // activeSchedule_ points into this object
+    BarrierManager(const BarrierManager&) = delete;
+    BarrierManager& operator=(const BarrierManager&) = delete;
 
     // Initialize with context for barrier operations
     void initialize(const VulkanContext* context);
+    void cleanupBeforeContextDestruction();
 
     // Main barrier analysis interface
     void analyzeBarrierRequirements(const std::vector<FrameGraphTypes::NodeId>& executionOrder,
                                     const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes);
 
+    // executionLevels parallels executionOrder; a dependency becomes a split barrier when a pass on the same
+    // queue records between the producer and the start of the consumer's level
     void createOptimalBarrierBatches(const std::vector<FrameGraphTypes::NodeId>& executionOrder,
-                                     const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes);
+                                     const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes,
+                                     const std::vector<uint32_t>& executionLevels);
+    
+    // Per-frame node predicates: enabled parallels the compiled execution order. Disabled nodes neither wait
+    // nor signal, and consumers synchronize against the last enabled writer instead; the schedule for each
+    // distinct set is built on first use and kept until the next compile. Call once before recording each
+    // frame: it also resolves the frame's cross-frame barriers and hands its last writes on to the next one
+    void selectSchedule(const std::vector<bool>& enabled);
+    
+    // The schedule with every node enabled, as analyzed at compile (FrameGraph::captureSchedule)
+    const BarrierSchedule& getFullSchedule() const { return fullSchedule_; }
+    
+    // Identifies this frame's cross-frame barriers into graphics nodes, which graphics recordings bake in
+    uint64_t getCrossFrameRecordingKey() const { return crossFrameRecordingKey_; }
+    
+    // Re-resolves the buffer and image handle of every barrier in every schedule through the resource
+    // accessors; keeps the schedules valid across external resource rebinds without rebuilding them
+    void rebindResources();
+
+    // Execution time barrier insertion: every barrier and event wait targeting the given nodes goes out as
+    // one vkCmdPipelineBarrier2 and one vkCmdWaitEvents2, recorded before the first of them executes
+    void insertBarriersForNodes(const FrameGraphTypes::NodeId* nodeIds, size_t nodeCount,
+                                VkCommandBuffer commandBuffer, uint32_t frameIndex);
+    void insertBarriersForNode(FrameGraphTypes::NodeId nodeId, VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+        insertBarriersForNodes(&nodeId, 1, commandBuffer, frameIndex);
+    }
 
-    // Execution time barrier insertion
-    void insertBarriersForNode(FrameGraphTypes::NodeId nodeId, VkCommandBuffer graphicsCmd, 
-                               bool& computeExecuted, bool nodeNeedsGraphics);
+    // Sets the events of split barriers produced by nodeId and records the queue family releases after its
+    // access; recorded right after it executes. Const and stateless, so recording lanes call it from their own threads.
+    void signalAfterNode(FrameGraphTypes::NodeId nodeId, VkCommandBuffer commandBuffer, uint32_t frameIndex) const;
+
+    // Aliasing barriers: the first enabled node touching a transient that shares heap memory waits for all
+    // earlier work on its queue, which covers the range's previous occupant from this frame or the one before.
+    // Call before createOptimalBarrierBatches, which places them in every schedule it builds
+    void createAliasingBarriers(const std::vector<FrameGraphTypes::NodeId>& executionOrder,
+                                const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes,
+                                const std::vector<FrameGraphTypes::ResourceId>& aliasedResources);
+    void insertAliasingBarrier(FrameGraphTypes::NodeId nodeId, VkCommandBuffer commandBuffer) const;
+
+    // Node-internal barriers (between dispatches of one pass, or on buffers outside the frame graph) go
+    // through these so every barrier shares one emission path; stateless and safe from recording lanes.
+    // Masks must stay within the legacy bits, which are identical in both forms.
+    void insertMemoryBarrier(VkCommandBuffer commandBuffer,
+                             VkPipelineStageFlags2KHR srcStage, VkAccessFlags2KHR srcAccess,
+                             VkPipelineStageFlags2KHR dstStage, VkAccessFlags2KHR dstAccess) const;
+    void insertBufferBarriers(VkCommandBuffer commandBuffer, const VkBufferMemoryBarrier2KHR* barriers, uint32_t count) const;
+
+    // Stage mask of a declared PipelineStage, also used for the graph's cross-queue semaphore waits
+    VkPipelineStageFlags2KHR convertPipelineStage(PipelineStage stage) const;
 
     // Resource access helpers
     void setResourceAccessors(std::function<const FrameGraphResources::FrameGraphBuffer*(FrameGraphTypes::ResourceId)> getBuffer,
@@ -69,29 +179,77 @@ public:
     void reset();
 
 private:
-    // Core barrier analysis
-    void addResourceBarrier(FrameGraphTypes::ResourceId resourceId, FrameGraphTypes::NodeId targetNode,
-                           PipelineStage srcStage, PipelineStage dstStage,
-                           ResourceAccess srcAccess, ResourceAccess dstAccess);
+    // Core barrier analysis; an empty enabled vector means every node runs
+    void buildSchedule(BarrierSchedule& schedule, const std::vector<bool>& enabled);
+    void scheduleCrossFrameBarriers(const BarrierSchedule& schedule);
+    void addResourceBarrier(BarrierSchedule& schedule, const ResourceDependency& dependency, FrameGraphTypes::NodeId targetNode,
+                           FrameGraphTypes::NodeId signalNode, PipelineStage srcStage, ResourceAccess srcAccess);
+    
+    // Compute-to-graphics handoff of a transient between queue families: released after releaseNode (the compute
+    // stream's last access), acquired before acquireNode. Transients start each frame undefined, so nothing
+    // returns them to the compute family
+    void addOwnershipTransfer(BarrierSchedule& schedule, const ResourceDependency& dependency, FrameGraphTypes::NodeId releaseNode,
+                              FrameGraphTypes::NodeId acquireNode, PipelineStage srcStage, ResourceAccess srcAccess);
+    bool isTransientResource(FrameGraphTypes::ResourceId resourceId) const;
 
     FrameGraphTypes::NodeId findNextGraphicsNode(FrameGraphTypes::NodeId fromNode,
                                                   const std::vector<FrameGraphTypes::NodeId>& executionOrder,
                                                   const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes) const;
 
-    void insertBarrierBatch(const NodeBarrierInfo& batch, VkCommandBuffer commandBuffer);
+    // Split events per frame slot, grown on demand and kept until context destruction: recompiling never
+    // destroys an event a pending frame may still set
+    bool ensureSplitEvents(uint32_t eventCount);
+    VkEvent getSplitEvent(const NodeBarrierInfo& batch, uint32_t frameIndex) const;
+
+    void fillDependencyInfo(const NodeBarrierInfo& batch, VkDependencyInfoKHR& dependencyInfo) const;
+    void insertPipelineBarrier(VkCommandBuffer commandBuffer,
+                               const std::vector<VkBufferMemoryBarrier2KHR>& bufferBarriers,
+                               const std::vector<VkImageMemoryBarrier2KHR>& imageBarriers) const;
 
     // Access conversion helpers
-    VkAccessFlags convertAccess(ResourceAccess access, PipelineStage stage) const;
-    VkPipelineStageFlags convertPipelineStage(PipelineStage stage) const;
+    VkAccessFlags2KHR convertAccess(ResourceAccess access, PipelineStage stage) const;
 
     // State
     const VulkanContext* context_ = nullptr;
-    
+    bool synchronization2_ = false;
+
     // Resource write tracking for O(n) barrier analysis
     std::unordered_map<FrameGraphTypes::ResourceId, ResourceWriteInfo> resourceWriteTracking_;
+
+    // Compiled inputs kept for building conditional schedules (nodes are owned by the frame graph)
+    std::vector<FrameGraphTypes::NodeId> executionOrder_;
+    std::vector<uint32_t> executionLevels_;
+    const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>* nodes_ = nullptr;
+    std::vector<FrameGraphTypes::ResourceId> aliasedResources_;
     
-    // Barrier batches inserted at optimal points for async execution
-    std::vector<NodeBarrierInfo> barrierBatches_;
+    // Barrier batches inserted at optimal points for async execution: the all-enabled schedule, one per
+    // disabled-node set seen since compile, and the one this frame records with
+    BarrierSchedule fullSchedule_;
+    std::unordered_map<std::vector<bool>, BarrierSchedule> conditionalSchedules_;
+    const BarrierSchedule* activeSchedule_ = &fullSchedule_;
+    
+    // Last write of each resource as of the previous frame, kept across recompiles. visibleStages has a bit per
+    // PipelineStage already synchronized with that write, so untouched resources cost nothing on later frames
+    struct ResourceState {
+        PipelineStage stage = PipelineStage::ComputeShader;
+        ResourceAccess access = ResourceAccess::Write;
+        bool onComputeQueue = false;
+        uint32_t visibleStages = 0;
+    };
+    std::unordered_map<FrameGraphTypes::ResourceId, ResourceState> resourceStates_;
+    
+    // This frame's barriers against earlier frames' writes, rebuilt by selectSchedule()
+    BarrierSchedule crossFrameSchedule_;
+    uint64_t crossFrameRecordingKey_ = 0;
+
+    // [frameIndex][eventIndex]
+    std::vector<std::vector<vulkan_raii::Event>> splitEvents_;
+
+    // Gathered per insertBarriersForNodes call (recording thread only)
+    std::vector<VkBufferMemoryBarrier2KHR> pendingBufferBarriers_;
+    std::vector<VkImageMemoryBarrier2KHR> pendingImageBarriers_;
+    std::vector<VkEvent> pendingEvents_;
+    std::vector<VkDependencyInfoKHR> pendingDependencies_;
 
     // Resource accessors (injected dependencies)
     std::function<const FrameGraphResources::FrameGraphBuffer*(FrameGraphTypes::ResourceId)> getBufferResource_;
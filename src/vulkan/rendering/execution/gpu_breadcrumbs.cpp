@@ -0,0 +1,174 @@
+#include "gpu_breadcrumbs.h"
+#include "../frame_graph_node_base.h"
+#include "../../core/vulkan_context.h"
+#include "../../core/vulkan_function_loader.h"
+#include "../../core/vulkan_constants.h"
+#include "../../core/vulkan_utils.h"
+#include <iostream>
+#include <stdexcept>
+
+namespace FrameGraphExecution {
+
+namespace {
+
+constexpr uint32_t MARKER_WORDS_PER_QUEUE = 2;  // begun, completed
+
+uint32_t markerOffset(GpuBreadcrumbs::Queue queue, bool end) {
+    return (static_cast<uint32_t>(queue) * MARKER_WORDS_PER_QUEUE + (end ? 1 : 0)) * sizeof(uint32_t);
+}
+
+}
+
+bool GpuBreadcrumbs::initialize(const VulkanContext* context) {
+    context_ = context;
+    mode_ = Mode::None;
+    if constexpr (!ENABLE_GPU_BREADCRUMBS) {
+        return false;
+    }
+    if (!context_) {
+        return false;
+    }
+    
+    const auto& vk = context_->getLoader();
+    if (!context_->supportsBufferMarkers() || !vk.vkCmdWriteBufferMarkerAMD) {
+        if (context_->supportsDiagnosticCheckpoints() && vk.vkCmdSetCheckpointNV && vk.vkGetQueueCheckpointDataNV) {
+            mode_ = Mode::Checkpoint;
+            return true;
+        }
+        return false;
+    }
+    
+    const VkDeviceSize size = QUEUE_COUNT * MARKER_WORDS_PER_QUEUE * sizeof(uint32_t);
+    VkBuffer buffer = VK_NULL_HANDLE;
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    try {
+        if (!VulkanUtils::createBuffer(context_->getDevice(), vk, size, VK_BUFFER_USAGE_TRANSFER_DST_BIT,
+                                       VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT,
+                                       buffer, memory)) {
+            return false;
+        }
+    } catch (const std::runtime_error& e) {
+        std::cerr << "GpuBreadcrumbs: No host-coherent memory for the marker buffer: " << e.what() << std::endl;
+        return false;
+    }
+    markerBuffer_ = vulkan_raii::make_buffer(buffer, context_);
+    markerMemory_ = vulkan_raii::make_device_memory(memory, context_);
+    
+    void* mapped = nullptr;
+    if (vk.vkMapMemory(context_->getDevice(), markerMemory_.get(), 0, size, 0, &mapped) != VK_SUCCESS) {
+        std::cerr << "GpuBreadcrumbs: Failed to map the marker buffer" << std::endl;
+        cleanupBeforeContextDestruction();
+        return false;
+    }
+    auto* words = static_cast<uint32_t*>(mapped);
+    for (uint32_t word = 0; word < QUEUE_COUNT * MARKER_WORDS_PER_QUEUE; ++word) {
+        words[word] = FrameGraphTypes::INVALID_NODE;
+    }
+    markers_ = words;
+    mode_ = Mode::BufferMarker;
+    return true;
+}
+
+void GpuBreadcrumbs::cleanupBeforeContextDestruction() {
+    // Freeing the memory unmaps it
+    markers_ = nullptr;
+    markerBuffer_.reset();
+    markerMemory_.reset();
+    mode_ = Mode::None;
+}
+
+void GpuBreadcrumbs::assignNodes(const std::vector<FrameGraphTypes::NodeId>& executionOrder,
+                                 const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes) {
+    if (!isActive()) return;
+    
+    std::lock_guard<std::mutex> lock(namesMutex_);
+    for (auto nodeId : executionOrder) {
+        auto it = nodes.find(nodeId);
+        if (it != nodes.end()) {
+            names_[nodeId] = it->second->getName();
+        }
+    }
+}
+
+const void* GpuBreadcrumbs::checkpointMarker(FrameGraphTypes::NodeId nodeId, bool end) {
+    return reinterpret_cast<const void*>((static_cast<uintptr_t>(nodeId) << 1) | (end ? 1u : 0u));
+}
+
+void GpuBreadcrumbs::beginNode(FrameGraphTypes::NodeId nodeId, Queue queue, VkCommandBuffer commandBuffer) const {
+    if (mode_ == Mode::BufferMarker) {
+        context_->getLoader().vkCmdWriteBufferMarkerAMD(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT,
+                                                        markerBuffer_.get(), markerOffset(queue, false), nodeId);
+    } else if (mode_ == Mode::Checkpoint) {
+        context_->getLoader().vkCmdSetCheckpointNV(commandBuffer, checkpointMarker(nodeId, false));
+    }
+}
+
+void GpuBreadcrumbs::endNode(FrameGraphTypes::NodeId nodeId, Queue queue, VkCommandBuffer commandBuffer) const {
+    if (mode_ == Mode::BufferMarker) {
+        context_->getLoader().vkCmdWriteBufferMarkerAMD(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+                                                        markerBuffer_.get(), markerOffset(queue, true), nodeId);
+    } else if (mode_ == Mode::Checkpoint) {
+        context_->getLoader().vkCmdSetCheckpointNV(commandBuffer, checkpointMarker(nodeId, true));
+    }
+}
+
+bool GpuBreadcrumbs::readTrail(Queue queue, BreadcrumbTrail& trail) const {
+    trail = {};
+    if (mode_ == Mode::Checkpoint) {
+        return readCheckpoints(queue, trail);
+    }
+    if (mode_ != Mode::BufferMarker || !markers_) {
+        return false;
+    }
+    trail.begun = markers_[markerOffset(queue, false) / sizeof(uint32_t)];
+    trail.completed = markers_[markerOffset(queue, true) / sizeof(uint32_t)];
+    return true;
+}
+
+bool GpuBreadcrumbs::readCheckpoints(Queue queue, BreadcrumbTrail& trail) const {
+    const auto& vk = context_->getLoader();
+    VkQueue vkQueue = queue == Queue::Compute ? context_->getComputeQueue() : context_->getGraphicsQueue();
+    
+    uint32_t count = 0;
+    vk.vkGetQueueCheckpointDataNV(vkQueue, &count, nullptr);
+    if (count == 0) {
+        return false;
+    }
+    std::vector<VkCheckpointDataNV> checkpoints(count, {VK_STRUCTURE_TYPE_CHECKPOINT_DATA_NV, nullptr});
+    vk.vkGetQueueCheckpointDataNV(vkQueue, &count, checkpoints.data());
+    
+    // One entry per stage with the last checkpoint that got that far: a begin at the top of the pipe names the
+    // node the queue started last, an end at the bottom the node it last finished
+    for (uint32_t i = 0; i < count; ++i) {
+        const auto marker = reinterpret_cast<uintptr_t>(checkpoints[i].pCheckpointMarker);
+        const auto nodeId = static_cast<FrameGraphTypes::NodeId>(marker >> 1);
+        const bool end = (marker & 1u) != 0;
+        if (checkpoints[i].stage == VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT && !end) {
+            trail.begun = nodeId;
+        } else if (checkpoints[i].stage == VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT && end) {
+            trail.completed = nodeId;
+        }
+    }
+    return true;
+}
+
+std::string GpuBreadcrumbs::describeNode(FrameGraphTypes::NodeId nodeId) const {
+    if (nodeId == FrameGraphTypes::INVALID_NODE) {
+        return "none";
+    }
+    std::lock_guard<std::mutex> lock(namesMutex_);
+    auto it = names_.find(nodeId);
+    const std::string name = it != names_.end() ? it->second : "unknown";
+    return name + " (node " + std::to_string(nodeId) + ")";
+}
+
+const char* GpuBreadcrumbs::getQueueName(Queue queue) {
+    switch (queue) {
+        case Queue::Compute: return "compute";
+        case Queue::Graphics: return "graphics";
+        case Queue::Count: break;
+    }
+    return "unknown";
+}
+
+} // namespace FrameGraphExecution
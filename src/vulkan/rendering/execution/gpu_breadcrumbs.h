@@ -0,0 +1,86 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../frame_graph_types.h"
+#include "../../core/vulkan_raii.h"
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include <cstdint>
+
+// Forward declarations
+class VulkanContext;
+class FrameGraphNode;
+
+namespace FrameGraphExecution {
+
+// Last frame graph node a queue started and the last one it finished (INVALID_NODE = none seen)
+struct BreadcrumbTrail {
+    FrameGraphTypes::NodeId begun = FrameGraphTypes::INVALID_NODE;
+    FrameGraphTypes::NodeId completed = FrameGraphTypes::INVALID_NODE;
+};
+
+// Marks the start (top of pipe) and end (bottom of pipe) of every recorded node on its queue, so a hang or a
+// device loss can be attributed to a node. With VK_AMD_buffer_marker the node IDs are written to a host-coherent
+// buffer the host reads at any time, a hung queue included; with VK_NV_device_diagnostic_checkpoints they are
+// checkpoints the driver only hands back once the device is lost. Markers hold node IDs only, nothing per frame,
+// so replayed recordings stay valid. Overlapping nodes on one queue retire their ends in pipeline order, so
+// "completed" is the latest end to retire rather than every node before "begun".
+class GpuBreadcrumbs {
+public:
+    enum class Queue : uint32_t { Compute, Graphics, Count };
+    static constexpr uint32_t QUEUE_COUNT = static_cast<uint32_t>(Queue::Count);
+    
+    GpuBreadcrumbs() = default;
+    ~GpuBreadcrumbs() = default;
+    
+    GpuBreadcrumbs(const GpuBreadcrumbs&) = delete;
+    GpuBreadcrumbs& operator=(const GpuBreadcrumbs&) = delete;
+    
+    // Stays inactive (every call a no-op) without ENABLE_GPU_BREADCRUMBS or either extension
+    bool initialize(const VulkanContext* context);
+    void cleanupBeforeContextDestruction();
+    bool isActive() const { return mode_ != Mode::None; }
+    bool readableBeforeLoss() const { return mode_ == Mode::BufferMarker; }
+    
+    // Keeps the node names for reports; names of removed nodes stay, as an in-flight frame may still run them
+    void assignNodes(const std::vector<FrameGraphTypes::NodeId>& executionOrder,
+                     const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes);
+    
+    // Recorded around the node's commands. Const like the timestamp hooks, so recording lanes call them from
+    // their own threads
+    void beginNode(FrameGraphTypes::NodeId nodeId, Queue queue, VkCommandBuffer commandBuffer) const;
+    void endNode(FrameGraphTypes::NodeId nodeId, Queue queue, VkCommandBuffer commandBuffer) const;
+    
+    // Any thread. Buffer markers are read as they stand; checkpoints only exist after VK_ERROR_DEVICE_LOST, so
+    // false before that or when the queue reported none
+    bool readTrail(Queue queue, BreadcrumbTrail& trail) const;
+    
+    // "<name> (node N)", or "none" for INVALID_NODE; any thread
+    std::string describeNode(FrameGraphTypes::NodeId nodeId) const;
+    
+    static const char* getQueueName(Queue queue);
+
+private:
+    enum class Mode : uint8_t { None, BufferMarker, Checkpoint };
+    
+    // Checkpoint markers are pointer-sized values, not pointers: the node ID shifted left once, low bit set on ends
+    static const void* checkpointMarker(FrameGraphTypes::NodeId nodeId, bool end);
+    bool readCheckpoints(Queue queue, BreadcrumbTrail& trail) const;
+    
+    const VulkanContext* context_ = nullptr;
+    Mode mode_ = Mode::None;
+    
+    // Buffer markers: {begun, completed} per queue, persistently mapped
+    vulkan_raii::Buffer markerBuffer_;
+    vulkan_raii::DeviceMemory markerMemory_;
+    const volatile uint32_t* markers_ = nullptr;
+    
+    mutable std::mutex namesMutex_;
+    std::unordered_map<FrameGraphTypes::NodeId, std::string> names_;
+};
+
+} // namespace FrameGraphExecution
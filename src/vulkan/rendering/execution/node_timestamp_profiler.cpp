@@ -0,0 +1,277 @@
+#include "node_timestamp_profiler.h"
+#include "../frame_graph_node_base.h"
+#include "../../core/vulkan_context.h"
+#include "../../core/vulkan_function_loader.h"
+#include "../../core/vulkan_constants.h"
+#include "../../../ecs/utilities/profiler.h"
+#include <algorithm>
+#include <iostream>
+
+namespace FrameGraphExecution {
+
+bool NodeTimestampProfiler::initialize(const VulkanContext* context) {
+    context_ = context;
+    active_ = false;
+    if constexpr (!ENABLE_GPU_NODE_TIMESTAMPS) {
+        return false;
+    }
+    if (!context_) {
+        return false;
+    }
+    
+    const auto& vk = context_->getLoader();
+    VkPhysicalDeviceProperties props;
+    vk.vkGetPhysicalDeviceProperties(context_->getPhysicalDevice(), &props);
+    
+    // Both queues must write timestamps; the narrower valid width bounds every delta
+    uint32_t familyCount = 0;
+    vk.vkGetPhysicalDeviceQueueFamilyProperties(context_->getPhysicalDevice(), &familyCount, nullptr);
+    std::vector<VkQueueFamilyProperties> families(familyCount);
+    vk.vkGetPhysicalDeviceQueueFamilyProperties(context_->getPhysicalDevice(), &familyCount, families.data());
+    
+    const uint32_t computeFamily = context_->getComputeQueueFamily();
+    const uint32_t graphicsFamily = context_->getGraphicsQueueFamily();
+    if (computeFamily >= familyCount || graphicsFamily >= familyCount) {
+        return false;
+    }
+    const uint32_t validBits = std::min(families[computeFamily].timestampValidBits, families[graphicsFamily].timestampValidBits);
+    if (validBits == 0 || props.limits.timestampPeriod <= 0.0f) {
+        std::cout << "NodeTimestampProfiler: Timestamps unsupported on the frame graph queues, GPU node timing disabled" << std::endl;
+        return false;
+    }
+    timestampMask_ = validBits >= 64 ? ~0ULL : ((1ULL << validBits) - 1);
+    timestampPeriodNs_ = props.limits.timestampPeriod;
+    clock_.initialize(context_, timestampPeriodNs_, timestampMask_);
+    synchronization2_ = context_->supportsSynchronization2();
+    
+    VkQueryPoolCreateInfo queryPoolInfo{};
+    queryPoolInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryPoolInfo.queryType = VK_QUERY_TYPE_TIMESTAMP;
+    queryPoolInfo.queryCount = GPU_NODE_TIMESTAMP_MAX_NODES * 2;
+    
+    if (!createQueryPools(queryPoolInfo, queryPools_)) {
+        return false;
+    }
+    
+    // Statistics are best effort: without them the timestamps still run
+    computeStatisticsPools_.clear();
+    graphicsStatisticsPools_.clear();
+    if (context_->supportsPipelineStatistics()) {
+        VkQueryPoolCreateInfo statisticsInfo{};
+        statisticsInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+        statisticsInfo.queryType = VK_QUERY_TYPE_PIPELINE_STATISTICS;
+        statisticsInfo.queryCount = GPU_NODE_TIMESTAMP_MAX_NODES;
+        
+        statisticsInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_COMPUTE_SHADER_INVOCATIONS_BIT;
+        const bool computeCreated = createQueryPools(statisticsInfo, computeStatisticsPools_);
+        
+        statisticsInfo.pipelineStatistics = VK_QUERY_PIPELINE_STATISTIC_VERTEX_SHADER_INVOCATIONS_BIT |
+                                            VK_QUERY_PIPELINE_STATISTIC_CLIPPING_PRIMITIVES_BIT;
+        const bool graphicsCreated = createQueryPools(statisticsInfo, graphicsStatisticsPools_);
+        
+        if (!computeCreated || !graphicsCreated) {
+            computeStatisticsPools_.clear();
+            graphicsStatisticsPools_.clear();
+        }
+    }
+    
+    const uint32_t framesInFlight = context_->getFramesInFlight();
+    writtenPairs_.assign(framesInFlight, std::vector<FrameGraphTypes::NodeId>(GPU_NODE_TIMESTAMP_MAX_NODES, FrameGraphTypes::INVALID_NODE));
+    active_ = true;
+    return true;
+}
+
+bool NodeTimestampProfiler::createQueryPools(const VkQueryPoolCreateInfo& createInfo, std::vector<vulkan_raii::QueryPool>& pools) {
+    const auto& vk = context_->getLoader();
+    pools.clear();
+    for (uint32_t frame = 0; frame < context_->getFramesInFlight(); ++frame) {
+        VkQueryPool queryPoolHandle = VK_NULL_HANDLE;
+        VkResult result = vk.vkCreateQueryPool(context_->getDevice(), &createInfo, nullptr, &queryPoolHandle);
+        if (result != VK_SUCCESS) {
+            std::cerr << "NodeTimestampProfiler: Failed to create query pool (type " << createInfo.queryType << "): " << result << std::endl;
+            pools.clear();
+            return false;
+        }
+        pools.push_back(vulkan_raii::make_query_pool(queryPoolHandle, context_));
+    }
+    return true;
+}
+
+void NodeTimestampProfiler::cleanupBeforeContextDestruction() {
+    queryPools_.clear();
+    computeStatisticsPools_.clear();
+    graphicsStatisticsPools_.clear();
+    writtenPairs_.clear();
+    active_ = false;
+}
+
+void NodeTimestampProfiler::assignNodes(const std::vector<FrameGraphTypes::NodeId>& executionOrder,
+                                        const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes) {
+    queryPairs_.clear();
+    statisticsPools_.clear();
+    if (!active_) return;
+    
+    for (size_t position = 0; position < executionOrder.size(); ++position) {
+        auto it = nodes.find(executionOrder[position]);
+        if (it == nodes.end()) continue;
+        if (position >= GPU_NODE_TIMESTAMP_MAX_NODES) {
+            std::cerr << "NodeTimestampProfiler: Only the first " << GPU_NODE_TIMESTAMP_MAX_NODES << " nodes are timed" << std::endl;
+            break;
+        }
+        queryPairs_[executionOrder[position]] = static_cast<uint32_t>(position);
+        timings_[executionOrder[position]].name = it->second->getName();
+        timings_[executionOrder[position]].bytesPerEntity = it->second->getBytesPerEntity();
+        samples_[executionOrder[position]].profileZone = Profiler::getInstance().registerZone("GPU/" + it->second->getName());
+        samples_[executionOrder[position]].profileTrack = it->second->needsComputeQueue() ? Profiler::GPU_COMPUTE_TRACK : Profiler::GPU_TRACK;
+        
+        if (!computeStatisticsPools_.empty() && it->second->wantsPipelineStatistics()) {
+            statisticsPools_[executionOrder[position]] = it->second->needsComputeQueue() ? StatisticsPool::Compute : StatisticsPool::Graphics;
+        }
+    }
+}
+
+void NodeTimestampProfiler::collect(uint32_t frameIndex) {
+    if (!active_ || frameIndex >= writtenPairs_.size()) return;
+    
+    const auto& vk = context_->getLoader();
+    VkQueryPool queryPool = queryPools_[frameIndex].get();
+    const int64_t collectNs = Profiler::now();
+    clock_.refresh(collectNs);
+    for (uint32_t pair = 0; pair < GPU_NODE_TIMESTAMP_MAX_NODES; ++pair) {
+        const FrameGraphTypes::NodeId nodeId = writtenPairs_[frameIndex][pair];
+        if (nodeId == FrameGraphTypes::INVALID_NODE) continue;
+        writtenPairs_[frameIndex][pair] = FrameGraphTypes::INVALID_NODE;
+        
+        // Value and availability per query; never waits, an unfinished pair is simply dropped
+        uint64_t results[4] = {};
+        VkResult result = vk.vkGetQueryPoolResults(
+            context_->getDevice(), queryPool, pair * 2, 2, sizeof(results), results, sizeof(uint64_t) * 2,
+            VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+        if ((result != VK_SUCCESS && result != VK_NOT_READY) || results[1] == 0 || results[3] == 0) {
+            continue;
+        }
+        
+        const uint64_t ticks = ((results[2] & timestampMask_) - (results[0] & timestampMask_)) & timestampMask_;
+        const double durationNs = static_cast<double>(ticks) * timestampPeriodNs_;
+        clock_.boundByReadback(collectNs, results[2]);
+        addSample(nodeId, static_cast<float>(durationNs / 1e6), clock_.toSteadyNs(results[0]));
+        
+        auto statistics = statisticsPools_.find(nodeId);
+        if (statistics != statisticsPools_.end()) {
+            collectStatistics(nodeId, statistics->second, pair, frameIndex);
+        }
+    }
+}
+
+void NodeTimestampProfiler::collectStatistics(FrameGraphTypes::NodeId nodeId, StatisticsPool pool, uint32_t pair, uint32_t frameIndex) {
+    const auto& vk = context_->getLoader();
+    
+    // Counters come back in statistic bit order, followed by the availability word
+    uint64_t results[3] = {};
+    const uint32_t counterCount = pool == StatisticsPool::Compute ? 1 : 2;
+    VkResult result = vk.vkGetQueryPoolResults(
+        context_->getDevice(), getStatisticsPool(pool, frameIndex), pair, 1, sizeof(results), results, sizeof(results),
+        VK_QUERY_RESULT_64_BIT | VK_QUERY_RESULT_WITH_AVAILABILITY_BIT);
+    if ((result != VK_SUCCESS && result != VK_NOT_READY) || results[counterCount] == 0) {
+        return;
+    }
+    
+    NodeGpuTiming& timing = timings_[nodeId];
+    timing.hasPipelineStatistics = true;
+    if (pool == StatisticsPool::Compute) {
+        timing.computeShaderInvocations = results[0];
+    } else {
+        timing.vertexShaderInvocations = results[0];
+        timing.clippingPrimitives = results[1];
+    }
+}
+
+VkQueryPool NodeTimestampProfiler::getStatisticsPool(StatisticsPool pool, uint32_t frameIndex) const {
+    const auto& pools = pool == StatisticsPool::Compute ? computeStatisticsPools_ : graphicsStatisticsPools_;
+    return pool != StatisticsPool::None && frameIndex < pools.size() ? pools[frameIndex].get() : VK_NULL_HANDLE;
+}
+
+void NodeTimestampProfiler::beginNode(FrameGraphTypes::NodeId nodeId, VkCommandBuffer commandBuffer, uint32_t frameIndex) const {
+    auto it = queryPairs_.find(nodeId);
+    if (!active_ || it == queryPairs_.end() || frameIndex >= queryPools_.size()) return;
+    
+    const auto& vk = context_->getLoader();
+    VkQueryPool queryPool = queryPools_[frameIndex].get();
+    const uint32_t firstQuery = it->second * 2;
+    
+    // Reset in the same command buffer, so replaying a recording resets its queries again
+    vk.vkCmdResetQueryPool(commandBuffer, queryPool, firstQuery, 2);
+    if (synchronization2_) {
+        vk.vkCmdWriteTimestamp2KHR(commandBuffer, VK_PIPELINE_STAGE_2_TOP_OF_PIPE_BIT_KHR, queryPool, firstQuery);
+    } else {
+        vk.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_TOP_OF_PIPE_BIT, queryPool, firstQuery);
+    }
+    
+    auto statistics = statisticsPools_.find(nodeId);
+    if (statistics != statisticsPools_.end()) {
+        VkQueryPool statisticsPool = getStatisticsPool(statistics->second, frameIndex);
+        vk.vkCmdResetQueryPool(commandBuffer, statisticsPool, it->second, 1);
+        vk.vkCmdBeginQuery(commandBuffer, statisticsPool, it->second, 0);
+    }
+}
+
+void NodeTimestampProfiler::endNode(FrameGraphTypes::NodeId nodeId, VkCommandBuffer commandBuffer, uint32_t frameIndex) const {
+    auto it = queryPairs_.find(nodeId);
+    if (!active_ || it == queryPairs_.end() || frameIndex >= queryPools_.size()) return;
+    
+    const auto& vk = context_->getLoader();
+    VkQueryPool queryPool = queryPools_[frameIndex].get();
+    const uint32_t lastQuery = it->second * 2 + 1;
+    
+    auto statistics = statisticsPools_.find(nodeId);
+    if (statistics != statisticsPools_.end()) {
+        vk.vkCmdEndQuery(commandBuffer, getStatisticsPool(statistics->second, frameIndex), it->second);
+    }
+    
+    // Written once everything recorded before it has finished, which includes the node's own work
+    if (synchronization2_) {
+        vk.vkCmdWriteTimestamp2KHR(commandBuffer, VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR, queryPool, lastQuery);
+    } else {
+        vk.vkCmdWriteTimestamp(commandBuffer, VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT, queryPool, lastQuery);
+    }
+    writtenPairs_[frameIndex][it->second] = nodeId;
+}
+
+void NodeTimestampProfiler::markReplayed(FrameGraphTypes::NodeId nodeId, uint32_t frameIndex) const {
+    auto it = queryPairs_.find(nodeId);
+    if (!active_ || it == queryPairs_.end() || frameIndex >= writtenPairs_.size()) return;
+    writtenPairs_[frameIndex][it->second] = nodeId;
+}
+
+const NodeGpuTiming* NodeTimestampProfiler::getTiming(FrameGraphTypes::NodeId nodeId) const {
+    auto it = timings_.find(nodeId);
+    return it != timings_.end() && it->second.sampleCount > 0 ? &it->second : nullptr;
+}
+
+void NodeTimestampProfiler::addSample(FrameGraphTypes::NodeId nodeId, float milliseconds, int64_t startNs) {
+    NodeSamples& samples = samples_[nodeId];
+    if (samples.window.size() < GPU_NODE_TIMING_WINDOW) {
+        samples.window.push_back(milliseconds);
+    } else {
+        samples.window[samples.next] = milliseconds;
+    }
+    samples.next = (samples.next + 1) % GPU_NODE_TIMING_WINDOW;
+    
+    sortScratch_.assign(samples.window.begin(), samples.window.end());
+    std::sort(sortScratch_.begin(), sortScratch_.end());
+    float sum = 0.0f;
+    for (float sample : sortScratch_) {
+        sum += sample;
+    }
+    
+    NodeGpuTiming& timing = timings_[nodeId];
+    timing.lastMs = milliseconds;
+    timing.minMs = sortScratch_.front();
+    timing.avgMs = sum / static_cast<float>(sortScratch_.size());
+    timing.p99Ms = sortScratch_[(sortScratch_.size() - 1) * 99 / 100];
+    ++timing.sampleCount;
+    
+    Profiler::getInstance().recordGpuZone(samples.profileZone, startNs, static_cast<int64_t>(milliseconds * 1e6f), samples.profileTrack);
+}
+
+} // namespace FrameGraphExecution
@@ -0,0 +1,115 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../frame_graph_types.h"
+#include "../../core/vulkan_raii.h"
+#include "../../core/gpu_clock_calibration.h"
+#include <vector>
+#include <string>
+#include <unordered_map>
+#include <memory>
+#include <cstdint>
+
+// Forward declarations
+class VulkanContext;
+class FrameGraphNode;
+
+namespace FrameGraphExecution {
+
+// Rolling GPU execution time of one node over the last GPU_NODE_TIMING_WINDOW measured frames
+struct NodeGpuTiming {
+    std::string name;
+    float lastMs = 0.0f;
+    float minMs = 0.0f;
+    float avgMs = 0.0f;
+    float p99Ms = 0.0f;
+    uint64_t sampleCount = 0;  // Total samples since the node was first timed
+    float bytesPerEntity = 0.0f;  // FrameGraphNode::getBytesPerEntity() at compile
+    
+    // Latest pipeline statistics reading, for nodes that opt in under ENABLE_GPU_PIPELINE_STATISTICS;
+    // compute nodes only fill computeShaderInvocations, graphics nodes the other two
+    bool hasPipelineStatistics = false;
+    uint64_t computeShaderInvocations = 0;
+    uint64_t vertexShaderInvocations = 0;
+    uint64_t clippingPrimitives = 0;
+};
+
+// Brackets every executed node with timestamps in a per-frame-slot query pool (two queries per compiled
+// position). Results are read back without waiting when the slot is recorded again, frames-in-flight frames
+// later. Timestamps go through vkCmdWriteTimestamp2 with VK_KHR_synchronization2, vkCmdWriteTimestamp otherwise.
+// Nodes returning true from wantsPipelineStatistics() additionally get a pipeline statistics query between
+// their timestamps, from a compute-only pool on the compute queue so it stays legal on dedicated compute families.
+class NodeTimestampProfiler {
+public:
+    NodeTimestampProfiler() = default;
+    ~NodeTimestampProfiler() = default;
+    
+    NodeTimestampProfiler(const NodeTimestampProfiler&) = delete;
+    NodeTimestampProfiler& operator=(const NodeTimestampProfiler&) = delete;
+    
+    // Stays inactive (every call a no-op) when ENABLE_GPU_NODE_TIMESTAMPS is off or either queue lacks timestamps
+    bool initialize(const VulkanContext* context);
+    void cleanupBeforeContextDestruction();
+    bool isActive() const { return active_; }
+    
+    // Query pairs follow the compiled order; timings survive recompilation for nodes that remain
+    void assignNodes(const std::vector<FrameGraphTypes::NodeId>& executionOrder,
+                     const std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>>& nodes);
+    
+    // Reads the slot's previous results into the rolling timings and Profiler ("GPU/<node>" zones on the GPU
+    // track of the node's queue, on the steady clock through GpuClockCalibration); call once the slot's fence
+    // has signalled and before anything records into it
+    void collect(uint32_t frameIndex);
+    
+    // Recorded around the node's commands, outside any render pass. Const and per-node, so recording lanes
+    // call them from their own threads
+    void beginNode(FrameGraphTypes::NodeId nodeId, VkCommandBuffer commandBuffer, uint32_t frameIndex) const;
+    void endNode(FrameGraphTypes::NodeId nodeId, VkCommandBuffer commandBuffer, uint32_t frameIndex) const;
+    
+    // A replayed recording writes the queries it was recorded with, without going through beginNode()
+    void markReplayed(FrameGraphTypes::NodeId nodeId, uint32_t frameIndex) const;
+    
+    const NodeGpuTiming* getTiming(FrameGraphTypes::NodeId nodeId) const;
+    const std::unordered_map<FrameGraphTypes::NodeId, NodeGpuTiming>& getTimings() const { return timings_; }
+
+private:
+    enum class StatisticsPool : uint8_t { None, Compute, Graphics };
+    
+    struct NodeSamples {
+        std::vector<float> window;  // Ring of the most recent samples
+        size_t next = 0;
+        uint32_t profileZone = 0;   // Profiler zone "GPU/<node>"
+        uint32_t profileTrack = 0;  // Profiler GPU track of the node's queue
+    };
+    
+    void addSample(FrameGraphTypes::NodeId nodeId, float milliseconds, int64_t startNs);
+    bool createQueryPools(const VkQueryPoolCreateInfo& createInfo, std::vector<vulkan_raii::QueryPool>& pools);
+    VkQueryPool getStatisticsPool(StatisticsPool pool, uint32_t frameIndex) const;
+    void collectStatistics(FrameGraphTypes::NodeId nodeId, StatisticsPool pool, uint32_t pair, uint32_t frameIndex);
+    
+    const VulkanContext* context_ = nullptr;
+    bool active_ = false;
+    bool synchronization2_ = false;
+    float timestampPeriodNs_ = 1.0f;
+    uint64_t timestampMask_ = ~0ULL;
+    GpuClockCalibration clock_;
+    
+    std::vector<vulkan_raii::QueryPool> queryPools_;  // One per frame slot
+    std::unordered_map<FrameGraphTypes::NodeId, uint32_t> queryPairs_;
+    
+    // Pipeline statistics, one query per pair index and frame slot (empty when the mode is off)
+    std::vector<vulkan_raii::QueryPool> computeStatisticsPools_;
+    std::vector<vulkan_raii::QueryPool> graphicsStatisticsPools_;
+    std::unordered_map<FrameGraphTypes::NodeId, StatisticsPool> statisticsPools_;
+    
+    // [frameIndex][pair]: node whose queries were written in the slot's last recording (INVALID_NODE = none);
+    // lanes write distinct entries of the current slot
+    mutable std::vector<std::vector<FrameGraphTypes::NodeId>> writtenPairs_;
+    
+    std::unordered_map<FrameGraphTypes::NodeId, NodeGpuTiming> timings_;
+    std::unordered_map<FrameGraphTypes::NodeId, NodeSamples> samples_;
+    std::vector<float> sortScratch_;
+};
+
+} // namespace FrameGraphExecution
@@ -0,0 +1,99 @@
+#include "parallel_recorder.h"
+#include <iostream>
+
+namespace FrameGraphExecution {
+
+ParallelRecorder::~ParallelRecorder() {
+    shutdown();
+}
+
+bool ParallelRecorder::initialize(uint32_t laneCount) {
+    shutdown();
+    if (laneCount == 0) {
+        std::cerr << "ParallelRecorder: Lane count must be at least 1" << std::endl;
+        return false;
+    }
+    
+    stopping_ = false;
+    generation_ = 0;
+    laneCount_ = laneCount;
+    workers_.reserve(laneCount - 1);
+    for (uint32_t lane = 1; lane < laneCount; ++lane) {
+        workers_.emplace_back(&ParallelRecorder::workerLoop, this, lane);
+    }
+    return true;
+}
+
+void ParallelRecorder::shutdown() {
+    {
+        std::lock_guard<std::mutex> lock(mutex_);
+        stopping_ = true;
+    }
+    workReady_.notify_all();
+    for (auto& worker : workers_) {
+        if (worker.joinable()) {
+            worker.join();
+        }
+    }
+    workers_.clear();
+    laneCount_ = 0;
+}
+
+void ParallelRecorder::run(std::vector<std::vector<Job>>& jobsPerLane) {
+    if (jobsPerLane.size() < laneCount_ || laneCount_ == 0) {
+        // Caller sized the lanes for a different recorder - fall back to running everything inline
+        for (auto& laneJobs : jobsPerLane) {
+            for (auto& job : laneJobs) job();
+        }
+        return;
+    }
+    
+    if (!workers_.empty()) {
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            jobs_ = &jobsPerLane;
+            pendingWorkers_ = static_cast<uint32_t>(workers_.size());
+            ++generation_;
+        }
+        workReady_.notify_all();
+    }
+    
+    for (auto& job : jobsPerLane[0]) {
+        job();
+    }
+    
+    if (!workers_.empty()) {
+        std::unique_lock<std::mutex> lock(mutex_);
+        workDone_.wait(lock, [this]() { return pendingWorkers_ == 0; });
+        jobs_ = nullptr;
+    }
+}
+
+void ParallelRecorder::workerLoop(uint32_t lane) {
+    uint64_t seenGeneration = 0;
+    for (;;) {
+        std::vector<Job>* laneJobs = nullptr;
+        {
+            std::unique_lock<std::mutex> lock(mutex_);
+            workReady_.wait(lock, [&]() { return stopping_ || generation_ != seenGeneration; });
+            if (stopping_) {
+                return;
+            }
+            seenGeneration = generation_;
+            laneJobs = &(*jobs_)[lane];
+        }
+        
+        for (auto& job : *laneJobs) {
+            job();
+        }
+        
+        {
+            std::lock_guard<std::mutex> lock(mutex_);
+            if (--pendingWorkers_ == 0) {
+                workDone_.notify_one();
+            }
+        }
+    }
+}
+
+} // namespace FrameGraphExecution
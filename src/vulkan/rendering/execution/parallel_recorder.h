@@ -0,0 +1,50 @@
+#pragma once
+
+#include <vector>
+#include <thread>
+#include <mutex>
+#include <condition_variable>
+#include <functional>
+#include <cstdint>
+
+namespace FrameGraphExecution {
+
+// Persistent recording lanes for frame graph levels. Lane 0 runs on the calling thread, lanes 1..N-1 on
+// worker threads that sleep between frames. Each lane runs its own job list in order, so a lane's jobs may
+// share a command pool; jobs on different lanes must not touch shared mutable state.
+class ParallelRecorder {
+public:
+    using Job = std::function<void()>;
+    
+    ParallelRecorder() = default;
+    ~ParallelRecorder();
+    
+    ParallelRecorder(const ParallelRecorder&) = delete;
+    ParallelRecorder& operator=(const ParallelRecorder&) = delete;
+    
+    // Spawns laneCount - 1 workers; a lane count of 1 keeps run() on the calling thread
+    bool initialize(uint32_t laneCount);
+    void shutdown();
+    
+    uint32_t getLaneCount() const { return laneCount_; }
+    
+    // Runs jobsPerLane[i] on lane i and returns once every lane has finished
+    void run(std::vector<std::vector<Job>>& jobsPerLane);
+
+private:
+    void workerLoop(uint32_t lane);
+    
+    std::vector<std::thread> workers_;
+    uint32_t laneCount_ = 0;
+    
+    // Hand-off state, guarded by mutex_
+    std::mutex mutex_;
+    std::condition_variable workReady_;
+    std::condition_variable workDone_;
+    std::vector<std::vector<Job>>* jobs_ = nullptr;
+    uint64_t generation_ = 0;
+    uint32_t pendingWorkers_ = 0;
+    bool stopping_ = false;
+};
+
+} // namespace FrameGraphExecution
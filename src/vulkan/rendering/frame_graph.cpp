@@ -2,10 +2,16 @@
 #include "../core/vulkan_context.h"
 #include "../core/vulkan_sync.h"
 #include "../core/queue_manager.h"
+#include "../core/vulkan_constants.h"
+#include "../core/vulkan_debug_labels.h"
 #include "../monitoring/gpu_memory_monitor.h"
 #include "../monitoring/gpu_timeout_detector.h"
+#include "../pipelines/hash_utils.h"
+#include "../../ecs/utilities/profiler.h"
 #include <iostream>
 #include <cassert>
+#include <algorithm>
+#include <thread>
 
 FrameGraph::FrameGraph() {
 }
@@ -31,6 +37,8 @@ bool FrameGraph::initialize(const VulkanContext& context, VulkanSync* sync, Queu
     }
     
     barrierManager_.initialize(&context);
+    nodeProfiler_.initialize(&context);
+    breadcrumbs_.initialize(&context);
     
     // Set up resource accessors for barrier manager
     barrierManager_.setResourceAccessors(
@@ -38,6 +46,12 @@ bool FrameGraph::initialize(const VulkanContext& context, VulkanSync* sync, Queu
         [this](FrameGraphTypes::ResourceId id) { return resourceManager_.getImageResource(id); }
     );
     
+    // Recording lanes are optional - without them every node records inline into the per-frame buffers
+    const uint32_t laneCount = std::min(FRAME_GRAPH_RECORDING_LANES, std::max(1u, std::thread::hardware_concurrency()));
+    if (laneCount > 1 && queueManager->createRecordingCommandPools(laneCount)) {
+        parallelRecorder_.initialize(laneCount);
+    }
+    
     initialized_ = true;
     std::cout << "FrameGraph initialized successfully with modular components" << std::endl;
     return true;
@@ -49,7 +63,9 @@ void FrameGraph::cleanup() {
     cleanupBeforeContextDestruction();
     
     nodes_.clear();
+    dependencyArena_.clear();
     executionOrder_.clear();
+    executionLevels_.clear();
     barrierManager_.reset();
     resourceManager_.cleanup();
     
@@ -59,6 +75,12 @@ void FrameGraph::cleanup() {
 }
 
 void FrameGraph::cleanupBeforeContextDestruction() {
+    // Secondaries are freed with the queue manager's recording pools
+    parallelRecorder_.shutdown();
+    parallelSlots_.clear();
+    barrierManager_.cleanupBeforeContextDestruction();
+    nodeProfiler_.cleanupBeforeContextDestruction();
+    breadcrumbs_.cleanupBeforeContextDestruction();
     resourceManager_.cleanupBeforeContextDestruction();
 }
 
@@ -66,6 +88,10 @@ void FrameGraph::setMemoryMonitor(GPUMemoryMonitor* monitor) {
     resourceManager_.setMemoryMonitor(monitor);
 }
 
+void FrameGraph::setMemoryAllocator(MemoryAllocator* allocator) {
+    resourceManager_.setMemoryAllocator(allocator);
+}
+
 // Resource management delegation
 FrameGraphTypes::ResourceId FrameGraph::createBuffer(const std::string& name, VkDeviceSize size, VkBufferUsageFlags usage) {
     return resourceManager_.createBuffer(name, size, usage);
@@ -75,6 +101,14 @@ FrameGraphTypes::ResourceId FrameGraph::createImage(const std::string& name, VkF
     return resourceManager_.createImage(name, format, extent, usage);
 }
 
+FrameGraphTypes::ResourceId FrameGraph::createTransientBuffer(const std::string& name, VkDeviceSize size, VkBufferUsageFlags usage) {
+    return resourceManager_.createTransientBuffer(name, size, usage);
+}
+
+FrameGraphTypes::ResourceId FrameGraph::createTransientImage(const std::string& name, VkFormat format, VkExtent2D extent, VkImageUsageFlags usage) {
+    return resourceManager_.createTransientImage(name, format, extent, usage);
+}
+
 FrameGraphTypes::ResourceId FrameGraph::importExternalBuffer(const std::string& name, VkBuffer buffer, VkDeviceSize size, VkBufferUsageFlags usage) {
     return resourceManager_.importExternalBuffer(name, buffer, size, usage);
 }
@@ -83,6 +117,16 @@ FrameGraphTypes::ResourceId FrameGraph::importExternalImage(const std::string& n
     return resourceManager_.importExternalImage(name, image, view, format, extent);
 }
 
+bool FrameGraph::updateExternalBuffer(FrameGraphTypes::ResourceId id, VkBuffer buffer, VkDeviceSize size) {
+    // Recordings may reference the old handle through the barrier batches
+    invalidateRecordedCommands();
+    if (!resourceManager_.updateExternalBuffer(id, buffer, size)) {
+        return false;
+    }
+    barrierManager_.rebindResources();
+    return true;
+}
+
 VkBuffer FrameGraph::getBuffer(FrameGraphTypes::ResourceId id) const {
     return resourceManager_.getBuffer(id);
 }
@@ -114,6 +158,138 @@ void FrameGraph::debugPrint() const {
     }
 }
 
+FrameGraphScheduleExport::Schedule FrameGraph::captureSchedule(uint32_t entityCount) const {
+    FrameGraphScheduleExport::Schedule schedule;
+    schedule.entityCount = entityCount;
+    schedule.timingWindow = GPU_NODE_TIMING_WINDOW;
+    if (!compiled_) return schedule;
+    
+    const auto& barrierSchedule = barrierManager_.getFullSchedule();
+    std::unordered_map<FrameGraphTypes::NodeId, FrameGraphCompilation::QueueStream> streams;
+    std::vector<FrameGraphTypes::ResourceId> declaredResources;
+    for (size_t position = 0; position < executionOrder_.size(); ++position) {
+        const FrameGraphTypes::NodeId nodeId = executionOrder_[position];
+        auto it = nodes_.find(nodeId);
+        if (it == nodes_.end()) continue;
+        const FrameGraphNode& node = *it->second;
+        
+        FrameGraphScheduleExport::ScheduleNode& entry = schedule.nodes.emplace_back();
+        entry.id = nodeId;
+        entry.name = node.getName();
+        entry.position = static_cast<uint32_t>(position);
+        entry.level = position < executionLevels_.size() ? executionLevels_[position] : 0;
+        entry.affinity = node.getQueueAffinity();
+        entry.stream = position < queuePartition_.streamAt.size() ? queuePartition_.streamAt[position]
+                                                                  : FrameGraphCompilation::streamForAffinity(entry.affinity);
+        entry.inputs.assign(node.getDeclaredInputs().begin(), node.getDeclaredInputs().end());
+        entry.outputs.assign(node.getDeclaredOutputs().begin(), node.getDeclaredOutputs().end());
+        entry.aliasingBarrier = barrierSchedule.aliasingBarrierNodes.count(nodeId) != 0;
+        entry.bytesPerFrame = static_cast<double>(node.getBytesPerEntity()) * entityCount;
+        if (const auto* timing = nodeProfiler_.getTiming(nodeId)) {
+            entry.hasTiming = true;
+            entry.avgMs = timing->avgMs;
+            entry.minMs = timing->minMs;
+            entry.p99Ms = timing->p99Ms;
+            entry.sampleCount = timing->sampleCount;
+        }
+        streams[nodeId] = entry.stream;
+        
+        for (const auto* dependencies : {&entry.inputs, &entry.outputs}) {
+            for (const ResourceDependency& dependency : *dependencies) {
+                if (std::find(declaredResources.begin(), declaredResources.end(), dependency.resourceId) == declaredResources.end()) {
+                    declaredResources.push_back(dependency.resourceId);
+                }
+            }
+        }
+    }
+    
+    std::sort(declaredResources.begin(), declaredResources.end());
+    for (FrameGraphTypes::ResourceId resourceId : declaredResources) {
+        FrameGraphScheduleExport::ScheduleResource& entry = schedule.resources.emplace_back();
+        entry.id = resourceId;
+        if (const auto* buffer = resourceManager_.getBufferResource(resourceId)) {
+            entry.name = buffer->debugName;
+            entry.size = buffer->size;
+            entry.isExternal = buffer->isExternal;
+            entry.isTransient = buffer->isTransient;
+            entry.isAliased = buffer->isAliased;
+        } else if (const auto* image = resourceManager_.getImageResource(resourceId)) {
+            entry.name = image->debugName;
+            entry.isImage = true;
+            entry.extent = image->extent;
+            entry.isExternal = image->isExternal;
+            entry.isTransient = image->isTransient;
+            entry.isAliased = image->isAliased;
+        }
+    }
+    
+    // The compiler's graph, labelled with the resources that order each pair
+    const auto graph = FrameGraphCompilation::DependencyGraph::buildGraph(nodes_);
+    for (const auto& producerEntry : schedule.nodes) {
+        auto adjacency = graph.adjacencyList.find(producerEntry.id);
+        if (adjacency == graph.adjacencyList.end()) continue;
+        const FrameGraphNode& producer = *nodes_.at(producerEntry.id);
+        for (FrameGraphTypes::NodeId consumerId : adjacency->second) {
+            const FrameGraphNode& consumer = *nodes_.at(consumerId);
+            FrameGraphScheduleExport::ScheduleEdge& edge = schedule.edges.emplace_back();
+            edge.producer = producerEntry.id;
+            edge.consumer = consumerId;
+            edge.crossQueue = streams[producerEntry.id] != streams[consumerId];
+            auto addShared = [&edge](std::span<const ResourceDependency> from, std::span<const ResourceDependency> to) {
+                for (const ResourceDependency& a : from) {
+                    const bool shared = std::any_of(to.begin(), to.end(),
+                                                    [&a](const ResourceDependency& b) { return b.resourceId == a.resourceId; });
+                    if (shared && std::find(edge.resources.begin(), edge.resources.end(), a.resourceId) == edge.resources.end()) {
+                        edge.resources.push_back(a.resourceId);
+                    }
+                }
+            };
+            addShared(producer.getDeclaredOutputs(), consumer.getDeclaredInputs());
+            addShared(producer.getDeclaredOutputs(), consumer.getDeclaredOutputs());
+            addShared(producer.getDeclaredInputs(), consumer.getDeclaredOutputs());
+        }
+    }
+    
+    auto addBarriers = [&schedule](const FrameGraphExecution::NodeBarrierInfo& batch, bool release) {
+        for (size_t i = 0; i < batch.bufferBarriers.size(); ++i) {
+            const auto& barrier = batch.bufferBarriers[i];
+            FrameGraphScheduleExport::ScheduleBarrier& entry = schedule.barriers.emplace_back();
+            entry.target = batch.targetNodeId;
+            entry.signal = batch.signalNodeId;
+            entry.release = release;
+            entry.resource = i < batch.bufferResourceIds.size() ? batch.bufferResourceIds[i] : 0;
+            entry.srcStages = barrier.srcStageMask;
+            entry.srcAccess = barrier.srcAccessMask;
+            entry.dstStages = barrier.dstStageMask;
+            entry.dstAccess = barrier.dstAccessMask;
+            entry.srcQueueFamily = barrier.srcQueueFamilyIndex;
+            entry.dstQueueFamily = barrier.dstQueueFamilyIndex;
+        }
+        for (size_t i = 0; i < batch.imageBarriers.size(); ++i) {
+            const auto& barrier = batch.imageBarriers[i];
+            FrameGraphScheduleExport::ScheduleBarrier& entry = schedule.barriers.emplace_back();
+            entry.target = batch.targetNodeId;
+            entry.signal = batch.signalNodeId;
+            entry.release = release;
+            entry.resource = i < batch.imageResourceIds.size() ? batch.imageResourceIds[i] : 0;
+            entry.isImage = true;
+            entry.srcStages = barrier.srcStageMask;
+            entry.srcAccess = barrier.srcAccessMask;
+            entry.dstStages = barrier.dstStageMask;
+            entry.dstAccess = barrier.dstAccessMask;
+            entry.srcQueueFamily = barrier.srcQueueFamilyIndex;
+            entry.dstQueueFamily = barrier.dstQueueFamilyIndex;
+            entry.oldLayout = barrier.oldLayout;
+            entry.newLayout = barrier.newLayout;
+        }
+    };
+    for (const auto& batch : barrierSchedule.batches) addBarriers(batch, false);
+    for (const auto& batch : barrierSchedule.releases) addBarriers(batch, true);
+    
+    FrameGraphScheduleExport::markCriticalPath(schedule);
+    return schedule;
+}
+
 void FrameGraph::logAllocationTelemetry() const {
     resourceManager_.logAllocationTelemetry();
 }
@@ -142,11 +318,21 @@ bool FrameGraph::compile() {
         std::cout << "FrameGraph compilation #" << compileCount << std::endl;
     }
     
+    // Same topology as the last compile: the order and barrier analysis still hold, only handles may have moved
+    captureNodeDependencies();
+    const uint64_t topologyHash = computeTopologyHash();
+    if (compiled_ && topologyHash == compiledTopologyHash_) {
+        barrierManager_.rebindResources();
+        invalidateRecordedCommands();
+        return true;
+    }
+    
     // Backup current state for transactional compilation
     compiler_.backupState(executionOrder_, compiled_);
     
     // Clear current compilation state
     executionOrder_.clear();
+    executionLevels_.clear();
     barrierManager_.reset();
     compiled_ = false;
     
@@ -188,10 +374,19 @@ bool FrameGraph::compile() {
             std::cerr << "- Skipping " << partialResult.problematicNodes.size() << " problematic nodes" << std::endl;
             
             executionOrder_ = partialResult.validNodes;
+            compiler_.assignExecutionLevels(nodes_, executionOrder_, executionLevels_);
+            if (!compiler_.partitionQueues(nodes_, executionOrder_, queuePartition_) || !placeTransientResources()) {
+                compiler_.restoreState(executionOrder_, compiled_);
+                compiler_.assignExecutionLevels(nodes_, executionOrder_, executionLevels_);
+                compiler_.partitionQueues(nodes_, executionOrder_, queuePartition_);
+                return false;
+            }
             
             // Analyze and create barriers for valid subgraph
             barrierManager_.analyzeBarrierRequirements(executionOrder_, nodes_);
-            barrierManager_.createOptimalBarrierBatches(executionOrder_, nodes_);
+            barrierManager_.createOptimalBarrierBatches(executionOrder_, nodes_, executionLevels_);
+            nodeProfiler_.assignNodes(executionOrder_, nodes_);
+            breadcrumbs_.assignNodes(executionOrder_, nodes_);
             
             // Initialize valid nodes only with new standardized lifecycle
             for (auto nodeId : executionOrder_) {
@@ -200,23 +395,42 @@ bool FrameGraph::compile() {
                     if (!it->second->initializeNode(*this)) {
                         std::cerr << "FrameGraph: Node initialization failed for node " << nodeId << " in partial compilation" << std::endl;
                         compiler_.restoreState(executionOrder_, compiled_);
+                        compiler_.assignExecutionLevels(nodes_, executionOrder_, executionLevels_);
+                        compiler_.partitionQueues(nodes_, executionOrder_, queuePartition_);
                         return false;
                     }
                 }
             }
             
+            assignParallelRecording();
             compiled_ = true;
+            compiledTopologyHash_ = topologyHash;
+            invalidateRecordedCommands();
             std::cerr << "Partial compilation successful" << std::endl;
             return true;
         }
         
         compiler_.restoreState(executionOrder_, compiled_);
+        compiler_.assignExecutionLevels(nodes_, executionOrder_, executionLevels_);
+        compiler_.partitionQueues(nodes_, executionOrder_, queuePartition_);
+        return false;
+    }
+    
+    // Independent nodes share a level; sorting by level keeps the order topological
+    compiler_.assignExecutionLevels(nodes_, executionOrder_, executionLevels_);
+    if (!compiler_.partitionQueues(nodes_, executionOrder_, queuePartition_)) {
+        std::cerr << "FrameGraph: Compilation failed, the queue streams cannot be ordered" << std::endl;
+        return false;
+    }
+    if (!placeTransientResources()) {
         return false;
     }
     
     // Analyze and create synchronization barriers
     barrierManager_.analyzeBarrierRequirements(executionOrder_, nodes_);
-    barrierManager_.createOptimalBarrierBatches(executionOrder_, nodes_);
+    barrierManager_.createOptimalBarrierBatches(executionOrder_, nodes_, executionLevels_);
+    nodeProfiler_.assignNodes(executionOrder_, nodes_);
+    breadcrumbs_.assignNodes(executionOrder_, nodes_);
     
     // Initialize nodes with standardized lifecycle
     // Lifecycle: initializeNode() once during compilation, then per-frame: prepareFrame() → execute() → releaseFrame()
@@ -230,14 +444,74 @@ bool FrameGraph::compile() {
         }
     }
     
+    assignParallelRecording();
     compiled_ = true;
-    std::cout << "FrameGraph compilation successful (" << executionOrder_.size() << " nodes)" << std::endl;
+    compiledTopologyHash_ = topologyHash;
+    invalidateRecordedCommands();
+    std::cout << "FrameGraph compilation successful (" << executionOrder_.size() << " nodes, "
+              << (executionLevels_.empty() ? 0 : executionLevels_.back() + 1) << " levels)" << std::endl;
     
     return true;
 }
 
+void FrameGraph::captureNodeDependencies() {
+    dependencyArena_.clear();
+    dependencyRanges_.clear();
+    for (const auto& [nodeId, node] : nodes_) {
+        const auto inputs = node->getInputs();
+        const auto outputs = node->getOutputs();
+        dependencyRanges_.push_back(dependencyArena_.size());
+        dependencyArena_.insert(dependencyArena_.end(), inputs.begin(), inputs.end());
+        dependencyRanges_.push_back(dependencyArena_.size());
+        dependencyArena_.insert(dependencyArena_.end(), outputs.begin(), outputs.end());
+        dependencyRanges_.push_back(dependencyArena_.size());
+    }
+    
+    // Spans are handed out once the arena stops growing; unordered_map iteration repeats without modification
+    const ResourceDependency* arena = dependencyArena_.data();
+    size_t range = 0;
+    for (auto& [nodeId, node] : nodes_) {
+        const size_t inputBegin = dependencyRanges_[range];
+        const size_t outputBegin = dependencyRanges_[range + 1];
+        const size_t end = dependencyRanges_[range + 2];
+        node->declaredInputs = {arena + inputBegin, outputBegin - inputBegin};
+        node->declaredOutputs = {arena + outputBegin, end - outputBegin};
+        range += 3;
+    }
+}
 
-FrameGraph::ExecutionResult FrameGraph::execute(uint32_t frameIndex, float time, float deltaTime, uint32_t globalFrame) {
+uint64_t FrameGraph::computeTopologyHash() const {
+    // Sorted by id so the hash does not depend on unordered_map iteration order
+    std::vector<FrameGraphTypes::NodeId> nodeIds;
+    nodeIds.reserve(nodes_.size());
+    for (const auto& [nodeId, node] : nodes_) {
+        nodeIds.push_back(nodeId);
+    }
+    std::sort(nodeIds.begin(), nodeIds.end());
+    
+    VulkanHash::HashCombiner hash;
+    auto combineDependencies = [&hash](std::span<const ResourceDependency> dependencies) {
+        hash.combine(dependencies.size());
+        for (const auto& dependency : dependencies) {
+            hash.combine(dependency.resourceId)
+                .combine(static_cast<uint32_t>(dependency.access))
+                .combine(static_cast<uint32_t>(dependency.stage))
+                .combine(dependency.offset)
+                .combine(dependency.size);
+        }
+    };
+    for (auto nodeId : nodeIds) {
+        const auto& node = nodes_.at(nodeId);
+        hash.combine(nodeId).combine(node->getName())
+            .combine(node->needsComputeQueue()).combine(node->needsGraphicsQueue());
+        combineDependencies(node->getDeclaredInputs());
+        combineDependencies(node->getDeclaredOutputs());
+    }
+    return hash.get();
+}
+
+FrameGraph::ExecutionResult FrameGraph::executeCompute(uint32_t frameIndex, float time, float deltaTime, uint32_t globalFrame) {
+    PROFILE_SCOPE("Frame Graph Compute Recording");
     ExecutionResult result;
     if (!compiled_) {
         std::cerr << "FrameGraph: Cannot execute, not compiled" << std::endl;
@@ -262,34 +536,73 @@ FrameGraph::ExecutionResult FrameGraph::execute(uint32_t frameIndex, float time,
         }
     }
     
+    // This slot's previous submission has completed, so its node timestamps are ready to read
+    nodeProfiler_.collect(frameIndex);
+    if (timeoutDetector_) {
+        timeoutDetector_->beginFrame(frameIndex);
+    }
+    
+    // Disabled nodes drop out of this frame's recording and barrier schedule
+    FrameContext frameContext;
+    frameContext.frameIndex = frameIndex;
+    frameContext.globalFrame = globalFrame;
+    frameContext.time = time;
+    frameContext.deltaTime = deltaTime;
+    frameContext.simulation = simulationStep_;
+    frameContext.presenting = presenting_;
+    evaluateNodePredicates(frameContext);
+    
     // Analyze which command buffers we'll need
     auto [computeNeeded, graphicsNeeded] = analyzeQueueRequirements();
     result.computeCommandBufferUsed = computeNeeded;
     result.graphicsCommandBufferUsed = graphicsNeeded;
+    resolveQueueSync(result);
     
-    // Begin only the command buffers that will be used
-    beginCommandBuffers(computeNeeded, graphicsNeeded, frameIndex);
+    // Compute is recorded every frame; the graphics queue is recorded or replayed by recordGraphics()
+    VkCommandBuffer computeCmd = queueManager_->getComputeCommandBuffer(frameIndex);
+    if (computeNeeded) {
+        beginCommandBuffer(computeCmd);
+        result.computeCommandBuffer = computeCmd;
+    }
     
     // Execute nodes with timeout monitoring if available
     bool computeExecuted = false;
+    bool timedOut = false;
     if (timeoutDetector_) {
-        if (!executeWithTimeoutMonitoring(frameIndex, time, deltaTime, globalFrame, computeExecuted)) {
-            // Timeout occurred, end command buffers and return early
-            endCommandBuffers(computeNeeded, graphicsNeeded, frameIndex);
-            handleExecutionTimeout();
-            return result;
-        }
+        timedOut = !executeWithTimeoutMonitoring(frameIndex, time, deltaTime, globalFrame, computeExecuted);
     } else {
         executeNodesInOrder(frameIndex, time, deltaTime, globalFrame, computeExecuted);
     }
     
-    // End only the command buffers that were begun
-    endCommandBuffers(computeNeeded, graphicsNeeded, frameIndex);
+    if (computeNeeded) {
+        endCommandBuffer(computeCmd);
+    }
     
-    // Frame graph complete - command buffers are ready for submission by VulkanRenderer
+    if (timedOut) {
+        handleExecutionTimeout();
+    }
     return result;
 }
 
+void FrameGraph::recordGraphics(uint32_t frameIndex, float time, float deltaTime, ExecutionResult& result) {
+    if (!result.graphicsCommandBufferUsed) {
+        return;
+    }
+    PROFILE_SCOPE("Frame Graph Graphics Recording");
+    
+    // Prepared only now, as this is where graphics nodes resolve the acquired image's framebuffer. Still
+    // recorded after a compute timeout so that image is presented
+    for (size_t i = 0; i < executionOrder_.size(); ++i) {
+        auto it = nodes_.find(executionOrder_[i]);
+        if (it != nodes_.end() && nodeEnabled_[i] && !it->second->needsComputeQueue()) {
+            it->second->prepareFrame(frameIndex, time, deltaTime);
+        }
+    }
+    
+    // Frame graph complete - command buffers are ready for submission by VulkanRenderer
+    result.graphicsCommandBuffer = recordGraphicsQueue(frameIndex, result.graphicsRecordingReused);
+}
+
 void FrameGraph::reset() {
     resourceManager_.reset();
     
@@ -304,140 +617,434 @@ void FrameGraph::reset() {
 
 void FrameGraph::removeSwapchainResources() {
     resourceManager_.removeSwapchainResources();
+    invalidateRecordedCommands();
+}
+
+void FrameGraph::setSwapchainImage(uint32_t imageIndex, uint32_t imageCount) {
+    swapchainImageIndex_ = imageIndex;
+    if (imageCount != swapchainImageCount_) {
+        swapchainImageCount_ = imageCount;
+        invalidateRecordedCommands();
+    }
+}
+
+void FrameGraph::logRecordingTelemetry() const {
+    const auto& t = recordingTelemetry_;
+    std::cout << "FrameGraph: Graphics recordings replayed " << t.graphicsReused << " / "
+              << (t.graphicsReused + t.graphicsRecorded) << " frames, compute nodes recorded on lanes "
+              << t.computeNodesOnLanes << ", node executions disabled " << t.nodesDisabled << std::endl;
+}
+
+void FrameGraph::invalidateRecordedCommands() {
+    for (auto& recording : graphicsRecordings_) {
+        recording.nodeKeys.clear();
+        recording.valid = false;
+    }
 }
 
 // Private helper methods
 
+void FrameGraph::evaluateNodePredicates(const FrameContext& frameContext) {
+    nodeEnabled_.assign(executionOrder_.size(), true);
+    for (size_t i = 0; i < executionOrder_.size(); ++i) {
+        auto it = nodes_.find(executionOrder_[i]);
+        if (it != nodes_.end() && ((!frameContext.presenting && !it->second->needsComputeQueue()) ||
+                                   !it->second->isEnabled(frameContext))) {
+            nodeEnabled_[i] = false;
+            ++recordingTelemetry_.nodesDisabled;
+        }
+    }
+    barrierManager_.selectSchedule(nodeEnabled_);
+}
+
 std::pair<bool, bool> FrameGraph::analyzeQueueRequirements() const {
     bool computeNeeded = false;
     bool graphicsNeeded = false;
     
-    for (auto nodeId : executionOrder_) {
-        auto it = nodes_.find(nodeId);
+    // Compute is recorded every frame it has nodes; a graphics stream whose nodes are all disabled records and
+    // submits nothing
+    using FrameGraphCompilation::QueueStream;
+    if (queuePartition_.streamAt.size() == executionOrder_.size()) {
+        const auto& graphicsStream = queuePartition_.streams[static_cast<uint32_t>(QueueStream::Graphics)];
+        computeNeeded = !queuePartition_.streams[static_cast<uint32_t>(QueueStream::Compute)].empty();
+        graphicsNeeded = std::any_of(graphicsStream.begin(), graphicsStream.end(),
+                                     [this](uint32_t position) { return nodeEnabled_[position]; });
+        return {computeNeeded, graphicsNeeded};
+    }
+    
+    // Restored order without a partition
+    for (size_t i = 0; i < executionOrder_.size(); ++i) {
+        auto it = nodes_.find(executionOrder_[i]);
         if (it != nodes_.end()) {
             if (it->second->needsComputeQueue()) computeNeeded = true;
-            if (it->second->needsGraphicsQueue()) graphicsNeeded = true;
+            if (it->second->needsGraphicsQueue() && nodeEnabled_[i]) graphicsNeeded = true;
         }
     }
     
     return {computeNeeded, graphicsNeeded};
 }
 
-void FrameGraph::beginCommandBuffers(bool useCompute, bool useGraphics, uint32_t frameIndex) {
-    const auto& vk = context_->getLoader();
+void FrameGraph::resolveQueueSync(ExecutionResult& result) const {
+    using FrameGraphCompilation::QueueStream;
+    const FrameGraphCompilation::QueueSyncPoint* syncPoint = queuePartition_.find(QueueStream::Compute, QueueStream::Graphics);
+    if (queuePartition_.streamAt.size() != executionOrder_.size()) {
+        // Restored order without a partition: wait as if every graphics node read compute output
+        result.graphicsWaitsOnCompute = result.computeCommandBufferUsed;
+        result.graphicsComputeWaitStages = VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR;
+        return;
+    }
+    if (!syncPoint) return;
+    
+    // Edges whose ends both run this frame form the cut the semaphore covers
+    for (const auto& edge : syncPoint->edges) {
+        if (nodeEnabled_[edge.producerPosition] && nodeEnabled_[edge.consumerPosition]) {
+            result.graphicsWaitsOnCompute = true;
+            result.graphicsComputeWaitStages |= barrierManager_.convertPipelineStage(edge.consumerStage);
+        }
+    }
     
+    // Vertex-stage reads include the indirect draw arguments, which declarations do not tell apart
+    if (result.graphicsComputeWaitStages & VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR) {
+        result.graphicsComputeWaitStages |= VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR;
+    }
+}
+
+void FrameGraph::beginCommandBuffer(VkCommandBuffer commandBuffer) {
     VkCommandBufferBeginInfo beginInfo{};
     beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    context_->getLoader().vkBeginCommandBuffer(commandBuffer, &beginInfo);
+}
+
+void FrameGraph::endCommandBuffer(VkCommandBuffer commandBuffer) {
+    context_->getLoader().vkEndCommandBuffer(commandBuffer);
+}
+
+void FrameGraph::executeNodesInOrder(uint32_t frameIndex, float time, float deltaTime, uint32_t globalFrame, bool& computeExecuted) {
+    VkCommandBuffer currentComputeCmd = queueManager_->getComputeCommandBuffer(frameIndex);
     
-    if (useCompute) {
-        VkCommandBuffer computeCmd = queueManager_->getComputeCommandBuffer(frameIndex);
-        vk.vkBeginCommandBuffer(computeCmd, &beginInfo);
+    // Without levels (restored state mismatch) every node is its own level and records inline
+    const bool levelsValid = executionLevels_.size() == executionOrder_.size();
+    for (size_t begin = 0; begin < executionOrder_.size();) {
+        size_t end = begin + 1;
+        while (levelsValid && end < executionOrder_.size() && executionLevels_[end] == executionLevels_[begin]) {
+            ++end;
+        }
+        executeLevel(begin, end, frameIndex, time, deltaTime, currentComputeCmd, computeExecuted);
+        begin = end;
     }
-    if (useGraphics) {
-        VkCommandBuffer graphicsCmd = queueManager_->getGraphicsCommandBuffer(frameIndex);
-        vk.vkBeginCommandBuffer(graphicsCmd, &beginInfo);
+}
+
+bool FrameGraph::placeTransientResources() {
+    std::vector<FrameGraphTypes::ResourceId> aliasedResources;
+    auto lifetimes = compiler_.computeResourceLifetimes(nodes_, executionOrder_);
+    if (!resourceManager_.placeTransientResources(lifetimes, aliasedResources)) {
+        std::cerr << "FrameGraph: Failed to place transient resources" << std::endl;
+        return false;
     }
+    barrierManager_.createAliasingBarriers(executionOrder_, nodes_, aliasedResources);
+    return true;
 }
 
-void FrameGraph::endCommandBuffers(bool useCompute, bool useGraphics, uint32_t frameIndex) {
-    const auto& vk = context_->getLoader();
-    
-    if (useCompute) {
-        VkCommandBuffer computeCmd = queueManager_->getComputeCommandBuffer(frameIndex);
-        vk.vkEndCommandBuffer(computeCmd);
+void FrameGraph::assignParallelRecording() {
+    const uint32_t laneCount = parallelRecorder_.getLaneCount();
+    if (laneCount < 2 || executionLevels_.size() != executionOrder_.size()) {
+        return;
     }
-    if (useGraphics) {
-        VkCommandBuffer graphicsCmd = queueManager_->getGraphicsCommandBuffer(frameIndex);
-        vk.vkEndCommandBuffer(graphicsCmd);
+    const uint32_t framesInFlight = context_->getFramesInFlight();
+    
+    for (size_t begin = 0; begin < executionOrder_.size();) {
+        size_t end = begin;
+        uint32_t nextLane = 0;
+        std::vector<FrameGraphTypes::NodeId> candidates;
+        for (; end < executionOrder_.size() && executionLevels_[end] == executionLevels_[begin]; ++end) {
+            auto it = nodes_.find(executionOrder_[end]);
+            if (it != nodes_.end() && it->second->needsComputeQueue() && it->second->supportsParallelRecording()) {
+                candidates.push_back(executionOrder_[end]);
+            }
+        }
+        begin = end;
+        if (candidates.size() < 2) continue;
+        
+        // Slots survive recompilation: their secondaries may still be pending on the GPU, so they are
+        // never freed or moved to another lane, only added for nodes that newly share a level
+        for (FrameGraphTypes::NodeId nodeId : candidates) {
+            const uint32_t lane = nextLane++ % laneCount;
+            if (parallelSlots_.count(nodeId)) continue;
+            
+            ParallelRecordingSlot slot;
+            slot.lane = lane;
+            for (uint32_t frame = 0; frame < framesInFlight; ++frame) {
+                VkCommandBuffer secondary = queueManager_->allocateRecordingCommandBuffer(lane, frame);
+                if (secondary == VK_NULL_HANDLE) break;
+                slot.secondaries.push_back(secondary);
+            }
+            if (slot.secondaries.size() != framesInFlight) {
+                std::cerr << "FrameGraph: Recording node " << nodeId << " inline, secondary allocation failed" << std::endl;
+                continue;
+            }
+            parallelSlots_.emplace(nodeId, std::move(slot));
+        }
     }
 }
 
-void FrameGraph::executeNodesInOrder(uint32_t frameIndex, float time, float deltaTime, uint32_t globalFrame, bool& computeExecuted) {
-    VkCommandBuffer currentComputeCmd = queueManager_->getComputeCommandBuffer(frameIndex);
-    VkCommandBuffer currentGraphicsCmd = queueManager_->getGraphicsCommandBuffer(frameIndex);
+void FrameGraph::executeLevel(size_t begin, size_t end, uint32_t frameIndex, float time, float deltaTime,
+                              VkCommandBuffer computeCmd, bool& computeExecuted) {
+    // Nodes of one level are independent, so everything they wait on goes out in one batch up front
+    levelComputeNodeIds_.clear();
+    for (size_t i = begin; i < end; ++i) {
+        auto it = nodes_.find(executionOrder_[i]);
+        if (it != nodes_.end() && nodeEnabled_[i] && it->second->needsComputeQueue()) {
+            levelComputeNodeIds_.push_back(executionOrder_[i]);
+        }
+    }
+    barrierManager_.insertBarriersForNodes(levelComputeNodeIds_.data(), levelComputeNodeIds_.size(), computeCmd, frameIndex);
     
-    for (auto nodeId : executionOrder_) {
-        auto it = nodes_.find(nodeId);
-        if (it == nodes_.end()) continue;
+    // Inline nodes run first on this thread; they may mutate shared state (staging, commits) the lanes read
+    levelParallelNodes_.clear();
+    for (size_t i = begin; i < end; ++i) {
+        auto it = nodes_.find(executionOrder_[i]);
+        if (it == nodes_.end() || !nodeEnabled_[i]) continue;
         
         auto& node = it->second;
+        if (node->needsComputeQueue() && node->supportsParallelRecording() && parallelSlots_.count(executionOrder_[i])) {
+            levelParallelNodes_.push_back(node.get());
+            continue;
+        }
+        
+        // Graphics nodes are prepared and execute in recordGraphics()
+        if (!node->needsComputeQueue()) {
+            continue;
+        }
         
         // Prepare frame with new standardized lifecycle
         node->prepareFrame(frameIndex, time, deltaTime);
+        computeExecuted = true;
+        recordNode(executionOrder_[i], *node, computeCmd, frameIndex);
         
-        // Insert barriers for this node using the barrier manager
-        barrierManager_.insertBarriersForNode(nodeId, currentGraphicsCmd, computeExecuted, node->needsGraphicsQueue());
+        // Release frame with new standardized lifecycle
+        node->releaseFrame(frameIndex);
+    }
+    
+    if (levelParallelNodes_.empty()) {
+        return;
+    }
+    
+    // prepareFrame() stays on this thread - it is where parallel nodes resolve pipelines from shared caches
+    for (FrameGraphNode* node : levelParallelNodes_) {
+        node->prepareFrame(frameIndex, time, deltaTime);
+    }
+    computeExecuted = true;
+    
+    const bool fanOut = levelParallelNodes_.size() > 1 && frameIndex < context_->getFramesInFlight();
+    if (!fanOut) {
+        for (FrameGraphNode* node : levelParallelNodes_) {
+            recordNode(node->getId(), *node, computeCmd, frameIndex);
+            node->releaseFrame(frameIndex);
+        }
+        return;
+    }
+    
+    laneJobs_.resize(parallelRecorder_.getLaneCount());
+    for (auto& jobs : laneJobs_) {
+        jobs.clear();
+    }
+    levelSecondaries_.clear();
+    levelFrameIndex_ = frameIndex;
+    for (size_t i = 0; i < levelParallelNodes_.size(); ++i) {
+        const ParallelRecordingSlot& slot = parallelSlots_.at(levelParallelNodes_[i]->getId());
+        levelSecondaries_.push_back(slot.secondaries[frameIndex]);
+        laneJobs_[slot.lane].push_back([this, i]() {
+            recordSecondary(levelParallelNodes_[i], levelSecondaries_[i], levelFrameIndex_);
+        });
+    }
+    
+    parallelRecorder_.run(laneJobs_);
+    
+    // Stitched in execution order, so the GPU sees the same command stream as inline recording
+    context_->getLoader().vkCmdExecuteCommands(
+        computeCmd, static_cast<uint32_t>(levelSecondaries_.size()), levelSecondaries_.data());
+    
+    for (FrameGraphNode* node : levelParallelNodes_) {
+        node->releaseFrame(frameIndex);
+    }
+    recordingTelemetry_.computeNodesOnLanes += levelParallelNodes_.size();
+}
+
+void FrameGraph::recordSecondary(FrameGraphNode* node, VkCommandBuffer secondary, uint32_t frameIndex) {
+    // Compute secondaries inherit no render pass, but the inheritance info is still mandatory
+    VkCommandBufferInheritanceInfo inheritanceInfo{};
+    inheritanceInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_INHERITANCE_INFO;
+    
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    beginInfo.pInheritanceInfo = &inheritanceInfo;
+    
+    const auto& vk = context_->getLoader();
+    vk.vkBeginCommandBuffer(secondary, &beginInfo);
+    recordNode(node->getId(), *node, secondary, frameIndex);
+    vk.vkEndCommandBuffer(secondary);
+}
+
+void FrameGraph::recordNode(FrameGraphTypes::NodeId nodeId, FrameGraphNode& node, VkCommandBuffer commandBuffer, uint32_t frameIndex) {
+    // getName() builds a string, so release builds skip the call along with the label
+    if constexpr (VULKAN_DEBUG_LABELS_ENABLED) {
+        VulkanDebugLabels::beginLabel(*context_, commandBuffer, node.getName());
+    }
+    const auto queue = node.needsComputeQueue() ? FrameGraphExecution::GpuBreadcrumbs::Queue::Compute
+                                                : FrameGraphExecution::GpuBreadcrumbs::Queue::Graphics;
+    nodeProfiler_.beginNode(nodeId, commandBuffer, frameIndex);
+    breadcrumbs_.beginNode(nodeId, queue, commandBuffer);
+    barrierManager_.insertAliasingBarrier(nodeId, commandBuffer);
+    node.execute(commandBuffer, *this);
+    barrierManager_.signalAfterNode(nodeId, commandBuffer, frameIndex);
+    breadcrumbs_.endNode(nodeId, queue, commandBuffer);
+    nodeProfiler_.endNode(nodeId, commandBuffer, frameIndex);
+    VulkanDebugLabels::endLabel(*context_, commandBuffer);
+}
+
+VkCommandBuffer FrameGraph::selectGraphicsCommandBuffer(uint32_t frameIndex, RecordedCommands*& recording) {
+    recording = nullptr;
+    if constexpr (!ENABLE_RECORDED_COMMAND_REUSE) {
+        return queueManager_->getGraphicsCommandBuffer(frameIndex);
+    }
+    
+    // Falls back to the per-frame buffer (never replayed) until the director has reported a swapchain image
+    if (swapchainImageCount_ == 0 || !queueManager_->allocateRecordedGraphicsCommandBuffers(swapchainImageCount_)) {
+        return queueManager_->getGraphicsCommandBuffer(frameIndex);
+    }
+    
+    VkCommandBuffer commandBuffer = queueManager_->getRecordedGraphicsCommandBuffer(frameIndex, swapchainImageIndex_);
+    if (commandBuffer == VK_NULL_HANDLE) {
+        return queueManager_->getGraphicsCommandBuffer(frameIndex);
+    }
+    
+    const size_t recordingCount = static_cast<size_t>(context_->getFramesInFlight()) * swapchainImageCount_;
+    if (graphicsRecordings_.size() != recordingCount) {
+        graphicsRecordings_.assign(recordingCount, RecordedCommands{});
+    }
+    recording = &graphicsRecordings_[static_cast<size_t>(frameIndex) * swapchainImageCount_ + swapchainImageIndex_];
+    return commandBuffer;
+}
+
+VkCommandBuffer FrameGraph::recordGraphicsQueue(uint32_t frameIndex, bool& reused) {
+    reused = false;
+    RecordedCommands* recording = nullptr;
+    VkCommandBuffer graphicsCmd = selectGraphicsCommandBuffer(frameIndex, recording);
+    
+    // Keys are read after prepareFrame(), which is where cacheable nodes resolve everything they record
+    graphicsNodeKeys_.clear();
+    bool cacheable = recording != nullptr;
+    for (size_t i = 0; i < executionOrder_.size(); ++i) {
+        auto it = nodes_.find(executionOrder_[i]);
+        if (it == nodes_.end() || !nodeEnabled_[i] || it->second->needsComputeQueue()) continue;
         
-        VkCommandBuffer cmdBuffer = node->needsComputeQueue() ? currentComputeCmd : currentGraphicsCmd;
+        const uint64_t key = it->second->getRecordingKey();
+        cacheable = cacheable && key != FrameGraphNode::UNCACHEABLE_RECORDING;
+        graphicsNodeKeys_.push_back(key);
+    }
+    
+    // The enabled set picks the barrier schedule, which the graphics recording bakes in as well
+    uint64_t enabledBits = 0;
+    for (size_t i = 0; i < nodeEnabled_.size(); ++i) {
+        enabledBits |= static_cast<uint64_t>(nodeEnabled_[i]) << (i % 64);
+        if (i % 64 == 63 || i + 1 == nodeEnabled_.size()) {
+            graphicsNodeKeys_.push_back(enabledBits);
+            enabledBits = 0;
+        }
+    }
+    graphicsNodeKeys_.push_back(barrierManager_.getCrossFrameRecordingKey());
+    
+    // This slot's fence has signalled, so the recording is no longer pending and may be submitted again
+    if (cacheable && recording->valid && recording->nodeKeys == graphicsNodeKeys_) {
+        for (size_t i = 0; i < executionOrder_.size(); ++i) {
+            auto it = nodes_.find(executionOrder_[i]);
+            if (it == nodes_.end() || !nodeEnabled_[i] || it->second->needsComputeQueue()) continue;
+            nodeProfiler_.markReplayed(executionOrder_[i], frameIndex);
+            it->second->releaseFrame(frameIndex);
+        }
+        ++recordingTelemetry_.graphicsReused;
+        reused = true;
+        return graphicsCmd;
+    }
+    
+    beginCommandBuffer(graphicsCmd);
+    
+    for (size_t i = 0; i < executionOrder_.size(); ++i) {
+        const FrameGraphTypes::NodeId nodeId = executionOrder_[i];
+        auto it = nodes_.find(nodeId);
+        if (it == nodes_.end() || !nodeEnabled_[i]) continue;
         
+        auto& node = it->second;
         if (node->needsComputeQueue()) {
-            computeExecuted = true;
+            continue;
         }
         
-        node->execute(cmdBuffer, *this);
+        // Compute consumers got theirs in the compute buffer; replays reuse these along with the events
+        barrierManager_.insertBarriersForNode(nodeId, graphicsCmd, frameIndex);
+        recordNode(nodeId, *node, graphicsCmd, frameIndex);
         
         // Release frame with new standardized lifecycle
         node->releaseFrame(frameIndex);
     }
+    
+    endCommandBuffer(graphicsCmd);
+    ++recordingTelemetry_.graphicsRecorded;
+    
+    if (recording) {
+        recording->nodeKeys = graphicsNodeKeys_;
+        recording->valid = cacheable;
+    }
+    return graphicsCmd;
 }
 
 bool FrameGraph::executeWithTimeoutMonitoring(uint32_t frameIndex, float time, float deltaTime, uint32_t globalFrame, bool& computeExecuted) {
     VkCommandBuffer currentComputeCmd = queueManager_->getComputeCommandBuffer(frameIndex);
-    VkCommandBuffer currentGraphicsCmd = queueManager_->getGraphicsCommandBuffer(frameIndex);
+    bool healthy = true;
     
-    for (auto nodeId : executionOrder_) {
+    for (size_t i = 0; i < executionOrder_.size(); ++i) {
+        const FrameGraphTypes::NodeId nodeId = executionOrder_[i];
         auto it = nodes_.find(nodeId);
-        if (it == nodes_.end()) continue;
+        if (it == nodes_.end() || !nodeEnabled_[i]) continue;
         
         auto& node = it->second;
-        
-        // Check GPU health before executing
-        if (!timeoutDetector_->isGPUHealthy()) {
-            std::cerr << "[FrameGraph] GPU unhealthy, aborting execution" << std::endl;
-            return false;
+        if (!node->needsComputeQueue()) {
+            continue;
         }
         
         // Prepare frame with new standardized lifecycle
         node->prepareFrame(frameIndex, time, deltaTime);
         
-        // Insert barriers for this node using the barrier manager
-        barrierManager_.insertBarriersForNode(nodeId, currentGraphicsCmd, computeExecuted, node->needsGraphicsQueue());
-        
-        VkCommandBuffer cmdBuffer = node->needsComputeQueue() ? currentComputeCmd : currentGraphicsCmd;
+        // Check GPU health before executing
+        if (healthy && !timeoutDetector_->isGPUHealthy()) {
+            std::cerr << "[FrameGraph] GPU unhealthy, aborting execution" << std::endl;
+            healthy = false;
+        }
         
-        // Begin timeout monitoring for this node
-        std::string nodeName = node->getName() + "_FrameGraph";
-        if (node->needsComputeQueue()) {
-            timeoutDetector_->beginComputeDispatch(nodeName.c_str(), 1); // Generic workgroup count
-            computeExecuted = true;
+        // Skipped nodes still consume their split barrier waits, so no event stays set into the next frame
+        if (!healthy) {
+            barrierManager_.insertBarriersForNode(nodeId, currentComputeCmd, frameIndex);
+            continue;
         }
         
-        // Execute the node
-        node->execute(cmdBuffer, *this);
+        // Node GPU time comes from nodeProfiler_; the detector times the dispatches nodes record
+        computeExecuted = true;
         
-        // End timeout monitoring
-        if (node->needsComputeQueue()) {
-            timeoutDetector_->endComputeDispatch();
-            
-            // Check if we need to apply recovery recommendations
-            auto recommendation = timeoutDetector_->getRecoveryRecommendation();
-            if (recommendation.shouldReduceWorkload) {
-                std::cout << "[FrameGraph] Applying timeout recovery recommendations" << std::endl;
-                // Future: Could implement workload reduction at frame graph level
-            }
-        }
+        // Execute the node
+        barrierManager_.insertBarriersForNode(nodeId, currentComputeCmd, frameIndex);
+        recordNode(nodeId, *node, currentComputeCmd, frameIndex);
         
         // Final health check after node execution
         if (!timeoutDetector_->isGPUHealthy()) {
             std::cerr << "[FrameGraph] GPU became unhealthy after node execution" << std::endl;
-            return false;
+            healthy = false;
         }
         
         // Release frame with new standardized lifecycle
         node->releaseFrame(frameIndex);
     }
     
-    return true;
+    return healthy;
 }
 
 void FrameGraph::handleExecutionTimeout() {
@@ -4,6 +4,7 @@
 #include <vulkan/vulkan.h>
 #include <vector>
 #include <memory>
+#include <memory_resource>
 #include <string>
 #include <unordered_map>
 #include <functional>
@@ -13,6 +14,11 @@
 #include "resources/resource_manager.h"
 #include "compilation/frame_graph_compiler.h"
 #include "execution/barrier_manager.h"
+#include "execution/parallel_recorder.h"
+#include "execution/node_timestamp_profiler.h"
+#include "execution/gpu_breadcrumbs.h"
+#include "frame_graph_schedule_export.h"
+#include "../../ecs/utilities/memory_tags.h"
 
 // Forward declarations
 class VulkanContext;
@@ -39,13 +45,20 @@ public:
     
     // Optional monitoring integration
     void setMemoryMonitor(GPUMemoryMonitor* monitor);
+    void setMemoryAllocator(MemoryAllocator* allocator);
     void setTimeoutDetector(GPUTimeoutDetector* detector) { timeoutDetector_ = detector; }
     
     // Resource management (delegated to ResourceManager)
     FrameGraphTypes::ResourceId createBuffer(const std::string& name, VkDeviceSize size, VkBufferUsageFlags usage);
     FrameGraphTypes::ResourceId createImage(const std::string& name, VkFormat format, VkExtent2D extent, VkImageUsageFlags usage);
+    
+    // Transient resources get memory at compile(), shared with transients whose lifetimes in the execution
+    // order do not overlap; contents are undefined at each frame's first use
+    FrameGraphTypes::ResourceId createTransientBuffer(const std::string& name, VkDeviceSize size, VkBufferUsageFlags usage);
+    FrameGraphTypes::ResourceId createTransientImage(const std::string& name, VkFormat format, VkExtent2D extent, VkImageUsageFlags usage);
     FrameGraphTypes::ResourceId importExternalBuffer(const std::string& name, VkBuffer buffer, VkDeviceSize size, VkBufferUsageFlags usage);
     FrameGraphTypes::ResourceId importExternalImage(const std::string& name, VkImage image, VkImageView view, VkFormat format, VkExtent2D extent);
+    bool updateExternalBuffer(FrameGraphTypes::ResourceId id, VkBuffer buffer, VkDeviceSize size);
     
     // Node management
     template<typename NodeType, typename... Args>
@@ -67,7 +80,9 @@ public:
         return nullptr;
     }
     
-    // Graph compilation and execution
+    // Graph compilation and execution. Recompiling a compiled graph whose topology hash (node ids and names,
+    // queues, declared accesses) is unchanged keeps the execution order and barrier schedules and only
+    // rebinds external resource handles
     bool compile();
     bool isCompiled() const { return compiled_; }
     
@@ -75,11 +90,40 @@ public:
     struct ExecutionResult {
         bool computeCommandBufferUsed = false;
         bool graphicsCommandBufferUsed = false;
+        
+        // Command buffers to submit; the graphics one may be a replayed recording from an earlier frame
+        VkCommandBuffer computeCommandBuffer = VK_NULL_HANDLE;
+        VkCommandBuffer graphicsCommandBuffer = VK_NULL_HANDLE;
+        bool graphicsRecordingReused = false;
+        
+        // The compute-to-graphics sync point for this frame's enabled nodes: whether a graphics node consumes
+        // this frame's compute output, and the stages its consumers first need it at
+        bool graphicsWaitsOnCompute = false;
+        VkPipelineStageFlags2KHR graphicsComputeWaitStages = 0;
     };
-    ExecutionResult execute(uint32_t frameIndex, float time, float deltaTime, uint32_t globalFrame);
+    // A frame runs in two phases so the swapchain image is acquired as late as possible: executeCompute()
+    // prepares and records the compute nodes, recordGraphics() then prepares and records (or replays) the
+    // graphics nodes once the director has reported the acquired image. A frame whose image could not be
+    // acquired skips the second phase and submits its compute alone
+    ExecutionResult executeCompute(uint32_t frameIndex, float time, float deltaTime, uint32_t globalFrame);
+    void recordGraphics(uint32_t frameIndex, float time, float deltaTime, ExecutionResult& result);
     void reset(); // Clear for next frame
     void removeSwapchainResources(); // Remove swapchain images during recreation
     
+    // Recorded command reuse (ENABLE_RECORDED_COMMAND_REUSE): graphics recordings are kept per frame slot and
+    // swapchain image, so the director reports which image this frame renders to before recordGraphics()
+    void setSwapchainImage(uint32_t imageIndex, uint32_t imageCount);
+    void invalidateRecordedCommands();  // compile(), external buffer updates and swapchain recreation
+    
+    struct RecordingTelemetry {
+        uint64_t graphicsRecorded = 0;
+        uint64_t graphicsReused = 0;
+        uint64_t computeNodesOnLanes = 0;  // Node recordings into lane secondaries (parallel levels)
+        uint64_t nodesDisabled = 0;        // Node executions skipped by their enable predicate
+    };
+    const RecordingTelemetry& getRecordingTelemetry() const { return recordingTelemetry_; }
+    void logRecordingTelemetry() const;
+    
     // Resource access (delegated to ResourceManager)
     VkBuffer getBuffer(FrameGraphTypes::ResourceId id) const;
     VkImage getImage(FrameGraphTypes::ResourceId id) const;
@@ -88,19 +132,46 @@ public:
     // Debug (delegated to ResourceManager)
     void debugPrint() const;
     
+    // The compiled order, dependency edges and full barrier schedule, annotated with the nodes' GPU timings and
+    // their bytes per entity times entityCount; empty before the first compile. FrameGraphScheduleExport::write
+    // turns it into Graphviz or JSON
+    FrameGraphScheduleExport::Schedule captureSchedule(uint32_t entityCount) const;
+    
     // Performance monitoring (delegated to ResourceManager)
     void logAllocationTelemetry() const;
+    const FrameGraphResources::ResourceManager::TransientTelemetry& getTransientTelemetry() const {
+        return resourceManager_.getTransientTelemetry();
+    }
     
     // Resource management and recovery (delegated to ResourceManager)
     void performResourceCleanup();
     bool isMemoryPressureCritical() const;
     void evictNonCriticalResources();
     
+    // Per-queue streams and their sync points from the last compile
+    const FrameGraphCompilation::QueuePartition& getQueuePartition() const { return queuePartition_; }
+    
     // Context access for nodes
     const VulkanContext* getContext() const { return context_; }
     
+    // Barrier emission for nodes (dispatch-to-dispatch barriers inside a pass, buffers outside the graph)
+    const FrameGraphExecution::BarrierManager& getBarrierManager() const { return barrierManager_; }
+    
+    // GPU execution time per node (ENABLE_GPU_NODE_TIMESTAMPS), measured frames-in-flight frames ago;
+    // nullptr until the node has a sample
+    const FrameGraphExecution::NodeGpuTiming* getNodeGpuTiming(FrameGraphTypes::NodeId nodeId) const { return nodeProfiler_.getTiming(nodeId); }
+    const FrameGraphExecution::NodeTimestampProfiler& getNodeProfiler() const { return nodeProfiler_; }
+    const FrameGraphExecution::GpuBreadcrumbs& getBreadcrumbs() const { return breadcrumbs_; }
+    
     // Global frame counter access for compute shaders (passed as parameter)
     uint32_t getGlobalFrameCounter() const { return currentGlobalFrame_; }
+    
+    // Simulation ticks of the next executeCompute(), set by the director beforehand
+    void setSimulationStep(const SimulationStep& step) { simulationStep_ = step; }
+    const SimulationStep& getSimulationStep() const { return simulationStep_; }
+    
+    // Whether the next frame draws and presents; without it only compute nodes run (FrameContext::presenting)
+    void setPresenting(bool presenting) { presenting_ = presenting; }
 
 private:
     // Core state
@@ -114,24 +185,86 @@ private:
     FrameGraphCompilation::FrameGraphCompiler compiler_;
     FrameGraphExecution::BarrierManager barrierManager_;
     FrameGraphResources::ResourceManager resourceManager_;
+    FrameGraphExecution::NodeTimestampProfiler nodeProfiler_;
+    FrameGraphExecution::GpuBreadcrumbs breadcrumbs_;
     
     // Node storage
     std::unordered_map<FrameGraphTypes::NodeId, std::unique_ptr<FrameGraphNode>> nodes_;
     FrameGraphTypes::NodeId nextNodeId_ = 1;
     
-    // Compiled execution order
+    // Every node's declared inputs then outputs, back to back; nodes hold spans into it until the next capture.
+    // Both charged to MemoryTag::FrameGraph
+    std::pmr::vector<ResourceDependency> dependencyArena_{&MemoryTags::getResource(MemoryTag::FrameGraph)};
+    std::pmr::vector<size_t> dependencyRanges_{&MemoryTags::getResource(MemoryTag::FrameGraph)};  // Scratch: input, output and end offsets per node while capturing
+    
+    // Compiled execution order, sorted by level; executionLevels_[i] is the level of executionOrder_[i]
     std::vector<FrameGraphTypes::NodeId> executionOrder_;
+    std::vector<uint32_t> executionLevels_;
+    FrameGraphCompilation::QueuePartition queuePartition_;
     bool compiled_ = false;
+    uint64_t compiledTopologyHash_ = 0;
+    
+    // This frame's enable predicate results, parallel to executionOrder_
+    std::vector<bool> nodeEnabled_;
+    
+    // Parallel recording (FRAME_GRAPH_RECORDING_LANES): parallel-capable compute nodes that share a level
+    // record on a fixed lane into per-frame-slot secondaries, executed from the compute primary in order
+    struct ParallelRecordingSlot {
+        uint32_t lane = 0;
+        std::vector<VkCommandBuffer> secondaries;  // Indexed by frame slot, allocated from the lane's pool
+    };
+    std::unordered_map<FrameGraphTypes::NodeId, ParallelRecordingSlot> parallelSlots_;
+    FrameGraphExecution::ParallelRecorder parallelRecorder_;
+    std::vector<std::vector<FrameGraphExecution::ParallelRecorder::Job>> laneJobs_;
+    std::vector<FrameGraphNode*> levelParallelNodes_;  // Scratch for the level being recorded
+    std::vector<VkCommandBuffer> levelSecondaries_;
+    std::vector<FrameGraphTypes::NodeId> levelComputeNodeIds_;  // Barrier batch for the level's compute nodes
+    uint32_t levelFrameIndex_ = 0;  // Read by lane jobs, which capture no more than fits std::function's inline storage
     
     // Current global frame counter (set during execution for node access)
     mutable uint32_t currentGlobalFrame_ = 0;
+    SimulationStep simulationStep_;
+    bool presenting_ = true;
+    
+    // Graphics recordings indexed frameIndex * swapchainImageCount_ + swapchainImageIndex_
+    struct RecordedCommands {
+        std::vector<uint64_t> nodeKeys;  // Graphics node keys in execution order when recorded
+        bool valid = false;
+    };
+    std::vector<RecordedCommands> graphicsRecordings_;
+    std::vector<uint64_t> graphicsNodeKeys_;  // Scratch for this frame's keys
+    uint32_t swapchainImageIndex_ = 0;
+    uint32_t swapchainImageCount_ = 0;
+    RecordingTelemetry recordingTelemetry_;
+    
+    void captureNodeDependencies();
+    uint64_t computeTopologyHash() const;
     
     // Execution helpers
+    void evaluateNodePredicates(const FrameContext& frameContext);
     std::pair<bool, bool> analyzeQueueRequirements() const;
-    void beginCommandBuffers(bool useCompute, bool useGraphics, uint32_t frameIndex);
-    void endCommandBuffers(bool useCompute, bool useGraphics, uint32_t frameIndex);
+    void resolveQueueSync(ExecutionResult& result) const;
+    void beginCommandBuffer(VkCommandBuffer commandBuffer);
+    void endCommandBuffer(VkCommandBuffer commandBuffer);
     void executeNodesInOrder(uint32_t frameIndex, float time, float deltaTime, uint32_t globalFrame, bool& computeExecuted);
     
+    // Lifetimes from the final order place transient memory; runs before barrier analysis captures handles
+    bool placeTransientResources();
+    
+    // Levels record one barrier batch for all their compute nodes, run inline nodes first, then fan
+    // parallel-capable compute nodes out across the recording lanes
+    void assignParallelRecording();
+    void executeLevel(size_t begin, size_t end, uint32_t frameIndex, float time, float deltaTime,
+                      VkCommandBuffer computeCmd, bool& computeExecuted);
+    void recordSecondary(FrameGraphNode* node, VkCommandBuffer secondary, uint32_t frameIndex);
+    
+    // One node's commands inside its debug label and timestamp pair, with its aliasing and split barriers
+    void recordNode(FrameGraphTypes::NodeId nodeId, FrameGraphNode& node, VkCommandBuffer commandBuffer, uint32_t frameIndex);
+    
+    // Graphics nodes record (or replay) after their prepareFrame() and once all compute nodes have run
+    VkCommandBuffer recordGraphicsQueue(uint32_t frameIndex, bool& reused);
+    VkCommandBuffer selectGraphicsCommandBuffer(uint32_t frameIndex, RecordedCommands*& recording);
+    
     // Timeout-aware execution
     bool executeWithTimeoutMonitoring(uint32_t frameIndex, float time, float deltaTime, uint32_t globalFrame, bool& computeExecuted);
     void handleExecutionTimeout();
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../../ecs/utilities/logger.h"
 #include <atomic>
 #include <cstdint>
 
@@ -44,13 +45,16 @@ namespace FrameGraphDebug {
     constexpr void resetCounter(DebugCounter&) {}
 #endif
 
-// Debug logging macros with counter-based throttling
+// Debug logging macros with counter-based throttling. They go through the Logger directly, past
+// LOG_MIN_LEVEL, so FRAME_GRAPH_DEBUG_COUNTERS keeps them in release builds
 #define FRAME_GRAPH_DEBUG_LOG_THROTTLED(counter, interval, message) \
     do { \
         if constexpr (FRAME_GRAPH_DEBUG_ENABLED) { \
             uint32_t count = FrameGraphDebug::incrementCounter(counter); \
             if (count % (interval) == 0) { \
-                std::cout << "[FrameGraph Debug] " << message << " (occurrence #" << count << ")" << std::endl; \
+                Logger::getInstance().write(LogLevel::Debug, 0, [&](std::ostream& _log_stream) { \
+                    _log_stream << "[FrameGraph Debug] " << message << " (occurrence #" << count << ")"; \
+                }); \
             } \
         } \
     } while(0)
@@ -59,7 +63,9 @@ namespace FrameGraphDebug {
 #define FRAME_GRAPH_DEBUG_LOG(message) \
     do { \
         if constexpr (FRAME_GRAPH_DEBUG_ENABLED) { \
-            std::cout << "[FrameGraph Debug] " << message << std::endl; \
+            Logger::getInstance().write(LogLevel::Debug, 0, [&](std::ostream& _log_stream) { \
+                _log_stream << "[FrameGraph Debug] " << message; \
+            }); \
         } \
     } while(0)
 
@@ -3,6 +3,8 @@
 #define VK_NO_PROTOTYPES
 #include <vulkan/vulkan.h>
 #include "frame_graph_types.h"
+#include <cstdint>
+#include <span>
 #include <string>
 #include <vector>
 
@@ -18,26 +20,66 @@ public:
     virtual std::string getName() const = 0;
     virtual FrameGraphTypes::NodeId getId() const { return nodeId; }
     
-    // Resource dependencies
+    // Resource dependencies. FrameGraph::compile() asks once per compile and keeps the answer in its dependency
+    // arena; compilation and barrier analysis read the declared spans, which stay valid until the next compile
     virtual std::vector<ResourceDependency> getInputs() const = 0;
     virtual std::vector<ResourceDependency> getOutputs() const = 0;
+    std::span<const ResourceDependency> getDeclaredInputs() const { return declaredInputs; }
+    std::span<const ResourceDependency> getDeclaredOutputs() const { return declaredOutputs; }
     
     // Node lifecycle - standardized pattern for all nodes
     virtual bool initializeNode(const FrameGraph& frameGraph) { return true; }  // One-time setup
     virtual void prepareFrame(uint32_t frameIndex, float time, float deltaTime) {} // Per-frame preparation with timing
     virtual void releaseFrame(uint32_t frameIndex) {}                           // Per-frame cleanup
     
+    // Per-frame enable predicate, queried before prepareFrame(): a disabled node gets no lifecycle calls that
+    // frame and the schedule drops its barriers, so readers of its outputs must accept the previous contents
+    virtual bool isEnabled(const FrameContext& frameContext) const { return true; }
+    
     // Execution
     virtual void execute(VkCommandBuffer commandBuffer, const FrameGraph& frameGraph) = 0;
     virtual void cleanup() {}
     
+    // Recorded command reuse: queried after prepareFrame(); while every node on a queue returns the key it
+    // returned when that queue's command buffer was recorded, execute() is skipped and the recording replayed.
+    // Nodes that bake per-frame values (push constants, CPU decisions) into their commands stay uncacheable
+    static constexpr uint64_t UNCACHEABLE_RECORDING = 0;
+    virtual uint64_t getRecordingKey() const { return UNCACHEABLE_RECORDING; }
+    
+    // Parallel recording: a compute node returning true may have execute() called on a recording lane,
+    // concurrently with other nodes of its level, into a secondary command buffer. Only valid when execute()
+    // reads shared managers without mutating them - pipelines and layouts must be resolved in prepareFrame()
+    virtual bool supportsParallelRecording() const { return false; }
+    
+    // Pipeline statistics: with ENABLE_GPU_PIPELINE_STATISTICS, the node's timestamp bracket also counts shader
+    // invocations (and clipped primitives on the graphics queue), reported in its NodeGpuTiming
+    virtual bool wantsPipelineStatistics() const { return false; }
     
-    // Synchronization hints
-    virtual bool needsComputeQueue() const { return false; }
-    virtual bool needsGraphicsQueue() const { return true; }
+    // Device memory read and written per live entity and simulation tick, averaged over the steady state and
+    // estimated from the kernel's own stream accesses; the benchmark mode turns it into GB/s with the node's
+    // GPU time. 0 = not reported (per-cell or per-draw work)
+    virtual float getBytesPerEntity() const { return 0.0f; }
+    
+    // Queue affinity: the stream FrameGraphCompiler::partitionQueues places the node in. Cross-queue
+    // semaphores and ownership transfers follow from it and the declared dependencies
+    virtual QueueAffinity getQueueAffinity() const { return QueueAffinity::Graphics; }
+    bool needsComputeQueue() const { return getQueueAffinity() != QueueAffinity::Graphics; }
+    bool needsGraphicsQueue() const { return getQueueAffinity() == QueueAffinity::Graphics; }
 
 protected:
+    // Folds one recorded input into a recording key; the result is never UNCACHEABLE_RECORDING
+    static uint64_t combineRecordingKey(uint64_t key, uint64_t value) {
+        key ^= value + 0x9e3779b97f4a7c15ull + (key << 6) + (key >> 2);
+        return key == UNCACHEABLE_RECORDING ? 1 : key;
+    }
+    
+    // Non-dispatchable handles are pointers or uint64_t depending on the platform
+    template<typename Handle>
+    static uint64_t recordingHandleKey(Handle handle) { return (uint64_t)(handle); }
+    
     FrameGraphTypes::NodeId nodeId = FrameGraphTypes::INVALID_NODE;
+    std::span<const ResourceDependency> declaredInputs;
+    std::span<const ResourceDependency> declaredOutputs;
     friend class FrameGraph;
 };
 
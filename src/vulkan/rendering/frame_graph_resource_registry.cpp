@@ -46,7 +46,7 @@ bool FrameGraphResourceRegistry::importEntityResources() {
     currentPositionBufferId = frameGraph->importExternalBuffer(
         "CurrentPositionBuffer",
         gpuEntityManager->getCurrentPositionBuffer(),
-        gpuEntityManager->getPositionBufferSize(),
+        gpuEntityManager->getCurrentPositionBufferSize(),
         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
     );
 
@@ -58,5 +58,61 @@ bool FrameGraphResourceRegistry::importEntityResources() {
         VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
     );
 
+    // Import spatial grid buffers (cell ranges, per-entity slots, cell-sorted indices)
+    spatialMapBufferId = frameGraph->importExternalBuffer(
+        "SpatialMapBuffer",
+        gpuEntityManager->getSpatialMapBuffer(),
+        gpuEntityManager->getSpatialMapBufferSize(),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+    );
+
+    spatialEntryBufferId = frameGraph->importExternalBuffer(
+        "SpatialEntryBuffer",
+        gpuEntityManager->getSpatialEntryBuffer(),
+        gpuEntityManager->getSpatialEntryBufferSize(),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+    );
+
+    spatialIndexBufferId = frameGraph->importExternalBuffer(
+        "SpatialIndexBuffer",
+        gpuEntityManager->getSpatialIndexBuffer(),
+        gpuEntityManager->getSpatialIndexBufferSize(),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+    );
+
+    // Import GPU culling output (compacted visible indices and their indirect draw command)
+    visibleIndexBufferId = frameGraph->importExternalBuffer(
+        "VisibleIndexBuffer",
+        gpuEntityManager->getVisibleIndexBuffer(),
+        gpuEntityManager->getVisibleIndexBufferSize(),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT
+    );
+
+    visibleDrawCommandBufferId = frameGraph->importExternalBuffer(
+        "VisibleDrawCommandBuffer",
+        gpuEntityManager->getVisibleDrawCommandBuffer(),
+        gpuEntityManager->getVisibleDrawCommandBufferSize(),
+        VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_INDIRECT_BUFFER_BIT
+    );
+
     return true;
+}
+
+bool FrameGraphResourceRegistry::refreshEntityResources() {
+    if (!frameGraph || !gpuEntityManager) {
+        std::cerr << "FrameGraphResourceRegistry: Invalid dependencies" << std::endl;
+        return false;
+    }
+    
+    bool success = true;
+    success &= frameGraph->updateExternalBuffer(entityBufferId, gpuEntityManager->getVelocityBuffer(), gpuEntityManager->getVelocityBufferSize());
+    success &= frameGraph->updateExternalBuffer(positionBufferId, gpuEntityManager->getPositionBuffer(), gpuEntityManager->getPositionBufferSize());
+    success &= frameGraph->updateExternalBuffer(currentPositionBufferId, gpuEntityManager->getCurrentPositionBuffer(), gpuEntityManager->getCurrentPositionBufferSize());
+    success &= frameGraph->updateExternalBuffer(targetPositionBufferId, gpuEntityManager->getTargetPositionBuffer(), gpuEntityManager->getPositionBufferSize());
+    success &= frameGraph->updateExternalBuffer(spatialMapBufferId, gpuEntityManager->getSpatialMapBuffer(), gpuEntityManager->getSpatialMapBufferSize());
+    success &= frameGraph->updateExternalBuffer(spatialEntryBufferId, gpuEntityManager->getSpatialEntryBuffer(), gpuEntityManager->getSpatialEntryBufferSize());
+    success &= frameGraph->updateExternalBuffer(spatialIndexBufferId, gpuEntityManager->getSpatialIndexBuffer(), gpuEntityManager->getSpatialIndexBufferSize());
+    success &= frameGraph->updateExternalBuffer(visibleIndexBufferId, gpuEntityManager->getVisibleIndexBuffer(), gpuEntityManager->getVisibleIndexBufferSize());
+    success &= frameGraph->updateExternalBuffer(visibleDrawCommandBufferId, gpuEntityManager->getVisibleDrawCommandBuffer(), gpuEntityManager->getVisibleDrawCommandBufferSize());
+    return success;
 }
\ No newline at end of file
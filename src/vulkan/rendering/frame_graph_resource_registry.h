@@ -16,12 +16,20 @@ public:
 
     // Import all entity-related resources into frame graph
     bool importEntityResources();
+    
+    // Re-point the imports at new handles after the entity buffers grew (resource IDs are kept)
+    bool refreshEntityResources();
 
     // Getters for resource IDs
     FrameGraphTypes::ResourceId getEntityBufferId() const { return entityBufferId; }
     FrameGraphTypes::ResourceId getPositionBufferId() const { return positionBufferId; }
     FrameGraphTypes::ResourceId getCurrentPositionBufferId() const { return currentPositionBufferId; }
     FrameGraphTypes::ResourceId getTargetPositionBufferId() const { return targetPositionBufferId; }
+    FrameGraphTypes::ResourceId getSpatialMapBufferId() const { return spatialMapBufferId; }
+    FrameGraphTypes::ResourceId getSpatialEntryBufferId() const { return spatialEntryBufferId; }
+    FrameGraphTypes::ResourceId getSpatialIndexBufferId() const { return spatialIndexBufferId; }
+    FrameGraphTypes::ResourceId getVisibleIndexBufferId() const { return visibleIndexBufferId; }
+    FrameGraphTypes::ResourceId getVisibleDrawCommandBufferId() const { return visibleDrawCommandBufferId; }
 
 private:
     // Dependencies
@@ -33,4 +41,9 @@ private:
     FrameGraphTypes::ResourceId positionBufferId = 0;
     FrameGraphTypes::ResourceId currentPositionBufferId = 0;
     FrameGraphTypes::ResourceId targetPositionBufferId = 0;
+    FrameGraphTypes::ResourceId spatialMapBufferId = 0;
+    FrameGraphTypes::ResourceId spatialEntryBufferId = 0;
+    FrameGraphTypes::ResourceId spatialIndexBufferId = 0;
+    FrameGraphTypes::ResourceId visibleIndexBufferId = 0;
+    FrameGraphTypes::ResourceId visibleDrawCommandBufferId = 0;
 };
\ No newline at end of file
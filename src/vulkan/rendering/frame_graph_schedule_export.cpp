@@ -0,0 +1,300 @@
+#include "frame_graph_schedule_export.h"
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <unordered_map>
+
+namespace FrameGraphScheduleExport {
+
+namespace {
+    const char* accessName(ResourceAccess access) {
+        switch (access) {
+            case ResourceAccess::Read: return "read";
+            case ResourceAccess::Write: return "write";
+            case ResourceAccess::ReadWrite: return "readwrite";
+        }
+        return "unknown";
+    }
+
+    const char* stageName(PipelineStage stage) {
+        switch (stage) {
+            case PipelineStage::ComputeShader: return "compute";
+            case PipelineStage::VertexShader: return "vertex";
+            case PipelineStage::FragmentShader: return "fragment";
+            case PipelineStage::ColorAttachment: return "color_attachment";
+            case PipelineStage::DepthAttachment: return "depth_attachment";
+            case PipelineStage::Transfer: return "transfer";
+        }
+        return "unknown";
+    }
+
+    const char* affinityName(QueueAffinity affinity) {
+        switch (affinity) {
+            case QueueAffinity::Graphics: return "graphics";
+            case QueueAffinity::AsyncCompute: return "async_compute";
+            case QueueAffinity::Transfer: return "transfer";
+        }
+        return "unknown";
+    }
+
+    const char* streamName(FrameGraphCompilation::QueueStream stream) {
+        return stream == FrameGraphCompilation::QueueStream::Compute ? "compute" : "graphics";
+    }
+
+    bool endsWith(const std::string& value, const char* suffix) {
+        const std::string ending(suffix);
+        return value.size() >= ending.size() && value.compare(value.size() - ending.size(), ending.size(), ending) == 0;
+    }
+
+    const ScheduleResource* findResource(const Schedule& schedule, FrameGraphTypes::ResourceId id) {
+        for (const ScheduleResource& resource : schedule.resources) {
+            if (resource.id == id) return &resource;
+        }
+        return nullptr;
+    }
+
+    std::string resourceLabel(const Schedule& schedule, FrameGraphTypes::ResourceId id) {
+        const ScheduleResource* resource = findResource(schedule, id);
+        return resource && !resource->name.empty() ? resource->name : "resource " + std::to_string(id);
+    }
+
+    bool hasBarrierInto(const Schedule& schedule, const ScheduleEdge& edge) {
+        for (const ScheduleBarrier& barrier : schedule.barriers) {
+            if (barrier.release || barrier.target != edge.consumer) continue;
+            if (std::find(edge.resources.begin(), edge.resources.end(), barrier.resource) != edge.resources.end()) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void writeDependencies(const std::vector<ResourceDependency>& dependencies, std::ostream& out) {
+        out << "[";
+        for (size_t i = 0; i < dependencies.size(); ++i) {
+            const ResourceDependency& dependency = dependencies[i];
+            out << (i == 0 ? "" : ", ") << "{\"resource\": " << dependency.resourceId << ", \"access\": \""
+                << accessName(dependency.access) << "\", \"stage\": \"" << stageName(dependency.stage) << "\"";
+            if (dependency.offset != 0 || dependency.size != ~0ULL) {
+                out << ", \"offset\": " << dependency.offset << ", \"size\": " << dependency.size;
+            }
+            out << "}";
+        }
+        out << "]";
+    }
+}
+
+void markCriticalPath(Schedule& schedule) {
+    schedule.criticalPath.clear();
+    schedule.criticalPathMs = 0.0f;
+    if (schedule.nodes.empty()) return;
+
+    std::unordered_map<FrameGraphTypes::NodeId, size_t> indexOf;
+    for (size_t i = 0; i < schedule.nodes.size(); ++i) {
+        indexOf[schedule.nodes[i].id] = i;
+    }
+
+    // Edges point forward in the execution order, so one pass over it settles every node's earliest finish
+    std::vector<std::vector<size_t>> incoming(schedule.nodes.size());
+    for (size_t e = 0; e < schedule.edges.size(); ++e) {
+        ScheduleEdge& edge = schedule.edges[e];
+        edge.critical = false;
+        auto consumer = indexOf.find(edge.consumer);
+        if (consumer != indexOf.end() && indexOf.count(edge.producer)) {
+            incoming[consumer->second].push_back(e);
+        }
+    }
+
+    std::vector<float> finishMs(schedule.nodes.size(), 0.0f);
+    std::vector<size_t> criticalEdge(schedule.nodes.size(), SIZE_MAX);
+    size_t last = 0;
+    for (size_t i = 0; i < schedule.nodes.size(); ++i) {
+        float startMs = 0.0f;
+        for (size_t e : incoming[i]) {
+            const float producerFinish = finishMs[indexOf[schedule.edges[e].producer]];
+            if (producerFinish > startMs || criticalEdge[i] == SIZE_MAX) {
+                startMs = std::max(startMs, producerFinish);
+                criticalEdge[i] = e;
+            }
+        }
+        finishMs[i] = startMs + (schedule.nodes[i].hasTiming ? schedule.nodes[i].avgMs : 0.0f);
+        if (finishMs[i] > finishMs[last]) last = i;
+    }
+
+    schedule.criticalPathMs = finishMs[last];
+    for (size_t i = last;; ) {
+        schedule.criticalPath.push_back(schedule.nodes[i].id);
+        const size_t e = criticalEdge[i];
+        if (e == SIZE_MAX) break;
+        schedule.edges[e].critical = true;
+        i = indexOf[schedule.edges[e].producer];
+    }
+    std::reverse(schedule.criticalPath.begin(), schedule.criticalPath.end());
+}
+
+bool write(const Schedule& schedule, const std::string& path) {
+    std::ofstream out(path);
+    if (!out) {
+        std::cerr << "FrameGraph: Cannot write schedule export to " << path << std::endl;
+        return false;
+    }
+    if (endsWith(path, ".dot") || endsWith(path, ".gv")) {
+        writeDot(schedule, out);
+    } else {
+        writeJson(schedule, out);
+    }
+    std::cout << "Wrote frame graph schedule (" << schedule.nodes.size() << " nodes, " << schedule.barriers.size()
+              << " barriers) to " << path << std::endl;
+    return true;
+}
+
+void writeDot(const Schedule& schedule, std::ostream& out) {
+    std::unordered_map<FrameGraphTypes::NodeId, uint32_t> barrierCounts;
+    std::unordered_map<FrameGraphTypes::NodeId, uint32_t> splitCounts;
+    for (const ScheduleBarrier& barrier : schedule.barriers) {
+        ++barrierCounts[barrier.target];
+        if (barrier.signal != 0) ++splitCounts[barrier.target];
+    }
+    auto onCriticalPath = [&schedule](FrameGraphTypes::NodeId id) {
+        return std::find(schedule.criticalPath.begin(), schedule.criticalPath.end(), id) != schedule.criticalPath.end();
+    };
+
+    out << "digraph FrameGraph {\n";
+    out << "  rankdir=LR;\n";
+    out << "  label=\"" << schedule.nodes.size() << " nodes, " << schedule.entityCount << " entities, critical path "
+        << schedule.criticalPathMs << " ms (avg over up to " << schedule.timingWindow << " frames)\";\n";
+    out << "  node [shape=box, fontname=\"monospace\"];\n";
+
+    // One cluster per queue stream, the subgraph each command buffer records
+    for (uint32_t stream = 0; stream < FrameGraphCompilation::QUEUE_STREAM_COUNT; ++stream) {
+        const auto queueStream = static_cast<FrameGraphCompilation::QueueStream>(stream);
+        out << "  subgraph cluster_" << streamName(queueStream) << " {\n";
+        out << "    label=\"" << streamName(queueStream) << " stream\";\n";
+        for (const ScheduleNode& node : schedule.nodes) {
+            if (node.stream != queueStream) continue;
+            out << "    n" << node.id << " [label=\"" << node.name << "\\n#" << node.position << " level " << node.level
+                << " (" << affinityName(node.affinity) << ")";
+            if (node.hasTiming) {
+                out << "\\navg " << node.avgMs << " ms, p99 " << node.p99Ms << " ms";
+            }
+            if (node.bytesPerFrame > 0.0) {
+                out << "\\n" << node.bytesPerFrame / (1024.0 * 1024.0) << " MB/frame";
+            }
+            if (barrierCounts.count(node.id)) {
+                out << "\\n" << barrierCounts[node.id] << " barriers";
+                if (splitCounts.count(node.id)) out << " (" << splitCounts[node.id] << " split)";
+            }
+            if (node.aliasingBarrier) {
+                out << "\\naliasing barrier";
+            }
+            out << "\"";
+            if (onCriticalPath(node.id)) out << ", color=red, penwidth=2";
+            out << "];\n";
+        }
+        out << "  }\n";
+    }
+
+    // Solid edges carry a barrier into the consumer, dashed ones a queue sync point's semaphore, dotted ones only order
+    for (const ScheduleEdge& edge : schedule.edges) {
+        out << "  n" << edge.producer << " -> n" << edge.consumer << " [label=\"";
+        for (size_t i = 0; i < edge.resources.size(); ++i) {
+            out << (i == 0 ? "" : "\\n") << resourceLabel(schedule, edge.resources[i]);
+        }
+        out << "\"";
+        if (edge.crossQueue) {
+            out << ", style=dashed";
+        } else if (!hasBarrierInto(schedule, edge)) {
+            out << ", style=dotted";
+        }
+        if (edge.critical) out << ", color=red, penwidth=2";
+        out << "];\n";
+    }
+    out << "}\n";
+}
+
+void writeJson(const Schedule& schedule, std::ostream& out) {
+    out << "{\n";
+    out << "  \"entityCount\": " << schedule.entityCount << ",\n";
+    out << "  \"timingWindow\": " << schedule.timingWindow << ",\n";
+    out << "  \"criticalPathMs\": " << schedule.criticalPathMs << ",\n";
+    out << "  \"criticalPath\": [";
+    for (size_t i = 0; i < schedule.criticalPath.size(); ++i) {
+        out << (i == 0 ? "" : ", ") << schedule.criticalPath[i];
+    }
+    out << "],\n";
+
+    out << "  \"nodes\": [";
+    for (size_t i = 0; i < schedule.nodes.size(); ++i) {
+        const ScheduleNode& node = schedule.nodes[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"id\": " << node.id << ", \"name\": \"" << node.name << "\", \"position\": " << node.position
+            << ", \"level\": " << node.level << ", \"queue\": \"" << affinityName(node.affinity) << "\", \"stream\": \""
+            << streamName(node.stream) << "\", \"aliasingBarrier\": " << (node.aliasingBarrier ? "true" : "false") << ",\n";
+        out << "     \"gpuMs\": ";
+        if (node.hasTiming) {
+            out << "{\"avg\": " << node.avgMs << ", \"min\": " << node.minMs << ", \"p99\": " << node.p99Ms
+                << ", \"samples\": " << node.sampleCount << "}";
+        } else {
+            out << "null";
+        }
+        out << ", \"bytesPerFrame\": " << node.bytesPerFrame << ",\n";
+        out << "     \"inputs\": ";
+        writeDependencies(node.inputs, out);
+        out << ",\n     \"outputs\": ";
+        writeDependencies(node.outputs, out);
+        out << "}";
+    }
+    out << "\n  ],\n";
+
+    out << "  \"resources\": [";
+    for (size_t i = 0; i < schedule.resources.size(); ++i) {
+        const ScheduleResource& resource = schedule.resources[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"id\": " << resource.id << ", \"name\": \"" << resource.name << "\", \"type\": \""
+            << (resource.isImage ? "image" : "buffer") << "\", ";
+        if (resource.isImage) {
+            out << "\"width\": " << resource.extent.width << ", \"height\": " << resource.extent.height;
+        } else {
+            out << "\"size\": " << resource.size;
+        }
+        out << ", \"external\": " << (resource.isExternal ? "true" : "false")
+            << ", \"transient\": " << (resource.isTransient ? "true" : "false")
+            << ", \"aliased\": " << (resource.isAliased ? "true" : "false") << "}";
+    }
+    out << "\n  ],\n";
+
+    out << "  \"edges\": [";
+    for (size_t i = 0; i < schedule.edges.size(); ++i) {
+        const ScheduleEdge& edge = schedule.edges[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"producer\": " << edge.producer << ", \"consumer\": " << edge.consumer << ", \"resources\": [";
+        for (size_t r = 0; r < edge.resources.size(); ++r) {
+            out << (r == 0 ? "" : ", ") << edge.resources[r];
+        }
+        out << "], \"crossQueue\": " << (edge.crossQueue ? "true" : "false")
+            << ", \"barrier\": " << (hasBarrierInto(schedule, edge) ? "true" : "false")
+            << ", \"critical\": " << (edge.critical ? "true" : "false") << "}";
+    }
+    out << "\n  ],\n";
+
+    // Stage and access masks are VkPipelineStageFlags2/VkAccessFlags2 bits
+    out << "  \"barriers\": [";
+    for (size_t i = 0; i < schedule.barriers.size(); ++i) {
+        const ScheduleBarrier& barrier = schedule.barriers[i];
+        out << (i == 0 ? "\n" : ",\n");
+        out << "    {\"target\": " << barrier.target << ", \"signal\": " << barrier.signal
+            << ", \"release\": " << (barrier.release ? "true" : "false") << ", \"resource\": " << barrier.resource
+            << ", \"srcStages\": " << barrier.srcStages << ", \"srcAccess\": " << barrier.srcAccess
+            << ", \"dstStages\": " << barrier.dstStages << ", \"dstAccess\": " << barrier.dstAccess;
+        if (barrier.srcQueueFamily != barrier.dstQueueFamily) {
+            out << ", \"srcQueueFamily\": " << barrier.srcQueueFamily << ", \"dstQueueFamily\": " << barrier.dstQueueFamily;
+        }
+        if (barrier.isImage) {
+            out << ", \"oldLayout\": " << barrier.oldLayout << ", \"newLayout\": " << barrier.newLayout;
+        }
+        out << "}";
+    }
+    out << "\n  ]\n";
+    out << "}\n";
+}
+
+} // namespace FrameGraphScheduleExport
@@ -0,0 +1,95 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "frame_graph_types.h"
+#include "compilation/frame_graph_compiler.h"
+#include <iosfwd>
+#include <string>
+#include <vector>
+#include <cstdint>
+
+// Offline view of a compiled frame graph (FrameGraph::captureSchedule): nodes in execution order with their level,
+// queue and measured GPU time, the resources they declare, the dependency edges between them, and the barriers of
+// the all-nodes-enabled schedule. Written as Graphviz DOT or JSON, with the critical path through the edges marked
+namespace FrameGraphScheduleExport {
+
+struct ScheduleNode {
+    FrameGraphTypes::NodeId id = 0;
+    std::string name;
+    uint32_t position = 0;  // In the execution order
+    uint32_t level = 0;
+    QueueAffinity affinity = QueueAffinity::Graphics;
+    FrameGraphCompilation::QueueStream stream = FrameGraphCompilation::QueueStream::Graphics;
+    std::vector<ResourceDependency> inputs;
+    std::vector<ResourceDependency> outputs;
+    bool aliasingBarrier = false;  // Waits for all earlier work on its queue before first using an aliased transient
+
+    // NodeGpuTiming over the last GPU_NODE_TIMING_WINDOW measured frames; hasTiming false until a sample exists
+    bool hasTiming = false;
+    float avgMs = 0.0f;
+    float minMs = 0.0f;
+    float p99Ms = 0.0f;
+    uint64_t sampleCount = 0;
+    double bytesPerFrame = 0.0;  // getBytesPerEntity() times the entity count (0 = not reported)
+};
+
+struct ScheduleResource {
+    FrameGraphTypes::ResourceId id = 0;
+    std::string name;
+    bool isImage = false;
+    VkDeviceSize size = 0;  // Buffers
+    VkExtent2D extent = {0, 0};  // Images
+    bool isExternal = false;
+    bool isTransient = false;
+    bool isAliased = false;
+};
+
+// Producer to consumer in the compiler's dependency graph, through the resources both declare and one of them writes
+struct ScheduleEdge {
+    FrameGraphTypes::NodeId producer = 0;
+    FrameGraphTypes::NodeId consumer = 0;
+    std::vector<FrameGraphTypes::ResourceId> resources;
+    bool crossQueue = false;  // Covered by a queue sync point's semaphore rather than a barrier
+    bool critical = false;    // On the critical path
+};
+
+struct ScheduleBarrier {
+    FrameGraphTypes::NodeId target = 0;  // Recorded before it (after it for releases)
+    FrameGraphTypes::NodeId signal = 0;  // Split barrier: the event is set after this node (0 = plain barrier)
+    bool release = false;                // Queue family release
+    FrameGraphTypes::ResourceId resource = 0;
+    bool isImage = false;
+    VkPipelineStageFlags2KHR srcStages = 0;
+    VkAccessFlags2KHR srcAccess = 0;
+    VkPipelineStageFlags2KHR dstStages = 0;
+    VkAccessFlags2KHR dstAccess = 0;
+    uint32_t srcQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+    uint32_t dstQueueFamily = VK_QUEUE_FAMILY_IGNORED;
+    VkImageLayout oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    VkImageLayout newLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+};
+
+struct Schedule {
+    std::vector<ScheduleNode> nodes;  // Execution order
+    std::vector<ScheduleResource> resources;
+    std::vector<ScheduleEdge> edges;
+    std::vector<ScheduleBarrier> barriers;
+    uint32_t entityCount = 0;
+    uint32_t timingWindow = 0;  // Frames the timings span at most
+
+    // Longest path through the edges weighted by each node's average GPU time; untimed nodes weigh nothing
+    std::vector<FrameGraphTypes::NodeId> criticalPath;
+    float criticalPathMs = 0.0f;
+};
+
+// Fills criticalPath, criticalPathMs and the edges' critical flags; the capture calls it
+void markCriticalPath(Schedule& schedule);
+
+// Format from the extension: ".dot" and ".gv" write Graphviz, anything else JSON. Names are node class names and
+// resource debug names, written unescaped
+bool write(const Schedule& schedule, const std::string& path);
+void writeDot(const Schedule& schedule, std::ostream& out);
+void writeJson(const Schedule& schedule, std::ostream& out);
+
+} // namespace FrameGraphScheduleExport
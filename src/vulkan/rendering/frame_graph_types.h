@@ -27,6 +27,14 @@ enum class PipelineStage {
     Transfer
 };
 
+// Queue a node records on. Transfer nodes share the async compute stream: the graph submits one command buffer
+// per stream and frame, and the transfer queue carries the uploads that run outside it
+enum class QueueAffinity {
+    Graphics,
+    AsyncCompute,
+    Transfer
+};
+
 // Resource classification for allocation strategies
 enum class ResourceCriticality {
     Critical,    // Must be device local, fail fast if not possible
@@ -35,8 +43,44 @@ enum class ResourceCriticality {
 };
 
 // Resource dependency descriptor
+// Buffer dependencies may name a byte range, which scopes the barriers BarrierManager builds for them
 struct ResourceDependency {
     FrameGraphTypes::ResourceId resourceId;
     ResourceAccess access;
     PipelineStage stage;
+    uint64_t offset = 0;
+    uint64_t size = ~0ULL;  // VK_WHOLE_SIZE
+};
+
+// Simulation ticks a frame advances (SimulationClock); simulation passes record one step per tick
+struct SimulationStep {
+    uint32_t firstTick = 0;           // Tick counter of the first step, which movement cycles are keyed on
+    uint32_t tickCount = 1;           // 0 on frames that only render
+    float tickSeconds = 0.0f;         // Integration step of every tick
+    float interpolationAlpha = 1.0f;  // Render blend from the previous tick's positions to the latest
+};
+
+// Per-frame values handed to node enable predicates
+struct FrameContext {
+    uint32_t frameIndex = 0;   // Frame-in-flight slot
+    uint32_t globalFrame = 0;  // Monotonic frame counter, as getGlobalFrameCounter()
+    float time = 0.0f;
+    float deltaTime = 0.0f;
+    SimulationStep simulation;
+    bool presenting = true;    // False on compute-only frames: graphics nodes are skipped and nothing is presented
+};
+
+// Span of execution-order indices (inclusive) in which a resource is read or written, computed at compile time
+struct ResourceLifetime {
+    static constexpr uint32_t UNUSED = UINT32_MAX;
+    
+    uint32_t firstUse = UNUSED;
+    uint32_t lastUse = 0;
+    bool usedByCompute = false;
+    bool usedByGraphics = false;
+    
+    bool isUsed() const { return firstUse != UNUSED; }
+    bool overlaps(const ResourceLifetime& other) const {
+        return isUsed() && other.isUsed() && firstUse <= other.lastUse && other.firstUse <= lastUse;
+    }
 };
\ No newline at end of file
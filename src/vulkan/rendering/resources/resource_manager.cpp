@@ -2,12 +2,14 @@
 #include "../../core/vulkan_context.h"
 #include "../../core/vulkan_utils.h"
 #include "../../core/vulkan_function_loader.h"
+#include "../../core/vulkan_debug_labels.h"
 #include "../../monitoring/gpu_memory_monitor.h"
 #include <iostream>
 #include <algorithm>
 #include <cassert>
 #include <thread>
 #include <chrono>
+#include <map>
 
 namespace FrameGraphResources {
 
@@ -44,15 +46,20 @@ void ResourceManager::cleanupBeforeContextDestruction() {
             if (!res.isExternal) {
                 if constexpr (std::is_same_v<std::decay_t<decltype(res)>, FrameGraphBuffer>) {
                     res.buffer.reset();
+                    res.allocation.reset();
                     res.memory.reset();
                 } else {
                     res.view.reset();
                     res.image.reset();
+                    res.allocation.reset();
                     res.memory.reset();
                 }
             }
         }, resource);
     }
+    
+    // Transient handles are gone, so their shared heaps can go too
+    transientHeaps_.clear();
 }
 
 FrameGraphTypes::ResourceId ResourceManager::createBuffer(const std::string& name, VkDeviceSize size, VkBufferUsageFlags usage) {
@@ -80,6 +87,7 @@ FrameGraphTypes::ResourceId ResourceManager::createBuffer(const std::string& nam
         std::cerr << "ResourceManager: Failed to create Vulkan buffer for '" << name << "'" << std::endl;
         return FrameGraphTypes::INVALID_RESOURCE;
     }
+    nameResource(buffer);
     
     resources_[id] = std::move(buffer);
     resourceNameMap_[name] = id;
@@ -121,6 +129,7 @@ FrameGraphTypes::ResourceId ResourceManager::createImage(const std::string& name
         std::cerr << "ResourceManager: Failed to create Vulkan image for '" << name << "'" << std::endl;
         return FrameGraphTypes::INVALID_RESOURCE;
     }
+    nameResource(image);
     
     resources_[id] = std::move(image);
     resourceNameMap_[name] = id;
@@ -136,6 +145,87 @@ FrameGraphTypes::ResourceId ResourceManager::createImage(const std::string& name
     return id;
 }
 
+FrameGraphTypes::ResourceId ResourceManager::createTransientBuffer(const std::string& name, VkDeviceSize size, VkBufferUsageFlags usage) {
+    if (!initialized_) {
+        std::cerr << "ResourceManager: Cannot create transient buffer, not initialized" << std::endl;
+        return FrameGraphTypes::INVALID_RESOURCE;
+    }
+    
+    // Check for duplicate names
+    if (resourceNameMap_.find(name) != resourceNameMap_.end()) {
+        std::cerr << "ResourceManager: Buffer with name '" << name << "' already exists" << std::endl;
+        return FrameGraphTypes::INVALID_RESOURCE;
+    }
+    
+    FrameGraphTypes::ResourceId id = nextResourceId_++;
+    
+    FrameGraphBuffer buffer;
+    buffer.size = size;
+    buffer.usage = usage;
+    buffer.isTransient = true;
+    buffer.debugName = name;
+    
+    // Memory comes later, from placeTransientResources() at compile time
+    if (!createTransientHandle(buffer)) {
+        std::cerr << "ResourceManager: Failed to create Vulkan buffer for transient '" << name << "'" << std::endl;
+        return FrameGraphTypes::INVALID_RESOURCE;
+    }
+    
+    resources_[id] = std::move(buffer);
+    resourceNameMap_[name] = id;
+    
+    // Shared heap ranges cannot be evicted one resource at a time
+    ResourceCleanupInfo cleanupInfo;
+    cleanupInfo.lastAccessTime = std::chrono::steady_clock::now();
+    cleanupInfo.criticality = classifyResource(std::get<FrameGraphBuffer>(resources_[id]));
+    cleanupInfo.canEvict = false;
+    resourceCleanupInfo_[id] = cleanupInfo;
+    
+    std::cout << "ResourceManager: Created transient buffer '" << name << "' (ID: " << id << ", Size: " << size << ")" << std::endl;
+    return id;
+}
+
+FrameGraphTypes::ResourceId ResourceManager::createTransientImage(const std::string& name, VkFormat format, VkExtent2D extent, VkImageUsageFlags usage) {
+    if (!initialized_) {
+        std::cerr << "ResourceManager: Cannot create transient image, not initialized" << std::endl;
+        return FrameGraphTypes::INVALID_RESOURCE;
+    }
+    
+    // Check for duplicate names
+    if (resourceNameMap_.find(name) != resourceNameMap_.end()) {
+        std::cerr << "ResourceManager: Image with name '" << name << "' already exists" << std::endl;
+        return FrameGraphTypes::INVALID_RESOURCE;
+    }
+    
+    FrameGraphTypes::ResourceId id = nextResourceId_++;
+    
+    FrameGraphImage image;
+    image.format = format;
+    image.extent = extent;
+    image.usage = usage;
+    image.isTransient = true;
+    image.debugName = name;
+    
+    // Memory and view come later, from placeTransientResources() at compile time
+    if (!createTransientHandle(image)) {
+        std::cerr << "ResourceManager: Failed to create Vulkan image for transient '" << name << "'" << std::endl;
+        return FrameGraphTypes::INVALID_RESOURCE;
+    }
+    
+    resources_[id] = std::move(image);
+    resourceNameMap_[name] = id;
+    
+    // Shared heap ranges cannot be evicted one resource at a time
+    ResourceCleanupInfo cleanupInfo;
+    cleanupInfo.lastAccessTime = std::chrono::steady_clock::now();
+    cleanupInfo.criticality = classifyResource(std::get<FrameGraphImage>(resources_[id]));
+    cleanupInfo.canEvict = false;
+    resourceCleanupInfo_[id] = cleanupInfo;
+    
+    std::cout << "ResourceManager: Created transient image '" << name << "' (ID: " << id << ")" << std::endl;
+    return id;
+}
+
 FrameGraphTypes::ResourceId ResourceManager::importExternalBuffer(const std::string& name, VkBuffer buffer, VkDeviceSize size, VkBufferUsageFlags usage) {
     if (!initialized_) {
         std::cerr << "ResourceManager: Cannot import buffer, not initialized" << std::endl;
@@ -157,6 +247,7 @@ FrameGraphTypes::ResourceId ResourceManager::importExternalBuffer(const std::str
     frameGraphBuffer.usage = usage;
     frameGraphBuffer.isExternal = true; // Don't manage lifecycle
     frameGraphBuffer.debugName = name;
+    nameResource(frameGraphBuffer);
     
     resources_[id] = std::move(frameGraphBuffer);
     resourceNameMap_[name] = id;
@@ -195,6 +286,7 @@ FrameGraphTypes::ResourceId ResourceManager::importExternalImage(const std::stri
     frameGraphImage.extent = extent;
     frameGraphImage.isExternal = true; // Don't manage lifecycle
     frameGraphImage.debugName = name;
+    nameResource(frameGraphImage);
     
     resources_[id] = std::move(frameGraphImage);
     resourceNameMap_[name] = id;
@@ -209,6 +301,205 @@ FrameGraphTypes::ResourceId ResourceManager::importExternalImage(const std::stri
     return id;
 }
 
+bool ResourceManager::updateExternalBuffer(FrameGraphTypes::ResourceId id, VkBuffer buffer, VkDeviceSize size) {
+    auto it = resources_.find(id);
+    FrameGraphBuffer* frameGraphBuffer = it != resources_.end() ? std::get_if<FrameGraphBuffer>(&it->second) : nullptr;
+    if (!frameGraphBuffer || !frameGraphBuffer->isExternal) {
+        std::cerr << "ResourceManager: Resource " << id << " is not an imported buffer" << std::endl;
+        return false;
+    }
+    
+    frameGraphBuffer->buffer = vulkan_raii::Buffer(buffer, context_);
+    frameGraphBuffer->buffer.detach(); // Still owned by the importer
+    frameGraphBuffer->size = size;
+    nameResource(*frameGraphBuffer);
+    return true;
+}
+
+bool ResourceManager::placeTransientResources(const std::unordered_map<FrameGraphTypes::ResourceId, ResourceLifetime>& lifetimes,
+                                              std::vector<FrameGraphTypes::ResourceId>& aliasedResources) {
+    aliasedResources.clear();
+    transientTelemetry_ = TransientTelemetry{};
+    
+    const auto& vk = context_->getLoader();
+    const VkDevice device = context_->getDevice();
+    
+    struct Placement {
+        FrameGraphTypes::ResourceId id;
+        FrameGraphResource* resource;
+        VkMemoryRequirements requirements;
+        ResourceLifetime lifetime;
+        VkDeviceSize offset = 0;
+    };
+    std::vector<Placement> placements;
+    
+    // Bound handles cannot be rebound, so a recompile recreates them before the old heaps are released
+    const bool replacing = !transientHeaps_.empty();
+    for (auto& [id, resource] : resources_) {
+        bool transient = false;
+        bool handleReady = true;
+        VkMemoryRequirements requirements{};
+        std::visit([&](auto& res) {
+            if (!res.isTransient) return;
+            transient = true;
+            res.isAliased = false;
+            if (replacing) {
+                handleReady = createTransientHandle(res);
+            }
+            if (!handleReady) return;
+            if constexpr (std::is_same_v<std::decay_t<decltype(res)>, FrameGraphBuffer>) {
+                vk.vkGetBufferMemoryRequirements(device, res.buffer.get(), &requirements);
+            } else {
+                vk.vkGetImageMemoryRequirements(device, res.image.get(), &requirements);
+            }
+        }, resource);
+        
+        if (!transient) continue;
+        if (!handleReady) {
+            std::cerr << "ResourceManager: Failed to recreate transient resource " << id << std::endl;
+            return false;
+        }
+        
+        Placement placement{id, &resource, requirements, {}};
+        auto lifetimeIt = lifetimes.find(id);
+        if (lifetimeIt != lifetimes.end()) {
+            placement.lifetime = lifetimeIt->second;
+        }
+        // Transients touched by both queues may be in use by either at any time, so they never alias
+        if (placement.lifetime.usedByCompute && placement.lifetime.usedByGraphics) {
+            placement.lifetime.firstUse = 0;
+            placement.lifetime.lastUse = ResourceLifetime::UNUSED - 1;
+        }
+        placements.push_back(placement);
+    }
+    transientHeaps_.clear();
+    
+    if (placements.empty()) {
+        return true;
+    }
+    
+    // Group by queue (aliasing barriers only order work on one queue), resource kind (keeps buffers and
+    // optimal-tiling images apart for bufferImageGranularity) and memory type
+    std::map<uint64_t, std::vector<size_t>> groups;
+    for (size_t i = 0; i < placements.size(); ++i) {
+        const Placement& placement = placements[i];
+        uint32_t memoryTypeIndex;
+        try {
+            memoryTypeIndex = VulkanUtils::findMemoryType(context_->getPhysicalDevice(), vk,
+                                                          placement.requirements.memoryTypeBits,
+                                                          VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        } catch (const std::exception&) {
+            std::cerr << "ResourceManager: No device local memory type for transient resource " << placement.id << std::endl;
+            return false;
+        }
+        const uint64_t queueClass = (placement.lifetime.usedByCompute ? 1u : 0u) | (placement.lifetime.usedByGraphics ? 2u : 0u);
+        const uint64_t isImage = std::holds_alternative<FrameGraphImage>(*placement.resource) ? 1u : 0u;
+        groups[(static_cast<uint64_t>(memoryTypeIndex) << 8) | (isImage << 4) | queueClass].push_back(i);
+    }
+    
+    auto alignUp = [](VkDeviceSize value, VkDeviceSize alignment) {
+        return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+    };
+    
+    for (auto& [groupKey, members] : groups) {
+        // Largest first, each at the lowest offset clear of every placed resource whose lifetime overlaps
+        std::stable_sort(members.begin(), members.end(), [&placements](size_t a, size_t b) {
+            return placements[a].requirements.size > placements[b].requirements.size;
+        });
+        
+        std::vector<size_t> placed;
+        VkDeviceSize heapSize = 0;
+        for (size_t index : members) {
+            Placement& placement = placements[index];
+            const VkDeviceSize size = placement.requirements.size;
+            
+            std::vector<VkDeviceSize> candidates{0};
+            for (size_t other : placed) {
+                if (placements[other].lifetime.overlaps(placement.lifetime)) {
+                    candidates.push_back(alignUp(placements[other].offset + placements[other].requirements.size,
+                                                 placement.requirements.alignment));
+                }
+            }
+            std::sort(candidates.begin(), candidates.end());
+            
+            for (VkDeviceSize candidate : candidates) {
+                bool conflict = false;
+                for (size_t other : placed) {
+                    const Placement& occupant = placements[other];
+                    if (occupant.lifetime.overlaps(placement.lifetime) &&
+                        candidate < occupant.offset + occupant.requirements.size &&
+                        occupant.offset < candidate + size) {
+                        conflict = true;
+                        break;
+                    }
+                }
+                if (!conflict) {
+                    placement.offset = candidate;
+                    break;
+                }
+            }
+            
+            placed.push_back(index);
+            heapSize = std::max(heapSize, placement.offset + size);
+            transientTelemetry_.requestedBytes += size;
+        }
+        
+        VkMemoryAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocInfo.allocationSize = heapSize;
+        allocInfo.memoryTypeIndex = static_cast<uint32_t>(groupKey >> 8);
+        
+        VkDeviceMemory vkMemory;
+        if (vk.vkAllocateMemory(device, &allocInfo, nullptr, &vkMemory) != VK_SUCCESS) {
+            std::cerr << "ResourceManager: Failed to allocate transient heap (" << heapSize << " bytes)" << std::endl;
+            return false;
+        }
+        transientHeaps_.emplace_back(vkMemory, context_);
+        transientTelemetry_.heapBytes += heapSize;
+        
+        for (size_t index : members) {
+            Placement& placement = placements[index];
+            
+            // Used resources sharing a range with another need an aliasing barrier on first use
+            for (size_t other : members) {
+                const Placement& neighbour = placements[other];
+                if (other != index && placement.lifetime.isUsed() && neighbour.lifetime.isUsed() &&
+                    placement.offset < neighbour.offset + neighbour.requirements.size &&
+                    neighbour.offset < placement.offset + placement.requirements.size) {
+                    aliasedResources.push_back(placement.id);
+                    break;
+                }
+            }
+            const bool aliased = !aliasedResources.empty() && aliasedResources.back() == placement.id;
+            
+            bool bound = false;
+            std::visit([&](auto& res) {
+                res.isAliased = aliased;
+                if constexpr (std::is_same_v<std::decay_t<decltype(res)>, FrameGraphBuffer>) {
+                    bound = vk.vkBindBufferMemory(device, res.buffer.get(), vkMemory, placement.offset) == VK_SUCCESS;
+                } else {
+                    bound = vk.vkBindImageMemory(device, res.image.get(), vkMemory, placement.offset) == VK_SUCCESS &&
+                            createTransientImageView(res);
+                }
+            }, *placement.resource);
+            
+            if (!bound) {
+                std::cerr << "ResourceManager: Failed to bind transient resource " << placement.id << std::endl;
+                return false;
+            }
+        }
+    }
+    
+    transientTelemetry_.transientResources = static_cast<uint32_t>(placements.size());
+    transientTelemetry_.aliasedResources = static_cast<uint32_t>(aliasedResources.size());
+    transientTelemetry_.heapCount = static_cast<uint32_t>(transientHeaps_.size());
+    
+    std::cout << "ResourceManager: Placed " << placements.size() << " transient resources in "
+              << transientHeaps_.size() << " heaps (" << transientTelemetry_.heapBytes << " of "
+              << transientTelemetry_.requestedBytes << " bytes, " << aliasedResources.size() << " aliased)" << std::endl;
+    return true;
+}
+
 VkBuffer ResourceManager::getBuffer(FrameGraphTypes::ResourceId id) const {
     const FrameGraphBuffer* buffer = getBufferResource(id);
     return buffer ? buffer->buffer.get() : VK_NULL_HANDLE;
@@ -292,6 +583,9 @@ void ResourceManager::reset() {
             ++it;
         }
     }
+    
+    // Every transient was frame-created, so nothing is bound to the shared heaps any more
+    transientHeaps_.clear();
 }
 
 void ResourceManager::debugPrint() const {
@@ -306,7 +600,8 @@ void ResourceManager::debugPrint() const {
             } else {
                 std::cout << " (Image, " << res.extent.width << "x" << res.extent.height << ")";
             }
-            std::cout << (res.isExternal ? " [External]" : " [Managed]") << std::endl;
+            std::cout << (res.isExternal ? " [External]" : res.isTransient ? " [Transient]" : " [Managed]")
+                      << (res.isAliased ? " [Aliased]" : "") << std::endl;
         }, resource);
     }
     std::cout << "============================\n" << std::endl;
@@ -332,6 +627,77 @@ bool ResourceManager::createVulkanImage(FrameGraphImage& image) {
     return tryAllocateWithStrategy(image, criticality);
 }
 
+bool ResourceManager::createTransientHandle(FrameGraphBuffer& buffer) {
+    buffer.buffer.reset();
+    
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = buffer.size;
+    bufferInfo.usage = buffer.usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    
+    VkBuffer vkBuffer;
+    if (context_->getLoader().vkCreateBuffer(context_->getDevice(), &bufferInfo, nullptr, &vkBuffer) != VK_SUCCESS) {
+        return false;
+    }
+    buffer.buffer = vulkan_raii::Buffer(vkBuffer, context_);
+    
+    // Recompiles recreate the handle, so it is named each time
+    nameResource(buffer);
+    return true;
+}
+
+bool ResourceManager::createTransientHandle(FrameGraphImage& image) {
+    image.view.reset();
+    image.image.reset();
+    
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.extent.width = image.extent.width;
+    imageInfo.extent.height = image.extent.height;
+    imageInfo.extent.depth = 1;
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = 1;
+    imageInfo.format = image.format;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    imageInfo.usage = image.usage;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    
+    VkImage vkImage;
+    if (context_->getLoader().vkCreateImage(context_->getDevice(), &imageInfo, nullptr, &vkImage) != VK_SUCCESS) {
+        return false;
+    }
+    image.image = vulkan_raii::Image(vkImage, context_);
+    nameResource(image);
+    return true;
+}
+
+bool ResourceManager::createTransientImageView(FrameGraphImage& image) {
+    const VkImageAspectFlags aspect = (image.usage & VK_IMAGE_USAGE_DEPTH_STENCIL_ATTACHMENT_BIT)
+        ? VK_IMAGE_ASPECT_DEPTH_BIT : VK_IMAGE_ASPECT_COLOR_BIT;
+    try {
+        VkImageView view = VulkanUtils::createImageView(context_->getDevice(), context_->getLoader(),
+                                                        image.image.get(), image.format, aspect);
+        image.view = vulkan_raii::ImageView(view, context_);
+    } catch (const std::exception&) {
+        return false;
+    }
+    nameResource(image);
+    return true;
+}
+
+void ResourceManager::nameResource(const FrameGraphBuffer& buffer) const {
+    VulkanDebugLabels::nameObject(*context_, VK_OBJECT_TYPE_BUFFER, buffer.buffer.get(), buffer.debugName);
+}
+
+void ResourceManager::nameResource(const FrameGraphImage& image) const {
+    VulkanDebugLabels::nameObject(*context_, VK_OBJECT_TYPE_IMAGE, image.image.get(), image.debugName);
+    VulkanDebugLabels::nameObject(*context_, VK_OBJECT_TYPE_IMAGE_VIEW, image.view.get(), image.debugName);
+}
+
 ResourceCriticality ResourceManager::classifyResource(const FrameGraphBuffer& buffer) const {
     // Critical: Entity and position buffers that are accessed every frame
     if (buffer.usage & VK_BUFFER_USAGE_STORAGE_BUFFER_BIT) {
@@ -446,17 +812,34 @@ bool ResourceManager::tryAllocateWithStrategy(FrameGraphBuffer& buffer, Resource
                                                                   memRequirements.memoryTypeBits, memoryProperties);
                 }
                 
-                VkMemoryAllocateInfo allocInfo{};
-                allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-                allocInfo.allocationSize = memRequirements.size;
-                allocInfo.memoryTypeIndex = memoryTypeIndex;
+                VkDeviceMemory boundMemory = VK_NULL_HANDLE;
+                VkDeviceSize boundOffset = 0;
+                VkResult allocResult = VK_ERROR_OUT_OF_DEVICE_MEMORY;
                 
-                VkDeviceMemory vkMemory;
-                VkResult allocResult = vk.vkAllocateMemory(device, &allocInfo, nullptr, &vkMemory);
-                if (allocResult == VK_SUCCESS) {
-                    buffer.memory = vulkan_raii::DeviceMemory(vkMemory, context_);
+                if (memoryAllocator_) {
+                    buffer.allocation = MemoryAllocation(memoryAllocator_,
+                        memoryAllocator_->allocateMemoryOfType(memRequirements, memoryTypeIndex));
+                    if (buffer.allocation) {
+                        allocResult = VK_SUCCESS;
+                        boundMemory = buffer.allocation.getMemory();
+                        boundOffset = buffer.allocation.getOffset();
+                    }
+                } else {
+                    VkMemoryAllocateInfo allocInfo{};
+                    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+                    allocInfo.allocationSize = memRequirements.size;
+                    allocInfo.memoryTypeIndex = memoryTypeIndex;
                     
-                    VkResult bindResult = vk.vkBindBufferMemory(device, buffer.buffer.get(), buffer.memory.get(), 0);
+                    VkDeviceMemory vkMemory;
+                    allocResult = vk.vkAllocateMemory(device, &allocInfo, nullptr, &vkMemory);
+                    if (allocResult == VK_SUCCESS) {
+                        buffer.memory = vulkan_raii::DeviceMemory(vkMemory, context_);
+                        boundMemory = vkMemory;
+                    }
+                }
+                
+                if (allocResult == VK_SUCCESS) {
+                    VkResult bindResult = vk.vkBindBufferMemory(device, buffer.buffer.get(), boundMemory, boundOffset);
                     if (bindResult == VK_SUCCESS) {
                         // Success - record telemetry
                         allocationTelemetry_.recordSuccess(wasRetried, wasFallback, wasHostMemory);
@@ -471,6 +854,7 @@ bool ResourceManager::tryAllocateWithStrategy(FrameGraphBuffer& buffer, Resource
                     } else {
                         std::cerr << "[ResourceManager] Buffer memory bind failed: " << buffer.debugName 
                                   << " (VkResult: " << bindResult << ")" << std::endl;
+                        buffer.allocation.reset();
                         buffer.memory.reset();
                     }
                 } else if (allocResult == VK_ERROR_OUT_OF_DEVICE_MEMORY || 
@@ -538,6 +922,20 @@ bool ResourceManager::tryAllocateWithStrategy(FrameGraphImage& image, ResourceCr
                                                               memRequirements.memoryTypeBits, 
                                                               VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
         
+        if (memoryAllocator_) {
+            image.allocation = MemoryAllocation(memoryAllocator_,
+                memoryAllocator_->allocateMemoryOfType(memRequirements, memoryTypeIndex,
+                                                       MemoryAllocator::AllocationKind::OptimalImage));
+            if (image.allocation &&
+                vk.vkBindImageMemory(device, image.image.get(), image.allocation.getMemory(),
+                                     image.allocation.getOffset()) == VK_SUCCESS) {
+                allocationTelemetry_.recordSuccess(false, false, false);
+                return true;
+            }
+            image.allocation.reset();
+            return false;
+        }
+        
         VkMemoryAllocateInfo allocInfo{};
         allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
         allocInfo.allocationSize = memRequirements.size;
@@ -578,6 +976,12 @@ uint32_t ResourceManager::findAnyCompatibleMemoryType(uint32_t typeFilter) const
 }
 
 void ResourceManager::logAllocationTelemetry() const {
+    if (transientTelemetry_.transientResources > 0) {
+        std::cout << "[ResourceManager] Transient heaps: " << transientTelemetry_.heapBytes << " of "
+                  << transientTelemetry_.requestedBytes << " bytes for " << transientTelemetry_.transientResources
+                  << " resources (" << transientTelemetry_.aliasedResources << " aliased)" << std::endl;
+    }
+    
     if (allocationTelemetry_.totalAttempts == 0) return;
     
     std::cout << "[ResourceManager] Allocation Telemetry Report:" << std::endl;
@@ -600,16 +1004,22 @@ void ResourceManager::logAllocationTelemetry() const {
 }
 
 void ResourceManager::performResourceCleanup() {
-    if (!memoryMonitor_) return;
-    
-    std::cout << "[ResourceManager] Resource cleanup performed" << std::endl;
+    // Empty allocator blocks are the cheapest memory to give back under a shrinking budget
+    if (memoryAllocator_ && memoryAllocator_->attemptMemoryRecovery()) {
+        std::cout << "[ResourceManager] Resource cleanup performed" << std::endl;
+    }
 }
 
 bool ResourceManager::isMemoryPressureCritical() const {
+    // Critical threshold: >85% of the device-local budget, which with VK_EXT_memory_budget already excludes what
+    // other processes hold
+    if (memoryAllocator_) {
+        return memoryAllocator_->getDeviceLocalBudget().pressureRatio > 0.85f;
+    }
     if (!memoryMonitor_) return false;
     
     float memoryPressure = memoryMonitor_->getMemoryPressure();
-    return memoryPressure > 0.85f; // Critical threshold: >85% memory pressure
+    return memoryPressure > 0.85f;
 }
 
 void ResourceManager::evictNonCriticalResources() {
@@ -4,6 +4,7 @@
 #include <vulkan/vulkan.h>
 #include "../frame_graph_types.h"
 #include "../../core/vulkan_raii.h"
+#include "../../resources/core/memory_allocator.h"
 #include <unordered_map>
 #include <string>
 #include <chrono>
@@ -17,15 +18,19 @@ namespace FrameGraphResources {
 
 // Resource types that can be managed by the frame graph
 struct FrameGraphBuffer {
+    MemoryAllocation allocation;      // Sub-allocated when a MemoryAllocator is set; outlives the buffer
     vulkan_raii::Buffer buffer;
-    vulkan_raii::DeviceMemory memory;
+    vulkan_raii::DeviceMemory memory; // Dedicated memory otherwise
     VkDeviceSize size = 0;
     VkBufferUsageFlags usage = 0;
     bool isExternal = false; // Managed outside frame graph
+    bool isTransient = false; // Memory placed in a shared transient heap at compile time
+    bool isAliased = false;   // Shares heap memory with a transient whose lifetime does not overlap
     std::string debugName;
 };
 
 struct FrameGraphImage {
+    MemoryAllocation allocation;
     vulkan_raii::Image image;
     vulkan_raii::ImageView view;
     vulkan_raii::DeviceMemory memory;
@@ -33,6 +38,8 @@ struct FrameGraphImage {
     VkExtent2D extent = {0, 0};
     VkImageUsageFlags usage = 0;
     bool isExternal = false; // Managed outside frame graph
+    bool isTransient = false; // Memory placed in a shared transient heap at compile time
+    bool isAliased = false;   // Shares heap memory with a transient whose lifetime does not overlap
     std::string debugName;
 };
 
@@ -59,14 +66,31 @@ public:
 
     // Optional monitoring integration
     void setMemoryMonitor(GPUMemoryMonitor* monitor) { memoryMonitor_ = monitor; }
+    
+    // Persistent resources are sub-allocated from it when set; transients keep their own heaps
+    void setMemoryAllocator(MemoryAllocator* allocator) { memoryAllocator_ = allocator; }
 
     // Resource creation
     FrameGraphTypes::ResourceId createBuffer(const std::string& name, VkDeviceSize size, VkBufferUsageFlags usage);
     FrameGraphTypes::ResourceId createImage(const std::string& name, VkFormat format, VkExtent2D extent, VkImageUsageFlags usage);
 
+    // Transient resource creation: the handle exists immediately, memory is bound by placeTransientResources().
+    // Contents do not survive from one frame to the next
+    FrameGraphTypes::ResourceId createTransientBuffer(const std::string& name, VkDeviceSize size, VkBufferUsageFlags usage);
+    FrameGraphTypes::ResourceId createTransientImage(const std::string& name, VkFormat format, VkExtent2D extent, VkImageUsageFlags usage);
+
+    // Places every transient in per-queue heaps so resources with disjoint lifetimes share memory, and reports
+    // the ones that do (they need an aliasing barrier before first use). Handles placed by an earlier compile
+    // are recreated, so the GPU must not be using them
+    bool placeTransientResources(const std::unordered_map<FrameGraphTypes::ResourceId, ResourceLifetime>& lifetimes,
+                                 std::vector<FrameGraphTypes::ResourceId>& aliasedResources);
+
     // External resource import
     FrameGraphTypes::ResourceId importExternalBuffer(const std::string& name, VkBuffer buffer, VkDeviceSize size, VkBufferUsageFlags usage);
     FrameGraphTypes::ResourceId importExternalImage(const std::string& name, VkImage image, VkImageView view, VkFormat format, VkExtent2D extent);
+    
+    // Re-point an imported buffer at a reallocated handle, keeping its resource ID
+    bool updateExternalBuffer(FrameGraphTypes::ResourceId id, VkBuffer buffer, VkDeviceSize size);
 
     // Resource access
     VkBuffer getBuffer(FrameGraphTypes::ResourceId id) const;
@@ -89,11 +113,27 @@ public:
     // Debug and telemetry
     void debugPrint() const;
     void logAllocationTelemetry() const;
+    
+    struct TransientTelemetry {
+        uint32_t transientResources = 0;
+        uint32_t aliasedResources = 0;
+        uint32_t heapCount = 0;
+        VkDeviceSize requestedBytes = 0;  // Sum of dedicated sizes
+        VkDeviceSize heapBytes = 0;       // Memory actually allocated for transients
+    };
+    const TransientTelemetry& getTransientTelemetry() const { return transientTelemetry_; }
 
 private:
     // Resource creation helpers
     bool createVulkanBuffer(FrameGraphBuffer& buffer);
     bool createVulkanImage(FrameGraphImage& image);
+    bool createTransientHandle(FrameGraphBuffer& buffer);
+    bool createTransientHandle(FrameGraphImage& image);
+    bool createTransientImageView(FrameGraphImage& image);
+    
+    // VK_EXT_debug_utils names from debugName, for captures; no-ops in release builds
+    void nameResource(const FrameGraphBuffer& buffer) const;
+    void nameResource(const FrameGraphImage& image) const;
 
     // Resource classification
     ResourceCriticality classifyResource(const FrameGraphBuffer& buffer) const;
@@ -115,6 +155,7 @@ private:
     // State
     const VulkanContext* context_ = nullptr;
     GPUMemoryMonitor* memoryMonitor_ = nullptr;
+    MemoryAllocator* memoryAllocator_ = nullptr;
     bool initialized_ = false;
     
     // Resource storage
@@ -124,6 +165,10 @@ private:
     
     // Resource cleanup tracking
     std::unordered_map<FrameGraphTypes::ResourceId, ResourceCleanupInfo> resourceCleanupInfo_;
+    
+    // Shared transient memory, one heap per (queue, resource kind, memory type) group
+    std::vector<vulkan_raii::DeviceMemory> transientHeaps_;
+    TransientTelemetry transientTelemetry_;
 
     // Resource allocation failure telemetry (moved from original frame_graph)
     struct AllocationTelemetry {
@@ -0,0 +1,12 @@
+#pragma once
+
+#include <glm/glm.hpp>
+
+// One camera view of the entity pass. rect is offset and size as fractions of the render target, as in
+// Viewport::offset/size; zero matrices (no camera) draw with the fallback camera and cull nothing
+struct ViewportCamera {
+    glm::vec4 rect{0.0f, 0.0f, 1.0f, 1.0f};
+    glm::mat4 view{0.0f};
+    glm::mat4 projection{0.0f};
+    glm::mat4 viewProjection{0.0f};
+};
@@ -37,7 +37,22 @@ void BufferFactory::cleanupBeforeContextDestruction() {
 
 ResourceHandle BufferFactory::createBuffer(VkDeviceSize size, 
                                           VkBufferUsageFlags usage,
-                                          VkMemoryPropertyFlags properties) {
+                                          VkMemoryPropertyFlags properties,
+                                          MemoryAllocator::Priority priority) {
+    return createBufferWithAllocation(size, usage, properties, false, priority);
+}
+
+ResourceHandle BufferFactory::createHostWriteBuffer(VkDeviceSize size, VkBufferUsageFlags usage) {
+    ResourceHandle handle = createBufferWithAllocation(size, usage, 0, true, MemoryAllocator::Priority::Normal);
+    if (handle.isValid()) {
+        handle.mappedData = handle.allocation.getMappedData();
+    }
+    return handle;
+}
+
+ResourceHandle BufferFactory::createBufferWithAllocation(VkDeviceSize size, VkBufferUsageFlags usage,
+                                                        VkMemoryPropertyFlags properties, bool hostWrite,
+                                                        MemoryAllocator::Priority priority) {
     ResourceHandle handle;
     
     // Create buffer
@@ -57,14 +72,16 @@ ResourceHandle BufferFactory::createBuffer(VkDeviceSize size,
     VkMemoryRequirements memRequirements;
     context->getLoader().vkGetBufferMemoryRequirements(context->getDevice(), bufferHandle, &memRequirements);
     
-    auto allocation = memoryAllocator->allocateMemory(memRequirements, properties);
+    auto allocation = hostWrite ? memoryAllocator->allocateHostWriteMemory(memRequirements)
+                                : memoryAllocator->allocateMemory(memRequirements, properties,
+                                                                  MemoryAllocator::AllocationKind::Buffer, priority);
     if (allocation.memory == VK_NULL_HANDLE) {
         std::cerr << "Failed to allocate buffer memory!" << std::endl;
         context->getLoader().vkDestroyBuffer(context->getDevice(), bufferHandle, nullptr);
         return {};
     }
     
-    if (context->getLoader().vkBindBufferMemory(context->getDevice(), bufferHandle, allocation.memory, 0) != VK_SUCCESS) {
+    if (context->getLoader().vkBindBufferMemory(context->getDevice(), bufferHandle, allocation.memory, allocation.offset) != VK_SUCCESS) {
         std::cerr << "Failed to bind buffer memory!" << std::endl;
         memoryAllocator->freeMemory(allocation);
         context->getLoader().vkDestroyBuffer(context->getDevice(), bufferHandle, nullptr);
@@ -72,8 +89,8 @@ ResourceHandle BufferFactory::createBuffer(VkDeviceSize size,
     }
     
     // Wrap handles in RAII wrappers
+    handle.allocation = MemoryAllocation(memoryAllocator, allocation);
     handle.buffer = vulkan_raii::make_buffer(bufferHandle, context);
-    handle.memory = vulkan_raii::make_device_memory(allocation.memory, context);
     handle.size = size;
     
     return handle;
@@ -128,14 +145,14 @@ ResourceHandle BufferFactory::createImage(uint32_t width, uint32_t height,
     VkMemoryRequirements memRequirements;
     context->getLoader().vkGetImageMemoryRequirements(context->getDevice(), imageHandle, &memRequirements);
     
-    auto allocation = memoryAllocator->allocateMemory(memRequirements, properties);
+    auto allocation = memoryAllocator->allocateMemory(memRequirements, properties, MemoryAllocator::AllocationKind::OptimalImage);
     if (allocation.memory == VK_NULL_HANDLE) {
         std::cerr << "Failed to allocate image memory!" << std::endl;
         context->getLoader().vkDestroyImage(context->getDevice(), imageHandle, nullptr);
         return {};
     }
     
-    if (context->getLoader().vkBindImageMemory(context->getDevice(), imageHandle, allocation.memory, 0) != VK_SUCCESS) {
+    if (context->getLoader().vkBindImageMemory(context->getDevice(), imageHandle, allocation.memory, allocation.offset) != VK_SUCCESS) {
         std::cerr << "Failed to bind image memory!" << std::endl;
         memoryAllocator->freeMemory(allocation);
         context->getLoader().vkDestroyImage(context->getDevice(), imageHandle, nullptr);
@@ -143,8 +160,8 @@ ResourceHandle BufferFactory::createImage(uint32_t width, uint32_t height,
     }
     
     // Wrap handles in RAII wrappers
+    handle.allocation = MemoryAllocation(memoryAllocator, allocation);
     handle.image = vulkan_raii::make_image(imageHandle, context);
-    handle.memory = vulkan_raii::make_device_memory(allocation.memory, context);
     handle.size = allocation.size;
     
     return handle;
@@ -157,9 +174,7 @@ ResourceHandle BufferFactory::createImageView(const ResourceHandle& imageHandle,
     
     // Copy the image by wrapping the existing handle (without claiming ownership)
     handle.image = vulkan_raii::make_image(imageHandle.image.get(), context);
-    handle.image.detach(); // Don't own the image - it's owned by imageHandle
-    handle.memory = vulkan_raii::make_device_memory(imageHandle.memory.get(), context);
-    handle.memory.detach(); // Don't own the memory - it's owned by imageHandle
+    handle.image.detach(); // Don't own the image - it's owned by imageHandle (and so is its memory)
     handle.size = imageHandle.size;
     
     VkImageViewCreateInfo viewInfo{};
@@ -187,14 +202,13 @@ ResourceHandle BufferFactory::createImageView(const ResourceHandle& imageHandle,
 void BufferFactory::destroyResource(ResourceHandle& handle) {
     if (!context || !handle.isValid()) return;
     
-    if (handle.mappedData && handle.memory) {
-        context->getLoader().vkUnmapMemory(context->getDevice(), handle.memory.get());
-    }
+    memoryAllocator->unmapResourceMemory(handle);
     
-    // RAII wrappers will handle cleanup automatically
+    // RAII wrappers will handle cleanup automatically; resources go before the memory they are bound to
     handle.imageView.reset();
     handle.buffer.reset();
     handle.image.reset();
+    handle.allocation.reset();
     handle.memory.reset();
     
     handle.mappedData = nullptr;
@@ -211,21 +225,20 @@ void BufferFactory::copyToBuffer(const ResourceHandle& dst, const void* data, Vk
         VkDeviceSize remaining = size;
         VkDeviceSize currentOffset = 0;
         
+        // Staging regions stay valid until their frame slot retires, so every chunk shares one submit
+        if (executor) {
+            executor->beginImmediateBatch();
+        }
+        
         while (remaining > 0) {
             VkDeviceSize chunkSize = std::min(remaining, maxChunkSize);
             
             // Try to allocate staging region for this chunk
             auto stagingRegion = stagingBuffer->allocate(chunkSize);
-            if (!stagingRegion.mappedData) {
-                // Reset staging buffer and try again
-                stagingBuffer->reset();
+            if (!stagingRegion.mappedData && chunkSize > 1024) {
+                // The pool could not grow by a full chunk - try with smaller chunk
+                chunkSize = std::min(chunkSize / 2, static_cast<VkDeviceSize>(MEGABYTE)); // Try with 1MB max
                 stagingRegion = stagingBuffer->allocate(chunkSize);
-                
-                // If still no space, try with smaller chunk
-                if (!stagingRegion.mappedData && chunkSize > 1024) {
-                    chunkSize = std::min(chunkSize / 2, static_cast<VkDeviceSize>(MEGABYTE)); // Try with 1MB max
-                    stagingRegion = stagingBuffer->allocate(chunkSize);
-                }
             }
             
             if (stagingRegion.mappedData) {
@@ -238,7 +251,6 @@ void BufferFactory::copyToBuffer(const ResourceHandle& dst, const void* data, Vk
                 stagingHandle.mappedData = stagingRegion.mappedData;
                 stagingHandle.size = chunkSize;
                 
-                // Synchronous transfer to ensure completion before moving to next chunk
                 copyBufferToBuffer(stagingHandle, dst, chunkSize, stagingRegion.offset, offset + currentOffset);
                 
                 remaining -= chunkSize;
@@ -250,6 +262,10 @@ void BufferFactory::copyToBuffer(const ResourceHandle& dst, const void* data, Vk
                 break;
             }
         }
+        
+        if (executor) {
+            executor->endImmediateBatch();
+        }
     }
 }
 
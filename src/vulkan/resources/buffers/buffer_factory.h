@@ -25,15 +25,19 @@ public:
     // Context access
     const VulkanContext* getContext() const { return context; }
     
-    // Buffer creation helpers
+    // Buffer creation helpers; the priority only matters for device-local memory (MemoryAllocator::Priority)
     ResourceHandle createBuffer(VkDeviceSize size, 
                                VkBufferUsageFlags usage,
-                               VkMemoryPropertyFlags properties);
+                               VkMemoryPropertyFlags properties,
+                               MemoryAllocator::Priority priority = MemoryAllocator::Priority::Normal);
     
     ResourceHandle createMappedBuffer(VkDeviceSize size,
                                      VkBufferUsageFlags usage,
                                      VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
     
+    // Persistently mapped buffer for small, frequently CPU-written data (MemoryAllocator::allocateHostWriteMemory)
+    ResourceHandle createHostWriteBuffer(VkDeviceSize size, VkBufferUsageFlags usage);
+    
     // Image creation helpers  
     ResourceHandle createImage(uint32_t width, uint32_t height,
                               VkFormat format,
@@ -56,6 +60,10 @@ public:
     void copyBufferToBuffer(const ResourceHandle& src, const ResourceHandle& dst, VkDeviceSize size, VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
 
 private:
+    ResourceHandle createBufferWithAllocation(VkDeviceSize size, VkBufferUsageFlags usage,
+                                              VkMemoryPropertyFlags properties, bool hostWrite,
+                                              MemoryAllocator::Priority priority);
+    
     const VulkanContext* context = nullptr;
     MemoryAllocator* memoryAllocator = nullptr;
     StagingBufferPool* stagingBuffer = nullptr;
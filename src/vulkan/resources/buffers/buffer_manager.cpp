@@ -29,7 +29,7 @@ bool BufferManager::initialize(ResourceCoordinator* coordinator,
     }
     
     // Initialize staging pool
-    if (!stagingPool->initialize(*coordinator->getContext(), stagingSize)) {
+    if (!stagingPool->initialize(bufferFactory, stagingSize)) {
         std::cerr << "Failed to initialize staging buffer pool!" << std::endl;
         return false;
     }
@@ -102,8 +102,8 @@ StagingBufferPool::StagingRegionGuard BufferManager::allocateStagingGuarded(VkDe
     return stagingPool->allocateGuarded(size, alignment);
 }
 
-void BufferManager::resetAllStaging() {
-    stagingPool->reset();
+void BufferManager::beginFrame(uint32_t frameIndex) {
+    stagingPool->beginFrame(frameIndex);
 }
 
 std::unique_ptr<GPUBuffer> BufferManager::createBuffer(VkDeviceSize size,
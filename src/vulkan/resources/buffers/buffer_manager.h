@@ -34,7 +34,7 @@ public:
     const StagingBufferPool& getPrimaryStagingBuffer() const;
     StagingBufferPool::StagingRegion allocateStaging(VkDeviceSize size, VkDeviceSize alignment = 1);
     StagingBufferPool::StagingRegionGuard allocateStagingGuarded(VkDeviceSize size, VkDeviceSize alignment = 1);
-    void resetAllStaging();
+    void beginFrame(uint32_t frameIndex);  // Retires the slot's staging once its fences have signalled
     
     // GPU buffer operations (delegated to BufferRegistry)
     std::unique_ptr<GPUBuffer> createBuffer(VkDeviceSize size,
@@ -44,8 +44,8 @@ void GPUBuffer::cleanup() {
         storageHandle.reset();
     }
     
+    stagedSpans.clear();
     stagingBytesWritten = 0;
-    stagingStartOffset = 0;
     needsUpload = false;
 }
 
@@ -62,19 +62,16 @@ bool GPUBuffer::addData(const void* data, VkDeviceSize size, VkDeviceSize alignm
     
     if (!bufferManager) return false;
     
+    // The pool grows instead of failing while it can, and its regions stay valid until the frame retires
     auto stagingRegion = bufferManager->allocateStaging(size, alignment);
     
-    if (!stagingRegion.mappedData) {
-        bufferManager->resetAllStaging();
-        stagingBytesWritten = 0;
-        stagingStartOffset = 0;
-        stagingRegion = bufferManager->allocateStaging(size, alignment);
-    }
-    
     if (stagingRegion.mappedData) {
         memcpy(stagingRegion.mappedData, data, size);
-        if (stagingBytesWritten == 0) {
-            stagingStartOffset = stagingRegion.offset;
+        if (!stagedSpans.empty() && stagedSpans.back().buffer == stagingRegion.buffer &&
+            stagedSpans.back().offset + stagedSpans.back().size == stagingRegion.offset) {
+            stagedSpans.back().size += size;
+        } else {
+            stagedSpans.push_back({stagingRegion.buffer, stagingRegion.offset, size});
         }
         stagingBytesWritten += size;
         needsUpload = true;
@@ -91,25 +88,30 @@ void GPUBuffer::flushToGPU(VkDeviceSize dstOffset) {
     
     if (!bufferManager) return;
     
-    auto& stagingBuffer = bufferManager->getPrimaryStagingBuffer();
-    
-    ResourceHandle stagingHandle;
-    stagingHandle.buffer = vulkan_raii::make_buffer(stagingBuffer.getBuffer(), coordinator->getContext());
-    stagingHandle.buffer.detach();
-    
-    coordinator->copyBufferToBuffer(
-        stagingHandle,
-        *storageHandle,
-        stagingBytesWritten,
-        stagingStartOffset,
-        dstOffset
-    );
+    // The spans land in disjoint ranges and outlive the submit, so they share one
+    CommandExecutor* executor = coordinator->getCommandExecutor();
+    executor->beginImmediateBatch();
+    for (const StagedSpan& span : stagedSpans) {
+        ResourceHandle stagingHandle;
+        stagingHandle.buffer = vulkan_raii::make_buffer(span.buffer, coordinator->getContext());
+        stagingHandle.buffer.detach();
+        
+        coordinator->copyBufferToBuffer(
+            stagingHandle,
+            *storageHandle,
+            span.size,
+            span.offset,
+            dstOffset
+        );
+        dstOffset += span.size;
+    }
+    executor->endImmediateBatch();
     
     resetStaging();
 }
 
 void GPUBuffer::resetStaging() {
+    stagedSpans.clear();
     stagingBytesWritten = 0;
-    stagingStartOffset = 0;
     needsUpload = false;
 }
\ No newline at end of file
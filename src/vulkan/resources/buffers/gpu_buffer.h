@@ -3,6 +3,7 @@
 #define VK_NO_PROTOTYPES
 #include <vulkan/vulkan.h>
 #include <memory>
+#include <vector>
 #include "../core/resource_handle.h"
 #include "../core/resource_coordinator.h"
 class BufferManager;
@@ -38,9 +39,14 @@ private:
     BufferManager* bufferManager = nullptr;
     VkDeviceSize bufferSize = 0;
     
-    // Staging state for device-local buffers
+    // Staging state for device-local buffers; consecutive regions can land in different staging segments
+    struct StagedSpan {
+        VkBuffer buffer = VK_NULL_HANDLE;
+        VkDeviceSize offset = 0;
+        VkDeviceSize size = 0;
+    };
+    std::vector<StagedSpan> stagedSpans;
     VkDeviceSize stagingBytesWritten = 0;
-    VkDeviceSize stagingStartOffset = 0;
     bool needsUpload = false;
     bool isDeviceLocal = false;
 };
\ No newline at end of file
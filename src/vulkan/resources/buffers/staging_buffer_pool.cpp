@@ -1,7 +1,5 @@
 #include "staging_buffer_pool.h"
-#include "../../core/vulkan_context.h"
-#include "../../core/vulkan_function_loader.h"
-#include "../../core/vulkan_raii.h"
+#include "buffer_factory.h"
 #include <iostream>
 #include <algorithm>
 
@@ -9,135 +7,100 @@ StagingBufferPool::~StagingBufferPool() {
     cleanup();
 }
 
-bool StagingBufferPool::initialize(const VulkanContext& context, VkDeviceSize size) {
-    this->context = &context;
-    this->totalSize = size;
-    this->currentOffset = 0;
-    
-    const auto& vk = context.getLoader();
-    const VkDevice device = context.getDevice();
-    
-    VkBufferCreateInfo bufferInfo{};
-    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
-    bufferInfo.size = size;
-    bufferInfo.usage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT;
-    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
-    
-    VkBuffer bufferHandle = VK_NULL_HANDLE;
-    if (vk.vkCreateBuffer(device, &bufferInfo, nullptr, &bufferHandle) != VK_SUCCESS) {
-        std::cerr << "Failed to create staging ring buffer!" << std::endl;
-        return false;
-    }
-    
-    VkMemoryRequirements memRequirements;
-    vk.vkGetBufferMemoryRequirements(device, bufferHandle, &memRequirements);
-    
-    VkPhysicalDeviceMemoryProperties memProperties;
-    vk.vkGetPhysicalDeviceMemoryProperties(context.getPhysicalDevice(), &memProperties);
-    
-    uint32_t memoryType = UINT32_MAX;
-    VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
-    
-    for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if ((memRequirements.memoryTypeBits & (1 << i)) && 
-            (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
-            memoryType = i;
-            break;
-        }
-    }
-    
-    if (memoryType == UINT32_MAX) {
-        std::cerr << "Failed to find suitable memory type for staging buffer!" << std::endl;
-        vk.vkDestroyBuffer(device, bufferHandle, nullptr);
-        return false;
-    }
-    
-    VkDeviceMemory memory;
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = memRequirements.size;
-    allocInfo.memoryTypeIndex = memoryType;
-    
-    if (vk.vkAllocateMemory(device, &allocInfo, nullptr, &memory) != VK_SUCCESS) {
-        std::cerr << "Failed to allocate staging buffer memory!" << std::endl;
-        vk.vkDestroyBuffer(device, bufferHandle, nullptr);
-        return false;
-    }
+bool StagingBufferPool::initialize(BufferFactory* bufferFactory, VkDeviceSize segmentSize) {
+    this->bufferFactory = bufferFactory;
+    this->segmentSize = segmentSize;
     
-    if (vk.vkBindBufferMemory(device, bufferHandle, memory, 0) != VK_SUCCESS) {
-        std::cerr << "Failed to bind staging buffer memory!" << std::endl;
-        vk.vkFreeMemory(device, memory, nullptr);
-        vk.vkDestroyBuffer(device, bufferHandle, nullptr);
+    if (!bufferFactory || segmentSize == 0) {
+        std::cerr << "StagingBufferPool: Invalid buffer factory or segment size" << std::endl;
         return false;
     }
     
-    if (vk.vkMapMemory(device, memory, 0, size, 0, &ringBuffer.mappedData) != VK_SUCCESS) {
-        std::cerr << "Failed to map staging buffer memory!" << std::endl;
-        vk.vkFreeMemory(device, memory, nullptr);
-        vk.vkDestroyBuffer(device, bufferHandle, nullptr);
+    Segment* segment = createSegment(segmentSize);
+    if (!segment) {
+        std::cerr << "Failed to create staging ring buffer!" << std::endl;
         return false;
     }
-    
-    ringBuffer.buffer = vulkan_raii::make_buffer(bufferHandle, &context);
-    ringBuffer.memory = vulkan_raii::make_device_memory(memory, &context);
-    ringBuffer.size = size;
+    freeSegments.push_back(segment);
     
     return true;
 }
 
 void StagingBufferPool::cleanup() {
-    if (context && ringBuffer.isValid()) {
-        if (ringBuffer.mappedData && ringBuffer.memory) {
-            context->getLoader().vkUnmapMemory(context->getDevice(), ringBuffer.memory.get());
+    if (bufferFactory) {
+        for (auto& segment : segments) {
+            bufferFactory->destroyResource(segment->handle);
         }
-        
-        ringBuffer.buffer.reset();
-        ringBuffer.memory.reset();
-        
-        ringBuffer.mappedData = nullptr;
-        ringBuffer.size = 0;
-        currentOffset = 0;
-        totalSize = 0;
-        totalWastedBytes = 0;
-        wrapAroundCount = 0;
-        largestFreeBlock = 0;
     }
-    context = nullptr;
+    
+    segments.clear();
+    freeSegments.clear();
+    for (auto& slot : frameSegments) {
+        slot.clear();
+    }
+    wastedBytes.fill(0);
+    currentSegment = nullptr;
+    totalSize = 0;
+    bufferFactory = nullptr;
+}
+
+void StagingBufferPool::beginFrame(uint32_t frameIndex) {
+    this->frameIndex = frameIndex % MAX_FRAMES_IN_FLIGHT;
+    frameCounter++;
+    
+    // The segment being filled belongs to the previous frame and retires with it
+    currentSegment = nullptr;
+    
+    auto& retired = frameSegments[this->frameIndex];
+    for (Segment* segment : retired) {
+        segment->cursor = 0;
+        freeSegments.push_back(segment);
+    }
+    retired.clear();
+    wastedBytes[this->frameIndex] = 0;
+    
+    releaseIdleSegments(STAGING_SEGMENT_IDLE_FRAMES);
 }
 
 StagingBufferPool::StagingRegion StagingBufferPool::allocate(VkDeviceSize size, VkDeviceSize alignment) {
     totalAllocations++;
     
-    if (!ringBuffer.isValid() || size == 0) {
+    if (!bufferFactory || size == 0) {
         failedAllocations++;
         return {};
     }
     
-    VkDeviceSize alignedOffset = ((currentOffset + alignment - 1) / alignment) * alignment;
-    VkDeviceSize wastedBytes = alignedOffset - currentOffset;
+    alignment = std::max<VkDeviceSize>(alignment, 1);
+    VkDeviceSize alignedOffset = 0;
     
-    if (alignedOffset + size > totalSize) {
-        alignedOffset = 0;
-        wastedBytes += totalSize - currentOffset;
-        wrapAroundCount++;
-        
-        if (size > totalSize) {
+    if (currentSegment) {
+        alignedOffset = ((currentSegment->cursor + alignment - 1) / alignment) * alignment;
+        if (alignedOffset + size > currentSegment->handle.size) {
+            wastedBytes[frameIndex] += currentSegment->handle.size - currentSegment->cursor;
+            currentSegment = nullptr;
+        }
+    }
+    
+    if (!currentSegment) {
+        currentSegment = acquireSegment(size);
+        if (!currentSegment) {
             failedAllocations++;
             return {};
         }
+        frameSegments[frameIndex].push_back(currentSegment);
+        alignedOffset = 0;
     }
     
-    totalWastedBytes += wastedBytes;
-    largestFreeBlock = std::max(largestFreeBlock, totalSize - (alignedOffset + size));
+    wastedBytes[frameIndex] += alignedOffset - currentSegment->cursor;
+    currentSegment->cursor = alignedOffset + size;
+    currentSegment->lastUsedFrame = frameCounter;
     
     StagingRegion region;
-    region.buffer = ringBuffer.buffer.get();
-    region.mappedData = static_cast<char*>(ringBuffer.mappedData) + alignedOffset;
+    region.buffer = currentSegment->handle.buffer.get();
+    region.mappedData = static_cast<char*>(currentSegment->handle.mappedData) + alignedOffset;
     region.offset = alignedOffset;
     region.size = size;
     
-    currentOffset = alignedOffset + size;
-    
     return region;
 }
 
@@ -146,35 +109,47 @@ StagingBufferPool::StagingRegionGuard StagingBufferPool::allocateGuarded(VkDevic
 }
 
 void StagingBufferPool::reset() {
-    currentOffset = 0;
-    totalWastedBytes = 0;
-    largestFreeBlock = totalSize;
+    currentSegment = nullptr;
+    for (auto& slot : frameSegments) {
+        for (Segment* segment : slot) {
+            segment->cursor = 0;
+            freeSegments.push_back(segment);
+        }
+        slot.clear();
+    }
+    wastedBytes.fill(0);
 }
 
 bool StagingBufferPool::tryDefragment() {
-    reset();
+    releaseIdleSegments(0);
     return true;
 }
 
 VkDeviceSize StagingBufferPool::getFragmentedBytes() const {
-    return totalWastedBytes;
+    VkDeviceSize total = 0;
+    for (VkDeviceSize bytes : wastedBytes) {
+        total += bytes;
+    }
+    return total;
 }
 
 bool StagingBufferPool::isFragmentationCritical() const {
     if (totalSize == 0) return false;
     
-    float fragmentationRatio = static_cast<float>(totalWastedBytes) / totalSize;
-    return fragmentationRatio > 0.3f || wrapAroundCount > 10;
+    float fragmentationRatio = static_cast<float>(getFragmentedBytes()) / totalSize;
+    return fragmentationRatio > 0.3f;
 }
 
 StagingBufferPool::PoolStats StagingBufferPool::getStats() const {
     PoolStats stats;
     stats.totalSize = totalSize;
-    stats.fragmentedBytes = totalWastedBytes;
-    stats.fragmentationRatio = totalSize > 0 ? static_cast<float>(totalWastedBytes) / totalSize : 0.0f;
+    stats.fragmentedBytes = getFragmentedBytes();
+    stats.fragmentationRatio = totalSize > 0 ? static_cast<float>(stats.fragmentedBytes) / totalSize : 0.0f;
     stats.fragmentationCritical = isFragmentationCritical();
     stats.allocations = totalAllocations;
     stats.failedAllocations = failedAllocations;
+    stats.segmentCount = static_cast<uint32_t>(segments.size());
+    stats.freeSegments = static_cast<uint32_t>(freeSegments.size());
     return stats;
 }
 
@@ -183,4 +158,53 @@ bool StagingBufferPool::isUnderPressure() const {
     
     float failureRate = static_cast<float>(failedAllocations) / totalAllocations;
     return failureRate > 0.1f || isFragmentationCritical();
-}
\ No newline at end of file
+}
+
+StagingBufferPool::Segment* StagingBufferPool::acquireSegment(VkDeviceSize minSize) {
+    // Smallest free segment that fits, so oversized ones stay available for large uploads
+    auto best = freeSegments.end();
+    for (auto it = freeSegments.begin(); it != freeSegments.end(); ++it) {
+        if ((*it)->handle.size >= minSize && (best == freeSegments.end() || (*it)->handle.size < (*best)->handle.size)) {
+            best = it;
+        }
+    }
+    
+    if (best != freeSegments.end()) {
+        Segment* segment = *best;
+        freeSegments.erase(best);
+        return segment;
+    }
+    
+    return createSegment(std::max(segmentSize, minSize));
+}
+
+StagingBufferPool::Segment* StagingBufferPool::createSegment(VkDeviceSize size) {
+    auto segment = std::make_unique<Segment>();
+    segment->handle = bufferFactory->createMappedBuffer(size, VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+        VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+    if (!segment->handle.isValid() || !segment->handle.mappedData) {
+        std::cerr << "StagingBufferPool: Failed to create " << size << " byte staging segment" << std::endl;
+        return nullptr;
+    }
+    
+    segment->lastUsedFrame = frameCounter;
+    totalSize += size;
+    segments.push_back(std::move(segment));
+    return segments.back().get();
+}
+
+void StagingBufferPool::releaseIdleSegments(uint64_t idleFrames) {
+    for (auto it = freeSegments.begin(); it != freeSegments.end() && segments.size() > 1;) {
+        Segment* segment = *it;
+        if (frameCounter - segment->lastUsedFrame < idleFrames) {
+            ++it;
+            continue;
+        }
+        
+        totalSize -= segment->handle.size;
+        bufferFactory->destroyResource(segment->handle);
+        segments.erase(std::find_if(segments.begin(), segments.end(),
+            [segment](const auto& owned) { return owned.get() == segment; }));
+        it = freeSegments.erase(it);
+    }
+}
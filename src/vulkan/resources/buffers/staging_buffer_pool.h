@@ -2,16 +2,25 @@
 
 #define VK_NO_PROTOTYPES
 #include <vulkan/vulkan.h>
+#include <array>
+#include <memory>
+#include <vector>
 #include "../core/resource_handle.h"
+#include "../../core/vulkan_constants.h"
 
-class VulkanContext;
+class BufferFactory;
 
+// Upload staging carved from persistently mapped segments. Every segment allocated from since a frame slot's
+// last beginFrame() belongs to that slot and goes back to the free list only once the slot's fences have
+// signalled, so a region stays valid for everything the frame submits and uploads never wait on the GPU.
+// A request that does not fit the current segment moves to a free segment, or a new one sized to fit;
+// free segments beyond the initial one are released after STAGING_SEGMENT_IDLE_FRAMES frames unused.
 class StagingBufferPool {
 public:
     StagingBufferPool() = default;
     ~StagingBufferPool();
     
-    bool initialize(const VulkanContext& context, VkDeviceSize size);
+    bool initialize(BufferFactory* bufferFactory, VkDeviceSize segmentSize);
     void cleanup();
     
     struct StagingRegion {
@@ -33,7 +42,7 @@ public:
         StagingRegionGuard(const StagingRegionGuard&) = delete;
         StagingRegionGuard& operator=(const StagingRegionGuard&) = delete;
         
-        StagingRegionGuard(StagingRegionGuard&& other) noexcept 
+        StagingRegionGuard(StagingRegionGuard&& other) noexcept
             : stagingPool(other.stagingPool), region(other.region) {
             other.stagingPool = nullptr;
             other.region = {};
@@ -54,21 +63,26 @@ public:
         
         const StagingRegion* operator->() const { return &region; }
         const StagingRegion& operator*() const { return region; }
-        
+    
     private:
         StagingBufferPool* stagingPool;
         StagingRegion region;
     };
     
+    // Retire what frameIndex allocated while it was last current - call after waiting on that slot's fences
+    void beginFrame(uint32_t frameIndex);
+    
     StagingRegion allocate(VkDeviceSize size, VkDeviceSize alignment = 1);
     StagingRegionGuard allocateGuarded(VkDeviceSize size, VkDeviceSize alignment = 1);
+    
+    // Retires every frame slot at once; only safe while the GPU is idle
     void reset();
     
+    // Releases every idle segment beyond the initial one
     bool tryDefragment();
     VkDeviceSize getFragmentedBytes() const;
     bool isFragmentationCritical() const;
     
-    VkBuffer getBuffer() const { return ringBuffer.buffer.get(); }
     VkDeviceSize getTotalSize() const { return totalSize; }
     
     struct PoolStats {
@@ -78,21 +92,38 @@ public:
         bool fragmentationCritical = false;
         uint32_t allocations = 0;
         uint32_t failedAllocations = 0;
+        uint32_t segmentCount = 0;
+        uint32_t freeSegments = 0;
     };
     
     PoolStats getStats() const;
     bool isUnderPressure() const;
-    
+
 private:
-    const VulkanContext* context = nullptr;
-    ResourceHandle ringBuffer;
-    VkDeviceSize currentOffset = 0;
+    struct Segment {
+        ResourceHandle handle;
+        VkDeviceSize cursor = 0;
+        uint64_t lastUsedFrame = 0;
+    };
+    
+    Segment* acquireSegment(VkDeviceSize minSize);
+    Segment* createSegment(VkDeviceSize size);
+    void releaseIdleSegments(uint64_t idleFrames);
+    
+    BufferFactory* bufferFactory = nullptr;
+    VkDeviceSize segmentSize = 0;
     VkDeviceSize totalSize = 0;
     
-    VkDeviceSize totalWastedBytes = 0;
-    uint32_t wrapAroundCount = 0;
-    VkDeviceSize largestFreeBlock = 0;
+    std::vector<std::unique_ptr<Segment>> segments;
+    std::vector<Segment*> freeSegments;
+    std::array<std::vector<Segment*>, MAX_FRAMES_IN_FLIGHT> frameSegments;  // Retired with their frame slot
+    Segment* currentSegment = nullptr;
+    uint32_t frameIndex = 0;
+    uint64_t frameCounter = 0;
+    
+    // Alignment padding and segment tails skipped by each slot's allocations
+    std::array<VkDeviceSize, MAX_FRAMES_IN_FLIGHT> wastedBytes{};
     
     mutable uint32_t totalAllocations = 0;
     mutable uint32_t failedAllocations = 0;
-};
\ No newline at end of file
+};
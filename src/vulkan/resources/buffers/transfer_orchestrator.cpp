@@ -104,51 +104,23 @@ bool TransferOrchestrator::executeBatch(const TransferBatch& batch) {
         return true;
     }
     
-    bool allSucceeded = true;
-    VkDeviceSize totalBytes = 0;
+    CommandExecutor::AsyncTransfer transfer;
+    bool success = submitBatch(batch, false, transfer);
     
-    for (const auto& transfer : batch.transfers) {
-        if (!transfer.data || !transfer.dstBuffer || transfer.size == 0) {
-            allSucceeded = false;
-            continue;
-        }
-        
-        bool success = copyToBuffer(*transfer.dstBuffer, transfer.data, transfer.size, transfer.offset);
-        if (!success) {
-            allSucceeded = false;
-        } else {
-            totalBytes += transfer.size;
-        }
-    }
-    
-    if (totalBytes > 0) {
-        updateTransferStats(totalBytes, false, true);
+    if (transfer.isValid()) {
+        executor->waitForTransfer(transfer);
+        executor->freeAsyncTransfer(transfer);
     }
     
-    return allSucceeded;
+    return success;
 }
 
 CommandExecutor::AsyncTransfer TransferOrchestrator::executeBatchAsync(const TransferBatch& batch) {
-    if (batch.empty()) {
-        return {};
-    }
-    
-    VkDeviceSize totalBytes = 0;
-    
-    for (const auto& transfer : batch.transfers) {
-        if (!transfer.data || !transfer.dstBuffer || transfer.size == 0) {
-            continue;
-        }
-        
-        auto asyncResult = copyToBufferAsync(*transfer.dstBuffer, transfer.data, transfer.size, transfer.offset);
-        totalBytes += transfer.size;
-    }
-    
-    if (totalBytes > 0) {
-        updateTransferStats(totalBytes, true, true);
+    CommandExecutor::AsyncTransfer transfer;
+    if (!batch.empty()) {
+        submitBatch(batch, true, transfer);
     }
-    
-    return {};
+    return transfer;
 }
 
 bool TransferOrchestrator::mapAndCopyToBuffer(const ResourceHandle& dst, const void* data, VkDeviceSize size, VkDeviceSize offset) {
@@ -218,7 +190,7 @@ bool TransferOrchestrator::copyStagedToBuffer(const ResourceHandle& dst, const v
     // Create a temporary ResourceHandle for the staging buffer region
     ResourceHandle stagingHandle;
     stagingHandle.buffer = vulkan_raii::make_buffer(stagingRegion.buffer, bufferRegistry->getResourceCoordinator()->getContext());
-    stagingHandle.size = stagingPool->getTotalSize(); // Use total staging buffer size
+    stagingHandle.size = stagingRegion.offset + stagingRegion.size; // Its segment reaches at least this far
     stagingHandle.mappedData = nullptr; // Staging buffer is already mapped, but we don't expose that here
     
     bufferRegistry->getBufferFactory()->copyBufferToBuffer(stagingHandle, dst, size, stagingRegion.offset, offset);
@@ -243,6 +215,76 @@ CommandExecutor::AsyncTransfer TransferOrchestrator::copyStagedToBufferAsync(con
     return executor->copyBufferToBufferAsync(stagingRegion.buffer, dst.buffer.get(), size, stagingRegion.offset, offset);
 }
 
+bool TransferOrchestrator::submitBatch(const TransferBatch& batch, bool wasAsync, CommandExecutor::AsyncTransfer& transfer) {
+    if (!stagingPool || !executor) {
+        return false;
+    }
+    
+    bool allSucceeded = true;
+    VkDeviceSize totalBytes = 0;
+    VkDeviceSize stagedBytes = 0;
+    
+    // Host-visible destinations are written in place; everything else shares one staging allocation
+    for (const auto& entry : batch.transfers) {
+        if (!entry.data || !entry.dstBuffer || !entry.dstBuffer->isValid() || entry.size == 0) {
+            allSucceeded = false;
+            continue;
+        }
+        
+        if (BufferOperationUtils::isBufferHostVisible(*entry.dstBuffer)) {
+            if (BufferOperationUtils::copyDirectToMappedBuffer(*entry.dstBuffer, entry.data, entry.size, entry.offset)) {
+                totalBytes += entry.size;
+            } else {
+                allSucceeded = false;
+            }
+        } else {
+            stagedBytes += entry.size;
+        }
+    }
+    
+    if (stagedBytes > 0) {
+        auto stagingRegion = stagingPool->allocate(stagedBytes);
+        if (!stagingRegion.isValid()) {
+            ValidationUtils::logError("TransferOrchestrator", "submitBatch", "failed to allocate batch staging");
+            return false;
+        }
+        
+        std::vector<CommandExecutor::BufferRegionCopy> copies;
+        copies.reserve(batch.size());
+        
+        VkDeviceSize packedOffset = 0;
+        for (const auto& entry : batch.transfers) {
+            if (!entry.data || !entry.dstBuffer || !entry.dstBuffer->isValid() || entry.size == 0 ||
+                BufferOperationUtils::isBufferHostVisible(*entry.dstBuffer)) {
+                continue;
+            }
+            memcpy(static_cast<char*>(stagingRegion.mappedData) + packedOffset, entry.data, entry.size);
+            
+            CommandExecutor::BufferRegionCopy copy{};
+            copy.dst = entry.dstBuffer->buffer.get();
+            copy.region.srcOffset = stagingRegion.offset + packedOffset;
+            copy.region.dstOffset = entry.offset;
+            copy.region.size = entry.size;
+            copies.push_back(copy);
+            
+            packedOffset += entry.size;
+        }
+        
+        transfer = executor->copyBufferRegionsAsync(stagingRegion.buffer, copies);
+        if (transfer.isValid()) {
+            totalBytes += stagedBytes;
+        } else {
+            allSucceeded = false;
+        }
+    }
+    
+    if (totalBytes > 0) {
+        updateTransferStats(totalBytes, wasAsync, true);
+    }
+    
+    return allSucceeded;
+}
+
 void TransferOrchestrator::updateTransferStats(VkDeviceSize bytesTransferred, bool wasAsync, bool wasBatch) {
     transferStats.totalTransfers++;
     transferStats.totalBytesTransferred += bytesTransferred;
@@ -47,6 +47,9 @@ public:
     CommandExecutor::AsyncTransfer copyBufferToBufferAsync(const ResourceHandle& src, const ResourceHandle& dst,
                                                           VkDeviceSize size, VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
     
+    // Staged transfers are packed into one staging allocation and recorded into one command buffer, one
+    // vkCmdCopyBuffer per destination. The async token is invalid when nothing needed staging or the submit
+    // failed; its staging is retired with the current frame slot, so it must land within the frames in flight
     bool executeBatch(const TransferBatch& batch);
     CommandExecutor::AsyncTransfer executeBatchAsync(const TransferBatch& batch);
     
@@ -81,6 +84,7 @@ private:
     bool requiresStaging(const ResourceHandle& buffer) const;
     bool copyStagedToBuffer(const ResourceHandle& dst, const void* data, VkDeviceSize size, VkDeviceSize offset);
     CommandExecutor::AsyncTransfer copyStagedToBufferAsync(const ResourceHandle& dst, const void* data, VkDeviceSize size, VkDeviceSize offset);
+    bool submitBatch(const TransferBatch& batch, bool wasAsync, CommandExecutor::AsyncTransfer& transfer);
     
     void updateTransferStats(VkDeviceSize bytesTransferred, bool wasAsync = false, bool wasBatch = false);
 };
\ No newline at end of file
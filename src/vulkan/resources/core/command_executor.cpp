@@ -1,9 +1,22 @@
 #include "command_executor.h"
 #include "../../core/vulkan_context.h"
 #include "../../core/vulkan_function_loader.h"
-#include "../../core/vulkan_utils.h"
 #include <iostream>
 
+namespace {
+// Multi-device simulation: uploads run on every GPU of the group, so each GPU's instance of a replicated
+// buffer gets the same contents. A mask of 0 (no device group) leaves the submit as it is
+void chainDeviceMask(VkSubmitInfo& submitInfo, VkDeviceGroupSubmitInfoKHR& deviceGroupInfo, const uint32_t& deviceMask) {
+    if (deviceMask == 0) {
+        return;
+    }
+    deviceGroupInfo.sType = VK_STRUCTURE_TYPE_DEVICE_GROUP_SUBMIT_INFO_KHR;
+    deviceGroupInfo.commandBufferCount = submitInfo.commandBufferCount;
+    deviceGroupInfo.pCommandBufferDeviceMasks = &deviceMask;
+    submitInfo.pNext = &deviceGroupInfo;
+}
+}
+
 CommandExecutor::CommandExecutor() {
 }
 
@@ -33,8 +46,11 @@ void CommandExecutor::cleanup() {
 }
 
 void CommandExecutor::cleanupBeforeContextDestruction() {
-    // QueueManager handles cleanup of its own resources
-    // No manual cleanup needed here
+    // QueueManager handles cleanup of its own resources; the immediate command buffer goes with its pool
+    immediateFence.reset();
+    immediateCommandBuffer = VK_NULL_HANDLE;
+    immediateRecording = false;
+    immediateBatchDepth = 0;
 }
 
 void CommandExecutor::copyBufferToBuffer(VkBuffer src, VkBuffer dst, VkDeviceSize size, 
@@ -54,20 +70,11 @@ void CommandExecutor::copyBufferToBuffer(VkBuffer src, VkBuffer dst, VkDeviceSiz
         return;
     }
     
-    // Use graphics command pool for synchronous operations
-    VkCommandPool commandPool = queueManager->getCommandPool(CommandPoolType::Graphics);
-    
-    if (commandPool == VK_NULL_HANDLE) {
-        std::cerr << "CommandExecutor: No valid graphics command pool available!" << std::endl;
+    VkCommandBuffer commandBuffer = beginImmediateCommands();
+    if (commandBuffer == VK_NULL_HANDLE) {
         return;
     }
     
-    VkCommandBuffer commandBuffer = VulkanUtils::beginSingleTimeCommands(
-        context->getDevice(), 
-        context->getLoader(), 
-        commandPool
-    );
-    
     VkBufferCopy copyRegion{};
     copyRegion.srcOffset = srcOffset;
     copyRegion.dstOffset = dstOffset;
@@ -75,14 +82,127 @@ void CommandExecutor::copyBufferToBuffer(VkBuffer src, VkBuffer dst, VkDeviceSiz
     
     context->getLoader().vkCmdCopyBuffer(commandBuffer, src, dst, 1, &copyRegion);
     
-    // Use graphics queue for synchronous completion
-    VulkanUtils::endSingleTimeCommands(
-        context->getDevice(),
-        context->getLoader(),
-        queueManager->getGraphicsQueue(),
-        commandPool,
-        commandBuffer
-    );
+    if (immediateBatchDepth == 0) {
+        submitImmediateCommands();
+    }
+}
+
+void CommandExecutor::readBufferToHost(VkBuffer src, VkBuffer dst, VkDeviceSize size,
+                                       VkDeviceSize srcOffset, VkDeviceSize dstOffset) {
+    // Batched copies go first with the default mask
+    if (immediateRecording && !submitImmediateCommands()) {
+        return;
+    }
+    
+    immediateDeviceMask = context ? context->getSimulationDeviceMask() : 0;
+    const uint32_t batchDepth = immediateBatchDepth;
+    immediateBatchDepth = 0;
+    copyBufferToBuffer(src, dst, size, srcOffset, dstOffset);
+    immediateBatchDepth = batchDepth;
+    immediateDeviceMask = 0;
+}
+
+void CommandExecutor::beginImmediateBatch() {
+    ++immediateBatchDepth;
+}
+
+bool CommandExecutor::endImmediateBatch() {
+    if (immediateBatchDepth == 0) {
+        return true;
+    }
+    if (--immediateBatchDepth > 0) {
+        return true;
+    }
+    return submitImmediateCommands();
+}
+
+VkCommandBuffer CommandExecutor::beginImmediateCommands() {
+    if (immediateRecording) {
+        return immediateCommandBuffer;
+    }
+    
+    const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
+    
+    // Allocated once from the graphics pool, whose RESET_COMMAND_BUFFER flag lets each begin reset it
+    if (immediateCommandBuffer == VK_NULL_HANDLE) {
+        VkCommandPool commandPool = queueManager->getCommandPool(CommandPoolType::Graphics);
+        if (commandPool == VK_NULL_HANDLE) {
+            std::cerr << "CommandExecutor: No valid graphics command pool available!" << std::endl;
+            return VK_NULL_HANDLE;
+        }
+        
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        immediateFence = vulkan_raii::create_fence(context, &fenceInfo);
+        if (!immediateFence) {
+            std::cerr << "CommandExecutor: Failed to create immediate fence!" << std::endl;
+            return VK_NULL_HANDLE;
+        }
+        
+        VkCommandBufferAllocateInfo allocInfo{};
+        allocInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        allocInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        allocInfo.commandPool = commandPool;
+        allocInfo.commandBufferCount = 1;
+        
+        if (vk.vkAllocateCommandBuffers(device, &allocInfo, &immediateCommandBuffer) != VK_SUCCESS) {
+            std::cerr << "CommandExecutor: Failed to allocate immediate command buffer!" << std::endl;
+            immediateCommandBuffer = VK_NULL_HANDLE;
+            return VK_NULL_HANDLE;
+        }
+    }
+    
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    
+    if (vk.vkBeginCommandBuffer(immediateCommandBuffer, &beginInfo) != VK_SUCCESS) {
+        std::cerr << "CommandExecutor: Failed to begin immediate command buffer!" << std::endl;
+        return VK_NULL_HANDLE;
+    }
+    
+    immediateRecording = true;
+    return immediateCommandBuffer;
+}
+
+bool CommandExecutor::submitImmediateCommands() {
+    if (!immediateRecording) {
+        return true;
+    }
+    immediateRecording = false;
+    
+    const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
+    
+    if (vk.vkEndCommandBuffer(immediateCommandBuffer) != VK_SUCCESS) {
+        std::cerr << "CommandExecutor: Failed to end immediate command buffer!" << std::endl;
+        return false;
+    }
+    
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &immediateCommandBuffer;
+    const uint32_t deviceMask = immediateDeviceMask != 0 ? immediateDeviceMask : context->getAllDevicesMask();
+    VkDeviceGroupSubmitInfoKHR deviceGroupInfo{};
+    chainDeviceMask(submitInfo, deviceGroupInfo, deviceMask);
+    
+    // The fence covers only this submission, so frames already queued on the graphics queue are not drained
+    VkFence fence = immediateFence.get();
+    if (vk.vkQueueSubmit(queueManager->getGraphicsQueue(), 1, &submitInfo, fence) != VK_SUCCESS) {
+        std::cerr << "CommandExecutor: Failed to submit immediate commands!" << std::endl;
+        return false;
+    }
+    queueManager->getTelemetry().recordSubmission(CommandPoolType::Graphics);
+    
+    VkResult waitResult = vk.vkWaitForFences(device, 1, &fence, VK_TRUE, UINT64_MAX);
+    vk.vkResetFences(device, 1, &fence);
+    if (waitResult != VK_SUCCESS) {
+        std::cerr << "CommandExecutor: Failed to wait for immediate commands: " << waitResult << std::endl;
+        return false;
+    }
+    return true;
 }
 
 CommandExecutor::AsyncTransfer CommandExecutor::copyBufferToBufferAsync(VkBuffer src, VkBuffer dst, VkDeviceSize size,
@@ -135,6 +255,9 @@ CommandExecutor::AsyncTransfer CommandExecutor::copyBufferToBufferAsync(VkBuffer
     submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
     submitInfo.commandBufferCount = 1;
     submitInfo.pCommandBuffers = &transfer.commandBuffer;
+    const uint32_t deviceMask = context->getAllDevicesMask();
+    VkDeviceGroupSubmitInfoKHR deviceGroupInfo{};
+    chainDeviceMask(submitInfo, deviceGroupInfo, deviceMask);
     
     VkQueue transferQueue = queueManager->getTransferQueue();
     if (vk.vkQueueSubmit(transferQueue, 1, &submitInfo, transfer.fence.get()) != VK_SUCCESS) {
@@ -146,6 +269,83 @@ CommandExecutor::AsyncTransfer CommandExecutor::copyBufferToBufferAsync(VkBuffer
     return transfer;
 }
 
+CommandExecutor::AsyncTransfer CommandExecutor::copyBufferRegionsAsync(VkBuffer src, const std::vector<BufferRegionCopy>& copies) {
+    if (!context || !queueManager) {
+        std::cerr << "CommandExecutor: Not properly initialized for async transfers!" << std::endl;
+        return {};
+    }
+    
+    if (src == VK_NULL_HANDLE || copies.empty()) {
+        std::cerr << "CommandExecutor: Invalid parameters for batched async transfer!" << std::endl;
+        return {};
+    }
+    
+    AsyncTransfer transfer = queueManager->allocateTransferCommand();
+    if (!transfer.isValid()) {
+        std::cerr << "CommandExecutor: Failed to allocate transfer command from QueueManager!" << std::endl;
+        return {};
+    }
+    
+    const auto& vk = context->getLoader();
+    
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    
+    if (vk.vkBeginCommandBuffer(transfer.commandBuffer, &beginInfo) != VK_SUCCESS) {
+        std::cerr << "CommandExecutor: Failed to begin transfer command buffer!" << std::endl;
+        queueManager->freeTransferCommand(transfer);
+        return {};
+    }
+    
+    // One vkCmdCopyBuffer per destination, carrying every region bound for it
+    std::vector<bool> recorded(copies.size(), false);
+    std::vector<VkBufferCopy> regions;
+    regions.reserve(copies.size());
+    for (size_t i = 0; i < copies.size(); ++i) {
+        if (recorded[i] || copies[i].dst == VK_NULL_HANDLE) {
+            continue;
+        }
+        
+        regions.clear();
+        for (size_t j = i; j < copies.size(); ++j) {
+            if (!recorded[j] && copies[j].dst == copies[i].dst) {
+                recorded[j] = true;
+                if (copies[j].region.size > 0) {
+                    regions.push_back(copies[j].region);
+                }
+            }
+        }
+        
+        if (!regions.empty()) {
+            vk.vkCmdCopyBuffer(transfer.commandBuffer, src, copies[i].dst, static_cast<uint32_t>(regions.size()), regions.data());
+        }
+    }
+    
+    if (vk.vkEndCommandBuffer(transfer.commandBuffer) != VK_SUCCESS) {
+        std::cerr << "CommandExecutor: Failed to end transfer command buffer!" << std::endl;
+        queueManager->freeTransferCommand(transfer);
+        return {};
+    }
+    
+    VkSubmitInfo submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+    submitInfo.commandBufferCount = 1;
+    submitInfo.pCommandBuffers = &transfer.commandBuffer;
+    const uint32_t deviceMask = context->getAllDevicesMask();
+    VkDeviceGroupSubmitInfoKHR deviceGroupInfo{};
+    chainDeviceMask(submitInfo, deviceGroupInfo, deviceMask);
+    
+    VkQueue transferQueue = queueManager->getTransferQueue();
+    if (vk.vkQueueSubmit(transferQueue, 1, &submitInfo, transfer.fence.get()) != VK_SUCCESS) {
+        std::cerr << "CommandExecutor: Failed to submit batched async transfer command buffer!" << std::endl;
+        queueManager->freeTransferCommand(transfer);
+        return {};
+    }
+    
+    return transfer;
+}
+
 bool CommandExecutor::isTransferComplete(const AsyncTransfer& transfer) {
     if (!queueManager) {
         return true; // Invalid state is considered complete
@@ -165,6 +365,16 @@ void CommandExecutor::freeAsyncTransfer(AsyncTransfer& transfer) {
     }
 }
 
+void CommandExecutor::retireAsyncTransfer(AsyncTransfer& transfer) {
+    if (queueManager) {
+        queueManager->retireTransferCommand(transfer);
+    }
+}
+
+uint32_t CommandExecutor::pollCompletedTransfers() {
+    return queueManager ? queueManager->pollCompletedTransfers() : 0;
+}
+
 bool CommandExecutor::usesDedicatedTransferQueue() const {
     return queueManager ? queueManager->hasDedicatedTransferQueue() : false;
 }
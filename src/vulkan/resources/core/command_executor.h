@@ -4,6 +4,7 @@
 #include <vulkan/vulkan.h>
 #include "../../core/vulkan_raii.h"
 #include "../../core/queue_manager.h"
+#include <vector>
 
 class VulkanContext;
 
@@ -21,19 +22,41 @@ public:
     bool initialize(const VulkanContext& context, QueueManager* queueManager);
     void cleanup();
     
-    // Synchronous transfer (uses graphics queue for immediate completion)
+    // Synchronous transfer (uses graphics queue for immediate completion), recorded into the reused immediate
+    // command buffer and waited on through its fence
     void copyBufferToBuffer(VkBuffer src, VkBuffer dst, VkDeviceSize size, 
                            VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
     
+    // copyBufferToBuffer into a host-visible readback buffer, submitted on its own (after anything batched).
+    // Under multi-device simulation it runs on the simulation GPU alone: device-local streams are current in
+    // its instance only, and the host memory has a single one the GPUs would otherwise both write
+    void readBufferToHost(VkBuffer src, VkBuffer dst, VkDeviceSize size,
+                          VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
+    
+    // Batches synchronous copies until the outermost endImmediateBatch, which submits them once and waits on
+    // one fence. Until then sources must stay alive and destinations unread, and copies must not overlap
+    void beginImmediateBatch();
+    bool endImmediateBatch();
+    
     // Async transfer with optimal queue selection
     using AsyncTransfer = QueueManager::TransferCommand;
     
     AsyncTransfer copyBufferToBufferAsync(VkBuffer src, VkBuffer dst, VkDeviceSize size,
                                          VkDeviceSize srcOffset = 0, VkDeviceSize dstOffset = 0);
     
+    // Batched async transfer - every region is recorded into one command buffer and one submit
+    struct BufferRegionCopy {
+        VkBuffer dst = VK_NULL_HANDLE;
+        VkBufferCopy region{};
+    };
+    
+    AsyncTransfer copyBufferRegionsAsync(VkBuffer src, const std::vector<BufferRegionCopy>& copies);
+    
     bool isTransferComplete(const AsyncTransfer& transfer);
     void waitForTransfer(const AsyncTransfer& transfer);
     void freeAsyncTransfer(AsyncTransfer& transfer);
+    void retireAsyncTransfer(AsyncTransfer& transfer);  // Recycled once complete, for callers that never wait on it
+    uint32_t pollCompletedTransfers();
     
     // Queue capability queries
     bool usesDedicatedTransferQueue() const;
@@ -46,4 +69,14 @@ public:
 private:
     const VulkanContext* context = nullptr;
     QueueManager* queueManager = nullptr;
+    
+    // Immediate submit context on the graphics queue
+    VkCommandBuffer immediateCommandBuffer = VK_NULL_HANDLE;
+    vulkan_raii::Fence immediateFence;
+    bool immediateRecording = false;
+    uint32_t immediateBatchDepth = 0;
+    uint32_t immediateDeviceMask = 0;  // Next immediate submit's device mask, 0 for every GPU
+    
+    VkCommandBuffer beginImmediateCommands();
+    bool submitImmediateCommands();
 };
\ No newline at end of file
@@ -0,0 +1,89 @@
+#include "frame_ring_allocator.h"
+#include "resource_coordinator.h"
+#include "../../core/vulkan_context.h"
+#include "../../core/vulkan_function_loader.h"
+#include "../../core/vulkan_constants.h"
+#include <algorithm>
+#include <cstring>
+#include <iostream>
+
+bool FrameRingAllocator::initialize(ResourceCoordinator* resourceCoordinator, VkDeviceSize bytesPerFrame) {
+    this->resourceCoordinator = resourceCoordinator;
+    
+    const VulkanContext* context = resourceCoordinator ? resourceCoordinator->getContext() : nullptr;
+    if (!context) {
+        std::cerr << "FrameRingAllocator: ResourceCoordinator has no context" << std::endl;
+        return false;
+    }
+    
+    // One alignment satisfies both dynamic uniform and dynamic storage offsets
+    VkPhysicalDeviceProperties properties{};
+    context->getLoader().vkGetPhysicalDeviceProperties(context->getPhysicalDevice(), &properties);
+    alignment = std::max(properties.limits.minUniformBufferOffsetAlignment,
+                         properties.limits.minStorageBufferOffsetAlignment);
+    alignment = std::max<VkDeviceSize>(alignment, 1);
+    
+    // Regions start on an aligned boundary so every dynamic offset is aligned
+    this->bytesPerFrame = (bytesPerFrame + alignment - 1) / alignment * alignment;
+    
+    // Rewritten every frame and read by every draw, so it goes to device-local memory when the host can map it.
+    // Per-frame instance data (the performance HUD's quads) is bound straight from it as a vertex buffer
+    ringBuffer = resourceCoordinator->createHostWriteBuffer(
+        this->bytesPerFrame * context->getFramesInFlight(),
+        VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT);
+    
+    if (!ringBuffer.isValid() || !ringBuffer.mappedData) {
+        std::cerr << "FrameRingAllocator: Failed to create persistent mapped ring buffer" << std::endl;
+        return false;
+    }
+    
+    frameCount = context->getFramesInFlight();
+    frameIndex = 0;
+    cursor = 0;
+    return true;
+}
+
+void FrameRingAllocator::cleanup() {
+    if (ringBuffer.isValid() && resourceCoordinator) {
+        resourceCoordinator->destroyResource(ringBuffer);
+    }
+    ringBuffer = {};
+    bytesPerFrame = 0;
+    cursor = 0;
+}
+
+void FrameRingAllocator::beginFrame(uint32_t frameIndex) {
+    this->frameIndex = frameIndex % frameCount;
+    cursor = 0;
+}
+
+FrameRingAllocator::Allocation FrameRingAllocator::allocate(VkDeviceSize size) {
+    if (!ringBuffer.mappedData || size == 0) {
+        return {};
+    }
+    
+    const VkDeviceSize alignedSize = (size + alignment - 1) / alignment * alignment;
+    if (cursor + alignedSize > bytesPerFrame) {
+        std::cerr << "FrameRingAllocator: Frame region exhausted (" << cursor << " + " << alignedSize
+                  << " > " << bytesPerFrame << " bytes)" << std::endl;
+        return {};
+    }
+    
+    const VkDeviceSize offset = frameIndex * bytesPerFrame + cursor;
+    cursor += alignedSize;
+    
+    Allocation allocation;
+    allocation.mapped = static_cast<char*>(ringBuffer.mappedData) + offset;
+    allocation.buffer = ringBuffer.buffer.get();
+    allocation.dynamicOffset = static_cast<uint32_t>(offset);
+    allocation.size = size;
+    return allocation;
+}
+
+FrameRingAllocator::Allocation FrameRingAllocator::push(const void* data, VkDeviceSize size) {
+    Allocation allocation = allocate(size);
+    if (allocation.isValid()) {
+        std::memcpy(allocation.mapped, data, static_cast<size_t>(size));
+    }
+    return allocation;
+}
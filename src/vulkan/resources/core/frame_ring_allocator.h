@@ -0,0 +1,52 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include "resource_handle.h"
+
+class ResourceCoordinator;
+
+// Transient per-frame constants: one persistent mapped buffer split into one region per frame in flight.
+// A region is only rewound once its frame slot's fences have signalled, so writes never race the GPU
+// and callers need no dirty tracking - they simply push fresh data every frame.
+class FrameRingAllocator {
+public:
+    struct Allocation {
+        void* mapped = nullptr;
+        VkBuffer buffer = VK_NULL_HANDLE;
+        uint32_t dynamicOffset = 0;  // For UNIFORM_BUFFER_DYNAMIC / STORAGE_BUFFER_DYNAMIC bindings
+        VkDeviceSize size = 0;
+        
+        bool isValid() const { return mapped != nullptr; }
+    };
+    
+    FrameRingAllocator() = default;
+    ~FrameRingAllocator() = default;
+    
+    bool initialize(ResourceCoordinator* resourceCoordinator, VkDeviceSize bytesPerFrame);
+    void cleanup();
+    
+    // Rewind the region of frameIndex - call after waiting on that frame slot's fences
+    void beginFrame(uint32_t frameIndex);
+    
+    // Sub-allocation aligned for uniform and storage offsets; invalid once the frame's region is full
+    Allocation allocate(VkDeviceSize size);
+    Allocation push(const void* data, VkDeviceSize size);
+    
+    // Stable for the allocator's lifetime, so descriptor sets only need writing once
+    VkBuffer getBuffer() const { return ringBuffer.buffer.get(); }
+    VkDeviceSize getBytesPerFrame() const { return bytesPerFrame; }
+    VkDeviceSize getAlignment() const { return alignment; }
+    
+private:
+    ResourceCoordinator* resourceCoordinator = nullptr;
+    ResourceHandle ringBuffer;
+    VkDeviceSize bytesPerFrame = 0;
+    VkDeviceSize alignment = 1;
+    
+    // Current frame region and bump cursor within it (one region per frame in flight)
+    uint32_t frameCount = 1;
+    uint32_t frameIndex = 0;
+    VkDeviceSize cursor = 0;
+};
@@ -3,25 +3,27 @@
 #include "validation_utils.h"
 #include "../../core/vulkan_context.h"
 #include "../../core/vulkan_function_loader.h"
+#include "../../core/vulkan_constants.h"
 #include <iostream>
 #include <stdexcept>
 #include <algorithm>
+#include <limits>
 
-// Simple VMA allocator replacement using manual allocation
-struct VmaAllocator_Impl {
-    VkDevice device;
-    VkPhysicalDevice physicalDevice;
-    const VulkanFunctionLoader* loader;
-    
-    struct Allocation {
-        VkDeviceMemory memory;
-        VkDeviceSize offset;
-        VkDeviceSize size;
-        void* mappedData;
-    };
-    
-    std::vector<Allocation> allocations;
-};
+namespace {
+
+VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+    return (value + alignment - 1) / alignment * alignment;
+}
+
+} // anonymous namespace
+
+float MemoryAllocator::getPriorityValue(Priority priority) {
+    switch (priority) {
+        case Priority::Low: return MEMORY_PRIORITY_LOW;
+        case Priority::High: return MEMORY_PRIORITY_HIGH;
+        default: return MEMORY_PRIORITY_NORMAL;
+    }
+}
 
 MemoryAllocator::MemoryAllocator() {
 }
@@ -32,25 +34,54 @@ MemoryAllocator::~MemoryAllocator() {
 
 bool MemoryAllocator::initialize(const VulkanContext& context) {
     this->context = &context;
-    
-    if (!initializeVMA()) {
-        return false;
+
+    const auto& vk = context.getLoader();
+    vk.vkGetPhysicalDeviceMemoryProperties(context.getPhysicalDevice(), &memoryProperties);
+
+    VkPhysicalDeviceProperties deviceProperties{};
+    vk.vkGetPhysicalDeviceProperties(context.getPhysicalDevice(), &deviceProperties);
+    nonCoherentAtomSize = std::max<VkDeviceSize>(deviceProperties.limits.nonCoherentAtomSize, 1);
+
+    memoryStats = {};
+    heapUsage.fill(0);
+    selectHostWriteMemoryType();
+
+    deviceLocalHeap = 0;
+    VkDeviceSize largestDeviceLocal = 0;
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++) {
+        const VkMemoryHeap& heap = memoryProperties.memoryHeaps[i];
+        if ((heap.flags & VK_MEMORY_HEAP_DEVICE_LOCAL_BIT) && heap.size > largestDeviceLocal) {
+            deviceLocalHeap = i;
+            largestDeviceLocal = heap.size;
+        }
     }
-    
+
+    driverBudgetValid = false;
+    residency = {};
+    refreshMemoryBudget();
     return true;
 }
 
 void MemoryAllocator::cleanup() {
-    cleanupVMA();
+    std::lock_guard<std::recursive_mutex> lock(allocationMutex);
+    if (!context) return;
+
+    if (memoryStats.dedicatedAllocations > 0) {
+        std::cerr << "MemoryAllocator: " << memoryStats.dedicatedAllocations
+                  << " dedicated allocations still live at cleanup" << std::endl;
+    }
+    releaseAllBlocks();
     context = nullptr;
 }
 
-MemoryAllocator::AllocationInfo MemoryAllocator::allocateMemory(VkMemoryRequirements requirements, 
-                                                                VkMemoryPropertyFlags properties) {
-    AllocationInfo allocation;
-    
+MemoryAllocator::AllocationInfo MemoryAllocator::allocateMemory(VkMemoryRequirements requirements,
+                                                                VkMemoryPropertyFlags properties,
+                                                                AllocationKind kind,
+                                                                Priority priority) {
+    if (!context) return {};
+
     uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, properties);
-    
+
     // Check memory pressure before allocation
     if (isUnderMemoryPressure()) {
         std::cerr << "Warning: GPU under memory pressure, attempting recovery..." << std::endl;
@@ -58,97 +89,201 @@ MemoryAllocator::AllocationInfo MemoryAllocator::allocateMemory(VkMemoryRequirem
             std::cerr << "Memory recovery failed, proceeding with risky allocation" << std::endl;
         }
     }
-    
-    VkMemoryAllocateInfo allocInfo{};
-    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
-    allocInfo.allocationSize = requirements.size;
-    allocInfo.memoryTypeIndex = memoryType;
-    
-    VkResult result = context->getLoader().vkAllocateMemory(context->getDevice(), &allocInfo, nullptr, &allocation.memory);
-    if (result != VK_SUCCESS) {
-        memoryStats.failedAllocations++;
-        
-        if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY || result == VK_ERROR_OUT_OF_HOST_MEMORY) {
-            std::cerr << "Out of memory - attempting emergency recovery..." << std::endl;
-            if (attemptMemoryRecovery()) {
-                // Retry allocation after recovery
-                result = context->getLoader().vkAllocateMemory(context->getDevice(), &allocInfo, nullptr, &allocation.memory);
+
+    AllocationInfo allocation = allocateMemoryOfType(requirements, memoryType, kind, priority);
+    if (allocation.memory == VK_NULL_HANDLE) {
+        std::cerr << "Critical: Memory allocation failed after recovery attempts!" << std::endl;
+    }
+    return allocation;
+}
+
+MemoryAllocator::AllocationInfo MemoryAllocator::allocateMemoryOfType(const VkMemoryRequirements& requirements,
+                                                                      uint32_t memoryTypeIndex,
+                                                                      AllocationKind kind,
+                                                                      Priority priority) {
+    std::lock_guard<std::recursive_mutex> lock(allocationMutex);
+    if (!context || memoryTypeIndex >= memoryProperties.memoryTypeCount ||
+        !(requirements.memoryTypeBits & (1u << memoryTypeIndex))) {
+        return {};
+    }
+
+    AllocationInfo allocation;
+    bool placed = false;
+    priority = getEffectivePriority(priority);
+
+    const VkDeviceSize blockSize = getBlockSize(memoryTypeIndex);
+    if (requirements.size < LARGE_BUFFER_THRESHOLD && requirements.size <= blockSize / 2) {
+        const VkDeviceSize alignment = getAlignment(requirements, memoryTypeIndex);
+        // Non-coherent ranges are flushed in whole atoms, so neighbours must not share one
+        const VkDeviceSize size = alignUp(requirements.size, alignment);
+
+        auto& pool = blockPools[(memoryTypeIndex * 2 + static_cast<uint32_t>(kind)) * PRIORITY_COUNT +
+                                static_cast<uint32_t>(priority)];
+        for (auto& block : pool) {
+            if (allocateFromBlock(*block, size, alignment, allocation)) {
+                placed = true;
+                break;
             }
         }
-        
-        if (result != VK_SUCCESS) {
-            std::cerr << "Critical: Memory allocation failed after recovery attempts!" << std::endl;
-            return {};
+
+        if (!placed) {
+            MemoryBlock* block = createBlock(memoryTypeIndex, kind, priority);
+            placed = block && allocateFromBlock(*block, size, alignment, allocation);
         }
     }
-    
-    allocation.size = requirements.size;
-    allocation.memoryTypeIndex = memoryType;
-    
-    // Track allocation in VMA wrapper for proper cleanup
-    if (allocator) {
-        VmaAllocator_Impl::Allocation vmaAlloc;
-        vmaAlloc.memory = allocation.memory;
-        vmaAlloc.offset = 0;
-        vmaAlloc.size = requirements.size;
-        vmaAlloc.mappedData = nullptr;
-        allocator->allocations.push_back(vmaAlloc);
-    }
-    
-    // Update comprehensive stats
-    memoryStats.totalAllocated += requirements.size;
-    memoryStats.activeAllocations++;
-    
-    if (memoryStats.totalAllocated - memoryStats.totalFreed > memoryStats.peakUsage) {
-        memoryStats.peakUsage = memoryStats.totalAllocated - memoryStats.totalFreed;
+
+    // Too large for a block, or no new block fit in the heap: an exact-size allocation may still
+    if (!placed) {
+        allocation = allocateDedicated(requirements, memoryTypeIndex, priority);
+        if (allocation.memory == VK_NULL_HANDLE) {
+            memoryStats.failedAllocations++;
+            return {};
+        }
     }
-    
-    // Update pressure status
-    memoryStats.memoryPressure = isUnderMemoryPressure();
-    
+
+    recordAllocation(allocation);
     return allocation;
 }
 
+bool MemoryAllocator::isRelocationCandidate(const AllocationInfo& allocation) const {
+    std::lock_guard<std::recursive_mutex> lock(allocationMutex);
+    const MemoryBlock* block = allocation.block;
+    if (!context || !block || block->mappedData) {
+        return false;
+    }
+
+    const VkDeviceSize used = getUsedBytes(*block);
+    if (used > static_cast<VkDeviceSize>(block->size * DEFRAG_SOURCE_BLOCK_OCCUPANCY)) {
+        return false;
+    }
+
+    const auto& pool = blockPools[block->poolIndex];
+    return std::any_of(pool.begin(), pool.end(), [block, used](const auto& other) {
+        return other.get() != block && getUsedBytes(*other) > used;
+    });
+}
+
+MemoryAllocator::AllocationInfo MemoryAllocator::allocateForRelocation(const AllocationInfo& allocation,
+                                                                       const VkMemoryRequirements& requirements) {
+    std::lock_guard<std::recursive_mutex> lock(allocationMutex);
+    if (!isRelocationCandidate(allocation) ||
+        !(requirements.memoryTypeBits & (1u << allocation.block->memoryTypeIndex))) {
+        return {};
+    }
+
+    const MemoryBlock& source = *allocation.block;
+    const VkDeviceSize sourceUsed = getUsedBytes(source);
+    const VkDeviceSize alignment = getAlignment(requirements, source.memoryTypeIndex);
+    const VkDeviceSize size = alignUp(requirements.size, alignment);
+
+    // Fullest first, so moves pack blocks tight and never head toward one as sparse as the source
+    std::vector<std::pair<VkDeviceSize, MemoryBlock*>> targets;
+    for (auto& block : blockPools[source.poolIndex]) {
+        const VkDeviceSize used = getUsedBytes(*block);
+        if (block.get() != &source && used > sourceUsed) {
+            targets.emplace_back(used, block.get());
+        }
+    }
+    std::sort(targets.begin(), targets.end(), [](const auto& a, const auto& b) { return a.first > b.first; });
+
+    AllocationInfo relocated;
+    for (auto& [used, block] : targets) {
+        if (allocateFromBlock(*block, size, alignment, relocated)) {
+            recordAllocation(relocated);
+            return relocated;
+        }
+    }
+    return {};
+}
+
+void MemoryAllocator::applyPriority(VkMemoryAllocateInfo& allocInfo, VkMemoryPriorityAllocateInfoEXT& priorityInfo,
+                                    Priority priority) const {
+    if (!context || !context->supportsMemoryPriority()) return;
+
+    priorityInfo = {};
+    priorityInfo.sType = VK_STRUCTURE_TYPE_MEMORY_PRIORITY_ALLOCATE_INFO_EXT;
+    priorityInfo.priority = getPriorityValue(priority);
+    priorityInfo.pNext = allocInfo.pNext;
+    allocInfo.pNext = &priorityInfo;
+}
+
+void MemoryAllocator::recordExternalAllocation(uint32_t memoryTypeIndex, VkDeviceSize size) {
+    std::lock_guard<std::recursive_mutex> lock(allocationMutex);
+    if (!context || memoryTypeIndex >= memoryProperties.memoryTypeCount) return;
+    heapUsage[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex] += size;
+}
+
+void MemoryAllocator::recordExternalFree(uint32_t memoryTypeIndex, VkDeviceSize size) {
+    std::lock_guard<std::recursive_mutex> lock(allocationMutex);
+    if (!context || memoryTypeIndex >= memoryProperties.memoryTypeCount) return;
+    VkDeviceSize& used = heapUsage[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex];
+    used = used > size ? used - size : 0;
+}
+
 void MemoryAllocator::freeMemory(const AllocationInfo& allocation) {
+    std::lock_guard<std::recursive_mutex> lock(allocationMutex);
     if (!context || allocation.memory == VK_NULL_HANDLE) return;
-    
-    if (allocation.mappedData) {
-        context->getLoader().vkUnmapMemory(context->getDevice(), allocation.memory);
+
+    if (MemoryBlock* block = allocation.block) {
+        releaseRange(*block, allocation.offset, allocation.size);
+        block->allocationCount--;
+
+        // Keep one empty block per pool so a free/allocate cycle does not hit the driver every time
+        if (block->allocationCount == 0) {
+            auto& pool = blockPools[block->poolIndex];
+            const bool otherEmpty = std::any_of(pool.begin(), pool.end(), [block](const auto& other) {
+                return other.get() != block && other->allocationCount == 0;
+            });
+            if (otherEmpty) {
+                auto it = std::find_if(pool.begin(), pool.end(), [block](const auto& other) {
+                    return other.get() == block;
+                });
+                destroyBlock(*it);
+                pool.erase(it);
+            }
+        }
+    } else {
+        if (allocation.mappedData) {
+            context->getLoader().vkUnmapMemory(context->getDevice(), allocation.memory);
+        }
+        freeDeviceMemory(allocation.memory, allocation.size, allocation.memoryTypeIndex);
+        memoryStats.dedicatedAllocations--;
     }
-    
-    // Remove from VMA tracking before freeing
-    if (allocator) {
-        auto& allocations = allocator->allocations;
-        allocations.erase(
-            std::remove_if(allocations.begin(), allocations.end(),
-                [&allocation](const VmaAllocator_Impl::Allocation& alloc) {
-                    return alloc.memory == allocation.memory;
-                }),
-            allocations.end()
-        );
-    }
-    
-    context->getLoader().vkFreeMemory(context->getDevice(), allocation.memory, nullptr);
-    
+
+    if (allocation.deviceLocalHostWrite) {
+        memoryStats.hostWriteDeviceLocalBytes -= std::min(memoryStats.hostWriteDeviceLocalBytes, allocation.size);
+    }
+
     // Update stats
     memoryStats.totalFreed += allocation.size;
     memoryStats.activeAllocations--;
+    updateBlockStats();
 }
 
 bool MemoryAllocator::mapMemory(const AllocationInfo& allocation, void** data) {
     if (!context || allocation.memory == VK_NULL_HANDLE) return false;
-    
-    if (context->getLoader().vkMapMemory(context->getDevice(), allocation.memory, 
+
+    if (allocation.block) {
+        if (!allocation.block->mappedData) {
+            std::cerr << "MemoryAllocator: Cannot map a sub-allocation of non-host-visible memory" << std::endl;
+            return false;
+        }
+        *data = static_cast<char*>(allocation.block->mappedData) + allocation.offset;
+        return true;
+    }
+
+    if (context->getLoader().vkMapMemory(context->getDevice(), allocation.memory,
                                          allocation.offset, allocation.size, 0, data) != VK_SUCCESS) {
         std::cerr << "Failed to map memory!" << std::endl;
         return false;
     }
-    
+
     return true;
 }
 
 void MemoryAllocator::unmapMemory(const AllocationInfo& allocation) {
-    if (context && allocation.memory != VK_NULL_HANDLE) {
+    // Block mappings live as long as the block
+    if (context && allocation.memory != VK_NULL_HANDLE && !allocation.block) {
         context->getLoader().vkUnmapMemory(context->getDevice(), allocation.memory);
     }
 }
@@ -157,29 +292,33 @@ bool MemoryAllocator::mapResourceMemory(ResourceHandle& handle) {
     if (!ValidationUtils::validateDependencies("MemoryAllocator::mapResourceMemory", context, &handle)) {
         return false;
     }
-    
+
     if (!handle.isValid()) {
-        ValidationUtils::logValidationFailure("MemoryAllocator::mapResourceMemory", 
+        ValidationUtils::logValidationFailure("MemoryAllocator::mapResourceMemory",
                                              "resource handle", "invalid handle");
         return false;
     }
-    
+
     if (handle.mappedData) {
         // Already mapped
         return true;
     }
-    
+
+    if (handle.allocation) {
+        return mapMemory(handle.allocation.getInfo(), &handle.mappedData);
+    }
+
     if (!handle.memory.get()) {
         ValidationUtils::logValidationFailure("MemoryAllocator::mapResourceMemory",
                                              "resource memory", "null memory handle");
         return false;
     }
-    
+
     AllocationInfo allocation;
     allocation.memory = handle.memory.get();
     allocation.size = handle.size;
     allocation.offset = 0; // Assuming full resource mapping
-    
+
     return mapMemory(allocation, &handle.mappedData);
 }
 
@@ -187,8 +326,11 @@ void MemoryAllocator::unmapResourceMemory(ResourceHandle& handle) {
     if (!context || !handle.isValid() || !handle.mappedData) {
         return;
     }
-    
-    if (handle.memory.get()) {
+
+    if (handle.allocation) {
+        unmapMemory(handle.allocation.getInfo());
+        handle.mappedData = nullptr;
+    } else if (handle.memory.get()) {
         context->getLoader().vkUnmapMemory(context->getDevice(), handle.memory.get());
         handle.mappedData = nullptr;
     }
@@ -197,130 +339,479 @@ void MemoryAllocator::unmapResourceMemory(ResourceHandle& handle) {
 MemoryAllocator::AllocationInfo MemoryAllocator::allocateMappedMemory(VkMemoryRequirements requirements,
                                                                      VkMemoryPropertyFlags properties) {
     AllocationInfo allocation = allocateMemory(requirements, properties);
-    
-    if (allocation.memory != VK_NULL_HANDLE && (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
+
+    if (allocation.memory != VK_NULL_HANDLE && !allocation.mappedData &&
+        (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT)) {
         if (!mapMemory(allocation, &allocation.mappedData)) {
-            ValidationUtils::logError("MemoryAllocator", "allocateMappedMemory", 
+            ValidationUtils::logError("MemoryAllocator", "allocateMappedMemory",
                                      "failed to map allocated memory");
             freeMemory(allocation);
             return {};
         }
     }
-    
+
     return allocation;
 }
 
+MemoryAllocator::AllocationInfo MemoryAllocator::allocateHostWriteMemory(const VkMemoryRequirements& requirements) {
+    std::lock_guard<std::recursive_mutex> lock(allocationMutex);
+    if (!context) return {};
+
+    if (ENABLE_DEVICE_LOCAL_HOST_WRITES && hasDeviceLocalHostVisible() &&
+        (requirements.memoryTypeBits & (1u << hostWriteMemoryType)) &&
+        requirements.size <= HOST_WRITE_MAX_BUFFER_SIZE &&
+        memoryStats.hostWriteDeviceLocalBytes + requirements.size <= hostWriteBudget) {
+        AllocationInfo allocation = allocateMemoryOfType(requirements, hostWriteMemoryType);
+
+        // Dedicated allocations (no block fit in the heap) are mapped here; blocks come mapped
+        if (allocation.memory != VK_NULL_HANDLE && !allocation.mappedData &&
+            !mapMemory(allocation, &allocation.mappedData)) {
+            freeMemory(allocation);
+            allocation = {};
+        }
+
+        if (allocation.memory != VK_NULL_HANDLE) {
+            allocation.deviceLocalHostWrite = true;
+            memoryStats.hostWriteDeviceLocalBytes += allocation.size;
+            return allocation;
+        }
+    }
+
+    return allocateMappedMemory(requirements);
+}
+
 uint32_t MemoryAllocator::findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties) {
-    VkPhysicalDeviceMemoryProperties memProperties;
-    context->getLoader().vkGetPhysicalDeviceMemoryProperties(context->getPhysicalDevice(), &memProperties);
-    
+    const VkPhysicalDeviceMemoryProperties& memProperties = memoryProperties;
+
+    // Mapped allocations first look for a single-instance heap: multi-instance memory (one copy per GPU of a
+    // device group) cannot be mapped
+    if (properties & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) {
+        for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
+            const VkMemoryHeapFlags heapFlags = memProperties.memoryHeaps[memProperties.memoryTypes[i].heapIndex].flags;
+            if ((typeFilter & (1 << i)) && !(heapFlags & VK_MEMORY_HEAP_MULTI_INSTANCE_BIT) &&
+                (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+                return i;
+            }
+        }
+    }
+
     // First pass: exact match
     for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && 
+        if ((typeFilter & (1 << i)) &&
             (memProperties.memoryTypes[i].propertyFlags & properties) == properties) {
             return i;
         }
     }
-    
+
     // Second pass: fallback to compatible memory type with required properties
     for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
-        if ((typeFilter & (1 << i)) && 
+        if ((typeFilter & (1 << i)) &&
             (memProperties.memoryTypes[i].propertyFlags & properties) != 0) {
-            std::cerr << "Warning: Using fallback memory type " << i 
+            std::cerr << "Warning: Using fallback memory type " << i
                       << " (requested properties not fully supported)" << std::endl;
             return i;
         }
     }
-    
+
     // Final fallback: any valid memory type from filter
     for (uint32_t i = 0; i < memProperties.memoryTypeCount; i++) {
         if (typeFilter & (1 << i)) {
-            std::cerr << "Warning: Using basic fallback memory type " << i 
+            std::cerr << "Warning: Using basic fallback memory type " << i
                       << " (properties may not match requirements)" << std::endl;
             return i;
         }
     }
-    
-    throw std::runtime_error("Failed to find any suitable memory type!");
-}
 
-bool MemoryAllocator::initializeVMA() {
-    // Simplified VMA initialization - just store device info
-    allocator = new VmaAllocator_Impl;
-    allocator->device = context->getDevice();
-    allocator->physicalDevice = context->getPhysicalDevice();
-    allocator->loader = &context->getLoader();
-    
-    return true;
+    throw std::runtime_error("Failed to find any suitable memory type!");
 }
 
 bool MemoryAllocator::isUnderMemoryPressure() const {
-    if (!context || !allocator) return false;
-    
-    VkPhysicalDeviceMemoryProperties memProps;
-    context->getLoader().vkGetPhysicalDeviceMemoryProperties(context->getPhysicalDevice(), &memProps);
-    
+    std::lock_guard<std::recursive_mutex> lock(allocationMutex);
+    if (!context) return false;
+
     // Check each heap for pressure (>80% usage indicates pressure)
-    for (uint32_t i = 0; i < memProps.memoryHeapCount; i++) {
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++) {
         DeviceMemoryBudget budget = getMemoryBudget(i);
         if (budget.pressureRatio > 0.8f) {
             return true;
         }
     }
-    
+
     return false;
 }
 
 MemoryAllocator::DeviceMemoryBudget MemoryAllocator::getMemoryBudget(uint32_t heapIndex) const {
+    std::lock_guard<std::recursive_mutex> lock(allocationMutex);
     DeviceMemoryBudget budget{};
-    
-    if (!context) return budget;
-    
-    VkPhysicalDeviceMemoryProperties memProps;
-    context->getLoader().vkGetPhysicalDeviceMemoryProperties(context->getPhysicalDevice(), &memProps);
-    
-    if (heapIndex >= memProps.memoryHeapCount) return budget;
-    
-    budget.heapSize = memProps.memoryHeaps[heapIndex].size;
-    
-    // Estimate used bytes from our allocations (simplified)
-    VkDeviceSize usedInHeap = 0;
-    for (const auto& alloc : allocator->allocations) {
-        // Simple heuristic: assume allocation is in this heap if it's device-local
-        usedInHeap += alloc.size;
-    }
-    
-    budget.usedBytes = usedInHeap;
-    budget.availableBytes = budget.heapSize > budget.usedBytes ? budget.heapSize - budget.usedBytes : 0;
-    budget.pressureRatio = budget.heapSize > 0 ? (float)budget.usedBytes / budget.heapSize : 1.0f;
-    
+
+    if (!context || heapIndex >= memoryProperties.memoryHeapCount) return budget;
+
+    // Blocks count in full: their free ranges are still memory the driver handed out
+    budget.heapSize = memoryProperties.memoryHeaps[heapIndex].size;
+    if (driverBudgetValid) {
+        budget.budgetBytes = std::min(driverHeapBudget[heapIndex], budget.heapSize);
+        const VkDeviceSize polled = driverHeapUsage[heapIndex];
+        const VkDeviceSize since = heapUsageAtPoll[heapIndex];
+        budget.usedBytes = heapUsage[heapIndex] >= since ? polled + (heapUsage[heapIndex] - since)
+                         : polled - std::min(polled, since - heapUsage[heapIndex]);
+    } else {
+        budget.budgetBytes = budget.heapSize;
+        budget.usedBytes = heapUsage[heapIndex];
+    }
+    budget.availableBytes = budget.budgetBytes > budget.usedBytes ? budget.budgetBytes - budget.usedBytes : 0;
+    budget.pressureRatio = budget.budgetBytes > 0 ? (float)budget.usedBytes / budget.budgetBytes : 1.0f;
+
     return budget;
 }
 
+MemoryAllocator::DeviceMemoryBudget MemoryAllocator::getDeviceLocalBudget() const {
+    return getMemoryBudget(deviceLocalHeap);
+}
+
+void MemoryAllocator::refreshMemoryBudget() {
+    std::lock_guard<std::recursive_mutex> lock(allocationMutex);
+    if (!context || !context->supportsMemoryBudget()) return;
+
+    VkPhysicalDeviceMemoryBudgetPropertiesEXT budgetProperties{};
+    budgetProperties.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_BUDGET_PROPERTIES_EXT;
+
+    VkPhysicalDeviceMemoryProperties2 properties2{};
+    properties2.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_MEMORY_PROPERTIES_2;
+    properties2.pNext = &budgetProperties;
+    context->getLoader().vkGetPhysicalDeviceMemoryProperties2KHR(context->getPhysicalDevice(), &properties2);
+
+    for (uint32_t i = 0; i < memoryProperties.memoryHeapCount; i++) {
+        driverHeapBudget[i] = budgetProperties.heapBudget[i];
+        driverHeapUsage[i] = budgetProperties.heapUsage[i];
+    }
+    heapUsageAtPoll = heapUsage;
+
+    // Some drivers leave the struct zeroed for heaps they do not track; fall back rather than report no budget
+    driverBudgetValid = driverHeapBudget[deviceLocalHeap] > 0;
+    updateResidency();
+}
+
+MemoryAllocator::ResidencyReport MemoryAllocator::getResidencyReport() const {
+    std::lock_guard<std::recursive_mutex> lock(allocationMutex);
+    return residency;
+}
+
+void MemoryAllocator::updateResidency() {
+    if (!driverBudgetValid) {
+        residency.demotedBytes = 0;
+        residency.overBudgetBytes = 0;
+        residency.demoted = false;
+        return;
+    }
+
+    const VkDeviceSize own = heapUsage[deviceLocalHeap];
+    const VkDeviceSize resident = driverHeapUsage[deviceLocalHeap];
+    const VkDeviceSize budget = driverHeapBudget[deviceLocalHeap];
+    residency.demotedBytes = own > resident ? own - resident : 0;
+    residency.overBudgetBytes = resident > budget ? resident - budget : 0;
+
+    const bool demoted = residency.demotedBytes >= DEMOTION_REPORT_THRESHOLD;
+    if (demoted && !residency.demoted) {
+        residency.demotionEvents++;
+        std::cerr << "MemoryAllocator: " << residency.demotedBytes / MEGABYTE << " MB of device-local memory demoted to "
+                  << "system memory (" << resident / MEGABYTE << " of " << own / MEGABYTE << " MB resident, budget "
+                  << budget / MEGABYTE << " MB)" << (context->supportsMemoryPriority() ? "" : ", no priorities to steer it")
+                  << std::endl;
+    } else if (!demoted && residency.demoted) {
+        std::cout << "MemoryAllocator: Device-local memory resident again" << std::endl;
+    }
+    residency.demoted = demoted;
+}
+
 bool MemoryAllocator::attemptMemoryRecovery() {
-    if (!allocator) return false;
-    
-    // Force garbage collection by triggering a memory defragmentation-like cleanup
-    size_t recoveredBytes = 0;
-    
-    // In a real VMA implementation, this would trigger defragmentation
-    // For now, we'll just log the attempt
-    std::cout << "Attempting memory recovery - would trigger VMA defragmentation here" << std::endl;
-    
+    std::lock_guard<std::recursive_mutex> lock(allocationMutex);
+    if (!context) return false;
+
+    const VkDeviceSize recoveredBytes = releaseEmptyBlocks();
+    if (recoveredBytes > 0) {
+        std::cout << "MemoryAllocator: Recovered " << recoveredBytes / MEGABYTE << " MB from empty blocks" << std::endl;
+        updateBlockStats();
+    }
+
     return recoveredBytes > 0;
 }
 
-void MemoryAllocator::cleanupVMA() {
-    if (allocator) {
-        // Clean up any remaining allocations
-        for (auto& alloc : allocator->allocations) {
-            if (alloc.mappedData) {
-                allocator->loader->vkUnmapMemory(allocator->device, alloc.memory);
+MemoryAllocator::MemoryStats MemoryAllocator::getMemoryStats() const {
+    std::lock_guard<std::recursive_mutex> lock(allocationMutex);
+    return memoryStats;
+}
+
+VkDeviceSize MemoryAllocator::getBlockSize(uint32_t memoryTypeIndex) const {
+    const uint32_t heapIndex = memoryProperties.memoryTypes[memoryTypeIndex].heapIndex;
+    const VkDeviceSize heapSize = memoryProperties.memoryHeaps[heapIndex].size;
+
+    // Small heaps (integrated GPUs' host-visible windows) would fill up with a couple of full blocks
+    if (heapSize < MEMORY_BLOCK_SIZE * 8) {
+        return std::max<VkDeviceSize>(heapSize / 8, 1);
+    }
+    return MEMORY_BLOCK_SIZE;
+}
+
+VkDeviceSize MemoryAllocator::getAlignment(const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex) const {
+    VkDeviceSize alignment = std::max<VkDeviceSize>(requirements.alignment, 1);
+
+    const VkMemoryPropertyFlags flags = memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags;
+    if (isHostVisible(memoryTypeIndex) && !(flags & VK_MEMORY_PROPERTY_HOST_COHERENT_BIT)) {
+        alignment = std::max(alignment, nonCoherentAtomSize);
+    }
+    return alignment;
+}
+
+bool MemoryAllocator::isHostVisible(uint32_t memoryTypeIndex) const {
+    return (memoryProperties.memoryTypes[memoryTypeIndex].propertyFlags & VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT) != 0;
+}
+
+VkDeviceSize MemoryAllocator::getUsedBytes(const MemoryBlock& block) {
+    VkDeviceSize freeBytes = 0;
+    for (const auto& [offset, size] : block.freeRanges) {
+        freeBytes += size;
+    }
+    return block.size - freeBytes;
+}
+
+void MemoryAllocator::selectHostWriteMemoryType() {
+    constexpr VkMemoryPropertyFlags required = VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT |
+                                               VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                               VK_MEMORY_PROPERTY_HOST_COHERENT_BIT;
+
+    hostWriteMemoryType = UINT32_MAX;
+    hostWriteBudget = 0;
+
+    VkDeviceSize bestHeapSize = 0;
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; i++) {
+        const VkMemoryType& type = memoryProperties.memoryTypes[i];
+        const VkDeviceSize heapSize = memoryProperties.memoryHeaps[type.heapIndex].size;
+        if ((type.propertyFlags & required) == required && heapSize > bestHeapSize) {
+            hostWriteMemoryType = i;
+            bestHeapSize = heapSize;
+        }
+    }
+
+    if (!hasDeviceLocalHostVisible()) {
+        return;
+    }
+
+    hostWriteBudget = std::min<VkDeviceSize>(HOST_WRITE_DEVICE_LOCAL_BUDGET, bestHeapSize / 4);
+    std::cout << "MemoryAllocator: Host writes use device-local memory type " << hostWriteMemoryType
+              << " (" << bestHeapSize / MEGABYTE << " MB heap" << (bestHeapSize > 256 * MEGABYTE ? ", resizable BAR" : "")
+              << ", " << hostWriteBudget / MEGABYTE << " MB budget)" << std::endl;
+}
+
+MemoryAllocator::Priority MemoryAllocator::getEffectivePriority(Priority priority) const {
+    // Without the extension separate pools would only fragment memory
+    return context && context->supportsMemoryPriority() ? priority : Priority::Normal;
+}
+
+VkDeviceMemory MemoryAllocator::allocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex, Priority priority) {
+    VkMemoryAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocInfo.allocationSize = size;
+    allocInfo.memoryTypeIndex = memoryTypeIndex;
+    VkMemoryPriorityAllocateInfoEXT priorityInfo{};
+    applyPriority(allocInfo, priorityInfo, priority);
+
+    VkDeviceMemory memory = VK_NULL_HANDLE;
+    VkResult result = context->getLoader().vkAllocateMemory(context->getDevice(), &allocInfo, nullptr, &memory);
+
+    if (result == VK_ERROR_OUT_OF_DEVICE_MEMORY || result == VK_ERROR_OUT_OF_HOST_MEMORY) {
+        std::cerr << "Out of memory - attempting emergency recovery..." << std::endl;
+        if (attemptMemoryRecovery()) {
+            // Retry allocation after recovery
+            result = context->getLoader().vkAllocateMemory(context->getDevice(), &allocInfo, nullptr, &memory);
+        }
+    }
+
+    if (result != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+
+    heapUsage[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex] += size;
+    memoryStats.deviceMemoryObjects++;
+    return memory;
+}
+
+void MemoryAllocator::freeDeviceMemory(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex) {
+    context->getLoader().vkFreeMemory(context->getDevice(), memory, nullptr);
+
+    VkDeviceSize& used = heapUsage[memoryProperties.memoryTypes[memoryTypeIndex].heapIndex];
+    used = used > size ? used - size : 0;
+    memoryStats.deviceMemoryObjects--;
+}
+
+MemoryAllocator::AllocationInfo MemoryAllocator::allocateDedicated(const VkMemoryRequirements& requirements,
+                                                                   uint32_t memoryTypeIndex, Priority priority) {
+    AllocationInfo allocation;
+    allocation.memory = allocateDeviceMemory(requirements.size, memoryTypeIndex, priority);
+    if (allocation.memory == VK_NULL_HANDLE) {
+        return {};
+    }
+
+    allocation.size = requirements.size;
+    allocation.memoryTypeIndex = memoryTypeIndex;
+    memoryStats.dedicatedAllocations++;
+    return allocation;
+}
+
+bool MemoryAllocator::allocateFromBlock(MemoryBlock& block, VkDeviceSize size, VkDeviceSize alignment,
+                                        AllocationInfo& allocation) {
+    // Best fit: the smallest free range that still holds the aligned request
+    auto best = block.freeRanges.end();
+    for (auto it = block.freeRanges.begin(); it != block.freeRanges.end(); ++it) {
+        const VkDeviceSize padding = alignUp(it->first, alignment) - it->first;
+        if (padding + size <= it->second && (best == block.freeRanges.end() || it->second < best->second)) {
+            best = it;
+        }
+    }
+    if (best == block.freeRanges.end()) {
+        return false;
+    }
+
+    const VkDeviceSize rangeOffset = best->first;
+    const VkDeviceSize rangeEnd = best->first + best->second;
+    const VkDeviceSize offset = alignUp(rangeOffset, alignment);
+    block.freeRanges.erase(best);
+
+    if (offset > rangeOffset) {
+        block.freeRanges.emplace(rangeOffset, offset - rangeOffset);
+    }
+    if (offset + size < rangeEnd) {
+        block.freeRanges.emplace(offset + size, rangeEnd - (offset + size));
+    }
+
+    allocation.memory = block.memory;
+    allocation.size = size;
+    allocation.offset = offset;
+    allocation.mappedData = block.mappedData ? static_cast<char*>(block.mappedData) + offset : nullptr;
+    allocation.memoryTypeIndex = block.memoryTypeIndex;
+    allocation.block = &block;
+    block.allocationCount++;
+    return true;
+}
+
+void MemoryAllocator::recordAllocation(const AllocationInfo& allocation) {
+    memoryStats.totalAllocated += allocation.size;
+    memoryStats.activeAllocations++;
+
+    if (memoryStats.totalAllocated - memoryStats.totalFreed > memoryStats.peakUsage) {
+        memoryStats.peakUsage = memoryStats.totalAllocated - memoryStats.totalFreed;
+    }
+
+    updateBlockStats();
+    memoryStats.memoryPressure = isUnderMemoryPressure();
+}
+
+MemoryAllocator::MemoryBlock* MemoryAllocator::createBlock(uint32_t memoryTypeIndex, AllocationKind kind,
+                                                           Priority priority) {
+    const VkDeviceSize blockSize = getBlockSize(memoryTypeIndex);
+    VkDeviceMemory memory = allocateDeviceMemory(blockSize, memoryTypeIndex, priority);
+    if (memory == VK_NULL_HANDLE) {
+        return nullptr;
+    }
+
+    auto block = std::make_unique<MemoryBlock>();
+    block->memory = memory;
+    block->size = blockSize;
+    block->memoryTypeIndex = memoryTypeIndex;
+    block->poolIndex = (memoryTypeIndex * 2 + static_cast<uint32_t>(kind)) * PRIORITY_COUNT + static_cast<uint32_t>(priority);
+    block->freeRanges.emplace(0, blockSize);
+
+    if (isHostVisible(memoryTypeIndex) &&
+        context->getLoader().vkMapMemory(context->getDevice(), memory, 0, VK_WHOLE_SIZE, 0, &block->mappedData) != VK_SUCCESS) {
+        std::cerr << "MemoryAllocator: Failed to map new block of memory type " << memoryTypeIndex << std::endl;
+        freeDeviceMemory(memory, blockSize, memoryTypeIndex);
+        return nullptr;
+    }
+
+    auto& pool = blockPools[block->poolIndex];
+    pool.push_back(std::move(block));
+    std::cout << "MemoryAllocator: New " << blockSize / MEGABYTE << " MB block for memory type " << memoryTypeIndex
+              << " (" << pool.size() << " in pool)" << std::endl;
+    return pool.back().get();
+}
+
+void MemoryAllocator::releaseRange(MemoryBlock& block, VkDeviceSize offset, VkDeviceSize size) {
+    auto next = block.freeRanges.lower_bound(offset);
+
+    // Merge with the range ending where this one starts
+    if (next != block.freeRanges.begin()) {
+        auto previous = std::prev(next);
+        if (previous->first + previous->second == offset) {
+            offset = previous->first;
+            size += previous->second;
+            block.freeRanges.erase(previous);
+        }
+    }
+
+    // And with the range starting where it ends
+    if (next != block.freeRanges.end() && offset + size == next->first) {
+        size += next->second;
+        block.freeRanges.erase(next);
+    }
+
+    block.freeRanges.emplace(offset, size);
+}
+
+void MemoryAllocator::destroyBlock(std::unique_ptr<MemoryBlock>& block) {
+    if (block->mappedData) {
+        context->getLoader().vkUnmapMemory(context->getDevice(), block->memory);
+    }
+    freeDeviceMemory(block->memory, block->size, block->memoryTypeIndex);
+    block.reset();
+}
+
+VkDeviceSize MemoryAllocator::releaseEmptyBlocks() {
+    VkDeviceSize releasedBytes = 0;
+    for (auto& pool : blockPools) {
+        for (auto it = pool.begin(); it != pool.end();) {
+            if ((*it)->allocationCount == 0) {
+                releasedBytes += (*it)->size;
+                destroyBlock(*it);
+                it = pool.erase(it);
+            } else {
+                ++it;
+            }
+        }
+    }
+    return releasedBytes;
+}
+
+void MemoryAllocator::releaseAllBlocks() {
+    for (auto& pool : blockPools) {
+        for (auto& block : pool) {
+            if (block->allocationCount > 0) {
+                std::cerr << "MemoryAllocator: Releasing block with " << block->allocationCount
+                          << " live allocations" << std::endl;
             }
-            allocator->loader->vkFreeMemory(allocator->device, alloc.memory, nullptr);
+            destroyBlock(block);
         }
-        
-        delete allocator;
-        allocator = nullptr;
+        pool.clear();
     }
-}
\ No newline at end of file
+    updateBlockStats();
+}
+
+void MemoryAllocator::updateBlockStats() {
+    uint32_t blockCount = 0;
+    VkDeviceSize blockBytes = 0;
+    VkDeviceSize freeBytes = 0;
+    VkDeviceSize largestFree = 0;
+
+    for (const auto& pool : blockPools) {
+        for (const auto& block : pool) {
+            blockCount++;
+            blockBytes += block->size;
+            for (const auto& [offset, size] : block->freeRanges) {
+                freeBytes += size;
+                largestFree = std::max(largestFree, size);
+            }
+        }
+    }
+
+    memoryStats.blockCount = blockCount;
+    memoryStats.blockBytes = blockBytes;
+    memoryStats.fragmentationRatio = freeBytes > 0 ? 1.0f - static_cast<float>(largestFree) / freeBytes : 0.0f;
+}
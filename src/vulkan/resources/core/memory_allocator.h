@@ -2,68 +2,139 @@
 
 #define VK_NO_PROTOTYPES
 #include <vulkan/vulkan.h>
+#include <array>
+#include <map>
 #include <memory>
+#include <mutex>
 #include <vector>
 
 class VulkanContext;
 
-// VMA allocator wrapper - simplified interface without external dependency
-class VmaAllocator_Impl;
-using VmaAllocator = VmaAllocator_Impl*;
-using VmaAllocation = void*;
-
-// Memory allocation and management
+// Memory allocation and management. Requests are sub-allocated from MEMORY_BLOCK_SIZE blocks kept per memory
+// type (best fit over each block's free ranges, coalesced on free); requests of LARGE_BUFFER_THRESHOLD or more,
+// or that a block of the heap could not hold twice, get a dedicated VkDeviceMemory. Host-visible blocks stay
+// mapped for their whole lifetime, since a VkDeviceMemory cannot be mapped once per sub-allocation. With
+// VK_EXT_memory_priority every VkDeviceMemory carries a residency priority, so blocks are pooled per priority too
 class MemoryAllocator {
+private:
+    struct MemoryBlock;
+
 public:
     MemoryAllocator();
     ~MemoryAllocator();
-    
+
     bool initialize(const VulkanContext& context);
     void cleanup();
-    
+
     // Context access
     const VulkanContext* getContext() const { return context; }
-    
+
+    // Linear buffers and optimal-tiling images are kept in separate blocks, so neighbours never need
+    // bufferImageGranularity padding
+    enum class AllocationKind : uint8_t { Buffer, OptimalImage };
+
+    // What the OS demotes to system memory first when device-local memory is oversubscribed (other processes,
+    // browsers, video players): High for the streams every frame reads (positions, velocities, the spatial grid),
+    // Low for cold data (snapshots, debug and capture buffers). Ignored without VK_EXT_memory_priority
+    enum class Priority : uint8_t { Low, Normal, High };
+    static constexpr uint32_t PRIORITY_COUNT = 3;
+    static float getPriorityValue(Priority priority);
+
     // Raw memory allocation
     struct AllocationInfo {
         VkDeviceMemory memory = VK_NULL_HANDLE;
         VkDeviceSize size = 0;
-        VkDeviceSize offset = 0;
-        void* mappedData = nullptr;
+        VkDeviceSize offset = 0;      // Bind offset within memory
+        void* mappedData = nullptr;   // Set up front for sub-allocations of host-visible types
         uint32_t memoryTypeIndex = 0;
+        MemoryBlock* block = nullptr; // Owning block, nullptr for dedicated allocations
+        bool deviceLocalHostWrite = false;  // Counted against the host-write budget
     };
-    
-    AllocationInfo allocateMemory(VkMemoryRequirements requirements, 
-                                  VkMemoryPropertyFlags properties);
+
+    AllocationInfo allocateMemory(VkMemoryRequirements requirements,
+                                  VkMemoryPropertyFlags properties,
+                                  AllocationKind kind = AllocationKind::Buffer,
+                                  Priority priority = Priority::Normal);
+
+    // For callers that pick the memory type themselves (fallback strategies); empty on failure, never throws
+    AllocationInfo allocateMemoryOfType(const VkMemoryRequirements& requirements,
+                                        uint32_t memoryTypeIndex,
+                                        AllocationKind kind = AllocationKind::Buffer,
+                                        Priority priority = Priority::Normal);
     void freeMemory(const AllocationInfo& allocation);
-    
-    // Memory mapping - centralized for all resource types
+
+    // For code that calls vkAllocateMemory itself (entity streams, sparse pages): chains priorityInfo in front of
+    // allocInfo's pNext when priorities are enabled; priorityInfo must outlive the call. The record calls count
+    // that memory into the heap usage the budget and demotion reports are built on
+    void applyPriority(VkMemoryAllocateInfo& allocInfo, VkMemoryPriorityAllocateInfoEXT& priorityInfo,
+                       Priority priority) const;
+    void recordExternalAllocation(uint32_t memoryTypeIndex, VkDeviceSize size);
+    void recordExternalFree(uint32_t memoryTypeIndex, VkDeviceSize size);
+
+    // Incremental defragmentation (MemoryDefragmenter). A sub-allocation of memory the host never maps is worth
+    // moving while its block is at most DEFRAG_SOURCE_BLOCK_OCCUPANCY full and a fuller block shares its pool;
+    // allocateForRelocation places the copy in the fullest such block with room, never in a new one, and is
+    // empty when none has room. The caller frees the original once nothing reads it
+    bool isRelocationCandidate(const AllocationInfo& allocation) const;
+    AllocationInfo allocateForRelocation(const AllocationInfo& allocation, const VkMemoryRequirements& requirements);
+
+    // Memory mapping - centralized for all resource types; sub-allocations resolve to their block's mapping
     bool mapMemory(const AllocationInfo& allocation, void** data);
     void unmapMemory(const AllocationInfo& allocation);
-    
+
     // Resource handle memory mapping (centralized to eliminate duplication)
-    bool mapResourceMemory(class ResourceHandle& handle);
-    void unmapResourceMemory(class ResourceHandle& handle);
-    
+    bool mapResourceMemory(struct ResourceHandle& handle);
+    void unmapResourceMemory(struct ResourceHandle& handle);
+
     // Utility for creating pre-mapped allocations
     AllocationInfo allocateMappedMemory(VkMemoryRequirements requirements,
                                        VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
-    
+
+    // Mapped memory for small buffers the CPU rewrites every frame (uniforms, per-frame constants): device-local
+    // host-visible when available and within HOST_WRITE_DEVICE_LOCAL_BUDGET, so GPU reads never cross the bus,
+    // host-visible coherent system memory otherwise. Either way mappedData is set and writes need no flush
+    AllocationInfo allocateHostWriteMemory(const VkMemoryRequirements& requirements);
+    bool hasDeviceLocalHostVisible() const { return hostWriteMemoryType != UINT32_MAX; }
+
     // Memory type utilities
     uint32_t findMemoryType(uint32_t typeFilter, VkMemoryPropertyFlags properties);
-    
-    // Memory pressure detection and management
+
+    // Memory pressure detection and management. With VK_EXT_memory_budget, budgetBytes and usedBytes are the
+    // driver's figures for this process (so other processes and the compositor shrink the budget), plus whatever
+    // this allocator took or released since the last refreshMemoryBudget(); otherwise the budget is the heap size
+    // and usage is this allocator's own device memory
     struct DeviceMemoryBudget {
         VkDeviceSize heapSize = 0;
+        VkDeviceSize budgetBytes = 0;
         VkDeviceSize usedBytes = 0;
         VkDeviceSize availableBytes = 0;
         float pressureRatio = 0.0f; // 0.0 = no pressure, 1.0 = critical
     };
-    
+
     bool isUnderMemoryPressure() const;
     DeviceMemoryBudget getMemoryBudget(uint32_t heapIndex) const;
+
+    // Budget of the largest device-local heap, where buffers and render targets live
+    DeviceMemoryBudget getDeviceLocalBudget() const;
+
+    // Polls per-heap budget and usage from the driver - once per frame; no-op without VK_EXT_memory_budget
+    void refreshMemoryBudget();
+    bool hasDriverBudget() const { return driverBudgetValid; }
+
+    // Demotion of device-local memory, from the same poll: the driver counts only what is resident in a heap, so
+    // device-local memory this process allocated but the driver no longer counts there has been moved out. A
+    // lower bound, since memory allocated around the allocator is not known to it. Logged when it starts and ends
+    struct ResidencyReport {
+        VkDeviceSize demotedBytes = 0;
+        VkDeviceSize overBudgetBytes = 0;   // Driver usage past the device-local budget: demotion is imminent
+        uint32_t demotionEvents = 0;        // Times demotedBytes rose past DEMOTION_REPORT_THRESHOLD
+        bool demoted = false;
+    };
+    ResidencyReport getResidencyReport() const;
+
+    // Releases blocks that no longer hold any allocation; true when memory went back to the driver
     bool attemptMemoryRecovery();
-    
+
     // Statistics with pressure tracking
     struct MemoryStats {
         VkDeviceSize totalAllocated = 0;
@@ -72,17 +143,120 @@ public:
         VkDeviceSize peakUsage = 0;
         uint32_t failedAllocations = 0;
         bool memoryPressure = false;
-        float fragmentationRatio = 0.0f;
+        float fragmentationRatio = 0.0f;   // 1 - largest free range / free bytes, across blocks
+
+        uint32_t blockCount = 0;
+        VkDeviceSize blockBytes = 0;       // Device memory held in blocks, used or not
+        uint32_t dedicatedAllocations = 0;
+        uint32_t deviceMemoryObjects = 0;  // Live vkAllocateMemory results (blocks + dedicated)
+        VkDeviceSize hostWriteDeviceLocalBytes = 0;  // allocateHostWriteMemory results placed in device-local memory
     };
-    
-    MemoryStats getMemoryStats() const { return memoryStats; }
+
+    MemoryStats getMemoryStats() const;
 
 private:
+    // One VkDeviceMemory carved into sub-allocations
+    struct MemoryBlock {
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        VkDeviceSize size = 0;
+        uint32_t memoryTypeIndex = 0;
+        uint32_t poolIndex = 0;
+        void* mappedData = nullptr;                        // Persistent mapping for host-visible types
+        std::map<VkDeviceSize, VkDeviceSize> freeRanges;   // offset -> size, never adjacent
+        uint32_t allocationCount = 0;
+    };
+
     const VulkanContext* context = nullptr;
-    VmaAllocator allocator = nullptr;
+    VkPhysicalDeviceMemoryProperties memoryProperties{};
+    VkDeviceSize nonCoherentAtomSize = 1;
     MemoryStats memoryStats;
-    
-    // Internal VMA wrapper functions
-    bool initializeVMA();
-    void cleanupVMA();
-};
\ No newline at end of file
+
+    // DEVICE_LOCAL | HOST_VISIBLE | HOST_COHERENT type on the largest such heap, UINT32_MAX when there is none
+    uint32_t hostWriteMemoryType = UINT32_MAX;
+    VkDeviceSize hostWriteBudget = 0;
+
+    // [(memoryTypeIndex * 2 + kind) * PRIORITY_COUNT + priority]; every priority shares Normal's pool when
+    // priorities are not enabled
+    std::array<std::vector<std::unique_ptr<MemoryBlock>>, VK_MAX_MEMORY_TYPES * 2 * PRIORITY_COUNT> blockPools;
+    std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> heapUsage{};  // Device memory allocated per heap
+    uint32_t deviceLocalHeap = 0;
+
+    // Last VK_EXT_memory_budget poll, with heapUsage as it stood then to apply later allocations on top
+    std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> driverHeapBudget{};
+    std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> driverHeapUsage{};
+    std::array<VkDeviceSize, VK_MAX_MEMORY_HEAPS> heapUsageAtPoll{};
+    bool driverBudgetValid = false;
+    ResidencyReport residency;
+    mutable std::recursive_mutex allocationMutex;  // Public entry points lock; some call each other
+
+    VkDeviceSize getBlockSize(uint32_t memoryTypeIndex) const;
+    VkDeviceSize getAlignment(const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex) const;
+    bool isHostVisible(uint32_t memoryTypeIndex) const;
+    static VkDeviceSize getUsedBytes(const MemoryBlock& block);
+    void selectHostWriteMemoryType();
+
+    Priority getEffectivePriority(Priority priority) const;
+    void updateResidency();
+
+    VkDeviceMemory allocateDeviceMemory(VkDeviceSize size, uint32_t memoryTypeIndex, Priority priority);
+    void freeDeviceMemory(VkDeviceMemory memory, VkDeviceSize size, uint32_t memoryTypeIndex);
+
+    AllocationInfo allocateDedicated(const VkMemoryRequirements& requirements, uint32_t memoryTypeIndex,
+                                     Priority priority);
+    bool allocateFromBlock(MemoryBlock& block, VkDeviceSize size, VkDeviceSize alignment, AllocationInfo& allocation);
+    void recordAllocation(const AllocationInfo& allocation);
+    MemoryBlock* createBlock(uint32_t memoryTypeIndex, AllocationKind kind, Priority priority);
+    void releaseRange(MemoryBlock& block, VkDeviceSize offset, VkDeviceSize size);
+    void destroyBlock(std::unique_ptr<MemoryBlock>& block);
+    VkDeviceSize releaseEmptyBlocks();
+    void releaseAllBlocks();
+    void updateBlockStats();
+};
+
+// Move-only ownership of one MemoryAllocator allocation, returned to the allocator on destruction or reset()
+class MemoryAllocation {
+public:
+    MemoryAllocation() = default;
+    MemoryAllocation(MemoryAllocator* allocator, const MemoryAllocator::AllocationInfo& info)
+        : allocator_(allocator), info_(info) {}
+    ~MemoryAllocation() { reset(); }
+
+    MemoryAllocation(const MemoryAllocation&) = delete;
+    MemoryAllocation& operator=(const MemoryAllocation&) = delete;
+
+    MemoryAllocation(MemoryAllocation&& other) noexcept : allocator_(other.allocator_), info_(other.info_) {
+        other.allocator_ = nullptr;
+        other.info_ = {};
+    }
+
+    MemoryAllocation& operator=(MemoryAllocation&& other) noexcept {
+        if (this != &other) {
+            reset();
+            allocator_ = other.allocator_;
+            info_ = other.info_;
+            other.allocator_ = nullptr;
+            other.info_ = {};
+        }
+        return *this;
+    }
+
+    void reset() {
+        if (allocator_ && info_.memory != VK_NULL_HANDLE) {
+            allocator_->freeMemory(info_);
+        }
+        allocator_ = nullptr;
+        info_ = {};
+    }
+
+    const MemoryAllocator::AllocationInfo& getInfo() const { return info_; }
+    VkDeviceMemory getMemory() const { return info_.memory; }
+    VkDeviceSize getOffset() const { return info_.offset; }
+    void* getMappedData() const { return info_.mappedData; }
+    MemoryAllocator* getAllocator() const { return allocator_; }
+
+    explicit operator bool() const { return info_.memory != VK_NULL_HANDLE; }
+
+private:
+    MemoryAllocator* allocator_ = nullptr;
+    MemoryAllocator::AllocationInfo info_{};
+};
@@ -0,0 +1,207 @@
+#include "memory_defragmenter.h"
+#include "memory_allocator.h"
+#include "../../core/vulkan_context.h"
+#include "../../core/vulkan_function_loader.h"
+#include "../../core/vulkan_constants.h"
+#include "../../core/deletion_queue.h"
+#include <algorithm>
+#include <iostream>
+
+MemoryDefragmenter::~MemoryDefragmenter() {
+    cleanup();
+}
+
+bool MemoryDefragmenter::initialize(const VulkanContext& context, MemoryAllocator* allocator, CommandExecutor* executor,
+                                    DeletionQueue* deletionQueue) {
+    if (!allocator || !executor || !deletionQueue) {
+        std::cerr << "MemoryDefragmenter: allocator, executor and deletion queue cannot be null" << std::endl;
+        return false;
+    }
+    
+    this->context = &context;
+    this->allocator = allocator;
+    this->executor = executor;
+    this->deletionQueue = deletionQueue;
+    statistics = {};
+    return true;
+}
+
+void MemoryDefragmenter::cleanup() {
+    if (executor) {
+        for (auto& move : moves) {
+            executor->waitForTransfer(move.transfer);
+            executor->freeAsyncTransfer(move.transfer);
+        }
+    }
+    moves.clear();
+    registrations.clear();
+    statistics.movesInFlight = 0;
+    
+    context = nullptr;
+    allocator = nullptr;
+    executor = nullptr;
+    deletionQueue = nullptr;
+}
+
+bool MemoryDefragmenter::registerBuffer(ResourceHandle* handle, VkBufferUsageFlags usage, RelocationCallback onRelocated) {
+    if (!context) {
+        return false;
+    }
+    if (!handle || !handle->buffer || !handle->allocation || handle->mappedData) {
+        std::cerr << "MemoryDefragmenter: Only sub-allocated, unmapped buffers can be moved" << std::endl;
+        return false;
+    }
+    
+    constexpr VkBufferUsageFlags copyUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT;
+    if ((usage & copyUsage) != copyUsage) {
+        std::cerr << "MemoryDefragmenter: Buffer needs TRANSFER_SRC and TRANSFER_DST usage to be moved" << std::endl;
+        return false;
+    }
+    
+    if (findRegistration(handle)) {
+        return true;
+    }
+    
+    Registration registration;
+    registration.handle = handle;
+    registration.usage = usage;
+    registration.onRelocated = std::move(onRelocated);
+    registrations.push_back(std::move(registration));
+    return true;
+}
+
+void MemoryDefragmenter::unregisterBuffer(ResourceHandle* handle) {
+    for (auto it = moves.begin(); it != moves.end();) {
+        if (it->handle != handle) {
+            ++it;
+            continue;
+        }
+        
+        // The copy only read the handle's buffer; its destination goes with it
+        executor->waitForTransfer(it->transfer);
+        executor->freeAsyncTransfer(it->transfer);
+        it = moves.erase(it);
+    }
+    statistics.movesInFlight = static_cast<uint32_t>(moves.size());
+    
+    registrations.erase(std::remove_if(registrations.begin(), registrations.end(),
+                                       [handle](const Registration& registration) { return registration.handle == handle; }),
+                        registrations.end());
+}
+
+void MemoryDefragmenter::beginFrame(uint32_t frameIndex) {
+    (void)frameIndex;
+    if (!context) {
+        return;
+    }
+    
+    completeMoves();
+    scheduleMoves();
+    statistics.movesInFlight = static_cast<uint32_t>(moves.size());
+}
+
+MemoryDefragmenter::Registration* MemoryDefragmenter::findRegistration(const ResourceHandle* handle) {
+    auto it = std::find_if(registrations.begin(), registrations.end(),
+                           [handle](const Registration& registration) { return registration.handle == handle; });
+    return it != registrations.end() ? &*it : nullptr;
+}
+
+void MemoryDefragmenter::completeMoves() {
+    for (auto it = moves.begin(); it != moves.end();) {
+        if (!executor->isTransferComplete(it->transfer)) {
+            ++it;
+            continue;
+        }
+        executor->freeAsyncTransfer(it->transfer);
+        
+        // Frames recorded before this one may still read the old buffer; it goes before its allocation
+        ResourceHandle& handle = *it->handle;
+        deletionQueue->retire(std::move(handle.buffer));
+        deletionQueue->retire(std::move(handle.allocation));
+        
+        handle.allocation = std::move(it->destination.allocation);
+        handle.buffer = std::move(it->destination.buffer);
+        statistics.movesCompleted++;
+        statistics.bytesMoved += it->bytes;
+        
+        if (Registration* registration = findRegistration(it->handle)) {
+            registration->moving = false;
+            if (registration->onRelocated) {
+                registration->onRelocated(handle);
+            }
+        }
+        it = moves.erase(it);
+    }
+}
+
+void MemoryDefragmenter::scheduleMoves() {
+    if (!ENABLE_MEMORY_DEFRAGMENTATION) {
+        return;
+    }
+    
+    VkDeviceSize budget = DEFRAG_BYTES_PER_FRAME;
+    for (auto& registration : registrations) {
+        if (registration.moving || frameSerial < registration.nextAttemptFrame) {
+            continue;
+        }
+        
+        const ResourceHandle& handle = *registration.handle;
+        if (handle.size > budget || !allocator->isRelocationCandidate(handle.allocation.getInfo())) {
+            continue;
+        }
+        
+        if (!startMove(registration)) {
+            statistics.failedMoves++;
+            registration.nextAttemptFrame = frameSerial + DEFRAG_RETRY_FRAMES;
+            continue;
+        }
+        budget -= handle.size;
+    }
+}
+
+bool MemoryDefragmenter::startMove(Registration& registration) {
+    const ResourceHandle& source = *registration.handle;
+    const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
+    
+    // A buffer created like the source has the source's requirements, so its new home is found before creating it
+    VkMemoryRequirements requirements{};
+    vk.vkGetBufferMemoryRequirements(device, source.buffer.get(), &requirements);
+    const MemoryAllocator::AllocationInfo relocated = allocator->allocateForRelocation(source.allocation.getInfo(), requirements);
+    if (relocated.memory == VK_NULL_HANDLE) {
+        return false;
+    }
+    
+    Move move;
+    move.handle = registration.handle;
+    move.destination.allocation = MemoryAllocation(allocator, relocated);
+    move.destination.size = source.size;
+    move.bytes = source.size;
+    
+    VkBufferCreateInfo bufferInfo{};
+    bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+    bufferInfo.size = source.size;
+    bufferInfo.usage = registration.usage;
+    bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+    
+    VkBuffer buffer = VK_NULL_HANDLE;
+    if (vk.vkCreateBuffer(device, &bufferInfo, nullptr, &buffer) != VK_SUCCESS) {
+        std::cerr << "MemoryDefragmenter: Failed to create relocation buffer" << std::endl;
+        return false;
+    }
+    move.destination.buffer = vulkan_raii::make_buffer(buffer, context);
+    
+    if (vk.vkBindBufferMemory(device, buffer, relocated.memory, relocated.offset) != VK_SUCCESS) {
+        std::cerr << "MemoryDefragmenter: Failed to bind relocation buffer memory" << std::endl;
+        return false;
+    }
+    
+    move.transfer = executor->copyBufferToBufferAsync(source.buffer.get(), buffer, source.size);
+    if (!move.transfer.isValid()) {
+        return false;
+    }
+    
+    registration.moving = true;
+    moves.push_back(std::move(move));
+    return true;
+}
@@ -0,0 +1,81 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "resource_handle.h"
+#include "command_executor.h"
+
+class VulkanContext;
+class MemoryAllocator;
+class DeletionQueue;
+
+// Incremental, stall-free compaction of MemoryAllocator blocks. Owners register device-local buffers the GPU only
+// reads once filled; each frame, registered buffers sitting in sparse blocks (MemoryAllocator::isRelocationCandidate)
+// are copied into fuller blocks of the same pool with vkCmdCopyBuffer on the transfer queue, DEFRAG_BYTES_PER_FRAME
+// at most. When a copy's fence has signalled the handle is switched to the new buffer and the owner's callback
+// re-points whatever cached the old one; the old buffer is retired into the renderer's DeletionQueue, and a block
+// it leaves empty goes through the allocator's usual empty-block handling. Render thread only
+class MemoryDefragmenter {
+public:
+    // handle already holds its new buffer; refresh descriptors or device addresses made from the old one
+    using RelocationCallback = std::function<void(const ResourceHandle& handle)>;
+    
+    MemoryDefragmenter() = default;
+    ~MemoryDefragmenter();
+    
+    bool initialize(const VulkanContext& context, MemoryAllocator* allocator, CommandExecutor* executor,
+                    DeletionQueue* deletionQueue);
+    void cleanup();
+    
+    // handle must stay at this address, sub-allocated and unwritten until unregisterBuffer; usage is its creation
+    // usage and must include TRANSFER_SRC and TRANSFER_DST. Owners that read the VkBuffer from the handle every
+    // frame need no callback
+    bool registerBuffer(ResourceHandle* handle, VkBufferUsageFlags usage, RelocationCallback onRelocated = {});
+    
+    // Waits out a move of handle still in flight, so the owner may write or destroy it straight after
+    void unregisterBuffer(ResourceHandle* handle);
+    
+    // Completes moves whose copies finished and schedules this frame's moves - call once frameIndex's fences signal
+    void beginFrame(uint32_t frameIndex);
+    
+    struct Statistics {
+        uint64_t movesCompleted = 0;
+        uint64_t bytesMoved = 0;
+        uint32_t movesInFlight = 0;
+        uint32_t failedMoves = 0;  // No fuller block had room, or the copy could not be submitted
+    };
+    const Statistics& getStatistics() const { return statistics; }
+
+private:
+    struct Registration {
+        ResourceHandle* handle = nullptr;
+        VkBufferUsageFlags usage = 0;
+        RelocationCallback onRelocated;
+        uint64_t nextAttemptFrame = 0;
+        bool moving = false;
+    };
+    
+    struct Move {
+        ResourceHandle* handle = nullptr;
+        ResourceHandle destination;
+        VkDeviceSize bytes = 0;
+        CommandExecutor::AsyncTransfer transfer;
+    };
+    
+    const VulkanContext* context = nullptr;
+    MemoryAllocator* allocator = nullptr;
+    CommandExecutor* executor = nullptr;
+    DeletionQueue* deletionQueue = nullptr;
+    
+    std::vector<Registration> registrations;
+    std::vector<Move> moves;
+    Statistics statistics;
+    
+    Registration* findRegistration(const ResourceHandle* handle);
+    void completeMoves();
+    void scheduleMoves();
+    bool startMove(Registration& registration);
+};
@@ -0,0 +1,160 @@
+#include "readback_ring.h"
+#include "resource_coordinator.h"
+#include "../../core/vulkan_context.h"
+#include "../../core/vulkan_function_loader.h"
+#include <iostream>
+
+namespace {
+
+// Keeps every result suitably aligned for reading back vec4 and uvec4 data in place
+constexpr VkDeviceSize READBACK_ALIGNMENT = 16;
+
+} // anonymous namespace
+
+bool ReadbackRing::initialize(ResourceCoordinator* resourceCoordinator, VkDeviceSize bytesPerFrame) {
+    this->resourceCoordinator = resourceCoordinator;
+    
+    const VulkanContext* context = resourceCoordinator ? resourceCoordinator->getContext() : nullptr;
+    if (!context) {
+        std::cerr << "ReadbackRing: ResourceCoordinator has no context" << std::endl;
+        return false;
+    }
+    
+    this->bytesPerFrame = (bytesPerFrame + READBACK_ALIGNMENT - 1) / READBACK_ALIGNMENT * READBACK_ALIGNMENT;
+    
+    ringBuffer = resourceCoordinator->createMappedBuffer(
+        this->bytesPerFrame * context->getFramesInFlight(),
+        VK_BUFFER_USAGE_TRANSFER_DST_BIT);
+    
+    if (!ringBuffer.isValid() || !ringBuffer.mappedData) {
+        std::cerr << "ReadbackRing: Failed to create persistent mapped readback buffer" << std::endl;
+        return false;
+    }
+    
+    frameCount = context->getFramesInFlight();
+    frameIndex = 0;
+    cursor = 0;
+    return true;
+}
+
+void ReadbackRing::cleanup() {
+    // Callbacks are dropped, not invoked - their owners may already be gone at teardown
+    pending.clear();
+    for (auto& slot : recorded) {
+        slot.clear();
+    }
+    
+    if (ringBuffer.isValid() && resourceCoordinator) {
+        resourceCoordinator->destroyResource(ringBuffer);
+    }
+    ringBuffer = {};
+    bytesPerFrame = 0;
+    cursor = 0;
+}
+
+bool ReadbackRing::request(VkBuffer src, VkDeviceSize offset, VkDeviceSize size, Callback callback) {
+    if (!ringBuffer.mappedData || src == VK_NULL_HANDLE || size == 0 || !callback) {
+        return false;
+    }
+    
+    if (size > bytesPerFrame) {
+        std::cerr << "ReadbackRing: " << size << " byte readback exceeds the " << bytesPerFrame
+                  << " byte frame region" << std::endl;
+        return false;
+    }
+    
+    pending.push_back({src, offset, size, std::move(callback)});
+    return true;
+}
+
+bool ReadbackRing::recordCopies(VkCommandBuffer commandBuffer) {
+    if (pending.empty() || !ringBuffer.isValid()) {
+        return false;
+    }
+    
+    const auto& vk = resourceCoordinator->getContext()->getLoader();
+    auto& slot = recorded[frameIndex];
+    const VkDeviceSize regionBase = frameIndex * bytesPerFrame;
+    
+    // Consecutive requests from one source share a vkCmdCopyBuffer
+    size_t taken = 0;
+    VkBuffer batchSource = VK_NULL_HANDLE;
+    copyRegions.clear();
+    
+    for (; taken < pending.size(); ++taken) {
+        Request& request = pending[taken];
+        const VkDeviceSize alignedSize = (request.size + READBACK_ALIGNMENT - 1) / READBACK_ALIGNMENT * READBACK_ALIGNMENT;
+        if (cursor + request.size > bytesPerFrame) {
+            break;
+        }
+        
+        if (request.src != batchSource && !copyRegions.empty()) {
+            vk.vkCmdCopyBuffer(commandBuffer, batchSource, ringBuffer.buffer.get(),
+                               static_cast<uint32_t>(copyRegions.size()), copyRegions.data());
+            copyRegions.clear();
+        }
+        batchSource = request.src;
+        
+        copyRegions.push_back({request.srcOffset, regionBase + cursor, request.size});
+        slot.push_back({regionBase + cursor, request.size, std::move(request.callback)});
+        cursor += alignedSize;
+    }
+    
+    if (!copyRegions.empty()) {
+        vk.vkCmdCopyBuffer(commandBuffer, batchSource, ringBuffer.buffer.get(),
+                           static_cast<uint32_t>(copyRegions.size()), copyRegions.data());
+    }
+    pending.erase(pending.begin(), pending.begin() + taken);
+    return taken > 0;
+}
+
+bool ReadbackRing::recordCopy(VkCommandBuffer commandBuffer, VkBuffer src, VkDeviceSize offset, VkDeviceSize size, Callback callback) {
+    if (!ringBuffer.isValid() || src == VK_NULL_HANDLE || size == 0 || !callback || cursor + size > bytesPerFrame) {
+        return false;
+    }
+    
+    const VkBufferCopy region{offset, frameIndex * bytesPerFrame + cursor, size};
+    resourceCoordinator->getContext()->getLoader().vkCmdCopyBuffer(commandBuffer, src, ringBuffer.buffer.get(), 1, &region);
+    recorded[frameIndex].push_back({region.dstOffset, size, std::move(callback)});
+    cursor += (size + READBACK_ALIGNMENT - 1) / READBACK_ALIGNMENT * READBACK_ALIGNMENT;
+    return true;
+}
+
+bool ReadbackRing::recordImageCopy(VkCommandBuffer commandBuffer, VkImage src, const VkRect2D& rect, uint32_t texelSize, Callback callback) {
+    const VkDeviceSize size = static_cast<VkDeviceSize>(rect.extent.width) * rect.extent.height * texelSize;
+    if (!ringBuffer.isValid() || src == VK_NULL_HANDLE || size == 0 || !callback || cursor + size > bytesPerFrame) {
+        return false;
+    }
+    
+    // The ring offset stays READBACK_ALIGNMENT aligned, a multiple of any colour texel size
+    VkBufferImageCopy region{};
+    region.bufferOffset = frameIndex * bytesPerFrame + cursor;
+    region.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    region.imageOffset = {rect.offset.x, rect.offset.y, 0};
+    region.imageExtent = {rect.extent.width, rect.extent.height, 1};
+    resourceCoordinator->getContext()->getLoader().vkCmdCopyImageToBuffer(
+        commandBuffer, src, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, ringBuffer.buffer.get(), 1, &region);
+    recorded[frameIndex].push_back({region.bufferOffset, size, std::move(callback)});
+    cursor += (size + READBACK_ALIGNMENT - 1) / READBACK_ALIGNMENT * READBACK_ALIGNMENT;
+    return true;
+}
+
+void ReadbackRing::beginFrame(uint32_t frameIndex) {
+    this->frameIndex = frameIndex % frameCount;
+    cursor = 0;
+    
+    // Callbacks may queue follow-up requests, so the slot is emptied before any of them runs
+    std::vector<RecordedCopy> completed;
+    completed.swap(recorded[this->frameIndex]);
+    for (auto& copy : completed) {
+        copy.callback(static_cast<const char*>(ringBuffer.mappedData) + copy.ringOffset, copy.size);
+    }
+}
+
+void ReadbackRing::cancelPending() {
+    std::vector<Request> cancelled;
+    cancelled.swap(pending);
+    for (auto& request : cancelled) {
+        request.callback(nullptr, 0);
+    }
+}
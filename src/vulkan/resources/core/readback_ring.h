@@ -0,0 +1,78 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include <array>
+#include <cstdint>
+#include <functional>
+#include <vector>
+#include "resource_handle.h"
+#include "../../core/vulkan_constants.h"
+
+class ResourceCoordinator;
+
+// Non-blocking GPU readback: requested buffer ranges are copied into one persistent mapped buffer split into
+// one region per frame in flight. A region's copies are recorded into that frame's command buffer and only
+// resolved when the slot comes round again, after its fences have signalled, so nothing waits on the GPU.
+// Requests, recording and callbacks all happen on the render thread.
+class ReadbackRing {
+public:
+    // data points at size bytes valid only for the call; nullptr when the request was cancelled
+    using Callback = std::function<void(const void* data, VkDeviceSize size)>;
+    
+    ReadbackRing() = default;
+    ~ReadbackRing() = default;
+    
+    bool initialize(ResourceCoordinator* resourceCoordinator, VkDeviceSize bytesPerFrame);
+    void cleanup();
+    
+    // Queues a copy of [offset, offset + size) of src for the next recordCopies()
+    bool request(VkBuffer src, VkDeviceSize offset, VkDeviceSize size, Callback callback);
+    bool hasPendingRequests() const { return !pending.empty(); }
+    
+    // Records every queued copy that fits the current frame's region; the rest wait for a later frame.
+    // The caller makes source writes visible to transfer reads before, and the copies available to the
+    // host after, whenever this returns true
+    bool recordCopies(VkCommandBuffer commandBuffer);
+    
+    // Records one copy straight into commandBuffer, for a pass that reads back its own output where it produces
+    // it (no ordering against the readback node needed); barriers as for recordCopies. False when the current
+    // frame's region has no room left
+    bool recordCopy(VkCommandBuffer commandBuffer, VkBuffer src, VkDeviceSize offset, VkDeviceSize size, Callback callback);
+    
+    // recordCopy for an image rect of a colour image in TRANSFER_SRC_OPTIMAL, tightly packed at texelSize bytes
+    bool recordImageCopy(VkCommandBuffer commandBuffer, VkImage src, const VkRect2D& rect, uint32_t texelSize, Callback callback);
+    
+    // Resolves the copies recorded while frameIndex was last current - call after waiting on that slot's fences
+    void beginFrame(uint32_t frameIndex);
+    
+    // Cancels requests not yet recorded, for when their source buffers are about to be destroyed
+    void cancelPending();
+
+private:
+    struct Request {
+        VkBuffer src = VK_NULL_HANDLE;
+        VkDeviceSize srcOffset = 0;
+        VkDeviceSize size = 0;
+        Callback callback;
+    };
+    
+    struct RecordedCopy {
+        VkDeviceSize ringOffset = 0;
+        VkDeviceSize size = 0;
+        Callback callback;
+    };
+    
+    ResourceCoordinator* resourceCoordinator = nullptr;
+    ResourceHandle ringBuffer;
+    VkDeviceSize bytesPerFrame = 0;
+    
+    std::vector<Request> pending;
+    std::array<std::vector<RecordedCopy>, MAX_FRAMES_IN_FLIGHT> recorded;  // Resolved with their frame slot
+    std::vector<VkBufferCopy> copyRegions;
+    
+    // Current frame region and bump cursor within it (one region per frame in flight)
+    uint32_t frameCount = 1;
+    uint32_t frameIndex = 0;
+    VkDeviceSize cursor = 0;
+};
@@ -3,6 +3,9 @@
 #include "transfer_manager.h"
 #include "memory_allocator.h"
 #include "validation_utils.h"
+#include "frame_ring_allocator.h"
+#include "readback_ring.h"
+#include "memory_defragmenter.h"
 // Bridge no longer needed - BufferManager uses coordinator directly
 #include "../managers/descriptor_pool_manager.h"
 #include "../managers/graphics_resource_manager.h"
@@ -13,6 +16,8 @@
 #include "../buffers/buffer_factory.h"
 #include "../../core/vulkan_context.h"
 #include "../../core/queue_manager.h"
+#include "../../core/deletion_queue.h"
+#include "../../core/vulkan_constants.h"
 #include <stdexcept>
 
 ResourceCoordinator::ResourceCoordinator() {
@@ -22,12 +27,13 @@ ResourceCoordinator::~ResourceCoordinator() {
     cleanup();
 }
 
-bool ResourceCoordinator::initialize(const VulkanContext& context, QueueManager* queueManager) {
-    if (!ValidationUtils::validateDependencies("ResourceCoordinator::initialize", &context, queueManager)) {
+bool ResourceCoordinator::initialize(const VulkanContext& context, QueueManager* queueManager, DeletionQueue* deletionQueue) {
+    if (!ValidationUtils::validateDependencies("ResourceCoordinator::initialize", &context, queueManager, deletionQueue)) {
         return false;
     }
     
     this->context = &context;
+    this->deletionQueue = deletionQueue;
     
     // Initialize command executor first
     if (!executor.initialize(context, queueManager)) {
@@ -52,23 +58,44 @@ void ResourceCoordinator::cleanup() {
 }
 
 void ResourceCoordinator::cleanupBeforeContextDestruction() {
+    if (memoryDefragmenter) {
+        memoryDefragmenter->cleanup();
+    }
+    // The device is idle; retired buffers hold allocations that must go back before the allocator does
+    if (deletionQueue) {
+        deletionQueue->flush();
+    }
+    executor.cleanupBeforeContextDestruction();
     if (resourceFactory) {
         resourceFactory->cleanupBeforeContextDestruction();
     }
     if (bufferManager) {
         bufferManager->cleanup();
     }
+    if (frameRingAllocator) {
+        frameRingAllocator->cleanup();
+    }
+    if (readbackRing) {
+        readbackRing->cleanup();
+    }
+    if (streamingReadbackRing) {
+        streamingReadbackRing->cleanup();
+    }
+    if (descriptorPoolManager) {
+        descriptorPoolManager->cleanup();
+    }
 }
 
 ResourceHandle ResourceCoordinator::createBuffer(VkDeviceSize size, 
                                                 VkBufferUsageFlags usage,
-                                                VkMemoryPropertyFlags properties) {
+                                                VkMemoryPropertyFlags properties,
+                                                MemoryAllocator::Priority priority) {
     if (!resourceFactory) {
         ValidationUtils::logError("ResourceCoordinator", "createBuffer", "ResourceFactory not initialized");
         return {};
     }
     
-    return resourceFactory->createBuffer(size, usage, properties);
+    return resourceFactory->createBuffer(size, usage, properties, priority);
 }
 
 ResourceHandle ResourceCoordinator::createMappedBuffer(VkDeviceSize size,
@@ -82,6 +109,15 @@ ResourceHandle ResourceCoordinator::createMappedBuffer(VkDeviceSize size,
     return resourceFactory->createMappedBuffer(size, usage, properties);
 }
 
+ResourceHandle ResourceCoordinator::createHostWriteBuffer(VkDeviceSize size, VkBufferUsageFlags usage) {
+    if (!resourceFactory) {
+        ValidationUtils::logError("ResourceCoordinator", "createHostWriteBuffer", "ResourceFactory not initialized");
+        return {};
+    }
+    
+    return resourceFactory->createHostWriteBuffer(size, usage);
+}
+
 ResourceHandle ResourceCoordinator::createImage(uint32_t width, uint32_t height,
                                                VkFormat format,
                                                VkImageUsageFlags usage,
@@ -163,6 +199,59 @@ GraphicsResourceManager* ResourceCoordinator::getGraphicsManager() const {
     return graphicsResourceManager.get();
 }
 
+FrameRingAllocator* ResourceCoordinator::getFrameRingAllocator() const {
+    return frameRingAllocator.get();
+}
+
+ReadbackRing* ResourceCoordinator::getReadbackRing() const {
+    return readbackRing.get();
+}
+
+bool ResourceCoordinator::enableStreamingReadbackRing(VkDeviceSize bytesPerFrame) {
+    if (streamingReadbackRing) {
+        return true;
+    }
+    
+    auto ring = std::make_unique<ReadbackRing>();
+    if (!ring->initialize(this, bytesPerFrame)) {
+        return false;  // ReadbackRing logged why
+    }
+    streamingReadbackRing = std::move(ring);
+    return true;
+}
+
+MemoryDefragmenter* ResourceCoordinator::getMemoryDefragmenter() const {
+    return memoryDefragmenter.get();
+}
+
+ReadbackRing* ResourceCoordinator::getStreamingReadbackRing() const {
+    return streamingReadbackRing.get();
+}
+
+void ResourceCoordinator::beginFrame(uint32_t frameIndex) {
+    if (memoryAllocator) {
+        memoryAllocator->refreshMemoryBudget();
+    }
+    if (frameRingAllocator) {
+        frameRingAllocator->beginFrame(frameIndex);
+    }
+    if (bufferManager) {
+        bufferManager->beginFrame(frameIndex);
+    }
+    if (readbackRing) {
+        readbackRing->beginFrame(frameIndex);
+    }
+    if (streamingReadbackRing) {
+        streamingReadbackRing->beginFrame(frameIndex);
+    }
+    if (descriptorPoolManager) {
+        descriptorPoolManager->beginFrame(frameIndex);
+    }
+    if (memoryDefragmenter) {
+        memoryDefragmenter->beginFrame(frameIndex);
+    }
+}
+
 BufferManager* ResourceCoordinator::getBufferManager() const {
     return bufferManager.get();
 }
@@ -182,8 +271,7 @@ VkDeviceSize ResourceCoordinator::getTotalAllocatedMemory() const {
 
 VkDeviceSize ResourceCoordinator::getAvailableMemory() const {
     if (!memoryAllocator) return 0;
-    auto stats = memoryAllocator->getMemoryStats();
-    return stats.totalAllocated > stats.totalFreed ? stats.totalAllocated - stats.totalFreed : 0;
+    return memoryAllocator->getDeviceLocalBudget().availableBytes;
 }
 
 uint32_t ResourceCoordinator::getAllocationCount() const {
@@ -222,7 +310,7 @@ bool ResourceCoordinator::initializeManagers(QueueManager* queueManager) {
     
     // 3. BufferManager (no longer needs bridge - uses coordinator directly)
     bufferManager = std::make_unique<BufferManager>();
-    if (!bufferManager->initialize(this, 16 * 1024 * 1024)) {
+    if (!bufferManager->initialize(this, STAGING_BUFFER_SIZE)) {
         return false;
     }
     
@@ -244,6 +332,24 @@ bool ResourceCoordinator::initializeManagers(QueueManager* queueManager) {
         return false;
     }
     
+    // 8. FrameRingAllocator (depends on ResourceFactory for its mapped buffer)
+    frameRingAllocator = std::make_unique<FrameRingAllocator>();
+    if (!frameRingAllocator->initialize(this, FRAME_RING_BYTES_PER_FRAME)) {
+        return false;
+    }
+    
+    // 9. ReadbackRing (depends on ResourceFactory for its mapped buffer)
+    readbackRing = std::make_unique<ReadbackRing>();
+    if (!readbackRing->initialize(this, READBACK_RING_BYTES_PER_FRAME)) {
+        return false;
+    }
+    
+    // 10. MemoryDefragmenter (depends on MemoryAllocator and the command executor's transfer queue)
+    memoryDefragmenter = std::make_unique<MemoryDefragmenter>();
+    if (!memoryDefragmenter->initialize(*context, memoryAllocator.get(), &executor, deletionQueue)) {
+        return false;
+    }
+    
     return true;
 }
 
@@ -257,11 +363,32 @@ void ResourceCoordinator::setupManagerDependencies() {
             bufferFactory->setStagingBuffer(&bufferManager->getPrimaryStagingBuffer());
         }
     }
+    
+    if (graphicsResourceManager) {
+        graphicsResourceManager->setMemoryDefragmenter(memoryDefragmenter.get());
+    }
 }
 
 void ResourceCoordinator::cleanupManagers() {
     // Cleanup in reverse order of initialization
+    if (streamingReadbackRing) {
+        streamingReadbackRing->cleanup();
+        streamingReadbackRing.reset();
+    }
+    if (readbackRing) {
+        readbackRing->cleanup();
+        readbackRing.reset();
+    }
+    if (frameRingAllocator) {
+        frameRingAllocator->cleanup();
+        frameRingAllocator.reset();
+    }
+    // Registered owners unregister on their way out, so the defragmenter outlives them
     graphicsResourceManager.reset();
+    if (memoryDefragmenter) {
+        memoryDefragmenter->cleanup();
+        memoryDefragmenter.reset();
+    }
     descriptorPoolManager.reset();
     transferManager.reset();
     bufferManager.reset();
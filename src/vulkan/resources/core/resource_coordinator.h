@@ -17,6 +17,10 @@ class DescriptorPoolManager;
 class GraphicsResourceManager;
 class BufferManager;
 class StagingBufferPool;
+class FrameRingAllocator;
+class ReadbackRing;
+class MemoryDefragmenter;
+class DeletionQueue;
 
 // Lightweight coordination only - delegates to specialized managers
 class ResourceCoordinator {
@@ -24,7 +28,8 @@ public:
     ResourceCoordinator();
     ~ResourceCoordinator();
     
-    bool initialize(const VulkanContext& context, QueueManager* queueManager);
+    // deletionQueue is the renderer's; buffers replaced while frames are in flight are retired into it
+    bool initialize(const VulkanContext& context, QueueManager* queueManager, DeletionQueue* deletionQueue);
     void cleanup();
     void cleanupBeforeContextDestruction();
     
@@ -34,12 +39,15 @@ public:
     // Resource creation (delegates to ResourceFactory)
     ResourceHandle createBuffer(VkDeviceSize size, 
                                VkBufferUsageFlags usage,
-                               VkMemoryPropertyFlags properties);
+                               VkMemoryPropertyFlags properties,
+                               MemoryAllocator::Priority priority = MemoryAllocator::Priority::Normal);
     
     ResourceHandle createMappedBuffer(VkDeviceSize size,
                                      VkBufferUsageFlags usage,
                                      VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
     
+    ResourceHandle createHostWriteBuffer(VkDeviceSize size, VkBufferUsageFlags usage);
+    
     ResourceHandle createImage(uint32_t width, uint32_t height,
                               VkFormat format,
                               VkImageUsageFlags usage,
@@ -66,9 +74,23 @@ public:
     DescriptorPoolManager* getDescriptorPoolManager() const;
     GraphicsResourceManager* getGraphicsManager() const;
     BufferManager* getBufferManager() const;
+    FrameRingAllocator* getFrameRingAllocator() const;
+    ReadbackRing* getReadbackRing() const;
+    MemoryDefragmenter* getMemoryDefragmenter() const;
+    DeletionQueue* getDeletionQueue() const { return deletionQueue; }
+    
+    // Second, much larger ReadbackRing for bulk streaming readbacks (entity telemetry capture), created on first
+    // use so runs without them map no extra memory; recorded and resolved alongside the default ring
+    bool enableStreamingReadbackRing(VkDeviceSize bytesPerFrame);
+    ReadbackRing* getStreamingReadbackRing() const;
     CommandExecutor* getCommandExecutor() { return &executor; }
     const CommandExecutor* getCommandExecutor() const { return &executor; }
     
+    // Polls the driver memory budget, then rewinds the frame ring region, retires staging segments, resolves
+    // readbacks, resets the transient descriptor arena of frameIndex and advances defragmentation - call once its
+    // fences signal
+    void beginFrame(uint32_t frameIndex);
+    
     // Graphics resource convenience methods
     const std::vector<VkBuffer>& getUniformBuffers() const;
     const std::vector<void*>& getUniformBuffersMapped() const;
@@ -79,7 +101,7 @@ public:
     
     // Simplified memory statistics interface
     VkDeviceSize getTotalAllocatedMemory() const;
-    VkDeviceSize getAvailableMemory() const;
+    VkDeviceSize getAvailableMemory() const;  // Headroom left in the device-local budget
     uint32_t getAllocationCount() const;
     
     // Performance optimization
@@ -87,6 +109,7 @@ public:
 
 private:
     const VulkanContext* context = nullptr;
+    DeletionQueue* deletionQueue = nullptr;
     CommandExecutor executor;
     
     // Bridge no longer needed - BufferManager uses coordinator directly
@@ -98,6 +121,10 @@ private:
     std::unique_ptr<DescriptorPoolManager> descriptorPoolManager;
     std::unique_ptr<GraphicsResourceManager> graphicsResourceManager;
     std::unique_ptr<BufferManager> bufferManager;
+    std::unique_ptr<FrameRingAllocator> frameRingAllocator;
+    std::unique_ptr<ReadbackRing> readbackRing;
+    std::unique_ptr<ReadbackRing> streamingReadbackRing;
+    std::unique_ptr<MemoryDefragmenter> memoryDefragmenter;
     
     // Initialization helpers
     bool initializeManagers(QueueManager* queueManager);
@@ -36,13 +36,14 @@ void ResourceFactory::cleanupBeforeContextDestruction() {
 
 ResourceHandle ResourceFactory::createBuffer(VkDeviceSize size, 
                                             VkBufferUsageFlags usage,
-                                            VkMemoryPropertyFlags properties) {
+                                            VkMemoryPropertyFlags properties,
+                                            MemoryAllocator::Priority priority) {
     if (!initialized || !bufferFactory) {
         ValidationUtils::logError("ResourceFactory", "createBuffer", "not initialized");
         return {};
     }
     
-    return bufferFactory->createBuffer(size, usage, properties);
+    return bufferFactory->createBuffer(size, usage, properties, priority);
 }
 
 ResourceHandle ResourceFactory::createMappedBuffer(VkDeviceSize size,
@@ -56,6 +57,15 @@ ResourceHandle ResourceFactory::createMappedBuffer(VkDeviceSize size,
     return bufferFactory->createMappedBuffer(size, usage, properties);
 }
 
+ResourceHandle ResourceFactory::createHostWriteBuffer(VkDeviceSize size, VkBufferUsageFlags usage) {
+    if (!initialized || !bufferFactory) {
+        ValidationUtils::logError("ResourceFactory", "createHostWriteBuffer", "not initialized");
+        return {};
+    }
+    
+    return bufferFactory->createHostWriteBuffer(size, usage);
+}
+
 ResourceHandle ResourceFactory::createImage(uint32_t width, uint32_t height,
                                            VkFormat format,
                                            VkImageUsageFlags usage,
@@ -23,12 +23,15 @@ public:
     // Core resource creation operations
     ResourceHandle createBuffer(VkDeviceSize size, 
                                VkBufferUsageFlags usage,
-                               VkMemoryPropertyFlags properties);
+                               VkMemoryPropertyFlags properties,
+                               MemoryAllocator::Priority priority = MemoryAllocator::Priority::Normal);
     
     ResourceHandle createMappedBuffer(VkDeviceSize size,
                                      VkBufferUsageFlags usage,
                                      VkMemoryPropertyFlags properties = VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
     
+    ResourceHandle createHostWriteBuffer(VkDeviceSize size, VkBufferUsageFlags usage);
+    
     ResourceHandle createImage(uint32_t width, uint32_t height,
                               VkFormat format,
                               VkImageUsageFlags usage,
@@ -3,15 +3,21 @@
 #define VK_NO_PROTOTYPES
 #include <vulkan/vulkan.h>
 #include "../../core/vulkan_raii.h"
+#include "memory_allocator.h"
 
 // Resource handle combining buffer/image with allocation
 struct ResourceHandle {
+    MemoryAllocation allocation;       // From MemoryAllocator; declared first so it outlives the buffer/image bound to it
     vulkan_raii::Buffer buffer;
     vulkan_raii::Image image;
     vulkan_raii::ImageView imageView;
-    vulkan_raii::DeviceMemory memory;
+    vulkan_raii::DeviceMemory memory;  // Memory the handle's owner allocated itself, outside MemoryAllocator
     void* mappedData = nullptr;
     VkDeviceSize size = 0;
-    
+
     bool isValid() const { return buffer || image; }
-};
\ No newline at end of file
+
+    // Memory the resource is bound to, whichever of the two owns it
+    VkDeviceMemory getMemory() const { return allocation ? allocation.getMemory() : memory.get(); }
+    VkDeviceSize getMemoryOffset() const { return allocation ? allocation.getOffset() : 0; }
+};
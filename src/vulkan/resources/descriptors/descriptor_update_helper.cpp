@@ -8,55 +8,127 @@ bool DescriptorUpdateHelper::updateDescriptorSet(
     VkDescriptorSet descriptorSet,
     const std::vector<BufferBinding>& bindings) {
     
-    if (!validateDescriptorSet(descriptorSet)) {
-        return false;
-    }
-    
     if (bindings.empty()) {
         std::cerr << "DescriptorUpdateHelper: No bindings provided" << std::endl;
         return false;
     }
 
-    // Validate all bindings first
+    DescriptorWriteBatch batch;
+    if (!batch.add(descriptorSet, bindings)) {
+        return false;
+    }
+    batch.flush(context);
+    return true;
+}
+
+bool DescriptorUpdateHelper::updateDescriptorSetWithTemplate(
+    const VulkanContext& context,
+    VkDescriptorSet descriptorSet,
+    const UpdateTemplate* updateTemplate,
+    const std::vector<BufferBinding>& bindings
+) {
+    DescriptorWriteBatch batch;
+    if (!batch.add(descriptorSet, updateTemplate, bindings)) {
+        return false;
+    }
+    batch.flush(context);
+    return true;
+}
+
+bool DescriptorUpdateHelper::fillTemplateData(const UpdateTemplate& updateTemplate,
+                                              const std::vector<BufferBinding>& bindings,
+                                              TemplateData& data) {
+    uint32_t coveredMask = 0;
     for (const auto& binding : bindings) {
-        if (!validateBinding(binding)) {
+        if (binding.binding >= MAX_DESCRIPTOR_TEMPLATE_BINDINGS) {
             return false;
         }
+        const uint32_t bit = 1u << binding.binding;
+        if (!(updateTemplate.bindingMask & bit) || (coveredMask & bit) ||
+            updateTemplate.types[binding.binding] != binding.type) {
+            return false;
+        }
+        coveredMask |= bit;
+        data[binding.binding] = {binding.buffer, binding.offset, binding.range};
     }
+    
+    // A template writes all of its entries, so a binding left out would be written from garbage
+    return coveredMask == updateTemplate.bindingMask;
+}
 
-    // Prepare descriptor writes
-    std::vector<VkWriteDescriptorSet> descriptorWrites(bindings.size());
-    std::vector<VkDescriptorBufferInfo> bufferInfos(bindings.size());
-
-    for (size_t i = 0; i < bindings.size(); ++i) {
-        const auto& binding = bindings[i];
-        
-        // Fill buffer info
-        bufferInfos[i].buffer = binding.buffer;
-        bufferInfos[i].offset = binding.offset;
-        bufferInfos[i].range = binding.range;
-
-        // Fill write descriptor
-        descriptorWrites[i] = {};
-        descriptorWrites[i].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
-        descriptorWrites[i].dstSet = descriptorSet;
-        descriptorWrites[i].dstBinding = binding.binding;
-        descriptorWrites[i].dstArrayElement = 0;
-        descriptorWrites[i].descriptorType = binding.type;
-        descriptorWrites[i].descriptorCount = 1;
-        descriptorWrites[i].pBufferInfo = &bufferInfos[i];
+bool DescriptorUpdateHelper::updateDescriptorSets(
+    const VulkanContext& context,
+    const std::vector<VkDescriptorSet>& descriptorSets,
+    const std::vector<BufferBinding>& bindingTemplate
+) {
+    DescriptorWriteBatch batch;
+    for (VkDescriptorSet descriptorSet : descriptorSets) {
+        if (!batch.add(descriptorSet, bindingTemplate)) {
+            return false;
+        }
     }
+    batch.flush(context);
+    return true;
+}
 
-    // Execute update
-    const auto& vk = context.getLoader();
-    vk.vkUpdateDescriptorSets(
-        context.getDevice(), 
-        static_cast<uint32_t>(descriptorWrites.size()), 
-        descriptorWrites.data(), 
-        0, 
-        nullptr
-    );
+bool DescriptorUpdateHelper::updateUniformBufferBinding(
+    const VulkanContext& context,
+    const std::vector<VkDescriptorSet>& descriptorSets,
+    uint32_t binding,
+    const std::vector<VkBuffer>& uniformBuffers,
+    VkDeviceSize bufferSize,
+    VkDescriptorType type
+) {
+    if (uniformBuffers.size() < descriptorSets.size()) {
+        std::cerr << "DescriptorUpdateHelper: " << descriptorSets.size() << " descriptor sets but only "
+                  << uniformBuffers.size() << " uniform buffers" << std::endl;
+        return false;
+    }
+    
+    DescriptorWriteBatch batch;
+    for (size_t i = 0; i < descriptorSets.size(); ++i) {
+        if (!batch.add(descriptorSets[i], {BufferBinding(binding, uniformBuffers[i], 0, bufferSize, type)})) {
+            return false;
+        }
+    }
+    batch.flush(context);
+    return true;
+}
 
+bool DescriptorUpdateHelper::pushBufferBindings(
+    const VulkanContext& context,
+    VkCommandBuffer commandBuffer,
+    VkPipelineBindPoint bindPoint,
+    VkPipelineLayout layout,
+    uint32_t set,
+    const std::vector<BufferBinding>& bindings) {
+    
+    if (!context.supportsPushDescriptors()) {
+        std::cerr << "DescriptorUpdateHelper: Push descriptors not supported" << std::endl;
+        return false;
+    }
+    
+    std::vector<VkDescriptorBufferInfo> bufferInfos;
+    std::vector<VkWriteDescriptorSet> writes;
+    bufferInfos.reserve(bindings.size());
+    writes.reserve(bindings.size());
+    for (const auto& binding : bindings) {
+        if (!validateBinding(binding)) {
+            return false;
+        }
+        bufferInfos.push_back({binding.buffer, binding.offset, binding.range});
+        
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstBinding = binding.binding;
+        write.descriptorCount = 1;
+        write.descriptorType = binding.type;
+        write.pBufferInfo = &bufferInfos.back();
+        writes.push_back(write);
+    }
+    
+    context.getLoader().vkCmdPushDescriptorSetKHR(commandBuffer, bindPoint, layout, set,
+                                                  static_cast<uint32_t>(writes.size()), writes.data());
     return true;
 }
 
@@ -70,6 +142,8 @@ bool DescriptorUpdateHelper::validateBinding(const BufferBinding& binding) {
     switch (binding.type) {
         case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER:
         case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER:
+        case VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC:
+        case VK_DESCRIPTOR_TYPE_STORAGE_BUFFER_DYNAMIC:
             // Valid buffer types
             break;
         default:
@@ -86,4 +160,77 @@ bool DescriptorUpdateHelper::validateDescriptorSet(VkDescriptorSet descriptorSet
         return false;
     }
     return true;
+}
+
+bool DescriptorWriteBatch::add(VkDescriptorSet descriptorSet, const std::vector<BufferBinding>& bindings) {
+    if (!DescriptorUpdateHelper::validateDescriptorSet(descriptorSet)) {
+        return false;
+    }
+    for (const auto& binding : bindings) {
+        if (!DescriptorUpdateHelper::validateBinding(binding)) {
+            return false;
+        }
+    }
+    
+    for (const auto& binding : bindings) {
+        bufferInfos.push_back({binding.buffer, binding.offset, binding.range});
+        
+        VkWriteDescriptorSet write{};
+        write.sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+        write.dstSet = descriptorSet;
+        write.dstBinding = binding.binding;
+        write.dstArrayElement = 0;
+        write.descriptorType = binding.type;
+        write.descriptorCount = 1;
+        writes.push_back(write);
+    }
+    return true;
+}
+
+bool DescriptorWriteBatch::add(VkDescriptorSet descriptorSet,
+                               const DescriptorUpdateHelper::UpdateTemplate* updateTemplate,
+                               const std::vector<BufferBinding>& bindings) {
+    TemplateUpdate update{descriptorSet, VK_NULL_HANDLE, {}};
+    if (!updateTemplate || updateTemplate->handle == VK_NULL_HANDLE ||
+        !DescriptorUpdateHelper::fillTemplateData(*updateTemplate, bindings, update.data)) {
+        return add(descriptorSet, bindings);
+    }
+    
+    if (!DescriptorUpdateHelper::validateDescriptorSet(descriptorSet)) {
+        return false;
+    }
+    for (const auto& binding : bindings) {
+        if (!DescriptorUpdateHelper::validateBinding(binding)) {
+            return false;
+        }
+    }
+    
+    update.handle = updateTemplate->handle;
+    templateUpdates.push_back(update);
+    return true;
+}
+
+void DescriptorWriteBatch::flush(const VulkanContext& context) {
+    const auto& vk = context.getLoader();
+    VkDevice device = context.getDevice();
+    
+    for (const auto& update : templateUpdates) {
+        vk.vkUpdateDescriptorSetWithTemplateKHR(device, update.descriptorSet, update.handle, update.data.data());
+    }
+    
+    if (!writes.empty()) {
+        // Every write carries exactly one buffer info, queued in the same order
+        for (size_t i = 0; i < writes.size(); ++i) {
+            writes[i].pBufferInfo = &bufferInfos[i];
+        }
+        vk.vkUpdateDescriptorSets(device, static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+    
+    clear();
+}
+
+void DescriptorWriteBatch::clear() {
+    writes.clear();
+    bufferInfos.clear();
+    templateUpdates.clear();
 }
\ No newline at end of file
@@ -1,8 +1,9 @@
 #pragma once
 
 #include <vulkan/vulkan.h>
-#include <vector>
 #include <array>
+#include <vector>
+#include "../../core/vulkan_constants.h"
 
 class VulkanContext;
 
@@ -13,7 +14,8 @@ class VulkanContext;
  * - Provides templated helpers for common descriptor update patterns
  * - Handles VkWriteDescriptorSet array construction
  * - Manages buffer info arrays and validation
- * - No state, no lifecycle - pure utility functions
+ * - Rewrites whole sets through update templates where the layout has one
+ * - No state, no lifecycle - pure utility functions (DescriptorWriteBatch below holds the batched state)
  */
 class DescriptorUpdateHelper {
 public:
@@ -31,6 +33,15 @@ public:
         BufferBinding(uint32_t binding, VkBuffer buffer, VkDeviceSize offset, VkDeviceSize range, VkDescriptorType type)
             : binding(binding), buffer(buffer), offset(offset), range(range), type(type) {}
     };
+    
+    // Update template over a buffer-only layout, built once per layout by DescriptorLayoutManager. Its data is
+    // one VkDescriptorBufferInfo per binding number, and it writes every binding in bindingMask
+    struct UpdateTemplate {
+        VkDescriptorUpdateTemplateKHR handle = VK_NULL_HANDLE;
+        uint32_t bindingMask = 0;
+        std::array<VkDescriptorType, MAX_DESCRIPTOR_TEMPLATE_BINDINGS> types{};
+    };
+    using TemplateData = std::array<VkDescriptorBufferInfo, MAX_DESCRIPTOR_TEMPLATE_BINDINGS>;
 
     // Single descriptor set update with multiple bindings
     static bool updateDescriptorSet(
@@ -39,40 +50,48 @@ public:
         const std::vector<BufferBinding>& bindings
     );
 
-    // Multiple descriptor sets with same binding pattern (for MAX_FRAMES_IN_FLIGHT)
-    template<size_t N>
+    // Whole-set rewrite in one template call; falls back to updateDescriptorSet when updateTemplate is null or
+    // bindings do not cover exactly the bindings it writes
+    static bool updateDescriptorSetWithTemplate(
+        const VulkanContext& context,
+        VkDescriptorSet descriptorSet,
+        const UpdateTemplate* updateTemplate,
+        const std::vector<BufferBinding>& bindings
+    );
+    
+    // Packs bindings into updateTemplate's data layout; false when they do not match what it writes
+    static bool fillTemplateData(const UpdateTemplate& updateTemplate, const std::vector<BufferBinding>& bindings,
+                                 TemplateData& data);
+
+    // Multiple descriptor sets with same binding pattern (one per frame in flight), in one update call
     static bool updateDescriptorSets(
         const VulkanContext& context,
-        const std::array<VkDescriptorSet, N>& descriptorSets,
+        const std::vector<VkDescriptorSet>& descriptorSets,
         const std::vector<BufferBinding>& bindingTemplate
-    ) {
-        for (size_t i = 0; i < N; ++i) {
-            if (!updateDescriptorSet(context, descriptorSets[i], bindingTemplate)) {
-                return false;
-            }
-        }
-        return true;
-    }
+    );
 
-    // Specialized helper for per-frame uniform buffer updates
-    template<size_t N>
+    // Specialized helper for per-frame uniform buffer updates (descriptorSets and uniformBuffers pair up by index),
+    // in one update call
     static bool updateUniformBufferBinding(
         const VulkanContext& context,
-        const std::array<VkDescriptorSet, N>& descriptorSets,
+        const std::vector<VkDescriptorSet>& descriptorSets,
         uint32_t binding,
-        const std::array<VkBuffer, N>& uniformBuffers,
-        VkDeviceSize bufferSize
-    ) {
-        for (size_t i = 0; i < N; ++i) {
-            BufferBinding uniformBinding(binding, uniformBuffers[i], 0, bufferSize, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
-            std::vector<BufferBinding> bindings = {uniformBinding};
-            
-            if (!updateDescriptorSet(context, descriptorSets[i], bindings)) {
-                return false;
-            }
-        }
-        return true;
-    }
+        const std::vector<VkBuffer>& uniformBuffers,
+        VkDeviceSize bufferSize,
+        VkDescriptorType type = VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER
+    );
+
+    // Records bindings into set of layout (a push descriptor layout) for the next dispatch or draw at bindPoint,
+    // with no set or pool behind them. False when a binding fails validation or the device has no
+    // VK_KHR_push_descriptor
+    static bool pushBufferBindings(
+        const VulkanContext& context,
+        VkCommandBuffer commandBuffer,
+        VkPipelineBindPoint bindPoint,
+        VkPipelineLayout layout,
+        uint32_t set,
+        const std::vector<BufferBinding>& bindings
+    );
 
     // Validation helpers
     static bool validateBinding(const BufferBinding& binding);
@@ -82,4 +101,40 @@ private:
     // No instantiation - pure utility class
     DescriptorUpdateHelper() = delete;
     ~DescriptorUpdateHelper() = delete;
+};
+
+/**
+ * DescriptorWriteBatch - Descriptor writes for several sets, submitted together by flush()
+ * 
+ * Plain writes go out in a single vkUpdateDescriptorSets call; template updates are one call per set. Nothing
+ * reaches the driver before flush(), so batched sets must not be pending on the GPU at that point unless their
+ * bindings are update-after-bind
+ */
+class DescriptorWriteBatch {
+public:
+    using BufferBinding = DescriptorUpdateHelper::BufferBinding;
+    
+    // False (and nothing queued) when the set or a binding fails validation
+    bool add(VkDescriptorSet descriptorSet, const std::vector<BufferBinding>& bindings);
+    
+    // Queues a template update, or plain writes when updateTemplate is null or does not match bindings
+    bool add(VkDescriptorSet descriptorSet, const DescriptorUpdateHelper::UpdateTemplate* updateTemplate,
+             const std::vector<BufferBinding>& bindings);
+    
+    void flush(const VulkanContext& context);
+    void clear();
+    
+    bool empty() const { return writes.empty() && templateUpdates.empty(); }
+
+private:
+    struct TemplateUpdate {
+        VkDescriptorSet descriptorSet;
+        VkDescriptorUpdateTemplateKHR handle;
+        DescriptorUpdateHelper::TemplateData data;
+    };
+    
+    // pBufferInfo is patched from bufferInfos at flush(), which may have reallocated since add()
+    std::vector<VkWriteDescriptorSet> writes;
+    std::vector<VkDescriptorBufferInfo> bufferInfos;
+    std::vector<TemplateUpdate> templateUpdates;
 };
\ No newline at end of file
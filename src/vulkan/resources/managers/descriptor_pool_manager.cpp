@@ -3,6 +3,7 @@
 #include "../../core/vulkan_function_loader.h"
 #include <vector>
 #include <iostream>
+#include <algorithm>
 
 DescriptorPoolManager::DescriptorPoolManager() {
 }
@@ -17,6 +18,7 @@ bool DescriptorPoolManager::initialize(const VulkanContext& context) {
 }
 
 void DescriptorPoolManager::cleanup() {
+    releaseTransientPools();
     context = nullptr;
 }
 
@@ -30,6 +32,9 @@ vulkan_raii::DescriptorPool DescriptorPoolManager::createDescriptorPool(const De
     if (config.uniformBuffers > 0) {
         poolSizes.push_back({VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, config.uniformBuffers});
     }
+    if (config.dynamicUniformBuffers > 0) {
+        poolSizes.push_back({VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, config.dynamicUniformBuffers});
+    }
     if (config.storageBuffers > 0) {
         poolSizes.push_back({VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, config.storageBuffers});
     }
@@ -46,6 +51,9 @@ vulkan_raii::DescriptorPool DescriptorPoolManager::createDescriptorPool(const De
     VkDescriptorPoolCreateInfo poolInfo{};
     poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
     poolInfo.flags = config.allowFreeDescriptorSets ? VK_DESCRIPTOR_POOL_CREATE_FREE_DESCRIPTOR_SET_BIT : 0;
+    if (config.bindlessReady) {
+        poolInfo.flags |= VK_DESCRIPTOR_POOL_CREATE_UPDATE_AFTER_BIND_BIT_EXT;
+    }
     poolInfo.poolSizeCount = static_cast<uint32_t>(poolSizes.size());
     poolInfo.pPoolSizes = poolSizes.data();
     poolInfo.maxSets = config.maxSets;
@@ -57,4 +65,84 @@ void DescriptorPoolManager::destroyDescriptorPool(VkDescriptorPool pool) {
     if (context && pool != VK_NULL_HANDLE) {
         context->getLoader().vkDestroyDescriptorPool(context->getDevice(), pool, nullptr);
     }
+}
+
+VkDescriptorSet DescriptorPoolManager::allocateTransientSet(VkDescriptorSetLayout layout) {
+    if (!context || layout == VK_NULL_HANDLE) {
+        return VK_NULL_HANDLE;
+    }
+    
+    TransientArena& arena = transientArenas[frameIndex];
+    VkDescriptorSet set = VK_NULL_HANDLE;
+    
+    // Out of pool memory and fragmentation both mean "move on": the arena never frees, so neither recovers
+    while (arena.current < arena.pools.size()) {
+        if (allocateFromPool(arena.pools[arena.current].get(), layout, set)) {
+            return set;
+        }
+        arena.current++;
+    }
+    
+    DescriptorPoolConfig config;
+    config.maxSets = TRANSIENT_DESCRIPTOR_POOL_SETS;
+    config.uniformBuffers = TRANSIENT_DESCRIPTOR_POOL_SETS * TRANSIENT_DESCRIPTORS_PER_SET;
+    config.dynamicUniformBuffers = TRANSIENT_DESCRIPTOR_POOL_SETS * TRANSIENT_DESCRIPTORS_PER_SET;
+    config.storageBuffers = TRANSIENT_DESCRIPTOR_POOL_SETS * TRANSIENT_DESCRIPTORS_PER_SET;
+    config.sampledImages = TRANSIENT_DESCRIPTOR_POOL_SETS * TRANSIENT_DESCRIPTORS_PER_SET;
+    config.storageImages = TRANSIENT_DESCRIPTOR_POOL_SETS * TRANSIENT_DESCRIPTORS_PER_SET;
+    config.samplers = TRANSIENT_DESCRIPTOR_POOL_SETS * TRANSIENT_DESCRIPTORS_PER_SET;
+    config.allowFreeDescriptorSets = false;  // Reset wholesale, which keeps pool allocation a bump
+    
+    vulkan_raii::DescriptorPool pool = createDescriptorPool(config);
+    if (!pool) {
+        std::cerr << "DescriptorPoolManager: Failed to create transient descriptor pool" << std::endl;
+        return VK_NULL_HANDLE;
+    }
+    
+    bool allocated = allocateFromPool(pool.get(), layout, set);
+    arena.pools.push_back(std::move(pool));
+    arena.current = arena.pools.size() - 1;
+    
+    if (!allocated) {
+        std::cerr << "DescriptorPoolManager: Layout needs more descriptors than a transient pool holds" << std::endl;
+        return VK_NULL_HANDLE;
+    }
+    return set;
+}
+
+void DescriptorPoolManager::beginFrame(uint32_t frameIndex) {
+    this->frameIndex = frameIndex % MAX_FRAMES_IN_FLIGHT;
+    if (!context) return;
+    
+    TransientArena& arena = transientArenas[this->frameIndex];
+    const size_t usedPools = std::min(arena.current + 1, arena.pools.size());
+    for (size_t i = 0; i < usedPools; ++i) {
+        context->getLoader().vkResetDescriptorPool(context->getDevice(), arena.pools[i].get(), 0);
+    }
+    arena.current = 0;
+}
+
+uint32_t DescriptorPoolManager::getTransientPoolCount() const {
+    size_t count = 0;
+    for (const auto& arena : transientArenas) {
+        count += arena.pools.size();
+    }
+    return static_cast<uint32_t>(count);
+}
+
+bool DescriptorPoolManager::allocateFromPool(VkDescriptorPool pool, VkDescriptorSetLayout layout, VkDescriptorSet& set) const {
+    VkDescriptorSetAllocateInfo allocInfo{};
+    allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocInfo.descriptorPool = pool;
+    allocInfo.descriptorSetCount = 1;
+    allocInfo.pSetLayouts = &layout;
+    
+    return context->getLoader().vkAllocateDescriptorSets(context->getDevice(), &allocInfo, &set) == VK_SUCCESS;
+}
+
+void DescriptorPoolManager::releaseTransientPools() {
+    for (auto& arena : transientArenas) {
+        arena.pools.clear();
+        arena.current = 0;
+    }
 }
\ No newline at end of file
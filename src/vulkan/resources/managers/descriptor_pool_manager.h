@@ -2,6 +2,8 @@
 
 #define VK_NO_PROTOTYPES
 #include <vulkan/vulkan.h>
+#include <array>
+#include <vector>
 #include "../../core/vulkan_raii.h"
 #include "../../core/vulkan_constants.h"
 
@@ -23,19 +25,40 @@ public:
     struct DescriptorPoolConfig {
         uint32_t maxSets = DEFAULT_MAX_DESCRIPTOR_SETS;
         uint32_t uniformBuffers = DEFAULT_MAX_DESCRIPTOR_SETS;
+        uint32_t dynamicUniformBuffers = 0;
         uint32_t storageBuffers = DEFAULT_MAX_DESCRIPTOR_SETS;
         uint32_t sampledImages = DEFAULT_MAX_DESCRIPTOR_SETS;
         uint32_t storageImages = DEFAULT_COMPUTE_CACHE_SIZE;
         uint32_t samplers = DEFAULT_COMPUTE_CACHE_SIZE;
         bool allowFreeDescriptorSets = true;
-        bool bindlessReady = false; // Future-proof for bindless
+        bool bindlessReady = false; // Update-after-bind pool, required by layouts with update-after-bind bindings
     };
     
     // Descriptor pool creation/destruction
     vulkan_raii::DescriptorPool createDescriptorPool(const DescriptorPoolConfig& config);
     vulkan_raii::DescriptorPool createDescriptorPool(); // Overload with default config
     void destroyDescriptorPool(VkDescriptorPool pool);
+    
+    // Per-frame transient sets: one arena of pools per frame in flight. Allocation is a bump from the
+    // arena's current pool, chaining a new pool when it runs out; sets are never freed individually and stay
+    // valid until beginFrame() next resets their slot. VK_NULL_HANDLE only when a fresh pool cannot hold the set
+    VkDescriptorSet allocateTransientSet(VkDescriptorSetLayout layout);
+    
+    // Resets every pool frameIndex used while it was last current - call after waiting on that slot's fences
+    void beginFrame(uint32_t frameIndex);
+    
+    uint32_t getTransientPoolCount() const;
 
 private:
     const VulkanContext* context = nullptr;
+    
+    struct TransientArena {
+        std::vector<vulkan_raii::DescriptorPool> pools;  // Kept across resets; only pools[0..current] are in use
+        size_t current = 0;
+    };
+    std::array<TransientArena, MAX_FRAMES_IN_FLIGHT> transientArenas;
+    uint32_t frameIndex = 0;
+    
+    bool allocateFromPool(VkDescriptorPool pool, VkDescriptorSetLayout layout, VkDescriptorSet& set) const;
+    void releaseTransientPools();
 };
\ No newline at end of file
@@ -1,5 +1,6 @@
 #include "graphics_resource_manager.h"
 #include "../buffers/buffer_factory.h"
+#include "../core/memory_defragmenter.h"
 #include "../../core/vulkan_context.h"
 #include "../../core/vulkan_function_loader.h"
 #include "../../core/vulkan_constants.h"
@@ -40,6 +41,10 @@ void GraphicsResourceManager::cleanupBeforeContextDestruction() {
     uniformBuffers.clear();
     uniformBuffersMapped.clear();
     
+    if (memoryDefragmenter) {
+        memoryDefragmenter->unregisterBuffer(&vertexBufferHandle);
+        memoryDefragmenter->unregisterBuffer(&indexBufferHandle);
+    }
     if (vertexBufferHandle.isValid()) {
         bufferFactory->destroyResource(vertexBufferHandle);
     }
@@ -54,17 +59,14 @@ void GraphicsResourceManager::cleanupBeforeContextDestruction() {
 
 bool GraphicsResourceManager::createUniformBuffers() {
     VkDeviceSize bufferSize = sizeof(glm::mat4) * 2;
+    const uint32_t framesInFlight = context->getFramesInFlight();
     
-    uniformBufferHandles.resize(MAX_FRAMES_IN_FLIGHT);
-    uniformBuffers.resize(MAX_FRAMES_IN_FLIGHT);
-    uniformBuffersMapped.resize(MAX_FRAMES_IN_FLIGHT);
+    uniformBufferHandles.resize(framesInFlight);
+    uniformBuffers.resize(framesInFlight);
+    uniformBuffersMapped.resize(framesInFlight);
     
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
-        uniformBufferHandles[i] = bufferFactory->createMappedBuffer(
-            bufferSize, 
-            VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT,
-            VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT
-        );
+    for (size_t i = 0; i < framesInFlight; i++) {
+        uniformBufferHandles[i] = bufferFactory->createHostWriteBuffer(bufferSize, VK_BUFFER_USAGE_UNIFORM_BUFFER_BIT);
         
         if (!uniformBufferHandles[i].isValid()) {
             std::cerr << "Failed to create uniform buffer " << i << std::endl;
@@ -79,11 +81,24 @@ bool GraphicsResourceManager::createUniformBuffers() {
     return true;
 }
 
-bool GraphicsResourceManager::createTriangleBuffers() {
-    PolygonMesh triangle = PolygonFactory::createTriangle();
+bool GraphicsResourceManager::createEntityMeshBuffers() {
+    // Every entity shape in one mesh; the triangle comes first, so the single-shape draws need no offsets
+    PolygonMesh mesh = PolygonFactory::createEntityShapes(shapeRanges);
+    
+    // A move still in flight would land on the handles about to be replaced
+    if (memoryDefragmenter) {
+        memoryDefragmenter->unregisterBuffer(&vertexBufferHandle);
+        memoryDefragmenter->unregisterBuffer(&indexBufferHandle);
+    }
+    
+    // Never rewritten once uploaded, so the defragmenter may move either buffer (hence TRANSFER_SRC)
+    constexpr VkBufferUsageFlags vertexBufferUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                                                     VK_BUFFER_USAGE_VERTEX_BUFFER_BIT;
+    constexpr VkBufferUsageFlags indexBufferUsage = VK_BUFFER_USAGE_TRANSFER_SRC_BIT | VK_BUFFER_USAGE_TRANSFER_DST_BIT |
+                                                    VK_BUFFER_USAGE_INDEX_BUFFER_BIT;
     
     // Create vertex buffer
-    VkDeviceSize vertexBufferSize = sizeof(Vertex) * triangle.vertices.size();
+    VkDeviceSize vertexBufferSize = sizeof(Vertex) * mesh.vertices.size();
     
     // Create staging buffer
     ResourceHandle stagingHandle = bufferFactory->createMappedBuffer(
@@ -98,12 +113,12 @@ bool GraphicsResourceManager::createTriangleBuffers() {
     }
     
     // Copy vertex data to staging buffer
-    memcpy(stagingHandle.mappedData, triangle.vertices.data(), (size_t)vertexBufferSize);
+    memcpy(stagingHandle.mappedData, mesh.vertices.data(), (size_t)vertexBufferSize);
     
     // Create device-local vertex buffer
     vertexBufferHandle = bufferFactory->createBuffer(
         vertexBufferSize,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_VERTEX_BUFFER_BIT,
+        vertexBufferUsage,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
     );
     
@@ -120,8 +135,8 @@ bool GraphicsResourceManager::createTriangleBuffers() {
     bufferFactory->destroyResource(stagingHandle);
     
     // Create index buffer
-    indexCount = static_cast<uint32_t>(triangle.indices.size());
-    VkDeviceSize indexBufferSize = sizeof(uint16_t) * triangle.indices.size();
+    indexCount = shapeRanges[0].indexCount;
+    VkDeviceSize indexBufferSize = sizeof(uint16_t) * mesh.indices.size();
     
     // Create index staging buffer
     ResourceHandle indexStagingHandle = bufferFactory->createMappedBuffer(
@@ -136,12 +151,12 @@ bool GraphicsResourceManager::createTriangleBuffers() {
     }
     
     // Copy index data to staging buffer
-    memcpy(indexStagingHandle.mappedData, triangle.indices.data(), (size_t)indexBufferSize);
+    memcpy(indexStagingHandle.mappedData, mesh.indices.data(), (size_t)indexBufferSize);
     
     // Create device-local index buffer
     indexBufferHandle = bufferFactory->createBuffer(
         indexBufferSize,
-        VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_INDEX_BUFFER_BIT,
+        indexBufferUsage,
         VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT
     );
     
@@ -157,12 +172,18 @@ bool GraphicsResourceManager::createTriangleBuffers() {
     // Clean up staging buffer
     bufferFactory->destroyResource(indexStagingHandle);
     
+    if (memoryDefragmenter) {
+        memoryDefragmenter->registerBuffer(&vertexBufferHandle, vertexBufferUsage);
+        memoryDefragmenter->registerBuffer(&indexBufferHandle, indexBufferUsage);
+    }
+    
     return true;
 }
 
 bool GraphicsResourceManager::createGraphicsDescriptorPool(VkDescriptorSetLayout descriptorSetLayout) {
     std::vector<VkDescriptorPoolSize> poolSizes = {
         {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER, DEFAULT_MAX_DESCRIPTOR_SETS},
+        {VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC, DEFAULT_MAX_DESCRIPTOR_SETS},
         {VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, DEFAULT_MAX_DESCRIPTOR_SETS}
     };
     
@@ -187,29 +208,30 @@ bool GraphicsResourceManager::createGraphicsDescriptorSets(VkDescriptorSetLayout
     // Cache the layout for potential recreation
     cachedDescriptorLayout = descriptorSetLayout;
     
-    std::vector<VkDescriptorSetLayout> layouts(MAX_FRAMES_IN_FLIGHT, descriptorSetLayout);
+    const uint32_t framesInFlight = context->getFramesInFlight();
+    std::vector<VkDescriptorSetLayout> layouts(framesInFlight, descriptorSetLayout);
     VkDescriptorSetAllocateInfo allocInfo{};
     allocInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
     allocInfo.descriptorPool = graphicsDescriptorPool.get();
-    allocInfo.descriptorSetCount = static_cast<uint32_t>(MAX_FRAMES_IN_FLIGHT);
+    allocInfo.descriptorSetCount = framesInFlight;
     allocInfo.pSetLayouts = layouts.data();
     
-    graphicsDescriptorSets.resize(MAX_FRAMES_IN_FLIGHT);
+    graphicsDescriptorSets.resize(framesInFlight);
     if (context->getLoader().vkAllocateDescriptorSets(context->getDevice(), &allocInfo, graphicsDescriptorSets.data()) != VK_SUCCESS) {
         std::cerr << "Failed to allocate graphics descriptor sets!" << std::endl;
         return false;
     }
     
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; i++) {
+    for (size_t i = 0; i < framesInFlight; i++) {
         // UBO binding
         VkDescriptorBufferInfo bufferInfo{};
         bufferInfo.buffer = uniformBuffers[i];
         bufferInfo.offset = 0;
         bufferInfo.range = sizeof(glm::mat4) * 2;
         
-        // Use helper for uniform buffer (binding 0)
+        // Use helper for uniform buffer (binding 0, dynamic in the entity graphics layout)
         std::vector<VkDescriptorBufferInfo> bufferInfos = {bufferInfo};
-        VulkanUtils::writeDescriptorSets(context->getDevice(), context->getLoader(), graphicsDescriptorSets[i], bufferInfos, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER);
+        VulkanUtils::writeDescriptorSets(context->getDevice(), context->getLoader(), graphicsDescriptorSets[i], bufferInfos, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC);
     }
     
     return true;
@@ -260,40 +282,26 @@ bool GraphicsResourceManager::updateDescriptorSets(const std::vector<DescriptorU
         }
     }
 
-    // Build base bindings (uniform buffer binding 0)
-    std::vector<DescriptorUpdateHelper::BufferBinding> bindings;
-    
-    // Add additional bindings
-    bindings.insert(bindings.end(), additionalBindings.begin(), additionalBindings.end());
-    
-    // Update each frame's descriptor set
-    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> descriptorSetArray;
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-        descriptorSetArray[i] = graphicsDescriptorSets[i];
-    }
-    
-    // Use specialized uniform buffer update helper
-    std::array<VkBuffer, MAX_FRAMES_IN_FLIGHT> uniformBufferArray;
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-        uniformBufferArray[i] = uniformBuffers[i];
-    }
-    
-    // Update uniform buffer binding (binding 0) for all frames
-    if (!DescriptorUpdateHelper::updateUniformBufferBinding(
-            *context, descriptorSetArray, 0, uniformBufferArray, sizeof(glm::mat4) * 2)) {
-        std::cerr << "GraphicsResourceManager: Failed to update uniform buffer binding" << std::endl;
+    if (uniformBuffers.size() < graphicsDescriptorSets.size()) {
+        std::cerr << "GraphicsResourceManager: " << graphicsDescriptorSets.size() << " descriptor sets but only "
+                  << uniformBuffers.size() << " uniform buffers" << std::endl;
         return false;
     }
     
-    // Update additional bindings if provided
-    if (!additionalBindings.empty()) {
-        for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
-            if (!DescriptorUpdateHelper::updateDescriptorSet(*context, graphicsDescriptorSets[i], additionalBindings)) {
-                std::cerr << "GraphicsResourceManager: Failed to update additional bindings for frame " << i << std::endl;
-                return false;
-            }
+    // Uniform buffer binding 0 plus any additional bindings, for every frame's set in one update call
+    DescriptorWriteBatch batch;
+    for (size_t i = 0; i < graphicsDescriptorSets.size(); ++i) {
+        std::vector<DescriptorUpdateHelper::BufferBinding> bindings = {
+            {0, uniformBuffers[i], 0, sizeof(glm::mat4) * 2, VK_DESCRIPTOR_TYPE_UNIFORM_BUFFER_DYNAMIC}
+        };
+        bindings.insert(bindings.end(), additionalBindings.begin(), additionalBindings.end());
+        
+        if (!batch.add(graphicsDescriptorSets[i], bindings)) {
+            std::cerr << "GraphicsResourceManager: Failed to update bindings for frame " << i << std::endl;
+            return false;
         }
     }
+    batch.flush(*context);
     
     return true;
 }
@@ -360,7 +368,9 @@ bool GraphicsResourceManager::createAllGraphicsResources() {
     bool success = true;
     
     success &= createUniformBuffers();
-    success &= createTriangleBuffers();
+    if (needsEntityMesh()) {
+        success &= createEntityMeshBuffers();
+    }
     
     if (success) {
         clearRecreationFlag();
@@ -381,9 +391,9 @@ bool GraphicsResourceManager::recreateGraphicsResources() {
 
 // Resource state queries (from facade)
 bool GraphicsResourceManager::areResourcesCreated() const {
+    // Procedural entity geometry needs no mesh buffers
     return !uniformBufferHandles.empty() && 
-           vertexBufferHandle.isValid() && 
-           indexBufferHandle.isValid();
+           (!needsEntityMesh() || (vertexBufferHandle.isValid() && indexBufferHandle.isValid()));
 }
 
 bool GraphicsResourceManager::areDescriptorsCreated() const {
@@ -408,10 +418,10 @@ VkDeviceSize GraphicsResourceManager::getGraphicsMemoryFootprint() const {
     
     // Add vertex/index buffer sizes (approximation)
     if (vertexBufferHandle.isValid()) {
-        total += sizeof(Vertex) * 3; // Triangle vertices
+        total += vertexBufferHandle.size;
     }
     if (indexBufferHandle.isValid()) {
-        total += sizeof(uint16_t) * 3; // Triangle indices  
+        total += indexBufferHandle.size;
     }
     
     return total;
@@ -7,9 +7,12 @@
 #include "../../core/vulkan_raii.h"
 #include "../core/resource_handle.h"
 #include "../descriptors/descriptor_update_helper.h"
+#include "../../core/vulkan_constants.h"
+#include "../../../PolygonFactory.h"
 
 class VulkanContext;
 class BufferFactory;
+class MemoryDefragmenter;
 
 // Consolidated graphics pipeline resource management
 // Merged from GraphicsResourceFacade for simplified architecture
@@ -24,13 +27,16 @@ public:
     // Context access
     const VulkanContext* getContext() const { return context; }
     
+    // The entity mesh's vertex and index buffers are registered with it once uploaded; draws fetch them every frame
+    void setMemoryDefragmenter(MemoryDefragmenter* defragmenter) { memoryDefragmenter = defragmenter; }
+    
     // High-level resource operations (consolidated from facade)
     bool createAllGraphicsResources();
     bool recreateGraphicsResources();
     
     // Individual resource creation
     bool createUniformBuffers();
-    bool createTriangleBuffers();
+    bool createEntityMeshBuffers();
     bool createGraphicsDescriptorPool(VkDescriptorSetLayout descriptorSetLayout);
     bool createGraphicsDescriptorSets(VkDescriptorSetLayout descriptorSetLayout);
     
@@ -50,7 +56,9 @@ public:
     const std::vector<void*>& getUniformBuffersMapped() const { return uniformBuffersMapped; }
     VkBuffer getVertexBuffer() const { return vertexBufferHandle.buffer.get(); }
     VkBuffer getIndexBuffer() const { return indexBufferHandle.buffer.get(); }
-    uint32_t getIndexCount() const { return indexCount; }
+    uint32_t getIndexCount() const { return indexCount; }  // Shape 0 (the triangle)
+    // Per-shape ranges of the merged entity mesh, in EntityShape order
+    const std::vector<PolygonMeshRange>& getShapeRanges() const { return shapeRanges; }
     VkDescriptorPool getDescriptorPool() const { return graphicsDescriptorPool.get(); }
     const std::vector<VkDescriptorSet>& getDescriptorSets() const { return graphicsDescriptorSets; }
     
@@ -69,6 +77,7 @@ public:
 private:
     const VulkanContext* context = nullptr;
     BufferFactory* bufferFactory = nullptr;
+    MemoryDefragmenter* memoryDefragmenter = nullptr;
     
     // Graphics pipeline resources
     std::vector<ResourceHandle> uniformBufferHandles;
@@ -78,6 +87,7 @@ private:
     ResourceHandle vertexBufferHandle;
     ResourceHandle indexBufferHandle;
     uint32_t indexCount = 0;
+    std::vector<PolygonMeshRange> shapeRanges;
     
     vulkan_raii::DescriptorPool graphicsDescriptorPool;
     std::vector<VkDescriptorSet> graphicsDescriptorSets;
@@ -89,6 +99,8 @@ private:
     bool resourcesNeedRecreation = false;
     
     // Internal helpers
+    // Shape binning draws the mesh even where entity geometry would otherwise be procedural
+    static bool needsEntityMesh() { return !ENABLE_PROCEDURAL_ENTITY_GEOMETRY || ENABLE_ENTITY_SHAPE_BINNING; }
     void markForRecreation() { resourcesNeedRecreation = true; }
     void clearRecreationFlag() { resourcesNeedRecreation = false; }
 };
\ No newline at end of file
@@ -0,0 +1,60 @@
+#include "camera_latch.h"
+#include <algorithm>
+
+void CameraLatch::setPredictionLead(float seconds) {
+    predictionLead = std::clamp(seconds, 0.0f, PREDICTION_SPAN_SECONDS);
+}
+
+void CameraLatch::publish(std::span<const ViewportCamera> publishedViews, std::span<const ViewportCamera> predicted,
+                          Clock::time_point publishedSampleTime) {
+    const uint32_t count = static_cast<uint32_t>(std::min<size_t>(publishedViews.size(), MAX_RENDER_VIEWPORTS));
+    const bool complete = std::none_of(publishedViews.begin(), publishedViews.begin() + count, [](const ViewportCamera& view) {
+        return view.view == glm::mat4(0.0f) || view.projection == glm::mat4(0.0f);
+    });
+    
+    std::lock_guard<std::mutex> lock(publishMutex);
+    viewCount = complete ? count : 0;
+    hasPrediction = predicted.size() >= count;
+    std::copy_n(publishedViews.begin(), viewCount, views.begin());
+    if (hasPrediction) {
+        std::copy_n(predicted.begin(), viewCount, predictedViews.begin());
+    }
+    sampleTime = publishedSampleTime;
+}
+
+void CameraLatch::addTarget(glm::mat4* viewAndProjection) {
+    if (targetCount < targets.size()) {
+        targets[targetCount++] = viewAndProjection;
+    }
+}
+
+uint32_t CameraLatch::latch(Clock::time_point submitTime) {
+    const uint32_t frameTargets = targetCount;
+    targetCount = 0;
+    if (!latchEnabled || frameTargets == 0) {
+        return 0;
+    }
+    
+    std::lock_guard<std::mutex> lock(publishMutex);
+    if (viewCount != frameTargets) {
+        return 0;  // Viewports changed since the frame was prepared; its own matrices stand
+    }
+    
+    // Linear between the sampled and the predicted view, which is exact for pans and close for short zooms
+    float alpha = 0.0f;
+    if (isPredicting() && hasPrediction) {
+        const float aheadSeconds = std::chrono::duration<float>(submitTime - sampleTime).count() + predictionLead;
+        alpha = std::clamp(aheadSeconds / PREDICTION_SPAN_SECONDS, 0.0f, 1.0f);
+    }
+    for (uint32_t view = 0; view < frameTargets; ++view) {
+        glm::mat4* target = targets[view];
+        if (alpha > 0.0f) {
+            target[0] = views[view].view + (predictedViews[view].view - views[view].view) * alpha;
+            target[1] = views[view].projection + (predictedViews[view].projection - views[view].projection) * alpha;
+        } else {
+            target[0] = views[view].view;
+            target[1] = views[view].projection;
+        }
+    }
+    return frameTargets;
+}
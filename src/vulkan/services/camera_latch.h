@@ -0,0 +1,66 @@
+#pragma once
+
+#include "../rendering/viewport_camera.h"
+#include "../core/vulkan_constants.h"
+#include <glm/glm.hpp>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <span>
+
+// Late-latched camera matrices. The main loop publishes its newest camera views whenever it has them, and the
+// frame's view and projection UBO entries are overwritten with them immediately before the graphics submit
+// instead of keeping what was current when the frame was prepared. Under --render-thread a frame is thereby
+// submitted with the camera of the frame the main thread is already simulating. With a prediction lead each
+// view is also extrapolated from its input sample to the submit plus the lead, at most PREDICTION_SPAN_SECONDS.
+// Only matrices are latched: viewport rects and the culled set keep the camera the frame was prepared with.
+class CameraLatch {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    // How far past the input sample publish() takes its predicted views; also the cap on any extrapolation
+    static constexpr float PREDICTION_SPAN_SECONDS = 0.05f;
+    
+    CameraLatch() = default;
+    ~CameraLatch() = default;
+    
+    void setEnabled(bool enabled) { latchEnabled = enabled; }
+    bool isEnabled() const { return latchEnabled; }
+    
+    // Time past the submit the prediction aims for, up to PREDICTION_SPAN_SECONDS (0 = no prediction)
+    void setPredictionLead(float seconds);
+    float getPredictionLead() const { return predictionLead; }
+    bool isPredicting() const { return predictionLead > 0.0f; }
+    
+    // Any thread. publishedViews are the viewports in draw order, a single full-screen view without viewports;
+    // predicted is empty or the same views PREDICTION_SPAN_SECONDS after the input sample. A view without
+    // matrices (no camera) disables latching until the next publish
+    void publish(std::span<const ViewportCamera> publishedViews, std::span<const ViewportCamera> predicted,
+                 Clock::time_point publishedSampleTime);
+    
+    // Frame producer while preparing the frame: one viewport's mapped view and projection matrices, contiguous
+    // in that order. clearTargets() goes first each frame, as targets point into the frame's ring region
+    void clearTargets() { targetCount = 0; }
+    void addTarget(glm::mat4* viewAndProjection);
+    
+    // Submitting thread, immediately before the graphics vkQueueSubmit: writes the newest published views over
+    // this frame's targets when their counts match, then clears the targets. Returns the views written
+    uint32_t latch(Clock::time_point submitTime = Clock::now());
+
+private:
+    bool latchEnabled = ENABLE_CAMERA_LATE_LATCH;
+    float predictionLead = 0.0f;
+    
+    // Published by the main loop, read by latch()
+    std::mutex publishMutex;
+    std::array<ViewportCamera, MAX_RENDER_VIEWPORTS> views{};
+    std::array<ViewportCamera, MAX_RENDER_VIEWPORTS> predictedViews{};
+    uint32_t viewCount = 0;
+    bool hasPrediction = false;
+    Clock::time_point sampleTime{};
+    
+    // This frame's UBO entries, frame producer and submitting thread only
+    std::array<glm::mat4*, MAX_RENDER_VIEWPORTS> targets{};
+    uint32_t targetCount = 0;
+};
@@ -1,11 +1,17 @@
 #include "command_submission_service.h"
+#include "camera_latch.h"
+#include "output_window.h"
 #include "../core/vulkan_context.h"
 #include "../core/vulkan_sync.h"
 #include "../core/vulkan_swapchain.h"
 #include "../core/vulkan_function_loader.h"
 #include "../core/vulkan_utils.h"
 #include "../core/queue_manager.h"
-#include <iostream>
+#include "../../ecs/utilities/logger.h"
+#include "../../ecs/utilities/profiler.h"
+#include <algorithm>
+#include <array>
+#include <bit>
 
 CommandSubmissionService::CommandSubmissionService() {
 }
@@ -21,11 +27,11 @@ bool CommandSubmissionService::initialize(VulkanContext* context, VulkanSync* sy
     this->queueManager = queueManager;
     
     if (!queueManager) {
-        std::cerr << "CommandSubmissionService: QueueManager is required!" << std::endl;
+        LOG_ERROR("CommandSubmissionService: QueueManager is required!");
         return false;
     }
     
-    std::cout << "CommandSubmissionService: Initialized with QueueManager" << std::endl;
+    LOG_INFO("CommandSubmissionService: Initialized with QueueManager");
     return true;
 }
 
@@ -36,135 +42,310 @@ SubmissionResult CommandSubmissionService::submitFrame(
     uint32_t currentFrame,
     uint32_t imageIndex,
     const FrameGraph::ExecutionResult& executionResult,
-    bool framebufferResized
+    bool framebufferResized,
+    bool graphicsLagsCompute,
+    std::optional<uint64_t> computeGraphicsWaitValue
 ) {
     SubmissionResult result;
+    const bool submitCompute = executionResult.computeCommandBufferUsed;
+    const bool submitGraphics = executionResult.graphicsCommandBufferUsed;
+    const bool timeline = sync->usesTimelineSemaphores();
 
     // ASYNC COMPUTE: Submit compute and graphics work in parallel
-    // Compute calculates frame N+1 while graphics renders frame N
+    // Pipelined frames draw the snapshot compute published last frame while this frame's compute runs
     
-    // 1. Submit compute work asynchronously (no waiting for graphics)
-    if (executionResult.computeCommandBufferUsed) {
-        result = submitComputeWorkAsync(currentFrame + 1); // Compute for NEXT frame
-        if (!result.success) {
-            return result;
+    // Capture the values before this frame's submissions bump them
+    const uint64_t previousComputeValue = computeTimelineValue;
+    const uint64_t previousGraphicsValue = graphicsTimelineValue;
+    const uint64_t computeSignalValue = submitCompute && timeline ? previousComputeValue + 1 : 0;
+    const uint64_t graphicsSignalValue = submitGraphics && timeline ? previousGraphicsValue + 1 : 0;
+    
+    // 1. Compute work recorded this frame (waits only for the previous graphics frame, or the older one that
+    //    last read the snapshot it overwrites)
+    SubmitBatch computeBatch;
+    if (submitCompute) {
+        const uint32_t frameIndex = currentFrame % context->getFramesInFlight();
+        computeBatch.addCommandBuffer(executionResult.computeCommandBuffer != VK_NULL_HANDLE
+            ? executionResult.computeCommandBuffer
+            : queueManager->getComputeCommandBuffer(frameIndex));
+        computeBatch.deviceMask = context->getSimulationDeviceMask();
+        
+        // Timeline pacing: signal the next compute value instead of resetting and signaling a fence. Fence pacing
+        // has no cross-queue semaphores; pipelined async compute requires the timeline path
+        if (timeline) {
+            // Write-after-read edge: that graphics frame may still read what this compute overwrites
+            const uint64_t graphicsWaitValue = std::min(computeGraphicsWaitValue.value_or(previousGraphicsValue), previousGraphicsValue);
+            if (graphicsWaitValue > 0) {
+                computeBatch.addWait(sync->getGraphicsTimelineSemaphore(), graphicsWaitValue,
+                                     VK_PIPELINE_STAGE_2_TRANSFER_BIT_KHR | VK_PIPELINE_STAGE_2_COMPUTE_SHADER_BIT_KHR);
+            }
+            computeBatch.addSignal(sync->getComputeTimelineSemaphore(), computeSignalValue);
+            if (extraComputeSignal != VK_NULL_HANDLE) {
+                computeBatch.addSignal(extraComputeSignal, extraComputeSignalValue);
+            }
         }
     }
-
-    // 2. Submit graphics work in parallel (uses previous frame's compute results)
-    if (executionResult.graphicsCommandBufferUsed) {
-        result = submitGraphicsWork(currentFrame);
-        if (!result.success) {
+    extraComputeSignal = VK_NULL_HANDLE;
+    
+    // 2. Graphics work, in parallel with this frame's compute when it lags one frame behind. May be a recording
+    //    replayed from an earlier frame on this slot and swapchain image
+    SubmitBatch graphicsBatch;
+    if (submitGraphics) {
+        graphicsBatch.addCommandBuffer(executionResult.graphicsCommandBuffer != VK_NULL_HANDLE
+            ? executionResult.graphicsCommandBuffer
+            : queueManager->getGraphicsCommandBuffer(currentFrame));
+        graphicsBatch.deviceMask = context->getRenderDeviceMask();
+        graphicsBatch.addWait(sync->getImageAvailableSemaphore(currentFrame), 0, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR);
+        for (OutputWindow* output : outputWindows) {
+            if (output->hasImage()) {
+                graphicsBatch.addWait(output->getAcquireSemaphore(), 0, VK_PIPELINE_STAGE_2_COLOR_ATTACHMENT_OUTPUT_BIT_KHR);
+            }
+        }
+        graphicsBatch.addSignal(sync->getRenderFinishedSemaphores()[currentFrame], 0);
+        
+        // Timeline pacing: wait on exactly the compute value this frame consumes, signal the next graphics value.
+        // This frame's compute is waited on where the frame graph's compute-to-graphics sync point has live
+        // edges, at their consumer stages; otherwise graphics only needs what compute published before
+        if (timeline) {
+            const bool consumesThisCompute = !graphicsLagsCompute && submitCompute && executionResult.graphicsWaitsOnCompute;
+            const uint64_t computeWaitValue = consumesThisCompute ? computeSignalValue : previousComputeValue;
+            const VkPipelineStageFlags2KHR computeWaitStages = consumesThisCompute
+                ? executionResult.graphicsComputeWaitStages
+                : VK_PIPELINE_STAGE_2_DRAW_INDIRECT_BIT_KHR | VK_PIPELINE_STAGE_2_VERTEX_SHADER_BIT_KHR;
+            if (computeWaitValue > 0) {
+                graphicsBatch.addWait(sync->getComputeTimelineSemaphore(), computeWaitValue, computeWaitStages);
+            }
+            graphicsBatch.addSignal(sync->getGraphicsTimelineSemaphore(), graphicsSignalValue);
+        }
+    }
+    
+    // One queue for both (no dedicated compute family): a single submission, and under fence pacing a single
+    // fence. The timeline edge between the two batches stays a semaphore, as the frame graph records no
+    // compute-to-graphics barrier; a same-queue wait resolves without a cross-queue handoff
+    const bool sharedQueue = submitCompute && submitGraphics &&
+                             queueManager->getComputeQueue() == queueManager->getGraphicsQueue();
+    if (sharedQueue) {
+        SubmitBatch batches[2] = {computeBatch, graphicsBatch};
+        uint32_t batchCount = 2;
+        if (!timeline) {
+            // Nothing orders graphics after compute under fence pacing, so both fit one batch
+            batches[0] = graphicsBatch;
+            batches[0].prependCommandBuffer(computeBatch.commandBuffers[0]);
+            batchCount = 1;
+        }
+        
+        // The in-flight fence covers both; the slot's compute fence is left signaled, so waiting on it returns
+        VkFence fence = VK_NULL_HANDLE;
+        if (!timeline) {
+            fence = sync->getInFlightFence(currentFrame);
+            if (!resetFence(fence, "graphics", result)) {
+                return result;
+            }
+        }
+        
+        latchCamera();
+        VkResult submitResult = submitBatches(queueManager->getGraphicsQueue(), batches, batchCount, fence);
+        if (!VulkanUtils::checkVkResult(submitResult, "submit frame commands")) {
+            result.lastResult = submitResult;
             return result;
         }
-
-        // 3. Present frame
+        queueManager->getTelemetry().recordSubmission(CommandPoolType::Compute);
+        queueManager->getTelemetry().recordSubmission(CommandPoolType::Graphics);
+        queueManager->getTelemetry().mergedFrameSubmissions++;
+    } else {
+        if (submitCompute) {
+            VkFence computeFence = VK_NULL_HANDLE;
+            if (!timeline) {
+                computeFence = sync->getComputeFence(currentFrame % context->getFramesInFlight());
+                if (!resetFence(computeFence, "compute", result)) {
+                    return result;
+                }
+            }
+            
+            VkResult computeSubmitResult = submitBatches(queueManager->getComputeQueue(), &computeBatch, 1, computeFence);
+            if (!VulkanUtils::checkVkResult(computeSubmitResult, "submit compute commands")) {
+                result.lastResult = computeSubmitResult;
+                return result;
+            }
+            queueManager->getTelemetry().recordSubmission(CommandPoolType::Compute);
+        }
+        
+        if (submitGraphics) {
+            VkFence graphicsFence = VK_NULL_HANDLE;
+            if (!timeline) {
+                graphicsFence = sync->getInFlightFence(currentFrame);
+                if (!resetFence(graphicsFence, "graphics", result)) {
+                    return result;
+                }
+            }
+            
+            latchCamera();
+            VkResult graphicsSubmitResult = submitBatches(queueManager->getGraphicsQueue(), &graphicsBatch, 1, graphicsFence);
+            if (graphicsSubmitResult != VK_SUCCESS) {
+                LOG_ERROR("CommandSubmissionService: Failed to submit graphics commands: " << graphicsSubmitResult);
+                result.lastResult = graphicsSubmitResult;
+                return result;
+            }
+            queueManager->getTelemetry().recordSubmission(CommandPoolType::Graphics);
+        }
+    }
+    
+    if (submitCompute && timeline) {
+        computeTimelineValue = computeSignalValue;
+    }
+    if (submitGraphics && timeline) {
+        graphicsTimelineValue = graphicsSignalValue;
+    }
+    
+    // 3. Present frame
+    result.success = true;
+    if (submitGraphics) {
         result = presentFrame(currentFrame, imageIndex, framebufferResized);
     }
 
+    result.computeTimelineValue = computeSignalValue;
+    result.graphicsTimelineValue = graphicsSignalValue;
     return result;
 }
 
-SubmissionResult CommandSubmissionService::submitComputeWorkAsync(uint32_t computeFrame) {
-    SubmissionResult result;
-
-    // Use current frame index for command buffer selection (not computeFrame)
-    uint32_t frameIndex = computeFrame % MAX_FRAMES_IN_FLIGHT;
-    VkCommandBuffer computeCommandBuffer = queueManager->getComputeCommandBuffer(frameIndex);
-
-    // Reset compute fence for this frame
-    VkFence computeFence = sync->getComputeFence(frameIndex);
-    // Cache loader and device references for performance
-    const auto& vk = context->getLoader();
-    const VkDevice device = context->getDevice();
-    
-    VkResult resetResult = vk.vkResetFences(device, 1, &computeFence);
-    if (resetResult != VK_SUCCESS) {
-        std::cerr << "CommandSubmissionService: Failed to reset compute fence: " << resetResult << std::endl;
-        result.lastResult = resetResult;
-        return result;
+void CommandSubmissionService::latchCamera() {
+    // Host writes to the coherent frame ring are visible to every submission made after them
+    if (cameraLatch) {
+        cameraLatch->latch();
     }
+}
 
-    // Submit compute work using VulkanUtils
-    // ASYNC COMPUTE: No semaphore signaling needed since compute works on frame N+1
-    // Graphics reads from frame N-1 buffer, so no synchronization required
-    std::vector<VkCommandBuffer> computeCmdBuffers = {computeCommandBuffer};
-    
-    VkResult computeSubmitResult = VulkanUtils::submitCommands(
-        queueManager->getComputeQueue(),
-        vk,
-        computeCmdBuffers,
-        {}, // no wait semaphores
-        {}, // no wait stages
-        {}, // no signal semaphores
-        computeFence
-    );
-
-    if (!VulkanUtils::checkVkResult(computeSubmitResult, "submit compute commands")) {
-        result.lastResult = computeSubmitResult;
-        return result;
-    }
-    
-    // Record telemetry for successful compute submission
-    queueManager->getTelemetry().recordSubmission(CommandPoolType::Compute);
-    
-    result.success = true;
-    return result;
+void CommandSubmissionService::SubmitBatch::addCommandBuffer(VkCommandBuffer commandBuffer) {
+    commandBuffers[commandBufferCount++] = commandBuffer;
 }
 
-SubmissionResult CommandSubmissionService::submitGraphicsWork(uint32_t currentFrame) {
-    SubmissionResult result;
+void CommandSubmissionService::SubmitBatch::prependCommandBuffer(VkCommandBuffer commandBuffer) {
+    for (uint32_t i = commandBufferCount; i > 0; --i) {
+        commandBuffers[i] = commandBuffers[i - 1];
+    }
+    commandBuffers[0] = commandBuffer;
+    ++commandBufferCount;
+}
 
-    // Cache loader and device references for performance
-    const auto& vk = context->getLoader();
-    const VkDevice device = context->getDevice();
+void CommandSubmissionService::SubmitBatch::addWait(VkSemaphore semaphore, uint64_t value, VkPipelineStageFlags2KHR stages) {
+    waitSemaphores[waitCount] = semaphore;
+    waitValues[waitCount] = value;
+    waitStages[waitCount] = stages;
+    ++waitCount;
+}
 
-    VkCommandBuffer graphicsCommandBuffer = queueManager->getGraphicsCommandBuffer(currentFrame);
+void CommandSubmissionService::SubmitBatch::addSignal(VkSemaphore semaphore, uint64_t value) {
+    signalSemaphores[signalCount] = semaphore;
+    signalValues[signalCount] = value;
+    ++signalCount;
+}
 
-    // Reset graphics fence
-    VkFence graphicsFence = sync->getInFlightFence(currentFrame);
-    VkResult resetResult = vk.vkResetFences(device, 1, &graphicsFence);
+bool CommandSubmissionService::resetFence(VkFence fence, const char* queueName, SubmissionResult& result) {
+    VkResult resetResult = context->getLoader().vkResetFences(context->getDevice(), 1, &fence);
     if (resetResult != VK_SUCCESS) {
-        std::cerr << "CommandSubmissionService: Failed to reset graphics fence: " << resetResult << std::endl;
+        LOG_ERROR("CommandSubmissionService: Failed to reset " << queueName << " fence: " << resetResult);
         result.lastResult = resetResult;
-        return result;
+        return false;
     }
+    return true;
+}
 
-    // Setup graphics submission - async compute model (no compute sync needed)
-    VkSubmitInfo graphicsSubmitInfo{};
-    graphicsSubmitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
-
-    // Only wait for swapchain image availability (async compute works on different buffer)
-    VkSemaphore waitSemaphores[] = {sync->getImageAvailableSemaphore(currentFrame)};
-    VkPipelineStageFlags waitStages[] = {VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT};
-    graphicsSubmitInfo.waitSemaphoreCount = 1;
-    graphicsSubmitInfo.pWaitSemaphores = waitSemaphores;
-    graphicsSubmitInfo.pWaitDstStageMask = waitStages;
-    graphicsSubmitInfo.commandBufferCount = 1;
-    graphicsSubmitInfo.pCommandBuffers = &graphicsCommandBuffer;
-
-    VkSemaphore signalSemaphores[] = {sync->getRenderFinishedSemaphores()[currentFrame]};
-    graphicsSubmitInfo.signalSemaphoreCount = 1;
-    graphicsSubmitInfo.pSignalSemaphores = signalSemaphores;
-
-    VkResult graphicsSubmitResult = vk.vkQueueSubmit(
-        queueManager->getGraphicsQueue(), 
-        1, 
-        &graphicsSubmitInfo, 
-        graphicsFence
-    );
-
-    if (graphicsSubmitResult != VK_SUCCESS) {
-        std::cerr << "CommandSubmissionService: Failed to submit graphics commands: " << graphicsSubmitResult << std::endl;
-        result.lastResult = graphicsSubmitResult;
-        return result;
+VkResult CommandSubmissionService::submitBatches(VkQueue queue, const SubmitBatch* batches, uint32_t batchCount, VkFence fence) {
+    PROFILE_SCOPE("Queue Submit");
+    const auto& vk = context->getLoader();
+    
+    // Binary semaphore entries ignore their values in both forms
+    if (context->supportsSynchronization2() && vk.vkQueueSubmit2KHR) {
+        std::array<VkSubmitInfo2KHR, MAX_FRAME_BATCHES> submits{};
+        std::array<std::array<VkSemaphoreSubmitInfoKHR, SubmitBatch::MAX_SEMAPHORES>, MAX_FRAME_BATCHES> waits{};
+        std::array<std::array<VkSemaphoreSubmitInfoKHR, SubmitBatch::MAX_SEMAPHORES>, MAX_FRAME_BATCHES> signals{};
+        std::array<std::array<VkCommandBufferSubmitInfoKHR, SubmitBatch::MAX_COMMAND_BUFFERS>, MAX_FRAME_BATCHES> commandBuffers{};
+        
+        for (uint32_t b = 0; b < batchCount; ++b) {
+            const SubmitBatch& batch = batches[b];
+            const uint32_t deviceIndex = batch.deviceMask ? static_cast<uint32_t>(std::countr_zero(batch.deviceMask)) : 0;
+            for (uint32_t i = 0; i < batch.waitCount; ++i) {
+                waits[b][i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR;
+                waits[b][i].semaphore = batch.waitSemaphores[i];
+                waits[b][i].value = batch.waitValues[i];
+                waits[b][i].stageMask = batch.waitStages[i];
+                waits[b][i].deviceIndex = deviceIndex;
+            }
+            for (uint32_t i = 0; i < batch.signalCount; ++i) {
+                signals[b][i].sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR;
+                signals[b][i].semaphore = batch.signalSemaphores[i];
+                signals[b][i].value = batch.signalValues[i];
+                signals[b][i].stageMask = VK_PIPELINE_STAGE_2_ALL_COMMANDS_BIT_KHR;
+                signals[b][i].deviceIndex = deviceIndex;
+            }
+            for (uint32_t i = 0; i < batch.commandBufferCount; ++i) {
+                commandBuffers[b][i].sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO_KHR;
+                commandBuffers[b][i].commandBuffer = batch.commandBuffers[i];
+                commandBuffers[b][i].deviceMask = batch.deviceMask;
+            }
+            
+            submits[b].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR;
+            submits[b].waitSemaphoreInfoCount = batch.waitCount;
+            submits[b].pWaitSemaphoreInfos = waits[b].data();
+            submits[b].commandBufferInfoCount = batch.commandBufferCount;
+            submits[b].pCommandBufferInfos = commandBuffers[b].data();
+            submits[b].signalSemaphoreInfoCount = batch.signalCount;
+            submits[b].pSignalSemaphoreInfos = signals[b].data();
+        }
+        return vk.vkQueueSubmit2KHR(queue, batchCount, submits.data(), fence);
     }
     
-    // Record telemetry for successful graphics submission
-    queueManager->getTelemetry().recordSubmission(CommandPoolType::Graphics);
+    // Legacy form: the synchronization2 stage bits used here have the same values as their VkPipelineStageFlags
+    std::array<VkSubmitInfo, MAX_FRAME_BATCHES> submits{};
+    std::array<VkTimelineSemaphoreSubmitInfoKHR, MAX_FRAME_BATCHES> timelineInfos{};
+    std::array<VkDeviceGroupSubmitInfoKHR, MAX_FRAME_BATCHES> deviceGroupInfos{};
+    std::array<std::array<VkPipelineStageFlags, SubmitBatch::MAX_SEMAPHORES>, MAX_FRAME_BATCHES> waitStages{};
+    std::array<std::array<uint32_t, SubmitBatch::MAX_SEMAPHORES>, MAX_FRAME_BATCHES> waitDeviceIndices{};
+    std::array<std::array<uint32_t, SubmitBatch::MAX_SEMAPHORES>, MAX_FRAME_BATCHES> signalDeviceIndices{};
+    std::array<std::array<uint32_t, SubmitBatch::MAX_COMMAND_BUFFERS>, MAX_FRAME_BATCHES> commandBufferMasks{};
+    const bool timeline = sync->usesTimelineSemaphores();
     
-    result.success = true;
-    return result;
+    for (uint32_t b = 0; b < batchCount; ++b) {
+        const SubmitBatch& batch = batches[b];
+        for (uint32_t i = 0; i < batch.waitCount; ++i) {
+            waitStages[b][i] = static_cast<VkPipelineStageFlags>(batch.waitStages[i]);
+        }
+        
+        submits[b].sType = VK_STRUCTURE_TYPE_SUBMIT_INFO;
+        submits[b].waitSemaphoreCount = batch.waitCount;
+        submits[b].pWaitSemaphores = batch.waitSemaphores.data();
+        submits[b].pWaitDstStageMask = waitStages[b].data();
+        submits[b].commandBufferCount = batch.commandBufferCount;
+        submits[b].pCommandBuffers = batch.commandBuffers.data();
+        submits[b].signalSemaphoreCount = batch.signalCount;
+        submits[b].pSignalSemaphores = batch.signalSemaphores.data();
+        
+        if (timeline) {
+            timelineInfos[b].sType = VK_STRUCTURE_TYPE_TIMELINE_SEMAPHORE_SUBMIT_INFO_KHR;
+            timelineInfos[b].waitSemaphoreValueCount = batch.waitCount;
+            timelineInfos[b].pWaitSemaphoreValues = batch.waitValues.data();
+            timelineInfos[b].signalSemaphoreValueCount = batch.signalCount;
+            timelineInfos[b].pSignalSemaphoreValues = batch.signalValues.data();
+            submits[b].pNext = &timelineInfos[b];
+        }
+        
+        if (batch.deviceMask != 0) {
+            const uint32_t deviceIndex = static_cast<uint32_t>(std::countr_zero(batch.deviceMask));
+            waitDeviceIndices[b].fill(deviceIndex);
+            signalDeviceIndices[b].fill(deviceIndex);
+            commandBufferMasks[b].fill(batch.deviceMask);
+            deviceGroupInfos[b].sType = VK_STRUCTURE_TYPE_DEVICE_GROUP_SUBMIT_INFO_KHR;
+            deviceGroupInfos[b].waitSemaphoreCount = batch.waitCount;
+            deviceGroupInfos[b].pWaitSemaphoreDeviceIndices = waitDeviceIndices[b].data();
+            deviceGroupInfos[b].commandBufferCount = batch.commandBufferCount;
+            deviceGroupInfos[b].pCommandBufferDeviceMasks = commandBufferMasks[b].data();
+            deviceGroupInfos[b].signalSemaphoreCount = batch.signalCount;
+            deviceGroupInfos[b].pSignalSemaphoreDeviceIndices = signalDeviceIndices[b].data();
+            deviceGroupInfos[b].pNext = submits[b].pNext;
+            submits[b].pNext = &deviceGroupInfos[b];
+        }
+    }
+    return vk.vkQueueSubmit(queue, batchCount, submits.data(), fence);
 }
 
 SubmissionResult CommandSubmissionService::presentFrame(uint32_t currentFrame, uint32_t imageIndex, bool framebufferResized) {
@@ -180,18 +361,73 @@ SubmissionResult CommandSubmissionService::presentFrame(uint32_t currentFrame, u
     VkSemaphore signalSemaphores[] = {sync->getRenderFinishedSemaphores()[currentFrame]};
     presentInfo.pWaitSemaphores = signalSemaphores;
 
-    VkSwapchainKHR swapChains[] = {swapchain->getSwapchain()};
-    presentInfo.swapchainCount = 1;
-    presentInfo.pSwapchains = swapChains;
-    presentInfo.pImageIndices = &imageIndex;
+    // The main window first, then each output window drawn this frame; all were rendered by the one submission
+    std::array<VkSwapchainKHR, 1 + MAX_OUTPUT_WINDOWS> swapChains{swapchain->getSwapchain()};
+    std::array<uint32_t, 1 + MAX_OUTPUT_WINDOWS> imageIndices{imageIndex};
+    std::array<OutputWindow*, 1 + MAX_OUTPUT_WINDOWS> presentedOutputs{};
+    uint32_t swapchainCount = 1;
+    for (OutputWindow* output : outputWindows) {
+        if (output->hasImage() && swapchainCount < swapChains.size()) {
+            presentedOutputs[swapchainCount] = output;
+            imageIndices[swapchainCount] = output->getImageIndex();
+            swapChains[swapchainCount++] = output->getSwapchain()->getSwapchain();
+        }
+    }
+    std::array<VkResult, 1 + MAX_OUTPUT_WINDOWS> presentResults{};
+    presentInfo.swapchainCount = swapchainCount;
+    presentInfo.pSwapchains = swapChains.data();
+    presentInfo.pImageIndices = imageIndices.data();
+    presentInfo.pResults = swapchainCount > 1 ? presentResults.data() : nullptr;
+    
+    // Tag the present so FramePacer can wait for it to reach the screen, and PresentTimingMonitor find its
+    // display time. Output windows present untagged (ID 0)
+    VkPresentIdKHR presentId{};
+    VkPresentTimesInfoGOOGLE presentTimes{};
+    std::array<VkPresentTimeGOOGLE, 1 + MAX_OUTPUT_WINDOWS> presentTime{};
+    std::array<uint64_t, 1 + MAX_OUTPUT_WINDOWS> presentIdValues{};
+    uint64_t presentIdValue = 0;
+    if (swapchain->supportsPresentWait() || swapchain->supportsDisplayTiming()) {
+        presentIdValue = swapchain->nextPresentId();
+        presentIdValues[0] = presentIdValue;
+    }
+    if (swapchain->supportsPresentWait()) {
+        presentId.sType = VK_STRUCTURE_TYPE_PRESENT_ID_KHR;
+        presentId.swapchainCount = swapchainCount;
+        presentId.pPresentIds = presentIdValues.data();
+        presentId.pNext = presentInfo.pNext;
+        presentInfo.pNext = &presentId;
+    }
+    if (swapchain->supportsDisplayTiming()) {
+        presentTime[0].presentID = static_cast<uint32_t>(presentIdValue);
+        presentTime[0].desiredPresentTime = 0;  // As soon as possible, timing is only read back
+        presentTimes.sType = VK_STRUCTURE_TYPE_PRESENT_TIMES_INFO_GOOGLE;
+        presentTimes.swapchainCount = swapchainCount;
+        presentTimes.pTimes = presentTime.data();
+        presentTimes.pNext = presentInfo.pNext;
+        presentInfo.pNext = &presentTimes;
+    }
 
-    VkResult presentResult = vk.vkQueuePresentKHR(queueManager->getPresentQueue(), &presentInfo);
+    VkResult presentResult;
+    {
+        PROFILE_SCOPE("Queue Present");
+        presentResult = vk.vkQueuePresentKHR(queueManager->getPresentQueue(), &presentInfo);
+    }
+    
+    // With output windows the call returns the worst of all results; the main window goes by its own
+    if (swapchainCount > 1) {
+        for (uint32_t i = 1; i < swapchainCount; ++i) {
+            presentedOutputs[i]->presented(presentResults[i]);
+        }
+        if (presentResult != VK_ERROR_DEVICE_LOST) {
+            presentResult = presentResults[0];
+        }
+    }
     
     if (presentResult == VK_ERROR_OUT_OF_DATE_KHR || presentResult == VK_SUBOPTIMAL_KHR || framebufferResized) {
         result.swapchainRecreationNeeded = true;
         result.success = true; // Still successful, just needs recreation
     } else if (presentResult != VK_SUCCESS) {
-        std::cerr << "CommandSubmissionService: Failed to present swap chain image: " << presentResult << std::endl;
+        LOG_ERROR("CommandSubmissionService: Failed to present swap chain image: " << presentResult);
         result.lastResult = presentResult;
         return result;
     } else {
@@ -199,5 +435,7 @@ SubmissionResult CommandSubmissionService::presentFrame(uint32_t currentFrame, u
     }
 
     result.lastResult = presentResult;
+    const bool queued = presentResult == VK_SUCCESS || presentResult == VK_SUBOPTIMAL_KHR;
+    result.presentId = queued ? presentIdValue : 0;
     return result;
 }
\ No newline at end of file
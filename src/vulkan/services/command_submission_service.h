@@ -3,17 +3,29 @@
 #include <vulkan/vulkan.h>
 #include "../core/vulkan_constants.h"
 #include "../rendering/frame_graph.h"
+#include <array>
+#include <optional>
+#include <vector>
 
 // Forward declarations
 class VulkanContext;
 class VulkanSync;
 class VulkanSwapchain;
 class QueueManager;
+class CameraLatch;
+class OutputWindow;
 
 struct SubmissionResult {
     bool success = false;
     bool swapchainRecreationNeeded = false;
     VkResult lastResult = VK_SUCCESS;
+    
+    // Timeline values signaled by this frame's submissions (0 = not submitted or fence pacing)
+    uint64_t computeTimelineValue = 0;
+    uint64_t graphicsTimelineValue = 0;
+    
+    // ID the frame was presented with (0 = not presented, or neither present wait nor display timing available)
+    uint64_t presentId = 0;
 };
 
 class CommandSubmissionService {
@@ -23,13 +35,29 @@ public:
 
     bool initialize(VulkanContext* context, VulkanSync* sync, VulkanSwapchain* swapchain, QueueManager* queueManager);
     void cleanup();
+    
+    // Late latch written immediately before each graphics submission (not owned, nullptr for none)
+    void setCameraLatch(CameraLatch* latch) { cameraLatch = latch; }
+    
+    // Display wall windows (not owned): graphics waits on the acquire of each that holds an image, and those
+    // images are presented in the main window's vkQueuePresentKHR
+    void setOutputWindows(const std::vector<OutputWindow*>& windows) { outputWindows = windows; }
+    
+    // One extra timeline value the next submitFrame's compute batch signals (timeline pacing only), such as the
+    // exported position semaphore; dropped when that frame submits no compute
+    void addComputeSignal(VkSemaphore semaphore, uint64_t value) { extraComputeSignal = semaphore; extraComputeSignalValue = value; }
 
-    // Main submission methods
+    // Main submission methods. With timeline pacing compute waits for the previous graphics frame (it rewrites
+    // what that frame read) unless computeGraphicsWaitValue names an older graphics value to wait for instead;
+    // graphicsLagsCompute lets graphics wait on the previous compute frame instead of this one (pipelined async
+    // compute, see GPUEntityManager::isGraphicsLaggingCompute and getSnapshotWriteAfterReadValue)
     SubmissionResult submitFrame(
         uint32_t currentFrame,
         uint32_t imageIndex,
         const FrameGraph::ExecutionResult& executionResult,
-        bool framebufferResized
+        bool framebufferResized,
+        bool graphicsLagsCompute = false,
+        std::optional<uint64_t> computeGraphicsWaitValue = std::nullopt
     );
 
 private:
@@ -38,13 +66,43 @@ private:
     VulkanSync* sync = nullptr;
     VulkanSwapchain* swapchain = nullptr;
     QueueManager* queueManager = nullptr;
+    CameraLatch* cameraLatch = nullptr;
+    std::vector<OutputWindow*> outputWindows;
+    VkSemaphore extraComputeSignal = VK_NULL_HANDLE;
+    uint64_t extraComputeSignalValue = 0;
+    
+    // Last values signaled on the per-queue timelines (timeline frame pacing only)
+    uint64_t computeTimelineValue = 0;
+    uint64_t graphicsTimelineValue = 0;
+
+    // Compute and graphics batches of one frame; with a single queue for both they go out in one call
+    static constexpr uint32_t MAX_FRAME_BATCHES = 2;
+    
+    // One VkSubmitInfo2 worth of work, lowered to VkSubmitInfo without synchronization2
+    struct SubmitBatch {
+        static constexpr uint32_t MAX_COMMAND_BUFFERS = 2;
+        static constexpr uint32_t MAX_SEMAPHORES = 2 + MAX_OUTPUT_WINDOWS;  // Graphics: image, compute and output acquires
+        
+        std::array<VkCommandBuffer, MAX_COMMAND_BUFFERS> commandBuffers{};
+        uint32_t commandBufferCount = 0;
+        std::array<VkSemaphore, MAX_SEMAPHORES> waitSemaphores{};
+        std::array<uint64_t, MAX_SEMAPHORES> waitValues{};          // Timeline semaphores only
+        std::array<VkPipelineStageFlags2KHR, MAX_SEMAPHORES> waitStages{};
+        uint32_t waitCount = 0;
+        std::array<VkSemaphore, MAX_SEMAPHORES> signalSemaphores{};
+        std::array<uint64_t, MAX_SEMAPHORES> signalValues{};
+        uint32_t signalCount = 0;
+        uint32_t deviceMask = 0;    // One GPU of a device group (VulkanContext masks), 0 for the default
+        
+        void addCommandBuffer(VkCommandBuffer commandBuffer);
+        void prependCommandBuffer(VkCommandBuffer commandBuffer);
+        void addWait(VkSemaphore semaphore, uint64_t value, VkPipelineStageFlags2KHR stages);
+        void addSignal(VkSemaphore semaphore, uint64_t value);
+    };
 
     // Helper methods
-    SubmissionResult submitComputeWorkAsync(uint32_t computeFrame);
-    SubmissionResult submitGraphicsWork(uint32_t currentFrame);
     SubmissionResult presentFrame(uint32_t currentFrame, uint32_t imageIndex, bool framebufferResized);
-
-    // Fence management helpers
-    bool resetAndSubmitCompute(uint32_t currentFrame, VkFence fence, VkCommandBuffer commandBuffer);
-    bool resetAndSubmitGraphics(uint32_t currentFrame, VkFence fence, VkCommandBuffer commandBuffer);
+    bool resetFence(VkFence fence, const char* queueName, SubmissionResult& result);
+    void latchCamera();
+    VkResult submitBatches(VkQueue queue, const SubmitBatch* batches, uint32_t batchCount, VkFence fence);
 };
\ No newline at end of file
@@ -2,7 +2,7 @@
 #include "../core/vulkan_swapchain.h"
 #include "presentation_surface.h"
 #include "render_frame_director.h"
-#include <iostream>
+#include "../../ecs/utilities/logger.h"
 
 void ErrorRecoveryService::initialize(PresentationSurface* presentationSurface) {
     this->presentationSurface = presentationSurface;
@@ -21,22 +21,28 @@ bool ErrorRecoveryService::handleFrameFailure(const RenderFrameResult& frameResu
                                              flecs::world* world,
                                              RenderFrameResult& retryResult) {
     
-    std::cerr << "ErrorRecoveryService: Frame " << frameCounter << " FAILED in frameDirector->directFrame()" << std::endl;
+    LOG_ERROR("ErrorRecoveryService: Frame " << frameCounter << " FAILED in frameDirector->directFrame()");
+    
+    // Nothing created on a lost device can be recreated or retried; VulkanRenderer rebuilds the device between frames
+    if (frameResult.acquireResult == VK_ERROR_DEVICE_LOST) {
+        LOG_ERROR("ErrorRecoveryService: Device lost, leaving recovery to VulkanRenderer::recoverFromDeviceLoss");
+        return false;
+    }
     
     if (!shouldAttemptSwapchainRecreation()) {
-        std::cerr << "ErrorRecoveryService: Frame failure not suitable for swapchain recreation" << std::endl;
+        LOG_ERROR("ErrorRecoveryService: Frame failure not suitable for swapchain recreation");
         return false;
     }
 
     const char* recreationReason = determineRecreationReason();
-    std::cout << "ErrorRecoveryService: Initiating proactive swapchain recreation due to: " << recreationReason << std::endl;
+    LOG_INFO("ErrorRecoveryService: Initiating proactive swapchain recreation due to: " << recreationReason);
     
     if (!attemptSwapchainRecreation()) {
-        std::cerr << "ErrorRecoveryService: Swapchain recreation failed" << std::endl;
+        LOG_ERROR("ErrorRecoveryService: Swapchain recreation failed");
         return false;
     }
 
-    std::cout << "ErrorRecoveryService: Swapchain recreation successful, retrying frame" << std::endl;
+    LOG_INFO("ErrorRecoveryService: Swapchain recreation successful, retrying frame");
     
     return retryFrameAfterRecreation(frameDirector, currentFrame, totalTime, deltaTime, frameCounter, world, retryResult);
 }
@@ -76,17 +82,17 @@ bool ErrorRecoveryService::retryFrameAfterRecreation(RenderFrameDirector* frameD
                                                     RenderFrameResult& retryResult) {
     
     if (!frameDirector) {
-        std::cerr << "ErrorRecoveryService: Frame director unavailable for retry" << std::endl;
+        LOG_ERROR("ErrorRecoveryService: Frame director unavailable for retry");
         return false;
     }
 
     retryResult = frameDirector->directFrame(currentFrame, totalTime, deltaTime, frameCounter, world);
     
     if (retryResult.success) {
-        std::cout << "ErrorRecoveryService: Frame retry after swapchain recreation succeeded" << std::endl;
+        LOG_INFO("ErrorRecoveryService: Frame retry after swapchain recreation succeeded");
         return true;
     } else {
-        std::cerr << "ErrorRecoveryService: Frame retry after swapchain recreation still failed" << std::endl;
+        LOG_ERROR("ErrorRecoveryService: Frame retry after swapchain recreation still failed");
         return false;
     }
 }
\ No newline at end of file
@@ -0,0 +1,90 @@
+#include "frame_pacer.h"
+#include "present_timing_monitor.h"
+#include "../core/vulkan_swapchain.h"
+#include "../core/vulkan_constants.h"
+#include <SDL3/SDL.h>
+#include <algorithm>
+#include <cmath>
+#include <thread>
+
+void FramePacer::setTargetFrameRate(uint32_t framesPerSecond) {
+    targetFrameRate = framesPerSecond;
+    period = framesPerSecond > 0
+        ? std::chrono::duration_cast<Clock::duration>(std::chrono::duration<double>(1.0 / framesPerSecond))
+        : Clock::duration::zero();
+    started = false;
+}
+
+void FramePacer::waitForNextFrame() {
+    if (isUncapped()) {
+        recordInterval(Clock::now());
+        return;
+    }
+    
+    waitForPreviousPresent();
+    
+    Clock::time_point now = Clock::now();
+    if (!started) {
+        nextDeadline = now + period;
+        started = true;
+    } else {
+        nextDeadline += period;
+        
+        // A frame that overran by more than a period restarts the schedule instead of bursting to catch up
+        if (now > nextDeadline + period) {
+            telemetry.missedDeadlines++;
+            nextDeadline = now;
+        }
+    }
+    
+    sleepUntil(nextDeadline);
+    recordInterval(Clock::now());
+}
+
+double FramePacer::Telemetry::getIntervalJitterMs() const {
+    if (frames < 2) return 0.0;
+    const double mean = totalIntervalMs / frames;
+    return std::sqrt(std::max(0.0, totalSquaredIntervalMs / frames - mean * mean));
+}
+
+void FramePacer::waitForPreviousPresent() {
+    if (!swapchain || !swapchain->supportsPresentWait()) return;
+    
+    const uint64_t lastPresentId = swapchain->getLastPresentId();
+    if (lastPresentId < 2) return;
+    
+    const uint64_t presentId = lastPresentId - 1;
+    const Clock::time_point waitStart = Clock::now();
+    telemetry.presentWaits++;
+    if (!swapchain->waitForPresent(presentId, PRESENT_WAIT_TIMEOUT_NS)) {
+        telemetry.presentWaitTimeouts++;
+    } else if (presentTiming && presentId >= swapchain->getFirstSwapchainPresentId()) {
+        presentTiming->markPresented(presentId, waitStart, Clock::now());
+    }
+}
+
+void FramePacer::sleepUntil(Clock::time_point deadline) const {
+    const auto spinWindow = std::chrono::microseconds(FRAME_PACING_SPIN_MICROSECONDS);
+    
+    Clock::time_point now = Clock::now();
+    if (deadline - now > spinWindow) {
+        const auto sleepFor = std::chrono::duration_cast<std::chrono::nanoseconds>(deadline - now - spinWindow);
+        SDL_DelayNS(static_cast<Uint64>(sleepFor.count()));
+    }
+    
+    // The sleep may wake anywhere inside the window; the rest is spent yielding
+    while (Clock::now() < deadline) {
+        std::this_thread::yield();
+    }
+}
+
+void FramePacer::recordInterval(Clock::time_point now) {
+    if (lastFrameEnd != Clock::time_point{}) {
+        const double intervalMs = std::chrono::duration<double, std::milli>(now - lastFrameEnd).count();
+        telemetry.frames++;
+        telemetry.totalIntervalMs += intervalMs;
+        telemetry.totalSquaredIntervalMs += intervalMs * intervalMs;
+        telemetry.maxIntervalMs = std::max(telemetry.maxIntervalMs, intervalMs);
+    }
+    lastFrameEnd = now;
+}
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+class VulkanSwapchain;
+class PresentTimingMonitor;
+
+// Main loop frame rate limiting. With a target rate each frame ends at a fixed deadline (the previous one plus
+// one period, resynchronised after a missed frame): the pacer sleeps until FRAME_PACING_SPIN_MICROSECONDS before
+// it and yields in a loop for the rest, so pacing is not bound to the OS sleep granularity. When the swapchain
+// supports present wait it first waits for the previous present to reach the screen, keeping at most one
+// frame queued ahead of the display. Uncapped (rate 0) never blocks.
+class FramePacer {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    FramePacer() = default;
+    ~FramePacer() = default;
+    
+    void setTargetFrameRate(uint32_t framesPerSecond);
+    uint32_t getTargetFrameRate() const { return targetFrameRate; }
+    bool isUncapped() const { return targetFrameRate == 0; }
+    
+    // Optional; without it (or without VK_KHR_present_wait) pacing relies on CPU timing alone
+    void setSwapchain(const VulkanSwapchain* swapchain) { this->swapchain = swapchain; }
+    
+    // Optional; told about every present wait that succeeded, which may be the exact time it reached the screen
+    void setPresentTimingMonitor(PresentTimingMonitor* monitor) { presentTiming = monitor; }
+    
+    // Blocks until the next frame may start - call once per frame, after its present
+    void waitForNextFrame();
+    
+    // Frame-to-frame intervals as seen by the loop, since the last resetTelemetry()
+    struct Telemetry {
+        uint64_t frames = 0;
+        double totalIntervalMs = 0.0;
+        double totalSquaredIntervalMs = 0.0;
+        double maxIntervalMs = 0.0;
+        uint64_t missedDeadlines = 0;      // Frames that ended more than a period late
+        uint64_t presentWaits = 0;
+        uint64_t presentWaitTimeouts = 0;
+        
+        double getAverageIntervalMs() const { return frames > 0 ? totalIntervalMs / frames : 0.0; }
+        double getIntervalJitterMs() const;  // Standard deviation
+    };
+    const Telemetry& getTelemetry() const { return telemetry; }
+    void resetTelemetry() { telemetry = {}; }
+
+private:
+    void waitForPreviousPresent();
+    void sleepUntil(Clock::time_point deadline) const;
+    void recordInterval(Clock::time_point now);
+    
+    const VulkanSwapchain* swapchain = nullptr;
+    PresentTimingMonitor* presentTiming = nullptr;
+    uint32_t targetFrameRate = 0;
+    Clock::duration period{};
+    
+    Clock::time_point nextDeadline{};
+    Clock::time_point lastFrameEnd{};
+    bool started = false;
+    
+    Telemetry telemetry;
+};
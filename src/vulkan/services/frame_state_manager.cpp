@@ -1,15 +1,24 @@
 #include "frame_state_manager.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
 #include "../core/vulkan_sync.h"
+#include "../../ecs/utilities/logger.h"
+#include <algorithm>
 
 FrameStateManager::FrameStateManager() {
-    frameStates.resize(MAX_FRAMES_IN_FLIGHT);
 }
 
-void FrameStateManager::initialize() {
+void FrameStateManager::initialize(uint32_t framesInFlight) {
+    frameStates.assign(framesInFlight, FrameState{});
+    pacingTelemetry = PacingTelemetry{};
+    gpuDrained = false;
+    
     // Reset all frame states
     for (auto& state : frameStates) {
         state.computeUsed = true;  // Initialize to true for safety on first frame
         state.graphicsUsed = true;
+        state.computeTimelineValue = 0;
+        state.graphicsTimelineValue = 0;
     }
 }
 
@@ -62,3 +71,108 @@ bool FrameStateManager::hasActiveFences(uint32_t frameIndex) const {
     const auto& slotState = frameStates[frameIndex];
     return slotState.computeUsed || slotState.graphicsUsed;
 }
+
+void FrameStateManager::setComputeTimelineValue(uint32_t frameIndex, uint64_t value) {
+    if (frameIndex >= frameStates.size()) return;
+    frameStates[frameIndex].computeTimelineValue = value;
+}
+
+void FrameStateManager::setGraphicsTimelineValue(uint32_t frameIndex, uint64_t value) {
+    if (frameIndex >= frameStates.size()) return;
+    frameStates[frameIndex].graphicsTimelineValue = value;
+}
+
+void FrameStateManager::getTimelineValuesToWait(uint32_t frameIndex, VulkanSync* sync,
+                                                std::vector<VkSemaphore>& semaphores, std::vector<uint64_t>& values) const {
+    semaphores.clear();
+    values.clear();
+    if (frameIndex >= frameStates.size() || !sync || !sync->usesTimelineSemaphores()) {
+        return;
+    }
+
+    // Timelines never need resetting - a value that was already reached simply returns immediately
+    const auto& slotState = frameStates[frameIndex];
+    if (slotState.computeTimelineValue > 0) {
+        semaphores.push_back(sync->getComputeTimelineSemaphore());
+        values.push_back(slotState.computeTimelineValue);
+    }
+    if (slotState.graphicsTimelineValue > 0) {
+        semaphores.push_back(sync->getGraphicsTimelineSemaphore());
+        values.push_back(slotState.graphicsTimelineValue);
+    }
+}
+
+void FrameStateManager::recordGraphicsSubmission(uint32_t frameIndex, Clock::time_point inputTime, Clock::time_point submitTime) {
+    if (frameIndex >= frameStates.size()) return;
+    
+    ++pacingTelemetry.submissions;
+    if (gpuDrained) {
+        // Nothing was queued since the drain was observed - the GPU sat idle at least this long
+        pacingTelemetry.totalGpuIdleMs += std::chrono::duration<double, std::milli>(submitTime - gpuDrainedTime).count();
+        ++pacingTelemetry.gpuIdleSubmissions;
+        gpuDrained = false;
+    }
+    
+    auto& slotState = frameStates[frameIndex];
+    slotState.completionPending = true;
+    slotState.inputTime = inputTime;
+}
+
+void FrameStateManager::pollCompletedFrames(const VulkanContext& context, VulkanSync* sync, Clock::time_point now) {
+    if (!sync) return;
+    
+    const auto& vk = context.getLoader();
+    const VkDevice device = context.getDevice();
+    
+    uint64_t completedGraphicsValue = 0;
+    if (sync->usesTimelineSemaphores() &&
+        vk.vkGetSemaphoreCounterValueKHR(device, sync->getGraphicsTimelineSemaphore(), &completedGraphicsValue) != VK_SUCCESS) {
+        return;
+    }
+    
+    for (uint32_t i = 0; i < frameStates.size(); ++i) {
+        auto& slotState = frameStates[i];
+        if (!slotState.completionPending) continue;
+        
+        const bool completed = sync->usesTimelineSemaphores()
+            ? slotState.graphicsTimelineValue <= completedGraphicsValue
+            : vk.vkGetFenceStatus(device, sync->getInFlightFence(i)) == VK_SUCCESS;
+        if (completed) {
+            completeFrame(slotState, now);
+        }
+    }
+}
+
+void FrameStateManager::recordSlotWait(uint32_t frameIndex, double waitMs, Clock::time_point now) {
+    if (frameIndex >= frameStates.size()) return;
+    
+    pacingTelemetry.totalCpuWaitMs += waitMs;
+    completeFrame(frameStates[frameIndex], now);
+}
+
+void FrameStateManager::completeFrame(FrameState& state, Clock::time_point now) {
+    if (!state.completionPending) return;
+    
+    state.completionPending = false;
+    const double latencyMs = std::chrono::duration<double, std::milli>(now - state.inputTime).count();
+    pacingTelemetry.totalLatencyMs += latencyMs;
+    pacingTelemetry.maxLatencyMs = std::max(pacingTelemetry.maxLatencyMs, latencyMs);
+    ++pacingTelemetry.framesCompleted;
+    
+    const bool anyPending = std::any_of(frameStates.begin(), frameStates.end(),
+                                        [](const FrameState& s) { return s.completionPending; });
+    if (!anyPending && !gpuDrained) {
+        gpuDrained = true;
+        gpuDrainedTime = now;
+    }
+}
+
+void FrameStateManager::logPacingTelemetry() const {
+    const auto& t = pacingTelemetry;
+    const double perSubmission = t.submissions ? 1.0 / static_cast<double>(t.submissions) : 0.0;
+    LOG_INFO("FrameStateManager: Pacing (" << frameStates.size() << " frames in flight) - "
+             << "input-to-completion avg " << t.averageLatencyMs() << "ms, max " << t.maxLatencyMs << "ms"
+             << " | CPU wait " << (t.totalCpuWaitMs * perSubmission) << "ms/frame"
+             << " | GPU idle " << (t.totalGpuIdleMs * perSubmission) << "ms/frame"
+             << " (" << t.gpuIdleSubmissions << "/" << t.submissions << " submissions found GPU drained)");
+}
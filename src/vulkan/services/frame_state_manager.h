@@ -1,18 +1,24 @@
 #pragma once
 
 #include <vector>
+#include <chrono>
 #include <vulkan/vulkan.h>
 #include "../core/vulkan_constants.h"
 
+class VulkanContext;
 class VulkanSync;
 
 class FrameStateManager {
 public:
+    using Clock = std::chrono::steady_clock;
+    
     FrameStateManager();
     ~FrameStateManager() = default;
 
-    void initialize();
+    // One slot per frame in flight
+    void initialize(uint32_t framesInFlight);
     void cleanup();
+    uint32_t getFramesInFlight() const { return static_cast<uint32_t>(frameStates.size()); }
 
     // Frame state tracking
     // Mark both compute and graphics usage for the given slot index
@@ -26,13 +32,58 @@ public:
     
     // Check if any fences need waiting for the given slot index
     bool hasActiveFences(uint32_t frameIndex) const;
+    
+    // Timeline frame pacing - values signaled by the last submissions that used the slot
+    void setComputeTimelineValue(uint32_t frameIndex, uint64_t value);
+    void setGraphicsTimelineValue(uint32_t frameIndex, uint64_t value);
+    
+    // Timeline semaphores and values that need to be reached before the slot is reused
+    void getTimelineValuesToWait(uint32_t frameIndex, VulkanSync* sync,
+                                 std::vector<VkSemaphore>& semaphores, std::vector<uint64_t>& values) const;
+    
+    // Frame pacing telemetry, CPU-observed: graphics completion is detected by polling each slot's
+    // fence or timeline value once per frame, so latencies are rounded up to the next poll
+    struct PacingTelemetry {
+        uint64_t framesCompleted = 0;
+        uint64_t submissions = 0;
+        uint64_t gpuIdleSubmissions = 0;   // Submissions that found the GPU already drained
+        double totalLatencyMs = 0.0;       // Input sample -> graphics completion observed
+        double maxLatencyMs = 0.0;
+        double totalCpuWaitMs = 0.0;       // CPU blocked on slot reuse (GPU-bound frames)
+        double totalGpuIdleMs = 0.0;       // Drained GPU waiting for the next submission (CPU-bound frames), lower bound
+        
+        double averageLatencyMs() const { return framesCompleted ? totalLatencyMs / framesCompleted : 0.0; }
+    };
+    
+    // Graphics work for the slot was submitted; inputTime is when that frame's input was sampled
+    void recordGraphicsSubmission(uint32_t frameIndex, Clock::time_point inputTime, Clock::time_point submitTime);
+    // Non-blocking poll of every slot with outstanding graphics work
+    void pollCompletedFrames(const VulkanContext& context, VulkanSync* sync, Clock::time_point now);
+    // The CPU just finished waiting waitMs for the slot, so its work is known complete
+    void recordSlotWait(uint32_t frameIndex, double waitMs, Clock::time_point now);
+    
+    const PacingTelemetry& getPacingTelemetry() const { return pacingTelemetry; }
+    void resetPacingTelemetry() { pacingTelemetry = PacingTelemetry{}; }
+    void logPacingTelemetry() const;
 
 private:
     // Track usage per frame
     struct FrameState {
         bool computeUsed = true;  // Initialize to true for safety on first use of the slot
         bool graphicsUsed = true;
+        uint64_t computeTimelineValue = 0;   // 0 = nothing signaled yet, timeline starts at 0
+        uint64_t graphicsTimelineValue = 0;
+        
+        // Pacing telemetry - graphics submitted but its completion not yet observed
+        bool completionPending = false;
+        Clock::time_point inputTime{};
     };
     
     std::vector<FrameState> frameStates;
+    
+    PacingTelemetry pacingTelemetry;
+    bool gpuDrained = false;              // Every submitted frame observed complete
+    Clock::time_point gpuDrainedTime{};   // When that was first observed
+    
+    void completeFrame(FrameState& state, Clock::time_point now);
 };
@@ -3,7 +3,7 @@
 #include "../core/vulkan_function_loader.h"
 #include "../core/vulkan_utils.h"
 #include "../core/vulkan_constants.h"
-#include <iostream>
+#include "../../ecs/utilities/logger.h"
 
 GPUSynchronizationService::GPUSynchronizationService() {
 }
@@ -14,13 +14,14 @@ GPUSynchronizationService::~GPUSynchronizationService() {
 
 bool GPUSynchronizationService::initialize(const VulkanContext& context) {
     this->context = &context;
+    framesInFlight = context.getFramesInFlight();
     
     const auto& vk = context.getLoader();
     const VkDevice device = context.getDevice();
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+    for (size_t i = 0; i < framesInFlight; ++i) {
         VkFence computeFenceHandle = VulkanUtils::createFence(device, vk, true);
         if (computeFenceHandle == VK_NULL_HANDLE) {
-            std::cerr << "GPUSynchronizationService: Failed to create compute fence for frame " << i << std::endl;
+            LOG_ERROR("GPUSynchronizationService: Failed to create compute fence for frame " << i);
             cleanup();
             return false;
         }
@@ -28,7 +29,7 @@ bool GPUSynchronizationService::initialize(const VulkanContext& context) {
         
         VkFence graphicsFenceHandle = VulkanUtils::createFence(device, vk, true);
         if (graphicsFenceHandle == VK_NULL_HANDLE) {
-            std::cerr << "GPUSynchronizationService: Failed to create graphics fence for frame " << i << std::endl;
+            LOG_ERROR("GPUSynchronizationService: Failed to create graphics fence for frame " << i);
             cleanup();
             return false;
         }
@@ -46,7 +47,7 @@ void GPUSynchronizationService::cleanup() {
     if (!context || !initialized) return;
     
     // RAII wrappers handle automatic cleanup
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+    for (size_t i = 0; i < framesInFlight; ++i) {
         computeFences[i].reset();
         graphicsFences[i].reset();
     }
@@ -56,14 +57,14 @@ void GPUSynchronizationService::cleanup() {
 
 void GPUSynchronizationService::cleanupBeforeContextDestruction() {
     // Explicit cleanup before context destruction to ensure proper destruction order
-    for (size_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+    for (size_t i = 0; i < framesInFlight; ++i) {
         computeFences[i].reset();
         graphicsFences[i].reset();
     }
 }
 
 VkResult GPUSynchronizationService::waitForComputeFence(uint32_t frameIndex, const char* fenceName) {
-    if (frameIndex >= MAX_FRAMES_IN_FLIGHT || !computeInUse[frameIndex]) {
+    if (frameIndex >= framesInFlight || !computeInUse[frameIndex]) {
         return VK_SUCCESS;
     }
     
@@ -75,7 +76,7 @@ VkResult GPUSynchronizationService::waitForComputeFence(uint32_t frameIndex, con
 }
 
 VkResult GPUSynchronizationService::waitForGraphicsFence(uint32_t frameIndex, const char* fenceName) {
-    if (frameIndex >= MAX_FRAMES_IN_FLIGHT || !graphicsInUse[frameIndex]) {
+    if (frameIndex >= framesInFlight || !graphicsInUse[frameIndex]) {
         return VK_SUCCESS;
     }
     
@@ -87,36 +88,36 @@ VkResult GPUSynchronizationService::waitForGraphicsFence(uint32_t frameIndex, co
 }
 
 bool GPUSynchronizationService::waitForAllFrames() {
-    std::cout << "GPUSynchronizationService: CRITICAL - Waiting for all frames before swapchain recreation" << std::endl;
+    LOG_INFO("GPUSynchronizationService: CRITICAL - Waiting for all frames before swapchain recreation");
     
-    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+    for (uint32_t i = 0; i < framesInFlight; ++i) {
         if (computeInUse[i]) {
-            std::cout << "GPUSynchronizationService: Waiting for compute fence " << i << std::endl;
+            LOG_INFO("GPUSynchronizationService: Waiting for compute fence " << i);
             VkResult result = waitForFenceRobust(computeFences[i].get(), "compute");
             if (result == VK_ERROR_DEVICE_LOST || result == VK_TIMEOUT) {
-                std::cerr << "GPUSynchronizationService: Failed to wait for compute fence " << i << ": " << result << std::endl;
+                LOG_ERROR("GPUSynchronizationService: Failed to wait for compute fence " << i << ": " << result);
                 return false;
             }
             computeInUse[i] = false;
-            std::cout << "GPUSynchronizationService: Compute fence " << i << " signaled successfully" << std::endl;
+            LOG_INFO("GPUSynchronizationService: Compute fence " << i << " signaled successfully");
         }
         if (graphicsInUse[i]) {
-            std::cout << "GPUSynchronizationService: Waiting for graphics fence " << i << std::endl;
+            LOG_INFO("GPUSynchronizationService: Waiting for graphics fence " << i);
             VkResult result = waitForFenceRobust(graphicsFences[i].get(), "graphics");
             if (result == VK_ERROR_DEVICE_LOST || result == VK_TIMEOUT) {
-                std::cerr << "GPUSynchronizationService: Failed to wait for graphics fence " << i << ": " << result << std::endl;
+                LOG_ERROR("GPUSynchronizationService: Failed to wait for graphics fence " << i << ": " << result);
                 return false;
             }
             graphicsInUse[i] = false;
-            std::cout << "GPUSynchronizationService: Graphics fence " << i << " signaled successfully" << std::endl;
+            LOG_INFO("GPUSynchronizationService: Graphics fence " << i << " signaled successfully");
         }
     }
     
     // CRITICAL FIX FOR SECOND RESIZE CRASH: Reset all fences after waiting
     // This prevents fence timeline corruption that can survive first resize but crash on second
-    std::cout << "GPUSynchronizationService: CRITICAL FIX - Resetting all fences after swapchain recreation wait" << std::endl;
+    LOG_INFO("GPUSynchronizationService: CRITICAL FIX - Resetting all fences after swapchain recreation wait");
     std::vector<VkFence> allFences;
-    for (uint32_t i = 0; i < MAX_FRAMES_IN_FLIGHT; ++i) {
+    for (uint32_t i = 0; i < framesInFlight; ++i) {
         allFences.push_back(computeFences[i].get());
         allFences.push_back(graphicsFences[i].get());
     }
@@ -129,10 +130,10 @@ bool GPUSynchronizationService::waitForAllFrames() {
                                            static_cast<uint32_t>(allFences.size()), 
                                            allFences.data());
     if (resetResult != VK_SUCCESS) {
-        std::cerr << "GPUSynchronizationService: WARNING - Failed to reset fences after swapchain recreation: " << resetResult << std::endl;
-        std::cerr << "  This may cause fence synchronization corruption in subsequent frames" << std::endl;
+        LOG_WARNING("GPUSynchronizationService: WARNING - Failed to reset fences after swapchain recreation: " << resetResult);
+        LOG_ERROR("  This may cause fence synchronization corruption in subsequent frames");
     } else {
-        std::cout << "GPUSynchronizationService: All fences successfully reset after swapchain recreation" << std::endl;
+        LOG_INFO("GPUSynchronizationService: All fences successfully reset after swapchain recreation");
     }
     
     return true;
@@ -148,8 +149,8 @@ VkResult GPUSynchronizationService::waitForFenceRobust(VkFence fence, const char
     VkResult result = vk.vkWaitForFences(device, 1, &fence, VK_TRUE, timeoutNs);
     
     if (result == VK_TIMEOUT) {
-        std::cerr << "GPUSynchronizationService: Critical: " << fenceName << " fence timeout after 2 seconds" << std::endl;
-        std::cerr << "  This indicates a GPU hang or driver issue. Propagating timeout error." << std::endl;
+        LOG_ERROR("GPUSynchronizationService: Critical: " << fenceName << " fence timeout after 2 seconds");
+        LOG_ERROR("  This indicates a GPU hang or driver issue. Propagating timeout error.");
         // Return timeout instead of forcing device idle - let caller handle recovery
         return VK_TIMEOUT;
     }
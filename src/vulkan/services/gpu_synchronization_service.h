@@ -34,6 +34,7 @@ public:
 private:
     const VulkanContext* context = nullptr;
     bool initialized = false;
+    uint32_t framesInFlight = 0;  // Active prefix of the MAX_FRAMES_IN_FLIGHT-sized arrays
 
     std::array<vulkan_raii::Fence, MAX_FRAMES_IN_FLIGHT> computeFences{};
     std::array<vulkan_raii::Fence, MAX_FRAMES_IN_FLIGHT> graphicsFences{};
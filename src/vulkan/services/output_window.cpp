@@ -0,0 +1,176 @@
+#include "output_window.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_swapchain.h"
+#include "../core/vulkan_function_loader.h"
+#include "../pipelines/graphics_pipeline_manager.h"
+#include "../../ecs/utilities/logger.h"
+
+OutputWindow::~OutputWindow() {
+    cleanupBeforeContextDestruction();
+}
+
+bool OutputWindow::initialize(const VulkanContext& context, SDL_Window* window, const VulkanSwapchain& mainSwapchain,
+                              GraphicsPipelineManager* graphicsManager) {
+    this->context = &context;
+    this->graphicsManager = graphicsManager;
+    this->window = window;
+    
+    surface = context.createWindowSurface(window);
+    if (!surface) {
+        return false;
+    }
+    if (!context.supportsPresentTo(surface.get())) {
+        LOG_ERROR("OutputWindow: The present queue cannot present to window " << SDL_GetWindowTitle(window));
+        cleanupBeforeContextDestruction();
+        return false;
+    }
+    
+    swapchain = std::make_unique<VulkanSwapchain>();
+    swapchain->setRenderQuality(mainSwapchain.getSampleCount(), mainSwapchain.getRenderScale());
+    swapchain->setPresentPolicy(mainSwapchain.getPresentPolicy());
+    if (!swapchain->initialize(context, window, surface.get()) || !swapchain->createFramebuffers(getRenderPass())) {
+        LOG_ERROR("OutputWindow: Failed to create the swapchain of window " << SDL_GetWindowTitle(window));
+        cleanupBeforeContextDestruction();
+        return false;
+    }
+    
+    semaphoreCount = context.getFramesInFlight() + 1;
+    for (uint32_t i = 0; i < semaphoreCount; ++i) {
+        if (!createSemaphore(i)) {
+            cleanupBeforeContextDestruction();
+            return false;
+        }
+    }
+    
+    LOG_INFO("OutputWindow: " << SDL_GetWindowTitle(window) << " at " << swapchain->getExtent().width << "x"
+             << swapchain->getExtent().height);
+    return true;
+}
+
+void OutputWindow::cleanupBeforeContextDestruction() {
+    for (auto& semaphore : acquireSemaphores) {
+        semaphore.reset();
+    }
+    semaphoreCount = 0;
+    imageHeld = false;
+    
+    // The swapchain goes before the surface it was created on
+    swapchain.reset();
+    surface.reset();
+}
+
+bool OutputWindow::createSemaphore(uint32_t index) {
+    VkSemaphoreCreateInfo semaphoreInfo{};
+    semaphoreInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_CREATE_INFO;
+    VkSemaphore semaphore = VK_NULL_HANDLE;
+    if (context->getLoader().vkCreateSemaphore(context->getDevice(), &semaphoreInfo, nullptr, &semaphore) != VK_SUCCESS) {
+        LOG_ERROR("OutputWindow: Failed to create acquire semaphore " << index);
+        return false;
+    }
+    acquireSemaphores[index] = vulkan_raii::make_semaphore(semaphore, context);
+    return true;
+}
+
+VkRenderPass OutputWindow::getRenderPass() const {
+    // The render pass cache hands back the main window's pass when format and quality match
+    if (context->supportsDynamicRendering()) {
+        return VK_NULL_HANDLE;
+    }
+    return graphicsManager->createRenderPass(
+        swapchain->getImageFormat(), swapchain->getDepthFormat(), swapchain->getSampleCount(),
+        swapchain->getSampleCount() != VK_SAMPLE_COUNT_1_BIT, swapchain->getOutputLayout());
+}
+
+bool OutputWindow::acquire() {
+    if (imageHeld) {
+        return true;
+    }
+    if (!isAvailable() || recreationNeeded) {
+        return false;
+    }
+    
+    const uint32_t semaphore = nextSemaphore;
+    const VkResult result = context->getLoader().vkAcquireNextImageKHR(
+        context->getDevice(), swapchain->getSwapchain(), 0, acquireSemaphores[semaphore].get(), VK_NULL_HANDLE, &imageIndex);
+    if (result == VK_SUCCESS || result == VK_SUBOPTIMAL_KHR) {
+        imageHeld = true;
+        heldSemaphore = semaphore;
+        nextSemaphore = (semaphore + 1) % semaphoreCount;
+        recreationNeeded = result == VK_SUBOPTIMAL_KHR;  // Still presented, then rebuilt
+        return true;
+    }
+    
+    // Not ready: this display has not released an image yet, so it skips the frame
+    if (result == VK_ERROR_OUT_OF_DATE_KHR) {
+        recreationNeeded = true;
+    } else if (result == VK_ERROR_SURFACE_LOST_KHR) {
+        LOG_ERROR("OutputWindow: Surface of window " << SDL_GetWindowTitle(window) << " lost, no longer drawn");
+        failed = true;
+    } else if (result != VK_NOT_READY && result != VK_TIMEOUT) {
+        LOG_ERROR("OutputWindow: Failed to acquire an image of window " << SDL_GetWindowTitle(window) << ": " << result);
+        recreationNeeded = true;
+    }
+    return false;
+}
+
+void OutputWindow::presented(VkResult result) {
+    imageHeld = false;
+    if (result == VK_ERROR_OUT_OF_DATE_KHR || result == VK_SUBOPTIMAL_KHR) {
+        recreationNeeded = true;
+    } else if (result != VK_SUCCESS) {
+        LOG_ERROR("OutputWindow: Failed to present window " << SDL_GetWindowTitle(window) << ": " << result);
+        recreationNeeded = true;
+    }
+}
+
+bool OutputWindow::hasArea() const {
+    int width = 0, height = 0;
+    SDL_GetWindowSizeInPixels(window, &width, &height);
+    return width > 0 && height > 0;
+}
+
+bool OutputWindow::needsRecreation() const {
+    return recreationNeeded && isAvailable() && hasArea();
+}
+
+bool OutputWindow::recreate(const VulkanSwapchain& mainSwapchain) {
+    if (!isAvailable()) {
+        return false;
+    }
+    
+    // Minimized: VulkanSwapchain::recreate would wait for the window to get an area again
+    if (!hasArea()) {
+        recreationNeeded = true;
+        return false;
+    }
+    
+    // A held image goes with the old swapchain; its semaphore was signaled without a wait, so it is replaced
+    if (imageHeld) {
+        imageHeld = false;
+        if (!createSemaphore(heldSemaphore)) {
+            failed = true;
+            return false;
+        }
+    }
+    
+    swapchain->setRenderQuality(mainSwapchain.getSampleCount(), mainSwapchain.getRenderScale());
+    swapchain->setPresentPolicy(mainSwapchain.getPresentPolicy());
+    const VkRenderPass renderPass = getRenderPass();
+    if ((renderPass == VK_NULL_HANDLE && !context->supportsDynamicRendering()) || !swapchain->recreate(renderPass)) {
+        LOG_ERROR("OutputWindow: Failed to recreate the swapchain of window " << SDL_GetWindowTitle(window) << ", no longer drawn");
+        failed = true;
+        return false;
+    }
+    recreationNeeded = false;
+    return true;
+}
+
+glm::mat4 OutputWindow::getWallTileProjection(const glm::mat4& projection, float projectionAspect, float wallAspect,
+                                              float left, float width) {
+    // The wall's clip x is the projection's scaled by projectionAspect / wallAspect; the tile then maps
+    // [left, left + width) of the wall onto [-1, 1], its offset applied through w so it holds before the divide
+    glm::mat4 tile(1.0f);
+    tile[0][0] = projectionAspect / (wallAspect * width);
+    tile[3][0] = (1.0f - 2.0f * left) / width - 1.0f;
+    return tile * projection;
+}
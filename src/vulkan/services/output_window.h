@@ -0,0 +1,86 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <SDL3/SDL.h>
+#include "../core/vulkan_constants.h"
+#include "../core/vulkan_raii.h"
+#include <glm/glm.hpp>
+#include <array>
+#include <cstdint>
+#include <memory>
+
+// Forward declarations
+class VulkanContext;
+class VulkanSwapchain;
+class GraphicsPipelineManager;
+
+/**
+ * One extra window of a display wall (--output-windows). It shares the main window's device, simulation and
+ * culling pass, but has its own surface, swapchain and acquire semaphores: RenderFrameDirector draws it with its
+ * own EntityGraphicsNode from one view of the culling pass, and CommandSubmissionService presents it in the
+ * main window's vkQueuePresentKHR.
+ *
+ * acquire() never waits, so a window whose display runs behind, or whose swapchain needs recreating, skips the
+ * frame instead of stalling the others. An image acquired for a frame that went out without graphics is kept for
+ * the next one.
+ */
+class OutputWindow {
+public:
+    OutputWindow() = default;
+    ~OutputWindow();
+    OutputWindow(const OutputWindow&) = delete;
+    OutputWindow& operator=(const OutputWindow&) = delete;
+    
+    // Takes mainSwapchain's render quality and present policy; false, reported, when the present queue cannot
+    // present to the window or its swapchain cannot be created
+    bool initialize(const VulkanContext& context, SDL_Window* window, const VulkanSwapchain& mainSwapchain,
+                    GraphicsPipelineManager* graphicsManager);
+    // Device idle
+    void cleanupBeforeContextDestruction();
+    
+    // At the start of a presenting frame: true when an image is held for it
+    bool acquire();
+    bool hasImage() const { return imageHeld; }
+    uint32_t getImageIndex() const { return imageIndex; }
+    VkSemaphore getAcquireSemaphore() const { return acquireSemaphores[heldSemaphore].get(); }
+    // After the present that included the held image, with its VkPresentInfoKHR::pResults entry
+    void presented(VkResult result);
+    
+    // Device idle: rebuilds the swapchain at the window's size with mainSwapchain's render quality and present
+    // policy. False while the window has no area (retried next time) or when it failed for good.
+    // needsRecreation() waits for a minimized window to be restored
+    bool needsRecreation() const;
+    void requestRecreation() { recreationNeeded = true; }
+    bool recreate(const VulkanSwapchain& mainSwapchain);
+    
+    bool isAvailable() const { return swapchain && !failed; }
+    VulkanSwapchain* getSwapchain() const { return swapchain.get(); }
+    
+    // Display wall layout: projection, made for projectionAspect, widened to a wall of wallAspect with the same
+    // vertical extent and narrowed to the tile [left, left + width) of it (fractions of the wall width)
+    static glm::mat4 getWallTileProjection(const glm::mat4& projection, float projectionAspect, float wallAspect,
+                                           float left, float width);
+
+private:
+    bool createSemaphore(uint32_t index);
+    bool hasArea() const;
+    // VK_NULL_HANDLE under dynamic rendering
+    VkRenderPass getRenderPass() const;
+    
+    const VulkanContext* context = nullptr;
+    GraphicsPipelineManager* graphicsManager = nullptr;
+    SDL_Window* window = nullptr;
+    vulkan_raii::SurfaceKHR surface;
+    std::unique_ptr<VulkanSwapchain> swapchain;
+    
+    // Taken in turn, one more than the frames in flight: a semaphore comes around again only after the frame
+    // whose graphics submission waited on it has completed
+    std::array<vulkan_raii::Semaphore, MAX_FRAMES_IN_FLIGHT + 1> acquireSemaphores{};
+    uint32_t semaphoreCount = 0;
+    uint32_t nextSemaphore = 0;
+    uint32_t heldSemaphore = 0;
+    uint32_t imageIndex = 0;
+    bool imageHeld = false;
+    bool recreationNeeded = false;
+    bool failed = false;
+};
@@ -0,0 +1,182 @@
+#include "present_timing_monitor.h"
+#include "../core/vulkan_swapchain.h"
+#include "../../ecs/utilities/logger.h"
+#include "../../ecs/utilities/profiler.h"
+#include <algorithm>
+#include <cmath>
+
+namespace {
+
+int64_t toProfilerNs(PresentTimingMonitor::Clock::time_point time) {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(time.time_since_epoch()).count();
+}
+
+} // namespace
+
+void PresentTimingMonitor::setTargetFrameRate(uint32_t framesPerSecond) {
+    std::lock_guard<std::mutex> lock(mutex);
+    targetFrameRate = framesPerSecond;
+}
+
+void PresentTimingMonitor::recordPresent(uint64_t presentId, Clock::time_point eventTime, Clock::time_point sampleTime,
+                                         Clock::time_point presentTime) {
+    if (presentId == 0) {
+        return;
+    }
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    const uint64_t newestId = pendingCount > 0 ? pending[(pendingHead + pendingCount - 1) % MAX_PENDING_PRESENTS].presentId : 0;
+    if (presentId <= newestId || presentId <= lastExactPresentId) {
+        // IDs restarted with a new swapchain object (device loss recovery); the old presents are gone with it
+        telemetry.droppedPresents += pendingCount;
+        pendingCount = 0;
+        lastExactPresentId = 0;
+    }
+    if (pendingCount == MAX_PENDING_PRESENTS) {
+        popOldest();
+        telemetry.droppedPresents++;
+    }
+    pending[(pendingHead + pendingCount) % MAX_PENDING_PRESENTS] = PendingPresent{presentId, eventTime, sampleTime, presentTime};
+    pendingCount++;
+}
+
+void PresentTimingMonitor::markPresented(uint64_t presentId, Clock::time_point waitStart, Clock::time_point waitEnd) {
+    // Below this the present was on screen before the wait began, and the return says nothing about when
+    constexpr auto BLOCKED_WAIT = std::chrono::microseconds(50);
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    completeThrough(presentId, waitEnd, waitEnd - waitStart >= BLOCKED_WAIT);
+}
+
+void PresentTimingMonitor::poll(const VulkanSwapchain& swapchain) {
+    pastTimings.clear();
+    swapchain.getPastPresentationTimings(pastTimings);
+    const Clock::time_point now = Clock::now();
+    
+    std::lock_guard<std::mutex> lock(mutex);
+    refreshDurationNs = swapchain.getRefreshDurationNs();
+    
+    // Presents the retired swapchain still held will never be reported
+    while (pendingCount > 0 && pending[pendingHead].presentId < swapchain.getFirstSwapchainPresentId()) {
+        popOldest();
+        telemetry.droppedPresents++;
+    }
+    
+    // Display times are only trusted between the submit and now; outside that the driver's clock is not the
+    // steady clock and the poll time is used instead
+    for (const VkPastPresentationTimingGOOGLE& timing : pastTimings) {
+        for (uint32_t i = 0; i < pendingCount; ++i) {
+            const PendingPresent& present = pending[(pendingHead + i) % MAX_PENDING_PRESENTS];
+            if (static_cast<uint32_t>(present.presentId) != timing.presentID) {
+                continue;
+            }
+            const Clock::time_point displayTime{std::chrono::nanoseconds(timing.actualPresentTime)};
+            const bool plausible = displayTime >= present.presentTime && displayTime <= now;
+            completeThrough(present.presentId, plausible ? displayTime : now, plausible);
+            break;
+        }
+    }
+    
+    if (!swapchain.supportsPresentWait()) {
+        return;
+    }
+    while (pendingCount > 0 && swapchain.waitForPresent(pending[pendingHead].presentId, 0)) {
+        completeThrough(pending[pendingHead].presentId, now, false);
+    }
+}
+
+void PresentTimingMonitor::completeThrough(uint64_t presentId, Clock::time_point completionTime, bool exact) {
+    static const ProfileZoneId eventZone = Profiler::getInstance().registerZone("Input Event to Present");
+    static const ProfileZoneId sampleZone = Profiler::getInstance().registerZone("Input Sample to Present");
+    
+    while (pendingCount > 0 && pending[pendingHead].presentId < presentId) {
+        popOldest();
+        telemetry.droppedPresents++;
+    }
+    if (pendingCount == 0 || pending[pendingHead].presentId != presentId) {
+        return;  // Already completed through another source
+    }
+    const PendingPresent present = pending[pendingHead];
+    popOldest();
+    
+    telemetry.presents++;
+    Profiler& profiler = Profiler::getInstance();
+    const bool profiling = profiler.isEnabled();
+    if (present.eventTime != Clock::time_point{} && completionTime > present.eventTime) {
+        const double latencyMs = std::chrono::duration<double, std::milli>(completionTime - present.eventTime).count();
+        eventLatency.add(static_cast<float>(latencyMs));
+        telemetry.maxEventLatencyMs = std::max(telemetry.maxEventLatencyMs, latencyMs);
+        if (profiling) {
+            profiler.record(eventZone, toProfilerNs(present.eventTime), toProfilerNs(completionTime) - toProfilerNs(present.eventTime));
+        }
+    }
+    if (completionTime > present.sampleTime) {
+        sampleLatency.add(std::chrono::duration<float, std::milli>(completionTime - present.sampleTime).count());
+        if (profiling) {
+            profiler.record(sampleZone, toProfilerNs(present.sampleTime), toProfilerNs(completionTime) - toProfilerNs(present.sampleTime));
+        }
+    }
+    
+    if (!exact) {
+        return;
+    }
+    telemetry.exactPresents++;
+    if (refreshDurationNs > 0 && lastExactPresentId != 0 && presentId == lastExactPresentId + 1) {
+        const double refreshes = std::chrono::duration<double, std::nano>(completionTime - lastExactCompletion).count() /
+                                 static_cast<double>(refreshDurationNs);
+        const double targetRefreshes = targetFrameRate > 0 ? 1e9 / (static_cast<double>(targetFrameRate) * refreshDurationNs) : 1.0;
+        const int64_t expected = std::max<int64_t>(1, std::llround(targetRefreshes));
+        const int64_t missed = std::max<int64_t>(0, std::llround(refreshes) - expected);
+        telemetry.missedVblanks += static_cast<uint64_t>(missed);
+        telemetry.measuredIntervals++;
+        profiler.recordMissedVblanks(static_cast<uint64_t>(missed));
+    }
+    lastExactPresentId = presentId;
+    lastExactCompletion = completionTime;
+}
+
+PresentTimingMonitor::Telemetry PresentTimingMonitor::getTelemetry() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return telemetry;
+}
+
+float PresentTimingMonitor::LatencySamples::percentile(float fraction) const {
+    const uint32_t held = std::min(count, MAX_LATENCY_SAMPLES);
+    if (held == 0) {
+        return 0.0f;
+    }
+    std::array<float, MAX_LATENCY_SAMPLES> sorted = values;
+    const uint32_t rank = static_cast<uint32_t>((held - 1) * fraction);
+    std::nth_element(sorted.begin(), sorted.begin() + rank, sorted.begin() + held);
+    return sorted[rank];
+}
+
+float PresentTimingMonitor::getEventLatencyPercentile(float percentile) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return eventLatency.percentile(percentile);
+}
+
+float PresentTimingMonitor::getSampleLatencyPercentile(float percentile) const {
+    std::lock_guard<std::mutex> lock(mutex);
+    return sampleLatency.percentile(percentile);
+}
+
+void PresentTimingMonitor::logTelemetry() const {
+    std::lock_guard<std::mutex> lock(mutex);
+    if (telemetry.presents == 0 && telemetry.droppedPresents == 0) {
+        return;  // Neither present wait nor display timing, or nothing presented
+    }
+    LOG_INFO("PresentTimingMonitor: Input event to present p50 " << eventLatency.percentile(0.5f) << "ms, p99 "
+             << eventLatency.percentile(0.99f) << "ms, max " << telemetry.maxEventLatencyMs << "ms"
+             << " | sample to present p50 " << sampleLatency.percentile(0.5f) << "ms, p99 " << sampleLatency.percentile(0.99f) << "ms"
+             << " | " << telemetry.missedVblanks << " missed vblanks over " << telemetry.measuredIntervals << " intervals"
+             << " (" << telemetry.exactPresents << "/" << telemetry.presents << " presents exact, "
+             << telemetry.droppedPresents << " dropped)");
+}
+
+void PresentTimingMonitor::resetTelemetry() {
+    std::lock_guard<std::mutex> lock(mutex);
+    telemetry = Telemetry{};
+    eventLatency.count = 0;
+    sampleLatency.count = 0;
+}
@@ -0,0 +1,96 @@
+#pragma once
+
+#include <vulkan/vulkan.h>
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+
+class VulkanSwapchain;
+
+// Input-to-present latency and missed vblanks, as seen on the display rather than at submit. Each present is
+// recorded with the earliest input event its frame consumed and the frame's input sample, and completes at the
+// first of: the actual display time from VK_GOOGLE_display_timing, a FramePacer present wait that blocked until
+// it was on screen, or a zero-timeout present wait in poll(), which rounds the completion up to the next poll.
+// Missed vblanks are counted only between consecutive presents with an exact completion time, as refreshes
+// beyond the frame rate limit's period that showed the previous image again.
+class PresentTimingMonitor {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    static constexpr uint32_t MAX_PENDING_PRESENTS = 16;
+    static constexpr uint32_t MAX_LATENCY_SAMPLES = 512;  // Percentiles are over the newest samples since reset
+    
+    PresentTimingMonitor() = default;
+    ~PresentTimingMonitor() = default;
+    
+    // Expected display interval is the period of this rate rounded to whole refreshes (0 = one refresh per frame)
+    void setTargetFrameRate(uint32_t framesPerSecond);
+    
+    // Frame producer, after vkQueuePresentKHR; eventTime is Clock::time_point{} when the frame consumed no input
+    // event. Past MAX_PENDING_PRESENTS outstanding the oldest is given up
+    void recordPresent(uint64_t presentId, Clock::time_point eventTime, Clock::time_point sampleTime,
+                       Clock::time_point presentTime);
+    
+    // FramePacer, after a present wait for presentId succeeded. A wait that blocked returned as the present
+    // reached the screen, so its return is taken as the exact completion time
+    void markPresented(uint64_t presentId, Clock::time_point waitStart, Clock::time_point waitEnd);
+    
+    // Frame producer once a frame: display timing results, then the present waits of the oldest presents
+    void poll(const VulkanSwapchain& swapchain);
+    
+    struct Telemetry {
+        uint64_t presents = 0;          // Completed presents
+        uint64_t exactPresents = 0;     // Of those, completed at a display time or a blocking present wait
+        uint64_t droppedPresents = 0;   // Never shown (replaced in the queue) or retired with their swapchain
+        uint64_t missedVblanks = 0;
+        uint64_t measuredIntervals = 0; // Consecutive exact presents the vblank count is over
+        double maxEventLatencyMs = 0.0;
+    };
+    Telemetry getTelemetry() const;
+    
+    // Over the latency samples since resetTelemetry(); 0 without samples
+    float getEventLatencyPercentile(float percentile) const;   // Input event -> on screen
+    float getSampleLatencyPercentile(float percentile) const;  // Input sample -> on screen
+    
+    void logTelemetry() const;
+    void resetTelemetry();
+
+private:
+    struct PendingPresent {
+        uint64_t presentId = 0;
+        Clock::time_point eventTime{};
+        Clock::time_point sampleTime{};
+        Clock::time_point presentTime{};
+    };
+    
+    struct LatencySamples {
+        std::array<float, MAX_LATENCY_SAMPLES> values{};
+        uint32_t count = 0;  // Total recorded; the ring holds the newest MAX_LATENCY_SAMPLES
+        
+        void add(float milliseconds) { values[count++ % MAX_LATENCY_SAMPLES] = milliseconds; }
+        float percentile(float fraction) const;
+    };
+    
+    // Retires every pending present up to presentId: older ones as dropped, presentId itself as completed
+    void completeThrough(uint64_t presentId, Clock::time_point completionTime, bool exact);
+    void popOldest() { pendingHead = (pendingHead + 1) % MAX_PENDING_PRESENTS; pendingCount--; }
+    
+    mutable std::mutex mutex;
+    std::array<PendingPresent, MAX_PENDING_PRESENTS> pending{};
+    uint32_t pendingHead = 0;
+    uint32_t pendingCount = 0;
+    
+    uint32_t targetFrameRate = 0;
+    uint64_t refreshDurationNs = 0;
+    uint64_t lastExactPresentId = 0;
+    Clock::time_point lastExactCompletion{};
+    
+    Telemetry telemetry;
+    LatencySamples eventLatency;
+    LatencySamples sampleLatency;
+    
+    // poll() scratch, frame producer only
+    std::vector<VkPastPresentationTimingGOOGLE> pastTimings;
+};
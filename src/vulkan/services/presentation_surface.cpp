@@ -5,6 +5,7 @@
 #include "../core/vulkan_function_loader.h"
 #include "../core/vulkan_constants.h"
 #include "gpu_synchronization_service.h"
+#include "../../ecs/utilities/profiler.h"
 #include <iostream>
 
 PresentationSurface::PresentationSurface() {
@@ -30,7 +31,7 @@ bool PresentationSurface::initialize(
 void PresentationSurface::cleanup() {
 }
 
-SurfaceAcquisitionResult PresentationSurface::acquireNextImage(uint32_t currentFrame) {
+SurfaceAcquisitionResult PresentationSurface::acquireNextImage(uint32_t currentFrame, VkSemaphore imageAvailableSemaphore) {
     SurfaceAcquisitionResult result;
 
     // Prevent concurrent acquisition attempts
@@ -54,7 +55,7 @@ SurfaceAcquisitionResult PresentationSurface::acquireNextImage(uint32_t currentF
         context->getDevice(),
         swapchain->getSwapchain(),
         timeoutNs,
-        VK_NULL_HANDLE,
+        imageAvailableSemaphore,
         VK_NULL_HANDLE,
         &result.imageIndex
     );
@@ -86,6 +87,7 @@ bool PresentationSurface::recreateSwapchain() {
         return true;
     }
     recreationInProgress = true;
+    PROFILE_HITCH_EVENT(HitchCause::SwapchainRecreation);
 
     
     // CRITICAL FIX FOR SECOND RESIZE CRASH: Skip redundant fence wait
@@ -96,26 +98,20 @@ bool PresentationSurface::recreateSwapchain() {
     //     return false;
     // }
 
-    // Clear graphics pipeline cache to prevent corruption
-    graphicsManager->clearCache();
-    
-    // Recreate render pass for new swapchain format
-    currentRenderPass = graphicsManager->createRenderPass(
-        swapchain->getImageFormat(), VK_FORMAT_UNDEFINED, VK_SAMPLE_COUNT_2_BIT, true);
-    if (currentRenderPass == VK_NULL_HANDLE) {
+    // Render passes are cached by format, sample count and output layout, none of which depend on the extent:
+    // a plain resize gets the same handle back, so the pipelines built against it stay valid (viewport and
+    // scissor are dynamic) and only the images and framebuffers below are rebuilt. A render quality change
+    // gets a new render pass, and the nodes compile pipelines for it on first use. Dynamic rendering has
+    // neither render pass nor framebuffers
+    currentRenderPass = context->supportsDynamicRendering() ? VK_NULL_HANDLE : graphicsManager->createRenderPass(
+        swapchain->getImageFormat(), swapchain->getDepthFormat(), swapchain->getSampleCount(),
+        swapchain->getSampleCount() != VK_SAMPLE_COUNT_1_BIT, swapchain->getOutputLayout());
+    if (currentRenderPass == VK_NULL_HANDLE && !context->supportsDynamicRendering()) {
         std::cerr << "PresentationSurface: Failed to recreate render pass" << std::endl;
         recreationInProgress = false;
         return false;
     }
     
-    // CRITICAL FIX FOR SECOND RESIZE CRASH: Recreate pipeline cache after render pass recreation
-    // This addresses VkPipelineCache internal corruption that survives first resize but crashes on second
-    if (!graphicsManager->recreatePipelineCache()) {
-        std::cerr << "PresentationSurface: CRITICAL ERROR - Failed to recreate graphics pipeline cache during swapchain recreation" << std::endl;
-        std::cerr << "  This may cause pipeline creation failures or crashes in subsequent frames" << std::endl;
-        // Continue anyway - this is better than failing entirely
-    }
-
     // Recreate swapchain
     if (!swapchain->recreate(currentRenderPass)) {
         recreationInProgress = false;
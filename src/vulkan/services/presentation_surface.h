@@ -30,7 +30,8 @@ public:
     void cleanup();
 
     // Main coordination methods
-    SurfaceAcquisitionResult acquireNextImage(uint32_t currentFrame);
+    // imageAvailableSemaphore is signaled for the graphics submission that waits on it
+    SurfaceAcquisitionResult acquireNextImage(uint32_t currentFrame, VkSemaphore imageAvailableSemaphore);
     bool recreateSwapchain();
 
     // Framebuffer resize handling
@@ -0,0 +1,194 @@
+#include "quality_governor.h"
+#include "../rendering/execution/node_timestamp_profiler.h"
+#include "../../ecs/utilities/logger.h"
+#include <algorithm>
+#include <ostream>
+#include <iterator>
+
+namespace {
+
+constexpr float RENDER_SCALE_STEPS[] = {1.0f, 0.85f, 0.7f, 0.5f};
+
+// Steps each knob can go below the baseline; the value limits (MSAA 1x, MIN_RENDER_SCALE, the stride cap) may stop it sooner
+constexpr std::array<uint32_t, QualityGovernor::KNOB_COUNT> MAX_STEPS = {3, std::size(RENDER_SCALE_STEPS) - 1, 6, 2, 2};
+
+void printKnobValue(std::ostream& out, QualityGovernor::Knob knob, const QualitySettings& settings) {
+    switch (knob) {
+        case QualityGovernor::Knob::CollisionStride: out << settings.collisionStride; break;
+        case QualityGovernor::Knob::RenderScale: out << settings.renderScale; break;
+        case QualityGovernor::Knob::Msaa: out << settings.msaaSamples << "x"; break;
+        case QualityGovernor::Knob::DensityLod: out << settings.densityLodThreshold << "px"; break;
+        case QualityGovernor::Knob::IdleSpeed: out << settings.idleSpeed; break;
+        case QualityGovernor::Knob::Count: break;
+    }
+}
+
+}
+
+const char* QualityGovernor::getKnobName(Knob knob) {
+    switch (knob) {
+        case Knob::CollisionStride: return "collision stride";
+        case Knob::RenderScale: return "render scale";
+        case Knob::Msaa: return "MSAA";
+        case Knob::DensityLod: return "density LOD threshold";
+        case Knob::IdleSpeed: return "physics idle speed";
+        case Knob::Count: break;
+    }
+    return "unknown";
+}
+
+void QualityGovernor::setEnabled(bool enable) {
+    enabled = enable;
+    steps = {};
+    history.clear();
+    settings = baseline;
+    windowFrames = 0;
+    windowCpuMs = 0.0;
+    settling = false;
+    windowsUnderBudget = 0;
+    restoreBackoff = 1;
+    windowsSinceRestore = UINT32_MAX;
+    floorReported = false;
+    LOG_INFO("QualityGovernor: " << (enabled ? "enabled" : "disabled") << ", target " << targetFrameMs << "ms");
+}
+
+void QualityGovernor::setBaseline(const QualitySettings& newBaseline) {
+    baseline = newBaseline;
+    settings = enabled ? settingsAt(steps) : baseline;
+}
+
+QualitySettings QualityGovernor::settingsAt(const Steps& knobSteps) const {
+    const auto step = [&knobSteps](Knob knob) { return knobSteps[static_cast<uint32_t>(knob)]; };
+    QualitySettings result = baseline;
+    if (baseline.collisionStride != 0) {
+        result.collisionStride = std::min(baseline.collisionStride << step(Knob::CollisionStride), PHYSICS_MAX_COLLISION_STRIDE);
+    }
+    result.renderScale = std::max(MIN_RENDER_SCALE, baseline.renderScale * RENDER_SCALE_STEPS[step(Knob::RenderScale)]);
+    result.msaaSamples = std::max(1u, baseline.msaaSamples >> step(Knob::Msaa));
+    if (ENABLE_DENSITY_LOD) {
+        result.densityLodThreshold = baseline.densityLodThreshold * static_cast<float>(1u << step(Knob::DensityLod));
+    }
+    result.idleSpeed = baseline.idleSpeed * static_cast<float>(1u << (2 * step(Knob::IdleSpeed)));
+    return result;
+}
+
+float QualityGovernor::sumWindowGpuTime(const FrameGraphExecution::NodeTimestampProfiler& nodeProfiler) {
+    // Nodes that did not run in the window keep their old averages, so only those with new samples count. Compute
+    // and graphics nodes overlap on separate queues, which makes the sum an upper bound of the GPU frame time
+    float totalMs = 0.0f;
+    for (const auto& [nodeId, timing] : nodeProfiler.getTimings()) {
+        uint64_t& lastSampleCount = nodeSampleCounts[nodeId];
+        if (timing.sampleCount != lastSampleCount) {
+            totalMs += timing.avgMs;
+            lastSampleCount = timing.sampleCount;
+        }
+    }
+    return totalMs;
+}
+
+bool QualityGovernor::update(float cpuFrameMs, const FrameGraphExecution::NodeTimestampProfiler& nodeProfiler) {
+    if (!enabled) {
+        return false;
+    }
+    windowCpuMs += cpuFrameMs;
+    if (++windowFrames < QUALITY_GOVERNOR_WINDOW_FRAMES) {
+        return false;
+    }
+    
+    telemetry.windows++;
+    telemetry.lastCpuMs = static_cast<float>(windowCpuMs / windowFrames);
+    telemetry.lastGpuMs = sumWindowGpuTime(nodeProfiler);
+    windowFrames = 0;
+    windowCpuMs = 0.0;
+    if (settling) {
+        settling = false;
+        return false;
+    }
+    if (windowsSinceRestore != UINT32_MAX) {
+        ++windowsSinceRestore;
+    }
+    
+    const float costMs = std::max(telemetry.lastCpuMs, telemetry.lastGpuMs);
+    if (costMs > targetFrameMs * QUALITY_GOVERNOR_DEGRADE_MARGIN) {
+        windowsUnderBudget = 0;
+        if (windowsSinceRestore <= QUALITY_GOVERNOR_RESTORE_WINDOWS) {
+            restoreBackoff = std::min(restoreBackoff * 2, QUALITY_GOVERNOR_MAX_RESTORE_BACKOFF);
+        }
+        windowsSinceRestore = UINT32_MAX;
+        return degrade();
+    }
+    
+    // A restore that held for a while clears the backoff
+    if (windowsSinceRestore != UINT32_MAX && windowsSinceRestore > QUALITY_GOVERNOR_RESTORE_WINDOWS) {
+        restoreBackoff = 1;
+        windowsSinceRestore = UINT32_MAX;
+    }
+    
+    if (costMs < targetFrameMs * QUALITY_GOVERNOR_RESTORE_MARGIN && !history.empty()) {
+        if (++windowsUnderBudget >= QUALITY_GOVERNOR_RESTORE_WINDOWS * restoreBackoff) {
+            windowsUnderBudget = 0;
+            windowsSinceRestore = 0;
+            return restore();
+        }
+        return false;
+    }
+    windowsUnderBudget = 0;
+    return false;
+}
+
+bool QualityGovernor::degrade() {
+    for (uint32_t knob = 0; knob < KNOB_COUNT; ++knob) {
+        if (steps[knob] >= MAX_STEPS[knob]) {
+            continue;
+        }
+        Steps next = steps;
+        next[knob]++;
+        const QualitySettings nextSettings = settingsAt(next);
+        if (nextSettings == settings) {
+            continue;  // Already at the knob's floor (1x MSAA, the stride cap, density LOD off)
+        }
+        
+        const QualitySettings previous = settings;
+        steps = next;
+        settings = nextSettings;
+        history.push_back(static_cast<Knob>(knob));
+        settling = true;
+        telemetry.degrades++;
+        logDecision("lowering", static_cast<Knob>(knob), previous);
+        return true;
+    }
+    
+    if (!floorReported) {
+        LOG_INFO("QualityGovernor: frame cost " << std::max(telemetry.lastCpuMs, telemetry.lastGpuMs) << "ms over the "
+                 << targetFrameMs << "ms target with every knob at its floor");
+        floorReported = true;
+    }
+    return false;
+}
+
+bool QualityGovernor::restore() {
+    const Knob knob = history.back();
+    history.pop_back();
+    
+    const QualitySettings previous = settings;
+    floorReported = false;
+    steps[static_cast<uint32_t>(knob)]--;
+    settings = settingsAt(steps);
+    settling = true;
+    telemetry.restores++;
+    logDecision("raising", knob, previous);
+    return true;
+}
+
+void QualityGovernor::logDecision(const char* action, Knob knob, const QualitySettings& previous) const {
+    Logger::getInstance().write(LogLevel::Info, 0, [&](std::ostream& out) {
+        out << "QualityGovernor: CPU " << telemetry.lastCpuMs << "ms, GPU " << telemetry.lastGpuMs << "ms against "
+            << targetFrameMs << "ms, " << action << " " << getKnobName(knob) << " ";
+        printKnobValue(out, knob, previous);
+        out << " -> ";
+        printKnobValue(out, knob, settings);
+        if (restoreBackoff > 1) {
+            out << " (restores wait " << QUALITY_GOVERNOR_RESTORE_WINDOWS * restoreBackoff << " windows)";
+        }
+    });
+}
@@ -0,0 +1,109 @@
+#pragma once
+
+#include "../rendering/frame_graph_types.h"
+#include "../core/vulkan_constants.h"
+#include <array>
+#include <cstdint>
+#include <unordered_map>
+#include <vector>
+
+namespace FrameGraphExecution {
+class NodeTimestampProfiler;
+}
+
+// Knob values the governor trades for frame time; VulkanRenderer applies them to the compute pipeline features,
+// the swapchain and, through RenderFrameDirector, the culling and physics nodes
+struct QualitySettings {
+    uint32_t collisionStride = PHYSICS_COLLISION_STRIDE;  // 0 = PhysicsComputeNode adapts it itself, left alone
+    float renderScale = DEFAULT_RENDER_SCALE;
+    uint32_t msaaSamples = static_cast<uint32_t>(DEFAULT_MSAA_SAMPLES);
+    float densityLodThreshold = ENTITY_LOD_PIXEL_THRESHOLD;
+    float idleSpeed = PHYSICS_IDLE_SPEED;
+    
+    bool operator==(const QualitySettings& other) const = default;
+};
+
+// Adaptive quality: holds a frame time target by stepping knobs down from the baseline settings in priority order
+// and back up in reverse. Every QUALITY_GOVERNOR_WINDOW_FRAMES frames it takes the longer of the window's average
+// CPU frame time and the sum of the node GPU times measured in it as the frame's cost; one step is taken per window,
+// only outside the band between the restore and degrade margins, and a window after each change is skipped while
+// the timings, which arrive frames-in-flight late, catch up. A restore that has to be undone straight away doubles
+// the windows the next one waits, so a knob on the edge of the budget does not flip back and forth. Disabled it
+// reports the baseline unchanged, for benchmarks.
+class QualityGovernor {
+public:
+    enum class Knob : uint32_t {
+        CollisionStride,  // Doubles up to PHYSICS_MAX_COLLISION_STRIDE
+        RenderScale,      // 0.85, 0.7 then 0.5 of the baseline, not below MIN_RENDER_SCALE
+        Msaa,             // Halves down to 1x
+        DensityLod,       // Doubles the pixel threshold, so the heat map takes over zoomed in further
+        IdleSpeed,        // Quadruples the physics idle speed, so slow entities sleep sooner
+        Count
+    };
+    static constexpr uint32_t KNOB_COUNT = static_cast<uint32_t>(Knob::Count);
+    
+    QualityGovernor() = default;
+    ~QualityGovernor() = default;
+    
+    // Off returns to the baseline at once and keeps it
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled; }
+    
+    void setTargetFrameTime(float milliseconds) { targetFrameMs = milliseconds; }
+    float getTargetFrameTime() const { return targetFrameMs; }
+    
+    // What the command line and runtime controls asked for; the governor never goes above it
+    void setBaseline(const QualitySettings& settings);
+    const QualitySettings& getBaseline() const { return baseline; }
+    
+    // Call once per frame with its CPU time and the node timings as of that frame; true when getSettings() changed
+    bool update(float cpuFrameMs, const FrameGraphExecution::NodeTimestampProfiler& nodeProfiler);
+    const QualitySettings& getSettings() const { return settings; }
+    
+    // Steps each knob is below its baseline
+    uint32_t getStep(Knob knob) const { return steps[static_cast<uint32_t>(knob)]; }
+    static const char* getKnobName(Knob knob);
+    
+    // Totals since the governor was created
+    struct Telemetry {
+        uint64_t windows = 0;
+        uint64_t degrades = 0;
+        uint64_t restores = 0;
+        float lastCpuMs = 0.0f;   // Averages of the last window
+        float lastGpuMs = 0.0f;
+    };
+    const Telemetry& getTelemetry() const { return telemetry; }
+
+private:
+    using Steps = std::array<uint32_t, KNOB_COUNT>;
+    
+    QualitySettings settingsAt(const Steps& knobSteps) const;
+    
+    // Summed average GPU time of the nodes timed since the last window
+    float sumWindowGpuTime(const FrameGraphExecution::NodeTimestampProfiler& nodeProfiler);
+    
+    bool degrade();
+    bool restore();
+    void logDecision(const char* action, Knob knob, const QualitySettings& previous) const;
+    
+    bool enabled = ENABLE_QUALITY_GOVERNOR;
+    float targetFrameMs = QUALITY_GOVERNOR_UNCAPPED_TARGET_MS;
+    QualitySettings baseline;
+    QualitySettings settings;
+    Steps steps{};
+    
+    // Knobs in the order they were stepped down, so restores undo the latest first
+    std::vector<Knob> history;
+    
+    // Window state
+    uint32_t windowFrames = 0;
+    double windowCpuMs = 0.0;
+    std::unordered_map<FrameGraphTypes::NodeId, uint64_t> nodeSampleCounts;  // Sample count each node was last summed at
+    bool settling = true;                 // Skip the window after a change, and the first (pipeline compiles)
+    uint32_t windowsUnderBudget = 0;
+    uint32_t restoreBackoff = 1;
+    uint32_t windowsSinceRestore = UINT32_MAX;
+    bool floorReported = false;           // Over budget with nothing left to lower, logged once
+    
+    Telemetry telemetry;
+};
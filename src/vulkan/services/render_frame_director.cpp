@@ -1,17 +1,37 @@
 #include "render_frame_director.h"
 #include "presentation_surface.h"
+#include "simulation_clock.h"
+#include "camera_latch.h"
+#include "output_window.h"
 #include "../core/vulkan_context.h"
 #include "../core/vulkan_swapchain.h"
 #include "../pipelines/pipeline_system_manager.h"
 #include "../core/vulkan_sync.h"
 #include "../resources/core/resource_coordinator.h"
 #include "../resources/managers/graphics_resource_manager.h"
+#include "../nodes/entity_upload_node.h"
+#include "../nodes/entity_despawn_node.h"
+#include "../nodes/entity_update_node.h"
+#include "../nodes/entity_spawn_node.h"
 #include "../nodes/entity_compute_node.h"
+#include "../nodes/spatial_grid_node.h"
+#include "../nodes/entity_reorder_node.h"
+#include "../nodes/entity_culling_node.h"
+#include "../nodes/entity_bounds_node.h"
+#include "../nodes/spatial_query_node.h"
+#include "../nodes/entity_publish_node.h"
+#include "../nodes/entity_readback_node.h"
 #include "../nodes/physics_compute_node.h"
 #include "../nodes/entity_graphics_node.h"
+#include "../nodes/overdraw_node.h"
+#include "../nodes/debug_overlay_node.h"
+#include "../monitoring/overdraw_monitor.h"
+#include "../nodes/performance_hud_node.h"
+#include "../nodes/swapchain_capture_node.h"
 #include "../nodes/swapchain_present_node.h"
 #include "../../ecs/gpu/gpu_entity_manager.h"
-#include <iostream>
+#include "../../ecs/utilities/logger.h"
+#include <algorithm>
 
 RenderFrameDirector::RenderFrameDirector() {
 }
@@ -54,31 +74,117 @@ RenderFrameResult RenderFrameDirector::directFrame(
     flecs::world* world
 ) {
     RenderFrameResult result;
+    const bool presentFrame = presenting || !frameGraphInitialized;
 
-    // 1. Acquire swapchain image using PresentationSurface
-    SurfaceAcquisitionResult acquisitionResult = presentationSurface->acquireNextImage(currentFrame);
-    if (!acquisitionResult.success) {
-        if (acquisitionResult.recreationNeeded) {
-            std::cout << "RenderFrameDirector: Swapchain recreation needed, skipping frame" << std::endl;
-        }
-        return result; // Failed to acquire image
-    }
-    result.imageIndex = acquisitionResult.imageIndex;
-
-    // 2. Setup frame graph
-    setupFrameGraph(result.imageIndex);
+    // 1. Setup frame graph; nothing before graphics recording depends on which swapchain image is drawn
+    setupFrameGraph();
 
-    // 3. Compile frame graph (don't execute yet)
+    // 2. Compile frame graph (don't execute yet)
     if (!compileFrameGraph(currentFrame, totalTime, deltaTime, frameCounter)) {
         return result;
     }
 
-    // 4. Configure frame graph nodes with world reference after swapchain acquisition
-    configureFrameGraphNodes(result.imageIndex, world);
-
-    // 5. Execute frame graph with timing data and global frame counter
+    // 3. Record compute with timing data and global frame counter
     uint32_t globalFrame = globalFrameCounter_.fetch_add(1, std::memory_order_relaxed);
-    result.executionResult = frameGraph->execute(currentFrame, totalTime, deltaTime, globalFrame);
+    SimulationStep simulation;
+    if (simulationClock) {
+        simulation = simulationClock->advance(deltaTime);
+    } else {
+        simulation.firstTick = globalFrame;
+        simulation.tickSeconds = deltaTime;
+    }
+    frameGraph->setSimulationStep(simulation);
+    frameGraph->setPresenting(presentFrame);
+    
+    // Output windows acquire before the node predicates are evaluated, without waiting: a window with no image
+    // ready skips this frame, and one acquired for a frame that goes out compute-only is kept for the next
+    for (size_t output = 0; output < outputGraphicsNodeIds.size(); ++output) {
+        if (auto* outputNode = frameGraph->getNode<EntityGraphicsNode>(outputGraphicsNodeIds[output])) {
+            outputNode->setTargetAcquired(presentFrame && outputWindows[output]->acquire());
+        }
+    }
+    
+    if (frameCameraVersion != cameraVersion) {
+        // Output windows take the culling views after the main window's
+        const size_t mainViewLimit = MAX_RENDER_VIEWPORTS - outputWindows.size();
+        if (viewportCameras.empty()) {
+            frameViewportCameras.assign(1, ViewportCamera{glm::vec4(0.0f, 0.0f, 1.0f, 1.0f), cameraView, cameraProjection, cameraViewProjection});
+        } else {
+            frameViewportCameras.assign(
+                viewportCameras.begin(), viewportCameras.begin() + std::min(viewportCameras.size(), mainViewLimit));
+        }
+        buildOutputWindowCameras();
+        frameCameraVersion = cameraVersion;
+    }
+    if (cameraLatch) {
+        cameraLatch->clearTargets();
+    }
+    OverdrawMonitor* const frameOverdrawMonitor = overdrawDiagnosticEnabled ? overdrawMonitor : nullptr;
+    if (auto* graphicsNode = frameGraph->getNode<EntityGraphicsNode>(graphicsNodeId)) {
+        graphicsNode->setInterpolationAlpha(simulation.interpolationAlpha);
+        graphicsNode->setViewportCameras(frameViewportCameras, cameraVersion);
+        graphicsNode->setCameraLatch(cameraLatch);
+        graphicsNode->setOverdrawMonitor(frameOverdrawMonitor);
+    }
+    for (size_t output = 0; output < outputGraphicsNodeIds.size(); ++output) {
+        if (auto* outputNode = frameGraph->getNode<EntityGraphicsNode>(outputGraphicsNodeIds[output])) {
+            outputNode->setInterpolationAlpha(simulation.interpolationAlpha);
+            outputNode->setViewportCameras(frameOutputCameras[output], cameraVersion);
+            outputNode->setViewportBase(static_cast<uint32_t>(frameViewportCameras.size() + output));
+        }
+    }
+    if (auto* overdrawNode = frameGraph->getNode<OverdrawNode>(overdrawNodeId)) {
+        overdrawNode->setOverdrawMonitor(frameOverdrawMonitor);
+    }
+    if (auto* debugOverlayNode = frameGraph->getNode<DebugOverlayNode>(debugOverlayNodeId)) {
+        debugOverlayNode->setEnabled(debugOverlayEnabled);
+        debugOverlayNode->setViewportCameras(frameViewportCameras, cameraVersion);
+    }
+    if (auto* hudNode = frameGraph->getNode<PerformanceHudNode>(hudNodeId)) {
+        hudNode->setStats(performanceHudStats);
+    }
+    if (auto* captureNode = frameGraph->getNode<SwapchainCaptureNode>(captureNodeId)) {
+        captureNode->setVideoRecorder(videoRecorder);
+    }
+    if (auto* cullingNode = frameGraph->getNode<EntityCullingNode>(cullingNodeId)) {
+        cullingNode->setViewportCameras(outputWindows.empty() ? frameViewportCameras : frameCullingCameras, cameraVersion);
+        cullingNode->setRenderHeight(swapchain->getRenderExtent().height);
+        cullingNode->setGridOrderAvailable(simulation.tickCount > 0);
+        cullingNode->setDensityLodThreshold(densityLodThreshold);
+    }
+    if (auto* physicsNode = frameGraph->getNode<PhysicsComputeNode>(physicsNodeId)) {
+        physicsNode->setIdleSpeed(physicsIdleSpeed);
+    }
+    result.executionResult = frameGraph->executeCompute(currentFrame, totalTime, deltaTime, globalFrame);
+    
+    // 4. Acquire the swapchain image only now, so the CPU records compute while the presentation engine still
+    //    holds the images instead of blocking first; compute-only frames acquire nothing
+    if (result.executionResult.graphicsCommandBufferUsed) {
+        SurfaceAcquisitionResult acquisitionResult = presentationSurface->acquireNextImage(
+            currentFrame, sync->getImageAvailableSemaphore(currentFrame));
+        if (!acquisitionResult.success) {
+            result.acquireResult = acquisitionResult.result;
+            if (acquisitionResult.result == VK_ERROR_DEVICE_LOST) {
+                return result;
+            }
+            
+            // Compute nodes already consumed this frame's uploads and ticks, so a retry would run them twice;
+            // the frame goes out compute-only and the swapchain is recreated after it
+            LOG_INFO("RenderFrameDirector: Swapchain image unavailable (" << acquisitionResult.result
+                     << "), submitting compute only and recreating");
+            result.executionResult.graphicsCommandBufferUsed = false;
+            result.executionResult.graphicsWaitsOnCompute = false;
+            result.swapchainRecreationNeeded = true;
+            result.success = true;
+            return result;
+        }
+        result.imageIndex = acquisitionResult.imageIndex;
+        
+        // 5. Point the graphics nodes at the acquired image, then record (or replay) graphics
+        bindSwapchainImage(result.imageIndex);
+        configureFrameGraphNodes(result.imageIndex, world);
+        frameGraph->recordGraphics(currentFrame, totalTime, deltaTime, result.executionResult);
+    }
     result.success = true;
 
     return result;
@@ -88,27 +194,26 @@ void RenderFrameDirector::updateResourceIds(
     FrameGraphTypes::ResourceId entityBufferId,
     FrameGraphTypes::ResourceId positionBufferId,
     FrameGraphTypes::ResourceId currentPositionBufferId,
-    FrameGraphTypes::ResourceId targetPositionBufferId
+    FrameGraphTypes::ResourceId targetPositionBufferId,
+    FrameGraphTypes::ResourceId spatialMapBufferId,
+    FrameGraphTypes::ResourceId spatialEntryBufferId,
+    FrameGraphTypes::ResourceId spatialIndexBufferId,
+    FrameGraphTypes::ResourceId visibleIndexBufferId,
+    FrameGraphTypes::ResourceId visibleDrawCommandBufferId
 ) {
     this->entityBufferId = entityBufferId;
     this->positionBufferId = positionBufferId;
     this->currentPositionBufferId = currentPositionBufferId;
     this->targetPositionBufferId = targetPositionBufferId;
+    this->spatialMapBufferId = spatialMapBufferId;
+    this->spatialEntryBufferId = spatialEntryBufferId;
+    this->spatialIndexBufferId = spatialIndexBufferId;
+    this->visibleIndexBufferId = visibleIndexBufferId;
+    this->visibleDrawCommandBufferId = visibleDrawCommandBufferId;
 }
 
 
-void RenderFrameDirector::setupFrameGraph(uint32_t imageIndex) {
-    // Only reset frame graph if not already compiled to avoid recompilation every frame
-    bool needsInitialization = !frameGraphInitialized;
-    if (needsInitialization) {
-        frameGraph->reset();
-        
-        // Initialize swapchain image resource ID cache
-        swapchainImageIds.resize(swapchain->getImages().size(), 0);
-        
-        std::cout << "RenderFrameDirector: Initializing frame graph for first time" << std::endl;
-    }
-    
+void RenderFrameDirector::bindSwapchainImage(uint32_t imageIndex) {
     // Import current swapchain image only if not already cached
     if (swapchainImageIds[imageIndex] == 0) {
         VkImage swapchainImage = swapchain->getImages()[imageIndex];
@@ -125,14 +230,97 @@ void RenderFrameDirector::setupFrameGraph(uint32_t imageIndex) {
     
     swapchainImageId = swapchainImageIds[imageIndex];
     
+    // Graphics recordings are kept per frame slot and swapchain image
+    frameGraph->setSwapchainImage(imageIndex, static_cast<uint32_t>(swapchain->getImages().size()));
+}
+
+void RenderFrameDirector::setupFrameGraph() {
+    // Only reset frame graph if not already compiled to avoid recompilation every frame
+    bool needsInitialization = !frameGraphInitialized;
+    if (needsInitialization) {
+        frameGraph->reset();
+        
+        // Initialize swapchain image resource ID cache
+        swapchainImageIds.resize(swapchain->getImages().size(), 0);
+        
+        LOG_INFO("RenderFrameDirector: Initializing frame graph for first time");
+    }
+    
     // Add nodes to frame graph only once during initialization
     if (needsInitialization) {
-        // Movement compute node (sets velocity every 900 frames)
-        computeNodeId = frameGraph->addNode<EntityComputeNode>(
+        // Entity upload node (publishes completed async uploads) - first, so every entity pass orders after it
+        uploadNodeId = frameGraph->addNode<EntityUploadNode>(
             entityBufferId,
             positionBufferId,
             currentPositionBufferId,
             targetPositionBufferId,
+            gpuEntityManager
+        );
+        
+        // Entity despawn node (swap-with-last compaction of removed entities) - before any pass reads slots
+        despawnNodeId = frameGraph->addNode<EntityDespawnNode>(
+            entityBufferId,
+            positionBufferId,
+            currentPositionBufferId,
+            pipelineSystem->getComputeManager(),
+            gpuEntityManager
+        );
+        
+        // Entity update node (sparse writes of ECS edits to resident entities, addressed by spawn ID)
+        updateNodeId = frameGraph->addNode<EntityUpdateNode>(
+            entityBufferId,
+            pipelineSystem->getComputeManager(),
+            gpuEntityManager
+        );
+        
+        // Entity spawn node (GPU-initialised bursts from emitter records, appended after the compaction)
+        spawnNodeId = frameGraph->addNode<EntitySpawnNode>(
+            entityBufferId,
+            positionBufferId,
+            currentPositionBufferId,
+            targetPositionBufferId,
+            pipelineSystem->getComputeManager(),
+            gpuEntityManager
+        );
+        
+        // Movement compute node (sets velocity every 900 frames) - folded into physics when fused
+        const bool fusedMovement = fuseMovementIntoPhysics || closedFormMovement;
+        if (!fusedMovement) {
+            computeNodeId = frameGraph->addNode<EntityComputeNode>(
+                entityBufferId,
+                positionBufferId,
+                currentPositionBufferId,
+                targetPositionBufferId,
+                pipelineSystem->getComputeManager(),
+                gpuEntityManager
+            );
+        }
+        
+        // Spatial grid passes (counting sort of entities into cells for collision queries)
+        // Insertion order matters: the dependency graph orders passes that share buffers as added
+        auto addGridPass = [this](SpatialGridNode::Pass pass) {
+            return frameGraph->addNode<SpatialGridNode>(
+                pass,
+                spatialMapBufferId,
+                spatialEntryBufferId,
+                spatialIndexBufferId,
+                positionBufferId,
+                currentPositionBufferId,
+                pipelineSystem->getComputeManager(),
+                gpuEntityManager
+            );
+        };
+        gridClearNodeId = addGridPass(SpatialGridNode::Pass::Clear);
+        gridCountNodeId = addGridPass(SpatialGridNode::Pass::Count);
+        gridPrefixSumNodeId = addGridPass(SpatialGridNode::Pass::PrefixSum);
+        gridScatterNodeId = addGridPass(SpatialGridNode::Pass::Scatter);
+        
+        // Entity reorder node (periodically permutes entity buffers into grid cell order)
+        reorderNodeId = frameGraph->addNode<EntityReorderNode>(
+            entityBufferId,
+            positionBufferId,
+            currentPositionBufferId,
+            spatialIndexBufferId,
             pipelineSystem->getComputeManager(),
             gpuEntityManager
         );
@@ -143,15 +331,68 @@ void RenderFrameDirector::setupFrameGraph(uint32_t imageIndex) {
             positionBufferId,
             currentPositionBufferId,
             targetPositionBufferId,
+            spatialMapBufferId,
+            spatialIndexBufferId,
+            pipelineSystem->getComputeManager(),
+            gpuEntityManager
+        );
+        if (auto* physicsNode = frameGraph->getNode<PhysicsComputeNode>(physicsNodeId)) {
+            physicsNode->setFusedMovement(fusedMovement);
+            physicsNode->setClosedFormMovement(closedFormMovement);
+        }
+        
+        // Entity culling node (frustum test + compaction into the culled indirect draw)
+        cullingNodeId = frameGraph->addNode<EntityCullingNode>(
+            positionBufferId,
+            spatialIndexBufferId,
+            visibleIndexBufferId,
+            visibleDrawCommandBufferId,
             pipelineSystem->getComputeManager(),
             gpuEntityManager
         );
         
+        // Spatial query node (batched radius / nearest queries over this frame's grid, read back asynchronously)
+        spatialQueryNodeId = frameGraph->addNode<SpatialQueryNode>(
+            entityBufferId,
+            currentPositionBufferId,
+            spatialMapBufferId,
+            spatialIndexBufferId,
+            pipelineSystem->getComputeManager(),
+            gpuEntityManager
+        );
+        
+        // Entity bounds node (live AABB, centroid and count, read back for camera focus)
+        boundsNodeId = frameGraph->addNode<EntityBoundsNode>(
+            positionBufferId,
+            pipelineSystem->getComputeManager(),
+            gpuEntityManager
+        );
+        
+        // Entity publish node (snapshots positions and the culled draw for pipelined async compute)
+        publishNodeId = frameGraph->addNode<EntityPublishNode>(
+            positionBufferId,
+            visibleIndexBufferId,
+            visibleDrawCommandBufferId,
+            gpuEntityManager
+        );
+        
+        // Entity readback node (debug readback copies once physics and the spatial grid are done)
+        readbackNodeId = frameGraph->addNode<EntityReadbackNode>(
+            entityBufferId,
+            positionBufferId,
+            spatialMapBufferId,
+            spatialIndexBufferId,
+            resourceCoordinator
+        );
+        
         // ELEGANT SOLUTION: Pass a dynamic swapchain image reference
         // Nodes will resolve the actual resource ID at execution time
         graphicsNodeId = frameGraph->addNode<EntityGraphicsNode>(
             entityBufferId,
             positionBufferId,
+            targetPositionBufferId,
+            visibleIndexBufferId,
+            visibleDrawCommandBufferId,
             0, // Placeholder - will be resolved dynamically
             pipelineSystem->getGraphicsManager(),
             swapchain,
@@ -159,6 +400,62 @@ void RenderFrameDirector::setupFrameGraph(uint32_t imageIndex) {
             gpuEntityManager
         );
         
+        // Display wall windows: a graphics node each, drawing its own view into its own swapchain. No late latch,
+        // and entity picks are left to the main window's node
+        outputGraphicsNodeIds.clear();
+        for (OutputWindow* output : outputWindows) {
+            outputGraphicsNodeIds.push_back(frameGraph->addNode<EntityGraphicsNode>(
+                entityBufferId,
+                positionBufferId,
+                targetPositionBufferId,
+                visibleIndexBufferId,
+                visibleDrawCommandBufferId,
+                0, // Not a frame graph resource - the output window acquires and presents its images
+                pipelineSystem->getGraphicsManager(),
+                output->getSwapchain(),
+                resourceCoordinator,
+                gpuEntityManager
+            ));
+        }
+        
+        // Reduces the main graphics node's overdraw counts and draws them over its output, below the debug overlay.
+        // The count image is outside the frame graph: only the write-after-write edge on the swapchain image
+        // orders this node after the main graphics node, so it must stay added after it and on the graphics queue
+        overdrawNodeId = frameGraph->addNode<OverdrawNode>(
+            0, // Placeholder - will be resolved dynamically
+            pipelineSystem->getComputeManager(),
+            pipelineSystem->getGraphicsManager(),
+            swapchain,
+            resourceCoordinator
+        );
+        
+        // Draws over the graphics node's output straight from the entity buffers, below the HUD
+        debugOverlayNodeId = frameGraph->addNode<DebugOverlayNode>(
+            entityBufferId,
+            positionBufferId,
+            spatialMapBufferId,
+            0, // Placeholder - will be resolved dynamically
+            pipelineSystem->getGraphicsManager(),
+            swapchain,
+            resourceCoordinator,
+            gpuEntityManager
+        );
+        
+        // Draws over the graphics node's output, so it must be added between it and the present node
+        hudNodeId = frameGraph->addNode<PerformanceHudNode>(
+            0, // Placeholder - will be resolved dynamically
+            pipelineSystem->getGraphicsManager(),
+            swapchain,
+            resourceCoordinator
+        );
+        
+        // Copies the finished image, HUD included, so it must come after the HUD node
+        captureNodeId = frameGraph->addNode<SwapchainCaptureNode>(
+            0, // Placeholder - will be resolved dynamically
+            pipelineSystem->getComputeManager(),
+            swapchain
+        );
+        
         presentNodeId = frameGraph->addNode<SwapchainPresentNode>(
             0, // Placeholder - will be resolved dynamically  
             swapchain
@@ -166,9 +463,21 @@ void RenderFrameDirector::setupFrameGraph(uint32_t imageIndex) {
         
         // Mark as initialized after nodes are added
         frameGraphInitialized = true;
-        std::cout << "RenderFrameDirector: Created nodes - Compute:" << computeNodeId 
-                  << " Physics:" << physicsNodeId << " Graphics:" << graphicsNodeId 
-                  << " Present:" << presentNodeId << std::endl;
+        LOG_INFO("RenderFrameDirector: Created nodes - Compute:" << (closedFormMovement ? "closed-form" : fusedMovement ? "fused" : std::to_string(computeNodeId))
+                 << " SpatialGrid:" << gridClearNodeId << "-" << gridScatterNodeId
+                 << " Reorder:" << reorderNodeId
+                 << " Physics:" << physicsNodeId << " Culling:" << cullingNodeId
+                 << " Bounds:" << boundsNodeId
+                 << " SpatialQuery:" << spatialQueryNodeId
+                 << " Publish:" << publishNodeId
+                 << " Readback:" << readbackNodeId
+                 << " Graphics:" << graphicsNodeId 
+                 << " Outputs:" << outputGraphicsNodeIds.size()
+                 << " Overdraw:" << overdrawNodeId
+                 << " DebugOverlay:" << debugOverlayNodeId
+                 << " HUD:" << hudNodeId
+                 << " Capture:" << captureNodeId
+                 << " Present:" << presentNodeId);
     }
     
     // Configure nodes with frame-specific data will be done externally
@@ -182,6 +491,33 @@ void RenderFrameDirector::configureFrameGraphNodes(uint32_t imageIndex, flecs::w
         graphicsNode->setWorld(world);
     }
     
+    for (size_t output = 0; output < outputGraphicsNodeIds.size(); ++output) {
+        if (auto* outputNode = frameGraph->getNode<EntityGraphicsNode>(outputGraphicsNodeIds[output])) {
+            outputNode->setImageIndex(outputWindows[output]->getImageIndex());
+            outputNode->setWorld(world);
+        }
+    }
+    
+    if (auto* overdrawNode = frameGraph->getNode<OverdrawNode>(overdrawNodeId)) {
+        overdrawNode->setImageIndex(imageIndex);
+        overdrawNode->setCurrentSwapchainImageId(swapchainImageId); // Dynamic resolution
+    }
+    
+    if (auto* debugOverlayNode = frameGraph->getNode<DebugOverlayNode>(debugOverlayNodeId)) {
+        debugOverlayNode->setImageIndex(imageIndex);
+        debugOverlayNode->setCurrentSwapchainImageId(swapchainImageId); // Dynamic resolution
+    }
+    
+    if (auto* hudNode = frameGraph->getNode<PerformanceHudNode>(hudNodeId)) {
+        hudNode->setImageIndex(imageIndex);
+        hudNode->setCurrentSwapchainImageId(swapchainImageId); // Dynamic resolution
+    }
+    
+    if (auto* captureNode = frameGraph->getNode<SwapchainCaptureNode>(captureNodeId)) {
+        captureNode->setImageIndex(imageIndex);
+        captureNode->setCurrentSwapchainImageId(swapchainImageId); // Dynamic resolution
+    }
+    
     if (auto* presentNode = frameGraph->getNode<SwapchainPresentNode>(presentNodeId)) {
         presentNode->setImageIndex(imageIndex);
         presentNode->setCurrentSwapchainImageId(swapchainImageId); // Dynamic resolution
@@ -212,8 +548,11 @@ void RenderFrameDirector::resetSwapchainCache() {
     // 2. Reset cache for new swapchain size  
     swapchainImageIds.assign(swapchain->getImages().size(), 0);
     
+    // 3. Let compile() rebind handles; an unchanged topology skips the sort and barrier analysis
+    frameGraphNeedsRevalidation = true;
+    
     // Command pool management is now handled by QueueManager - no manual recreation needed
-    std::cout << "RenderFrameDirector: Swapchain cache reset complete (QueueManager handles command pools)" << std::endl;
+    LOG_INFO("RenderFrameDirector: Swapchain cache reset complete (QueueManager handles command pools)");
     
     // 4. CRITICAL FIX: Update BOTH graphics AND compute descriptor sets after swapchain recreation
     // This fixes the second window resize crash by ensuring all descriptor sets have valid buffer bindings
@@ -226,34 +565,103 @@ void RenderFrameDirector::resetSwapchainCache() {
             bool computeSuccess = gpuEntityManager->getDescriptorManager().recreateDescriptorSets();
             
             if (graphicsSuccess && computeSuccess) {
-                std::cout << "RenderFrameDirector: Successfully updated graphics AND compute descriptor sets after swapchain recreation" << std::endl;
+                LOG_INFO("RenderFrameDirector: Successfully updated graphics AND compute descriptor sets after swapchain recreation");
             } else {
-                std::cerr << "RenderFrameDirector: ERROR - Failed to update descriptor sets after swapchain recreation!" << std::endl;
-                std::cerr << "  Graphics descriptor sets: " << (graphicsSuccess ? "SUCCESS" : "FAILED") << std::endl;
-                std::cerr << "  Compute descriptor sets: " << (computeSuccess ? "SUCCESS" : "FAILED") << std::endl;
+                LOG_ERROR("RenderFrameDirector: ERROR - Failed to update descriptor sets after swapchain recreation!");
+                LOG_ERROR("  Graphics descriptor sets: " << (graphicsSuccess ? "SUCCESS" : "FAILED"));
+                LOG_ERROR("  Compute descriptor sets: " << (computeSuccess ? "SUCCESS" : "FAILED"));
             }
         } else {
-            std::cerr << "RenderFrameDirector: WARNING - Invalid entity or position buffer during swapchain recreation" << std::endl;
-            std::cerr << "  Movement params buffer: " << (movementParamsBuffer != VK_NULL_HANDLE ? "VALID" : "NULL") << std::endl;
-            std::cerr << "  Position buffer: " << (positionBuffer != VK_NULL_HANDLE ? "VALID" : "NULL") << std::endl;
+            LOG_WARNING("RenderFrameDirector: WARNING - Invalid entity or position buffer during swapchain recreation");
+            LOG_ERROR("  Movement params buffer: " << (movementParamsBuffer != VK_NULL_HANDLE ? "VALID" : "NULL"));
+            LOG_ERROR("  Position buffer: " << (positionBuffer != VK_NULL_HANDLE ? "VALID" : "NULL"));
         }
     } else {
-        std::cerr << "RenderFrameDirector: WARNING - Missing gpuEntityManager or resourceCoordinator during swapchain recreation" << std::endl;
+        LOG_WARNING("RenderFrameDirector: WARNING - Missing gpuEntityManager or resourceCoordinator during swapchain recreation");
     }
     
     // 5. Invalidate any node-local caches that depend on swapchain/render pass
     if (auto* graphicsNode = frameGraph->getNode<EntityGraphicsNode>(graphicsNodeId)) {
         graphicsNode->invalidateCachedState();
+    }
+    if (auto* overdrawNode = frameGraph->getNode<OverdrawNode>(overdrawNodeId)) {
+        overdrawNode->invalidateCachedState();
+    }
+    if (overdrawMonitor) {
+        overdrawMonitor->invalidateCountImage();  // The old count image went with the swapchain
+    }
+    if (auto* debugOverlayNode = frameGraph->getNode<DebugOverlayNode>(debugOverlayNodeId)) {
+        debugOverlayNode->invalidateCachedState();
     }
+    if (auto* hudNode = frameGraph->getNode<PerformanceHudNode>(hudNodeId)) {
+        hudNode->invalidateCachedState();
+    }
+    if (auto* captureNode = frameGraph->getNode<SwapchainCaptureNode>(captureNodeId)) {
+        captureNode->invalidateCachedState();
+    }
 
     // 6. That's it! Next frame will naturally import new images
     // No forced rebuilds, no stale references, no complexity
 }
 
+void RenderFrameDirector::resetOutputWindowCache() {
+    for (FrameGraphTypes::NodeId outputNodeId : outputGraphicsNodeIds) {
+        if (auto* outputNode = frameGraph->getNode<EntityGraphicsNode>(outputNodeId)) {
+            outputNode->invalidateCachedState();
+        }
+    }
+    
+    // New extents move the wall tiles, and recordings may still name the old swapchains' images
+    ++cameraVersion;
+    frameGraph->invalidateRecordedCommands();
+}
+
+void RenderFrameDirector::buildOutputWindowCameras() {
+    frameOutputCameras.resize(outputWindows.size());
+    if (outputWindows.empty()) {
+        return;
+    }
+    frameCullingCameras = frameViewportCameras;
+    
+    // The windows stand side by side at the height of the first: together they show the main window's first view
+    // widened to their combined aspect, each window its share by pixel width
+    const ViewportCamera& mainView = frameViewportCameras.front();
+    const VkExtent2D renderExtent = swapchain->getRenderExtent();
+    const float projectionAspect = static_cast<float>(renderExtent.width) * mainView.rect.z /
+                                   std::max(static_cast<float>(renderExtent.height) * mainView.rect.w, 1.0f);
+    float wallWidth = 0.0f;
+    float wallHeight = 0.0f;
+    for (OutputWindow* output : outputWindows) {
+        if (output->isAvailable()) {
+            wallWidth += static_cast<float>(output->getSwapchain()->getExtent().width);
+            if (wallHeight == 0.0f) {
+                wallHeight = static_cast<float>(output->getSwapchain()->getExtent().height);
+            }
+        }
+    }
+    
+    float left = 0.0f;
+    for (size_t output = 0; output < outputWindows.size(); ++output) {
+        ViewportCamera tile;  // Zero matrices for a window no longer drawn
+        if (outputWindows[output]->isAvailable() && wallWidth > 0.0f && wallHeight > 0.0f) {
+            const float width = static_cast<float>(outputWindows[output]->getSwapchain()->getExtent().width) / wallWidth;
+            tile.view = mainView.view;
+            tile.projection = OutputWindow::getWallTileProjection(
+                mainView.projection, projectionAspect, wallWidth / wallHeight, left, width);
+            tile.viewProjection = tile.projection * tile.view;
+            left += width;
+        }
+        frameCullingCameras.push_back(tile);
+        frameOutputCameras[output].assign(1, tile);
+    }
+}
+
 bool RenderFrameDirector::compileFrameGraph(uint32_t currentFrame, float totalTime, float deltaTime, uint32_t frameCounter) {
-    // Compile frame graph only if not already compiled
-    if (!frameGraph->isCompiled() && !frameGraph->compile()) {
-        std::cerr << "RenderFrameDirector: Failed to compile frame graph" << std::endl;
+    // Compile frame graph only if not already compiled, or revalidate it after swapchain recreation
+    const bool needsCompile = !frameGraph->isCompiled() || frameGraphNeedsRevalidation;
+    frameGraphNeedsRevalidation = false;
+    if (needsCompile && !frameGraph->compile()) {
+        LOG_ERROR("RenderFrameDirector: Failed to compile frame graph");
         return false;
     }
     
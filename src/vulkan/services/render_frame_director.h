@@ -7,6 +7,7 @@
 #include <flecs.h>
 #include "../core/vulkan_constants.h"
 #include "../rendering/frame_graph.h"
+#include "../rendering/viewport_camera.h"
 
 // Forward declarations
 class VulkanContext;
@@ -16,10 +17,18 @@ class ResourceCoordinator;
 class GPUEntityManager;
 class PipelineSystemManager;
 class PresentationSurface;
+class SimulationClock;
+class CameraLatch;
+struct PerformanceHudStats;
+class VideoRecorder;
+class OutputWindow;
+class OverdrawMonitor;
 
 struct RenderFrameResult {
     bool success = false;
     uint32_t imageIndex = 0;
+    VkResult acquireResult = VK_SUCCESS;  // Set when image acquisition failed
+    bool swapchainRecreationNeeded = false;  // No image after compute was recorded: submitted compute-only
     FrameGraph::ExecutionResult executionResult;
 };
 
@@ -55,7 +64,12 @@ public:
         FrameGraphTypes::ResourceId entityBufferId,
         FrameGraphTypes::ResourceId positionBufferId,
         FrameGraphTypes::ResourceId currentPositionBufferId,
-        FrameGraphTypes::ResourceId targetPositionBufferId
+        FrameGraphTypes::ResourceId targetPositionBufferId,
+        FrameGraphTypes::ResourceId spatialMapBufferId,
+        FrameGraphTypes::ResourceId spatialEntryBufferId,
+        FrameGraphTypes::ResourceId spatialIndexBufferId,
+        FrameGraphTypes::ResourceId visibleIndexBufferId,
+        FrameGraphTypes::ResourceId visibleDrawCommandBufferId
     );
 
     // Node configuration after setup
@@ -63,6 +77,62 @@ public:
     
     // Swapchain recreation support
     void resetSwapchainCache();
+    // After output windows were recreated: rebuilds their wall tiles and drops their cached state and recordings
+    void resetOutputWindowCache();
+    
+    // Display wall windows (not owned), set before the first frame: each gets its own graphics node, drawing one
+    // culling view that continues the main camera to the right of the previous window (OutputWindow)
+    void setOutputWindows(const std::vector<OutputWindow*>& windows) { outputWindows = windows; }
+    
+    // Frame graph options - take effect when nodes are first created. Fused movement walks every entity randomly,
+    // whatever its MovementType
+    void setFuseMovementIntoPhysics(bool fuse) { fuseMovementIntoPhysics = fuse; }
+    // Closed-form movement fuses too, physics evaluating the walk's velocity rather than storing it
+    void setClosedFormMovement(bool closedForm) { closedFormMovement = closedForm; }
+    
+    // Source of each frame's simulation ticks (not owned); without one every frame is a single variable step
+    void setSimulationClock(SimulationClock* clock) { simulationClock = clock; }
+    
+    // Late latch the graphics node registers its camera UBO entries with (not owned); its targets are cleared
+    // at the start of every frame, so a frame that draws nothing leaves none behind
+    void setCameraLatch(CameraLatch* latch) { cameraLatch = latch; }
+    
+    // Camera for the next frames, handed to the graphics and culling nodes before each execution. Both setters
+    // bump the camera version the nodes key their per-camera work on, so call them only when the camera changed
+    void setCameraMatrices(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection) {
+        cameraView = view;
+        cameraProjection = projection;
+        cameraViewProjection = viewProjection;
+        ++cameraVersion;
+    }
+    
+    // Per-viewport cameras for the next frames; empty draws the camera above over the whole render target
+    void setViewportCameras(const std::vector<ViewportCamera>& cameras) {
+        viewportCameras = cameras;
+        ++cameraVersion;
+    }
+    
+    // QualityGovernor's density LOD threshold and physics idle speed, handed to the culling and physics nodes each frame
+    void setDensityLodThreshold(float pixels) { densityLodThreshold = pixels; }
+    void setPhysicsIdleSpeed(float speed) { physicsIdleSpeed = speed; }
+    
+    // Spatial grid occupancy and entity bounds drawn by DebugOverlayNode over the next frames
+    void setDebugOverlayEnabled(bool enabled) { debugOverlayEnabled = enabled; }
+    
+    // Overdraw diagnostic (not owned, null without fragment stores): while enabled the main window's entity pass
+    // counts into it and OverdrawNode reduces and draws the counts over the next frames
+    void setOverdrawMonitor(OverdrawMonitor* monitor) { overdrawMonitor = monitor; }
+    void setOverdrawDiagnosticEnabled(bool enabled) { overdrawDiagnosticEnabled = enabled; }
+    
+    // Figures the performance HUD draws over the next frames (not owned); nullptr hides it
+    void setPerformanceHud(const PerformanceHudStats* stats) { performanceHudStats = stats; }
+    
+    // Recorder the presented frames are captured into (not owned); nullptr stops capturing
+    void setVideoRecorder(VideoRecorder* recorder) { videoRecorder = recorder; }
+    
+    // Off while the window cannot be seen: frames then acquire no swapchain image and run only the compute
+    // nodes. The first frame still presents, since it is the one that builds the frame graph
+    void setPresenting(bool enabled) { presenting = enabled; }
 
 private:
     // Dependencies
@@ -74,29 +144,80 @@ private:
     GPUEntityManager* gpuEntityManager = nullptr;
     FrameGraph* frameGraph = nullptr;
     PresentationSurface* presentationSurface = nullptr;
+    SimulationClock* simulationClock = nullptr;
+    CameraLatch* cameraLatch = nullptr;
+    const PerformanceHudStats* performanceHudStats = nullptr;
+    bool debugOverlayEnabled = false;
+    OverdrawMonitor* overdrawMonitor = nullptr;
+    bool overdrawDiagnosticEnabled = false;
+    VideoRecorder* videoRecorder = nullptr;
+    std::vector<OutputWindow*> outputWindows;
+    
+    glm::mat4 cameraView{0.0f};
+    glm::mat4 cameraProjection{0.0f};
+    glm::mat4 cameraViewProjection{0.0f};
+    std::vector<ViewportCamera> viewportCameras;
+    std::vector<ViewportCamera> frameViewportCameras;  // What this frame's nodes draw, reused across frames
+    std::vector<ViewportCamera> frameCullingCameras;   // With output windows: the main views, then one per window
+    std::vector<std::vector<ViewportCamera>> frameOutputCameras;  // Each output window's single view
+    uint64_t cameraVersion = 1;
+    uint64_t frameCameraVersion = 0;                   // cameraVersion frameViewportCameras was built from
+    float densityLodThreshold = ENTITY_LOD_PIXEL_THRESHOLD;
+    float physicsIdleSpeed = PHYSICS_IDLE_SPEED;
 
     // Resource IDs
     FrameGraphTypes::ResourceId entityBufferId = 0;
     FrameGraphTypes::ResourceId positionBufferId = 0;
     FrameGraphTypes::ResourceId currentPositionBufferId = 0;
     FrameGraphTypes::ResourceId targetPositionBufferId = 0;
+    FrameGraphTypes::ResourceId spatialMapBufferId = 0;
+    FrameGraphTypes::ResourceId spatialEntryBufferId = 0;
+    FrameGraphTypes::ResourceId spatialIndexBufferId = 0;
+    FrameGraphTypes::ResourceId visibleIndexBufferId = 0;
+    FrameGraphTypes::ResourceId visibleDrawCommandBufferId = 0;
     FrameGraphTypes::ResourceId swapchainImageId = 0;
     
     // State management
     bool frameGraphInitialized = false;
+    bool frameGraphNeedsRevalidation = false; // Swapchain recreated since the last compile() call
+    bool presenting = true;
+    bool fuseMovementIntoPhysics = FUSE_MOVEMENT_INTO_PHYSICS && !ENABLE_MOVEMENT_TYPE_DISPATCH;
+    bool closedFormMovement = false;
     std::vector<FrameGraphTypes::ResourceId> swapchainImageIds; // Cached per swapchain image
     
     // Global frame counter for compute shader consistency
     std::atomic<uint32_t> globalFrameCounter_{0};
     
     // Node IDs for configuration
+    FrameGraphTypes::NodeId uploadNodeId = 0;
+    FrameGraphTypes::NodeId despawnNodeId = 0;
+    FrameGraphTypes::NodeId updateNodeId = 0;
+    FrameGraphTypes::NodeId spawnNodeId = 0;
     FrameGraphTypes::NodeId computeNodeId = 0;
+    FrameGraphTypes::NodeId gridClearNodeId = 0;
+    FrameGraphTypes::NodeId gridCountNodeId = 0;
+    FrameGraphTypes::NodeId gridPrefixSumNodeId = 0;
+    FrameGraphTypes::NodeId gridScatterNodeId = 0;
+    FrameGraphTypes::NodeId reorderNodeId = 0;
     FrameGraphTypes::NodeId physicsNodeId = 0;
+    FrameGraphTypes::NodeId cullingNodeId = 0;
+    FrameGraphTypes::NodeId boundsNodeId = 0;
+    FrameGraphTypes::NodeId spatialQueryNodeId = 0;
+    FrameGraphTypes::NodeId publishNodeId = 0;
+    FrameGraphTypes::NodeId readbackNodeId = 0;
     FrameGraphTypes::NodeId graphicsNodeId = 0;
+    FrameGraphTypes::NodeId overdrawNodeId = 0;
+    FrameGraphTypes::NodeId debugOverlayNodeId = 0;
+    FrameGraphTypes::NodeId hudNodeId = 0;
+    FrameGraphTypes::NodeId captureNodeId = 0;
     FrameGraphTypes::NodeId presentNodeId = 0;
+    std::vector<FrameGraphTypes::NodeId> outputGraphicsNodeIds;  // One per output window
 
     // Helper methods
-    void setupFrameGraph(uint32_t imageIndex);
+    void setupFrameGraph();
+    void bindSwapchainImage(uint32_t imageIndex);
     void configureNodes(FrameGraphTypes::NodeId graphicsNodeId, FrameGraphTypes::NodeId presentNodeId, uint32_t imageIndex, flecs::world* world);
     bool compileFrameGraph(uint32_t currentFrame, float totalTime, float deltaTime, uint32_t frameCounter);
+    // Appends the output windows' wall tiles of the main window's first view to frameCullingCameras
+    void buildOutputWindowCameras();
 };
\ No newline at end of file
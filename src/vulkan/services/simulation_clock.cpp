@@ -0,0 +1,63 @@
+#include "simulation_clock.h"
+#include <algorithm>
+#include <cmath>
+
+void SimulationClock::setTickRate(uint32_t ticksPerSecond) {
+    tickRate = ticksPerSecond;
+    tickSeconds = ticksPerSecond > 0 ? 1.0 / ticksPerSecond : 0.0;
+    accumulator = 0.0;
+}
+
+void SimulationClock::fastForward(float seconds, uint32_t ticksPerFrame) {
+    const double length = isFixedStep() ? tickSeconds : 1.0 / SIMULATION_TICK_RATE;
+    fastForwardTicks = static_cast<uint32_t>(std::ceil(std::max(0.0f, seconds) / length));
+    fastForwardTicksPerFrame = std::clamp(ticksPerFrame, 1u, MAX_SIMULATION_FAST_FORWARD_TICKS_PER_FRAME);
+}
+
+SimulationStep SimulationClock::advance(float deltaTime) {
+    SimulationStep step;
+    step.firstTick = nextTick;
+    telemetry.frames++;
+    
+    if (fastForwardTicks > 0) {
+        const uint32_t ticks = std::min(fastForwardTicks, fastForwardTicksPerFrame);
+        fastForwardTicks -= ticks;
+        accumulator = 0.0;
+        step.tickCount = ticks;
+        step.tickSeconds = static_cast<float>(isFixedStep() ? tickSeconds : 1.0 / SIMULATION_TICK_RATE);
+        step.interpolationAlpha = 1.0f;
+        nextTick += ticks;
+        telemetry.ticks += ticks;
+        telemetry.fastForwardTicks += ticks;
+        return step;
+    }
+    
+    if (!isFixedStep()) {
+        step.tickCount = 1;
+        step.tickSeconds = deltaTime;
+        step.interpolationAlpha = 1.0f;
+        nextTick++;
+        telemetry.ticks++;
+        return step;
+    }
+    
+    accumulator += std::max(0.0f, deltaTime);
+    uint32_t ticks = static_cast<uint32_t>(std::floor(accumulator / tickSeconds));
+    accumulator -= ticks * tickSeconds;
+    
+    // Catching up on a long stall would make the following frames slower still
+    if (ticks > MAX_SIMULATION_TICKS_PER_FRAME) {
+        telemetry.droppedTicks += ticks - MAX_SIMULATION_TICKS_PER_FRAME;
+        ticks = MAX_SIMULATION_TICKS_PER_FRAME;
+    }
+    
+    step.tickCount = ticks;
+    step.tickSeconds = static_cast<float>(tickSeconds);
+    step.interpolationAlpha = static_cast<float>(std::clamp(accumulator / tickSeconds, 0.0, 1.0));
+    nextTick += ticks;
+    telemetry.ticks += ticks;
+    if (ticks == 0) {
+        telemetry.idleFrames++;
+    }
+    return step;
+}
@@ -0,0 +1,54 @@
+#pragma once
+
+#include "../rendering/frame_graph_types.h"
+#include "../core/vulkan_constants.h"
+#include <cstdint>
+
+// Fixed-step simulation timing. Frame time accumulates and is spent in whole ticks of 1 / tick rate seconds, so
+// movement and physics advance at the same rate whatever the frame rate: a slow frame runs several ticks, a fast
+// one none, and the leftover fraction becomes the render interpolation alpha. At most
+// MAX_SIMULATION_TICKS_PER_FRAME run per frame; time beyond that is dropped rather than caught up later.
+// Tick rate 0 is variable step: one tick per frame, integrated over the frame's deltaTime. While fast-forwarding
+// every frame runs a fixed number of ticks whatever its deltaTime, and the frame time spent doing so is not owed
+// to the simulation afterwards.
+class SimulationClock {
+public:
+    SimulationClock() = default;
+    ~SimulationClock() = default;
+    
+    void setTickRate(uint32_t ticksPerSecond);
+    uint32_t getTickRate() const { return tickRate; }
+    bool isFixedStep() const { return tickRate > 0; }
+    
+    // Ticks for a frame that took deltaTime seconds - call once per frame that executes the frame graph
+    SimulationStep advance(float deltaTime);
+    
+    // Runs the given simulation time in fast-forward frames of ticksPerFrame ticks (clamped to
+    // MAX_SIMULATION_FAST_FORWARD_TICKS_PER_FRAME), at the tick rate or SIMULATION_TICK_RATE under variable step;
+    // a call while fast-forwarding replaces what remains
+    void fastForward(float seconds, uint32_t ticksPerFrame = SIMULATION_FAST_FORWARD_TICKS_PER_FRAME);
+    bool isFastForwarding() const { return fastForwardTicks > 0; }
+    // True when the next advance() leaves fast-forward ticks for later frames, so that frame need not be drawn
+    bool isFastForwardFrameHidden() const { return fastForwardTicks > fastForwardTicksPerFrame; }
+    
+    // Totals since the last resetTelemetry()
+    struct Telemetry {
+        uint64_t frames = 0;
+        uint64_t ticks = 0;
+        uint64_t idleFrames = 0;     // Frames that ran no tick
+        uint64_t droppedTicks = 0;   // Ticks over the per-frame cap, never simulated
+        uint64_t fastForwardTicks = 0;
+    };
+    const Telemetry& getTelemetry() const { return telemetry; }
+    void resetTelemetry() { telemetry = {}; }
+
+private:
+    uint32_t tickRate = ENABLE_FIXED_TIMESTEP_SIMULATION ? SIMULATION_TICK_RATE : 0;
+    double tickSeconds = ENABLE_FIXED_TIMESTEP_SIMULATION ? 1.0 / SIMULATION_TICK_RATE : 0.0;
+    double accumulator = 0.0;
+    uint32_t nextTick = 0;
+    uint32_t fastForwardTicks = 0;  // Left to run
+    uint32_t fastForwardTicksPerFrame = SIMULATION_FAST_FORWARD_TICKS_PER_FRAME;
+    
+    Telemetry telemetry;
+};
@@ -0,0 +1,76 @@
+#include "spatial_cell_tuner.h"
+#include "../../ecs/gpu/entity_buffer_manager.h"
+#include "../../ecs/utilities/logger.h"
+#include <algorithm>
+#include <cmath>
+
+void SpatialCellTuner::setEnabled(bool enable) {
+    enabled = enable;
+    step = 0;
+    cellSize = SPATIAL_CELL_SIZE;
+    windowStart = Clock::time_point{};
+    LOG_INFO("SpatialCellTuner: " << (enabled ? "enabled" : "disabled") << ", cell size " << cellSize);
+}
+
+float SpatialCellTuner::measureOccupancy(const SimulationCounters& counters, uint32_t entityCount) {
+    if (!counters.histogramValid) {
+        return counters.occupiedCells > 0 ? static_cast<float>(entityCount) / counters.occupiedCells : 0.0f;
+    }
+    
+    // Bin b counts cells of [2^(b-1), 2^b) entities, each taken at the middle of its range but not past the largest
+    // cell. Weighting by the entities in a cell gives the occupancy the average narrow phase walks
+    double entities = 0.0;
+    double weighted = 0.0;
+    for (uint32_t bin = 1; bin < SPATIAL_OCCUPANCY_HISTOGRAM_BINS; ++bin) {
+        const double lower = static_cast<double>(1u << (bin - 1));
+        const double occupancy = std::min(lower * 1.5 - 0.5, std::max(lower, static_cast<double>(counters.maxCellOccupancy)));
+        entities += counters.occupancyHistogram[bin] * occupancy;
+        weighted += counters.occupancyHistogram[bin] * occupancy * occupancy;
+    }
+    return entities > 0.0 ? static_cast<float>(weighted / entities) : 0.0f;
+}
+
+bool SpatialCellTuner::update(Clock::time_point now, const SimulationCounters& counters, uint32_t entityCount,
+                              uint32_t cellCapacity) {
+    if (!enabled || !counters.valid) {
+        return false;
+    }
+    if (windowStart == Clock::time_point{}) {
+        windowStart = now;
+        return false;
+    }
+    if (std::chrono::duration<float, std::milli>(now - windowStart).count() < SPATIAL_CELL_TUNER_INTERVAL_MS) {
+        return false;
+    }
+    windowStart = now;
+    
+    telemetry.evaluations++;
+    const float occupancy = measureOccupancy(counters, entityCount);
+    telemetry.lastOccupancy = occupancy;
+    if (occupancy == 0.0f) {
+        return false;
+    }
+    
+    // Halving the cell area roughly halves the occupancy, doubling it doubles the largest cell
+    const bool crowded = occupancy > SPATIAL_CELL_TUNER_HIGH_OCCUPANCY ||
+                         (counters.overflowCells > 0 && occupancy * 0.5f >= SPATIAL_CELL_TUNER_LOW_OCCUPANCY);
+    const bool sparse = occupancy < SPATIAL_CELL_TUNER_LOW_OCCUPANCY && counters.maxCellOccupancy * 2 <= cellCapacity;
+    const int32_t nextStep = crowded ? std::max(step - 1, -SPATIAL_CELL_TUNER_MAX_SHRINK_STEPS)
+                           : sparse ? std::min(step + 1, SPATIAL_CELL_TUNER_MAX_GROW_STEPS)
+                           : step;
+    if (nextStep == step) {
+        return false;
+    }
+    
+    const float previous = cellSize;
+    step = nextStep;
+    cellSize = SPATIAL_CELL_SIZE * std::exp2(0.5f * static_cast<float>(step));
+    if (crowded) {
+        telemetry.shrinks++;
+    } else {
+        telemetry.grows++;
+    }
+    LOG_INFO("SpatialCellTuner: " << occupancy << " entities per cell (largest " << counters.maxCellOccupancy << ", "
+             << counters.overflowCells << " over capacity), cell size " << previous << " -> " << cellSize);
+    return true;
+}
@@ -0,0 +1,51 @@
+#pragma once
+
+#include "../core/vulkan_constants.h"
+#include <chrono>
+#include <cstdint>
+
+struct SimulationCounters;
+
+// Automatic spatial grid cell size (--auto-cell-size). Every SPATIAL_CELL_TUNER_INTERVAL_MS it measures how many
+// entities an average entity shares its cell with - from the occupancy histogram when one is built, otherwise the
+// mean over occupied cells - and scales the cell size by sqrt(2), half or twice the cell area, when that leaves the
+// band between SPATIAL_CELL_TUNER_LOW_OCCUPANCY and SPATIAL_CELL_TUNER_HIGH_OCCUPANCY. Cells over the physics cell
+// capacity also shrink the cells, unless that would take the occupancy under the band. The band is wider than the
+// factor of two one step moves the occupancy by, and growing is held back while it could overflow the largest
+// cell, so a step is not undone by the next; the interval restarts at each change, which gives the counters,
+// read back frames late, time to describe the new grid. Disabled it reports the baseline cell size.
+class SpatialCellTuner {
+public:
+    using Clock = std::chrono::steady_clock;
+    
+    SpatialCellTuner() = default;
+    ~SpatialCellTuner() = default;
+    
+    void setEnabled(bool enabled);
+    bool isEnabled() const { return enabled; }
+    
+    // Call once per frame with the latest counters, the live entity count and the cell capacity physics tests;
+    // true when getCellSize() changed
+    bool update(Clock::time_point now, const SimulationCounters& counters, uint32_t entityCount, uint32_t cellCapacity);
+    float getCellSize() const { return cellSize; }
+    
+    // Totals since the tuner was created
+    struct Telemetry {
+        uint64_t evaluations = 0;
+        uint64_t grows = 0;
+        uint64_t shrinks = 0;
+        float lastOccupancy = 0.0f;   // Entities per cell an average entity saw at the last evaluation
+    };
+    const Telemetry& getTelemetry() const { return telemetry; }
+
+private:
+    // Entity-weighted mean cell occupancy; 0 when nothing was counted
+    static float measureOccupancy(const SimulationCounters& counters, uint32_t entityCount);
+    
+    bool enabled = false;
+    int32_t step = 0;  // Half powers of two from SPATIAL_CELL_SIZE
+    float cellSize = SPATIAL_CELL_SIZE;
+    Clock::time_point windowStart{};
+    
+    Telemetry telemetry;
+};
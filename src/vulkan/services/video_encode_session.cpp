@@ -0,0 +1,764 @@
+#include "video_encode_session.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../../ecs/utilities/logger.h"
+#include <algorithm>
+#include <array>
+
+namespace {
+    constexpr VkFormat PICTURE_FORMAT = VK_FORMAT_G8_B8R8_2PLANE_420_UNORM;  // NV12
+    constexpr uint32_t LOG2_MAX_FRAME_NUM = 8;
+    constexpr uint8_t NO_REFERENCE = STD_VIDEO_H264_NO_REFERENCE_PICTURE;
+    
+    // Feedback query results with VK_QUERY_RESULT_WITH_STATUS_BIT_KHR
+    struct EncodeFeedback {
+        uint32_t bitstreamOffset = 0;
+        uint32_t bytesWritten = 0;
+        int32_t status = 0;
+    };
+    
+    VkDeviceSize alignUp(VkDeviceSize value, VkDeviceSize alignment) {
+        return alignment > 1 ? (value + alignment - 1) / alignment * alignment : value;
+    }
+}
+
+VideoEncodeSession::~VideoEncodeSession() {
+    cleanup();
+}
+
+bool VideoEncodeSession::initialize(const VulkanContext& context, VkExtent2D extent, uint32_t slotCount, uint32_t gopFrames, uint32_t qp) {
+    cleanup();
+    if (!context.supportsVideoEncode() || !context.supportsSynchronization2() || !context.supportsTimelineSemaphores()) {
+        return false;
+    }
+    this->context = &context;
+    this->extent = extent;
+    this->gopFrames = std::max(gopFrames, 1u);
+    this->qp = qp;
+    
+    if (!createSession() || !createParameters() || !createImages() || !createSlots(slotCount)) {
+        cleanup();
+        return false;
+    }
+    if (constantQp) {
+        LOG_INFO("VideoEncodeSession: Encoding " << extent.width << "x" << extent.height << " H.264 " << profileName
+                 << " at constant QP " << this->qp << ", IDR every " << this->gopFrames << " frames");
+    } else {
+        LOG_INFO("VideoEncodeSession: Encoding " << extent.width << "x" << extent.height << " H.264 " << profileName
+                 << " with the encoder's default rate control, IDR every " << this->gopFrames << " frames");
+    }
+    return true;
+}
+
+void VideoEncodeSession::cleanup() {
+    if (!context) {
+        return;
+    }
+    const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
+    
+    for (Slot& slot : slots) {
+        if (slot.sourceView != VK_NULL_HANDLE) vk.vkDestroyImageView(device, slot.sourceView, nullptr);
+        if (slot.sourceImage != VK_NULL_HANDLE) vk.vkDestroyImage(device, slot.sourceImage, nullptr);
+        if (slot.sourceMemory != VK_NULL_HANDLE) vk.vkFreeMemory(device, slot.sourceMemory, nullptr);
+        if (slot.bitstreamBuffer != VK_NULL_HANDLE) vk.vkDestroyBuffer(device, slot.bitstreamBuffer, nullptr);
+        if (slot.bitstreamMemory != VK_NULL_HANDLE) vk.vkFreeMemory(device, slot.bitstreamMemory, nullptr);
+    }
+    slots.clear();
+    feedbackPool.reset();
+    commandPool.reset();  // Frees the slots' command buffers
+    
+    for (VkImageView& view : dpbViews) {
+        if (view != VK_NULL_HANDLE) vk.vkDestroyImageView(device, view, nullptr);
+        view = VK_NULL_HANDLE;
+    }
+    if (dpbImage != VK_NULL_HANDLE) vk.vkDestroyImage(device, dpbImage, nullptr);
+    if (dpbMemory != VK_NULL_HANDLE) vk.vkFreeMemory(device, dpbMemory, nullptr);
+    dpbImage = VK_NULL_HANDLE;
+    dpbMemory = VK_NULL_HANDLE;
+    
+    if (parameters != VK_NULL_HANDLE) vk.vkDestroyVideoSessionParametersKHR(device, parameters, nullptr);
+    if (session != VK_NULL_HANDLE) vk.vkDestroyVideoSessionKHR(device, session, nullptr);
+    for (VkDeviceMemory memory : sessionMemory) {
+        vk.vkFreeMemory(device, memory, nullptr);
+    }
+    sessionMemory.clear();
+    parameters = VK_NULL_HANDLE;
+    session = VK_NULL_HANDLE;
+    parameterBytes.clear();
+    
+    dpbInitialized = false;
+    sessionReset = false;
+    frameNumber = 0;
+    idrId = 0;
+    context = nullptr;
+}
+
+uint32_t VideoEncodeSession::findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const {
+    // VulkanUtils::findMemoryType throws; a recording that cannot allocate is simply not started
+    VkPhysicalDeviceMemoryProperties memoryProperties{};
+    context->getLoader().vkGetPhysicalDeviceMemoryProperties(context->getPhysicalDevice(), &memoryProperties);
+    for (uint32_t i = 0; i < memoryProperties.memoryTypeCount; ++i) {
+        if ((typeBits & (1u << i)) && (memoryProperties.memoryTypes[i].propertyFlags & properties) == properties) {
+            return i;
+        }
+    }
+    return UINT32_MAX;
+}
+
+bool VideoEncodeSession::createSession() {
+    const auto& vk = context->getLoader();
+    const VkPhysicalDevice physicalDevice = context->getPhysicalDevice();
+    
+    // High profile where the encoder has it (8x8 transforms), Main otherwise; both 4:2:0 8-bit progressive
+    constexpr std::array<std::pair<StdVideoH264ProfileIdc, const char*>, 2> candidates = {{
+        {STD_VIDEO_H264_PROFILE_IDC_HIGH, "High"},
+        {STD_VIDEO_H264_PROFILE_IDC_MAIN, "Main"},
+    }};
+    bool found = false;
+    for (const auto& [profileIdc, name] : candidates) {
+        h264Profile = {};
+        h264Profile.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_PROFILE_INFO_KHR;
+        h264Profile.stdProfileIdc = profileIdc;
+        usageInfo = {};
+        usageInfo.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_USAGE_INFO_KHR;
+        usageInfo.pNext = &h264Profile;
+        usageInfo.videoUsageHints = VK_VIDEO_ENCODE_USAGE_RECORDING_BIT_KHR;
+        usageInfo.videoContentHints = VK_VIDEO_ENCODE_CONTENT_RENDERED_BIT_KHR;
+        usageInfo.tuningMode = VK_VIDEO_ENCODE_TUNING_MODE_DEFAULT_KHR;
+        profile = {};
+        profile.sType = VK_STRUCTURE_TYPE_VIDEO_PROFILE_INFO_KHR;
+        profile.pNext = &usageInfo;
+        profile.videoCodecOperation = VK_VIDEO_CODEC_OPERATION_ENCODE_H264_BIT_KHR;
+        profile.chromaSubsampling = VK_VIDEO_CHROMA_SUBSAMPLING_420_BIT_KHR;
+        profile.lumaBitDepth = VK_VIDEO_COMPONENT_BIT_DEPTH_8_BIT_KHR;
+        profile.chromaBitDepth = VK_VIDEO_COMPONENT_BIT_DEPTH_8_BIT_KHR;
+        
+        h264Capabilities = {};
+        h264Capabilities.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_CAPABILITIES_KHR;
+        encodeCapabilities = {};
+        encodeCapabilities.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_CAPABILITIES_KHR;
+        encodeCapabilities.pNext = &h264Capabilities;
+        capabilities = {};
+        capabilities.sType = VK_STRUCTURE_TYPE_VIDEO_CAPABILITIES_KHR;
+        capabilities.pNext = &encodeCapabilities;
+        if (vk.vkGetPhysicalDeviceVideoCapabilitiesKHR(physicalDevice, &profile, &capabilities) == VK_SUCCESS) {
+            profileName = name;
+            found = true;
+            break;
+        }
+    }
+    if (!found) {
+        LOG_INFO("VideoEncodeSession: No supported H.264 encode profile");
+        return false;
+    }
+    
+    profileList = {};
+    profileList.sType = VK_STRUCTURE_TYPE_VIDEO_PROFILE_LIST_INFO_KHR;
+    profileList.profileCount = 1;
+    profileList.pProfiles = &profile;
+    
+    if (extent.width < capabilities.minCodedExtent.width || extent.height < capabilities.minCodedExtent.height ||
+        extent.width > capabilities.maxCodedExtent.width || extent.height > capabilities.maxCodedExtent.height) {
+        LOG_INFO("VideoEncodeSession: " << extent.width << "x" << extent.height << " is outside the encoder's "
+                 << capabilities.maxCodedExtent.width << "x" << capabilities.maxCodedExtent.height << " limit");
+        return false;
+    }
+    if (capabilities.maxDpbSlots < 2 || capabilities.maxActiveReferencePictures < 1) {
+        LOG_INFO("VideoEncodeSession: Encoder has too few DPB slots for P pictures");
+        return false;
+    }
+    
+    // The picture format must be encodable from, and reconstructable into
+    for (VkImageUsageFlags usage : {VK_IMAGE_USAGE_VIDEO_ENCODE_SRC_BIT_KHR, VK_IMAGE_USAGE_VIDEO_ENCODE_DPB_BIT_KHR}) {
+        VkPhysicalDeviceVideoFormatInfoKHR formatInfo{};
+        formatInfo.sType = VK_STRUCTURE_TYPE_PHYSICAL_DEVICE_VIDEO_FORMAT_INFO_KHR;
+        formatInfo.pNext = &profileList;
+        formatInfo.imageUsage = usage;
+        uint32_t formatCount = 0;
+        vk.vkGetPhysicalDeviceVideoFormatPropertiesKHR(physicalDevice, &formatInfo, &formatCount, nullptr);
+        std::vector<VkVideoFormatPropertiesKHR> formats(formatCount);
+        for (auto& format : formats) {
+            format.sType = VK_STRUCTURE_TYPE_VIDEO_FORMAT_PROPERTIES_KHR;
+        }
+        vk.vkGetPhysicalDeviceVideoFormatPropertiesKHR(physicalDevice, &formatInfo, &formatCount, formats.data());
+        const bool nv12 = std::any_of(formats.begin(), formats.begin() + formatCount, [](const VkVideoFormatPropertiesKHR& format) {
+            return format.format == PICTURE_FORMAT && format.imageTiling == VK_IMAGE_TILING_OPTIMAL;
+        });
+        if (!nv12) {
+            LOG_INFO("VideoEncodeSession: Encoder does not take NV12 pictures");
+            return false;
+        }
+    }
+    
+    // Constant QP needs rate control off; the constant must then lie in the encoder's range
+    constantQp = (encodeCapabilities.rateControlModes & VK_VIDEO_ENCODE_RATE_CONTROL_MODE_DISABLED_BIT_KHR) != 0;
+    if (constantQp) {
+        qp = static_cast<uint32_t>(std::clamp(static_cast<int32_t>(qp), h264Capabilities.minQp, h264Capabilities.maxQp));
+    }
+    // Intra-only encoders get an IDR picture every frame
+    if (h264Capabilities.maxPPictureL0ReferenceCount == 0) {
+        gopFrames = 1;
+    }
+    
+    VkVideoSessionCreateInfoKHR sessionInfo{};
+    sessionInfo.sType = VK_STRUCTURE_TYPE_VIDEO_SESSION_CREATE_INFO_KHR;
+    sessionInfo.queueFamilyIndex = context->getVideoEncodeQueueFamily();
+    sessionInfo.pVideoProfile = &profile;
+    sessionInfo.pictureFormat = PICTURE_FORMAT;
+    sessionInfo.maxCodedExtent = extent;
+    sessionInfo.referencePictureFormat = PICTURE_FORMAT;
+    sessionInfo.maxDpbSlots = 2;
+    sessionInfo.maxActiveReferencePictures = 1;
+    sessionInfo.pStdHeaderVersion = &capabilities.stdHeaderVersion;
+    
+    const VkDevice device = context->getDevice();
+    if (vk.vkCreateVideoSessionKHR(device, &sessionInfo, nullptr, &session) != VK_SUCCESS) {
+        LOG_ERROR("VideoEncodeSession: Failed to create video session");
+        session = VK_NULL_HANDLE;
+        return false;
+    }
+    
+    uint32_t requirementCount = 0;
+    vk.vkGetVideoSessionMemoryRequirementsKHR(device, session, &requirementCount, nullptr);
+    std::vector<VkVideoSessionMemoryRequirementsKHR> requirements(requirementCount);
+    for (auto& requirement : requirements) {
+        requirement.sType = VK_STRUCTURE_TYPE_VIDEO_SESSION_MEMORY_REQUIREMENTS_KHR;
+    }
+    vk.vkGetVideoSessionMemoryRequirementsKHR(device, session, &requirementCount, requirements.data());
+    
+    std::vector<VkBindVideoSessionMemoryInfoKHR> binds;
+    for (const auto& requirement : requirements) {
+        uint32_t memoryType = findMemoryType(requirement.memoryRequirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+        if (memoryType == UINT32_MAX) {
+            memoryType = findMemoryType(requirement.memoryRequirements.memoryTypeBits, 0);
+        }
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirement.memoryRequirements.size;
+        allocateInfo.memoryTypeIndex = memoryType;
+        VkDeviceMemory memory = VK_NULL_HANDLE;
+        if (memoryType == UINT32_MAX || vk.vkAllocateMemory(device, &allocateInfo, nullptr, &memory) != VK_SUCCESS) {
+            LOG_ERROR("VideoEncodeSession: Failed to allocate video session memory");
+            return false;
+        }
+        sessionMemory.push_back(memory);
+        
+        VkBindVideoSessionMemoryInfoKHR bind{};
+        bind.sType = VK_STRUCTURE_TYPE_BIND_VIDEO_SESSION_MEMORY_INFO_KHR;
+        bind.memoryBindIndex = requirement.memoryBindIndex;
+        bind.memory = memory;
+        bind.memorySize = requirement.memoryRequirements.size;
+        binds.push_back(bind);
+    }
+    if (!binds.empty() && vk.vkBindVideoSessionMemoryKHR(device, session, static_cast<uint32_t>(binds.size()), binds.data()) != VK_SUCCESS) {
+        LOG_ERROR("VideoEncodeSession: Failed to bind video session memory");
+        return false;
+    }
+    return true;
+}
+
+bool VideoEncodeSession::createParameters() {
+    const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
+    
+    // BT.709 limited range, as capture_yuv.comp converts; timing at the Y4M rate, though frames come as presented
+    StdVideoH264SequenceParameterSetVui vui{};
+    vui.flags.video_signal_type_present_flag = 1;
+    vui.flags.color_description_present_flag = 1;
+    vui.flags.timing_info_present_flag = 1;
+    vui.video_format = 5;  // Unspecified
+    vui.colour_primaries = 1;
+    vui.transfer_characteristics = 1;
+    vui.matrix_coefficients = 1;
+    vui.num_units_in_tick = 1;
+    vui.time_scale = RECORDING_FRAME_RATE * 2;
+    
+    // POC type 2 (output order is decode order) and a single reference frame
+    StdVideoH264SequenceParameterSet sps{};
+    sps.flags.direct_8x8_inference_flag = 1;
+    sps.flags.frame_mbs_only_flag = 1;
+    sps.flags.vui_parameters_present_flag = 1;
+    sps.profile_idc = h264Profile.stdProfileIdc;
+    sps.level_idc = h264Capabilities.maxLevelIdc;
+    sps.chroma_format_idc = STD_VIDEO_H264_CHROMA_FORMAT_IDC_420;
+    sps.log2_max_frame_num_minus4 = LOG2_MAX_FRAME_NUM - 4;
+    sps.pic_order_cnt_type = STD_VIDEO_H264_POC_TYPE_2;
+    sps.max_num_ref_frames = 1;
+    sps.pic_width_in_mbs_minus1 = extent.width / 16 - 1;
+    sps.pic_height_in_map_units_minus1 = extent.height / 16 - 1;
+    sps.pSequenceParameterSetVui = &vui;
+    
+    const VkVideoEncodeH264StdFlagsKHR stdFlags = h264Capabilities.stdSyntaxFlags;
+    StdVideoH264PictureParameterSet pps{};
+    pps.flags.entropy_coding_mode_flag = (stdFlags & VK_VIDEO_ENCODE_H264_STD_ENTROPY_CODING_MODE_FLAG_SET_BIT_KHR) ? 1 : 0;
+    pps.flags.transform_8x8_mode_flag = h264Profile.stdProfileIdc == STD_VIDEO_H264_PROFILE_IDC_HIGH &&
+                                        (stdFlags & VK_VIDEO_ENCODE_H264_STD_TRANSFORM_8X8_MODE_FLAG_SET_BIT_KHR) ? 1 : 0;
+    pps.flags.deblocking_filter_control_present_flag = 1;
+    
+    VkVideoEncodeH264SessionParametersAddInfoKHR addInfo{};
+    addInfo.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_SESSION_PARAMETERS_ADD_INFO_KHR;
+    addInfo.stdSPSCount = 1;
+    addInfo.pStdSPSs = &sps;
+    addInfo.stdPPSCount = 1;
+    addInfo.pStdPPSs = &pps;
+    VkVideoEncodeH264SessionParametersCreateInfoKHR h264Info{};
+    h264Info.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_SESSION_PARAMETERS_CREATE_INFO_KHR;
+    h264Info.maxStdSPSCount = 1;
+    h264Info.maxStdPPSCount = 1;
+    h264Info.pParametersAddInfo = &addInfo;
+    VkVideoSessionParametersCreateInfoKHR parametersInfo{};
+    parametersInfo.sType = VK_STRUCTURE_TYPE_VIDEO_SESSION_PARAMETERS_CREATE_INFO_KHR;
+    parametersInfo.pNext = &h264Info;
+    parametersInfo.videoSession = session;
+    if (vk.vkCreateVideoSessionParametersKHR(device, &parametersInfo, nullptr, &parameters) != VK_SUCCESS) {
+        LOG_ERROR("VideoEncodeSession: Failed to create H.264 session parameters");
+        parameters = VK_NULL_HANDLE;
+        return false;
+    }
+    
+    // The implementation may have overridden fields, so the headers are what it encoded, not what was asked for
+    VkVideoEncodeH264SessionParametersGetInfoKHR h264GetInfo{};
+    h264GetInfo.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_SESSION_PARAMETERS_GET_INFO_KHR;
+    h264GetInfo.writeStdSPS = VK_TRUE;
+    h264GetInfo.writeStdPPS = VK_TRUE;
+    VkVideoEncodeSessionParametersGetInfoKHR getInfo{};
+    getInfo.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_SESSION_PARAMETERS_GET_INFO_KHR;
+    getInfo.pNext = &h264GetInfo;
+    getInfo.videoSessionParameters = parameters;
+    size_t headerSize = 0;
+    if (vk.vkGetEncodedVideoSessionParametersKHR(device, &getInfo, nullptr, &headerSize, nullptr) != VK_SUCCESS || headerSize == 0) {
+        LOG_ERROR("VideoEncodeSession: Failed to query the encoded SPS/PPS size");
+        return false;
+    }
+    parameterBytes.resize(headerSize);
+    if (vk.vkGetEncodedVideoSessionParametersKHR(device, &getInfo, nullptr, &headerSize, parameterBytes.data()) != VK_SUCCESS) {
+        LOG_ERROR("VideoEncodeSession: Failed to encode SPS/PPS");
+        return false;
+    }
+    parameterBytes.resize(headerSize);
+    return true;
+}
+
+VkImage VideoEncodeSession::createVideoImage(VkImageUsageFlags usage, uint32_t layers, VkDeviceMemory& memory) const {
+    const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
+    
+    // Source pictures are filled on the graphics queue and read on the encode queue, with no ownership transfer
+    const std::array<uint32_t, 2> families = {context->getGraphicsQueueFamily(), context->getVideoEncodeQueueFamily()};
+    const bool shared = (usage & VK_IMAGE_USAGE_VIDEO_ENCODE_SRC_BIT_KHR) && families[0] != families[1];
+    
+    VkImageCreateInfo imageInfo{};
+    imageInfo.sType = VK_STRUCTURE_TYPE_IMAGE_CREATE_INFO;
+    imageInfo.pNext = &profileList;
+    imageInfo.imageType = VK_IMAGE_TYPE_2D;
+    imageInfo.format = PICTURE_FORMAT;
+    imageInfo.extent = {extent.width, extent.height, 1};
+    imageInfo.mipLevels = 1;
+    imageInfo.arrayLayers = layers;
+    imageInfo.samples = VK_SAMPLE_COUNT_1_BIT;
+    imageInfo.tiling = VK_IMAGE_TILING_OPTIMAL;
+    imageInfo.usage = usage;
+    imageInfo.sharingMode = shared ? VK_SHARING_MODE_CONCURRENT : VK_SHARING_MODE_EXCLUSIVE;
+    imageInfo.queueFamilyIndexCount = shared ? 2 : 0;
+    imageInfo.pQueueFamilyIndices = shared ? families.data() : nullptr;
+    imageInfo.initialLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    
+    VkImage image = VK_NULL_HANDLE;
+    if (vk.vkCreateImage(device, &imageInfo, nullptr, &image) != VK_SUCCESS) {
+        return VK_NULL_HANDLE;
+    }
+    VkMemoryRequirements requirements{};
+    vk.vkGetImageMemoryRequirements(device, image, &requirements);
+    VkMemoryAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+    allocateInfo.allocationSize = requirements.size;
+    allocateInfo.memoryTypeIndex = findMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT);
+    if (allocateInfo.memoryTypeIndex == UINT32_MAX ||
+        vk.vkAllocateMemory(device, &allocateInfo, nullptr, &memory) != VK_SUCCESS ||
+        vk.vkBindImageMemory(device, image, memory, 0) != VK_SUCCESS) {
+        if (memory != VK_NULL_HANDLE) {
+            vk.vkFreeMemory(device, memory, nullptr);
+            memory = VK_NULL_HANDLE;
+        }
+        vk.vkDestroyImage(device, image, nullptr);
+        return VK_NULL_HANDLE;
+    }
+    return image;
+}
+
+bool VideoEncodeSession::createImages() {
+    const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
+    
+    dpbImage = createVideoImage(VK_IMAGE_USAGE_VIDEO_ENCODE_DPB_BIT_KHR, 2, dpbMemory);
+    if (dpbImage == VK_NULL_HANDLE) {
+        LOG_ERROR("VideoEncodeSession: Failed to create the DPB image");
+        return false;
+    }
+    for (uint32_t layer = 0; layer < 2; ++layer) {
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = dpbImage;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = PICTURE_FORMAT;
+        viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, layer, 1};
+        if (vk.vkCreateImageView(device, &viewInfo, nullptr, &dpbViews[layer]) != VK_SUCCESS) {
+            dpbViews[layer] = VK_NULL_HANDLE;
+            LOG_ERROR("VideoEncodeSession: Failed to create DPB view " << layer);
+            return false;
+        }
+    }
+    return true;
+}
+
+bool VideoEncodeSession::createSlots(uint32_t slotCount) {
+    const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
+    
+    VkCommandPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_COMMAND_POOL_CREATE_INFO;
+    poolInfo.flags = VK_COMMAND_POOL_CREATE_RESET_COMMAND_BUFFER_BIT;
+    poolInfo.queueFamilyIndex = context->getVideoEncodeQueueFamily();
+    VkCommandPool poolHandle = VK_NULL_HANDLE;
+    if (vk.vkCreateCommandPool(device, &poolInfo, nullptr, &poolHandle) != VK_SUCCESS) {
+        LOG_ERROR("VideoEncodeSession: Failed to create encode command pool");
+        return false;
+    }
+    commandPool = vulkan_raii::make_command_pool(poolHandle, context);
+    
+    VkQueryPoolVideoEncodeFeedbackCreateInfoKHR feedbackInfo{};
+    feedbackInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_VIDEO_ENCODE_FEEDBACK_CREATE_INFO_KHR;
+    feedbackInfo.pNext = &profile;
+    feedbackInfo.encodeFeedbackFlags = VK_VIDEO_ENCODE_FEEDBACK_BITSTREAM_BUFFER_OFFSET_BIT_KHR |
+                                       VK_VIDEO_ENCODE_FEEDBACK_BITSTREAM_BYTES_WRITTEN_BIT_KHR;
+    VkQueryPoolCreateInfo queryInfo{};
+    queryInfo.sType = VK_STRUCTURE_TYPE_QUERY_POOL_CREATE_INFO;
+    queryInfo.pNext = &feedbackInfo;
+    queryInfo.queryType = VK_QUERY_TYPE_VIDEO_ENCODE_FEEDBACK_KHR;
+    queryInfo.queryCount = slotCount;
+    VkQueryPool queryHandle = VK_NULL_HANDLE;
+    if (vk.vkCreateQueryPool(device, &queryInfo, nullptr, &queryHandle) != VK_SUCCESS) {
+        LOG_ERROR("VideoEncodeSession: Failed to create encode feedback queries");
+        return false;
+    }
+    feedbackPool = vulkan_raii::make_query_pool(queryHandle, context);
+    
+    // Worst case of an uncompressed picture, which the encoder never reaches at any sane QP
+    bitstreamSize = alignUp(static_cast<VkDeviceSize>(extent.width) * extent.height * 3 / 2,
+                            capabilities.minBitstreamBufferSizeAlignment);
+    
+    slots.resize(slotCount);
+    for (uint32_t index = 0; index < slotCount; ++index) {
+        Slot& slot = slots[index];
+        slot.sourceImage = createVideoImage(VK_IMAGE_USAGE_VIDEO_ENCODE_SRC_BIT_KHR | VK_IMAGE_USAGE_TRANSFER_DST_BIT, 1, slot.sourceMemory);
+        if (slot.sourceImage == VK_NULL_HANDLE) {
+            LOG_ERROR("VideoEncodeSession: Failed to create source picture " << index);
+            return false;
+        }
+        VkImageViewCreateInfo viewInfo{};
+        viewInfo.sType = VK_STRUCTURE_TYPE_IMAGE_VIEW_CREATE_INFO;
+        viewInfo.image = slot.sourceImage;
+        viewInfo.viewType = VK_IMAGE_VIEW_TYPE_2D;
+        viewInfo.format = PICTURE_FORMAT;
+        viewInfo.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+        if (vk.vkCreateImageView(device, &viewInfo, nullptr, &slot.sourceView) != VK_SUCCESS) {
+            slot.sourceView = VK_NULL_HANDLE;
+            LOG_ERROR("VideoEncodeSession: Failed to create source picture view " << index);
+            return false;
+        }
+        
+        VkBufferCreateInfo bufferInfo{};
+        bufferInfo.sType = VK_STRUCTURE_TYPE_BUFFER_CREATE_INFO;
+        bufferInfo.pNext = &profileList;
+        bufferInfo.size = bitstreamSize;
+        bufferInfo.usage = VK_BUFFER_USAGE_VIDEO_ENCODE_DST_BIT_KHR;
+        bufferInfo.sharingMode = VK_SHARING_MODE_EXCLUSIVE;
+        if (vk.vkCreateBuffer(device, &bufferInfo, nullptr, &slot.bitstreamBuffer) != VK_SUCCESS) {
+            slot.bitstreamBuffer = VK_NULL_HANDLE;
+            LOG_ERROR("VideoEncodeSession: Failed to create bitstream buffer " << index);
+            return false;
+        }
+        VkMemoryRequirements requirements{};
+        vk.vkGetBufferMemoryRequirements(device, slot.bitstreamBuffer, &requirements);
+        // Read back by the writer job, so cached where the device has it
+        uint32_t memoryType = findMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT |
+                                             VK_MEMORY_PROPERTY_HOST_COHERENT_BIT | VK_MEMORY_PROPERTY_HOST_CACHED_BIT);
+        if (memoryType == UINT32_MAX) {
+            memoryType = findMemoryType(requirements.memoryTypeBits, VK_MEMORY_PROPERTY_HOST_VISIBLE_BIT | VK_MEMORY_PROPERTY_HOST_COHERENT_BIT);
+        }
+        VkMemoryAllocateInfo allocateInfo{};
+        allocateInfo.sType = VK_STRUCTURE_TYPE_MEMORY_ALLOCATE_INFO;
+        allocateInfo.allocationSize = requirements.size;
+        allocateInfo.memoryTypeIndex = memoryType;
+        void* mapped = nullptr;
+        if (memoryType == UINT32_MAX ||
+            vk.vkAllocateMemory(device, &allocateInfo, nullptr, &slot.bitstreamMemory) != VK_SUCCESS ||
+            vk.vkBindBufferMemory(device, slot.bitstreamBuffer, slot.bitstreamMemory, 0) != VK_SUCCESS ||
+            vk.vkMapMemory(device, slot.bitstreamMemory, 0, VK_WHOLE_SIZE, 0, &mapped) != VK_SUCCESS) {
+            LOG_ERROR("VideoEncodeSession: Failed to allocate bitstream buffer " << index);
+            return false;
+        }
+        slot.bitstreamData = static_cast<const uint8_t*>(mapped);
+        
+        VkCommandBufferAllocateInfo commandInfo{};
+        commandInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_ALLOCATE_INFO;
+        commandInfo.commandPool = commandPool.get();
+        commandInfo.level = VK_COMMAND_BUFFER_LEVEL_PRIMARY;
+        commandInfo.commandBufferCount = 1;
+        if (vk.vkAllocateCommandBuffers(device, &commandInfo, &slot.commandBuffer) != VK_SUCCESS) {
+            LOG_ERROR("VideoEncodeSession: Failed to allocate encode command buffer " << index);
+            return false;
+        }
+        
+        VkFenceCreateInfo fenceInfo{};
+        fenceInfo.sType = VK_STRUCTURE_TYPE_FENCE_CREATE_INFO;
+        VkFence fenceHandle = VK_NULL_HANDLE;
+        if (vk.vkCreateFence(device, &fenceInfo, nullptr, &fenceHandle) != VK_SUCCESS) {
+            LOG_ERROR("VideoEncodeSession: Failed to create encode fence " << index);
+            return false;
+        }
+        slot.fence = vulkan_raii::make_fence(fenceHandle, context);
+    }
+    return true;
+}
+
+void VideoEncodeSession::recordEncode(Slot& slot, uint32_t slotIndex) {
+    const auto& vk = context->getLoader();
+    const VkCommandBuffer commandBuffer = slot.commandBuffer;
+    
+    const uint64_t frameInGop = frameNumber % gopFrames;
+    const bool idr = frameInGop == 0;
+    const int32_t setupIndex = static_cast<int32_t>(frameNumber % 2);
+    const int32_t referenceIndex = 1 - setupIndex;
+    slot.idr = idr;
+    
+    vk.vkResetCommandBuffer(commandBuffer, 0);
+    VkCommandBufferBeginInfo beginInfo{};
+    beginInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_BEGIN_INFO;
+    beginInfo.flags = VK_COMMAND_BUFFER_USAGE_ONE_TIME_SUBMIT_BIT;
+    vk.vkBeginCommandBuffer(commandBuffer, &beginInfo);
+    
+    // The source picture was filled before the graphics timeline value the submit waits for, at this stage
+    std::array<VkImageMemoryBarrier2KHR, 2> barriers{};
+    uint32_t barrierCount = 0;
+    VkImageMemoryBarrier2KHR& source = barriers[barrierCount++];
+    source.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+    source.srcStageMask = VK_PIPELINE_STAGE_2_VIDEO_ENCODE_BIT_KHR;
+    source.dstStageMask = VK_PIPELINE_STAGE_2_VIDEO_ENCODE_BIT_KHR;
+    source.dstAccessMask = VK_ACCESS_2_VIDEO_ENCODE_READ_BIT_KHR;
+    source.oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    source.newLayout = VK_IMAGE_LAYOUT_VIDEO_ENCODE_SRC_KHR;
+    source.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    source.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    source.image = slot.sourceImage;
+    source.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    if (!dpbInitialized) {
+        VkImageMemoryBarrier2KHR& dpb = barriers[barrierCount++];
+        dpb.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER_2_KHR;
+        dpb.srcStageMask = VK_PIPELINE_STAGE_2_NONE_KHR;
+        dpb.dstStageMask = VK_PIPELINE_STAGE_2_VIDEO_ENCODE_BIT_KHR;
+        dpb.dstAccessMask = VK_ACCESS_2_VIDEO_ENCODE_READ_BIT_KHR | VK_ACCESS_2_VIDEO_ENCODE_WRITE_BIT_KHR;
+        dpb.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+        dpb.newLayout = VK_IMAGE_LAYOUT_VIDEO_ENCODE_DPB_KHR;
+        dpb.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        dpb.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        dpb.image = dpbImage;
+        dpb.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 2};
+        dpbInitialized = true;
+    }
+    VkDependencyInfoKHR dependency{};
+    dependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+    dependency.imageMemoryBarrierCount = barrierCount;
+    dependency.pImageMemoryBarriers = barriers.data();
+    vk.vkCmdPipelineBarrier2KHR(commandBuffer, &dependency);
+    
+    vk.vkCmdResetQueryPool(commandBuffer, feedbackPool.get(), slotIndex, 1);
+    
+    // Reference pictures: the one this frame reconstructs into, and on a P frame the previous frame's
+    const uint32_t frameNum = static_cast<uint32_t>(frameInGop % (1u << LOG2_MAX_FRAME_NUM));
+    StdVideoEncodeH264ReferenceInfo setupStd{};
+    setupStd.primary_pic_type = idr ? STD_VIDEO_H264_PICTURE_TYPE_IDR : STD_VIDEO_H264_PICTURE_TYPE_P;
+    setupStd.FrameNum = frameNum;
+    setupStd.PicOrderCnt = static_cast<int32_t>(frameInGop * 2);
+    StdVideoEncodeH264ReferenceInfo referenceStd{};
+    referenceStd.primary_pic_type = frameInGop == 1 ? STD_VIDEO_H264_PICTURE_TYPE_IDR : STD_VIDEO_H264_PICTURE_TYPE_P;
+    referenceStd.FrameNum = static_cast<uint32_t>((frameInGop - 1) % (1u << LOG2_MAX_FRAME_NUM));
+    referenceStd.PicOrderCnt = static_cast<int32_t>((frameInGop - 1) * 2);
+    
+    std::array<VkVideoEncodeH264DpbSlotInfoKHR, 2> dpbInfos{};
+    std::array<VkVideoPictureResourceInfoKHR, 2> dpbResources{};
+    std::array<VkVideoReferenceSlotInfoKHR, 2> referenceSlots{};
+    for (uint32_t i = 0; i < 2; ++i) {
+        dpbInfos[i].sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_DPB_SLOT_INFO_KHR;
+        dpbInfos[i].pStdReferenceInfo = i == 0 ? &setupStd : &referenceStd;
+        dpbResources[i].sType = VK_STRUCTURE_TYPE_VIDEO_PICTURE_RESOURCE_INFO_KHR;
+        dpbResources[i].codedExtent = extent;
+        dpbResources[i].imageViewBinding = dpbViews[i == 0 ? setupIndex : referenceIndex];
+        referenceSlots[i].sType = VK_STRUCTURE_TYPE_VIDEO_REFERENCE_SLOT_INFO_KHR;
+        referenceSlots[i].pNext = &dpbInfos[i];
+        referenceSlots[i].slotIndex = i == 0 ? setupIndex : referenceIndex;
+        referenceSlots[i].pPictureResource = &dpbResources[i];
+    }
+    
+    VkVideoEncodeRateControlInfoKHR rateControl{};
+    rateControl.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_RATE_CONTROL_INFO_KHR;
+    rateControl.rateControlMode = constantQp ? VK_VIDEO_ENCODE_RATE_CONTROL_MODE_DISABLED_BIT_KHR
+                                             : VK_VIDEO_ENCODE_RATE_CONTROL_MODE_DEFAULT_KHR;
+    
+    // The setup picture is activated by this encode, so it is bound without a slot; a reset frees every slot
+    std::array<VkVideoReferenceSlotInfoKHR, 2> boundSlots = referenceSlots;
+    boundSlots[0].slotIndex = -1;
+    VkVideoBeginCodingInfoKHR codingInfo{};
+    codingInfo.sType = VK_STRUCTURE_TYPE_VIDEO_BEGIN_CODING_INFO_KHR;
+    codingInfo.pNext = sessionReset ? &rateControl : nullptr;  // Must match the state the session was set to
+    codingInfo.videoSession = session;
+    codingInfo.videoSessionParameters = parameters;
+    codingInfo.referenceSlotCount = idr ? 1 : 2;
+    codingInfo.pReferenceSlots = boundSlots.data();
+    vk.vkCmdBeginVideoCodingKHR(commandBuffer, &codingInfo);
+    
+    if (!sessionReset) {
+        VkVideoCodingControlInfoKHR control{};
+        control.sType = VK_STRUCTURE_TYPE_VIDEO_CODING_CONTROL_INFO_KHR;
+        control.pNext = &rateControl;
+        control.flags = VK_VIDEO_CODING_CONTROL_RESET_BIT_KHR | VK_VIDEO_CODING_CONTROL_ENCODE_RATE_CONTROL_BIT_KHR;
+        vk.vkCmdControlVideoCodingKHR(commandBuffer, &control);
+        sessionReset = true;
+    }
+    
+    StdVideoEncodeH264ReferenceListsInfo referenceLists{};
+    std::fill(std::begin(referenceLists.RefPicList0), std::end(referenceLists.RefPicList0), NO_REFERENCE);
+    std::fill(std::begin(referenceLists.RefPicList1), std::end(referenceLists.RefPicList1), NO_REFERENCE);
+    if (!idr) {
+        referenceLists.RefPicList0[0] = static_cast<uint8_t>(referenceIndex);
+    }
+    
+    StdVideoEncodeH264SliceHeader sliceHeader{};
+    sliceHeader.slice_type = idr ? STD_VIDEO_H264_SLICE_TYPE_I : STD_VIDEO_H264_SLICE_TYPE_P;
+    sliceHeader.cabac_init_idc = STD_VIDEO_H264_CABAC_INIT_IDC_0;
+    sliceHeader.disable_deblocking_filter_idc = STD_VIDEO_H264_DISABLE_DEBLOCKING_FILTER_IDC_ENABLED;
+    VkVideoEncodeH264NaluSliceInfoKHR slice{};
+    slice.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_NALU_SLICE_INFO_KHR;
+    slice.constantQp = constantQp ? static_cast<int32_t>(qp) : 0;
+    slice.pStdSliceHeader = &sliceHeader;
+    
+    StdVideoEncodeH264PictureInfo pictureStd{};
+    pictureStd.flags.IdrPicFlag = idr ? 1 : 0;
+    pictureStd.flags.is_reference = 1;
+    pictureStd.idr_pic_id = static_cast<uint16_t>(idrId);
+    pictureStd.primary_pic_type = setupStd.primary_pic_type;
+    pictureStd.frame_num = frameNum;
+    pictureStd.PicOrderCnt = setupStd.PicOrderCnt;
+    pictureStd.pRefLists = &referenceLists;
+    VkVideoEncodeH264PictureInfoKHR picture{};
+    picture.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_H264_PICTURE_INFO_KHR;
+    picture.naluSliceEntryCount = 1;
+    picture.pNaluSliceEntries = &slice;
+    picture.pStdPictureInfo = &pictureStd;
+    
+    VkVideoEncodeInfoKHR encodeInfo{};
+    encodeInfo.sType = VK_STRUCTURE_TYPE_VIDEO_ENCODE_INFO_KHR;
+    encodeInfo.pNext = &picture;
+    encodeInfo.dstBuffer = slot.bitstreamBuffer;
+    encodeInfo.dstBufferRange = bitstreamSize;
+    encodeInfo.srcPictureResource.sType = VK_STRUCTURE_TYPE_VIDEO_PICTURE_RESOURCE_INFO_KHR;
+    encodeInfo.srcPictureResource.codedExtent = extent;
+    encodeInfo.srcPictureResource.imageViewBinding = slot.sourceView;
+    encodeInfo.pSetupReferenceSlot = &referenceSlots[0];
+    encodeInfo.referenceSlotCount = idr ? 0 : 1;
+    encodeInfo.pReferenceSlots = idr ? nullptr : &referenceSlots[1];
+    
+    vk.vkCmdBeginQuery(commandBuffer, feedbackPool.get(), slotIndex, 0);
+    vk.vkCmdEncodeVideoKHR(commandBuffer, &encodeInfo);
+    vk.vkCmdEndQuery(commandBuffer, feedbackPool.get(), slotIndex);
+    
+    VkVideoEndCodingInfoKHR endInfo{};
+    endInfo.sType = VK_STRUCTURE_TYPE_VIDEO_END_CODING_INFO_KHR;
+    vk.vkCmdEndVideoCodingKHR(commandBuffer, &endInfo);
+    
+    // The writer job reads the bitstream through the mapping once the fence signals
+    VkMemoryBarrier2KHR hostBarrier{};
+    hostBarrier.sType = VK_STRUCTURE_TYPE_MEMORY_BARRIER_2_KHR;
+    hostBarrier.srcStageMask = VK_PIPELINE_STAGE_2_VIDEO_ENCODE_BIT_KHR;
+    hostBarrier.srcAccessMask = VK_ACCESS_2_VIDEO_ENCODE_WRITE_BIT_KHR;
+    hostBarrier.dstStageMask = VK_PIPELINE_STAGE_2_HOST_BIT_KHR;
+    hostBarrier.dstAccessMask = VK_ACCESS_2_HOST_READ_BIT_KHR;
+    VkDependencyInfoKHR hostDependency{};
+    hostDependency.sType = VK_STRUCTURE_TYPE_DEPENDENCY_INFO_KHR;
+    hostDependency.memoryBarrierCount = 1;
+    hostDependency.pMemoryBarriers = &hostBarrier;
+    vk.vkCmdPipelineBarrier2KHR(commandBuffer, &hostDependency);
+    
+    vk.vkEndCommandBuffer(commandBuffer);
+    
+    if (idr) {
+        ++idrId;
+    }
+    ++frameNumber;
+}
+
+bool VideoEncodeSession::submit(uint32_t slotIndex, VkSemaphore waitSemaphore, uint64_t waitValue) {
+    if (!isActive() || slotIndex >= slots.size() || slots[slotIndex].pending) {
+        return false;
+    }
+    const auto& vk = context->getLoader();
+    Slot& slot = slots[slotIndex];
+    
+    recordEncode(slot, slotIndex);
+    
+    VkSemaphoreSubmitInfoKHR waitInfo{};
+    waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_SUBMIT_INFO_KHR;
+    waitInfo.semaphore = waitSemaphore;
+    waitInfo.value = waitValue;
+    waitInfo.stageMask = VK_PIPELINE_STAGE_2_VIDEO_ENCODE_BIT_KHR;
+    VkCommandBufferSubmitInfoKHR commandInfo{};
+    commandInfo.sType = VK_STRUCTURE_TYPE_COMMAND_BUFFER_SUBMIT_INFO_KHR;
+    commandInfo.commandBuffer = slot.commandBuffer;
+    VkSubmitInfo2KHR submitInfo{};
+    submitInfo.sType = VK_STRUCTURE_TYPE_SUBMIT_INFO_2_KHR;
+    submitInfo.waitSemaphoreInfoCount = 1;
+    submitInfo.pWaitSemaphoreInfos = &waitInfo;
+    submitInfo.commandBufferInfoCount = 1;
+    submitInfo.pCommandBufferInfos = &commandInfo;
+    
+    VkFence fence = slot.fence.get();
+    vk.vkResetFences(context->getDevice(), 1, &fence);
+    const VkResult result = vk.vkQueueSubmit2KHR(context->getVideoEncodeQueue(), 1, &submitInfo, fence);
+    if (result != VK_SUCCESS) {
+        LOG_ERROR("VideoEncodeSession: Encode submit failed (VkResult: " << result << ")");
+        return false;
+    }
+    slot.pending = true;
+    return true;
+}
+
+bool VideoEncodeSession::collect(uint32_t slotIndex, std::vector<uint8_t>& bitstream) {
+    if (slotIndex >= slots.size() || !slots[slotIndex].pending) {
+        return false;
+    }
+    const auto& vk = context->getLoader();
+    const VkDevice device = context->getDevice();
+    Slot& slot = slots[slotIndex];
+    if (vk.vkGetFenceStatus(device, slot.fence.get()) != VK_SUCCESS) {
+        return false;
+    }
+    slot.pending = false;
+    
+    EncodeFeedback feedback{};
+    const VkResult result = vk.vkGetQueryPoolResults(device, feedbackPool.get(), slotIndex, 1, sizeof(feedback), &feedback,
+                                                     sizeof(feedback), VK_QUERY_RESULT_WITH_STATUS_BIT_KHR);
+    if (result != VK_SUCCESS || feedback.status != VK_QUERY_RESULT_STATUS_COMPLETE_KHR ||
+        static_cast<VkDeviceSize>(feedback.bitstreamOffset) + feedback.bytesWritten > bitstreamSize) {
+        LOG_ERROR("VideoEncodeSession: Encode of slot " << slotIndex << " failed (status " << feedback.status << ")");
+        return true;
+    }
+    
+    // Annex-B: the parameter sets repeated in front of every IDR picture, so the stream can be cut at any of them
+    if (slot.idr) {
+        bitstream.insert(bitstream.end(), parameterBytes.begin(), parameterBytes.end());
+    }
+    const uint8_t* data = slot.bitstreamData + feedback.bitstreamOffset;
+    bitstream.insert(bitstream.end(), data, data + feedback.bytesWritten);
+    return true;
+}
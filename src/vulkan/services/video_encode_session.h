@@ -0,0 +1,105 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../core/vulkan_raii.h"
+#include "../core/vulkan_constants.h"
+#include <cstdint>
+#include <vector>
+
+// Forward declarations
+class VulkanContext;
+
+/**
+ * Vulkan Video H.264 encoder for session recording (VulkanContext::supportsVideoEncode). Owns the video session,
+ * its SPS/PPS parameters, a two-picture DPB and, per recorder slot, an NV12 source image, a bitstream buffer,
+ * feedback query and encode command buffer. VideoRecorder fills the source image on the graphics queue; the
+ * encode submit waits for that frame's graphics timeline value, so the queues share the images concurrently and
+ * nothing is transferred between families.
+ *
+ * Every gopFrames-th frame is an IDR picture, the rest P pictures referencing the previous frame. The first
+ * frame resets the session and sets rate control: constant QP where the encoder can run without rate control,
+ * the implementation default otherwise. Output is Annex-B, with SPS/PPS written in front of each IDR picture.
+ */
+class VideoEncodeSession {
+public:
+    VideoEncodeSession() = default;
+    ~VideoEncodeSession();
+    VideoEncodeSession(const VideoEncodeSession&) = delete;
+    VideoEncodeSession& operator=(const VideoEncodeSession&) = delete;
+    
+    // False when the device cannot encode extent (a multiple of 16) with the profile this needs
+    bool initialize(const VulkanContext& context, VkExtent2D extent, uint32_t slotCount, uint32_t gopFrames, uint32_t qp);
+    void cleanup();  // Device idle
+    bool isActive() const { return session != VK_NULL_HANDLE; }
+    
+    // NV12 image VideoRecorder copies the converted frame into, TRANSFER_DST_OPTIMAL once filled
+    VkImage getSourceImage(uint32_t slot) const { return slots[slot].sourceImage; }
+    
+    // Encodes slot's source image once the graphics queue reached waitValue on waitSemaphore
+    bool submit(uint32_t slot, VkSemaphore waitSemaphore, uint64_t waitValue);
+    
+    // Non-blocking; true once slot's encode finished, appending its Annex-B bytes (empty on an encoder error)
+    bool collect(uint32_t slot, std::vector<uint8_t>& bitstream);
+    
+    const char* getProfileName() const { return profileName; }
+
+private:
+    struct Slot {
+        VkImage sourceImage = VK_NULL_HANDLE;
+        VkDeviceMemory sourceMemory = VK_NULL_HANDLE;
+        VkImageView sourceView = VK_NULL_HANDLE;
+        VkBuffer bitstreamBuffer = VK_NULL_HANDLE;
+        VkDeviceMemory bitstreamMemory = VK_NULL_HANDLE;
+        const uint8_t* bitstreamData = nullptr;
+        VkCommandBuffer commandBuffer = VK_NULL_HANDLE;
+        vulkan_raii::Fence fence;
+        bool idr = false;       // Frame carries SPS/PPS in front of it
+        bool pending = false;
+    };
+    
+    bool createSession();
+    bool createParameters();
+    bool createImages();
+    bool createSlots(uint32_t slotCount);
+    VkImage createVideoImage(VkImageUsageFlags usage, uint32_t layers, VkDeviceMemory& memory) const;
+    uint32_t findMemoryType(uint32_t typeBits, VkMemoryPropertyFlags properties) const;
+    void recordEncode(Slot& slot, uint32_t slotIndex);
+    
+    const VulkanContext* context = nullptr;
+    VkExtent2D extent{};
+    uint32_t gopFrames = RECORDING_DEFAULT_GOP;
+    uint32_t qp = RECORDING_DEFAULT_QP;
+    const char* profileName = "";
+    
+    // Profile chain, referenced by every object the session uses
+    VkVideoEncodeH264ProfileInfoKHR h264Profile{};
+    VkVideoEncodeUsageInfoKHR usageInfo{};
+    VkVideoProfileInfoKHR profile{};
+    VkVideoProfileListInfoKHR profileList{};
+    
+    VkVideoCapabilitiesKHR capabilities{};
+    VkVideoEncodeCapabilitiesKHR encodeCapabilities{};
+    VkVideoEncodeH264CapabilitiesKHR h264Capabilities{};
+    bool constantQp = false;    // Rate control can be disabled, encoding at qp
+    
+    VkVideoSessionKHR session = VK_NULL_HANDLE;
+    std::vector<VkDeviceMemory> sessionMemory;
+    VkVideoSessionParametersKHR parameters = VK_NULL_HANDLE;
+    std::vector<uint8_t> parameterBytes;  // Encoded SPS and PPS
+    
+    // Reconstructed pictures, one layer each; frame n is set up in layer n % 2
+    VkImage dpbImage = VK_NULL_HANDLE;
+    VkDeviceMemory dpbMemory = VK_NULL_HANDLE;
+    VkImageView dpbViews[2] = {VK_NULL_HANDLE, VK_NULL_HANDLE};
+    bool dpbInitialized = false;
+    
+    std::vector<Slot> slots;
+    VkDeviceSize bitstreamSize = 0;
+    vulkan_raii::CommandPool commandPool;
+    vulkan_raii::QueryPool feedbackPool;  // One query per slot: bitstream offset and bytes written
+    
+    uint64_t frameNumber = 0;   // Frames submitted
+    uint32_t idrId = 0;
+    bool sessionReset = false;
+};
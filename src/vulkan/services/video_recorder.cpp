@@ -0,0 +1,619 @@
+#include "video_recorder.h"
+#include "../core/vulkan_context.h"
+#include "../core/vulkan_function_loader.h"
+#include "../resources/core/resource_coordinator.h"
+#include "../resources/descriptors/descriptor_update_helper.h"
+#include "../../ecs/utilities/logger.h"
+#include <algorithm>
+#include <cstring>
+
+namespace {
+    // Must match CapturePushConstants in capture_yuv.comp
+    struct CapturePushConstants {
+        uint32_t width;
+        uint32_t height;
+        uint32_t planar;
+        uint32_t swapRedBlue;
+    };
+    static_assert(sizeof(CapturePushConstants) == 16);
+    
+    constexpr uint32_t CAPTURE_BLOCK_WIDTH = 8 * 16;  // Pixels per workgroup: 8x2 per invocation, 16x4 invocations
+    constexpr uint32_t CAPTURE_BLOCK_HEIGHT = 2 * 4;
+    constexpr double MEGABYTE = 1024.0 * 1024.0;
+    
+    // 8-bit four-channel formats can be converted as packed words; blue first needs its channels swapped
+    bool isCapturableFormat(VkFormat format, bool& swapRedBlue) {
+        switch (format) {
+            case VK_FORMAT_B8G8R8A8_UNORM:
+            case VK_FORMAT_B8G8R8A8_SRGB:
+                swapRedBlue = true;
+                return true;
+            case VK_FORMAT_R8G8B8A8_UNORM:
+            case VK_FORMAT_R8G8B8A8_SRGB:
+            case VK_FORMAT_A8B8G8R8_UNORM_PACK32:
+            case VK_FORMAT_A8B8G8R8_SRGB_PACK32:
+                swapRedBlue = false;
+                return true;
+            default:
+                return false;
+        }
+    }
+    
+    VkDeviceSize frameBytes(VkExtent2D extent) {
+        return static_cast<VkDeviceSize>(extent.width) * extent.height * 3 / 2;
+    }
+}
+
+VideoRecorder::~VideoRecorder() {
+    close();
+}
+
+bool VideoRecorder::attach(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, const RecordingOptions& options) {
+    detach();
+    if (!output && !openOutput(options)) {
+        return false;
+    }
+    this->context = &context;
+    this->resourceCoordinator = resourceCoordinator;
+    gopFrames = options.gopFrames;
+    qp = options.qp;
+    slotCount = std::min(context.getFramesInFlight(), MAX_FRAMES_IN_FLIGHT);
+    failed = false;
+    
+    // Binding 0: the captured frame as packed texels; binding 1: the YUV output
+    std::array<VkDescriptorSetLayoutBinding, 2> bindings{};
+    for (uint32_t binding = 0; binding < bindings.size(); ++binding) {
+        bindings[binding].binding = binding;
+        bindings[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+        bindings[binding].descriptorCount = 1;
+        bindings[binding].stageFlags = VK_SHADER_STAGE_COMPUTE_BIT;
+    }
+    VkDescriptorSetLayoutCreateInfo layoutInfo{};
+    layoutInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_LAYOUT_CREATE_INFO;
+    layoutInfo.bindingCount = static_cast<uint32_t>(bindings.size());
+    layoutInfo.pBindings = bindings.data();
+    
+    // With push descriptors recordCapture() pushes both buffers, so there is no pool or set to allocate
+    pushDescriptors = context.supportsPushDescriptors();
+    if (pushDescriptors) {
+        layoutInfo.flags = VK_DESCRIPTOR_SET_LAYOUT_CREATE_PUSH_DESCRIPTOR_BIT_KHR;
+    }
+    
+    const auto& vk = context.getLoader();
+    const VkDevice device = context.getDevice();
+    VkDescriptorSetLayout layoutHandle = VK_NULL_HANDLE;
+    if (vk.vkCreateDescriptorSetLayout(device, &layoutInfo, nullptr, &layoutHandle) != VK_SUCCESS) {
+        LOG_ERROR("VideoRecorder: Failed to create capture descriptor set layout");
+        detach();
+        return false;
+    }
+    descriptorSetLayout = vulkan_raii::make_descriptor_set_layout(layoutHandle, &context);
+    if (pushDescriptors) {
+        return true;
+    }
+    
+    VkDescriptorPoolSize poolSize{VK_DESCRIPTOR_TYPE_STORAGE_BUFFER, 2 * MAX_FRAMES_IN_FLIGHT};
+    VkDescriptorPoolCreateInfo poolInfo{};
+    poolInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_POOL_CREATE_INFO;
+    poolInfo.maxSets = MAX_FRAMES_IN_FLIGHT;
+    poolInfo.poolSizeCount = 1;
+    poolInfo.pPoolSizes = &poolSize;
+    VkDescriptorPool poolHandle = VK_NULL_HANDLE;
+    if (vk.vkCreateDescriptorPool(device, &poolInfo, nullptr, &poolHandle) != VK_SUCCESS) {
+        LOG_ERROR("VideoRecorder: Failed to create capture descriptor pool");
+        detach();
+        return false;
+    }
+    descriptorPool = vulkan_raii::make_descriptor_pool(poolHandle, &context);
+    
+    std::array<VkDescriptorSetLayout, MAX_FRAMES_IN_FLIGHT> layouts;
+    layouts.fill(layoutHandle);
+    std::array<VkDescriptorSet, MAX_FRAMES_IN_FLIGHT> sets{};
+    VkDescriptorSetAllocateInfo allocateInfo{};
+    allocateInfo.sType = VK_STRUCTURE_TYPE_DESCRIPTOR_SET_ALLOCATE_INFO;
+    allocateInfo.descriptorPool = poolHandle;
+    allocateInfo.descriptorSetCount = slotCount;
+    allocateInfo.pSetLayouts = layouts.data();
+    if (vk.vkAllocateDescriptorSets(device, &allocateInfo, sets.data()) != VK_SUCCESS) {
+        LOG_ERROR("VideoRecorder: Failed to allocate capture descriptor sets");
+        detach();
+        return false;
+    }
+    for (uint32_t slot = 0; slot < slotCount; ++slot) {
+        slots[slot].descriptorSet = sets[slot];
+    }
+    return true;
+}
+
+bool VideoRecorder::openOutput(const RecordingOptions& options) {
+    // An external encoder takes Y4M on its stdin, so it rules out the hardware path
+    if (!options.encoderCommand.empty()) {
+#if defined(_WIN32)
+        output = _popen(options.encoderCommand.c_str(), "wb");
+#else
+        output = popen(options.encoderCommand.c_str(), "w");
+#endif
+        outputIsPipe = true;
+        useHardwareEncode = false;
+        modeChosen = true;
+    } else {
+        output = std::fopen(options.path.c_str(), "wb");
+        outputIsPipe = false;
+    }
+    if (!output) {
+        LOG_ERROR("VideoRecorder: Failed to open " << (outputIsPipe ? options.encoderCommand : options.path));
+        return false;
+    }
+    return true;
+}
+
+void VideoRecorder::detach() {
+    if (!context) {
+        return;
+    }
+    // The device is idle, so every submitted frame has finished and goes to the writer before its slot is freed
+    collectFinished(true);
+    JobSystem::getInstance().wait(writeJobs, JobPriority::Low);
+    releaseResources();
+    descriptorPool.reset();
+    descriptorSetLayout.reset();
+    for (Slot& slot : slots) {
+        slot.descriptorSet = VK_NULL_HANDLE;
+    }
+    context = nullptr;
+    resourceCoordinator = nullptr;
+}
+
+void VideoRecorder::close() {
+    detach();
+    JobSystem::getInstance().wait(writeJobs, JobPriority::Low);
+    if (!output) {
+        return;
+    }
+#if defined(_WIN32)
+    const int status = outputIsPipe ? _pclose(output) : std::fclose(output);
+#else
+    const int status = outputIsPipe ? pclose(output) : std::fclose(output);
+#endif
+    if (status != 0) {
+        LOG_ERROR("VideoRecorder: Closing the recording output failed (" << status << ")");
+    }
+    output = nullptr;
+    
+    const Telemetry totals = getTelemetry();
+    LOG_INFO("VideoRecorder: Recorded " << totals.framesWritten << " frames of " << extent.width << "x" << extent.height
+             << (useHardwareEncode ? " as H.264, " : " as Y4M, ") << totals.framesDropped << " dropped, "
+             << totals.bytesWritten / MEGABYTE << " MB");
+}
+
+bool VideoRecorder::createResources() {
+    releaseResources();
+    ++resourceGeneration;
+    
+    // The first device decides the format for the whole recording; a rebuilt one must encode the same way
+    if (!modeChosen) {
+        useHardwareEncode = ENABLE_VIDEO_ENCODE && context->supportsVideoEncode() &&
+                            encodeSession.initialize(*context, extent, slotCount, gopFrames, qp);
+        modeChosen = true;
+        if (!useHardwareEncode) {
+            LOG_INFO("VideoRecorder: No H.264 video encode, recording " << extent.width << "x" << extent.height << " as Y4M");
+        }
+    } else if (useHardwareEncode && !encodeSession.initialize(*context, extent, slotCount, gopFrames, qp)) {
+        LOG_ERROR("VideoRecorder: The rebuilt device cannot continue the H.264 recording");
+        return false;
+    }
+    
+    const VkDeviceSize pixelBytes = static_cast<VkDeviceSize>(extent.width) * extent.height * sizeof(uint32_t);
+    const VkDeviceSize yuvBytes = frameBytes(extent);
+    captureImage = resourceCoordinator->createImage(extent.width, extent.height, captureFormat,
+                                                    VK_IMAGE_USAGE_TRANSFER_DST_BIT | VK_IMAGE_USAGE_TRANSFER_SRC_BIT);
+    // Capture yields to the simulation's streams when device-local memory runs short
+    rgbBuffer = resourceCoordinator->createBuffer(pixelBytes, VK_BUFFER_USAGE_TRANSFER_DST_BIT | VK_BUFFER_USAGE_STORAGE_BUFFER_BIT,
+                                                  VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, MemoryAllocator::Priority::Low);
+    if (!captureImage.isValid() || !rgbBuffer.isValid()) {
+        LOG_ERROR("VideoRecorder: Failed to create the " << extent.width << "x" << extent.height << " capture resources");
+        return false;
+    }
+    if (useHardwareEncode) {
+        yuvDeviceBuffer = resourceCoordinator->createBuffer(yuvBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT | VK_BUFFER_USAGE_TRANSFER_SRC_BIT,
+                                                            VK_MEMORY_PROPERTY_DEVICE_LOCAL_BIT, MemoryAllocator::Priority::Low);
+        if (!yuvDeviceBuffer.isValid()) {
+            LOG_ERROR("VideoRecorder: Failed to create the YUV conversion buffer");
+            return false;
+        }
+    }
+    
+    const auto& vk = context->getLoader();
+    for (uint32_t index = 0; index < slotCount; ++index) {
+        Slot& slot = slots[index];
+        if (useHardwareEncode) {
+            slot.yuvBuffer = yuvDeviceBuffer.buffer.get();
+        } else {
+            slot.yuvReadback = resourceCoordinator->createMappedBuffer(yuvBytes, VK_BUFFER_USAGE_STORAGE_BUFFER_BIT);
+            if (!slot.yuvReadback.isValid() || !slot.yuvReadback.mappedData) {
+                LOG_ERROR("VideoRecorder: Failed to create readback buffer " << index);
+                return false;
+            }
+            slot.yuvBuffer = slot.yuvReadback.buffer.get();
+        }
+        if (pushDescriptors) {
+            continue;
+        }
+        
+        const std::array<VkDescriptorBufferInfo, 2> bufferInfos = {{
+            {rgbBuffer.buffer.get(), 0, VK_WHOLE_SIZE},
+            {slot.yuvBuffer, 0, VK_WHOLE_SIZE},
+        }};
+        std::array<VkWriteDescriptorSet, 2> writes{};
+        for (uint32_t binding = 0; binding < writes.size(); ++binding) {
+            writes[binding].sType = VK_STRUCTURE_TYPE_WRITE_DESCRIPTOR_SET;
+            writes[binding].dstSet = slot.descriptorSet;
+            writes[binding].dstBinding = binding;
+            writes[binding].descriptorCount = 1;
+            writes[binding].descriptorType = VK_DESCRIPTOR_TYPE_STORAGE_BUFFER;
+            writes[binding].pBufferInfo = &bufferInfos[binding];
+        }
+        vk.vkUpdateDescriptorSets(context->getDevice(), static_cast<uint32_t>(writes.size()), writes.data(), 0, nullptr);
+    }
+    return true;
+}
+
+void VideoRecorder::releaseResources() {
+    // The writer may still be reading a readback mapping
+    JobSystem::getInstance().wait(writeJobs, JobPriority::Low);
+    encodeSession.cleanup();
+    for (Slot& slot : slots) {
+        if (slot.yuvReadback.isValid() && resourceCoordinator) {
+            resourceCoordinator->destroyResource(slot.yuvReadback);
+        }
+        slot.yuvReadback = ResourceHandle{};
+        slot.yuvBuffer = VK_NULL_HANDLE;
+        slot.state = SlotState::Free;
+    }
+    if (resourceCoordinator) {
+        if (captureImage.isValid()) resourceCoordinator->destroyResource(captureImage);
+        if (rgbBuffer.isValid()) resourceCoordinator->destroyResource(rgbBuffer);
+        if (yuvDeviceBuffer.isValid()) resourceCoordinator->destroyResource(yuvDeviceBuffer);
+    }
+    captureImage = ResourceHandle{};
+    rgbBuffer = ResourceHandle{};
+    yuvDeviceBuffer = ResourceHandle{};
+    submittedSlots.clear();
+    captureSlot = UINT32_MAX;
+}
+
+void VideoRecorder::beginFrame(uint32_t frameIndex) {
+    if (!context) {
+        return;
+    }
+    // A frame captured but never submitted has nothing to collect
+    for (uint32_t index = 0; index < slotCount; ++index) {
+        if (slots[index].state == SlotState::Captured) {
+            slots[index].state = SlotState::Free;
+            ++framesDropped;
+        }
+    }
+    captureSlot = UINT32_MAX;
+    
+    // This slot's frame has completed on the graphics queue, and older ones before it
+    if (!useHardwareEncode) {
+        const uint32_t completedSlot = frameIndex % std::max(slotCount, 1u);
+        if (std::find(submittedSlots.begin(), submittedSlots.end(), completedSlot) != submittedSlots.end()) {
+            while (!submittedSlots.empty()) {
+                const uint32_t slot = submittedSlots.front();
+                submittedSlots.pop_front();
+                slots[slot].state = SlotState::Free;
+                slots[slot].writing.store(true, std::memory_order_relaxed);
+                Output frame;
+                frame.readbackSlot = slot;
+                queueOutput(std::move(frame));
+                if (slot == completedSlot) {
+                    break;
+                }
+            }
+        }
+        return;
+    }
+    collectFinished(false);
+}
+
+void VideoRecorder::collectFinished(bool wait) {
+    // Readbacks are all complete once the device is idle; encodes are taken in submission order as they finish
+    while (!submittedSlots.empty()) {
+        const uint32_t slot = submittedSlots.front();
+        Output frame;
+        if (useHardwareEncode) {
+            bool finished = encodeSession.collect(slot, frame.bytes);
+            if (wait && !finished) {
+                context->getLoader().vkQueueWaitIdle(context->getVideoEncodeQueue());
+                finished = encodeSession.collect(slot, frame.bytes);
+            }
+            if (!finished) {
+                return;
+            }
+            if (frame.bytes.empty()) {
+                ++framesDropped;
+            }
+        } else {
+            frame.readbackSlot = slot;
+            slots[slot].writing.store(true, std::memory_order_relaxed);
+        }
+        submittedSlots.pop_front();
+        slots[slot].state = SlotState::Free;
+        if (frame.readbackSlot != UINT32_MAX || !frame.bytes.empty()) {
+            queueOutput(std::move(frame));
+        }
+    }
+}
+
+bool VideoRecorder::prepareCapture(uint32_t frameIndex, VkExtent2D source, VkFormat sourceFormat) {
+    captureSlot = UINT32_MAX;
+    if (!context || failed || slotCount == 0 || source.width == 0 || source.height == 0) {
+        return false;
+    }
+    bool swap = false;
+    if (!isCapturableFormat(sourceFormat, swap)) {
+        if (!formatReported) {
+            LOG_ERROR("VideoRecorder: Swapchain format " << sourceFormat << " cannot be recorded");
+            formatReported = true;
+        }
+        ++framesDropped;
+        return false;
+    }
+    
+    if (extent.width == 0) {
+        extent.width = source.width / RECORDING_EXTENT_ALIGNMENT * RECORDING_EXTENT_ALIGNMENT;
+        extent.height = source.height / RECORDING_EXTENT_ALIGNMENT * RECORDING_EXTENT_ALIGNMENT;
+        if (extent.width == 0 || extent.height == 0) {
+            extent = {};
+            return false;
+        }
+    }
+    if (!captureImage.isValid() || captureFormat != sourceFormat) {
+        // A new format after a swapchain rebuild only needs another capture image, but everything in flight
+        // would be lost either way; it is simplest to start the slots over
+        if (!submittedSlots.empty()) {
+            ++framesDropped;
+            return false;
+        }
+        captureFormat = sourceFormat;
+        if (!createResources()) {
+            releaseResources();
+            failed = true;
+            return false;
+        }
+    }
+    
+    Slot& slot = slots[frameIndex % slotCount];
+    if (slot.state != SlotState::Free || slot.writing.load(std::memory_order_acquire)) {
+        ++framesDropped;
+        return false;
+    }
+    slot.state = SlotState::Captured;
+    captureSlot = frameIndex % slotCount;
+    sourceExtent = source;
+    swapRedBlue = swap;
+    return true;
+}
+
+uint64_t VideoRecorder::getCaptureKey() const {
+    uint64_t key = resourceGeneration;
+    key = key * 0x100000001B3ull ^ captureSlot;
+    key = key * 0x100000001B3ull ^ ((static_cast<uint64_t>(sourceExtent.width) << 32) | sourceExtent.height);
+    key = key * 0x100000001B3ull ^ (swapRedBlue ? 1u : 0u);
+    return key;
+}
+
+void VideoRecorder::recordCapture(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk, VkImage swapchainImage,
+                                  VkPipeline pipeline, VkPipelineLayout pipelineLayout) const {
+    if (captureSlot == UINT32_MAX) {
+        return;
+    }
+    const Slot& slot = slots[captureSlot];
+    const VkImage capture = captureImage.image.get();
+    
+    // The image is finished (entity pass, upscale blit or HUD); the capture image's previous frame may still be
+    // read by that frame's copy, so its contents are discarded only after it
+    std::array<VkImageMemoryBarrier, 2> barriers{};
+    for (auto& barrier : barriers) {
+        barrier.sType = VK_STRUCTURE_TYPE_IMAGE_MEMORY_BARRIER;
+        barrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+        barrier.subresourceRange = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 1, 0, 1};
+    }
+    barriers[0].image = swapchainImage;
+    barriers[0].srcAccessMask = VK_ACCESS_COLOR_ATTACHMENT_WRITE_BIT | VK_ACCESS_TRANSFER_WRITE_BIT;
+    barriers[0].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barriers[0].oldLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barriers[1].image = capture;
+    barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    vk.vkCmdPipelineBarrier(commandBuffer,
+        VK_PIPELINE_STAGE_COLOR_ATTACHMENT_OUTPUT_BIT | VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT, 0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+    
+    // A source no more than the alignment larger is cropped; any other size is scaled to the recording extent
+    const bool crop = sourceExtent.width >= extent.width && sourceExtent.height >= extent.height &&
+                      sourceExtent.width - extent.width < RECORDING_EXTENT_ALIGNMENT &&
+                      sourceExtent.height - extent.height < RECORDING_EXTENT_ALIGNMENT;
+    VkImageBlit blit{};
+    blit.srcSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.srcOffsets[1] = crop ? VkOffset3D{static_cast<int32_t>(extent.width), static_cast<int32_t>(extent.height), 1}
+                              : VkOffset3D{static_cast<int32_t>(sourceExtent.width), static_cast<int32_t>(sourceExtent.height), 1};
+    blit.dstSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    blit.dstOffsets[1] = {static_cast<int32_t>(extent.width), static_cast<int32_t>(extent.height), 1};
+    vk.vkCmdBlitImage(commandBuffer, swapchainImage, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL,
+                      capture, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL, 1, &blit, crop ? VK_FILTER_NEAREST : VK_FILTER_LINEAR);
+    
+    // Back to presentable; nothing after the capture touches the swapchain image
+    barriers[0].srcAccessMask = 0;
+    barriers[0].dstAccessMask = 0;
+    barriers[0].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    barriers[0].newLayout = VK_IMAGE_LAYOUT_PRESENT_SRC_KHR;
+    barriers[1].srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    barriers[1].dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    barriers[1].oldLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    barriers[1].newLayout = VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL;
+    vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT,
+        VK_PIPELINE_STAGE_TRANSFER_BIT | VK_PIPELINE_STAGE_BOTTOM_OF_PIPE_BIT,
+        0, 0, nullptr, 0, nullptr, static_cast<uint32_t>(barriers.size()), barriers.data());
+    
+    VkBufferImageCopy copy{};
+    copy.imageSubresource = {VK_IMAGE_ASPECT_COLOR_BIT, 0, 0, 1};
+    copy.imageExtent = {extent.width, extent.height, 1};
+    vk.vkCmdCopyImageToBuffer(commandBuffer, capture, VK_IMAGE_LAYOUT_TRANSFER_SRC_OPTIMAL, rgbBuffer.buffer.get(), 1, &copy);
+    
+    VkBufferMemoryBarrier pixelBarrier{};
+    pixelBarrier.sType = VK_STRUCTURE_TYPE_BUFFER_MEMORY_BARRIER;
+    pixelBarrier.srcAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    pixelBarrier.dstAccessMask = VK_ACCESS_SHADER_READ_BIT;
+    pixelBarrier.srcQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    pixelBarrier.dstQueueFamilyIndex = VK_QUEUE_FAMILY_IGNORED;
+    pixelBarrier.buffer = rgbBuffer.buffer.get();
+    pixelBarrier.size = VK_WHOLE_SIZE;
+    vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_TRANSFER_BIT, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT,
+                            0, 0, nullptr, 1, &pixelBarrier, 0, nullptr);
+    
+    const CapturePushConstants pushConstants{extent.width, extent.height, useHardwareEncode ? 0u : 1u, swapRedBlue ? 1u : 0u};
+    vk.vkCmdBindPipeline(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipeline);
+    if (pushDescriptors) {
+        // Both handles are covered by the capture key's resource generation and slot
+        DescriptorUpdateHelper::pushBufferBindings(*context, commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, {
+            {0, rgbBuffer.buffer.get(), VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
+            {1, slot.yuvBuffer, VK_DESCRIPTOR_TYPE_STORAGE_BUFFER},
+        });
+    } else {
+        vk.vkCmdBindDescriptorSets(commandBuffer, VK_PIPELINE_BIND_POINT_COMPUTE, pipelineLayout, 0, 1, &slot.descriptorSet, 0, nullptr);
+    }
+    vk.vkCmdPushConstants(commandBuffer, pipelineLayout, VK_SHADER_STAGE_COMPUTE_BIT, 0, sizeof(pushConstants), &pushConstants);
+    vk.vkCmdDispatch(commandBuffer, (extent.width + CAPTURE_BLOCK_WIDTH - 1) / CAPTURE_BLOCK_WIDTH,
+                     (extent.height + CAPTURE_BLOCK_HEIGHT - 1) / CAPTURE_BLOCK_HEIGHT, 1);
+    
+    VkBufferMemoryBarrier yuvBarrier = pixelBarrier;
+    yuvBarrier.srcAccessMask = VK_ACCESS_SHADER_WRITE_BIT;
+    yuvBarrier.buffer = slot.yuvBuffer;
+    if (!useHardwareEncode) {
+        // Read through the mapping once the slot's frame wait returns
+        yuvBarrier.dstAccessMask = VK_ACCESS_HOST_READ_BIT;
+        vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_HOST_BIT,
+                                0, 0, nullptr, 1, &yuvBarrier, 0, nullptr);
+        return;
+    }
+    
+    // NV12 into the slot's picture, whose last encode finished before the slot was freed; the encode submit
+    // moves it to VIDEO_ENCODE_SRC once the graphics timeline passes this frame
+    VkImageMemoryBarrier pictureBarrier = barriers[1];
+    pictureBarrier.image = encodeSession.getSourceImage(captureSlot);
+    pictureBarrier.srcAccessMask = 0;
+    pictureBarrier.dstAccessMask = VK_ACCESS_TRANSFER_WRITE_BIT;
+    pictureBarrier.oldLayout = VK_IMAGE_LAYOUT_UNDEFINED;
+    pictureBarrier.newLayout = VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL;
+    pictureBarrier.subresourceRange = {VK_IMAGE_ASPECT_PLANE_0_BIT | VK_IMAGE_ASPECT_PLANE_1_BIT, 0, 1, 0, 1};
+    yuvBarrier.dstAccessMask = VK_ACCESS_TRANSFER_READ_BIT;
+    vk.vkCmdPipelineBarrier(commandBuffer, VK_PIPELINE_STAGE_COMPUTE_SHADER_BIT, VK_PIPELINE_STAGE_TRANSFER_BIT,
+                            0, 0, nullptr, 1, &yuvBarrier, 1, &pictureBarrier);
+    
+    std::array<VkBufferImageCopy, 2> planes{};
+    planes[0].imageSubresource = {VK_IMAGE_ASPECT_PLANE_0_BIT, 0, 0, 1};
+    planes[0].imageExtent = {extent.width, extent.height, 1};
+    planes[1].bufferOffset = static_cast<VkDeviceSize>(extent.width) * extent.height;
+    planes[1].imageSubresource = {VK_IMAGE_ASPECT_PLANE_1_BIT, 0, 0, 1};
+    planes[1].imageExtent = {extent.width / 2, extent.height / 2, 1};
+    vk.vkCmdCopyBufferToImage(commandBuffer, slot.yuvBuffer, pictureBarrier.image, VK_IMAGE_LAYOUT_TRANSFER_DST_OPTIMAL,
+                              static_cast<uint32_t>(planes.size()), planes.data());
+}
+
+void VideoRecorder::submitFrame(VkSemaphore graphicsTimeline, uint64_t graphicsTimelineValue) {
+    if (captureSlot == UINT32_MAX) {
+        return;
+    }
+    const uint32_t slot = captureSlot;
+    captureSlot = UINT32_MAX;
+    if (graphicsTimelineValue == 0 && useHardwareEncode) {
+        slots[slot].state = SlotState::Free;
+        ++framesDropped;
+        return;
+    }
+    if (useHardwareEncode && !encodeSession.submit(slot, graphicsTimeline, graphicsTimelineValue)) {
+        slots[slot].state = SlotState::Free;
+        ++framesDropped;
+        return;
+    }
+    slots[slot].state = SlotState::Submitted;
+    submittedSlots.push_back(slot);
+    ++framesCaptured;
+}
+
+void VideoRecorder::cancelFrame() {
+    // The slot is only reused after its frame slot's wait, so whatever the failed submit still writes is harmless
+    if (captureSlot == UINT32_MAX) {
+        return;
+    }
+    slots[captureSlot].state = SlotState::Free;
+    captureSlot = UINT32_MAX;
+    ++framesDropped;
+}
+
+void VideoRecorder::queueOutput(Output&& frame) {
+    {
+        std::lock_guard<std::mutex> lock(queueMutex);
+        queued.push_back(std::move(frame));
+        if (writing) return;  // The running job picks it up
+        writing = true;
+    }
+    JobSystem::getInstance().submit([this]() { writeQueued(); }, JobPriority::Low, &writeJobs);
+}
+
+void VideoRecorder::writeQueued() {
+    std::unique_lock<std::mutex> lock(queueMutex);
+    while (!queued.empty()) {
+        Output frame = std::move(queued.front());
+        queued.pop_front();
+        lock.unlock();
+        
+        bool written = false;
+        uint64_t bytes = 0;
+        if (frame.readbackSlot == UINT32_MAX) {
+            bytes = frame.bytes.size();
+            written = std::fwrite(frame.bytes.data(), 1, frame.bytes.size(), output) == frame.bytes.size();
+        } else {
+            // Y4M: the stream header once, then FRAME and the Y, U and V planes of every picture
+            Slot& slot = slots[frame.readbackSlot];
+            written = true;
+            if (!headerWritten) {
+                char header[96];
+                const int length = std::snprintf(header, sizeof(header), "YUV4MPEG2 W%u H%u F%u:1 Ip A1:1 C420jpeg XCOLORRANGE=LIMITED\n",
+                                                 extent.width, extent.height, RECORDING_FRAME_RATE);
+                written = std::fwrite(header, 1, static_cast<size_t>(length), output) == static_cast<size_t>(length);
+                bytes += static_cast<uint64_t>(length);
+                headerWritten = written;
+            }
+            const size_t planeBytes = static_cast<size_t>(frameBytes(extent));
+            written = written && std::fwrite("FRAME\n", 1, 6, output) == 6 &&
+                      std::fwrite(slot.yuvReadback.mappedData, 1, planeBytes, output) == planeBytes;
+            bytes += 6 + planeBytes;
+            slot.writing.store(false, std::memory_order_release);
+        }
+        if (written) {
+            ++framesWritten;
+            bytesWritten += bytes;
+        } else {
+            ++writeFailures;
+        }
+        
+        lock.lock();
+    }
+    writing = false;
+}
+
+VideoRecorder::Telemetry VideoRecorder::getTelemetry() const {
+    Telemetry telemetry;
+    telemetry.framesCaptured = framesCaptured.load();
+    telemetry.framesWritten = framesWritten.load();
+    telemetry.framesDropped = framesDropped.load();
+    telemetry.bytesWritten = bytesWritten.load();
+    telemetry.writeFailures = writeFailures.load();
+    return telemetry;
+}
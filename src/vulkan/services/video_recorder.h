@@ -0,0 +1,164 @@
+#pragma once
+
+#define VK_NO_PROTOTYPES
+#include <vulkan/vulkan.h>
+#include "../core/vulkan_raii.h"
+#include "../core/vulkan_constants.h"
+#include "../resources/core/resource_handle.h"
+#include "../../ecs/utilities/job_system.h"
+#include "video_encode_session.h"
+#include <array>
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <deque>
+#include <mutex>
+#include <string>
+#include <vector>
+
+// Forward declarations
+class VulkanContext;
+class VulkanFunctionLoader;
+class ResourceCoordinator;
+
+// --record settings, handed to VulkanRenderer::setRecording before initialize()
+struct RecordingOptions {
+    std::string path;                           // Output file: H.264 Annex-B with hardware encode, Y4M otherwise
+    uint32_t gopFrames = RECORDING_DEFAULT_GOP;
+    uint32_t qp = RECORDING_DEFAULT_QP;
+    std::string encoderCommand;                 // Without hardware encode, Y4M is piped into this command instead
+};
+
+/**
+ * Session recording (--record). SwapchainCaptureNode records, at the end of each presented frame, a blit of the
+ * swapchain image into a capture image of the recording extent, a copy into a buffer, and capture_yuv.comp's
+ * conversion to YUV 4:2:0 into the frame slot's output. With VideoEncodeSession that output is copied into the
+ * slot's NV12 picture and encoded on the video encode queue after the graphics submit; without it the I420
+ * bytes are read back from a host-visible buffer. A Low-priority JobSystem job, one at a time, writes finished
+ * frames to the file (or the encoder pipe) in order.
+ *
+ * Slots follow the renderer's frame slots, so a readback is complete once the slot's frame wait returns, and an
+ * encode once its fence signals. A frame whose slot is still encoding or being written is dropped rather than
+ * waited for. The recording extent is the first frame's, rounded down to RECORDING_EXTENT_ALIGNMENT; later
+ * frames of another size are scaled to it. The output stays open across device rebuilds (detach/attach), a
+ * rebuilt encoder starting again with an IDR picture. With VK_KHR_push_descriptor the conversion's buffers are
+ * pushed while recording and the layout is a push descriptor layout; otherwise each slot has a set in a pool.
+ */
+class VideoRecorder {
+public:
+    VideoRecorder() = default;
+    ~VideoRecorder();
+    VideoRecorder(const VideoRecorder&) = delete;
+    VideoRecorder& operator=(const VideoRecorder&) = delete;
+    
+    // Takes the device's resources; the first attach picks the output format and opens the output
+    bool attach(const VulkanContext& context, ResourceCoordinator* resourceCoordinator, const RecordingOptions& options);
+    // Device idle: hands the slots' finished frames to the writer and releases the device's resources
+    void detach();
+    // Detaches, writes everything queued and closes the output
+    void close();
+    
+    bool isAttached() const { return context != nullptr; }
+    bool usesHardwareEncode() const { return useHardwareEncode; }
+    
+    // After the frame slot's wait, before the frame is recorded: collects finished frames for the writer
+    void beginFrame(uint32_t frameIndex);
+    
+    // Frame graph side (SwapchainCaptureNode). prepareCapture() reserves the slot for a source of extent and
+    // format, false when the frame is not captured; recordCapture() then records into the graphics command buffer,
+    // leaving the swapchain image in PRESENT_SRC
+    bool prepareCapture(uint32_t frameIndex, VkExtent2D sourceExtent, VkFormat sourceFormat);
+    void recordCapture(VkCommandBuffer commandBuffer, const VulkanFunctionLoader& vk, VkImage swapchainImage,
+                       VkPipeline pipeline, VkPipelineLayout pipelineLayout) const;
+    VkDescriptorSetLayout getDescriptorSetLayout() const { return descriptorSetLayout.get(); }
+    // Changes whenever recordCapture() would record other commands or handles (slot, source, resources)
+    uint64_t getCaptureKey() const;
+    
+    // After the graphics submit of the frame prepareCapture() reserved (graphicsTimelineValue 0 under fence
+    // pacing, which only the readback path runs with); cancelFrame() drops it when the submit failed instead
+    void submitFrame(VkSemaphore graphicsTimeline, uint64_t graphicsTimelineValue);
+    void cancelFrame();
+    
+    struct Telemetry {
+        uint64_t framesCaptured = 0;    // Submitted for encoding or readback
+        uint64_t framesWritten = 0;
+        uint64_t framesDropped = 0;     // Slot busy, unsupported source format, or an encoder error
+        uint64_t bytesWritten = 0;
+        uint64_t writeFailures = 0;
+    };
+    Telemetry getTelemetry() const;
+
+private:
+    enum class SlotState : uint8_t {
+        Free,
+        Captured,   // prepareCapture() reserved it for the frame being recorded
+        Submitted,  // Graphics (and encode) work in flight
+    };
+    
+    struct Slot {
+        SlotState state = SlotState::Free;
+        ResourceHandle yuvReadback;     // Readback path only
+        VkBuffer yuvBuffer = VK_NULL_HANDLE;
+        VkDescriptorSet descriptorSet = VK_NULL_HANDLE;  // Null with push descriptors
+        std::atomic<bool> writing{false};    // The writer holds yuvReadback's mapping
+    };
+    
+    // A finished frame: encoded bytes, or a readback slot whose mapping the writer reads from
+    struct Output {
+        std::vector<uint8_t> bytes;
+        uint32_t readbackSlot = UINT32_MAX;
+    };
+    
+    bool openOutput(const RecordingOptions& options);
+    bool createResources();
+    void releaseResources();
+    void collectFinished(bool wait);
+    void queueOutput(Output&& output);
+    void writeQueued();
+    
+    // Device side, render thread only
+    const VulkanContext* context = nullptr;
+    ResourceCoordinator* resourceCoordinator = nullptr;
+    VideoEncodeSession encodeSession;
+    bool useHardwareEncode = false;
+    bool modeChosen = false;             // Output format fixed by the first frame, kept across rebuilds
+    uint32_t gopFrames = RECORDING_DEFAULT_GOP;
+    uint32_t qp = RECORDING_DEFAULT_QP;
+    
+    VkExtent2D extent{};                 // Recording extent, fixed by the first captured frame
+    VkFormat captureFormat = VK_FORMAT_UNDEFINED;
+    ResourceHandle captureImage;
+    ResourceHandle rgbBuffer;
+    ResourceHandle yuvDeviceBuffer;      // Encode path: converted frame copied into the slot's picture
+    vulkan_raii::DescriptorSetLayout descriptorSetLayout;
+    vulkan_raii::DescriptorPool descriptorPool;
+    bool pushDescriptors = false;
+    std::array<Slot, MAX_FRAMES_IN_FLIGHT> slots;
+    uint32_t slotCount = 0;
+    std::deque<uint32_t> submittedSlots;  // Submission order
+    
+    // Resolved by prepareCapture() for recordCapture()
+    uint32_t captureSlot = UINT32_MAX;
+    VkExtent2D sourceExtent{};
+    bool swapRedBlue = false;
+    bool formatReported = false;
+    bool failed = false;                 // Resources could not be created; nothing more is captured
+    uint64_t resourceGeneration = 0;     // Bumped whenever capture resources are recreated
+    
+    // Output, written by the writer job apart from open and close
+    std::FILE* output = nullptr;
+    bool outputIsPipe = false;
+    bool headerWritten = false;          // Y4M stream header
+    
+    // Handoff to the writer, one job at a time like EntityStreamServer's sender
+    std::mutex queueMutex;
+    std::deque<Output> queued;
+    bool writing = false;                // A writeQueued() job is queued or running
+    JobCounter writeJobs;
+    
+    std::atomic<uint64_t> framesCaptured{0};
+    std::atomic<uint64_t> framesWritten{0};
+    std::atomic<uint64_t> framesDropped{0};
+    std::atomic<uint64_t> bytesWritten{0};
+    std::atomic<uint64_t> writeFailures{0};
+};
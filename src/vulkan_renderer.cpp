@@ -4,12 +4,18 @@
 #include "vulkan/core/vulkan_swapchain.h"
 #include "vulkan/core/vulkan_sync.h"
 #include "vulkan/core/queue_manager.h"
+#include "vulkan/core/deletion_queue.h"
 #include "vulkan/resources/core/resource_coordinator.h"
+#include "vulkan/resources/core/frame_ring_allocator.h"
+#include "vulkan/resources/core/memory_allocator.h"
+#include "vulkan/resources/buffers/buffer_manager.h"
+#include "vulkan/resources/buffers/buffer_statistics_collector.h"
 #include "vulkan/resources/managers/graphics_resource_manager.h"
 #include "vulkan/rendering/frame_graph.h"
 #include "vulkan/nodes/entity_compute_node.h"
 #include "vulkan/nodes/entity_graphics_node.h"
 #include "vulkan/nodes/swapchain_present_node.h"
+#include "vulkan/nodes/performance_hud_node.h"
 #include "vulkan/services/render_frame_director.h"
 #include "vulkan/services/command_submission_service.h"
 #include "vulkan/rendering/frame_graph_resource_registry.h"
@@ -17,16 +23,26 @@
 #include "vulkan/services/presentation_surface.h"
 #include "vulkan/services/frame_state_manager.h"
 #include "vulkan/services/error_recovery_service.h"
+#include "vulkan/monitoring/gpu_memory_monitor.h"
+#include "vulkan/monitoring/device_health_monitor.h"
+#include "vulkan/monitoring/overdraw_monitor.h"
+#include "vulkan/monitoring/metrics_exporter.h"
+#include "vulkan/services/video_recorder.h"
+#include "vulkan/services/output_window.h"
 #include "vulkan/pipelines/pipeline_system_manager.h"
+#include "vulkan/pipelines/graphics_pipeline_manager.h"
 #include "ecs/gpu/gpu_entity_manager.h"
 #include "ecs/components/component.h"
 #include "ecs/components/camera_component.h"
-#include <iostream>
+#include "ecs/utilities/profiler.h"
+#include "ecs/utilities/logger.h"
+#include "ecs/utilities/memory_tags.h"
 #include <array>
 #include <chrono>
 #include <algorithm>
 #include <cmath>
 #include <cassert>
+#include <bit>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 
@@ -37,90 +53,123 @@ VulkanRenderer::VulkanRenderer() {
 
 VulkanRenderer::~VulkanRenderer() {
     cleanup();
+    finishRecording();
 }
 
 bool VulkanRenderer::initialize(SDL_Window* window) {
     if (!window) {
-        std::cerr << "VulkanRenderer: NULL window provided" << std::endl;
+        LOG_ERROR("VulkanRenderer: NULL window provided");
         return false;
     }
     this->window = window;
     
     // Phase 1: Core Vulkan initialization
     context = std::make_unique<VulkanContext>();
+    if (context) {
+        context->setFramesInFlight(framesInFlight);
+        context->setPreferredDevice(preferredDevice);
+        context->setSimulationDeviceRequested(simulationDevice);
+        context->setExternalExportRequested(!positionExportPath.empty());
+        // A piped encoder takes the readback path, so only a plain recording needs an encode queue
+        context->setVideoEncodeRequested(ENABLE_VIDEO_ENCODE && recordingOptions && recordingOptions->encoderCommand.empty());
+    }
     if (!context || !context->initialize(window)) {
-        std::cerr << "Failed to initialize Vulkan context" << std::endl;
+        LOG_ERROR("Failed to initialize Vulkan context");
+        deviceUnavailable = !context || context->getPhysicalDevice() == VK_NULL_HANDLE;
         cleanup();
         return false;
     }
     
     swapchain = std::make_unique<VulkanSwapchain>();
+    if (swapchain) {
+        swapchain->setRenderQuality(static_cast<VkSampleCountFlagBits>(requestedMSAASamples), requestedRenderScale);
+        swapchain->setPresentPolicy(requestedPresentPolicy);
+        swapchain->setCaptureRequested(recordingOptions != nullptr);
+    }
     if (!swapchain || !swapchain->initialize(*context, window)) {
-        std::cerr << "Failed to initialize Vulkan swapchain" << std::endl;
+        LOG_ERROR("Failed to initialize Vulkan swapchain");
         cleanup();
         return false;
     }
+    framePacer.setSwapchain(swapchain.get());
+    framePacer.setPresentTimingMonitor(&presentTiming);
+    
+    deletionQueue = std::make_unique<DeletionQueue>();
+    deletionQueue->setFramesInFlight(context->getFramesInFlight());
     
     // Phase 2: Pipeline and synchronization objects (depend on context)
     pipelineSystem = std::make_unique<PipelineSystemManager>();
-    if (!pipelineSystem || !pipelineSystem->initialize(*context)) {
-        std::cerr << "Failed to initialize AAA Pipeline System" << std::endl;
+    if (!pipelineSystem || !pipelineSystem->initialize(*context, deletionQueue.get())) {
+        LOG_ERROR("Failed to initialize AAA Pipeline System");
         cleanup();
         return false;
     }
     
     sync = std::make_unique<VulkanSync>();
     if (!sync || !sync->initialize(*context)) {
-        std::cerr << "Failed to initialize Vulkan sync" << std::endl;
+        LOG_ERROR("Failed to initialize Vulkan sync");
         cleanup();
         return false;
     }
     
     queueManager = std::make_unique<QueueManager>();
     if (!queueManager || !queueManager->initialize(*context)) {
-        std::cerr << "Failed to initialize Queue Manager" << std::endl;
+        LOG_ERROR("Failed to initialize Queue Manager");
         cleanup();
         return false;
     }
     
     // Phase 3: Render pass and framebuffers (depend on pipeline system and swapchain)
     if (!pipelineSystem->getGraphicsManager()) {
-        std::cerr << "Graphics manager not available from pipeline system" << std::endl;
+        LOG_ERROR("Graphics manager not available from pipeline system");
         cleanup();
         return false;
     }
     
-    VkRenderPass renderPass = pipelineSystem->getGraphicsManager()->createRenderPass(
-        swapchain->getImageFormat(), VK_FORMAT_UNDEFINED, VK_SAMPLE_COUNT_2_BIT, true);
-    if (renderPass == VK_NULL_HANDLE) {
-        std::cerr << "Failed to create render pass" << std::endl;
+    // Under dynamic rendering the entity pass draws on the swapchain's image views without either
+    const bool dynamicRendering = context->supportsDynamicRendering();
+    VkRenderPass renderPass = dynamicRendering ? VK_NULL_HANDLE : pipelineSystem->getGraphicsManager()->createRenderPass(
+        swapchain->getImageFormat(), swapchain->getDepthFormat(), swapchain->getSampleCount(),
+        swapchain->getSampleCount() != VK_SAMPLE_COUNT_1_BIT, swapchain->getOutputLayout());
+    if (renderPass == VK_NULL_HANDLE && !dynamicRendering) {
+        LOG_ERROR("Failed to create render pass");
         cleanup();
         return false;
     }
     
     if (!swapchain->createFramebuffers(renderPass)) {
-        std::cerr << "Failed to create framebuffers" << std::endl;
+        LOG_ERROR("Failed to create framebuffers");
         cleanup();
         return false;
     }
     
+    // Display wall windows: one that cannot be drawn stays blank rather than failing startup
+    for (SDL_Window* outputSdlWindow : outputSdlWindows) {
+        auto outputWindow = std::make_unique<OutputWindow>();
+        if (outputWindow->initialize(*context, outputSdlWindow, *swapchain, pipelineSystem->getGraphicsManager())) {
+            outputWindows.push_back(std::move(outputWindow));
+        } else {
+            LOG_ERROR("Output window " << SDL_GetWindowTitle(outputSdlWindow) << " will not be drawn");
+        }
+    }
+    
     // Phase 4: Resource management (depends on context, queue manager)
     resourceCoordinator = std::make_unique<ResourceCoordinator>();
-    if (!resourceCoordinator || !resourceCoordinator->initialize(*context, queueManager.get())) {
-        std::cerr << "Failed to initialize Resource coordinator" << std::endl;
+    if (!resourceCoordinator || !resourceCoordinator->initialize(*context, queueManager.get(), deletionQueue.get())) {
+        LOG_ERROR("Failed to initialize Resource coordinator");
         cleanup();
         return false;
     }
     
     if (!resourceCoordinator->getGraphicsManager()->createAllGraphicsResources()) {
-        std::cerr << "Failed to create graphics resources (uniform and triangle buffers)" << std::endl;
+        LOG_ERROR("Failed to create graphics resources (uniform and triangle buffers)");
         cleanup();
         return false;
     }
     
     // Phase 5: Descriptor layouts and pools (depend on pipeline system)
     if (!pipelineSystem->getLayoutManager()) {
-        std::cerr << "Layout manager not available from pipeline system" << std::endl;
+        LOG_ERROR("Layout manager not available from pipeline system");
         cleanup();
         return false;
     }
@@ -128,57 +177,78 @@ bool VulkanRenderer::initialize(SDL_Window* window) {
     auto layoutSpec = DescriptorLayoutPresets::createEntityGraphicsLayout();
     VkDescriptorSetLayout descriptorLayout = pipelineSystem->getLayoutManager()->getLayout(layoutSpec);
     if (descriptorLayout == VK_NULL_HANDLE) {
-        std::cerr << "Failed to create descriptor layout" << std::endl;
+        LOG_ERROR("Failed to create descriptor layout");
         cleanup();
         return false;
     }
     
     if (!resourceCoordinator->getGraphicsManager()->createGraphicsDescriptorPool(descriptorLayout)) {
-        std::cerr << "Failed to create descriptor pool" << std::endl;
+        LOG_ERROR("Failed to create descriptor pool");
         cleanup();
         return false;
     }
     
     if (!resourceCoordinator->getGraphicsManager()->createGraphicsDescriptorSets(descriptorLayout)) {
-        std::cerr << "Failed to create descriptor sets" << std::endl;
+        LOG_ERROR("Failed to create descriptor sets");
         cleanup();
         return false;
     }
     
-    // Phase 6: Entity management (depends on context, sync, resource context)
-    gpuEntityManager = std::make_unique<GPUEntityManager>();
+    // Phase 6: Entity management (depends on context, sync, resource context); a device-loss rebuild reinitializes
+    // the manager it kept
+    if (!gpuEntityManager) {
+        gpuEntityManager = std::make_unique<GPUEntityManager>();
+    }
+    if (gpuEntityManager) {
+        gpuEntityManager->getBufferManager().setPositionExportPath(positionExportPath);
+        gpuEntityManager->getBufferManager().setAccessedComputeBindings(pipelineSystem->reflectEntityComputeBindings());
+    }
     if (!gpuEntityManager || !gpuEntityManager->initialize(*context, sync.get(), resourceCoordinator.get())) {
-        std::cerr << "Failed to initialize GPU entity manager" << std::endl;
+        LOG_ERROR("Failed to initialize GPU entity manager");
         cleanup();
         return false;
     }
     
     // Validate entity manager buffers before using them
     if (!gpuEntityManager->getMovementParamsBuffer() || !gpuEntityManager->getPositionBuffer()) {
-        std::cerr << "GPU entity manager missing required buffers" << std::endl;
+        LOG_ERROR("GPU entity manager missing required buffers");
         cleanup();
         return false;
     }
     
+    // Indirect draw command needs the entity mesh index count; the non-indexed procedural draw reads the same
+    // word as its vertex count, which the expanded path grows by one triangle per visible entity
+    const auto geometryPath = GraphicsPipelinePresets::selectEntityGeometryPath(*context);
+    if (geometryPath == GraphicsPipelinePresets::EntityGeometryPath::BinnedMesh) {
+        gpuEntityManager->setShapeDraws(resourceCoordinator->getGraphicsManager()->getShapeRanges());
+    } else {
+        gpuEntityManager->setDrawIndexCount(
+            GraphicsPipelinePresets::isProceduralGeometry(geometryPath)
+                ? ENTITY_PROCEDURAL_VERTEX_COUNT
+                : resourceCoordinator->getGraphicsManager()->getIndexCount(),
+            geometryPath == GraphicsPipelinePresets::EntityGeometryPath::ProceduralExpanded);
+    }
+    
     if (!resourceCoordinator->getGraphicsManager()->updateDescriptorSetsWithEntityAndPositionBuffers(
             gpuEntityManager->getMovementParamsBuffer(),
             gpuEntityManager->getPositionBuffer())) {
-        std::cerr << "Failed to update descriptor sets with entity and position buffers" << std::endl;
+        LOG_ERROR("Failed to update descriptor sets with entity and position buffers");
         cleanup();
         return false;
     }
-    std::cout << "Graphics descriptor sets updated with entity and position buffers" << std::endl;
+    LOG_INFO("Graphics descriptor sets updated with entity and position buffers");
     
     auto computeLayoutSpec = DescriptorLayoutPresets::createEntityComputeLayout();
     VkDescriptorSetLayout computeDescriptorLayout = pipelineSystem->getLayoutManager()->getLayout(computeLayoutSpec);
     if (computeDescriptorLayout == VK_NULL_HANDLE) {
-        std::cerr << "Failed to create compute descriptor layout" << std::endl;
+        LOG_ERROR("Failed to create compute descriptor layout");
         cleanup();
         return false;
     }
     
+    gpuEntityManager->getDescriptorManager().setLayoutManager(pipelineSystem->getLayoutManager());
     if (!gpuEntityManager->getDescriptorManager().createComputeDescriptorSets(computeDescriptorLayout)) {
-        std::cerr << "Failed to create compute descriptor sets" << std::endl;
+        LOG_ERROR("Failed to create compute descriptor sets");
         cleanup();
         return false;
     }
@@ -187,29 +257,47 @@ bool VulkanRenderer::initialize(SDL_Window* window) {
     auto graphicsLayoutSpec = DescriptorLayoutPresets::createEntityGraphicsLayout();
     VkDescriptorSetLayout graphicsDescriptorLayout = pipelineSystem->getLayoutManager()->getLayout(graphicsLayoutSpec);
     if (!gpuEntityManager->getDescriptorManager().createGraphicsDescriptorSets(graphicsDescriptorLayout)) {
-        std::cerr << "Failed to create entity graphics descriptor sets" << std::endl;
+        LOG_ERROR("Failed to create entity graphics descriptor sets");
         cleanup();
         return false;
     }
     
+    // Node pipelines compile on worker threads while the rest of initialization runs
+    // Bindless and buffer address modes swap every entity pipeline onto their shader variants
+    const auto& entityDescriptors = gpuEntityManager->getDescriptorManager();
+    pipelineSystem->warmupCommonPipelines(renderPass, gpuEntityManager->isCompactLayout(),
+        entityDescriptors.getBindlessTableLayout(), entityDescriptors.getBindlessUniformLayout(),
+        entityDescriptors.usesStreamAddresses(), dynamicRendering ? swapchain->getImageFormat() : VK_FORMAT_UNDEFINED,
+        swapchain->getDepthFormat());
+    
     // Phase 7: Modular architecture (depends on all previous components)
     if (!initializeModularArchitecture()) {
-        std::cerr << "Failed to initialize modular architecture" << std::endl;
+        LOG_ERROR("Failed to initialize modular architecture");
         cleanup();
         return false;
     }
     
     // Final validation - ensure all critical components are available
     if (!frameDirector || !submissionService || !frameStateManager || !errorRecoveryService) {
-        std::cerr << "Initialization state validation failed - missing critical services" << std::endl;
+        LOG_ERROR("Initialization state validation failed - missing critical services");
         cleanup();
         return false;
     }
     
-    pipelineSystem->warmupCommonPipelines();
+    // A recording that cannot be set up is reported and skipped rather than failing the renderer
+    if (recordingOptions) {
+        if (!videoRecorder) {
+            videoRecorder = std::make_unique<VideoRecorder>();
+        }
+        if (videoRecorder->attach(*context, resourceCoordinator.get(), *recordingOptions)) {
+            frameDirector->setVideoRecorder(videoRecorder.get());
+        }
+    }
     
-    std::cout << "VulkanRenderer: AAA Pipeline System initialization complete" << std::endl;
+    LOG_INFO("VulkanRenderer: AAA Pipeline System initialization complete");
     
+    // Governed collision stride, density LOD and idle speed for the new compute manager and director
+    applyQualitySettings();
     initialized = true;
     return true;
 }
@@ -222,10 +310,15 @@ void VulkanRenderer::cleanup() {
             const VkDevice device = context->getDevice();
             vk.vkDeviceWaitIdle(device);
         } catch (const std::exception& e) {
-            std::cerr << "Exception during device wait idle: " << e.what() << std::endl;
+            LOG_ERROR("Exception during device wait idle: " << e.what());
         }
     }
     
+    // The recorder's frames are finished once the device is idle; its resources go before the coordinator's
+    if (videoRecorder) {
+        videoRecorder->detach();
+    }
+    
     // Cleanup modular architecture first (higher-level components)
     cleanupModularArchitecture();
     
@@ -234,7 +327,7 @@ void VulkanRenderer::cleanup() {
         try {
             sync->cleanupBeforeContextDestruction();
         } catch (const std::exception& e) {
-            std::cerr << "Exception during sync cleanup: " << e.what() << std::endl;
+            LOG_ERROR("Exception during sync cleanup: " << e.what());
         }
     }
     
@@ -242,7 +335,7 @@ void VulkanRenderer::cleanup() {
         try {
             pipelineSystem->cleanupBeforeContextDestruction();
         } catch (const std::exception& e) {
-            std::cerr << "Exception during pipeline system cleanup: " << e.what() << std::endl;
+            LOG_ERROR("Exception during pipeline system cleanup: " << e.what());
         }
     }
     
@@ -251,7 +344,7 @@ void VulkanRenderer::cleanup() {
         try {
             resourceCoordinator->cleanupBeforeContextDestruction();
         } catch (const std::exception& e) {
-            std::cerr << "Exception during resource coordinator cleanup: " << e.what() << std::endl;
+            LOG_ERROR("Exception during resource coordinator cleanup: " << e.what());
         }
     }
     
@@ -277,7 +370,12 @@ void VulkanRenderer::cleanup() {
         pipelineSystem.reset();
     }
     
+    // Whatever the components above retired on their way out; the device is idle
+    deletionQueue.reset();
+    
+    outputWindows.clear();
     if (swapchain) {
+        framePacer.setSwapchain(nullptr);
         swapchain.reset();
     }
     
@@ -297,30 +395,31 @@ void VulkanRenderer::drawFrame() {
 bool VulkanRenderer::initializeModularArchitecture() {
     frameGraph = std::make_unique<FrameGraph>();
     if (!frameGraph->initialize(*context, sync.get(), queueManager.get())) {
-        std::cerr << "Failed to initialize frame graph" << std::endl;
+        LOG_ERROR("Failed to initialize frame graph");
         return false;
     }
+    frameGraph->setMemoryAllocator(resourceCoordinator->getMemoryAllocator());
     
     resourceRegistry = std::make_unique<FrameGraphResourceRegistry>();
     if (!resourceRegistry->initialize(frameGraph.get(), gpuEntityManager.get())) {
-        std::cerr << "Failed to initialize resource importer" << std::endl;
+        LOG_ERROR("Failed to initialize resource importer");
         return false;
     }
     
     if (!resourceRegistry->importEntityResources()) {
-        std::cerr << "Failed to import entity resources" << std::endl;
+        LOG_ERROR("Failed to import entity resources");
         return false;
     }
     
     syncService = std::make_unique<GPUSynchronizationService>();
     if (!syncService->initialize(*context)) {
-        std::cerr << "Failed to initialize synchronization manager" << std::endl;
+        LOG_ERROR("Failed to initialize synchronization manager");
         return false;
     }
     
     presentationSurface = std::make_unique<PresentationSurface>();
     if (!presentationSurface->initialize(context.get(), swapchain.get(), pipelineSystem->getGraphicsManager(), syncService.get())) {
-        std::cerr << "Failed to initialize swapchain coordinator" << std::endl;
+        LOG_ERROR("Failed to initialize swapchain coordinator");
         return false;
     }
     
@@ -335,34 +434,71 @@ bool VulkanRenderer::initializeModularArchitecture() {
         frameGraph.get(),
         presentationSurface.get()
     )) {
-        std::cerr << "Failed to initialize frame orchestrator" << std::endl;
+        LOG_ERROR("Failed to initialize frame orchestrator");
         return false;
     }
+    frameDirector->setSimulationClock(&simulationClock);
+    frameDirector->setCameraLatch(&cameraLatch);
+    frameDirector->setClosedFormMovement(closedFormMovement);
+    frameDirector->setDebugOverlayEnabled(debugOverlayVisible);
     
     frameDirector->updateResourceIds(
         resourceRegistry->getEntityBufferId(),
         resourceRegistry->getPositionBufferId(),
         resourceRegistry->getCurrentPositionBufferId(),
-        resourceRegistry->getTargetPositionBufferId()
+        resourceRegistry->getTargetPositionBufferId(),
+        resourceRegistry->getSpatialMapBufferId(),
+        resourceRegistry->getSpatialEntryBufferId(),
+        resourceRegistry->getSpatialIndexBufferId(),
+        resourceRegistry->getVisibleIndexBufferId(),
+        resourceRegistry->getVisibleDrawCommandBufferId()
     );
     
     submissionService = std::make_unique<CommandSubmissionService>();
     if (!submissionService->initialize(context.get(), sync.get(), swapchain.get(), queueManager.get())) {
-        std::cerr << "Failed to initialize queue submission manager" << std::endl;
+        LOG_ERROR("Failed to initialize queue submission manager");
         return false;
     }
+    submissionService->setCameraLatch(&cameraLatch);
+    
+    std::vector<OutputWindow*> outputWindowPointers;
+    for (const auto& outputWindow : outputWindows) {
+        outputWindowPointers.push_back(outputWindow.get());
+    }
+    frameDirector->setOutputWindows(outputWindowPointers);
+    submissionService->setOutputWindows(outputWindowPointers);
     
     frameStateManager = std::make_unique<FrameStateManager>();
-    frameStateManager->initialize();
+    frameStateManager->initialize(context->getFramesInFlight());
     
     errorRecoveryService = std::make_unique<ErrorRecoveryService>();
     errorRecoveryService->initialize(presentationSurface.get());
     
-    std::cout << "Modular architecture initialized successfully" << std::endl;
+    memoryMonitor = std::make_unique<GPUMemoryMonitor>(context.get());
+    memoryMonitor->setMemoryAllocator(resourceCoordinator->getMemoryAllocator());
+    memoryMonitor->beginFrame();
+    
+    deviceHealthMonitor = std::make_unique<DeviceHealthMonitor>();
+    deviceHealthMonitor->start(context.get(), sync.get(), &frameGraph->getBreadcrumbs());
+    
+    if (ENABLE_OVERDRAW_DIAGNOSTIC && context->supportsOverdrawCounting()) {
+        overdrawMonitor = std::make_unique<OverdrawMonitor>();
+        if (!overdrawMonitor->initialize(*context, resourceCoordinator.get())) {
+            LOG_WARNING("VulkanRenderer: Overdraw diagnostic unavailable");
+            overdrawMonitor.reset();
+        }
+    }
+    frameDirector->setOverdrawMonitor(overdrawMonitor.get());
+    frameDirector->setOverdrawDiagnosticEnabled(overdrawDiagnosticVisible);
+    
+    LOG_INFO("Modular architecture initialized successfully");
     return true;
 }
 
 void VulkanRenderer::cleanupModularArchitecture() {
+    overdrawMonitor.reset();
+    deviceHealthMonitor.reset();
+    memoryMonitor.reset();
     errorRecoveryService.reset();
     frameStateManager.reset();
     submissionService.reset();
@@ -373,30 +509,298 @@ void VulkanRenderer::cleanupModularArchitecture() {
     frameGraph.reset();
 }
 
+void VulkanRenderer::rebindEntityBuffers() {
+    // Compute and entity graphics descriptor sets were already recreated by GPUEntityManager::growCapacity
+    if (!resourceRegistry->refreshEntityResources()) {
+        LOG_ERROR("VulkanRenderer: Failed to refresh frame graph entity imports after buffer growth");
+    }
+    
+    // Sparse growth kept the handles, and the sets may still be in use by frames in flight
+    if (!gpuEntityManager->grewInPlace() &&
+        !resourceCoordinator->getGraphicsManager()->updateDescriptorSetsWithEntityAndPositionBuffers(
+            gpuEntityManager->getMovementParamsBuffer(),
+            gpuEntityManager->getPositionBuffer())) {
+        LOG_ERROR("VulkanRenderer: Failed to update graphics descriptor sets after buffer growth");
+    }
+    
+    entityBufferGeneration = gpuEntityManager->getBufferGeneration();
+}
+
+void VulkanRenderer::setFramesInFlight(uint32_t count) {
+    if (initialized) {
+        LOG_ERROR("VulkanRenderer: Frames in flight can only be changed before initialize()");
+        return;
+    }
+    framesInFlight = std::clamp(count, MIN_FRAMES_IN_FLIGHT, MAX_FRAMES_IN_FLIGHT);
+    framesInFlightRequested = true;
+}
+
+void VulkanRenderer::setPresentPolicy(PresentPolicy policy) {
+    requestedPresentPolicy = policy;
+    presentPolicyChanged = initialized;
+    if (!initialized && !framesInFlightRequested) {
+        framesInFlight = std::clamp(VulkanSwapchain::getPolicyFramesInFlight(policy), MIN_FRAMES_IN_FLIGHT, MAX_FRAMES_IN_FLIGHT);
+    }
+}
+
+void VulkanRenderer::setComputeShaderFeatures(const ComputeShaderFeatures& features) {
+    shaderFeatures = features;
+    QualitySettings baseline = qualityGovernor.getBaseline();
+    baseline.collisionStride = features.collisionStride;
+    qualityGovernor.setBaseline(baseline);
+    applyQualitySettings();
+}
+
+void VulkanRenderer::setRenderQuality(uint32_t msaaSamples, float renderScale) {
+    QualitySettings baseline = qualityGovernor.getBaseline();
+    baseline.msaaSamples = std::bit_floor(std::clamp(msaaSamples, 1u, 64u));
+    baseline.renderScale = renderScale;
+    qualityGovernor.setBaseline(baseline);
+    applyQualitySettings();
+}
+
+void VulkanRenderer::setFrameRateLimit(uint32_t framesPerSecond) {
+    framePacer.setTargetFrameRate(framesPerSecond);
+    presentTiming.setTargetFrameRate(framesPerSecond);
+    if (!targetFrameTimeRequested) {
+        qualityGovernor.setTargetFrameTime(framesPerSecond > 0 ? 1000.0f / framesPerSecond : QUALITY_GOVERNOR_UNCAPPED_TARGET_MS);
+    }
+}
+
+void VulkanRenderer::setTargetFrameTime(float milliseconds) {
+    qualityGovernor.setTargetFrameTime(milliseconds);
+    targetFrameTimeRequested = true;
+}
+
+void VulkanRenderer::setQualityGovernorEnabled(bool enabled) {
+    qualityGovernor.setEnabled(enabled);
+    applyQualitySettings();
+}
+
+void VulkanRenderer::updateQualityGovernor(std::chrono::steady_clock::time_point frameStartTime) {
+    if (!frameGraph) return;
+    
+    // Slot waits are part of it, so a GPU-bound frame shows up here as well as in the node timings
+    const float cpuFrameMs = std::chrono::duration<float, std::milli>(std::chrono::steady_clock::now() - frameStartTime).count();
+    if (qualityGovernor.update(cpuFrameMs, frameGraph->getNodeProfiler())) {
+        applyQualitySettings();
+    }
+}
+
+void VulkanRenderer::setSpatialCellTuningEnabled(bool enabled) {
+    spatialCellTuner.setEnabled(enabled);
+    if (gpuEntityManager) {
+        if (enabled) {
+            gpuEntityManager->getBufferManager().setOccupancyHistogram(true);
+        }
+        gpuEntityManager->setSpatialCellSize(spatialCellTuner.getCellSize());
+    }
+}
+
+void VulkanRenderer::updateSpatialCellTuner(std::chrono::steady_clock::time_point frameStartTime) {
+    if (!gpuEntityManager || !spatialCellTuner.isEnabled()) return;
+    
+    const bool changed = spatialCellTuner.update(frameStartTime, gpuEntityManager->getSimulationCounters(),
+                                                 gpuEntityManager->getEntityCount(), shaderFeatures.maxEntitiesPerCell);
+    // Also after a device loss recovery, which starts the entity buffers over at SPATIAL_CELL_SIZE
+    if (changed || gpuEntityManager->getSpatialGridConfig().cellSize != spatialCellTuner.getCellSize()) {
+        gpuEntityManager->setSpatialCellSize(spatialCellTuner.getCellSize());
+    }
+}
+
+void VulkanRenderer::applyQualitySettings() {
+    const QualitySettings& quality = qualityGovernor.getSettings();
+    if (quality.msaaSamples != requestedMSAASamples || quality.renderScale != requestedRenderScale) {
+        requestedMSAASamples = quality.msaaSamples;
+        requestedRenderScale = quality.renderScale;
+        renderQualityChanged = initialized;
+    }
+    
+    if (pipelineSystem && pipelineSystem->getComputeManager()) {
+        ComputeShaderFeatures features = shaderFeatures;
+        features.collisionStride = quality.collisionStride;
+        pipelineSystem->getComputeManager()->setShaderFeatures(features);
+    }
+    if (frameDirector) {
+        frameDirector->setDensityLodThreshold(quality.densityLodThreshold);
+        frameDirector->setPhysicsIdleSpeed(quality.idleSpeed);
+    }
+}
+
+uint32_t VulkanRenderer::getMSAASamples() const {
+    return swapchain ? static_cast<uint32_t>(swapchain->getSampleCount()) : requestedMSAASamples;
+}
+
+float VulkanRenderer::getRenderScale() const {
+    return swapchain ? swapchain->getRenderScale() : requestedRenderScale;
+}
+
+bool VulkanRenderer::applyPendingRenderQuality() {
+    if (!renderQualityChanged) {
+        return false;
+    }
+    renderQualityChanged = false;
+    
+    if (!swapchain->setRenderQuality(static_cast<VkSampleCountFlagBits>(requestedMSAASamples), requestedRenderScale)) {
+        return false;
+    }
+    
+    // Recreation destroys the MSAA and scaled images that frames still in flight render into
+    context->getLoader().vkDeviceWaitIdle(context->getDevice());
+    return true;
+}
+
+bool VulkanRenderer::applyPendingPresentPolicy() {
+    if (!presentPolicyChanged) {
+        return false;
+    }
+    presentPolicyChanged = false;
+    
+    if (!swapchain->setPresentPolicy(requestedPresentPolicy)) {
+        return false;
+    }
+    
+    LOG_INFO("VulkanRenderer: Present policy " << VulkanSwapchain::getPresentPolicyName(requestedPresentPolicy)
+             << " (frames in flight stay at " << framesInFlight << ")");
+    context->getLoader().vkDeviceWaitIdle(context->getDevice());
+    return true;
+}
+
+void VulkanRenderer::markInputSampled(std::chrono::steady_clock::time_point sampleTime) {
+    lastInputSampleTime = sampleTime;
+    inputSampled = true;
+}
+
+void VulkanRenderer::markInputEvent(std::chrono::steady_clock::time_point eventTime) {
+    if (!inputEventPending || eventTime < pendingInputEventTime) {
+        pendingInputEventTime = eventTime;
+    }
+    inputEventPending = true;
+}
+
+void VulkanRenderer::setCameraMatrices(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection) {
+    if (frameDirector) {
+        frameDirector->setCameraMatrices(view, projection, viewProjection);
+    }
+}
+
+void VulkanRenderer::setViewportCameras(const std::vector<ViewportCamera>& cameras) {
+    if (frameDirector) {
+        frameDirector->setViewportCameras(cameras);
+    }
+}
+
 void VulkanRenderer::drawFrameModular() {
+    if (deviceLost) {
+        return;
+    }
+    
+    // Stamp frames the GPU finished since last frame before blocking on this slot
+    const auto frameStartTime = std::chrono::steady_clock::now();
+    if (frameStateManager) {
+        frameStateManager->pollCompletedFrames(*context, sync.get(), frameStartTime);
+    }
+    if (swapchain) {
+        presentTiming.poll(*swapchain);
+    }
+    
     // Wait for GPU work tied to this slot index before reusing it
-    if (frameStateManager && frameStateManager->hasActiveFences(currentFrame)) {
+    if (frameStateManager && sync->usesTimelineSemaphores()) {
+        // Timeline pacing: wait for the values the slot's last submissions signaled, no fence resets
+        frameStateManager->getTimelineValuesToWait(currentFrame, sync.get(), timelineWaitSemaphores, timelineWaitValues);
+        
+        if (!timelineWaitSemaphores.empty()) {
+            VkSemaphoreWaitInfoKHR waitInfo{};
+            waitInfo.sType = VK_STRUCTURE_TYPE_SEMAPHORE_WAIT_INFO_KHR;
+            waitInfo.semaphoreCount = static_cast<uint32_t>(timelineWaitSemaphores.size());
+            waitInfo.pSemaphores = timelineWaitSemaphores.data();
+            waitInfo.pValues = timelineWaitValues.data();
+            
+            VkResult waitResult = context->getLoader().vkWaitSemaphoresKHR(context->getDevice(), &waitInfo, UINT64_MAX);
+            if (waitResult != VK_SUCCESS) {
+                LOG_ERROR("VulkanRenderer: Failed to wait for GPU timeline values: " << waitResult);
+                if (waitResult == VK_ERROR_DEVICE_LOST) {
+                    markDeviceLost("the timeline wait");
+                }
+                return;
+            }
+        }
+    } else if (frameStateManager && frameStateManager->hasActiveFences(currentFrame)) {
         auto fencesToWait = frameStateManager->getFencesToWait(currentFrame, sync.get());
         
         if (!fencesToWait.empty()) {
             const auto& vk = context->getLoader();
             const VkDevice device = context->getDevice();
             
+            deviceHealthMonitor->beginFenceWait();
             VkResult waitResult = vk.vkWaitForFences(device, static_cast<uint32_t>(fencesToWait.size()), 
                                                     fencesToWait.data(), VK_TRUE, UINT64_MAX);
+            deviceHealthMonitor->endFenceWait();
             if (waitResult != VK_SUCCESS) {
-                std::cerr << "VulkanRenderer: Failed to wait for GPU fences: " << waitResult << std::endl;
+                LOG_ERROR("VulkanRenderer: Failed to wait for GPU fences: " << waitResult);
+                if (waitResult == VK_ERROR_DEVICE_LOST) {
+                    markDeviceLost("the fence wait");
+                }
                 return;
             }
         }
     }
     
-    // Upload pending GPU entities
+    if (frameStateManager) {
+        const auto waitEndTime = std::chrono::steady_clock::now();
+        frameStateManager->recordSlotWait(currentFrame,
+            std::chrono::duration<double, std::milli>(waitEndTime - frameStartTime).count(), waitEndTime);
+    }
+    
+    // Objects retired while this slot was last current are no longer referenced
+    deletionQueue->beginFrame();
+    
+    // The GPU is done with this slot, so its per-frame constants and staging uploads can be rewritten
+    resourceCoordinator->beginFrame(currentFrame);
+    if (videoRecorder && videoRecorder->isAttached()) {
+        videoRecorder->beginFrame(currentFrame);
+    }
+    if (overdrawMonitor) {
+        overdrawMonitor->beginFrame(currentFrame);  // Also while hidden, so the last counted frames drain
+    }
+    
+    // Transfer commands handed back in flight are recycled once their fences signal
+    queueManager->pollCompletedTransfers();
+    
+    // The slot's primaries and per-lane secondaries are done executing; one pool reset each recycles them
+    queueManager->resetCommandBuffersForFrame(currentFrame);
+    
+    // Adopts shader hot-reload recompiles before anything records
+    pipelineSystem->beginFrame();
+    
+    // Staged spawns outgrew the entity buffers - grow them before this frame records against the old handles
+    if (gpuEntityManager && gpuEntityManager->needsCapacityGrowth()) {
+        gpuEntityManager->growCapacity();
+    }
+    if (gpuEntityManager && gpuEntityManager->getBufferGeneration() != entityBufferGeneration) {
+        rebindEntityBuffers();
+    }
+    
+    // Upload pending GPU entities on the transfer queue - EntityUploadNode publishes them once landed
     if (gpuEntityManager && gpuEntityManager->hasPendingUploads()) {
-        gpuEntityManager->uploadPendingEntities();
+        gpuEntityManager->uploadPendingEntitiesAsync();
+    }
+    
+    // Queues the position mirror's, telemetry capture's and entity stream's readback chunks and the GPU expiry
+    // count for this frame's copies (nothing while they are off)
+    if (gpuEntityManager) {
+        gpuEntityManager->refreshPositionMirror(frameCounter);
+        gpuEntityManager->refreshTelemetryCapture(frameCounter);
+        gpuEntityManager->refreshEntityStream(frameCounter);
+        gpuEntityManager->refreshExpiredEntityCount();
     }
+    updateSpatialCellTuner(frameStartTime);
+    
+    updatePerformanceHud(frameStartTime);
     
-    // Orchestrate the frame
+    // Orchestrate the frame - fast-forward frames that leave ticks for later run their compute only
+    const bool presenting = presentationEnabled && !simulationClock.isFastForwardFrameHidden();
+    frameDirector->setPresenting(presenting);
     auto frameResult = frameDirector->directFrame(
         currentFrame,
         totalTime,
@@ -411,6 +815,9 @@ void VulkanRenderer::drawFrameModular() {
             frameResult, frameDirector.get(), currentFrame, totalTime, deltaTime, frameCounter, world, retryResult)) {
             frameResult = retryResult;
         } else {
+            if (frameResult.acquireResult == VK_ERROR_DEVICE_LOST) {
+                markDeviceLost("image acquisition");
+            }
             return;
         }
     } else {
@@ -419,35 +826,75 @@ void VulkanRenderer::drawFrameModular() {
     
     // Note: Frame graph nodes already configured in directFrame() - no need to configure again
     
-    // Submit frame work
+    // Submit frame work - pipelined frames let graphics trail this frame's compute by one frame, and compute
+    // only wait for the graphics frame that last drew the snapshot it overwrites
+    const bool graphicsLagsCompute = gpuEntityManager->isPipelinedComputeActive() && gpuEntityManager->isGraphicsLaggingCompute();
+    EntityPositionExport& positionExport = gpuEntityManager->getBufferManager().getPositionExport();
+    if (const uint64_t exportValue = positionExport.takePendingSignal()) {
+        submissionService->addComputeSignal(positionExport.getSemaphore(), exportValue);
+    }
     auto submissionResult = submissionService->submitFrame(
         currentFrame,
         frameResult.imageIndex,
         frameResult.executionResult,
-        framebufferResized
+        framebufferResized,
+        graphicsLagsCompute,
+        graphicsLagsCompute ? std::optional<uint64_t>(gpuEntityManager->getSnapshotWriteAfterReadValue()) : std::nullopt
     );
     
+    if (videoRecorder && videoRecorder->isAttached()) {
+        if (submissionResult.success) {
+            videoRecorder->submitFrame(sync->getGraphicsTimelineSemaphore(), submissionResult.graphicsTimelineValue);
+        } else {
+            videoRecorder->cancelFrame();
+        }
+    }
     if (!submissionResult.success) {
-        std::cerr << "VulkanRenderer: Frame " << frameCounter << " FAILED in submissionService->submitFrame()" << std::endl;
-        std::cerr << "  VkResult: " << submissionResult.lastResult << std::endl;
+        LOG_ERROR("VulkanRenderer: Frame " << frameCounter << " FAILED in submissionService->submitFrame()");
+        LOG_ERROR("  VkResult: " << submissionResult.lastResult);
+        if (submissionResult.lastResult == VK_ERROR_DEVICE_LOST) {
+            markDeviceLost("frame submission");
+        }
         return;
     } else {
         logFrameSuccessIfNeeded("Frame submission completed successfully");
     }
+    if (gpuEntityManager->isPipelinedComputeActive()) {
+        gpuEntityManager->markSnapshotDrawn(submissionResult.graphicsTimelineValue);
+    }
     
-    if (submissionResult.swapchainRecreationNeeded || framebufferResized) {
-        std::cout << "VulkanRenderer: SWAPCHAIN RECREATION INITIATED - Frame " << frameCounter << std::endl;
+    const bool presentPolicyApplied = presenting && applyPendingPresentPolicy();
+    const bool renderQualityApplied = presenting && applyPendingRenderQuality();
+    if (renderQualityApplied || presentPolicyApplied || submissionResult.swapchainRecreationNeeded ||
+        frameResult.swapchainRecreationNeeded || (framebufferResized && presenting)) {
+        LOG_INFO("VulkanRenderer: SWAPCHAIN RECREATION INITIATED - Frame " << frameCounter);
         
         if (presentationSurface && presentationSurface->recreateSwapchain()) {
-            std::cout << "VulkanRenderer: SWAPCHAIN RECREATION COMPLETED - Next frames should render normally" << std::endl;
+            LOG_INFO("VulkanRenderer: SWAPCHAIN RECREATION COMPLETED - Next frames should render normally");
             framebufferResized = false;  // Reset the flag
             // Notify frame director so it can reset cached swapchain-dependent state
             if (frameDirector) {
                 frameDirector->resetSwapchainCache();
             }
         } else {
-            std::cerr << "VulkanRenderer: CRITICAL ERROR - Swapchain recreation FAILED" << std::endl;
+            LOG_ERROR("VulkanRenderer: CRITICAL ERROR - Swapchain recreation FAILED");
         }
+        for (const auto& outputWindow : outputWindows) {
+            outputWindow->requestRecreation();  // Takes the main window's new quality and policy
+        }
+    }
+    
+    // Output windows recreate after the main window, or on their own when only their display changed
+    const bool outputRecreationNeeded = presenting && std::any_of(outputWindows.begin(), outputWindows.end(),
+        [](const auto& outputWindow) { return outputWindow->needsRecreation(); });
+    if (outputRecreationNeeded) {
+        context->getLoader().vkDeviceWaitIdle(context->getDevice());
+        for (const auto& outputWindow : outputWindows) {
+            if (outputWindow->needsRecreation()) {
+                outputWindow->recreate(*swapchain);
+            }
+        }
+        frameDirector->resetOutputWindowCache();
     }
     
     // Periodic memory pressure monitoring (every 60 frames to avoid performance impact)
@@ -457,10 +904,10 @@ void VulkanRenderer::drawFrameModular() {
             VkDeviceSize totalAllocated = resourceCoordinator->getTotalAllocatedMemory();
             VkDeviceSize available = resourceCoordinator->getAvailableMemory();
             uint32_t allocCount = resourceCoordinator->getAllocationCount();
-            std::cout << "VulkanRenderer: Frame " << frameCounter << " - Memory pressure status: HIGH" 
-                      << ", Total allocated: " << (totalAllocated / (1024 * 1024)) << "MB"
-                      << ", Available: " << (available / (1024 * 1024)) << "MB"
-                      << ", Active allocations: " << allocCount << std::endl;
+            LOG_INFO("VulkanRenderer: Frame " << frameCounter << " - Memory pressure status: HIGH" 
+                     << ", Total allocated: " << (totalAllocated / (1024 * 1024)) << "MB"
+                     << ", Available: " << (available / (1024 * 1024)) << "MB"
+                     << ", Active allocations: " << allocCount);
         }
     }
     
@@ -473,21 +920,468 @@ void VulkanRenderer::drawFrameModular() {
         frameStateManager->setGraphicsUsed(currentFrame, graphicsUsed);
 
         // Mark compute usage for the slot compute work was submitted to (N+1 slot)
-        uint32_t computeSlot = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+        uint32_t computeSlot = (currentFrame + 1) % context->getFramesInFlight();
         frameStateManager->setComputeUsed(computeSlot, computeUsed);
+        
+        // Timeline pacing: remember which values to wait on when these slots come around again
+        if (submissionResult.graphicsTimelineValue > 0) {
+            frameStateManager->setGraphicsTimelineValue(currentFrame, submissionResult.graphicsTimelineValue);
+        }
+        if (submissionResult.computeTimelineValue > 0) {
+            frameStateManager->setComputeTimelineValue(computeSlot, submissionResult.computeTimelineValue);
+        }
+        deviceHealthMonitor->recordSubmission(submissionResult.computeTimelineValue, submissionResult.graphicsTimelineValue);
+        
+        if (graphicsUsed) {
+            frameStateManager->recordGraphicsSubmission(currentFrame,
+                inputSampled ? lastInputSampleTime : frameStartTime, std::chrono::steady_clock::now());
+        }
+    }
+    if (submissionResult.presentId != 0) {
+        presentTiming.recordPresent(submissionResult.presentId,
+            inputEventPending ? pendingInputEventTime : std::chrono::steady_clock::time_point{},
+            inputSampled ? lastInputSampleTime : frameStartTime, std::chrono::steady_clock::now());
+        inputEventPending = false;
+    }
+    
+    // Periodic frame pacing report - compare depths by latency vs GPU idle time
+    if (frameStateManager && frameCounter % 300 == 0 && frameCounter > 0) {
+        frameStateManager->logPacingTelemetry();
+        frameStateManager->resetPacingTelemetry();
+        presentTiming.logTelemetry();
+        presentTiming.resetTelemetry();
+        if (frameGraph) {
+            frameGraph->logRecordingTelemetry();
+        }
+        if (memoryMonitor) {
+            memoryMonitor->logNodeBandwidth();
+        }
     }
+    recordNodeBandwidth();
+    publishMetrics(frameStartTime);
+    if (presenting) {
+        updateQualityGovernor(frameStartTime);
+    }
     
     totalTime += deltaTime;
     frameCounter++;
-    currentFrame = (currentFrame + 1) % MAX_FRAMES_IN_FLIGHT;
+    currentFrame = (currentFrame + 1) % context->getFramesInFlight();
+    
+    if (recoverySnapshotInterval > 0 && frameCounter % recoverySnapshotInterval == 0) {
+        saveEntitySnapshot(recoverySnapshotPath);
+    }
 }
 
+void VulkanRenderer::recordNodeBandwidth() {
+    if (!memoryMonitor || !frameGraph || !gpuEntityManager) return;
+    
+    // Timings arrive frames-in-flight late; the live entity count stands in for the one they were recorded with
+    const uint64_t entityCount = gpuEntityManager->getEntityCount();
+    for (const auto& [nodeId, timing] : frameGraph->getNodeProfiler().getTimings()) {
+        if (timing.bytesPerEntity <= 0.0f) continue;
+        const uint64_t bytes = static_cast<uint64_t>(static_cast<double>(timing.bytesPerEntity) * entityCount);
+        memoryMonitor->recordNodeBandwidth(timing.name, timing.sampleCount, bytes, timing.lastMs);
+    }
+    memoryMonitor->endFrame();
+    memoryMonitor->beginFrame();
+}
+
+void VulkanRenderer::setPerformanceHudVisible(bool visible) {
+    if (visible && !performanceHud) {
+        performanceHud = std::make_unique<PerformanceHudStats>();
+    }
+    if (visible && !performanceHudVisible) {
+        // Start from a clean history rather than frame times from before the HUD was last hidden
+        *performanceHud = PerformanceHudStats{};
+        lastHudFrameStart = {};
+        hudFramesSinceRefresh = PERFORMANCE_HUD_REFRESH_FRAMES;
+    }
+    performanceHudVisible = visible;
+    LOG_INFO("VulkanRenderer: Performance HUD " << (visible ? "shown" : "hidden"));
+}
+
+void VulkanRenderer::setDebugOverlayVisible(bool visible) {
+    debugOverlayVisible = visible;
+    if (frameDirector) {
+        frameDirector->setDebugOverlayEnabled(visible);
+    }
+    LOG_INFO("VulkanRenderer: Debug overlay " << (visible ? "shown" : "hidden"));
+}
+
+void VulkanRenderer::setOverdrawDiagnosticVisible(bool visible) {
+    if (visible && !overdrawDiagnosticVisible && overdrawMonitor) {
+        // Figures from before it was last hidden describe a different scene
+        overdrawMonitor->resetStats();
+    }
+    overdrawDiagnosticVisible = visible;
+    if (frameDirector) {
+        frameDirector->setOverdrawDiagnosticEnabled(visible);
+    }
+    if (visible && initialized && !overdrawMonitor) {
+        LOG_WARNING("VulkanRenderer: Overdraw diagnostic needs fragmentStoresAndAtomics, not shown");
+        return;
+    }
+    LOG_INFO("VulkanRenderer: Overdraw diagnostic " << (visible ? "shown" : "hidden"));
+}
+
+void VulkanRenderer::updatePerformanceHud(std::chrono::steady_clock::time_point frameStartTime) {
+    if (!performanceHudVisible || !performanceHud) {
+        frameDirector->setPerformanceHud(nullptr);
+        return;
+    }
+    PerformanceHudStats& hud = *performanceHud;
+    
+    // Start-to-start time, so the graph shows what the user sees including fence waits and pacing
+    if (lastHudFrameStart != std::chrono::steady_clock::time_point{}) {
+        hud.frameTimesMs[hud.frameTimeCursor] = static_cast<float>(
+            std::chrono::duration<double, std::milli>(frameStartTime - lastHudFrameStart).count());
+        hud.frameTimeCursor = (hud.frameTimeCursor + 1) % PERFORMANCE_HUD_FRAME_HISTORY;
+    }
+    lastHudFrameStart = frameStartTime;
+    
+    if (++hudFramesSinceRefresh >= PERFORMANCE_HUD_REFRESH_FRAMES) {
+        hudFramesSinceRefresh = 0;
+        
+        float frameTimeSum = 0.0f;
+        uint32_t frameTimeSamples = 0;
+        for (float milliseconds : hud.frameTimesMs) {
+            if (milliseconds > 0.0f) {
+                frameTimeSum += milliseconds;
+                ++frameTimeSamples;
+            }
+        }
+        hud.averageFrameMs = frameTimeSamples > 0 ? frameTimeSum / frameTimeSamples : 0.0f;
+        
+        hud.nodeTimes.clear();
+        for (const auto& [nodeId, timing] : frameGraph->getNodeProfiler().getTimings()) {
+            if (timing.sampleCount > 0) {
+                hud.nodeTimes.push_back({timing.name, timing.avgMs});
+            }
+        }
+        std::sort(hud.nodeTimes.begin(), hud.nodeTimes.end(),
+                  [](const PerformanceHudStats::NodeTime& a, const PerformanceHudStats::NodeTime& b) { return a.gpuMs > b.gpuMs; });
+        
+        const MemoryAllocator::DeviceMemoryBudget budget = resourceCoordinator->getMemoryAllocator()->getDeviceLocalBudget();
+        hud.vramUsedBytes = budget.usedBytes;
+        hud.vramBudgetBytes = budget.budgetBytes;
+        
+        const ComputePipelineManager::ComputeStats computeStats = pipelineSystem->getComputeManager()->getStats();
+        hud.computePipelines = computeStats.totalPipelines;
+        hud.computeCacheHitRatio = computeStats.hitRatio;
+        
+        std::vector<PipelineExecutableReport> executableReports;
+        pipelineSystem->getComputeManager()->collectExecutableReports(executableReports);
+        pipelineSystem->getGraphicsManager()->collectExecutableReports(executableReports);
+        hud.shaderStats.clear();
+        for (const PipelineExecutableReport& report : executableReports) {
+            hud.shaderStats.push_back({report.name, static_cast<uint32_t>(report.stats.registers),
+                                       static_cast<uint32_t>(report.stats.spills),
+                                       static_cast<uint32_t>(report.stats.sharedMemoryBytes),
+                                       report.stats.spillsRegisters()});
+        }
+        std::sort(hud.shaderStats.begin(), hud.shaderStats.end(),
+                  [](const PerformanceHudStats::ShaderStat& a, const PerformanceHudStats::ShaderStat& b) { return a.registers > b.registers; });
+        
+        hud.entityCount = gpuEntityManager ? gpuEntityManager->getEntityCount() : 0;
+        const uint64_t uploadedBytes = gpuEntityManager ? gpuEntityManager->getBufferManager().getUploadedBytes() : 0;
+        const double refreshSeconds = std::chrono::duration<double>(frameStartTime - lastHudRefreshTime).count();
+        hud.uploadMegabytesPerSecond = lastHudRefreshTime != std::chrono::steady_clock::time_point{} && refreshSeconds > 0.0
+            ? static_cast<float>((uploadedBytes - lastHudUploadedBytes) / (1024.0 * 1024.0) / refreshSeconds)
+            : 0.0f;
+        lastHudUploadedBytes = uploadedBytes;
+        lastHudRefreshTime = frameStartTime;
+        
+        const SimulationCounters simulation = gpuEntityManager ? gpuEntityManager->getSimulationCounters() : SimulationCounters{};
+        const bool countersContinue = hud.simulationCountersValid && simulation.collisions >= lastHudCollisions;
+        const float perFrame = 1.0f / PERFORMANCE_HUD_REFRESH_FRAMES;
+        hud.collisionsPerFrame = countersContinue ? (simulation.collisions - lastHudCollisions) * perFrame : 0.0f;
+        hud.truncatedEntitiesPerFrame = countersContinue ? (simulation.truncatedEntities - lastHudTruncatedEntities) * perFrame : 0.0f;
+        hud.directionChangesPerFrame = countersContinue ? (simulation.directionChanges - lastHudDirectionChanges) * perFrame : 0.0f;
+        hud.occupiedCells = simulation.occupiedCells;
+        hud.gridCells = gpuEntityManager ? gpuEntityManager->getSpatialGridConfig().getCellCount() : 0;
+        hud.cellSize = gpuEntityManager ? gpuEntityManager->getSpatialGridConfig().cellSize : SPATIAL_CELL_SIZE;
+        hud.overflowCells = simulation.overflowCells;
+        hud.maxCellOccupancy = simulation.maxCellOccupancy;
+        hud.simulationCountersValid = simulation.valid;
+        const OverdrawMonitor::Stats* overdraw = overdrawMonitor && overdrawDiagnosticVisible ? &overdrawMonitor->getStats() : nullptr;
+        hud.overdrawValid = overdraw && overdraw->valid;
+        hud.averageOverdraw = hud.overdrawValid ? overdraw->averageOverdraw() : 0.0f;
+        hud.maxOverdraw = hud.overdrawValid ? overdraw->maxFragments : 0;
+        hud.overdrawCoverage = hud.overdrawValid && overdraw->pixels > 0
+            ? static_cast<float>(overdraw->coveredPixels) / overdraw->pixels : 0.0f;
+        lastHudCollisions = simulation.collisions;
+        lastHudTruncatedEntities = simulation.truncatedEntities;
+        lastHudDirectionChanges = simulation.directionChanges;
+        ++hud.version;
+    }
+    
+    frameDirector->setPerformanceHud(&hud);
+}
+
+void VulkanRenderer::addOutputWindow(SDL_Window* outputWindow) {
+    if (outputSdlWindows.size() >= MAX_OUTPUT_WINDOWS) {
+        LOG_ERROR("VulkanRenderer: At most " << MAX_OUTPUT_WINDOWS << " output windows, "
+                  << SDL_GetWindowTitle(outputWindow) << " will not be drawn");
+        return;
+    }
+    outputSdlWindows.push_back(outputWindow);
+}
+
+void VulkanRenderer::setRecording(const RecordingOptions& options) {
+    if (initialized) {
+        LOG_ERROR("VulkanRenderer: Recording can only be set up before initialize()");
+        return;
+    }
+    recordingOptions = std::make_unique<RecordingOptions>(options);
+}
+
+void VulkanRenderer::finishRecording() {
+    if (videoRecorder) {
+        videoRecorder->close();
+        videoRecorder.reset();
+    }
+}
+
+bool VulkanRenderer::startMetricsExport(const MetricsExportOptions& options) {
+    if (!metricsExporter) {
+        metricsExporter = std::make_unique<MetricsExporter>();
+    }
+    return metricsExporter->start(options);
+}
+
+void VulkanRenderer::publishMetrics(std::chrono::steady_clock::time_point frameStartTime) {
+    if (!metricsExporter) return;
+    
+    if (lastMetricsFrameStart != std::chrono::steady_clock::time_point{}) {
+        const double frameMs = std::chrono::duration<double, std::milli>(frameStartTime - lastMetricsFrameStart).count();
+        metricsFrameTimeSumMs += frameMs;
+        metricsFrameTimeMaxMs = std::max(metricsFrameTimeMaxMs, frameMs);
+        ++metricsFrameSamples;
+    }
+    lastMetricsFrameStart = frameStartTime;
+    if (frameCounter % METRICS_PUBLISH_FRAMES != 0) return;
+    
+    // Registration is a lookup once a metric exists, so metrics are simply named where they are published
+    MetricsRegistry& registry = metricsExporter->getRegistry();
+    const auto gauge = [&registry](const char* name, double value, const char* labelName = nullptr, const char* labelValue = nullptr) {
+        registry.set(registry.registerMetric(name, MetricsRegistry::Type::Gauge, labelName, labelValue), value);
+    };
+    const auto counter = [&registry](const char* name, double value, const char* labelName = nullptr, const char* labelValue = nullptr) {
+        registry.set(registry.registerMetric(name, MetricsRegistry::Type::Counter, labelName, labelValue), value);
+    };
+    
+    // Start-to-start frame times over the window since the last publish
+    gauge("frame_time_ms", metricsFrameSamples > 0 ? metricsFrameTimeSumMs / metricsFrameSamples : 0.0);
+    gauge("frame_time_max_ms", metricsFrameTimeMaxMs);
+    counter("frames_total", static_cast<double>(frameCounter));
+    gauge("device_lost", deviceLost ? 1.0 : 0.0);
+    if (deviceHealthMonitor) {
+        counter("gpu_hangs_total", static_cast<double>(deviceHealthMonitor->getTelemetry().hangsDetected));
+        gauge("gpu_stall_max_ms", deviceHealthMonitor->getTelemetry().longestStallMs);
+    }
+    metricsFrameTimeSumMs = 0.0;
+    metricsFrameTimeMaxMs = 0.0;
+    metricsFrameSamples = 0;
+    
+    // Tagged CPU heap per subsystem; allocations are upstream calls, so pooled tags grow slowly
+    const MemoryTags::Report heap = MemoryTags::getReport();
+    for (size_t tag = 0; tag < MEMORY_TAG_COUNT; ++tag) {
+        const char* tagName = getMemoryTagName(static_cast<MemoryTag>(tag));
+        gauge("cpu_heap_bytes", static_cast<double>(heap.tags[tag].currentBytes), "tag", tagName);
+        counter("cpu_heap_allocations_total", static_cast<double>(heap.tags[tag].allocations), "tag", tagName);
+    }
+    
+    if (gpuEntityManager) {
+        gauge("entities", gpuEntityManager->getEntityCount());
+        counter("entity_upload_bytes_total", static_cast<double>(gpuEntityManager->getBufferManager().getUploadedBytes()));
+        
+        const SimulationCounters simulation = gpuEntityManager->getSimulationCounters();
+        if (simulation.valid) {
+            counter("physics_collisions_total", static_cast<double>(simulation.collisions));
+            counter("physics_truncated_entities_total", static_cast<double>(simulation.truncatedEntities));
+            counter("movement_direction_changes_total", static_cast<double>(simulation.directionChanges));
+            gauge("spatial_occupied_cells", simulation.occupiedCells);
+            gauge("spatial_overflow_cells", simulation.overflowCells);
+            gauge("spatial_max_cell_occupancy", simulation.maxCellOccupancy);
+        }
+        gauge("spatial_cell_size", gpuEntityManager->getSpatialGridConfig().cellSize);
+        const EntityStreamServer& stream = gpuEntityManager->getBufferManager().getEntityStream();
+        if (stream.isEnabled()) {
+            const EntityStreamServer::Telemetry streaming = stream.getTelemetry();
+            gauge("entity_stream_clients", streaming.clients);
+            counter("entity_stream_snapshots_total", static_cast<double>(streaming.snapshotsSent));
+            counter("entity_stream_snapshots_dropped_total", static_cast<double>(streaming.snapshotsDropped));
+            counter("entity_stream_bytes_total", static_cast<double>(streaming.bytesSent));
+            counter("entity_stream_send_failures_total", static_cast<double>(streaming.sendFailures));
+            counter("entity_stream_entries_total", static_cast<double>(streaming.entriesSent));
+            counter("entity_stream_entries_deferred_total", static_cast<double>(streaming.entriesDeferred));
+        }
+        if (videoRecorder) {
+            const VideoRecorder::Telemetry recording = videoRecorder->getTelemetry();
+            counter("recording_frames_total", static_cast<double>(recording.framesWritten));
+            counter("recording_frames_dropped_total", static_cast<double>(recording.framesDropped));
+            counter("recording_bytes_total", static_cast<double>(recording.bytesWritten));
+            counter("recording_write_failures_total", static_cast<double>(recording.writeFailures));
+        }
+        if (spatialCellTuner.isEnabled()) {
+            const SpatialCellTuner::Telemetry& tuning = spatialCellTuner.getTelemetry();
+            gauge("spatial_cell_tuner_occupancy", tuning.lastOccupancy);
+            counter("spatial_cell_size_changes_total", static_cast<double>(tuning.shrinks), "direction", "shrink");
+            counter("spatial_cell_size_changes_total", static_cast<double>(tuning.grows), "direction", "grow");
+        }
+        if (simulation.histogramValid) {
+            // Labelled with the smallest entity count of each bin
+            for (uint32_t bin = 0; bin < SPATIAL_OCCUPANCY_HISTOGRAM_BINS; ++bin) {
+                const std::string minimum = std::to_string(bin == 0 ? 0u : 1u << (bin - 1));
+                gauge("spatial_cell_occupancy_cells", simulation.occupancyHistogram[bin], "min_entities", minimum.c_str());
+            }
+        }
+    }
+    
+    if (overdrawMonitor && overdrawDiagnosticVisible && overdrawMonitor->getStats().valid) {
+        const OverdrawMonitor::Stats& overdraw = overdrawMonitor->getStats();
+        gauge("overdraw_average", overdraw.averageOverdraw());
+        gauge("overdraw_max_fragments", overdraw.maxFragments);
+        gauge("overdraw_covered_pixels", overdraw.coveredPixels);
+        // Labelled with the smallest fragment count of each bin, like the cell occupancy histogram
+        for (uint32_t bin = 0; bin < OVERDRAW_HISTOGRAM_BINS; ++bin) {
+            const std::string minimum = std::to_string(bin == 0 ? 0u : 1u << (bin - 1));
+            gauge("overdraw_pixels", overdraw.histogram[bin], "min_fragments", minimum.c_str());
+        }
+    }
+    
+    if (const MemoryAllocator* allocator = resourceCoordinator->getMemoryAllocator()) {
+        const MemoryAllocator::DeviceMemoryBudget budget = allocator->getDeviceLocalBudget();
+        gauge("gpu_memory_used_bytes", static_cast<double>(budget.usedBytes));
+        gauge("gpu_memory_budget_bytes", static_cast<double>(budget.budgetBytes));
+        gauge("gpu_memory_pressure", budget.pressureRatio);
+    }
+    
+    const QueueManager::QueueTelemetry& queues = queueManager->getTelemetry();
+    counter("queue_submissions_total", static_cast<double>(queues.graphicsSubmissions), "queue", "graphics");
+    counter("queue_submissions_total", static_cast<double>(queues.computeSubmissions), "queue", "compute");
+    counter("queue_submissions_total", static_cast<double>(queues.transferSubmissions), "queue", "transfer");
+    counter("queue_submissions_total", static_cast<double>(queues.backgroundComputeSubmissions), "queue", "background_compute");
+    counter("queue_submissions_total", static_cast<double>(queues.presentSubmissions), "queue", "present");
+    gauge("transfer_commands_active", queues.activeTransferCommands);
+    gauge("transfer_commands_peak", queues.peakTransferCommands);
+    
+    BufferManager* bufferManager = resourceCoordinator->getBufferManager();
+    if (BufferStatisticsCollector* collector = bufferManager ? bufferManager->getStatisticsCollector() : nullptr) {
+        const BufferStatisticsCollector::BufferStats buffers = collector->getStats();
+        if (buffers.isValid) {
+            gauge("buffers", buffers.totalBuffers);
+            gauge("buffer_bytes", static_cast<double>(buffers.totalBufferSize));
+            gauge("staging_bytes", static_cast<double>(buffers.stagingTotalSize));
+            gauge("staging_fragmentation_ratio", buffers.stagingFragmentationRatio);
+            counter("staging_failed_allocations_total", buffers.stagingFailedAllocations);
+            counter("buffer_transferred_bytes_total", static_cast<double>(buffers.totalBytesTransferred));
+        }
+    }
+    
+    const auto& transients = frameGraph->getTransientTelemetry();
+    gauge("frame_graph_transient_resources", transients.transientResources);
+    gauge("frame_graph_aliased_resources", transients.aliasedResources);
+    gauge("frame_graph_transient_heap_bytes", static_cast<double>(transients.heapBytes));
+    gauge("frame_graph_transient_requested_bytes", static_cast<double>(transients.requestedBytes));
+    
+    for (const auto& [nodeId, timing] : frameGraph->getNodeProfiler().getTimings()) {
+        if (timing.sampleCount == 0) continue;
+        gauge("node_gpu_ms", timing.avgMs, "node", timing.name.c_str());
+        gauge("node_gpu_p99_ms", timing.p99Ms, "node", timing.name.c_str());
+    }
+    
+    for (const Profiler::ProfileReport& zone : Profiler::getInstance().generateReport()) {
+        gauge("cpu_zone_ms", zone.recentAverageTime, "zone", zone.name.c_str());
+    }
+}
 
 void VulkanRenderer::updateAspectRatio(int windowWidth, int windowHeight) {
     // Camera aspect ratio updates are now handled by CameraService
     // This method is kept for renderer-specific aspect ratio handling if needed
 }
 
+bool VulkanRenderer::saveEntitySnapshot(const std::string& path) {
+    if (!initialized || !gpuEntityManager) return false;
+    
+    // Frames in flight are still writing the streams being read back
+    PROFILE_HITCH_EVENT(HitchCause::DeviceWaitIdle);
+    context->getLoader().vkDeviceWaitIdle(context->getDevice());
+    return gpuEntityManager->saveSnapshot(path, frameCounter, totalTime);
+}
+
+bool VulkanRenderer::loadEntitySnapshot(const std::string& path) {
+    if (!initialized || !gpuEntityManager) return false;
+    
+    PROFILE_HITCH_EVENT(HitchCause::DeviceWaitIdle);
+    context->getLoader().vkDeviceWaitIdle(context->getDevice());
+    uint64_t savedFrame = 0;
+    float savedTime = 0.0f;
+    if (!gpuEntityManager->loadSnapshot(path, savedFrame, savedTime, world)) {
+        return false;
+    }
+    totalTime = savedTime;
+    return true;
+}
+
+void VulkanRenderer::setRecoverySnapshot(const std::string& path, uint32_t intervalFrames) {
+    recoverySnapshotPath = path;
+    recoverySnapshotInterval = path.empty() ? 0 : intervalFrames;
+}
+
+void VulkanRenderer::markDeviceLost(const char* operation) {
+    if (!deviceLost) {
+        LOG_ERROR("VulkanRenderer: VK_ERROR_DEVICE_LOST in " << operation << " at frame " << frameCounter
+                  << " - drawing stops until the device is rebuilt");
+        if (deviceHealthMonitor) {
+            deviceHealthMonitor->reportDeviceLost();
+        }
+    }
+    deviceLost = true;
+    
+    // No frame publishes while the device is gone, so the alert has to go out from here
+    if (metricsExporter) {
+        MetricsRegistry& registry = metricsExporter->getRegistry();
+        registry.set(registry.registerMetric("device_lost", MetricsRegistry::Type::Gauge), 1.0);
+    }
+}
+
+bool VulkanRenderer::recoverFromDeviceLoss() {
+    if (!deviceLost || !window) {
+        return false;
+    }
+    const auto recoveryStart = std::chrono::steady_clock::now();
+    SDL_Window* recoveryWindow = window;
+    
+    // Everything below the window goes, except the entity manager: services, ECS systems and the render thread
+    // hold pointers to it, so only its buffers and descriptors are released with the device
+    std::unique_ptr<GPUEntityManager> entityManager = std::move(gpuEntityManager);
+    if (entityManager) {
+        entityManager->releaseDeviceResources();
+    }
+    cleanup();
+    
+    // Per-slot state of the old device is gone; requested quality and present policy are applied by initialize
+    gpuEntityManager = std::move(entityManager);
+    deviceLost = false;
+    currentFrame = 0;
+    framebufferResized = false;
+    renderQualityChanged = false;
+    presentPolicyChanged = false;
+    if (!initialize(recoveryWindow)) {
+        LOG_ERROR("VulkanRenderer: Device rebuild after VK_ERROR_DEVICE_LOST failed");
+        return false;
+    }
+    
+    if (recoverySnapshotPath.empty() || !loadEntitySnapshot(recoverySnapshotPath)) {
+        LOG_ERROR("VulkanRenderer: No recovery snapshot restored, the rebuilt device starts without entities");
+    }
+    LOG_INFO("VulkanRenderer: Recovered from device loss in "
+             << std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - recoveryStart).count()
+             << "ms");
+    return true;
+}
+
 void VulkanRenderer::setFramebufferResized(bool resized) {
     framebufferResized = resized;
     if (presentationSurface) {
@@ -503,7 +1397,7 @@ void VulkanRenderer::logFrameSuccessIfNeeded(const char* operation) {
     if (frameCounter - lastRecreationFrame <= 10 && lastRecreationFrame > 0) {
         framesAfterRecreation = frameCounter - lastRecreationFrame;
         
-        std::cout << "VulkanRenderer: Frame " << frameCounter << " SUCCESS (+" << framesAfterRecreation 
-                 << " frames post-resize) - " << operation << std::endl;
+        LOG_INFO("VulkanRenderer: Frame " << frameCounter << " SUCCESS (+" << framesAfterRecreation 
+                << " frames post-resize) - " << operation);
     }
 }
@@ -4,13 +4,22 @@
 #include <vulkan/vulkan.h>
 #include <SDL3/SDL.h>
 #include <memory>
+#include <string>
 #include <vector>
+#include <chrono>
 #include <glm/glm.hpp>
 #include <glm/gtc/matrix_transform.hpp>
 #include <flecs.h>
 #include "vulkan/core/vulkan_constants.h"
 #include "vulkan/rendering/frame_graph.h"
+#include "vulkan/rendering/viewport_camera.h"
 #include "vulkan/pipelines/pipeline_system_manager.h"
+#include "vulkan/services/frame_pacer.h"
+#include "vulkan/services/simulation_clock.h"
+#include "vulkan/services/camera_latch.h"
+#include "vulkan/services/present_timing_monitor.h"
+#include "vulkan/services/quality_governor.h"
+#include "vulkan/services/spatial_cell_tuner.h"
 
 // Forward declarations for modules
 class VulkanContext;
@@ -18,6 +27,7 @@ class VulkanSwapchain;
 class VulkanSync;
 class QueueManager;
 class ResourceCoordinator;
+class DeletionQueue;
 class GPUEntityManager;
 class FrameGraph;
 class EntityComputeNode;
@@ -32,6 +42,15 @@ class GPUSynchronizationService;
 class PresentationSurface;
 class FrameStateManager;
 class ErrorRecoveryService;
+struct PerformanceHudStats;
+class MetricsExporter;
+struct MetricsExportOptions;
+class VideoRecorder;
+struct RecordingOptions;
+class GPUMemoryMonitor;
+class DeviceHealthMonitor;
+class OverdrawMonitor;
+class OutputWindow;
 
 class VulkanRenderer {
 public:
@@ -43,36 +62,199 @@ public:
     void cleanup();
     void drawFrame();
     
+    // Frames-in-flight depth (MIN_FRAMES_IN_FLIGHT..MAX_FRAMES_IN_FLIGHT) - set before initialize(); overrides the
+    // present policy's depth
+    void setFramesInFlight(uint32_t count);
+    uint32_t getFramesInFlight() const { return framesInFlight; }
+    
+    // GPU by name substring or UUID - set before initialize(); see VulkanContext::setPreferredDevice
+    void setPreferredDevice(const std::string& nameOrUuid) { preferredDevice = nameOrUuid; }
+    // Second GPU of the rendering GPU's device group for the compute batch ("auto" for any) - set before
+    // initialize(); see VulkanContext::setSimulationDeviceRequested
+    void setSimulationDevice(const std::string& nameOrUuid) { simulationDevice = nameOrUuid; }
+    
+    // Random walk for every entity, its velocity evaluated in closed form by physics rather than stored by a
+    // movement pass - set before initialize(); see RenderFrameDirector::setClosedFormMovement
+    void setClosedFormMovement(bool closedForm) { closedFormMovement = closedForm; }
+    
+    // Exports the published position snapshots and a timeline semaphore for a consumer process, described by
+    // the manifest at manifestPath - set before initialize(); see EntityPositionExport
+    void setPositionExport(const std::string& manifestPath) { positionExportPath = manifestPath; }
+    
+    // Display wall window (not owned, up to MAX_OUTPUT_WINDOWS) drawn from the same simulation - set before
+    // initialize(); kept over device rebuilds. A window the device cannot present to is reported and left blank
+    void addOutputWindow(SDL_Window* outputWindow);
+    
+    // Records the presented frames to options.path - set before initialize(); see VideoRecorder. The output
+    // survives device rebuilds and is finished by finishRecording(), after cleanup() and before the JobSystem stops
+    void setRecording(const RecordingOptions& options);
+    void finishRecording();
+    
+    // Timestamp this frame's input sampling for input-to-present latency telemetry
+    void markInputSampled(std::chrono::steady_clock::time_point sampleTime = std::chrono::steady_clock::now());
+    
+    // Earliest key or mouse event this frame consumed; carried to the next frame that presents, so a frame
+    // without graphics hands it on. PresentTimingMonitor measures from it to the frame on screen
+    void markInputEvent(std::chrono::steady_clock::time_point eventTime);
+    const PresentTimingMonitor& getPresentTimingMonitor() const { return presentTiming; }
+    
+    // Main loop frame rate limit (0 = uncapped); waitForNextFrame() goes after each drawFrame(). Its period is the
+    // quality governor's target unless setTargetFrameTime() chose one
+    void setFrameRateLimit(uint32_t framesPerSecond);
+    void waitForNextFrame() { framePacer.waitForNextFrame(); }
+    const FramePacer& getFramePacer() const { return framePacer; }
+    
+    // Camera matrices written into the frame just before its graphics submit; publish() is safe from the main
+    // thread while a render thread draws
+    CameraLatch& getCameraLatch() { return cameraLatch; }
+    void resetPacingTelemetry() { framePacer.resetTelemetry(); }
+    
+    // Movement and physics tick rate (0 = one variable-length tick per frame)
+    void setSimulationTickRate(uint32_t ticksPerSecond) { simulationClock.setTickRate(ticksPerSecond); }
+    const SimulationClock& getSimulationClock() const { return simulationClock; }
+    void resetSimulationTelemetry() { simulationClock.resetTelemetry(); }
+    // Runs seconds of simulation without frame pacing, ticksPerFrame ticks per compute-only frame, and draws
+    // the frame that finishes it (SimulationClock::fastForward)
+    void fastForwardSimulation(float seconds, uint32_t ticksPerFrame = SIMULATION_FAST_FORWARD_TICKS_PER_FRAME) {
+        simulationClock.fastForward(seconds, ticksPerFrame);
+    }
+    bool isFastForwarding() const { return simulationClock.isFastForwarding(); }
+    
+    // MSAA sample count (rounded down to a power of two, then to what the device supports) and render scale;
+    // before initialize() this is the startup quality, afterwards the swapchain is recreated with it once the
+    // next frame is submitted. The getters report the values in effect, which the quality governor may have lowered
+    void setRenderQuality(uint32_t msaaSamples, float renderScale);
+    uint32_t getMSAASamples() const;
+    float getRenderScale() const;
+    
+    // Present mode and swapchain image count policy. Before initialize() it also picks the frames-in-flight depth
+    // unless setFramesInFlight() chose one; afterwards the swapchain is recreated with it once the next frame is
+    // submitted, at the depth already in use
+    void setPresentPolicy(PresentPolicy policy);
+    PresentPolicy getPresentPolicy() const { return requestedPresentPolicy; }
+    
+    // Physics shader permutation (collisions, cell capacity). Takes effect on the next frame recorded; the
+    // previous variant keeps running until the new pipeline has compiled
+    void setComputeShaderFeatures(const ComputeShaderFeatures& features);
+    const ComputeShaderFeatures& getComputeShaderFeatures() const { return shaderFeatures; }
+    
+    // Adaptive quality: QualityGovernor holds the target frame time by lowering the collision stride, render scale,
+    // MSAA, density LOD threshold and physics idle speed below the settings above, and raising them back when there
+    // is time to spare. Disabled (benchmarks) those settings apply as given
+    void setQualityGovernorEnabled(bool enabled);
+    void setTargetFrameTime(float milliseconds);
+    const QualityGovernor& getQualityGovernor() const { return qualityGovernor; }
+    
+    // Spatial grid cell size from the simulation counters' cell occupancy (SpatialCellTuner); off keeps
+    // SPATIAL_CELL_SIZE. Turns the occupancy histogram on, which the tuner measures with
+    void setSpatialCellTuningEnabled(bool enabled);
+    const SpatialCellTuner& getSpatialCellTuner() const { return spatialCellTuner; }
     
     // GPU entity management
     GPUEntityManager* getGPUEntityManager() { return gpuEntityManager.get(); }
+    
+    // GPUEntityManager snapshots, taken between frames once the GPU has drained. A restore also resumes the saved
+    // simulation time; the frame counter keeps counting, since frame pacing and the published snapshots key off it
+    bool saveEntitySnapshot(const std::string& path);
+    bool loadEntitySnapshot(const std::string& path);
+    
+    // Device-loss recovery point: every intervalFrames frames the entities are saved to path as above, each save
+    // replacing the last only once written (0 frames = off)
+    void setRecoverySnapshot(const std::string& path, uint32_t intervalFrames);
+    
+    // A VK_ERROR_DEVICE_LOST from a frame wait, acquire or submit stops drawing until recoverFromDeviceLoss()
+    // tears the device down and rebuilds everything on the same window, with pipelines seeded from the on-disk
+    // pipeline caches, then restores the recovery snapshot. GPUEntityManager itself is kept, so pointers to it
+    // stay valid; entities spawned after the snapshot are lost. Call between frames, while no frame is being
+    // recorded and the world is not progressing
+    bool isDeviceLost() const { return deviceLost; }
+    bool recoverFromDeviceLoss();
+    
+    // Per-node GPU timings and pipeline statistics for diagnostics
+    const FrameGraph* getFrameGraph() const { return frameGraph.get(); }
+    
+    // Per-node achieved bandwidth, fed from the node timings every frame
+    const GPUMemoryMonitor* getMemoryMonitor() const { return memoryMonitor.get(); }
+    
+    // Hang watchdog over the frame's timeline values or fence waits, with the frame graph's breadcrumbs
+    const DeviceHealthMonitor* getDeviceHealthMonitor() const { return deviceHealthMonitor.get(); }
+    
+    // On-screen overlay of frame times, per-node GPU time, VRAM, compute pipeline cache and upload figures,
+    // drawn by PerformanceHudNode over the presented image (needs dynamic rendering)
+    void setPerformanceHudVisible(bool visible);
+    bool isPerformanceHudVisible() const { return performanceHudVisible; }
+    
+    // Spatial grid cells shaded by occupancy and entity bounding circles coloured by collision state, drawn by
+    // DebugOverlayNode from the GPU buffers over the presented image (needs dynamic rendering)
+    void setDebugOverlayVisible(bool visible);
+    bool isDebugOverlayVisible() const { return debugOverlayVisible; }
+    
+    // Fragments shaded per pixel by the entity pass, counted into a storage image, reduced on the GPU into an
+    // average, maximum and histogram for the HUD and metrics, and drawn as a heat map by OverdrawNode (the heat
+    // map needs dynamic rendering). Unavailable without fragmentStoresAndAtomics
+    void setOverdrawDiagnosticVisible(bool visible);
+    bool isOverdrawDiagnosticVisible() const { return overdrawDiagnosticVisible; }
+    
+    // Prometheus /metrics endpoint and/or StatsD push of frame times, GPU memory, queue, buffer, frame graph,
+    // per-node GPU and Profiler zone figures, published every METRICS_PUBLISH_FRAMES frames. Survives device
+    // rebuilds; false when the configured sockets cannot be opened
+    bool startMetricsExport(const MetricsExportOptions& options);
     void setDeltaTime(float deltaTime) { 
         this->deltaTime = deltaTime; 
         clampedDeltaTime = deltaTime;  // Update static member for global access
     }
     
-    // Camera integration
+    // Camera integration - matrices are captured once per frame by the caller, before drawFrame
     void setWorld(flecs::world* world) { this->world = world; }
+    void setCameraMatrices(const glm::mat4& view, const glm::mat4& projection, const glm::mat4& viewProjection);
+    // Active viewports, each drawn with its own camera in one entity pass; empty uses the camera above full screen
+    void setViewportCameras(const std::vector<ViewportCamera>& cameras);
     void updateAspectRatio(int windowWidth, int windowHeight);
     void setFramebufferResized(bool resized);
     
+    // Off while the window cannot be seen: drawFrame() then runs the compute nodes only, presents nothing and
+    // leaves swapchain recreation and the quality governor until presentation resumes
+    void setPresentationEnabled(bool enabled) { presentationEnabled = enabled; }
+    bool isPresentationEnabled() const { return presentationEnabled; }
+    
     // Static access to clamped deltaTime for global use
     static float getClampedDelta() { return clampedDeltaTime; }
     
     bool isInitialized() const { return initialized; }
+    // After a failed initialize(): no Vulkan instance or no device it could pick, so only the CPU backend can run
+    bool isDeviceUnavailable() const { return deviceUnavailable; }
 
 private:
     bool initialized = false;
+    bool deviceUnavailable = false;
     SDL_Window* window = nullptr;
     flecs::world* world = nullptr; // Reference to ECS world for camera access
     
-    // Removed duplicate MAX_FRAMES_IN_FLIGHT - using public constant
+    uint32_t framesInFlight = DEFAULT_FRAMES_IN_FLIGHT;
+    bool framesInFlightRequested = false;  // Explicit setFramesInFlight(), kept over the present policy's depth
+    std::string preferredDevice;
+    std::string simulationDevice;
+    bool closedFormMovement = false;
+    std::string positionExportPath;
     uint32_t currentFrame = 0;
     bool framebufferResized = false;
+    bool presentationEnabled = true;
+    
+    uint32_t requestedMSAASamples = DEFAULT_MSAA_SAMPLES;
+    float requestedRenderScale = DEFAULT_RENDER_SCALE;
+    bool renderQualityChanged = false;
+    
+    PresentPolicy requestedPresentPolicy = DEFAULT_PRESENT_POLICY;
+    bool presentPolicyChanged = false;
+    
+    ComputeShaderFeatures shaderFeatures;
 
     // Core Vulkan modules
     std::unique_ptr<VulkanContext> context;
+    std::unique_ptr<DeletionQueue> deletionQueue;   // Every device object retired while frames may be in flight
     std::unique_ptr<VulkanSwapchain> swapchain;
+    std::vector<SDL_Window*> outputSdlWindows;
+    std::vector<std::unique_ptr<OutputWindow>> outputWindows;  // Those that initialized, in wall order
     std::unique_ptr<VulkanSync> sync;
     std::unique_ptr<QueueManager> queueManager;
     std::unique_ptr<ResourceCoordinator> resourceCoordinator;
@@ -92,6 +274,9 @@ private:
     std::unique_ptr<PresentationSurface> presentationSurface;
     std::unique_ptr<FrameStateManager> frameStateManager;
     std::unique_ptr<ErrorRecoveryService> errorRecoveryService;
+    std::unique_ptr<GPUMemoryMonitor> memoryMonitor;
+    std::unique_ptr<DeviceHealthMonitor> deviceHealthMonitor;
+    std::unique_ptr<OverdrawMonitor> overdrawMonitor;  // ENABLE_OVERDRAW_DIAGNOSTIC with fragment stores only
 
 
     // Helper functions
@@ -99,9 +284,81 @@ private:
     void cleanupModularArchitecture();
     void drawFrameModular();
     
+    // Applies a setRenderQuality() made since the last frame; true when the swapchain must be recreated
+    bool applyPendingRenderQuality();
+    
+    // Likewise for setPresentPolicy()
+    bool applyPendingPresentPolicy();
+    
+    // Hands the governor this frame's CPU time, then applies what it decided
+    void updateQualityGovernor(std::chrono::steady_clock::time_point frameStartTime);
+    
+    // Pushes the governor's settings to the swapchain request, compute pipeline features and frame director
+    void applyQualitySettings();
+    
+    // Hands the tuner the latest simulation counters and applies a new cell size before this frame's grid build
+    void updateSpatialCellTuner(std::chrono::steady_clock::time_point frameStartTime);
+    
+    // Entity buffer growth - re-point frame graph imports and graphics descriptors at the new handles
+    void rebindEntityBuffers();
+    uint64_t entityBufferGeneration = 0;
+    
+    FramePacer framePacer;
+    SimulationClock simulationClock;
+    CameraLatch cameraLatch;
+    PresentTimingMonitor presentTiming;
+    QualityGovernor qualityGovernor;
+    SpatialCellTuner spatialCellTuner;
+    bool targetFrameTimeRequested = false;  // setTargetFrameTime() wins over the frame rate limit's period
+    
+    // Latest input sample time for pacing telemetry
+    std::chrono::steady_clock::time_point lastInputSampleTime{};
+    bool inputSampled = false;
+    std::chrono::steady_clock::time_point pendingInputEventTime{};
+    bool inputEventPending = false;
+    
+    // Reused wait lists for timeline frame pacing (avoids a per-frame allocation)
+    std::vector<VkSemaphore> timelineWaitSemaphores;
+    std::vector<uint64_t> timelineWaitValues;
+    
+    // Hands nodes timed since the last frame to the memory monitor
+    void recordNodeBandwidth();
+    
+    // Frame time history every frame, the other HUD figures every PERFORMANCE_HUD_REFRESH_FRAMES frames
+    void updatePerformanceHud(std::chrono::steady_clock::time_point frameStartTime);
+    std::unique_ptr<PerformanceHudStats> performanceHud;
+    bool performanceHudVisible = false;
+    bool debugOverlayVisible = false;
+    bool overdrawDiagnosticVisible = false;
+    std::chrono::steady_clock::time_point lastHudFrameStart{};
+    std::chrono::steady_clock::time_point lastHudRefreshTime{};
+    uint64_t lastHudUploadedBytes = 0;
+    uint64_t lastHudCollisions = 0;
+    uint64_t lastHudTruncatedEntities = 0;
+    uint64_t lastHudDirectionChanges = 0;
+    uint32_t hudFramesSinceRefresh = 0;
+    
+    // Frame time window every frame, everything else into the exporter's registry every METRICS_PUBLISH_FRAMES
+    void publishMetrics(std::chrono::steady_clock::time_point frameStartTime);
+    std::unique_ptr<MetricsExporter> metricsExporter;
+    
+    // Session recording, kept across device rebuilds like the exporter
+    std::unique_ptr<RecordingOptions> recordingOptions;
+    std::unique_ptr<VideoRecorder> videoRecorder;
+    std::chrono::steady_clock::time_point lastMetricsFrameStart{};
+    double metricsFrameTimeSumMs = 0.0;
+    double metricsFrameTimeMaxMs = 0.0;
+    uint32_t metricsFrameSamples = 0;
+    
     // Logging helpers
     void logFrameSuccessIfNeeded(const char* operation);
     
+    // Device loss stops drawFrame until recoverFromDeviceLoss
+    void markDeviceLost(const char* operation);
+    bool deviceLost = false;
+    std::string recoverySnapshotPath;
+    uint32_t recoverySnapshotInterval = 0;
+    
     // GPU compute state
     float deltaTime = 0.0f;
     float totalTime = 0.0f; // Accumulated simulation time